@@ -88,16 +88,61 @@ int main(void)
 
 	sei();
 
+	/* Control line states last reported to the host */
+	uint8_t ReportedLineStates = 0;
+
 	for (;;)
 	{
-		/* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-		if (!(RingBuffer_IsFull(&USBtoUSART_Buffer)))
+		/* Only pull in a packet from the host once all of it fits into the USART transmit buffer, so that
+		 * the OUT endpoint is read out and released in one go rather than a byte per pass of the loop */
+		if ((USB_DeviceState == DEVICE_STATE_Configured) && VirtualSerial_CDC_Interface.State.LineEncoding.BaudRateBPS)
+		{
+			Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataOUTEndpointNumber);
+
+			if (Endpoint_IsOUTReceived())
+			{
+				uint8_t BytesInPacket = Endpoint_BytesInEndpoint();
+
+				if (BytesInPacket <= (BUFFER_SIZE - RingBuffer_GetCount(&USBtoUSART_Buffer)))
+				{
+					if (BytesInPacket)
+					{
+						while (BytesInPacket--)
+						  RingBuffer_Insert(&USBtoUSART_Buffer, Endpoint_Read_Byte());
+
+						LEDs_TurnOnLEDs(LEDMASK_RX);
+						PulseMSRemaining.RxLEDPulse = TX_RX_LED_PULSE_MS;
+					}
+
+					Endpoint_ClearOUT();
+				}
+			}
+		}
+
+		/* Let the USART data register empty interrupt drain the buffer into the USART while the target
+		 * can take it. Held back, the buffer fills and the OUT endpoint goes unread, so the host's
+		 * writes stall instead of ending in buffer overflow replies to be retried */
+		bool TargetReady = TARGET_READY();
+
+		if (TargetReady && !(RingBuffer_IsEmpty(&USBtoUSART_Buffer)))
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				UCSR1B |= (1 << UDRIE1);
+			}
+		}
+
+		/* Report the flow control line to the host as DSR, for hosts that would rather pause than block */
+		if ((USB_DeviceState == DEVICE_STATE_Configured) && VirtualSerial_CDC_Interface.State.LineEncoding.BaudRateBPS)
 		{
-			int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
+			uint8_t LineStates = (TargetReady ? CDC_CONTROL_LINE_IN_DSR : 0);
 
-			/* Read bytes from the USB OUT endpoint into the USART transmit buffer */
-			if (!(ReceivedByte < 0))
-			  RingBuffer_Insert(&USBtoUSART_Buffer, ReceivedByte);
+			if (LineStates != ReportedLineStates)
+			{
+				VirtualSerial_CDC_Interface.State.ControlLineStates.DeviceToHost = LineStates;
+				CDC_Device_SendControlLineStateChange(&VirtualSerial_CDC_Interface);
+				ReportedLineStates = LineStates;
+			}
 		}
 		
 		/* Check if the UART receive buffer flush timer has expired or the buffer is nearly full */
@@ -106,14 +151,26 @@ int main(void)
 		{
 			TIFR0 |= (1 << TOV0);
 
-			if (USARTtoUSB_Buffer.Count) {
+			if (BufferCount && (USB_DeviceState == DEVICE_STATE_Configured))
+			{
 				LEDs_TurnOnLEDs(LEDMASK_TX);
 				PulseMSRemaining.TxLEDPulse = TX_RX_LED_PULSE_MS;
-			}
 
-			/* Read bytes from the USART receive buffer into the USB IN endpoint */
-			while (BufferCount--)
-			  CDC_Device_SendByte(&VirtualSerial_CDC_Interface, RingBuffer_Remove(&USARTtoUSB_Buffer));
+				/* Write the USART receive buffer to the USB IN endpoint a whole packet at a time, leaving
+				 * whatever doesn't fit for the next pass instead of waiting on the host to free a bank */
+				Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpointNumber);
+
+				while (BufferCount && Endpoint_IsINReady())
+				{
+					uint8_t BytesInPacket = (BufferCount < CDC_TXRX_EPSIZE) ? BufferCount : CDC_TXRX_EPSIZE;
+					BufferCount -= BytesInPacket;
+
+					while (BytesInPacket--)
+					  Endpoint_Write_Byte(RingBuffer_Remove(&USARTtoUSB_Buffer));
+
+					Endpoint_ClearIN();
+				}
+			}
 			  
 			/* Turn off TX LED(s) once the TX pulse period has elapsed */
 			if (PulseMSRemaining.TxLEDPulse && !(--PulseMSRemaining.TxLEDPulse))
@@ -124,14 +181,6 @@ int main(void)
 			  LEDs_TurnOffLEDs(LEDMASK_RX);
 		}
 		
-		/* Load the next byte from the USART transmit buffer into the USART */
-		if (!(RingBuffer_IsEmpty(&USBtoUSART_Buffer))) {
-		  Serial_TxByte(RingBuffer_Remove(&USBtoUSART_Buffer));
-		  	
-		  	LEDs_TurnOnLEDs(LEDMASK_RX);
-			PulseMSRemaining.RxLEDPulse = TX_RX_LED_PULSE_MS;
-		}
-		
 		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
 		USB_USBTask();
 	}
@@ -149,9 +198,17 @@ void SetupHardware(void)
 	LEDs_Init();
 	USB_Init();
 
-	/* Start the flush timer so that overflows occur rapidly to push received bytes to the USB interface */
-	TCCR0B = (1 << CS02);
+	/* Start the flush timer so that overflows occur rapidly to push received bytes to the USB interface.
+	 * At F_CPU / 64 it overflows every 1ms; the bot's short replies would otherwise wait up to 4ms
+	 * for a flush, which costs more than the transfer itself once the link runs above 115200 baud. */
+	TCCR0B = ((1 << CS01) | (1 << CS00));
 	
+#if defined(AVR_FLOW_CONTROL_PIN)
+	/* Pull up the target flow control line, so that it reads ready unless driven low */
+	AVR_FLOW_CONTROL_DDR  &= ~AVR_FLOW_CONTROL_MASK;
+	AVR_FLOW_CONTROL_PORT |= AVR_FLOW_CONTROL_MASK;
+#endif
+
 	/* Pull target /RESET line high */
 	AVR_RESET_LINE_PORT |= AVR_RESET_LINE_MASK;
 	AVR_RESET_LINE_DDR  |= AVR_RESET_LINE_MASK;
@@ -215,7 +272,8 @@ void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCI
 
 	UCSR1C = ConfigMask;
 	UCSR1A = (CDCInterfaceInfo->State.LineEncoding.BaudRateBPS == 57600) ? 0 : (1 << U2X1);
-	UCSR1B = ((1 << RXCIE1) | (1 << TXEN1) | (1 << RXEN1));
+	UCSR1B = ((1 << RXCIE1) | (1 << TXEN1) | (1 << RXEN1) |
+	          (RingBuffer_IsEmpty(&USBtoUSART_Buffer) ? 0 : (1 << UDRIE1)));
 }
 
 /** ISR to manage the reception of data from the serial port, placing received bytes into a circular buffer
@@ -229,6 +287,18 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 	  RingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
 }
 
+/** ISR to feed the serial port from the circular buffer of data from the host, one byte each time the
+ *  USART data register empties. The interrupt disables itself once the buffer runs dry or the target
+ *  holds its flow control line, and the main loop enables it again when there's more to send.
+ */
+ISR(USART1_UDRE_vect, ISR_BLOCK)
+{
+	if (RingBuffer_IsEmpty(&USBtoUSART_Buffer) || !(TARGET_READY()))
+	  UCSR1B &= ~(1 << UDRIE1);
+	else
+	  UDR1 = RingBuffer_Remove(&USBtoUSART_Buffer);
+}
+
 /** Event handler for the CDC Class driver Host-to-Device Line Encoding Changed event.
  *
  *  \param[in] CDCInterfaceInfo  Pointer to the CDC class interface configuration structure being referenced
@@ -66,6 +66,16 @@
 		
 		/** LED mask for the library LED driver, to indicate that the USB interface is busy. */
 		#define LEDMASK_BUSY             (LEDS_LED1 | LEDS_LED2)		
+
+		/** Whether the target can take more data. The target holds its flow control line low while its
+		 *  command buffer is too full for the host's next packets; the line is pulled up, so a target
+		 *  which doesn't drive it is always ready.
+		 */
+		#if defined(AVR_FLOW_CONTROL_PIN)
+			#define TARGET_READY()       ((AVR_FLOW_CONTROL_PIN & AVR_FLOW_CONTROL_MASK) ? true : false)
+		#else
+			#define TARGET_READY()       true
+		#endif
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
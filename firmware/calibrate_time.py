@@ -0,0 +1,203 @@
+#!/usr/bin/env python
+
+# Fits sailtime's print time estimates to a machine from the block times its
+# flight recorder measures, for a FLIGHT_RECORDER build:
+#
+#   calibrate_time.py [-b baud] [-s seconds] [-o file] port
+#
+# Start a build which is mostly moves, then run this for a while during it
+# (120 seconds by default).  The ring is read as fast as it fills; each
+# record holds how long the block before it took, which is paired with the
+# time the planner's own trapezoid gives for that block from its steps,
+# rates and acceleration.  A least squares fit of
+#
+#   measured = cruise * cruising time + ramp * ramping time + block_ms
+#
+# is written to the file (sailtime.cal by default) for sailtime -k.  Blocks
+# the planner ran short of moves for are left out, as their time depends on
+# the file and not on the machine, as are any with a field too big for its
+# record.  Heating and other waits are not blocks, so they're never fitted;
+# sailtime's estimate leaves them out anyway.  Needs pyserial.
+
+from __future__ import print_function
+
+import argparse
+import math
+import struct
+import sys
+import time
+
+import serial
+
+START_BYTE = 0xD5
+RC_OK = 0x81
+HOST_CMD_FLIGHT_RECORDER = 44
+
+FLIGHT_ACCEL = 0x01
+FLIGHT_CRUISE = 0x02
+
+RECORD = struct.Struct('<HHHHHHBB')
+
+def crc8(data):
+    crc = 0
+    for b in bytearray(data):
+        crc ^= b
+        for i in range(8):
+            if crc & 0x01:
+                crc = (crc >> 1) ^ 0x8C
+            else:
+                crc >>= 1
+    return crc
+
+def query(port, payload):
+    port.write(bytearray([START_BYTE, len(payload)]) + payload + bytearray([crc8(payload)]))
+    while True:
+        b = port.read(1)
+        if not b:
+            sys.exit("no reply from the bot")
+        if bytearray(b)[0] == START_BYTE:
+            break
+    length = bytearray(port.read(1))[0]
+    reply = port.read(length)
+    crc = port.read(1)
+    if len(reply) != length or not crc or bytearray(crc)[0] != crc8(reply):
+        sys.exit("garbled reply from the bot")
+    if bytearray(reply)[0] != RC_OK:
+        sys.exit("the bot doesn't support HOST_CMD_FLIGHT_RECORDER; is it a FLIGHT_RECORDER build?")
+    return reply
+
+def read_from(port, seq):
+    """Returns the freeze cause, the next sequence number, the oldest held
+    and the (seq, record) pairs from seq on which fit in a reply"""
+    reply = query(port, struct.pack('<BBH', HOST_CMD_FLIGHT_RECORDER, 0, seq))
+    cause, after, nxt, oldest = struct.unpack('<BHHH', reply[1:8])
+    first = seq if ((nxt - seq) & 0xffff) <= ((nxt - oldest) & 0xffff) else oldest
+    count = bytearray(reply)[8]
+    records = []
+    for i in range(count):
+        records.append(((first + i) & 0xffff, RECORD.unpack_from(reply, 9 + i * RECORD.size)))
+    return cause, nxt, oldest, records
+
+def predict(record):
+    """The cruising and ramping milliseconds of a block as
+    plan_block_time_ms() would have them, or None if the record can't say"""
+    interval, steps, initial, nominal, final, accel, depth, flags = record
+    if steps == 0 or nominal == 0 or 0xffff in (steps, initial, nominal, final, accel):
+        return None
+    accel *= 16
+    if not (flags & FLIGHT_ACCEL) or accel == 0:
+        return steps * 1000.0 / nominal, 0.0
+    if flags & FLIGHT_CRUISE:
+        peak = nominal
+        ramp_steps = (2.0 * peak * peak - initial * initial - final * final) / (2.0 * accel)
+        plateau = max(0.0, steps - ramp_steps)
+    else:
+        peak = min(nominal, math.sqrt((2.0 * accel * steps + initial * initial + final * final) / 2.0))
+        plateau = 0.0
+    ramps = max(0.0, peak - initial) + max(0.0, peak - final)
+    return plateau * 1000.0 / nominal, ramps * 1000.0 / accel
+
+def samples(run):
+    """(cruise ms, ramp ms, measured ms) of each block of a run of
+    consecutive records whose time the next record gives"""
+    out = []
+    for (seq, a), (next_seq, b) in zip(run, run[1:]):
+        if next_seq != ((seq + 1) & 0xffff):
+            continue
+        interval, depth = b[0], b[6]
+        # Set up late as the planner had nothing else, or out of range
+        if depth <= 1 or interval == 0 or interval == 0xffff:
+            continue
+        times = predict(a)
+        if times is not None:
+            out.append((times[0], times[1], interval / 10.0))
+    return out
+
+def solve(rows, columns):
+    """Least squares for the measured time over the given columns of the
+    rows, by the normal equations"""
+    n = len(columns)
+    m = [[0.0] * (n + 1) for i in range(n)]
+    for row in rows:
+        x = [row[c] if c < 2 else 1.0 for c in columns]
+        for i in range(n):
+            for j in range(n):
+                m[i][j] += x[i] * x[j]
+            m[i][n] += x[i] * row[2]
+    for i in range(n):
+        pivot = max(range(i, n), key=lambda r: abs(m[r][i]))
+        if abs(m[pivot][i]) < 1e-9:
+            return None
+        m[i], m[pivot] = m[pivot], m[i]
+        for r in range(n):
+            if r != i:
+                f = m[r][i] / m[i][i]
+                for c in range(i, n + 1):
+                    m[r][c] -= f * m[i][c]
+    return [m[i][n] / m[i][i] for i in range(n)]
+
+def fit(rows):
+    fitted = {0: 1.0, 1: 1.0, 2: 0.0}
+    # A build with no accelerated blocks leaves nothing to fit ramps to
+    columns = [c for c in (0, 1) if any(row[c] > 0.0 for row in rows)] + [2]
+    factors = solve(rows, columns)
+    if factors is None:
+        sys.exit("the blocks seen are too alike to fit; let it run for longer")
+    for c, f in zip(columns, factors):
+        fitted[c] = f
+    return fitted[0], fitted[1], fitted[2]
+
+def main():
+    parser = argparse.ArgumentParser(description='Calibrate sailtime from a FLIGHT_RECORDER build')
+    parser.add_argument('port')
+    parser.add_argument('-b', '--baud', type=int, default=115200)
+    parser.add_argument('-s', '--seconds', type=float, default=120.0)
+    parser.add_argument('-o', '--output', default='sailtime.cal')
+    args = parser.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=2)
+    query(port, struct.pack('<BB', HOST_CMD_FLIGHT_RECORDER, 1))
+    rows, run, seq, lost, freezes = [], [], 0, 0, 0
+    stop = time.time() + args.seconds
+    while time.time() < stop:
+        cause, nxt, oldest, records = read_from(port, seq)
+        if records and records[0][0] != seq:
+            # Overwritten before they were read
+            lost += (records[0][0] - seq) & 0xffff
+            rows += samples(run)
+            run = []
+        run += records
+        seq = (seq + len(records)) & 0xffff
+        if seq != nxt:
+            continue
+        if cause != 0:
+            # Frozen by a stutter or a pause; start over
+            freezes += 1
+            rows += samples(run)
+            run, seq = [], 0
+            query(port, struct.pack('<BB', HOST_CMD_FLIGHT_RECORDER, 1))
+        else:
+            time.sleep(0.005)
+    rows += samples(run)
+
+    if len(rows) < 20:
+        sys.exit("only %d blocks to fit; is a build running?" % len(rows))
+    cruise, ramp, block_ms = fit(rows)
+    measured = sum(row[2] for row in rows)
+    before = sum(row[0] + row[1] for row in rows)
+    after = sum(cruise * row[0] + ramp * row[1] + block_ms for row in rows)
+    rms = math.sqrt(sum((cruise * row[0] + ramp * row[1] + block_ms - row[2]) ** 2
+                        for row in rows) / len(rows))
+
+    print('%d blocks, %d records lost, %d freezes' % (len(rows), lost, freezes))
+    print('measured %.1f s, estimated %.1f s, %.1f s calibrated (rms %.2f ms a block)'
+          % (measured / 1000.0, before / 1000.0, after / 1000.0, rms))
+    print('cruise %.4f, ramp %.4f, block_ms %.3f' % (cruise, ramp, block_ms))
+    with open(args.output, 'w') as f:
+        f.write('# calibrate_time.py, %d blocks from %s\n' % (len(rows), args.port))
+        f.write('cruise %.4f\n' % cruise)
+        f.write('ramp %.4f\n' % ramp)
+        f.write('block_ms %.3f\n' % block_ms)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/python
+#
+# Creates dense, uniformly spaced ADC to temperature tables from the sparse
+# tables in TemperatureTable.cc and ThermistorTables.h
+"""Dense Thermistor Table Generator
+
+Resamples the sparse (adc, temperature) tables, which the firmware binary
+searches, at every 2^bits ADC counts.  The firmware then indexes a dense
+table with a shift and interpolates between two neighbouring entries with
+another shift, instead of searching and dividing.
+
+Temperatures are stored in 1/16 degrees C.  Each table starts with the
+lowest and highest readings it covers, as the sparse table does.
+
+Every reading of every table is checked against the sparse interpolation,
+and the worst error is written into the header and to stderr.
+
+Usage: python createDenseTemperatureLookup.py [options] > src/MightyBoard/shared/TemperatureDenseTables.h
+
+Options:
+  -h, --help			show this help
+  --src=...			path to src/MightyBoard/shared (default: the one next to this script)
+  --max-error=...		fail if a table is out by more than this many degrees C, in the checked range
+  --check-max=...		highest temperature the check covers (default: 300)
+"""
+
+from __future__ import print_function
+import os
+import re
+import sys
+import getopt
+
+FRAC_BITS = 4		# temperatures in 1/16 C
+
+# ADC counts between entries, as a shift.  MightyBoard readings are 10 bit.
+# The Azteeg's are 8 times oversampled, and the entries of its tables fall
+# on multiples of 8, so every entry lands on the dense grid; a coarser step
+# is out by several degrees near 300C on some of them.
+STEP_BITS_MIGHTYBOARD = 3
+STEP_BITS_AZTEEG = 3
+
+# The MightyBoard tables are only used for the platform, which doesn't get
+# this hot; their first entries are too far apart to resample closely
+CHECK_MAX_HBP = 150
+
+TABLE_RE = re.compile(r'(?:const\s+static|static\s+const)\s+Entry\s+(\w+)\[\]\s+PROGMEM\s*=\s*\{(.*?)\};', re.S)
+ENTRY_RE = re.compile(r'\{\s*([^,{}]+?)\s*,\s*(-?\d+)\s*\}')
+
+def parseEntries(body):
+	entries = []
+	for adc, value in ENTRY_RE.findall(body):
+		adc = adc.replace('TEMP_OVERSAMPLE', '8')
+		if not re.match(r'^[\d\s\*]+$', adc):
+			raise ValueError('unexpected ADC value ' + adc)
+		entries.append((eval(adc), int(value)))
+	return entries
+
+def sparse(entries, reading):
+	"As TempReadtoCelsius() interpolates, extrapolating past the last entry"
+	for i in range(1, len(entries)):
+		if reading < entries[i][0] or i == len(entries) - 1:
+			(a0, v0), (a1, v1) = entries[i - 1], entries[i]
+			return v0 + float((reading - a0) * (v1 - v0)) / (a1 - a0)
+
+def dense(entries, bits):
+	lo, hi = entries[0][0], entries[-1][0]
+	step = 1 << bits
+	count = (hi - lo + step - 1) // step + 1
+	values = [int(round(sparse(entries, lo + i * step) * (1 << FRAC_BITS))) for i in range(count)]
+	for i in range(count - 1):
+		if abs(values[i + 1] - values[i]) * (step - 1) > 32767:
+			raise ValueError('interpolation would overflow 16 bits')
+	if max(values) > 32767 or min(values) < -32768:
+		raise ValueError('temperature out of range')
+	return lo, hi, values
+
+def lookup(lo, values, bits, reading):
+	"As TempReadtoCelsius() does with TEMP_DENSE_TABLES set"
+	offset = reading - lo
+	i = offset >> bits
+	frac = offset & ((1 << bits) - 1)
+	t = values[i]
+	if frac:
+		t += ((values[i + 1] - t) * frac) >> bits
+	return float(t) / (1 << FRAC_BITS)
+
+def check(entries, lo, hi, values, bits, check_max):
+	worst, worst_reading = 0.0, lo
+	for reading in range(lo, hi + 1):
+		expected = sparse(entries, reading)
+		if expected < 0 or expected > check_max:
+			continue
+		error = abs(lookup(lo, values, bits, reading) - expected)
+		if error > worst:
+			worst, worst_reading = error, reading
+	return worst, worst_reading
+
+def emit(label, name, entries, bits, check_max, results):
+	lo, hi, values = dense(entries, bits)
+	worst, reading = check(entries, lo, hi, values, bits, check_max)
+	results.append((label, worst))
+	print('// %d entries, worst error %.2fC at reading %d' % (len(values), worst, reading))
+	for i in range(1, len(entries)):
+		# Two entries for one reading; the dense table ramps across the step
+		if entries[i][0] == entries[i - 1][0]:
+			print('// The sparse table steps from %dC to %dC at reading %d' %
+			      (entries[i - 1][1], entries[i][1], entries[i][0]))
+	print('static const int16_t %s[] PROGMEM = {' % name)
+	print('     %d, %d,' % (lo, hi))
+	for i in range(0, len(values), 10):
+		row = ', '.join('%5d' % v for v in values[i:i + 10])
+		print('     %s%s' % (row, ',' if i + 10 < len(values) else ''))
+	print('};')
+
+def mightyboardTables(path):
+	text = open(path).read()
+	g = text.index('#elif BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_G')
+	a = text.index('#elif BOARD_TYPE == BOARD_TYPE_AZTEEG_X3')
+	boards = []
+	for board, section in (('MIGHTYBOARD_E', text[:g]), ('MIGHTYBOARD_G', text[g:a])):
+		for name, body in TABLE_RE.findall(section):
+			# Thermocouple readings are left to the binary search
+			if name == 'table_hbp_thermistor':
+				boards.append((board, parseEntries(body)))
+	return boards
+
+def azteegTables(path):
+	text = open(path).read()
+	tables = []
+	for block in re.split(r'\n#if MY_INDEX == ', text)[1:]:
+		index = block.split(None, 1)[0]
+		found = TABLE_RE.findall(block)
+		if found:
+			tables.append((index, parseEntries(found[0][1])))
+		else:
+			sys.stderr.write('MY_INDEX %s: no table found, skipped\n' % index)
+	return tables
+
+def main(argv):
+	src = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'src', 'MightyBoard', 'shared')
+	max_error = None
+	check_max = 300
+
+	try:
+		opts, args = getopt.getopt(argv, "h", ["help", "src=", "max-error=", "check-max="])
+	except getopt.GetoptError:
+		usage()
+		sys.exit(2)
+
+	for opt, arg in opts:
+		if opt in ("-h", "--help"):
+			usage()
+			sys.exit()
+		elif opt == "--src":
+			src = arg
+		elif opt == "--max-error":
+			max_error = float(arg)
+		elif opt == "--check-max":
+			check_max = int(arg)
+
+	results = []
+
+	print("// Dense thermistor tables, indexed by (reading - first) >> TEMP_DENSE_STEP_BITS")
+	print("// Made with createDenseTemperatureLookup.py from the tables in TemperatureTable.cc")
+	print("// and ThermistorTables.h; regenerate it when they change")
+	print("// Errors are against the sparse tables, for readings of 0 to %dC (%dC for" % (check_max, CHECK_MAX_HBP))
+	print("// the MightyBoard platform tables)")
+	print("//")
+	print("// No include guard: TemperatureTable.cc includes this once for the MightyBoards,")
+	print("// and ThermistorTables.h once for each Azteeg table slot, with MY_INDEX and")
+	print("// MY_TABLE set.  The dense table for MY_TABLE is named MY_TABLE_dense.")
+	print("")
+	print("#define TEMP_DENSE_FRAC_BITS %d" % FRAC_BITS)
+	print("")
+	print("#define TEMP_DENSE_CAT(t) t ## _dense")
+	print("#define TEMP_DENSE_NAME(t) TEMP_DENSE_CAT(t)")
+
+	first = True
+	for board, entries in mightyboardTables(os.path.join(src, 'TemperatureTable.cc')):
+		print("")
+		print("#%s BOARD_TYPE == BOARD_TYPE_%s" % ("if" if first else "elif", board))
+		print("")
+		print("#define TEMP_DENSE_STEP_BITS %d" % STEP_BITS_MIGHTYBOARD)
+		print("")
+		emit(board, 'table_hbp_thermistor_dense', entries, STEP_BITS_MIGHTYBOARD,
+		     min(check_max, CHECK_MAX_HBP), results)
+		first = False
+
+	print("")
+	print("#elif BOARD_TYPE == BOARD_TYPE_AZTEEG_X3")
+	print("")
+	print("#define TEMP_DENSE_STEP_BITS %d" % STEP_BITS_AZTEEG)
+	for index, entries in azteegTables(os.path.join(src, 'ThermistorTables.h')):
+		print("")
+		print("#if MY_INDEX == %s" % index)
+		emit('MY_INDEX ' + index, 'TEMP_DENSE_NAME(MY_TABLE)', entries, STEP_BITS_AZTEEG,
+		     check_max, results)
+		print("#endif")
+	print("")
+	print("#endif")
+
+	failed = False
+	for name, worst in results:
+		sys.stderr.write('%-28s worst error %.2fC\n' % (name, worst))
+		if max_error is not None and worst > max_error:
+			failed = True
+	if failed:
+		sys.stderr.write('worst error above %.2fC\n' % max_error)
+		sys.exit(1)
+
+def usage():
+	print(__doc__)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -8,45 +8,205 @@
 #   u16  unsigned 16-bit int
 #   f8.8 8.8 fixed point
 # The value can be any integer or float value recognized by python.
+#
+#   make-eeprom.py [-z size] [-f image] [-o image] [-p port [-b baud] [-r]] < csv
+#
+# The image starts out erased, or as the file given with -f (an image saved
+# with -o, say, or one read from a machine which is set up as it should be),
+# and the CSV's values go over it.  By default it's printed as Intel hex.
+# With -o it's saved as a binary image instead, and with -p it's sent to an
+# EEPROM_IMAGE build with HOST_CMD_EEPROM_IMAGE: run length encoded unless
+# -r is given, only the bytes which differ written, and the whole checked
+# against the CRC the bot gives back.  The bot keeps its own lifetime
+# counters.  Sending needs pyserial.
 
+from __future__ import print_function
+
+import argparse
+import struct
 import sys
+import time
+
+START_BYTE = 0xD5
+RC_OK = 0x81
+RC_BOT_BUILDING = 0x8A
+HOST_CMD_EEPROM_IMAGE = 47
 
-size = 0x200
-
-buffer = [0xff]*size
-for line in sys.stdin.readlines():
-    if line.startswith("#"):
-        continue
-    fields = line.strip().split(",")
-    if len(fields) == 3:
-        [addrstr,typestr,valstr] = fields;
-        addr = int(addrstr,16)
-        val = eval(valstr)
-        if typestr == "u8":
-            buffer[addr] = val;
-        elif typestr == "u16":
-            buffer[addr] = val & 0xff
-            buffer[addr+1] = (val >> 8) & 0xff
-        elif typestr == "f8.8":
-            buffer[addr] = int(val) & 0xff
-            buffer[addr+1] = int(val*256) & 0xff
+MAX_PACKET_PAYLOAD = 32
+
+def parse(lines, buffer):
+    for line in lines:
+        if line.startswith("#"):
+            continue
+        fields = line.strip().split(",")
+        if len(fields) == 3:
+            [addrstr,typestr,valstr] = fields;
+            addr = int(addrstr,16)
+            val = eval(valstr)
+            if typestr == "u8":
+                buffer[addr] = val;
+            elif typestr == "u16":
+                buffer[addr] = val & 0xff
+                buffer[addr+1] = (val >> 8) & 0xff
+            elif typestr == "f8.8":
+                buffer[addr] = int(val) & 0xff
+                buffer[addr+1] = int(val*256) & 0xff
 
 # EEPROM GENERATION
 
-offset = 0
-blocksize = 16
-
-while size > 0:
-    codes = []
-    linesize = min(blocksize,size)
-    codes.append(linesize)
-    codes.append(offset>>8)
-    codes.append(offset&0xff)
-    codes.append(0) # data code
-    codes.extend(buffer[offset:offset+linesize])
-    # calculate checksum
-    checksum=(0x100-(sum(codes)&0xff))&0xff
-    codes.append(checksum)
-    print reduce(lambda s,v:s+'{0:02X}'.format(v), codes, ":")
-    offset += linesize
-    size -= linesize
+def print_hex(buffer):
+    size = len(buffer)
+    offset = 0
+    blocksize = 16
+
+    while size > 0:
+        codes = []
+        linesize = min(blocksize,size)
+        codes.append(linesize)
+        codes.append(offset>>8)
+        codes.append(offset&0xff)
+        codes.append(0) # data code
+        codes.extend(buffer[offset:offset+linesize])
+        # calculate checksum
+        checksum=(0x100-(sum(codes)&0xff))&0xff
+        codes.append(checksum)
+        print(":" + ''.join('{0:02X}'.format(v) for v in codes))
+        offset += linesize
+        size -= linesize
+
+# SENDING
+
+def crc8(data):
+    crc = 0
+    for b in bytearray(data):
+        crc ^= b
+        for i in range(8):
+            if crc & 0x01:
+                crc = (crc >> 1) ^ 0x8C
+            else:
+                crc >>= 1
+    return crc
+
+def crc16(data):
+    """CRC-16 as avr-libc's _crc16_update gives it, from 0xffff"""
+    crc = 0xffff
+    for b in bytearray(data):
+        crc ^= b
+        for i in range(8):
+            if crc & 0x01:
+                crc = (crc >> 1) ^ 0xA001
+            else:
+                crc >>= 1
+    return crc
+
+def query(port, payload):
+    port.write(bytearray([START_BYTE, len(payload)]) + payload + bytearray([crc8(payload)]))
+    while True:
+        b = port.read(1)
+        if not b:
+            sys.exit("no reply from the bot")
+        if bytearray(b)[0] == START_BYTE:
+            break
+    length = bytearray(port.read(1))[0]
+    reply = port.read(length)
+    crc = port.read(1)
+    if len(reply) != length or not crc or bytearray(crc)[0] != crc8(reply):
+        sys.exit("garbled reply from the bot")
+    if bytearray(reply)[0] == RC_BOT_BUILDING:
+        sys.exit("the bot is building; send the image once it's finished")
+    if bytearray(reply)[0] != RC_OK:
+        sys.exit("the bot doesn't support HOST_CMD_EEPROM_IMAGE; is it an EEPROM_IMAGE build?")
+    return reply
+
+def encode(data, start, room):
+    """Run length encodes data from start, as much as fits in room bytes;
+    returns the encoding"""
+    out = bytearray()
+    i = start
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 130 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            if len(out) + 2 > room:
+                break
+            out += bytearray([0x80 | (run - 3), data[i]])
+            i += run
+            continue
+        # Bytes as they are, up to the next run worth encoding
+        j = i
+        while j < len(data) and j - i < 128 and \
+                not (j + 2 < len(data) and data[j] == data[j + 1] == data[j + 2]):
+            j += 1
+        n = min(j - i, room - len(out) - 1)
+        if n <= 0:
+            break
+        out.append(n - 1)
+        out += data[i:i + n]
+        i += n
+    return out
+
+def send(buffer, port, rle):
+    data = bytearray(buffer)
+    reply = query(port, struct.pack('<BB', HOST_CMD_EEPROM_IMAGE, 0))
+    size, keep_start, keep_end = struct.unpack('<HHH', reply[1:7])
+    if len(data) > size:
+        sys.exit("the image is %d bytes but the bot's EEPROM only %d" % (len(data), size))
+
+    room = MAX_PACKET_PAYLOAD - 4
+    offset, packets, stalls, changed = 0, 0, 0, 0
+    start = time.time()
+    while offset < len(data):
+        if keep_start <= offset < keep_end:
+            offset = keep_end
+            continue
+        if rle:
+            chunk = encode(data, offset, room)
+        else:
+            chunk = data[offset:offset + room]
+        reply = query(port, struct.pack('<BBH', HOST_CMD_EEPROM_IMAGE, 2 if rle else 1, offset) + chunk)
+        packets += 1
+        taken, changed = struct.unpack('<HH', reply[1:5])
+        if taken == offset:
+            # The write queue is full
+            stalls += 1
+            time.sleep(0.02)
+        offset = taken
+
+    reply = query(port, struct.pack('<BBHH', HOST_CMD_EEPROM_IMAGE, 3, 0, len(data)))
+    crc, changed = struct.unpack('<HH', reply[1:5])
+    expected = crc16(data[:keep_start] + data[keep_end:])
+    print('%d bytes in %d packets (%d waiting for the writes), %d changed, %.1f s'
+          % (len(data), packets, stalls, changed, time.time() - start))
+    if crc != expected:
+        sys.exit("verify failed: the bot has CRC %04x, the image %04x" % (crc, expected))
+    print('verified, CRC %04x' % crc)
+
+def main():
+    parser = argparse.ArgumentParser(description='Make an EEPROM image from a CSV on stdin')
+    parser.add_argument('-z', '--size', type=lambda s: int(s, 0), default=0x200)
+    parser.add_argument('-f', '--from', dest='base', help='start from this binary image')
+    parser.add_argument('-o', '--output', help='save a binary image rather than print hex')
+    parser.add_argument('-p', '--port', help='send the image to the bot on this port')
+    parser.add_argument('-b', '--baud', type=int, default=115200)
+    parser.add_argument('-r', '--raw', action='store_true', help="don't run length encode")
+    args = parser.parse_args()
+
+    buffer = [0xff]*args.size
+    if args.base:
+        with open(args.base, 'rb') as f:
+            base = bytearray(f.read())[:args.size]
+        buffer[:len(base)] = list(base)
+    parse(sys.stdin.readlines(), buffer)
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(bytearray(buffer))
+    if args.port:
+        import serial
+        send(buffer, serial.Serial(args.port, args.baud, timeout=2), not args.raw)
+    if not args.output and not args.port:
+        print_hex(buffer)
+
+if __name__ == '__main__':
+    main()
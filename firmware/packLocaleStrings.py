@@ -0,0 +1,262 @@
+#!/usr/bin/python
+#
+# Packs the messages of a locale file with a dictionary of common words
+"""Locale String Packer
+
+Reads one of src/MightyBoard/shared/locale/Menu.*.cc and writes it out with
+every message which is a plain string literal packed.  The substrings which
+save the most flash are gathered into a dictionary of up to 127 words, and
+each use of one in a message is replaced by a single byte:
+
+  0x01 - 0x7F	the character itself
+  0x80 - 0xFE	word (byte - 0x80) of LOCALE_WORDS
+  0xFF		the byte which follows it, for characters above 0x7F
+
+The last character of each word has its top bit set, and LOCALE_WORD_OFFSETS
+gives where each starts.  The firmware unpacks messages as it writes them
+when LOCALE_PACKED is defined; the SCons build does this with pack_locale=1.
+
+Messages built from macros are left as they are, as are those in UNPACKED,
+which the firmware takes the length of or indexes into.
+
+Usage: python packLocaleStrings.py [options] Menu.EN.cc > Menu.EN.packed.cc
+
+Options:
+  -h, --help			show this help
+  --max-words=...		most words in the dictionary (default: 127)
+"""
+
+from __future__ import print_function
+import re
+import sys
+import getopt
+
+WORD_FIRST = 0x80
+LITERAL = 0xFF
+MAX_WORDS = LITERAL - WORD_FIRST
+
+MIN_WORD = 2
+MAX_WORD = 20
+
+# Messages the firmware reads other than through the unpacker
+UNPACKED = ('HEATING_MSG', 'HEATING_SPACES_MSG')
+
+MESSAGE_RE = re.compile(r'^(const\s+(?:static\s+)?PROGMEM\s+prog_uchar\s+(\w+)\s*\[\s*\]\s*=\s*)'
+			r'((?:"(?:[^"\\\n]|\\.)*"\s*)+)(;.*)$', re.M)
+LITERAL_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+
+ESCAPES = { 'n': 10, 't': 9, 'r': 13, '0': 0, '\\': 92, '"': 34, "'": 39, '?': 63 }
+
+def unescape(literal):
+	"The bytes of the body of a C string literal"
+	out = bytearray()
+	data = bytearray(literal.encode('latin-1'))
+	i = 0
+	while i < len(data):
+		c = data[i]
+		if c != 92:
+			out.append(c)
+			i += 1
+			continue
+		e = chr(data[i + 1])
+		if e == 'x':
+			j = i + 2
+			while j < len(data) and chr(data[j]) in '0123456789abcdefABCDEF':
+				j += 1
+			out.append(int(bytes(data[i + 2:j]).decode('ascii'), 16) & 0xff)
+			i = j
+		elif e in '01234567':
+			j = i + 1
+			while j < i + 4 and j < len(data) and chr(data[j]) in '01234567':
+				j += 1
+			out.append(int(bytes(data[i + 1:j]).decode('ascii'), 8) & 0xff)
+			i = j
+		elif e in ESCAPES:
+			out.append(ESCAPES[e])
+			i += 2
+		else:
+			raise ValueError('unknown escape \\' + e)
+	return out
+
+def escape(packed):
+	"A C string literal for the bytes, octal escapes don't run on"
+	out = []
+	for c in packed:
+		if c == 34 or c == 92:
+			out.append('\\' + chr(c))
+		elif 32 <= c < 127:
+			out.append(chr(c))
+		else:
+			out.append('\\%03o' % c)
+	return '"' + ''.join(out) + '"'
+
+def candidates(runs):
+	"Savings of each substring of the unpacked runs, were it a word"
+	counts = {}
+	for run in runs:
+		n = len(run)
+		for i in range(n):
+			for l in range(MIN_WORD, min(MAX_WORD, n - i) + 1):
+				w = bytes(run[i:i + l])
+				counts[w] = counts.get(w, 0) + 1
+	best, best_saving = None, 0
+	for w, count in counts.items():
+		if count < 2:
+			continue
+		# Each use saves all but a byte, and the word costs its
+		# characters and an offset
+		saving = count * (len(w) - 1) - (len(w) + 2)
+		# Ties go the same way whatever order the counts come in
+		if saving > best_saving or (saving == best_saving and best is not None and w < best):
+			best, best_saving = w, saving
+	return best, best_saving
+
+def split(message, word, token):
+	"Replace the uses of word in the runs of plain characters"
+	out = []
+	for part in message:
+		if not isinstance(part, bytearray):
+			out.append(part)
+			continue
+		pieces = bytes(part).split(word)
+		for k, piece in enumerate(pieces):
+			if k:
+				out.append(token)
+			if piece:
+				out.append(bytearray(piece))
+	return out
+
+def pack(messages, max_words):
+	"Choose the words greedily, replacing each before the next is chosen"
+	words = []
+	while len(words) < max_words:
+		runs = [part for message in messages.values() for part in message
+			if isinstance(part, bytearray)]
+		word, saving = candidates(runs)
+		if word is None:
+			break
+		token = WORD_FIRST + len(words)
+		for name in messages:
+			messages[name] = split(messages[name], word, token)
+		words.append(word)
+	return words
+
+def parts(body):
+	"Runs of plain characters, which words may be taken from, and the bytes above 0x7F"
+	out = []
+	for run in re.split(b'([\x80-\xff]+)', bytes(body)):
+		if not run:
+			continue
+		if bytearray(run)[0] >= WORD_FIRST:
+			out.append(bytes(run))
+		else:
+			out.append(bytearray(run))
+	return out
+
+def encode(message):
+	out = bytearray()
+	for part in message:
+		if isinstance(part, int):
+			out.append(part)
+		elif isinstance(part, bytearray):
+			out += part
+		else:
+			for c in bytearray(part):
+				out.append(LITERAL)
+				out.append(c)
+	return out
+
+def main(argv):
+	max_words = MAX_WORDS
+
+	try:
+		opts, args = getopt.getopt(argv, "h", ["help", "max-words="])
+	except getopt.GetoptError:
+		usage()
+		sys.exit(2)
+
+	for opt, arg in opts:
+		if opt in ("-h", "--help"):
+			usage()
+			sys.exit()
+		elif opt == "--max-words":
+			max_words = min(int(arg), MAX_WORDS)
+
+	if len(args) != 1:
+		usage()
+		sys.exit(2)
+
+	text = open(args[0], 'rb').read().decode('latin-1')
+
+	messages = {}
+	size = 0
+	for m in MESSAGE_RE.finditer(text):
+		name = m.group(2)
+		if name in UNPACKED:
+			continue
+		body = bytearray()
+		for literal in LITERAL_RE.findall(m.group(3)):
+			body += unescape(literal)
+		# A message defined under two #if branches is packed once
+		# for each, and they only share words
+		if name in messages and messages[name][0] != body:
+			name = (name, m.start())
+		messages[name] = (body, parts(body))
+	size = sum(len(body) + 1 for body, p in messages.values())
+
+	split_messages = dict((name, p) for name, (body, p) in messages.items())
+	words = pack(split_messages, max_words)
+	packed = dict((name, encode(p)) for name, p in split_messages.items())
+
+	def replace(m):
+		name = m.group(2)
+		if (name, m.start()) in packed:
+			name = (name, m.start())
+		if name not in packed:
+			return m.group(0)
+		return m.group(1) + escape(packed[name]) + m.group(4)
+
+	out = MESSAGE_RE.sub(replace, text)
+
+	dictionary = bytearray()
+	offsets = []
+	for w in words:
+		offsets.append(len(dictionary))
+		w = bytearray(w)
+		w[-1] |= 0x80
+		dictionary += w
+
+	packed_size = sum(len(p) + 1 for p in packed.values()) + len(dictionary) + 2 * len(words)
+
+	lines = []
+	lines.append('// Packed by packLocaleStrings.py from %s; build with LOCALE_PACKED' %
+		     args[0].replace('\\', '/').split('/')[-1])
+	lines.append('// %d messages in %d bytes, %d with the dictionary of %d words' %
+		     (len(packed), size, packed_size, len(words)))
+	lines.append('')
+	lines.append(out.rstrip('\n'))
+	lines.append('')
+	lines.append('const PROGMEM prog_uchar LOCALE_WORDS[] = {')
+	for i in range(0, len(dictionary), 12):
+		lines.append('     %s,' % ', '.join('0x%02x' % c for c in dictionary[i:i + 12]))
+	lines.append('     0')
+	lines.append('};')
+	lines.append('')
+	lines.append('const PROGMEM uint16_t LOCALE_WORD_OFFSETS[] = {')
+	for i in range(0, len(offsets), 10):
+		row = ', '.join('%4d' % o for o in offsets[i:i + 10])
+		lines.append('     %s%s' % (row, ',' if i + 10 < len(offsets) else ''))
+	lines.append('};')
+	lines.append('')
+
+	# The parts left unpacked go out byte for byte as they came in
+	stdout = getattr(sys.stdout, 'buffer', sys.stdout)
+	stdout.write('\n'.join(lines).encode('latin-1'))
+
+	sys.stderr.write('%s: %d bytes of messages packed into %d\n' % (args[0], size, packed_size))
+
+def usage():
+	print(__doc__)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -0,0 +1,214 @@
+#!/usr/bin/python
+#
+# Packs an x3g file into the table format of the onboard utility scripts
+"""Utility Script Packer
+
+Reads an x3g file and prints it as a C table for the onboard scripts of
+src/MightyBoard/Motherboard/UtilityScripts.cc, which unpacks them as it
+plays them.  The packed script is a run of these, each led by a byte op:
+
+  0x00 - 0x3F	(op + 1) bytes of the script follow as they are
+  0x40 - 0x7F	repeat: a byte length L follows, and the L packed bytes
+		before the op are played (op - 0x40 + 1) more times
+  0x80 - 0xFF	a move, HOST_CMD_QUEUE_POINT_NEW or, with bit 6 set,
+		HOST_CMD_QUEUE_POINT_NEW_EXT
+
+The positions and the rest of a move carry over from the move before it.
+Bits 0 - 4 of the op are set for each axis, X to B, which has moved, and an
+int16 of the steps it has moved by follows for each.  Bit 5 is set when the
+rest, the bytes after the positions, follow as well; it always is for the
+first move, and for the first after one of the other kind.  Moves of more
+than an int16 are left as they are, as is everything other than a move.
+Repeats don't nest.
+
+The script is unpacked again and checked before it is printed.
+
+Usage: python packUtilityScript.py [options] script.x3g
+
+Options:
+  -h, --help			show this help
+  --name=...			name of the table (default: Script)
+  --define=...			wrap the table in a #define of this name
+  --length=...			pack only the first this many bytes
+"""
+
+from __future__ import print_function
+import struct
+import sys
+import getopt
+
+LITERAL_MAX = 64
+REPEAT = 0x40
+REPEAT_MAX = 64
+MOVE = 0x80
+MOVE_EXT = 0x40
+MOVE_REST = 0x20
+
+QUEUE_POINT_NEW = 142
+QUEUE_POINT_NEW_EXT = 155
+AXES = 5
+
+# Lengths of the commands with the command byte, for those which have one
+LENGTHS = { 131: 8, 132: 8, 133: 5, 134: 2, 135: 6, 137: 2, 139: 25, 140: 21,
+	141: 6, 142: 26, 143: 2, 144: 2, 145: 3, 146: 6, 147: 6, 148: 5, 150: 3,
+	151: 2, 152: 2, 154: 2, 155: 32, 156: 2, 157: 21, 158: 5, 162: 4, 163: 6,
+	164: 2, 165: 19, 166: 2 }
+# Commands of 4 bytes and a string
+STRINGS = (149, 153)
+TOOL_COMMAND = 136
+
+def commands(data):
+	"Split the script into its commands"
+	i = 0
+	while i < len(data):
+		c = data[i]
+		if c in LENGTHS:
+			n = LENGTHS[c]
+		elif c in STRINGS:
+			n = data.index(0, i + 5) + 1 - i
+		elif c == TOOL_COMMAND:
+			n = 4 + data[i + 3]
+		else:
+			raise ValueError("unknown command %d at byte %d" % (c, i))
+		yield data[i:i + n]
+		i += n
+	if i != len(data):
+		raise ValueError("the last command is cut short")
+
+def ops(data):
+	"The ops of the script, before repeats are found"
+	out = []
+	literal = bytearray()
+	positions = [0] * AXES
+	kind = rest = None
+	for command in commands(data):
+		if command[0] in (QUEUE_POINT_NEW, QUEUE_POINT_NEW_EXT):
+			moved = struct.unpack('<5i', bytes(command[1:21]))
+			deltas = [ p - q for p, q in zip(moved, positions) ]
+			if all(-32768 <= d <= 32767 for d in deltas):
+				while literal:
+					out.append(bytearray([len(literal[:LITERAL_MAX]) - 1]) + literal[:LITERAL_MAX])
+					literal = literal[LITERAL_MAX:]
+				op = bytearray([MOVE | (MOVE_EXT if command[0] == QUEUE_POINT_NEW_EXT else 0)])
+				for axis, d in enumerate(deltas):
+					if d:
+						op[0] |= 1 << axis
+						op += struct.pack('<h', d)
+				if command[0] != kind or command[21:] != rest:
+					op[0] |= MOVE_REST
+					op += command[21:]
+				kind, rest, positions = command[0], command[21:], list(moved)
+				out.append(op)
+				continue
+		literal += command
+	while literal:
+		out.append(bytearray([len(literal[:LITERAL_MAX]) - 1]) + literal[:LITERAL_MAX])
+		literal = literal[LITERAL_MAX:]
+	return out
+
+def pack(data):
+	"Pack the script, repeating whichever run of ops saves the most at each"
+	o = ops(data)
+	out = bytearray()
+	i = 0
+	while i < len(o):
+		best = None
+		for n in range(1, (len(o) - i) // 2 + 1):
+			block = o[i:i + n]
+			length = sum(map(len, block))
+			if length > 255:
+				break
+			times = 1
+			while times <= REPEAT_MAX and o[i + times * n:i + (times + 1) * n] == block:
+				times += 1
+			saved = (times - 1) * length - 2
+			if times > 1 and saved > 0 and (best is None or saved > best[0]):
+				best = (saved, n, times, length)
+		if best:
+			saved, n, times, length = best
+			out += b''.join(o[i:i + n]) + bytearray([REPEAT | (times - 2), length])
+			i += n * times
+		else:
+			out += o[i]
+			i += 1
+	return out
+
+def unpack(packed):
+	"Unpack it again, as the firmware does"
+	out = bytearray()
+	move = bytearray(32)
+	repeat_left = 0
+	i = 0
+	while i < len(packed):
+		op = packed[i]
+		i += 1
+		if op < REPEAT:
+			out += packed[i:i + op + 1]
+			i += op + 1
+		elif op < MOVE:
+			length = packed[i]
+			i += 1
+			if repeat_left == 0:
+				repeat_left = (op & (REPEAT - 1)) + 1
+			else:
+				repeat_left -= 1
+			if repeat_left:
+				i -= length + 2
+		else:
+			move[0] = QUEUE_POINT_NEW_EXT if op & MOVE_EXT else QUEUE_POINT_NEW
+			n = LENGTHS[move[0]]
+			positions = list(struct.unpack('<5i', bytes(move[1:21])))
+			for axis in range(AXES):
+				if op & (1 << axis):
+					positions[axis] += struct.unpack('<h', bytes(packed[i:i + 2]))[0]
+					i += 2
+			move[1:21] = struct.pack('<5i', *positions)
+			if op & MOVE_REST:
+				move[21:n] = packed[i:i + n - 21]
+				i += n - 21
+			out += move[:n]
+	return out
+
+def usage():
+	print(__doc__)
+	sys.exit(2)
+
+def main(argv):
+	try:
+		opts, args = getopt.getopt(argv, "h", ["help", "name=", "define=", "length="])
+	except getopt.GetoptError:
+		usage()
+	if len(args) != 1:
+		usage()
+
+	name = 'Script'
+	define = None
+	length = None
+	for opt, arg in opts:
+		if opt in ("-h", "--help"):
+			usage()
+		elif opt == "--name":
+			name = arg
+		elif opt == "--define":
+			define = arg
+		elif opt == "--length":
+			length = int(arg)
+
+	data = bytearray(open(args[0], 'rb').read())
+	if length is not None:
+		data = data[:length]
+	packed = pack(data)
+	if unpack(packed) != data:
+		sys.exit("%s: the packed script doesn't unpack to the same bytes" % args[0])
+
+	end = ' \\' if define else ''
+	head = "const static uint8_t %s[] PROGMEM = {" % name
+	print(("#define %s %s" % (define, head) if define else head) + end)
+	rows = [ packed[i:i + 16] for i in range(0, len(packed), 16) ]
+	for r, row in enumerate(rows):
+		line = ','.join('%d' % b for b in row)
+		print(line + ('};' if r == len(rows) - 1 else ',' + end))
+	print("// %d bytes, %d packed" % (len(data), len(packed)), file=sys.stderr)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -0,0 +1,129 @@
+#!/usr/bin/env python
+
+# Runs the sampling profiler of a PC_PROFILE build over the serial port and
+# prints where the time went, by function, from the symbols of the ELF the
+# build made:
+#
+#   pcprof.py [-b baud] [-s seconds] [--base addr] [--shift n] port elf
+#
+# The profile is started afresh, left to sample for the given seconds (10
+# by default) and read back.  At first the buckets are 2KB each over the
+# whole of the flash, which is too coarse to tell small functions apart;
+# once the busy part is known, run it again with --base at its start and a
+# smaller --shift to look closer.  A bucket shared by several functions is
+# split between them by how much of it each takes up, so the figures for
+# them are only estimates; those are marked with a ~.  Needs pyserial, and
+# avr-nm on the path or given with --nm.
+
+from __future__ import print_function
+
+import argparse
+import struct
+import subprocess
+import sys
+import time
+
+import serial
+
+START_BYTE = 0xD5
+RC_OK = 0x81
+HOST_CMD_PC_PROFILE = 45
+
+def crc8(data):
+    crc = 0
+    for b in bytearray(data):
+        crc ^= b
+        for i in range(8):
+            if crc & 0x01:
+                crc = (crc >> 1) ^ 0x8C
+            else:
+                crc >>= 1
+    return crc
+
+def query(port, payload):
+    port.write(bytearray([START_BYTE, len(payload)]) + payload + bytearray([crc8(payload)]))
+    while True:
+        b = port.read(1)
+        if not b:
+            sys.exit("no reply from the bot")
+        if bytearray(b)[0] == START_BYTE:
+            break
+    length = bytearray(port.read(1))[0]
+    reply = port.read(length)
+    crc = port.read(1)
+    if len(reply) != length or not crc or bytearray(crc)[0] != crc8(reply):
+        sys.exit("garbled reply from the bot")
+    if bytearray(reply)[0] != RC_OK:
+        sys.exit("the bot doesn't support HOST_CMD_PC_PROFILE; is it a PC_PROFILE build?")
+    return reply
+
+def status(reply):
+    running, base, shift, buckets, outside = struct.unpack('<BIBBH', reply[1:10])
+    return base, shift, buckets, outside
+
+def read_buckets(port):
+    counts = []
+    while True:
+        reply = query(port, struct.pack('<BBB', HOST_CMD_PC_PROFILE, 0, len(counts)))
+        base, shift, buckets, outside = status(reply)
+        n = bytearray(reply)[10]
+        counts += struct.unpack('<%dH' % n, reply[11:11 + 2 * n])
+        if n == 0 or len(counts) >= buckets:
+            return base, shift, counts, outside
+
+def functions(nm, elf):
+    out = subprocess.check_output([nm, '-C', '-n', '-S', elf]).decode('latin-1')
+    funcs = []
+    for line in out.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4 and fields[2] in 'tTwW':
+            funcs.append((int(fields[0], 16), int(fields[1], 16), fields[3]))
+    return funcs
+
+def main():
+    parser = argparse.ArgumentParser(description='Profile a PC_PROFILE build')
+    parser.add_argument('port')
+    parser.add_argument('elf')
+    parser.add_argument('-b', '--baud', type=int, default=115200)
+    parser.add_argument('-s', '--seconds', type=float, default=10.0)
+    parser.add_argument('--base', type=lambda s: int(s, 0), default=0)
+    parser.add_argument('--shift', type=int, default=11)
+    parser.add_argument('--nm', default='avr-nm')
+    args = parser.parse_args()
+
+    funcs = functions(args.nm, args.elf)
+    port = serial.Serial(args.port, args.baud, timeout=2)
+    query(port, struct.pack('<BBIB', HOST_CMD_PC_PROFILE, 1, args.base, args.shift))
+    time.sleep(args.seconds)
+    base, shift, counts, outside = read_buckets(port)
+    query(port, struct.pack('<BB', HOST_CMD_PC_PROFILE, 2))
+
+    total = sum(counts) + outside
+    if total == 0:
+        sys.exit("no samples")
+    size = 1 << shift
+    share = {}
+    shared = set()
+    for i, count in enumerate(counts):
+        if count == 0:
+            continue
+        lo = base + i * size
+        hi = lo + size
+        parts = [(min(hi, a + s) - max(lo, a), name) for a, s, name in funcs
+                 if a < hi and a + s > lo]
+        covered = sum(p[0] for p in parts)
+        if covered == 0:
+            parts, covered = [(1, '?%06x' % lo)], 1
+        for width, name in parts:
+            share[name] = share.get(name, 0.0) + count * float(width) / covered
+            if len(parts) > 1:
+                shared.add(name)
+
+    print('%d samples, %d outside 0x%x-0x%x' % (total, outside, base, base + len(counts) * size))
+    for name, count in sorted(share.items(), key=lambda kv: -kv[1]):
+        if count * 1000 < total:
+            break
+        print('%s%6.2f%%  %s' % ('~' if name in shared else ' ', 100.0 * count / total, name))
+
+if __name__ == '__main__':
+    main()
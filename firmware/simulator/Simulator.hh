@@ -20,7 +20,8 @@
 #define _BV(x) (1 << (x))
 #endif
 
-#ifndef FPTYPE
+// The planner's fixed point, unless it's built with -DNOFIXED for float
+#if !defined(FPTYPE) && !defined(NOFIXED)
 #define FPTYPE _iAccum
 #endif
 
@@ -28,6 +29,31 @@
 #define FORCE_INLINE inline
 #endif
 
+// divkF() works out the AVR's exactly rounded quotient a bit at a time,
+// which is most of the planner's time on the host.  Unchecked builds have
+// the host divide in one go, for the same result.
+#if defined(SIMULATOR_UNCHECKED) && !defined(AVRFIX_ORIGINAL_DIVSQRT)
+static inline _iAccum divk_host(_iAccum x, _iAccum y)
+{
+     if (y == 0)
+	  return (x < 0 ? AVRFIX_ACCUM_MIN : AVRFIX_ACCUM_MAX);
+     if (x == 0)
+	  return 0;
+
+     uint32_t ux = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+     uint32_t uy = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+     uint64_t q  = ((uint64_t)ux << (AVRFIX_ACCUM_FBIT + 1)) / uy;
+
+     q = (q >> 1) + (q & 1);
+     if (q > (uint64_t)AVRFIX_ACCUM_MAX)
+	  return ((x < 0) != (y < 0) ? AVRFIX_ACCUM_MIN : AVRFIX_ACCUM_MAX);
+     return ((x < 0) != (y < 0) ? -(_iAccum)q : (_iAccum)q);
+}
+
+#undef divk
+#define divk(a,b) divk_host((a),(b))
+#endif
+
 // avr-gcc makes double the same as float
 #define double float
 
@@ -45,6 +71,8 @@
 #define HAS_STEPPER_ACCELERATION
 #endif
 
+// Checked fixed point arithmetic, which counts and reports overflows
+#if !defined(NOFIXED) && !defined(SIMULATOR_UNCHECKED)
 extern FPTYPE ftofpS(float x, int lineno, const char *src);
 extern FPTYPE itofpS(int32_t x, int lineno, const char *src);
 extern FPTYPE fpsquareS(FPTYPE x, int lineno, const char *src);
@@ -55,11 +83,28 @@ extern FPTYPE fpdivS(FPTYPE x, FPTYPE y, int lineno, const char *src);
 extern FPTYPE fpsqrtS(FPTYPE x, int lineno, const char *src);
 extern FPTYPE fpabsS(FPTYPE x, int lineno, const char *src);
 extern FPTYPE fpscale2S(FPTYPE x, int lineno, const char *src);
+#endif
 
 #ifdef linux
 extern size_t strlcat(char *dst, const char *src, size_t size);
 #endif
 
+// avr-libc's <util/crc16.h> has it in assembly; this is the C it documents
+static inline uint8_t _crc_ibutton_update(uint8_t crc, uint8_t data)
+{
+     uint8_t i;
+
+     crc = crc ^ data;
+     for (i = 0; i < 8; i++)
+     {
+	  if (crc & 0x01)
+	       crc = (crc >> 1) ^ 0x8C;
+	  else
+	       crc >>= 1;
+     }
+     return crc;
+}
+
 #endif
 
 #endif
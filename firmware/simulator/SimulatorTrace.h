@@ -0,0 +1,61 @@
+// SimulatorTrace.h
+// Binary trace of the blocks the simulator plans, one fixed size record
+// per block as plan_dump_current_block() steps it out.  Written by the
+// simulator's -T switch and read by simtrace.
+//
+// The file is a simtrace_header_t followed by the records, in the byte
+// order of the machine which wrote it; the magic number reads backwards
+// on a machine of the other order.
+
+#ifndef SIMULATOR_TRACE_H_
+
+#define SIMULATOR_TRACE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIMTRACE_MAGIC   0x43525453  // "STRC"
+#define SIMTRACE_VERSION 1
+
+typedef struct {
+     uint32_t magic;
+     uint16_t version;
+     uint16_t record_size;   // sizeof(simtrace_record_t); records may grow
+} simtrace_header_t;
+
+// Record flags
+#define SIMTRACE_ACCEL          0x01  // block was accelerated
+#define SIMTRACE_NOMINAL_LENGTH 0x02  // nominal speed always reached
+#define SIMTRACE_RECALCULATE    0x04  // recalculate flag still set
+#define SIMTRACE_OVERRUN        0x08  // cost model: an interrupt overran
+#define SIMTRACE_STARVED        0x10  // cost model: too short to plan the next
+
+typedef struct {
+     uint32_t index;             // block number, from 1
+     int32_t  steps[5];          // x, y, z, a, b, signed by direction
+     uint32_t step_event_count;
+     int32_t  accelerate_until;
+     int32_t  decelerate_after;
+     uint32_t initial_rate;      // steps/s
+     uint32_t peak_rate;
+     uint32_t final_rate;
+     uint32_t nominal_rate;
+     float    entry_speed;       // mm/s
+     float    nominal_speed;
+     float    exit_speed;
+     float    millimeters;
+     float    z;                 // height after the block, in mm
+     float    duration;          // s
+     uint16_t planned;           // times passed to calculate_trapezoid_for_block()
+     uint8_t  flags;             // SIMTRACE_ flags
+     uint8_t  extruder;          // active extruder
+} simtrace_record_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
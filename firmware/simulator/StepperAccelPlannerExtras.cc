@@ -16,6 +16,7 @@
 #include "Steppers.hh"
 #include "StepperAccelPlanner.hh"
 #include "StepperAccelPlannerExtras.hh"
+#include "SimulatorTrace.h"
 #include "avrfix.h"
 
 #define min(a,b) (((a)<=(b))?(a):(b))
@@ -26,6 +27,14 @@ bool     simulator_use_max_feed_rate  = false;
 FPTYPE   simulator_max_feed_rate      = 0;
 bool     simulator_dump_speeds        = false;
 bool     simulator_show_alt_feed_rate = false;
+bool     simulator_quiet_overflows    = false;
+uint32_t simulator_overflow_count     = 0;
+bool     simulator_cost_model         = false;
+
+simulator_cycles_t simulator_cycles   = { 180, 28, 260, 1400, 28000, 3200 };
+
+bool                 simulator_time_calibrated = false;
+simulator_time_cal_t simulator_time_cal        = { 1.0, 1.0, 0.0 };
 
 uint32_t z1[100000];
 uint32_t z2[100000];
@@ -57,6 +66,14 @@ static int planner_counts[BLOCK_BUFFER_SIZE+1];
 // Track total time required to print
 static float total_time = 0.0;
 
+// and the time of the last block stepped out, in 2 MHz ticks
+static uint32_t last_block_ticks = 0;
+
+// and how far the X, Y and Z axes moved, and how many times they started
+// from the minimum planner speed
+static float    total_xyz_mm = 0.0;
+static uint32_t total_stops  = 0;
+
 // Storage for the plan_record() counters
 static int record_add    = 0;
 static int record_mul    = 0;
@@ -140,6 +157,12 @@ void st_set_e_position(const int32_t &a, const int32_t &b)
   CRITICAL_SECTION_END;
 }
 
+// The simulator doesn't step the blocks, so there's no playing them at
+// another speed factor
+void st_set_speed_factor(uint16_t)
+{
+}
+
 int32_t st_get_position(uint8_t axis)
 {
   int32_t count_pos;
@@ -270,6 +293,137 @@ float filamentUsed(void)
      return (filamentUsed);
 }
 
+// Binary block trace, when plan_trace_open() has been called
+static FILE *trace_fp = NULL;
+
+typedef char simtrace_size_check[(sizeof(simtrace_record_t) == 80) ? 1 : -1];
+
+int plan_time_cal_load(const char *fname)
+{
+     FILE *fp = fopen(fname, "r");
+     if (!fp)
+     {
+	  fprintf(stderr, "Unable to open the calibration file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  return(-1);
+     }
+
+     simulator_time_cal_t cal = { 1.0, 1.0, 0.0 };
+     char line[128], name[32];
+     float value;
+     int lineno = 0;
+     while (fgets(line, sizeof(line), fp))
+     {
+	  lineno++;
+	  if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+	       continue;
+	  if (2 == sscanf(line, "%31s %f", name, &value))
+	  {
+	       if (!strcmp(name, "cruise"))
+	       {
+		    cal.cruise = value;
+		    continue;
+	       }
+	       if (!strcmp(name, "ramp"))
+	       {
+		    cal.ramp = value;
+		    continue;
+	       }
+	       if (!strcmp(name, "block_ms"))
+	       {
+		    cal.block_ms = value;
+		    continue;
+	       }
+	  }
+	  fprintf(stderr, "%s:%d: expected \"cruise\", \"ramp\" or \"block_ms\" and a number\n",
+		  fname, lineno);
+	  fclose(fp);
+	  return(-1);
+     }
+     fclose(fp);
+
+     simulator_time_cal = cal;
+     simulator_time_calibrated = true;
+     return(0);
+}
+
+int plan_trace_open(const char *fname)
+{
+     simtrace_header_t hdr;
+
+     if (!(trace_fp = fopen(fname, "wb")))
+     {
+	  fprintf(stderr, "Unable to open the trace file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  return(-1);
+     }
+     setvbuf(trace_fp, NULL, _IOFBF, 1 << 16);
+
+     hdr.magic       = SIMTRACE_MAGIC;
+     hdr.version     = SIMTRACE_VERSION;
+     hdr.record_size = sizeof(simtrace_record_t);
+     if (1 != fwrite(&hdr, sizeof(hdr), 1, trace_fp))
+     {
+	  plan_trace_close();
+	  return(-1);
+     }
+     return(0);
+}
+
+int plan_trace_close(void)
+{
+     int iret;
+
+     if (!trace_fp)
+	  return(0);
+     iret = fclose(trace_fp);
+     trace_fp = NULL;
+     return(iret);
+}
+
+// Cost model totals
+#define F_CPU_SIM 16000000.0
+#define CYCLES_PER_TICK 8	// the stepper timer runs at 2 MHz
+
+static uint64_t cost_isr_cycles  = 0;	// in all interrupts
+static uint64_t cost_plan_cycles = 0;	// planning all blocks
+static uint32_t cost_overruns    = 0;	// interrupts longer than their interval
+static uint32_t cost_overrun_blocks = 0;
+static uint32_t cost_starved_blocks = 0;	// too short to plan the next one in
+static float    cost_peak_load   = 0.0;	// worst block's interrupt share of the cpu
+
+// Per block
+static uint64_t blk_isr_cycles;
+static uint32_t blk_overruns;
+static float    blk_worst;		// worst interrupt, as a share of its interval
+static bool     blk_first;		// the next interrupt also runs setup_next_block()
+
+static void cost_one(uint32_t cycles, uint32_t budget, uint32_t count)
+{
+     blk_isr_cycles += (uint64_t)cycles * count;
+     if (cycles > budget)
+	  blk_overruns += count;
+     if (budget && (float)cycles / (float)budget > blk_worst)
+	  blk_worst = (float)cycles / (float)budget;
+}
+
+// Charge count interrupts alike, interval ticks apart
+static void cost_interrupt(uint16_t interval, int step_loops, int axes, bool ramp, uint32_t count)
+{
+     uint32_t cycles = simulator_cycles.isr + step_loops * axes * simulator_cycles.step;
+     uint32_t budget = (uint32_t)interval * CYCLES_PER_TICK;
+
+     if (ramp)
+	  cycles += simulator_cycles.ramp;
+     if (blk_first && count)
+     {
+	  cost_one(cycles + simulator_cycles.setup, budget, 1);
+	  count--;
+	  blk_first = false;
+     }
+     cost_one(cycles, budget, count);
+}
+
 #define CHECK_SPEED_CHANGES
 #ifdef CHECK_SPEED_CHANGES
 static int total_violation_count = 0;
@@ -290,6 +444,8 @@ void plan_dump_current_block(int discard, int report)
      uint8_t out_bits;
      static float z_height = 10.0;  // figure z-offset is around 10
      uint16_t timer;
+     int axes, loops;
+     uint8_t trace_flags;
 #ifdef CHECK_SPEED_CHANGES
      static float maxd;
      static float prev_speed[STEPPER_COUNT] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
@@ -300,8 +456,8 @@ void plan_dump_current_block(int discard, int report)
      if (!block)
 	  return;
 
-     if (report && block->message[0] != '\0')
-	  printf("%s", block->message);
+     if (report && plan_block_cold(block)->message[0] != '\0')
+	  printf("%s", plan_block_cold(block)->message);
 
      action[0] = (block->steps[X_AXIS] != 0) ?
 	  (((uint32_t)(0x7fffffff & block->steps[X_AXIS]) == block->step_event_count) ? 'X' : 'x') : ' ';
@@ -315,16 +471,29 @@ void plan_dump_current_block(int discard, int report)
 	  (((uint32_t)(0x7fffffff & block->steps[B_AXIS]) == block->step_event_count) ? 'B' : 'b') : ' ';
      action[5] = '\0';
 
+     axes = 0;
+     for (int j = 0; j < STEPPER_COUNT; j++)
+	  if (block->steps[j] != 0)
+	       axes++;
+     blk_isr_cycles = 0;
+     blk_overruns   = 0;
+     blk_worst      = 0.0;
+     blk_first      = true;
+
      if (block->acceleration_rate == 0)
      {
 	     // No acceleration
 	     initial_rate  = block->nominal_rate;
 	     acc_step_rate = block->nominal_rate;
 	     dec_step_rate = block->nominal_rate;
-	     acceleration_time = calc_timer(acc_step_rate, &step_loops) * block->step_event_count;
+	     timer = calc_timer(acc_step_rate, &step_loops);
+	     acceleration_time = timer * block->step_event_count;
 	     deceleration_time = 0;
 	     coast_time        = 0;
 	     step_events_completed = block->step_event_count;
+	     if (simulator_cost_model)
+		  cost_interrupt(timer, step_loops, axes, false,
+				 (block->step_event_count + step_loops - 1) / step_loops);
      }
      else
      {
@@ -340,6 +509,7 @@ void plan_dump_current_block(int discard, int report)
 
 	     for (step_events_completed = 0; step_events_completed <= block->step_event_count; )
 	     {
+		     loops = step_loops;
 		     step_events_completed += step_loops;
 		     if (step_events_completed <= (uint32_t)(0x7fffffff & block->accelerate_until))
 		     {
@@ -361,6 +531,8 @@ void plan_dump_current_block(int discard, int report)
 				     acc_step_rate = block->nominal_rate;
 			     acceleration_time += timer = calc_timer(acc_step_rate, &step_loops);
 			     dec_step_rate = acc_step_rate;
+			     if (simulator_cost_model)
+				  cost_interrupt(timer, loops, axes, true, 1);
 		     }
 		     else if (step_events_completed > (uint32_t)(0x7fffffff & block->decelerate_after))
 		     {
@@ -381,13 +553,17 @@ void plan_dump_current_block(int discard, int report)
 					    dec_step_rate, acc_step_rate, intermed,
 					    acc_step_rate, block->acceleration_rate,
 					    deceleration_time);
-			     deceleration_time += calc_timer(dec_step_rate, &step_loops);
+			     deceleration_time += timer = calc_timer(dec_step_rate, &step_loops);
+			     if (simulator_cost_model)
+				  cost_interrupt(timer, loops, axes, true, 1);
 		     }
 		     else
 		     {
 			     // Must make this call as it has side effects
-			     coast_time += calc_timer(acc_step_rate, &step_loops);
+			     coast_time += timer = calc_timer(acc_step_rate, &step_loops);
 			     dec_step_rate = acc_step_rate;
+			     if (simulator_cost_model)
+				  cost_interrupt(timer, loops, axes, false, 1);
 		     }
 	     }
      }
@@ -475,12 +651,127 @@ void plan_dump_current_block(int discard, int report)
      }
 
      planner_counts[max(0, min(block->planned, BLOCK_BUFFER_SIZE))] += 1;
-     total_time += (float)(acceleration_time + coast_time + deceleration_time) / 2000000.0;
+     last_block_ticks = (uint32_t)(acceleration_time + coast_time + deceleration_time);
+     total_time += (float)last_block_ticks / 2000000.0;
+     if (simulator_time_calibrated)
+     {
+	  // An unaccelerated block is all at its nominal rate
+	  float cruise = (float)(block->acceleration_rate ? coast_time : last_block_ticks);
+	  float ramp   = (float)(block->acceleration_rate ? acceleration_time + deceleration_time : 0);
+	  total_time += ((simulator_time_cal.cruise - 1.0) * cruise +
+			 (simulator_time_cal.ramp - 1.0) * ramp) / 2000000.0 +
+	       simulator_time_cal.block_ms / 1000.0;
+     }
+
+     if (block->steps[X_AXIS] || block->steps[Y_AXIS] || block->steps[Z_AXIS])
+     {
+	  float dx = stepperAxisStepsToMM_(block->steps[X_AXIS], X_AXIS);
+	  float dy = stepperAxisStepsToMM_(block->steps[Y_AXIS], Y_AXIS);
+	  float dz = stepperAxisStepsToMM_(block->steps[Z_AXIS], Z_AXIS);
+
+	  total_xyz_mm += sqrt(dx*dx + dy*dy + dz*dz);
+	  if (!block->use_accel || block->entry_speed <= minimumPlannerSpeed)
+	       total_stops++;
+     }
+
+     trace_flags = 0;
+     if (simulator_cost_model)
+     {
+	  // The main loop gets what the interrupts leave of the block, and
+	  // in the steady state must plan a block in that time
+	  double block_cycles = (double)(acceleration_time + coast_time + deceleration_time) *
+	       (double)CYCLES_PER_TICK;
+	  uint64_t plan_cycles = simulator_cycles.plan +
+	       (uint64_t)max(block->planned, 0) * simulator_cycles.recalc;
+	  double spare = block_cycles - (double)blk_isr_cycles;
+	  float load = (block_cycles > 0.0) ? (float)((double)blk_isr_cycles / block_cycles) : 0.0f;
+
+	  cost_isr_cycles  += blk_isr_cycles;
+	  cost_plan_cycles += plan_cycles;
+	  cost_overruns    += blk_overruns;
+	  if (load > cost_peak_load)
+	       cost_peak_load = load;
+	  if (blk_overruns)
+	       cost_overrun_blocks++;
+	  if (spare < (double)plan_cycles)
+	       cost_starved_blocks++;
+	  if (blk_overruns)
+	       trace_flags |= SIMTRACE_OVERRUN;
+	  if (spare < (double)plan_cycles)
+	       trace_flags |= SIMTRACE_STARVED;
+	  if (trace_flags && !trace_fp)
+	       printf("*** Block %d [%s]: %.2f ms, interrupts use %.0f%% of the cpu; "
+		      "%u interrupts overrun, worst at %.0f%% of its interval; "
+		      "%.2f ms of %.2f ms needed to plan\n",
+		      i, action, 1000.0 * block_cycles / F_CPU_SIM, 100.0 * load,
+		      blk_overruns, 100.0 * blk_worst,
+		      1000.0 * max(spare, 0.0) / F_CPU_SIM,
+		      1000.0 * (double)plan_cycles / F_CPU_SIM);
+     }
+
+     if (trace_fp)
+     {
+	  simtrace_record_t r;
+	  float mm_per_step = (block->step_event_count != 0) ?
+	       FPTOF(block->millimeters) / (float)block->step_event_count : 0.0f;
+
+	  memset(&r, 0, sizeof(r));
+	  r.index = i;
+	  for (int j = 0; j < STEPPER_COUNT && j < 5; j++)
+	       r.steps[j] = count_direction[j] * block->steps[j];
+	  r.step_event_count = block->step_event_count;
+	  r.accelerate_until = block->accelerate_until;
+	  r.decelerate_after = block->decelerate_after;
+	  r.initial_rate     = initial_rate;
+	  r.peak_rate        = acc_step_rate;
+	  r.final_rate       = dec_step_rate;
+	  r.nominal_rate     = block->nominal_rate;
+	  r.entry_speed      = FPTOF(block->entry_speed);
+	  r.nominal_speed    = FPTOF(block->nominal_speed);
+	  r.exit_speed       = (float)dec_step_rate * mm_per_step;
+	  r.millimeters      = FPTOF(block->millimeters);
+	  r.z                = z_height;
+	  r.duration         = (float)(acceleration_time + coast_time + deceleration_time) / 2000000.0;
+	  r.planned          = (uint16_t)max(block->planned, 0);
+	  r.flags            = trace_flags |
+	       (block->use_accel ? SIMTRACE_ACCEL : 0) |
+	       (block->nominal_length_flag ? SIMTRACE_NOMINAL_LENGTH : 0) |
+	       (block->recalculate_flag ? SIMTRACE_RECALCULATE : 0);
+	  r.extruder         = block->active_extruder;
+	  if (1 != fwrite(&r, sizeof(r), 1, trace_fp))
+	  {
+	       fprintf(stderr, "Error writing the trace file; %s (%d)\n", strerror(errno), errno);
+	       plan_trace_close();
+	  }
+     }
 
      if (discard)
 	  plan_discard_current_block();
 }
 
+float plan_total_time(void)
+{
+     return(total_time);
+}
+
+uint32_t plan_last_block_ticks(void)
+{
+     return(last_block_ticks);
+}
+
+void plan_cost_totals(uint32_t *overruns, uint32_t *starved, uint64_t *plan_cycles)
+{
+     *overruns    = cost_overruns;
+     *starved     = cost_starved_blocks;
+     *plan_cycles = cost_plan_cycles;
+}
+
+void plan_motion_totals(float *xyz_mm, uint32_t *stops)
+{
+     *xyz_mm = total_xyz_mm;
+     *stops  = total_stops;
+}
+
 void plan_dump_run_data(int time_only)
 {
      int cnt, ihours, imins, isecs, idsecs;
@@ -499,6 +790,20 @@ void plan_dump_run_data(int time_only)
      idsecs = (int)(0.5 + ttime * 100.0);
      printf("Total print time is %02d:%02d:%02d.%02d (%f seconds)\n",
 	    ihours, imins, isecs, idsecs, total_time);
+     if (total_time > 0.0)
+	  printf("X, Y and Z moved %.1f mm at an average of %.2f mm/s; %u moves started "
+		 "from a full stop\n", total_xyz_mm, total_xyz_mm / total_time, total_stops);
+
+     if (simulator_cost_model && total_time > 0.0)
+     {
+	  printf("Interrupts use %.1f%% of the cpu on average, %.1f%% in the worst block; "
+		 "planning uses %.1f%%\n",
+		 100.0 * (double)cost_isr_cycles / (total_time * F_CPU_SIM),
+		 100.0 * cost_peak_load,
+		 100.0 * (double)cost_plan_cycles / (total_time * F_CPU_SIM));
+	  printf("%u interrupts overran in %u blocks; %u blocks were too short to plan "
+		 "the next in\n", cost_overruns, cost_overrun_blocks, cost_starved_blocks);
+     }
 
      if (time_only)
 	     return;
@@ -551,24 +856,33 @@ void plan_dump_run_data(int time_only)
 void plan_block_notice(const char *fmt, ...)
 {
      va_list ap;
-     block_t *block;
+     block_cold_t *cold;
      uint8_t index;
      size_t len;
 
      va_start(ap, fmt);
 
      index = (block_buffer_head == 0) ? BLOCK_BUFFER_SIZE - 1 : block_buffer_head - 1;
-     block = &block_buffer[index];
+     cold = &block_cold_buffer[index];
 
-     len = strlen(block->message);
-     vsnprintf(block->message + len, sizeof(block->message) - len, fmt, ap);
+     len = strlen(cold->message);
+     vsnprintf(cold->message + len, sizeof(cold->message) - len, fmt, ap);
 
      va_end(ap);
 }
 
+#if defined(FIXED) && defined(SIMULATOR_CHECKED)
+
+// Tallies a suspect FPTYPE computation; returns true if it should also be reported
+static bool fp_overflow(void)
+{
+     simulator_overflow_count++;
+     return !simulator_quiet_overflows;
+}
+
 FPTYPE ftofpS(float x, int lineno, const char *src)
 {
-    if (x > 32767.0f || x < -32768.0f)
+    if ((x > 32767.0f || x < -32768.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FTOFP(%f) call on line %d pf %s is suspect; "
 		"the value %f is too large for an FPTYPE <<<\n",
 		x, lineno, src ? src : "???", x);
@@ -577,7 +891,7 @@ FPTYPE ftofpS(float x, int lineno, const char *src)
 
 FPTYPE itofpS(int32_t x, int lineno, const char *src)
 {
-    if (x > 0x7fff || x < -0x8000)
+    if ((x > 0x7fff || x < -0x8000) && fp_overflow())
 	 printf(">>> OVERFLOW: IPTOF(%d) call on line %d of %s is suspect; "
 		"the value %d is too large for an FPTYPE <<<\n",
 		x, lineno, src ? src : "???", x);
@@ -587,7 +901,7 @@ FPTYPE itofpS(int32_t x, int lineno, const char *src)
 FPTYPE fpsquareS(FPTYPE x, int lineno, const char *src)
 {
     double z = ktof(x) * ktof(x);
-    if (z > 32767.0f)
+    if ((z > 32767.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FPSQUARE(%f) call on line %d of %s is suspect; "
 		"the value %f * %f is too large for an FPTYPE <<<\n",
 		ktof(x), lineno, src ? src : "???", ktof(x), ktof(x));
@@ -597,7 +911,7 @@ FPTYPE fpsquareS(FPTYPE x, int lineno, const char *src)
 FPTYPE fpmult2S(FPTYPE x, FPTYPE y, int lineno, const char *src)
 {
      double z = ktof(x) * ktof(y);
-     if (z > 32767.0f || z < -32768.0f)
+     if ((z > 32767.0f || z < -32768.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FPMULT2(%f, %f) call on line %d of %s is suspect; "
 		"the product %f * %f is too large for an FPTYPE <<<\n",
 		ktof(x), ktof(y), lineno, src ? src : "???", ktof(x), ktof(y));
@@ -607,7 +921,7 @@ FPTYPE fpmult2S(FPTYPE x, FPTYPE y, int lineno, const char *src)
 FPTYPE fpmult3S(FPTYPE x, FPTYPE y, FPTYPE a, int lineno, const char *src)
 {
      double z = ktof(x) * ktof(y) * ktof(a);
-     if (z > 32767.0f || z < -32768.0f)
+     if ((z > 32767.0f || z < -32768.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FPMULT3(%f, %f, %f) call on line %d of %s is suspect; "
 		"the product %f * %f * %f is too large for an FPTYPE <<<\n",
 		ktof(x), ktof(y), ktof(a), lineno, src ? src : "???", ktof(x), ktof(y), ktof(a));
@@ -617,7 +931,7 @@ FPTYPE fpmult3S(FPTYPE x, FPTYPE y, FPTYPE a, int lineno, const char *src)
 FPTYPE fpmult4S(FPTYPE x, FPTYPE y, FPTYPE a, FPTYPE b, int lineno, const char *src)
 {
      double z = ktof(x) * ktof(y) * ktof(a) * ktof(b);
-     if (z > 32767.0f || z < -32768.0f)
+     if ((z > 32767.0f || z < -32768.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FPMULT4(%f, %f, %f, %f) call on line %d of %s is suspect; "
 		"the product %f * %f * %f * %f is too large for an FPTYPE <<<\n",
 		ktof(x), ktof(y), ktof(a), ktof(b), lineno, src ? src : "???",
@@ -628,7 +942,7 @@ FPTYPE fpmult4S(FPTYPE x, FPTYPE y, FPTYPE a, FPTYPE b, int lineno, const char *
 FPTYPE fpdivS(FPTYPE x, FPTYPE y, int lineno, const char *src)
 {
      double z = ktof(x) / ktof(y);
-     if (z > 32767.0f || z < -32768.0f)
+     if ((z > 32767.0f || z < -32768.0f) && fp_overflow())
 	 printf(">>> OVERFLOW: FPDIV(%f, %f) call on line %d of %s is suspect; "
 		"%f / %f is too large for an FPTYPE <<<\n",
 		ktof(x), ktof(y), lineno, src ? src : "???", ktof(x), ktof(y));
@@ -638,13 +952,15 @@ FPTYPE fpdivS(FPTYPE x, FPTYPE y, int lineno, const char *src)
 FPTYPE fpscale2S(FPTYPE x, int lineno, const char *src)
 {
      double z = ktof(x) * 2.0;
-     if (z > 32767.0f || z < -32768.0f)
+     if ((z > 32767.0f || z < -32768.0f) && fp_overflow())
 	  printf(">>> OVERFLOW: FPSCALE(%f) call on line %d of %s is suspect; "
 		 "%f << 1 is too large for an FPTYPE <<<\n",
 		 ktof(x), lineno, src ? src : "???", ktof(x));
      return x << 1;
 }
 
+#endif
+
 namespace eeprom {
 
 uint8_t getEeprom8(const uint16_t location, const uint8_t default_value) { return default_value; }
@@ -19,6 +19,49 @@ extern bool   simulator_use_max_feed_rate;
 extern bool   simulator_show_alt_feed_rate;
 extern FPTYPE simulator_max_feed_rate;
 
+// Suspect FPTYPE computations seen by the FPMULT2() etc. checks, which
+// are only reported when simulator_quiet_overflows is false
+extern bool     simulator_quiet_overflows;
+extern uint32_t simulator_overflow_count;
+
+// AVR cycle cost model.  Each interrupt the block walk in
+// plan_dump_current_block() steps through is charged simulator_cycles
+// and compared with its interval; each block is charged its planning and
+// replanning, which the main loop must fit in around the interrupts
+// before the block has been stepped out.  The defaults are for a 16 MHz
+// ATmega2560 and should be calibrated from the ISR_PROFILE screen:
+// ST_INTERRUPT averages, times 8 cycles a tick, while cruising with one
+// axis give isr + step, and while ramping add ramp; SETUP_NEXT_BLOCK
+// gives setup.
+typedef struct {
+     uint32_t isr;     // st_interrupt() entry, exit and bookkeeping
+     uint32_t step;    // each moving axis, each step of an interrupt
+     uint32_t ramp;    // the rate and timer calculation while ramping
+     uint32_t setup;   // setup_next_block(), at the start of each block
+     uint32_t plan;    // plan_buffer_line() for a block
+     uint32_t recalc;  // each planner_recalculate() pass over a block
+} simulator_cycles_t;
+
+extern bool               simulator_cost_model;
+extern simulator_cycles_t simulator_cycles;
+
+// Corrections to the time estimate, fitted by calibrate_time.py to the
+// block times a machine's flight recorder measured.  The cruising and the
+// ramping parts of each block are scaled and block_ms is added for each
+// block; they only apply once plan_time_cal_load() has read them.
+typedef struct {
+     float cruise;     // times the time spent at the nominal rate
+     float ramp;       // times the time spent accelerating and decelerating
+     float block_ms;   // plus this for each block
+} simulator_time_cal_t;
+
+extern bool                 simulator_time_calibrated;
+extern simulator_time_cal_t simulator_time_cal;
+
+// Read "cruise", "ramp" and "block_ms" lines from the file, returns 0 on
+// success, else reports the problem and returns -1
+extern int plan_time_cal_load(const char *fname);
+
 extern void init_extras(bool acceleration);
 extern void st_set_position(const int32_t &x, const int32_t &y, const int32_t &z, const int32_t &a, const int32_t &b);
 extern void st_set_e_position(const int32_t &a, const int32_t &b);
@@ -27,6 +70,19 @@ extern void st_deprime_enable(bool enable);
 extern void plan_dump(int chart);
 extern void plan_dump_current_block(int discard, int report);
 extern void plan_dump_run_data(int time_only);
+extern float plan_total_time(void);
+// Time the block plan_dump_current_block() last stepped out took, in ticks
+// of the 2 MHz stepper timer; a float sum of them loses the odd millisecond
+extern uint32_t plan_last_block_ticks(void);
+extern void plan_cost_totals(uint32_t *overruns, uint32_t *starved, uint64_t *plan_cycles);
+// Distance the X, Y and Z axes moved, and the moves of theirs started from
+// the minimum planner speed or unaccelerated
+extern void plan_motion_totals(float *xyz_mm, uint32_t *stops);
+
+// Write a binary record of each block plan_dump_current_block() steps out
+// to the file, in the format of SimulatorTrace.h, until plan_trace_close()
+extern int plan_trace_open(const char *fname);
+extern int plan_trace_close(void);
 void plan_block_notice(const char *fmt, ...);
 
 extern float stepperAxisStepsToMM_(int32_t steps, uint8_t axis);
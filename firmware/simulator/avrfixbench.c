@@ -0,0 +1,231 @@
+// Microbenchmark for the avrfix divide and square root routines
+//
+//     avrfixbench [-n samples] [-r repeats]
+//
+// Compares divkF() and sqrtkF() against the original divkD(), divkS() and
+// sqrtkD() for accuracy, measured against double precision, and for time
+// per call.  Operands are spread logarithmically over the ranges the
+// planner works with.  The times are for the host cpu, which has a hardware
+// divider: on the AVR the 32 bit division within divkD() and divkS() is a
+// 32 step software loop, against divkF()'s typical 18 steps, so divkD()
+// compares better here than it does on a board.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+#include "avrfix.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+typedef _iAccum (*div_fn_t)(_iAccum, _iAccum);
+typedef _iAccum (*sqrt_fn_t)(_iAccum);
+
+static _iAccum sqrtkD_fn(_iAccum a) { return sqrtkD(a); }
+
+// avrfix's own ktod() scales by the short accum factor
+#define KTOD(k) ((double)(k) / ACCUM_FACTOR)
+
+static int32_t samples = 20000;
+static int32_t repeats = 50;
+
+static _iAccum *div_x, *div_y, *sqrt_a;
+
+// The routines are compiled without optimization; sink the results
+// anyway so that the calls can't be dropped
+static volatile _iAccum sink;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-n samples] [-r repeats]\n"
+"  ?, -h  -- This help message\n"
+"     -n  -- Number of operands to test (default %d)\n"
+"     -r  -- Number of timing passes over the operands (default %d)\n",
+	     prog ? prog : "avrfixbench", samples, repeats);
+}
+
+// Repeatable pseudo random numbers, so that runs can be compared
+static uint32_t lcg_state = 12345;
+
+static double urand(void)
+{
+     lcg_state = lcg_state * 1664525UL + 1013904223UL;
+     return (double)(lcg_state >> 8) / 16777216.0;
+}
+
+// Random value whose magnitude is spread logarithmically over [2^lo, 2^hi]
+static double lrand(int lo, int hi, int allow_negative)
+{
+     double v = pow(2.0, lo + (hi - lo) * urand());
+     if (allow_negative && urand() < 0.5)
+	  v = -v;
+     return v;
+}
+
+static uint64_t now(void)
+{
+#ifdef HAVE_RDTSC
+     return (uint64_t)__rdtsc();
+#else
+     return (uint64_t)clock();
+#endif
+}
+
+static const char *time_units(void)
+{
+#ifdef HAVE_RDTSC
+     return "cycles";
+#else
+     return "clocks";
+#endif
+}
+
+static void report(const char *name, double max_err, double sum_err,
+		   int32_t bad, uint64_t ticks)
+{
+     printf("%-8s  %10.3f  %10.3f  %8d  %10.1f\n", name, max_err,
+	    sum_err / samples, bad,
+	    (double)ticks / ((double)samples * repeats));
+}
+
+static void bench_div(const char *name, div_fn_t fn)
+{
+     double max_err = 0.0, sum_err = 0.0;
+     int32_t i, r, bad = 0;
+     uint64_t start;
+
+     for (i = 0; i < samples; i++)
+     {
+	  double exact = KTOD(div_x[i]) / KTOD(div_y[i]) * ACCUM_FACTOR;
+	  double err = fabs((double)fn(div_x[i], div_y[i]) - exact);
+	  if (err > max_err)
+	       max_err = err;
+	  sum_err += err;
+	  if (err > 1.0)
+	       bad++;
+     }
+
+     start = now();
+     for (r = 0; r < repeats; r++)
+	  for (i = 0; i < samples; i++)
+	       sink = fn(div_x[i], div_y[i]);
+
+     report(name, max_err, sum_err, bad, now() - start);
+}
+
+static void bench_sqrt(const char *name, sqrt_fn_t fn)
+{
+     double max_err = 0.0, sum_err = 0.0;
+     int32_t i, r, bad = 0;
+     uint64_t start;
+
+     for (i = 0; i < samples; i++)
+     {
+	  double exact = sqrt(KTOD(sqrt_a[i])) * ACCUM_FACTOR;
+	  double err = fabs((double)fn(sqrt_a[i]) - exact);
+	  if (err > max_err)
+	       max_err = err;
+	  sum_err += err;
+	  if (err > 1.0)
+	       bad++;
+     }
+
+     start = now();
+     for (r = 0; r < repeats; r++)
+	  for (i = 0; i < samples; i++)
+	       sink = fn(sqrt_a[i]);
+
+     report(name, max_err, sum_err, bad, now() - start);
+}
+
+int main(int argc, char *argv[])
+{
+     char c;
+     int32_t i;
+
+     while ((c = getopt(argc, argv, ":hn:r:?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  case 'n' :
+	       samples = atoi(optarg);
+	       break;
+
+	  case 'r' :
+	       repeats = atoi(optarg);
+	       break;
+
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(0);
+
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+	  }
+     }
+
+     if (samples <= 0 || repeats <= 0)
+     {
+	  usage(stderr, argv[0]);
+	  return(1);
+     }
+
+     div_x  = (_iAccum *)malloc(samples * sizeof(_iAccum));
+     div_y  = (_iAccum *)malloc(samples * sizeof(_iAccum));
+     sqrt_a = (_iAccum *)malloc(samples * sizeof(_iAccum));
+     if (!div_x || !div_y || !sqrt_a)
+     {
+	  fprintf(stderr, "%s: unable to allocate memory\n", argv[0]);
+	  return(1);
+     }
+
+     // Quotients which don't fit in an s15.16 are skipped; the
+     // routines disagree on how they overflow
+     for (i = 0; i < samples; i++)
+     {
+	  do {
+	       div_x[i] = ftok(lrand(-8, 14, 1));
+	       div_y[i] = ftok(lrand(-8, 14, 1));
+	  } while (div_y[i] == 0 ||
+		   fabs(KTOD(div_x[i]) / KTOD(div_y[i])) >= 32767.0);
+	  sqrt_a[i] = ftok(lrand(-16, 14, 0));
+	  if (sqrt_a[i] == 0)
+	       sqrt_a[i] = 1;
+     }
+
+     printf("%d operands, %d timing passes; errors in units of 1/65536\n\n",
+	    samples, repeats);
+     printf("routine    max error  mean error  err > 1  %s/call\n",
+	    time_units());
+
+     bench_div("divkD", divkD);
+     bench_div("divkS", divkS);
+     bench_div("divkF", divkF);
+     printf("\n");
+     bench_sqrt("sqrtkD", sqrtkD_fn);
+     bench_sqrt("sqrtkF", sqrtkF);
+
+     free(div_x);
+     free(div_y);
+     free(sqrt_a);
+
+     return(0);
+}
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Runs the benchmark suite through the fixed point simulator and through
+# float_simulator, the same planner with float arithmetic, and compares
+# the blocks each planned with tracediff: their entry speeds, trapezoid
+# boundaries, total times and planner cost.
+#
+#     bench/fpdiff.sh [objdir]
+#
+# The cost model is on for both.  Float arithmetic costs far more cycles on
+# the AVR than fixed point, so give the float build its own costs for -C
+# with FLOAT_CYCLES=isr,step,ramp,setup,plan,recalc.  Tolerances can be
+# passed to tracediff with TRACEDIFF="-s 0.2 -t 1".  The exit status is
+# non-zero when any print differs by more than they allow.
+
+bench=`dirname "$0"`
+objdir=${1:-$bench/../LinuxObj}
+case "$objdir" in
+     /*) ;;
+     *) objdir="`pwd`/$objdir" ;;
+esac
+
+for exe in simulator float_simulator tracediff; do
+     if [ ! -x "$objdir/$exe" ]; then
+	  echo "$0: no $exe in $objdir; make it first" >&2
+	  exit 1
+     fi
+done
+
+tmp=`mktemp -d` || exit 1
+trap 'rm -rf "$tmp"' 0
+
+cd "$bench/../.." || exit 1
+status=0
+for f in \
+     simulator/bench/vase.x3g \
+     simulator/bench/travel.x3g \
+     "s3g scripts/ReplicatorLeveling-XY-max.x3g" \
+     "s3g scripts/ReplicatorLeveling-XY-min.x3g" \
+     "s3g scripts/ReplicatorLeveling-max.x3g" \
+     "s3g scripts/nozzleCalibration-Rep1.x3g" \
+     "s3g scripts/nozzleCalibration-Rep2.x3g"
+do
+     echo "== $f"
+     "$objdir/simulator" -p -T "$tmp/fixed" "$f" > /dev/null &&
+     "$objdir/float_simulator" -p ${FLOAT_CYCLES:+-C "$FLOAT_CYCLES"} -T "$tmp/float" "$f" > /dev/null || {
+	  echo "$0: the simulators failed on $f" >&2
+	  exit 1
+     }
+     "$objdir/tracediff" $TRACEDIFF "$tmp/fixed" "$tmp/float" || status=1
+done
+exit $status
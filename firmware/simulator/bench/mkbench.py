@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+
+# Writes the generated prints of the benchmark suite, vase.x3g and
+# travel.x3g, into the current directory.  They are checked in, so the
+# suite doesn't change with the python or the float rounding of whoever
+# runs it; rerun this only to change them.
+#
+#   vase.x3g   -- a 40 mm spiral vase of 180 chords a turn, 8 mm tall:
+#                 long runs of short moves with shallow corners
+#   travel.x3g -- ten layers of a 4 x 4 grid of 6 mm squares, 30 mm apart,
+#                 with a retract, a travel and a prime between squares
+
+import math
+import struct
+
+STEPS_PER_MM = [94.139704, 94.139704, 400.0, 96.275202, 96.275202]
+
+# Filament for a 0.4 x 0.2 mm bead of 1.75 mm filament, per mm of path
+EXTRUDE = (0.4 * 0.2) / (math.pi * 0.875 * 0.875)
+
+HOST_CMD_SET_POSITION_EXT    = 140
+HOST_CMD_QUEUE_POINT_NEW_EXT = 155
+
+class Writer:
+    def __init__(self, name):
+        self.f = open(name, 'wb')
+        self.pos = [0.0] * 5    # mm, with A relative per move
+
+    def set_position(self, x, y, z):
+        self.pos = [x, y, z, 0.0, 0.0]
+        steps = [int(round(self.pos[i] * STEPS_PER_MM[i])) for i in range(5)]
+        self.f.write(struct.pack('<B5i', HOST_CMD_SET_POSITION_EXT, *steps))
+
+    # A move to x, y, z extruding e mm of filament, at feedrate mm/s
+    def move(self, x, y, z, e, feedrate):
+        d = [x - self.pos[0], y - self.pos[1], z - self.pos[2], e, 0.0]
+        distance = math.sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2])
+        if distance == 0.0:
+            distance = abs(e)
+        steps = [int(round(d[i] * STEPS_PER_MM[i])) for i in range(5)]
+        master = max([abs(s) for s in steps])
+        if master == 0:
+            return
+        self.pos = [x, y, z, 0.0, 0.0]
+        target = [int(round(self.pos[i] * STEPS_PER_MM[i])) for i in range(3)] + steps[3:]
+        dda_rate = int(master * feedrate / distance)
+        self.f.write(struct.pack('<B6iBfh', HOST_CMD_QUEUE_POINT_NEW_EXT,
+                                 target[0], target[1], target[2], target[3], target[4],
+                                 dda_rate, 0x18, distance, int(feedrate * 64)))
+
+    def close(self):
+        self.f.close()
+
+def vase():
+    w = Writer('vase.x3g')
+    w.set_position(20.0, 0.0, 0.2)
+    chords, turns, layer = 180, 40, 0.2
+    radius = 20.0
+    for i in range(1, chords * turns + 1):
+        t = 2.0 * math.pi * i / chords
+        x, y = radius * math.cos(t), radius * math.sin(t)
+        z = 0.2 + layer * i / chords
+        step = 2.0 * math.pi * radius / chords
+        w.move(x, y, z, EXTRUDE * step, 40.0)
+    w.close()
+
+def travel():
+    w = Writer('travel.x3g')
+    w.set_position(0.0, 0.0, 0.2)
+    side, pitch, n = 6.0, 30.0, 4
+    for layer in range(10):
+        z = 0.2 + 0.2 * layer
+        for row in range(n):
+            for col in range(n):
+                x0, y0 = col * pitch, row * pitch
+                w.move(w.pos[0], w.pos[1], z, -1.0, 30.0)   # retract
+                w.move(x0, y0, z, 0.0, 150.0)               # travel
+                w.move(x0, y0, z, 1.0, 30.0)                # prime
+                for (x, y) in [(x0 + side, y0), (x0 + side, y0 + side),
+                               (x0, y0 + side), (x0, y0)]:
+                    w.move(x, y, z, EXTRUDE * side, 50.0)
+    w.close()
+
+vase()
+travel()
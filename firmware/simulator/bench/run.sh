@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Runs the benchmark suite through sailtime and prints a line of CSV for
+# each print: the planned time, the filament, the deepest the planner got,
+# the X, Y and Z distance and average speed, the moves started from a full
+# stop, and the cost model's overruns, starved blocks and planning cycles.
+#
+#     bench/run.sh [sailtime]
+#
+# The prints are the generated ones in bench (see mkbench.py) and the
+# leveling and calibration scripts in "s3g scripts".  Their names are
+# printed relative to the firmware directory, and the figures are rounded,
+# so the output of two builds can be diffed: save one with
+#
+#     bench/run.sh > before.csv
+#
+# and compare the next with it.
+
+bench=`dirname "$0"`
+sailtime=${1:-$bench/../LinuxObj/sailtime}
+case "$sailtime" in
+     /*) ;;
+     *) sailtime="`pwd`/$sailtime" ;;
+esac
+
+if [ ! -x "$sailtime" ]; then
+     echo "$0: no sailtime at $sailtime; make it first" >&2
+     exit 1
+fi
+
+cd "$bench/../.." || exit 1
+exec "$sailtime" -p -j 4 \
+     simulator/bench/vase.x3g \
+     simulator/bench/travel.x3g \
+     "s3g scripts/ReplicatorLeveling-XY-max.x3g" \
+     "s3g scripts/ReplicatorLeveling-XY-min.x3g" \
+     "s3g scripts/ReplicatorLeveling-max.x3g" \
+     "s3g scripts/nozzleCalibration-Rep1.x3g" \
+     "s3g scripts/nozzleCalibration-Rep2.x3g"
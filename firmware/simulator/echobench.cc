@@ -0,0 +1,543 @@
+// Host link round trip benchmark, with HOST_CMD_DEBUG_ECHO
+//
+//     echobench [-b bauds] [-n count] [-s sizes] [-t msecs] [-w secs] port
+//
+// Sends "count" echo packets of each payload size to the bot on the
+// serial port, each as soon as the reply to the one before it is in, at
+// each baud rate in turn.  For each rate and size it reports
+//
+//   - the packets per second, and the share of the link they use: the
+//     bits of the frames both ways, at 10 bits a byte, over the rate,
+//   - the round trip times: min, median, 90th and 99th percentiles, max
+//     and mean,
+//   - the spread of the way back alone.  The reply carries the bot's
+//     clock, so the time it's received less the bot's time varies only
+//     with the delay after the bot answered; the spread is that less its
+//     minimum over the run, to the bot clock's 100 usecs.  The latency
+//     timer of a USB serial bridge shows up here,
+//   - errors: timeouts, CRC errors and bad replies (not RC_OK, or the
+//     echo differs).
+//
+// Rates other than 115200 are switched to with HOST_CMD_SET_BAUD_RATE,
+// so they must be among those the bot supports (115200, 250000 and
+// 500000).  The bot drops back to 115200 after 2 seconds without a
+// packet, and the port is switched back to it at the end.  Opening the
+// port may reset the bot, so -w waits before the first packet.
+//
+// The exit status is non-zero if the port can't be used, or any packet
+// failed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+
+#if defined(__linux__)
+// termios2, for rates which have no B constant
+#include <asm/termbits.h>
+#else
+#include <termios.h>
+#if defined(__APPLE__)
+#include <IOKit/serial/ioss.h>
+#endif
+#endif
+
+#include "Packet.hh"
+#include "Commands.hh"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+// Start byte, length, payload and CRC
+#define FRAME_OVERHEAD 3
+
+// The reply is RC_OK, the bot's time and the echo
+#define ECHO_MAX (MAX_PACKET_PAYLOAD - 5)
+
+#define DEFAULT_BAUD 115200
+#define MAX_LIST     16
+
+typedef struct {
+     uint32_t sent;
+     uint32_t good;
+     uint32_t timeouts;
+     uint32_t crc_errors;
+     uint32_t bad;        // not RC_OK, or the echo differs
+     int64_t  usecs;      // the whole run
+     int64_t *rtt;        // usecs, of the good replies
+     int64_t *offset;     // usecs the reply was received after the bot's time
+} run_t;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-? | -h] [-b bauds] [-n count] [-s sizes] [-t msecs] [-w secs] port\n"
+"         port -- Serial port of the bot\n"
+"     -b bauds -- Comma separated baud rates to run at (default 115200)\n"
+"     -n count -- Echo packets to send at each rate and size (default 1000)\n"
+"     -s sizes -- Comma separated echo sizes, 0 to %d bytes (default 0,8,16,%d)\n"
+"     -t msecs -- Time to wait for each reply (default 100)\n"
+"      -w secs -- Time to wait after opening the port, for the bot to reset\n"
+"                 (default 3)\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "echobench", ECHO_MAX, ECHO_MAX);
+}
+
+// Microseconds
+static int64_t now(void)
+{
+     struct timeval tv;
+
+     gettimeofday(&tv, NULL);
+     return (int64_t)tv.tv_sec * 1000000 + (int64_t)tv.tv_usec;
+}
+
+// Comma separated non-negative integers, at most MAX_LIST of them
+static int parse_list(const char *str, long *list)
+{
+     int n = 0;
+
+     while (*str)
+     {
+	  char *end;
+
+	  if (n >= MAX_LIST)
+	       return(-1);
+	  list[n] = strtol(str, &end, 0);
+	  if (end == str || list[n] < 0 || (*end && *end != ','))
+	       return(-1);
+	  n++;
+	  str = *end ? end + 1 : end;
+     }
+     return(n);
+}
+
+// Raw 8N1 at baud, with reads returning whatever has arrived
+static int set_baud(int fd, long baud)
+{
+#if defined(__linux__)
+     struct termios2 t;
+
+     if (ioctl(fd, TCGETS2, &t) < 0)
+	  return(-1);
+     t.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT) | CSIZE | PARENB | CSTOPB | CRTSCTS);
+     t.c_cflag |= BOTHER | (BOTHER << IBSHIFT) | CS8 | CLOCAL | CREAD;
+     t.c_iflag = 0;
+     t.c_oflag = 0;
+     t.c_lflag = 0;
+     t.c_cc[VMIN] = 0;
+     t.c_cc[VTIME] = 0;
+     t.c_ispeed = (speed_t)baud;
+     t.c_ospeed = (speed_t)baud;
+     return(ioctl(fd, TCSETS2, &t));
+#else
+     struct termios t;
+
+     if (tcgetattr(fd, &t) < 0)
+	  return(-1);
+     cfmakeraw(&t);
+     t.c_cflag &= ~(CSTOPB | CRTSCTS);
+     t.c_cflag |= CLOCAL | CREAD;
+     t.c_cc[VMIN] = 0;
+     t.c_cc[VTIME] = 0;
+#if defined(__APPLE__)
+     speed_t speed = (speed_t)baud;
+
+     cfsetspeed(&t, B115200);
+     if (tcsetattr(fd, TCSANOW, &t) < 0)
+	  return(-1);
+     return(ioctl(fd, IOSSIOSPEED, &speed));
+#else
+     speed_t speed;
+
+     switch (baud)
+     {
+     case 115200 : speed = B115200; break;
+#if defined(B500000)
+     case 500000 : speed = B500000; break;
+#endif
+     default :
+	  errno = EINVAL;
+	  return(-1);
+     }
+     cfsetspeed(&t, speed);
+     return(tcsetattr(fd, TCSANOW, &t));
+#endif
+#endif
+}
+
+// Throw away whatever has been received
+static void flush_input(int fd)
+{
+#if defined(__linux__)
+     ioctl(fd, TCFLSH, TCIFLUSH);
+#else
+     tcflush(fd, TCIFLUSH);
+#endif
+}
+
+// Wait until everything written has gone out
+static void drain(int fd)
+{
+#if defined(__linux__)
+     ioctl(fd, TCSBRK, 1);
+#else
+     tcdrain(fd);
+#endif
+}
+
+static bool send_packet(int fd, OutPacket& out)
+{
+     uint8_t frame[MAX_PACKET_PAYLOAD + FRAME_OVERHEAD];
+     size_t n = 0, done = 0;
+
+     while (!out.isFinished())
+	  frame[n++] = out.getNextByteToSend();
+     while (done < n)
+     {
+	  ssize_t w = write(fd, frame + done, n - done);
+	  if (w < 0)
+	  {
+	       if (errno == EINTR || errno == EAGAIN)
+		    continue;
+	       return(false);
+	  }
+	  done += (size_t)w;
+     }
+     return(true);
+}
+
+// Feeds bytes to in until it finishes or fails, or timeout usecs pass.
+// Returns false on a timeout, leaving in as it was when the time ran out.
+static bool receive_packet(int fd, InPacket& in, int64_t timeout)
+{
+     int64_t deadline = now() + timeout;
+
+     in.reset();
+     while (!in.isFinished() && !in.hasError())
+     {
+	  struct pollfd p;
+	  uint8_t b;
+	  int64_t left = deadline - now();
+
+	  if (left <= 0)
+	       return(false);
+	  p.fd = fd;
+	  p.events = POLLIN;
+	  if (poll(&p, 1, (int)((left + 999) / 1000)) <= 0)
+	       continue;
+	  if (read(fd, &b, 1) == 1)
+	       in.processByte(b);
+     }
+     return(true);
+}
+
+// Asks the bot to change to baud and follows it if it agrees
+static bool switch_baud(int fd, long *current, long baud, int64_t timeout)
+{
+     OutPacket out;
+     InPacket in;
+
+     if (baud == *current)
+	  return(true);
+
+     out.append8(HOST_CMD_SET_BAUD_RATE);
+     out.append32((uint32_t)baud);
+     if (!send_packet(fd, out) || !receive_packet(fd, in, timeout) ||
+	 !in.isFinished() || in.getLength() < 1 || in.read8(0) != RC_OK)
+	  return(false);
+
+     // The bot changes once its reply has gone out
+     drain(fd);
+     if (set_baud(fd, baud) < 0)
+	  return(false);
+     *current = baud;
+     usleep(10000);
+     flush_input(fd);
+     return(true);
+}
+
+static int compare(const void *a, const void *b)
+{
+     int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+
+     return((x < y) ? -1 : (x > y) ? 1 : 0);
+}
+
+// The p'th percentile of n sorted values
+static int64_t percentile(const int64_t *v, uint32_t n, int p)
+{
+     return(v[((uint64_t)(n - 1) * p + 50) / 100]);
+}
+
+static void run(int fd, run_t *r, uint32_t count, long size, int64_t timeout)
+{
+     uint8_t echo[ECHO_MAX];
+     int64_t start = now();
+
+     for (long i = 0; i < size; i++)
+	  echo[i] = (uint8_t)(0x55 ^ i);
+
+     for (uint32_t n = 0; n < count; n++)
+     {
+	  OutPacket out;
+	  InPacket in;
+	  int64_t sent, received;
+
+	  // Vary the echo, so a stale reply doesn't match
+	  if (size)
+	       echo[0] = (uint8_t)n;
+	  out.append8(HOST_CMD_DEBUG_ECHO);
+	  for (long i = 0; i < size; i++)
+	       out.append8(echo[i]);
+
+	  sent = now();
+	  if (!send_packet(fd, out))
+	  {
+	       fprintf(stderr, "Unable to write to the port; %s (%d)\n",
+		       strerror(errno), errno);
+	       break;
+	  }
+	  r->sent++;
+
+	  if (!receive_packet(fd, in, timeout))
+	  {
+	       r->timeouts++;
+	       flush_input(fd);
+	       continue;
+	  }
+	  received = now();
+
+	  if (in.hasError())
+	  {
+	       if (in.getErrorCode() == PacketError::BAD_CRC)
+		    r->crc_errors++;
+	       else
+		    r->bad++;
+	       // Let the rest of a mangled reply arrive before the next
+	       usleep(2000);
+	       flush_input(fd);
+	       continue;
+	  }
+
+	  if (in.getLength() != 5 + size || in.read8(0) != RC_OK ||
+	      memcmp((const uint8_t *)in.getData() + 5, echo, size))
+	  {
+	       r->bad++;
+	       continue;
+	  }
+
+	  r->rtt[r->good] = received - sent;
+	  r->offset[r->good] = received - (int64_t)in.read32(1) * 100;
+	  r->good++;
+     }
+     r->usecs = now() - start;
+}
+
+static void report(long baud, long size, run_t *r)
+{
+     // Request and reply frames, at 10 bits to the byte
+     double bits = 10.0 * (2 * FRAME_OVERHEAD + 1 + size + 5 + size);
+     double pps = (r->usecs > 0) ? (double)r->good * 1000000.0 / (double)r->usecs : 0.0;
+
+     printf("%7ld %4ld %7u %8.1f %5.1f%%",
+	    baud, size, r->good, pps, 100.0 * bits * pps / (double)baud);
+
+     if (r->good)
+     {
+	  int64_t sum = 0, least;
+	  uint32_t i;
+
+	  qsort(r->rtt, r->good, sizeof(int64_t), compare);
+	  for (i = 0; i < r->good; i++)
+	       sum += r->rtt[i];
+
+	  // The bot's clock wraps every 2^32 ticks, past any sensible run
+	  least = r->offset[0];
+	  for (i = 1; i < r->good; i++)
+	       if (r->offset[i] < least)
+		    least = r->offset[i];
+	  for (i = 0; i < r->good; i++)
+	       r->offset[i] -= least;
+	  qsort(r->offset, r->good, sizeof(int64_t), compare);
+
+	  printf(" %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f",
+		 r->rtt[0] / 1000.0,
+		 percentile(r->rtt, r->good, 50) / 1000.0,
+		 percentile(r->rtt, r->good, 90) / 1000.0,
+		 percentile(r->rtt, r->good, 99) / 1000.0,
+		 r->rtt[r->good - 1] / 1000.0,
+		 (double)sum / r->good / 1000.0,
+		 percentile(r->offset, r->good, 50) / 1000.0,
+		 percentile(r->offset, r->good, 99) / 1000.0);
+     }
+     else
+	  printf(" %7s %7s %7s %7s %7s %7s %7s %7s", "-", "-", "-", "-", "-", "-", "-", "-");
+
+     printf(" %6u %6u %6u\n", r->timeouts, r->crc_errors, r->bad);
+}
+
+int main(int argc, const char *argv[])
+{
+     char c;
+     int fd, status = 0;
+     int nbauds = 1, nsizes = 4;
+     long bauds[MAX_LIST] = { DEFAULT_BAUD };
+     long sizes[MAX_LIST] = { 0, 8, 16, ECHO_MAX };
+     long current;
+     long count = 1000;
+     int64_t timeout = 100000;
+     double wait = 3.0;
+     run_t r;
+
+     while ((c = getopt(argc, (char **)argv, ":hb:n:s:t:w:?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  // Unknown switch
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  // Explicit help request
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(1);
+
+	  case 'b' :
+	       nbauds = parse_list(optarg, bauds);
+	       if (nbauds <= 0)
+	       {
+		    fprintf(stderr, "%s: the baud rates, \"%s\", must be a list of at most %d "
+			    "comma separated rates\n", argv[0], optarg, MAX_LIST);
+		    return(1);
+	       }
+	       break;
+
+	  case 'n' :
+	       count = atol(optarg);
+	       if (count <= 0)
+	       {
+		    fprintf(stderr, "%s: the count, \"%s\", must be a positive integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+
+	  case 's' :
+	       nsizes = parse_list(optarg, sizes);
+	       for (int i = 0; i < nsizes; i++)
+		    if (sizes[i] > ECHO_MAX)
+			 nsizes = -1;
+	       if (nsizes <= 0)
+	       {
+		    fprintf(stderr, "%s: the sizes, \"%s\", must be a list of at most %d comma "
+			    "separated sizes of 0 to %d bytes\n", argv[0], optarg, MAX_LIST,
+			    ECHO_MAX);
+		    return(1);
+	       }
+	       break;
+
+	  case 't' :
+	       timeout = (int64_t)atol(optarg) * 1000;
+	       if (timeout <= 0)
+	       {
+		    fprintf(stderr, "%s: the timeout, \"%s\", must be a positive number "
+			    "of milliseconds\n", argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+
+	  case 'w' :
+	       wait = atof(optarg);
+	       if (wait < 0.0)
+	       {
+		    fprintf(stderr, "%s: the wait, \"%s\", must not be negative\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+	  }
+     }
+
+     if (optind != argc - 1)
+     {
+	  usage(stderr, argv[0]);
+	  return(1);
+     }
+
+     fd = open(argv[optind], O_RDWR | O_NOCTTY);
+     if (fd < 0)
+     {
+	  fprintf(stderr, "Unable to open the port \"%s\"; %s (%d)\n",
+		  argv[optind], strerror(errno), errno);
+	  return(1);
+     }
+     if (set_baud(fd, DEFAULT_BAUD) < 0)
+     {
+	  fprintf(stderr, "Unable to set up the port \"%s\"; %s (%d)\n",
+		  argv[optind], strerror(errno), errno);
+	  close(fd);
+	  return(1);
+     }
+     current = DEFAULT_BAUD;
+
+     usleep((useconds_t)(wait * 1000000.0));
+     flush_input(fd);
+
+     r.rtt = (int64_t *)malloc(count * sizeof(int64_t));
+     r.offset = (int64_t *)malloc(count * sizeof(int64_t));
+     if (!r.rtt || !r.offset)
+     {
+	  fprintf(stderr, "Unable to allocate memory for %ld round trips\n", count);
+	  close(fd);
+	  return(1);
+     }
+
+     printf("%7s %4s %7s %8s %6s %7s %7s %7s %7s %7s %7s %7s %7s %6s %6s %6s\n",
+	    "baud", "size", "good", "pkts/s", "link", "min ms", "p50", "p90", "p99",
+	    "max", "mean", "back50", "back99", "tmo", "crc", "bad");
+
+     for (int b = 0; b < nbauds; b++)
+     {
+	  if (!switch_baud(fd, &current, bauds[b], timeout))
+	  {
+	       fprintf(stderr, "The bot didn't change to %ld baud\n", bauds[b]);
+	       status = 1;
+	       continue;
+	  }
+	  for (int s = 0; s < nsizes; s++)
+	  {
+	       r.sent = r.good = r.timeouts = r.crc_errors = r.bad = 0;
+	       run(fd, &r, (uint32_t)count, sizes[s], timeout);
+	       report(bauds[b], sizes[s], &r);
+	       if (r.good != (uint32_t)count)
+		    status = 1;
+	  }
+     }
+
+     if (!switch_baud(fd, &current, DEFAULT_BAUD, timeout))
+     {
+	  fprintf(stderr, "The bot didn't change back to %d baud; it will after 2 "
+		  "seconds without packets\n", DEFAULT_BAUD);
+	  set_baud(fd, DEFAULT_BAUD);
+     }
+
+     free(r.rtt);
+     free(r.offset);
+     close(fd);
+     return(status);
+}
@@ -0,0 +1,531 @@
+// Replay the timing of a print from a host through the planner
+//
+//     hostreplay [-b bytes] [-s skip] [-v] log file
+//
+// Takes the times at which the bot answered the packets of a print sent
+// from a host, as logged by a HOST_LOG build (see HostLog.hh), and feeds
+// the commands of the print's .s3g or .x3g file to the planner at those
+// times, as Command.cc would take them from its buffer.  The moves are
+// stepped out in simulated time, each taking as long as its trapezoid, and
+// every time the stepper is left idle with nothing buffered behind it is
+// reported: when, for how long, and how long the host had been quiet.
+//
+// The log is text, a record to a line, as HOST_CMD_HOST_LOG reads them
+// back:
+//
+//     time command response [free]
+//
+// with the time in hundreds of microseconds (it may wrap at 2^32), the
+// command byte of the packet (0xff for a packet which failed to arrive),
+// the response code and the space then left in the command buffer.  Lines
+// starting with # are skipped.  A host which logs its own packets and the
+// replies to them may leave the free space out.
+//
+// Each RC_OK reply to a bufferable command takes the next command of the
+// file; a reply of RC_BUFFER_OVERFLOW is a retry, which the host sends
+// again.  With -s, the first command taken is that many into the file, for
+// a log which starts part way through a print.  Commands which wait for
+// the moves ahead of them are run as soon as the moves have been stepped
+// out: how long a heater took isn't known here, so the buffer running dry
+// after one, up to the next move planned, isn't reported.  The firmware's
+// free space is printed by each report, to show where the replay and the
+// bot went their separate ways.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "Simulator.hh"
+#include "StepperAccelPlannerExtras.hh"
+#include "StepperAccel.hh"
+#include "EepromMap.hh"
+#include "Point.hh"
+#include "Steppers.hh"
+#include "Packet.hh"
+#include "s3g.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+// COMMAND_BUFFER_SIZE of Command.hh, without PLATFORM_COMMAND_BUFFER_SIZE
+#define DEFAULT_BUFFER_SIZE 512
+
+// HOST_LOG_NO_COMMAND and a free space the log didn't give
+#define NO_COMMAND 0xff
+#define NO_FREE    -1
+
+typedef struct {
+     int64_t  usecs;     // unwrapped
+     uint8_t  command;
+     uint8_t  response;
+     int32_t  free;
+} record_t;
+
+typedef struct {
+     // The print
+     const s3g_command_t *cmds;
+     size_t   count;
+     size_t   next_cmd;      // of the file, for the next RC_OK
+     size_t   head;          // oldest command in the buffer
+     size_t   buffered;      // bytes in the buffer
+     size_t   buffer_size;
+
+     // The stepper
+     int64_t  busy_until;    // when the block being stepped out finishes
+     bool     started;       // a move has been stepped out
+     bool     deliberate;    // drained by a command which waits for the moves
+     bool     starved;
+     int64_t  starved_at;
+     int64_t  starved_quiet; // since the last command taken, when it ran dry
+     int32_t  starved_free;
+
+     // What the log said last
+     int64_t  last_packet;
+     int64_t  last_command;
+     int32_t  last_free;
+
+     // Totals
+     uint32_t underruns;
+     int64_t  starved_usecs;
+     int64_t  longest_gap;
+     uint32_t retries;
+     uint32_t errors;
+     uint32_t mismatches;
+} replay_t;
+
+static int verbose = 0;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-? | -h] [-b bytes] [-s skip] [-v] log file\n"
+"          log -- The packet timing, as read back from a HOST_LOG build\n"
+"         file -- The .s3g or .x3g file which was printed\n"
+"     -b bytes -- Size of the command buffer (default %d)\n"
+"      -s skip -- The log starts with command \"skip\" of the file (default 0)\n"
+"           -v -- Also report the retries and packet errors in the log\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "hostreplay", DEFAULT_BUFFER_SIZE);
+}
+
+static s3g_command_t *load(const char *fname, size_t *count)
+{
+     s3g_context_t *ctx;
+     s3g_command_t cmd, *cmds = NULL;
+     size_t n = 0, max = 0;
+
+     ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (void *)fname, O_RDONLY, 0);
+     if (!ctx)
+	  // Assume that s3g_open() has complained
+	  return(NULL);
+
+     while (!s3g_command_read(ctx, &cmd))
+     {
+	  if (n >= max)
+	  {
+	       s3g_command_t *tmp;
+
+	       max = max ? max * 2 : 4096;
+	       tmp = (s3g_command_t *)realloc(cmds, max * sizeof(s3g_command_t));
+	       if (!tmp)
+	       {
+		    fprintf(stderr, "Unable to allocate memory for the commands in %s\n", fname);
+		    free(cmds);
+		    s3g_close(ctx);
+		    return(NULL);
+	       }
+	       cmds = tmp;
+	  }
+	  memcpy(&cmds[n++], &cmd, sizeof(s3g_command_t));
+     }
+
+     s3g_close(ctx);
+
+     *count = n;
+     return(cmds);
+}
+
+static record_t *load_log(const char *fname, size_t *count)
+{
+     FILE *fp;
+     char line[256];
+     record_t *recs = NULL;
+     size_t n = 0, max = 0;
+     uint32_t last = 0;
+     int64_t usecs = 0;
+     int lineno = 0;
+
+     fp = fopen(fname, "r");
+     if (!fp)
+     {
+	  fprintf(stderr, "Unable to open the log file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  return(NULL);
+     }
+
+     while (fgets(line, sizeof(line), fp))
+     {
+	  long long time, command, response, free_space;
+	  int fields;
+
+	  lineno++;
+	  if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+	       continue;
+
+	  fields = sscanf(line, "%lli %lli %lli %lli", &time, &command, &response, &free_space);
+	  if (fields < 3 || command < 0 || command > 0xff || response < 0 || response > 0xff)
+	  {
+	       fprintf(stderr, "%s, line %d: expected a time, a command byte, a response "
+		       "code and perhaps the free space\n", fname, lineno);
+	       free(recs);
+	       fclose(fp);
+	       return(NULL);
+	  }
+
+	  if (n >= max)
+	  {
+	       record_t *tmp;
+
+	       max = max ? max * 2 : 4096;
+	       tmp = (record_t *)realloc(recs, max * sizeof(record_t));
+	       if (!tmp)
+	       {
+		    fprintf(stderr, "Unable to allocate memory for the records in %s\n", fname);
+		    free(recs);
+		    fclose(fp);
+		    return(NULL);
+	       }
+	       recs = tmp;
+	  }
+
+	  // The board's clock wraps, but the gaps between packets are short
+	  if (n > 0)
+	       usecs += (int64_t)(uint32_t)((uint32_t)time - last) * 100;
+	  last = (uint32_t)time;
+
+	  recs[n].usecs = usecs;
+	  recs[n].command = (uint8_t)command;
+	  recs[n].response = (uint8_t)response;
+	  recs[n].free = (fields == 4) ? (int32_t)free_space : NO_FREE;
+	  n++;
+     }
+
+     fclose(fp);
+
+     *count = n;
+     return(recs);
+}
+
+static bool is_move(uint8_t id)
+{
+     return(id == HOST_CMD_QUEUE_POINT_NEW || id == HOST_CMD_QUEUE_POINT_NEW_EXT ||
+	    id == HOST_CMD_QUEUE_POINT_DELTA || id == HOST_CMD_QUEUE_POINT_EXT);
+}
+
+// Commands which wait for the moves ahead of them to be stepped out, as
+// the simulator has it
+static bool waits(uint8_t id)
+{
+     return(!is_move(id) &&
+	    id != HOST_CMD_PLANNER_HINT &&
+	    id != HOST_CMD_FIRMWARE_RETRACT &&
+	    id != HOST_CMD_SET_ADVANCE_PROFILE &&
+	    id != HOST_CMD_SET_POSITION_EXT &&
+	    id != HOST_CMD_SET_ACCELERATION_TOGGLE &&
+	    id != HOST_CMD_TOOL_COMMAND &&
+	    id != HOST_CMD_ENABLE_AXES &&
+	    id != HOST_CMD_SET_BUILD_PERCENT &&
+	    id != HOST_CMD_CHANGE_TOOL &&
+	    id != HOST_CMD_RECALL_HOME_POSITION);
+}
+
+static void run_command(const s3g_command_t *cmd)
+{
+     if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_NEW)
+     {
+	  Point target = Point(cmd->t.queue_point_new.x, cmd->t.queue_point_new.y,
+			       cmd->t.queue_point_new.z, cmd->t.queue_point_new.a,
+			       cmd->t.queue_point_new.b);
+	  steppers::setTargetNew(target, 0, cmd->t.queue_point_new.us, cmd->t.queue_point_new.rel);
+     }
+     else if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_NEW_EXT ||
+	      cmd->cmd_id == HOST_CMD_QUEUE_POINT_DELTA)
+     {
+	  Point target = Point(cmd->t.queue_point_new_ext.x, cmd->t.queue_point_new_ext.y,
+			       cmd->t.queue_point_new_ext.z, cmd->t.queue_point_new_ext.a,
+			       cmd->t.queue_point_new_ext.b);
+	  steppers::setTargetNewExt(target, cmd->t.queue_point_new_ext.dda_rate,
+				    cmd->t.queue_point_new_ext.rel,
+				    plan_float_to_fp(cmd->t.queue_point_new_ext.distance),
+				    cmd->t.queue_point_new_ext.feedrate_mult_64);
+     }
+     else if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_EXT)
+     {
+	  Point target = Point(cmd->t.queue_point_ext.x, cmd->t.queue_point_ext.y,
+			       cmd->t.queue_point_ext.z, cmd->t.queue_point_ext.a,
+			       cmd->t.queue_point_ext.b);
+	  steppers::setTargetNew(target, cmd->t.queue_point_ext.dda, 0, 0);
+     }
+     else if (cmd->cmd_id == HOST_CMD_PLANNER_HINT)
+     {
+	  planner_hint_speed = FTOFP((float)cmd->t.planner_hint.max_entry_speed_64 / 64.0);
+	  planner_hint_nominal_length =
+	       (cmd->t.planner_hint.flags & PLANNER_HINT_NOMINAL_LENGTH) != 0;
+     }
+     else if (cmd->cmd_id == HOST_CMD_SET_POSITION_EXT)
+     {
+	  Point target = Point(cmd->t.set_position_ext.x, cmd->t.set_position_ext.y,
+			       cmd->t.set_position_ext.z, cmd->t.set_position_ext.a,
+			       cmd->t.set_position_ext.b);
+	  steppers::definePosition(target, false);
+     }
+     else if (cmd->cmd_id == HOST_CMD_SET_ACCELERATION_TOGGLE)
+	  steppers::setSegmentAccelState((cmd->t.set_segment_acceleration.s != 0) ? true : false);
+}
+
+// Seconds, for the reports
+static float secs(int64_t usecs)
+{
+     return((float)usecs / 1.0e6f);
+}
+
+// Run the bot up to the time now: take commands from the buffer while the
+// planner has room, and step out its blocks one after another
+static void advance(replay_t *r, int64_t now)
+{
+     for (;;)
+     {
+	  bool idle = r->busy_until <= now;
+
+	  while (r->head < r->next_cmd)
+	  {
+	       const s3g_command_t *cmd = &r->cmds[r->head];
+
+	       if (is_move(cmd->cmd_id))
+	       {
+		    if (movesplanned() >= BLOCK_BUFFER_SIZE - 1)
+			 break;
+		    r->deliberate = false;
+	       }
+	       else if (waits(cmd->cmd_id))
+	       {
+		    if (movesplanned() != 0 || !idle)
+			 break;
+		    r->deliberate = true;
+	       }
+	       run_command(cmd);
+	       r->buffered -= cmd->cmd_raw_len;
+	       r->head++;
+	  }
+
+	  if (movesplanned() == 0)
+	  {
+	       if (idle && r->started && !r->starved && !r->deliberate)
+	       {
+		    // Ran dry when the last block finished
+		    r->starved = true;
+		    r->starved_at = r->busy_until;
+		    r->starved_quiet = r->busy_until - r->last_command;
+		    r->starved_free = r->last_free;
+	       }
+	       return;
+	  }
+	  if (r->busy_until > now)
+	       return;
+
+	  // The next block starts as soon as the stepper can take it
+	  int64_t start = r->starved ? now : r->busy_until;
+	  if (!r->started)
+	       start = now;
+	  if (r->starved)
+	  {
+	       int64_t len = now - r->starved_at;
+
+	       r->underruns++;
+	       r->starved_usecs += len;
+	       printf("%10.3f s  dry for %7.1f ms before command %lu, %6.1f ms after the "
+		      "last command came",
+		      secs(r->starved_at), (float)len / 1000.0f, (unsigned long)(r->head - 1),
+		      (float)r->starved_quiet / 1000.0f);
+	       if (r->starved_free != NO_FREE)
+		    printf("; the bot had %d bytes free", r->starved_free);
+	       printf("\n");
+	       r->starved = false;
+	  }
+	  plan_dump_current_block(1, 0);
+	  r->busy_until = start + (int64_t)(plan_last_block_ticks() >> 1);
+	  r->started = true;
+     }
+}
+
+static int replay(replay_t *r, const record_t *recs, size_t nrecs)
+{
+     size_t i;
+
+     for (i = 0; i < nrecs; i++)
+     {
+	  const record_t *rec = &recs[i];
+
+	  advance(r, rec->usecs);
+
+	  if (i > 0 && rec->usecs - recs[i - 1].usecs > r->longest_gap)
+	       r->longest_gap = rec->usecs - recs[i - 1].usecs;
+	  r->last_packet = rec->usecs;
+	  r->last_free = rec->free;
+
+	  if (rec->command == NO_COMMAND)
+	  {
+	       r->errors++;
+	       if (verbose)
+		    printf("%10.3f s  packet error, response 0x%02x\n", secs(rec->usecs), rec->response);
+	       continue;
+	  }
+	  if (!(rec->command & 0x80))
+	       continue;
+	  if (rec->response == RC_BUFFER_OVERFLOW)
+	  {
+	       r->retries++;
+	       if (verbose)
+		    printf("%10.3f s  buffer full for command %lu\n", secs(rec->usecs),
+			   (unsigned long)r->next_cmd);
+	       continue;
+	  }
+	  if (rec->response != RC_OK)
+	       continue;
+
+	  if (r->next_cmd >= r->count)
+	  {
+	       fprintf(stderr, "The log goes on past the end of the file, at %.3f s\n",
+		       secs(rec->usecs));
+	       return(1);
+	  }
+
+	  const s3g_command_t *cmd = &r->cmds[r->next_cmd];
+	  if (cmd->cmd_id != rec->command)
+	  {
+	       // Not the print which was logged, or the wrong -s
+	       fprintf(stderr, "At %.3f s the log has command %u where the file has %u (command %lu)\n",
+		       secs(rec->usecs), rec->command, cmd->cmd_id, (unsigned long)r->next_cmd);
+	       return(1);
+	  }
+	  if (r->buffered + cmd->cmd_raw_len > r->buffer_size)
+	       // The bot had more room than the replay thinks it had
+	       r->mismatches++;
+	  r->buffered += cmd->cmd_raw_len;
+	  r->next_cmd++;
+	  r->last_command = rec->usecs;
+
+	  // It may be just what the stepper was waiting for
+	  advance(r, rec->usecs);
+     }
+
+     // Step out whatever is left
+     while (r->head < r->next_cmd || movesplanned() != 0)
+	  advance(r, r->busy_until > r->last_packet ? r->busy_until : r->last_packet);
+
+     return(0);
+}
+
+int main(int argc, const char *argv[])
+{
+     char c;
+     size_t skip = 0;
+     replay_t r;
+
+     memset(&r, 0, sizeof(replay_t));
+     r.buffer_size = DEFAULT_BUFFER_SIZE;
+
+     while ((c = getopt(argc, (char **)argv, ":b:hs:v?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  // Unknown switch
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  // Explicit help request
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(1);
+
+	  case 'b' :
+	       r.buffer_size = (size_t)atol(optarg);
+	       if (r.buffer_size < MAX_PACKET_PAYLOAD)
+	       {
+		    fprintf(stderr, "%s: the buffer size, \"%s\", must be at least %d bytes\n",
+			    argv[0], optarg, MAX_PACKET_PAYLOAD);
+		    return(1);
+	       }
+	       break;
+
+	  case 's' :
+	       skip = (size_t)atol(optarg);
+	       break;
+
+	  case 'v' :
+	       verbose = 1;
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+     if (argc != 2)
+     {
+	  usage(stderr, NULL);
+	  return(1);
+     }
+
+     record_t *recs;
+     size_t nrecs;
+     s3g_command_t *cmds;
+
+     recs = load_log(argv[0], &nrecs);
+     if (!recs)
+	  return(1);
+     cmds = load(argv[1], &r.count);
+     if (!cmds)
+	  return(1);
+     if (skip > r.count)
+     {
+	  fprintf(stderr, "%s has only %lu commands\n", argv[1], (unsigned long)r.count);
+	  return(1);
+     }
+     r.cmds = cmds;
+     r.next_cmd = r.head = skip;
+
+     steppers::init();
+     steppers::reset();
+     init_extras(true);
+
+     int iret = replay(&r, recs, nrecs);
+
+     printf("%lu records over %.3f s; %lu commands taken, %u buffer full retries, "
+	    "%u packet errors\n",
+	    (unsigned long)nrecs, nrecs ? secs(recs[nrecs - 1].usecs) : 0.0f,
+	    (unsigned long)(r.next_cmd - skip), r.retries, r.errors);
+     printf("The longest the host went quiet was %.1f ms; the stepper ran dry %u times, "
+	    "for %.3f s in all\n",
+	    (float)r.longest_gap / 1000.0f, r.underruns, secs(r.starved_usecs));
+     printf("The last move finished at %.3f s\n", secs(r.busy_until));
+     if (r.mismatches)
+	  printf("%u commands arrived when the replay's buffer had no room for them; "
+		 "is -b right?\n", r.mismatches);
+
+     free(recs);
+     free(cmds);
+
+     return(iret);
+}
@@ -0,0 +1,519 @@
+// Host packet parser fuzzer and throughput benchmark
+//
+//     packetbench [-n bytes] [-r passes] [-s seed] [-w file]
+//     packetbench [-r passes] capture [capture ...]
+//
+// Streams bytes through InPacket::processByte(), taking packets off as
+// Host.cc's runHostSlice() does: a finished packet or an error is
+// consumed and the packet reset before the next byte.  It reports the
+// bytes parsed per second and checks the state machine as it goes,
+//
+//   - a started packet must finish or fail within MAX_PACKET_PAYLOAD + 3
+//     bytes of its start byte, else the parser has stalled,
+//   - the state must be one of the PS_ states which the consumer can
+//     see, and the payload length no more than MAX_PACKET_PAYLOAD.
+//
+// With no files, a random stream of -n bytes is made and parsed: good
+// packets, packets with bad CRCs or lengths over MAX_PACKET_PAYLOAD,
+// truncated packets and bursts of line noise.  A truncated packet or a
+// burst of noise is followed by an idle gap, where the packet timeout
+// of runHostSlice() is applied.  Every good packet must then come out
+// intact, and every bad one as exactly one error; packets which happen
+// to be framed within the noise are counted but allowed.  -w writes the
+// stream out, so that a failure can be replayed as a capture.
+//
+// Captures are raw bytes as sent by a host, such as those written by -w
+// or logged from a serial port.  They're only checked for stalls, and
+// the packets and errors in them counted.  There are no gaps in them.
+//
+// The exit status is non-zero if any check fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "Packet.hh"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+// Start byte, length, payload and CRC
+#define MAX_FRAME (MAX_PACKET_PAYLOAD + 3)
+
+// What each byte of a generated stream is part of
+#define K_GOOD   0	// a good packet
+#define K_BAD    1	// a packet which the parser must reject
+#define K_NOISE  2	// noise or a truncated packet, ahead of a gap
+
+typedef struct {
+     uint8_t *bytes;
+     uint8_t *kind;     // NULL for captures
+     size_t   len, max;
+     size_t  *gaps;     // offsets of the bytes which follow an idle gap
+     size_t   ngaps, maxgaps;
+     size_t   good, bad;
+} stream_t;
+
+typedef struct {
+     uint32_t packets;  // packets received
+     uint32_t errors;   // errors other than timeouts
+     uint32_t timeouts;
+     uint32_t spurious; // packets received from the noise
+     uint32_t stalls;
+     uint32_t failures; // lost, mangled or unexpected packets and bad states
+     int64_t  usecs;
+} result_t;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-? | -h] [-n bytes] [-r passes] [-s seed] [-w file] [capture ...]\n"
+"      capture -- File of raw bytes sent by a host to parse; without any, a\n"
+"                 random stream is made and checked\n"
+"     -n bytes -- Length of the random stream (default 1000000)\n"
+"    -r passes -- Parse each stream \"passes\" times and report the fastest (default 3)\n"
+"      -s seed -- Seed for the random stream (default 1)\n"
+"      -w file -- Write the random stream to file\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "packetbench");
+}
+
+// Microseconds
+static int64_t now(void)
+{
+     struct timeval tv;
+
+     gettimeofday(&tv, NULL);
+     return (int64_t)tv.tv_sec * 1000000 + (int64_t)tv.tv_usec;
+}
+
+// xorshift32, so that a seed makes the same stream on every platform
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+     rng_state ^= rng_state << 13;
+     rng_state ^= rng_state >> 17;
+     rng_state ^= rng_state << 5;
+     return(rng_state);
+}
+
+static uint8_t crc_ibutton(const uint8_t *data, size_t len)
+{
+     uint8_t crc = 0;
+
+     while (len--)
+     {
+	  uint8_t i;
+
+	  crc ^= *data++;
+	  for (i = 0; i < 8; i++)
+	       crc = (crc & 0x01) ? (crc >> 1) ^ 0x8C : crc >> 1;
+     }
+     return(crc);
+}
+
+static void append(stream_t *s, uint8_t b, uint8_t kind)
+{
+     s->bytes[s->len] = b;
+     s->kind[s->len++] = kind;
+}
+
+static void gap(stream_t *s)
+{
+     if (s->ngaps >= s->maxgaps)
+     {
+	  s->maxgaps = s->maxgaps ? s->maxgaps * 2 : 1024;
+	  s->gaps = (size_t *)realloc(s->gaps, s->maxgaps * sizeof(size_t));
+	  if (!s->gaps)
+	  {
+	       fprintf(stderr, "Unable to allocate memory for the stream\n");
+	       exit(1);
+	  }
+     }
+     s->gaps[s->ngaps++] = s->len;
+}
+
+// One packet, noise burst or gap at a time until there's no room for more
+static bool generate(stream_t *s, size_t len)
+{
+     s->bytes = (uint8_t *)malloc(len);
+     s->kind = (uint8_t *)malloc(len);
+     if (!s->bytes || !s->kind)
+     {
+	  fprintf(stderr, "Unable to allocate memory for a stream of %lu bytes\n",
+		  (unsigned long)len);
+	  return(false);
+     }
+     s->max = len;
+
+     while (s->len + MAX_FRAME <= s->max)
+     {
+	  uint8_t payload[MAX_PACKET_PAYLOAD];
+	  uint8_t n, i, what = rng() % 16;
+
+	  n = rng() % (MAX_PACKET_PAYLOAD + 1);
+	  for (i = 0; i < n; i++)
+	       payload[i] = rng();
+
+	  if (what < 10)
+	  {
+	       // Good packet
+	       append(s, START_BYTE, K_GOOD);
+	       append(s, n, K_GOOD);
+	       for (i = 0; i < n; i++)
+		    append(s, payload[i], K_GOOD);
+	       append(s, crc_ibutton(payload, n), K_GOOD);
+	       s->good++;
+	  }
+	  else if (what < 12)
+	  {
+	       // Bad CRC
+	       append(s, START_BYTE, K_BAD);
+	       append(s, n, K_BAD);
+	       for (i = 0; i < n; i++)
+		    append(s, payload[i], K_BAD);
+	       append(s, crc_ibutton(payload, n) ^ (1 + rng() % 255), K_BAD);
+	       s->bad++;
+	  }
+	  else if (what < 13)
+	  {
+	       // Length over the maximum
+	       append(s, START_BYTE, K_BAD);
+	       append(s, MAX_PACKET_PAYLOAD + 1 + rng() % (255 - MAX_PACKET_PAYLOAD), K_BAD);
+	       s->bad++;
+	  }
+	  else if (what < 14)
+	  {
+	       // Truncated packet, which only the timeout ends
+	       append(s, START_BYTE, K_NOISE);
+	       append(s, n, K_NOISE);
+	       if (n)
+		    for (i = rng() % n; i > 0; i--)
+			 append(s, rng(), K_NOISE);
+	       gap(s);
+	  }
+	  else
+	  {
+	       // Line noise, rich in start bytes
+	       for (i = 1 + rng() % MAX_FRAME; i > 0; i--)
+		    append(s, (rng() % 4) ? rng() : START_BYTE, K_NOISE);
+	       gap(s);
+	  }
+     }
+
+     return(true);
+}
+
+static bool load(stream_t *s, const char *fname)
+{
+     struct stat st;
+     int fd;
+
+     fd = open(fname, O_RDONLY);
+     if (fd < 0 || fstat(fd, &st) < 0)
+     {
+	  fprintf(stderr, "Unable to open the capture file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  if (fd >= 0)
+	       close(fd);
+	  return(false);
+     }
+
+     s->max = s->len = (size_t)st.st_size;
+     s->bytes = (uint8_t *)malloc(s->len ? s->len : 1);
+     if (!s->bytes || read(fd, s->bytes, s->len) != (ssize_t)s->len)
+     {
+	  fprintf(stderr, "Unable to read the capture file \"%s\"\n", fname);
+	  close(fd);
+	  return(false);
+     }
+
+     close(fd);
+     return(true);
+}
+
+static bool save(const stream_t *s, const char *fname)
+{
+     int fd;
+
+     fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+     if (fd < 0)
+     {
+	  fprintf(stderr, "Unable to create the file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  return(false);
+     }
+     if (write(fd, s->bytes, s->len) != (ssize_t)s->len)
+     {
+	  fprintf(stderr, "Unable to write the file \"%s\"; %s (%d)\n",
+		  fname, strerror(errno), errno);
+	  close(fd);
+	  return(false);
+     }
+     close(fd);
+     return(true);
+}
+
+static void fail(result_t *r, size_t offset, const char *what)
+{
+     // Enough to find the first few in a -w dump
+     if (r->failures++ < 10)
+	  fprintf(stderr, "byte %lu: %s\n", (unsigned long)offset, what);
+}
+
+// Parse the stream once with every check; good is the offset of the
+// next good packet to come out
+static void check(const stream_t *s, result_t *r)
+{
+     InPacket packet;
+     size_t i, g = 0, started = 0, good = 0;
+
+     memset(r, 0, sizeof(result_t));
+
+     for (i = 0; i < s->len; i++)
+     {
+	  if (g < s->ngaps && s->gaps[g] == i)
+	  {
+	       g++;
+	       if (packet.isStarted())
+	       {
+		    packet.timeout();
+		    r->timeouts++;
+		    packet.reset();
+	       }
+	  }
+
+	  if (!packet.isStarted())
+	       started = i;
+
+	  packet.processByte(s->bytes[i]);
+
+	  uint8_t state = packet.debugGetState();
+	  if (state > PS_CRC && state != PS_LAST)
+	       fail(r, i, "parser left in an unknown state");
+	  if (packet.getLength() > MAX_PACKET_PAYLOAD)
+	       fail(r, i, "payload longer than MAX_PACKET_PAYLOAD");
+
+	  if (packet.isFinished())
+	  {
+	       r->packets++;
+	       if (s->kind)
+	       {
+		    // Which good packet, if any, ends here
+		    while (good < i && s->kind[good] != K_GOOD)
+			 good++;
+		    if (s->kind[i] == K_NOISE)
+			 r->spurious++;
+		    else if (good != started || s->kind[i] != K_GOOD ||
+			     i - started != (size_t)packet.getLength() + 2)
+			 fail(r, i, "unexpected packet");
+		    else
+		    {
+			 const volatile uint8_t *data = packet.getData();
+			 for (uint8_t j = 0; j < packet.getLength(); j++)
+			      if (data[j] != s->bytes[started + 2 + j])
+			      {
+				   fail(r, i, "mangled packet");
+				   break;
+			      }
+			 good = i + 1;
+		    }
+	       }
+	       packet.reset();
+	  }
+	  else if (packet.hasError())
+	  {
+	       r->errors++;
+	       packet.reset();
+	  }
+	  else if (packet.isStarted() && i - started >= MAX_FRAME)
+	  {
+	       r->stalls++;
+	       fail(r, i, "parser stalled");
+	       packet.reset();
+	  }
+	  else if (s->kind && s->kind[i] == K_GOOD && !packet.isStarted())
+	       // A good packet was dropped part way through
+	       fail(r, i, "lost packet");
+     }
+
+     if (s->kind)
+     {
+	  // Good packets the noise has swallowed would show up here
+	  if (r->packets - r->spurious != s->good)
+	       fail(r, s->len, "count of good packets is wrong");
+	  // Each noise byte outside a packet is an error of its own, so
+	  // only the bad packets are counted exactly
+	  if (r->errors < s->bad)
+	       fail(r, s->len, "count of bad packets is wrong");
+     }
+}
+
+// Parse the stream as quickly as runHostSlice() could take packets off
+static int64_t timed(const stream_t *s)
+{
+     InPacket packet;
+     size_t i, g = 0;
+     uint32_t packets = 0;
+     int64_t start;
+
+     start = now();
+     for (i = 0; i < s->len; i++)
+     {
+	  if (g < s->ngaps && s->gaps[g] == i)
+	  {
+	       g++;
+	       if (packet.isStarted())
+		    packet.reset();
+	  }
+	  packet.processByte(s->bytes[i]);
+	  if (packet.isFinished())
+	  {
+	       packets++;
+	       packet.reset();
+	  }
+	  else if (packet.hasError())
+	       packet.reset();
+     }
+
+     // Keep the loop from being optimised away
+     if (packets == 0xFFFFFFFF)
+	  fprintf(stderr, "\n");
+
+     return(now() - start);
+}
+
+static bool run(const char *name, const stream_t *s, int passes)
+{
+     result_t r;
+
+     check(s, &r);
+     for (int p = 0; p < passes; p++)
+     {
+	  int64_t usecs = timed(s);
+	  if (p == 0 || usecs < r.usecs)
+	       r.usecs = usecs;
+     }
+
+     printf("%-32s %10lu %8u %8u %8u %8u %6u %12.0f\n", name, (unsigned long)s->len,
+	    r.packets, r.errors, r.timeouts, r.spurious, r.stalls,
+	    (r.usecs > 0) ? (float)s->len * 1000000.0f / (float)r.usecs : 0.0f);
+     if (r.failures)
+	  printf("%s: %u check(s) failed\n", name, r.failures);
+
+     return(r.failures == 0);
+}
+
+int main(int argc, const char *argv[])
+{
+     char c;
+     int passes = 3;
+     int status = 0;
+     size_t len = 1000000;
+     const char *wfile = NULL;
+
+     while ((c = getopt(argc, (char **)argv, ":hn:r:s:w:?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  // Unknown switch
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  // Explicit help request
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(1);
+
+	  case 'n' :
+	       len = (size_t)atol(optarg);
+	       if (len < MAX_FRAME)
+	       {
+		    fprintf(stderr, "%s: the stream length, \"%s\", must be at least %d bytes\n",
+			    argv[0], optarg, MAX_FRAME);
+		    return(1);
+	       }
+	       break;
+
+	  case 'r' :
+	       passes = atoi(optarg);
+	       if (passes <= 0)
+	       {
+		    fprintf(stderr, "%s: the number of passes, \"%s\", must be a positive integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+
+	  case 's' :
+	       rng_state = (uint32_t)strtoul(optarg, NULL, 0);
+	       if (rng_state == 0)
+	       {
+		    fprintf(stderr, "%s: the seed, \"%s\", must be a non-zero integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+
+	  case 'w' :
+	       wfile = optarg;
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+
+     printf("%-32s %10s %8s %8s %8s %8s %6s %12s\n",
+	    "stream", "bytes", "packets", "errors", "timeouts", "spurious", "stalls", "bytes/s");
+
+     if (argc == 0)
+     {
+	  stream_t s;
+
+	  memset(&s, 0, sizeof(stream_t));
+	  if (!generate(&s, len))
+	       return(1);
+	  if (wfile && !save(&s, wfile))
+	       status = 1;
+	  if (!run("(random)", &s, passes))
+	       status = 1;
+	  free(s.bytes);
+	  free(s.kind);
+	  free(s.gaps);
+	  return(status);
+     }
+
+     for (int f = 0; f < argc; f++)
+     {
+	  stream_t s;
+
+	  memset(&s, 0, sizeof(stream_t));
+	  if (!load(&s, argv[f]))
+	  {
+	       free(s.bytes);
+	       status = 1;
+	       continue;
+	  }
+	  if (!run(argv[f], &s, passes))
+	       status = 1;
+	  free(s.bytes);
+     }
+
+     return(status);
+}
@@ -0,0 +1,275 @@
+// Planner throughput benchmark
+//
+//     planbench [-r passes] file [file ...]
+//
+// Replays the moves of each .s3g or .x3g file through the planner and
+// reports the number of segments planned per second, how many times on
+// average each block was (re)planned before it was retired, and the
+// number of suspect FPTYPE computations seen by the overflow checks.
+//
+// The commands are read into memory first so that only the planner is
+// timed.  With several passes the fastest one is reported.  Blocks are
+// retired once the pipeline is half full, as the simulator does.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/time.h>
+
+#include "Simulator.hh"
+#include "StepperAccelPlannerExtras.hh"
+#include "StepperAccel.hh"
+#include "EepromMap.hh"
+#include "Point.hh"
+#include "Steppers.hh"
+#include "s3g.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+typedef struct {
+     uint32_t segments;      // blocks retired
+     uint32_t planned;       // sum of block->planned over the retired blocks
+     int      max_planned;
+     uint32_t overflows;
+     int64_t  usecs;
+} bench_t;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-? | -h] [-r passes] file [file ...]\n"
+"         file -- The .s3g or .x3g file to replay through the planner\n"
+"    -r passes -- Replay each file \"passes\" times and report the fastest (default 3)\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "planbench");
+}
+
+// Microseconds; Simulator.hh makes double a float, which can't hold the time of day
+static int64_t now(void)
+{
+     struct timeval tv;
+
+     gettimeofday(&tv, NULL);
+     return (int64_t)tv.tv_sec * 1000000 + (int64_t)tv.tv_usec;
+}
+
+// Read the whole file so that the replay isn't timing file i/o
+static s3g_command_t *load(const char *fname, size_t *count)
+{
+     s3g_context_t *ctx;
+     s3g_command_t cmd, *cmds = NULL;
+     size_t n = 0, max = 0;
+
+     ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (void *)fname, O_RDONLY, 0);
+     if (!ctx)
+	  // Assume that s3g_open() has complained
+	  return(NULL);
+
+     while (!s3g_command_read(ctx, &cmd))
+     {
+	  if (n >= max)
+	  {
+	       s3g_command_t *tmp;
+
+	       max = max ? max * 2 : 4096;
+	       tmp = (s3g_command_t *)realloc(cmds, max * sizeof(s3g_command_t));
+	       if (!tmp)
+	       {
+		    fprintf(stderr, "Unable to allocate memory for the commands in %s\n", fname);
+		    free(cmds);
+		    s3g_close(ctx);
+		    return(NULL);
+	       }
+	       cmds = tmp;
+	  }
+	  memcpy(&cmds[n++], &cmd, sizeof(s3g_command_t));
+     }
+
+     s3g_close(ctx);
+
+     *count = n;
+     return(cmds);
+}
+
+static void retire_block(bench_t *b)
+{
+     block_t *block = plan_get_current_block();
+
+     if (!block)
+	  return;
+
+     b->segments++;
+     b->planned += block->planned;
+     if (block->planned > b->max_planned)
+	  b->max_planned = block->planned;
+
+     plan_discard_current_block();
+}
+
+static void replay(const s3g_command_t *cmds, size_t count, bench_t *b)
+{
+     size_t i;
+     int64_t start;
+
+     steppers::reset();
+     init_extras(true);
+
+     memset(b, 0, sizeof(bench_t));
+     simulator_overflow_count = 0;
+
+     start = now();
+
+     for (i = 0; i < count; i++)
+     {
+	  const s3g_command_t *cmd = &cmds[i];
+
+	  if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_NEW)
+	  {
+	       Point target = Point(cmd->t.queue_point_new.x, cmd->t.queue_point_new.y,
+				    cmd->t.queue_point_new.z, cmd->t.queue_point_new.a,
+				    cmd->t.queue_point_new.b);
+	       steppers::setTargetNew(target, 0, cmd->t.queue_point_new.us, cmd->t.queue_point_new.rel);
+	  }
+	  else if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_NEW_EXT ||
+		   cmd->cmd_id == HOST_CMD_QUEUE_POINT_DELTA)
+	  {
+	       Point target = Point(cmd->t.queue_point_new_ext.x, cmd->t.queue_point_new_ext.y,
+				    cmd->t.queue_point_new_ext.z, cmd->t.queue_point_new_ext.a,
+				    cmd->t.queue_point_new_ext.b);
+	       steppers::setTargetNewExt(target, cmd->t.queue_point_new_ext.dda_rate,
+					 cmd->t.queue_point_new_ext.rel,
+					 plan_float_to_fp(cmd->t.queue_point_new_ext.distance),
+					 cmd->t.queue_point_new_ext.feedrate_mult_64);
+	  }
+	  else if (cmd->cmd_id == HOST_CMD_QUEUE_POINT_EXT)
+	  {
+	       Point target = Point(cmd->t.queue_point_ext.x, cmd->t.queue_point_ext.y,
+				    cmd->t.queue_point_ext.z, cmd->t.queue_point_ext.a,
+				    cmd->t.queue_point_ext.b);
+	       steppers::setTargetNew(target, cmd->t.queue_point_ext.dda, 0, 0);
+	  }
+	  else if (cmd->cmd_id == HOST_CMD_SET_POSITION_EXT)
+	  {
+	       Point target = Point(cmd->t.set_position_ext.x, cmd->t.set_position_ext.y,
+				    cmd->t.set_position_ext.z, cmd->t.set_position_ext.a,
+				    cmd->t.set_position_ext.b);
+	       steppers::definePosition(target, false);
+	       continue;
+	  }
+	  else if (cmd->cmd_id == HOST_CMD_SET_ACCELERATION_TOGGLE)
+	  {
+	       steppers::setSegmentAccelState((cmd->t.set_segment_acceleration.s != 0) ? true : false);
+	       continue;
+	  }
+	  else
+	  {
+	       // Commands which the bot waits on drain the pipeline
+	       if (cmd->cmd_id != HOST_CMD_TOOL_COMMAND &&
+		   cmd->cmd_id != HOST_CMD_ENABLE_AXES &&
+		   cmd->cmd_id != HOST_CMD_SET_BUILD_PERCENT &&
+		   cmd->cmd_id != HOST_CMD_CHANGE_TOOL &&
+		   cmd->cmd_id != HOST_CMD_RECALL_HOME_POSITION)
+		    while (movesplanned() != 0)
+			 retire_block(b);
+	       continue;
+	  }
+
+	  if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1))
+	       retire_block(b);
+     }
+
+     while (movesplanned() != 0)
+	  retire_block(b);
+
+     b->usecs = now() - start;
+     b->overflows = simulator_overflow_count;
+}
+
+int main(int argc, const char *argv[])
+{
+     char c;
+     int passes = 3;
+     int status = 0;
+
+     while ((c = getopt(argc, (char **)argv, ":hr:?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  // Unknown switch
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  // Explicit help request
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(1);
+
+	  case 'r' :
+	       passes = atoi(optarg);
+	       if (passes <= 0)
+	       {
+		    fprintf(stderr, "%s: the number of passes, \"%s\", must be a positive integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+     if (argc == 0)
+     {
+	  usage(stderr, NULL);
+	  return(1);
+     }
+
+     steppers::init();
+
+     // The overflow checks are tallied rather than printed
+     simulator_quiet_overflows = true;
+
+     printf("%-32s %9s %12s %10s %5s %9s\n",
+	    "file", "segments", "segments/s", "avg depth", "max", "overflows");
+
+     for (int f = 0; f < argc; f++)
+     {
+	  s3g_command_t *cmds;
+	  size_t count;
+	  bench_t best, b;
+
+	  cmds = load(argv[f], &count);
+	  if (!cmds)
+	  {
+	       status = 1;
+	       continue;
+	  }
+
+	  for (int p = 0; p < passes; p++)
+	  {
+	       replay(cmds, count, &b);
+	       if (p == 0 || b.usecs < best.usecs)
+		    best = b;
+	  }
+	  free(cmds);
+
+	  printf("%-32s %9u %12.0f %10.2f %5d %9u\n", argv[f], best.segments,
+		 (best.usecs > 0) ? (float)best.segments * 1000000.0f / (float)best.usecs : 0.0f,
+		 best.segments ? (float)best.planned / (float)best.segments : 0.0f,
+		 best.max_planned, best.overflows);
+     }
+
+     return(status);
+}
@@ -1,10 +1,14 @@
-// Simple tool to dump a .s3g file either from disk of from stdin
+// Simple tool to copy a .s3g file either from disk of from stdin
 //
-//     s3gcopy filename
+//     planner [-H] [-o outfile] filename
 //
 // or
 //
-//     s3gcopy < filename
+//     planner [-H] [-o outfile] < filename
+//
+// With -H, a HOST_CMD_PLANNER_HINT is written ahead of each accelerated
+// move, holding the junction speed the firmware would otherwise work out
+// as it queued the move.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,47 +35,114 @@ static void usage(FILE *f, const char *prog)
 	  f = stderr;
 
      fprintf(f,
-"Usage: %s -hE [file]\n"
-"   file  -- The .s3g file to dump.  If not supplied then stdin is dumped\n"
-"  ?, -h  -- This help message\n"
-"     -E  -- Display distance moved and ratio of extruder steps to distance\n",
-	     prog ? prog : "s3gdump");
+"Usage: %s [-hH] [-a x,y,z,a,b] [-j jdev] [-J x,y,z,a,b] [-s x,y,z,a,b] [-o outfile] [file]\n"
+"         file -- The .s3g file to read.  If not supplied then stdin is read\n"
+"   -o outfile -- The .x3g file to write (default ./out.x3g)\n"
+"           -H -- Write a planner hint ahead of each accelerated move, with\n"
+"                 the junction speed worked out from the settings below,\n"
+"                 which should be the printer's own\n"
+" -a x,y,z,a,b -- Max acceleration of each axis, in mm/s^2 (default 1000,1000,150,\n"
+"                 2000,2000)\n"
+"      -j jdev -- Junction deviation, in mm (default 0, none)\n"
+" -J x,y,z,a,b -- Max speed change of each axis, in mm/s (default 15,15,10,20,20)\n"
+" -s x,y,z,a,b -- Steps per mm of each axis (default 94.139704,94.139704,400,\n"
+"                 96.275202,96.275202)\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "planner");
 }
 
-int main(int argc, const char *argv[])
+int main(int argc, char *argv[])
 {
-     bool acceleration_enabled, blocking;
+     bool acceleration_enabled, blocking, hints;
+     char c;
      s3g_command_t cmd;
-     int tool_id;
+     int i, tool_id;
      s3g_context_t *in_ctx, *out_ctx;
      int32_t tool_offsets[NTOOLS][NAXES];
+     const char *outfile = "./out.x3g";
+     float jdev = 0.0f;
+     float accel[NAXES] = { 1000.0f, 1000.0f, 150.0f, 2000.0f, 2000.0f };
+     float jerk[NAXES]  = { 15.0f, 15.0f, 10.0f, 20.0f, 20.0f };
+     float spm[NAXES] = { 94.139704f, 94.139704f, 400.0f, 96.275202f, 96.275202f };
 
      assert(sizeof(int) >= sizeof(int32_t));
 
      acceleration_enabled = false;
+     hints   = false;
      in_ctx  = NULL;
      out_ctx = NULL;
 
-     if (argc < 2)
-	  in_ctx = s3g_open(0, NULL, O_RDONLY, 0);
-     else
+     while ((c = getopt(argc, argv, ":a:hHj:J:o:s:?")) != GETOPTS_END)
      {
-	  if (!strcmp(argv[1], "?") || !strcmp(argv[1], "-h"))
+	  switch(c)
+	  {
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(0);
+
+	  case 'H' :
+	       hints = true;
+	       break;
+
+	  case 'j' :
+	       jdev = strtof(optarg, NULL);
+	       break;
+
+	  case 'a' :
+	  case 'J' :
+	  case 's' :
 	  {
-	        usage(NULL, argv[0]);
-		return -1;
+	       float *v = (c == 'a') ? accel : (c == 'J') ? jerk : spm;
+
+	       if (NAXES != sscanf(optarg, "%f,%f,%f,%f,%f", &v[0], &v[1], &v[2],
+				   &v[3], &v[4]))
+	       {
+		    fprintf(stderr, "%s: unable to parse the list of five values, \"%s\"\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       for (i = 0; i < NAXES; i++)
+		    if (v[i] <= 0.0f)
+		    {
+			 fprintf(stderr, "%s: the values of -%c must be positive\n", argv[0], c);
+			 return(1);
+		    }
+	       break;
+	  }
+
+	  case 'o' :
+	       outfile = optarg;
+	       break;
 	  }
-	  in_ctx = s3g_open(0, (void *)argv[1], O_RDONLY, 0);
      }
 
+     argc -= optind;
+     argv += optind;
+     if (argc > 1)
+     {
+	  usage(stderr, NULL);
+	  return(1);
+     }
+
+     in_ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (argc > 0) ? (void *)argv[0] : NULL, O_RDONLY, 0);
+
      if (!in_ctx)
 	  // Assume that s3g_open() has complained
 	  return(1);
 
-     if (!(out_ctx = s3g_open(0, "./out.x3g", O_CREAT | O_WRONLY, 0644)))
+     if (!(out_ctx = s3g_open(0, (void *)outfile, O_CREAT | O_TRUNC | O_WRONLY, 0644)) ||
+	 s3g_set_write_buffer(out_ctx, 0))
 	  goto done;
 
      s3g_position_init();
+     if (hints)
+	  s3g_queue_hints(accel, jdev, jerk, spm);
      tool_id = 0;
 
      while (!s3g_command_read(in_ctx, &cmd))
@@ -111,6 +182,13 @@ int main(int argc, const char *argv[])
 	       s3g_position_mark_known(4, (int)cmd.t.set_position_ext.b);
 	       break;
 
+	  // Hints are written afresh with -H, so those already there go
+
+	  case HOST_CMD_PLANNER_HINT :
+	       if (hints)
+		    cmd.cmd_raw_len = 0;
+	       break;
+
 	  // Change acceleration state
 
 	  case HOST_CMD_SET_ACCELERATION_TOGGLE :
@@ -157,6 +235,7 @@ int main(int argc, const char *argv[])
 	  // Accelerated motion command
 
 	  case HOST_CMD_QUEUE_POINT_NEW_EXT :
+	  case HOST_CMD_QUEUE_POINT_DELTA :
 	  {
 	       int32_t target[NAXES];
 
@@ -227,7 +306,11 @@ int main(int argc, const char *argv[])
 
 done:
      s3g_close(in_ctx);
-     s3g_close(out_ctx);
+     if (s3g_close(out_ctx))
+     {
+	  fprintf(stderr, "*** 5 s3g_close() badness ***\n");
+	  return(-1);
+     }
      
      return(0);
 }
@@ -3,6 +3,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <math.h>
 #include "s3g_private.h"
 #include "s3g_stdio.h"
 #include "s3g.h"
@@ -28,6 +29,10 @@ typedef struct cmd_move_s {
      float    distance;     // distance (mm)
      int      dda;          // DDA rate
      uint8_t  relmask;
+     float    accel;        // acceleration along the move (mm/s^2)
+     float    vmax;         // max entry speed (mm/s) for a planner hint
+     bool     hint;         // write a HOST_CMD_PLANNER_HINT ahead of the move
+     bool     nominal_length; // can stop from feedrate within distance
 } cmd_move_t;
 
 typedef struct queue_s {
@@ -40,6 +45,15 @@ static size_t queue_max = 0;
 static size_t queue_next = 0;
 static cmd_move_t *prev_move = NULL;
 
+// Planner hints; see s3g_queue_hints()
+static bool  hints = false;
+static float hint_accel[NAXES] = { 1000.0f, 1000.0f, 150.0f, 2000.0f, 2000.0f };
+static float hint_jerk[NAXES]  = { 15.0f, 15.0f, 10.0f, 20.0f, 20.0f };
+static float hint_jdev = 0.0f;
+static float steps_per_mm[NAXES] = {
+     94.139704f, 94.139704f, 400.0f, 96.275202f, 96.275202f
+};
+
 static unsigned char *w8(unsigned char *buf, unsigned char v)
 {
      *buf++ = v;
@@ -252,7 +266,7 @@ int s3g_queue_accelerated(int *target, bool accelerated, int dda_rate, float dis
 	  }
 
 	  // Axial distance in millimeters
-	  ptr->d[i] = 1.0; // steps_to_mm(i, ptr->steps[i]);
+	  ptr->d[i] = (float)ptr->steps[i] / steps_per_mm[i];
      }
 
      ptr->dda      = dda_rate;
@@ -274,6 +288,151 @@ int s3g_queue_accelerated(int *target, bool accelerated, int dda_rate, float dis
      return(0);
 }
 
+void s3g_queue_hints(const float *accel, float jdev, const float *jerk, const float *spm)
+{
+     int i;
+
+     hints     = true;
+     hint_jdev = jdev;
+     for (i = 0; i < NAXES; i++)
+     {
+	  if (accel)
+	       hint_accel[i] = accel[i];
+	  if (jerk)
+	       hint_jerk[i] = jerk[i];
+	  if (spm)
+	       steps_per_mm[i] = spm[i];
+     }
+}
+
+// The acceleration the firmware gives move m: the master axis's, cut to
+// that of any other axis which it would take over the limit of
+
+static float move_accel(const cmd_move_t *m)
+{
+     int i, k = m->msteps_index;
+     float acc_st;
+
+     if (m->msteps == 0)
+	  return(0.0f);
+
+     // In steps of the master axis per s^2
+     acc_st = hint_accel[k] * steps_per_mm[k];
+     for (i = 0; i < NAXES; i++)
+	  if (i != k && acc_st * (float)abs(m->steps[i]) >
+	      hint_accel[i] * steps_per_mm[i] * (float)m->msteps)
+	       acc_st = hint_accel[i] * steps_per_mm[i];
+
+     return(acc_st * m->distance / (float)m->msteps);
+}
+
+// The junction speed the firmware would work out for move m after move p,
+// with the same sums as plan_buffer_line().  prev_s holds the axis speeds
+// the firmware keeps of p, and is updated to those of m.
+
+static float junction_speed(const cmd_move_t *p, const cmd_move_t *m, float *prev_s)
+{
+     int i;
+     float scaling = 1.0f, vmax, min_jerk;
+     uint8_t jerk_axes = AXES_MASK;
+     bool scaled;
+
+     min_jerk = hint_jerk[0];
+     for (i = 1; i < NAXES; i++)
+	  if (hint_jerk[i] < min_jerk)
+	       min_jerk = hint_jerk[i];
+
+     scaled = false;
+     if (!p)
+	  vmax = 0.0f;
+     else if (m->feedrate <= min_jerk)
+	  vmax = m->feedrate;
+     else
+     {
+	  float mxyz = sqrtf(m->d[0] * m->d[0] + m->d[1] * m->d[1] + m->d[2] * m->d[2]);
+	  float pxyz = sqrtf(p->d[0] * p->d[0] + p->d[1] * p->d[1] + p->d[2] * p->d[2]);
+
+	  if (hint_jdev > 0.0f && mxyz > 0.0f && pxyz > 0.0f && p->feedrate > 0.0f)
+	  {
+	       float cos_dir = 0.0f, sin_half;
+
+	       for (i = 0; i < 3; i++)
+		    cos_dir += (m->d[i] / mxyz) * (p->d[i] / pxyz);
+	       sin_half = (cos_dir > -1.0f) ? sqrtf((1.0f + cos_dir) * 0.5f) : 0.0f;
+	       if (1.0f - sin_half > 0.001f)
+	       {
+		    float v = sqrtf(m->accel * hint_jdev) * sqrtf(sin_half / (1.0f - sin_half));
+		    if (v < p->feedrate && v < m->feedrate)
+			 scaling = v / m->feedrate;
+	       }
+	       if (p->feedrate < m->feedrate * scaling)
+		    scaling = p->feedrate / m->feedrate;
+	       jerk_axes &= ~AXES_XYZ_MASK;
+	  }
+
+	  for (i = 0; i < NAXES; i++)
+	  {
+	       float s;
+
+	       if (!(jerk_axes & (1 << i)) || fabsf(m->s[i] - prev_s[i]) <= hint_jerk[i])
+		    continue;
+	       if (m->s[i] == 0.0f)
+	       {
+		    scaling = 0.0f;
+		    break;
+	       }
+	       s = (m->s[i] > prev_s[i]) ? (prev_s[i] + hint_jerk[i]) / m->s[i] :
+		    (prev_s[i] - hint_jerk[i]) / m->s[i];
+	       if (s < scaling)
+	       {
+		    if (s <= 0.0f)
+		    {
+			 scaling = 0.0f;
+			 break;
+		    }
+		    scaling = s;
+	       }
+	  }
+	  vmax = m->feedrate * scaling;
+	  scaled = scaling != 1.0f;
+     }
+
+     for (i = 0; i < NAXES; i++)
+	  prev_s[i] = scaled ? m->s[i] * scaling : m->s[i];
+
+     return(vmax);
+}
+
+// Work out the hint for each queued move.  Only the junction sums are the
+// host's to do: the firmware brakes to a stop at the end of its own buffer
+// whatever the host plans, so braking sooner for a stop further ahead
+// could only slow the moves down.
+
+static void plan_moves(void)
+{
+     int i, k;
+     float prev_s[NAXES];
+     cmd_move_t *m, *p = NULL;
+
+     for (k = 0; k < NAXES; k++)
+	  prev_s[k] = 0.0f;
+
+     for (i = 0; i < queue_next; i++)
+     {
+	  if (!queue[i].is_move || !queue[i].cmd)
+	       continue;
+	  m = (cmd_move_t *)queue[i].cmd;
+	  for (k = 0; k < NAXES; k++)
+	       m->s[k] = (m->distance > 0.0f) ? m->d[k] * m->feedrate / m->distance : 0.0f;
+	  m->hint = p && m->feedrate > 0.0f && m->distance > 0.0f &&
+	       (m->steps[0] || m->steps[1] || m->steps[2]);
+	  m->accel = move_accel(m);
+	  m->vmax = junction_speed(p, m, prev_s);
+	  m->nominal_length = m->feedrate <= sqrtf(2.0f * m->accel * m->distance);
+	  p = m;
+     }
+}
+
 int s3g_queue_flush(s3g_context_t *ctx)
 {
      int i, iret;
@@ -284,6 +443,9 @@ int s3g_queue_flush(s3g_context_t *ctx)
 	  return(-1);
      }
 
+     if (hints)
+	  plan_moves();
+
      iret = 0;
      for (i = 0; i < queue_next; i++)
      {
@@ -298,6 +460,22 @@ int s3g_queue_flush(s3g_context_t *ctx)
 	       size_t len;
 	       cmd_move_t *ptr = (cmd_move_t *)queue[i].cmd;
 
+	       if (hints && ptr->hint)
+	       {
+		    // 0 is no hint to the firmware, so a stop is sent as 1
+		    float v = ptr->vmax * 64.0f;
+		    uint16_t v64 = (v >= 65535.0f) ? 65535 : (v < 1.0f) ? 1 : (uint16_t)v;
+
+		    bufptr = buf;
+		    bufptr = w8(bufptr,  (uint8_t)HOST_CMD_PLANNER_HINT);
+		    bufptr = w16(bufptr, v64);
+		    bufptr = w8(bufptr,  ptr->nominal_length ? PLANNER_HINT_NOMINAL_LENGTH : 0);
+
+		    len = bufptr - buf;
+		    if ((ssize_t)len != s3g_write(ctx, buf, len))
+			 iret = -1;
+	       }
+
 	       bufptr = buf;
 	       bufptr = w8(bufptr,     (uint8_t)HOST_CMD_QUEUE_POINT_NEW_EXT);
 	       bufptr = w32(bufptr,    (int32_t)ptr->t[0]);
@@ -311,14 +489,14 @@ int s3g_queue_flush(s3g_context_t *ctx)
 	       bufptr = w16(bufptr,    (int16_t)(ptr->feedrate * 64.0));
 
 	       len = bufptr - buf;
-	       if ((ssize_t)len != (*ctx->write)(ctx->w_ctx, buf, len))
+	       if ((ssize_t)len != s3g_write(ctx, buf, len))
 		    iret = -1;
 	       free(ptr);
 	  }
 	  else {
 	       cmd_raw_t *ptr = (cmd_raw_t *)queue[i].cmd;
 
-	       if ((ssize_t)ptr->len != (*ctx->write)(ctx->w_ctx, ptr->cmd, ptr->len))
+	       if ((ssize_t)ptr->len != s3g_write(ctx, ptr->cmd, ptr->len))
 		    iret = -1;
 	       free(ptr);
 	  }
@@ -9,6 +9,12 @@ void s3g_queue_init(void);
 int s3g_queue_len(void);
 int s3g_queue_add_cmd(unsigned char *cmd, size_t len);
 int s3g_queue_flush(s3g_context_t *ctx);
+
+// Write a HOST_CMD_PLANNER_HINT ahead of each move flushed, planned with
+// the axis accelerations accel[] (mm/s^2), junction deviation jdev (mm, 0
+// for none) and max speed changes jerk[] (mm/s) the firmware is set to.
+// accel, jerk and spm, the steps per mm, may be NULL to keep the defaults.
+void s3g_queue_hints(const float *accel, float jdev, const float *jerk, const float *spm);
 int s3g_queue_unaccelerated(s3g_command_t *cmd, int *target, uint8_t relmask);
 int s3g_queue_accelerated(int *target, bool acceleration_enabled, int dda_rate,
   float distance, float feedrate, uint8_t relmask);
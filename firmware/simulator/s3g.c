@@ -9,6 +9,7 @@
 #include "Commands.hh"
 #include "s3g_private.h"
 #include "s3g_stdio.h"
+#include "s3g_mmap.h"
 #include "s3g.h"
 
 typedef struct {
@@ -89,7 +90,13 @@ static const s3g_command_info_t command_table_raw[] = {
      /* 155 */  {HOST_CMD_QUEUE_POINT_NEW_EXT, 31, 0, "queue point new extended"},
      /* 156 */  {HOST_CMD_SET_ACCELERATION_TOGGLE, 1, -1, "set segment acceleration"},
      /* 157 */  {HOST_CMD_STREAM_VERSION, 20, 0, "stream version"},
-     /* 158 */  {HOST_CMD_PAUSE_AT_ZPOS, 4, 0, "pause at Z position"}
+     /* 158 */  {HOST_CMD_PAUSE_AT_ZPOS, 4, 0, "pause at Z position"},
+     /* 159 */  {HOST_CMD_QUEUE_POINT_DELTA, -1, 0, "queue point delta"},
+     /* 162 */  {HOST_CMD_PLANNER_HINT, 3, 0, "planner hint"},
+     /* 163 */  {HOST_CMD_FIRMWARE_RETRACT, 5, 0, "firmware retract"},
+     /* 164 */  {HOST_CMD_SET_ADVANCE_PROFILE, 1, 0, "set advance profile"},
+     /* 165 */  {HOST_CMD_PROBE_POINT, 18, -1, "probe point"},
+     /* 166 */  {HOST_CMD_CONCURRENT, 1, 0, "concurrent start up"}
 };
 
 static const s3g_command_info_t tool_command_table_raw[] = {
@@ -219,8 +226,7 @@ static int s3g_init(void)
 s3g_context_t *s3g_open(int type, void *src, int flags, int mode)
 {
      s3g_context_t *ctx;
-
-     (void)type; // Only type is a file
+     int istat;
 
      ctx = (s3g_context_t *)calloc(1, sizeof(s3g_context_t));
      if (!ctx)
@@ -230,8 +236,18 @@ s3g_context_t *s3g_open(int type, void *src, int flags, int mode)
 	  return(NULL);
      }
 
-     if (s3g_stdio_open(ctx, src, flags, mode))
+     // Map the file when asked to, falling back to reading it when it
+     // can't be mapped
+     istat = 1;
+     if (type == S3G_INPUT_TYPE_MMAP)
+	  istat = s3g_mmap_open(ctx, src, flags, mode);
+     if (istat > 0)
+	  istat = s3g_stdio_open(ctx, src, flags, mode);
+     if (istat)
+     {
+	  free(ctx);
 	  return(NULL);
+     }
 
      return(ctx);
 }
@@ -239,13 +255,18 @@ s3g_context_t *s3g_open(int type, void *src, int flags, int mode)
 
 int s3g_close(s3g_context_t *ctx)
 {
-     int iret;
+     int iret, fret;
 
      if (!ctx)
 	  return(0);
 
+     fret = s3g_flush(ctx);
      iret = (ctx->close != NULL) ? (*ctx->close)(ctx->r_ctx) : 0;
+     if (fret)
+	  iret = fret;
 
+     if (ctx->wbuf)
+	  free(ctx->wbuf);
      free(ctx);
 
      return(iret);
@@ -518,6 +539,58 @@ int s3g_command_read_ext(s3g_context_t *ctx, s3g_command_t *cmd,
 	  GET_INT16(queue_point_new_ext.feedrate_mult_64);
 	  break;
 
+     case HOST_CMD_QUEUE_POINT_DELTA :
+	  // axes1, then x2, y2, z2, a2, b2 for each axis in it, dda_rate2,
+	  // distance 4, feedrate_mult64 2 = 9 to 19 bytes.  Decoded as a
+	  // queue point new extended with every axis relative.
+	  GET_UINT8(queue_point_new_ext.rel);
+	  ui8arg = cmd->t.queue_point_new_ext.rel;
+	  cmd->cmd_len = 9;
+	  if (ui8arg & 0x01) { GET_INT16(queue_point_new_ext.x); cmd->cmd_len += 2; }
+	  else ZERO(queue_point_new_ext.x, int32_t);
+	  if (ui8arg & 0x02) { GET_INT16(queue_point_new_ext.y); cmd->cmd_len += 2; }
+	  else ZERO(queue_point_new_ext.y, int32_t);
+	  if (ui8arg & 0x04) { GET_INT16(queue_point_new_ext.z); cmd->cmd_len += 2; }
+	  else ZERO(queue_point_new_ext.z, int32_t);
+	  if (ui8arg & 0x08) { GET_INT16(queue_point_new_ext.a); cmd->cmd_len += 2; }
+	  else ZERO(queue_point_new_ext.a, int32_t);
+	  if (ui8arg & 0x10) { GET_INT16(queue_point_new_ext.b); cmd->cmd_len += 2; }
+	  else ZERO(queue_point_new_ext.b, int32_t);
+	  GET_UINT16(queue_point_new_ext.dda_rate);
+	  GET_FLOAT32(queue_point_new_ext.distance);
+	  GET_INT16(queue_point_new_ext.feedrate_mult_64);
+	  cmd->t.queue_point_new_ext.rel = 0x1f;
+	  break;
+
+     case HOST_CMD_PLANNER_HINT :
+	  GET_UINT16(planner_hint.max_entry_speed_64);
+	  GET_UINT8(planner_hint.flags);
+	  break;
+
+     case HOST_CMD_FIRMWARE_RETRACT :
+	  GET_UINT8(firmware_retract.flags);
+	  GET_UINT16(firmware_retract.steps);
+	  GET_INT16(firmware_retract.feedrate_mult_64);
+	  break;
+
+     case HOST_CMD_SET_ADVANCE_PROFILE :
+	  GET_UINT8(advance_profile.index);
+	  break;
+
+     case HOST_CMD_PROBE_POINT :
+	  GET_UINT8(probe_point.point);
+	  GET_INT32(probe_point.x);
+	  GET_INT32(probe_point.y);
+	  GET_UINT32(probe_point.feedrate);
+	  GET_UINT16(probe_point.timeout);
+	  GET_UINT16(probe_point.tolerance);
+	  GET_UINT8(probe_point.touches);
+	  break;
+
+     case HOST_CMD_CONCURRENT :
+	  GET_UINT8(concurrent.action);
+	  break;
+
      case HOST_CMD_SET_POT_VALUE :
 	  GET_UINT8(digi_pot.axis);
 	  GET_UINT8(digi_pot.value);
@@ -658,6 +731,72 @@ done:
      return(iret);
 }
 
+int s3g_set_write_buffer(s3g_context_t *ctx, size_t size)
+{
+     unsigned char *buf;
+
+     if (!ctx)
+     {
+	  errno = EINVAL;
+	  return(-1);
+     }
+
+     if (s3g_flush(ctx))
+	  return(-1);
+
+     if (size == 0)
+	  size = S3G_WRITE_BUFSIZE;
+     if (!(buf = (unsigned char *)realloc(ctx->wbuf, size)))
+     {
+	  fprintf(stderr, "s3g_set_write_buffer(%d): Unable to allocate VM; %s (%d)\n",
+		  __LINE__, strerror(errno), errno);
+	  return(-1);
+     }
+     ctx->wbuf      = buf;
+     ctx->wbuf_size = size;
+     ctx->wbuf_len  = 0;
+
+     return(0);
+}
+
+int s3g_flush(s3g_context_t *ctx)
+{
+     size_t len;
+
+     if (!ctx || !ctx->wbuf_len)
+	  return(0);
+
+     // Dropped even when the write fails, so a later flush won't repeat it
+     len = ctx->wbuf_len;
+     ctx->wbuf_len = 0;
+     if (!ctx->write)
+     {
+	  errno = EINVAL;
+	  return(-1);
+     }
+     if ((ssize_t)len != (*ctx->write)(ctx->w_ctx, ctx->wbuf, len))
+	  return(-1);
+
+     return(0);
+}
+
+ssize_t s3g_write(s3g_context_t *ctx, const void *buf, size_t nbytes)
+{
+     if (ctx->wbuf)
+     {
+	  if (ctx->wbuf_len + nbytes > ctx->wbuf_size && s3g_flush(ctx))
+	       return(-1);
+	  if (nbytes <= ctx->wbuf_size)
+	  {
+	       memcpy(ctx->wbuf + ctx->wbuf_len, buf, nbytes);
+	       ctx->wbuf_len += nbytes;
+	       return((ssize_t)nbytes);
+	  }
+     }
+
+     return((*ctx->write)(ctx->w_ctx, buf, nbytes));
+}
+
 static void writef(s3g_context_t *ctx, const char *fmt, ...)
 {
 	va_list ap;
@@ -668,7 +807,7 @@ static void writef(s3g_context_t *ctx, const char *fmt, ...)
 	va_end(ap);
 
 	if (ctx && ctx->write)
-		(*ctx->write)(ctx->w_ctx, (unsigned char *)buf, strlen(buf));
+		s3g_write(ctx, buf, strlen(buf));
 	else
 		puts(buf);
 }
@@ -900,6 +1039,56 @@ void s3g_command_display(s3g_context_t *ctx, s3g_command_t *cmd)
 		 F(queue_point_new_ext.feedrate_mult_64));
 	  break;
 
+     case HOST_CMD_QUEUE_POINT_DELTA :
+	  writef(ctx, "Move by (%d, %d, %d, %d, %d), DDA rate %d, "
+		 "distance %f mm, feedrate*64 %d steps/s",
+		 F(queue_point_new_ext.x),
+		 F(queue_point_new_ext.y),
+		 F(queue_point_new_ext.z),
+		 F(queue_point_new_ext.a),
+		 F(queue_point_new_ext.b),
+		 F(queue_point_new_ext.dda_rate),
+		 F(queue_point_new_ext.distance),
+		 F(queue_point_new_ext.feedrate_mult_64));
+	  break;
+
+     case HOST_CMD_PLANNER_HINT :
+	  writef(ctx, "Planner hint for the next move, max entry speed*64 %hu mm/s%s",
+		 F(planner_hint.max_entry_speed_64),
+		 (F(planner_hint.flags) & PLANNER_HINT_NOMINAL_LENGTH) ? ", nominal length" : "");
+	  break;
+
+     case HOST_CMD_FIRMWARE_RETRACT :
+	  writef(ctx, "Firmware %s, %hu steps, feedrate*64 %hd mm/s",
+		 (F(firmware_retract.flags) & FIRMWARE_RETRACT_UNRETRACT) ? "unretract" : "retract",
+		 F(firmware_retract.steps),
+		 F(firmware_retract.feedrate_mult_64));
+	  break;
+
+     case HOST_CMD_SET_ADVANCE_PROFILE :
+	  writef(ctx, "Set advance profile %hhu", F(advance_profile.index));
+	  break;
+
+     case HOST_CMD_PROBE_POINT :
+	  writef(ctx, "Probe %s point %hhu at (%d, %d), feedrate %u us/step, "
+		 "timeout %hu s, tolerance %hu steps, up to %hhu touches",
+		 (F(probe_point.point) & PROBE_POINT_MESH) ? "mesh" : "skew",
+		 (uint8_t)(F(probe_point.point) & ~PROBE_POINT_MESH),
+		 F(probe_point.x),
+		 F(probe_point.y),
+		 F(probe_point.feedrate),
+		 F(probe_point.timeout),
+		 F(probe_point.tolerance),
+		 F(probe_point.touches));
+	  break;
+
+     case HOST_CMD_CONCURRENT :
+	  writef(ctx, "%s",
+		 (F(concurrent.action) == CONCURRENT_BEGIN) ? "Begin waiting for the heaters alongside what follows" :
+		 (F(concurrent.action) == CONCURRENT_JOIN) ? "Join: wait for the heaters waited on since the begin" :
+		 "Unknown concurrent start up action");
+	  break;
+
      case HOST_CMD_SET_POT_VALUE :
 	  writef(ctx, "Set %s axis potentiometer to %hhu",
 		 axes_names(F(digi_pot.axis), buf, sizeof(buf)),
@@ -1002,7 +1191,7 @@ int s3g_command_write(s3g_context_t *ctx, s3g_command_t *cmd)
      if (cmd->cmd_raw_len == 0)
 	  return(0);
 
-     if ((ssize_t)cmd->cmd_raw_len == (*ctx->write)(ctx->w_ctx, cmd->cmd_raw, cmd->cmd_raw_len))
+     if ((ssize_t)cmd->cmd_raw_len == s3g_write(ctx, cmd->cmd_raw, cmd->cmd_raw_len))
 	  return(0);
 
      return(-1);
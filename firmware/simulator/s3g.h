@@ -282,6 +282,35 @@ typedef struct {
     float zpos;
 } s3g_pause_at_zpos;
 
+typedef struct {
+    uint16_t max_entry_speed_64;
+    uint8_t  flags;
+} s3g_planner_hint;
+
+typedef struct {
+    uint8_t  flags;
+    uint16_t steps;
+    int16_t  feedrate_mult_64;
+} s3g_firmware_retract;
+
+typedef struct {
+    uint8_t  index;
+} s3g_set_advance_profile;
+
+typedef struct {
+    uint8_t  point;
+    int32_t  x;
+    int32_t  y;
+    uint32_t feedrate;
+    uint16_t timeout;
+    uint16_t tolerance;
+    uint8_t  touches;
+} s3g_probe_point;
+
+typedef struct {
+    uint8_t  action;
+} s3g_concurrent;
+
 // s3g_command_t
 // An individual command read from a .s3g file is stored in
 // this data structure.  You need to know from the command id
@@ -339,10 +368,16 @@ typedef struct {
 	  s3g_build_end_notification   build_end;
 	  s3g_stream_version           x3g_version;
 	  s3g_pause_at_zpos            pause_at_zpos;
+	  s3g_planner_hint             planner_hint;
+	  s3g_firmware_retract         firmware_retract;
+	  s3g_set_advance_profile      advance_profile;
+	  s3g_probe_point              probe_point;
+	  s3g_concurrent               concurrent;
      } t;
 } s3g_command_t;
 
 #define S3G_INPUT_TYPE_FILE 0  // stdin or a named disk file
+#define S3G_INPUT_TYPE_MMAP 1  // as a file, but mapped into memory to be read
 
 // Obtain an s3g_context for an input source of type S3G_INPUT_TYPE_.
 // The context returned must be disposed of by calling s3g_close().
@@ -353,11 +388,14 @@ typedef struct {
 //      Input source type.  Must be one of
 //
 //         S3G_INPUT_TYPE_FILE
+//         S3G_INPUT_TYPE_MMAP -- read only; a source which isn't a regular
+//                                file is read as S3G_INPUT_TYPE_FILE
 //
 //   void *src
 //      Input source information for the selected input type
 //
 //         S3G_INPUT_TYPE_FILE -- const char *filename or NULL for stdin
+//         S3G_INPUT_TYPE_MMAP -- const char *filename or NULL for stdin
 //
 //   Return values:
 //
@@ -392,7 +430,8 @@ int s3g_command_read_ext(s3g_context_t *ctx, s3g_command_t *cmd,
 			 unsigned char *rawbuf, size_t maxbuf, size_t *len);
 
 
-// Close the s3g input source, releasing any resources
+// Close the s3g input source, releasing any resources.  Anything still
+// held by s3g_set_write_buffer() is written out first.
 //
 // Call arguments:
 //
@@ -415,6 +454,30 @@ void s3g_command_display(s3g_context_t *ctx, s3g_command_t *cmd);
 
 int s3g_command_write(s3g_context_t *ctx, s3g_command_t *cmd);
 
+// Hold what's written to the context in a buffer of size bytes, or of
+// S3G_WRITE_BUFSIZE when size is 0, rather than passing each command
+// s3g_command_write() or s3g_command_display() writes straight on to the
+// writer.  The buffer is written out when it's full, by s3g_flush() and
+// by s3g_close().  A write bigger than the buffer goes straight through.
+//
+//  Return values:
+//
+//    0 -- Success
+//   -1 -- Error flushing what was held before, or no memory; check errno
+
+#define S3G_WRITE_BUFSIZE (256 * 1024)
+
+int s3g_set_write_buffer(s3g_context_t *ctx, size_t size);
+
+// Write out what the context's buffer holds
+//
+//  Return values:
+//
+//    0 -- Success, or nothing was held
+//   -1 -- Write error; check errno
+
+int s3g_flush(s3g_context_t *ctx);
+
 int s3g_command_isblocking(s3g_command_t *cmd);
 
 #ifdef __cplusplus
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "s3g_mmap.h"
+
+// Read only driver which maps the whole input file and hands out its
+// bytes with memcpy().  The stdio driver costs a read() system call for
+// each field of each command, which dominates the time taken to get
+// through a large .x3g file.
+
+// This driver's private context
+
+typedef struct {
+     const unsigned char *base;  // Start of the mapping; NULL for an empty file
+     size_t               size;  // Length of the file and of the mapping
+     size_t               pos;   // Offset of the next byte to read
+} s3g_mmap_ctx_t;
+
+
+// mmap_close
+//
+// Unmap the input file and release the allocated driver context
+//
+// Call arguments:
+//
+//   void *ctx
+//     Private driver context allocated by s3g_mmap_open().
+//
+// Return values:
+//
+//   0 -- Success
+//  -1 -- Error; check errno
+
+static s3g_close_proc_t mmap_close;
+static int mmap_close(void *ctx)
+{
+     s3g_mmap_ctx_t *myctx = (s3g_mmap_ctx_t *)ctx;
+     int iret = 0;
+
+     // Sanity check
+     if (!myctx)
+     {
+	  errno = EINVAL;
+	  return(-1);
+     }
+
+     if (myctx->base)
+	  iret = munmap((void *)myctx->base, myctx->size);
+     free(myctx);
+
+     return(iret);
+}
+
+
+// mmap_read
+//
+// Take the next nbytes of the input file, copying at most maxbuf of them
+// into buf.  Same semantics as stdio_read(): bytes beyond maxbuf are skipped
+// over, and a short count means that the end of the file was reached.
+//
+// Call arguments:
+//
+//   void *ctx
+//     Private driver context created by s3g_mmap_open().
+//
+//   void *buf
+//     Buffer into which to copy the data.  If buf == NULL, then maxbuf will be
+//     considered 0 and nbytes will be skipped.
+//
+//   size_t maxbuf
+//     Maximum number of bytes to store in buf.
+//
+//   size_t nbytes
+//     The number of bytes to take from the input file.
+//
+// Return values:
+//
+//  > 0 -- Number of bytes read.  If the returned value is less than nbytes, then an
+//           end of file condition has occurred.
+//    0 -- End of file reached or nbytes == 0
+//   -1 -- Invalid call arguments; check errno
+
+static s3g_read_proc_t mmap_read;
+static ssize_t mmap_read(void *ctx, void *buf, size_t maxbuf, size_t nbytes)
+{
+     s3g_mmap_ctx_t *myctx = (s3g_mmap_ctx_t *)ctx;
+     size_t left;
+
+     // Sanity check
+     if (!myctx)
+     {
+	  errno = EINVAL;
+	  return((ssize_t)-1);
+     }
+
+     left = myctx->size - myctx->pos;
+     if (nbytes > left)
+	  nbytes = left;
+
+     if (!buf)
+	  maxbuf = 0;
+
+     if (maxbuf)
+	  memcpy(buf, myctx->base + myctx->pos, (nbytes < maxbuf) ? nbytes : maxbuf);
+     myctx->pos += nbytes;
+
+     return((ssize_t)nbytes);
+}
+
+
+// s3g_mmap_open
+// Our public open routine.  This is the only public routine for the driver.
+//
+// Call arguments
+//
+//   s3g_context_t *ctx
+//     s3g context to associate ourselves with.
+//
+//   void *src
+//     Input source information.  NULL for stdin, otherwise a "const char *"
+//     pointer to the complete name of the file to map.
+//
+//   int oflag, int mode
+//     As for open(2).  Only O_RDONLY can be mapped.
+//
+// Return values:
+//
+//   0 -- Success
+//   1 -- The source is not a regular file opened read only; nothing was
+//        done and nothing complained of
+//  -1 -- Error; check errno
+
+int s3g_mmap_open(s3g_context_t *ctx, void *src, int oflag, int mode)
+{
+     s3g_mmap_ctx_t *tmp;
+     struct stat st;
+     const char *fname = src ? (const char *)src : "<stdin>";
+     void *base = NULL;
+     off_t pos = 0;
+     int fd;
+
+     // Sanity check
+     if (!ctx)
+     {
+	  fprintf(stderr, "s3g_mmap_open(%d): Invalid call; ctx=NULL\n", __LINE__);
+	  errno = EINVAL;
+	  return(-1);
+     }
+
+     if ((oflag & O_ACCMODE) != O_RDONLY)
+	  return(1);
+
+     if (src == NULL)
+	  fd = fileno(stdin);
+     else if ((fd = open(fname, oflag, mode)) < 0)
+     {
+	  fprintf(stderr, "s3g_open(%d): Unable to open the file \"%s\"; %s (%d)\n",
+		  __LINE__, fname, strerror(errno), errno);
+	  return(-1);
+     }
+
+     // Pipes, ttys and such are left to the stdio driver
+     if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+     {
+	  if (src)
+	       close(fd);
+	  return(1);
+     }
+
+     // Redirected stdin may already have been read from
+     if (src == NULL && (pos = lseek(fd, 0, SEEK_CUR)) < 0)
+	  pos = 0;
+
+     // A zero length mapping is an error, so an empty file has none
+     if (st.st_size > 0)
+     {
+	  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	  if (base == MAP_FAILED)
+	  {
+	       if (src)
+		    close(fd);
+	       return(1);
+	  }
+	  (void)madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+     }
+
+     // The mapping holds its own reference to the file
+     if (src)
+	  close(fd);
+
+     // Allocate memory for our "driver" context
+     tmp = (s3g_mmap_ctx_t *)calloc(1, sizeof(s3g_mmap_ctx_t));
+     if (tmp == NULL)
+     {
+	  fprintf(stderr, "s3g_open(%d): Unable to allocate VM; %s (%d)\n",
+		  __LINE__, strerror(errno), errno);
+	  if (base)
+	       munmap(base, (size_t)st.st_size);
+	  return(-1);
+     }
+     tmp->base = (const unsigned char *)base;
+     tmp->size = base ? (size_t)st.st_size : 0;
+     tmp->pos  = ((size_t)pos < tmp->size) ? (size_t)pos : tmp->size;
+
+     // All finished and happy; no writer until s3g_add_writer() is called
+     ctx->close  = mmap_close;
+     ctx->read   = mmap_read;
+     ctx->r_ctx  = tmp;
+
+     return(0);
+}
@@ -26,9 +26,17 @@ typedef struct {
      void             *w_ctx;    // File driver private context
      size_t            nread;    // Bytes read
      size_t            nwritten; // Bytes written
+     unsigned char    *wbuf;     // Writes held for s3g_flush(), see s3g_set_write_buffer()
+     size_t            wbuf_size;
+     size_t            wbuf_len;
 } s3g_context_t;
 #endif
 
+// Pass bytes on to the context's writer, by way of its buffer when
+// s3g_set_write_buffer() gave it one, so they keep their order with those
+// s3g_command_write() writes
+ssize_t s3g_write(s3g_context_t *ctx, const void *buf, size_t nbytes);
+
 // File driver open procedure; no need at present to keep this in the context
 
 typedef int s3g_open_proc_t(s3g_context_t *ctx, void *src, int oflag, int mode);
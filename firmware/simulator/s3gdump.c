@@ -240,9 +240,9 @@ int main(int argc, const char *argv[])
      argv += optind;
 
      if (argc == 0)
-	  ctx = s3g_open(0, NULL, O_RDONLY, 0);
+	  ctx = s3g_open(S3G_INPUT_TYPE_MMAP, NULL, O_RDONLY, 0);
      else
-	  ctx = s3g_open(0, (void *)argv[0], O_RDONLY, 0);
+	  ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (void *)argv[0], O_RDONLY, 0);
 
      if (!ctx)
 	  // Assume that s3g_open() has complained
@@ -0,0 +1,411 @@
+// Rewrite a .x3g file with runs of colinear moves merged into one move
+//
+//     s3gmerge [-d] [-t tol] [-e etol] [-s x,y,z,a,b] infile outfile
+//
+// Slicers break straight and nearly straight lines into many short
+// HOST_CMD_QUEUE_POINT_NEW_EXT segments, each of which costs SD card
+// bandwidth and a planner block.  A run of segments with the same feed
+// rate and relative mask is merged while every vertex along it lies within
+// tol mm of the straight line from its start to its end, the run doesn't
+// double back on itself, and the extruders keep within etol mm of extruding
+// evenly along it.
+//
+// The merged move's distance is the sum of the segments' distances, and
+// its dda rate is set so that it takes as long as the segments did.  With
+// -d, merged moves that fit are written as HOST_CMD_QUEUE_POINT_DELTA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+
+#include "Commands.hh"
+#include "s3g.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+#define AXIS_COUNT 5
+#define A_AXIS     3
+
+// Most segments merged into one move; bounds the work of checking a run
+#define MAX_RUN 64
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-hd] [-t tol] [-e etol] [-s x,y,z,a,b] infile outfile\n"
+"       infile -- The .x3g file to read\n"
+"      outfile -- The .x3g file to write\n"
+"           -d -- Write merged moves as delta moves where they fit\n"
+"       -e etol -- Largest extrusion error allowed, in mm of filament (default 0.01)\n"
+"        -t tol -- Largest deviation from the path allowed, in mm (default 0.02)\n"
+" -s x,y,z,a,b -- Steps per mm of each axis (default 94.139704,94.139704,400,\n"
+"                 96.275202,96.275202)\n"
+"        ?, -h -- This help message\n",
+	     prog ? prog : "s3gmerge");
+}
+
+static float steps_per_mm[AXIS_COUNT] = {
+     94.139704f, 94.139704f, 400.0f, 96.275202f, 96.275202f
+};
+
+static float tolerance  = 0.02f;
+static float etolerance = 0.01f;
+static int   use_delta  = 0;
+
+// The run of moves being merged.  vertex[0] is where the run starts and
+// vertex[n] where its n'th move ends, as absolute steps.
+static struct {
+     int     n;
+     int32_t vertex[MAX_RUN + 1][AXIS_COUNT];
+     double  seconds;		// time the moves take
+     float   distance;		// sum of their distances
+     uint8_t rel;
+     int16_t feedrate_mult_64;
+     s3g_command_t first;	// written as is if the run is one move
+} run;
+
+// Where the last move ended, and which axes that's known for
+static int32_t position[AXIS_COUNT];
+static uint8_t known;
+
+static unsigned long moves_in = 0, moves_out = 0;
+
+static int write_raw(s3g_context_t *ctx, const unsigned char *raw, size_t len)
+{
+     s3g_command_t cmd;
+
+     memcpy(cmd.cmd_raw, raw, len);
+     cmd.cmd_raw_len = len;
+     return(s3g_command_write(ctx, &cmd));
+}
+
+static unsigned char *put(unsigned char *p, const void *v, size_t len)
+{
+     memcpy(p, v, len);
+     return(p + len);
+}
+
+// Write the run out as a single move
+static int flush(s3g_context_t *ctx)
+{
+     const int32_t *start = run.vertex[0], *end = run.vertex[run.n];
+     unsigned char raw[64], *p;
+     int32_t delta[AXIS_COUNT], master = 0, dda_rate, v;
+     uint8_t mask = 0;
+     int i, fits;
+
+     if (run.n == 0)
+	  return(0);
+
+     moves_out++;
+     if (run.n == 1)
+     {
+	  run.n = 0;
+	  return(s3g_command_write(ctx, &run.first));
+     }
+
+     for (i = 0; i < AXIS_COUNT; i++)
+     {
+	  delta[i] = end[i] - start[i];
+	  if (labs(delta[i]) > master)
+	       master = labs(delta[i]);
+	  if (delta[i] != 0)
+	       mask |= 1 << i;
+     }
+     dda_rate = (run.seconds > 0.0) ? (int32_t)(0.5 + (double)master / run.seconds) : 1;
+     if (dda_rate < 1)
+	  dda_rate = 1;
+
+     fits = use_delta && dda_rate <= 0xffff && (run.rel & 0x07) == 0;
+     for (i = 0; i < AXIS_COUNT && fits; i++)
+	  fits = delta[i] >= -32768 && delta[i] <= 32767;
+
+     p = raw;
+     if (fits)
+     {
+	  uint16_t rate = (uint16_t)dda_rate;
+
+	  *p++ = HOST_CMD_QUEUE_POINT_DELTA;
+	  *p++ = mask;
+	  for (i = 0; i < AXIS_COUNT; i++)
+	       if (mask & (1 << i))
+	       {
+		    int16_t d = (int16_t)delta[i];
+		    p = put(p, &d, sizeof(d));
+	       }
+	  p = put(p, &rate, sizeof(rate));
+     }
+     else
+     {
+	  *p++ = HOST_CMD_QUEUE_POINT_NEW_EXT;
+	  for (i = 0; i < AXIS_COUNT; i++)
+	  {
+	       v = (run.rel & (1 << i)) ? delta[i] : end[i];
+	       p = put(p, &v, sizeof(v));
+	  }
+	  p = put(p, &dda_rate, sizeof(dda_rate));
+	  *p++ = run.rel;
+     }
+     p = put(p, &run.distance, sizeof(run.distance));
+     p = put(p, &run.feedrate_mult_64, sizeof(run.feedrate_mult_64));
+
+     run.n = 0;
+     return(write_raw(ctx, raw, (size_t)(p - raw)));
+}
+
+// Whether the run with the vertex end added still follows a straight line
+static int straight(const int32_t *end)
+{
+     const int32_t *start = run.vertex[0];
+     double line[3], len2 = 0.0, elen[2], t_last = 0.0;
+     int i, k;
+
+     for (i = 0; i < 3; i++)
+     {
+	  line[i] = (double)(end[i] - start[i]) / steps_per_mm[i];
+	  len2 += line[i] * line[i];
+     }
+     if (len2 <= 0.0)
+	  return(0);
+     for (i = 0; i < 2; i++)
+	  elen[i] = (double)(end[A_AXIS + i] - start[A_AXIS + i]) / steps_per_mm[A_AXIS + i];
+
+     for (k = 1; k <= run.n; k++)
+     {
+	  double d[3], t = 0.0, dev2 = 0.0;
+
+	  for (i = 0; i < 3; i++)
+	  {
+	       d[i] = (double)(run.vertex[k][i] - start[i]) / steps_per_mm[i];
+	       t += d[i] * line[i];
+	  }
+	  t /= len2;
+
+	  // Doubling back, or off the end of the line
+	  if (t < t_last || t > 1.0)
+	       return(0);
+	  t_last = t;
+
+	  for (i = 0; i < 3; i++)
+	       dev2 += (d[i] - t * line[i]) * (d[i] - t * line[i]);
+	  if (dev2 > (double)tolerance * tolerance)
+	       return(0);
+
+	  for (i = 0; i < 2; i++)
+	  {
+	       double e = (double)(run.vertex[k][A_AXIS + i] - start[A_AXIS + i]) /
+		    steps_per_mm[A_AXIS + i];
+	       if (fabs(e - t * elen[i]) > etolerance)
+		    return(0);
+	  }
+     }
+     return(1);
+}
+
+// Add a queue point new extended command to the run, writing out the run
+// first if the move can't be merged into it
+static int add_move(s3g_context_t *ctx, s3g_command_t *cmd)
+{
+     int32_t target[AXIS_COUNT], master = 0;
+     const int32_t *v = &cmd->t.queue_point_new_ext.x;  // x, y, z, a, b
+     uint8_t rel = cmd->t.queue_point_new_ext.rel;
+     int16_t feedrate = cmd->t.queue_point_new_ext.feedrate_mult_64;
+     int i, mergeable;
+
+     moves_in++;
+
+     // A move is only of use to a run if where it starts and ends are known
+     mergeable = 1;
+     for (i = 0; i < AXIS_COUNT; i++)
+     {
+	  if (rel & (1 << i))
+	  {
+	       if (!(known & (1 << i)))
+		    mergeable = 0;
+	       target[i] = position[i] + v[i];
+	  }
+	  else
+	       target[i] = v[i];
+	  if (labs(target[i] - position[i]) > master)
+	       master = labs(target[i] - position[i]);
+     }
+
+     if (run.n > 0 &&
+	 (!mergeable || run.n >= MAX_RUN || rel != run.rel ||
+	  feedrate != run.feedrate_mult_64 || !straight(target)))
+     {
+	  if (flush(ctx))
+	       return(-1);
+     }
+
+     if (!mergeable || known != (1 << AXIS_COUNT) - 1 ||
+	 cmd->t.queue_point_new_ext.dda_rate <= 0)
+     {
+	  // Pass it through
+	  if (flush(ctx) || s3g_command_write(ctx, cmd))
+	       return(-1);
+	  moves_out++;
+     }
+     else
+     {
+	  if (run.n == 0)
+	  {
+	       memcpy(run.vertex[0], position, sizeof(position));
+	       run.seconds  = 0.0;
+	       run.distance = 0.0f;
+	       run.rel      = rel;
+	       run.feedrate_mult_64 = feedrate;
+	       run.first    = *cmd;
+	  }
+	  run.n++;
+	  memcpy(run.vertex[run.n], target, sizeof(target));
+	  run.seconds  += (double)master / (double)cmd->t.queue_point_new_ext.dda_rate;
+	  run.distance += cmd->t.queue_point_new_ext.distance;
+     }
+
+     memcpy(position, target, sizeof(position));
+     known = (1 << AXIS_COUNT) - 1;
+
+     return(0);
+}
+
+int main(int argc, char *argv[])
+{
+     char c;
+     s3g_command_t cmd;
+     s3g_context_t *in_ctx, *out_ctx;
+     int i, iret;
+
+     while ((c = getopt(argc, argv, ":de:hs:t:?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(0);
+
+	  case 'd' :
+	       use_delta = -1;
+	       break;
+
+	  case 'e' :
+	       etolerance = strtof(optarg, NULL);
+	       break;
+
+	  case 't' :
+	       tolerance = strtof(optarg, NULL);
+	       break;
+
+	  case 's' :
+	       if (AXIS_COUNT != sscanf(optarg, "%f,%f,%f,%f,%f", &steps_per_mm[0],
+					&steps_per_mm[1], &steps_per_mm[2],
+					&steps_per_mm[3], &steps_per_mm[4]))
+	       {
+		    fprintf(stderr, "%s: unable to parse the steps per mm, \"%s\"\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       for (i = 0; i < AXIS_COUNT; i++)
+		    if (steps_per_mm[i] <= 0.0f)
+		    {
+			 fprintf(stderr, "%s: steps per mm must be positive\n", argv[0]);
+			 return(1);
+		    }
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+     if (argc != 2)
+     {
+	  usage(stderr, NULL);
+	  return(1);
+     }
+
+     if (!(in_ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (void *)argv[0], O_RDONLY, 0)))
+	  // Assume that s3g_open() has complained
+	  return(1);
+     if (!(out_ctx = s3g_open(S3G_INPUT_TYPE_FILE, (void *)argv[1],
+			      O_CREAT | O_TRUNC | O_WRONLY, 0644)))
+     {
+	  s3g_close(in_ctx);
+	  return(1);
+     }
+     if (s3g_set_write_buffer(out_ctx, 0))
+     {
+	  s3g_close(in_ctx);
+	  s3g_close(out_ctx);
+	  return(1);
+     }
+
+     known = 0;
+     iret = 0;
+     while (!iret && !s3g_command_read(in_ctx, &cmd))
+     {
+	  switch (cmd.cmd_id)
+	  {
+	  case HOST_CMD_QUEUE_POINT_NEW_EXT :
+	       iret = add_move(out_ctx, &cmd);
+	       continue;
+
+	  // Any other command ends the run, which is written ahead of it
+
+	  case HOST_CMD_SET_POSITION_EXT :
+	       position[0] = cmd.t.set_position_ext.x;
+	       position[1] = cmd.t.set_position_ext.y;
+	       position[2] = cmd.t.set_position_ext.z;
+	       position[3] = cmd.t.set_position_ext.a;
+	       position[4] = cmd.t.set_position_ext.b;
+	       known = (1 << AXIS_COUNT) - 1;
+	       break;
+
+	  // The position is lost after anything else which moves the axes
+	  case HOST_CMD_FIND_AXES_MINIMUM :
+	  case HOST_CMD_FIND_AXES_MAXIMUM :
+	  case HOST_CMD_RECALL_HOME_POSITION :
+	  case HOST_CMD_QUEUE_POINT_EXT :
+	  case HOST_CMD_QUEUE_POINT_NEW :
+	  case HOST_CMD_QUEUE_POINT_DELTA :
+	  case HOST_CMD_QUEUE_ARC :
+	       known = 0;
+	       break;
+
+	  default :
+	       break;
+	  }
+	  if (flush(out_ctx) || s3g_command_write(out_ctx, &cmd))
+	       iret = -1;
+     }
+     if (!iret && flush(out_ctx))
+	  iret = -1;
+
+     s3g_close(in_ctx);
+     if (s3g_close(out_ctx))
+	  iret = -1;
+
+     if (iret)
+     {
+	  fprintf(stderr, "s3gmerge: Error writing \"%s\"\n", argv[1]);
+	  return(1);
+     }
+
+     fprintf(stderr, "s3gmerge: %lu moves merged into %lu\n", moves_in, moves_out);
+     return(0);
+}
@@ -0,0 +1,146 @@
+// Reads the binary block trace written by the simulator's -T switch
+//
+//     simtrace [-s] filename
+//
+// and prints each record as a line of CSV, or with -s, a summary.
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "SimulatorTrace.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-hs] [file]\n"
+"   file  -- The trace file to read.  If not supplied then stdin is read\n"
+"  ?, -h  -- This help message\n"
+"     -s  -- Summarize the trace rather than printing each block as CSV\n",
+	     prog ? prog : "simtrace");
+}
+
+static void print_csv_header(void)
+{
+     printf("index,x,y,z,a,b,step_events,accelerate_until,decelerate_after,"
+	    "initial_rate,peak_rate,final_rate,nominal_rate,entry_speed,nominal_speed,"
+	    "exit_speed,mm,z_height,duration,planned,flags,extruder\n");
+}
+
+static void print_csv(const simtrace_record_t *r)
+{
+     printf("%u,%d,%d,%d,%d,%d,%u,%d,%d,%u,%u,%u,%u,%.3f,%.3f,%.3f,%.4f,%.3f,%.6f,%u,0x%02x,%u\n",
+	    r->index, r->steps[0], r->steps[1], r->steps[2], r->steps[3], r->steps[4],
+	    r->step_event_count, r->accelerate_until, r->decelerate_after,
+	    r->initial_rate, r->peak_rate, r->final_rate, r->nominal_rate,
+	    r->entry_speed, r->nominal_speed, r->exit_speed, r->millimeters,
+	    r->z, r->duration, r->planned, r->flags, r->extruder);
+}
+
+int main(int argc, char *argv[])
+{
+     char c;
+     FILE *fp;
+     simtrace_header_t hdr;
+     simtrace_record_t r;
+     unsigned char skip[256];
+     int summary = 0;
+     unsigned long count = 0, nominal = 0, overruns = 0, starved = 0;
+     double total_time = 0.0, total_mm = 0.0, max_speed = 0.0;
+
+     while ((c = getopt(argc, argv, ":hs?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(0);
+
+	  case 's' :
+	       summary = -1;
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+
+     if (argc == 0)
+	  fp = stdin;
+     else if (!(fp = fopen(argv[0], "rb")))
+     {
+	  fprintf(stderr, "simtrace: Unable to open the file \"%s\"; %s (%d)\n",
+		  argv[0], strerror(errno), errno);
+	  return(1);
+     }
+
+     if (1 != fread(&hdr, sizeof(hdr), 1, fp) || hdr.magic != SIMTRACE_MAGIC)
+     {
+	  fprintf(stderr, "simtrace: Not a simulator trace, or one written with the "
+		  "other byte order\n");
+	  return(1);
+     }
+     if (hdr.version != SIMTRACE_VERSION || hdr.record_size < sizeof(r) ||
+	 hdr.record_size - sizeof(r) > sizeof(skip))
+     {
+	  fprintf(stderr, "simtrace: Unsupported trace version %u with %u byte records\n",
+		  hdr.version, hdr.record_size);
+	  return(1);
+     }
+
+     if (!summary)
+	  print_csv_header();
+
+     // Newer writers may append fields to each record; skip them
+     while (1 == fread(&r, sizeof(r), 1, fp) &&
+	    (hdr.record_size == sizeof(r) ||
+	     1 == fread(skip, hdr.record_size - sizeof(r), 1, fp)))
+     {
+	  if (!summary)
+	  {
+	       print_csv(&r);
+	       continue;
+	  }
+	  count++;
+	  total_time += r.duration;
+	  total_mm   += r.millimeters;
+	  if (r.nominal_speed > max_speed)
+	       max_speed = r.nominal_speed;
+	  if (r.peak_rate >= r.nominal_rate)
+	       nominal++;
+	  if (r.flags & SIMTRACE_OVERRUN)
+	       overruns++;
+	  if (r.flags & SIMTRACE_STARVED)
+	       starved++;
+     }
+
+     if (summary)
+     {
+	  printf("%lu blocks, %.1f mm in %.2f s (average %.2f mm/s); fastest block %.2f mm/s\n",
+		 count, total_mm, total_time,
+		 (total_time > 0.0) ? total_mm / total_time : 0.0, max_speed);
+	  printf("%lu blocks reached their nominal rate; %lu overran an interrupt, "
+		 "%lu starved the planner\n", nominal, overruns, starved);
+     }
+
+     if (fp != stdin)
+	  fclose(fp);
+
+     return(0);
+}
@@ -4,6 +4,8 @@
 #include <string.h>
 #include <stdarg.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <sys/wait.h>
 
 #include "Simulator.hh"
 #include "StepperAccelPlannerExtras.hh"
@@ -15,12 +17,18 @@
 
 static char pending_notices[10240];
 
+// Display each block as it's stepped out: REPORT, but not when tracing
+static int report;
+
 static void pending_notice(const char *fmt, ...)
 {
 #if !defined(SAILTIME)
      va_list ap;
      size_t len;
 
+     if (!report)
+	  return;
+
      va_start(ap, fmt);
 
      len = strlen(pending_notices);
@@ -66,13 +74,13 @@ static ssize_t display(void *ctx_, void *str, size_t len)
 
 #if defined(SAILTIME)
 #define PROGNAME "sailtime"
-#define OPTIONS "[-? | -h] [-a x,y,z,a,b] [-c x,y,z,a,b]"
-#define GETOPTS ":a:c:h?"
+#define OPTIONS "[-? | -h] [-a x,y,z,a,b] [-c x,y,z,a,b] [-j jobs] [-k cal] [-p] [-C cycles]"
+#define GETOPTS ":a:c:hj:k:pC:?"
 #define REPORT 0
 #else
 #define PROGNAME "planner"
-#define OPTIONS "[-? | -h] [-a x,y,z,a,b] [-c x,y,z,a,b] [-mstu] [-d mask] [-r rate]"
-#define GETOPTS ":a:c:hd:mr:stu?"
+#define OPTIONS "[-? | -h] [-a x,y,z,a,b] [-c x,y,z,a,b] [-mpstu] [-d mask] [-r rate] [-C cycles] [-T trace]"
+#define GETOPTS ":a:c:hd:mr:pstuC:T:?"
 #define REPORT -1
 #endif
 
@@ -84,15 +92,29 @@ static void usage(FILE *f, const char *prog)
      fprintf(f,
 "Usage: %s " OPTIONS " [file]\n"
 "         file -- The name of the .s3g or .x3g file to dump.  If not supplied then stdin is dumped\n"
+#if defined(SAILTIME)
+"                 With -j or more than one file, each file is estimated in a\n"
+"                 process of its own and a line of CSV is printed for each\n"
+#endif
 " -a x,y,z,a,b -- Maximum x, y, z, a, and b accelerations (mm/s^2)\n"
 " -c x,y,z,a,b -- Maximum x, y, z, a, and b speed changes (mm/s)\n"
-#if !defined(SAILTIME)
+#if defined(SAILTIME)
+"      -j jobs -- Estimate up to \"jobs\" files at a time\n"
+"       -k cal -- Correct the estimate with the factors calibrate_time.py fitted\n"
+"                 to the block times measured on a machine\n"
+#else
 "      -d mask -- Selectively enable debugging with a bit mask \"mask\"\n"
 "           -m -- Display actual s3g/x3g move commands and\n"
 "      -r rate -- Flag feed rates which exceed \"rate\"\n"
 "           -s -- Display block initial, peak and final speeds (mm/s) along with rates\n"
 "           -u -- Display significant differences between interval based and us based feed rates\n"
+"     -T trace -- Write a binary record of each block to the file \"trace\" instead of\n"
+"                 displaying it; read it with simtrace\n"
 #endif
+"           -p -- Report blocks which would overrun the stepper interrupt or\n"
+"                 starve the planner on a 16 MHz ATmega2560\n"
+"    -C cycles -- Costs for -p in cpu cycles: isr,step,ramp,setup,plan,recalc\n"
+"                 (default %u,%u,%u,%u,%u,%u)\n"
 "        ?, -h -- This help message\n"
 "\n"
 " Default maximum accelerations are:\n"
@@ -105,175 +127,31 @@ static void usage(FILE *f, const char *prog)
 "        z = %d mm/s\n"
 "     a, b = %d mm/s\n",
 	     prog ? prog : PROGNAME,
+	     simulator_cycles.isr, simulator_cycles.step, simulator_cycles.ramp,
+	     simulator_cycles.setup, simulator_cycles.plan, simulator_cycles.recalc,
 	     DEFAULT_MAX_ACCELERATION_AXIS_X, DEFAULT_MAX_ACCELERATION_AXIS_Z,
 	     DEFAULT_MAX_ACCELERATION_AXIS_A,
 	     DEFAULT_MAX_SPEED_CHANGE_X, DEFAULT_MAX_SPEED_CHANGE_Z,
 	     DEFAULT_MAX_SPEED_CHANGE_A);
 }
 
-int main(int argc, const char *argv[])
+// Plan the moves of one input source, NULL for stdin, with the planner as
+// main() left it.  The planner's state is global, so this may only be done
+// once in a process; batch() forks a process for each file.
+
+static int simulate(const char *fname, int show_moves, int *max_depth)
 {
-     char c;
      s3g_command_t cmd;
      s3g_context_t *ctx;
      myctx_t myctx;
-     int show_moves = 0;
-
-     steppers::init();
-     steppers::reset();
-
-     // Enable acceleration: it's off by default
-     init_extras(true);
-
-     pending_notices[0] = '\0';
-
-     simulator_use_max_feed_rate = false;
-     simulator_dump_speeds = false;
-     simulator_show_alt_feed_rate = false;
-
-     while ((c = getopt(argc, (char **)argv, GETOPTS)) != GETOPTS_END)
-     {
-	  switch(c)
-	  {
-	  // Unknown switch
-	  case ':' :
-	  default :
-	       usage(stderr, argv[0]);
-	       return(1);
-
-	  // Explicit help request
-	  case 'h' :
-	  case '?' :
-	       usage(stdout, argv[0]);
-	       return(1);
-
-          // max accelerations
-	  case 'a' :
-	  // max speed changes
-	  case 'c' :
-	  {
-	       char cc;
-	       int index = 0;
-	       const char *ptr = optarg;
-	       int16_t v = 0, vals[5];
-
-	       while ((cc = *ptr++))
-	       {
-		    if (cc == ',')
-		    {
-			 if (index >= 5)
-			 {
-			      fprintf(stderr,
-				      "Too many values specified in \"%s\"\n",
-				      optarg);
-			      return(1);
-			 }
-			 vals[index++] = v;
-			 v = 0;
-		    }
-		    else if ('0' <= cc && cc <= '9')
-			 v = v * 10 + (cc - '0');
-		    else
-		    {
-			 fprintf(stderr, "Invalid syntax for \"%s\"\n", optarg);
-			 return(1);
-		    }
-	       }
-	       if (index >= 5)
-	       {
-		    fprintf(stderr,
-			    "Too many values specified in \"%s\"\n",
-			    optarg);
-		       return(1);
-	       }
-	       vals[index++] = v;
-
-	       if (c == 'a')
-	       {
-		    int j;
-		    for (j = 0; j < STEPPER_COUNT; j++)
-		    {
-			 float steps_per_mm = (float)replicator_axis_steps_per_mm::axis_steps_per_mm[j] / 1000000.0f;
-			 max_acceleration_units_per_sq_second[j] = (uint32_t)vals[j];
-			 // Limit the max accelerations so that the calculation of block->acceleration & JKN Advance K2
-			 // can be performed without overflow issues
-			 if (max_acceleration_units_per_sq_second[j] > (uint32_t)((float)0xFFFFF / steps_per_mm))
-			      max_acceleration_units_per_sq_second[j] = (uint32_t)((float)0xFFFFF / steps_per_mm);
-			 axis_steps_per_sqr_second[j] = (uint32_t)((float)max_acceleration_units_per_sq_second[j] * steps_per_mm);
-			 axis_accel_step_cutoff[j] = (uint32_t)0xffffffff / axis_steps_per_sqr_second[j];
-		    }
-	       }
-	       else
-	       {
-		    int j;
-		    for (j = 0; j < index; j++)
-			 max_speed_change[j] = FTOFP((float)vals[j]);
-	       }
-	       break;
-	  }
-
-	  // Debug
-	  case 'd' :
-	  {
-	       char *ptr = NULL;
-	       simulator_debug = (uint32_t)(0xffffffff & strtoul(optarg, &ptr, 0));
-	       if (ptr == NULL || ptr == optarg)
-	       {
-		    fprintf(stderr, "%s: unable to parse the debug mask, \"%s\", as an integer\n",
-			    argv[0], optarg);
-		    return(1);
-	       }
-	  }
-	  break;
-
-	  // Show moves
-	  case 'm' :
-	       show_moves = 1;
-	       break;
-
-	  // Max feed rate
-	  case 'r' :
-	  {
-	       char *ptr = NULL;
-	       float rate;
-
-	       rate = strtof(optarg, &ptr);
-	       if (ptr == NULL || ptr == optarg)
-	       {
-		    fprintf(stderr, "%s: unable to parse the feed rate, \"%s\", as a floating point number\n",
-			    argv[0], optarg);
-		    return(1);
-	       }
-	       simulator_use_max_feed_rate = true;
-	       simulator_max_feed_rate = FTOFP(rate);
-	  }
-	  break;
-
-          // Display speeds as well as rates
-	  case 's' :
-	       simulator_dump_speeds = true;
-	       break;
-
-          // Display significant differences between interval based and us based feed rates
-	  case 'u' :
-	       simulator_show_alt_feed_rate = true;
-	       break;
-	  }
-     }
-
-     argc -= optind;
-     argv += optind;
-     if (argc == 0)
-	  // Open stdin
-	  ctx = s3g_open(0, NULL, O_RDONLY, 0);
-     else
-	  // Open the specified file
-	  ctx = s3g_open(0, (void *)argv[0], O_RDONLY, 0);
 
+     ctx = s3g_open(S3G_INPUT_TYPE_MMAP, (void *)fname, O_RDONLY, 0);
      if (!ctx)
 	  // Assume that s3g_open() has complained
 	  return(1);
 
+     *max_depth = 0;
+
      // Add a writer to use when converting an .s3g packet to 
      // human readable text
      s3g_add_writer(ctx, &display, &myctx);
@@ -286,6 +164,9 @@ int main(int argc, const char *argv[])
 	  myctx.buf[0] = '\0';
 	  s3g_command_display(ctx, &cmd);
 
+	  if (movesplanned() > *max_depth)
+	       *max_depth = movesplanned();
+
 	  if (cmd.cmd_id == HOST_CMD_QUEUE_POINT_NEW)
 	  {
 	       Point target = Point(cmd.t.queue_point_new.x, cmd.t.queue_point_new.y,
@@ -312,9 +193,10 @@ int main(int argc, const char *argv[])
 	       if (show_moves && myctx.buf[0]) pending_notice("%s\n", myctx.buf);
 	       handle_pending_notices();
 
-	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, REPORT);
+	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, report);
 	  }
-	  else if (cmd.cmd_id == HOST_CMD_QUEUE_POINT_NEW_EXT)
+	  else if (cmd.cmd_id == HOST_CMD_QUEUE_POINT_NEW_EXT ||
+		   cmd.cmd_id == HOST_CMD_QUEUE_POINT_DELTA)
 	  {
 	       Point target = Point(cmd.t.queue_point_new_ext.x, cmd.t.queue_point_new_ext.y,
 				    cmd.t.queue_point_new_ext.z, cmd.t.queue_point_new_ext.a,
@@ -337,13 +219,21 @@ int main(int argc, const char *argv[])
 
 	       steppers::setTargetNewExt(target, cmd.t.queue_point_new_ext.dda_rate,
 					 cmd.t.queue_point_new_ext.rel,
-					 cmd.t.queue_point_new_ext.distance,
+					 plan_float_to_fp(cmd.t.queue_point_new_ext.distance),
 					 cmd.t.queue_point_new_ext.feedrate_mult_64);
 
 	       if (show_moves && myctx.buf[0]) pending_notice("%s\n", myctx.buf);
 	       handle_pending_notices();
 
-	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, REPORT);
+	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, report);
+	  }
+	  else if (cmd.cmd_id == HOST_CMD_PLANNER_HINT)
+	  {
+	       // Held for the move after it, as the firmware does
+	       planner_hint_speed = FTOFP((float)cmd.t.planner_hint.max_entry_speed_64 / 64.0);
+	       planner_hint_nominal_length =
+		    (cmd.t.planner_hint.flags & PLANNER_HINT_NOMINAL_LENGTH) != 0;
+	       if (show_moves && myctx.buf[0]) pending_notice("%s\n", myctx.buf);
 	  }
 	  else if (cmd.cmd_id == HOST_CMD_QUEUE_POINT_EXT)
 	  {
@@ -361,7 +251,7 @@ int main(int argc, const char *argv[])
 
 	       handle_pending_notices();
 
-	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, REPORT);
+	       if (movesplanned() >= (BLOCK_BUFFER_SIZE >> 1)) plan_dump_current_block(1, report);
 	  }
 	  else if (cmd.cmd_id == HOST_CMD_SET_POSITION_EXT)
 	  {
@@ -400,13 +290,13 @@ int main(int argc, const char *argv[])
 		   cmd.cmd_id != HOST_CMD_SET_POSITION_EXT)
 	       {
 		    bool warn = movesplanned() != 0;
-		    if (warn && REPORT) {
+		    if (warn && report) {
 			printf("*** >>> Draining planning buffer <<< ***\n");
 			fflush(stdout);
 		    }
 		    while (movesplanned() != 0)
-			plan_dump_current_block(1, REPORT);
-		    if (warn && REPORT) {
+			plan_dump_current_block(1, report);
+		    if (warn && report) {
 			printf("*** >>> Planning buffer drained <<< ***\n");
 			fflush(stdout);
 		    }
@@ -430,11 +320,353 @@ int main(int argc, const char *argv[])
 
      // Dump any remaining blocks
      while (movesplanned() != 0)
-	 plan_dump_current_block(1, REPORT);
+	 plan_dump_current_block(1, report);
 
      s3g_close(ctx);
 
-     plan_dump_run_data((REPORT) ? 0 : -1);
+     return(0);
+}
+
+#if defined(SAILTIME)
+
+// Estimate each of the files in a process of its own, at most jobs at a
+// time, and print a line of CSV for each in the order given.  Each child
+// writes its line into a pipe of its own; a line is far shorter than
+// PIPE_BUF, so the child never blocks on it.
+
+static int batch(int nfiles, const char *files[], int jobs)
+{
+     int *fds;
+     int i, next, running, status, iret;
+
+     fds = (int *)calloc(nfiles, sizeof(int));
+     if (!fds)
+     {
+	  fprintf(stderr, PROGNAME ": Unable to allocate VM; %s (%d)\n",
+		  strerror(errno), errno);
+	  return(1);
+     }
+
+     fflush(stdout);
+
+     iret = 0;
+     next = 0;
+     running = 0;
+     while (next < nfiles || running > 0)
+     {
+	  if (next < nfiles && running < jobs)
+	  {
+	       int pfd[2];
+	       pid_t pid;
+
+	       if (pipe(pfd) < 0 || (pid = fork()) < 0)
+	       {
+		    // Finish the jobs already running and report them
+		    fprintf(stderr, PROGNAME ": Unable to start a job for \"%s\"; %s (%d)\n",
+			    files[next], strerror(errno), errno);
+		    nfiles = next;
+		    iret = 1;
+		    continue;
+	       }
+
+	       if (pid == 0)
+	       {
+		    char line[512];
+		    int depth, len;
+
+		    close(pfd[0]);
+		    // The cost model's block reports would be lost among the
+		    // lines of CSV; its totals are added to the line instead
+		    if (simulator_cost_model)
+			 (void)freopen("/dev/null", "w", stdout);
+		    if (simulate(files[next], 0, &depth))
+			 _exit(1);
+		    float xyz_mm, seconds = plan_total_time();
+		    uint32_t stops;
+		    plan_motion_totals(&xyz_mm, &stops);
+		    len = snprintf(line, sizeof(line), "\"%s\",%.2f,%.2f,%.2f,%d,%.1f,%.2f,%u",
+				   files[next], seconds,
+				   stepperAxisStepsToMM_((int32_t)getFilamentLength(0), A_AXIS),
+				   stepperAxisStepsToMM_((int32_t)getFilamentLength(1), B_AXIS),
+				   depth, xyz_mm, (seconds > 0.0) ? xyz_mm / seconds : 0.0, stops);
+		    if (simulator_cost_model)
+		    {
+			 uint32_t overruns, starved;
+			 uint64_t plan_cycles;
+			 plan_cost_totals(&overruns, &starved, &plan_cycles);
+			 len += snprintf(line + len, sizeof(line) - len, ",%u,%u,%.1f",
+					 overruns, starved, (double)plan_cycles / 1.0e6);
+		    }
+		    len += snprintf(line + len, sizeof(line) - len, "\n");
+		    if (write(pfd[1], line, len) != len)
+			 _exit(1);
+		    _exit(0);
+	       }
+
+	       close(pfd[1]);
+	       fds[next++] = pfd[0];
+	       running++;
+	       continue;
+	  }
+
+	  // Wait for any job to finish before starting another
+	  if (wait(&status) > 0)
+	       running--;
+     }
+
+     printf("file,seconds,filament_a_mm,filament_b_mm,max_planner_depth,xyz_mm,"
+	    "avg_mm_per_s,full_stops%s\n",
+	    simulator_cost_model ? ",isr_overruns,starved_blocks,plan_mcycles" : "");
+     for (i = 0; i < nfiles; i++)
+     {
+	  char line[512];
+	  ssize_t n = read(fds[i], line, sizeof(line) - 1);
+
+	  close(fds[i]);
+	  if (n <= 0)
+	  {
+	       fprintf(stderr, PROGNAME ": Unable to estimate \"%s\"\n", files[i]);
+	       iret = 1;
+	       continue;
+	  }
+	  fwrite(line, 1, (size_t)n, stdout);
+     }
+
+     free(fds);
+
+     return(iret);
+}
+
+#endif
+
+int main(int argc, const char *argv[])
+{
+     char c;
+     int show_moves = 0;
+#if defined(SAILTIME)
+     int jobs = 0;
+#endif
+
+     steppers::init();
+     steppers::reset();
+
+     // Enable acceleration: it's off by default
+     init_extras(true);
+
+     pending_notices[0] = '\0';
+     report = REPORT;
+
+     simulator_use_max_feed_rate = false;
+     simulator_dump_speeds = false;
+     simulator_show_alt_feed_rate = false;
+
+     while ((c = getopt(argc, (char **)argv, GETOPTS)) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  // Unknown switch
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  // Explicit help request
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(1);
+
+          // max accelerations
+	  case 'a' :
+	  // max speed changes
+	  case 'c' :
+	  {
+	       char cc;
+	       int index = 0;
+	       const char *ptr = optarg;
+	       int16_t v = 0, vals[5];
+
+	       while ((cc = *ptr++))
+	       {
+		    if (cc == ',')
+		    {
+			 if (index >= 5)
+			 {
+			      fprintf(stderr,
+				      "Too many values specified in \"%s\"\n",
+				      optarg);
+			      return(1);
+			 }
+			 vals[index++] = v;
+			 v = 0;
+		    }
+		    else if ('0' <= cc && cc <= '9')
+			 v = v * 10 + (cc - '0');
+		    else
+		    {
+			 fprintf(stderr, "Invalid syntax for \"%s\"\n", optarg);
+			 return(1);
+		    }
+	       }
+	       if (index >= 5)
+	       {
+		    fprintf(stderr,
+			    "Too many values specified in \"%s\"\n",
+			    optarg);
+		       return(1);
+	       }
+	       vals[index++] = v;
+
+	       if (c == 'a')
+	       {
+		    int j;
+		    for (j = 0; j < STEPPER_COUNT; j++)
+		    {
+			 float steps_per_mm = (float)replicator_axis_steps_per_mm::axis_steps_per_mm[j] / 1000000.0f;
+			 max_acceleration_units_per_sq_second[j] = (uint32_t)vals[j];
+			 // Limit the max accelerations so that the calculation of block->acceleration & JKN Advance K2
+			 // can be performed without overflow issues
+			 if (max_acceleration_units_per_sq_second[j] > (uint32_t)((float)0xFFFFF / steps_per_mm))
+			      max_acceleration_units_per_sq_second[j] = (uint32_t)((float)0xFFFFF / steps_per_mm);
+			 axis_steps_per_sqr_second[j] = (uint32_t)((float)max_acceleration_units_per_sq_second[j] * steps_per_mm);
+			 axis_accel_step_cutoff[j] = (uint32_t)0xffffffff / axis_steps_per_sqr_second[j];
+		    }
+		    plan_set_accel_limits();
+	       }
+	       else
+	       {
+		    int j;
+		    for (j = 0; j < index; j++)
+			 max_speed_change[j] = FTOFP((float)vals[j]);
+	       }
+	       break;
+	  }
+
+	  // Debug
+	  case 'd' :
+	  {
+	       char *ptr = NULL;
+	       simulator_debug = (uint32_t)(0xffffffff & strtoul(optarg, &ptr, 0));
+	       if (ptr == NULL || ptr == optarg)
+	       {
+		    fprintf(stderr, "%s: unable to parse the debug mask, \"%s\", as an integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	  }
+	  break;
+
+#if defined(SAILTIME)
+	  // Batch mode
+	  case 'j' :
+	  {
+	       char *ptr = NULL;
+	       jobs = (int)strtol(optarg, &ptr, 10);
+	       if (ptr == NULL || ptr == optarg || *ptr != '\0' || jobs < 1)
+	       {
+		    fprintf(stderr, "%s: unable to parse the job count, \"%s\", as a positive integer\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	  }
+	  break;
+
+	  // Calibrated time
+	  case 'k' :
+	       if (plan_time_cal_load(optarg))
+		    return(1);
+	       break;
+#endif
+
+	  // Cost model
+	  case 'p' :
+	       simulator_cost_model = true;
+	       break;
+
+	  case 'C' :
+	  {
+	       simulator_cycles_t sc;
+
+	       if (6 != sscanf(optarg, "%u,%u,%u,%u,%u,%u", &sc.isr, &sc.step, &sc.ramp,
+			       &sc.setup, &sc.plan, &sc.recalc))
+	       {
+		    fprintf(stderr, "%s: unable to parse the cycle costs, \"%s\", as six integers\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       simulator_cycles = sc;
+	       simulator_cost_model = true;
+	  }
+	  break;
+
+#if !defined(SAILTIME)
+	  // Binary trace
+	  case 'T' :
+	       if (plan_trace_open(optarg))
+		    return(1);
+	       report = 0;
+	       break;
+#endif
+
+	  // Show moves
+	  case 'm' :
+	       show_moves = 1;
+	       break;
+
+	  // Max feed rate
+	  case 'r' :
+	  {
+	       char *ptr = NULL;
+	       float rate;
+
+	       rate = strtof(optarg, &ptr);
+	       if (ptr == NULL || ptr == optarg)
+	       {
+		    fprintf(stderr, "%s: unable to parse the feed rate, \"%s\", as a floating point number\n",
+			    argv[0], optarg);
+		    return(1);
+	       }
+	       simulator_use_max_feed_rate = true;
+	       simulator_max_feed_rate = FTOFP(rate);
+	  }
+	  break;
+
+          // Display speeds as well as rates
+	  case 's' :
+	       simulator_dump_speeds = true;
+	       break;
+
+          // Display significant differences between interval based and us based feed rates
+	  case 'u' :
+	       simulator_show_alt_feed_rate = true;
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+
+#if defined(SAILTIME)
+     if (jobs > 0 || argc > 1)
+     {
+	  if (argc == 0)
+	  {
+	       usage(stderr, PROGNAME);
+	       return(1);
+	  }
+	  return(batch(argc, argv, (jobs > 0) ? jobs : 1));
+     }
+#endif
+
+     {
+	  int depth;
+
+	  if (simulate((argc == 0) ? NULL : argv[0], show_moves, &depth))
+	       return(1);
+     }
+
+     plan_trace_close();
+     plan_dump_run_data((report) ? 0 : -1);
 
      return(0);
 }
@@ -0,0 +1,231 @@
+// Compares two binary block traces written by the simulator's -T switch,
+// such as those of the fixed point simulator and float_simulator over the
+// same file
+//
+//     tracediff [-v] [-s speed] [-t steps] [-d percent] a b
+//
+// and reports how far apart the blocks' entry speeds, the steps at which
+// their trapezoids stop accelerating and start decelerating, and the total
+// times are, along with what each cost the planner.  The exit status is 2
+// when any differs by more than its tolerance, so the arithmetic of one
+// build can be checked against the other's.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+
+#include "SimulatorTrace.h"
+
+#if defined(__arm__)
+#define GETOPTS_END (char)-1
+#else
+#define GETOPTS_END -1
+#endif
+
+typedef struct {
+     const char       *name;
+     FILE             *fp;
+     simtrace_header_t hdr;
+     unsigned long     count, overruns, starved, planned;
+     double            total_time;
+} trace_t;
+
+static void usage(FILE *f, const char *prog)
+{
+     if (f == NULL)
+	  f = stderr;
+
+     fprintf(f,
+"Usage: %s [-hv] [-s speed] [-t steps] [-d percent] a b\n"
+"      a, b  -- The two trace files to compare\n"
+"     ?, -h  -- This help message\n"
+"        -v  -- Print each block which differs by more than a tolerance\n"
+"  -s speed  -- Tolerance for entry speeds, in mm/s (default 0.5)\n"
+"  -t steps  -- Tolerance for the trapezoid boundaries, in steps (default 2)\n"
+"-d percent  -- Tolerance for the total time, in percent (default 0.1)\n",
+	     prog ? prog : "tracediff");
+}
+
+static int trace_open(trace_t *t, const char *name)
+{
+     memset(t, 0, sizeof(*t));
+     t->name = name;
+     if (!(t->fp = fopen(name, "rb")))
+     {
+	  fprintf(stderr, "tracediff: Unable to open the file \"%s\"; %s (%d)\n",
+		  name, strerror(errno), errno);
+	  return(-1);
+     }
+     if (1 != fread(&t->hdr, sizeof(t->hdr), 1, t->fp) || t->hdr.magic != SIMTRACE_MAGIC)
+     {
+	  fprintf(stderr, "tracediff: \"%s\" is not a simulator trace, or one written "
+		  "with the other byte order\n", name);
+	  return(-1);
+     }
+     if (t->hdr.version != SIMTRACE_VERSION || t->hdr.record_size < sizeof(simtrace_record_t))
+     {
+	  fprintf(stderr, "tracediff: \"%s\" has unsupported trace version %u with %u "
+		  "byte records\n", name, t->hdr.version, t->hdr.record_size);
+	  return(-1);
+     }
+     return(0);
+}
+
+// Read the next record, skipping any fields newer writers appended
+static int trace_read(trace_t *t, simtrace_record_t *r)
+{
+     if (1 != fread(r, sizeof(*r), 1, t->fp))
+	  return(0);
+     if (t->hdr.record_size > sizeof(*r) &&
+	 fseek(t->fp, t->hdr.record_size - sizeof(*r), SEEK_CUR))
+	  return(0);
+
+     t->count++;
+     t->total_time += r->duration;
+     t->planned    += r->planned;
+     if (r->flags & SIMTRACE_OVERRUN)
+	  t->overruns++;
+     if (r->flags & SIMTRACE_STARVED)
+	  t->starved++;
+     return(1);
+}
+
+int main(int argc, char *argv[])
+{
+     char c;
+     trace_t a, b;
+     simtrace_record_t ra, rb;
+     int verbose = 0, over = 0;
+     double tol_speed = 0.5, tol_percent = 0.1;
+     long tol_steps = 2;
+     unsigned long speed_over = 0, accel_over = 0, decel_over = 0, common = 0;
+     double speed_max = 0.0, speed_sq = 0.0;
+     long accel_max = 0, decel_max = 0;
+     uint32_t speed_at = 0, accel_at = 0, decel_at = 0;
+
+     while ((c = getopt(argc, argv, ":d:hs:t:v?")) != GETOPTS_END)
+     {
+	  switch(c)
+	  {
+	  case ':' :
+	  default :
+	       usage(stderr, argv[0]);
+	       return(1);
+
+	  case 'h' :
+	  case '?' :
+	       usage(stdout, argv[0]);
+	       return(0);
+
+	  case 'd' :
+	       tol_percent = atof(optarg);
+	       break;
+
+	  case 's' :
+	       tol_speed = atof(optarg);
+	       break;
+
+	  case 't' :
+	       tol_steps = atol(optarg);
+	       break;
+
+	  case 'v' :
+	       verbose = -1;
+	       break;
+	  }
+     }
+
+     argc -= optind;
+     argv += optind;
+
+     if (argc != 2)
+     {
+	  usage(stderr, NULL);
+	  return(1);
+     }
+     if (trace_open(&a, argv[0]) || trace_open(&b, argv[1]))
+	  return(1);
+
+     if (verbose)
+	  printf("index,entry_speed_a,entry_speed_b,accelerate_until_a,accelerate_until_b,"
+		 "decelerate_after_a,decelerate_after_b\n");
+
+     // Block by block for as long as both have them
+     while (trace_read(&a, &ra) && trace_read(&b, &rb))
+     {
+	  double ds = fabs((double)ra.entry_speed - (double)rb.entry_speed);
+	  long da = labs((long)ra.accelerate_until - (long)rb.accelerate_until);
+	  long dd = labs((long)ra.decelerate_after - (long)rb.decelerate_after);
+
+	  common++;
+	  speed_sq += ds * ds;
+	  if (ds > speed_max)
+	  {
+	       speed_max = ds;
+	       speed_at  = ra.index;
+	  }
+	  if (da > accel_max)
+	  {
+	       accel_max = da;
+	       accel_at  = ra.index;
+	  }
+	  if (dd > decel_max)
+	  {
+	       decel_max = dd;
+	       decel_at  = ra.index;
+	  }
+	  if (ds > tol_speed)
+	       speed_over++;
+	  if (da > tol_steps)
+	       accel_over++;
+	  if (dd > tol_steps)
+	       decel_over++;
+
+	  if (verbose && (ds > tol_speed || da > tol_steps || dd > tol_steps))
+	       printf("%u,%.3f,%.3f,%d,%d,%d,%d\n", ra.index,
+		      ra.entry_speed, rb.entry_speed, ra.accelerate_until, rb.accelerate_until,
+		      ra.decelerate_after, rb.decelerate_after);
+     }
+     // and whatever's left of the longer one, for its totals
+     while (trace_read(&a, &ra))
+	  ;
+     while (trace_read(&b, &rb))
+	  ;
+     fclose(a.fp);
+     fclose(b.fp);
+
+     if (a.count != b.count)
+     {
+	  printf("%lu blocks in %s but %lu in %s; compared the first %lu\n",
+		 a.count, a.name, b.count, b.name, common);
+	  over = 1;
+     }
+     else
+	  printf("%lu blocks\n", common);
+
+     printf("Entry speeds: %lu blocks differ by more than %.3f mm/s; most %.3f mm/s "
+	    "at block %u, rms %.4f mm/s\n", speed_over, tol_speed, speed_max, speed_at,
+	    common ? sqrt(speed_sq / (double)common) : 0.0);
+     printf("Accelerate until: %lu blocks differ by more than %ld steps; most %ld at "
+	    "block %u\n", accel_over, tol_steps, accel_max, accel_at);
+     printf("Decelerate after: %lu blocks differ by more than %ld steps; most %ld at "
+	    "block %u\n", decel_over, tol_steps, decel_max, decel_at);
+
+     double dt = (a.total_time > 0.0) ?
+	  100.0 * (b.total_time - a.total_time) / a.total_time : 0.0;
+     printf("Total time: %.2f s and %.2f s, %+.3f%%\n", a.total_time, b.total_time, dt);
+
+     printf("Planner cost: %.2f and %.2f trapezoid passes a block; %lu and %lu blocks "
+	    "overran an interrupt, %lu and %lu starved the planner\n",
+	    a.count ? (double)a.planned / (double)a.count : 0.0,
+	    b.count ? (double)b.planned / (double)b.count : 0.0,
+	    a.overruns, b.overruns, a.starved, b.starved);
+
+     if (speed_over || accel_over || decel_over || fabs(dt) > tol_percent)
+	  over = 1;
+
+     return(over ? 2 : 0);
+}
@@ -0,0 +1,363 @@
+/*
+ *  Checkpoints of SD card builds, for carrying on after a power loss.
+ *
+ *  A checkpoint is taken as the move at its offset in the file is read,
+ *  and queued as a planner action behind the moves already planned, so it
+ *  is kept once the nozzle has got to where the record says.  Its record
+ *  goes into the next of the slots of the RESUME_CHECKPOINTS region, queued
+ *  for the EEPROM interrupt once there's room for all of it, as the stats
+ *  journal's does: each slot is written once in CHECKPOINT_SLOTS, and only
+ *  the bytes which differ from the last time.  The CRC goes last, so a
+ *  record cut short by the power going fails it and the one before it is
+ *  resumed from.
+ *
+ *  RESUME_STATE is set once the first record of a build is in, and cleared
+ *  as it ends, so only a build which was cut short is offered for resuming.
+ */
+
+#include "Compat.hh"
+#include "Checkpoint.hh"
+
+#ifdef POWER_LOSS_RESUME
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util/crc16.h>
+
+#include "Eeprom.hh"
+#include "EepromMap.hh"
+#include "Timeout.hh"
+#include "Host.hh"
+#include "Command.hh"
+#include "Commands.hh"
+#include "Motherboard.hh"
+#include "StepperAxis.hh"
+
+#ifndef POWER_LOSS_RESUME_S
+#define POWER_LOSS_RESUME_S 60
+#endif
+
+// How far above the part the nozzle is kept while X and Y are homed
+#define RESUME_LIFT_MM		5.0
+#define RESUME_HOME_FEEDRATE	2500.0	// mm/min
+#define RESUME_MOVE_FEEDRATE	1500.0	// mm/min
+#define RESUME_HEAT_TIMEOUT_S	1200
+
+// Leaves neither an erased nor a zeroed slot with a good CRC
+#define CHECKPOINT_CRC_SEED 0x5C
+
+// The low bits of seq are flags, and the sequence number, compared modulo
+// 64, counts up in the rest
+#define RECORD_TOOL		0x01	// tool 1 was in use
+#define RECORD_FAN		0x02	// the extra FET's fan was on
+#define RECORD_SEQ		0x04
+#define RECORD_SEQ_MASK		0xFC
+
+typedef struct {
+     uint8_t seq;
+     uint32_t offset;		// of the move in the file
+     int32_t position[5];	// where the move starts from
+     uint16_t tool_temp[2];
+     uint8_t platform_temp;
+     uint8_t crc;
+} Record;
+
+typedef char checkpoint_size_check[(sizeof(Record) < EEPROM_QUEUE_LENGTH) ? 1 : -1];
+
+#define CHECKPOINT_SLOTS ((eeprom_offsets::RESUME_CHECKPOINTS_END - eeprom_offsets::RESUME_CHECKPOINTS) / sizeof(Record))
+
+typedef char checkpoint_slots_check[(CHECKPOINT_SLOTS >= 2 && CHECKPOINT_SLOTS < 32) ? 1 : -1];
+
+namespace checkpoint {
+
+static Record pending;
+static bool active = false;	// checkpoints are being taken of the build
+static bool taken = false;	// pending waits for the moves before it
+static bool kept = false;	// pending waits to be queued
+static bool resuming = false;
+
+// RESUME_STATE is set after the first record of the build
+enum { ARM_NONE, ARM_WAITING, ARM_DUE };
+static uint8_t arm = ARM_NONE;
+
+// The file's bytes start here in the command buffer after the preamble of
+// a resumed build; below it, the offset of a move would be off
+static uint32_t first_offset;
+
+static Timeout interval;
+static uint8_t next_slot = 0;
+static uint8_t next_seq = 0;
+
+static uint8_t crc(const Record *r) {
+     const uint8_t *p = (const uint8_t *)r;
+     uint8_t c = CHECKPOINT_CRC_SEED;
+     for (uint8_t i = 0; i < offsetof(Record, crc); i++)
+	  c = _crc_ibutton_update(c, p[i]);
+     return c;
+}
+
+// Reads the newest record into newest, and sets where the next goes
+static bool findNewest(Record *newest) {
+     Record r;
+     bool found = false;
+
+     next_slot = 0;
+     next_seq = 0;
+     for (uint8_t slot = 0; slot < CHECKPOINT_SLOTS; slot++) {
+	  eeprom::readBlock(&r, (const void *)(eeprom_offsets::RESUME_CHECKPOINTS + slot * sizeof(Record)),
+			    sizeof(Record));
+	  if ( r.crc != crc(&r) )
+	       continue;
+	  if ( !found || (int8_t)((r.seq & RECORD_SEQ_MASK) - (newest->seq & RECORD_SEQ_MASK)) > 0 ) {
+	       *newest = r;
+	       next_slot = slot + 1;
+	       found = true;
+	  }
+     }
+     if ( found ) {
+	  next_seq = (newest->seq & RECORD_SEQ_MASK) + RECORD_SEQ;
+	  if ( next_slot >= CHECKPOINT_SLOTS )
+	       next_slot = 0;
+     }
+     return found;
+}
+
+static void startCheckpoints(uint32_t offset) {
+     active = true;
+     taken = false;
+     kept = false;
+     first_offset = offset;
+     interval.start(POWER_LOSS_RESUME_S * 1000000L);
+}
+
+void buildStarted(const char *name) {
+     // resume() carries on with the checkpoints it has
+     if ( resuming )
+	  return;
+
+     Record r;
+     findNewest(&r);
+
+     char file[RESUME_FILE_LEN];
+     strncpy(file, name, sizeof(file) - 1);
+     file[sizeof(file) - 1] = 0;
+     eeprom::writeByte((uint8_t *)eeprom_offsets::RESUME_STATE, RESUME_STATE_NONE);
+     eeprom::writeBlock(file, (void *)eeprom_offsets::RESUME_FILE, strlen(file) + 1);
+
+     startCheckpoints(0);
+     arm = ARM_WAITING;
+}
+
+void buildEnded() {
+     if ( !active )
+	  return;
+     active = false;
+     taken = false;
+     kept = false;
+     arm = ARM_NONE;
+     eeprom::writeByte((uint8_t *)eeprom_offsets::RESUME_STATE, RESUME_STATE_NONE);
+}
+
+bool due() {
+     return active && !taken && !kept && interval.hasElapsed();
+}
+
+bool take(uint32_t offset, const Point &position, uint8_t tool) {
+     if ( offset < first_offset )
+	  return false;
+
+     memset(&pending, 0, sizeof(pending));
+     pending.offset = offset;
+     for (uint8_t i = 0; i < STEPPER_COUNT; i++)
+	  pending.position[i] = position[i];
+     if ( tool )
+	  pending.seq |= RECORD_TOOL;
+     taken = true;
+     return true;
+}
+
+void commit(bool fan) {
+     // The build ended before the moves did
+     if ( !taken )
+	  return;
+
+     Motherboard &board = Motherboard::getBoard();
+     for (uint8_t i = 0; i < EXTRUDERS; i++)
+	  pending.tool_temp[i] = board.getExtruderBoard(i).getExtruderHeater().get_set_temperature();
+     pending.platform_temp = (uint8_t)board.getPlatformHeater().get_set_temperature();
+     if ( fan )
+	  pending.seq |= RECORD_FAN;
+
+     taken = false;
+     kept = true;
+     interval.start(POWER_LOSS_RESUME_S * 1000000L);
+}
+
+void service() {
+     if ( kept && eeprom::writeRoom(sizeof(Record)) ) {
+	  pending.seq |= next_seq;
+	  pending.crc = crc(&pending);
+	  eeprom::writeBlock(&pending, (void *)(eeprom_offsets::RESUME_CHECKPOINTS + next_slot * sizeof(Record)),
+			     sizeof(Record));
+	  if ( ++next_slot >= CHECKPOINT_SLOTS )
+	       next_slot = 0;
+	  next_seq += RECORD_SEQ;
+	  kept = false;
+	  if ( arm == ARM_WAITING )
+	       arm = ARM_DUE;
+     }
+     // After the record, so that the state never points at one half written
+     else if ( arm == ARM_DUE && eeprom::writeRoom(1) ) {
+	  eeprom::writeByte((uint8_t *)eeprom_offsets::RESUME_STATE, RESUME_STATE_ACTIVE);
+	  arm = ARM_NONE;
+     }
+}
+
+bool available() {
+     Record r;
+     return !active &&
+	  eeprom::getEeprom8(eeprom_offsets::RESUME_STATE, RESUME_STATE_NONE) == RESUME_STATE_ACTIVE &&
+	  findNewest(&r);
+}
+
+static void push16(uint16_t v) {
+     command::push((uint8_t)v);
+     command::push((uint8_t)(v >> 8));
+}
+
+static void push32(uint32_t v) {
+     push16((uint16_t)v);
+     push16((uint16_t)(v >> 16));
+}
+
+static void pushToolCommand(uint8_t tool, uint8_t command, uint8_t length, uint16_t arg) {
+     command::push(HOST_CMD_TOOL_COMMAND);
+     command::push(tool);
+     command::push(command);
+     command::push(length);
+     if ( length == 1 )
+	  command::push((uint8_t)arg);
+     else
+	  push16(arg);
+}
+
+static void pushWait(uint8_t command, uint8_t tool) {
+     command::push(command);
+     command::push(tool);
+     push16(100);
+     push16(RESUME_HEAT_TIMEOUT_S);
+}
+
+// A move from at to to, with the axis which steps the most going at
+// mm_per_min
+static void pushMove(int32_t *at, const int32_t *to, float mm_per_min) {
+     uint8_t axis = Z_AXIS;
+     int32_t most = 0;
+     for (uint8_t i = 0; i < 3; i++) {
+	  int32_t d = labs(to[i] - at[i]);
+	  if ( d > most ) {
+	       most = d;
+	       axis = i;
+	  }
+     }
+     command::push(HOST_CMD_QUEUE_POINT_EXT);
+     for (uint8_t i = 0; i < 5; i++) {
+	  push32(to[i]);
+	  at[i] = to[i];
+     }
+     push32((uint32_t)(60000000.0 / (mm_per_min * stepperAxisStepsPerMM(axis))));
+}
+
+static void pushHome(uint8_t command, uint8_t axes) {
+     command::push(command);
+     command::push(axes);
+     push32((uint32_t)(60000000.0 / (RESUME_HOME_FEEDRATE * stepperAxisStepsPerMM(X_AXIS))));
+     push16(30);
+}
+
+// The commands which take the place of the file up to the checkpoint
+static void pushPreamble(const Record *r) {
+     uint8_t tool = ( r->seq & RECORD_TOOL ) ? 1 : 0;
+     int32_t at[5], to[5];
+
+     command::push(HOST_CMD_CHANGE_TOOL);
+     command::push(tool);
+
+     command::push(HOST_CMD_SET_POSITION_EXT);
+     for (uint8_t i = 0; i < 5; i++) {
+	  at[i] = to[i] = r->position[i];
+	  push32(at[i]);
+     }
+
+     // Up off the part before anything moves sideways
+     to[Z_AXIS] += (int32_t)(RESUME_LIFT_MM * stepperAxisStepsPerMM(Z_AXIS));
+     pushMove(at, to, RESUME_MOVE_FEEDRATE);
+
+     if ( r->platform_temp )
+	  pushToolCommand(0, SLAVE_CMD_SET_PLATFORM_TEMP, 2, r->platform_temp);
+     for (uint8_t i = 0; i < EXTRUDERS; i++)
+	  if ( r->tool_temp[i] )
+	       pushToolCommand(i, SLAVE_CMD_SET_TEMP, 2, r->tool_temp[i]);
+
+     // Z is left where it is, with the part in the way of its endstop
+#if defined(X_HOME_MIN) && defined(Y_HOME_MIN)
+     pushHome(HOST_CMD_FIND_AXES_MINIMUM, _BV(X_AXIS) | _BV(Y_AXIS));
+#elif defined(X_HOME_MIN)
+     pushHome(HOST_CMD_FIND_AXES_MINIMUM, _BV(X_AXIS));
+     pushHome(HOST_CMD_FIND_AXES_MAXIMUM, _BV(Y_AXIS));
+#elif defined(Y_HOME_MIN)
+     pushHome(HOST_CMD_FIND_AXES_MAXIMUM, _BV(X_AXIS));
+     pushHome(HOST_CMD_FIND_AXES_MINIMUM, _BV(Y_AXIS));
+#else
+     pushHome(HOST_CMD_FIND_AXES_MAXIMUM, _BV(X_AXIS) | _BV(Y_AXIS));
+#endif
+     command::push(HOST_CMD_RECALL_HOME_POSITION);
+     command::push(_BV(X_AXIS) | _BV(Y_AXIS));
+     for (uint8_t i = X_AXIS; i <= Y_AXIS; i++)
+	  at[i] = (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + i * sizeof(uint32_t), 0);
+
+     if ( r->platform_temp )
+	  pushWait(HOST_CMD_WAIT_FOR_PLATFORM, 0);
+     for (uint8_t i = 0; i < EXTRUDERS; i++)
+	  if ( r->tool_temp[i] )
+	       pushWait(HOST_CMD_WAIT_FOR_TOOL, i);
+     pushToolCommand(tool, SLAVE_CMD_TOGGLE_VALVE, 1, ( r->seq & RECORD_FAN ) ? 1 : 0);
+
+     // Over the checkpoint, and then down onto it
+     pushMove(at, to, RESUME_MOVE_FEEDRATE);
+     to[Z_AXIS] = r->position[Z_AXIS];
+     pushMove(at, to, RESUME_MOVE_FEEDRATE);
+}
+
+sdcard::SdErrorCode resume() {
+     Record r;
+     char file[RESUME_FILE_LEN];
+
+     if ( !available() )
+	  return sdcard::SD_ERR_FILE_NOT_FOUND;
+     findNewest(&r);
+     eeprom::readBlock(file, (const void *)eeprom_offsets::RESUME_FILE, sizeof(file));
+     file[sizeof(file) - 1] = 0;
+
+     resuming = true;
+     sdcard::SdErrorCode e = host::startBuildFromSD(file, strlen(file));
+     resuming = false;
+     if ( e != sdcard::SD_SUCCESS )
+	  return e;
+
+     // Building from the top of the file would build on top of the part
+     if ( host::getHostState() != host::HOST_STATE_BUILDING_FROM_SD ||
+	  !sdcard::playbackSeek(r.offset) ) {
+	  sdcard::finishPlayback();
+	  return sdcard::SD_ERR_GENERIC;
+     }
+
+     pushPreamble(&r);
+     startCheckpoints(r.offset);
+     return sdcard::SD_SUCCESS;
+}
+
+}
+
+#endif
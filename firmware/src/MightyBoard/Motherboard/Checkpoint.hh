@@ -0,0 +1,56 @@
+#ifndef __CHECKPOINT_HH__
+#define __CHECKPOINT_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// Checkpoints of an SD card build, from which it can be carried on after
+// the power has gone.  Every POWER_LOSS_RESUME_S seconds the place in the
+// file of the next move is noted, along with where the nozzle will be once
+// the moves before it are done, and kept once they are, with the heater
+// settings and fan as they are then.  Each is written as a record to the
+// next slot of eeprom_offsets::RESUME_CHECKPOINTS in the background.
+
+#ifdef POWER_LOSS_RESUME
+
+#include "Point.hh"
+#include "SDCard.hh"
+
+namespace checkpoint {
+
+/// Called when an SD card build starts, with the name of its file in the
+/// working directory.  Any checkpoints of the last build are dropped.
+void buildStarted(const char *name);
+
+/// Called when the build has finished or been cancelled
+void buildEnded();
+
+/// True when it's time for another checkpoint
+bool due();
+
+/// Note the checkpoint at the move starting at offset in the file, which
+/// starts from position, in the command coordinates of tool.  False, with
+/// nothing noted, if offset is still in a resumed build's preamble.
+bool take(uint32_t offset, const Point &position, uint8_t tool);
+
+/// Keep the checkpoint now that the moves before it are done, taking the
+/// heater settings as they are and whether the extra FET's fan is on
+void commit(bool fan);
+
+/// Queue the checkpoint kept to be written, if there's room for it.
+/// Called from the main loop.
+void service();
+
+/// True if a build was cut short and can be carried on
+bool available();
+
+/// Start the build cut short again from its newest checkpoint: reheat,
+/// home X and Y raised clear of the part, and go back down to where it
+/// left off
+sdcard::SdErrorCode resume();
+
+}
+
+#endif
+
+#endif
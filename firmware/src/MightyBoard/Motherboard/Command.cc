@@ -18,6 +18,7 @@
 #include "Compat.hh"
 #include "Command.hh"
 #include "Steppers.hh"
+#include "Kinematics.hh"
 #include "Commands.hh"
 #include "Configuration.hh"
 #include "Timeout.hh"
@@ -26,6 +27,10 @@
 #include <avr/eeprom.h>
 #include "Eeprom.hh"
 #include "EepromMap.hh"
+#include "StatsJournal.hh"
+#include "Checkpoint.hh"
+#include "PreScan.hh"
+#include "DryRun.hh"
 #include "SDCard.hh"
 #include "Pin.hh"
 #include <util/delay.h>
@@ -48,10 +53,19 @@
 #include "stdio.h"
 #include "Menu_locales.hh"
 #include "Version.hh"
+#include "FlightRecorder.hh"
+#include "LayerLog.hh"
 #include <math.h>
 
 #if defined(AUTO_LEVEL)
 #include "SkewTilt.hh"
+#include "MeshLevel.hh"
+#include "Xmem.hh"
+#endif
+
+// A machine with one extruder has none standing by
+#if defined(TOOLCHANGE_PREHEAT) && EXTRUDERS == 1
+#undef TOOLCHANGE_PREHEAT
 #endif
 
 namespace command {
@@ -82,9 +96,128 @@ uint8_t pstop_move_count = 0;
 
 #endif
 
-#define COMMAND_BUFFER_SIZE 512
-uint8_t buffer_data[COMMAND_BUFFER_SIZE];
-CircularBuffer command_buffer(COMMAND_BUFFER_SIZE, buffer_data);
+CommandBuffer command_buffer XMEM_COMMANDS_DATA;
+
+// While printing from SD, the command buffer is refilled once it has room for
+// COMMAND_BUFFER_REFILL_CHUNK bytes, so that each refill copies whole SD read
+// buffers.  Whilst a run of moves is being planned, it's only refilled when it
+// drops below COMMAND_BUFFER_LOW_WATERMARK bytes, which is enough that the
+// planner doesn't run out of moves before the next slice.
+#ifndef COMMAND_BUFFER_REFILL_CHUNK
+#define COMMAND_BUFFER_REFILL_CHUNK SD_BYTE_BUFLEN
+#endif
+
+#ifndef COMMAND_BUFFER_LOW_WATERMARK
+#define COMMAND_BUFFER_LOW_WATERMARK (COMMAND_BUFFER_SIZE / 4)
+#endif
+
+typedef char command_buffer_watermark_check[(COMMAND_BUFFER_REFILL_CHUNK < COMMAND_BUFFER_SIZE &&
+					      COMMAND_BUFFER_LOW_WATERMARK <= COMMAND_BUFFER_SIZE - COMMAND_BUFFER_REFILL_CHUNK) ? 1 : -1];
+
+// Fill the command buffer straight from a playback source, a run of bytes
+// at a time: the SD read buffer, or the script in flash.  read copies up to
+// count bytes to dst and returns how many, 0 at the end.  Copies no more
+// than most bytes, and returns how many it did
+typedef uint16_t (*PlaybackRead)(uint8_t *dst, uint16_t count);
+
+static uint16_t refillFrom(PlaybackRead read, uint16_t most = COMMAND_BUFFER_SIZE) {
+	uint8_t *dst;
+	uint16_t room, copied = 0;
+	while ( copied < most && ( room = command_buffer.pushContiguous(&dst) ) > 0 ) {
+		if ( room > most - copied ) room = most - copied;
+		uint16_t n = read(dst, room);
+		// End of file or a read error; the caller deals with them
+		if ( n == 0 ) break;
+		command_buffer.pushed(n);
+		copied += n;
+	}
+	return copied;
+}
+
+#ifdef SD_DIRECT_DECODE
+
+// While building from SD, a command which lies wholly in the SD read buffer
+// is decoded where it is, rather than being copied into the command buffer
+// and out again.  Only a command which straddles the end of the read buffer,
+// or one with a string, goes through the command buffer.  The decoder reads
+// the commands from command_source, which is the read buffer while the
+// command buffer is empty and the next command is in it, and the command
+// buffer otherwise.  The read buffer may be the SD library's block cache,
+// which any read of the card replaces, so refillFromSD() looks it up again
+// before each command.
+class CommandSource {
+	const uint8_t *bytes;	// The unread part of the SD read buffer, or 0
+	uint16_t avail;
+public:
+	CommandSource() : bytes(0), avail(0) {}
+
+	// Points at the SD read buffer if the next command can be decoded
+	// from it, else at the command buffer.  Returns which.
+	bool refresh();
+
+	void forget() {
+		bytes = 0;
+		avail = 0;
+	}
+
+	uint8_t operator[](uint16_t index) {
+		return bytes ? bytes[index] : command_buffer[index];
+	}
+
+	uint16_t getLength() const {
+		return bytes ? avail : command_buffer.getLength();
+	}
+
+	bool isEmpty() const {
+		return !bytes && command_buffer.isEmpty();
+	}
+
+	bool peek(uint8_t *dst, uint16_t sz, uint16_t offset = 0) const {
+		if ( !bytes ) return command_buffer.peek(dst, sz, offset);
+		if ( avail < offset + sz ) return false;
+		memcpy(dst, bytes + offset, sz);
+		return true;
+	}
+
+	// Only whole commands are decoded in place, so the read buffer can't
+	// run out part way through one
+	void pop(uint16_t sz) {
+		if ( !bytes ) {
+			command_buffer.pop(sz);
+			return;
+		}
+		if ( sz > avail ) sz = avail;
+		sdcard::playbackSkip(sz);
+		bytes += sz;
+		avail -= sz;
+		if ( avail == 0 ) bytes = 0;
+	}
+
+	uint8_t pop() {
+		if ( !bytes ) return command_buffer.pop();
+		uint8_t b = *bytes;
+		pop(1);
+		return b;
+	}
+
+	bool popInto(uint8_t *dst, uint16_t sz) {
+		if ( !bytes ) return command_buffer.popInto(dst, sz);
+		if ( !peek(dst, sz) ) return false;
+		pop(sz);
+		return true;
+	}
+};
+
+static CommandSource command_source;
+
+#else
+
+static CommandBuffer &command_source = command_buffer;
+
+#endif
+
+static void refillFromSD();
+
 uint8_t currentToolIndex = 0;
 
 #if defined(LINE_NUMBER)
@@ -101,15 +234,35 @@ bool outstanding_tool_command = false;
 enum PauseState paused = PAUSE_STATE_NONE;
 static const prog_uchar *pauseErrorMessage = 0;
 static bool coldPause = false;
+#ifdef FAST_CANCEL
+static bool fastCancelling = false;
+#endif
 bool heat_shutdown = false;
 
 static Point pausedPosition;
 
-volatile int32_t  pauseZPos = 0;
-bool pauseAtZPosActivated = false;
+// Planner actions waiting for the build to get to a Z; see actionAtZPos().
+// They're checked as the moves are planned, not on each command.
+#ifndef Z_ACTIONS
+#define Z_ACTIONS 4
+#endif
+
+typedef struct {
+	int32_t zpos;		// in steps, 0 for a free entry
+	bool armed;		// the planner has been below zpos since it was set
+	plan_action_t action;
+} z_action_t;
+
+static z_action_t z_actions[Z_ACTIONS];
+static uint8_t z_actions_set = 0;	// entries in use
+static uint8_t z_actions_due = 0;	// mask of those got to, waiting to be queued
 
 int64_t filamentLength[EXTRUDERS] = { EXTRUDERS_(0, 0) };	//This maybe pos or neg, but ABS it and all is good (in steps)
 int64_t lastFilamentLength[EXTRUDERS] = { EXTRUDERS_(0, 0) };
+// Extruded since it was last folded into filamentLength.  The moves add to
+// these rather than to filamentLength, as a 64 bit add takes several times a
+// 32 bit one.  2^31 steps is kilometres of filament, more than a build uses.
+static int32_t filamentSteps[EXTRUDERS];
 static int32_t lastFilamentPosition[EXTRUDERS];
 static uint16_t currentRetraction[EXTRUDERS];
 
@@ -133,21 +286,122 @@ bool dittoPrinting = false;
 #endif
 bool deleteAfterUse = true;
 
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER) || defined(CORE_XYZ)
+// A home is made in up to three phases, HOME_FAST and HOME_BACKOFF being
+// skipped where the fast approach would be no faster
+enum {
+	HOME_FAST,	// accelerated approach to the endstops
+	HOME_BACKOFF,	// back off from them
+	HOME_SLOW,	// home at the speed asked for
+	HOME_DONE
+};
+
 static uint8_t  home_command;
-static bool     home_again;
+static uint8_t  home_flags;
+static uint8_t  home_phase;
+static uint8_t  home_fast_axes;
 static uint32_t home_feedrate;
 static uint16_t home_timeout_s;
+#if KINEMATICS_MIXED_MASK
+static bool     home_again;
 #endif
 
 #if defined(AUTO_LEVEL)
 static uint8_t alevel_state;
+// A HOST_CMD_PROBE_POINT in progress.  Its touches are homes of Z, each
+// taken up by probeTouched() once it's done.
+static bool     probe_active = false;
+static uint8_t  probe_point;
+static uint8_t  probe_touches;		// The most to make
+static uint8_t  probe_count;		// Made so far
+static uint16_t probe_tolerance;	// Steps
+static int32_t  probe_min, probe_max, probe_sum;
+#if defined(AUTO_LEVEL_MESH)
+// A move queued while mesh leveling is split where it crosses the lines of
+// the grid, so that Z follows the mesh between them.  The pieces go to the
+// planner as it has room for them; the rest of the move waits here, in the
+// coordinates of the commands.
+static bool    mesh_pending = false;
+static int32_t mesh_from[STEPPER_COUNT];
+static int32_t mesh_target[STEPPER_COUNT];
+static int32_t mesh_dda_rate;
+static uint8_t mesh_relative;
+static FPTYPE  mesh_distance;
+static int16_t mesh_feedrate;
+#define MESH_SEGMENTS_PENDING mesh_pending
+#endif
 #if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL)
 uint8_t zprobe_hits = 0;
 uint8_t max_zprobe_hits = ALEVEL_MAX_ZPROBE_HITS_DEFAULT; // Later set by steppers::reset()
 #endif
 #endif
 
+#if !defined(AUTO_LEVEL) || !defined(AUTO_LEVEL_MESH)
+#define MESH_SEGMENTS_PENDING false
+#endif
+
+#ifndef ARC_TOLERANCE
+// Furthest the chords of an arc may stray from it, in mm
+#define ARC_TOLERANCE 0.01
+#endif
+
+#ifndef ARC_MIN_SEGMENT
+// Shortest chord, in mm.  The planner has to hold enough chords to brake
+// in, so a shallower planner gets longer ones.
+#if BLOCK_BUFFER_SIZE >= 32
+#define ARC_MIN_SEGMENT 0.25
+#else
+#define ARC_MIN_SEGMENT 0.5
+#endif
+#endif
+
+// Chords between recomputing the radius from scratch, which stops the
+// rounding of the fixed point rotation adding up
+#define ARC_CORRECTION 16
+
+// An arc is queued as chords, a few at a time as the planner has room for
+// them, as a move split over the mesh is.  The radius, in mm, is turned
+// through the angle of a chord in fixed point for each one.
+static bool     arc_pending = false;
+static uint16_t arc_segments;		// chords in all
+static uint16_t arc_done;		// chords queued
+static uint8_t  arc_correction;		// chords until the next correction
+static int32_t  arc_center[2];		// X and Y, steps
+static float    arc_start_radius[2];	// X and Y, mm
+static FPTYPE   arc_radius[2];
+static FPTYPE   arc_cos, arc_sin;	// of the chord's angle
+static float    arc_angle;		// of a chord, radians
+static FPTYPE   arc_steps_per_mm[2];
+static int32_t  arc_end[3];		// X, Y and Z, steps
+static int32_t  arc_z;			// Z at the start
+static int32_t  arc_last[3];		// X, Y and Z of the chord queued last
+static int32_t  arc_extrude[2];		// A and B, steps
+static int32_t  arc_extruded[2];
+static FPTYPE   arc_distance;		// of a chord, mm
+static float    arc_rate;		// dda steps per second per step of a chord
+static int16_t  arc_feedrate;
+
+#define MOVE_SEGMENTS_PENDING (MESH_SEGMENTS_PENDING || arc_pending)
+
+// Firmware retraction.  A retract waits for the move after it, to go with
+// it if it's a travel; see queueHostMove()
+static bool     retracted = false;	// the active tool is retracted
+static bool     retract_pending = false;	// but the retract isn't queued yet
+static uint16_t retract_steps;		// of the pending retract
+static int16_t  retract_feedrate;	// mm/s * 64
+
+// A travel with a retract and an unretract is queued as three blocks
+#define MOVE_PLANNER_ROOM (retracted ? (BLOCK_BUFFER_SIZE - 3) : (BLOCK_BUFFER_SIZE - 2))
+
+// With MOVE_QUEUE, the moves are decoded on ahead of a full planner into
+// the steppers' queue, which needs the same room
+#ifdef MOVE_QUEUE
+#define MOVE_ROOM		( movesplanned() < MOVE_PLANNER_ROOM || steppers::moveQueueRoom(retracted ? 3 : 1) )
+#define MOVE_QUEUE_EMPTY	steppers::moveQueueEmpty()
+#else
+#define MOVE_ROOM		( movesplanned() < MOVE_PLANNER_ROOM )
+#define MOVE_QUEUE_EMPTY	true
+#endif
+
 uint16_t getRemainingCapacity() {
 	uint16_t sz;
 	ATOMIC_BLOCK(ATOMIC_FORCEON) {
@@ -215,11 +469,15 @@ void alevel_update(Point &newPoint) {
 
      if ( delta[0] != 0 || delta[1] != 0 || delta[2] != 0 ) {
 
-	  if ( alevel_state & 8 )
+	  if ( alevel_state & 8 ) {
 	       // Auto-leveling was initialized successfully
 	       //   update the transform
 	       skew_update(delta);
-	  else
+#if defined(AUTO_LEVEL_MESH)
+	       mesh_update(delta);
+#endif
+	  }
+	  else {
 	       // We were getting ready to initialize auto-leveling,
 	       //   but hadn't completed the process AND we just
 	       //   translated some combination of X, Y, or Z.
@@ -229,6 +487,10 @@ void alevel_update(Point &newPoint) {
 	       //   be doing something like this.  But the code is
 	       //   here should it happen.
 	       alevel_state = 0;
+#if defined(AUTO_LEVEL_MESH)
+	       mesh_deinit();
+#endif
+	  }
      }
 }
 
@@ -255,11 +517,24 @@ static void cancelMidBuild() {
      // If we don't flush it, it'll get executed causing the build
      // platform to "unclear" itself.
      command_buffer.reset();
+#ifdef SD_DIRECT_DECODE
+     command_source.forget();
+#endif
 
      // And finally cancel the build
      host::stopBuild();
 }
 
+#ifdef SD_FILE_CRC
+void cancelFileError(const unsigned char *msg) {
+     if ( paused != PAUSE_STATE_NONE )
+	  return;
+     sdCardError = true;
+     pauseErrorMessage = msg;
+     cancelMidBuild();
+}
+#endif
+
 //Called when filament is extracted via the filament menu during a pause.
 //It prevents noodle from being primed into the extruder on resume
 
@@ -268,6 +543,9 @@ void pauseUnRetractClear(void) {
 }
 
 void pause(bool pause, bool cold) {
+#ifdef FLIGHT_RECORDER
+	if ( pause ) flightrec::freeze(flightrec::FREEZE_PAUSE);
+#endif
 	if ( pause ) paused = (enum PauseState)PAUSE_STATE_ENTER_COMMAND;
 	else         paused = (enum PauseState)PAUSE_STATE_EXIT_COMMAND;
 	coldPause = cold;
@@ -304,33 +582,117 @@ bool pauseIntermediateState() {
 	return true;
 }
 
-void pauseAtZPos(int32_t zpos) {
-        pauseZPos = zpos;
+#ifdef FAST_CANCEL
+
+void fastCancel() {
+	fastCancelling = true;
+	command_buffer.reset();
+#ifdef SD_DIRECT_DECODE
+	command_source.forget();
+#endif
+	pause(true);
+}
+
+bool fastCancelParking() {
+	return fastCancelling && paused == PAUSE_STATE_ENTER_WAIT_CLEARING_PLATFORM;
+}
+
+#endif
+
+static void clearZAction(uint8_t i) {
+	if ( z_actions[i].zpos == 0 ) return;
+	z_actions[i].zpos = 0;
+	z_actions_due &= ~(1 << i);
+	z_actions_set --;
+}
+
+bool actionAtZPos(int32_t zpos, uint8_t type, uint8_t arg0, uint8_t arg1, uint8_t arg2) {
+	if ( zpos == 0 ) return false;
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ ) {
+		z_action_t *za = &z_actions[i];
+		if ( za->zpos != 0 ) continue;
+
+		za->action.type = type;
+		za->action.arg[0] = arg0;
+		za->action.arg[1] = arg1;
+		za->action.arg[2] = arg2;
+
+		//If we're already past the position, we might be paused, or
+		//homing, so the action is armed later, when Z drops below it
+		za->armed = steppers::getPlannerPosition()[2] < zpos;
+		za->zpos = zpos;
+		z_actions_set ++;
+		return true;
+	}
+	return false;
+}
 
-	//If we're already past the pause position, we might be paused,
-	//or homing, so we activate the pauseZPos later, when the Z position drops
-	//below pauseZPos
-	if ( steppers::getPlannerPosition()[2] >= pauseZPos )
-		pauseAtZPosActivated = false;
-	else	pauseAtZPosActivated = true;
+static void clearZActions() {
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ )
+		clearZAction(i);
+}
+
+// Marks those of the actions which the move just planned got to
+static void checkZActions() {
+	int32_t z = steppers::getPlannerPosition()[2];
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ ) {
+		z_action_t *za = &z_actions[i];
+		if ( za->zpos == 0 ) continue;
+		if ( ! za->armed ) {
+			if ( z < za->zpos ) za->armed = true;
+		}
+		else if ( z >= za->zpos )
+			z_actions_due |= 1 << i;
+	}
+}
+
+static void queueAction(const plan_action_t *action);
+
+// Queues the actions got to on the last move planned, so they're carried out
+// as it finishes.  With moves decoded ahead into the steppers' queue, that
+// waits for the queue to empty.  Returns true while some are still waiting,
+// which holds back the moves after them.
+static bool queueZActions() {
+	if ( ! MOVE_QUEUE_EMPTY ) return true;
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ ) {
+		if ( ! ( z_actions_due & (1 << i) ) ) continue;
+		if ( plan_action_room() == 0 ) return true;
+		queueAction(&z_actions[i].action);
+		clearZAction(i);
+	}
+	return false;
+}
+
+void pauseAtZPos(int32_t zpos) {
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ )
+		if ( z_actions[i].zpos != 0 && z_actions[i].action.type == PLAN_ACTION_PAUSE )
+			clearZAction(i);
+	actionAtZPos(zpos, PLAN_ACTION_PAUSE, 0);
 }
 
 int32_t getPauseAtZPos() {
-        return pauseZPos;
+	for ( uint8_t i = 0; i < Z_ACTIONS; i ++ )
+		if ( z_actions[i].zpos != 0 && z_actions[i].action.type == PLAN_ACTION_PAUSE )
+			return z_actions[i].zpos;
+	return 0;
 }
 
 bool isEmpty() {
-	return command_buffer.isEmpty();
+	return command_source.isEmpty();
 }
 
 void push(uint8_t byte) {
+#ifdef SD_DIRECT_DECODE
+	// What's pushed goes ahead of the rest of the file
+	command_source.forget();
+#endif
 	command_buffer.push(byte);
 }
 
 uint8_t pop8() {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline"
-	return command_buffer.pop();
+	return command_source.pop();
 #pragma GCC diagnostic pop
 }
 
@@ -344,8 +706,8 @@ int16_t pop16() {
 	} shared;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline"
-	shared.b.data[0] = command_buffer.pop();
-	shared.b.data[1] = command_buffer.pop();
+	shared.b.data[0] = command_source.pop();
+	shared.b.data[1] = command_source.pop();
 #pragma GCC diagnostic pop
 	return shared.a;
 }
@@ -360,10 +722,10 @@ int32_t pop32() {
 	} shared;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline"
-	shared.b.data[0] = command_buffer.pop();
-	shared.b.data[1] = command_buffer.pop();
-	shared.b.data[2] = command_buffer.pop();
-	shared.b.data[3] = command_buffer.pop();
+	shared.b.data[0] = command_source.pop();
+	shared.b.data[1] = command_source.pop();
+	shared.b.data[2] = command_source.pop();
+	shared.b.data[3] = command_source.pop();
 #pragma GCC diagnostic pop
 	return shared.a;
 }
@@ -375,7 +737,8 @@ enum ModeState {
 	HOMING,
 	WAIT_ON_TOOL,
 	WAIT_ON_PLATFORM,
-	WAIT_ON_BUTTON
+	WAIT_ON_BUTTON,
+	WAIT_ON_BARRIER		// A HOST_CMD_CONCURRENT join
 };
 
 enum ModeState mode = READY;
@@ -394,19 +757,54 @@ enum {
 /// Action to take when button times out
 uint8_t button_timeout_behavior;
 
+#ifdef HEAT_WAIT_MOVES
+// The heaters a wait has left to the first move which extrudes: a bit for
+// each tool, and HEAT_BARRIER_PLATFORM.  They share tool_wait_timeout.
+#define HEAT_BARRIER_PLATFORM	0x80
+static uint8_t heat_barrier = 0;
+static bool heat_barrier_held = false;	// A move or a join is waiting on it
+// Between a HOST_CMD_CONCURRENT begin and its join, or the first move which
+// extrudes, the waits go to heat_barrier whatever the settings
+static bool concurrent_phase = false;
+#endif
+
+#ifdef TOOLCHANGE_PREHEAT
+// How often preheatStandbyTool() searches the command buffer
+#define PREHEAT_SCAN_MICROS	1000000L
+
+static Timeout preheat_timeout;
+static int8_t preheat_tool = -1;	// The tool preheatStandbyTool() raised early, or -1,
+static int16_t preheat_temp;		// and the temperature it raised it to
+#endif
+
 void buildDone() {
 #if defined(AUTO_LEVEL)
      alevel_state = 0;
      skew_deinit();
+#if defined(AUTO_LEVEL_MESH)
+     mesh_pending = false;
+     mesh_deinit();
+#endif
+#endif
+     arc_pending = false;
+#ifdef HEAT_WAIT_MOVES
+	heat_barrier = 0;
+	heat_barrier_held = false;
+	concurrent_phase = false;
 #endif
 }
 
 void buildReset() {
-	pauseAtZPos(0);
-	pauseAtZPosActivated = false;
+	clearZActions();
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
 		pausedDigiPots[i] = 0;
 	deleteAfterUse = true;
+#ifdef TOOLCHANGE_PREHEAT
+	preheat_tool = -1;
+#endif
+
+	retracted = false;
+	retract_pending = false;
 
 	sdCardError = false;
 
@@ -420,14 +818,18 @@ void buildReset() {
 	paused = PAUSE_STATE_NONE;
 	pauseErrorMessage = 0;
 	coldPause = false;
+#ifdef FAST_CANCEL
+	fastCancelling = false;
+#endif
 	for ( uint8_t i = 0; i < EXTRUDERS; i++ ) {
         filamentLength[i] = 0;
         lastFilamentLength[i] = 0;
+		filamentSteps[i] = 0;
 		lastFilamentPosition[i] = 0;
 	}
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
-	if (( eeprom::getEeprom8(eeprom_offsets::TOOL_COUNT, 1) == 2 ) && ( eeprom::getEeprom8(eeprom_offsets::DITTO_PRINT_ENABLED, 0) ))
+	if (( eeprom::settings.tool_count == 2 ) && ( eeprom::settings.ditto_print ))
 		dittoPrinting = true;
 	else dittoPrinting = false;
 #endif
@@ -437,6 +839,9 @@ void buildReset() {
 	startingBuildTimePercentage = 0;
 	elapsedSecondsSinceBuildStart = 0;
 #endif
+#if defined(ESTIMATE_TIME)
+	plan_reset_motion_time();
+#endif
 
 #if defined(PSTOP_SUPPORT)
 	pstop_triggered = false;
@@ -460,13 +865,24 @@ void buildReset() {
 	pausedExtruderTemp[1] = 0;
 #endif
 
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER) || defined(CORE_XYZ)
+#if KINEMATICS_MIXED_MASK
 	home_again = false;
 #endif
 
 #if defined(AUTO_LEVEL)
+	probe_active = false;
 	alevel_state = 0;
 	skew_deinit();
+#if defined(AUTO_LEVEL_MESH)
+	mesh_pending = false;
+	mesh_deinit();
+#endif
+#endif
+	arc_pending = false;
+#ifdef HEAT_WAIT_MOVES
+	heat_barrier = 0;
+	heat_barrier_held = false;
+	concurrent_phase = false;
 #endif
 }
 
@@ -474,6 +890,9 @@ void reset() {
         buildReset();
 	buildPercentage = 101;
 	command_buffer.reset();
+#ifdef SD_DIRECT_DECODE
+	command_source.forget();
+#endif
 	mode = READY;
 }
 
@@ -485,6 +904,13 @@ bool isReady() {
     return (mode == READY);
 }
 
+bool isHeating() {
+#ifdef HEAT_WAIT_MOVES
+    if ( heat_barrier_held ) return true;
+#endif
+    return (mode == WAIT_ON_TOOL) || (mode == WAIT_ON_PLATFORM);
+}
+
 #if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL) && defined(AUTO_LEVEL) && defined(Z_MIN_STOP_PORT)
 void possibleZLevelPStop() {
 
@@ -532,7 +958,7 @@ void retractFilament(bool retract) {
 
 	//Calculate the dda interval, we'll calculate for A and assume B is the same
 	//Get the feedrate for A, we'll use the max_speed_change feedrate for A
-	float retractFeedRateA = (float)eeprom::getEeprom16(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t) * A_AXIS, DEFAULT_MAX_ACCELERATION_AXIS_A);
+	float retractFeedRateA = (float)eeprom::settings.retract_feedrate_a;
 
 	int32_t dda_interval = (int32_t)(1000000.0 / (retractFeedRateA * (float)stepperAxis[A_AXIS].steps_per_mm));
 
@@ -645,23 +1071,30 @@ void platformAccess(bool clearPlatform) {
    uint8_t as = steppers::alterSpeed;
    steppers::alterSpeed = 0;
 
-   steppers::setTargetNewExt(targetPosition, dda_rate, (uint8_t)0, distance,
+   steppers::setTargetNewExt(targetPosition, dda_rate, (uint8_t)0, FTOFP(distance),
 			     (int16_t)(FPTOF(stepperAxis[Z_AXIS].max_feedrate) * 64.0));
 
    // Restore use of speed control
    steppers::alterSpeed = as;
 }
 
+// Only when the total's wanted, by a screen or at the end of the build
+static void foldFilament(uint8_t extruder) {
+	filamentLength[extruder] += filamentSteps[extruder];
+	filamentSteps[extruder] = 0;
+}
+
 //Adds the filament used during this build for a particular extruder
 void addFilamentUsedForExtruder(uint8_t extruder) {
+#ifdef SD_DRY_RUN
+	// None was
+	if ( dryrun::isRunning() ) return;
+#endif
         //Need to do this to get the absolute amount
         int64_t fl = getFilamentLength(extruder);
 
         if ( fl > 0 ) {
-		int16_t offset = eeprom_offsets::FILAMENT_LIFETIME + extruder * sizeof(int64_t);
-                int64_t filamentUsed = eeprom::getEepromInt64(offset, 0);
-                filamentUsed += fl;
-                eeprom::setEepromInt64(offset, filamentUsed);
+                journal::addFilament(extruder, fl);
 
                 //We've used it up, so reset it
                 lastFilamentLength[extruder] = filamentLength[extruder];
@@ -676,6 +1109,7 @@ void addFilamentUsed() {
 }
 
 int64_t getFilamentLength(uint8_t extruder) {
+        foldFilament(extruder);
         if ( filamentLength[extruder] < 0 )       return -filamentLength[extruder];
         return filamentLength[extruder];
 }
@@ -702,22 +1136,28 @@ float filamentUsed() {
 // Saves the current digi pot settings, and switches them on high powered
 // if power_high is true, otherwise low powered
 void saveDigiPotsAndPower(bool power_high) {
+	uint8_t axes = 0;
+	uint8_t low[STEPPER_COUNT];
+
 	for (uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		low[i] = 20;
 		if ( pausedDigiPots[i] != 0 )	continue;	//Protection against double saving
 
 		pausedDigiPots[i] = steppers::getAxisPotValue(i);
-		if ( power_high )	steppers::resetAxisPot(i);
-		else			steppers::setAxisPotValue(i, 20);
+		axes |= 1 << i;
 	}
+
+	// All the pots change in the one transaction
+	if ( power_high )	steppers::resetAxisPots(axes);
+	else			steppers::setAxisPotValues(low, axes);
 }
 
 //Restores previously saved digit pot value.
 //Assumes saveDigiPotAndPower has been called recently
 void restoreDigiPots(void) {
-	for (uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
-		steppers::setAxisPotValue(i, pausedDigiPots[i]);
+	steppers::setAxisPotValues(pausedDigiPots, (1 << STEPPER_COUNT) - 1);
+	for (uint8_t i = 0; i < STEPPER_COUNT; i ++ )
 		pausedDigiPots[i] = 0;
-	}
 }
 
 #ifdef PSTOP_SUPPORT
@@ -779,250 +1219,1170 @@ static void applyExtrusionFactors(int32_t *a_steps, int32_t *b_steps, const uint
 #endif
 }
 
-// Handle movement comands -- called from a few places
-static void handleMovementCommand(const uint8_t &command) {
-        // Motherboard::getBoard().resetUserInputTimeout();  // call already made by our caller
-	if (command == HOST_CMD_QUEUE_POINT_EXT) {
-		// check for completion
-		if (command_buffer.getLength() >= 25) {
-			pop8(); // remove the command code
-			mode = MOVING;
+// Fail to compile if the packing is off
+typedef char queue_point_ext_size_check[(sizeof(queue_point_ext_t) == 25) ? 1 : -1];
+typedef char queue_point_new_size_check[(sizeof(queue_point_new_t) == 26) ? 1 : -1];
+typedef char queue_point_new_ext_size_check[(sizeof(queue_point_new_ext_t) == 32) ? 1 : -1];
+typedef char queue_point_delta_tail_size_check[(sizeof(queue_point_delta_tail_t) == 8) ? 1 : -1];
+typedef char queue_arc_size_check[(sizeof(queue_arc_t) == MAX_PACKET_PAYLOAD) ? 1 : -1];
+typedef char planner_hint_size_check[(sizeof(planner_hint_t) == 4) ? 1 : -1];
+typedef char firmware_retract_size_check[(sizeof(firmware_retract_t) == 6) ? 1 : -1];
+
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+// d * f / MESH_SPLIT_WHOLE, without overflowing on long moves
+static int32_t meshSplit(int32_t d, uint16_t f) {
+	if ( labs(d) < (1L << (31 - MESH_SPLIT_BITS)) )
+		return (d * (int32_t)f) >> MESH_SPLIT_BITS;
+	return (int32_t)(((int64_t)d * f) >> MESH_SPLIT_BITS);
+}
 
-			int32_t x = pop32();
-			int32_t y = pop32();
-			int32_t z = pop32();
-			int32_t a = pop32();
-#if EXTRUDERS > 1
-			int32_t b = pop32();
+// Queue pieces of the pending move while the planner has room, returns
+// true once it's all queued
+static bool queueMeshSegments() {
+	while ( mesh_pending && movesplanned() < (BLOCK_BUFFER_SIZE - 2) ) {
+		uint16_t f = mesh_crossing(mesh_from, mesh_target);
+		FPTYPE distance;
+		Point piece;
+
+		if ( f >= MESH_SPLIT_WHOLE ) {
+			for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+				piece[i] = mesh_target[i];
+			distance = mesh_distance;
+			mesh_pending = false;
+		} else {
+			for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+				piece[i] = mesh_from[i] + meshSplit(mesh_target[i] - mesh_from[i], f);
+#ifdef FIXED
+			distance = (FPTYPE)meshSplit((int32_t)mesh_distance, f);
 #else
-			pop32();
+			distance = mesh_distance * (float)f / (float)MESH_SPLIT_WHOLE;
 #endif
-			if (steppers::alterExtrusion) {
-				applyExtrusionFactorAbsolute(&a, 0);
-#if EXTRUDERS > 1
-				applyExtrusionFactorAbsolute(&b, 1);
+			mesh_distance -= distance;
+		}
+
+		steppers::setTargetNewExt(piece, mesh_dda_rate, mesh_relative,
+					  distance, mesh_feedrate);
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			mesh_from[i] = piece[i];
+	}
+	return ! mesh_pending;
+}
+
+// Start splitting a move over the mesh.  The pieces are absolute moves, so
+// the relative axes are resolved here against where the last move ended.
+static void queueMeshMove(const Point &target, int32_t dda_rate, uint8_t relative,
+			  FPTYPE distance, int16_t feedrateMult64) {
+	Point last = steppers::getPlannerPosition();
+	last[Z_AXIS] += steppers::z_Offset_Change;
+
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ ) {
+		mesh_from[i] = last[i];
+		mesh_target[i] = target[i];
+		if ( relative & (1 << i) )
+			mesh_target[i] += last[i];
+	}
+	mesh_dda_rate = dda_rate;
+	mesh_relative = relative & ~((1 << STEPPER_COUNT) - 1);
+	mesh_distance = distance;
+	mesh_feedrate = feedrateMult64;
+	mesh_pending = true;
+
+	queueMeshSegments();
+}
 #endif
-			}
-			int32_t dda = pop32();
+
+// Queue a move of the kind HOST_CMD_QUEUE_POINT_NEW_EXT describes
+static void queuePointNewExt(int32_t x, int32_t y, int32_t z, int32_t a, int32_t b,
+			     int32_t dda_rate, uint8_t relative, FPTYPE distance,
+			     int16_t feedrateMult64) {
+	mode = MOVING;
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
-   			if ( dittoPrinting ) {
-				if ( currentToolIndex == 0 )	b = a;
-				else				a = b;
-			}
+	if ( dittoPrinting ) {
+		if ( currentToolIndex == 0 ) {
+			b = a;
+
+			//Set B to be the same as A
+			relative &= ~(_BV(B_AXIS));
+			if ( relative & _BV(A_AXIS) )	relative |= _BV(B_AXIS);
+		} else {
+			a = b;
+
+			//Set A to be the same as B
+			relative &= ~(_BV(A_AXIS));
+			if ( relative & _BV(B_AXIS) )	relative |= _BV(A_AXIS);
+		}
+	}
+#endif
+	if (steppers::alterExtrusion) applyExtrusionFactors(&a, &b, relative);
+	int32_t ab[2] = {a,b};
+
+	for ( int i = 0; i < 2; i ++ ) {
+		if (relative & (1 << (A_AXIS + i))) {
+			filamentSteps[i] += ab[i];
+			lastFilamentPosition[i] += ab[i];
+		} else {
+			filamentSteps[i] += ab[i] - lastFilamentPosition[i];
+			lastFilamentPosition[i] = ab[i];
+		}
+	}
+
+#if defined(PSTOP_SUPPORT)
+	// Positions must be known at this point; okay to do a pstop and
+	// its attendant platform clearing
+	pstop_incr();
+#endif
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+	if ( mesh_active ) {
+		queueMeshMove(Point(STEPPERS_(x,y,z,a,b)), dda_rate,
+			      relative | 0x80,
+			      distance, feedrateMult64);
+		return;
+	}
 #endif
+	// Bit 7 puts the move under the speed factor of the panel
+	steppers::setTargetNewExt(Point(STEPPERS_(x,y,z,a,b)), dda_rate,
+				  relative | 0x80,
+				  distance, feedrateMult64);
+}
+
+// The active extruder's steps for a firmware retract, or an unretract
+static int32_t retractDelta(uint16_t steps, bool unretract) {
+	bool extrude_direction[EXTRUDERS] = { EXTRUDERS_(ACCELERATION_EXTRUDE_WHEN_NEGATIVE_A, ACCELERATION_EXTRUDE_WHEN_NEGATIVE_B) };
 
-			lastFilamentPosition[0] = a;
-			filamentLength[0] += (int64_t)(a - lastFilamentPosition[0]);
+	return ( extrude_direction[currentToolIndex] ^ unretract ) ? (int32_t)steps : -(int32_t)steps;
+}
+
+// Queue a firmware retract, or unretract, as a move of the extruder alone
+static void queueRetractMove(uint16_t steps, int16_t feedrateMult64, bool unretract) {
+	uint8_t axis = A_AXIS + currentToolIndex;
+	int32_t ab[2] = { 0, 0 };
+
+	ab[currentToolIndex] = retractDelta(steps, unretract);
+	queuePointNewExt(0, 0, 0, ab[0], ab[1],
+			 (int32_t)(stepperAxis[axis].steps_per_mm * (float)feedrateMult64) >> 6,
+			 0x1f, plan_float_to_fp(stepperAxisStepsToMM(steps, axis)),
+			 feedrateMult64);
+}
+
+// The pending retract goes on its own, ahead of whatever isn't a travel
+static void flushRetract() {
+	if ( ! retract_pending )
+		return;
+	retract_pending = false;
+	queueRetractMove(retract_steps, retract_feedrate, false);
+}
+
+// The part of a travel of distance mm at feedrateMult64 which takes as long
+// as steps of the active extruder do at retractMult64
+static float retractShare(uint16_t steps, int16_t retractMult64,
+			  float distance, int16_t feedrateMult64) {
+	return stepperAxisStepsToMM(steps, A_AXIS + currentToolIndex) * (float)feedrateMult64 /
+		((float)retractMult64 * distance);
+}
+
+// Queue the part of a travel from start to end between the shares from and
+// to of the way along it, extruding e steps of the active extruder
+static void queueTravelPart(const int32_t *start, const int32_t *end, float from, float to,
+			    int32_t e, int32_t dda_rate, float distance, int16_t feedrateMult64) {
+	int32_t p[3];
+	int32_t ab[2] = { 0, 0 };
+
+	if ( to <= from )
+		return;
+	for ( uint8_t i = 0; i < 3; i++ )
+		p[i] = ( to >= 1.0 ) ? end[i] : start[i] + (int32_t)((float)(end[i] - start[i]) * to);
+	ab[currentToolIndex] = e;
+	queuePointNewExt(p[0], p[1], p[2], ab[0], ab[1], dda_rate,
+			 (1 << A_AXIS) | (1 << B_AXIS),
+			 plan_float_to_fp(distance * (to - from)), feedrateMult64);
+}
+
+// A move from the host.  While retracted, a travel takes the pending
+// retract over its start, and an unretract which is the next command over
+// its end, so that the extruder moves without stopping the travel.
+static void queueHostMove(int32_t x, int32_t y, int32_t z, int32_t a, int32_t b,
+			  int32_t dda_rate, uint8_t relative, FPTYPE distance,
+			  int16_t feedrateMult64) {
+	bool travel = retracted && distance > 0 && feedrateMult64 > 0 &&
+		a == ((relative & (1 << A_AXIS)) ? 0 : lastFilamentPosition[0]);
 #if EXTRUDERS > 1
-			filamentLength[1] += (int64_t)(b - lastFilamentPosition[1]);
-			lastFilamentPosition[1] = b;
+	travel = travel && b == ((relative & (1 << B_AXIS)) ? 0 : lastFilamentPosition[1]);
 #endif
-			LINE_NUMBER_INCR;
-#if defined(PSTOP_SUPPORT)
-			pstop_incr();
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+	// The mesh splits the move as it goes
+	travel = travel && ! mesh_active;
 #endif
-			steppers::setTargetNew(Point(STEPPERS_(x,y,z,a,b)), dda, 0, 0);
+
+	struct firmware_retract_t unretract;
+	bool prime = travel &&
+		command_source.getLength() >= sizeof(unretract) &&
+		command_source[0] == HOST_CMD_FIRMWARE_RETRACT &&
+		(command_source[1] & FIRMWARE_RETRACT_UNRETRACT) &&
+		command_source.popInto((uint8_t *)&unretract, sizeof(unretract));
+
+	if ( ! travel || ! ( retract_pending || prime ) ) {
+		flushRetract();
+		queuePointNewExt(x, y, z, a, b, dda_rate, relative, distance, feedrateMult64);
+		return;
+	}
+
+	float mm = FPTOF(distance);
+	float head = 0.0, tail = 0.0;
+
+	if ( retract_pending )
+		head = retractShare(retract_steps, retract_feedrate, mm, feedrateMult64);
+	if ( prime ) {
+		LINE_NUMBER_INCR;
+		retracted = false;
+		if ( unretract.feedrate_mult_64 <= 0 )
+			unretract.feedrate_mult_64 = (int16_t)(eeprom::settings.retract_feedrate_a << 6);
+		tail = retractShare(unretract.steps, unretract.feedrate_mult_64, mm, feedrateMult64);
+	}
+
+	// Too short a travel for both at their rates shares itself out between them
+	if ( head + tail > 1.0 ) {
+		float both = head + tail;
+		head /= both;
+		tail /= both;
+	}
+
+	Point last = steppers::getPlannerPosition();
+	last[Z_AXIS] += steppers::z_Offset_Change;
+
+	int32_t start[3] = { last[X_AXIS], last[Y_AXIS], last[Z_AXIS] };
+	int32_t end[3] = { x, y, z };
+	for ( uint8_t i = 0; i < 3; i++ )
+		if ( relative & (1 << i) ) end[i] += start[i];
+
+	if ( retract_pending ) {
+		retract_pending = false;
+		queueTravelPart(start, end, 0.0, head, retractDelta(retract_steps, false),
+				dda_rate, mm, feedrateMult64);
+	}
+	queueTravelPart(start, end, head, 1.0 - tail, 0, dda_rate, mm, feedrateMult64);
+	if ( prime )
+		queueTravelPart(start, end, 1.0 - tail, 1.0, retractDelta(unretract.steps, true),
+				dda_rate, mm, feedrateMult64);
+}
+
+// d * k / n, without overflowing for long extrusions
+static int32_t arcShare(int32_t d, uint16_t k, uint16_t n) {
+	if ( labs(d) < 0x8000L )
+		return d * (int32_t)k / (int32_t)n;
+	return (int32_t)((int64_t)d * k / n);
+}
+
+// Queue chords of the pending arc while the planner has room, returns
+// true once it's all queued
+static bool queueArcSegments() {
+	while ( arc_pending && ! MESH_SEGMENTS_PENDING && movesplanned() < (BLOCK_BUFFER_SIZE - 2) ) {
+		int32_t p[3];
+
+		if ( ++arc_done >= arc_segments ) {
+			for ( uint8_t i = 0; i < 3; i++ )
+				p[i] = arc_end[i];
+			arc_pending = false;
+		} else {
+			if ( --arc_correction == 0 ) {
+				arc_correction = ARC_CORRECTION;
+				float angle = arc_angle * (float)arc_done;
+				float c = cos(angle), s = sin(angle);
+				arc_radius[0] = FTOFP(arc_start_radius[0] * c - arc_start_radius[1] * s);
+				arc_radius[1] = FTOFP(arc_start_radius[0] * s + arc_start_radius[1] * c);
+			} else {
+				FPTYPE x = arc_radius[0];
+				arc_radius[0] = FPMULT2(x, arc_cos) - FPMULT2(arc_radius[1], arc_sin);
+				arc_radius[1] = FPMULT2(x, arc_sin) + FPMULT2(arc_radius[1], arc_cos);
+			}
+			for ( uint8_t i = 0; i < 2; i++ )
+				p[i] = arc_center[i] + FPTOI(FPMULT2(arc_radius[i], arc_steps_per_mm[i]));
+			p[2] = arc_z + arcShare(arc_end[2] - arc_z, arc_done, arc_segments);
+		}
+
+		int32_t e[2], master = 0;
+		for ( uint8_t i = 0; i < 2; i++ ) {
+			int32_t extruded = arcShare(arc_extrude[i], arc_done, arc_segments);
+			e[i] = extruded - arc_extruded[i];
+			arc_extruded[i] = extruded;
+			if ( labs(e[i]) > master ) master = labs(e[i]);
+		}
+		for ( uint8_t i = 0; i < 3; i++ ) {
+			if ( labs(p[i] - arc_last[i]) > master ) master = labs(p[i] - arc_last[i]);
+			arc_last[i] = p[i];
+		}
+
+		queuePointNewExt(p[0], p[1], p[2], e[0], e[1], (int32_t)((float)master * arc_rate),
+				 (1 << A_AXIS) | (1 << B_AXIS), arc_distance, arc_feedrate);
+	}
+	return ! arc_pending;
+}
+
+// Start queuing the chords of a HOST_CMD_QUEUE_ARC.  X, Y and Z are
+// absolute and the extruders relative, as for HOST_CMD_QUEUE_POINT_DELTA.
+static void queueArc(const struct queue_arc_t &arc) {
+	Point last = steppers::getPlannerPosition();
+	last[Z_AXIS] += steppers::z_Offset_Change;
+
+	float spm[3];
+	for ( uint8_t i = 0; i < 3; i++ )
+		spm[i] = stepperAxisStepsPerMM(i);
+
+	arc_center[0] = last[X_AXIS] + arc.i;
+	arc_center[1] = last[Y_AXIS] + arc.j;
+	arc_start_radius[0] = -(float)arc.i / spm[0];
+	arc_start_radius[1] = -(float)arc.j / spm[1];
+	float ex = (float)(arc.x - arc_center[0]) / spm[0];
+	float ey = (float)(arc.y - arc_center[1]) / spm[1];
+	float r = sqrt(arc_start_radius[0] * arc_start_radius[0] + arc_start_radius[1] * arc_start_radius[1]);
+
+	// Angle from the start to the end, the way round the arc goes; the
+	// whole circle when they're the same
+	float angle = atan2(arc_start_radius[0] * ey - arc_start_radius[1] * ex,
+			    arc_start_radius[0] * ex + arc_start_radius[1] * ey);
+	if ( arc.flags & QUEUE_ARC_CCW ) {
+		if ( angle <= 0.0 ) angle += 2.0 * M_PI;
+	} else if ( angle >= 0.0 )
+		angle -= 2.0 * M_PI;
+
+	// The chord a sagitta of ARC_TOLERANCE cuts
+	float chord = ( r > ARC_TOLERANCE ) ? 2.0 * sqrt(ARC_TOLERANCE * (2.0 * r - ARC_TOLERANCE)) : 0.0;
+	if ( chord < ARC_MIN_SEGMENT ) chord = ARC_MIN_SEGMENT;
+	float n = ceil(fabs(angle) * r / chord);
+	if ( n < 1.0 ) n = 1.0;
+	else if ( n > 65535.0 ) n = 65535.0;
+	arc_segments = (uint16_t)n;
+
+	arc_angle = angle / n;
+	arc_cos = FTOFP(cos(arc_angle));
+	arc_sin = FTOFP(sin(arc_angle));
+	arc_radius[0] = FTOFP(arc_start_radius[0]);
+	arc_radius[1] = FTOFP(arc_start_radius[1]);
+	arc_steps_per_mm[0] = FTOFP(spm[0]);
+	arc_steps_per_mm[1] = FTOFP(spm[1]);
+	arc_correction = ARC_CORRECTION;
+	arc_done = 0;
+
+	arc_end[0] = arc.x;
+	arc_end[1] = arc.y;
+	arc_end[2] = arc.z;
+	arc_z = last[Z_AXIS];
+	for ( uint8_t i = 0; i < 3; i++ )
+		arc_last[i] = last[i];
+	arc_extrude[0] = arc.a;
+	arc_extrude[1] = arc.b;
+	arc_extruded[0] = arc_extruded[1] = 0;
+
+	// Each chord is as long as the next
+	float xy;
+	if ( arc_segments == 1 ) {
+		float dx = (float)(arc.x - last[X_AXIS]) / spm[0];
+		float dy = (float)(arc.y - last[Y_AXIS]) / spm[1];
+		xy = sqrt(dx * dx + dy * dy);
+	} else
+		xy = 2.0 * r * fabs(sin(arc_angle * 0.5));
+	float z = (float)(arc.z - last[Z_AXIS]) / spm[2] / n;
+	float distance = sqrt(xy * xy + z * z);
+	if ( distance == 0.0 ) {
+		// Only the extruders move
+		for ( uint8_t i = 0; i < EXTRUDERS; i++ ) {
+			float mm = fabs((float)arc_extrude[i] / stepperAxisStepsPerMM(A_AXIS + i)) / n;
+			if ( mm > distance ) distance = mm;
 		}
 	}
-	 else if (command == HOST_CMD_QUEUE_POINT_NEW) {
-		// check for completion
-		if (command_buffer.getLength() >= 26) {
-			pop8(); // remove the command code
-			mode = MOVING;
+	arc_distance = FTOFP(distance);
+	arc_feedrate = arc.feedrate_mult_64;
+	arc_rate = ( distance > 0.0 ) ? (float)arc.feedrate_mult_64 / 64.0 / distance : 0.0;
+	arc_pending = true;
 
-			int32_t x = pop32();
-			int32_t y = pop32();
-			int32_t z = pop32();
-			int32_t a = pop32();
-			int32_t b = pop32();
-			int32_t us = pop32();
-			uint8_t relative = pop8();
+	queueArcSegments();
+}
+
+// The flags of a command in the dispatch table, commands[]
+#define CMD_MOVE	0x01	// Handed to the planner as long as it has room, ahead of the rest
+#define CMD_NO_SYNC	0x02	// Needn't wait for the planner to empty first
+#define CMD_STRING	0x04	// A NUL terminated string follows the length given
+#define CMD_LEN_TOOL	0x08	// Plus the payload length in byte 3
+#define CMD_LEN_DELTA	0x10	// Plus 2 for each axis in the mask in byte 1
+
+// The CMD_ flags of a command, 0 for one which isn't bufferable
+static uint8_t commandFlags(uint8_t command);
+
+// The length of the command offset bytes into the command buffer, or 0 if
+// it's unknown or the buffer doesn't yet hold enough of it to tell.  That of
+// a string command leaves out the string.
+static uint16_t commandLength(uint16_t offset);
+
+// The movement commands, which runCommandSlice() hands to the planner as long
+// as it has room for them
+
+static void handleQueuePointExt() {
+	struct queue_point_ext_t move;
+	if (command_source.popInto((uint8_t *)&move, sizeof(move))) {
+		flushRetract();
+		mode = MOVING;
+
+		int32_t x = move.x;
+		int32_t y = move.y;
+		int32_t z = move.z;
+		int32_t a = move.a;
+#if EXTRUDERS > 1
+		int32_t b = move.b;
+#endif
+		if (steppers::alterExtrusion) {
+			applyExtrusionFactorAbsolute(&a, 0);
+#if EXTRUDERS > 1
+			applyExtrusionFactorAbsolute(&b, 1);
+#endif
+		}
+		int32_t dda = move.dda;
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
-   			if ( dittoPrinting ) {
-				if ( currentToolIndex == 0 ) {
-					b = a;
-
-					//Set B to be the same as A
-					relative &= ~(_BV(B_AXIS));
-					if ( relative & _BV(A_AXIS) )	relative |= _BV(B_AXIS);
-				} else {
-					a = b;
-
-					//Set A to be the same as B
-					relative &= ~(_BV(A_AXIS));
-					if ( relative & _BV(B_AXIS) )	relative |= _BV(A_AXIS);
-				}
-			}
+		if ( dittoPrinting ) {
+			if ( currentToolIndex == 0 )	b = a;
+			else				a = b;
+		}
 #endif
-			if (steppers::alterExtrusion) applyExtrusionFactors(&a, &b, relative);
-			int32_t ab[2] = {a,b};
-
-			for ( int i = 0; i < 2; i ++ ) {
-				if (relative & (1 << (A_AXIS + i))) {
-					filamentLength[i] += (int64_t)ab[i];
-					lastFilamentPosition[i] += ab[i];
-				} else {
-					filamentLength[i] += (int64_t)(ab[i] - lastFilamentPosition[i]);
-					lastFilamentPosition[i] = ab[i];
-				}
-			}
 
-			LINE_NUMBER_INCR;
+		lastFilamentPosition[0] = a;
+		filamentSteps[0] += a - lastFilamentPosition[0];
+#if EXTRUDERS > 1
+		filamentSteps[1] += b - lastFilamentPosition[1];
+		lastFilamentPosition[1] = b;
+#endif
+		LINE_NUMBER_INCR;
 #if defined(PSTOP_SUPPORT)
-			pstop_incr();
+		pstop_incr();
 #endif
-			steppers::setTargetNew(Point(STEPPERS_(x,y,z,a,b)), 0, us, relative);
-		}
+		steppers::setTargetNew(Point(STEPPERS_(x,y,z,a,b)), dda, 0, 0);
 	}
-	else if (command == HOST_CMD_QUEUE_POINT_NEW_EXT ) {
-		// check for completion
-		if (command_buffer.getLength() >= 32) {
-			pop8(); // remove the command code
-			mode = MOVING;
-
-			int32_t x = pop32();
-			int32_t y = pop32();
-			int32_t z = pop32();
-			int32_t a = pop32();
-			int32_t b = pop32();
-			int32_t dda_rate = pop32();
-			uint8_t relative = pop8() & 0x7F; // make sure that the high bit is clear
-			int32_t distanceInt32 = pop32();
-			float *distance = (float *)&distanceInt32;
-			int16_t feedrateMult64 = pop16();
+}
+
+static void handleQueuePointNew() {
+	struct queue_point_new_t move;
+	if (command_source.popInto((uint8_t *)&move, sizeof(move))) {
+		flushRetract();
+		mode = MOVING;
+
+		int32_t x = move.x;
+		int32_t y = move.y;
+		int32_t z = move.z;
+		int32_t a = move.a;
+		int32_t b = move.b;
+		int32_t us = move.us;
+		uint8_t relative = move.relative;
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
-   			if ( dittoPrinting ) {
-				if ( currentToolIndex == 0 ) {
-					b = a;
-
-					//Set B to be the same as A
-					relative &= ~(_BV(B_AXIS));
-					if ( relative & _BV(A_AXIS) )	relative |= _BV(B_AXIS);
-				} else {
-					a = b;
-
-					//Set A to be the same as B
-					relative &= ~(_BV(A_AXIS));
-					if ( relative & _BV(B_AXIS) )	relative |= _BV(A_AXIS);
-				}
+		if ( dittoPrinting ) {
+			if ( currentToolIndex == 0 ) {
+				b = a;
+
+				//Set B to be the same as A
+				relative &= ~(_BV(B_AXIS));
+				if ( relative & _BV(A_AXIS) )	relative |= _BV(B_AXIS);
+			} else {
+				a = b;
+
+				//Set A to be the same as B
+				relative &= ~(_BV(A_AXIS));
+				if ( relative & _BV(B_AXIS) )	relative |= _BV(A_AXIS);
 			}
+		}
 #endif
-			if (steppers::alterExtrusion) applyExtrusionFactors(&a, &b, relative);
-			int32_t ab[2] = {a,b};
-
-			for ( int i = 0; i < 2; i ++ ) {
-				if (relative & (1 << (A_AXIS + i))) {
-					filamentLength[i] += (int64_t)ab[i];
-					lastFilamentPosition[i] += ab[i];
-				} else {
-					filamentLength[i] += (int64_t)(ab[i] - lastFilamentPosition[i]);
-					lastFilamentPosition[i] = ab[i];
-				}
+		if (steppers::alterExtrusion) applyExtrusionFactors(&a, &b, relative);
+		int32_t ab[2] = {a,b};
+
+		for ( int i = 0; i < 2; i ++ ) {
+			if (relative & (1 << (A_AXIS + i))) {
+				filamentSteps[i] += ab[i];
+				lastFilamentPosition[i] += ab[i];
+			} else {
+				filamentSteps[i] += ab[i] - lastFilamentPosition[i];
+				lastFilamentPosition[i] = ab[i];
 			}
+		}
 
-			LINE_NUMBER_INCR;
+		LINE_NUMBER_INCR;
 #if defined(PSTOP_SUPPORT)
-			// Positions must be known at this point; okay to do a pstop and
-			// its attendant platform clearing
-			pstop_incr();
+		pstop_incr();
 #endif
-			steppers::setTargetNewExt(Point(STEPPERS_(x,y,z,a,b)), dda_rate,
-						  relative | steppers::alterSpeed,
-						  *distance, feedrateMult64);
+		steppers::setTargetNew(Point(STEPPERS_(x,y,z,a,b)), 0, us, relative);
+	}
+}
+
+// A HOST_CMD_QUEUE_POINT_DELTA in buf as the HOST_CMD_QUEUE_POINT_NEW_EXT it
+// stands for, with X, Y and Z from last
+static void decodeQueuePointDelta(const uint8_t *buf, const int32_t *last,
+				  struct queue_point_new_ext_t *move) {
+	uint8_t axes = buf[1];
+	int32_t delta[QUEUE_POINT_DELTA_AXES];
+	const uint8_t *p = buf + 2;
+	for ( uint8_t i = 0; i < QUEUE_POINT_DELTA_AXES; i ++ ) {
+		int16_t d = 0;
+		if ( axes & (1 << i) ) {
+			memcpy(&d, p, sizeof(d));
+			p += sizeof(d);
 		}
+		delta[i] = d;
 	}
+	struct queue_point_delta_tail_t tail;
+	memcpy(&tail, p, sizeof(tail));
+
+	move->command = HOST_CMD_QUEUE_POINT_NEW_EXT;
+	move->x = last[X_AXIS] + delta[0];
+	move->y = last[Y_AXIS] + delta[1];
+	move->z = last[Z_AXIS] + delta[2];
+	move->a = delta[3];
+	move->b = delta[4];
+	move->dda_rate = tail.dda_rate;
+	move->relative = (1 << A_AXIS) | (1 << B_AXIS);
+	move->distance = tail.distance;
+	move->feedrate_mult_64 = tail.feedrate_mult_64;
 }
 
-//If overrideToolIndex = -1, the toolIndex specified in the packet is used, otherwise
-//the toolIndex specified by overrideToolIndex is used
+#ifdef SEGMENT_MERGE
 
-bool processExtruderCommandPacket(int8_t overrideToolIndex) {
-	Motherboard& board = Motherboard::getBoard();
-	//command_buffer[0] is the command code, i.e. HOST_CMD_TOOL_COMMAND
+// Moves from the host of up to SEGMENT_MERGE_STEPS steps of X or Y between
+// them, in a line to within SEGMENT_MERGE_DEVIATION steps, are run as one
+// planner block.  Only those already in the command buffer are taken, so
+// nothing waits for a move to merge with.
+#ifndef SEGMENT_MERGE_STEPS
+#define SEGMENT_MERGE_STEPS	32
+#endif
+#ifndef SEGMENT_MERGE_DEVIATION
+#define SEGMENT_MERGE_DEVIATION	1
+#endif
 
-	//Handle the tool index and override it if we need to
-	uint8_t toolIndex = command_buffer[1];
-	if ( overrideToolIndex != -1 )  toolIndex = (uint8_t)overrideToolIndex;
+// The steps of the master of X and Y
+static int32_t stepSpan(const int32_t *d) {
+	int32_t x = labs(d[0]), y = labs(d[1]);
+	return ( x > y ) ? x : y;
+}
 
-	uint8_t command = command_buffer[2];
-	//command_buffer[3] - Payload length
+// The moves start and end at the same height, go on the same way, and
+// extrude at much the same rate for their length: within an eighth
+static bool segmentsMerge(const int32_t *start, const struct queue_point_new_ext_t &move,
+			  const struct queue_point_new_ext_t &next) {
+	if ( next.relative != move.relative || next.feedrate_mult_64 != move.feedrate_mult_64 ||
+	     !( next.distance > 0.0 ) || next.z != move.z || start[Z_AXIS] != move.z )
+		return false;
+
+	int32_t d1[2] = { move.x - start[X_AXIS], move.y - start[Y_AXIS] };
+	int32_t d2[2] = { next.x - move.x, next.y - move.y };
+	int32_t c[2] = { next.x - start[X_AXIS], next.y - start[Y_AXIS] };
+	int32_t l1 = stepSpan(d1);
+	int32_t l2 = stepSpan(d2);
+	int32_t lc = stepSpan(c);
+	if ( l1 == 0 || l2 == 0 || l1 + l2 > SEGMENT_MERGE_STEPS )
+		return false;
+
+	// Neither turns back, and the corner between them is no further than
+	// the deviation off the line the merged move takes
+	if ( d1[0] * c[0] + d1[1] * c[1] <= 0 || d2[0] * c[0] + d2[1] * c[1] <= 0 )
+		return false;
+	if ( labs(c[0] * d1[1] - c[1] * d1[0]) > SEGMENT_MERGE_DEVIATION * lc )
+		return false;
+
+	int32_t e1[2] = { move.a, move.b };
+	int32_t e2[2] = { next.a, next.b };
+	for ( uint8_t i = 0; i < 2; i++ ) {
+		int32_t r1 = e1[i] * l2, r2 = e2[i] * l1;
+		if ( labs(r1 - r2) * 8 > labs(r1) + labs(r2) )
+			return false;
+	}
+	return true;
+}
 
-	int16_t temp;
+// Takes the moves which follow move in the command buffer into it, for as
+// long as they merge.  X, Y and Z must be absolute and the extruders
+// relative, as they are for HOST_CMD_QUEUE_POINT_DELTA.
+static void mergeSegments(struct queue_point_new_ext_t *move) {
+	if ( ( move->relative & 0x1f ) != ( (1 << A_AXIS) | (1 << B_AXIS) ) ||
+	     move->feedrate_mult_64 <= 0 || !( move->distance > 0.0 ) )
+		return;
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+	if ( mesh_active ) return;
+#endif
 
-		switch (command) {
-		case SLAVE_CMD_SET_TEMP:
-			temp = (int16_t)command_buffer[4] + (int16_t)( command_buffer[5] << 8 );
-			if ( temp == 0 ) addFilamentUsed();
+	int32_t start[3];
+	Point last = steppers::getPlannerPosition();
+	for ( uint8_t i = 0; i <= Z_AXIS; i++ )
+		start[i] = last[i];
+	start[Z_AXIS] += steppers::z_Offset_Change;
 
-			/// Handle override gcode temp
-			if (( temp ) && ( altTemp[toolIndex] ||
-					   (eeprom::getEeprom8(eeprom_offsets::OVERRIDE_GCODE_TEMP, DEFAULT_OVERRIDE_GCODE_TEMP)) ))
-			    temp = altTemp[toolIndex] ? (int16_t)altTemp[toolIndex] : eeprom::getEeprom16(eeprom_offsets::PREHEAT_SETTINGS + toolIndex * sizeof(int16_t), DEFAULT_PREHEAT_TEMP);
+	for (;;) {
+		uint8_t command = command_source.isEmpty() ? 0 : command_source[0];
+		if ( command != HOST_CMD_QUEUE_POINT_NEW_EXT && command != HOST_CMD_QUEUE_POINT_DELTA )
+			return;
+		uint16_t len = commandLength(0);
+		if ( len == 0 || command_source.getLength() < len )
+			return;
 
-#ifdef DEBUG_NO_HEAT_NO_WAIT
-			temp  = 0;
-#endif
+		struct queue_point_new_ext_t next;
+		if ( command == HOST_CMD_QUEUE_POINT_NEW_EXT ) {
+			command_source.peek((uint8_t *)&next, sizeof(next));
+			next.relative &= 0x7F;
+		} else {
+			uint8_t buf[QUEUE_POINT_DELTA_MAX_LEN];
+			int32_t end[3] = { move->x, move->y, move->z };
+			command_source.peek(buf, len);
+			decodeQueuePointDelta(buf, end, &next);
+		}
+		if ( ! segmentsMerge(start, *move, next) )
+			return;
 
-			board.getExtruderBoard(toolIndex).getExtruderHeater().set_target_temperature(temp);
+		command_source.pop(len);
+		LINE_NUMBER_INCR;
+		move->x = next.x;
+		move->y = next.y;
+		move->a += next.a;
+		move->b += next.b;
+		move->distance += next.distance;
+		if ( next.dda_rate > move->dda_rate ) move->dda_rate = next.dda_rate;
+	}
+}
 
-#if !defined(HEATERS_ON_STEROIDS)
-			/// if platform is actively heating and extruder is not cooling down, pause extruder
-			if( board.getPlatformHeater().isHeating() &&
-			    !board.getPlatformHeater().isCooling() &&
-			    !board.getExtruderBoard(toolIndex).getExtruderHeater().isCooling() ){
-				check_temp_state = true;
-				board.getExtruderBoard(toolIndex).getExtruderHeater().Pause(true);
-			}  /// else ensure extruder is not paused
-			else {
-				board.getExtruderBoard(toolIndex).getExtruderHeater().Pause(false);
-			}
-#endif
-			BOARD_STATUS_CLEAR(Motherboard::STATUS_PREHEATING);
-			return true;
-		// can be removed in process via host query works OK
- 		case SLAVE_CMD_PAUSE_UNPAUSE:
-			host::pauseBuild(command::isPaused() == 0, false);
-			return true;
-		case SLAVE_CMD_TOGGLE_FAN:
-			board.getExtruderBoard(toolIndex).setFan((command_buffer[4] & 0x01) != 0);
-			return true;
-		case SLAVE_CMD_TOGGLE_VALVE:
-#if defined(COOLING_FAN_PWM)
-			board.setExtra(command_buffer[4], true);
-#else
-			board.setExtra((command_buffer[4] & 0x01) != 0);
 #endif
-			return true;
-		case SLAVE_CMD_SET_PLATFORM_TEMP:
-			if ( !eeprom::hasHBP() ) return true;
-			temp = (int16_t)command_buffer[4] + (int16_t)( command_buffer[5] << 8 );
-#ifdef DEBUG_NO_HEAT_NO_WAIT
-			temp = 0;
+
+static void queueHostMoveOf(struct queue_point_new_ext_t *move) {
+#ifdef SEGMENT_MERGE
+	mergeSegments(move);
 #endif
-			/// Handle override gcode temp
-			if (( temp ) && ( altTemp[ALTTEMP_PLATFORM_INDEX] || (eeprom::getEeprom8(eeprom_offsets::OVERRIDE_GCODE_TEMP, 0)) )) {
-				temp = altTemp[ALTTEMP_PLATFORM_INDEX] ? (int16_t)altTemp[ALTTEMP_PLATFORM_INDEX] : eeprom::getEeprom16(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP, 100);
-			}
+	queueHostMove(move->x, move->y, move->z, move->a, move->b, move->dda_rate,
+		      move->relative, plan_float_to_fp(move->distance), move->feedrate_mult_64);
+}
 
-			board.getPlatformHeater().set_target_temperature(temp);
+static void handleQueuePointNewExt() {
+	struct queue_point_new_ext_t move;
+	if (command_source.popInto((uint8_t *)&move, sizeof(move))) {
+		LINE_NUMBER_INCR;
+		move.relative &= 0x7F; // make sure that the high bit is clear
+		queueHostMoveOf(&move);
+	}
+}
 
-			// If we're setting the platform temp to 0 (off) then it's tempting to
-			// just bail here.  However, it may be that the platform was previously
-			// turned on and the extruders paused and now it's being turned off....
-			// so go ahead and consider the platform as being used and handle the
-			// check_temp_state flag.
-			board.setUsingPlatform(true);
-#if !defined(HEATERS_ON_STEROIDS)
-			// pause extruder heaters platform is heating up
-			bool pause_state; /// avr-gcc doesn't allow cross-initializtion of variables within a switch statement
-			pause_state = !board.getPlatformHeater().isCooling();
-			check_temp_state = pause_state;
-			Motherboard::pauseHeaters(pause_state);
+static void handleQueuePointDelta() {
+	uint8_t buf[QUEUE_POINT_DELTA_MAX_LEN];
+	if (command_source.popInto(buf, commandLength(0))) {
+		// X, Y and Z are made absolute here: setTargetNewExt() adds
+		// relative axes to the planner's position, which already has
+		// the toolhead offsets, skew and live Z adjustment in it.
+		// The extruders, which have none of those, stay relative.
+		Point last = steppers::getPlannerPosition();
+		last[Z_AXIS] += steppers::z_Offset_Change;
+		int32_t xyz[3] = { last[X_AXIS], last[Y_AXIS], last[Z_AXIS] };
+		struct queue_point_new_ext_t move;
+		decodeQueuePointDelta(buf, xyz, &move);
+		LINE_NUMBER_INCR;
+		queueHostMoveOf(&move);
+	}
+}
+
+static void handlePlannerHint() {
+	// The move it's for comes next
+	struct planner_hint_t hint;
+	if (command_source.popInto((uint8_t *)&hint, sizeof(hint))) {
+		FPTYPE v = ITOFP((int32_t)hint.max_entry_speed_64);
+#ifdef FIXED
+		v >>= 6;
+#else
+		v /= 64.0;
+#endif
+		planner_hint_speed = v;
+		planner_hint_nominal_length = (hint.flags & PLANNER_HINT_NOMINAL_LENGTH) != 0;
+	}
+}
+
+static void handleQueueArc() {
+	struct queue_arc_t arc;
+	if (command_source.popInto((uint8_t *)&arc, sizeof(arc))) {
+		flushRetract();
+		mode = MOVING;
+		LINE_NUMBER_INCR;
+		queueArc(arc);
+	}
+}
+
+static void handleFirmwareRetract() {
+	struct firmware_retract_t retract;
+	if (command_source.popInto((uint8_t *)&retract, sizeof(retract))) {
+		LINE_NUMBER_INCR;
+		if ( retract.feedrate_mult_64 <= 0 )
+			retract.feedrate_mult_64 = (int16_t)(eeprom::settings.retract_feedrate_a << 6);
+		if ( ! ( retract.flags & FIRMWARE_RETRACT_UNRETRACT ) ) {
+			if ( ! retracted ) {
+				retracted = true;
+				retract_pending = true;
+				retract_steps = retract.steps;
+				retract_feedrate = retract.feedrate_mult_64;
+			}
+		} else if ( retracted ) {
+			retracted = false;
+			// One which never moved just goes
+			if ( retract_pending ) retract_pending = false;
+			else queueRetractMove(retract.steps, retract.feedrate_mult_64, true);
+		}
+	}
+}
+
+// Begins a phase in which the waits for the heaters go on alongside the
+// commands after them, or joins it, waiting there for the heaters
+static void handleConcurrent() {
+	pop8(); // remove the command code
+	LINE_NUMBER_INCR;
+	uint8_t action = pop8();
+#ifdef HEAT_WAIT_MOVES
+	if ( action == CONCURRENT_BEGIN )
+		concurrent_phase = true;
+	else if ( action == CONCURRENT_JOIN ) {
+		concurrent_phase = false;
+		if ( heat_barrier != 0 )
+			mode = WAIT_ON_BARRIER;
+	}
+#else
+	// Each wait was waited for as it came
+	(void)action;
+#endif
+}
+
+static void handleSetAdvanceProfile() {
+	pop8(); // remove the command code
+#ifdef JKN_ADVANCE
+	steppers::setAdvanceProfile(pop8());
+#else
+	pop8();
+#endif
+	LINE_NUMBER_INCR;
+}
+
+#ifdef SD_DRY_RUN
+// Moving, or the next command waits for the planner to empty before it runs
+bool waitingForMoves() {
+	if ( mode == MOVING ) return true;
+	if ( mode != READY || command_source.isEmpty() ) return false;
+	return ! ( commandFlags(command_source[0]) & ( CMD_MOVE | CMD_NO_SYNC ) );
+}
+#endif
+
+// The commands which runCommandSlice() hands to the planner ahead of the rest
+static bool isMovementCommand(uint8_t command) {
+	return ( commandFlags(command) & CMD_MOVE ) != 0;
+}
+
+// The temperature a SLAVE_CMD_SET_TEMP of temp sets the tool to, after any
+// override of the gcode's
+static int16_t toolTemperature(uint8_t toolIndex, int16_t temp) {
+	/// Handle override gcode temp
+	if (( temp ) && ( altTemp[toolIndex] ||
+			   (eeprom::settings.override_gcode_temp) ))
+	    temp = altTemp[toolIndex] ? (int16_t)altTemp[toolIndex] : eeprom::settings.preheat_temp[toolIndex];
+
+#ifdef DEBUG_NO_HEAT_NO_WAIT
+	temp  = 0;
+#endif
+	return temp;
+}
+
+// True when the tool, and the other one as well when ditto printing, has
+// nothing left to heat
+static bool toolReady(uint8_t toolIndex) {
+	Motherboard& board = Motherboard::getBoard();
+	if ( board.getExtruderBoard(toolIndex).getExtruderHeater().isHeating() )
+		return false;
+#if defined(DITTO_PRINT) && EXTRUDERS > 1
+	if ( dittoPrinting &&
+	     board.getExtruderBoard((toolIndex == 0) ? 1 : 0).getExtruderHeater().isHeating() )
+		return false;
+#endif
+	return true;
+}
+
+#ifdef HEAT_WAIT_MOVES
+
+// An extruder's A or B of a move: relative, or absolute from where it is.
+// An absolute one is taken to move while the extrusion factors apply, as
+// they change it.  A bot with one extruder has no B to move.
+static bool extruderMoves(int32_t ab, uint8_t relative, uint8_t i) {
+	if ( i >= EXTRUDERS ) return false;
+	if ( relative & (1 << (A_AXIS + i)) ) return ab != 0;
+	return steppers::alterExtrusion || ab != lastFilamentPosition[i];
+}
+
+// True unless the move at the head of the command buffer leaves the
+// extruders still.  One not yet all in the buffer is taken to move them.
+static bool moveExtrudes() {
+	uint8_t command = command_source[0];
+	uint16_t len = commandLength(0);
+	if ( len == 0 || command_source.getLength() < len )
+		return true;
+
+	switch ( command ) {
+	case HOST_CMD_QUEUE_POINT_EXT: {
+		struct queue_point_ext_t move;
+		command_source.peek((uint8_t *)&move, sizeof(move));
+		return extruderMoves(move.a, 0, 0) || extruderMoves(move.b, 0, 1);
+	}
+	case HOST_CMD_QUEUE_POINT_NEW: {
+		struct queue_point_new_t move;
+		command_source.peek((uint8_t *)&move, sizeof(move));
+		return extruderMoves(move.a, move.relative, 0) || extruderMoves(move.b, move.relative, 1);
+	}
+	case HOST_CMD_QUEUE_POINT_NEW_EXT: {
+		struct queue_point_new_ext_t move;
+		command_source.peek((uint8_t *)&move, sizeof(move));
+		return extruderMoves(move.a, move.relative, 0) || extruderMoves(move.b, move.relative, 1);
+	}
+	case HOST_CMD_QUEUE_POINT_DELTA: {
+		uint8_t buf[QUEUE_POINT_DELTA_MAX_LEN];
+		int32_t xyz[3] = { 0, 0, 0 };
+		struct queue_point_new_ext_t move;
+		command_source.peek(buf, len);
+		decodeQueuePointDelta(buf, xyz, &move);
+		return move.a != 0 || move.b != 0;
+	}
+	case HOST_CMD_QUEUE_ARC: {
+		struct queue_arc_t arc;
+		command_source.peek((uint8_t *)&arc, sizeof(arc));
+		return arc.a != 0 || arc.b != 0;
+	}
+	case HOST_CMD_PLANNER_HINT:
+	case HOST_CMD_SET_ADVANCE_PROFILE:
+		return false;
+	default:
+		// A firmware retract or unretract turns the extruder
+		return true;
+	}
+}
+
+// Takes the heaters of heat_barrier which are ready off it; true while any
+// are left
+static bool heatBarrierWaits() {
+	Motherboard& board = Motherboard::getBoard();
+	for ( uint8_t i = 0; i < EXTRUDERS; i++ )
+		if ( ( heat_barrier & (1 << i) ) && toolReady(i) )
+			heat_barrier &= ~(1 << i);
+	Heater& platform = board.getPlatformHeater();
+	if ( ! platform.isHeating() || platform.has_reached_target_temperature() )
+		heat_barrier &= ~HEAT_BARRIER_PLATFORM;
+
+	// The moves before may have taken longer than the timeout, so it only
+	// counts against a heater still not ready
+	if ( heat_barrier != 0 && tool_wait_timeout.hasElapsed() ) {
+		board.errorResponse(( heat_barrier & HEAT_BARRIER_PLATFORM ) ?
+				    PLATFORM_TIMEOUT_MSG : EXTRUDER_TIMEOUT_MSG);
+		heat_barrier = 0;
+	}
+	heat_barrier_held = heat_barrier != 0;
+	return heat_barrier_held;
+}
+
+// True while the move at the head of the command buffer must wait for the
+// heaters of heat_barrier.  One which extrudes ends a concurrent phase.
+static bool heatBarrierHolds() {
+	if ( ( heat_barrier == 0 && ! concurrent_phase ) || ! moveExtrudes() )
+		return false;
+	concurrent_phase = false;
+	return heat_barrier != 0 && heatBarrierWaits();
+}
+
+// Leaves the wait just begun to the first move which extrudes, or to the
+// join, if the settings or a concurrent phase have it so
+static void deferHeatWait(uint8_t barrier) {
+	if ( ! ( eeprom::settings.heat_wait_moves || concurrent_phase ) ||
+	     ( mode != WAIT_ON_TOOL && mode != WAIT_ON_PLATFORM ) )
+		return;
+	heat_barrier |= barrier;
+	mode = READY;
+}
+
+#endif
+
+#ifdef TOOLCHANGE_PREHEAT
+
+// The length of the command offset bytes into the command buffer, which
+// holds at least 4 bytes from there, or 0 if it's a string or unknown
+static uint16_t commandSize(uint16_t offset) {
+	if ( commandFlags(command_source[offset]) & CMD_STRING )
+		return 0;
+	return commandLength(offset);
+}
+
+// Milliseconds the move of size bytes at offset in the command buffer takes
+// at its feed rate, or 0 if it doesn't say
+static uint32_t moveMillis(uint16_t offset, uint8_t command, uint16_t size) {
+	float distance;
+	int16_t feedrate_mult_64;
+
+	if ( command == HOST_CMD_QUEUE_POINT_NEW ) {
+		struct queue_point_new_t move;
+		command_source.peek((uint8_t *)&move, sizeof(move), offset);
+		return (uint32_t)move.us / 1000;
+	}
+	else if ( command == HOST_CMD_QUEUE_POINT_NEW_EXT ) {
+		struct queue_point_new_ext_t move;
+		command_source.peek((uint8_t *)&move, sizeof(move), offset);
+		distance = move.distance;
+		feedrate_mult_64 = move.feedrate_mult_64;
+	}
+	else if ( command == HOST_CMD_QUEUE_POINT_DELTA ) {
+		struct queue_point_delta_tail_t tail;
+		command_source.peek((uint8_t *)&tail, sizeof(tail), offset + size - sizeof(tail));
+		distance = tail.distance;
+		feedrate_mult_64 = tail.feedrate_mult_64;
+	}
+	else
+		return 0;
+
+	if ( feedrate_mult_64 <= 0 || !( distance > 0.0 ) )
+		return 0;
+	return (uint32_t)(distance * 64000.0 / feedrate_mult_64);
+}
+
+// Starts the temperature raise the command buffer holds for the standby tool,
+// ahead of the next tool change, once the moves before it take no longer than
+// the heat up and TOOLCHANGE_PREHEAT seconds.  The moves sent to the planner
+// are timed by their trapezoids, and those in the command buffer by their
+// feed rates.  Moves which don't give one are taken as no time, which errs on
+// the early side.  The look ahead goes no further than the command buffer
+static void preheatStandbyTool() {
+	if ( preheat_timeout.isActive() && !preheat_timeout.hasElapsed() )
+		return;
+	preheat_timeout.start(PREHEAT_SCAN_MICROS);
+
+#if defined(DITTO_PRINT) && EXTRUDERS > 1
+	if ( dittoPrinting )
+		return;
+#endif
+
+	uint32_t run_ms, ahead_ms;
+	plan_get_motion_time(&run_ms, &ahead_ms);
+
+	uint16_t length = command_source.getLength();
+	uint16_t offset = 0;
+	while ( offset + 4 <= length ) {
+		uint8_t command = command_source[offset];
+		uint16_t size = commandSize(offset);
+		if ( size == 0 || offset + size > length || command == HOST_CMD_CHANGE_TOOL )
+			return;
+
+		if ( command == HOST_CMD_TOOL_COMMAND && size >= 6 &&
+		     command_source[offset + 2] == SLAVE_CMD_SET_TEMP &&
+		     command_source[offset + 1] != currentToolIndex ) {
+			uint8_t toolIndex = command_source[offset + 1];
+			if ( toolIndex >= EXTRUDERS )
+				return;
+
+			Motherboard& board = Motherboard::getBoard();
+			Heater& heater = board.getExtruderBoard(toolIndex).getExtruderHeater();
+			int16_t temp = toolTemperature(toolIndex, (int16_t)command_source[offset + 4] +
+						       (int16_t)( command_source[offset + 5] << 8 ));
+
+			if ( temp <= heater.get_set_temperature() || heater.isPaused() || heater.has_failed() )
+				return;
+#if !defined(HEATERS_ON_STEROIDS)
+			// It would only be paused for the platform
+			if ( board.getPlatformHeater().isHeating() )
+				return;
+#endif
+			if ( (uint32_t)(heater.secondsToHeat(temp) + TOOLCHANGE_PREHEAT) * 1000 < ahead_ms )
+				return;
+
+			heater.set_target_temperature(temp);
+			preheat_tool = toolIndex;
+			preheat_temp = temp;
+			return;
+		}
+
+		ahead_ms += moveMillis(offset, command, size);
+		offset += size;
+	}
+}
+
+#endif
+
+#ifdef POWER_LOSS_RESUME
+static bool fan_on = false;
+#endif
+
+// Sets the fan on the extra FET as SLAVE_CMD_TOGGLE_VALVE asks
+static void setFan(uint8_t fan) {
+#ifdef POWER_LOSS_RESUME
+	fan_on = fan != 0;
+#endif
+#if defined(COOLING_FAN_PWM)
+	Motherboard::setExtra(fan, true);
+#else
+	Motherboard::setExtra(fan != 0);
+#endif
+}
+
+static void setToolTemperature(uint8_t toolIndex, int16_t temp) {
+	Motherboard& board = Motherboard::getBoard();
+
+	if ( temp == 0 ) addFilamentUsed();
+
+	temp = toolTemperature(toolIndex, temp);
+
+#ifdef TOOLCHANGE_PREHEAT
+	// When preheatStandbyTool() has set it already, setting it again would
+	// start the heat up checks over
+	if ( toolIndex == preheat_tool ) {
+		preheat_tool = -1;
+		if ( temp != preheat_temp )
+			board.getExtruderBoard(toolIndex).getExtruderHeater().set_target_temperature(temp);
+	}
+	else
+#endif
+	board.getExtruderBoard(toolIndex).getExtruderHeater().set_target_temperature(temp);
+
+#if !defined(HEATERS_ON_STEROIDS)
+	/// if platform is actively heating and extruder is not cooling down, pause extruder
+	if( board.getPlatformHeater().isHeating() &&
+	    !board.getPlatformHeater().isCooling() &&
+	    !board.getExtruderBoard(toolIndex).getExtruderHeater().isCooling() ){
+		check_temp_state = true;
+		board.getExtruderBoard(toolIndex).getExtruderHeater().Pause(true);
+	}  /// else ensure extruder is not paused
+	else {
+		board.getExtruderBoard(toolIndex).getExtruderHeater().Pause(false);
+	}
+#endif
+	BOARD_STATUS_CLEAR(Motherboard::STATUS_PREHEATING);
+}
+
+static void setPlatformTemperature(int16_t temp) {
+	Motherboard& board = Motherboard::getBoard();
+
+#ifdef DEBUG_NO_HEAT_NO_WAIT
+	temp = 0;
+#endif
+	/// Handle override gcode temp
+	if (( temp ) && ( altTemp[ALTTEMP_PLATFORM_INDEX] || (eeprom::settings.override_gcode_temp) )) {
+		temp = altTemp[ALTTEMP_PLATFORM_INDEX] ? (int16_t)altTemp[ALTTEMP_PLATFORM_INDEX] : eeprom::settings.preheat_temp[2];
+	}
+
+	board.getPlatformHeater().set_target_temperature(temp);
+
+	// If we're setting the platform temp to 0 (off) then it's tempting to
+	// just bail here.  However, it may be that the platform was previously
+	// turned on and the extruders paused and now it's being turned off....
+	// so go ahead and consider the platform as being used and handle the
+	// check_temp_state flag.
+	board.setUsingPlatform(true);
+#if !defined(HEATERS_ON_STEROIDS)
+	// pause extruder heaters platform is heating up
+	bool pause_state = !board.getPlatformHeater().isCooling();
+	check_temp_state = pause_state;
+	Motherboard::pauseHeaters(pause_state);
+#endif
+	BOARD_STATUS_CLEAR(Motherboard::STATUS_PREHEATING);
+}
+
+// Carries out one of the planner's actions, now that the moves before it are done
+static void runAction(const plan_action_t *action) {
+	int16_t temp = (int16_t)action->arg[1] + (int16_t)( action->arg[2] << 8 );
+
+#ifdef SD_DRY_RUN
+	// The heaters and fans are left as they are
+	if ( dryrun::isRunning() ) return;
+#endif
+
+	switch ( action->type ) {
+	case PLAN_ACTION_FAN:
+		setFan(action->arg[0]);
+		break;
+	case PLAN_ACTION_TOOL_FAN:
+		Motherboard::getBoard().getExtruderBoard(action->arg[0]).setFan(action->arg[1]);
+		break;
+	case PLAN_ACTION_TOOL_TEMP:
+		setToolTemperature(action->arg[0], temp);
+		break;
+	case PLAN_ACTION_PLATFORM_TEMP:
+		setPlatformTemperature(temp);
+		break;
+#ifdef HAS_RGB_LED
+	case PLAN_ACTION_RGB_LED:
+		RGB_LED::setCustomColor(action->arg[0], action->arg[1], action->arg[2]);
+		break;
+#endif
+	case PLAN_ACTION_PAUSE:
+		if ( isPaused() == 0 )
+			host::pauseBuild(true, false);
+		break;
+#ifdef POWER_LOSS_RESUME
+	case PLAN_ACTION_CHECKPOINT:
+		checkpoint::commit(fan_on);
+		break;
+#endif
+#ifdef LAYER_LOG
+	case PLAN_ACTION_LAYER:
+		layerlog::layerDone((uint32_t)action->arg[0] | ((uint32_t)action->arg[1] << 8) |
+				    ((uint32_t)action->arg[2] << 16));
+		break;
+#endif
+	}
+}
+
+static void runActions() {
+	plan_action_t action;
+	while ( plan_take_action(&action) )
+		runAction(&action);
+}
+
+// Has the action carried out once the moves read ahead of it are done, rather
+// than as it's read, while they're still in the planner; straight away when
+// there are none.  Callers wait for plan_action_room() before they read the
+// command, so its turn never comes before theirs.
+static void queueAction(const plan_action_t *action) {
+	if ( !plan_queue_action(action) ) {
+		runActions();
+		runAction(action);
+	}
+}
+
+static void queueAction(uint8_t type, uint8_t arg0, uint8_t arg1 = 0, uint8_t arg2 = 0) {
+	plan_action_t action;
+	action.type = type;
+	action.arg[0] = arg0;
+	action.arg[1] = arg1;
+	action.arg[2] = arg2;
+	queueAction(&action);
+}
+
+//If overrideToolIndex = -1, the toolIndex specified in the packet is used, otherwise
+//the toolIndex specified by overrideToolIndex is used
+
+bool processExtruderCommandPacket(int8_t overrideToolIndex) {
+	//command_buffer[0] is the command code, i.e. HOST_CMD_TOOL_COMMAND
+
+	//Handle the tool index and override it if we need to
+	uint8_t toolIndex = command_source[1];
+	if ( overrideToolIndex != -1 )  toolIndex = (uint8_t)overrideToolIndex;
+
+	uint8_t command = command_source[2];
+	//command_buffer[3] - Payload length
+
+		switch (command) {
+		case SLAVE_CMD_SET_TEMP:
+			queueAction(PLAN_ACTION_TOOL_TEMP, toolIndex, command_source[4], command_source[5]);
+			return true;
+		// can be removed in process via host query works OK
+ 		case SLAVE_CMD_PAUSE_UNPAUSE:
+			host::pauseBuild(command::isPaused() == 0, false);
+			return true;
+		case SLAVE_CMD_TOGGLE_FAN:
+			queueAction(PLAN_ACTION_TOOL_FAN, toolIndex, command_source[4] & 0x01);
+			return true;
+		case SLAVE_CMD_TOGGLE_VALVE:
+#if defined(COOLING_FAN_PWM)
+			queueAction(PLAN_ACTION_FAN, command_source[4]);
+#else
+			queueAction(PLAN_ACTION_FAN, command_source[4] & 0x01);
 #endif
-			BOARD_STATUS_CLEAR(Motherboard::STATUS_PREHEATING);
+			return true;
+		case SLAVE_CMD_SET_PLATFORM_TEMP:
+			if ( !eeprom::hasHBP() ) return true;
+			queueAction(PLAN_ACTION_PLATFORM_TEMP, 0, command_source[4], command_source[5]);
 			return true;
         // not being used with 5D
 		case SLAVE_CMD_TOGGLE_MOTOR_1:
@@ -1054,11 +2414,26 @@ void handlePauseState(void) {
 		//If we're heating, the digi pots might be turned down, save them and
 		//turn the pots to full on
 		saveDigiPotsAndPower(true);
+#ifdef FAST_PAUSE
+		//Rather than drain it, stop where we are in the pipeline
+		steppers::stopMidMove();
+#endif
 		break;
 
 	case PAUSE_STATE_ENTER_WAIT_PIPELINE_DRAIN:
+#ifdef FAST_PAUSE
+		//Wait for the steppers to stop, then set the rest of the pipeline
+		//aside until we resume
+		if (steppers::parkStoppedMoves()) {
+#if defined(FAST_CANCEL)
+			//Nothing set aside comes back after a cancel
+			if ( fastCancelling )
+				steppers::discardParkedMoves();
+#endif
+#else
 		//Wait for the pipeline to drain
-		if (movesplanned() == 0) {
+		if (movesplanned() == 0 && MOVE_QUEUE_EMPTY) {
+#endif
 			paused = PAUSE_STATE_ENTER_START_RETRACT_FILAMENT;
 		}
 		break;
@@ -1070,6 +2445,11 @@ void handlePauseState(void) {
 		//Retract the filament by 1mm to prevent blobbing
 		retractFilament(true);
 		paused = PAUSE_STATE_ENTER_WAIT_RETRACT_FILAMENT;
+#ifdef FAST_CANCEL
+		//Plan the platform clear behind it rather than waiting
+		if ( fastCancelling )
+			paused = PAUSE_STATE_ENTER_START_CLEARING_PLATFORM;
+#endif
 		break;
 
 	case PAUSE_STATE_ENTER_WAIT_RETRACT_FILAMENT:
@@ -1108,8 +2488,13 @@ void handlePauseState(void) {
 
 		    //If we're pausing, and we have HEAT_DURING_PAUSE switched off, switch off the heaters
 		    //if (( ! cancelling ) && ( ! (eeprom::getEeprom8(eeprom_offsets::HEAT_DURING_PAUSE, DEFAULT_HEAT_DURING_PAUSE) )))
-		    if ( coldPause || !(eeprom::getEeprom8(eeprom_offsets::HEAT_DURING_PAUSE, DEFAULT_HEAT_DURING_PAUSE)) )
+		    if ( coldPause || !eeprom::settings.heat_during_pause )
 			heatersOff();
+#ifdef FAST_CANCEL
+		    //Left until the retract was planned, which needs them hot
+		    else if ( fastCancelling )
+			heatersOff();
+#endif
 		    if ( coldPause ) {
 #ifdef HAS_RGB_LED
 			    RGB_LED::setColor(0, 0, 0);
@@ -1146,133 +2531,1182 @@ void handlePauseState(void) {
 		//We switch digi pots to low during heating
 		saveDigiPotsAndPower(false);
 
-		Motherboard& board = Motherboard::getBoard();
+#ifdef FAST_PAUSE
+		//If the pause is left before it got going, so are the moves
+		steppers::cancelStopMidMove();
+#endif
+
+		Motherboard& board = Motherboard::getBoard();
+
+		int16_t platform_temp = altTemp[ALTTEMP_PLATFORM_INDEX] ? (int16_t)altTemp[ALTTEMP_PLATFORM_INDEX] : pausedPlatformTemp;
+		if ( platform_temp > 0 ) {
+			board.getPlatformHeater().Pause(false);
+			board.getPlatformHeater().set_target_temperature(platform_temp);
+		}
+
+		int16_t temp = altTemp[0] ? (int16_t)altTemp[0] : pausedExtruderTemp[0];
+		if ( temp > 0 ) {
+			board.getExtruderBoard(0).getExtruderHeater().Pause(false);
+			board.getExtruderBoard(0).getExtruderHeater().set_target_temperature(temp);
+#if !defined(HEATERS_ON_STEROIDS)
+			if ( platform_temp > 0 )
+				board.getExtruderBoard(0).getExtruderHeater().Pause(true);
+#endif
+		}
+#if EXTRUDERS > 1
+		temp = altTemp[1] ? (int16_t)altTemp[1] : pausedExtruderTemp[1];
+		if ( temp > 0 ) {
+			board.getExtruderBoard(1).getExtruderHeater().Pause(false);
+			board.getExtruderBoard(1).getExtruderHeater().set_target_temperature(temp);
+#if !defined(HEATERS_ON_STEROIDS)
+			if ( platform_temp > 0 )
+				board.getExtruderBoard(1).getExtruderHeater().Pause(true);
+#endif
+		}
+#endif // EXTRUDERS > 1
+
+		paused = PAUSE_STATE_EXIT_WAIT_FOR_PLATFORM_HEATER;
+		break;
+	}
+
+	case PAUSE_STATE_EXIT_WAIT_FOR_PLATFORM_HEATER:
+		//Waiting for the platform heater to reach it's set point
+		if (( pausedPlatformTemp > 0 ) && ( ! Motherboard::getBoard().getPlatformHeater().has_reached_target_temperature() ))
+			break;
+		paused = PAUSE_STATE_EXIT_WAIT_FOR_TOOLHEAD_HEATERS;
+		break;
+
+	case PAUSE_STATE_EXIT_WAIT_FOR_TOOLHEAD_HEATERS:
+		if (( pausedExtruderTemp[0] > 0 ) && ( ! Motherboard::getBoard().getExtruderBoard(0).getExtruderHeater().has_reached_target_temperature() ))
+			break;
+#if EXTRUDERS > 1
+		if (( pausedExtruderTemp[1] > 0 ) && ( ! Motherboard::getBoard().getExtruderBoard(1).getExtruderHeater().has_reached_target_temperature() ))
+			break;
+#endif
+
+		restoreDigiPots();
+
+		paused = PAUSE_STATE_EXIT_START_RETURNING_PLATFORM;
+		break;
+
+	case PAUSE_STATE_EXIT_START_RETURNING_PLATFORM:
+		//Instruct the platform to return to it's pre pause position
+
+		//If we're heating, the digi pots might be turned down, save them and switch them high
+		saveDigiPotsAndPower(true);
+
+		platformAccess(false);
+		paused = PAUSE_STATE_EXIT_WAIT_RETURNING_PLATFORM;
+		displayStatusMessage(PAUSE_LEAVE_MSG, PAUSE_RESUMING_POSITION_MSG, true);
+		break;
+
+	case PAUSE_STATE_EXIT_WAIT_RETURNING_PLATFORM:
+		//Wait for the platform to finish moving to it's prepause position
+		if (movesplanned() == 0)
+			paused = PAUSE_STATE_EXIT_START_UNRETRACT_FILAMENT;
+		break;
+
+	case PAUSE_STATE_EXIT_START_UNRETRACT_FILAMENT:
+		retractFilament(false);
+		paused = PAUSE_STATE_EXIT_WAIT_UNRETRACT_FILAMENT;
+		break;
+
+	case PAUSE_STATE_EXIT_WAIT_UNRETRACT_FILAMENT:
+		//Wait for the filament unretraction to finish
+		//then resume processing commands
+		if (movesplanned() == 0) {
+#ifdef FAST_PAUSE
+			//Carry on from where we stopped
+			steppers::resumeParkedMoves();
+#endif
+		        Motherboard::getBoard().setExtra(pausedFanState);
+			restoreDigiPots();
+			removeStatusMessage();
+			paused = PAUSE_STATE_NONE;
+			pauseErrorMessage = 0;
+#if defined(PSTOP_SUPPORT)
+			pstop_triggered = false;
+#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
+			zprobe_stop_triggered = false;
+#endif
+#endif
+		}
+		break;
+
+        case PAUSE_STATE_ERROR:
+		removeStatusMessage();
+		// Need to set incomplete true so that isWaiting() will be true for the
+		// message screen.  That, in turn, keeps InterfaceBoard::doUpdate() from
+		// clearing the message when it sees that the build has finished.
+	        Motherboard::getBoard().errorResponse(pauseErrorMessage, false, true);
+		sdcard::finishPlayback();
+#ifdef FAST_PAUSE
+		steppers::discardParkedMoves();
+#endif
+	        pauseErrorMessage = 0;
+		sdCardError = false;
+	        paused = PAUSE_STATE_NONE;
+	        break;
+
+        case PAUSE_STATE_MSG_PAUSED:
+		removeStatusMessage();
+		// Need to set incomplete true so that isWaiting() will be true for the
+		// message screen.  That, in turn, keeps InterfaceBoard::doUpdate() from
+		// clearing the message when it sees that the build has finished.
+	        Motherboard::getBoard().errorResponse(pauseErrorMessage, false, true);
+	        paused = PAUSE_STATE_PAUSED;
+	        break;
+
+	default:
+		break;
+   }
+}
+
+// Starts the next phase of the home of home_flags
+static void startHomingPhase() {
+	bool maximums = home_command == HOST_CMD_FIND_AXES_MAXIMUM;
+
+	homing_timeout.start(home_timeout_s * 1000L * 1000L);
+	if ( home_phase == HOME_FAST ) {
+		home_fast_axes = steppers::startHomingFast(maximums, home_flags, home_feedrate);
+		home_phase = home_fast_axes ? HOME_BACKOFF : HOME_SLOW;
+		if ( home_fast_axes )
+			return;
+	}
+	if ( home_phase == HOME_BACKOFF ) {
+		steppers::startHomingBackoff(maximums, home_fast_axes);
+		home_phase = HOME_SLOW;
+		return;
+	}
+	steppers::startHoming(maximums, home_flags, home_feedrate);
+	home_phase = HOME_DONE;
+}
+
+// A fast slice for processing commands and refilling the stepper queue, etc.
+static void handleChangeTool() {
+	pop8(); // remove the command code
+#if EXTRUDERS > 1
+	currentToolIndex = pop8();
+	steppers::changeToolIndex(currentToolIndex);
+#else
+	pop8();
+#endif
+	LINE_NUMBER_INCR;
+}
+
+static void handleEnableAxes() {
+	pop8(); // remove the command code
+	uint8_t axes = pop8();
+	LINE_NUMBER_INCR;
+
+#if defined(DITTO_PRINT) && EXTRUDERS > 1
+	if ( dittoPrinting ) {
+		if ( currentToolIndex == 0 ) {
+			//Set B to be the same as A
+			axes &= ~(_BV(B_AXIS));
+			if ( axes & _BV(A_AXIS) )	axes |= _BV(B_AXIS);
+		} else {
+			//Set A to be the same as B
+			axes &= ~(_BV(A_AXIS));
+			if ( axes & _BV(B_AXIS) )	axes |= _BV(A_AXIS);
+		}
+	}
+#endif
+	steppers::enableAxes(axes, (axes & 0x80) != 0);
+}
+
+static void handleSetPositionExt() {
+	pop8(); // remove the command code
+	int32_t x = pop32();
+	int32_t y = pop32();
+	int32_t z = pop32();
+	int32_t a = pop32();
+#if EXTRUDERS > 1
+	int32_t b = pop32();
+#else
+	pop32();
+#endif
+
+#if defined(DITTO_PRINT) && EXTRUDERS > 1
+	if ( dittoPrinting ) {
+		if ( currentToolIndex == 0 )	b = a;
+		else				a = b;
+	}
+#endif
+
+	lastFilamentPosition[0] = a;
+#if EXTRUDERS > 1
+	lastFilamentPosition[1] = b;
+#endif
+	LINE_NUMBER_INCR;
+
+	Point newPoint = Point(STEPPERS_(x,y,z,a,b));
+#if defined(AUTO_LEVEL)
+	alevel_update(newPoint);
+#endif
+	steppers::definePosition(newPoint, false);
+}
+
+static void handleDelay() {
+	mode = DELAY;
+	pop8(); // remove the command code
+	// parameter is in milliseconds; timeouts need microseconds
+	uint32_t microseconds = pop32() * 1000L;
+	LINE_NUMBER_INCR;
+
+	delay_timeout.start(microseconds);
+}
+
+static void handlePauseForButton() {
+	pop8(); // remove the command code
+	button_mask = pop8();
+	uint16_t timeout_seconds = pop16();
+	button_timeout_behavior = pop8();
+	LINE_NUMBER_INCR;
+
+	if (timeout_seconds != 0) {
+		button_wait_timeout.start(timeout_seconds * 1000L * 1000L);
+	} else {
+		button_wait_timeout = Timeout();
+	}
+	// set button wait via interface board
+	Motherboard::interfaceBlinkOn();
+	InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
+	ib.waitForButton(button_mask);
+	BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
+	mode = WAIT_ON_BUTTON;
+}
+
+static void handleDisplayMessage() {
+#if defined(COOLING_FAN_PWM_ON_DISPLAY)
+	if (command_buffer[5] == 'F' && command_buffer[6] == '\0') {
+		pop32(); // remove the command code, xpos, ypos, options
+		uint8_t timeout_seconds = pop8();
+		pop16(); // discard message
+		fan_pwm_override = true;
+		fan_pwm_override_value = timeout_seconds;
+
+		// On at the new duty, along with the moves after it
+		queueAction(PLAN_ACTION_FAN, 1);
+		LINE_NUMBER_INCR;
+		return;
+	}
+#endif
+	MessageScreen* scr = Motherboard::getBoard().getMessageScreen();
+	pop8(); // remove the command code
+	uint8_t options = pop8();
+	uint8_t xpos = pop8();
+	uint8_t ypos = pop8();
+	uint8_t timeout_seconds = pop8();
+	LINE_NUMBER_INCR;
+
+	// check message clear bit
+	if ((options & (1 << 0)) == 0) { scr->clearMessage(); }
+	// set position and add message
+	scr->setXY(xpos, ypos);
+	scr->addMessage(command_buffer);
+
+	// push message screen if the full message has been recieved
+	if ((options & (1 << 1))) {
+		InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
+		if (ib.getCurrentScreen() != scr) {
+			ib.pushScreen(scr);
+		}
+		else {
+			scr->refreshScreen();
+		}
+		// set message timeout if not a buttonWait call
+		if ((timeout_seconds != 0) && (!(options & (1 << 2)))) {
+			scr->setTimeout(timeout_seconds);//, true);
+		}
+
+		if (options & (1 << 2)) { // button wait bit --> start button wait
+			if (timeout_seconds != 0) {
+				button_wait_timeout.start(timeout_seconds * 1000L * 1000L);
+			}
+			else {
+				button_wait_timeout = Timeout();
+			}
+			button_mask = (1 << ButtonArray::CENTER);  // center button
+			button_timeout_behavior &= (1 << BUTTON_CLEAR_SCREEN);
+			Motherboard::interfaceBlinkOn();
+			InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
+			ib.waitForButton(button_mask);
+			BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
+			mode = WAIT_ON_BUTTON;
+		}
+	}
+}
+
+static void handleFindAxes() {
+	uint8_t command = pop8();
+	uint8_t flags = pop8();
+	uint32_t feedrate = pop32(); // feedrate in us per step
+	uint16_t timeout_s = pop16();
+	LINE_NUMBER_INCR;
+
+#ifdef SD_DRY_RUN
+	// With no moves made there's nothing to stop at the endstops, and the
+	// file sets the position it wants afterwards
+	if ( dryrun::isRunning() ) return;
+#endif
+
+#if defined(CALCULATE_HOMING_TIMEOUT)
+	// for bigger machines, we have longer axis, and it may take more time
+	// to home. since MakerBot Desktop and ReplicatorG doesn't have a
+	// convinient way to set homing timeout, we just ignore the timeout
+	// in command and re-calculate the optimal timeout according to axis
+	// length and feedrate.
+	//   timeout = axis_length / (feedrate / 5) * 125%
+	// for example, a 200mm axis with homing feedrate 10mm/s will timeout
+	// in 200mm / 10mm/s * 125% = 25s.
+	for (int axis = 0;axis < STEPPER_COUNT;++axis) {
+		// check the flag this way to avoid tabbing the code to the right
+		// to the screen......
+		if (!(flags & (1 << axis)))
+			continue;
+
+		// axis length in steps
+		int32_t axis_length = stepperAxis[axis].max_axis_steps_limit - stepperAxis[axis].min_axis_steps_limit;
+		if (axis_length < 0)
+			axis_length = -axis_length;
+
+		// us per step
+		uint32_t max_feedrate = stepperAxis[axis].min_interval * 5;
+		if (feedrate < max_feedrate)
+			feedrate = max_feedrate;
+
+		uint32_t optimal_timeout = (uint16_t)(axis_length * feedrate * 2 / 1000L / 1000L * 1.25);
+		if (timeout_s < optimal_timeout)
+			timeout_s = optimal_timeout;
+	}
+#endif
+
+#if KINEMATICS_MIXED_MASK
+	if (((1 << X_AXIS) | (1 << Y_AXIS)) == (flags & ((1 << X_AXIS) | (1 << Y_AXIS)))) {
+	     flags &= ~(1 << Y_AXIS);
+	     home_again     = true;
+	}
+	else
+	     home_again = false;
+#endif
+	//bool direction = command == HOST_CMD_FIND_AXES_MAXIMUM;
+#if defined(PSTOP_OKAY)
+	// Helpful at end of print
+	// Especially with filament detectors
+	// with timeouts that are fooled by
+	// end gcode which homes, sends Z
+	// to bottom, then plays a song.
+	pstop_okay = false;
+#endif
+#if defined(AUTO_LEVEL)
+	probe_active = false;
+#endif
+	mode = HOMING;
+	home_command   = command;
+	home_flags     = flags;
+	home_feedrate  = feedrate;
+	home_timeout_s = timeout_s;
+	home_phase     = HOME_FAST;
+	startHomingPhase();
+}
+
+static void handleWaitForTool() {
+#ifdef DEBUG_NO_HEAT_NO_WAIT
+	mode = READY;
+#else
+	mode = WAIT_ON_TOOL;
+#endif
+#if defined(PSTOP_SUPPORT)
+	// Assume that by now coordinates are set
+	pstop_okay = true;
+#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
+	zprobe_hits = 0;
+#endif
+#endif
+	pop8();
+	currentToolIndex = pop8();
+	pop16();	//uint16_t toolPingDelay
+	uint16_t toolTimeout = (uint16_t)pop16();
+	LINE_NUMBER_INCR;
+	// if we re-add handling of toolTimeout, we need to make sure
+	// that values that overflow our counter will not be passed)
+	tool_wait_timeout.start(toolTimeout*1000000L);
+#ifdef HEAT_WAIT_MOVES
+	deferHeatWait(1 << currentToolIndex);
+#endif
+}
+
+// FIXME: Almost equivalent to WAIT_FOR_TOOL
+static void handleWaitForPlatform() {
+#ifdef DEBUG_NO_HEAT_NO_WAIT
+	mode = READY;
+#else
+	mode = WAIT_ON_PLATFORM;
+#endif
+#if defined(PSTOP_SUPPORT)
+	// Assume that by now coordinates are set
+	pstop_okay = true;
+#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
+	zprobe_hits = 0;
+#endif
+#endif
+	pop8();
+	pop8();	//uint8_t currentToolIndex
+	pop16(); //uint16_t toolPingDelay
+	uint16_t toolTimeout = (uint16_t)pop16();
+	LINE_NUMBER_INCR;
+	// if we re-add handling of toolTimeout, we need to make sure
+	// that values that overflow our counter will not be passed)
+	tool_wait_timeout.start(toolTimeout*1000000L);
+#ifdef HEAT_WAIT_MOVES
+	deferHeatWait(HEAT_BARRIER_PLATFORM);
+#endif
+}
+
+#if defined(AUTO_LEVEL)
+// The point under the probe, with the nozzle at at
+static void alevelProbePoint(int32_t *position, const Point& at) {
+	int32_t poffset[2];
+	cli();
+	eeprom::readBlock(poffset, (void*)eeprom_offsets::ALEVEL_PROBE_OFFSETS,
+			  2 * sizeof(int32_t));
+	sei();
+	position[0] = at[X_AXIS] + poffset[0];
+	position[1] = at[Y_AXIS] + poffset[1];
+	position[2] = at[Z_AXIS];
+}
+
+// Records point idx, 0 - 2, of the skew
+static void alevelRecordSkew(uint8_t idx, const int32_t *position) {
+	alevel_state |= 1 << idx;
+	cli();
+	eeprom::writeBlock(
+		position,
+		(char *)eeprom_offsets::ALEVEL_P1 + idx * 3 * sizeof(int32_t),
+		3 * sizeof(int32_t));
+	sei();
+}
+
+#if defined(AUTO_LEVEL_MESH)
+// Records point idx of the mesh.  Noted so that a translation part way
+// through starts over
+static void alevelRecordMesh(uint8_t idx, const int32_t *position) {
+	if ( mesh_record(idx, position) ) alevel_state |= 16;
+	else alevel_state &= ~16;
+}
+#endif
+#endif
+
+static void handleStoreHomePosition() {
+	pop8();
+	uint8_t axes = pop8();
+	LINE_NUMBER_INCR;
+
+	// Go through each axis, and if that axis is specified, read it's value,
+	// then record it to the eeprom.
+	Point currentPoint = steppers::getPlannerPosition();
+#if !defined(AUTO_LEVEL)
+	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
+#else
+	for (uint8_t i = 0; i <= Z_AXIS; i++) {
+#endif
+		if ( axes & (1 << i) ) {
+		     uint16_t offset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + i * 4;
+			uint32_t position = currentPoint[i];
+			cli();
+			eeprom::writeBlock(&position, (void*) offset, 4);
+			sei();
+		}
+	}
+#if defined(AUTO_LEVEL)
+	// Trigger only for A, B, or A & B
+	// Do not trigger if any of X, Y, or Z was specified
+	if ((axes) && (axes == (axes & ((1 << A_AXIS) | (1 << B_AXIS))))) {
+	     uint8_t idx;
+	     switch(axes) {
+	     case (1 << A_AXIS) : idx = 0; break;
+	     case (1 << B_AXIS) : idx = 1; break;
+	     default: idx = 2; break;
+	     }
+	     int32_t position[3];
+	     alevelProbePoint(position, currentPoint);
+	     alevelRecordSkew(idx, position);
+	}
+#endif
+}
+
+static void handleRecallHomePosition() {
+	pop8();
+	uint8_t axes = pop8();
+	LINE_NUMBER_INCR;
+
+	Point newPoint = steppers::getPlannerPosition();
+#if defined(AUTO_LEVEL)
+	// Trigger only for A & B
+	// Do not trigger if any of X, Y, or Z was specified
+	if ( axes == ((1 << A_AXIS) | (1 << B_AXIS)) ) {
+	     // M132 AB -- initialize and enable skew
+	     // alevel_state must have bits 0, 1, and 2 set
+	     uint8_t alevel_valid = 1;
+	     if ( 7 == (alevel_state & 7) ) {
+		  // Attempt to enable auto-level
+		  auto_level_t alevel_data;
+		  int32_t zhome;
+		  uint32_t zhoffset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
+		       sizeof(int32_t) * (Z_AXIS);
+		  cli();
+		  eeprom::readBlock(&zhome, (void *)zhoffset, sizeof(int32_t));
+		  eeprom::readBlock(&alevel_data, (void *)eeprom_offsets::ALEVEL_FLAGS,
+				    sizeof(alevel_data));
+		  sei();
+#if defined(AUTO_LEVEL_ZYYX)
+		  if ( zhome != 0 ) {
+#endif
+		       if ( alevel_data.max_zdelta <= 0 )
+			    alevel_data.max_zdelta = ALEVEL_MAX_ZDELTA_DEFAULT;
+#if defined(AUTO_LEVEL_MESH)
+		       mesh_deinit();
+#endif
+		       if ( skew_init(alevel_data.max_zdelta, zhome,
+				      alevel_data.p1, alevel_data.p2,
+				      alevel_data.p3) ) {
+			    alevel_valid = 0;
+			    alevel_state |= 8;
+		       }
+		       else
+			    alevel_valid = 2;
+#if defined(AUTO_LEVEL_ZYYX)
+		  }
+		  else
+		       alevel_valid = 3;
+#endif
+	     }
+	     cli();
+	     eeprom::writeByte((uint8_t *)eeprom_offsets::ALEVEL_FLAGS,
+			       alevel_valid ? 1 : 0);
+	     sei();
+	     if ( alevel_valid ) {
+		  // Cancel the build!
+		  if ( alevel_valid == 1 )
+		       pauseErrorMessage = ALEVEL_INCOMPLETE_MSG;
+#if defined(AUTO_LEVEL_ZYYX)
+		  else if ( alevel_valid == 3 )
+		       pauseErrorMessage = ALEVEL_NOT_CALIBRATED_MSG;
+#endif
+		  else
+		       pauseErrorMessage = ( skew_status() == ALEVEL_COLINEAR )
+			    ? ALEVEL_COLINEAR_MSG : ALEVEL_BADLEVEL_MSG;
+
+
+		  // Now cancel the build
+		  cancelMidBuild();
+	     }
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
+	     else
+		 {
+			//those are not saved, so in case of reboot everything will be as usual
+			steppers::disableZMinEnd(true);
+		}
+#endif
+		steppers::z_Offset_Change=0;//we reset the gap to ZERO to avoid summing it next time we do a movement
+	}
+	else if ( axes == (1 << A_AXIS) ) {
+	     // Trigger only for A
+	     // Do not trigger if any of X, Y, or Z was specified
+
+	     // M132 A -- check skew data and cancel build if delta is lower than threshold, for calibration script only
+	     // alevel_state must have bits 0, 1, and 2 set
+	     auto_level_t alevel_data;
+	     int32_t zhome;
+	     uint32_t zhoffset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
+		  sizeof(int32_t) * (Z_AXIS);
+	     cli();
+	     eeprom::readBlock(&zhome, (void *)zhoffset, sizeof(int32_t));
+	     eeprom::readBlock(&alevel_data, (void *)eeprom_offsets::ALEVEL_FLAGS,
+			       sizeof(alevel_data));
+	     sei();
+
+	     alevel_data.max_zdelta = ALEVEL_MAX_ZDELTA_CALIBRATED;
+	     if ( skew_check(alevel_data.max_zdelta,
+			     alevel_data.p1, alevel_data.p2,
+			     alevel_data.p3) )
+		  displayStatusMessage(ALEVEL_GOOD_MSG,ALEVEL_MSG2, false);
+	     else
+		  displayStatusMessage(ALEVEL_FAIL_MSG,ALEVEL_MSG2, false);
+
+	     button_wait_timeout = Timeout();
+	     button_mask = (1 << ButtonArray::CENTER);  // center button
+	     button_timeout_behavior &= (1 << BUTTON_CLEAR_SCREEN);
+	     Motherboard::interfaceBlinkOn();
+	     InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
+	     ib.waitForButton(button_mask);
+	     BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
+	     mode = WAIT_ON_BUTTON;
+	}
+	else if ( axes == (1 << B_AXIS) ) {
+	     //ZYYX modified, added M132 B -- disable skew
+	     skew_deinit();
+#if defined(AUTO_LEVEL_MESH)
+	     mesh_deinit();
+#endif
+	}
+	else {
+#endif
+	     for (uint8_t i = 0; i <= Z_AXIS; i++) {
+		  if ( axes & (1 << i) ) {
+		       uint16_t offset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + 4*i;
+		       cli();
+		       eeprom::readBlock(&(newPoint[i]), (void*) offset, 4);
+		       sei();
+		  }
+	     }
+
+	     lastFilamentPosition[0] = newPoint[A_AXIS];
+#if EXTRUDERS > 1
+	     lastFilamentPosition[1] = newPoint[B_AXIS];
+#endif
+#if defined(AUTO_LEVEL)
+	// If we've jumped through all the hoops and successfully initialized
+	// auto-leveling, then we need to update the skew transform as we may be
+	// translating our X, Y, or Z coordinates.
+	alevel_update(newPoint);
+#endif
+	steppers::definePosition(newPoint, true);
+#if defined(AUTO_LEVEL)
+	}
+#endif
+}
+
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+static void handleMeshLevel() {
+	pop8(); // remove the command code
+	uint8_t action = pop8();
+	uint8_t idx = pop8();
+	LINE_NUMBER_INCR;
+
+	if ( action == 0 ) {
+	     // Record the point under the probe, as M131 does
+	     int32_t position[3];
+	     alevelProbePoint(position, steppers::getPlannerPosition());
+	     alevelRecordMesh(idx, position);
+	}
+	else if ( action == 1 ) {
+	     // Enable with the mesh in EEPROM, which needn't have
+	     // been probed during this build
+	     auto_level_t alevel_data;
+	     int32_t zhome;
+	     uint32_t zhoffset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
+		  sizeof(int32_t) * (Z_AXIS);
+	     cli();
+	     eeprom::readBlock(&zhome, (void *)zhoffset, sizeof(int32_t));
+	     eeprom::readBlock(&alevel_data, (void *)eeprom_offsets::ALEVEL_FLAGS,
+			       sizeof(alevel_data));
+	     sei();
+	     if ( alevel_data.max_zdelta <= 0 )
+		  alevel_data.max_zdelta = ALEVEL_MAX_ZDELTA_DEFAULT;
+	     skew_deinit();
+	     if ( mesh_init(alevel_data.max_zdelta, zhome) ) {
+		  alevel_state = 8;
+#if defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
+		  steppers::disableZMinEnd(true);
+#endif
+	     }
+	     else {
+		  if ( mesh_status() == ALEVEL_NOT_ACTIVE )
+		       pauseErrorMessage = ALEVEL_INCOMPLETE_MSG;
+		  else
+		       pauseErrorMessage = ( mesh_status() == ALEVEL_COLINEAR )
+			    ? ALEVEL_COLINEAR_MSG : ALEVEL_BADLEVEL_MSG;
+		  cancelMidBuild();
+	     }
+	     steppers::z_Offset_Change = 0;
+	}
+	else if ( action == 2 ) {
+	     mesh_deinit();
+	     alevel_state &= ~8;
+	}
+}
+#endif
+
+#if defined(AUTO_LEVEL)
+static void handleProbePoint() {
+	pop8(); // remove the command code
+	probe_point = pop8();
+	int32_t x = pop32();
+	int32_t y = pop32();
+	uint32_t feedrate = pop32(); // feedrate in us per step
+	uint16_t timeout_s = pop16();
+	probe_tolerance = pop16();
+	probe_touches = pop8();
+	LINE_NUMBER_INCR;
+
+#ifdef SD_DRY_RUN
+	if ( dryrun::isRunning() ) return;
+#endif
+
+	if ( probe_touches == 0 ) probe_touches = 1;
+	probe_count = 0;
+	probe_sum = 0;
+	probe_active = true;
+
+	// The first touch starts, fast, once the travel is done
+	steppers::startProbeTravel(x, y);
+#if KINEMATICS_MIXED_MASK
+	home_again = false;
+#endif
+	mode = HOMING;
+	home_command   = HOST_CMD_FIND_AXES_MINIMUM;
+	home_flags     = 1 << Z_AXIS;
+	home_feedrate  = feedrate;
+	home_timeout_s = timeout_s;
+	home_phase     = HOME_FAST;
+	homing_timeout.start(timeout_s * 1000L * 1000L);
+}
+
+// Takes up a touch of the HOST_CMD_PROBE_POINT and backs off from it, then
+// touches again unless the touches so far are within the tolerance or
+// there have been enough of them.  The last backing off leaves the probe
+// clear for the travel to the next point.
+static void probeTouched() {
+	Point at = steppers::getPlannerPosition();
+	int32_t z = at[Z_AXIS];
+	if ( probe_count == 0 || z < probe_min ) probe_min = z;
+	if ( probe_count == 0 || z > probe_max ) probe_max = z;
+	probe_sum += z;
+	probe_count ++;
+
+	steppers::startHomingBackoff(false, 1 << Z_AXIS);
+	if ( probe_count < probe_touches &&
+	     ( probe_count < 2 || (uint32_t)(probe_max - probe_min) > probe_tolerance )) {
+		home_phase = HOME_SLOW;
+		return;
+	}
+	probe_active = false;
+
+	int32_t position[3];
+	alevelProbePoint(position, at);
+	position[2] = probe_sum / probe_count;
+#if defined(AUTO_LEVEL_MESH)
+	if ( probe_point & PROBE_POINT_MESH ) {
+		alevelRecordMesh(probe_point & ~PROBE_POINT_MESH, position);
+		return;
+	}
+#endif
+	if ( probe_point <= 2 )
+		alevelRecordSkew(probe_point, position);
+}
+#endif
+
+static void handleSetPotValue() {
+	pop8(); // remove the command code
+	uint8_t axis = pop8();
+	uint8_t value = pop8();
+	LINE_NUMBER_INCR;
+	steppers::setAxisPotValue(axis, value);
+}
+
+static void handleSetRGBLed() {
+	pop8(); // remove the command code
+
+#ifdef HAS_RGB_LED
+	uint8_t red = pop8();
+	uint8_t green = pop8();
+	uint8_t blue = pop8();
+#else
+	pop8();
+	pop8();
+	pop8();
+#endif
+	pop8(); // uint8_t blink_rate = pop8();
+	pop8();	//uint8_t effect
+	LINE_NUMBER_INCR;
+	// RGB_LED::setLEDBlink(blink_rate);
+#ifdef HAS_RGB_LED
+	queueAction(PLAN_ACTION_RGB_LED, red, green, blue);
+#endif
+}
+
+static void handleSetBeep() {
+	pop8(); // remove the command code
+	uint16_t frequency= pop16();
+	uint16_t beep_length = pop16();
+	pop8();	//uint8_t effect
+	LINE_NUMBER_INCR;
+	Piezo::setTone(frequency, beep_length);
+}
+
+static void handleToolCommand() {
+	uint8_t payload_length = command_source[3];
+#if defined(DITTO_PRINT) && EXTRUDERS > 1
+	if ( dittoPrinting ) {
+		//Delete after use toggles, so that
+		//when deleteAfterUse = false, it's the 1st call of the extruder command
+		//and we copy to the other extruder.  When true, it's the 2nd call if the
+		//extruder command, and we use the tool index specified in the command
+		if ( deleteAfterUse )	deleteAfterUse = false;
+		else			deleteAfterUse = true;
+	} else
+#endif
+		deleteAfterUse = true;  //ELSE
+
+
+	//If we're not setting a temperature, or toggling a fan, then we don't
+	//"ditto print" the command, so we delete after use
+	if (( command_source[2] != SLAVE_CMD_SET_TEMP ) &&
+	    ( command_source[2] != SLAVE_CMD_TOGGLE_FAN ))
+		deleteAfterUse = true;
+
+	//If we're copying this command due to ditto printing, then we need to switch
+	//the extruder controller by switching toolindex to the other extruder
+	int8_t overrideToolIndex = -1;
+	if ( ! deleteAfterUse ) {
+		if ( command_source[1] == 0 )	overrideToolIndex = 1;
+		else				overrideToolIndex = 0;
+	}
+
+	processExtruderCommandPacket(overrideToolIndex);
+
+	//Delete the packet from the buffer
+	if ( deleteAfterUse ) {
+		//We start from 1 not 0, because byte 0 was already removed in the pop8
+		//above
+		for ( uint8_t i = 0; i < (4U + payload_length); i ++ )
+			pop8();
+
+		LINE_NUMBER_INCR;
+	}
+}
+
+static void handleSetBuildPercent() {
+	pop8(); // remove the command code
+	uint8_t percent = pop8();
+	pop8();	// uint8_t ignore; // remove the reserved byte
+	if ( percent != buildPercentage ) {
+		buildPercentage = percent;
+		Motherboard::getBoard().getInterfaceBoard().notify(SCREEN_EVENT_BUILD);
+	}
+	LINE_NUMBER_INCR;
+#if defined(BUILD_STATS) || defined(ESTIMATE_TIME)
+	//Set the starting time / percent on the first HOST_CMD_SET_BUILD_PERCENT
+	//with a non zero value sent near the start of the build
+	//We use this to calculate the build time
+	if (( buildPercentage > 0 ) && ( startingBuildTimeSeconds == 0) && ( startingBuildTimePercentage == 0 )) {
+		startingBuildTimeSeconds = host::getPrintSeconds();
+		startingBuildTimePercentage = buildPercentage;
+	}
+	if ( buildPercentage > 0 ) {
+		elapsedSecondsSinceBuildStart = host::getPrintSeconds();
+	}
+#endif
+}
+
+static void handleQueueSong() {
+	/// Error tone is 0,
+	/// End tone is 1,
+	/// all other tones user-defined (defaults to end-tone)
+	pop8(); // remove the command code
+	uint8_t songId = pop8();
+	LINE_NUMBER_INCR;
+	if(songId == 0)
+		Piezo::errorTone(4);
+	else if (songId == 1 )
+		Piezo::playTune(TUNE_PRINT_DONE);
+	else
+		Piezo::errorTone(2);
+#if defined(PSTOP_SUPPORT)
+	// Helpful at end of print
+	// Especially with filament detectors
+	// with timeouts that are fooled by
+	// end gcode which homes, sends Z
+	// to bottom, then plays a song.
+	pstop_okay = false;
+#endif
+}
+
+static void handleResetToFactory() {
+	/// reset EEPROM settings to the factory value. Reboot bot.
+	pop8(); // remove the command code
+	pop8();	//uint8_t options
+	LINE_NUMBER_INCR;
+	FACTORYRESETEEPROM(false);
+	Motherboard::getBoard().reset(false);
+}
+
+static void handleBuildStartNotification() {
+	pop8(); // remove the command code
+	pop32();	//int buildSteps
+	LINE_NUMBER_INCR;
+	host::handleBuildStartNotification(command_buffer);
+#if defined(PSTOP_SUPPORT)
+	pstop_okay = false;
+#endif
+}
+
+static void handleBuildEndNotification() {
+	pop8(); // remove the command code
+	// uint8_t flags = pop8();
+	pop8();
+	LINE_NUMBER_INCR;
+	host::handleBuildStopNotification();
+#if defined(PSTOP_SUPPORT)
+	pstop_okay = false;
+#endif
+}
+
+static void handleSetAccelerationToggle() {
+	pop8(); // remove the command code
+	LINE_NUMBER_INCR;
+	uint8_t status = pop8();
+	steppers::setSegmentAccelState(status == 1);
+}
+
+static void handleStreamVersion() {
+	pop32();
+	pop32();
+	pop32();
+	pop32();
+	pop32();
+	pop8();
+	LINE_NUMBER_INCR;
+}
 
-		int16_t platform_temp = altTemp[ALTTEMP_PLATFORM_INDEX] ? (int16_t)altTemp[ALTTEMP_PLATFORM_INDEX] : pausedPlatformTemp;
-		if ( platform_temp > 0 ) {
-			board.getPlatformHeater().Pause(false);
-			board.getPlatformHeater().set_target_temperature(platform_temp);
-		}
+static void handlePauseAtZPos() {
+	pop8(); // remove the command code
+	LINE_NUMBER_INCR;
+	int32_t zPosInt32 = pop32();
+	float *zPos = (float *)&zPosInt32;
 
-		int16_t temp = altTemp[0] ? (int16_t)altTemp[0] : pausedExtruderTemp[0];
-		if ( temp > 0 ) {
-			board.getExtruderBoard(0).getExtruderHeater().Pause(false);
-			board.getExtruderBoard(0).getExtruderHeater().set_target_temperature(temp);
-#if !defined(HEATERS_ON_STEROIDS)
-			if ( platform_temp > 0 )
-				board.getExtruderBoard(0).getExtruderHeater().Pause(true);
+	//Exclude negative zpos's and nearly zero zpos's
+	if ( *zPos < 0.001 )	*zPos = 0.0;
+	pauseAtZPos(stepperAxisMMToSteps(*zPos, Z_AXIS));
+}
+
+typedef struct {
+	void (*handler)(void);
+	uint8_t length;		// With the command code
+	uint8_t flags;
+} CommandEntry;
+
+#define CMD_FIRST	HOST_CMD_FIND_AXES_MINIMUM
+#define CMD_LAST	HOST_CMD_CONCURRENT
+
+// The bufferable commands, in order from CMD_FIRST
+const static CommandEntry commands[CMD_LAST - CMD_FIRST + 1] PROGMEM = {
+	{ handleFindAxes,		8,	CMD_NO_SYNC },				// 131
+	{ handleFindAxes,		8,	CMD_NO_SYNC },				// 132
+	{ handleDelay,			5,	0 },					// 133
+	{ handleChangeTool,		2,	CMD_NO_SYNC },				// 134
+	{ handleWaitForTool,		6,	0 },					// 135
+	{ handleToolCommand,		4,	CMD_NO_SYNC | CMD_LEN_TOOL },		// 136
+	{ handleEnableAxes,		2,	CMD_NO_SYNC },				// 137
+	{ NULL,				0,	0 },					// 138
+	{ handleQueuePointExt,		sizeof(queue_point_ext_t),	CMD_MOVE },	// 139
+	{ handleSetPositionExt,		21,	CMD_NO_SYNC },				// 140
+	{ handleWaitForPlatform,	6,	0 },					// 141
+	{ handleQueuePointNew,		sizeof(queue_point_new_t),	CMD_MOVE },	// 142
+	{ handleStoreHomePosition,	2,	0 },					// 143
+	{ handleRecallHomePosition,	2,	CMD_NO_SYNC },				// 144
+	{ handleSetPotValue,		3,	0 },					// 145
+	{ handleSetRGBLed,		6,	CMD_NO_SYNC },				// 146
+	{ handleSetBeep,		6,	0 },					// 147
+	{ handlePauseForButton,		5,	CMD_NO_SYNC },				// 148
+	{ handleDisplayMessage,		6,	CMD_STRING },				// 149
+	{ handleSetBuildPercent,	3,	CMD_NO_SYNC },				// 150
+	{ handleQueueSong,		2,	0 },					// 151
+	{ handleResetToFactory,		2,	0 },					// 152
+	{ handleBuildStartNotification,	5,	CMD_STRING },				// 153
+	{ handleBuildEndNotification,	2,	0 },					// 154
+	{ handleQueuePointNewExt,	sizeof(queue_point_new_ext_t),	CMD_MOVE },	// 155
+	{ handleSetAccelerationToggle,	2,	CMD_NO_SYNC },				// 156
+	{ handleStreamVersion,		21,	0 },					// 157
+	{ handlePauseAtZPos,		5,	0 },					// 158
+	{ handleQueuePointDelta,	2 + sizeof(queue_point_delta_tail_t),	CMD_MOVE | CMD_LEN_DELTA },	// 159
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+	{ handleMeshLevel,		3,	0 },					// 160
+#else
+	{ NULL,				3,	0 },					// 160
 #endif
-		}
-#if EXTRUDERS > 1
-		temp = altTemp[1] ? (int16_t)altTemp[1] : pausedExtruderTemp[1];
-		if ( temp > 0 ) {
-			board.getExtruderBoard(1).getExtruderHeater().Pause(false);
-			board.getExtruderBoard(1).getExtruderHeater().set_target_temperature(temp);
-#if !defined(HEATERS_ON_STEROIDS)
-			if ( platform_temp > 0 )
-				board.getExtruderBoard(1).getExtruderHeater().Pause(true);
+	{ handleQueueArc,		sizeof(queue_arc_t),		CMD_MOVE },	// 161
+	{ handlePlannerHint,		sizeof(planner_hint_t),		CMD_MOVE },	// 162
+	{ handleFirmwareRetract,	sizeof(firmware_retract_t),	CMD_MOVE },	// 163
+	{ handleSetAdvanceProfile,	2,	CMD_MOVE },				// 164
+#if defined(AUTO_LEVEL)
+	{ handleProbePoint,		19,	0 },					// 165
+#else
+	{ NULL,				19,	0 },					// 165
 #endif
-		}
-#endif // EXTRUDERS > 1
+	{ handleConcurrent,		2,	CMD_NO_SYNC }				// 166
+};
 
-		paused = PAUSE_STATE_EXIT_WAIT_FOR_PLATFORM_HEATER;
-		break;
+static uint8_t commandFlags(uint8_t command) {
+	if ( command < CMD_FIRST || command > CMD_LAST ) return 0;
+	return pgm_read_byte(&commands[command - CMD_FIRST].flags);
+}
+
+// Bytes of a command, from its code, which tell how long it is
+static uint8_t lengthBytes(uint8_t flags) {
+	if ( flags & CMD_LEN_TOOL ) return 4;
+	if ( flags & CMD_LEN_DELTA ) return 2;
+	return 1;
+}
+
+// The length of command, given the last of its lengthBytes()
+static uint16_t entryLength(uint8_t command, uint8_t length_byte) {
+	const CommandEntry *entry = &commands[command - CMD_FIRST];
+	uint16_t length = pgm_read_byte(&entry->length);
+	uint8_t flags = pgm_read_byte(&entry->flags);
+	if ( flags & CMD_LEN_TOOL )
+		length += length_byte;
+	else if ( flags & CMD_LEN_DELTA ) {
+		for ( uint8_t i = 0; i < QUEUE_POINT_DELTA_AXES; i ++ )
+			if ( length_byte & (1 << i) ) length += 2;
 	}
+	return length;
+}
 
-	case PAUSE_STATE_EXIT_WAIT_FOR_PLATFORM_HEATER:
-		//Waiting for the platform heater to reach it's set point
-		if (( pausedPlatformTemp > 0 ) && ( ! Motherboard::getBoard().getPlatformHeater().has_reached_target_temperature() ))
-			break;
-		paused = PAUSE_STATE_EXIT_WAIT_FOR_TOOLHEAD_HEATERS;
-		break;
+static uint16_t commandLength(uint16_t offset) {
+	uint8_t command = command_source[offset];
+	if ( command < CMD_FIRST || command > CMD_LAST ) return 0;
 
-	case PAUSE_STATE_EXIT_WAIT_FOR_TOOLHEAD_HEATERS:
-		if (( pausedExtruderTemp[0] > 0 ) && ( ! Motherboard::getBoard().getExtruderBoard(0).getExtruderHeater().has_reached_target_temperature() ))
-			break;
-#if EXTRUDERS > 1
-		if (( pausedExtruderTemp[1] > 0 ) && ( ! Motherboard::getBoard().getExtruderBoard(1).getExtruderHeater().has_reached_target_temperature() ))
-			break;
+	uint8_t need = lengthBytes(commandFlags(command));
+	if ( command_source.getLength() < offset + need ) return 0;
+	return entryLength(command, command_source[offset + need - 1]);
+}
+
+#ifdef SD_DIRECT_DECODE
+
+bool CommandSource::refresh() {
+	forget();
+	if ( !command_buffer.isEmpty() || !sdcard::isPlaying() )
+		return false;
+
+	const uint8_t *next;
+	uint16_t n = sdcard::playbackBuffered(&next);
+	if ( n == 0 )
+		return false;
+	uint8_t flags = commandFlags(next[0]);
+	uint8_t need = lengthBytes(flags);
+	if ( flags == 0 || ( flags & CMD_STRING ) || n < need ||
+	     n < entryLength(next[0], next[need - 1]) )
+		return false;
+
+	bytes = next;
+	avail = n;
+	return true;
+}
+
+// The command buffer is only filled with what can't be decoded in place:
+// the command at its head is made whole, a piece from each SD read buffer
+// it spans.  Those with strings, whose lengths aren't known, have the
+// buffer filled as far as it goes.
+static void refillFromSD() {
+	if ( command_source.refresh() )
+		return;
+
+	for (;;) {
+		uint16_t have = command_buffer.getLength();
+		uint16_t need = 1;
+		if ( have ) {
+			uint8_t flags = commandFlags(command_buffer[0]);
+			if ( flags == 0 || ( flags & CMD_STRING ) ) {
+				refillFrom(sdcard::playbackRead);
+				return;
+			}
+			need = lengthBytes(flags);
+			if ( have >= need ) need = commandLength(0);
+		}
+		if ( have >= need )
+			return;
+		if ( refillFrom(sdcard::playbackRead, need - have) == 0 ) {
+#ifdef SD_PLAYBACK_STATS
+			// Everything read so far has been used up, so the card isn't keeping up
+			if ( have == 0 && sdcard::playbackHasNext() )
+				sdcard::playbackStats.starved++;
 #endif
+			return;
+		}
+	}
+}
 
-		restoreDigiPots();
+#else
 
-		paused = PAUSE_STATE_EXIT_START_RETURNING_PLATFORM;
-		break;
+static void refillFromSD() {
+#ifdef SD_PLAYBACK_STATS
+	// Everything read so far has been used up, so the card isn't keeping up
+	if ( command_buffer.isEmpty() && sdcard::playbackHasNext() )
+		sdcard::playbackStats.starved++;
+#endif
+	refillFrom(sdcard::playbackRead);
+}
 
-	case PAUSE_STATE_EXIT_START_RETURNING_PLATFORM:
-		//Instruct the platform to return to it's pre pause position
+#endif
 
-		//If we're heating, the digi pots might be turned down, save them and switch them high
-		saveDigiPotsAndPower(true);
+#ifdef SD_PRESCAN
 
-		platformAccess(false);
-		paused = PAUSE_STATE_EXIT_WAIT_RETURNING_PLATFORM;
-		displayStatusMessage(PAUSE_LEAVE_MSG, PAUSE_RESUMING_POSITION_MSG, true);
-		break;
+uint8_t fileLengthBytes(uint8_t command) {
+	if ( command < CMD_FIRST || command > CMD_LAST ||
+	     pgm_read_byte(&commands[command - CMD_FIRST].length) == 0 )
+		return 0;
+	return lengthBytes(commandFlags(command));
+}
 
-	case PAUSE_STATE_EXIT_WAIT_RETURNING_PLATFORM:
-		//Wait for the platform to finish moving to it's prepause position
-		if (movesplanned() == 0)
-			paused = PAUSE_STATE_EXIT_START_UNRETRACT_FILAMENT;
-		break;
+uint16_t fileCommandLength(const uint8_t *bytes) {
+	return entryLength(bytes[0], bytes[fileLengthBytes(bytes[0]) - 1]);
+}
 
-	case PAUSE_STATE_EXIT_START_UNRETRACT_FILAMENT:
-		retractFilament(false);
-		paused = PAUSE_STATE_EXIT_WAIT_UNRETRACT_FILAMENT;
-		break;
+bool fileCommandHasString(uint8_t command) {
+	return ( commandFlags(command) & CMD_STRING ) != 0;
+}
 
-	case PAUSE_STATE_EXIT_WAIT_UNRETRACT_FILAMENT:
-		//Wait for the filament unretraction to finish
-		//then resume processing commands
-		if (movesplanned() == 0) {
-		        Motherboard::getBoard().setExtra(pausedFanState);
-			restoreDigiPots();
-			removeStatusMessage();
-			paused = PAUSE_STATE_NONE;
-			pauseErrorMessage = 0;
-#if defined(PSTOP_SUPPORT)
-			pstop_triggered = false;
-#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
-			zprobe_stop_triggered = false;
 #endif
-#endif
-		}
-		break;
-
-        case PAUSE_STATE_ERROR:
-		removeStatusMessage();
-		// Need to set incomplete true so that isWaiting() will be true for the
-		// message screen.  That, in turn, keeps InterfaceBoard::doUpdate() from
-		// clearing the message when it sees that the build has finished.
-	        Motherboard::getBoard().errorResponse(pauseErrorMessage, false, true);
-		sdcard::finishPlayback();
-	        pauseErrorMessage = 0;
-		sdCardError = false;
-	        paused = PAUSE_STATE_NONE;
-	        break;
 
-        case PAUSE_STATE_MSG_PAUSED:
-		removeStatusMessage();
-		// Need to set incomplete true so that isWaiting() will be true for the
-		// message screen.  That, in turn, keeps InterfaceBoard::doUpdate() from
-		// clearing the message when it sees that the build has finished.
-	        Motherboard::getBoard().errorResponse(pauseErrorMessage, false, true);
-	        paused = PAUSE_STATE_PAUSED;
-	        break;
+// Runs the command at the head of the command buffer, once the buffer holds
+// all of it.  One with no handler is left where it is.
+static void runCommand(uint8_t command) {
+	void (*handler)(void) = 0;
+	uint16_t length = 0;
 
-	default:
-		break;
-   }
+	if ( command >= CMD_FIRST && command <= CMD_LAST ) {
+		handler = (void (*)(void))pgm_read_word(&commands[command - CMD_FIRST].handler);
+		length = commandLength(0);
+	}
+	if ( handler && length ) {
+		if ( command_source.getLength() >= length )
+			handler();
+	}
+#ifdef SD_DRY_RUN
+	// Where a build would be stuck for good
+	else if ( dryrun::isRunning() )
+		dryrun::fail(command);
+#endif
 }
 
-// A fast slice for processing commands and refilling the stepper queue, etc.
 void runCommandSlice() {
 
+    // The actions whose moves are done.  Those which come up while pausing
+    // wait for the unpause, which restores the fan and heaters first
+    if ( paused == PAUSE_STATE_NONE )
+	runActions();
+
+#ifdef UNDERRUN_STATS
+    // Before anything is refilled, so the buffers are as the planner found
+    // them.  Waiting, or a non-move next, means the moves ran out on purpose.
+    {
+	uint8_t command = command_source[0];
+	steppers::checkUnderrun(( mode != READY && mode != MOVING ) ||
+				( ! command_source.isEmpty() && ! isMovementCommand(command) ));
+    }
+#endif
+
     // get command from SD card if building from SD
     if ( sdcard::isPlaying() ) {
-	while (command_buffer.getRemainingCapacity() > 0 && sdcard::playbackHasNext()) {
-	    command_buffer.push(sdcard::playbackNext());
-	}
+#ifdef SD_DIRECT_DECODE
+	refillFromSD();
+#else
+	if ( command_buffer.getRemainingCapacity() >= COMMAND_BUFFER_REFILL_CHUNK )
+	    refillFromSD();
+#endif
 
 	// Deal with any end of file conditions
 	if( !sdcard::playbackHasNext() ) {
@@ -1305,9 +3739,7 @@ void runCommandSlice() {
 
     // get command from onboard script if building from onboard
     else if(utility::isPlaying()) {
-		while (command_buffer.getRemainingCapacity() > 0 && utility::playbackHasNext()){
-			command_buffer.push(utility::playbackNext());
-		}
+		refillFrom(utility::playbackRead);
 		if(!utility::playbackHasNext() && command_buffer.isEmpty()){
 			utility::finishPlayback();
 		}
@@ -1326,19 +3758,6 @@ void runCommandSlice() {
 	}
 #endif
 
-	//If we were previously past the z pause position (e.g. homing, entering a value during a pause)
-	//then we need to activate the z pause when the z position falls below it's value
-	if (( pauseZPos ) && ( ! pauseAtZPosActivated ) && ( steppers::getPlannerPosition()[2] < pauseZPos)) {
-		pauseAtZPosActivated = true;
-	}
-
-        //If we've reached Pause @ ZPos, then pause
-        if ((( pauseZPos ) && ( pauseAtZPosActivated ) && ( isPaused() == 0 ) && ( steppers::getPlannerPosition()[2]) >= pauseZPos )) {
-		pauseAtZPos(0);		//Clear the pause at zpos
-                host::pauseBuild(true, false);
-		return;
-	}
-
 	if (( paused != PAUSE_STATE_NONE && paused != PAUSE_STATE_PAUSED )) {
 		handlePauseState();
 		return;
@@ -1357,23 +3776,38 @@ void runCommandSlice() {
 	    return;
 	}
 
+#ifdef TOOLCHANGE_PREHEAT
+#ifdef SD_DRY_RUN
+	if ( ! dryrun::isRunning() )
+#endif
+	preheatStandbyTool();
+#endif
+
 	if ( mode == HOMING ) {
 	     if ( !steppers::isRunning() ) {
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER) || defined(CORE_XYZ)
-		  if ( home_again ) {
+		  if ( home_phase != HOME_DONE )
+		       startHomingPhase();
+#if defined(AUTO_LEVEL)
+		  else if ( probe_active )
+		       probeTouched();
+#endif
+#if KINEMATICS_MIXED_MASK
+		  else if ( home_again ) {
 		       home_again = false;
-		       homing_timeout.start(home_timeout_s * 1000L * 1000L);
-		       steppers::startHoming(home_command==HOST_CMD_FIND_AXES_MAXIMUM,
-					     (1 << Y_AXIS),
-					     home_feedrate);
+		       home_flags = 1 << Y_AXIS;
+		       home_phase = HOME_FAST;
+		       startHomingPhase();
 		  }
-		  else
 #endif
+		  else
 		       mode = READY;
 	     }
 	     else if ( homing_timeout.hasElapsed() ) {
 		  steppers::abort();
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER) || defined(CORE_XYZ)
+#if defined(AUTO_LEVEL)
+		  probe_active = false;
+#endif
+#if KINEMATICS_MIXED_MASK
 		  home_again = false;
 #endif
 		  mode = READY;
@@ -1404,6 +3838,24 @@ void runCommandSlice() {
 	}
 #endif
 
+#ifdef SD_DRY_RUN
+	// Nothing is waited for: there's no heat coming, and no one watching
+#ifdef HEAT_WAIT_MOVES
+	if ( dryrun::isRunning() ) {
+		heat_barrier = 0;
+		heat_barrier_held = false;
+		concurrent_phase = false;
+	}
+#endif
+	if ( dryrun::isRunning() && mode != READY && mode != MOVING && mode != HOMING ) {
+		if ( mode == WAIT_ON_BUTTON ) {
+			Motherboard::interfaceBlinkOff();
+			BOARD_STATUS_CLEAR(Motherboard::STATUS_WAITING_FOR_BUTTON);
+		}
+		mode = READY;
+	}
+#endif
+
 	if ( mode == MOVING ) {
 		if ( !steppers::isRunning() )
 			mode = READY;
@@ -1420,26 +3872,8 @@ void runCommandSlice() {
 			Motherboard::getBoard().errorResponse(EXTRUDER_TIMEOUT_MSG);
 			mode = READY;
 		}
-		else if ( !Motherboard::getBoard().getExtruderBoard(currentToolIndex).getExtruderHeater().isHeating() ) {
-#if defined(DITTO_PRINT) && EXTRUDERS > 1
-			if ( dittoPrinting ) {
-				if ( !Motherboard::getBoard().getExtruderBoard((currentToolIndex == 0 ) ? 1 : 0).getExtruderHeater().isHeating() )
-					mode = READY;
-			}
-			else
-#endif
-				mode = READY;
-		}
-		else if ( Motherboard::getBoard().getExtruderBoard(currentToolIndex).getExtruderHeater().has_reached_target_temperature() ) {
-#if defined(DITTO_PRINT) && EXTRUDERS > 1
-			if ( dittoPrinting ) {
-				if ( Motherboard::getBoard().getExtruderBoard((currentToolIndex == 0) ? 1 : 0).getExtruderHeater().has_reached_target_temperature() )
-            				mode = READY;
-			}
-			else
-#endif
-				mode = READY;
-		}
+		else if ( toolReady(currentToolIndex) )
+			mode = READY;
 	}
 
 	if ( mode == WAIT_ON_PLATFORM ) {
@@ -1452,6 +3886,13 @@ void runCommandSlice() {
 			mode = READY;
 	}
 
+#ifdef HEAT_WAIT_MOVES
+	if ( mode == WAIT_ON_BARRIER ) {
+		if ( ! heatBarrierWaits() )
+			mode = READY;
+	}
+#endif
+
 	if ( mode == WAIT_ON_BUTTON ) {
 		if ( button_wait_timeout.hasElapsed() ) {
 			if ( button_timeout_behavior & (1 << BUTTON_TIMEOUT_ABORT) )
@@ -1489,11 +3930,10 @@ void runCommandSlice() {
 		//The steppers have already stopped moving, this allows a movement plan to be computed once.
 
 		uint8_t count = 0;
-		uint8_t command = command_buffer[0];
+		uint8_t command = command_source[0];
 
 		if ( st_empty() ) {
-			if ((command == HOST_CMD_QUEUE_POINT_EXT || command == HOST_CMD_QUEUE_POINT_NEW ||
-					command == HOST_CMD_QUEUE_POINT_NEW_EXT) ) {
+			if ( isMovementCommand(command) ) {
 				pipeline_ready = false;
 				_MemoryBarrier();
 			}
@@ -1501,9 +3941,26 @@ void runCommandSlice() {
 			disable_slowdown = true;
 		}
 
-		while ( command_buffer.getLength() > 0 && movesplanned() < (BLOCK_BUFFER_SIZE - 2) &&
-				(command == HOST_CMD_QUEUE_POINT_EXT || command == HOST_CMD_QUEUE_POINT_NEW ||
-						command == HOST_CMD_QUEUE_POINT_NEW_EXT)) {
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+		// The rest of a move split over the mesh goes before the next command
+		if ( mesh_pending ) queueMeshSegments();
+#endif
+		// and so do the rest of the chords of an arc
+		if ( arc_pending ) queueArcSegments();
+
+		while ( ! MOVE_SEGMENTS_PENDING &&
+				command_source.getLength() > 0 && MOVE_ROOM &&
+				isMovementCommand(command) ) {
+#ifdef MOVE_QUEUE
+			// A change of advance profile is for the moves after it
+			if ( command == HOST_CMD_SET_ADVANCE_PROFILE && ! steppers::moveQueueEmpty() ) break;
+#endif
+#ifdef HEAT_WAIT_MOVES
+			// What's planned runs on while the heaters come up
+			if ( heatBarrierHolds() ) break;
+#endif
+			// The moves past a Z action wait for it to be queued
+			if ( z_actions_due && queueZActions() ) break;
 
 			//If we get a very detailed spot, allow for up to BLOCK_BUFFER_SIZE*2 commands before leaving.
 			//Otherwise, st_interrupt could be consuming blocks forever leaving us unresponsive to input.
@@ -1512,12 +3969,28 @@ void runCommandSlice() {
 				return;
 			}
 
-			handleMovementCommand(command);
+#ifdef POWER_LOSS_RESUME
+			// The move is where the build can be carried on from, once the
+			// nozzle has got to where it starts
+			if ( checkpoint::due() && sdcard::isPlaying() && plan_action_room() && MOVE_QUEUE_EMPTY ) {
+				uint32_t played, size;
+				sdcard::playbackProgress(&played, &size);
+				if ( checkpoint::take(played - command_buffer.getLength(),
+						      steppers::getPlannerPosition(), currentToolIndex) )
+					queueAction(PLAN_ACTION_CHECKPOINT, 0);
+			}
+#endif
+			runCommand(command);
+			if ( z_actions_set ) checkZActions();
 
-			while ( command_buffer.getRemainingCapacity() > 0 && sdcard::isPlaying() && sdcard::playbackHasNext())
-				command_buffer.push(sdcard::playbackNext());
+#ifdef SD_DIRECT_DECODE
+			if ( sdcard::isPlaying() )
+#else
+			if ( command_buffer.getLength() < COMMAND_BUFFER_LOW_WATERMARK && sdcard::isPlaying() )
+#endif
+				refillFromSD();
 
-			command = command_buffer[0];
+			command = command_source[0];
 
 			//Since we might stay here for a while, make sure the watchdog doesn't fire.
 			wdt_reset();
@@ -1529,688 +4002,51 @@ void runCommandSlice() {
 			pipeline_ready = true;
 		}
 
+		if ( MOVE_SEGMENTS_PENDING ) return;
+
+		// A retract with no move after it to go with goes by itself, ahead
+		// of what's next
+		if ( retract_pending && command_source.getLength() > 0 && ! isMovementCommand(command) ) {
+			if ( movesplanned() >= (BLOCK_BUFFER_SIZE - 2) ) return;
+			flushRetract();
+		}
+
 		//
 		// process next command on the queue.
 		//
-		if ((command_buffer.getLength() > 0)){
+		if ((command_source.getLength() > 0)){
 			Motherboard::getBoard().resetUserInputTimeout();
 
+			// The rest see the moves decoded ahead of them planned, as
+			// their actions and positions go with the planner's
+			if ( ! MOVE_QUEUE_EMPTY ) return;
+
 			//If we're running acceleration, we want to populate the pipeline buffer,
 			//but we also need to sync (wait for the pipeline buffer to clear) on certain
 			//commands, we do that here
 			//If we're not pipeline'able command, then we sync here,
 			//by waiting for the pipeline buffer to empty before continuing
-			if ((command != HOST_CMD_QUEUE_POINT_EXT) &&
- 			    (command != HOST_CMD_QUEUE_POINT_NEW) &&
-			    (command != HOST_CMD_QUEUE_POINT_NEW_EXT ) &&
-			    (command != HOST_CMD_ENABLE_AXES ) &&
-			    (command != HOST_CMD_CHANGE_TOOL ) &&
-			    (command != HOST_CMD_SET_POSITION_EXT) &&
-			    (command != HOST_CMD_SET_ACCELERATION_TOGGLE) &&
-			    (command != HOST_CMD_RECALL_HOME_POSITION) &&
-			    (command != HOST_CMD_FIND_AXES_MINIMUM) &&
-			    (command != HOST_CMD_FIND_AXES_MAXIMUM) &&
-			    (command != HOST_CMD_TOOL_COMMAND) &&
-			    (command != HOST_CMD_PAUSE_FOR_BUTTON) &&
-				(command != HOST_CMD_SET_BUILD_PERCENT)) {
-       	                         if ( ! st_empty() )     return;
-       	                 }
-
-			if (command == HOST_CMD_CHANGE_TOOL) {
-				if (command_buffer.getLength() >= 2) {
-					pop8(); // remove the command code
-#if EXTRUDERS > 1
-                    currentToolIndex = pop8();
-                    steppers::changeToolIndex(currentToolIndex);
-#else
-					pop8();
-#endif
-                    LINE_NUMBER_INCR;
-				}
-			} else if (command == HOST_CMD_ENABLE_AXES) {
-				if (command_buffer.getLength() >= 2) {
-					pop8(); // remove the command code
-					uint8_t axes = pop8();
-					LINE_NUMBER_INCR;
-
-#if defined(DITTO_PRINT) && EXTRUDERS > 1
-					if ( dittoPrinting ) {
-						if ( currentToolIndex == 0 ) {
-							//Set B to be the same as A
-							axes &= ~(_BV(B_AXIS));
-							if ( axes & _BV(A_AXIS) )	axes |= _BV(B_AXIS);
-						} else {
-							//Set A to be the same as B
-							axes &= ~(_BV(A_AXIS));
-							if ( axes & _BV(B_AXIS) )	axes |= _BV(A_AXIS);
-						}
-					}
-#endif
-					steppers::enableAxes(axes, (axes & 0x80) != 0);
-				}
-			} else if (command == HOST_CMD_SET_POSITION_EXT) {
-				// check for completion
-				if (command_buffer.getLength() >= 21) {
-					pop8(); // remove the command code
-					int32_t x = pop32();
-					int32_t y = pop32();
-					int32_t z = pop32();
-					int32_t a = pop32();
-#if EXTRUDERS > 1
-					int32_t b = pop32();
-#else
-					pop32();
-#endif
-
-#if defined(DITTO_PRINT) && EXTRUDERS > 1
-					if ( dittoPrinting ) {
-						if ( currentToolIndex == 0 )	b = a;
-						else				a = b;
-					}
-#endif
-
-					lastFilamentPosition[0] = a;
-#if EXTRUDERS > 1
-					lastFilamentPosition[1] = b;
+			uint8_t flags = commandFlags(command);
+			if (( ! ( flags & ( CMD_MOVE | CMD_NO_SYNC ) ) )
+#ifdef TOOLCHANGE_PREHEAT
+			    // Waiting for a tool which is hot already needn't stop the moves,
+			    // unless a change of its temperature is still to come
+			    && !((command == HOST_CMD_WAIT_FOR_TOOL) && (command_source.getLength() >= 2) &&
+				 !plan_actions_pending() && toolReady(command_source[1]))
 #endif
-					LINE_NUMBER_INCR;
-
-					Point newPoint = Point(STEPPERS_(x,y,z,a,b));
-#if defined(AUTO_LEVEL)
-					alevel_update(newPoint);
-#endif
-					steppers::definePosition(newPoint, false);
-				}
-			} else if (command == HOST_CMD_DELAY) {
-				if (command_buffer.getLength() >= 5) {
-					mode = DELAY;
-					pop8(); // remove the command code
-					// parameter is in milliseconds; timeouts need microseconds
-					uint32_t microseconds = pop32() * 1000L;
-					LINE_NUMBER_INCR;
-
-					delay_timeout.start(microseconds);
-				}
-			} else if (command == HOST_CMD_PAUSE_FOR_BUTTON) {
-				if (command_buffer.getLength() >= 5) {
-					pop8(); // remove the command code
-					button_mask = pop8();
-					uint16_t timeout_seconds = pop16();
-					button_timeout_behavior = pop8();
-					LINE_NUMBER_INCR;
-
-					if (timeout_seconds != 0) {
-						button_wait_timeout.start(timeout_seconds * 1000L * 1000L);
-					} else {
-						button_wait_timeout = Timeout();
-					}
-                    // set button wait via interface board
-					Motherboard::interfaceBlinkOn();
-					InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
-					ib.waitForButton(button_mask);
-					BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
-					mode = WAIT_ON_BUTTON;
-				}
+			    ) {
+				// The actions queued with the moves are part of the sync too
+				if ( ! st_empty() || plan_actions_pending() )	return;
 			}
-			else if (command == HOST_CMD_DISPLAY_MESSAGE) {
-#if defined(COOLING_FAN_PWM_ON_DISPLAY)
-				if (command_buffer[5] == 'F' && command_buffer[6] == '\0') {
-					pop32(); // remove the command code, xpos, ypos, options
-					uint8_t timeout_seconds = pop8();
-					pop16(); // discard message
-					fan_pwm_enable = false;
-					fan_pwm_override = true;
-					fan_pwm_override_value = timeout_seconds;
-
-					fan_pwm_bottom_count = (255 - (1 << FAN_PWM_BITS)) +
-						(int)(0.5 + ((uint16_t)(1 << FAN_PWM_BITS) * fan_pwm_override_value) / 100.0);
-					fan_pwm_enable = true;
-					LINE_NUMBER_INCR;
-				}
-				else
-				{
-#endif
-					MessageScreen* scr = Motherboard::getBoard().getMessageScreen();
-					if (command_buffer.getLength() >= 6) {
-						pop8(); // remove the command code
-						uint8_t options = pop8();
-						uint8_t xpos = pop8();
-						uint8_t ypos = pop8();
-						uint8_t timeout_seconds = pop8();
-						LINE_NUMBER_INCR;
-
-						// check message clear bit
-						if ((options & (1 << 0)) == 0) { scr->clearMessage(); }
-						// set position and add message
-						scr->setXY(xpos, ypos);
-						scr->addMessage(command_buffer);
-
-						// push message screen if the full message has been recieved
-						if ((options & (1 << 1))) {
-							InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
-							if (ib.getCurrentScreen() != scr) {
-								ib.pushScreen(scr);
-							}
-							else {
-								scr->refreshScreen();
-							}
-							// set message timeout if not a buttonWait call
-							if ((timeout_seconds != 0) && (!(options & (1 << 2)))) {
-								scr->setTimeout(timeout_seconds);//, true);
-							}
-
-							if (options & (1 << 2)) { // button wait bit --> start button wait
-								if (timeout_seconds != 0) {
-									button_wait_timeout.start(timeout_seconds * 1000L * 1000L);
-								}
-								else {
-									button_wait_timeout = Timeout();
-								}
-								button_mask = (1 << ButtonArray::CENTER);  // center button
-								button_timeout_behavior &= (1 << BUTTON_CLEAR_SCREEN);
-								Motherboard::interfaceBlinkOn();
-								InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
-								ib.waitForButton(button_mask);
-								BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
-								mode = WAIT_ON_BUTTON;
-							}
-						}
-					}
-#if defined(COOLING_FAN_PWM_ON_DISPLAY)
-				}
-#endif
-			} else if (command == HOST_CMD_FIND_AXES_MINIMUM ||
-				   command == HOST_CMD_FIND_AXES_MAXIMUM) {
-				if (command_buffer.getLength() >= 8) {
-					pop8(); // remove the command
-					uint8_t flags = pop8();
-					uint32_t feedrate = pop32(); // feedrate in us per step
-					uint16_t timeout_s = pop16();
-					LINE_NUMBER_INCR;
-
-#if defined(CALCULATE_HOMING_TIMEOUT)
-					// for bigger machines, we have longer axis, and it may take more time
-					// to home. since MakerBot Desktop and ReplicatorG doesn't have a
-					// convinient way to set homing timeout, we just ignore the timeout
-					// in command and re-calculate the optimal timeout according to axis
-					// length and feedrate.
-					//   timeout = axis_length / (feedrate / 5) * 125%
-					// for example, a 200mm axis with homing feedrate 10mm/s will timeout
-					// in 200mm / 10mm/s * 125% = 25s.
-					for (int axis = 0;axis < STEPPER_COUNT;++axis) {
-						// check the flag this way to avoid tabbing the code to the right
-						// to the screen......
-						if (!(flags & (1 << axis)))
-							continue;
-
-						// axis length in steps
-						int32_t axis_length = stepperAxis[axis].max_axis_steps_limit - stepperAxis[axis].min_axis_steps_limit;
-						if (axis_length < 0)
-							axis_length = -axis_length;
-
-						// us per step
-						uint32_t max_feedrate = stepperAxis[axis].min_interval * 5;
-						if (feedrate < max_feedrate)
-							feedrate = max_feedrate;
-
-						uint32_t optimal_timeout = (uint16_t)(axis_length * feedrate * 2 / 1000L / 1000L * 1.25);
-						if (timeout_s < optimal_timeout)
-							timeout_s = optimal_timeout;
-					}
-#endif
-
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER) || defined(CORE_XYZ)
-					if (((1 << X_AXIS) | (1 << Y_AXIS)) == (flags & ((1 << X_AXIS) | (1 << Y_AXIS)))) {
-					     flags &= ~(1 << Y_AXIS);
-					     home_again     = true;
-					     home_command   = command;
-					     home_feedrate  = feedrate;
-					     home_timeout_s = timeout_s;
-					}
-					else
-					     home_again = false;
-#endif
-					//bool direction = command == HOST_CMD_FIND_AXES_MAXIMUM;
-#if defined(PSTOP_OKAY)
-					// Helpful at end of print
-					// Especially with filament detectors
-					// with timeouts that are fooled by
-					// end gcode which homes, sends Z
-					// to bottom, then plays a song.
-					pstop_okay = false;
-#endif
-					mode = HOMING;
-					homing_timeout.start(timeout_s * 1000L * 1000L);
-					steppers::startHoming(command==HOST_CMD_FIND_AXES_MAXIMUM,
-							flags,
-							feedrate);
-				}
-			} else if (command == HOST_CMD_WAIT_FOR_TOOL) {
-				if (command_buffer.getLength() >= 6) {
-#ifdef DEBUG_NO_HEAT_NO_WAIT
-					mode = READY;
-#else
-					mode = WAIT_ON_TOOL;
-#endif
-#if defined(PSTOP_SUPPORT)
-					// Assume that by now coordinates are set
-					pstop_okay = true;
-#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
-					zprobe_hits = 0;
-#endif
-#endif
-					pop8();
-					currentToolIndex = pop8();
-					pop16();	//uint16_t toolPingDelay
-					uint16_t toolTimeout = (uint16_t)pop16();
-					LINE_NUMBER_INCR;
-					// if we re-add handling of toolTimeout, we need to make sure
-					// that values that overflow our counter will not be passed)
-					tool_wait_timeout.start(toolTimeout*1000000L);
-				}
-			} else if (command == HOST_CMD_WAIT_FOR_PLATFORM) {
-        // FIXME: Almost equivalent to WAIT_FOR_TOOL
-				if (command_buffer.getLength() >= 6) {
-#ifdef DEBUG_NO_HEAT_NO_WAIT
-					mode = READY;
-#else
-					mode = WAIT_ON_PLATFORM;
-#endif
-#if defined(PSTOP_SUPPORT)
-					// Assume that by now coordinates are set
-					pstop_okay = true;
-#if defined(AUTO_LEVEL) && defined(PSTOP_ZMIN_LEVEL)
-					zprobe_hits = 0;
-#endif
-#endif
-					pop8();
-					pop8();	//uint8_t currentToolIndex
-					pop16(); //uint16_t toolPingDelay
-					uint16_t toolTimeout = (uint16_t)pop16();
-					LINE_NUMBER_INCR;
-					// if we re-add handling of toolTimeout, we need to make sure
-					// that values that overflow our counter will not be passed)
-					tool_wait_timeout.start(toolTimeout*1000000L);
-				}
-			} else if (command == HOST_CMD_STORE_HOME_POSITION) {
-
-				// check for completion
-				if (command_buffer.getLength() >= 2) {
-					pop8();
-					uint8_t axes = pop8();
-					LINE_NUMBER_INCR;
-
-					// Go through each axis, and if that axis is specified, read it's value,
-					// then record it to the eeprom.
-					Point currentPoint = steppers::getPlannerPosition();
-#if !defined(AUTO_LEVEL)
-					for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-#else
-					for (uint8_t i = 0; i <= Z_AXIS; i++) {
-#endif
-						if ( axes & (1 << i) ) {
-						     uint16_t offset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + i * 4;
-							uint32_t position = currentPoint[i];
-							cli();
-							eeprom_write_block(&position, (void*) offset, 4);
-							sei();
-						}
-					}
-#if defined(AUTO_LEVEL)
-					// Trigger only for A, B, or A & B
-					// Do not trigger if any of X, Y, or Z was specified
-					if ((axes) && (axes == (axes & ((1 << A_AXIS) | (1 << B_AXIS))))) {
-					     uint8_t idx;
-					     switch(axes) {
-					     case (1 << A_AXIS) : idx = 0; break;
-					     case (1 << B_AXIS) : idx = 1; break;
-					     default: idx = 2; break;
-					     }
-					     alevel_state |= 1 << idx;
-					     int32_t position[3], poffset[2];
-						 cli();
-						 eeprom_read_block(poffset, (void*)eeprom_offsets::ALEVEL_PROBE_OFFSETS,
-							 2 * sizeof(int32_t));
-						 sei();
-					     position[0] = currentPoint[X_AXIS] + poffset[0];
-					     position[1] = currentPoint[Y_AXIS] + poffset[1];
-					     position[2] = currentPoint[Z_AXIS];
-					     cli();
-					     eeprom_write_block(
-						  position,
-						  (char *)eeprom_offsets::ALEVEL_P1 + idx * 3 * sizeof(int32_t),
-						  3 * sizeof(int32_t));
-					     sei();
-					}
-#endif
-				}
-			} else if (command == HOST_CMD_RECALL_HOME_POSITION) {
-				// check for completion
-				if (command_buffer.getLength() >= 2) {
-					pop8();
-					uint8_t axes = pop8();
-					LINE_NUMBER_INCR;
-
-					Point newPoint = steppers::getPlannerPosition();
-#if defined(AUTO_LEVEL)
-					// Trigger only for A & B
-					// Do not trigger if any of X, Y, or Z was specified
-					if ( axes == ((1 << A_AXIS) | (1 << B_AXIS)) ) {
-					     // M132 AB -- initialize and enable skew
-					     // alevel_state must have bits 0, 1, and 2 set
-					     uint8_t alevel_valid = 1;
-					     if ( 7 == (alevel_state & 7) ) {
-						  // Attempt to enable auto-level
-						  auto_level_t alevel_data;
-						  int32_t zhome;
-						  uint32_t zhoffset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
-						       sizeof(int32_t) * (Z_AXIS);
-						  cli();
-						  eeprom_read_block(&zhome, (void *)zhoffset, sizeof(int32_t));
-						  eeprom_read_block(&alevel_data, (void *)eeprom_offsets::ALEVEL_FLAGS,
-								    sizeof(alevel_data));
-						  sei();
-#if defined(AUTO_LEVEL_ZYYX)
-						  if ( zhome != 0 ) {
-#endif
-						       if ( alevel_data.max_zdelta <= 0 )
-							    alevel_data.max_zdelta = ALEVEL_MAX_ZDELTA_DEFAULT;
-						       if ( skew_init(alevel_data.max_zdelta, zhome,
-								      alevel_data.p1, alevel_data.p2,
-								      alevel_data.p3) ) {
-							    alevel_valid = 0;
-							    alevel_state |= 8;
-						       }
-						       else
-							    alevel_valid = 2;
-#if defined(AUTO_LEVEL_ZYYX)
-						  }
-						  else
-						       alevel_valid = 3;
-#endif
-					     }
-					     cli();
-					     eeprom_write_byte((uint8_t *)eeprom_offsets::ALEVEL_FLAGS,
-							       alevel_valid ? 1 : 0);
-					     sei();
-					     if ( alevel_valid ) {
-						  // Cancel the build!
-						  if ( alevel_valid == 1 )
-						       pauseErrorMessage = ALEVEL_INCOMPLETE_MSG;
-#if defined(AUTO_LEVEL_ZYYX)
-						  else if ( alevel_valid == 3 )
-						       pauseErrorMessage = ALEVEL_NOT_CALIBRATED_MSG;
-#endif
-						  else
-						       pauseErrorMessage = ( skew_status() == ALEVEL_COLINEAR )
-							    ? ALEVEL_COLINEAR_MSG : ALEVEL_BADLEVEL_MSG;
-
-
-						  // Now cancel the build
-						  cancelMidBuild();
-					     }
-#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
-					     else
-						 {
-							//those are not saved, so in case of reboot everything will be as usual
-							steppers::disableZMinEnd(true);
-						}
-#endif
-                        steppers::z_Offset_Change=0;//we reset the gap to ZERO to avoid summing it next time we do a movement
-					}
-					else if ( axes == (1 << A_AXIS) ) {
-					     // Trigger only for A
-					     // Do not trigger if any of X, Y, or Z was specified
-
-					     // M132 A -- check skew data and cancel build if delta is lower than threshold, for calibration script only
-					     // alevel_state must have bits 0, 1, and 2 set
-					     auto_level_t alevel_data;
-					     int32_t zhome;
-					     uint32_t zhoffset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
-						  sizeof(int32_t) * (Z_AXIS);
-					     cli();
-					     eeprom_read_block(&zhome, (void *)zhoffset, sizeof(int32_t));
-					     eeprom_read_block(&alevel_data, (void *)eeprom_offsets::ALEVEL_FLAGS,
-							       sizeof(alevel_data));
-					     sei();
-
-					     alevel_data.max_zdelta = ALEVEL_MAX_ZDELTA_CALIBRATED;
-					     if ( skew_check(alevel_data.max_zdelta,
-							     alevel_data.p1, alevel_data.p2,
-							     alevel_data.p3) )
-						  displayStatusMessage(ALEVEL_GOOD_MSG,ALEVEL_MSG2, false);
-					     else
-						  displayStatusMessage(ALEVEL_FAIL_MSG,ALEVEL_MSG2, false);
-
-					     button_wait_timeout = Timeout();
-					     button_mask = (1 << ButtonArray::CENTER);  // center button
-					     button_timeout_behavior &= (1 << BUTTON_CLEAR_SCREEN);
-					     Motherboard::interfaceBlinkOn();
-					     InterfaceBoard& ib = Motherboard::getBoard().getInterfaceBoard();
-					     ib.waitForButton(button_mask);
-					     BOARD_STATUS_SET(Motherboard::STATUS_WAITING_FOR_BUTTON);
-					     mode = WAIT_ON_BUTTON;
-					}
-					else if ( axes == (1 << B_AXIS) ) {
-					     //ZYYX modified, added M132 B -- disable skew
-					     skew_deinit();
-					}
-					else {
-#endif
-					     for (uint8_t i = 0; i <= Z_AXIS; i++) {
-						  if ( axes & (1 << i) ) {
-						       uint16_t offset = eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + 4*i;
-						       cli();
-						       eeprom_read_block(&(newPoint[i]), (void*) offset, 4);
-						       sei();
-						  }
-					     }
-
-					     lastFilamentPosition[0] = newPoint[A_AXIS];
-#if EXTRUDERS > 1
-					     lastFilamentPosition[1] = newPoint[B_AXIS];
-#endif
-#if defined(AUTO_LEVEL)
-					// If we've jumped through all the hoops and successfully initialized
-					// auto-leveling, then we need to update the skew transform as we may be
-					// translating our X, Y, or Z coordinates.
-					alevel_update(newPoint);
-#endif
-					steppers::definePosition(newPoint, true);
-#if defined(AUTO_LEVEL)
-					}
-#endif
-				}
-
 
-			} else if (command == HOST_CMD_SET_POT_VALUE) {
-				if (command_buffer.getLength() >= 3) {
-					pop8(); // remove the command code
-					uint8_t axis = pop8();
-					uint8_t value = pop8();
-					LINE_NUMBER_INCR;
-                    steppers::setAxisPotValue(axis, value);
-				}
-			}else if (command == HOST_CMD_SET_RGB_LED){
-				if (command_buffer.getLength() >= 6) {
-					pop8(); // remove the command code
-
-#ifdef HAS_RGB_LED
-					uint8_t red = pop8();
-					uint8_t green = pop8();
-					uint8_t blue = pop8();
-#else
-					pop8();
-					pop8();
-					pop8();
-#endif
-					pop8(); // uint8_t blink_rate = pop8();
-					pop8();	//uint8_t effect
-					LINE_NUMBER_INCR;
-					// RGB_LED::setLEDBlink(blink_rate);
-#ifdef HAS_RGB_LED
-					RGB_LED::setCustomColor(red, green, blue);
-#endif
-
-				}
-			}else if (command == HOST_CMD_SET_BEEP){
-				if (command_buffer.getLength() >= 6) {
-					pop8(); // remove the command code
-					uint16_t frequency= pop16();
-					uint16_t beep_length = pop16();
-					pop8();	//uint8_t effect
-					LINE_NUMBER_INCR;
-                    Piezo::setTone(frequency, beep_length);
-
-				}
-			}else if (command == HOST_CMD_TOOL_COMMAND) {
-				if (command_buffer.getLength() >= 4) { // needs a payload
-					uint8_t payload_length = command_buffer[3];
-					if (command_buffer.getLength() >= 4U+payload_length) {
-#if defined(DITTO_PRINT) && EXTRUDERS > 1
-							if ( dittoPrinting ) {
-								//Delete after use toggles, so that
-								//when deleteAfterUse = false, it's the 1st call of the extruder command
-								//and we copy to the other extruder.  When true, it's the 2nd call if the
-								//extruder command, and we use the tool index specified in the command
-								if ( deleteAfterUse )	deleteAfterUse = false;
-								else			deleteAfterUse = true;
-							} else
-#endif
-								deleteAfterUse = true;  //ELSE
-
-
-							//If we're not setting a temperature, or toggling a fan, then we don't
-							//"ditto print" the command, so we delete after use
-							if (( command_buffer[2] != SLAVE_CMD_SET_TEMP ) &&
-							    ( command_buffer[2] != SLAVE_CMD_TOGGLE_FAN ))
-								deleteAfterUse = true;
-
-							//If we're copying this command due to ditto printing, then we need to switch
-							//the extruder controller by switching toolindex to the other extruder
-							int8_t overrideToolIndex = -1;
-							if ( ! deleteAfterUse ) {
-								if ( command_buffer[1] == 0 )	overrideToolIndex = 1;
-								else				overrideToolIndex = 0;
-							}
-
-							processExtruderCommandPacket(overrideToolIndex);
-
-							//Delete the packet from the buffer
-							if ( deleteAfterUse ) {
-								//We start from 1 not 0, because byte 0 was already removed in the pop8
-								//above
-								for ( uint8_t i = 0; i < (4U + payload_length); i ++ )
-									pop8();
-
-								LINE_NUMBER_INCR;
-							}
-				}
+			// The moves are left to the loop above
+			if ( ! ( flags & CMD_MOVE ) ) {
+				// Those carried out as actions need room in the planner for one
+				if ( plan_action_room() == 0 )	return;
+				// after the Z actions of the moves before them
+				if ( z_actions_due && queueZActions() )	return;
+				runCommand(command);
 			}
-			} else if (command == HOST_CMD_SET_BUILD_PERCENT){
-				if (command_buffer.getLength() >= 3){
-					pop8(); // remove the command code
-					buildPercentage = pop8();
-					pop8();	// uint8_t ignore; // remove the reserved byte
-					LINE_NUMBER_INCR;
-#if defined(BUILD_STATS) || defined(ESTIMATE_TIME)
-					//Set the starting time / percent on the first HOST_CMD_SET_BUILD_PERCENT
-					//with a non zero value sent near the start of the build
-					//We use this to calculate the build time
-					if (( buildPercentage > 0 ) && ( startingBuildTimeSeconds == 0) && ( startingBuildTimePercentage == 0 )) {
-						startingBuildTimeSeconds = host::getPrintSeconds();
-						startingBuildTimePercentage = buildPercentage;
-					}
-					if ( buildPercentage > 0 ) {
-						elapsedSecondsSinceBuildStart = host::getPrintSeconds();
-					}
-#endif
-				}
-			} else if (command == HOST_CMD_QUEUE_SONG ) //queue a song for playing
- 			{
-				/// Error tone is 0,
-				/// End tone is 1,
-				/// all other tones user-defined (defaults to end-tone)
-				if (command_buffer.getLength() >= 2){
-					pop8(); // remove the command code
-					uint8_t songId = pop8();
-					LINE_NUMBER_INCR;
-					if(songId == 0)
-						Piezo::errorTone(4);
-					else if (songId == 1 )
-						Piezo::playTune(TUNE_PRINT_DONE);
-					else
-						Piezo::errorTone(2);
-				}
-#if defined(PSTOP_SUPPORT)
-				// Helpful at end of print
-				// Especially with filament detectors
-				// with timeouts that are fooled by
-				// end gcode which homes, sends Z
-				// to bottom, then plays a song.
-				pstop_okay = false;
-#endif
-
-			} else if ( command == HOST_CMD_RESET_TO_FACTORY) {
-				/// reset EEPROM settings to the factory value. Reboot bot.
-				if (command_buffer.getLength() >= 2){
-				pop8(); // remove the command code
-				pop8();	//uint8_t options
-				LINE_NUMBER_INCR;
-				FACTORYRESETEEPROM(false);
-				Motherboard::getBoard().reset(false);
-				}
-			} else if ( command == HOST_CMD_BUILD_START_NOTIFICATION) {
-				if (command_buffer.getLength() >= 5){
-					pop8(); // remove the command code
-					pop32();	//int buildSteps
-					LINE_NUMBER_INCR;
-					host::handleBuildStartNotification(command_buffer);
-#if defined(PSTOP_SUPPORT)
-					pstop_okay = false;
-#endif
-				}
-			} else if ( command == HOST_CMD_BUILD_END_NOTIFICATION) {
-				if (command_buffer.getLength() >= 2){
-					pop8(); // remove the command code
-					// uint8_t flags = pop8();
-					pop8();
-					LINE_NUMBER_INCR;
-					host::handleBuildStopNotification();
-#if defined(PSTOP_SUPPORT)
-					pstop_okay = false;
-#endif
-				}
-			} else if ( command == HOST_CMD_SET_ACCELERATION_TOGGLE) {
-				if (command_buffer.getLength() >= 2){
-					pop8(); // remove the command code
-					LINE_NUMBER_INCR;
-					uint8_t status = pop8();
-					steppers::setSegmentAccelState(status == 1);
-				}
-			} else if ( command == HOST_CMD_STREAM_VERSION ) {
-			        if ( command_buffer.getLength() >= 21 ) {
-					pop32();
-					pop32();
-					pop32();
-					pop32();
-					pop32();
-					pop8();
-					LINE_NUMBER_INCR;
-				}
-			} else if ( command == HOST_CMD_PAUSE_AT_ZPOS ) {
-				if (command_buffer.getLength() >= 5){
-					pop8(); // remove the command code
-					LINE_NUMBER_INCR;
-					int32_t zPosInt32 = pop32();
-					float *zPos = (float *)&zPosInt32;
-
-					//Exclude negative zpos's and nearly zero zpos's
-					if ( *zPos < 0.001 )	*zPos = 0.0;
-					pauseAtZPos(stepperAxisMMToSteps(*zPos, Z_AXIS));
-				}
-		        } else {
-		        }
 		}
 	}
 
@@ -2227,6 +4063,37 @@ void runCommandSlice() {
 //If we can't complete the calculation due to a lack of information, then we return 0
 
 int32_t estimatedTimeLeftInSeconds(void) {
+#if defined(ESTIMATE_TIME)
+	//When printing from the SD card, the motion time of the file so far,
+	//from the planner's trapezoids, is scaled up to the whole file
+	if ( sdcard::isPlaying() ) {
+		uint32_t played, size, run_ms, queued_ms;
+		sdcard::playbackProgress(&played, &size);
+		plan_get_motion_time(&run_ms, &queued_ms);
+
+		//Bytes still in the command buffer haven't been planned yet
+		uint16_t unplanned = command_buffer.getLength();
+		played = ( played > unplanned ) ? played - unplanned : 0;
+
+#ifdef SD_PRESCAN
+		//Once the file's been pre-scanned, the planner's time so far is
+		//set against the moves' own time to here rather than their bytes
+		if ( prescan::results() && ( run_ms >= 10000 ) && ( played < size ) ) {
+			uint32_t done = prescan::nominalMillis(played);
+			uint32_t total = prescan::results()->millis[PRESCAN_PROFILE - 1];
+			if (( done > 0 ) && ( total > done ))
+				return (int32_t)(((float)(run_ms + queued_ms) * (float)(total - done) / (float)done +
+						  (float)queued_ms) / 1000.0);
+		}
+#endif
+
+		//Wait for enough of the file to go by to be representative
+		if (( run_ms >= 10000 ) && ( played >= (size >> 7) ) && ( played < size ))
+			return (int32_t)(((float)(run_ms + queued_ms) * (float)(size - played) / (float)played +
+					  (float)queued_ms) / 1000.0);
+	}
+#endif
+
 	//Safety guard against insufficient information, we return 0 if this is the case
 	if (( buildPercentage == 101 ) || ( buildPercentage == 0 ) ||
 	    ( buildPercentage == startingBuildTimePercentage ) ||
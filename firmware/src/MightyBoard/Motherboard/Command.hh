@@ -20,6 +20,78 @@
 
 #include <stdint.h>
 #include "Configuration.hh"
+#include "CircularBuffer.hh"
+
+// The command buffer wraps with a mask, so its size must be a power of two
+#ifdef PLATFORM_COMMAND_BUFFER_SIZE
+#define COMMAND_BUFFER_SIZE PLATFORM_COMMAND_BUFFER_SIZE
+#elif defined(XMEM) && defined(XMEM_COMMANDS)
+#define COMMAND_BUFFER_SIZE 8192
+#else
+#define COMMAND_BUFFER_SIZE 512
+#endif
+
+typedef CircularBufferPow2Templ<uint8_t, COMMAND_BUFFER_SIZE> CommandBuffer;
+
+// The move commands as they sit in the command buffer, including the
+// command code.  Fields are little-endian, as is the AVR, so each move
+// is decoded with a single copy out of the buffer.
+struct queue_point_ext_t {
+	uint8_t	command;
+	int32_t	x, y, z, a, b;
+	int32_t	dda;
+} __attribute__ ((__packed__));
+
+struct queue_point_new_t {
+	uint8_t	command;
+	int32_t	x, y, z, a, b;
+	int32_t	us;
+	uint8_t	relative;
+} __attribute__ ((__packed__));
+
+struct queue_point_new_ext_t {
+	uint8_t	command;
+	int32_t	x, y, z, a, b;
+	int32_t	dda_rate;
+	uint8_t	relative;
+	float	distance;
+	int16_t	feedrate_mult_64;
+} __attribute__ ((__packed__));
+
+// HOST_CMD_QUEUE_POINT_DELTA is the command code, the axes mask and an
+// int16 delta for each axis in the mask, followed by these
+struct queue_point_delta_tail_t {
+	uint16_t dda_rate;
+	float	distance;
+	int16_t	feedrate_mult_64;
+} __attribute__ ((__packed__));
+
+struct queue_arc_t {
+	uint8_t	command;
+	int32_t	x, y, z;
+	int32_t	a, b;
+	int32_t	i, j;
+	uint8_t	flags;
+	int16_t	feedrate_mult_64;
+} __attribute__ ((__packed__));
+
+struct planner_hint_t {
+	uint8_t	command;
+	uint16_t max_entry_speed_64;
+	uint8_t	flags;
+} __attribute__ ((__packed__));
+
+struct firmware_retract_t {
+	uint8_t	command;
+	uint8_t	flags;
+	uint16_t steps;
+	int16_t	feedrate_mult_64;
+} __attribute__ ((__packed__));
+
+#define QUEUE_ARC_CCW 0x01
+
+#define QUEUE_POINT_DELTA_AXES 5
+#define QUEUE_POINT_DELTA_MAX_LEN (2 + 2 * QUEUE_POINT_DELTA_AXES + sizeof(queue_point_delta_tail_t))
 
 
 //Pause states are used internally to determine various scenarios, so the
@@ -126,12 +198,29 @@ void pauseAtZPos(int32_t zpos);
 /// \return the z position set for pausing (in steps), otherwise 0
 int32_t getPauseAtZPos();
 
+/// Carry out a planner action (PLAN_ACTION_*) as the first move planned at or
+/// above a Z position (in steps) finishes.  Checked as moves are planned, so
+/// it goes at the layer change rather than when a command is read.  A Z the
+/// build is already at or above waits for it to drop below first.
+/// \return false if zpos is 0 or there's no room for another
+bool actionAtZPos(int32_t zpos, uint8_t type, uint8_t arg0, uint8_t arg1 = 0, uint8_t arg2 = 0);
+
 /// Returns the paused state
 enum PauseState pauseState();
 
 /// Returns true if we're transitioning between fully paused, or fully unpaused
 bool pauseIntermediateState();
 
+#ifdef FAST_CANCEL
+/// Cancel the running build by way of a pause which stops within the move
+/// it's in, throws away what's buffered after it and plans the retract and
+/// platform clear back to back, turning the heaters off once they are
+void fastCancel();
+
+/// True from when fastCancel()'s moves are planned until they've run
+bool fastCancelParking();
+#endif
+
 /// Check the state of the command processor
 /// \return True if it is waiting for a button press, false if not
 bool isWaiting();
@@ -140,6 +229,28 @@ bool isWaiting();
 /// \return True if it is in ready mode, false if not in ready mode
 bool isReady();
 
+/// \return True while the build waits for a heater to come up to temperature
+bool isHeating();
+
+#ifdef SD_DRY_RUN
+/// \return True if what's next waits for the moves planned to be done
+bool waitingForMoves();
+#endif
+
+#ifdef SD_PRESCAN
+/// For reading the commands of a file without running them: the number of
+/// bytes of a command, from its code, needed to tell its length, or 0 for
+/// a code this firmware doesn't know
+uint8_t fileLengthBytes(uint8_t command);
+
+/// The length of the command at bytes, including its code, given the first
+/// fileLengthBytes() of it
+uint16_t fileCommandLength(const uint8_t *bytes);
+
+/// True if a NUL terminated string follows the fileCommandLength() bytes
+bool fileCommandHasString(uint8_t command);
+#endif
+
 /// Returns the length of filament extruded (in steps)
 int64_t getFilamentLength(uint8_t extruder);
 
@@ -166,6 +277,12 @@ void push(uint8_t byte);
 /// commands are no longer executed when the heat shutdown is activated
 void heatShutdown();
 
+#ifdef SD_FILE_CRC
+/// Cancel the SD card build, as for a read error, showing msg: its file has
+/// been found to be damaged ahead of where the build has got to
+void cancelFileError(const unsigned char *msg);
+#endif
+
 #if defined(LINE_NUMBER)
 
 /// return line number of current build
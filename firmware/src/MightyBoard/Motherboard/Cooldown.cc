@@ -0,0 +1,67 @@
+/*
+ *  Platform cool down monitor, for telling when a build can be taken off
+ *  and the next one started.
+ */
+
+#include "Compat.hh"
+#include "Cooldown.hh"
+
+#ifdef PLATFORM_COOLDOWN
+
+#include "Host.hh"
+#include "Command.hh"
+#include "Steppers.hh"
+#include "Motherboard.hh"
+#include "Eeprom.hh"
+#include "EepromMap.hh"
+#include "Timeout.hh"
+
+namespace cooldown {
+
+static Timeout sample_timeout;
+
+// Seconds the readings have been at or below the release temperature, up
+// to COOLDOWN_SETTLE_SECONDS
+static uint8_t cool_seconds;
+
+static bool heaterFailed() {
+	Motherboard& board = Motherboard::getBoard();
+	for ( uint8_t e = 0; e < EXTRUDERS; e++ )
+		if ( board.getExtruderBoard(e).getExtruderHeater().has_failed() )
+			return true;
+	return board.getPlatformHeater().has_failed();
+}
+
+void runSlice() {
+	if ( sample_timeout.isActive() && !sample_timeout.hasElapsed() )
+		return;
+	sample_timeout.start(1000000);
+
+	Heater& platform = Motherboard::getBoard().getPlatformHeater();
+	if ( !eeprom::settings.hbp_present )
+		cool_seconds = COOLDOWN_SETTLE_SECONDS;
+	// A failed thermistor's readings can't be trusted to be cool
+	else if ( platform.get_set_temperature() != 0 || platform.has_failed() ||
+		  platform.get_current_temperature() > (int16_t)eeprom::settings.release_temp )
+		cool_seconds = 0;
+	else if ( cool_seconds < COOLDOWN_SETTLE_SECONDS )
+		cool_seconds++;
+}
+
+bool released() {
+	return cool_seconds >= COOLDOWN_SETTLE_SECONDS;
+}
+
+uint8_t status() {
+	if ( !released() )
+		return 0;
+	if ( host::getHostState() != host::HOST_STATE_READY ||
+	     command::pauseState() != PAUSE_STATE_NONE || steppers::isRunning() ||
+	     heaterFailed() )
+		return COOLDOWN_RELEASE;
+	return COOLDOWN_RELEASE | COOLDOWN_NEXT_READY;
+}
+
+}
+
+#endif
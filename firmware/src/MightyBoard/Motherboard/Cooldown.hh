@@ -0,0 +1,39 @@
+#ifndef __COOLDOWN_HH__
+#define __COOLDOWN_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// Watches the platform as it cools once its heater is off, for telling when
+// the build can be taken off it and the bot is ready for the next one.  The
+// platform is taken to be cool once its readings have stayed at or below
+// the release temperature of PLATFORM_RELEASE_TEMP for COOLDOWN_SETTLE_SECONDS,
+// so a reading dipping on its way down doesn't count.  A bot without a
+// heated platform is always cool.  The state is sent after the board status
+// of HOST_CMD_BOARD_STATUS.
+
+#ifdef PLATFORM_COOLDOWN
+
+#define COOLDOWN_SETTLE_SECONDS 5
+
+namespace cooldown {
+
+enum {
+	COOLDOWN_RELEASE	= 0x01,	///< The platform's heater is off and it has cooled to the release temperature
+	COOLDOWN_NEXT_READY	= 0x02	///< As well, nothing is building, pausing or moving and no heater has failed
+};
+
+/// Called from runHostSlice(), takes the platform's reading once a second
+void runSlice();
+
+/// The COOLDOWN_ bits
+uint8_t status();
+
+/// True once the platform has cooled to the release temperature
+bool released();
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ *  Dry run of an SD card build, planned as fast as it can be with nothing
+ *  moved, heated or waited for.
+ */
+
+#include "Compat.hh"
+#include "DryRun.hh"
+
+#ifdef SD_DRY_RUN
+
+#include <string.h>
+#include "Host.hh"
+#include "Command.hh"
+#include "Steppers.hh"
+#include "StepperAccel.hh"
+#include "StepperAccelPlanner.hh"
+#include "Motherboard.hh"
+#include "PrintQueue.hh"
+
+#ifndef INT32_MAX
+#define INT32_MAX 0x7fffffffL
+#endif
+
+namespace dryrun {
+
+static Report rep;
+static uint8_t saved_tool;
+static micros_t start_centa;
+
+// The steppers' time, in ms from the start: when each block was planned,
+// and when the last one taken would have been run.  The time the planning
+// would have waited for room in the planner is added on.
+static uint32_t ready_ms[BLOCK_BUFFER_SIZE];
+static uint8_t stamped;		// Blocks up to here have their ready_ms
+static uint32_t finish_ms;
+static uint32_t waited_ms;
+static bool from_rest;		// The next block starts with the steppers stopped
+
+static uint32_t sinceStart() {
+	uint8_t wrap;
+	return (uint32_t)(Motherboard::getBoard().getCurrentCentaMicros(&wrap) - start_centa) / 10;
+}
+
+static uint32_t now() {
+	return sinceStart() + waited_ms;
+}
+
+// The planning waits until the steppers get to t
+static void waitFor(uint32_t t) {
+	int32_t d = (int32_t)(t - now());
+	if ( d > 0 )
+		waited_ms += d;
+}
+
+static uint32_t playedOffset() {
+	uint32_t played, size;
+	sdcard::playbackProgress(&played, &size);
+	// Less what's still in the command buffer
+	uint16_t unread = COMMAND_BUFFER_SIZE - command::getRemainingCapacity();
+	return ( played > unread ) ? played - unread : 0;
+}
+
+sdcard::SdErrorCode start(char *name) {
+	if ( rep.state == DRY_RUN_RUNNING || host::getHostState() != host::HOST_STATE_READY )
+		return sdcard::SD_ERR_GENERIC;
+#ifdef PRINT_QUEUE
+	// The queue would go on to build its entries for real
+	if ( printqueue::isQueueFile(name) )
+		return sdcard::SD_ERR_GENERIC;
+#endif
+
+	memset(&rep, 0, sizeof(rep));
+	rep.state = DRY_RUN_RUNNING;
+	saved_tool = steppers::toolIndex;
+
+	sdcard::SdErrorCode e = host::startBuildFromSD(name, strlen(name));
+	// A directory is moved into rather than played
+	if ( e == sdcard::SD_SUCCESS &&
+	     host::getHostState() != host::HOST_STATE_BUILDING_FROM_SD )
+		e = sdcard::SD_ERR_FILE_NOT_FOUND;
+	if ( e != sdcard::SD_SUCCESS ) {
+		rep.state = DRY_RUN_NONE;
+		return e;
+	}
+
+	st_dry_run(true);
+	rep.min_lead_ms = INT32_MAX;
+	uint8_t wrap;
+	start_centa = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	stamped = block_buffer_head;
+	finish_ms = 0;
+	waited_ms = 0;
+	from_rest = true;
+	return e;
+}
+
+bool isRunning() {
+	return rep.state == DRY_RUN_RUNNING;
+}
+
+static void end(uint8_t error, uint8_t detail) {
+	if ( rep.state != DRY_RUN_RUNNING )
+		return;
+	if ( rep.error == DRY_RUN_OK ) {
+		rep.error = error;
+		rep.detail = detail;
+		rep.offset = playedOffset();
+	}
+	rep.elapsed_ms = sinceStart();
+	if ( rep.moves == 0 )
+		rep.min_lead_ms = 0;
+	rep.state = DRY_RUN_DONE;
+
+	st_dry_run(false);
+	steppers::changeToolIndex(saved_tool);
+	// Takes up the motors' position as the planner's
+	steppers::abort();
+}
+
+// The block in slot index has been taken, and would have taken ms
+static void account(uint8_t index, uint32_t ms) {
+	uint32_t ready = ready_ms[index];
+
+	if ( ! from_rest ) {
+		int32_t lead = (int32_t)(finish_ms - ready);
+		if ( lead < rep.min_lead_ms )
+			rep.min_lead_ms = lead;
+		if ( lead < 0 && rep.starved != 0xffff )
+			rep.starved ++;
+	}
+	from_rest = false;
+
+	if ( (int32_t)(ready - finish_ms) > 0 )
+		finish_ms = ready;
+	finish_ms += ms;
+	rep.moves ++;
+	rep.planned_ms += ms;
+}
+
+void runSlice() {
+	uint8_t head = block_buffer_head;
+	if ( stamped != head ) {
+		uint32_t t = now();
+		do {
+			ready_ms[stamped] = t;
+			stamped = (stamped + 1) & (BLOCK_BUFFER_SIZE - 1);
+		} while ( stamped != head );
+	}
+
+	bool last = ! sdcard::isPlaying() && command::isEmpty();
+	bool drain = last || command::waitingForMoves();
+	uint32_t ms;
+
+	// Full, the planner would have had to wait for the block being stepped
+	// before planning another, which leaves the rest to plan ahead
+	if ( ! drain ) {
+		if ( movesplanned() < BLOCK_BUFFER_SIZE - 3 )
+			return;
+		uint8_t index = block_buffer_tail;
+		if ( steppers::takeDryRunMove(&ms) ) {
+			account(index, ms);
+			waitFor(finish_ms);
+		}
+		return;
+	}
+
+	// Waiting for the moves to be done, it starts again from rest after
+	for (;;) {
+		uint8_t index = block_buffer_tail;
+		if ( ! steppers::takeDryRunMove(&ms) )
+			break;
+		account(index, ms);
+	}
+	if ( blocks_queued() )
+		return;
+	waitFor(finish_ms);
+	from_rest = true;
+
+	if ( last ) {
+		if ( sdcard::sdAvailable != sdcard::SD_SUCCESS )
+			end(DRY_RUN_SD_ERROR, sdcard::sdAvailable);
+		else
+			end(DRY_RUN_OK, 0);
+		// Clears away the filament counted and the like
+		command::reset();
+	}
+}
+
+void stop() {
+	if ( sdcard::sdAvailable != sdcard::SD_SUCCESS )
+		end(DRY_RUN_SD_ERROR, sdcard::sdAvailable);
+	else
+		end(DRY_RUN_CANCELLED, 0);
+}
+
+void fail(uint8_t command) {
+	if ( rep.error != DRY_RUN_OK )
+		return;
+	rep.error = DRY_RUN_BAD_COMMAND;
+	rep.detail = command;
+	rep.offset = playedOffset();
+	host::stopBuildNow();
+}
+
+const Report *report() {
+	return &rep;
+}
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __DRY_RUN_HH__
+#define __DRY_RUN_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A dry run of an SD card build, to check a file against this firmware.  The
+// file is played and planned as for a build, only the planner's blocks are
+// taken as soon as they're planned rather than stepped, the heaters, fans
+// and homing are left alone and nothing is waited for, so it runs as fast
+// as the commands can be read and planned.  The motors are taken to be
+// where they were before it once it's over.
+//
+// How far the moves were planned ahead of the steppers is worked out as
+// though they had been stepped: each block would start when the one before
+// it had run, or when it was planned if that was later, and the planning
+// would wait whenever the planner was full.  The lead is the motion time
+// queued ahead of each move as it was planned.
+
+#ifdef SD_DRY_RUN
+
+#include "SDCard.hh"
+
+namespace dryrun {
+
+enum {
+	DRY_RUN_NONE,		///< None since the last reset
+	DRY_RUN_RUNNING,
+	DRY_RUN_DONE
+};
+
+enum {
+	DRY_RUN_OK,
+	DRY_RUN_BAD_COMMAND,	///< detail is the command, which a build would stop at
+	DRY_RUN_SD_ERROR,	///< detail is the SdErrorCode
+	DRY_RUN_CANCELLED
+};
+
+typedef struct {
+	uint8_t state;
+	uint8_t error;
+	uint8_t detail;
+	uint32_t offset;	///< Bytes into the file the run got to
+	uint32_t moves;		///< Planner blocks
+	uint32_t planned_ms;	///< Time of their trapezoids
+	int32_t min_lead_ms;	///< Least motion time queued ahead of a move, negative if the steppers would have stalled
+	uint16_t starved;	///< Moves which would have stalled the steppers
+	uint32_t elapsed_ms;	///< How long the run took
+} Report;
+
+/// Start a dry run of the file name in the working directory
+sdcard::SdErrorCode start(char *name);
+
+/// True from start() until the commands of the file have all been run
+bool isRunning();
+
+/// Called by the stepper slice while running: takes the blocks planned
+void runSlice();
+
+/// Called when the build is stopped before its end
+void stop();
+
+/// Stop the run at command, which this firmware has no handler for
+void fail(uint8_t command);
+
+/// The report of the run, or of the last one
+const Report *report();
+
+}
+
+#endif
+
+#endif
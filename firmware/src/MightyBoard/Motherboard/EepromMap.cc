@@ -19,6 +19,7 @@
 #include "Model.hh"
 #include "EepromMap.hh"
 #include "Eeprom.hh"
+#include "StatsJournal.hh"
 #include <avr/eeprom.h>
 #include <avr/wdt.h>
 
@@ -60,7 +61,7 @@ namespace eeprom {
 void setDefaultCoolingFan(uint16_t eeprom_base){
 
 	uint8_t fan_settings[] = {1, DEFAULT_COOLING_FAN_SETPOINT_C};
-    eeprom_write_block( fan_settings, (uint8_t*)(eeprom_base + cooler_eeprom_offsets::ENABLE_OFFSET),2);
+    eeprom::writeBlock( fan_settings, (uint8_t*)(eeprom_base + cooler_eeprom_offsets::ENABLE_OFFSET),2);
 }
 
 
@@ -84,7 +85,7 @@ void setDefaultsThermistorTables()
 		DEFAULT_THERM_TABLE_EXT,
 		DEFAULT_THERM_TABLE_EXT,
 		DEFAULT_THERM_TABLE_HBP };
-	eeprom_write_block((void*)defs,
+	eeprom::writeBlock((void*)defs,
 			   (uint8_t*)(eeprom_offsets::TEMP_TABLE_INDICES),
 			   sizeof(defs));
 }
@@ -102,7 +103,7 @@ uint8_t getThermistorTable(uint8_t idx)
 
 void setThermistorTable(uint8_t idx, uint8_t index)
 {
-	eeprom_write_byte((uint8_t*)(eeprom_offsets::TEMP_TABLE_INDICES + idx),
+	eeprom::writeByte((uint8_t*)(eeprom_offsets::TEMP_TABLE_INDICES + idx),
 					  index);
 }
 
@@ -133,10 +134,10 @@ typedef struct Color {
 void setDefaultLedEffects(uint16_t eeprom_base)
 {
      // default color is white
-     eeprom_write_byte(
+     eeprom::writeByte(
 	  (uint8_t*)(eeprom_base + blink_eeprom_offsets::BASIC_COLOR_OFFSET),
 	  LED_DEFAULT_COLOR);
-     eeprom_write_byte(
+     eeprom::writeByte(
 	  (uint8_t*)(eeprom_base + blink_eeprom_offsets::LED_HEAT_OFFSET),
 	  LED_DEFAULT_HEAT_COLOR);
 
@@ -146,7 +147,7 @@ void setDefaultLedEffects(uint16_t eeprom_base)
      colors.red   = 0xFF;
      colors.green = 0xFF;
      colors.blue  = 0xFF;
-     eeprom_write_block(
+     eeprom::writeBlock(
 	  (void*)&colors,
 	  (uint8_t*)(eeprom_base + blink_eeprom_offsets::CUSTOM_COLOR_OFFSET),
 	  sizeof(colors));
@@ -155,13 +156,12 @@ void setDefaultLedEffects(uint16_t eeprom_base)
 #ifdef HAS_RGB_LED
 
 LEDColors getColor() {
-	return static_cast<LEDColors>(eeprom::getEeprom8(
-		eeprom_offsets::LED_STRIP_SETTINGS + blink_eeprom_offsets::BASIC_COLOR_OFFSET,
-		LED_DEFAULT_COLOR));
+	return static_cast<LEDColors>(eeprom::settings.led_color);
 }
 
 void setColor(uint8_t color) {
-	eeprom_write_byte((uint8_t*)eeprom_offsets::LED_STRIP_SETTINGS + blink_eeprom_offsets::BASIC_COLOR_OFFSET, color);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::LED_STRIP_SETTINGS + blink_eeprom_offsets::BASIC_COLOR_OFFSET, color);
+	loadSettings();
 }
 
 #endif
@@ -174,7 +174,7 @@ void setColor(uint8_t color) {
      */
 
 void setCustomColor(uint8_t red, uint8_t green, uint8_t blue) {
-	eeprom_write_byte(
+	eeprom::writeByte(
 	     (uint8_t*)(eeprom_offsets::LED_STRIP_SETTINGS +
 			blink_eeprom_offsets::BASIC_COLOR_OFFSET),
 	     LED_DEFAULT_CUSTOM);
@@ -183,11 +183,12 @@ void setCustomColor(uint8_t red, uint8_t green, uint8_t blue) {
 	colors.red   = red;
 	colors.green = green;
 	colors.blue  = blue;
-	eeprom_write_block(
+	eeprom::writeBlock(
 	     (void*)&colors,
 	     (uint8_t*)(eeprom_offsets::LED_STRIP_SETTINGS +
 			blink_eeprom_offsets::CUSTOM_COLOR_OFFSET),
 	     sizeof(colors));
+	loadSettings();
 }
 
     /**
@@ -197,8 +198,8 @@ void setCustomColor(uint8_t red, uint8_t green, uint8_t blue) {
      */
 void eeprom_write_sound(Sound sound, uint16_t dest)
 {
-	eeprom_write_word((uint16_t*)dest, 	sound.freq);
-	eeprom_write_word((uint16_t*)dest + 2, sound.durationMs);
+	eeprom::writeWord((uint16_t*)dest, 	sound.freq);
+	eeprom::writeWord((uint16_t*)dest + 2, sound.durationMs);
 }
 
 /**
@@ -217,10 +218,10 @@ void setDefaultBuzzEffects(uint16_t eeprom_base)
  */
 void setDefaultsPreheat(uint16_t eeprom_base)
 {
-    eeprom_write_word((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP), DEFAULT_PREHEAT_TEMP);
-    eeprom_write_word((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP), DEFAULT_PREHEAT_TEMP);
-    eeprom_write_word((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), DEFAULT_PREHEAT_HBP);
-    eeprom_write_byte((uint8_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_ON_OFF_OFFSET), (1<<HEAT_MASK_RIGHT) + (1<<HEAT_MASK_PLATFORM));
+    eeprom::writeWord((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP), DEFAULT_PREHEAT_TEMP);
+    eeprom::writeWord((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP), DEFAULT_PREHEAT_TEMP);
+    eeprom::writeWord((uint16_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), DEFAULT_PREHEAT_HBP);
+    eeprom::writeByte((uint8_t*)(eeprom_base + preheat_eeprom_offsets::PREHEAT_ON_OFF_OFFSET), (1<<HEAT_MASK_RIGHT) + (1<<HEAT_MASK_PLATFORM));
 }
 
 
@@ -231,34 +232,34 @@ void setDefaultsPreheat(uint16_t eeprom_base)
  */
 void setDefaultsAcceleration()
 {
-	eeprom_write_byte((uint8_t *) (eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::ACCELERATION_ACTIVE), 0x01);
+	eeprom::writeByte((uint8_t *) (eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::ACCELERATION_ACTIVE), 0x01);
 
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*0), DEFAULT_MAX_ACCELERATION_AXIS_X);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*1), DEFAULT_MAX_ACCELERATION_AXIS_Y);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*2), DEFAULT_MAX_ACCELERATION_AXIS_Z);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*3), DEFAULT_MAX_ACCELERATION_AXIS_A);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*4), DEFAULT_MAX_ACCELERATION_AXIS_B);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*0), DEFAULT_MAX_ACCELERATION_AXIS_X);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*1), DEFAULT_MAX_ACCELERATION_AXIS_Y);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*2), DEFAULT_MAX_ACCELERATION_AXIS_Z);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*3), DEFAULT_MAX_ACCELERATION_AXIS_A);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_AXIS + sizeof(uint16_t)*4), DEFAULT_MAX_ACCELERATION_AXIS_B);
 
 #ifdef OLD_ACCEL_LIMITS
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_NORMAL_MOVE),   DEFAULT_MAX_ACCELERATION_NORMAL_MOVE);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_EXTRUDER_MOVE), DEFAULT_MAX_ACCELERATION_EXTRUDER_MOVE);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_NORMAL_MOVE),   DEFAULT_MAX_ACCELERATION_NORMAL_MOVE);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_ACCELERATION_EXTRUDER_MOVE), DEFAULT_MAX_ACCELERATION_EXTRUDER_MOVE);
 #endif
 
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*0), DEFAULT_MAX_SPEED_CHANGE_X);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*1), DEFAULT_MAX_SPEED_CHANGE_Y);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*2), DEFAULT_MAX_SPEED_CHANGE_Z);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*3), DEFAULT_MAX_SPEED_CHANGE_A);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*4), DEFAULT_MAX_SPEED_CHANGE_B);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*0), DEFAULT_MAX_SPEED_CHANGE_X);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*1), DEFAULT_MAX_SPEED_CHANGE_Y);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*2), DEFAULT_MAX_SPEED_CHANGE_Z);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*3), DEFAULT_MAX_SPEED_CHANGE_A);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::MAX_SPEED_CHANGE + sizeof(uint16_t)*4), DEFAULT_MAX_SPEED_CHANGE_B);
 
-	eeprom_write_dword((uint32_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::JKN_ADVANCE_K),  DEFAULT_JKN_ADVANCE_K);
-	eeprom_write_dword((uint32_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::JKN_ADVANCE_K2), DEFAULT_JKN_ADVANCE_K2);
+	eeprom::writeDword((uint32_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::JKN_ADVANCE_K),  DEFAULT_JKN_ADVANCE_K);
+	eeprom::writeDword((uint32_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::JKN_ADVANCE_K2), DEFAULT_JKN_ADVANCE_K2);
 
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::EXTRUDER_DEPRIME_STEPS + sizeof(uint16_t)*0), DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
-	eeprom_write_word((uint16_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::EXTRUDER_DEPRIME_STEPS + sizeof(uint16_t)*1), DEFAULT_EXTRUDER_DEPRIME_STEPS_B);
-	eeprom_write_byte((uint8_t *)eeprom_offsets::EXTRUDER_DEPRIME_ON_TRAVEL, DEFAULT_EXTRUDER_DEPRIME_ON_TRAVEL);
-	eeprom_write_byte((uint8_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::SLOWDOWN_FLAG), DEFAULT_SLOWDOWN_FLAG);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::EXTRUDER_DEPRIME_STEPS + sizeof(uint16_t)*0), DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
+	eeprom::writeWord((uint16_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::EXTRUDER_DEPRIME_STEPS + sizeof(uint16_t)*1), DEFAULT_EXTRUDER_DEPRIME_STEPS_B);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::EXTRUDER_DEPRIME_ON_TRAVEL, DEFAULT_EXTRUDER_DEPRIME_ON_TRAVEL);
+	eeprom::writeByte((uint8_t *)(eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::SLOWDOWN_FLAG), DEFAULT_SLOWDOWN_FLAG);
 
-	eeprom_write_byte((uint8_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::DEFAULTS_FLAG), _BV(ACCELERATION_INIT_BIT));
+	eeprom::writeByte((uint8_t *)(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::DEFAULTS_FLAG), _BV(ACCELERATION_INIT_BIT));
 }
 
 /// Writes to EEPROM the default toolhead 'home' values to idicate toolhead offset
@@ -279,7 +280,7 @@ void setDefaultAxisHomePositions()
 #else
 	len = sizeof(uint32_t) * 5;
 #endif
-	eeprom_write_block((uint8_t*)&(homes[0]),(uint8_t*)(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS), len );
+	eeprom::writeBlock((uint8_t*)&(homes[0]),(uint8_t*)(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS), len );
 }
 
 /// Write to EEPROM the default profiles
@@ -289,7 +290,7 @@ void setDefaultsProfiles(uint16_t eeprom_base) {
 	uint32_t homeOffsets[PROFILES_HOME_POSITIONS_STORED];
 	const char *profileNames[] = {"ABS", "PLA", "Profile3", "Profile4" };
 
-	eeprom_read_block((void *)homeOffsets, (void *)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
+	eeprom::readBlock((void *)homeOffsets, (void *)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
 
 	for (uint8_t i = 0; i < PROFILES_QUANTITY; i ++ ) {
 		uint16_t profile_offset = eeprom_base + i * PROFILE_SIZE;
@@ -297,17 +298,24 @@ void setDefaultsProfiles(uint16_t eeprom_base) {
 		//Note this will overflow the string when strlen + 1 < PROFILE_NAME_SIZE, however it doesn't
 		//matter because it will overflow into the same array, and AVR isn't bright enough to segv,
 		//so we ignore that and save the 20 odd cycles it would take to check the length.
-		eeprom_write_block(profileNames[i],(uint8_t*)(profile_offset + profile_offsets::PROFILE_NAME), PROFILE_NAME_SIZE);
+		eeprom::writeBlock(profileNames[i],(uint8_t*)(profile_offset + profile_offsets::PROFILE_NAME), PROFILE_NAME_SIZE);
 
-		eeprom_write_block((void *)homeOffsets,(void *)(profile_offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
+		eeprom::writeBlock((void *)homeOffsets,(void *)(profile_offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
 
-    		eeprom_write_word((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP), DEFAULT_PREHEAT_TEMP);
-    		eeprom_write_word((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP), DEFAULT_PREHEAT_TEMP);
-    		eeprom_write_word((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP), (i == 1)?45:DEFAULT_PREHEAT_HBP);
+    		eeprom::writeWord((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP), DEFAULT_PREHEAT_TEMP);
+    		eeprom::writeWord((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP), DEFAULT_PREHEAT_TEMP);
+    		eeprom::writeWord((uint16_t*)(profile_offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP), (i == 1)?45:DEFAULT_PREHEAT_HBP);
+
+		uint16_t advance_offset = eeprom_offsets::ADVANCE_PROFILES + i * ADVANCE_PROFILE_SIZE;
+		eeprom::writeDword((uint32_t*)(advance_offset + advance_profile_offsets::JKN_ADVANCE_K), DEFAULT_JKN_ADVANCE_K);
+		eeprom::writeDword((uint32_t*)(advance_offset + advance_profile_offsets::JKN_ADVANCE_K2), DEFAULT_JKN_ADVANCE_K2);
+		eeprom::writeWord((uint16_t*)(advance_offset + advance_profile_offsets::DEPRIME_STEPS), DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
+		eeprom::writeWord((uint16_t*)(advance_offset + advance_profile_offsets::MAX_EXTRUSION_RATE), 0);
 	}
+	eeprom::writeByte((uint8_t*)eeprom_offsets::ADVANCE_PROFILE_ACTIVE, ADVANCE_PROFILE_NONE);
 
 	//Initialize a flag to tell us profiles have been initialized
-	eeprom_write_byte((uint8_t*)eeprom_offsets::PROFILES_INIT,PROFILES_INITIALIZED);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::PROFILES_INIT,PROFILES_INITIALIZED);
 }
 
 
@@ -340,12 +348,12 @@ void factoryResetEEPROM()
 #endif
 
 	/// Write 'MainBoard' settings
-	eeprom_write_block(THE_REPLICATOR_STR,
+	eeprom::writeBlock(THE_REPLICATOR_STR,
 			   (uint8_t*)eeprom_offsets::MACHINE_NAME,sizeof(THE_REPLICATOR_STR));
 
-	eeprom_write_block(&(vRefBase[0]),(uint8_t*)(eeprom_offsets::DIGI_POT_SETTINGS), 5 );
-	eeprom_write_byte((uint8_t*)eeprom_offsets::ENDSTOP_INVERSION, endstop_invert);
-	eeprom_write_byte((uint8_t*)eeprom_offsets::AXIS_HOME_DIRECTION, home_direction);
+	eeprom::writeBlock(&(vRefBase[0]),(uint8_t*)(eeprom_offsets::DIGI_POT_SETTINGS), 5 );
+	eeprom::writeByte((uint8_t*)eeprom_offsets::ENDSTOP_INVERSION, endstop_invert);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::AXIS_HOME_DIRECTION, home_direction);
 
 	SETDEFAULTAXISHOMEPOSITIONS(full_reset);
 
@@ -353,21 +361,22 @@ void factoryResetEEPROM()
 
 	wdt_reset();
 
-	/// store the default axis lengths for the machine
-	eeprom_write_block((uint8_t*)&(replicator_axis_lengths::axis_lengths[0]), (uint8_t*)(eeprom_offsets::AXIS_LENGTHS), 20);
-
-	/// store the default axis steps per mm for the machine
-	eeprom_write_block((uint8_t*)&(replicator_axis_steps_per_mm::axis_steps_per_mm[0]), (uint8_t*)(eeprom_offsets::AXIS_STEPS_PER_MM), 20);
-
-	/// store the default axis max feedrates for the machine
-	eeprom_write_block((uint8_t*)&(replicator_axis_max_feedrates::axis_max_feedrates[0]), (uint8_t*)(eeprom_offsets::AXIS_MAX_FEEDRATES), 20);
+	/// store the default axis lengths, steps per mm and max feedrates for the machine
+	for (uint8_t i = 0; i < 5; i++) {
+		eeprom::writeDword((uint32_t*)(eeprom_offsets::AXIS_LENGTHS) + i,
+				   AXIS_DEFAULT(replicator_axis_lengths::axis_lengths, i));
+		eeprom::writeDword((uint32_t*)(eeprom_offsets::AXIS_STEPS_PER_MM) + i,
+				   AXIS_DEFAULT(replicator_axis_steps_per_mm::axis_steps_per_mm, i));
+		eeprom::writeDword((uint32_t*)(eeprom_offsets::AXIS_MAX_FEEDRATES) + i,
+				   AXIS_DEFAULT(replicator_axis_max_feedrates::axis_max_feedrates, i));
+	}
 
 	setDefaultsAcceleration();
 
 	/// write MightyBoard VID/PID. Only after verification does production write
 	/// a proper 'The Replicator' PID/VID to eeprom, and to the USB chip
 	uint16_t vidPid[] = { 0x23C1, MACHINE_ID };
-	eeprom_write_block(&(vidPid[0]), (uint8_t*)eeprom_offsets::VID_PID_INFO, 4);
+	eeprom::writeBlock(&(vidPid[0]), (uint8_t*)eeprom_offsets::VID_PID_INFO, 4);
 
 	/// Write 'extruder 0' settings
 	setDefaultsExtruder(eeprom_offsets::T0_DATA_BASE);
@@ -386,49 +395,85 @@ void factoryResetEEPROM()
 	/// Preheat heater settings
 	setDefaultsPreheat(eeprom_offsets::PREHEAT_SETTINGS);
 
-	eeprom_write_byte((uint8_t*)eeprom_offsets::FILAMENT_HELP_SETTINGS, 1);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::FILAMENT_HELP_SETTINGS, 1);
 
 	// Set override gcode temp to off
-	eeprom_write_byte((uint8_t*)eeprom_offsets::OVERRIDE_GCODE_TEMP, DEFAULT_OVERRIDE_GCODE_TEMP);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::OVERRIDE_GCODE_TEMP, DEFAULT_OVERRIDE_GCODE_TEMP);
 
 	// Set heaters on during pause to a default of on
-	eeprom_write_byte((uint8_t*)eeprom_offsets::HEAT_DURING_PAUSE, DEFAULT_HEAT_DURING_PAUSE);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::HEAT_DURING_PAUSE, DEFAULT_HEAT_DURING_PAUSE);
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
 	// Sets ditto printing, defaults to off
-	eeprom_write_byte((uint8_t*)eeprom_offsets::DITTO_PRINT_ENABLED, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::DITTO_PRINT_ENABLED, 0);
 #endif
 
 	// Extruder hold
-	eeprom_write_byte((uint8_t *)eeprom_offsets::EXTRUDER_HOLD, DEFAULT_EXTRUDER_HOLD);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::EXTRUDER_HOLD, DEFAULT_EXTRUDER_HOLD);
 
 #ifdef TOOLHEAD_OFFSET_SYSTEM
 	// Toolhead offset system
-	eeprom_write_byte((uint8_t *)eeprom_offsets::TOOLHEAD_OFFSET_SYSTEM,
+	eeprom::writeByte((uint8_t *)eeprom_offsets::TOOLHEAD_OFFSET_SYSTEM,
 			  DEFAULT_TOOLHEAD_OFFSET_SYSTEM);
 #endif
 
 	// Use SD card CRC checking
-	eeprom_write_byte((uint8_t *)eeprom_offsets::SD_USE_CRC, DEFAULT_SD_USE_CRC);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::SD_USE_CRC, DEFAULT_SD_USE_CRC);
+
+	// Slow the interface down while the planner is short of moves
+	eeprom::writeByte((uint8_t *)eeprom_offsets::UI_PRINT_PRIORITY, DEFAULT_UI_PRINT_PRIORITY);
+
+	// Fast homing approach and back-off
+	eeprom::writeByte((uint8_t *)eeprom_offsets::HOMING_FAST_FEEDRATE + 0, DEFAULT_HOMING_FAST_FEEDRATE_X);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::HOMING_FAST_FEEDRATE + 1, DEFAULT_HOMING_FAST_FEEDRATE_Y);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::HOMING_FAST_FEEDRATE + 2, DEFAULT_HOMING_FAST_FEEDRATE_Z);
+	eeprom::writeByte((uint8_t *)eeprom_offsets::HOMING_BACKOFF, DEFAULT_HOMING_BACKOFF);
+
+	// Corner with the max speed changes
+	eeprom::writeByte((uint8_t *)eeprom_offsets::JUNCTION_DEVIATION, DEFAULT_JUNCTION_DEVIATION);
+
+	// Input shaper off, tuned for a typical frame
+	eeprom::writeByte((uint8_t *)eeprom_offsets::INPUT_SHAPER + input_shaper_offsets::TYPE, DEFAULT_INPUT_SHAPER_TYPE);
+	for (uint8_t i = 0; i < 2; i++) {
+		eeprom::writeByte((uint8_t *)eeprom_offsets::INPUT_SHAPER + input_shaper_offsets::FREQUENCY + 2 * i,
+				  DEFAULT_INPUT_SHAPER_FREQUENCY);
+		eeprom::writeByte((uint8_t *)eeprom_offsets::INPUT_SHAPER + input_shaper_offsets::DAMPING + 2 * i,
+				  DEFAULT_INPUT_SHAPER_DAMPING);
+	}
+
+	// No limit on the extrusion rate, for 1.75 mm filament
+	for (uint8_t i = 0; i < 2; i++) {
+		eeprom::writeWord((uint16_t *)(eeprom_offsets::EXTRUSION_LIMITS + extrusion_limit_offsets::MAX_VOLUMETRIC_FLOW + 4 * i),
+				  DEFAULT_MAX_VOLUMETRIC_FLOW);
+		eeprom::writeWord((uint16_t *)(eeprom_offsets::EXTRUSION_LIMITS + extrusion_limit_offsets::FILAMENT_DIAMETER + 4 * i),
+				  DEFAULT_FILAMENT_DIAMETER);
+	}
 
 	setToolHeadCount(0);
 
-	eeprom_write_byte((uint8_t*)eeprom_offsets::HBP_PRESENT,
+	eeprom::writeByte((uint8_t*)eeprom_offsets::HBP_PRESENT,
 					  DEFAULT_HBP_PRESENT);
 
-	eeprom_write_byte((uint8_t*)eeprom_offsets::ENABLE_ALTERNATE_UART, 0);
-	eeprom_write_byte((uint8_t*)eeprom_offsets::CLEAR_FOR_ESTOP, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::ENABLE_ALTERNATE_UART, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::CLEAR_FOR_ESTOP, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::FAST_CANCEL_ENABLE, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::PLATFORM_RELEASE_TEMP, DEFAULT_PLATFORM_RELEASE_TEMP);
+	for (uint8_t i = 0; i < 4; i++)
+		eeprom::writeByte((uint8_t*)eeprom_offsets::HEATER_PERIODS + i, 0);
+	for (uint8_t i = 0; i < 4; i++)
+		eeprom::writeByte((uint8_t*)eeprom_offsets::TRAVEL_PROFILE + i, 0);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::HEAT_WAIT_MOVES_ENABLE, 0);
 
 	{
 	     int32_t dummy = ALEVEL_MAX_ZDELTA_DEFAULT;
-	     eeprom_write_block(&dummy,
+	     eeprom::writeBlock(&dummy,
 				(uint8_t*)eeprom_offsets::ALEVEL_MAX_ZDELTA,
 				sizeof(int32_t));
 	}
-	eeprom_write_byte((uint8_t*)eeprom_offsets::ALEVEL_MAX_ZPROBE_HITS,
+	eeprom::writeByte((uint8_t*)eeprom_offsets::ALEVEL_MAX_ZPROBE_HITS,
 			  ALEVEL_MAX_ZPROBE_HITS_DEFAULT);
 
-	eeprom_write_byte((uint8_t*)eeprom_offsets::COOLING_FAN_DUTY_CYCLE,
+	eeprom::writeByte((uint8_t*)eeprom_offsets::COOLING_FAN_DUTY_CYCLE,
 			  COOLING_FAN_DUTY_CYCLE_DEFAULT);
 
 	{
@@ -437,21 +482,22 @@ void factoryResetEEPROM()
 				   ALEVEL_PROBE_P1_COMP,
 				   ALEVEL_PROBE_P2_COMP,
 				   ALEVEL_PROBE_P3_COMP };
-	     eeprom_write_block(
+	     eeprom::writeBlock(
 		  (uint8_t*)dummy,
 		  (uint8_t*)eeprom_offsets::ALEVEL_PROBE_OFFSETS,
 		  sizeof(uint32_t)*5);
 	}
 
 #ifdef PSTOP_SUPPORT
-	eeprom_write_byte((uint8_t*)eeprom_offsets::PSTOP_ENABLE,   DEFAULT_PSTOP_ENABLE);
-	eeprom_write_byte((uint8_t*)eeprom_offsets::PSTOP_INVERTED, DEFAULT_PSTOP_INVERTED);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::PSTOP_ENABLE,   DEFAULT_PSTOP_ENABLE);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::PSTOP_INVERTED, DEFAULT_PSTOP_INVERTED);
 #endif
 
 #if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
 	setDefaultsThermistorTables();
 #endif
 
+	loadSettings();
 }
 
 void setToolHeadCount(uint8_t count) {
@@ -469,10 +515,12 @@ void setToolHeadCount(uint8_t count) {
 	if ( count != 1 )
 	        count = 2;
 #endif
-	eeprom_write_byte((uint8_t*)eeprom_offsets::TOOL_COUNT, count);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::TOOL_COUNT, count);
 
 	// update XY axis offsets to match tool head settings
 	SETDEFAULTAXISHOMEPOSITIONS(false);
+
+	loadSettings();
 }
 
 #if EXTRUDERS > 1
@@ -484,7 +532,7 @@ bool isSingleTool(){
 	// MBI tested with == 1 BUT when writing this same value,
         //  they treat a value > 2 as implying 1.  SOOO, a better test
 	//  is to consider single anything which is != 2.
-	return (getEeprom8(eeprom_offsets::TOOL_COUNT, 1) != 2);
+	return (settings.tool_count != 2);
 }
 //#endif
 #else
@@ -492,7 +540,7 @@ bool isSingleTool() { return true; }
 #endif
 
 bool hasHBP() {
-	return (getEeprom8(eeprom_offsets::HBP_PRESENT, 1) == 1);
+	return (settings.hbp_present == 1);
 }
 
 //
@@ -500,17 +548,15 @@ void storeToolheadToleranceDefaults(){
 
 	// assume t0 to t1 distance is in specifications (0 steps tolerance error)
 	uint32_t offsets[3] = {TOOLHEAD_OFFSET_X, TOOLHEAD_OFFSET_Y, 0};
-	eeprom_write_block((uint8_t*)&(offsets[0]),(uint8_t*)(eeprom_offsets::TOOLHEAD_OFFSET_SETTINGS), 12 );
+	eeprom::writeBlock((uint8_t*)&(offsets[0]),(uint8_t*)(eeprom_offsets::TOOLHEAD_OFFSET_SETTINGS), 12 );
 }
 
 void getBuildTime(uint16_t *hours, uint8_t *minutes) {
-	*hours = eeprom::getEeprom16(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::HOURS,0);
-	*minutes = eeprom::getEeprom8(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::MINUTES,0);
+	journal::getBuildTime(hours, minutes);
 }
 
 void setBuildTime(uint16_t hours, uint8_t minutes) {
-	eeprom_write_word((uint16_t*)(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::HOURS), hours);
-	eeprom_write_byte((uint8_t*)(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::MINUTES), minutes);
+	journal::setBuildTime(hours, minutes);
 }
 
 void updateBuildTime(uint16_t new_hours, uint8_t new_minutes) {
@@ -547,7 +593,7 @@ void fullResetEEPROM() {
 #else
 	uint8_t axis_invert = PLATFORM_AXIS_INVERT;
 #endif
-	eeprom_write_byte((uint8_t*)eeprom_offsets::AXIS_INVERSION, axis_invert);
+	eeprom::writeByte((uint8_t*)eeprom_offsets::AXIS_INVERSION, axis_invert);
 
 	// tool count settings
 	setToolHeadCount(0);
@@ -558,11 +604,11 @@ void fullResetEEPROM() {
 	// set build time to zero
 	setBuildTime((uint16_t)0, (uint8_t)0);
 
-	eeprom_write_byte((uint8_t*)(eeprom_offsets::BOTSTEP_TYPE), BOTSTEP_16_STEP);
+	eeprom::writeByte((uint8_t*)(eeprom_offsets::BOTSTEP_TYPE), BOTSTEP_16_STEP);
 
 	// filament lifetime counter
-	setEepromInt64(eeprom_offsets::FILAMENT_LIFETIME, 0);
-	setEepromInt64(eeprom_offsets::FILAMENT_LIFETIME + sizeof(int64_t), 0);
+	journal::setFilament(0, 0);
+	journal::setFilament(1, 0);
 
 	FACTORYRESETEEPROM(true);
 }
@@ -570,13 +616,7 @@ void fullResetEEPROM() {
 #ifdef HAS_RGB_LED
 
 bool heatLights() {
-     return
-	  ( LED_DEFAULT_OFF != eeprom::getEeprom8( // LEDs enabled
-	       eeprom_offsets::LED_STRIP_SETTINGS, LED_DEFAULT_OFF) ) &&
-	  ( LED_DEFAULT_OFF != eeprom::getEeprom8( // Heat progress enabled
-		   eeprom_offsets::LED_STRIP_SETTINGS +
-		   blink_eeprom_offsets::LED_HEAT_OFFSET,
-		   LED_DEFAULT_HEAT_COLOR) );
+     return settings.heat_lights;
 }
 
 #endif
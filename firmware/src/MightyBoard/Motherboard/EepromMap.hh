@@ -27,6 +27,17 @@
 #include <stdint.h>
 #include "Model.hh"
 
+// The default axis tables below are in flash, read with AXIS_DEFAULT()
+#if !defined(SIMULATOR)
+#include <avr/pgmspace.h>
+#define AXIS_DEFAULT(table, i) pgm_read_dword(&(table)[i])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define AXIS_DEFAULT(table, i) ((table)[i])
+#endif
+
 enum LEDColors {
     LED_DEFAULT_WHITE = 0,
     LED_DEFAULT_RED,
@@ -152,9 +163,9 @@ namespace replicator_axis_lengths{
 	// These are the maximum lengths of all axis, and are populated from Replicator G
 	// on connection.  These are reasonable defaults for X/Y/Z/A/B
 	// Each one is the length(in mm's) * steps_per_mm  (from the xml file and the result is rounded down)
-	const static uint32_t axis_lengths[5] = {227L, 148L, 150L, 100000L, 100000L};
+	const static uint32_t axis_lengths[5] PROGMEM = {227L, 148L, 150L, 100000L, 100000L};
 #else
-	const static uint32_t axis_lengths[5] = PLATFORM_AXIS_LENGTHS;
+	const static uint32_t axis_lengths[5] PROGMEM = PLATFORM_AXIS_LENGTHS;
 #endif
 }
 
@@ -163,17 +174,17 @@ namespace replicator_axis_max_feedrates{
 	// These are the maximum feedrates of all axis, and are populated from Replicator G
 	// on connection.  These are reasonable defaults for X/Y/Z/A/B
 	// Each one is the feedrate in mm per minute (extruders are the feedrate of the input filament)
-	const static uint32_t axis_max_feedrates[5] = {18000, 18000, 1170, 1600, 1600};
+	const static uint32_t axis_max_feedrates[5] PROGMEM = {18000, 18000, 1170, 1600, 1600};
 #else
-	const static uint32_t axis_max_feedrates[5] = PLATFORM_MAX_FEEDRATES;
+	const static uint32_t axis_max_feedrates[5] PROGMEM = PLATFORM_MAX_FEEDRATES;
 #endif
 }
 
 namespace replicator_axis_steps_per_mm{
 #if !defined(PLATFORM_AXIS_STEPS_PER_MM)
-	const static uint32_t axis_steps_per_mm[5] = { 94139704, 94139704, 400000000, 96275202, 96275202};
+	const static uint32_t axis_steps_per_mm[5] PROGMEM = { 94139704, 94139704, 400000000, 96275202, 96275202};
 #else
-	const static uint32_t axis_steps_per_mm[5] = PLATFORM_AXIS_STEPS_PER_MM;
+	const static uint32_t axis_steps_per_mm[5] PROGMEM = PLATFORM_AXIS_STEPS_PER_MM;
 #endif
 
 	/// Footnote:
@@ -474,6 +485,138 @@ const static uint16_t ALEVEL_P2                = 0x0E31;//0x0E2C;
 //$type:iii $ignore:True $unit:steps
 const static uint16_t ALEVEL_P3                = 0x0E3D;//0x0E38;
 
+//Print priority (1 byte): slow the interface down while the planner is
+//short of moves
+//$BEGIN_ENTRY
+//$type:B $constraints:l,0,1 $tooltip:Check or set to 1 to update the display and read the buttons less often while the printer is running short of moves, leaving more time for feeding it commands.  Uncheck or set to zero to always update the display at full rate.
+const static uint16_t UI_PRINT_PRIORITY        = 0x0E49;
+#define DEFAULT_UI_PRINT_PRIORITY 1
+
+//Fast homing speeds (3 bytes): mm/s of the accelerated approach to the
+//endstops of X, Y and Z, before backing off and homing at the speed asked
+//for.  Zero homes the axis at that speed only.
+//$BEGIN_ENTRY
+//$type:BBB $unit:mm/s $tooltip:Speeds in mm/s at which to first approach the X, Y and Z endstops when homing, accelerating up to speed.  The axis then backs off and homes again at the speed given by the homing command.  Speeds above the axis' maximum feedrate are taken as the maximum.  Set an axis to 0 to home it at the commanded speed only.
+const static uint16_t HOMING_FAST_FEEDRATE     = 0x0E4A;
+#define DEFAULT_HOMING_FAST_FEEDRATE_X 60
+#define DEFAULT_HOMING_FAST_FEEDRATE_Y 60
+#define DEFAULT_HOMING_FAST_FEEDRATE_Z 10
+
+//Back-off after the fast homing approach (1 byte), in 0.1 mm
+//$BEGIN_ENTRY
+//$type:B $unit:0.1 mm $constraints:l,5,250 $tooltip:Distance in tenths of a millimeter to back off from the endstops after the fast homing approach, before homing again at the commanded speed.  The default is 30 (3 mm).
+const static uint16_t HOMING_BACKOFF           = 0x0E4D;
+#define DEFAULT_HOMING_BACKOFF 30
+
+//Junction deviation (1 byte), in 0.01 mm: how far the planner may let the
+//path of an accelerated corner stray from the corner when working out the
+//speed to take it at.  Zero keeps the max speed change limits for X, Y and Z.
+//$BEGIN_ENTRY
+//$type:B $unit:0.01 mm $constraints:l,0,200 $tooltip:Distance in hundredths of a millimeter by which the path of the nozzle would stray from a corner were it taken as a curve; the planner takes each corner at the speed which that curve allows.  This corners faster than the per axis max speed changes on the shallow angles of curves made of small segments.  Try 5 (0.05 mm).  Set to 0 to use the max speed changes for X, Y and Z as before.  The extruders always use their max speed changes.
+const static uint16_t JUNCTION_DEVIATION       = 0x0E4E;
+#define DEFAULT_JUNCTION_DEVIATION 0
+
+//Heater models for the feed-forward of HEATER_FEED_FORWARD builds, 8 bytes
+//each for tool 0, tool 1 and the platform: gain (C), time constant (s),
+//dead time (0.1 s) and ambient (C).  Written by the model tune.
+//$BEGIN_ENTRY
+//$type:HHHhHHHhHHHh $ignore:True
+const static uint16_t HEATER_MODEL_SETTINGS    = 0x0E50;
+
+//Grid of Z heights for AUTO_LEVEL_MESH builds: the X and Y of the first
+//and last points probed, the Z of the first point, the grid size (X | Y << 4)
+//once the whole grid is in, then the Z of each point less the first's as
+//16 bit values, row by row.  Up to 0x0F44, 100 points.  Written by the
+//mesh level command.
+//$BEGIN_ENTRY
+//$type:iiiiiB $ignore:True $unit:steps
+const static uint16_t ALEVEL_MESH              = 0x0E68;
+const static uint16_t ALEVEL_MESH_END          = 0x0F45;
+
+//Extrusion limits (8 bytes): for tool 0 and then tool 1, the most the hot
+//end can melt in mm³/s, 0 for no limit, and the filament diameter in 0.01 mm;
+//see extrusion_limit_offsets
+//$BEGIN_ENTRY
+//$type:HHHH $tooltip:For the right and then the left extruder, the greatest volume of filament in cubic millimeters per second which the hot end can melt, followed by the diameter of the filament in hundredths of a millimeter (175 for 1.75 mm).  Any move which would extrude faster is slowed to this rate; moves within it keep their speed.  Set the volume to 0 for no limit.
+const static uint16_t EXTRUSION_LIMITS         = 0x0BC2;
+#define DEFAULT_MAX_VOLUMETRIC_FLOW 0
+#define DEFAULT_FILAMENT_DIAMETER 175
+
+//Advance profiles, 12 bytes each for the PROFILES_QUANTITY profiles at
+//PROFILES_BASE, whose names they go by; see advance_profile_offsets
+//$BEGIN_ENTRY
+//$type:IIHHIIHHIIHHIIHH $ignore:True
+const static uint16_t ADVANCE_PROFILES         = 0x0BCA;
+
+//Advance profile in use (1 byte), 0xFF for the JKN advance and deprime
+//settings of ACCELERATION2_SETTINGS
+//$BEGIN_ENTRY
+//$type:B $constraints:l,0,255 $tooltip:The advance profile to print with, 0 to 3, picked from the profiles menu or by the host.  Each profile has its own JKN advance K and K2, deprime steps and max extrusion rate.  Set to 255 to use the JKN advance and deprime settings.
+const static uint16_t ADVANCE_PROFILE_ACTIVE   = 0x0BFA;
+#define ADVANCE_PROFILE_NONE 0xFF
+
+//Input shaper of INPUT_SHAPING builds (5 bytes): the type, then the resonant
+//frequency and damping of X and then of Y; see input_shaper_offsets
+//$BEGIN_ENTRY
+//$type:BBBBB $tooltip:Input shaper type (0 = off, 1 = ZV, 2 = ZVD), then for X and then Y the frequency in Hz at which the axis rings and its damping ratio in hundredths.  Shaping counters the ringing of each axis at its frequency, at the cost of rounding corners a little.  ZVD copes better with a frequency which is a little off, but rounds corners more.  Needs firmware built with INPUT_SHAPING.
+const static uint16_t INPUT_SHAPER             = 0x0BFB;
+#define DEFAULT_INPUT_SHAPER_TYPE 0
+#define DEFAULT_INPUT_SHAPER_FREQUENCY 40
+#define DEFAULT_INPUT_SHAPER_DAMPING 10
+
+//Journal of the lifetime filament counters and build time, 24 records of
+//21 bytes written round the region in turn (see StatsJournal.cc).  The
+//newest record takes the place of FILAMENT_LIFETIME and TOTAL_BUILD_TIME,
+//which are only read if the journal is empty.
+//$BEGIN_ENTRY
+//$type:B $ignore:True
+const static uint16_t STATS_JOURNAL            = 0x0C00;
+const static uint16_t STATS_JOURNAL_END        = 0x0E00;
+
+//Heater periods (4 bytes): how often the extruders' sensors are read and
+//how often their PID is run, then the same for the platform, in hundredths
+//of a second; see heater_period_offsets.  0 keeps the firmware's own.
+//$BEGIN_ENTRY
+//$type:BBBB $unit:0.01 s $tooltip:For the extruders and then the platform, the time in hundredths of a second between readings of the temperature sensor, then between runs of the PID.  Set either to 0 for the firmware's default: readings as often as the board's sensors allow, and a PID run on every reading.  A platform heats and cools slowly, so it can be read every second or two; the PID gains count in runs, so run the PID autotune again after changing a PID period.  Readings no closer than 0.25 s (extruders) and 0.1 s (platform) are taken, and the boards with a dual thermocouple reader read the extruders on their own schedule.  Takes effect at the next reset.
+const static uint16_t HEATER_PERIODS           = 0x0A28;
+
+//Travel profile of TRAVEL_ACCELERATION builds (4 bytes): the acceleration
+//of moves which don't extrude as a percentage of each axis's max
+//acceleration, then their junction deviation; see travel_profile_offsets.
+//$BEGIN_ENTRY
+//$type:HBB $tooltip:For moves which don't extrude, first the max acceleration of each of X, Y and Z as a percentage of its max acceleration for printing (0 or 100 for the same), then the junction deviation in hundredths of a millimeter (0 for the same as printing).  Travel can usually take 150% or more of the printing acceleration and twice the junction deviation; the accelerations are still held to what the stepper timing can do.  The last byte is unused.  Needs firmware built with TRAVEL_ACCELERATION.  Takes effect from the next move planned.
+const static uint16_t TRAVEL_PROFILE           = 0x0A24;
+
+//Moves while heating of HEAT_WAIT_MOVES builds (1 byte)
+//$BEGIN_ENTRY
+//$type:B $constraints:l,0,1 $tooltip:Check or set to 1 to let the moves which don't extrude go on while the build waits for its heaters: homing, probing and travel go ahead, and only the first move which turns an extruder waits for the heaters to come up to temperature.  That saves the time the start of a build spends at the heat up and then homing.  Uncheck or set to 0 for the build to stop at each wait until the heaters are ready.  Needs firmware built with HEAT_WAIT_MOVES.
+const static uint16_t HEAT_WAIT_MOVES_ENABLE   = 0x0A23;
+
+//Platform release temperature of PLATFORM_COOLDOWN builds (1 byte), in C
+//$BEGIN_ENTRY
+//$type:B $constraints:m,0,120 $unit:C $tooltip:The temperature in C which the build platform must cool down to, with its heater off, before a build can be taken off it.  The host can tell when it has from HOST_CMD_BOARD_STATUS, and a print queue's "cool" line without a temperature waits for it.  Needs firmware built with PLATFORM_COOLDOWN.
+const static uint16_t PLATFORM_RELEASE_TEMP    = 0x0A2C;
+#define DEFAULT_PLATFORM_RELEASE_TEMP 40
+
+//Fast cancel of FAST_CANCEL builds (1 byte)
+//$BEGIN_ENTRY
+//$type:B $constraints:l,0,1 $tooltip:Check or set to 1 to cancel builds quickly: the bot slows to a stop within the move it's in, drops the rest of the build, turns the heaters off and moves clear of the build straight away.  Uncheck or set to 0 to stop dead and then clear the build as a pause does, waiting out each step in turn.  Needs firmware built with FAST_CANCEL.
+const static uint16_t FAST_CANCEL_ENABLE       = 0x0A2D;
+
+//Power loss resume of POWER_LOSS_RESUME builds: the name of the SD card file
+//being built (31 bytes), whether it was cut short (1 byte, 1 from the first
+//checkpoint until the build ends), then 12 checkpoints of 31 bytes written
+//round the region in turn (see Checkpoint.cc)
+//$BEGIN_ENTRY
+//$type:B $ignore:True
+const static uint16_t RESUME_FILE              = 0x0A2E;
+const static uint16_t RESUME_STATE             = 0x0A4D;
+const static uint16_t RESUME_CHECKPOINTS       = 0x0A4E;
+const static uint16_t RESUME_CHECKPOINTS_END   = 0x0BC2;
+#define RESUME_FILE_LEN 31
+#define RESUME_STATE_NONE 0
+#define RESUME_STATE_ACTIVE 1
+
 //Stop clears build platform (1 byte)
 //$BEGIN_ENTRY
 //$type:B $constraints:l,0,1 $tooltip:Check or set to 1 to instruct the printer to clear the build away from the extruder before stopping.  Uncheck or set to zero to immediately stop the printer (e.g., perform an Emergency Stop).
@@ -638,6 +781,41 @@ const static uint16_t FUTURE_USE            = 0x0E; //18 bytes for future use
 //0x1C is end of acceleration2 settings (28 bytes long)
 }
 
+namespace extrusion_limit_offsets{
+const static uint16_t MAX_VOLUMETRIC_FLOW = 0x00; //uint16_t, mm³/s
+const static uint16_t FILAMENT_DIAMETER   = 0x02; //uint16_t, 0.01 mm
+// 4 further on for tool 1
+}
+
+namespace advance_profile_offsets{
+const static uint16_t JKN_ADVANCE_K      = 0x00; //uint32_t, factor * 100000
+const static uint16_t JKN_ADVANCE_K2     = 0x04; //uint32_t, factor * 100000
+const static uint16_t DEPRIME_STEPS      = 0x08; //uint16_t, A and B alike
+// The top speed of the filament on printing moves, in mm/s, 0 for no limit
+// other than EXTRUSION_LIMITS
+const static uint16_t MAX_EXTRUSION_RATE = 0x0A; //uint16_t
+#define ADVANCE_PROFILE_SIZE 12
+}
+
+namespace travel_profile_offsets{
+const static uint16_t ACCELERATION       = 0x00; //uint16_t, percent
+const static uint16_t JUNCTION_DEVIATION = 0x02; //uint8_t, 0.01 mm
+}
+
+namespace heater_period_offsets{
+const static uint16_t SAMPLE   = 0x00; //uint8_t, 0.01 s
+const static uint16_t PID      = 0x01; //uint8_t, 0.01 s
+// The extruders' first, then the platform's this far on
+const static uint16_t PLATFORM = 0x02;
+}
+
+namespace input_shaper_offsets{
+const static uint16_t TYPE      = 0x00;
+// Of X, 2 further on for Y
+const static uint16_t FREQUENCY = 0x01;
+const static uint16_t DAMPING   = 0x02;
+}
+
 namespace build_time_offsets{
 //$BEGIN_ENTRY
 //$type:H $ignore:True $constraints:a
@@ -0,0 +1,112 @@
+/*
+ *  Ring of the last blocks the steppers ran, frozen when a build stutters
+ *  or fails and read back over the host interface.
+ */
+
+#include "Compat.hh"
+#include "FlightRecorder.hh"
+
+#ifdef FLIGHT_RECORDER
+
+#include "Motherboard.hh"
+#include "Xmem.hh"
+#include <util/atomic.h>
+#include <string.h>
+
+namespace flightrec {
+
+// As for the host log, a record's slot is its sequence number modulo the
+// size
+#if (FLIGHT_RECORDER_RECORDS & (FLIGHT_RECORDER_RECORDS - 1)) != 0 || FLIGHT_RECORDER_RECORDS > 128
+#error FLIGHT_RECORDER_RECORDS must be a power of two, no more than 128
+#endif
+
+static BlockRecord records[FLIGHT_RECORDER_RECORDS] XMEM_FLIGHT_RECORDER_DATA;
+
+static uint16_t next = 0;		///< Sequence number of the next record
+static uint8_t held = 0;		///< Records held, up to FLIGHT_RECORDER_RECORDS
+static uint8_t cause = FREEZE_NONE;
+static uint16_t frozen_after;
+static micros_t last_time;		///< When the last record was taken
+
+static uint16_t cap16(uint32_t v) {
+	return ( v > 0xffff ) ? 0xffff : (uint16_t)v;
+}
+
+void record(const block_t *block) {
+	if ( cause != FREEZE_NONE ) return;
+
+	uint8_t wrap;
+	micros_t now = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	BlockRecord *r = &records[next % FLIGHT_RECORDER_RECORDS];
+	r->interval = ( held == 0 ) ? 0xffff : cap16(now - last_time);
+	last_time = now;
+	r->steps = cap16(block->step_event_count);
+	r->initial_rate = cap16(block->initial_rate);
+	r->nominal_rate = cap16(block->nominal_rate);
+	r->final_rate = cap16(block->final_rate);
+	r->accel = cap16(block->acceleration_st >> 4);
+	r->depth = movesplanned();
+	r->flags = block->dda_master_axis_index << FLIGHT_AXIS_SHIFT;
+	if ( block->use_accel ) r->flags |= FLIGHT_ACCEL;
+	if ( block->decelerate_after > block->accelerate_until ) r->flags |= FLIGHT_CRUISE;
+
+	next ++;
+	if ( held < FLIGHT_RECORDER_RECORDS ) held ++;
+}
+
+void freeze(uint8_t why) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if ( cause != FREEZE_NONE ) return;
+		uint8_t wrap;
+		frozen_after = ( held == 0 ) ? 0xffff :
+			cap16(Motherboard::getBoard().getCurrentCentaMicros(&wrap) - last_time);
+		cause = why;
+	}
+}
+
+void arm() {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		next = 0;
+		held = 0;
+		cause = FREEZE_NONE;
+	}
+}
+
+uint8_t frozen() {
+	return cause;
+}
+
+uint16_t frozenAfter() {
+	return ( cause != FREEZE_NONE ) ? frozen_after : 0;
+}
+
+uint16_t getNext() {
+	uint16_t n;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		n = next;
+	}
+	return n;
+}
+
+uint16_t getOldest() {
+	uint16_t n;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		n = next - held;
+	}
+	return n;
+}
+
+bool getRecord(uint16_t seq, BlockRecord *record) {
+	bool ok;
+	// The interrupt may be writing over the oldest one
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ok = (uint16_t)(next - 1 - seq) < held;
+		if ( ok ) memcpy(record, &records[seq % FLIGHT_RECORDER_RECORDS], sizeof(BlockRecord));
+	}
+	return ok;
+}
+
+}
+
+#endif
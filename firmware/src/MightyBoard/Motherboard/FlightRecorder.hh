@@ -0,0 +1,87 @@
+#ifndef __FLIGHT_RECORDER_HH__
+#define __FLIGHT_RECORDER_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A ring of the last blocks the stepper interrupt took from the planner:
+// their steps and rates, how long after the block before each was set up
+// and how many blocks were queued then.  When the steppers run dry in mid
+// build, an error is shown or the build is paused, the ring is frozen with
+// the cause, so the blocks leading up to a stutter can be read back with
+// HOST_CMD_FLIGHT_RECORDER after the fact.  Recording starts at power up,
+// and again when the host clears the ring.  Each record's interval is how
+// long the block before it really took, which calibrate_time.py reads back
+// to fit sailtime's estimates to the machine.
+
+#ifdef FLIGHT_RECORDER
+
+#include "StepperAccelPlanner.hh"
+
+// 14 bytes each; a power of two
+#ifndef FLIGHT_RECORDER_RECORDS
+#if defined(XMEM) && defined(XMEM_FLIGHT_RECORDER)
+#define FLIGHT_RECORDER_RECORDS	128
+#else
+#define FLIGHT_RECORDER_RECORDS	16
+#endif
+#endif
+
+namespace flightrec {
+
+// Why the ring was frozen, 0 while it's still recording
+enum {
+	FREEZE_NONE	= 0,
+	FREEZE_UNDERRUN	= 1,	///< The planner ran dry in mid build
+	FREEZE_ERROR	= 2,	///< A heater failed or an error message was shown
+	FREEZE_PAUSE	= 3,	///< The build was paused
+	FREEZE_HOST	= 4	///< Asked for with HOST_CMD_FLIGHT_RECORDER
+};
+
+// Bits of BlockRecord::flags; the master axis is in bits 2 to 4
+#define FLIGHT_ACCEL		0x01	///< The block is accelerated
+#define FLIGHT_CRUISE		0x02	///< It reaches its nominal rate, else it's a triangle
+#define FLIGHT_AXIS_SHIFT	2
+
+typedef struct {
+	uint16_t interval;	///< Hundreds of microseconds since the block before was set up, 0xffff for longer
+	uint16_t steps;		///< Step events, 0xffff for more
+	uint16_t initial_rate;	///< Steps a second at the start, at the nominal rate and at the end
+	uint16_t nominal_rate;
+	uint16_t final_rate;
+	uint16_t accel;		///< Steps a second squared over 16, 0xffff for more
+	uint8_t depth;		///< Blocks in the planner, this one included
+	uint8_t flags;		///< FLIGHT_ bits
+} BlockRecord;
+
+/// Called by setup_next_block() in the stepper interrupt
+void record(const block_t *block);
+
+/// Stop recording with the cause, unless the ring is already frozen
+void freeze(uint8_t cause);
+
+/// Clear the ring and record again
+void arm();
+
+/// The FREEZE_ cause
+uint8_t frozen();
+
+/// Hundreds of microseconds from the last record to the freeze, 0xffff for
+/// longer
+uint16_t frozenAfter();
+
+/// Sequence number of the next record; it counts from 0 when armed and
+/// wraps
+uint16_t getNext();
+
+/// Sequence number of the oldest record held
+uint16_t getOldest();
+
+/// Copy record seq, returns false if it isn't held
+bool getRecord(uint16_t seq, BlockRecord *record);
+
+}
+
+#endif
+
+#endif
@@ -28,12 +28,28 @@
 #include <avr/eeprom.h>
 #include <avr/pgmspace.h>
 #include <util/delay.h>
+#include <util/crc16.h>
 #include <avr/wdt.h>
 #include "Main.hh"
 #include "Errors.hh"
 #include "Eeprom.hh"
 #include "EepromMap.hh"
+#include "StatsJournal.hh"
 #include "UtilityScripts.hh"
+#include "IsrProfile.hh"
+#include "MemoryProfile.hh"
+#include "Scheduler.hh"
+#include "HeaterLog.hh"
+#include "HostLog.hh"
+#include "FlightRecorder.hh"
+#include "PcProfile.hh"
+#include "PrintQueue.hh"
+#include "Cooldown.hh"
+#include "Checkpoint.hh"
+#include "PreScan.hh"
+#include "DryRun.hh"
+#include "LayerLog.hh"
+#include "StepperAccelPlanner.hh"
 #include "stdio.h"
 
 #ifdef HAS_RGB_LED
@@ -42,13 +58,8 @@
 
 namespace host {
 
-/// Identify a command packet, and process it.  If the packet is a command
-/// packet, return true, indicating that the packet has been queued and no
-/// other processing needs to be done. Otherwise, processing of this packet
-/// should drop through to the next processing level.
-bool processCommandPacket(const InPacket& from_host, OutPacket& to_host);
+void processCommandPacket(const InPacket& from_host, OutPacket& to_host);
 bool processQueryPacket(const InPacket& from_host, OutPacket& to_host);
-bool processExtruderQueryPacket(const InPacket& from_host, OutPacket& to_host);
 
 // Timeout from time first bit recieved until we abort packet reception
 Timeout packet_in_timeout;
@@ -59,6 +70,66 @@ bool buildWasCancelled;
 #define HOST_PACKET_TIMEOUT_MS 200
 #define HOST_PACKET_TIMEOUT_MICROS (1000L*HOST_PACKET_TIMEOUT_MS)
 
+// Baud rate of the host link after reset, and how long it may stay at a
+// negotiated rate without a packet arriving before going back to it
+#define HOST_DEFAULT_BAUD 115200L
+#define HOST_BAUD_LINK_TIMEOUT_MS 2000
+#define HOST_BAUD_LINK_TIMEOUT_MICROS (1000L*HOST_BAUD_LINK_TIMEOUT_MS)
+
+static uint32_t pending_baud = 0;
+static bool fast_baud = false;
+Timeout baud_link_timeout;
+
+// How many packets the host may send ahead of the replies once it has turned
+// on HOST_CMD_SET_PACKET_WINDOW: as many as the UART can hold, as the reply
+// to one goes only after its slot has been freed.
+#define HOST_PACKET_WINDOW UART_IN_PACKETS
+
+static bool packet_window = false;
+static uint8_t expected_seq;
+static bool credit_mode = false;
+
+#ifdef HOST_LARGE_PACKETS
+static bool large_packets = false;
+#define HOST_PACKET_LIMIT	( large_packets ? MAX_IN_PACKET_PAYLOAD : MAX_PACKET_PAYLOAD )
+
+static void setLargePackets(bool on) {
+	large_packets = on;
+	UART::getHostUART().setInPacketLimit(HOST_PACKET_LIMIT);
+}
+#else
+#define HOST_PACKET_LIMIT	MAX_PACKET_PAYLOAD
+#endif
+
+#if defined(EEPROM_IMAGE) && !defined(EEPROM_IMAGE_CHUNK)
+// Bytes of an EEPROM image decoded and compared at a time, twice that of stack
+#define EEPROM_IMAGE_CHUNK	64
+#endif
+
+#if HOST_TELEMETRY
+// The shortest period for the status frames of HOST_CMD_SET_TELEMETRY, so
+// that they can't crowd out the replies
+#define HOST_TELEMETRY_MIN_MS 50
+
+static uint16_t telemetry_ms = 0;	// 0 while the frames are off
+static uint8_t telemetry_count;
+Timeout telemetry_timeout;
+
+static void sendTelemetry(OutPacket& out);
+#endif
+
+#ifdef HOST_FLOW_CONTROL_PIN
+// The room the command buffer needs for the USB bridge to keep passing on
+// packets: the UART's slots and one more on the wire, each of them full.
+// The line is released again once there's a further packet's worth.
+#define HOST_FLOW_HOLD_ROOM	((UART_IN_PACKETS + 1) * HOST_PACKET_LIMIT)
+#define HOST_FLOW_RELEASE_ROOM	(HOST_FLOW_HOLD_ROOM + HOST_PACKET_LIMIT)
+
+static bool flow_held = false;
+
+static void updateFlowControl();
+#endif
+
 //#define HOST_TOOL_RESPONSE_TIMEOUT_MS 50
 //#define HOST_TOOL_RESPONSE_TIMEOUT_MICROS (1000L*HOST_TOOL_RESPONSE_TIMEOUT_MS)
 
@@ -101,21 +172,59 @@ bool hard_reset = false;
 bool cancelBuild = false;
 
 void runHostSlice() {
+#ifdef HOST_FLOW_CONTROL_PIN
+	updateFlowControl();
+#endif
+
 	// If we're cancelling the build, and we have completed pausing,
 	// then we cancel the build
 	if (( buildState == BUILD_CANCELLING ) && ( command::pauseState() == PAUSE_STATE_PAUSED )) {
 		stopBuildNow();
 	}
+#ifdef FAST_CANCEL
+	// A fast cancel is over once its moves are planned
+	else if (( buildState == BUILD_CANCELLING ) && command::fastCancelParking()) {
+		stopBuildNow();
+	}
+#endif
 
-        InPacket& in = UART::getHostUART().in;
         OutPacket& out = UART::getHostUART().out;
 	if (out.isSending() &&
 	    (( ! do_host_reset) || (do_host_reset && (! do_host_reset_timeout.hasElapsed())))) {
 		return;
 	}
 
+	// A rate agreed with HOST_CMD_SET_BAUD_RATE starts once the reply has
+	// gone.  If the host doesn't follow, or goes quiet, drop back.
+	if ( pending_baud ) {
+		UART::getHostUART().setBaudRate(pending_baud);
+		fast_baud = pending_baud != HOST_DEFAULT_BAUD;
+		if ( fast_baud ) baud_link_timeout.start(HOST_BAUD_LINK_TIMEOUT_MICROS);
+		else baud_link_timeout.abort();
+		pending_baud = 0;
+	}
+	else if ( fast_baud && baud_link_timeout.hasElapsed() ) {
+		UART::getHostUART().resetInPackets();
+		UART::getHostUART().setBaudRate(HOST_DEFAULT_BAUD);
+		fast_baud = false;
+		baud_link_timeout.abort();
+		packet_window = false;
+		credit_mode = false;
+#ifdef HOST_LARGE_PACKETS
+		setLargePackets(false);
+#endif
+#if HOST_TELEMETRY
+		telemetry_ms = 0;
+#endif
+	}
+
     // soft reset the machine unless waiting to notify repG that a cancel has occured
-	if (do_host_reset && (!cancelBuild || cancel_timeout.hasElapsed())){
+	if (do_host_reset && (!cancelBuild || cancel_timeout.hasElapsed())
+#ifdef FAST_CANCEL
+	    // or for the moves clear of the build, which the reset would cut short
+	    && !command::fastCancelParking()
+#endif
+	    ){
 
 		if((buildState == BUILD_RUNNING) || (buildState == BUILD_PAUSED)){
 			stopBuild();
@@ -129,6 +238,14 @@ void runHostSlice() {
         // a hard reset calls the start up sound and resets heater errors
 		hard_reset = false;
 		packet_in_timeout.abort();
+		packet_window = false;
+		credit_mode = false;
+#ifdef HOST_LARGE_PACKETS
+		setLargePackets(false);
+#endif
+#if HOST_TELEMETRY
+		telemetry_ms = 0;
+#endif
 
 		// Clear the machine and build names
 		machineName[0] = 0;
@@ -137,9 +254,17 @@ void runHostSlice() {
 
 		return;
 	}
+	InPacket& in = UART::getHostUART().getInPacket();
+
     // new packet coming in
 	if (in.isStarted() && !in.isFinished()) {
-		if (!packet_in_timeout.isActive()) {
+		if (!packet_in_timeout.isActive()
+#ifdef HOST_FLOW_CONTROL_PIN
+		    // A packet the bridge was holding back when the line went
+		    // low hasn't been slow to arrive
+		    || flow_held
+#endif
+		    ) {
 			// initiate timeout
 			packet_in_timeout.start(HOST_PACKET_TIMEOUT_MICROS);
 		} else if (packet_in_timeout.hasElapsed()) {
@@ -151,6 +276,9 @@ void runHostSlice() {
 		// Reset packet quickly and start handling the next packet.
 		packet_in_timeout.abort();
 		out.reset();
+		if ( packet_window ) out.append8(expected_seq - 1);
+		if ( credit_mode ) out.append16(command::getRemainingCapacity());
+		uint8_t code_at = out.getLength();
 
 		// Report error code.
 		switch (in.getErrorCode()){
@@ -169,13 +297,34 @@ void runHostSlice() {
 				break;
 		}
 
-		in.reset();
+#ifdef HOST_LOG
+		hostlog::record(HOST_LOG_NO_COMMAND, out.read8(code_at));
+#endif
+		UART::getHostUART().nextInPacket();
 		UART::getHostUART().beginSend();
 	}
 	else if (in.isFinished() == 1) {
 		//DEBUG_PIN1.setValue(false);
 		packet_in_timeout.abort();
 		out.reset();
+		if ( fast_baud ) baud_link_timeout.start(HOST_BAUD_LINK_TIMEOUT_MICROS);
+
+		// In windowed mode only the next packet in sequence is handled,
+		// and the reply leads with the last one accepted
+		bool windowed = packet_window;
+		bool in_sequence = true;
+		if ( windowed ) {
+			in_sequence = ( in.getLength() > 0 ) && ( in.popFront() == expected_seq );
+			out.append8(in_sequence ? expected_seq : (uint8_t)(expected_seq - 1));
+		}
+		// In credit mode the free space in the command buffer follows,
+		// filled in once the packet has been handled
+		bool credits = credit_mode;
+		if ( credits ) out.append16(0);
+		uint8_t code_at = out.getLength();
+		if ( ! in_sequence ) {
+			out.append8(RC_OUT_OF_SEQUENCE);
+		} else
 	  // do not respond to commands if the bot has had a heater failure
 		if(currentState == HOST_STATE_HEAT_SHUTDOWN){
 			if(cancelBuild){
@@ -187,23 +336,52 @@ void runHostSlice() {
 		}else if(cancelBuild){
 			out.append8(RC_CANCEL_BUILD);
 			cancelBuild = false;
-		} else
-		if (processCommandPacket(in, out)) {
-			// okay, processed
-		} else if (processQueryPacket(in, out)) {
-			// okay, processed
-		} else {
+		} else if ( in.getLength() > 0 && ( in.read8(0) & 0x80 ) ) {
+			processCommandPacket(in, out);
+		} else if ( ! processQueryPacket(in, out) ) {
 			// Unrecognized command
 			out.append8(RC_CMD_UNSUPPORTED);
 		}
-		in.reset();
+		if ( windowed && in_sequence ) {
+			// A command the buffer had no room for has to be sent again
+			if ( out.read8(code_at) == RC_BUFFER_OVERFLOW ) {
+				out.reset();
+				out.append8(expected_seq - 1);
+				if ( credits ) out.append16(0);
+				out.append8(RC_BUFFER_OVERFLOW);
+			}
+			else expected_seq++;
+		}
+		if ( credits ) out.write16(code_at - 2, command::getRemainingCapacity());
+#ifdef HOST_LOG
+		hostlog::record(( in.getLength() > 0 ) ? in.read8(0) : HOST_LOG_NO_COMMAND,
+				out.read8(code_at));
+#endif
+		UART::getHostUART().nextInPacket();
                 UART::getHostUART().beginSend();
 	}
+#if HOST_TELEMETRY
+	// Only when there's no reply to send, which has gone if we got here
+	else if ( telemetry_ms && telemetry_timeout.hasElapsed() ) {
+		telemetry_timeout.start(telemetry_ms * 1000L);
+		sendTelemetry(out);
+                UART::getHostUART().beginSend();
+	}
+#endif
 	/// mark new state as ready if done building from SD
 	if(currentState==HOST_STATE_BUILDING_FROM_SD)
 	{
 		if(!sdcard::isPlaying())
 		{
+#ifdef POWER_LOSS_RESUME
+			checkpoint::buildEnded();
+#endif
+#ifdef SD_PRESCAN
+			prescan::stop();
+#endif
+#ifdef LAYER_LOG
+			layerlog::stop();
+#endif
 			currentState = HOST_STATE_READY;
 			BOARD_STATUS_CLEAR(Motherboard::STATUS_SD_CARD_PLAYING);
 		}
@@ -219,51 +397,73 @@ void runHostSlice() {
 			BOARD_STATUS_CLEAR(Motherboard::STATUS_ONBOARD_SCRIPT);
 		}
 	}
+#ifdef PLATFORM_COOLDOWN
+	// Before the queue, which may wait on it
+	cooldown::runSlice();
+#endif
+#ifdef PRINT_QUEUE
+	printqueue::runSlice();
+#endif
+#ifdef SD_PRESCAN
+	prescan::runSlice();
+#endif
+#ifdef LAYER_LOG
+	layerlog::runSlice();
+#endif
 }
 
-/** Identify a command packet, and process it.  If the packet is a command
- * packet, return true, indicating that the packet has been queued and no
- * other processing needs to be done. Otherwise, processing of this packet
- * should drop through to the next processing level.
- */
-bool processCommandPacket(const InPacket& from_host, OutPacket& to_host) {
-	if (from_host.getLength() >= 1) {
-		uint8_t command = from_host.read8(0);
-		if ((command & 0x80) != 0) {
+#ifdef HOST_FLOW_CONTROL_PIN
+
+/// Hold the flow control line to the USB bridge low while the command
+/// buffer is short of room for the host's next packets.  Only a buffer the
+/// host has filled holds it: SD and onboard builds fill it as well, and the
+/// host must still be able to query them.
+static void updateFlowControl() {
+	uint16_t room = command::getRemainingCapacity();
+	bool hold = ( currentState != HOST_STATE_BUILDING_FROM_SD ) &&
+		( currentState != HOST_STATE_BUILDING_ONBOARD ) &&
+		( room < ( flow_held ? HOST_FLOW_RELEASE_ROOM : HOST_FLOW_HOLD_ROOM ));
+
+	if ( hold != flow_held ) {
+		flow_held = hold;
+		HOST_FLOW_CONTROL_PIN.setValue(!hold);
+	}
+}
+
+#endif
+
+/// Queue a command packet, one with the high bit of its command code set
+void processCommandPacket(const InPacket& from_host, OutPacket& to_host) {
 #ifdef S3G_CAPTURE_2_SD
-			// If we're capturing a file to an SD card, we send it to the sdcard module
-			// for processing.
-			if (sdcard::isCapturing()) {
-				sdcard::capturePacket(from_host);
-				to_host.append8(RC_OK);
-				return true;
-			}
+	// If we're capturing a file to an SD card, we send it to the sdcard module
+	// for processing.
+	if (sdcard::isCapturing()) {
+		sdcard::capturePacket(from_host);
+		to_host.append8(RC_OK);
+		return;
+	}
 #endif
-			if(sdcard::isPlaying() || utility::isPlaying()){
-				// ignore action commands if SD card build is playing
-				// or if ONBOARD script is playing
-				to_host.append8(RC_BOT_BUILDING);
-				return true;
-			}
+	if(sdcard::isPlaying() || utility::isPlaying()){
+		// ignore action commands if SD card build is playing
+		// or if ONBOARD script is playing
+		to_host.append8(RC_BOT_BUILDING);
+		return;
+	}
 
-			// Queue command, if there's room.
-			// Turn off interrupts while querying or manipulating the queue!
-			ATOMIC_BLOCK(ATOMIC_FORCEON) {
-				const uint8_t command_length = from_host.getLength();
-				if (command::getRemainingCapacity() >= command_length) {
-					// Append command to buffer
-					for (int i = 0; i < command_length; i++) {
-						command::push(from_host.read8(i));
-					}
-					to_host.append8(RC_OK);
-				} else {
-					to_host.append8(RC_BUFFER_OVERFLOW);
-				}
+	// Queue command, if there's room.
+	// Turn off interrupts while querying or manipulating the queue!
+	ATOMIC_BLOCK(ATOMIC_FORCEON) {
+		const uint8_t command_length = from_host.getLength();
+		if (command::getRemainingCapacity() >= command_length) {
+			// Append command to buffer
+			for (int i = 0; i < command_length; i++) {
+				command::push(from_host.read8(i));
 			}
-			return true;
+			to_host.append8(RC_OK);
+		} else {
+			to_host.append8(RC_BUFFER_OVERFLOW);
 		}
 	}
-	return false;
 }
 
     // alert the host that the bot has had a heat failure
@@ -284,7 +484,7 @@ void heatShutdown(){
 
 // Received driver version info, and request for fw version info.
 // puts fw version into a reply packet, and send it back
-inline void handleVersion(const InPacket& from_host, OutPacket& to_host) {
+static void handleVersion(const InPacket& from_host, OutPacket& to_host) {
 
     // Case to give an error on Replicator G versions older than 0038.
     if(from_host.read16(1) < 39) {
@@ -300,7 +500,7 @@ inline void handleVersion(const InPacket& from_host, OutPacket& to_host) {
 
 // Received driver version info, and request for fw version info.
 // puts fw version into a reply packet, and send it back
-inline void handleGetAdvancedVersion(const InPacket& from_host, OutPacket& to_host) {
+static void handleGetAdvancedVersion(const InPacket& from_host, OutPacket& to_host) {
 
 	// we're not doing anything with the host version at the moment
 	from_host.read16(1);	//uint16_t host_version
@@ -315,7 +515,7 @@ inline void handleGetAdvancedVersion(const InPacket& from_host, OutPacket& to_ho
 }
 
 // return build name
-inline void handleGetBuildName(OutPacket& to_host) {
+static void handleGetBuildName(const InPacket&, OutPacket& to_host) {
 	to_host.append8(RC_OK);
 	for (uint8_t idx = 0; idx < sizeof(buildName); idx++) {
 		to_host.append8(buildName[idx]);
@@ -323,12 +523,12 @@ inline void handleGetBuildName(OutPacket& to_host) {
 	}
 }
 
-inline void handleGetBufferSize(OutPacket& to_host) {
+static void handleGetBufferSize(const InPacket&, OutPacket& to_host) {
 	to_host.append8(RC_OK);
 	to_host.append32(command::getRemainingCapacity());
 }
 
-inline void handleGetPosition(OutPacket& to_host) {
+static void handleGetPosition(const InPacket&, OutPacket& to_host) {
 	uint8_t toolIndex;
 	ATOMIC_BLOCK(ATOMIC_FORCEON) {
 		const Point p = steppers::getStepperPosition(&toolIndex);
@@ -343,7 +543,7 @@ inline void handleGetPosition(OutPacket& to_host) {
 	}
 }
 
-inline void handleGetPositionExt(OutPacket& to_host) {
+static void handleGetPositionExt(const InPacket&, OutPacket& to_host) {
 	uint8_t toolIndex;
 	ATOMIC_BLOCK(ATOMIC_FORCEON) {
 		const Point p = steppers::getStepperPosition(&toolIndex);
@@ -373,22 +573,35 @@ inline void handleGetPositionExt(OutPacket& to_host) {
 #ifdef S3G_CAPTURE_2_SD
 
     // capture to SD
-inline void handleCaptureToFile(const InPacket& from_host, OutPacket& to_host) {
+static void handleCaptureToFile(const InPacket& from_host, OutPacket& to_host) {
 	char *p = (char*)from_host.getData() + 1;
 	to_host.append8(RC_OK);
-	to_host.append8(sdcard::startCapture(p));
+	sdcard::SdErrorCode e = sdcard::startCapture(p);
+#if defined(SD_FILE_CRC)
+	if ( e == sdcard::SD_SUCCESS )
+		prescan::captureStarted(p);
+#endif
+	to_host.append8(e);
 }
     // stop capture to SD
-inline void handleEndCapture(const InPacket& from_host, OutPacket& to_host) {
+static void handleEndCapture(const InPacket& from_host, OutPacket& to_host) {
 	to_host.append8(RC_OK);
-	to_host.append32(sdcard::finishCapture());
+	uint32_t bytes = sdcard::finishCapture();
+	to_host.append32(bytes);
+#if defined(SD_FILE_CRC)
+	prescan::captureFinished(bytes);
+#endif
+#ifdef SD_PLAY_WHILE_CAPTURE
+	// Leave be a build playing the file as it came in
+	if ( !sdcard::isPlaying() )
+#endif
 	sdcard::reset();
 }
 
 #endif // S3G_CAPTURE_2_SD
 
     // playback from SD
-inline void handlePlayback(const InPacket& from_host, OutPacket& to_host) {
+static void handlePlayback(const InPacket& from_host, OutPacket& to_host) {
 	to_host.append8(RC_OK);
 	for (uint8_t idx = 1; (idx < from_host.getLength()) && (idx < sizeof(buildName)); idx++)
 		buildName[idx-1] = from_host.read8(idx);
@@ -401,9 +614,16 @@ static bool isX3G(const char *fnbuf) {
 	if (len < 5) {
 		return false;
 	}
-	return fnbuf[len - 4] == '.' &&
-			(fnbuf[len - 3] == 'x' || fnbuf[len - 3] == 's') &&
-			fnbuf[len - 2] == '3' && fnbuf[len - 1] == 'g';
+	if (fnbuf[len - 4] == '.' &&
+	    (fnbuf[len - 3] == 'x' || fnbuf[len - 3] == 's') &&
+	    fnbuf[len - 2] == '3' && fnbuf[len - 1] == 'g')
+		return true;
+#ifdef PRINT_QUEUE
+	// A queue is started as a build is
+	if (printqueue::isQueueFile(fnbuf))
+		return true;
+#endif
+	return false;
 }
     // retrieve SD file names
 void handleNextFilename(const InPacket& from_host, OutPacket& to_host) {
@@ -435,7 +655,7 @@ void handleNextFilename(const InPacket& from_host, OutPacket& to_host) {
 }
 
     // pause command response
-inline void handlePause(OutPacket& to_host) {
+static void handlePause(const InPacket&, OutPacket& to_host) {
 	//If we're either pausing or unpausing, but we haven't completed
 	//the operation yet, we ignore this request
 	if (!command::pauseIntermediateState()) {
@@ -447,7 +667,7 @@ inline void handlePause(OutPacket& to_host) {
 }
 
     // check if steppers are still executing a command
-inline void handleIsFinished(OutPacket& to_host) {
+static void handleIsFinished(const InPacket&, OutPacket& to_host) {
 	to_host.append8(RC_OK);
 	ATOMIC_BLOCK(ATOMIC_FORCEON) {
 		bool done = !steppers::isRunning() && command::isEmpty();
@@ -460,7 +680,8 @@ void handleReadEeprom(const InPacket& from_host, OutPacket& to_host) {
     uint16_t offset = from_host.read16(1);
     uint8_t length = from_host.read8(3);
     uint8_t data[length];
-    eeprom_read_block(data, (const void*) offset, length);
+    eeprom::readBlock(data, (const void*) offset, length);
+    journal::hostRead(offset, data, length);
     to_host.append8(RC_OK);
     for (int i = 0; i < length; i++) {
         to_host.append8(data[i]);
@@ -474,13 +695,16 @@ void handleWriteEeprom(const InPacket& from_host, OutPacket& to_host) {
     uint16_t offset = from_host.read16(1);
     uint8_t length = from_host.read8(3);
     uint8_t data[length];
-    eeprom_read_block(data, (const void*) offset, length);
+    eeprom::readBlock(data, (const void*) offset, length);
     for (int i = 0; i < length; i++) {
         data[i] = from_host.read8(i + 4);
     }
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
-		eeprom_write_block(data, (void*) offset, length);
-	}
+    // Queued, so the reply goes straight back
+    eeprom::writeBlock(data, (void*) offset, length);
+    journal::hostWrite(offset, data, length);
+    eeprom::loadSettings();
+    // Tuning the motion during a build takes effect from the next move
+    steppers::applySettings(offset, length);
     to_host.append8(RC_OK);
     to_host.append8(length);
 }
@@ -491,10 +715,10 @@ enum { // bit assignments
 };
 
     // stop steppers and command execution
-inline void handleExtendedStop(const InPacket& from_host, OutPacket& to_host) {
+static void handleExtendedStop(const InPacket& from_host, OutPacket& to_host) {
 	uint8_t flags = from_host.read8(1);
 	if (flags & _BV(ES_STEPPERS)) {
-		steppers::abort();
+		steppers::abortDecelerated();
 	}
 	if (flags & _BV(ES_COMMANDS)) {
 		command::reset();
@@ -505,7 +729,7 @@ inline void handleExtendedStop(const InPacket& from_host, OutPacket& to_host) {
 }
 
     //set build name and build state
-void handleBuildStartNotification(CircularBuffer& buf) {
+void handleBuildStartNotification(CommandBuffer& buf) {
 	uint8_t idx = 0;
 	switch (currentState){
 		case HOST_STATE_BUILDING_FROM_SD:
@@ -546,6 +770,9 @@ void handleBuildStartNotification(CircularBuffer& buf) {
 	startPrintTime();
 #if defined(LINE_NUMBER)
 	command::clearLineNumber();
+#endif
+#if defined(UNDERRUN_STATS)
+	steppers::resetUnderruns();
 #endif
 	buildState = BUILD_RUNNING;
 	buildWasCancelled = false;
@@ -576,7 +803,7 @@ void handleBuildStopNotification() {
 }
 
 /// get current print stats if printing, or last print stats if not printing
-inline void handleGetBuildStats(OutPacket& to_host) {
+static void handleGetBuildStats(const InPacket&, OutPacket& to_host) {
         to_host.append8(RC_OK);
 	
 	uint16_t hours;
@@ -597,119 +824,959 @@ inline void handleGetBuildStats(OutPacket& to_host) {
 	to_host.append32(0); // line number reporting not supported
 #endif
         to_host.append32(0); // open spot for filament detect info
+#if defined(UNDERRUN_STATS)
+	for ( uint8_t i = 0; i < steppers::UNDERRUN_CAUSES; i++ )
+		to_host.append16(steppers::getUnderruns(i));
+#else
+	for ( uint8_t i = 0; i < 3; i++ )
+		to_host.append16(0); // underrun counting not supported
+#endif
+}
+#ifdef ISR_PROFILE
+/// get the execution time statistics for one interrupt handler
+/// byte 1 is the ISR_PROFILE_ source, if bit 0 of byte 2 is set all the
+/// statistics are reset after they've been read.  Times are in cpu cycles.
+static void handleGetIsrProfile(const InPacket& from_host, OutPacket& to_host) {
+	isr_profile_t profile;
+
+	if (( from_host.getLength() < 3 ) || ( ! isr_profile_get(from_host.read8(1), &profile) )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	if ( from_host.read8(2) & 0x01 )	isr_profile_reset();
+
+	to_host.append8(RC_OK);
+	to_host.append32(( profile.count ) ? (uint32_t)profile.min_ticks * ISR_PROFILE_CYCLES_PER_TICK : 0);
+	to_host.append32(( profile.count ) ? (profile.total_ticks / profile.count) * ISR_PROFILE_CYCLES_PER_TICK : 0);
+	to_host.append32((uint32_t)profile.max_ticks * ISR_PROFILE_CYCLES_PER_TICK);
+	to_host.append16(profile.count);
+	for ( uint8_t i = 0; i < ISR_PROFILE_BUCKETS; i ++ )
+		to_host.append16(profile.histogram[i]);
+	to_host.append16(isr_profile_overruns);
+}
+#endif
+
+/// switch the host link to the baud rate in bytes 1-4 once the reply has been
+/// sent, if it's one the UART supports
+static void handleSetBaudRate(const InPacket& from_host, OutPacket& to_host) {
+	if (( from_host.getLength() < 5 ) || ( ! UART::supportsBaudRate(from_host.read32(1)) )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	pending_baud = from_host.read32(1);
+	to_host.append8(RC_OK);
+}
+
+/// number the packets from the host if byte 1 is non-zero, else stop, and
+/// reply with how many the host may send ahead of the replies
+static void handleSetPacketWindow(const InPacket& from_host, OutPacket& to_host) {
+	if (( from_host.getLength() >= 2 ) && from_host.read8(1)) {
+		if ( ! packet_window ) expected_seq = 0;
+		packet_window = true;
+	}
+	else packet_window = false;
+	to_host.append8(RC_OK);
+	to_host.append8(HOST_PACKET_WINDOW);
+}
+
+/// turn the free command buffer space in every reply on or off, as described
+/// for HOST_CMD_SET_CREDIT_MODE
+static void handleSetCreditMode(const InPacket& from_host, OutPacket& to_host) {
+	credit_mode = ( from_host.getLength() >= 2 ) && from_host.read8(1);
+	to_host.append8(RC_OK);
+	to_host.append16(command::getRemainingCapacity());
+	to_host.append16(COMMAND_BUFFER_SIZE);
+}
+
+#ifdef HOST_LARGE_PACKETS
+/// accept packets of up to MAX_IN_PACKET_PAYLOAD bytes if byte 1 is non-zero,
+/// else only the usual MAX_PACKET_PAYLOAD, and reply with the limit
+static void handleSetLargePackets(const InPacket& from_host, OutPacket& to_host) {
+	setLargePackets(( from_host.getLength() >= 2 ) && from_host.read8(1));
+	to_host.append8(RC_OK);
+	to_host.append8(HOST_PACKET_LIMIT);
+}
+#endif
+
+#ifdef EEPROM_IMAGE
+// Total of the bytes which differed and were queued since the image began
+static uint16_t image_changed;
+
+// The image leaves the journal of the lifetime counters as the machine has it
+static bool imageKeeps(uint16_t addr) {
+	return ( addr >= eeprom_offsets::STATS_JOURNAL ) && ( addr < eeprom_offsets::STATS_JOURNAL_END );
+}
+
+// Decodes the chunk in byte 4 on into data, as it is or run length encoded,
+// and returns the number of bytes, no more than most
+static uint8_t decodeImageChunk(const InPacket& from_host, bool rle, uint8_t *data, uint8_t most) {
+	uint8_t length = from_host.getLength();
+	uint8_t i = 4, n = 0;
+	while (( i < length ) && ( n < most )) {
+		if ( !rle ) {
+			data[n++] = from_host.read8(i++);
+			continue;
+		}
+		uint8_t c = from_host.read8(i++);
+		if ( c & 0x80 ) {
+			if ( i >= length ) break;
+			uint8_t value = from_host.read8(i++);
+			for ( uint8_t r = ( c & 0x7f ) + 3; r && ( n < most ); r -- )
+				data[n++] = value;
+		}
+		else {
+			for ( uint8_t r = c + 1; r && ( i < length ) && ( n < most ); r -- )
+				data[n++] = from_host.read8(i++);
+		}
+	}
+	return n;
+}
+
+/// begin, write a chunk of or verify an EEPROM image, as described for
+/// HOST_CMD_EEPROM_IMAGE
+static void handleEepromImage(const InPacket& from_host, OutPacket& to_host) {
+	const uint16_t size = E2END + 1;
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 3 ) || ( action != 0 && from_host.getLength() < 4 ) ||
+	    ( action == 3 && from_host.getLength() < 6 )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	if (( buildState == BUILD_RUNNING ) || ( buildState == BUILD_PAUSED )) {
+		to_host.append8(RC_BOT_BUILDING);
+		return;
+	}
+
+	if ( action == 0 ) {
+		image_changed = 0;
+		to_host.append8(RC_OK);
+		to_host.append16(size);
+		to_host.append16(eeprom_offsets::STATS_JOURNAL);
+		to_host.append16(eeprom_offsets::STATS_JOURNAL_END);
+		return;
+	}
+
+	uint16_t offset = from_host.read16(2);
+	uint8_t data[EEPROM_IMAGE_CHUNK];
+	if ( action == 3 ) {
+		uint16_t length = from_host.read16(4);
+		if (( offset > size ) || ( length > size - offset )) {
+			to_host.append8(RC_CMD_UNSUPPORTED);
+			return;
+		}
+		// What was queued is what's read back, so wait for it to be written
+		eeprom::flushWrites();
+		uint16_t crc = 0xffff;
+		for ( uint16_t done = 0; done < length; ) {
+			uint8_t n = ( length - done < EEPROM_IMAGE_CHUNK ) ? length - done : EEPROM_IMAGE_CHUNK;
+			eeprom::readBlock(data, (const void*)(offset + done), n);
+			for ( uint8_t i = 0; i < n; i ++ )
+				if ( !imageKeeps(offset + done + i) )
+					crc = _crc16_update(crc, data[i]);
+			done += n;
+		}
+		eeprom::loadSettings();
+		steppers::applySettings(offset, length);
+		to_host.append8(RC_OK);
+		to_host.append16(crc);
+		to_host.append16(image_changed);
+		return;
+	}
+
+	if ( offset > size ) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	uint8_t most = ( size - offset < EEPROM_IMAGE_CHUNK ) ? size - offset : EEPROM_IMAGE_CHUNK;
+	uint8_t n = decodeImageChunk(from_host, action == 2, data, most);
+	uint8_t held[EEPROM_IMAGE_CHUNK];
+	eeprom::readBlock(held, (const void*)offset, n);
+
+	// Queue the bytes which differ while there's room, without waiting
+	// for any; the host sends the rest again from where this stopped
+	uint8_t taken = 0;
+	for ( ; taken < n; taken ++ ) {
+		uint16_t addr = offset + taken;
+		if (( held[taken] == data[taken] ) || imageKeeps(addr) )
+			continue;
+		if ( !eeprom::writeRoom(1) )
+			break;
+		eeprom::writeByte((uint8_t*)addr, data[taken]);
+		image_changed ++;
+	}
+	to_host.append8(RC_OK);
+	to_host.append16(offset + taken);
+	to_host.append16(image_changed);
+}
+#endif
+
+#if HOST_TELEMETRY
+/// push a status frame every bytes 1-2 milliseconds, or stop if that's 0
+static void handleSetTelemetry(const InPacket& from_host, OutPacket& to_host) {
+	if ( from_host.getLength() < 3 ) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	telemetry_ms = from_host.read16(1);
+	if ( telemetry_ms && telemetry_ms < HOST_TELEMETRY_MIN_MS )
+		telemetry_ms = HOST_TELEMETRY_MIN_MS;
+	if ( telemetry_ms ) telemetry_timeout.start(telemetry_ms * 1000L);
+	to_host.append8(RC_OK);
+	to_host.append16(telemetry_ms);
+}
+
+/// the frame described for HOST_CMD_SET_TELEMETRY
+static void sendTelemetry(OutPacket& out) {
+	Motherboard& board = Motherboard::getBoard();
+	Heater& tool0 = board.getExtruderBoard(0).getExtruderHeater();
+	Heater& tool1 = board.getExtruderBoard(1).getExtruderHeater();
+	Heater& platform = board.getPlatformHeater();
+
+	out.reset();
+	if ( packet_window ) out.append8(expected_seq - 1);
+	if ( credit_mode ) out.append16(command::getRemainingCapacity());
+	out.append8(RC_TELEMETRY);
+	out.append8(telemetry_count++);
+
+	uint8_t toolIndex;
+	ATOMIC_BLOCK(ATOMIC_FORCEON) {
+		const Point p = steppers::getStepperPosition(&toolIndex);
+		out.append32(p[0]);
+		out.append32(p[1]);
+		out.append32(p[2]);
+	}
+
+	out.append16(tool0.get_current_temperature());
+	out.append16(tool1.get_current_temperature());
+	out.append16(platform.get_current_temperature());
+	out.append8(tool0.get_output());
+	out.append8(tool1.get_output());
+	out.append8(platform.get_output());
+	out.append8(movesplanned());
+	out.append8(command::getBuildPercentage());
+	out.append8(board_status);
+}
+#endif
+
+#ifdef MEMORY_PROFILE
+/// get the SRAM use, as described for HOST_CMD_GET_MEMORY_PROFILE
+static void handleGetMemoryProfile(const InPacket& from_host, OutPacket& to_host) {
+	memory_profile_t profile;
+	uint16_t samples[MEMORY_PROFILE_HISTORY];
+
+	memory_profile_get(&profile);
+	uint8_t count = memory_profile_history(samples);
+	if (( from_host.getLength() >= 2 ) && ( from_host.read8(1) & 0x01 ))
+		memory_profile_reset();
+
+	to_host.append8(RC_OK);
+	to_host.append16(profile.sram);
+	to_host.append16(profile.static_bytes);
+	to_host.append16(profile.heap);
+	to_host.append16(profile.stack);
+	to_host.append16(profile.headroom);
+	to_host.append16(profile.free_now);
+	to_host.append8(MEMORY_PROFILE_SUBSYSTEMS);
+	for ( uint8_t i = 0; i < MEMORY_PROFILE_SUBSYSTEMS; i ++ )
+		to_host.append16(memory_profile_subsystem(i));
+	to_host.append8(count);
+	for ( uint8_t i = 0; i < count; i ++ )
+		to_host.append16(samples[i]);
+}
+#endif
+
+#ifdef PLANNER_STATS
+/// read the planner's block statistics, as described for HOST_CMD_GET_PLANNER_STATS
+static void handleGetPlannerStats(const InPacket& from_host, OutPacket& to_host) {
+	if ( from_host.getLength() < 2 ) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+	uint8_t flags = from_host.read8(1);
+	planner_stats_t stats;
+	plan_stats_get(&stats);
+	if ( flags & 0x80 )	plan_stats_reset();
+
+	to_host.append8(RC_OK);
+	if ( flags & 0x01 ) {
+		to_host.append8(PLANNER_STATS_BUCKET_MM_S);
+		for ( uint8_t i = 0; i < PLANNER_STATS_BUCKETS; i ++ )
+			to_host.append16(stats.histogram[i]);
+		return;
+	}
+	to_host.append32(stats.blocks);
+	to_host.append32(stats.reached_nominal);
+	to_host.append32(stats.full_stops);
+	to_host.append32(stats.accel_ms);
+	to_host.append32(stats.cruise_ms);
+	to_host.append32(stats.decel_ms);
+}
+#endif
+
+#ifdef SD_DRY_RUN
+/// start a dry run of an SD card file or read its report, as described for
+/// HOST_CMD_DRY_RUN
+static void handleDryRun(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 1 ) || ( action == 1 && from_host.getLength() < 3 )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	to_host.append8(RC_OK);
+	if ( action == 1 ) {
+		for (uint8_t idx = 2; (idx < from_host.getLength()) && (idx < sizeof(buildName) + 1); idx++)
+			buildName[idx-2] = from_host.read8(idx);
+		buildName[sizeof(buildName)-1] = '\0';
+		to_host.append8(dryrun::start(buildName));
+		return;
+	}
+
+	const dryrun::Report *rep = dryrun::report();
+	to_host.append8(rep->state);
+	to_host.append8(rep->error);
+	to_host.append8(rep->detail);
+	to_host.append32(rep->offset);
+	to_host.append32(rep->moves);
+	to_host.append32(rep->planned_ms);
+	to_host.append32((uint32_t)rep->min_lead_ms);
+	to_host.append16(rep->starved);
+	to_host.append32(rep->elapsed_ms);
+}
+#endif
+
+#ifdef SD_PLAYBACK_STATS
+/// get the SD card playback counters of the current or last print from SD:
+/// the chunk look ups, bytes played back, longest look up in microseconds,
+/// CRC retries and the number of times the command buffer ran dry.  If bit 0
+/// of byte 1 is set the counters are reset after they've been read.
+static void handleGetSdPlaybackStats(const InPacket& from_host, OutPacket& to_host) {
+	sdcard::PlaybackStats stats;
+
+	sdcard::getPlaybackStats(&stats);
+	if (( from_host.getLength() >= 2 ) && ( from_host.read8(1) & 0x01 ))
+		sdcard::resetPlaybackStats();
+
+	to_host.append8(RC_OK);
+	to_host.append32(stats.fetches);
+	to_host.append32(stats.bytes);
+	to_host.append32(stats.max_micros);
+	to_host.append16(stats.crc_retries);
+	to_host.append16(stats.starved);
+}
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+/// start or stop a heater tune, and report on it, as described for
+/// HOST_CMD_HEATER_TUNE
+static void handleHeaterTune(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t index = ( from_host.getLength() >= 3 ) ? from_host.read8(1) : 0xff;
+	if ( index > 2 ) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	Motherboard& board = Motherboard::getBoard();
+	Heater& heater = ( index == 2 ) ? board.getPlatformHeater() :
+		board.getExtruderBoard(index).getExtruderHeater();
+
+	switch ( from_host.read8(2) ) {
+	case 1:
+		if ( from_host.getLength() >= 5 )
+			heater.startModelTune((int16_t)from_host.read16(3));
+		break;
+	case 2:
+		heater.abortTune();
+		break;
+	}
+
+	const HeaterModel& model = heater.getModel();
+	to_host.append8(RC_OK);
+	to_host.append8(heater.getTuneState());
+	to_host.append16(model.gain);
+	to_host.append16(model.tau);
+	to_host.append16(model.dead);
+	to_host.append16(model.ambient);
+}
+#endif
+
+#ifdef PID_AUTOTUNE
+/// start or stop a PID autotune, and report on it, as described for
+/// HOST_CMD_PID_AUTOTUNE
+static void handlePIDAutotune(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t index = ( from_host.getLength() >= 3 ) ? from_host.read8(1) : 0xff;
+	if ( index > 2 ) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	Motherboard& board = Motherboard::getBoard();
+	Heater& heater = ( index == 2 ) ? board.getPlatformHeater() :
+		board.getExtruderBoard(index).getExtruderHeater();
+
+	switch ( from_host.read8(2) ) {
+	case 1:
+		if ( from_host.getLength() >= 5 )
+			heater.startAutotune((int16_t)from_host.read16(3),
+				( from_host.getLength() >= 6 ) ? from_host.read8(5) : AUTOTUNE_CYCLES);
+		break;
+	case 2:
+		heater.abortAutotune();
+		break;
+	}
+
+	to_host.append8(RC_OK);
+	to_host.append8(heater.getAutotuneState());
+	to_host.append8(heater.getAutotuneCycles());
+	to_host.append16((uint16_t)(heater.getPIDGain(pid_eeprom_offsets::P_TERM_OFFSET) * 256.0));
+	to_host.append16((uint16_t)(heater.getPIDGain(pid_eeprom_offsets::I_TERM_OFFSET) * 256.0));
+	to_host.append16((uint16_t)(heater.getPIDGain(pid_eeprom_offsets::D_TERM_OFFSET) * 256.0));
+}
+#endif
+
+#ifdef HEATER_LOG
+// Samples which fit in a reply after its 7 bytes of header
+#define HEATER_LOG_PER_PACKET	((MAX_PACKET_PAYLOAD - 7) / 8)
+
+/// start, stop or read the heater log, as described for HOST_CMD_HEATER_LOG
+static void handleHeaterLog(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 2 ) || ( action != 2 && from_host.getLength() < ( action ? 5 : 4 ) )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	if ( action == 1 )
+		heaterlog::start(from_host.read8(2), from_host.read16(3));
+	else if ( action == 2 )
+		heaterlog::stop();
+
+	uint16_t oldest = heaterlog::getOldest();
+	to_host.append8(RC_OK);
+	to_host.append8(heaterlog::isRunning() ? 1 : 0);
+	to_host.append16(heaterlog::getNext());
+	to_host.append16(oldest);
+	if ( action != 0 ) return;
+
+	// Read from the oldest if the one asked for has been overwritten, or
+	// is from before the log was started again
+	uint16_t seq = from_host.read16(2);
+	uint16_t next = heaterlog::getNext();
+	if ( (uint16_t)(next - seq) > (uint16_t)(next - oldest) ) seq = oldest;
+
+	uint16_t left = next - seq;
+	// Fewer fit behind the header of the windowed and credit modes
+	uint8_t most = ( MAX_PACKET_PAYLOAD - 1 - to_host.getLength() ) / 8;
+	if ( most > HEATER_LOG_PER_PACKET ) most = HEATER_LOG_PER_PACKET;
+	uint8_t count = ( left < most ) ? (uint8_t)left : most;
+	to_host.append8(count);
+	heaterlog::HeaterSample sample;
+	for ( uint8_t i = 0; i < count; i ++ ) {
+		heaterlog::getSample(seq + i, &sample);
+		to_host.append16(sample.time);
+		to_host.append16((uint16_t)sample.setpoint);
+		to_host.append16((uint16_t)sample.reading);
+		to_host.append8(sample.heater);
+		to_host.append8(sample.output);
+	}
+}
+#endif
+
+#ifdef HOST_LOG
+// Records which fit in a reply after its 7 bytes of header
+#define HOST_LOG_PER_PACKET	((MAX_PACKET_PAYLOAD - 7) / 8)
+
+/// start, stop or read the host packet log, as described for HOST_CMD_HOST_LOG
+static void handleHostLog(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 2 ) || ( action == 0 && from_host.getLength() < 4 )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	if ( action == 1 )
+		hostlog::start();
+	else if ( action == 2 )
+		hostlog::stop();
+
+	uint16_t oldest = hostlog::getOldest();
+	to_host.append8(RC_OK);
+	to_host.append8(hostlog::isRunning() ? 1 : 0);
+	to_host.append16(hostlog::getNext());
+	to_host.append16(oldest);
+	if ( action != 0 ) return;
+
+	uint16_t seq = from_host.read16(2);
+	uint16_t next = hostlog::getNext();
+	if ( (uint16_t)(next - seq) > (uint16_t)(next - oldest) ) seq = oldest;
+
+	uint16_t left = next - seq;
+	uint8_t most = ( MAX_PACKET_PAYLOAD - 1 - to_host.getLength() ) / 8;
+	if ( most > HOST_LOG_PER_PACKET ) most = HOST_LOG_PER_PACKET;
+	uint8_t count = ( left < most ) ? (uint8_t)left : most;
+	to_host.append8(count);
+	hostlog::HostRecord record;
+	for ( uint8_t i = 0; i < count; i ++ ) {
+		hostlog::getRecord(seq + i, &record);
+		to_host.append32(record.time);
+		to_host.append8(record.command);
+		to_host.append8(record.response);
+		to_host.append16(record.free);
+	}
+}
+#endif
+
+#ifdef FLIGHT_RECORDER
+/// read, clear or freeze the flight recorder, as described for
+/// HOST_CMD_FLIGHT_RECORDER
+static void handleFlightRecorder(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 2 ) || ( action == 0 && from_host.getLength() < 4 )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	if ( action == 1 )
+		flightrec::arm();
+	else if ( action == 2 )
+		flightrec::freeze(flightrec::FREEZE_HOST);
+
+	// Read together, in case the interrupt records in between
+	uint16_t oldest, next;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		oldest = flightrec::getOldest();
+		next = flightrec::getNext();
+	}
+	to_host.append8(RC_OK);
+	to_host.append8(flightrec::frozen());
+	to_host.append16(flightrec::frozenAfter());
+	to_host.append16(next);
+	to_host.append16(oldest);
+	if ( action != 0 ) return;
+
+	uint16_t seq = from_host.read16(2);
+	if ( (uint16_t)(next - seq) > (uint16_t)(next - oldest) ) seq = oldest;
+
+	uint16_t left = next - seq;
+	uint8_t most = ( MAX_PACKET_PAYLOAD - 1 - to_host.getLength() ) / sizeof(flightrec::BlockRecord);
+	uint8_t count = ( left < most ) ? (uint8_t)left : most;
+	to_host.append8(count);
+	flightrec::BlockRecord record;
+	for ( uint8_t i = 0; i < count; i ++ ) {
+		// Overwritten since, if it's still recording
+		if ( ! flightrec::getRecord(seq + i, &record) )
+			memset(&record, 0, sizeof(record));
+		to_host.append16(record.interval);
+		to_host.append16(record.steps);
+		to_host.append16(record.initial_rate);
+		to_host.append16(record.nominal_rate);
+		to_host.append16(record.final_rate);
+		to_host.append16(record.accel);
+		to_host.append8(record.depth);
+		to_host.append8(record.flags);
+	}
+}
+#endif
+
+#ifdef PC_PROFILE
+/// start, stop or read the sampling profiler, as described for
+/// HOST_CMD_PC_PROFILE
+static void handlePcProfile(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t action = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0xff;
+	if (( action > 2 ) || ( action == 0 && from_host.getLength() < 3 ) ||
+	    ( action == 1 && ( from_host.getLength() < 7 || from_host.read8(6) > 17 ) )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	if ( action == 1 )
+		pcprof::start(from_host.read32(2), from_host.read8(6));
+	else if ( action == 2 )
+		pcprof::stop();
+
+	to_host.append8(RC_OK);
+	to_host.append8(pcprof::running() ? 1 : 0);
+	to_host.append32(pcprof::getBase());
+	to_host.append8(pcprof::getShift());
+	to_host.append8(PC_PROFILE_BUCKETS);
+	to_host.append16(pcprof::getOutside());
+	if ( action != 0 ) return;
+
+	uint8_t first = from_host.read8(2);
+	uint8_t left = ( first < PC_PROFILE_BUCKETS ) ? PC_PROFILE_BUCKETS - first : 0;
+	uint8_t most = ( MAX_PACKET_PAYLOAD - 1 - to_host.getLength() ) / 2;
+	uint8_t count = ( left < most ) ? left : most;
+	to_host.append8(count);
+	for ( uint8_t i = 0; i < count; i ++ )
+		to_host.append16(pcprof::getBucket(first + i));
+}
+#endif
+
+#ifdef SLICE_STATS
+/// get the timing of a slice of the main loop, or of whole passes when byte
+/// 1 is 0xff, as described for HOST_CMD_GET_SLICE_STATS
+static void handleGetSliceStats(const InPacket& from_host, OutPacket& to_host) {
+	scheduler::SliceStats stats;
+	uint8_t slice = ( from_host.getLength() >= 2 ) ? from_host.read8(1) : 0;
+	if ( slice == 0xff ) slice = SLICE_LOOP;
+
+	if (( from_host.getLength() < 3 ) || ( ! scheduler::getSliceStats(slice, &stats) )) {
+		to_host.append8(RC_CMD_UNSUPPORTED);
+		return;
+	}
+
+	uint16_t histogram[SLICE_HISTOGRAM_BUCKETS];
+	scheduler::getLoopHistogram(histogram);
+	uint8_t slow = scheduler::getSlowSlice();
+	if ( from_host.read8(2) & 0x01 )	scheduler::resetSliceStats();
+
+	to_host.append8(RC_OK);
+	to_host.append8(SLICE_COUNT);
+	to_host.append8(slow);
+	to_host.append32(( stats.runs ) ? (stats.total / stats.runs) * 100 : 0);
+	to_host.append32((uint32_t)stats.max * 100);
+	to_host.append16(stats.runs);
+	to_host.append16(stats.deferred);
+	to_host.append16(stats.over_budget);
+	if ( slice == SLICE_LOOP ) {
+		for ( uint8_t i = 0; i < SLICE_HISTOGRAM_BUCKETS; i ++ )
+			to_host.append16(histogram[i]);
+	}
+}
+#endif
+
+#ifdef SD_BENCHMARK
+/// read the file named by the rest of the packet from the SD card for up to a
+/// second and return the sd error code, the bytes read, the time taken in
+/// microseconds and the bytes read per second
+static void handleSdBenchmark(const InPacket& from_host, OutPacket& to_host) {
+	char fname[MAX_FILE_LEN];
+	uint8_t idx;
+	for (idx = 1; (idx < from_host.getLength()) && (idx < sizeof(fname)); idx++)
+		fname[idx-1] = from_host.read8(idx);
+	fname[idx-1] = '\0';
+
+	uint32_t bytes, micros;
+	sdcard::SdErrorCode e = sdcard::benchmarkRead(fname, &bytes, &micros);
+
+	to_host.append8(RC_OK);
+	to_host.append8(e);
+	to_host.append32(bytes);
+	to_host.append32(micros);
+	to_host.append32(( micros ) ? (uint32_t)(((uint64_t)bytes * 1000000) / micros) : 0);
 }
+#endif
+
 /// get current print stats if printing, or last print stats if not printing
-inline void handleGetBoardStatus(OutPacket& to_host) {
+static void handleGetBoardStatus(const InPacket&, OutPacket& to_host) {
 	to_host.append8(RC_OK);
 	to_host.append8(board_status);
+#ifdef PLATFORM_COOLDOWN
+	to_host.append8(cooldown::status());
+#endif
 }
 
-// query packets (non action, not queued)
-bool processQueryPacket(const InPacket& from_host, OutPacket& to_host) {
-	if (from_host.getLength() >= 1) {
-		uint8_t command = from_host.read8(0);
-		if ((command & 0x80) == 0) {
-			// Is query command.
-			switch (command) {
-			case HOST_CMD_VERSION:
-				handleVersion(from_host,to_host);
-				return true;
-			case HOST_CMD_GET_BUILD_NAME:
-				handleGetBuildName(to_host);
-				return true;
-			case HOST_CMD_INIT:
-				// There's really nothing we want to do here; we don't want to
-				// interrupt a running build, for example.
-				to_host.append8(RC_OK);
-				return true;
-			case HOST_CMD_CLEAR_BUFFER: // equivalent at current time
-			case HOST_CMD_ABORT: // equivalent at current time
-			case HOST_CMD_RESET:
-			{
-				bool resetMe = true;
-				command::addFilamentUsed();
-				if (currentState == HOST_STATE_BUILDING ||
-				    currentState == HOST_STATE_BUILDING_FROM_SD ||
-				    currentState == HOST_STATE_BUILDING_ONBOARD) {
-				     if (1 == eeprom::getEeprom8(eeprom_offsets::CLEAR_FOR_ESTOP, 0)) {
-					  buildState = BUILD_CANCELED;
+// The longest answer to a tool query, SLAVE_CMD_GET_PID_STATE's
+#define EXTRUDER_QUERY_MAX_ANSWER 12
+
+// The answers to the tool queries about tool id
+static void queryVersion(uint8_t, OutPacket& to_host) {
+	to_host.append16(firmware_version);
+}
+
+static void queryTemp(uint8_t id, OutPacket& to_host) {
+	to_host.append16(Motherboard::getBoard().getExtruderBoard(id).getExtruderHeater().get_current_temperature());
+}
+
+static void queryIsToolReady(uint8_t id, OutPacket& to_host) {
+	to_host.append8(Motherboard::getBoard().getExtruderBoard(id).getExtruderHeater().has_reached_target_temperature()?1:0);
+}
+
+static void queryPlatformTemp(uint8_t, OutPacket& to_host) {
+	to_host.append16(Motherboard::getBoard().getPlatformHeater().get_current_temperature());
+}
+
+static void querySetPoint(uint8_t id, OutPacket& to_host) {
+	to_host.append16(Motherboard::getBoard().getExtruderBoard(id).getExtruderHeater().get_set_temperature());
+}
+
+static void queryPlatformSetPoint(uint8_t, OutPacket& to_host) {
+	to_host.append16(Motherboard::getBoard().getPlatformHeater().get_set_temperature());
+}
+
+static void queryIsPlatformReady(uint8_t, OutPacket& to_host) {
+	to_host.append8(Motherboard::getBoard().getPlatformHeater().has_reached_target_temperature()?1:0);
+}
+
+static void queryToolStatus(uint8_t id, OutPacket& to_host) {
+	Motherboard& board = Motherboard::getBoard();
+	to_host.append8((board.getExtruderBoard(id).getExtruderHeater().has_failed()?128:0)
+					| (board.getPlatformHeater().has_failed()?64:0)
+					// The reason's bits below the two failed flags; a
+					// runaway shows as the extruder having failed alone
+					| (board.getExtruderBoard(id).getExtruderHeater().GetFailMode() & 0x3f)
+					| (board.getExtruderBoard(id).getExtruderHeater().has_reached_target_temperature()?1:0));
+}
+
+static void queryPIDState(uint8_t id, OutPacket& to_host) {
+#if defined(SUPPORT_GET_PID_STATE)
+	Motherboard& board = Motherboard::getBoard();
+	to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDErrorTerm());
+	to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDDeltaTerm());
+	to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDLastOutput());
+	to_host.append16(board.getPlatformHeater().getPIDErrorTerm());
+	to_host.append16(board.getPlatformHeater().getPIDDeltaTerm());
+	to_host.append16(board.getPlatformHeater().getPIDLastOutput());
+#else
+	(void)id;
+	to_host.append32(0);
+	to_host.append32(0);
+	to_host.append32(0);
+#endif
+}
+
+typedef void (*ExtruderQuery)(uint8_t id, OutPacket& to_host);
+
+// Indexed by the SLAVE_CMD_ code, NULL for those which aren't tool queries
+const static ExtruderQuery extruder_queries[SLAVE_CMD_GET_PID_STATE + 1] PROGMEM = {
+	queryVersion,		// SLAVE_CMD_VERSION
+	NULL,
+	queryTemp,		// SLAVE_CMD_GET_TEMP
+	NULL, NULL, NULL, NULL, NULL, NULL, NULL,			//  3 - 9
+	NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,	// 10 - 19
+	NULL, NULL,
+	queryIsToolReady,	// SLAVE_CMD_IS_TOOL_READY
+	NULL, NULL, NULL, NULL, NULL, NULL, NULL,			// 23 - 29
+	queryPlatformTemp,	// SLAVE_CMD_GET_PLATFORM_TEMP
+	NULL,
+	querySetPoint,		// SLAVE_CMD_GET_SP
+	queryPlatformSetPoint,	// SLAVE_CMD_GET_PLATFORM_SP
+	NULL,
+	queryIsPlatformReady,	// SLAVE_CMD_IS_PLATFORM_READY
+	queryToolStatus,	// SLAVE_CMD_GET_TOOL_STATUS
+	queryPIDState		// SLAVE_CMD_GET_PID_STATE
+};
+
+// Append the answer to one tool query, returns false if it isn't supported
+static bool appendExtruderQuery(uint8_t id, uint8_t command, OutPacket& to_host) {
+	if ( command > SLAVE_CMD_GET_PID_STATE ) return false;
+	ExtruderQuery query = (ExtruderQuery)pgm_read_word(&extruder_queries[command]);
+	if ( ! query ) return false;
+	query(id, to_host);
+	return true;
+}
+
+/// answer the tool index and query pairs after byte 0, as described for
+/// HOST_CMD_TOOL_MULTI_QUERY
+static void handleToolMultiQuery(const InPacket& from_host, OutPacket& to_host) {
+	// The answers are gathered first, as the count goes ahead of them
+	OutPacket answers;
+	uint8_t room = MAX_PACKET_PAYLOAD - to_host.getLength() - 2;
+	uint8_t answered = 0;
+
+	for ( uint8_t i = 1; i + 1 < from_host.getLength(); i += 2 ) {
+		if ( answers.getLength() + EXTRUDER_QUERY_MAX_ANSWER > room )
+			break;
+		if ( ! appendExtruderQuery(from_host.read8(i), from_host.read8(i + 1), answers) )
+			break;
+		answered++;
+	}
+
+	to_host.append8(RC_OK);
+	to_host.append8(answered);
+	for ( uint8_t i = 0; i < answers.getLength(); i++ )
+		to_host.append8(answers.read8(i));
+}
+
+// There's really nothing we want to do here; we don't want to
+// interrupt a running build, for example.
+static void handleInit(const InPacket&, OutPacket& to_host) {
+	to_host.append8(RC_OK);
+}
+
+// HOST_CMD_CLEAR_BUFFER and HOST_CMD_ABORT are equivalent at current time
+static void handleReset(const InPacket&, OutPacket& to_host) {
+	bool resetMe = true;
+	command::addFilamentUsed();
+	if (currentState == HOST_STATE_BUILDING ||
+	    currentState == HOST_STATE_BUILDING_FROM_SD ||
+	    currentState == HOST_STATE_BUILDING_ONBOARD) {
+	     if (1 == eeprom::settings.clear_for_estop) {
+		  buildState = BUILD_CANCELED;
 #if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
-					  steppers::disableZMinEnd(false);
-#endif
-                      steppers::z_Offset_Change=0;//we reset the gap to ZERO to avoid summing it next time we start a print.
-					  stopBuild();
-					  resetMe = false;
-				     }
-				     // Motherboard::getBoard().indicateError(ERR_RESET_DURING_BUILD);
-				}
-				if ( resetMe ) {
-				     do_host_reset = true; // indicate reset after response has been sent
-				     do_host_reset_timeout.start(200000);	//Protection against the firmware sending to a down host
-				}
-				to_host.append8(RC_OK);
-				return true;
-			}
-			case HOST_CMD_GET_BUFFER_SIZE:
-				handleGetBufferSize(to_host);
-				return true;
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
-			case HOST_CMD_GET_POSITION:
-				handleGetPosition(to_host);
-				return true;
-			case HOST_CMD_GET_POSITION_EXT:
-				handleGetPositionExt(to_host);
-				return true;
-#pragma GCC diagnostic pop
+		  steppers::disableZMinEnd(false);
+#endif
+		  steppers::z_Offset_Change=0;//we reset the gap to ZERO to avoid summing it next time we start a print.
+		  stopBuild();
+		  resetMe = false;
+	     }
+	     // Motherboard::getBoard().indicateError(ERR_RESET_DURING_BUILD);
+	}
+	if ( resetMe ) {
+	     do_host_reset = true; // indicate reset after response has been sent
+	     do_host_reset_timeout.start(200000);	//Protection against the firmware sending to a down host
+	}
+	to_host.append8(RC_OK);
+}
+
+    // legacy tool / motherboard breakout of query commands
+static void handleToolQuery(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t id = from_host.read8(1);
+	uint8_t command = from_host.read8(2);
+	// All commands are query commands.
+	to_host.append8(RC_OK);
+	if ( ! appendExtruderQuery(id, command, to_host) )
+		to_host.append8(RC_CMD_UNSUPPORTED);
+}
+
+/// answer with the time, then as many of the bytes after byte 0 as fit, for
+/// a host to time the link with
+static void handleDebugEcho(const InPacket& from_host, OutPacket& to_host) {
+	uint8_t wrap;
+	to_host.append8(RC_OK);
+	to_host.append32(Motherboard::getBoard().getCurrentCentaMicros(&wrap));
+	for ( uint8_t i = 1; i < from_host.getLength() && to_host.getLength() < MAX_PACKET_PAYLOAD; i++ )
+		to_host.append8(from_host.read8(i));
+}
+
+typedef void (*QueryHandler)(const InPacket& from_host, OutPacket& to_host);
+
+// The query handlers, indexed by the command code, NULL for those which
+// aren't supported
+const static QueryHandler query_handlers[HOST_CMD_EEPROM_IMAGE + 1] PROGMEM = {
+	handleVersion,			// HOST_CMD_VERSION
+	handleInit,			// HOST_CMD_INIT
+	handleGetBufferSize,		// HOST_CMD_GET_BUFFER_SIZE
+	handleReset,			// HOST_CMD_CLEAR_BUFFER
+	handleGetPosition,		// HOST_CMD_GET_POSITION
+	NULL,
+	NULL,
+	handleReset,			// HOST_CMD_ABORT
+	handlePause,			// HOST_CMD_PAUSE
+	NULL,				// HOST_CMD_PROBE
+	handleToolQuery,		// HOST_CMD_TOOL_QUERY
+	handleIsFinished,		// HOST_CMD_IS_FINISHED
+	handleReadEeprom,		// HOST_CMD_READ_EEPROM
+	handleWriteEeprom,		// HOST_CMD_WRITE_EEPROM
 #ifdef S3G_CAPTURE_2_SD
-			case HOST_CMD_CAPTURE_TO_FILE:
-				handleCaptureToFile(from_host,to_host);
-				return true;
-			case HOST_CMD_END_CAPTURE:
-				handleEndCapture(from_host,to_host);
-				return true;
-#endif
-			case HOST_CMD_PLAYBACK_CAPTURE:
-				handlePlayback(from_host,to_host);
-				return true;
-			case HOST_CMD_NEXT_FILENAME:
-				handleNextFilename(from_host,to_host);
-				return true;
-			case HOST_CMD_PAUSE:
-				handlePause(to_host);
-				return true;
-			case HOST_CMD_TOOL_QUERY:
-				if(processExtruderQueryPacket(from_host,to_host)){
-					return true;}
-				break;
-			case HOST_CMD_IS_FINISHED:
-				handleIsFinished(to_host);
-				return true;
-			case HOST_CMD_READ_EEPROM:
-				handleReadEeprom(from_host,to_host);
-				return true;
-			case HOST_CMD_WRITE_EEPROM:
-				handleWriteEeprom(from_host,to_host);
-				return true;
-			case HOST_CMD_EXTENDED_STOP:
-				handleExtendedStop(from_host,to_host);
-				return true;
-			case HOST_CMD_BOARD_STATUS:
-				handleGetBoardStatus(to_host);
-				return true;
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
-			case HOST_CMD_GET_BUILD_STATS:
-				handleGetBuildStats(to_host);
-				return true;
-#pragma GCC diagnostic pop
-			case HOST_CMD_ADVANCED_VERSION:
-				handleGetAdvancedVersion(from_host, to_host);
-				return true;
-			}
-		}
+	handleCaptureToFile,		// HOST_CMD_CAPTURE_TO_FILE
+	handleEndCapture,		// HOST_CMD_END_CAPTURE
+#else
+	NULL,
+	NULL,
+#endif
+	handlePlayback,			// HOST_CMD_PLAYBACK_CAPTURE
+	handleReset,			// HOST_CMD_RESET
+	handleNextFilename,		// HOST_CMD_NEXT_FILENAME
+	NULL,				// HOST_CMD_GET_DBG_REG
+	handleGetBuildName,		// HOST_CMD_GET_BUILD_NAME
+	handleGetPositionExt,		// HOST_CMD_GET_POSITION_EXT
+	handleExtendedStop,		// HOST_CMD_EXTENDED_STOP
+	handleGetBoardStatus,		// HOST_CMD_BOARD_STATUS
+	handleGetBuildStats,		// HOST_CMD_GET_BUILD_STATS
+	NULL,
+	NULL,
+	handleGetAdvancedVersion,	// HOST_CMD_ADVANCED_VERSION
+#ifdef ISR_PROFILE
+	handleGetIsrProfile,		// HOST_CMD_GET_ISR_PROFILE
+#else
+	NULL,
+#endif
+#ifdef SD_BENCHMARK
+	handleSdBenchmark,		// HOST_CMD_SD_BENCHMARK
+#else
+	NULL,
+#endif
+#ifdef SD_PLAYBACK_STATS
+	handleGetSdPlaybackStats,	// HOST_CMD_GET_SD_PLAYBACK_STATS
+#else
+	NULL,
+#endif
+	handleSetBaudRate,		// HOST_CMD_SET_BAUD_RATE
+	handleSetPacketWindow,		// HOST_CMD_SET_PACKET_WINDOW
+#ifdef SLICE_STATS
+	handleGetSliceStats,		// HOST_CMD_GET_SLICE_STATS
+#else
+	NULL,
+#endif
+#if HOST_TELEMETRY
+	handleSetTelemetry,		// HOST_CMD_SET_TELEMETRY
+#else
+	NULL,
+#endif
+	handleToolMultiQuery,		// HOST_CMD_TOOL_MULTI_QUERY
+#ifdef HEATER_FEED_FORWARD
+	handleHeaterTune,		// HOST_CMD_HEATER_TUNE
+#else
+	NULL,
+#endif
+#ifdef PID_AUTOTUNE
+	handlePIDAutotune,		// HOST_CMD_PID_AUTOTUNE
+#else
+	NULL,
+#endif
+#ifdef HEATER_LOG
+	handleHeaterLog,		// HOST_CMD_HEATER_LOG
+#else
+	NULL,
+#endif
+#ifdef HOST_LOG
+	handleHostLog,			// HOST_CMD_HOST_LOG
+#else
+	NULL,
+#endif
+#ifdef MEMORY_PROFILE
+	handleGetMemoryProfile,		// HOST_CMD_GET_MEMORY_PROFILE
+#else
+	NULL,
+#endif
+#ifdef SD_DRY_RUN
+	handleDryRun,			// HOST_CMD_DRY_RUN
+#else
+	NULL,
+#endif
+	handleSetCreditMode,		// HOST_CMD_SET_CREDIT_MODE
+#ifdef PLANNER_STATS
+	handleGetPlannerStats,		// HOST_CMD_GET_PLANNER_STATS
+#else
+	NULL,
+#endif
+#ifdef FLIGHT_RECORDER
+	handleFlightRecorder,		// HOST_CMD_FLIGHT_RECORDER
+#else
+	NULL,
+#endif
+#ifdef PC_PROFILE
+	handlePcProfile,		// HOST_CMD_PC_PROFILE
+#else
+	NULL,
+#endif
+#ifdef HOST_LARGE_PACKETS
+	handleSetLargePackets,		// HOST_CMD_SET_LARGE_PACKETS
+#else
+	NULL,
+#endif
+#ifdef EEPROM_IMAGE
+	handleEepromImage		// HOST_CMD_EEPROM_IMAGE
+#else
+	NULL
+#endif
+};
+
+// query packets (non action, not queued), returns false if it isn't supported
+bool processQueryPacket(const InPacket& from_host, OutPacket& to_host) {
+	if ( from_host.getLength() < 1 ) return false;
+
+	uint8_t command = from_host.read8(0);
+	if ( command == HOST_CMD_DEBUG_ECHO ) {
+		handleDebugEcho(from_host, to_host);
+		return true;
 	}
-	return false;
+	if ( command > HOST_CMD_EEPROM_IMAGE ) return false;
+	QueryHandler handler = (QueryHandler)pgm_read_word(&query_handlers[command]);
+	if ( ! handler ) return false;
+	handler(from_host, to_host);
+	return true;
 }
 
 char* getMachineName() {
@@ -782,7 +1849,10 @@ void stopPrintTime() {
 
     print_time_state = PRINT_TIME_OTHER;
 
-    // Save the information
+    // Save the information, unless nothing was built
+#ifdef SD_DRY_RUN
+    if ( ! dryrun::isRunning() )
+#endif
     eeprom::updateBuildTime(last_print_hours, last_print_minutes);
 }
 
@@ -814,6 +1884,11 @@ sdcard::SdErrorCode startBuildFromSD(char *fname, uint8_t flen) {
 		for (uint8_t i = 0; i < flen; i++) buildName[i] = fname[i];
 		buildName[flen] = 0;
 	}
+#ifdef PRINT_QUEUE
+	// Builds the queue's entries, which come back through here
+	if ( printqueue::isQueueFile(fname) )
+		return printqueue::start(fname);
+#endif
 	e = sdcard::startPlayback(fname);
 	if (e == sdcard::SD_CWD) return sdcard::SD_SUCCESS;
 	if (e != sdcard::SD_SUCCESS) {
@@ -830,6 +1905,23 @@ sdcard::SdErrorCode startBuildFromSD(char *fname, uint8_t flen) {
 	buildWasCancelled = false;
 	currentState = HOST_STATE_BUILDING_FROM_SD;
 	BOARD_STATUS_SET(Motherboard::STATUS_SD_CARD_PLAYING);
+	// A dry run leaves the last build's checkpoints be, and has no use for
+	// a pre-scan
+#ifdef SD_DRY_RUN
+	if ( ! dryrun::isRunning() ) {
+#endif
+#ifdef POWER_LOSS_RESUME
+	checkpoint::buildStarted(fname);
+#endif
+#ifdef SD_PRESCAN
+	prescan::start(fname);
+#endif
+#ifdef LAYER_LOG
+	layerlog::start(fname);
+#endif
+#ifdef SD_DRY_RUN
+	}
+#endif
 
 	return e;
 }
@@ -858,6 +1950,18 @@ void stopBuildNow() {
     last_print_line = command::getLineNumber();
 #endif
     stopPrintTime();
+#ifdef POWER_LOSS_RESUME
+    checkpoint::buildEnded();
+#endif
+#ifdef SD_PRESCAN
+    prescan::stop();
+#endif
+#ifdef LAYER_LOG
+    layerlog::stop();
+#endif
+#ifdef SD_DRY_RUN
+    dryrun::stop();
+#endif
     do_host_reset = true; // indicate reset after response has been sent
     do_host_reset_timeout.start(200000);	//Protection against the firmware sending to a down host
 #if HAS_RGB_LED
@@ -875,9 +1979,17 @@ void stopBuildNow() {
 // where we pause first and when that's complete we call stopBuildNow to cancel the
 // print.  The purpose of the pause is to move the build away from the tool head.
 void stopBuild() {
+#ifdef FAST_CANCEL
+    bool fast = eeprom::settings.fast_cancel &&
+	!command::isPaused() && !command::pauseIntermediateState();
+#endif
     buildState = BUILD_CANCELLING;
     buildWasCancelled = true;
-    steppers::abort();
+#if defined(FAST_CANCEL) && defined(FAST_PAUSE)
+    // The pause slows it to a stop within the move instead
+    if ( !fast )
+#endif
+    steppers::abortDecelerated();
     disable_slowdown = true;
 
     BOARD_STATUS_SET(Motherboard::STATUS_CANCELLING);
@@ -888,6 +2000,10 @@ void stopBuild() {
     //The runSlice picks up this pause later when completed, then calls stopBuildNow
     if ( (command::isPaused()) || (command::pauseIntermediateState()) )
 		stopBuildNow();
+#ifdef FAST_CANCEL
+    else if ( fast )
+		command::fastCancel();
+#endif
     else
 		command::pause(true);
 #if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
@@ -918,62 +2034,6 @@ void pauseBuild(bool pause, bool cold) {
 	}
 }
 
-    // legacy tool / motherboard breakout of query commands
-bool processExtruderQueryPacket(const InPacket& from_host, OutPacket& to_host) {
-	Motherboard& board = Motherboard::getBoard();
-	if (from_host.getLength() >= 1) {
-
-        uint8_t	id = from_host.read8(1);
-		uint8_t command = from_host.read8(2);
-		// All commands are query commands.
-		to_host.append8(RC_OK);
-		switch (command) {
-		case SLAVE_CMD_VERSION:
-			to_host.append16(firmware_version);
-			return true;
-		case SLAVE_CMD_GET_TEMP:
-			to_host.append16(board.getExtruderBoard(id).getExtruderHeater().get_current_temperature());
-			return true;
-		case SLAVE_CMD_IS_TOOL_READY:
-			to_host.append8(board.getExtruderBoard(id).getExtruderHeater().has_reached_target_temperature()?1:0);
-			return true;
-		case SLAVE_CMD_GET_PLATFORM_TEMP:
-			to_host.append16(board.getPlatformHeater().get_current_temperature());
-			return true;
-		case SLAVE_CMD_GET_SP:
-			to_host.append16(board.getExtruderBoard(id).getExtruderHeater().get_set_temperature());
-			return true;
-		case SLAVE_CMD_GET_PLATFORM_SP:
-			to_host.append16(board.getPlatformHeater().get_set_temperature());
-			return true;
-		case SLAVE_CMD_IS_PLATFORM_READY:
-			to_host.append8(board.getPlatformHeater().has_reached_target_temperature()?1:0);
-			return true;
-		case SLAVE_CMD_GET_TOOL_STATUS:
-			to_host.append8((board.getExtruderBoard(id).getExtruderHeater().has_failed()?128:0)
-							| (board.getPlatformHeater().has_failed()?64:0)
-							| (board.getExtruderBoard(id).getExtruderHeater().GetFailMode())
-							| (board.getExtruderBoard(id).getExtruderHeater().has_reached_target_temperature()?1:0));
-			return true;
-		case SLAVE_CMD_GET_PID_STATE:
-#if defined(SUPPORT_GET_PID_STATE)
-			to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDErrorTerm());
-			to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDDeltaTerm());
-			to_host.append16(board.getExtruderBoard(id).getExtruderHeater().getPIDLastOutput());
-			to_host.append16(board.getPlatformHeater().getPIDErrorTerm());
-			to_host.append16(board.getPlatformHeater().getPIDDeltaTerm());
-			to_host.append16(board.getPlatformHeater().getPIDLastOutput());
-#else
-			to_host.append32(0);
-			to_host.append32(0);
-			to_host.append32(0);
-#endif
-			return true;
-		}
-	}
-	return false;
-}
-
 #if defined(BUILD_STATS) || defined(ESTIMATE_TIME)
 
 bool isBuildComplete() {
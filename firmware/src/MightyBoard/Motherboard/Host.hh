@@ -21,7 +21,7 @@
 #include "Model.hh"
 #include "Packet.hh"
 #include "SDCard.hh"
-#include "CircularBuffer.hh"
+#include "Command.hh"
 
 // TODO: Make this a class.
 /// Functions in the host namespace deal with communications to the host
@@ -86,7 +86,7 @@ void stopBuildNow();
 void stopBuild();
 
 /// set build state and build name
-void handleBuildStartNotification(CircularBuffer& buf);
+void handleBuildStartNotification(CommandBuffer& buf);
 
 /// set build state
 void handleBuildStopNotification();
@@ -0,0 +1,73 @@
+/*
+ *  Ring of the host packets answered and their timing, read back over the
+ *  host interface.
+ */
+
+#include "Compat.hh"
+#include "HostLog.hh"
+
+#ifdef HOST_LOG
+
+#include "Motherboard.hh"
+#include "Command.hh"
+#include <string.h>
+
+namespace hostlog {
+
+// As for the heater log, a record's slot is its sequence number modulo the
+// size
+#if (HOST_LOG_RECORDS & (HOST_LOG_RECORDS - 1)) != 0 || HOST_LOG_RECORDS > 0x8000
+#error HOST_LOG_RECORDS must be a power of two, no more than 32768
+#endif
+
+static HostRecord records[HOST_LOG_RECORDS];
+
+static uint16_t next = 0;		///< Sequence number of the next record
+static uint16_t held = 0;		///< Records held, up to HOST_LOG_RECORDS
+static bool logging = false;
+
+void start() {
+	next = 0;
+	held = 0;
+	logging = true;
+}
+
+void stop() {
+	logging = false;
+}
+
+bool isRunning() {
+	return logging;
+}
+
+void record(uint8_t command, uint8_t response) {
+	if ( !logging ) return;
+
+	uint8_t wrap;
+	HostRecord *r = &records[next % HOST_LOG_RECORDS];
+	r->time = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	r->command = command;
+	r->response = response;
+	r->free = command::getRemainingCapacity();
+
+	next ++;
+	if ( held < HOST_LOG_RECORDS ) held ++;
+}
+
+uint16_t getNext() {
+	return next;
+}
+
+uint16_t getOldest() {
+	return next - held;
+}
+
+bool getRecord(uint16_t seq, HostRecord *record) {
+	if ( (uint16_t)(next - 1 - seq) >= held ) return false;
+	memcpy(record, &records[seq % HOST_LOG_RECORDS], sizeof(HostRecord));
+	return true;
+}
+
+}
+
+#endif
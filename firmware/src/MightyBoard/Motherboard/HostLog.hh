@@ -0,0 +1,57 @@
+#ifndef __HOST_LOG_HH__
+#define __HOST_LOG_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A ring of the host packets runHostSlice() has answered, each with the time
+// it was taken in and the reply given, so that the timing of a print from a
+// host can be read back with HOST_CMD_HOST_LOG and replayed through the
+// simulator's hostreplay to see where the command buffer ran dry.  Once it's
+// full the oldest records are overwritten.
+
+#ifdef HOST_LOG
+
+// 8 bytes each; a power of two
+#ifndef HOST_LOG_RECORDS
+#define HOST_LOG_RECORDS	128
+#endif
+
+// Command byte of a record for a packet which failed to arrive whole
+#define HOST_LOG_NO_COMMAND	0xff
+
+namespace hostlog {
+
+typedef struct {
+	uint32_t time;		///< Hundreds of microseconds since the board started
+	uint8_t command;	///< First byte of the payload, or HOST_LOG_NO_COMMAND
+	uint8_t response;	///< Response code of the reply
+	uint16_t free;		///< Space left in the command buffer after the packet
+} HostRecord;
+
+/// Clear the log and start logging
+void start();
+
+/// Stop logging, keeping the records
+void stop();
+
+bool isRunning();
+
+/// Called by runHostSlice() with each reply it sends
+void record(uint8_t command, uint8_t response);
+
+/// Sequence number of the next record to be logged; it counts from 0 at
+/// the start and wraps
+uint16_t getNext();
+
+/// Sequence number of the oldest record held
+uint16_t getOldest();
+
+/// Copy record seq, returns false if it isn't held
+bool getRecord(uint16_t seq, HostRecord *record);
+
+}
+
+#endif
+
+#endif
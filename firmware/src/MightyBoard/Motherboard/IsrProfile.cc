@@ -0,0 +1,65 @@
+/*
+ *  Execution time statistics for the stepper, advance and ADC interrupts,
+ *  used to see how close a print is to overrunning the stepper timer.
+ */
+
+#include "Configuration.hh"
+
+#if defined(ISR_PROFILE)
+
+#include <string.h>
+#include <util/atomic.h>
+#include "IsrProfile.hh"
+
+static isr_profile_t isr_profile[ISR_PROFILE_SOURCES];
+
+uint16_t isr_profile_overruns;
+
+void isr_profile_record(uint8_t source, uint16_t ticks) {
+	isr_profile_t *p = &isr_profile[source];
+	uint8_t sreg = SREG;
+	cli();
+
+	if ( ticks < p->min_ticks )	p->min_ticks = ticks;
+	if ( ticks > p->max_ticks )	p->max_ticks = ticks;
+
+	// Before the count overflows, halve the history.  The average and
+	// histogram then favour recent calls, without losing their shape.
+	if ( p->count == 0xffff ) {
+		p->count >>= 1;
+		p->total_ticks >>= 1;
+		for ( uint8_t i = 0; i < ISR_PROFILE_BUCKETS; i ++ )
+			p->histogram[i] >>= 1;
+	}
+	p->count ++;
+	p->total_ticks += ticks;
+
+	// Bucket limits are 32, 128 and 512 ticks
+	uint8_t bucket;
+	if	( ticks < 32 )	bucket = 0;
+	else if ( ticks < 128 )	bucket = 1;
+	else if ( ticks < 512 )	bucket = 2;
+	else			bucket = 3;
+	p->histogram[bucket] ++;
+
+	SREG = sreg;
+}
+
+bool isr_profile_get(uint8_t source, isr_profile_t *profile) {
+	if ( source >= ISR_PROFILE_SOURCES ) return false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memcpy(profile, &isr_profile[source], sizeof(isr_profile_t));
+	}
+	return true;
+}
+
+void isr_profile_reset(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memset(isr_profile, 0, sizeof(isr_profile));
+		for ( uint8_t i = 0; i < ISR_PROFILE_SOURCES; i ++ )
+			isr_profile[i].min_ticks = 0xffff;
+		isr_profile_overruns = 0;
+	}
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __ISR_PROFILE_HH__
+#define __ISR_PROFILE_HH__
+
+#include "Configuration.hh"
+
+#if defined(ISR_PROFILE)
+
+#include <inttypes.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// Execution time statistics for the interrupt handlers which compete with the
+// stepper interrupt.  Times are measured with the stepper timer, which ticks at
+// 2 MHz, i.e. every 8 cpu cycles.
+//
+// For the stepper interrupt, the time recorded is from when the interrupt became
+// due until it finished, and an overrun is counted when that is longer than the
+// interval to the next stepper interrupt.
+
+#define ISR_PROFILE_ST_INTERRUPT	0	// st_interrupt(), called from the stepper interrupt
+#define ISR_PROFILE_EXTRUDER_INTERRUPT	1	// st_extruder_interrupt(), the advance interrupt
+#define ISR_PROFILE_SETUP_NEXT_BLOCK	2	// setup_next_block(), part of st_interrupt()
+#define ISR_PROFILE_ADC			3	// ADC conversion complete interrupt
+#define ISR_PROFILE_UART_RX		4	// host UART receive interrupt, the packet parser
+#define ISR_PROFILE_SOURCES		5
+
+// Histogram buckets are < 256, < 1024, < 4096 and >= 4096 cpu cycles
+#define ISR_PROFILE_BUCKETS		4
+
+#define ISR_PROFILE_CYCLES_PER_TICK	8
+
+typedef struct {
+	uint16_t min_ticks;
+	uint16_t max_ticks;
+	uint32_t total_ticks;		// Sum of the times of the last "count" calls
+	uint16_t count;
+	uint16_t histogram[ISR_PROFILE_BUCKETS];
+} isr_profile_t;
+
+extern uint16_t isr_profile_overruns;
+
+// Stepper timer count.  Interrupts are disabled for the read, so it's safe to
+// use from code which has interrupts enabled; a nested interrupt could
+// otherwise corrupt the shared 16 bit TEMP register half way through.
+inline uint16_t isr_profile_now() {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t ticks = STEPPER_TCNTn;
+	SREG = sreg;
+	return ticks;
+}
+
+// Ticks elapsed since start.  Allows for the stepper timer having been
+// reset by a compare match once in between
+inline uint16_t isr_profile_since(uint16_t start) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t now = STEPPER_TCNTn;
+	if ( now < start ) now += STEPPER_OCRnA + 1;
+	SREG = sreg;
+	return now - start;
+}
+
+// Reading or writing the high byte of a 16 bit timer register on its own accesses
+// the timer's TEMP register.  Interrupts which can preempt code using the stepper
+// timer (i.e. the ADC interrupt, which can run inside the stepper interrupt) must
+// save and restore it around their own timer reads.
+#define ISR_PROFILE_TEMP		(*((volatile uint8_t *)&STEPPER_TCNTn + 1))
+
+// Records a call of source which took ticks
+extern void isr_profile_record(uint8_t source, uint16_t ticks);
+
+// Copies the statistics for source, returns false if source is out of range
+extern bool isr_profile_get(uint8_t source, isr_profile_t *profile);
+
+extern void isr_profile_reset(void);
+
+#endif
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * How the X, Y and Z axes of the commands map to the X, Y and Z motors for
+ * the machine geometry the firmware is built for.
+ *
+ * Each geometry is a struct of static transforms over the first three axes,
+ * inlined at compile time; the extruders always map straight through.  The
+ * maps are linear, so they turn moves as well as positions.  Kinematics is
+ * typedef'd to the geometry CORE_XY, CORE_XY_STEPPER, CORE_XZ or CORE_XYZ
+ * selects, and the planner, the stepper interrupt and homing are written
+ * against it, so a new geometry is a new struct here and a line below.
+ *
+ *   toMotors(m, c)         Cartesian steps c[3] to motor steps m[3]
+ *   toCartesian(c, m)      The inverse.  Whole cartesian steps make motor
+ *                          steps whose sums are even, so the halving is exact
+ *   endstopDirections(m)   For motors moving by m[3], bit n is set when the
+ *                          carriage heads towards the max endstop of axis n.
+ *                          The endstops watch the carriage, not the motor
+ *
+ * The transforms are templated on the arrays, so they read and write the
+ * volatile positions of the stepper interrupt as well.
+ *
+ * KINEMATICS_MIXED_MASK has a bit set for each motor which drives more than
+ * one axis, and is 0 for Cartesian machines.  When it isn't, either the
+ * planner plans the motor steps (KINEMATICS_MIX_IN_PLANNER) or it plans
+ * cartesian steps which the stepper interrupt mixes as it starts each block
+ * (KINEMATICS_MIX_IN_STEPPER).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef KINEMATICS_HH
+#define KINEMATICS_HH
+
+#include <stdint.h>
+
+#ifndef FORCE_INLINE
+	#ifdef SIMULATOR
+		#define FORCE_INLINE inline
+	#else
+		#define FORCE_INLINE __attribute__((always_inline)) inline
+	#endif
+#endif
+
+// Bits of the X, Y and Z motors in the masks below, which the preprocessor
+// needs before AxisEnum is declared
+#define KINEMATICS_X	(1 << 0)
+#define KINEMATICS_Y	(1 << 1)
+#define KINEMATICS_Z	(1 << 2)
+
+struct CartesianKinematics {
+	template <typename M, typename C>
+	static FORCE_INLINE void toMotors(M m, C c) {
+		m[0] = c[0];
+		m[1] = c[1];
+		m[2] = c[2];
+	}
+
+	template <typename C, typename M>
+	static FORCE_INLINE void toCartesian(C c, M m) {
+		c[0] = m[0];
+		c[1] = m[1];
+		c[2] = m[2];
+	}
+
+	template <typename M>
+	static FORCE_INLINE uint8_t endstopDirections(M m) {
+		return ((m[0] > 0) ? KINEMATICS_X : 0) |
+			((m[1] > 0) ? KINEMATICS_Y : 0) |
+			((m[2] > 0) ? KINEMATICS_Z : 0);
+	}
+};
+
+// A = X + Y, B = X - Y on the X and Y motors
+struct CoreXYKinematics {
+	template <typename M, typename C>
+	static FORCE_INLINE void toMotors(M m, C c) {
+		int32_t x = c[0], y = c[1];
+		m[0] = x + y;
+		m[1] = x - y;
+		m[2] = c[2];
+	}
+
+	template <typename C, typename M>
+	static FORCE_INLINE void toCartesian(C c, M m) {
+		int32_t a = m[0], b = m[1];
+		c[0] = (a + b) / 2;
+		c[1] = (a - b) / 2;
+		c[2] = m[2];
+	}
+
+	// Whichever of X and Y the carriage mostly moves along: both motors
+	// forward is +X, A forward and B back is +Y
+	template <typename M>
+	static FORCE_INLINE uint8_t endstopDirections(M m) {
+		if ( m[0] <= 0 ) return 0;
+		return ( m[1] > 0 ) ? KINEMATICS_X : ( m[1] < 0 ) ? KINEMATICS_Y : 0;
+	}
+};
+
+// A = X + Z, B = X - Z on the X and Z motors
+struct CoreXZKinematics {
+	template <typename M, typename C>
+	static FORCE_INLINE void toMotors(M m, C c) {
+		int32_t x = c[0], z = c[2];
+		m[0] = x + z;
+		m[1] = c[1];
+		m[2] = x - z;
+	}
+
+	template <typename C, typename M>
+	static FORCE_INLINE void toCartesian(C c, M m) {
+		int32_t a = m[0], b = m[2];
+		c[0] = (a + b) / 2;
+		c[1] = m[1];
+		c[2] = (a - b) / 2;
+	}
+
+	template <typename M>
+	static FORCE_INLINE uint8_t endstopDirections(M m) {
+		uint8_t bits = ( m[1] > 0 ) ? KINEMATICS_Y : 0;
+		if ( m[0] <= 0 ) return bits;
+		return bits | (( m[2] > 0 ) ? KINEMATICS_X : ( m[2] < 0 ) ? KINEMATICS_Z : 0);
+	}
+};
+
+// A = Z + Y + X, B = Z + Y - X, C = Z - Y - X on all three motors.  The
+// endstops go by the motors
+struct CoreXYZKinematics {
+	template <typename M, typename C>
+	static FORCE_INLINE void toMotors(M m, C c) {
+		int32_t x = c[0], y = c[1], z = c[2];
+		m[0] = z + y + x;
+		m[1] = z + y - x;
+		m[2] = z - y - x;
+	}
+
+	template <typename C, typename M>
+	static FORCE_INLINE void toCartesian(C c, M m) {
+		int32_t a = m[0], b = m[1], d = m[2];
+		c[0] = (a - b) / 2;
+		c[1] = (b - d) / 2;
+		c[2] = (d + a) / 2;
+	}
+
+	template <typename M>
+	static FORCE_INLINE uint8_t endstopDirections(M m) {
+		return CartesianKinematics::endstopDirections(m);
+	}
+};
+
+#if defined(CORE_XY) + defined(CORE_XY_STEPPER) + defined(CORE_XZ) + defined(CORE_XYZ) > 1
+	#error "Only one of CORE_XY, CORE_XY_STEPPER, CORE_XZ and CORE_XYZ may be defined"
+#endif
+
+#if defined(CORE_XY)
+	typedef CoreXYKinematics Kinematics;
+	#define KINEMATICS_MIXED_MASK	(KINEMATICS_X | KINEMATICS_Y)
+	#define KINEMATICS_MIX_IN_PLANNER
+#elif defined(CORE_XY_STEPPER)
+	typedef CoreXYKinematics Kinematics;
+	#define KINEMATICS_MIXED_MASK	(KINEMATICS_X | KINEMATICS_Y)
+	#define KINEMATICS_MIX_IN_STEPPER
+#elif defined(CORE_XZ)
+	typedef CoreXZKinematics Kinematics;
+	#define KINEMATICS_MIXED_MASK	(KINEMATICS_X | KINEMATICS_Z)
+	#define KINEMATICS_MIX_IN_PLANNER
+#elif defined(CORE_XYZ)
+	typedef CoreXYZKinematics Kinematics;
+	#define KINEMATICS_MIXED_MASK	(KINEMATICS_X | KINEMATICS_Y | KINEMATICS_Z)
+	#define KINEMATICS_MIX_IN_PLANNER
+#else
+	typedef CartesianKinematics Kinematics;
+	#define KINEMATICS_MIXED_MASK	0
+#endif
+
+// The axes whose motors must hold while those in axes move: all of the mixed
+// ones when any of them is moving
+FORCE_INLINE uint8_t kinematicsHoldAxes(uint8_t axes)
+{
+	return ( axes & KINEMATICS_MIXED_MASK ) ? ( axes | KINEMATICS_MIXED_MASK ) : axes;
+}
+
+#endif // KINEMATICS_HH
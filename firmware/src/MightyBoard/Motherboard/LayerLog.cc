@@ -0,0 +1,257 @@
+/*
+ *  Per layer log of an SD card build's timing, queued and written to the
+ *  card behind the build.
+ */
+
+#include "Compat.hh"
+#include "LayerLog.hh"
+
+#ifdef LAYER_LOG
+
+#include <string.h>
+
+#include "Motherboard.hh"
+#include "Host.hh"
+#include "SDCard.hh"
+#include "Command.hh"
+#include "Steppers.hh"
+#include "StepperAxis.hh"
+#include "StepperAccelPlanner.hh"
+#include "Timeout.hh"
+
+// Queued bytes written at a time, and the blocks the planner must hold for
+// the card to be written to
+#define LAYER_LOG_FLUSH_BYTES	64
+#ifndef LAYER_LOG_MIN_BLOCKS
+#define LAYER_LOG_MIN_BLOCKS	(BLOCK_BUFFER_SIZE / 2)
+#endif
+
+// How often the heaters are looked at
+#define LAYER_LOG_HEATER_MICROS	250000L
+
+namespace layerlog {
+
+static bool running = false;
+
+// Planning side: the height of the layer the moves are being planned in and
+// the mm planned in it
+static uint16_t planned_layers;
+static int32_t z_top;
+static float planned_mm;
+
+// Stepping side: the layer being stepped, since the last PLAN_ACTION_LAYER
+static bool in_layer;
+static uint16_t layer;
+static int32_t layer_z;
+static micros_t layer_start;
+static uint16_t layer_underruns;
+static uint8_t min_blocks;
+static int16_t heater_dev;
+
+static uint16_t dropped;
+static Timeout heater_timeout;
+
+// NAME.LOG for NAME.X3G; left empty when there's no room for it
+static void makeLogName(char *dst, const char *name) {
+	const char *dot = strrchr(name, '.');
+	size_t len = dot ? (size_t)(dot - name) : strlen(name);
+
+	dst[0] = 0;
+	if ( len + 5 > MAX_FILE_LEN )
+		return;
+	memcpy(dst, name, len);
+	strcpy_P(dst + len, PSTR(".log"));
+}
+
+// Appends v, with a point before its last decimals digits
+static char *appendFixed(char *p, int32_t v, uint8_t decimals) {
+	char digits[11];
+	uint8_t n = 0;
+	uint32_t u = (uint32_t)v;
+
+	if ( v < 0 ) {
+		*p++ = '-';
+		u = (uint32_t)-v;
+	}
+	do {
+		digits[n++] = '0' + u % 10;
+		u /= 10;
+	} while ( u || n <= decimals );
+	while ( n ) {
+		if ( n == decimals ) *p++ = '.';
+		*p++ = digits[--n];
+	}
+	return p;
+}
+
+static uint16_t underruns() {
+	uint16_t n = 0;
+	for (uint8_t i = 0; i < steppers::UNDERRUN_CAUSES; i++)
+		n += steppers::getUnderruns(i);
+	return n;
+}
+
+// Queues a line, or counts it as dropped
+static void logLine(const char *line, uint8_t n) {
+	if ( !sdcard::logWrite(line, n) && dropped != 0xffff )
+		dropped++;
+}
+
+static void startLayer() {
+	uint8_t wrap;
+	uint8_t toolIndex;
+	in_layer = true;
+	layer_z = steppers::getStepperPosition(&toolIndex)[Z_AXIS];
+	layer_start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	layer_underruns = underruns();
+	min_blocks = 0xff;
+	heater_dev = 0;
+}
+
+static void endLayer(uint32_t mm100) {
+	uint8_t wrap;
+	char line[64];
+	char *p = line;
+
+	uint32_t ms = (Motherboard::getBoard().getCurrentCentaMicros(&wrap) - layer_start) / 10;
+	float z_um = (float)layer_z * 1000.0 / stepperAxisStepsPerMM(Z_AXIS);
+
+	layer++;
+	p = appendFixed(p, layer, 0);
+	*p++ = ',';
+	p = appendFixed(p, (int32_t)z_um, 3);
+	*p++ = ',';
+	p = appendFixed(p, (int32_t)ms, 0);
+	*p++ = ',';
+	// Tenths of a mm/s; mm100 is 24 bits
+	p = appendFixed(p, ms ? (int32_t)(mm100 * 100 / ms) : 0, 1);
+	*p++ = ',';
+	p = appendFixed(p, (uint16_t)(underruns() - layer_underruns), 0);
+	*p++ = ',';
+	p = appendFixed(p, ( min_blocks == 0xff ) ? 0 : min_blocks, 0);
+	*p++ = ',';
+	p = appendFixed(p, heater_dev, 0);
+	*p++ = '\n';
+	logLine(line, (uint8_t)(p - line));
+	in_layer = false;
+}
+
+void start(char *name) {
+	char log_name[MAX_FILE_LEN];
+
+	stop();
+	makeLogName(log_name, name);
+	if ( !log_name[0] || sdcard::logOpen(log_name) != sdcard::SD_SUCCESS )
+		return;
+
+	planned_layers = 0;
+	z_top = 0;
+	planned_mm = 0.0;
+	in_layer = false;
+	layer = 0;
+	dropped = 0;
+	heater_timeout.start(LAYER_LOG_HEATER_MICROS);
+	running = true;
+
+	static const char header[] PROGMEM =
+		"layer,z_mm,ms,mm_per_s,underruns,min_blocks,heater_dev\n";
+	char line[sizeof(header)];
+	strcpy_P(line, header);
+	logLine(line, sizeof(header) - 1);
+}
+
+void stop() {
+	if ( !running )
+		return;
+	running = false;
+
+	// The moves planned since the last layer change have been stepped, or
+	// thrown away
+	if ( in_layer ) {
+		float mm100 = planned_mm * 100.0;
+		endLayer(( mm100 < 16777215.0 ) ? (uint32_t)mm100 : 0xffffffUL);
+	}
+	if ( dropped ) {
+		char line[24];
+		char *p = line;
+		strcpy_P(p, PSTR("# dropped "));
+		p = appendFixed(p + strlen(p), dropped, 0);
+		*p++ = '\n';
+		sdcard::logWrite(line, (uint8_t)(p - line));
+	}
+	sdcard::logClose();
+}
+
+bool isRunning() {
+	return running;
+}
+
+void runSlice() {
+	if ( !running )
+		return;
+
+	uint8_t blocks = movesplanned();
+	if ( in_layer && blocks < min_blocks )
+		min_blocks = blocks;
+
+	if ( in_layer && heater_timeout.hasElapsed() ) {
+		heater_timeout.start(LAYER_LOG_HEATER_MICROS);
+		Motherboard &board = Motherboard::getBoard();
+		for (uint8_t i = 0; i < EXTRUDERS; i++) {
+			Heater &heater = board.getExtruderBoard(i).getExtruderHeater();
+			if ( heater.get_set_temperature() > 0 && !heater.isPaused() &&
+			     heater.getDelta() > heater_dev )
+				heater_dev = heater.getDelta();
+		}
+		if ( board.isUsingPlatform() && board.getPlatformHeater().get_set_temperature() > 0 &&
+		     board.getPlatformHeater().getDelta() > heater_dev )
+			heater_dev = board.getPlatformHeater().getDelta();
+	}
+
+	// A write can take the card a few ms, which the planner's blocks have to
+	// cover; waiting for the heaters, nothing's moving
+	if ( sdcard::logQueued() >= LAYER_LOG_FLUSH_BYTES &&
+	     ( blocks >= LAYER_LOG_MIN_BLOCKS || command::isHeating() ) )
+		sdcard::logFlush();
+}
+
+void planned(float mm) {
+	bool extruding = planner_target[A_AXIS] > planner_position[A_AXIS];
+#if STEPPER_COUNT > 4
+	extruding = extruding || planner_target[B_AXIS] > planner_position[B_AXIS];
+#endif
+
+	if ( extruding &&
+	     ( planner_target[X_AXIS] != planner_position[X_AXIS] ||
+	       planner_target[Y_AXIS] != planner_position[Y_AXIS] ) &&
+	     ( planned_layers == 0 || planner_target[Z_AXIS] > z_top ) ) {
+		planned_layers++;
+		z_top = planner_target[Z_AXIS];
+
+		// The distance of the layer before goes with the action, which
+		// leaves one for the command being run
+		float mm100 = planned_mm * 100.0;
+		uint32_t n = ( mm100 < 16777215.0 ) ? (uint32_t)mm100 : 0xffffffUL;
+		plan_action_t action;
+		action.type = PLAN_ACTION_LAYER;
+		action.arg[0] = (uint8_t)n;
+		action.arg[1] = (uint8_t)(n >> 8);
+		action.arg[2] = (uint8_t)(n >> 16);
+		if ( plan_action_room() < 2 || !plan_queue_action(&action) )
+			layerDone(n);
+		planned_mm = 0.0;
+	}
+	planned_mm += mm;
+}
+
+void layerDone(uint32_t mm100) {
+	if ( !running )
+		return;
+	if ( in_layer )
+		endLayer(mm100);
+	startLayer();
+}
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef __LAYER_LOG_HH__
+#define __LAYER_LOG_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A line for each layer of an SD card build, written as it goes to NAME.LOG
+// next to NAME.X3G, for telling afterwards where the build slowed down:
+//
+//   layer,z_mm,ms,mm_per_s,underruns,min_blocks,heater_dev
+//
+// with the time the layer took, the average speed of its moves, the planner
+// underruns during it (see steppers::checkUnderrun()), the fewest blocks the
+// planner held and the furthest, in degrees, a heater was from its target.
+// As for the pre-scan, a layer starts with the first move extruded at a
+// greater height; it's timed from when the steppers finish the block before
+// it.  The lines are queued and only written to the card while the planner
+// has blocks to spare, so that the log doesn't hold up the moves; one which
+// doesn't fit the queue is dropped, and the count of those ends the log.
+
+#ifdef LAYER_LOG
+
+namespace layerlog {
+
+/// Called when an SD card build starts, with the name of its file in the
+/// working directory
+void start(char *name);
+
+/// Called when the build ends; the last layer is logged and the log closed
+void stop();
+
+bool isRunning();
+
+/// Called from runHostSlice(), samples the planner and heaters, and writes
+/// some of the log when it's safe to
+void runSlice();
+
+/// Called by the planner with each move it's about to queue, from
+/// planner_position to planner_target, mm long.  The move which starts a
+/// layer has the planner queue PLAN_ACTION_LAYER behind the blocks before it.
+void planned(float mm);
+
+/// Called when PLAN_ACTION_LAYER is taken up, with the hundredths of a mm
+/// the moves of the layer which ended add up to
+void layerDone(uint32_t mm100);
+
+}
+
+#endif
+
+#endif
@@ -32,6 +32,8 @@
 #include <util/delay.h>
 #include "UtilityScripts.hh"
 #include "Piezo.hh"
+#include "Scheduler.hh"
+#include "MemoryProfile.hh"
 
 #if defined(STACK_PAINT) && defined(DEBUG_SRAM_MONITOR)
 	bool stackAlertLockout = false;
@@ -45,8 +47,6 @@
         extern uint8_t __bss_end;
         extern uint8_t __stack;
 
-        #define STACK_CANARY 0xc5
-
         void StackPaint(void) __attribute__ ((naked)) __attribute__ ((section (".init1")));
 
         void StackPaint(void)
@@ -194,14 +194,8 @@ int main() {
 
 	sei();
 	while (1) {
-		// Host interaction thread.
-		host::runHostSlice();
-		// Command handling thread.
-		command::runCommandSlice();
-		// Motherboard slice
-		board.runMotherboardSlice();
-                // Stepper slice
-                steppers::runSteppersSlice();
+		// Host, command, motherboard, stepper and piezo slices
+		scheduler::runSlices();
 
 		//Alert if SRAM/stack has been corrupted by running out of SRAM
 #if defined(STACK_PAINT) && defined(DEBUG_SRAM_MONITOR)
@@ -215,8 +209,9 @@ int main() {
 		}
 #endif
 
-		// Piezo slice
-		Piezo::runPiezoSlice();
+#ifdef MEMORY_PROFILE
+		memory_profile_sample();
+#endif
 
 		// reset the watch dog timer
 		wdt_reset();
@@ -20,6 +20,9 @@
 
 #include <avr/interrupt.h>
 
+/// What StackPaint() fills the free SRAM with at start up
+#define STACK_CANARY 0xc5
+
 /// Test for stack / SRAM corruption
 /// Returns the number of bytes that haven't been touched on the stack
 extern uint16_t StackCount(void);
@@ -0,0 +1,121 @@
+/*
+ *  SRAM usage: the stack's high-water mark from the STACK_CANARY paint,
+ *  the static SRAM of the larger buffers, and the headroom over time, used
+ *  to see how much more the planner and the buffers can be given.
+ */
+
+#include "Configuration.hh"
+
+#if defined(MEMORY_PROFILE)
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "MemoryProfile.hh"
+#include "Main.hh"
+#include "Timeout.hh"
+#include "Command.hh"
+#include "StepperAccelPlanner.hh"
+#include "LiquidCrystalSerial.hh"
+#include "UART.hh"
+
+extern uint8_t __data_start;
+extern uint8_t __bss_end;
+extern uint8_t __stack;
+
+// Only set once malloc() has been called.  Weak, so as not to pull malloc()
+// into builds which don't otherwise use it
+extern uint8_t *__brkval __attribute__((weak));
+
+// Buffers placed in external SRAM (see Xmem.hh) take none of the internal
+const static PROGMEM uint16_t subsystem_bytes[MEMORY_PROFILE_SUBSYSTEMS] = {
+#if defined(XMEM) && defined(XMEM_PLANNER)
+	0,
+#else
+	sizeof(block_t) * BLOCK_BUFFER_SIZE,
+#endif
+#if defined(XMEM) && defined(XMEM_COMMANDS)
+	0,
+#else
+	sizeof(CommandBuffer),
+#endif
+	sizeof(LiquidCrystalSerial),
+	sizeof(UART)
+};
+
+// Fails to compile unless MEMORY_PROFILE_HISTORY is a power of two
+typedef char history_check[((MEMORY_PROFILE_HISTORY & (MEMORY_PROFILE_HISTORY - 1)) == 0) ? 1 : -1];
+
+static uint16_t history[MEMORY_PROFILE_HISTORY];
+static uint8_t history_next;
+static uint8_t history_count;
+static Timeout sample_timeout;
+
+static const uint8_t *heapEnd() {
+	if ( &__brkval && __brkval )
+		return __brkval;
+	return &__bss_end;
+}
+
+// Untouched bytes, counted up from the heap
+static uint16_t headroom() {
+	const uint8_t *p = heapEnd();
+	uint16_t c = 0;
+
+	while ( *p == STACK_CANARY && p <= &__stack ) {
+		p++;
+		c++;
+	}
+	return c;
+}
+
+void memory_profile_get(memory_profile_t *profile) {
+	const uint8_t *heap_end = heapEnd();
+
+	profile->sram = (uint16_t)(RAMEND + 1 - RAMSTART);
+	profile->static_bytes = (uint16_t)(&__bss_end - &__data_start);
+	profile->heap = (uint16_t)(heap_end - &__bss_end);
+	profile->headroom = headroom();
+	profile->stack = (uint16_t)(&__stack + 1 - heap_end) - profile->headroom;
+	profile->free_now = (uint16_t)((const uint8_t *)SP - heap_end);
+}
+
+uint16_t memory_profile_subsystem(uint8_t subsystem) {
+	if ( subsystem >= MEMORY_PROFILE_SUBSYSTEMS ) return 0;
+	return pgm_read_word(&subsystem_bytes[subsystem]);
+}
+
+uint8_t memory_profile_history(uint16_t *samples) {
+	uint8_t i = ( history_next - history_count ) & (MEMORY_PROFILE_HISTORY - 1);
+	for ( uint8_t n = 0; n < history_count; n ++ ) {
+		samples[n] = history[i];
+		i = ( i + 1 ) & (MEMORY_PROFILE_HISTORY - 1);
+	}
+	return history_count;
+}
+
+void memory_profile_sample(void) {
+	if ( sample_timeout.isActive() && ! sample_timeout.hasElapsed() )
+		return;
+	sample_timeout.start(MEMORY_PROFILE_SAMPLE_S * 1000000L);
+
+	history[history_next] = headroom();
+	history_next = ( history_next + 1 ) & (MEMORY_PROFILE_HISTORY - 1);
+	if ( history_count < MEMORY_PROFILE_HISTORY )
+		history_count ++;
+}
+
+void memory_profile_reset(void) {
+	// Nothing below the stack pointer is live: an interrupt which comes
+	// in part way through has returned before the painting carries on
+	uint8_t *p = (uint8_t *)heapEnd();
+	uint8_t *end = (uint8_t *)SP;
+
+	while ( p < end )
+		*p++ = STACK_CANARY;
+
+	history_next = 0;
+	history_count = 0;
+	sample_timeout.abort();
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __MEMORY_PROFILE_HH__
+#define __MEMORY_PROFILE_HH__
+
+#include "Configuration.hh"
+
+#if defined(MEMORY_PROFILE)
+
+#if !defined(STACK_PAINT)
+#error "MEMORY_PROFILE needs STACK_PAINT"
+#endif
+
+#include <inttypes.h>
+
+// SRAM use, from the linker's section symbols and the STACK_CANARY paint of
+// Main.cc.  The stack has never reached the bytes between the top of the heap
+// (the end of .bss when nothing has been malloc()ed) and the first byte below
+// the stack which no longer holds the paint, so those are the headroom left.
+
+#define MEMORY_PROFILE_PLANNER		0	// block_buffer[]
+#define MEMORY_PROFILE_COMMANDS		1	// command_buffer
+#define MEMORY_PROFILE_LCD		2	// the LCD driver and its shadow of the screen
+#define MEMORY_PROFILE_PACKETS		3	// the host UART and its packets
+#define MEMORY_PROFILE_SUBSYSTEMS	4
+
+// The headroom is sampled every MEMORY_PROFILE_SAMPLE_S seconds, and the last
+// MEMORY_PROFILE_HISTORY samples are kept
+#define MEMORY_PROFILE_HISTORY		8
+#ifndef MEMORY_PROFILE_SAMPLE_S
+#define MEMORY_PROFILE_SAMPLE_S		60
+#endif
+
+typedef struct {
+	uint16_t sram;		// Size of the SRAM
+	uint16_t static_bytes;	// .data and .bss
+	uint16_t heap;		// malloc()ed
+	uint16_t stack;		// Deepest the stack has been
+	uint16_t headroom;	// Never touched
+	uint16_t free_now;	// Between the heap and the stack pointer
+} memory_profile_t;
+
+extern void memory_profile_get(memory_profile_t *profile);
+
+// Bytes of static SRAM one of the MEMORY_PROFILE_ subsystems has, 0 for one
+// out of range
+extern uint16_t memory_profile_subsystem(uint8_t subsystem);
+
+// Copies the headroom samples to samples, oldest first, and returns how many
+// there are
+extern uint8_t memory_profile_history(uint16_t *samples);
+
+// Called from the main loop, takes a sample when one is due
+extern void memory_profile_sample(void);
+
+// Paints the free SRAM again, so the stack's depth is measured afresh, and
+// clears the history
+extern void memory_profile_reset(void);
+
+#endif
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ *  Mesh leveling: Z offsets probed on a grid of MESH_POINTS_X by
+ *  MESH_POINTS_Y points, interpolated bilinearly between them.  Where the
+ *  three point plane of SkewTilt.cc can't follow a plate which isn't flat,
+ *  the mesh can, so long as moves are split where they cross the grid's
+ *  lines (see mesh_crossing()); between two lines the offset changes
+ *  linearly along a straight move.
+ *
+ *  Positions on the grid are kept in cells, in fixed point with
+ *  MESH_FRAC_BITS of fraction, and worked out from steps with a reciprocal
+ *  of the grid's spacing taken once in mesh_init().  A point costs four
+ *  multiplies and no division.
+ */
+
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+
+#include "Compat.hh"
+#include <stdlib.h>
+#include <stddef.h>
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+
+#include "Eeprom.hh"
+#include "EepromMap.hh"
+#include "MeshLevel.hh"
+
+#define MESH_FRAC_BITS  12
+#define MESH_FRAC_ONE   (1L << MESH_FRAC_BITS)
+#define MESH_RECIP_BITS 24
+
+// The grid lines must be at least this many steps apart, which keeps the
+// reciprocals below 2^14 and their products with offsets of up to 2^16
+// steps in 32 bits
+#define MESH_CELL_MIN   1024
+
+// A move which starts this close to a grid line, in 1/MESH_FRAC_ONE of a
+// cell, isn't split at it; there's nothing to gain from a tiny segment
+#define MESH_NEAR       64
+
+// Marks a whole mesh in EEPROM, and that it was probed on this size of grid
+#define MESH_GRID       (MESH_POINTS_X | (MESH_POINTS_Y << 4))
+
+// At eeprom_offsets::ALEVEL_MESH, followed by the Z of each point less the
+// Z of the first as MESH_POINTS int16s
+typedef struct {
+     int32_t first[2];  // X, Y of the first point probed
+     int32_t last[2];   // X, Y of the last point probed
+     int32_t z;         // Z of the first point
+     uint8_t grid;      // MESH_GRID once the last point has been recorded
+} mesh_header_t;
+
+#define MESH_EEPROM(field) (eeprom_offsets::ALEVEL_MESH + offsetof(mesh_header_t, field))
+#define MESH_EEPROM_Z      (eeprom_offsets::ALEVEL_MESH + sizeof(mesh_header_t))
+
+typedef char mesh_size_check[(MESH_POINTS_X >= 2 && MESH_POINTS_Y >= 2 &&
+			      MESH_POINTS_X < 16 && MESH_POINTS_Y < 16) ? 1 : -1];
+typedef char mesh_eeprom_check[(MESH_EEPROM_Z + MESH_POINTS * sizeof(int16_t) <=
+				eeprom_offsets::ALEVEL_MESH_END) ? 1 : -1];
+
+bool mesh_active = false;
+
+// As skew_zdelta
+static int32_t mesh_zdelta = ALEVEL_NOT_ACTIVE;
+
+// Points recorded so far, and the Z of the first of them
+static uint8_t mesh_recorded = 0;
+static int32_t mesh_record_z;
+
+// The first point of the grid, with the Z home offset taken from its Z.
+// Moved when the coordinate space is translated.
+static int32_t mesh_origin[3];
+
+// 2^MESH_RECIP_BITS over the spacing, in steps, of the grid along X and Y
+static int32_t mesh_recip[2];
+
+// Z offsets from the first point, row by row
+static int16_t mesh_z[MESH_POINTS];
+
+// Position along an axis in cells from the first point
+static int32_t gridPos(int32_t p, uint8_t axis)
+{
+     return ( (p - mesh_origin[axis]) * mesh_recip[axis] ) >> (MESH_RECIP_BITS - MESH_FRAC_BITS);
+}
+
+static int32_t lerp(int32_t d, int32_t f)
+{
+     return ( d * f + (MESH_FRAC_ONE >> 1) ) >> MESH_FRAC_BITS;
+}
+
+// The cell which position u is in, and how far across it, held to the grid
+static uint8_t cellOf(int32_t u, uint8_t points, int32_t *f)
+{
+     if ( u <= 0 ) {
+	  *f = 0;
+	  return 0;
+     }
+     if ( u >= ((int32_t)(points - 1) << MESH_FRAC_BITS) ) {
+	  *f = MESH_FRAC_ONE;
+	  return points - 2;
+     }
+     *f = u & (MESH_FRAC_ONE - 1);
+     return (uint8_t)(u >> MESH_FRAC_BITS);
+}
+
+int32_t mesh(const int32_t *P)
+{
+     int32_t fx, fy;
+     uint8_t i = cellOf(gridPos(P[0], 0), MESH_POINTS_X, &fx);
+     uint8_t j = cellOf(gridPos(P[1], 1), MESH_POINTS_Y, &fy);
+
+     const int16_t *z = &mesh_z[j * MESH_POINTS_X + i];
+     int32_t z0 = z[0] + lerp(z[1] - z[0], fx);
+     int32_t z1 = z[MESH_POINTS_X] + lerp(z[MESH_POINTS_X + 1] - z[MESH_POINTS_X], fx);
+
+     return mesh_origin[2] + z0 + lerp(z1 - z0, fy);
+}
+
+// num of den as a fraction of MESH_SPLIT_WHOLE, for |num| < |den|
+static uint16_t splitFraction(int32_t num, int32_t den)
+{
+     while ( labs(den) >= (1L << (31 - MESH_SPLIT_BITS)) ) {
+	  num >>= 1;
+	  den >>= 1;
+     }
+     int32_t f = (num << MESH_SPLIT_BITS) / den;
+     return ( f < 1 ) ? 1 : (uint16_t)f;
+}
+
+uint16_t mesh_crossing(const int32_t *from, const int32_t *to)
+{
+     uint16_t split = MESH_SPLIT_WHOLE;
+
+     for ( uint8_t axis = 0; axis < 2; axis++ ) {
+	  int32_t u0 = gridPos(from[axis], axis);
+	  int32_t u1 = gridPos(to[axis], axis);
+	  int32_t last = ( axis == 0 ) ? MESH_POINTS_X - 1 : MESH_POINTS_Y - 1;
+	  int32_t line;
+
+	  // The first line past u0 on the way to u1.  Outside the first and
+	  // last lines the offset doesn't change, so those are the only lines
+	  // there.
+	  if ( u1 > u0 ) {
+	       line = ( (u0 + MESH_NEAR) >> MESH_FRAC_BITS ) + 1;
+	       if ( line < 0 ) line = 0;
+	       if ( line > last ) continue;
+	       line <<= MESH_FRAC_BITS;
+	       if ( line >= u1 ) continue;
+	  }
+	  else if ( u1 < u0 ) {
+	       line = ( u0 - MESH_NEAR - 1 ) >> MESH_FRAC_BITS;
+	       if ( line > last ) line = last;
+	       if ( line < 0 ) continue;
+	       line <<= MESH_FRAC_BITS;
+	       if ( line <= u1 ) continue;
+	  }
+	  else
+	       continue;
+
+	  uint16_t f = splitFraction(line - u0, u1 - u0);
+	  if ( f < split ) split = f;
+     }
+
+     return split;
+}
+
+bool mesh_record(uint8_t idx, const int32_t *P)
+{
+     if ( idx != mesh_recorded || idx >= MESH_POINTS ) {
+	  mesh_recorded = 0;
+	  return false;
+     }
+
+     cli();
+     if ( idx == 0 ) {
+	  mesh_record_z = P[2];
+	  // Not a whole mesh again until the last point is in
+	  eeprom::writeByte((uint8_t *)MESH_EEPROM(grid), 0xff);
+	  eeprom::writeBlock(P, (void *)MESH_EEPROM(first), 2 * sizeof(int32_t));
+	  eeprom::writeBlock(&mesh_record_z, (void *)MESH_EEPROM(z), sizeof(int32_t));
+     }
+
+     int32_t dz = P[2] - mesh_record_z;
+     int16_t z = ( dz > 32767 ) ? 32767 : ( dz < -32768 ) ? -32768 : (int16_t)dz;
+     eeprom::writeBlock(&z, (void *)(MESH_EEPROM_Z + idx * sizeof(int16_t)), sizeof(int16_t));
+
+     if ( idx == MESH_POINTS - 1 ) {
+	  eeprom::writeBlock(P, (void *)MESH_EEPROM(last), 2 * sizeof(int32_t));
+	  eeprom::writeByte((uint8_t *)MESH_EEPROM(grid), MESH_GRID);
+     }
+     sei();
+
+     mesh_recorded++;
+     return true;
+}
+
+bool mesh_init(int32_t maxz, int32_t zoffset)
+{
+     mesh_header_t h;
+
+     mesh_deinit();
+
+     cli();
+     eeprom::readBlock(&h, (void *)eeprom_offsets::ALEVEL_MESH, sizeof(h));
+     eeprom::readBlock(mesh_z, (void *)MESH_EEPROM_Z, sizeof(mesh_z));
+     sei();
+
+     // Never probed, or not on this size of grid
+     if ( h.grid != MESH_GRID )
+	  return false;
+
+     int16_t zmin = mesh_z[0], zmax = mesh_z[0];
+     for ( uint8_t i = 1; i < MESH_POINTS; i++ ) {
+	  if ( mesh_z[i] < zmin ) zmin = mesh_z[i];
+	  if ( mesh_z[i] > zmax ) zmax = mesh_z[i];
+     }
+     if ( (int32_t)zmax - zmin > maxz ) {
+	  mesh_zdelta = ALEVEL_BAD_LEVEL;
+	  return false;
+     }
+
+     // The spacing may be negative, when the grid was probed from the far
+     // corner, and gridPos() counts from the first point either way
+     int32_t cell[2];
+     cell[0] = ( h.last[0] - h.first[0] ) / ( MESH_POINTS_X - 1 );
+     cell[1] = ( h.last[1] - h.first[1] ) / ( MESH_POINTS_Y - 1 );
+     if ( labs(cell[0]) < MESH_CELL_MIN || labs(cell[1]) < MESH_CELL_MIN ) {
+	  mesh_zdelta = ALEVEL_COLINEAR;
+	  return false;
+     }
+     mesh_recip[0] = (1L << MESH_RECIP_BITS) / cell[0];
+     mesh_recip[1] = (1L << MESH_RECIP_BITS) / cell[1];
+
+     mesh_origin[0] = h.first[0];
+     mesh_origin[1] = h.first[1];
+     mesh_origin[2] = h.z - zoffset;
+
+     mesh_zdelta = (int32_t)zmax - zmin;
+     mesh_active = true;
+
+     return true;
+}
+
+void mesh_update(const int32_t *delta)
+{
+     mesh_origin[0] += delta[0];
+     mesh_origin[1] += delta[1];
+     mesh_origin[2] += delta[2];
+}
+
+void mesh_deinit(void)
+{
+     mesh_active   = false;
+     mesh_zdelta   = ALEVEL_NOT_ACTIVE;
+     mesh_recorded = 0;
+}
+
+int32_t mesh_status(void)
+{
+     return mesh_zdelta;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef __MESH_LEVEL_HH__
+#define __MESH_LEVEL_HH__
+
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_MESH)
+
+#include <stdint.h>
+#include "Configuration.hh"
+#include "SkewTilt.hh"
+
+// Points probed along X and Y; the grid they make needn't be square
+#ifndef MESH_POINTS_X
+#define MESH_POINTS_X 4
+#endif
+
+#ifndef MESH_POINTS_Y
+#define MESH_POINTS_Y 4
+#endif
+
+#define MESH_POINTS (MESH_POINTS_X * MESH_POINTS_Y)
+
+// Fractions of a move given by mesh_crossing()
+#define MESH_SPLIT_BITS  14
+#define MESH_SPLIT_WHOLE (1 << MESH_SPLIT_BITS)
+
+extern bool mesh_active;
+
+// The Z offset, in steps, of the mesh at P's X and Y.  Beyond the edges
+// of the grid the edge values carry on.
+extern int32_t mesh(const int32_t *P);
+
+// Record probed point idx, at P.  The points are probed row by row: along
+// X from the first, then the next row over in Y.  Returns false, and
+// starts over, if idx isn't the next point.
+extern bool mesh_record(uint8_t idx, const int32_t *P);
+
+// Load the mesh recorded in EEPROM and start leveling with it.  As for
+// skew_init(), maxz is the most the points may differ by in Z and zoffset
+// the Z home offset.
+extern bool mesh_init(int32_t maxz, int32_t zoffset);
+
+extern void mesh_update(const int32_t *delta);
+extern void mesh_deinit(void);
+
+// As skew_status(): ALEVEL_ codes, or the max Z difference between points
+extern int32_t mesh_status(void);
+
+// How far, in 1/MESH_SPLIT_WHOLE of the way, a move from the point from to
+// the point to goes before it first crosses a line of the grid, or
+// MESH_SPLIT_WHOLE if it doesn't cross one
+extern uint16_t mesh_crossing(const int32_t *from, const int32_t *to);
+
+#endif
+
+#endif
@@ -28,9 +28,12 @@
 #include "Commands.hh"
 #include "Eeprom.hh"
 #include "EepromMap.hh"
+#include "StatsJournal.hh"
+#include "Checkpoint.hh"
 #include "Piezo.hh"
 #ifdef HAS_RGB_LED
 #include "RGB_LED.hh"
+#include "RGB_Effects.hh"
 #endif
 #include "Errors.hh"
 #include <avr/eeprom.h>
@@ -39,6 +42,8 @@
 #include "TemperatureTable.hh"
 #include "SDCard.hh"
 #include "TWI.hh"
+#include "IsrProfile.hh"
+#include "FlightRecorder.hh"
 
 #ifdef DIGIPOT_SUPPORT
 #include "DigiPots.hh"
@@ -74,11 +79,20 @@
 	#warning "Release: DEBUG_SRAM_MONITOR enabled in Configuration.hh"
 #endif
 
-//Frequency of Timer 5
-//100 = (1.0 / ( 16MHz / 64 / 25 = 10KHz)) * 1000000
-//#define MICROS_INTERVAL 100
+// Timer 5 counts at 16 MHz / 64 = 250 KHz and overflows once a millisecond
+#define TIMER5_TICKS_PER_MS	250
+#define TIMER5_TICKS_PER_CENTA	25
 
-/// ticks of 100 Microsecond units since board initialization
+#if defined(HBP_SOFTPWM)
+#if !defined(HBP_HEAT_ON_OC5B)
+#error "HBP_SOFTPWM needs HBP_HEAT on OC5B"
+#endif
+// The HBP's duty while it's on, in ticks of a timer 5 cycle
+#define HBP_PWM_TICKS		205
+#endif
+
+/// ticks of 100 Microsecond units since board initialization, to the last
+/// timer 5 overflow
 static volatile micros_t centa_micros = 0;
 static volatile uint8_t clock_wrap    = 0;
 
@@ -93,17 +107,11 @@ static bool singleTool;
 uint8_t board_status;
 static bool heating_lights_active;
 
-#if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
-#define FAN_PWM_BITS 6
-#endif
-
 #if defined(COOLING_FAN_PWM)
 //fan duty cycle 0-100 cached from incoming commands.
-static uint8_t fan_pwm_bottom_count;
 int8_t fan_pwm_cached_value;
 bool           fan_pwm_enable = false;
 #elif defined(COOLING_FAN_PWM_ON_DISPLAY)
-uint8_t fan_pwm_bottom_count;
 bool           fan_pwm_enable = false;
 bool           fan_pwm_override = false;
 uint8_t        fan_pwm_override_value = 100;
@@ -114,6 +122,16 @@ static volatile int32_t zprobe_trigger_clear_zpos = 0;
 static volatile uint32_t total_zprobe_triggered = 0;
 #endif
 
+#if !defined(USE_THERMOCOUPLE_DUAL) || defined(SAMPLE_INTERVAL_MICROS_THERMISTOR)
+// A sample period from HEATER_PERIODS, in hundredths of a second but no
+// fewer than least, or the build's own period where that's 0
+static micros_t heaterPeriod(uint8_t offset, uint8_t least, micros_t period) {
+	uint8_t hundredths = eeprom::getEeprom8(eeprom_offsets::HEATER_PERIODS + offset, 0);
+	if ( hundredths == 0 ) return period;
+	return 10000L * (( hundredths < least ) ? least : hundredths);
+}
+#endif
+
 /// Instantiate static motherboard instance
 Motherboard Motherboard::motherboard;
 
@@ -126,11 +144,7 @@ Motherboard::Motherboard() :
      therm_sensor(),
 #endif
 #endif
-#if defined(HAS_I2C_LCD) || defined(HAS_VIKI_INTERFACE)
      lcd(),
-#else
-     lcd(LCD_STROBE, LCD_DATA, LCD_CLK),
-#endif
      messageScreen(),
      mainMenu(),
      finishedPrintMenu(),
@@ -164,12 +178,22 @@ Motherboard::Motherboard() :
 {
 }
 
+#ifdef JKN_ADVANCE_UNIFIED_ISR
+
+// Advance runs from the stepper interrupt, the advance timer is unused
+#define ENABLE_TIMER_INTERRUPTS		STEPPER_TIMSKn	|= (1<<STEPPER_OCIEnA)
+#define DISABLE_TIMER_INTERRUPTS	STEPPER_TIMSKn	&= ~(1<<STEPPER_OCIEnA)
+
+#else
+
 #define ENABLE_TIMER_INTERRUPTS		ADVANCE_TIMSKn 	|= (1<<ADVANCE_OCIEnA); \
                 			STEPPER_TIMSKn	|= (1<<STEPPER_OCIEnA)
 
 #define DISABLE_TIMER_INTERRUPTS	ADVANCE_TIMSKn 	&= ~(1<<ADVANCE_OCIEnA); \
                 			STEPPER_TIMSKn	&= ~(1<<STEPPER_OCIEnA)
 
+#endif
+
 // Initialize Timers
 //
 //
@@ -217,7 +241,7 @@ void Motherboard::initClocks() {
 	// this call is handled in Piezo::reset() -- no need to make it here as well
 	// Piezo::shutdown_timer();
 
-#ifdef JKN_ADVANCE
+#if defined(JKN_ADVANCE) && !defined(JKN_ADVANCE_UNIFIED_ISR)
 	// Extruder/Advance timer
 
 	ADVANCE_TCCRnA = ADVANCE_CTC;	       	// CTC
@@ -320,12 +344,23 @@ void Motherboard::initClocks() {
 	// Timer 5 is 16 bit
 	//
 	//   - Microsecond timer, SD card check timer, P-Stop check timer, LED flashing timer
-
-	TCCR5A = 0x00; // WGM51:WGM50 00
-	TCCR5B = 0x0B; // WGM53:WGM52 10 (CTC) CS52:CS50 011 (/64) => CTC, 250 KHz
+	//
+	// It runs in fast PWM with TOP at OCR5A and overflows once a millisecond.
+	// The overflow interrupt counts the milliseconds, getCurrentCentaMicros()
+	// adds the ticks since, and OC5B and OC5C are the HBP and fan PWM on the
+	// boards with them on those pins.  Where the fan is elsewhere, the
+	// overflow switches it on and the OCR5B match off again.
+
+	TCCR5A = 0x03; // WGM51:WGM50 11
+	TCCR5B = 0x1B; // WGM53:WGM52 11 (Fast PWM, TOP=OCR5A) CS52:CS50 011 (/64) => 250 KHz
 	TCCR5C = 0x00;
-	OCR5A  =   25; // 250KHz / 25 => 10 KHz
-	TIMSK5 = 0x02; // | ( 1 << OCIE5A  -> turn on OCR5A match interrupt
+	OCR5A  = TIMER5_TICKS_PER_MS - 1; // 250KHz / 250 => 1 KHz
+	TCNT5  = 0;
+#if defined(HBP_SOFTPWM)
+	OCR5B  = HBP_PWM_TICKS;
+	TCCR5A |= (1 << COM5B1);
+#endif
+	TIMSK5 = (1 << TOIE5); // turn on the overflow interrupt
 }
 
 /// Reset the motherboard to its initial state.
@@ -344,6 +379,10 @@ void Motherboard::init() {
 	hasInterfaceBoard = interface::isConnected();
 	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x03);
 
+#ifdef ISR_PROFILE
+	isr_profile_reset();
+#endif
+
 	initClocks();
 	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x04);
 
@@ -354,49 +393,16 @@ void Motherboard::reset(bool hard_reset) {
 
 	// Initialize the host and slave UARTs
 	UART::getHostUART().enable(true);
-	UART::getHostUART().in.reset();
-	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x07);
-
-	if (hasInterfaceBoard) {
-
-		// Make sure our interface board is initialized
-		interfaceBoard.init();
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x09);
-
-		splashScreen.hold_on = false;
-		interfaceBoard.pushScreen(&splashScreen);
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0A);
-
-		if ( hard_reset )
-			_delay_ms(3000);
-
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0B);
-
-		// Finally, set up the interface
-		interface::init(&interfaceBoard, &lcd);
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0C);
-
-		interface_update_timeout.start(interfaceBoard.getUpdateRate());
-	}
-
-	// interface LEDs default to full ON
-	interfaceBlink(0,0);
-
-	// only call the piezo buzzer on full reboot start up
-	// do not clear heater fail messages, though the user should not be able to soft reboot from heater fail
-	if ( hard_reset ) {
-
-#ifdef HAS_RGB_LED
-		RGB_LED::init();
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0D);
+	UART::getHostUART().resetInPackets();
+#ifdef HOST_FLOW_CONTROL_PIN
+	// Released until the host has filled the command buffer
+	HOST_FLOW_CONTROL_PIN.setValue(true);
+	HOST_FLOW_CONTROL_PIN.setDirection(true);
 #endif
-		Piezo::playTune(TUNE_SAILFISH_STARTUP);
-		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0E);
-
-		heatShutdown = 0;
-		heatFailMode = HEATER_FAIL_NONE;
-	}
+	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x07);
 
+	// The heaters and their sensors are set up ahead of the interface, whose
+	// LCD takes a while to start
 	board_status = STATUS_NONE | STATUS_PREHEATING;
 	heating_lights_active = false;
 
@@ -407,7 +413,15 @@ void Motherboard::reset(bool hard_reset) {
 #if CUTOFF_PRESENT
 	cutoff.init();
 #endif
+#if defined(USE_THERMOCOUPLE_DUAL)
+	// The reader's steps go round the channels at the pace of its ADC
 	extruder_manage_timeout.start(SAMPLE_INTERVAL_MICROS_THERMOCOUPLE);
+#else
+	// The thermocouples take a quarter second to convert
+	extruder_sample_micros = heaterPeriod(heater_period_offsets::SAMPLE, 25,
+					      SAMPLE_INTERVAL_MICROS_THERMOCOUPLE);
+	extruder_manage_timeout.start(extruder_sample_micros);
+#endif
 	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0F);
 
 	// initialize the extruders
@@ -425,7 +439,15 @@ void Motherboard::reset(bool hard_reset) {
 	DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x13);
 
 #if defined(SAMPLE_INTERVAL_MICROS_THERMISTOR)
-	platform_timeout.start(SAMPLE_INTERVAL_MICROS_THERMISTOR);
+	platform_sample_micros = heaterPeriod(heater_period_offsets::PLATFORM + heater_period_offsets::SAMPLE,
+					      10, SAMPLE_INTERVAL_MICROS_THERMISTOR);
+	platform_timeout.start(platform_sample_micros);
+#endif
+
+#ifdef HEATER_POWER_BUDGET
+	platform_credit = 0;
+	platform_slot = true;
+	power_share_timeout.start(POWER_SHARE_MICROS);
 #endif
 
 	// Note it's less code to turn them all off at once
@@ -441,6 +463,45 @@ void Motherboard::reset(bool hard_reset) {
 	if ( !eeprom::hasHBP() )
 	    platform_heater.disable(true);
 
+	if (hasInterfaceBoard) {
+
+		// Make sure our interface board is initialized
+		interfaceBoard.init();
+		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x09);
+
+		splashScreen.hold_on = false;
+		interfaceBoard.pushScreen(&splashScreen);
+		lcd.flush();
+		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0A);
+
+		// Finally, set up the interface
+		interface::init(&interfaceBoard, &lcd);
+		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0C);
+
+		// The splash stays up until the first update, which takes it
+		// down; the rest of the board runs in the meantime
+		interface_update_timeout.start(hard_reset ? SPLASH_SCREEN_MICROS :
+					       interfaceBoard.getUpdateRate());
+	}
+
+	// interface LEDs default to full ON
+	interfaceBlink(0,0);
+
+	// only call the piezo buzzer on full reboot start up
+	// do not clear heater fail messages, though the user should not be able to soft reboot from heater fail
+	if ( hard_reset ) {
+
+#ifdef HAS_RGB_LED
+		RGB_LED::init();
+		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0D);
+#endif
+		Piezo::playTune(TUNE_SAILFISH_STARTUP);
+		DEBUG_VALUE(DEBUG_MOTHERBOARD | 0x0E);
+
+		heatShutdown = 0;
+		heatFailMode = HEATER_FAIL_NONE;
+	}
+
 	// user_input_timeout.start(USER_INPUT_TIMEOUT);
 #ifdef HAS_RGB_LED
 	RGB_LED::setDefaultColor();
@@ -457,11 +518,22 @@ void Motherboard::reset(bool hard_reset) {
 /// the board was booted.
 micros_t Motherboard::getCurrentCentaMicros(uint8_t *wrap) {
 	micros_t micros_snapshot;
+	uint8_t ticks;
 	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
 	     micros_snapshot = centa_micros;
 	     *wrap = clock_wrap;
+	     // TOP is below 256, so the low byte is all of the count
+	     ticks = TCNT5L;
+	     // An overflow the interrupt hasn't had yet, unless the count was
+	     // read just before it
+	     if ( ( TIFR5 & (1 << TOV5) ) && ( ticks < TIMER5_TICKS_PER_MS / 2 ) ) {
+		  micros_snapshot += TIMER5_TICKS_PER_MS / TIMER5_TICKS_PER_CENTA;
+		  if ( micros_snapshot < TIMER5_TICKS_PER_MS / TIMER5_TICKS_PER_CENTA ) ++*wrap;
+	     }
 	}
-	return micros_snapshot;
+	micros_t now = micros_snapshot + ticks / TIMER5_TICKS_PER_CENTA;
+	if ( now < micros_snapshot ) ++*wrap;
+	return now;
 }
 
 micros_t Motherboard::getCurrentSeconds() {
@@ -485,6 +557,15 @@ void Motherboard::doStepperInterrupt() {
 	cli();
 	ENABLE_TIMER_INTERRUPTS;
 
+#ifdef ISR_PROFILE
+	//The timer was reset when this interrupt became due, so it now holds the
+	//time taken since then.  If that's past the next interrupt, we've overrun
+	uint16_t isr_ticks = STEPPER_TCNTn;
+	isr_profile_record(ISR_PROFILE_ST_INTERRUPT, isr_ticks);
+	if (( isr_ticks >= STEPPER_OCRnA ) && ( isr_profile_overruns != 0xffff ))
+		isr_profile_overruns ++;
+#endif
+
 #ifdef ANTI_CLUNK_PROTECTION
 	//Because it's possible another stepper interrupt became due whilst
 	//we were processing the last interrupt, and had stepper interrupts
@@ -553,9 +634,10 @@ void Motherboard::HeatingAlerts() {
 				heating_lights_active = true;
 			}
 #ifdef HAS_RGB_LED
+			// The timer interrupt fades to each new colour
 			if (RGB_LED::LEDEnabled)
-				SET_COLOR((255*abs((setTemp - deltaTemp)))/div_temp, 0,
-						  (255*deltaTemp)/div_temp, false);
+				RGB_Effects::fade((255*abs((setTemp - deltaTemp)))/div_temp, 0,
+						  (255*deltaTemp)/div_temp, RGB_EFFECT_HEAT_MS);
 #endif
 		}
 	}
@@ -575,6 +657,9 @@ void Motherboard::heaterFail(HeaterFailMode mode, uint8_t slave_id) {
 
 	// record heat fail mode
 	heatFailMode = mode;
+#ifdef FLIGHT_RECORDER
+	flightrec::freeze(flightrec::FREEZE_ERROR);
+#endif
 
 	if ( heatFailMode == HEATER_FAIL_NOT_PLUGGED_IN ) {
 
@@ -638,6 +723,9 @@ void Motherboard::errorResponse(const prog_uchar *msg, bool reset, bool incomple
 
 void Motherboard::errorResponse(const prog_uchar *msg1, const prog_uchar *msg2,
 				bool reset, bool incomplete) {
+#ifdef FLIGHT_RECORDER
+	flightrec::freeze(flightrec::FREEZE_ERROR);
+#endif
 	interfaceBoard.errorMessage(msg1, msg2, incomplete);
 	startButtonWait();
 	reset_request = reset;
@@ -660,13 +748,39 @@ void Motherboard::runMotherboardSlice() {
 			interface_update_timeout.start(interfaceBoard.getUpdateRate());
 			interface_updated = true;
 		}
+		// Screens draw into the LCD's copy of the display; send a few of
+		// the cells which changed on each pass
+		lcd.flush(LCD_FLUSH_BYTES);
 	}
 
+	// Queue the filament and build time journal's record, if it's changed
+	journal::service();
+#ifdef POWER_LOSS_RESUME
+	checkpoint::service();
+#endif
+
 #if defined(SAMPLE_INTERVAL_MICROS_THERMISTOR)
 	if ( isUsingPlatform() && platform_timeout.hasElapsed() ) {
 		// manage heating loops for the HBP
-		platform_heater.manage_temperature();
-		platform_timeout.start(SAMPLE_INTERVAL_MICROS_THERMISTOR);
+		if ( !platform_heater.isDisabled() )
+			platform_heater.manage_reading(platform_thermistor.update());
+		platform_timeout.start(platform_sample_micros);
+	}
+#endif
+
+#ifdef HEATER_POWER_BUDGET
+	if ( power_share_timeout.hasElapsed() ) {
+		// Give the platform heater this slot if its share has built up
+		// to a whole one, Bresenham fashion
+		uint32_t demand = ((uint16_t)Extruder_One.getExtruderHeater().get_output() +
+				   Extruder_Two.getExtruderHeater().get_output()) * HEATER_WATTS_EXTRUDER +
+			HEATER_WATTS_PLATFORM * 255L;
+		platform_credit += (uint16_t)(( demand > HEATER_POWER_BUDGET * 255L ) ?
+					      (HEATER_POWER_BUDGET * 255L * 255L) / demand : 255);
+		platform_slot = platform_credit >= 255;
+		if ( platform_slot ) platform_credit -= 255;
+		sharePower();
+		power_share_timeout.start(POWER_SHARE_MICROS);
 	}
 #endif
 
@@ -756,6 +870,11 @@ void Motherboard::runMotherboardSlice() {
 		case HEATER_FAIL_DROPPING_TEMP:
 		        msg2 = HEATER_FAIL_DROPPING_TEMP_MSG;
 			break;
+#ifdef HEATER_RUNAWAY_MODEL
+		case HEATER_FAIL_RUNAWAY:
+		        msg2 = HEATER_FAIL_RUNAWAY_MSG;
+			break;
+#endif
 		case HEATER_FAIL_NOT_PLUGGED_IN:
 			errorResponse(msg, HEATER_FAIL_NOT_PLUGGED_IN_MSG);
 			heatShutdown = 0;
@@ -808,11 +927,22 @@ void Motherboard::runMotherboardSlice() {
 
 			    // Next case doesn't occur on a Rep 2
 		       case THERM_CHANNEL_HBP:
-			    if ( isUsingPlatform() )
-				 platform_heater.manage_temperature();
+			    if ( isUsingPlatform() && !platform_heater.isDisabled() )
+				 platform_heater.manage_reading(platform_thermistor.update());
 			    break;
 
-			    // Cold junction read on a Rep 2
+#ifdef THERM_CHANNEL_ALL
+			    // All three at once from the ADC sequencer
+		       case THERM_CHANNEL_ALL:
+			    Extruder_One.runExtruderSlice();
+			    HeatingAlerts();
+			    Extruder_Two.runExtruderSlice();
+			    if ( isUsingPlatform() && !platform_heater.isDisabled() )
+				 platform_heater.manage_reading(platform_thermistor.update());
+			    break;
+#endif
+
+			    // Cold junction reads come back as THERM_ADC_BUSY
 		       default:
 			    break;
 		       }
@@ -820,16 +950,20 @@ void Motherboard::runMotherboardSlice() {
 	     }
 	}
 #else
+	// The thermocouples are read a byte per pass over shared clock and data
+	// pins, so each read is finished before the other extruder's starts
+	if ( extruder_update ) {
+	        Extruder_Two.runExtruderSlice();
+		extruder_update = Extruder_Two.isSensorBusy();
+	}
 	// stagger mid accounts for the case when we've just run the interface update
-	if ( extruder_manage_timeout.hasElapsed() && !interface_updated ) {
+	else if ( extruder_manage_timeout.hasElapsed() && !interface_updated ) {
 		Extruder_One.runExtruderSlice();
-		HeatingAlerts();
-		extruder_manage_timeout.start(SAMPLE_INTERVAL_MICROS_THERMOCOUPLE);
-		extruder_update = true;
-	}
-	else if (extruder_update) {
-	        Extruder_Two.runExtruderSlice();
-		extruder_update = false;
+		if ( !Extruder_One.isSensorBusy() ) {
+			HeatingAlerts();
+			extruder_manage_timeout.start(extruder_sample_micros);
+			extruder_update = true;
+		}
 	}
 #endif
 }
@@ -895,10 +1029,16 @@ void Motherboard::interfaceBlink(uint8_t on_time, uint8_t off_time) {
 	}
 }
 
-#ifdef JKN_ADVANCE
+#if defined(JKN_ADVANCE) && !defined(JKN_ADVANCE_UNIFIED_ISR)
 /// Timer 2 extruder advance
 ISR(ADVANCE_TIMERn_COMPA_vect) {
+#ifdef ISR_PROFILE
+	uint16_t isr_start = STEPPER_TCNTn;
+#endif
 	steppers::doExtruderInterrupt();
+#ifdef ISR_PROFILE
+	isr_profile_record(ISR_PROFILE_EXTRUDER_INTERRUPT, isr_profile_since(isr_start));
+#endif
 }
 #endif
 
@@ -908,53 +1048,40 @@ uint8_t blink_overflow_counter = 0;
 
 volatile micros_t m2;
 
-#if defined(HBP_SOFTPWM) && defined(__AVR_ATmega2560__)
-volatile uint8_t pwmcnt = 0;
-#define PWM_H   210
-#define PWM_COUST   255
-#endif
-
-/// Timer 5 overflow interrupt
-ISR(TIMER5_COMPA_vect) {
-#if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
-     static uint8_t fan_pwm_counter = 255;
-#endif
-
-     // Motherboard::getBoard().UpdateMicros();
-     if ( ++centa_micros == 0 ) ++clock_wrap;
-     if ( ++mcount >= 10000 ) {
+/// Timer 5 overflow interrupt, once a millisecond
+ISR(TIMER5_OVF_vect) {
+     micros_t micros = centa_micros + TIMER5_TICKS_PER_MS / TIMER5_TICKS_PER_CENTA;
+     if ( micros < TIMER5_TICKS_PER_MS / TIMER5_TICKS_PER_CENTA ) ++clock_wrap;
+     centa_micros = micros;
+     if ( ++mcount >= 1000 ) {
 	  seconds += 1;
 	  mcount = 0;
      }
 
-#if defined(HBP_SOFTPWM) && defined(__AVR_ATmega2560__)
-     //softpwm
-    if (pwmcnt < PWM_H) {
-        HBP_HEAT.setValue(true);
-    } else {
-        HBP_HEAT.setValue(false);
-    }
-    if (pwmcnt >= PWM_COUST)
-        pwmcnt = 0;
-    else
-        pwmcnt++;
+#if (defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)) && !defined(EX_FAN_ON_OC5C)
+     // The start of the fan's pulse; the OCR5B match ends it
+     if ( fan_pwm_enable )
+	  EX_FAN.setValue(true);
 #endif
 
-#if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
-    if ( fan_pwm_enable ) {
-	 // fan_pwm_counter is uint8_t
-	 //   we expect it to wrap such that 255 + 1 ==> 0
-	 if ( ++fan_pwm_counter == 0 )
-	      fan_pwm_counter = 256 - (1 << FAN_PWM_BITS);
-	 EX_FAN.setValue(fan_pwm_counter <= fan_pwm_bottom_count);
-    }
+	Piezo::tick();
+
+#ifdef HAS_RGB_LED
+	RGB_Effects::tick();
 #endif
 
-	if (blink_overflow_counter++ <= 0xA4)
+	// The rest every 17 ms
+	if (blink_overflow_counter++ <= 15)
 	     return;
 
 	blink_overflow_counter = 0;
 
+	// The clock is up to date, and none of what's left has to be on time:
+	// let the stepper and serial interrupts in while it runs, as the LED
+	// of a Viki goes out over I2C.  The counter was cleared first, so this
+	// interrupt coming again in the meantime only keeps the clock.
+	sei();
+
 #ifndef BROKEN_SD
 	/// Check SD Card Detect
 	if ( SD_DETECT_PIN.getValue() != 0x00 ) sdcard::mustReinit = true;
@@ -1011,16 +1138,54 @@ ISR(TIMER5_COMPA_vect) {
 	}
 }
 
+#if (defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)) && !defined(EX_FAN_ON_OC5C)
+/// The end of the fan's pulse
+ISR(TIMER5_COMPB_vect) {
+     EX_FAN.setValue(false);
+}
+#endif
+
 void Motherboard::setUsingPlatform(bool is_using) {
   using_platform = is_using;
 }
 
+#if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
+// Run the fan at a duty of 0 < fan_pwm < 100 percent, a pulse on each timer 5
+// cycle: from OC5C where the fan is on it, else switched by the interrupts
+static void fanPWMStart(uint16_t fan_pwm) {
+     uint8_t ticks = (uint8_t)((fan_pwm * TIMER5_TICKS_PER_MS) / 100);
+#if defined(EX_FAN_ON_OC5C)
+     OCR5C = ticks;
+     TCCR5A |= (1 << COM5C1);
+#else
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  OCR5B = ticks;
+	  TIFR5 = (1 << OCF5B);
+	  TIMSK5 |= (1 << OCIE5B);
+     }
+#endif
+     fan_pwm_enable = true;
+}
+
+// Hand the fan back to EXTRA_FET.setValue()
+static void fanPWMStop() {
+     fan_pwm_enable = false;
+#if defined(EX_FAN_ON_OC5C)
+     TCCR5A &= ~(1 << COM5C1);
+#else
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  TIMSK5 &= ~(1 << OCIE5B);
+     }
+#endif
+}
+#endif
+
 #if defined(COOLING_FAN_PWM)
 void Motherboard::setExtra(uint8_t value, bool bypass_eeprom) {
      uint16_t fan_pwm; // Will be multiplying 8 bits by 100(decimal)
 
      // Disable any fan PWM handling in Timer 5
-     fan_pwm_enable = false;
+     fanPWMStop();
 
      if (value == 0) {
 	  EXTRA_FET.setValue(false);
@@ -1031,7 +1196,7 @@ void Motherboard::setExtra(uint8_t value, bool bypass_eeprom) {
      // Restore eeprom value only if bypass is disabled or value == 1(True) for backward compatibility
 	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
 			if(!bypass_eeprom || value == 1)
-				fan_pwm = (uint16_t)eeprom::getEeprom8(eeprom_offsets::COOLING_FAN_DUTY_CYCLE, COOLING_FAN_DUTY_CYCLE_DEFAULT);
+				fan_pwm = (uint16_t)eeprom::settings.cooling_fan_duty;
 			else
 				fan_pwm = (uint16_t)value;
 	}
@@ -1046,17 +1211,14 @@ void Motherboard::setExtra(uint8_t value, bool bypass_eeprom) {
      }
 
      // Fan is to be turned on AND we are doing PWM
-     // We start the bottom count at 255 - 64 and then wrap
-     fan_pwm_enable = true;
-     fan_pwm_bottom_count = (255 - (1 << FAN_PWM_BITS)) +
-	  (int)(0.5 +  ((uint16_t)(1 << FAN_PWM_BITS) * fan_pwm) / 100.0);
+     fanPWMStart(fan_pwm);
 }
 #elif defined(COOLING_FAN_PWM_ON_DISPLAY)
 void Motherboard::setExtra(bool on) {
 	uint16_t fan_pwm; // Will be multiplying 8 bits by 100(decimal)
 
 	// Disable any fan PWM handling in Timer 5
-	fan_pwm_enable = false;
+	fanPWMStop();
 
 	if (!on) {
 		EXTRA_FET.setValue(false);
@@ -1069,8 +1231,7 @@ void Motherboard::setExtra(bool on) {
 			fan_pwm = (uint16_t)fan_pwm_override_value;
 		}
 		else {
-			fan_pwm = (uint16_t)eeprom::getEeprom8(eeprom_offsets::COOLING_FAN_DUTY_CYCLE,
-				COOLING_FAN_DUTY_CYCLE_DEFAULT);
+			fan_pwm = (uint16_t)eeprom::settings.cooling_fan_duty;
 		}
 	}
 
@@ -1082,10 +1243,7 @@ void Motherboard::setExtra(bool on) {
 	}
 
 	// Fan is to be turned on AND we are doing PWM
-	// We start the bottom count at 255 - 64 and then wrap
-	fan_pwm_enable = true;
-	fan_pwm_bottom_count = (255 - (1 << FAN_PWM_BITS)) +
-		(int)(0.5 + ((uint16_t)(1 << FAN_PWM_BITS) * fan_pwm) / 100.0);
+	fanPWMStart(fan_pwm);
 }
 #else
 
@@ -1095,7 +1253,7 @@ void Motherboard::setExtra(bool on) {
 
 #endif
 
-#if defined(HBP_SOFTPWM) && defined(__AVR_ATmega2560__)
+#if defined(HBP_SOFTPWM)
 void softpwmHBP(bool on){
     if (on)
     {
@@ -1111,7 +1269,7 @@ void BuildPlatformHeatingElement::setHeatingElement(uint8_t value) {
      // PWM'd PID implementation.  We reduce the MV to one bit, essentially.
      // It works relatively well.
      ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-#if defined(HBP_SOFTPWM) && defined(__AVR_ATmega2560__)
+#if defined(HBP_SOFTPWM)
 	  softpwmHBP(value != 0);
 #else
 	  HBP_HEAT.setValue(value != 0);
@@ -1119,6 +1277,40 @@ void BuildPlatformHeatingElement::setHeatingElement(uint8_t value) {
      }
 }
 
+#ifdef HEATER_POWER_BUDGET
+
+// The heaters all run at once.  When what they ask for comes to more than
+// the budget, each gets the same fraction of what it asked for: the
+// extruders by scaling their PWM outputs down together, and the platform,
+// which is only on or off, by getting that fraction of the slots.  While
+// the platform is on the extruders share what's left, so the budget also
+// holds from moment to moment.
+
+typedef char power_budget_check[(HEATER_POWER_BUDGET >= HEATER_WATTS_PLATFORM) ? 1 : -1];
+
+void Motherboard::sharePower() {
+	Heater& tool0 = Extruder_One.getExtruderHeater();
+	Heater& tool1 = Extruder_Two.getExtruderHeater();
+
+	// Watts times 255
+	uint32_t extruders = ((uint16_t)tool0.get_output() + tool1.get_output()) * HEATER_WATTS_EXTRUDER;
+	uint32_t budget = HEATER_POWER_BUDGET * 255L;
+	bool platform = platform_heater.get_output() != 0;
+
+	if ( platform && ( platform_slot || extruders + HEATER_WATTS_PLATFORM * 255L <= budget ) ) {
+		platform_heater.setPowerShare(255);
+		budget -= HEATER_WATTS_PLATFORM * 255L;
+	}
+	else
+		platform_heater.setPowerShare(0);
+
+	uint8_t share = ( extruders > budget ) ? (uint8_t)((budget * 255) / extruders) : 255;
+	tool0.setPowerShare(share);
+	tool1.setPowerShare(share);
+}
+
+#endif
+
 void Motherboard::heatersOff(bool platform)
 {
 	motherboard.getExtruderBoard(0).getExtruderHeater().Pause(false);
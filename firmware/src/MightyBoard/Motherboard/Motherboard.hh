@@ -56,8 +56,6 @@
 #if defined(COOLING_FAN_PWM)
 extern bool fan_pwm_enable;
 #elif defined(COOLING_FAN_PWM_ON_DISPLAY)
-#define FAN_PWM_BITS 6
-extern uint8_t fan_pwm_bottom_count;
 extern bool fan_pwm_enable;
 extern bool fan_pwm_override;
 extern uint8_t fan_pwm_override_value;
@@ -70,6 +68,26 @@ extern uint8_t fan_pwm_override_value;
 #include "StepperAxis.hh"
 #include "StepperAccelPlanner.hh"
 
+#ifdef HEATER_POWER_BUDGET
+/// Watts an extruder heater and the platform heater draw at full output
+#ifndef HEATER_WATTS_EXTRUDER
+#define HEATER_WATTS_EXTRUDER 40
+#endif
+#ifndef HEATER_WATTS_PLATFORM
+#define HEATER_WATTS_PLATFORM 120
+#endif
+/// The platform heater is either on or off, so when the budget is short it
+/// gets its share as a fraction of slots this long
+#ifndef POWER_SHARE_MICROS
+#define POWER_SHARE_MICROS (250L * 1000L)
+#endif
+#endif
+
+/// How long the splash screen stays up after power on
+#ifndef SPLASH_SCREEN_MICROS
+#define SPLASH_SCREEN_MICROS (3000L * 1000L)
+#endif
+
 /// Build platform heating element on v34 Extruder controller
 /// \ingroup ECv34
 class BuildPlatformHeatingElement : public HeatingElement {
@@ -129,9 +147,19 @@ private:
 	ThermocoupleReader therm_sensor;
 #endif
 	Timeout extruder_manage_timeout;
+#if !defined(USE_THERMOCOUPLE_DUAL)
+	micros_t extruder_sample_micros;	///< From HEATER_PERIODS, or SAMPLE_INTERVAL_MICROS_THERMOCOUPLE
+#endif
 
 #if defined(SAMPLE_INTERVAL_MICROS_THERMISTOR)
 	Timeout platform_timeout;
+	micros_t platform_sample_micros;	///< From HEATER_PERIODS, or SAMPLE_INTERVAL_MICROS_THERMISTOR
+#endif
+
+#ifdef HEATER_POWER_BUDGET
+	Timeout power_share_timeout;
+	uint16_t platform_credit;	///< Accumulates the platform's share of slots
+	bool platform_slot;		///< The platform heater has this slot
 #endif
 
 
@@ -193,6 +221,12 @@ public:
 
 	void runMotherboardSlice();
 
+#ifdef HEATER_POWER_BUDGET
+	/// Share HEATER_POWER_BUDGET out between the heaters, by what they
+	/// ask for now.  The heaters call this when their outputs change.
+	void sharePower();
+#endif
+
 	/// Count the number of steppers available on this board.
         int getStepperCount() const { return STEPPER_COUNT; }
 
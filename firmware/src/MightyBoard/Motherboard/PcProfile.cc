@@ -0,0 +1,128 @@
+/*
+ *  Sampling profiler: counts the return addresses a timer interrupt finds
+ *  on the stack in buckets of flash, read back over the host interface.
+ */
+
+#include "Compat.hh"
+#include "PcProfile.hh"
+
+#ifdef PC_PROFILE
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <string.h>
+
+#if PC_PROFILE_BUCKETS > 255
+#error PC_PROFILE_BUCKETS must be no more than 255
+#endif
+
+// Read and written by the assembly, so they have their C names
+extern "C" {
+volatile uint8_t pcprof_sample[3];
+void __vector_pcprof_tally(void) __attribute__ ((signal, used));
+}
+
+namespace pcprof {
+
+static uint16_t buckets[PC_PROFILE_BUCKETS];
+static uint16_t outside;
+static uint32_t window_base;
+static uint8_t window_shift = PC_PROFILE_DEFAULT_SHIFT;
+
+static void tally() {
+	// The return address is in words, high byte first
+	uint32_t addr = (((uint32_t)pcprof_sample[0] << 16) |
+			 ((uint16_t)pcprof_sample[1] << 8) | pcprof_sample[2]) << 1;
+	uint16_t *count = &outside;
+	if ( addr >= window_base ) {
+		uint32_t bucket = (addr - window_base) >> window_shift;
+		if ( bucket < PC_PROFILE_BUCKETS ) count = &buckets[bucket];
+	}
+	if ( *count == 0xffff ) {
+		for ( uint8_t i = 0; i < PC_PROFILE_BUCKETS; i ++ )
+			buckets[i] >>= 1;
+		outside >>= 1;
+	}
+	(*count) ++;
+}
+
+void start(uint32_t base, uint8_t shift) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memset(buckets, 0, sizeof(buckets));
+		outside = 0;
+		window_base = base;
+		window_shift = shift;
+		// The match is at TOP, so it comes once a millisecond; the
+		// fan's OCR5B interrupt shares TIMSK5
+		TIFR5 = (1 << OCF5A);
+		TIMSK5 |= (1 << OCIE5A);
+	}
+}
+
+void stop() {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		TIMSK5 &= ~(1 << OCIE5A);
+	}
+}
+
+bool running() {
+	return ( TIMSK5 & (1 << OCIE5A) ) != 0;
+}
+
+uint32_t getBase() {
+	return window_base;
+}
+
+uint8_t getShift() {
+	return window_shift;
+}
+
+uint16_t getOutside() {
+	uint16_t n;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		n = outside;
+	}
+	return n;
+}
+
+uint16_t getBucket(uint8_t bucket) {
+	if ( bucket >= PC_PROFILE_BUCKETS ) return 0;
+	uint16_t n;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		n = buckets[bucket];
+	}
+	return n;
+}
+
+}
+
+// With three registers pushed, the three bytes above them are the address
+// the interrupt came from.  None of these instructions touch SREG, so after
+// putting the registers back the stack is as the interrupt left it, and the
+// tally, an ordinary handler, returns from the interrupt itself.
+ISR(TIMER5_COMPA_vect, ISR_NAKED) {
+	asm volatile (
+		"push r0"			"\n\t"
+		"push r30"			"\n\t"
+		"push r31"			"\n\t"
+		"in r30, __SP_L__"		"\n\t"
+		"in r31, __SP_H__"		"\n\t"
+		"ldd r0, Z+4"			"\n\t"
+		"sts pcprof_sample, r0"		"\n\t"
+		"ldd r0, Z+5"			"\n\t"
+		"sts pcprof_sample+1, r0"	"\n\t"
+		"ldd r0, Z+6"			"\n\t"
+		"sts pcprof_sample+2, r0"	"\n\t"
+		"pop r31"			"\n\t"
+		"pop r30"			"\n\t"
+		"pop r0"			"\n\t"
+		"jmp __vector_pcprof_tally"	"\n\t"
+	);
+}
+
+void __vector_pcprof_tally(void) {
+	pcprof::tally();
+}
+
+#endif
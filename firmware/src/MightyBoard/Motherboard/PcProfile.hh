@@ -0,0 +1,48 @@
+#ifndef __PC_PROFILE_HH__
+#define __PC_PROFILE_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A sampling profiler for where all of the code's time goes, the main loop
+// as well as the interrupts which let others in.  Once a millisecond, the
+// timer 5 compare A interrupt takes the address it interrupted from the
+// stack and counts it in one of PC_PROFILE_BUCKETS buckets, each 2^shift
+// bytes of flash from the base of the window.  Addresses outside the window
+// are counted apart.  Code running with interrupts off is seen as where it
+// turns them back on.  Started, stopped and read with HOST_CMD_PC_PROFILE;
+// pcprof.py maps the buckets to the functions in the ELF.
+
+#ifdef PC_PROFILE
+
+#ifndef PC_PROFILE_BUCKETS
+#define PC_PROFILE_BUCKETS	128
+#endif
+
+// 2KB buckets over the 2560's 256KB of flash
+#define PC_PROFILE_DEFAULT_SHIFT	11
+
+namespace pcprof {
+
+/// Clear the counts and sample into buckets of 2^shift bytes from base
+void start(uint32_t base, uint8_t shift);
+
+/// Stop sampling; the counts are kept to be read
+void stop();
+
+bool running();
+uint32_t getBase();
+uint8_t getShift();
+
+/// Samples outside the window
+uint16_t getOutside();
+
+/// Samples in bucket, 0 for one out of range.  The counts are halved
+/// together when one would overflow.
+uint16_t getBucket(uint8_t bucket);
+
+}
+
+#endif
+
+#endif
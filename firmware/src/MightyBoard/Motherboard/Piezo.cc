@@ -23,6 +23,7 @@
 #include "Configuration.hh"
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <util/atomic.h>
 #include <util/delay.h>
 #include "EepromMap.hh"
 #include "Eeprom.hh"
@@ -32,40 +33,38 @@
 
 namespace Piezo {
 
-// Tones are placed on a tone queue when setTone is called.  The sound queue is internally limited to
-// TONE_QUEUE_SIZE.
+// Tones are placed on a tone queue when setTone is called, with the timer
+// settings which play them worked out there and then.  The sound queue is
+// internally limited to TONE_QUEUE_SIZE.
 //
-// At some point later, runPiezoSlice, processes the tone
-//
-// Sounds are started and removed from the queue by runPiezoSlice (and also started by setTone if the queue is empty).
+// The millisecond interrupt of timer 5 counts down the tone playing and
+// loads the next one's settings into the buzzer timer when it ends, so a
+// tune runs with no work in the main loop.
 //
 // There is no interrupt for this buzzer, the Timer is hooked up via OCR0B directly to the buzzer pin, and toggles when
 // the timer loops.  This is frequency generation without the overhead of the CPU having to toggle the pin manually and
 // run an interrupt at the frequency of the tone.  Reduces CPU load and results in better tone generation.
+// (BUZZER_SOFT_PWM boards, whose buzzer isn't on an output compare pin,
+// still toggle it from the timer's interrupt.)
 //
 
-
-// Index for tone_data
-#define FREQUENCY 0
-#define DURATION  1
-
-// Union used for mapping a combined 2 x uint16_t value into a uint32_t value for storage in the circular buffer
+// A tone as the buzzer timer plays it
 struct tone {
-	union {
-		uint32_t tone_entry;	//Place holder for referencing
-		uint16_t tone_data[2];	//index 0 is frequency, index 1 is duration
-	};
+	uint16_t top;		// OCRnA, half a period
+	uint8_t  clock;		// Clock select bits of TCCRnB, 0 for a rest
+	uint16_t duration;	// ms
 };
 
-// Setup the tone buffer
-const static uint8_t TONE_QUEUE_SIZE = 20;
+// Setup the tone buffer.  The size must be a power of two; the longest
+// tune has 15 notes.  Its 8 bit indices let setTone() push while the
+// interrupt pops.
+#define TONE_QUEUE_SIZE 16
 
-uint32_t tones_buf[TONE_QUEUE_SIZE];
-CircularBuffer32 tones(TONE_QUEUE_SIZE, tones_buf);
+CircularBufferPow2Templ<struct tone, TONE_QUEUE_SIZE, uint8_t> tones;
 
 static bool soundEnabled = false;
-static bool playing = false;
-static Timeout piezoTimeout;
+static volatile bool playing = false;
+static volatile uint16_t remaining_ms;
 
 // This should be called if the buzzer status is ever changed
 // It empties the queue and clears the buffer
@@ -74,12 +73,11 @@ void reset(void) {
 	// Reads the sound setting in from eeprom
 	soundEnabled = (bool)(eeprom::getEeprom8(eeprom_offsets::BUZZ_SETTINGS + buzz_eeprom_offsets::SOUND_ON,1) != 0);
 
-	//Empty the queue
-	tones.reset();
-
-	// Clear the timer, and we're not playing anymore
-	piezoTimeout.clear();
-	playing = false;
+	//Empty the queue, and we're not playing anymore
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		tones.reset();
+		playing = false;
+	}
 
 	// We need to set the buzzer pin to output, so that the timer can drive it
 	BUZZER_PIN.setDirection(true);
@@ -122,154 +120,149 @@ void shutdown_timer(void) {
 #endif
 }
 
-// Internal routine, sets up timer to start playing
-// or stops the timer if the buffer is empty
+// Work out the prescaler and compare value which play a frequency
 
-void processNextTone(void) {
-     if ( tones.isEmpty() ) {
-	  reset();
-     } 
+static void toneSettings(uint16_t frequency, struct tone *tone) {
+     if ( frequency == NOTE_0 ) {
+	  //Note 0 acts as a rest (i.e. doesn't play a note)
+	  tone->clock = 0;
+	  return;
+     }
+
+     uint32_t freq = (uint32_t)frequency;
+
+     // OCR0A for a given frequency can be calculated with:
+     // OCR0A = (F_CPU / (f * 2 * prescaler_factor)) - 1
+
+     // Pick the appropriate prescaler for the given frequency
+     uint8_t prescalerFactorBits;
+
+#if BUZZER_TIMER == 4
+     if ( freq >= 500) {
+	  //Prescaler = 8 (1 << 3)
+	  prescalerFactorBits	= 3;
+	  tone->clock           = _BV(CS41);
+     }
      else {
-	  playing = true;
+	  //Prescaler = 64 (1 << 6)
+	  prescalerFactorBits	= 6;
+	  tone->clock           = _BV(CS41) | _BV(CS40);
+     }
+#elif BUZZER_TIMER == 0
+     if ( freq >= 3906 ) {
+	  //Prescaler = 8	(1 << 3)
+	  prescalerFactorBits	= 3;
+	  tone->clock           = _BV(CS01);
+     }
+     else if ( freq >= 488  ) {
+	  //Prescaler = 64 (1 << 6)
+	  prescalerFactorBits	= 6;
+	  tone->clock           = _BV(CS01) | _BV(CS00);
+     } else if ( freq >= 122  ) {
+	  //Prescaler = 256 (1 << 8)
+	  prescalerFactorBits	= 8;
+	  tone->clock           = _BV(CS02);
+     } else 			   {
+	  //Prescaler = 1024 (1 << 10)
+	  prescalerFactorBits	= 10;
+	  tone->clock           = _BV(CS02) | _BV(CS00);
+     }
+#else
+#error missing piezo code
+#endif
 
-	  //Get the next tone from the buffer
-	  struct tone tone;
+     tone->top = (uint16_t)(((uint32_t)F_CPU / ((freq << (uint32_t)1) << (uint32_t)prescalerFactorBits)) - 1);
+}
 
-	  tone.tone_entry = tones.pop();
+// Internal routine, sets up timer to play the next tone
+// or stops the timer if the buffer is empty.  Runs with interrupts off
 
-	  //Schedule the end of tone.  Duration is in ms, timer is in uS, so
-	  //we multiply by 1000
-	  piezoTimeout.start((micros_t)tone.tone_data[DURATION] * (micros_t)1000);
+static void processNextTone(void) {
+     if ( tones.isEmpty() ) {
+	  playing = false;
+	  shutdown_timer();
+	  BUZZER_PIN.setValue(false);
+	  return;
+     }
 
-	  if ( tone.tone_data[FREQUENCY] == NOTE_0 ) {
-	       //Note 0 acts as a rest (i.e. doesn't play a note), so we shut the timer down
-	       shutdown_timer();
-	  } 
-	  else {
-	       uint32_t freq = (uint32_t)tone.tone_data[FREQUENCY];
+     playing = true;
 
-	       // OCR0A for a given frequency can be calculated with:
-	       // OCR0A = (F_CPU / (f * 2 * prescaler_factor)) - 1
+     //Get the next tone from the buffer
+     struct tone tone = tones.pop();
+     remaining_ms = tone.duration;
 
-	       // Pick the appropriate prescaler for the given frequency
-	       uint8_t prescalerFactorBits;
-	       uint8_t prescalerBits;
+     if ( tone.clock == 0 ) {
+	  //A rest, so we shut the timer down
+	  shutdown_timer();
+	  return;
+     }
 
 #if BUZZER_TIMER == 4
-	       //Setup the counter to count from 0 to OCR4A and toggle OC4A on counter reset
-	       if ( freq >= 500) {
-		    //Prescaler = 8 (1 << 3)
-		    prescalerFactorBits	= 3;
-		    prescalerBits       = _BV(CS41);
-	       }
-	       else {
-		    //Prescaler = 64 (1 << 6)
-		    prescalerFactorBits	= 6;
-		    prescalerBits       = _BV(CS41) | _BV(CS40);
-	       }
-
-	       //Calculate the value for OCR4A, but save it in a variable
-	       //to avoid contaminating the timer with a lengthy calculation
-	       uint16_t outputCompareTop =
-		    (uint16_t)(((uint32_t)F_CPU / ((freq << (uint32_t)1) << (uint32_t)prescalerFactorBits)) - 1);
+     //Setup the counter to count from 0 to OCR4A and toggle OC4A on counter reset
 #if defined(BUZZER_SOFT_PWM)
-	       TCCR4A = 0;				// Disconnect OC4A pin from Timer
+     TCCR4A = 0;				// Disconnect OC4A pin from Timer
 #else
-	       TCCR4A = _BV(COM4A0);			// Toggle OC4A pin on match; 1/2 freq of ORC4A
+     TCCR4A = _BV(COM4A0);			// Toggle OC4A pin on match; 1/2 freq of ORC4A
 #endif
-	       TCCR4B = prescalerBits |_BV(WGM42);	// Prescaler; CTC (top == OCR4A)
-	       OCR4A  = (uint16_t)outputCompareTop;	// Frequency when compiled with prescaler
-	       OCR4B  = 0x00;				// Not used
-	       TCNT4  = 0x00;				// Clear the counter
+     TCCR4B = tone.clock |_BV(WGM42);		// Prescaler; CTC (top == OCR4A)
+     OCR4A  = tone.top;				// Frequency when compiled with prescaler
+     OCR4B  = 0x00;				// Not used
+     TCNT4  = 0x00;				// Clear the counter
 #if defined(BUZZER_SOFT_PWM)
-	       TIMSK4 = _BV(OCIE4A);			// Enable interrupt
+     TIMSK4 = _BV(OCIE4A);			// Enable interrupt
 #else
-	       TIMSK4 = 0x00;				// No interrupts
+     TIMSK4 = 0x00;				// No interrupts
 #endif
 #elif BUZZER_TIMER == 0
-	       if ( freq >= 3906 ) {
-		    //Prescaler = 8	(1 << 3)
-		    prescalerFactorBits	= 3;
-		    prescalerBits = _BV(CS01);
-	       }
-	       else if ( freq >= 488  ) {
-		    //Prescaler = 64 (1 << 6)
-		    prescalerFactorBits	= 6;
-		    prescalerBits       = _BV(CS01) | _BV(CS00);
-	       } else if ( freq >= 122  ) {
-		    //Prescaler = 256 (1 << 8)
-		    prescalerFactorBits	= 8;
-		    prescalerBits       = _BV(CS02);
-	       } else 			   {
-		    //Prescaler = 1024 (1 << 10)
-		    prescalerFactorBits	= 10;
-		    prescalerBits       = _BV(CS02) | _BV(CS00);
-	       }
-
-	       //Calculate the value for OCR0A, but save it in a variable
-	       //to avoid contaminating the timer with a lengthy calculation
-	       uint8_t outputCompareTop =
-		    (uint8_t)(((uint32_t)F_CPU / ((freq << (uint32_t)1) << (uint32_t)prescalerFactorBits)) - 1);
-
-	       //Setup the counter to count from 0 to OCR0A and toggle OC0B on counter reset
-	       TCCR0A =
+     //Setup the counter to count from 0 to OCR0A and toggle OC0B on counter reset
+     TCCR0A =
 #if !defined(BUZZER_SOFT_PWM)
-		    _BV(COM0B0) |			// Toggle OC0B on match; 1/2 freq of ORC0A
+	  _BV(COM0B0) |				// Toggle OC0B on match; 1/2 freq of ORC0A
 #endif
-							// because we're toggling)
-		    _BV(WGM01);			       	// CTC (top == OCR0A)
+						// because we're toggling)
+	  _BV(WGM01);			       	// CTC (top == OCR0A)
 
-	       TCCR0B = prescalerBits;			// Prescaler
-	       OCR0A  = (uint8_t)outputCompareTop;	// Frequency when compiled with prescaler
+     TCCR0B = tone.clock;			// Prescaler
+     OCR0A  = (uint8_t)tone.top;		// Frequency when compiled with prescaler
 
-	       OCR0B  = 0x00;				// Not used
-	       TCNT0  = 0x00;				// Clear the counter
+     OCR0B  = 0x00;				// Not used
+     TCNT0  = 0x00;				// Clear the counter
 #if defined(BUZZER_SOFT_PWM)
-	       TIMSK0 = _BV(OCIE0A);			// Enable interrupt
+     TIMSK0 = _BV(OCIE0A);			// Enable interrupt
 #else
-	       TIMSK0 = 0x00;				// No interrupts
+     TIMSK0 = 0x00;				// No interrupts
 #endif
-#else
-#error missing piezo code
 #endif
-	  }
-     }
-}
-
-#if defined(BUZZER_)
-ISR() {
 }
-#endif
 
 void setTone(uint16_t frequency, uint16_t duration)
 {
      //If sound is switched off, we do nothin
-     if ( ! soundEnabled )
+     if ( ! soundEnabled || duration == 0 )
 	  return;
 
-     //Add the tone to the buffer
-     if ( tones.getRemainingCapacity() ) {
-	  struct tone tone;
+     struct tone tone;
+     toneSettings(frequency, &tone);
+     tone.duration = duration;
 
-	  tone.tone_data[FREQUENCY] = frequency;
-	  tone.tone_data[DURATION]  = duration;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  //Add the tone to the buffer
+	  if ( tones.getRemainingCapacity() )
+	       tones.push(tone);
 
-	  tones.push(tone.tone_entry);
+	  //If we're not playing tones, then we start the tone we just put in the queue
+	  if ( ! playing )
+	       processNextTone();
      }
-
-     //If we're not playing tones, then we schedule the tone we just put in the queue
-     if ( ! playing )
-	  processNextTone();
 }
 
 bool isPlaying() {
      return playing;
 }
 
-void runPiezoSlice(void) {
-     // If we're playing a sound and the last sound has finished, queue
-     // the next one if we have one
-     if ( (soundEnabled ) && ( playing ) && ( piezoTimeout.hasElapsed() ))
+void tick(void) {
+     // When the tone playing has finished, start the next one if we have one
+     if ( playing && --remaining_ms == 0 )
 	  processNextTone();
 }
 
@@ -112,7 +112,6 @@
 #define NOTE_DS8 4978
 
 #include "Pin.hh"
-#include "Timeout.hh"
 #include "Types.hh"
 #include "CircularBuffer.hh"
 
@@ -143,8 +142,9 @@ namespace Piezo {
      // Shuts the timer off
      void shutdown_timer(void);
 
-     // Call every so often to handle the queue and start/end tones
-     void runPiezoSlice(void);
+     // Called every millisecond by the timer 5 interrupt to end tones
+     // and start the next in the queue
+     void tick(void);
 
      /// is the buzzer playing a song?
      bool isPlaying();
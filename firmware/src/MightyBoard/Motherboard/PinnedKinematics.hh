@@ -0,0 +1,55 @@
+#ifndef __PINNED_KINEMATICS_HH__
+#define __PINNED_KINEMATICS_HH__
+
+// Kinematics built into the firmware, for a fleet of one kind of machine.  A
+// platform with 'kinematics' in platforms.py defines PINNED_KINEMATICS,
+// PLATFORM_AXIS_INVERT and, for each axis n from 0 (X) to 4 (B),
+//
+//   PINNED_STEPS_PER_MM_n       -- steps per mm
+//   PINNED_MAX_FEEDRATE_n       -- max feedrate, in mm/minute
+//   PINNED_MAX_ACCELERATION_n   -- max acceleration, in mm/s^2
+//
+// These take the place of the EEPROM's AXIS_STEPS_PER_MM, AXIS_MAX_FEEDRATES,
+// the axis bits of AXIS_INVERSION and MAX_ACCELERATION_AXIS, which are then
+// never read; writing them changes nothing.  The tables the planner and
+// setTargetNewExt() work from are constants, and each axis' direction
+// inversion is folded into the stepper interrupt's code for it.
+
+#ifdef PINNED_KINEMATICS
+
+#if !defined(PLATFORM_AXIS_INVERT) || !defined(PINNED_STEPS_PER_MM_0) || \
+    !defined(PINNED_MAX_FEEDRATE_0) || !defined(PINNED_MAX_ACCELERATION_0)
+#error "PINNED_KINEMATICS needs the values made from a platform's 'kinematics'"
+#endif
+
+// The tables written by the reset and apply...() functions otherwise
+#define PINNED_CONST const
+
+// An initializer of F(n) for each stepper
+#if STEPPER_COUNT > 4
+#define PINNED_AXES(F) { F(0), F(1), F(2), F(3), F(4) }
+#else
+#define PINNED_AXES(F) { F(0), F(1), F(2), F(3) }
+#endif
+
+#define PINNED_STEPS_PER_MM(n)		((float)PINNED_STEPS_PER_MM_##n)
+#define PINNED_MAX_FEEDRATE(n)		((uint32_t)PINNED_MAX_FEEDRATE_##n)
+#define PINNED_STEPS_PER_UNIT_INVERSE(n) FTOFP(1.0 / PINNED_STEPS_PER_MM(n))
+
+// The max acceleration held to 0xFFFFF steps/s^2, and the steps/s^2 and
+// cutoff made from it, as loadAccelerationSettings() makes them
+#define PINNED_ACCELERATION_CAP(n)	((uint32_t)((float)0xFFFFF / PINNED_STEPS_PER_MM(n)))
+#define PINNED_MAX_ACCELERATION(n)	(((uint32_t)PINNED_MAX_ACCELERATION_##n > PINNED_ACCELERATION_CAP(n)) ? \
+					 PINNED_ACCELERATION_CAP(n) : (uint32_t)PINNED_MAX_ACCELERATION_##n)
+#define PINNED_STEPS_PER_SQR_SECOND(n)	((uint32_t)((float)PINNED_MAX_ACCELERATION(n) * PINNED_STEPS_PER_MM(n)))
+#define PINNED_ACCEL_STEP_CUTOFF(n)	((uint32_t)0xffffffff / PINNED_STEPS_PER_SQR_SECOND(n))
+
+#define PINNED_AXIS_INVERTED(axis)	(((PLATFORM_AXIS_INVERT) >> (axis)) & 1)
+
+#else
+
+#define PINNED_CONST
+
+#endif
+
+#endif
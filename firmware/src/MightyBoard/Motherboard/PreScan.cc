@@ -0,0 +1,565 @@
+/*
+ *  Pre-scan of the file of an SD card build.  The commands are read with
+ *  the command table's lengths, and the moves among them followed from
+ *  position to position without being planned, totting up the filament,
+ *  layers and time.
+ *
+ *  The time of a move is the one it gives, or its length over its feed
+ *  rate, with no time taken to speed up and slow down; the planner's own
+ *  estimate of the moves run so far makes up the difference as the build
+ *  goes (see estimatedTimeLeftInSeconds()).
+ *
+ *  With SD_FILE_CRC the scan also takes a CRC of the whole file.  A file
+ *  captured from the host gets a sidecar with the CRC of what was written,
+ *  which the first scan of it checks the card against; a file which reads
+ *  back differently, or not at all, has its build cancelled.  One which has
+ *  been read whole once is marked as checked, and isn't read again.
+ */
+
+#include "Compat.hh"
+#include "PreScan.hh"
+
+#ifdef SD_PRESCAN
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <util/crc16.h>
+
+#include "SDCard.hh"
+#include "Host.hh"
+#include "Command.hh"
+#include "Commands.hh"
+#include "Eeprom.hh"
+#include "EepromMap.hh"
+#include "StepperAxis.hh"
+#include "Timeout.hh"
+#ifdef SD_FILE_CRC
+#include "Menu_locales.hh"
+#endif
+
+// Bytes read a slice while the build waits for its heaters, and every
+// PRESCAN_TRICKLE_MICROS otherwise
+#define PRESCAN_SLICE_BYTES	512
+#define PRESCAN_TRICKLE_BYTES	128
+#define PRESCAN_TRICKLE_MICROS	50000L
+
+// Bumped when Results changes, to have old sidecar files read again
+#define SIDECAR_VERSION		2
+#define SIDECAR_CRC_SEED	0x3B
+
+// Sidecar flags
+#define SIDECAR_RESULTS		0x01	///< results is complete
+#define SIDECAR_FILE_CRC	0x02	///< file_crc is that of the whole file
+#define SIDECAR_CHECKED		0x04	///< The file has been read back whole
+
+typedef struct {
+	uint8_t version;
+	uint8_t flags;
+	uint16_t file_crc;
+	prescan::Results results;
+	uint8_t crc;
+} Sidecar;
+
+namespace prescan {
+
+enum {
+	SCAN_IDLE,
+	SCAN_RUNNING,	///< Reading the file
+	SCAN_DONE,	///< results in; the sidecar may wait to be written
+	SCAN_KEPT	///< results in and on the card
+};
+
+static uint8_t state = SCAN_IDLE;
+static Results res;
+static char sidecar_name[MAX_FILE_LEN];
+static Timeout trickle;
+
+// Where the read has got to
+static uint32_t offset;
+static uint8_t profile_next;
+static uint32_t total_ms;
+static uint16_t carry_us;
+static int32_t pos[5];
+static uint8_t known;		// axes whose position is known
+
+static uint8_t flags;		// SIDECAR_ flags of what's been found
+
+#ifdef SD_FILE_CRC
+// Past a command which can't be decoded, the rest is read for its CRC alone
+static bool decoding;
+static bool read_failed;
+static uint32_t read_bytes;
+static uint16_t file_crc;
+// The CRC the file should have, from its sidecar, if it had one
+static bool ref_known;
+static uint16_t ref_crc;
+#ifdef S3G_CAPTURE_2_SD
+static char capture_sidecar[MAX_FILE_LEN];
+#endif
+#endif
+
+// Reads on through the file, taking the CRC of what's read
+static int16_t fileRead(uint8_t *dst, uint8_t count) {
+	int16_t n = sdcard::scanRead(dst, count);
+#ifdef SD_FILE_CRC
+	if ( n < 0 )
+		read_failed = true;
+	for (int16_t i = 0; i < n; i++)
+		file_crc = _crc16_update(file_crc, dst[i]);
+	if ( n > 0 )
+		read_bytes += n;
+#endif
+	return n;
+}
+
+static uint8_t sidecarCrc(const Sidecar *s) {
+	const uint8_t *p = (const uint8_t *)s;
+	uint8_t c = SIDECAR_CRC_SEED;
+	for (uint8_t i = 0; i < offsetof(Sidecar, crc); i++)
+		c = _crc_ibutton_update(c, p[i]);
+	return c;
+}
+
+// NAME.INF for NAME.X3G; left empty when there's no room for it
+static void makeSidecarName(char *dst, const char *name) {
+	const char *dot = strrchr(name, '.');
+	size_t len = dot ? (size_t)(dot - name) : strlen(name);
+
+	dst[0] = 0;
+	if ( len + 5 > MAX_FILE_LEN )
+		return;
+	memcpy(dst, name, len);
+	strcpy_P(dst + len, PSTR(".inf"));
+}
+
+static void addMicros(float us) {
+	if ( !( us > 0.0 ) )
+		return;
+	uint32_t whole = (uint32_t)us + carry_us;
+	total_ms += whole / 1000;
+	carry_us = whole % 1000;
+}
+
+// Follows a move to to, with the axes in relative taken as a change, and
+// returns the most steps any axis with a known position takes
+static int32_t moveTo(const int32_t *to, uint8_t relative) {
+	int32_t next[5];
+	int32_t most = 0;
+	bool extruding = false;
+
+	for (uint8_t i = 0; i < 5; i++) {
+		bool rel = ( relative & (1 << i) ) != 0;
+		next[i] = rel ? pos[i] + to[i] : to[i];
+		if ( !rel && !( known & (1 << i) ) )
+			continue;
+		int32_t d = next[i] - pos[i];
+		if ( labs(d) > most )
+			most = labs(d);
+		if ( i >= A_AXIS && d > 0 ) {
+			res.filament[i - A_AXIS] += d;
+			extruding = true;
+		}
+	}
+
+	// A layer starts with the first move extruded at a greater height
+	const uint8_t xyz = _BV(X_AXIS) | _BV(Y_AXIS) | _BV(Z_AXIS);
+	if ( extruding && ( known & xyz ) == xyz &&
+	     ( next[X_AXIS] != pos[X_AXIS] || next[Y_AXIS] != pos[Y_AXIS] ) &&
+	     ( res.layers == 0 || next[Z_AXIS] > res.z_max ) ) {
+		res.layers++;
+		res.z_max = next[Z_AXIS];
+	}
+
+	memcpy(pos, next, sizeof(pos));
+	known |= ~relative & 0x1F;
+	return most;
+}
+
+// Time for distance mm at feedrate_mult_64 mm/s times 64
+static float feedMicros(float distance, int16_t feedrate_mult_64) {
+	if ( feedrate_mult_64 <= 0 )
+		return 0.0;
+	return distance * 64000000.0 / feedrate_mult_64;
+}
+
+static float arcLength(const struct queue_arc_t *arc) {
+	float sx = stepperAxisStepsPerMM(X_AXIS), sy = stepperAxisStepsPerMM(Y_AXIS);
+	float rx = -(float)arc->i / sx, ry = -(float)arc->j / sy;
+	float ex = (float)(arc->x - pos[X_AXIS] - arc->i) / sx;
+	float ey = (float)(arc->y - pos[Y_AXIS] - arc->j) / sy;
+
+	float angle = atan2(rx * ey - ry * ex, rx * ex + ry * ey);
+	if ( arc->flags & QUEUE_ARC_CCW ) {
+		if ( angle <= 0.0 ) angle += 2.0 * M_PI;
+	} else if ( angle >= 0.0 )
+		angle -= 2.0 * M_PI;
+	return fabs(angle) * sqrt(rx * rx + ry * ry);
+}
+
+static void decode(const uint8_t *bytes) {
+	int32_t to[5];
+
+	switch ( bytes[0] ) {
+	case HOST_CMD_QUEUE_POINT_EXT: {
+		const struct queue_point_ext_t *move = (const struct queue_point_ext_t *)bytes;
+		memcpy(to, &move->x, sizeof(to));
+		addMicros((float)move->dda * (float)moveTo(to, 0));
+		break;
+	}
+	case HOST_CMD_QUEUE_POINT_NEW: {
+		const struct queue_point_new_t *move = (const struct queue_point_new_t *)bytes;
+		memcpy(to, &move->x, sizeof(to));
+		moveTo(to, move->relative);
+		addMicros((float)move->us);
+		break;
+	}
+	case HOST_CMD_QUEUE_POINT_NEW_EXT: {
+		const struct queue_point_new_ext_t *move = (const struct queue_point_new_ext_t *)bytes;
+		memcpy(to, &move->x, sizeof(to));
+		moveTo(to, move->relative & 0x7F);
+		addMicros(feedMicros(move->distance, move->feedrate_mult_64));
+		break;
+	}
+	case HOST_CMD_QUEUE_POINT_DELTA: {
+		const uint8_t *p = bytes + 2;
+		for (uint8_t i = 0; i < QUEUE_POINT_DELTA_AXES; i++) {
+			int16_t d = 0;
+			if ( bytes[1] & (1 << i) ) {
+				memcpy(&d, p, sizeof(d));
+				p += sizeof(d);
+			}
+			to[i] = d;
+		}
+		struct queue_point_delta_tail_t tail;
+		memcpy(&tail, p, sizeof(tail));
+		moveTo(to, 0x1F);
+		addMicros(feedMicros(tail.distance, tail.feedrate_mult_64));
+		break;
+	}
+	case HOST_CMD_QUEUE_ARC: {
+		const struct queue_arc_t *arc = (const struct queue_arc_t *)bytes;
+		const uint8_t xy = _BV(X_AXIS) | _BV(Y_AXIS);
+		if ( ( known & xy ) == xy )
+			addMicros(feedMicros(arcLength(arc), arc->feedrate_mult_64));
+		memcpy(to, &arc->x, sizeof(to));
+		moveTo(to, _BV(A_AXIS) | _BV(B_AXIS));
+		break;
+	}
+	case HOST_CMD_SET_POSITION_EXT:
+		memcpy(pos, bytes + 1, sizeof(pos));
+		known = 0x1F;
+		break;
+	case HOST_CMD_FIND_AXES_MINIMUM:
+	case HOST_CMD_FIND_AXES_MAXIMUM:
+		known &= ~bytes[1];
+		break;
+	case HOST_CMD_RECALL_HOME_POSITION:
+		for (uint8_t i = X_AXIS; i <= Z_AXIS; i++) {
+			if ( !( bytes[1] & (1 << i) ) )
+				continue;
+			pos[i] = (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS +
+							    i * sizeof(uint32_t), 0);
+			known |= 1 << i;
+		}
+		break;
+	case HOST_CMD_DELAY: {
+		uint32_t ms;
+		memcpy(&ms, bytes + 1, sizeof(ms));
+		total_ms += ms;
+		break;
+	}
+	}
+}
+
+// Reads the next command, or as much of it as there is; false at the end of
+// the file, or on an error or a command this firmware doesn't know
+static bool readCommand() {
+	uint8_t bytes[MAX_PACKET_PAYLOAD];
+	uint8_t need;
+
+	if ( fileRead(bytes, 1) != 1 || ( need = command::fileLengthBytes(bytes[0]) ) == 0 )
+		return false;
+	if ( need > 1 && fileRead(bytes + 1, need - 1) != need - 1 )
+		return false;
+
+	uint16_t length = command::fileCommandLength(bytes);
+	if ( length < need )
+		return false;
+	uint16_t rest = length - need;
+	if ( length <= sizeof(bytes) ) {
+		if ( fileRead(bytes + need, rest) != (int16_t)rest )
+			return false;
+		decode(bytes);
+	}
+	else {
+		// Nothing this long is looked into
+		while ( rest ) {
+			uint8_t n = ( rest > sizeof(bytes) ) ? sizeof(bytes) : rest;
+			if ( fileRead(bytes, n) != n )
+				return false;
+			rest -= n;
+		}
+	}
+	offset += length;
+
+	if ( command::fileCommandHasString(bytes[0]) ) {
+		do {
+			if ( fileRead(bytes, 1) != 1 )
+				return false;
+			offset++;
+		} while ( bytes[0] );
+	}
+
+	uint32_t part = res.size / PRESCAN_PROFILE;
+	while ( profile_next < PRESCAN_PROFILE - 1 && offset >= part * (profile_next + 1) )
+		res.millis[profile_next++] = total_ms;
+	return true;
+}
+
+static void keep() {
+	Sidecar s;
+
+	if ( sidecar_name[0] && flags ) {
+		s.version = SIDECAR_VERSION;
+		s.flags = flags;
+#ifdef SD_FILE_CRC
+		s.file_crc = file_crc;
+#else
+		s.file_crc = 0;
+#endif
+		s.results = res;
+		s.crc = sidecarCrc(&s);
+		sdcard::writeSmallFile(sidecar_name, &s, sizeof(s));
+	}
+	state = SCAN_KEPT;
+}
+
+#ifdef SD_FILE_CRC
+// Cancels the build of a file which didn't read back as it was written
+static void reject() {
+	const prog_uchar *msg = FILE_CHECKSUM_MSG;
+	if ( read_failed ) {
+		sdcard::SdErrorCode e = sdcard::scanError();
+		msg = ( e == sdcard::SD_ERR_NO_CARD_PRESENT ) ? NOCARD_MSG :
+			( e == sdcard::SD_ERR_CRC ) ? CARDCRC_MSG : CARDERROR_MSG;
+	}
+	state = SCAN_IDLE;
+	command::cancelFileError(msg);
+}
+#endif
+
+// At the end of the file, or of what could be read of it
+static void finish() {
+	sdcard::scanClose();
+#ifdef SD_FILE_CRC
+	if ( read_failed || ( ref_known && read_bytes == res.size && file_crc != ref_crc ) ) {
+		reject();
+		return;
+	}
+	if ( read_bytes == res.size )
+		flags |= SIDECAR_FILE_CRC | SIDECAR_CHECKED;
+	if ( decoding )
+#endif
+	// Read to the end, rather than given up on part way
+	if ( offset >= res.size ) {
+		while ( profile_next < PRESCAN_PROFILE )
+			res.millis[profile_next++] = total_ms;
+		flags |= SIDECAR_RESULTS;
+	}
+	state = flags ? SCAN_DONE : SCAN_IDLE;
+}
+
+static void scanBytes(uint16_t budget) {
+	uint32_t from = offset;
+
+	while ( offset - from < budget ) {
+#ifdef SD_FILE_CRC
+		if ( !decoding ) {
+			uint8_t bytes[32];
+			int16_t n = fileRead(bytes, sizeof(bytes));
+			if ( n <= 0 )
+				break;
+			offset += n;
+			continue;
+		}
+#endif
+		if ( readCommand() )
+			continue;
+#ifdef SD_FILE_CRC
+		// A command this firmware doesn't know; a build would stop there,
+		// but the file may yet be sound
+		if ( !read_failed && read_bytes < res.size ) {
+			decoding = false;
+			offset = read_bytes;
+			continue;
+		}
+#endif
+		finish();
+		return;
+	}
+#ifdef SD_FILE_CRC
+	if ( !decoding && offset - from < budget )
+		finish();
+#endif
+}
+
+// CRC of the first block of the file open, which is read from the top
+static uint16_t headCrc() {
+	uint8_t bytes[32];
+	uint16_t crc = 0xFFFF;
+	for (uint8_t b = 0; b < 512 / sizeof(bytes); b++) {
+		int16_t n = sdcard::scanRead(bytes, sizeof(bytes));
+		for (int16_t i = 0; i < n; i++)
+			crc = _crc16_update(crc, bytes[i]);
+		if ( n < (int16_t)sizeof(bytes) )
+			break;
+	}
+	return crc;
+}
+
+// Takes what's known from the sidecar, if it's of this file; true if
+// there's no need to read the file
+static bool loadSidecar() {
+	Sidecar s;
+	uint32_t size;
+
+	if ( !sidecar_name[0] || sdcard::scanOpen(sidecar_name, &size) != sdcard::SD_SUCCESS )
+		return false;
+	bool ok = size == sizeof(s) &&
+		sdcard::scanRead((uint8_t *)&s, sizeof(s)) == (int16_t)sizeof(s) &&
+		s.version == SIDECAR_VERSION && s.crc == sidecarCrc(&s) &&
+		s.results.size == res.size && s.results.head_crc == res.head_crc;
+	sdcard::scanClose();
+	if ( !ok )
+		return false;
+
+#ifdef SD_FILE_CRC
+	// Read again until it's been read back whole once
+	ref_known = ( s.flags & SIDECAR_FILE_CRC ) != 0;
+	ref_crc = s.file_crc;
+	if ( !( s.flags & SIDECAR_CHECKED ) )
+		return false;
+	file_crc = s.file_crc;
+#else
+	if ( !( s.flags & SIDECAR_RESULTS ) )
+		return false;
+#endif
+	flags = s.flags;
+	res = s.results;
+	return true;
+}
+
+void start(char *name) {
+	stop();
+	state = SCAN_IDLE;
+	flags = 0;
+#ifdef SD_FILE_CRC
+	ref_known = false;
+#endif
+	memset(&res, 0, sizeof(res));
+	makeSidecarName(sidecar_name, name);
+
+	if ( sdcard::scanOpen(name, &res.size) != sdcard::SD_SUCCESS )
+		return;
+	res.head_crc = headCrc();
+	sdcard::scanClose();
+	if ( loadSidecar() ) {
+		state = SCAN_KEPT;
+		return;
+	}
+
+	// From the top again
+	if ( sdcard::scanOpen(name, &res.size) != sdcard::SD_SUCCESS )
+		return;
+	offset = 0;
+#ifdef SD_FILE_CRC
+	decoding = true;
+	read_failed = false;
+	read_bytes = 0;
+	file_crc = 0xFFFF;
+#endif
+	profile_next = 0;
+	total_ms = 0;
+	carry_us = 0;
+	known = 0;
+	memset(pos, 0, sizeof(pos));
+	trickle.abort();
+	state = SCAN_RUNNING;
+}
+
+void stop() {
+	if ( state == SCAN_RUNNING ) {
+		sdcard::scanClose();
+		state = SCAN_IDLE;
+	}
+	else if ( state == SCAN_DONE )
+		keep();
+}
+
+void runSlice() {
+	if ( state != SCAN_RUNNING && state != SCAN_DONE )
+		return;
+
+	// The card is the build's first; the scan has it while the build waits
+	// for its heaters, and otherwise only with plenty in the command buffer
+	bool heating = command::isHeating();
+	if ( !heating ) {
+		if ( trickle.isActive() && !trickle.hasElapsed() )
+			return;
+		trickle.start(PRESCAN_TRICKLE_MICROS);
+		if ( command::getRemainingCapacity() > COMMAND_BUFFER_SIZE / 2 )
+			return;
+	}
+
+	if ( state == SCAN_RUNNING )
+		scanBytes(heating ? PRESCAN_SLICE_BYTES : PRESCAN_TRICKLE_BYTES);
+	// Writing the sidecar takes a while, so it waits for the heaters too,
+	// or for the end of the build
+	else if ( heating )
+		keep();
+}
+
+#if defined(SD_FILE_CRC) && defined(S3G_CAPTURE_2_SD)
+void captureStarted(const char *name) {
+	makeSidecarName(capture_sidecar, name);
+	// An empty one does for none, should the capture come to nothing
+	if ( capture_sidecar[0] )
+		sdcard::writeSmallFile(capture_sidecar, 0, 0);
+}
+
+void captureFinished(uint32_t size) {
+	Sidecar s;
+
+	memset(&s, 0, sizeof(s));
+	if ( !capture_sidecar[0] || !sdcard::getCaptureCrc(&s.results.head_crc, &s.file_crc) )
+		return;
+	s.version = SIDECAR_VERSION;
+	s.flags = SIDECAR_FILE_CRC;
+	s.results.size = size;
+	s.crc = sidecarCrc(&s);
+	sdcard::writeSmallFile(capture_sidecar, &s, sizeof(s));
+	capture_sidecar[0] = 0;
+}
+#endif
+
+const Results *results() {
+	return ( flags & SIDECAR_RESULTS ) ? &res : 0;
+}
+
+uint32_t nominalMillis(uint32_t at) {
+	uint32_t part = res.size / PRESCAN_PROFILE;
+	if ( part == 0 || at >= res.size )
+		return res.millis[PRESCAN_PROFILE - 1];
+
+	uint8_t k = at / part;
+	if ( k >= PRESCAN_PROFILE )
+		k = PRESCAN_PROFILE - 1;
+	uint32_t from = k ? res.millis[k - 1] : 0;
+	return from + (uint32_t)((float)(res.millis[k] - from) * (float)(at - part * k) / (float)part);
+}
+
+}
+
+#endif
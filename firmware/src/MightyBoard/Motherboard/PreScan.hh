@@ -0,0 +1,65 @@
+#ifndef __PRE_SCAN_HH__
+#define __PRE_SCAN_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A read through the file of an SD card build, alongside its playback,
+// which works out what's in it without running it: how many layers and
+// how tall, how much filament, and how long its moves take.  The file is
+// read while the build waits for its heaters, and a little at a time
+// after that.  What's found is kept on the card in a sidecar file, NAME.INF
+// for NAME.X3G, and read from there when the file is built again.  With
+// SD_FILE_CRC, the scan also checks the file reads back whole, and as it
+// was written if it was captured from the host.
+
+#if defined(SD_FILE_CRC) && !defined(SD_PRESCAN)
+#error "SD_FILE_CRC needs SD_PRESCAN"
+#endif
+
+#ifdef SD_PRESCAN
+
+// The moves' time is kept for each eighth of the file, for telling how far
+// through the build's time its place in the file is
+#define PRESCAN_PROFILE 8
+
+namespace prescan {
+
+typedef struct {
+	uint32_t size;		///< Of the file
+	uint16_t head_crc;	///< Of its first block, to tell it from another file of the same size
+	uint16_t layers;	///< Z heights extruded at, from the bottom up
+	int32_t z_max;		///< Highest Z extruded at, in steps
+	int32_t filament[2];	///< Extruded by A and B, in steps
+	uint32_t millis[PRESCAN_PROFILE];	///< Time of the moves to the end of each part, at their own feed rates
+} Results;
+
+/// Called when an SD card build starts, with the name of its file in the
+/// working directory
+void start(char *name);
+
+/// Called when the build ends; the results found are kept
+void stop();
+
+/// Called from runHostSlice(), reads on through the file when it's time to
+void runSlice();
+
+/// What was found in the file, or 0 until the whole of it has been read
+const Results *results();
+
+/// Time the moves take from the start of the file to offset in it, at their
+/// own feed rates.  Only once results() is in.
+uint32_t nominalMillis(uint32_t offset);
+
+#if defined(SD_FILE_CRC) && defined(S3G_CAPTURE_2_SD)
+/// Called when a capture to the file name starts, and once it's finished
+/// with the bytes written, to leave the CRC of what was written beside it
+void captureStarted(const char *name);
+void captureFinished(uint32_t size);
+#endif
+
+}
+
+#endif
+
+#endif
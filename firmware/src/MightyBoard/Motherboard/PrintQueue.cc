@@ -0,0 +1,218 @@
+/*
+ *  Queue of SD card builds, played one after another with an optional cool
+ *  down and eject build between them.
+ */
+
+#include "Compat.hh"
+#include "PrintQueue.hh"
+
+#ifdef PRINT_QUEUE
+
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "Host.hh"
+#include "Command.hh"
+#include "Steppers.hh"
+#include "Motherboard.hh"
+#include "Cooldown.hh"
+
+namespace printqueue {
+
+enum QueueState {
+	QUEUE_IDLE,
+	QUEUE_BUILDING,		///< Playing an entry
+	QUEUE_COOLING,		///< Entry marked done, waiting for the platform
+	QUEUE_EJECTING		///< Playing the eject build
+};
+
+static uint8_t state = QUEUE_IDLE;
+static char queue_name[MAX_FILE_LEN];
+
+// Settings in effect at the entry being built, and where its '-' is
+static char eject_name[MAX_FILE_LEN];
+static uint8_t cool_temp;
+#ifdef PLATFORM_COOLDOWN
+static bool cool_release;
+#endif
+static uint32_t entry_offset;
+
+bool isQueueFile(const char *name) {
+	size_t len = strlen(name);
+	return len >= 4 && strcasecmp_P(name + len - 4, PSTR(".que")) == 0;
+}
+
+static const char *skipSpaces(const char *p) {
+	while ( *p == ' ' || *p == '\t' )
+		p++;
+	return p;
+}
+
+static bool isKeyword(const char *line, PGM_P word, uint8_t len) {
+	return strncmp_P(line, word, len) == 0 &&
+		( line[len] == 0 || line[len] == ' ' || line[len] == '\t' );
+}
+
+// Takes in a line, trimmed of trailing spaces.  Returns true for an entry
+// still to do, copying its name to entry.
+static bool parseLine(const char *line, char *entry) {
+	if ( isKeyword(line, PSTR("-"), 1) ) {
+		const char *name = skipSpaces(line + 1);
+		// A queue in a queue would start itself over again
+		if ( *name == 0 || isQueueFile(name) )
+			return false;
+		strcpy(entry, name);
+		return true;
+	}
+	if ( isKeyword(line, PSTR("cool"), 4) ) {
+		uint16_t t = 0;
+		const char *p = skipSpaces(line + 4);
+#ifdef PLATFORM_COOLDOWN
+		cool_release = *p == 0;
+#endif
+		for ( ; *p >= '0' && *p <= '9'; p++ )
+			if ( (t = t * 10 + (*p - '0')) > 255 ) t = 255;
+		cool_temp = (uint8_t)t;
+	}
+	else if ( isKeyword(line, PSTR("eject"), 5) )
+		strcpy(eject_name, skipSpaces(line + 5));
+	return false;
+}
+
+// Reads the queue from the top as far as the first entry still to do,
+// picking up the settings on the way
+static bool findEntry(char *entry) {
+	cool_temp = 0;
+#ifdef PLATFORM_COOLDOWN
+	cool_release = false;
+#endif
+	eject_name[0] = 0;
+	if ( sdcard::startPlayback(queue_name) != sdcard::SD_SUCCESS )
+		return false;
+
+	// Room for "- " and the longest name; longer lines are cut short
+	char line[MAX_FILE_LEN + 2];
+	uint8_t len = 0;
+	uint32_t offset = 0, line_start = 0;
+	bool found = false;
+
+	for (;;) {
+		bool more = sdcard::playbackHasNext();
+		uint8_t c = more ? sdcard::playbackNext() : '\n';
+		offset++;
+		if ( c != '\n' ) {
+			if ( c != '\r' && len < sizeof(line) - 1 )
+				line[len++] = c;
+			continue;
+		}
+		while ( len && ( line[len-1] == ' ' || line[len-1] == '\t' ) )
+			len--;
+		line[len] = 0;
+		if ( parseLine(line, entry) ) {
+			entry_offset = line_start;
+			found = true;
+			break;
+		}
+		if ( !more )
+			break;
+		len = 0;
+		line_start = offset;
+	}
+	sdcard::finishPlayback();
+	return found;
+}
+
+static sdcard::SdErrorCode startFile(char *name) {
+	sdcard::SdErrorCode e = host::startBuildFromSD(name, strlen(name));
+	// A directory is moved into rather than played
+	if ( e == sdcard::SD_SUCCESS &&
+	     host::getHostState() != host::HOST_STATE_BUILDING_FROM_SD )
+		e = sdcard::SD_ERR_FILE_NOT_FOUND;
+	return e;
+}
+
+static sdcard::SdErrorCode startNext() {
+	char entry[MAX_FILE_LEN];
+
+	state = QUEUE_IDLE;
+	if ( !findEntry(entry) )
+		return sdcard::SD_ERR_FILE_NOT_FOUND;
+	sdcard::SdErrorCode e = startFile(entry);
+	if ( e == sdcard::SD_SUCCESS )
+		state = QUEUE_BUILDING;
+	return e;
+}
+
+sdcard::SdErrorCode start(const char *name) {
+	strncpy(queue_name, name, sizeof(queue_name) - 1);
+	queue_name[sizeof(queue_name) - 1] = 0;
+	return startNext();
+}
+
+void stop() {
+	state = QUEUE_IDLE;
+}
+
+bool isRunning() {
+	return state != QUEUE_IDLE;
+}
+
+// The end of the file is reached well before the end of the build, which
+// is over once the commands after it have been run and the moves made
+static bool buildOver() {
+	return command::isEmpty() && command::isReady() &&
+		command::pauseState() == PAUSE_STATE_NONE && !steppers::isRunning();
+}
+
+void runSlice() {
+	if ( state == QUEUE_IDLE )
+		return;
+
+	host::HostState hs = host::getHostState();
+	if ( hs == host::HOST_STATE_BUILDING_FROM_SD && state != QUEUE_COOLING )
+		return;
+
+	// Cancelled, a heater fault, or some other build started in between
+	if ( hs != host::HOST_STATE_READY || host::buildWasCancelled ) {
+		state = QUEUE_IDLE;
+		return;
+	}
+
+	switch ( state ) {
+	case QUEUE_BUILDING:
+		if ( !buildOver() )
+			return;
+		// Were it left '-', the entry would be built again
+		if ( sdcard::overwriteByte(queue_name, entry_offset, '+') != sdcard::SD_SUCCESS ) {
+			state = QUEUE_IDLE;
+			return;
+		}
+		state = QUEUE_COOLING;
+		break;
+
+	case QUEUE_COOLING:
+		if ( cool_temp &&
+		     Motherboard::getBoard().getPlatformHeater().get_current_temperature() > cool_temp )
+			return;
+#ifdef PLATFORM_COOLDOWN
+		if ( cool_release && !cooldown::released() )
+			return;
+#endif
+		if ( eject_name[0] == 0 )
+			startNext();
+		// Rather than build on top of what couldn't be cleared away
+		else if ( startFile(eject_name) == sdcard::SD_SUCCESS )
+			state = QUEUE_EJECTING;
+		else
+			state = QUEUE_IDLE;
+		break;
+
+	case QUEUE_EJECTING:
+		if ( buildOver() )
+			startNext();
+		break;
+	}
+}
+
+}
+
+#endif
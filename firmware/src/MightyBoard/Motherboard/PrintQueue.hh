@@ -0,0 +1,56 @@
+#ifndef __PRINT_QUEUE_HH__
+#define __PRINT_QUEUE_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A queue of builds kept in a text file on the SD card, NAME.QUE, which is
+// started from the SD card menu or by the host as any other build is.  Each
+// build is played in turn, and once one has finished the next is started
+// without waiting for someone to come to the panel.
+//
+// One entry or setting a line, read from the top each time:
+//
+//   - FILE.X3G     a build still to do.  The '-' is overwritten with a '+'
+//                  once it has finished, so a queue which is stopped and
+//                  started again carries on where it left off
+//   cool N         after each build below, wait for the platform to cool
+//                  down to N C; 0 or none doesn't wait.  In PLATFORM_COOLDOWN
+//                  builds, "cool" on its own waits for the platform to have
+//                  settled at its release temperature
+//   eject FILE.X3G after each build below and the cool down, play FILE.X3G
+//                  to clear the platform; an empty name plays nothing
+//
+// Anything else, such as a '#' comment or a "+ FILE.X3G" done entry, is
+// skipped.  The files must be in the same directory as the queue.  A
+// cancelled build stops the queue, with that build still to do.
+
+#ifdef PRINT_QUEUE
+
+#include "SDCard.hh"
+
+namespace printqueue {
+
+/// True if name ends with ".que"
+bool isQueueFile(const char *name);
+
+/// Start the first build still to do in the queue file name, from
+/// host::startBuildFromSD()
+/// \return SD_SUCCESS if a build was started
+sdcard::SdErrorCode start(const char *name);
+
+/// Drop the rest of the queue, leaving any build going
+void stop();
+
+/// True while the queue has builds to run
+bool isRunning();
+
+/// Called from runHostSlice(), starts the cool down, the eject build and the
+/// next build when each is due
+void runSlice();
+
+}
+
+#endif
+
+#endif
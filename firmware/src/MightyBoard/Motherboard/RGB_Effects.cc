@@ -0,0 +1,121 @@
+/*
+ *  RGB LED effects: fades and pulses shown by the timer 5 interrupt, so
+ *  that a build's main loop does none of the work.  When an effect starts
+ *  its RGB_EFFECT_STEPS colours are worked out into a table; the interrupt
+ *  only counts ticks and hands the next colour to the board's
+ *  RGB_LED::pushColor(), which writes it without waiting (on the I2C
+ *  drivers, through the queued TWI writes).  If the writes don't fit in
+ *  the queue the colour is tried again on the next tick.
+ */
+
+#include "Compat.hh"
+#include <util/atomic.h>
+#include "RGB_Effects.hh"
+
+#ifdef HAS_RGB_LED
+
+#include "RGB_LED.hh"
+
+namespace RGB_Effects {
+
+static uint8_t steps[RGB_EFFECT_STEPS][3];
+
+static volatile uint8_t mode = RGB_EFFECT_NONE;
+static uint8_t next;		// step to show next
+static int8_t direction;	// of a pulse
+static uint16_t ticks, ticks_per_step;
+
+// Colour last shown, and the one the effect ends on
+static uint8_t shown[3], target[3];
+
+void stop() {
+     mode = RGB_EFFECT_NONE;
+}
+
+void colorSet(uint8_t r, uint8_t g, uint8_t b) {
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  mode = RGB_EFFECT_NONE;
+	  shown[0] = target[0] = r;
+	  shown[1] = target[1] = g;
+	  shown[2] = target[2] = b;
+     }
+}
+
+// Lay out the steps from one colour to another, and start them going
+static void start(uint8_t effect, const uint8_t *from, const uint8_t *to, uint16_t ms) {
+     stop();
+
+     for (uint8_t i = 0; i < RGB_EFFECT_STEPS; i++)
+	  for (uint8_t c = 0; c < 3; c++)
+	       steps[i][c] = from[c] + ((int16_t)(to[c] - from[c]) * (i + 1)) / RGB_EFFECT_STEPS;
+     for (uint8_t c = 0; c < 3; c++)
+	  target[c] = to[c];
+
+     RGB_LED::prepareEffect(from, to);
+
+     uint16_t t = ms / RGB_EFFECT_STEPS;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  ticks_per_step = t ? t : 1;
+	  ticks = 0;
+	  next = 0;
+	  direction = 1;
+	  mode = effect;
+     }
+}
+
+void fade(uint8_t r, uint8_t g, uint8_t b, uint16_t ms) {
+     if ( !RGB_LED::LEDEnabled )
+	  return;
+     if ( mode != RGB_EFFECT_PULSE && target[0] == r && target[1] == g && target[2] == b )
+	  return;
+
+     uint8_t from[3], to[3] = { r, g, b };
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  mode = RGB_EFFECT_NONE;
+	  from[0] = shown[0];
+	  from[1] = shown[1];
+	  from[2] = shown[2];
+     }
+     start(RGB_EFFECT_FADE, from, to, ms);
+}
+
+void pulse(uint8_t r, uint8_t g, uint8_t b, uint16_t period_ms) {
+     if ( !RGB_LED::LEDEnabled )
+	  return;
+
+     uint8_t from[3] = { 0, 0, 0 }, to[3] = { r, g, b };
+     // Up the steps and back down again
+     start(RGB_EFFECT_PULSE, from, to, period_ms >> 1);
+}
+
+void tick() {
+     if ( mode == RGB_EFFECT_NONE || ++ticks < ticks_per_step )
+	  return;
+     ticks = ticks_per_step;
+
+     const uint8_t *c = steps[next];
+     if ( !RGB_LED::pushColor(c[0], c[1], c[2]) )
+	  return;
+     shown[0] = c[0];
+     shown[1] = c[1];
+     shown[2] = c[2];
+     ticks = 0;
+
+     if ( mode == RGB_EFFECT_FADE ) {
+	  if ( next == RGB_EFFECT_STEPS - 1 )
+	       mode = RGB_EFFECT_NONE;
+	  else
+	       next++;
+     }
+     else {
+	  if ( next == RGB_EFFECT_STEPS - 1 )
+	       direction = -1;
+	  else if ( next == 0 )
+	       direction = 1;
+	  next += direction;
+     }
+}
+
+}
+
+#endif // HAS_RGB_LED
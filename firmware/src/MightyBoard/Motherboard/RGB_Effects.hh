@@ -0,0 +1,47 @@
+#ifndef __RGB_EFFECTS_HH__
+#define __RGB_EFFECTS_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+#ifdef HAS_RGB_LED
+
+// Colours an effect steps through, worked out when it starts
+#ifndef RGB_EFFECT_STEPS
+#define RGB_EFFECT_STEPS 16
+#endif
+
+// Fade from one heating progress colour to the next over this long
+#ifndef RGB_EFFECT_HEAT_MS
+#define RGB_EFFECT_HEAT_MS 800
+#endif
+
+#define RGB_EFFECT_NONE  0
+#define RGB_EFFECT_FADE  1
+#define RGB_EFFECT_PULSE 2
+
+namespace RGB_Effects {
+
+/// Fade from the colour shown to r, g, b over ms milliseconds.  Nothing
+/// is done if that's the colour already shown or being faded to.
+void fade(uint8_t r, uint8_t g, uint8_t b, uint16_t ms);
+
+/// Pulse r, g, b on and off from black, once every period_ms
+void pulse(uint8_t r, uint8_t g, uint8_t b, uint16_t period_ms);
+
+/// Stop the effect, leaving the colour last shown
+void stop();
+
+/// RGB_LED::setColor() calls this: any effect is stopped, and effects
+/// go on from this colour
+void colorSet(uint8_t r, uint8_t g, uint8_t b);
+
+/// Show the effect's next colour when it's due; from the millisecond interrupt
+/// of timer 5
+void tick();
+
+}
+
+#endif // HAS_RGB_LED
+
+#endif // __RGB_EFFECTS_HH__
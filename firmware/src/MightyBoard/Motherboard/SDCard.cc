@@ -20,6 +20,7 @@
 
 #include <avr/io.h>
 #include <string.h>
+#include <avr/wdt.h>
 #include "lib_sd/sd-reader_config.h"
 #include "lib_sd/fat.h"
 #include "lib_sd/sd_raw.h"
@@ -28,6 +29,11 @@
 #include "Menu_locales.hh"
 #include "Eeprom.hh"
 #include "EepromMap.hh"
+#include "CircularBuffer.hh"
+#include "Xmem.hh"
+#if defined(SD_FILE_CRC) && defined(S3G_CAPTURE_2_SD)
+#include <util/crc16.h>
+#endif
 
 #ifndef USE_DYNAMIC_MEMORY
 #error Dynamic memory should be explicitly disabled in the G3 mobo.
@@ -50,7 +56,18 @@ uint8_t sdErrno;
 static struct partition_struct* partition = 0;
 static struct fat_fs_struct* fs = 0;
 static struct fat_dir_struct* cwd = 0; // current working directory
-static struct fat_file_struct* file = 0;
+static struct fat_file_struct* file = 0; // file being played back
+static struct fat_file_struct* capture_file = 0;
+#ifdef SD_PRESCAN
+static struct fat_file_struct* scan_file = 0;
+#endif
+#ifdef LAYER_LOG
+static struct fat_file_struct* log_file = 0;
+#endif
+
+// Changed whenever cwd is, so that positions from directoryTell() can be
+// recognized as stale
+static uint8_t dir_generation = 0;
 
 void forceReinit() {
 #ifndef BROKEN_SD
@@ -96,6 +113,7 @@ static SdErrorCode changeWorkingDir(struct fat_dir_entry_struct *newDir)
 		struct fat_dir_entry_struct rootdirectory;
 		fat_get_dir_entry_of_path(fs, "/", &rootdirectory);
 		cwd = fat_open_dir(fs, &rootdirectory);
+		dir_generation++;
 		return cwd ? SD_SUCCESS : SD_ERR_NO_ROOT;
 	}
 
@@ -105,6 +123,7 @@ static SdErrorCode changeWorkingDir(struct fat_dir_entry_struct *newDir)
 
 	fat_close_dir(cwd);
 	cwd = tmp;
+	dir_generation++;
 
 	return SD_SUCCESS;
 }
@@ -260,6 +279,35 @@ void directoryNextEntry(char* buffer, uint8_t bufsize, uint8_t *buflen, bool *is
 	}
 }
 
+void directoryTell(DirPosition *pos) {
+	struct fat_dir_pos_struct dpos;
+
+	pos->generation = dir_generation;
+	if ( cwd == 0 ) {
+		pos->cluster = 0;
+		pos->offset = 0;
+		return;
+	}
+	fat_tell_dir(cwd, &dpos);
+	pos->cluster = dpos.cluster;
+	pos->offset = dpos.offset;
+}
+
+bool directoryValid(const DirPosition *pos) {
+	return !mustReinit && cwd != 0 && pos->generation == dir_generation;
+}
+
+SdErrorCode directorySeek(const DirPosition *pos) {
+	struct fat_dir_pos_struct dpos;
+
+	if ( !directoryValid(pos) )
+		return SD_ERR_GENERIC;
+	dpos.cluster = (cluster_t)pos->cluster;
+	dpos.offset = pos->offset;
+	fat_seek_dir(cwd, &dpos);
+	return SD_SUCCESS;
+}
+
 static bool findFileInDir(const char* name, struct fat_dir_entry_struct* dir_entry)
 {
 	fat_reset_dir(cwd);
@@ -281,12 +329,12 @@ bool changeDirectory(const char* dname)
 	return ( changeWorkingDir(&dirEntry) == SD_SUCCESS );
 }
 
-static void finishFile() {
-	if ( file == 0 )
+static void finishFile(struct fat_file_struct** fd) {
+	if ( *fd == 0 )
 		return;
-	fat_close_file(file);
+	fat_close_file(*fd);
 	sd_raw_sync();
-	file = 0;
+	*fd = 0;
 }
 
 // WARNING: if the file is a directory, we merely move into it
@@ -295,7 +343,7 @@ static void finishFile() {
 //  +1 -- File opened
 //  -1 -- Moved to the directory; file not opened
 
-static int8_t openFile(const char* name)
+static int8_t openFile(const char* name, struct fat_file_struct** fd)
 {
 	struct fat_dir_entry_struct fileEntry;
 
@@ -305,18 +353,14 @@ static int8_t openFile(const char* name)
 	if ( fileEntry.attributes & FAT_ATTRIB_DIR )
 		return ( changeWorkingDir(&fileEntry) == SD_SUCCESS ) ? -1 : 0;
 
-	finishFile();
-	file = fat_open_file(fs, &fileEntry);
-	return (file != 0) ? 1 : 0;
+	finishFile(fd);
+	*fd = fat_open_file(fs, &fileEntry);
+	return (*fd != 0) ? 1 : 0;
 }
 
-#if 0
-static uint32_t open_filesize = 0U;
-
-uint32_t getFileSize() {
-	return open_filesize;
-}
-#endif
+// Size of the file being played back and the bytes taken from it so far
+static uint32_t playback_size = 0U;
+static uint32_t playback_read = 0U;
 
 static void deleteFile(char *name)
 {
@@ -337,6 +381,39 @@ static bool capturing = false;
 static bool playing = false;
 static uint32_t capturedBytes = 0L;
 
+#ifdef SD_PLAY_WHILE_CAPTURE
+#ifndef S3G_CAPTURE_2_SD
+#error "SD_PLAY_WHILE_CAPTURE needs S3G_CAPTURE_2_SD"
+#endif
+
+// Set while the file played back is the one being captured.  Its end is
+// then only where the capture has got to so far, and playback waits there
+// for more rather than finishing.
+static bool following = false;
+#endif
+
+#ifdef S3G_CAPTURE_2_SD
+
+// Bytes captured from the host are queued here and written to the card a
+// run at a time by runCaptureSlice(), so the host gets its reply without
+// waiting for the card to write a block.
+
+#ifdef PLATFORM_SD_CAPTURE_BUFFER
+#define SD_CAPTURE_BUFFER_SIZE PLATFORM_SD_CAPTURE_BUFFER
+#else
+#define SD_CAPTURE_BUFFER_SIZE 256
+#endif
+
+static CircularBufferPow2Templ<uint8_t, SD_CAPTURE_BUFFER_SIZE> capture_buffer;
+static bool capture_failed = false;
+
+#ifdef SD_FILE_CRC
+// CRC of what's been written so far, and of the first block alone
+static uint16_t capture_crc, capture_head_crc;
+#endif
+
+#endif
+
 bool isPlaying() {
 	return playing;
 }
@@ -370,31 +447,86 @@ SdErrorCode startCapture(char* filename)
     if ( !createFile(filename) )
 	return SD_ERR_FILE_NOT_FOUND;
 
-    if ( openFile(filename) != 1 )
+    if ( openFile(filename, &capture_file) != 1 )
 	return SD_ERR_GENERIC;
 
+#ifdef S3G_CAPTURE_2_SD
+    capture_buffer.reset();
+    capture_failed = false;
+#ifdef SD_FILE_CRC
+    capture_crc = 0xFFFF;
+    capture_head_crc = 0xFFFF;
+#endif
+#endif
     capturing = true;
     return SD_SUCCESS;
 }
 
 #ifdef S3G_CAPTURE_2_SD
 
-void capturePacket(const Packet& packet)
+// Write the queued bytes which are contiguous in the buffer, stopping at
+// the end of the file's current block.  The file is written from its
+// start, so capturedBytes is also the file position.
+static void flushCaptureChunk() {
+	const uint8_t *bytes;
+	uint16_t n = capture_buffer.peekContiguous(&bytes);
+	if ( n == 0 ) return;
+	uint16_t to_block_end = 512 - ((uint16_t)capturedBytes & 511);
+	if ( n > to_block_end ) n = to_block_end;
+	if ( fat_write_file(capture_file, bytes, n) != (intptr_t)n ) {
+		// Card full or gone.  Drop what's queued rather than retry
+		// forever; the byte count finishCapture() returns tells the tale
+		capture_failed = true;
+		capture_buffer.reset();
+		return;
+	}
+#ifdef SD_FILE_CRC
+	for (uint16_t i = 0; i < n; i++)
+		capture_crc = _crc16_update(capture_crc, bytes[i]);
+	// The chunk ends at a block end, so the first block is a whole chunk
+	if ( capturedBytes < 512 )
+		capture_head_crc = capture_crc;
+#endif
+	capture_buffer.pop(n);
+	capturedBytes += n;
+}
+
+// Make room for count more bytes, writing to the card if need be
+static bool captureRoom(uint8_t count) {
+	while ( !capture_failed && capture_buffer.getRemainingCapacity() < count )
+		flushCaptureChunk();
+	return !capture_failed;
+}
+
+void capturePacket(const InPacket& packet)
 {
-	if (file == 0) return;
+	if (capture_file == 0) return;
+	if ( !captureRoom(packet.getLength()) ) return;
 	// Casting away volatile is OK in this instance; we know where the
-	// data is located and that fat_write_file isn't caching
-	fat_write_file(file, (uint8_t*)packet.getData(), packet.getLength());
-	capturedBytes += packet.getLength();
+	// data is located and that nothing else touches it until the next packet
+	capture_buffer.pushFrom((const uint8_t*)packet.getData(), packet.getLength());
 }
 
+void runCaptureSlice() {
+	if ( capturing && !capture_buffer.isEmpty() )
+		flushCaptureChunk();
+}
+
+#ifdef SD_FILE_CRC
+bool getCaptureCrc(uint16_t *head_crc, uint16_t *file_crc) {
+	*head_crc = capture_head_crc;
+	*file_crc = capture_crc;
+	return !capture_failed;
+}
+#endif
+
 #endif
 
 #ifdef EEPROM_MENU_ENABLE
 
 /// Writes b to the open file
 bool writeByte(uint8_t b) {
-    return ( (intptr_t)1 == fat_write_file(file, (uint8_t *)&b, (uintptr_t)1) );
+    return ( (intptr_t)1 == fat_write_file(capture_file, (uint8_t *)&b, (uintptr_t)1) );
 }
 
 #endif
@@ -402,40 +534,189 @@ bool writeByte(uint8_t b) {
 uint32_t finishCapture()
 {
 	if ( capturing ) {
-		finishFile();
+#ifdef S3G_CAPTURE_2_SD
+		while ( !capture_failed && !capture_buffer.isEmpty() )
+			flushCaptureChunk();
+#endif
+#ifdef SD_PLAY_WHILE_CAPTURE
+		// Playback goes on to the end of the file as it now is
+		if ( following ) {
+			fat_follow_file(file, capture_file);
+			playback_size = capturedBytes;
+			following = false;
+		}
+#endif
+		finishFile(&capture_file);
 		capturing = false;
 	}
 	return capturedBytes;
 }
 
-static uint8_t next_index;
-static uint8_t next_avail;
-static uint8_t next_bytes[SD_BYTE_BUFLEN];
 static bool has_more = false;
 //static bool retry = false;
 
+static void readError() {
+	if ( !sd_raw_available() ) {
+	    sdAvailable = SD_ERR_NO_CARD_PRESENT;
+	}
+	else
+	    sdAvailable = ( fat_errno == FAT_ERR_CRC ) ? SD_ERR_CRC : SD_ERR_READ;
+}
+
+static void readNextBytes();
+
+#ifdef SD_PLAYBACK_STATS
+
+PlaybackStats playbackStats;
+
+#if !SD_RAW_SAVE_RAM
+static uint16_t crc_retries_base;
+#endif
+
+void getPlaybackStats(PlaybackStats *stats) {
+	*stats = playbackStats;
+#if !SD_RAW_SAVE_RAM
+	stats->crc_retries = sd_raw_crc_retries - crc_retries_base;
+#endif
+}
+
+void resetPlaybackStats() {
+	memset(&playbackStats, 0, sizeof(playbackStats));
+#if !SD_RAW_SAVE_RAM
+	crc_retries_base = sd_raw_crc_retries;
+#endif
+}
+
 void fetchNextBytes() {
+	uint8_t wrap;
+	micros_t start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	readNextBytes();
+	uint32_t micros = (uint32_t)(Motherboard::getBoard().getCurrentCentaMicros(&wrap) - start) * 100;
+	playbackStats.fetches++;
+	if ( micros > playbackStats.max_micros )
+	    playbackStats.max_micros = micros;
+}
+
+#define COUNT_PLAYBACK_BYTES(n) playbackStats.bytes += (n)
+
+#else
+
+void fetchNextBytes() {
+	readNextBytes();
+}
+
+#define COUNT_PLAYBACK_BYTES(n)
+
+#endif
+
+#ifdef SD_PLAY_WHILE_CAPTURE
+// Before each read of a file being captured, take in what has been written
+// to it since.  Should the reader wait at the end of a cluster, it has to
+// find its place again through the FAT next time; it has caught up with
+// the capture by then, so the time isn't missed.
+#define FOLLOW_CAPTURE() do { \
+	if ( following ) { \
+	    fat_follow_file(file, capture_file); \
+	    playback_size = capturedBytes; \
+	} \
+    } while (0)
+#define FOLLOWING_CAPTURE following
+#else
+#define FOLLOW_CAPTURE()
+#define FOLLOWING_CAPTURE false
+#endif
+
+#if FAT_PEEK_SUPPORT
+
+// The file is played back in place from the block cache of sd_raw, a block
+// at a time, rather than being copied out a few bytes at a time.  Anything
+// else which reads the card, such as a directory listing for the host,
+// replaces the cached block, so playbackBuffered() looks the data up again
+// each time.  That costs little while the block is still cached.
+
+static const uint8_t *next_bytes;
+static uint16_t next_avail;
+
+static void readNextBytes() {
+	FOLLOW_CAPTURE();
+	intptr_t read = fat_peek_file(file, &next_bytes);
+	if ( read > 0 ) {
+	    next_avail = (uint16_t)read;
+	    return;
+	}
+	next_avail = 0;
+	if ( read == 0 && FOLLOWING_CAPTURE )
+	    return;
+	has_more = false;
+	if ( read < 0 )
+	    readError();
+}
+
+bool playbackHasNext() {
+  return has_more;
+}
+
+uint16_t playbackBuffered(const uint8_t **bytes) {
+    if ( !has_more )
+	return 0;
+    fetchNextBytes();
+    *bytes = next_bytes;
+    return next_avail;
+}
+
+void playbackSkip(uint16_t count) {
+    COUNT_PLAYBACK_BYTES(count);
+    playback_read += count;
+    fat_skip_file(file, count);
+    fetchNextBytes();
+}
+
+uint8_t playbackNext() {
+    const uint8_t *bytes;
+    if ( playbackBuffered(&bytes) == 0 )
+	return 0;
+    uint8_t rv = *bytes;
+    playbackSkip(1);
+    return rv;
+}
+
+#else
+
+// A read buffer in external SRAM may be longer than a byte can count
+#if SD_BYTE_BUFLEN > 255
+typedef uint16_t next_index_t;
+#else
+typedef uint8_t next_index_t;
+#endif
+
+static next_index_t next_index;
+static next_index_t next_avail;
+static uint8_t next_bytes[SD_BYTE_BUFLEN] XMEM_SD_DATA;
+
+static void readNextBytes() {
 
         // BE WARNED: fat_read_file() only returns an error on the first
         //   call which encounters the error.  The next call after the error
         //   return will merely return 0 (no bytes read).
 
+	FOLLOW_CAPTURE();
         int16_t read = fat_read_file(file, next_bytes, SD_BYTE_BUFLEN);
 	// retry = read < 0;
 	if ( read > 0 ) {
-	    next_avail = (uint8_t)read;
+	    COUNT_PLAYBACK_BYTES(read);
+	    playback_read += read;
+	    next_avail = (next_index_t)read;
 	    next_index = 0;
 	    return;
 	}
+	else if ( read == 0 && FOLLOWING_CAPTURE ) {
+	    next_avail = 0;
+	    next_index = 0;
+	}
 	else {
 	    has_more = false;
-	    if ( read < 0 ) {
-		if ( !sd_raw_available() ) {
-		    sdAvailable = SD_ERR_NO_CARD_PRESENT;
-		}
-		else
-		    sdAvailable = ( fat_errno == FAT_ERR_CRC ) ? SD_ERR_CRC : SD_ERR_READ;
-	    }
+	    if ( read < 0 )
+		readError();
 	}
 }
 
@@ -449,13 +730,54 @@ bool playbackHasNext() {
   return has_more || next_index < next_avail;// || retry;
 }
 
+// The last read of a file may return fewer than SD_BYTE_BUFLEN bytes, so the
+// buffer is used up at next_avail rather than at its end
 uint8_t playbackNext() {
     uint8_t rv = next_bytes[next_index];
-    if(++next_index == SD_BYTE_BUFLEN)
+    if(++next_index >= next_avail)
         fetchNextBytes();
     return rv;
 }
 
+uint16_t playbackBuffered(const uint8_t **bytes) {
+    // Only once playback has caught up with a capture is the buffer empty
+    // with more of the file to come
+    if ( next_index >= next_avail && has_more )
+        fetchNextBytes();
+    *bytes = &next_bytes[next_index];
+    return ( next_index < next_avail ) ? (uint16_t)(next_avail - next_index) : 0;
+}
+
+void playbackSkip(uint16_t count) {
+    next_index += (next_index_t)count;
+    if ( next_index >= next_avail )
+        fetchNextBytes();
+}
+
+#endif
+
+uint16_t playbackRead(uint8_t *dst, uint16_t count) {
+    const uint8_t *bytes;
+    uint16_t n = playbackBuffered(&bytes);
+    if ( n > count )
+	n = count;
+    if ( n ) {
+	memcpy(dst, bytes, n);
+	playbackSkip(n);
+    }
+    return n;
+}
+
+void playbackProgress(uint32_t *played, uint32_t *size) {
+    *size = playback_size;
+#if FAT_PEEK_SUPPORT
+    *played = playback_read;
+#else
+    // Less what's been read into next_bytes but not played
+    *played = playback_read - (( next_index < next_avail ) ? next_avail - next_index : 0);
+#endif
+}
+
 SdErrorCode startPlayback(char* filename) {
 #ifndef BROKEN_SD
     if ( mustReinit ) {
@@ -469,33 +791,279 @@ SdErrorCode startPlayback(char* filename) {
 	return result;
 #endif
 
+#ifndef SD_PLAY_WHILE_CAPTURE
+    // The one file handle is the capture's
+    if ( capturing )
+	return SD_ERR_GENERIC;
     capturedBytes = 0L;
+#endif
 
-    int8_t res = openFile(filename);
+    int8_t res = openFile(filename, &file);
     if ( res == 0 )
 	return SD_ERR_FILE_NOT_FOUND;
     else if ( res == -1 )
 	// The file was a directory and we successfully moved into it
 	return SD_CWD;
 
-    // open_filesize = fat_get_file_size(file);
+    playback_size = fat_get_file_size(file);
+    playback_read = 0;
+#ifdef SD_PLAY_WHILE_CAPTURE
+    following = capturing && fat_follow_file(file, capture_file);
+    // The progress is of the part captured so far
+    if ( following )
+	playback_size = capturedBytes;
+#endif
+#if FAT_CLUSTER_CACHE_RUNS
+    // Look up the file's clusters now, rather than in the FAT at each
+    // cluster boundary mid print.  A file still being captured has yet to
+    // get all of them.
+    if ( !FOLLOWING_CAPTURE )
+	fat_cache_file_clusters(file);
+#endif
+#if SD_RAW_STREAM_SUPPORT
+    // Nothing else should need the card while a file is played back, so
+    // let sd_raw keep a multiple block read going
+    sd_raw_stream(1);
+#endif
     playing = true;
     has_more = true;
+#ifdef SD_PLAYBACK_STATS
+    resetPlaybackStats();
+#endif
+#if !FAT_PEEK_SUPPORT
+    next_index = 0;
+#endif
+    next_avail = 0;
     fetchNextBytes();
     return SD_SUCCESS;
 }
 
 void finishPlayback() {
 	if ( !playing ) return;
-	finishFile();
+#if SD_RAW_STREAM_SUPPORT
+	sd_raw_stream(0);
+#endif
+	finishFile(&file);
 	playing = false;
 	has_more = false;
+#ifdef SD_PLAY_WHILE_CAPTURE
+	following = false;
+#endif
+}
+
+#ifdef POWER_LOSS_RESUME
+
+bool playbackSeek(uint32_t offset) {
+    // Past the end, a seek would grow the file
+    if ( !playing || offset > fat_get_file_size(file) )
+	return false;
+    int32_t pos = (int32_t)offset;
+    if ( !fat_seek_file(file, &pos, FAT_SEEK_SET) )
+	return false;
+    playback_read = offset;
+    has_more = true;
+#if !FAT_PEEK_SUPPORT
+    next_index = 0;
+#endif
+    next_avail = 0;
+    fetchNextBytes();
+    return true;
+}
+
+#endif
+
+#ifdef SD_PRESCAN
+
+// Unlike openFile(), a directory of the name is left alone
+static bool openPlainFile(const char* name, struct fat_file_struct** fd) {
+	struct fat_dir_entry_struct fileEntry;
+
+	if ( !findFileInDir(name, &fileEntry) || (fileEntry.attributes & FAT_ATTRIB_DIR) )
+		return false;
+	finishFile(fd);
+	*fd = fat_open_file(fs, &fileEntry);
+	return *fd != 0;
+}
+
+SdErrorCode scanOpen(const char* filename, uint32_t *size) {
+	if ( mustReinit )
+		return SD_ERR_GENERIC;
+	if ( !openPlainFile(filename, &scan_file) )
+		return SD_ERR_FILE_NOT_FOUND;
+	*size = fat_get_file_size(scan_file);
+	return SD_SUCCESS;
+}
+
+int16_t scanRead(uint8_t *dst, uint8_t count) {
+	if ( scan_file == 0 )
+		return -1;
+	return (int16_t)fat_read_file(scan_file, dst, count);
+}
+
+SdErrorCode scanError() {
+	if ( !sd_raw_available() )
+		return SD_ERR_NO_CARD_PRESENT;
+	return ( fat_errno == FAT_ERR_CRC ) ? SD_ERR_CRC : SD_ERR_READ;
+}
+
+void scanClose() {
+	finishFile(&scan_file);
+}
+
+bool writeSmallFile(char* filename, const void *data, uint8_t n) {
+	if ( mustReinit || sd_raw_locked() || scan_file != 0 )
+		return false;
+	deleteFile(filename);
+	if ( !createFile(filename) || !openPlainFile(filename, &scan_file) )
+		return false;
+	bool ok = fat_write_file(scan_file, (const uint8_t *)data, n) == (intptr_t)n;
+	finishFile(&scan_file);
+	return ok;
+}
+
+#endif
+
+#ifdef LAYER_LOG
+
+// A log written alongside the build is queued here, so that what writes to
+// it doesn't wait on the card, and written a run at a time when the writer
+// says, as a capture is by flushCaptureChunk()
+
+#ifndef SD_LOG_BUFFER_SIZE
+#define SD_LOG_BUFFER_SIZE 128
+#endif
+
+static CircularBufferPow2Templ<uint8_t, SD_LOG_BUFFER_SIZE> log_buffer;
+static bool log_failed = false;
+static uint32_t log_bytes;
+
+SdErrorCode logOpen(char* filename) {
+	if ( mustReinit )
+		return SD_ERR_GENERIC;
+	if ( sd_raw_locked() )
+		return SD_ERR_CARD_LOCKED;
+	finishFile(&log_file);
+	deleteFile(filename);
+	if ( !createFile(filename) || openFile(filename, &log_file) != 1 )
+		return SD_ERR_GENERIC;
+	log_buffer.reset();
+	log_failed = false;
+	log_bytes = 0;
+	return SD_SUCCESS;
+}
+
+bool logWrite(const void *data, uint8_t n) {
+	if ( log_file == 0 || log_failed )
+		return false;
+	return log_buffer.pushFrom((const uint8_t *)data, n);
+}
+
+uint16_t logQueued() {
+	return log_buffer.getLength();
+}
+
+bool logFlush() {
+	const uint8_t *bytes;
+	uint16_t n = log_buffer.peekContiguous(&bytes);
+	if ( log_file == 0 || log_failed )
+		return false;
+	if ( n == 0 )
+		return true;
+	uint16_t to_block_end = 512 - ((uint16_t)log_bytes & 511);
+	if ( n > to_block_end ) n = to_block_end;
+	if ( fat_write_file(log_file, bytes, n) != (intptr_t)n ) {
+		log_failed = true;
+		log_buffer.reset();
+		return false;
+	}
+	log_buffer.pop(n);
+	log_bytes += n;
+	return true;
+}
+
+void logClose() {
+	while ( !log_buffer.isEmpty() && logFlush() )
+		;
+	finishFile(&log_file);
 }
 
+#endif
+
+#ifdef PRINT_QUEUE
+
+SdErrorCode overwriteByte(char* filename, uint32_t offset, uint8_t b) {
+	if ( playing || capturing )
+		return SD_ERR_GENERIC;
+	if ( mustReinit ) {
+		SdErrorCode rsp = initCard();
+		if ( rsp != SD_SUCCESS ) return rsp;
+	}
+	if ( sd_raw_locked() )
+		return SD_ERR_CARD_LOCKED;
+	if ( openFile(filename, &file) != 1 )
+		return SD_ERR_FILE_NOT_FOUND;
+
+	int32_t pos = (int32_t)offset;
+	bool ok = fat_seek_file(file, &pos, FAT_SEEK_SET) &&
+		( fat_write_file(file, &b, 1) == (intptr_t)1 );
+	finishFile(&file);
+	return ok ? SD_SUCCESS : SD_ERR_GENERIC;
+}
+
+#endif
+
+#ifdef SD_BENCHMARK
+
+// The main loop, and with it the heater control, is held up while the
+// file is read, so the benchmark stops after a second
+
+#define SD_BENCHMARK_CENTAMICROS 10000
+
+SdErrorCode benchmarkRead(char* filename, uint32_t *bytes, uint32_t *micros) {
+	*bytes = 0;
+	*micros = 0;
+	if ( playing || capturing )
+		return SD_ERR_GENERIC;
+
+	uint8_t wrap;
+	micros_t start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	micros_t elapsed = 0;
+
+	// Time the open too, it's part of starting a print
+	SdErrorCode rsp = startPlayback(filename);
+	if ( rsp != SD_SUCCESS )
+		return rsp;
+
+	const uint8_t *data;
+	uint16_t n;
+	while ( ( n = playbackBuffered(&data) ) != 0 ) {
+		*bytes += n;
+		playbackSkip(n);
+		elapsed = Motherboard::getBoard().getCurrentCentaMicros(&wrap) - start;
+		if ( elapsed >= SD_BENCHMARK_CENTAMICROS )
+			break;
+		wdt_reset();
+	}
+	elapsed = Motherboard::getBoard().getCurrentCentaMicros(&wrap) - start;
+	*micros = elapsed * 100;
+
+	rsp = sdAvailable;
+	finishPlayback();
+	return rsp;
+}
+
+#endif
+
 void reset() {
 	finishPlayback();
 	finishCapture();
-	finishFile();
+	finishFile(&file);
+#ifdef SD_PRESCAN
+	finishFile(&scan_file);
+#endif
+#ifdef LAYER_LOG
+	finishFile(&log_file);
+#endif
 	if (cwd != 0) {
 		fat_close_dir(cwd);
 		cwd = 0;
@@ -508,7 +1076,7 @@ void reset() {
 		partition_close(partition);
 		partition = 0;
 	}
-	// open_filesize = 0;
+	playback_size = 0;
 #ifndef BROKEN_SD
 	mustReinit = true;
 #endif
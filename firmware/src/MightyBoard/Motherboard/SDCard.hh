@@ -28,6 +28,8 @@ namespace sdcard {
 
 #ifdef PLATFORM_SD_READ_BUFFER
 #define SD_BYTE_BUFLEN PLATFORM_SD_READ_BUFFER
+#elif defined(XMEM) && defined(XMEM_SD)
+#define SD_BYTE_BUFLEN 512
 #else
 #define SD_BYTE_BUFLEN 16
 #endif
@@ -85,6 +87,34 @@ namespace sdcard {
 			    uint8_t* fileLength = 0, bool *isDir = 0);
 
 
+    /// A position in the listing of the working directory
+    typedef struct {
+      uint32_t cluster;
+      uint16_t offset;
+      uint8_t  generation;  ///< Which working directory the position is in
+    } DirPosition;
+
+
+    /// Get the position of the entry which directoryNextEntry() will
+    /// return next, for coming back to with directorySeek().
+    /// \param[out] pos Position in the directory
+    void directoryTell(DirPosition *pos);
+
+
+    /// Check that a position got from directoryTell() is still good: the
+    /// card and working directory haven't changed since.
+    /// \param[in] pos Position in the directory
+    /// \return True if directorySeek() would go there
+    bool directoryValid(const DirPosition *pos);
+
+
+    /// Continue a directory scan from a position got from directoryTell().
+    /// Fails if the card or working directory has changed since.
+    /// \param[in] pos Position in the directory
+    /// \return SD_SUCCESS if successful
+    SdErrorCode directorySeek(const DirPosition *pos);
+
+
     /// Begin capturing bufffered commands to a new file with the given filename.
     /// Returns an SD card error/success code.
     /// \param[in] filename Name of file to write to
@@ -92,9 +122,23 @@ namespace sdcard {
     SdErrorCode startCapture(char* filename);
 
 
-    /// Capture the contents of a packet to the currently open file.
+#ifdef S3G_CAPTURE_2_SD
+    /// Capture the contents of a packet to the currently open file.  The
+    /// packet is queued, and written to the card by runCaptureSlice().
     /// \param[in] packet Packet to write to file.
-    void capturePacket(const Packet& packet);
+    void capturePacket(const InPacket& packet);
+
+
+    /// Write some of the captured data to the card, if there is any
+    /// queued.  Called from the main loop while capturing.
+    void runCaptureSlice();
+
+#ifdef SD_FILE_CRC
+    /// CRC-16 of the file captured, read once finishCapture() has written
+    /// the last of it, and of its first 512 bytes.  False if a write failed.
+    bool getCaptureCrc(uint16_t *head_crc, uint16_t *file_crc);
+#endif
+#endif
 
 #ifdef EEPROM_MENU_ENABLE
     /// Writes b to the open file
@@ -129,10 +173,141 @@ namespace sdcard {
     uint8_t playbackNext();
 
 
+    /// Return the bytes of the read buffer which haven't been played back
+    /// yet, for copying out in one go.  Consume them with playbackSkip().
+    /// The bytes may be in the SD library's block cache, so they're only
+    /// valid until the card is next accessed.
+    /// \param[out] bytes Set to the first unread byte
+    /// \return Number of unread bytes, 0 at the end of the file
+    uint16_t playbackBuffered(const uint8_t **bytes);
+
+
+    /// Consume count bytes returned by playbackBuffered(), reading the
+    /// next chunk of the file once the buffer is used up.
+    /// \param[in] count Number of bytes to consume
+    void playbackSkip(uint16_t count);
+
+
+    /// Copy up to count of the next bytes of the file to dst, as much of
+    /// the read buffer as there is, and consume them.
+    /// \param[out] dst Where to copy them
+    /// \param[in] count Most bytes to copy
+    /// \return Number of bytes copied, 0 at the end of the file
+    uint16_t playbackRead(uint8_t *dst, uint16_t count);
+
+
+    /// How far playback has got, for estimating the time left
+    /// \param[out] played Bytes of the file played back
+    /// \param[out] size Size of the file
+    void playbackProgress(uint32_t *played, uint32_t *size);
+
+
     /// Halt playback.  Should be called at the end of playback, or on manual
     /// halt; frees up resources.
     void finishPlayback();
 
+#ifdef PRINT_QUEUE
+    /// Overwrite one byte of an existing file in the working directory,
+    /// leaving the rest of it as it is.  Fails while a file is played back
+    /// or captured, as they need the one open file.
+    /// \param[in] filename Name of the file
+    /// \param[in] offset Offset of the byte from the start of the file
+    /// \param[in] b Byte to write there
+    /// \return SD_SUCCESS if successful
+    SdErrorCode overwriteByte(char* filename, uint32_t offset, uint8_t b);
+#endif
+
+#ifdef POWER_LOSS_RESUME
+    /// Carry on playing back the file from offset, rather than from where
+    /// playback has got to.
+    /// \param[in] offset Offset from the start of the file
+    /// \return True if successful, false if not playing or the file is
+    /// shorter than offset
+    bool playbackSeek(uint32_t offset);
+#endif
+
+#ifdef SD_PRESCAN
+    /// Open a file in the working directory for reading alongside the file
+    /// played back, with a handle of its own.  Only one is open at a time.
+    /// \param[in] filename Name of the file
+    /// \param[out] size Size of the file
+    /// \return SD_SUCCESS if successful
+    SdErrorCode scanOpen(const char* filename, uint32_t *size);
+
+    /// Read on from where the last read of the scanOpen() file ended
+    /// \param[out] dst Where to copy the bytes
+    /// \param[in] count Most bytes to read
+    /// \return Number of bytes read, 0 at the end of the file, -1 on an error
+    int16_t scanRead(uint8_t *dst, uint8_t count);
+
+    /// Why the last scanRead() returned -1
+    SdErrorCode scanError();
+
+    /// Close the scanOpen() file
+    void scanClose();
+
+    /// Replace a file in the working directory with n bytes of data, using
+    /// the scanOpen() handle, which mustn't be open
+    /// \return True if successful
+    bool writeSmallFile(char* filename, const void *data, uint8_t n);
+#endif
+
+#ifdef LAYER_LOG
+    /// Create a file in the working directory afresh and keep it open for
+    /// appending to alongside the file played back, with a handle of its
+    /// own.  Only one is open at a time.
+    /// \param[in] filename Name of the file
+    /// \return SD_SUCCESS if successful
+    SdErrorCode logOpen(char* filename);
+
+    /// Queue n bytes to go on the end of the logOpen() file.  Nothing is
+    /// written to the card until logFlush().
+    /// \return False, with nothing queued, if there isn't room for them
+    bool logWrite(const void *data, uint8_t n);
+
+    /// Number of bytes queued and not yet written
+    uint16_t logQueued();
+
+    /// Write the queued bytes which lie together in the queue, up to the
+    /// end of the file's current block.  Once a write fails, the queue and
+    /// all that's written to it after are dropped.
+    /// \return False if the write failed
+    bool logFlush();
+
+    /// Write what's still queued and close the file
+    void logClose();
+#endif
+
+#ifdef SD_BENCHMARK
+    /// Read a file from the card as playback does, for up to a second,
+    /// to measure how fast the card can be read.
+    /// \param[in] filename Name of the file to read
+    /// \param[out] bytes Number of bytes read
+    /// \param[out] micros Time taken, in microseconds
+    /// \return SD_SUCCESS if successful
+    SdErrorCode benchmarkRead(char* filename, uint32_t *bytes, uint32_t *micros);
+#endif
+
+#ifdef SD_PLAYBACK_STATS
+    /// Counters for telling SD card stalls apart from planner stalls.
+    /// They're cleared when playback starts.
+    typedef struct {
+      uint32_t fetches;      ///< Look ups of the next chunk of the file
+      uint32_t bytes;        ///< Bytes of the file played back
+      uint32_t max_micros;   ///< Longest look up, to the 100us the clock ticks at
+      uint16_t crc_retries;  ///< Block reads repeated after a CRC error
+      uint16_t starved;      ///< Times the command buffer ran dry in mid file
+    } PlaybackStats;
+
+    extern PlaybackStats playbackStats;
+
+    /// Copy the playback counters into stats
+    void getPlaybackStats(PlaybackStats *stats);
+
+    /// Clear the playback counters
+    void resetPlaybackStats();
+#endif
+
     /// Check whether a job is being played back from the SD card
     /// \return True if we're playing back buffered commands from a file, false otherwise
     bool isPlaying();
@@ -0,0 +1,179 @@
+/*
+ *  Cooperative scheduler for the slices of the main loop, which puts the
+ *  interface and heaters off while the planner needs refilling.
+ */
+
+#include "Compat.hh"
+#include "Scheduler.hh"
+#include "Host.hh"
+#include "Command.hh"
+#include "Motherboard.hh"
+#include "Steppers.hh"
+#include "StepperAccelPlanner.hh"
+#include "SDCard.hh"
+#include "Timeout.hh"
+#include <avr/pgmspace.h>
+#include <string.h>
+
+namespace scheduler {
+
+static void runHost() { host::runHostSlice(); }
+#ifdef S3G_CAPTURE_2_SD
+static void runSdCapture() { sdcard::runCaptureSlice(); }
+#endif
+static void runCommand() { command::runCommandSlice(); }
+static void runMotherboard() { Motherboard::getBoard().runMotherboardSlice(); }
+static void runSteppers() { steppers::runSteppersSlice(); }
+
+typedef struct {
+	void (*run)(void);
+	uint8_t priority;
+} Slice;
+
+// In SLICE_ order, which is the order they run in
+const static Slice slices[SLICE_COUNT] PROGMEM = {
+	{ runHost,		SLICE_PRIORITY_FEED },
+#ifdef S3G_CAPTURE_2_SD
+	{ runSdCapture,		SLICE_PRIORITY_FEED },
+#endif
+	{ runCommand,		SLICE_PRIORITY_FEED },
+	{ runMotherboard,	SLICE_PRIORITY_BACKGROUND },
+	{ runSteppers,		SLICE_PRIORITY_FEED }
+};
+
+// Runs while the background slices are being put off
+static Timeout defer_timeout;
+
+#ifdef SLICE_STATS
+#define SLICE_BUDGET_TICKS	(SLICE_BUDGET_MS * 10)
+
+// The last entry is for whole passes, SLICE_LOOP
+static SliceStats slice_stats[SLICE_COUNT + 1];
+static uint16_t loop_histogram[SLICE_HISTOGRAM_BUCKETS];
+static uint8_t slow_slice = SLICE_NONE;
+static micros_t pass_start;
+static bool pass_started = false;
+
+// Upper limits of all but the last bucket, in ticks
+const static uint16_t histogram_limits[SLICE_HISTOGRAM_BUCKETS - 1] PROGMEM = {
+	5, 10, 20, 50, 100
+};
+
+static void recordSlice(uint8_t slice, uint16_t ticks) {
+	SliceStats *s = &slice_stats[slice];
+
+	if ( ticks > s->max ) s->max = ticks;
+	if ( ticks > SLICE_BUDGET_TICKS ) {
+		s->over_budget ++;
+		if ( slice != SLICE_LOOP ) slow_slice = slice;
+	}
+
+	// Halve the history before the count overflows, as the ISR
+	// profile does
+	if ( s->runs == 0xffff ) {
+		s->runs >>= 1;
+		s->total >>= 1;
+		if ( slice == SLICE_LOOP ) {
+			for ( uint8_t i = 0; i < SLICE_HISTOGRAM_BUCKETS; i ++ )
+				loop_histogram[i] >>= 1;
+		}
+	}
+	s->runs ++;
+	s->total += ticks;
+}
+
+static void recordLoop(uint16_t ticks) {
+	recordSlice(SLICE_LOOP, ticks);
+
+	uint8_t bucket = 0;
+	while ( bucket < SLICE_HISTOGRAM_BUCKETS - 1 &&
+		ticks >= pgm_read_word(&histogram_limits[bucket]) )
+		bucket ++;
+	loop_histogram[bucket] ++;
+}
+
+static uint16_t ticksSince(micros_t start, micros_t now) {
+	micros_t ticks = now - start;
+	return ( ticks > 0xffff ) ? 0xffff : (uint16_t)ticks;
+}
+
+bool getSliceStats(uint8_t slice, SliceStats *stats) {
+	if ( slice > SLICE_LOOP ) return false;
+	memcpy(stats, &slice_stats[slice], sizeof(SliceStats));
+	return true;
+}
+
+void getLoopHistogram(uint16_t *histogram) {
+	memcpy(histogram, loop_histogram, sizeof(loop_histogram));
+}
+
+uint8_t getSlowSlice() {
+	return slow_slice;
+}
+
+void resetSliceStats() {
+	memset(slice_stats, 0, sizeof(slice_stats));
+	memset(loop_histogram, 0, sizeof(loop_histogram));
+	slow_slice = SLICE_NONE;
+	pass_started = false;
+}
+#endif
+
+// Running low on moves, with commands waiting which could refill them
+static bool plannerLow() {
+	return movesplanned() < SCHEDULER_LOW_MOVES && ! command::isEmpty() &&
+		! command::isPaused();
+}
+
+void runSlices() {
+	// One read of the clock for all of the timeouts polled this pass
+	Timeout::latchClock();
+
+	bool defer;
+	if ( ! plannerLow() ) {
+		defer_timeout.abort();
+		defer = false;
+	}
+	else if ( ! defer_timeout.isActive() ) {
+		defer_timeout.start(SCHEDULER_DEFER_MS * 1000L);
+		defer = true;
+	}
+	else {
+		// Once they've waited long enough they get this pass, and
+		// the timeout starts again on the next
+		defer = ! defer_timeout.hasElapsed();
+	}
+
+#ifdef SLICE_STATS
+	Motherboard& board = Motherboard::getBoard();
+	uint8_t wrap;
+	micros_t start = board.getCurrentCentaMicros(&wrap);
+
+	// The loop period runs from the start of one pass to the start of the
+	// next, so it takes in the work Main.cc does between them
+	if ( pass_started ) recordLoop(ticksSince(pass_start, start));
+	pass_start = start;
+	pass_started = true;
+#endif
+
+	for ( uint8_t i = 0; i < SLICE_COUNT; i ++ ) {
+		if ( defer && pgm_read_byte(&slices[i].priority) == SLICE_PRIORITY_BACKGROUND ) {
+#ifdef SLICE_STATS
+			slice_stats[i].deferred ++;
+#endif
+			continue;
+		}
+
+		((void (*)(void))pgm_read_word(&slices[i].run))();
+
+#ifdef SLICE_STATS
+		micros_t now = board.getCurrentCentaMicros(&wrap);
+		recordSlice(i, ticksSince(start, now));
+		start = now;
+#endif
+	}
+
+	Timeout::unlatchClock();
+}
+
+}
@@ -0,0 +1,84 @@
+#ifndef __SCHEDULER_HH__
+#define __SCHEDULER_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// The main loop runs these slices in turn.  Feed slices, which get moves to
+// the planner, run on every pass.  Background slices (the interface and
+// heaters) are put off while the planner is running low on moves and there
+// are commands waiting, so that the moves get refilled first; but they never
+// wait more than SCHEDULER_DEFER_MS.  The clock is taken once a pass for
+// the timeouts the slices poll.
+
+#define SLICE_HOST		0
+#ifdef S3G_CAPTURE_2_SD
+#define SLICE_SD_CAPTURE	1
+#define SLICE_COMMAND		2
+#else
+#define SLICE_COMMAND		1
+#endif
+#define SLICE_MOTHERBOARD	(SLICE_COMMAND + 1)
+#define SLICE_STEPPERS		(SLICE_COMMAND + 2)
+#define SLICE_COUNT		(SLICE_COMMAND + 3)
+
+// Statistics index for a whole pass of the main loop, and the slow slice
+// when none has gone over the budget
+#define SLICE_LOOP		SLICE_COUNT
+#define SLICE_NONE		0xff
+
+#define SLICE_PRIORITY_FEED		0
+#define SLICE_PRIORITY_BACKGROUND	1
+
+// The planner is running low with fewer moves than this
+#ifndef SCHEDULER_LOW_MOVES
+#define SCHEDULER_LOW_MOVES		(BLOCK_BUFFER_SIZE >> 2)
+#endif
+
+// The longest the background slices are put off for
+#ifndef SCHEDULER_DEFER_MS
+#define SCHEDULER_DEFER_MS		20
+#endif
+
+// A slice, or a pass of the loop, which takes longer than this is counted
+// as over budget; a pass much longer than a short block takes to step out
+// lets the planner run dry.
+#ifndef SLICE_BUDGET_MS
+#define SLICE_BUDGET_MS			5
+#endif
+
+// Loop periods are counted in buckets below 0.5, 1, 2, 5 and 10ms and above
+#define SLICE_HISTOGRAM_BUCKETS		6
+
+namespace scheduler {
+
+/// Run one pass of the main loop's slices
+void runSlices();
+
+#ifdef SLICE_STATS
+/// How long a slice takes to run, in the 100us ticks of
+/// getCurrentCentaMicros(), so a run shorter than that may count as 0
+typedef struct {
+	uint32_t total;		///< Sum of the times of the last "runs" runs
+	uint16_t max;		///< Longest run
+	uint16_t runs;
+	uint16_t deferred;	///< Passes on which a background slice was put off
+	uint16_t over_budget;	///< Runs longer than SLICE_BUDGET_MS
+} SliceStats;
+
+/// Copy the statistics for slice, or for SLICE_LOOP, returns false if slice
+/// is out of range
+bool getSliceStats(uint8_t slice, SliceStats *stats);
+
+/// Copy the histogram of loop periods, SLICE_HISTOGRAM_BUCKETS counts
+void getLoopHistogram(uint16_t *histogram);
+
+/// The slice which last went over budget, or SLICE_NONE
+uint8_t getSlowSlice();
+
+void resetSliceStats();
+#endif
+
+}
+
+#endif
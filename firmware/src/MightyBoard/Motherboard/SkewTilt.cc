@@ -49,6 +49,14 @@
  *
  *    z-skew = z - (d + x * Nx + y * Ny ) / Nz
  *
+ * Rather than divide for every point, skew_init() works out the slopes
+ * Sx = -Nx / Nz and Sy = -Ny / Nz once, in fixed point, and with the
+ * reference point R = (rx, ry, rz) in the plane the Z offset is
+ *
+ *    rz + Sx * (x - rx) + Sy * (y - ry)
+ *
+ * Moving the coordinate system then only moves R.
+ *
  * Tilt transform
  * --------------
  *  Probe the build platform's Z height at three points, P1, P2, and P3,
@@ -87,6 +95,14 @@
  * Inverting the process is then just
  *
  *    P = rotate-Y(Ay, rotate-X(-Ax, P'))
+ *
+ * tilt_init() multiplies the two rotations out into one 3x3 matrix M,
+ * which takes the Z axis to N.  As the rotation is small, M - I is kept,
+ * in fixed point, and a point costs nine integer multiply-adds,
+ *
+ *    P' = P + (M - I) P
+ *
+ * and the inverse uses the transpose of M.
  */
 
 #if defined(AUTO_LEVEL)
@@ -101,16 +117,20 @@
 #endif
 
 #include "Steppers.hh"
+#include "Eeprom.hh"
 #include "EepromMap.hh"
 #include "SkewTilt.hh"
 
-// Coefficients for the equation of the plane
-//
-//   dot-product(P, N) + d = 0
-//   N = normal = ( skew_data[0], skew_data[1], skew_data[2] )
-//   d = skew_data[3]
+// Fraction bits of the slopes of the plane, and of the tilt matrix
+#define SKEW_FRAC_BITS 16
+
+// The slopes are multiplied by X and Y offsets of up to 2^16 steps in 32
+// bits, so they must stay below 2^14, a slope of 1/4; a plate so far out
+// of level is reported as ALEVEL_BAD_LEVEL
+#define SKEW_SLOPE_MAX (1L << 14)
 
-static int32_t skew_data[4];
+// Slopes of the plane, dZ/dX and dZ/dY, each scaled by 2^SKEW_FRAC_BITS
+static int32_t skew_slope[2];
 
 // Maximum difference in Z between the three probing points
 // we need to initialize this since it's also used for error
@@ -127,10 +147,15 @@ static int32_t skew_zdelta = ALEVEL_NOT_ACTIVE;
 // skewing activated
 bool skew_active = false;
 
-// reference point.  Needed to compute d and needed when coordinate
-// space is translated
+// reference point, in the plane.  Moved when coordinate space is translated
 static int32_t r[3];
 
+// Round a sum of products with a fixed point factor back to steps
+static int32_t fixedRound(int32_t sum)
+{
+     return ( sum + (1L << (SKEW_FRAC_BITS - 1)) ) >> SKEW_FRAC_BITS;
+}
+
 static void crossProduct(const int32_t *V1, const int32_t *V2, int32_t *N)
 {
      // Scale down to prevent 32bit overflow
@@ -139,16 +164,10 @@ static void crossProduct(const int32_t *V1, const int32_t *V2, int32_t *N)
      N[2] = (V1[0] * V2[1] - V1[1] * V2[0]) / 512;
 }
 
-static void skew_constant(void)
-{
-     // Determine by solving for d using a point in the plane previously saved
-     skew_data[3] = - ( r[0] * skew_data[0] + r[1] * skew_data[1] + r[2] * skew_data[2] );
-}
-
 int32_t skew(const int32_t *P)
 {
-     // z - ( x * Nx + y * Ny ) / Nz
-     return ( - ( skew_data[3] + P[0] * skew_data[0] + P[1] * skew_data[1] ) / skew_data[2] );
+     // rz + Sx * (x - rx) + Sy * (y - ry)
+     return r[2] + fixedRound((P[0] - r[0]) * skew_slope[0] + (P[1] - r[1]) * skew_slope[1]);
 }
 
 void skew_update(const int32_t *delta)
@@ -156,8 +175,6 @@ void skew_update(const int32_t *delta)
      r[0] += delta[0];
      r[1] += delta[1];
      r[2] += delta[2];
-
-     skew_constant();
 }
 
 bool skew_check(int32_t maxz, const int32_t *P1, const int32_t *P2,
@@ -180,7 +197,7 @@ bool skew_check(int32_t maxz, const int32_t *P1, const int32_t *P2,
 bool skew_init(int32_t maxz, int32_t zoffset,
 	       const int32_t *P1, const int32_t *P2, const int32_t *P3)
 {
-     int32_t probeComps[3], probeOffsets[2], V1[3], V2[3], ztmp;
+     int32_t probeComps[3], probeOffsets[2], V1[3], V2[3], N[3], ztmp;
 
      skew_deinit();
 
@@ -201,10 +218,10 @@ bool skew_init(int32_t maxz, int32_t zoffset,
      }
 
      cli();
-     eeprom_read_block(probeComps, (void *)eeprom_offsets::ALEVEL_PROBE_COMP_SETTINGS,
+     eeprom::readBlock(probeComps, (void *)eeprom_offsets::ALEVEL_PROBE_COMP_SETTINGS,
 		       3*sizeof(int32_t));
 #if !defined(ZYYX_3D_PRINTER)
-     eeprom_read_block(probeOffsets, (void *)eeprom_offsets::ALEVEL_PROBE_OFFSETS,
+     eeprom::readBlock(probeOffsets, (void *)eeprom_offsets::ALEVEL_PROBE_OFFSETS,
 		       2*sizeof(int32_t));
 #endif
      sei();
@@ -222,26 +239,28 @@ bool skew_init(int32_t maxz, int32_t zoffset,
      V2[1] = P3[1] - P1[1];
      V2[2] += probeComps[2] - probeComps[0]; // (P3[2] + probeComps[2]) - (P1[2] + probeComps[0])
 
-     // Compute the normal to the plane and store
-     // in skew_data[0], [1], [2]
-     crossProduct(V1, V2, skew_data);
+     // Compute the normal to the plane
+     crossProduct(V1, V2, N);
 
      // This should never happen: it indicates that either the
      //   probing points fail to define a plane (are co-linear), or
      //   the plane is parallel to the Z axis!  In that case, the
      //   ztmp > skew_zdata test should have triggered a failure
-     if ( skew_data[2] == 0 ) {
-	  skew_zdelta = ( skew_data[0] == 0 && skew_data[1] == 0 ) ?
+     if ( N[2] == 0 ) {
+	  skew_zdelta = ( N[0] == 0 && N[1] == 0 ) ?
 	       ALEVEL_COLINEAR : ALEVEL_BAD_LEVEL;
 	  return false;
      }
 
-     // We want the upward pointing normal
-     if ( skew_data[2] < 0 )
-     {
-	  skew_data[0] = -skew_data[0];
-	  skew_data[1] = -skew_data[1];
-	  skew_data[2] = -skew_data[2];
+     // The slopes, which don't depend on which way the normal points.
+     // This is the only division; it's done once, in 64 bits.
+     skew_slope[0] = (int32_t)( -((int64_t)N[0] << SKEW_FRAC_BITS) / N[2] );
+     skew_slope[1] = (int32_t)( -((int64_t)N[1] << SKEW_FRAC_BITS) / N[2] );
+
+     if ( labs(skew_slope[0]) >= SKEW_SLOPE_MAX || labs(skew_slope[1]) >= SKEW_SLOPE_MAX ) {
+	  skew_slope[0] = skew_slope[1] = 0;
+	  skew_zdelta = ALEVEL_BAD_LEVEL;
+	  return false;
      }
 
      // Save P1 as a reference point in case we need
@@ -263,9 +282,6 @@ bool skew_init(int32_t maxz, int32_t zoffset,
      r[1] = P1[1] + probeOffsets[1];
      r[2] = P1[2] - zoffset;
 
-     // Calculate the constant d using the reference point
-     skew_constant();
-
      // And we're good to go
      skew_active = true;
 
@@ -274,10 +290,11 @@ bool skew_init(int32_t maxz, int32_t zoffset,
 
 void skew_deinit(void)
 {
-     skew_data[0] = 0;
-     skew_data[1] = 0;
-     skew_data[2] = 1;
-     skew_data[3] = 0;
+     skew_slope[0] = 0;
+     skew_slope[1] = 0;
+     r[0] = 0;
+     r[1] = 0;
+     r[2] = 0;
      skew_zdelta  = ALEVEL_NOT_ACTIVE;
      skew_active  = false;
 }
@@ -289,16 +306,9 @@ int32_t skew_status(void)
 
 #if defined(AUTO_LEVEL_TILT)
 
-#define cosAx       0
-#define cosAy       1
-#define sinAx       2
-#define sinAy       3
-#define cosAx_cosAy 4
-#define cosAx_sinAy 5
-#define sinAx_sinAy 6
-#define sinAx_cosAy 7
-
-static FPTYPE tilt_data[8];
+// M - I, scaled by 2^SKEW_FRAC_BITS.  M is a small rotation, so its
+// entries off the diagonal are about the slopes and those on it about 0.
+static int32_t tilt_matrix[3][3];
 
 bool tilt_init(Point &P1, Point &P2, Point &P3)
 {
@@ -325,64 +335,53 @@ bool tilt_init(Point &P1, Point &P2, Point &P3)
 	  N[2] = -N[2];
      }
 
-     FPTYPE Ax, Ay, Nz;
-
-     Nz = ITOFP(N[2]);
-     Ax = atan2(ITOFP(N[1]), Nz);
-     Ay = atan2(ITOFP(N[0]), Nz);
-
-     tilt_data[cosAx] = FCOS(Ax);
-     tilt_data[cosAy] = FCOS(Ay);
-     tilt_data[sinAx] = FSIN(Ax);
-     tilt_data[sinAy] = FSIN(Ay);
-     tilt_data[cosAx_cosAy] = FPMULT2(tilt_data[cosAx], tilt_data[cosAy]);
-     tilt_data[cosAx_sinAy] = FPMULT2(tilt_data[cosAx], tilt_data[sinAy]);
-     tilt_data[sinAx_sinAy] = FPMULT2(tilt_data[sinAx], tilt_data[sinAy]);
-     tilt_data[sinAx_cosAy] = FPMULT2(tilt_data[sinAx], tilt_data[cosAy]);
+     // The sines and cosines of Ax = atan(Ny / Nz) and Ay = atan(Nx / Nz),
+     // without the trig
+     float nx = (float)N[0], ny = (float)N[1], nz = (float)N[2];
+     float hx = sqrt(ny * ny + nz * nz);
+     float hy = sqrt(nx * nx + nz * nz);
+     float cosAx = nz / hx, sinAx = ny / hx;
+     float cosAy = nz / hy, sinAy = nx / hy;
+
+     // M = rotate-X(-Ax) rotate-Y(Ay), which takes (0, 0, 1) to N
+     float M[3][3] = {
+	  {  cosAy,          0.0,    sinAy         },
+	  { -sinAx * sinAy,  cosAx,  sinAx * cosAy },
+	  { -cosAx * sinAy, -sinAx,  cosAx * cosAy }
+     };
+
+     // Each row of M - I is multiplied by a point of up to 2^16 steps
+     // on each axis, and the three products summed in 32 bits
+     for ( uint8_t i = 0; i < 3; i++ )
+	  for ( uint8_t j = 0; j < 3; j++ ) {
+	       float m = M[i][j] - ( ( i == j ) ? 1.0 : 0.0 );
+	       if ( fabs(m) >= (float)(SKEW_SLOPE_MAX >> 1) / (1L << SKEW_FRAC_BITS) )
+		    return false;
+	       tilt_matrix[i][j] = (int32_t)lround(m * (1L << SKEW_FRAC_BITS));
+	  }
 
      return true;
 }
 
 Point tilt(Point &P)
 {
-     FPTYPE Px, Py, Pz;
-
-     Px = ITOFP(P[0]);
-     Py = ITOFP(P[1]);
-     Pz = ITOFP(P[2]);
-
      Point np;
 
-     np[0] = FPTOI(FPMULT2(Px, tilt_data[cosAx]) +
-		    FPMULT2(Pz, tilt_data[sinAy]));
-     np[1] = FPTOI(FPMULT2(Py, tilt_data[cosAx]) -
-		    FPMULT2(Px, tilt_data[sinAx_sinAy]) +
-		    FPMULT2(Px, tilt_data[sinAx_cosAy]));
-     np[2] = FPTOI(FPMULT2(Pz, tilt_data[cosAx_cosAy]) +
-		    FPMULT2(Px, tilt_data[cosAx_sinAy]) -
-		    FPMULT2(Py, tilt_data[sinAx]));
+     for ( uint8_t i = 0; i < 3; i++ )
+	  np[i] = P[i] + fixedRound(tilt_matrix[i][0] * P[0] +
+				    tilt_matrix[i][1] * P[1] + tilt_matrix[i][2] * P[2]);
 
      return np;
 }
 
 Point tilt_inverse(Point &P)
 {
-     FPTYPE Px, Py, Pz;
-
-     Px = ITOFP(P[0]);
-     Py = ITOFP(P[1]);
-     Pz = ITOFP(P[2]);
-
      Point np;
 
-     np[0] = FPTOI(FPMULT2(Px, tilt_data[cosAy]) +
-		    FPMULT2(Pz, tilt_data[sinAx]));
-     np[1] = FPTOI(FPMULT2(Py, tilt_data[cosAy]) -
-		    FPMULT2(Px, tilt_data[sinAx_sinAy]) +
-		    FPMULT2(Px, tilt_data[cosAx_sinAy]));
-     np[2] = FPTOI(FPMULT2(Pz, tilt_data[cosAx_cosAy]) +
-		    FPMULT2(Px, tilt_data[sinAx_cosAy]) -
-		    FPMULT2(Py, tilt_data[sinAy]));
+     // M is a rotation, so its inverse is its transpose
+     for ( uint8_t i = 0; i < 3; i++ )
+	  np[i] = P[i] + fixedRound(tilt_matrix[0][i] * P[0] +
+				    tilt_matrix[1][i] * P[1] + tilt_matrix[2][i] * P[2]);
 
      return np;
 }
@@ -0,0 +1,183 @@
+/*
+ *  Journal of the lifetime filament counters and build time.  These
+ *  change at the end of every build, on pauses and when heaters are
+ *  turned off, and writing them in place blocked for 3.3 ms a byte and
+ *  wore out the same few bytes each time.
+ *
+ *  The counters are kept in RAM.  A change is written as a whole record
+ *  into the next of the slots of the STATS_JOURNAL region, queued for the
+ *  EEPROM interrupt once there's room for all of it, so each slot is
+ *  written once in JOURNAL_SLOTS changes.  The record's CRC goes last; a
+ *  record cut short by a reset fails its CRC, and the one before it is
+ *  read at the next boot.  Sequence numbers, compared modulo 256, say
+ *  which record is the newest.
+ *
+ *  The old fixed cells, FILAMENT_LIFETIME and TOTAL_BUILD_TIME, are read
+ *  only to start the journal; the host still reads and writes the counters
+ *  there, through hostRead() and hostWrite().
+ */
+
+#include "Compat.hh"
+#include <stddef.h>
+#include <util/crc16.h>
+#include <avr/pgmspace.h>
+
+#include "Eeprom.hh"
+#include "EepromMap.hh"
+#include "StatsJournal.hh"
+
+// Leaves neither an erased nor a zeroed slot with a good CRC
+#define JOURNAL_CRC_SEED 0x4A
+
+typedef struct {
+     uint8_t seq;
+     uint16_t hours;
+     uint8_t minutes;
+     int64_t filament[2];
+     uint8_t crc;
+} Record;
+
+// hours and minutes lie as they do at TOTAL_BUILD_TIME, and then the
+// counters as at FILAMENT_LIFETIME; see copyCells()
+typedef char journal_size_check[(sizeof(Record) == 21 && sizeof(Record) < EEPROM_QUEUE_LENGTH) ? 1 : -1];
+typedef char journal_time_check[(build_time_offsets::MINUTES == 2) ? 1 : -1];
+
+#define JOURNAL_SLOTS ((eeprom_offsets::STATS_JOURNAL_END - eeprom_offsets::STATS_JOURNAL) / sizeof(Record))
+
+typedef char journal_slots_check[(JOURNAL_SLOTS >= 2 && JOURNAL_SLOTS < 128) ? 1 : -1];
+
+namespace journal {
+
+static Record current;		// the counters as they are now
+static bool dirty = false;	// current has changed since it was last queued
+
+static uint8_t next_slot = 0;
+static uint8_t next_seq = 0;
+
+static uint8_t crc(const Record *r) {
+     const uint8_t *p = (const uint8_t *)r;
+     uint8_t c = JOURNAL_CRC_SEED;
+     for (uint8_t i = 0; i < offsetof(Record, crc); i++)
+	  c = _crc_ibutton_update(c, p[i]);
+     return c;
+}
+
+void load() {
+     flush();
+
+     Record r;
+     bool found = false;
+     for (uint8_t slot = 0; slot < JOURNAL_SLOTS; slot++) {
+	  eeprom::readBlock(&r, (const void *)(eeprom_offsets::STATS_JOURNAL + slot * sizeof(Record)),
+			    sizeof(Record));
+	  if ( r.crc != crc(&r) )
+	       continue;
+	  if ( !found || (int8_t)(r.seq - current.seq) > 0 ) {
+	       current = r;
+	       next_slot = slot + 1;
+	       found = true;
+	  }
+     }
+
+     if ( found ) {
+	  next_seq = current.seq + 1;
+	  if ( next_slot >= JOURNAL_SLOTS )
+	       next_slot = 0;
+     }
+     else {
+	  current.hours = eeprom::getEeprom16(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::HOURS, 0);
+	  current.minutes = eeprom::getEeprom8(eeprom_offsets::TOTAL_BUILD_TIME + build_time_offsets::MINUTES, 0);
+	  for (uint8_t i = 0; i < 2; i++)
+	       current.filament[i] = eeprom::getEepromInt64(eeprom_offsets::FILAMENT_LIFETIME +
+							    i * sizeof(int64_t), 0);
+	  next_slot = 0;
+	  next_seq = 0;
+     }
+     dirty = false;
+}
+
+static void queueRecord() {
+     Record out = current;
+     out.seq = next_seq++;
+     out.crc = crc(&out);
+     eeprom::writeBlock(&out, (void *)(eeprom_offsets::STATS_JOURNAL + next_slot * sizeof(Record)),
+			sizeof(Record));
+     if ( ++next_slot >= JOURNAL_SLOTS )
+	  next_slot = 0;
+     dirty = false;
+}
+
+void service() {
+     if ( dirty && eeprom::writeRoom(sizeof(Record)) )
+	  queueRecord();
+}
+
+void flush() {
+     if ( dirty )
+	  queueRecord();
+     eeprom::flushWrites();
+}
+
+int64_t getFilament(uint8_t extruder) {
+     return current.filament[extruder];
+}
+
+void addFilament(uint8_t extruder, int64_t steps) {
+     current.filament[extruder] += steps;
+     dirty = true;
+}
+
+void setFilament(uint8_t extruder, int64_t steps) {
+     current.filament[extruder] = steps;
+     dirty = true;
+}
+
+void getBuildTime(uint16_t *hours, uint8_t *minutes) {
+     *hours = current.hours;
+     *minutes = current.minutes;
+}
+
+void setBuildTime(uint16_t hours, uint8_t minutes) {
+     current.hours = hours;
+     current.minutes = minutes;
+     dirty = true;
+}
+
+// Copies the bytes of the fixed cells which fall in offset to
+// offset + length between data and the current record, returns true if
+// any did
+static bool copyCells(uint16_t offset, uint8_t *data, uint8_t length, bool to_record) {
+     static const PROGMEM uint16_t cell[2]  = { eeprom_offsets::TOTAL_BUILD_TIME, eeprom_offsets::FILAMENT_LIFETIME };
+     static const PROGMEM uint8_t  first[2] = { offsetof(Record, hours), offsetof(Record, filament) };
+     static const PROGMEM uint8_t  size[2]  = { 3, 2 * sizeof(int64_t) };
+
+     uint8_t *rec = (uint8_t *)&current;
+     bool any = false;
+     for (uint8_t c = 0; c < 2; c++) {
+	  uint16_t base = pgm_read_word(&cell[c]);
+	  uint8_t  *r   = rec + pgm_read_byte(&first[c]);
+	  uint8_t  n    = pgm_read_byte(&size[c]);
+	  for (uint8_t i = 0; i < n; i++) {
+	       uint16_t addr = base + i;
+	       if ( addr < offset || addr >= offset + length )
+		    continue;
+	       if ( to_record )
+		    r[i] = data[addr - offset];
+	       else
+		    data[addr - offset] = r[i];
+	       any = true;
+	  }
+     }
+     return any;
+}
+
+void hostRead(uint16_t offset, uint8_t *data, uint8_t length) {
+     copyCells(offset, data, length, false);
+}
+
+void hostWrite(uint16_t offset, const uint8_t *data, uint8_t length) {
+     if ( copyCells(offset, (uint8_t *)data, length, true) )
+	  dirty = true;
+}
+
+}
@@ -0,0 +1,39 @@
+#ifndef __STATS_JOURNAL_HH__
+#define __STATS_JOURNAL_HH__
+
+#include <stdint.h>
+
+// The lifetime filament counters and build time are kept in RAM and
+// journalled to the EEPROM in the background, each change as a new record
+// in the next slot of eeprom_offsets::STATS_JOURNAL.
+
+namespace journal {
+
+/// Read the newest record, finishing any record still being written
+/// first.  With no record, the old fixed cells are taken instead.
+void load();
+
+/// Queue a record of the changes, if there's room for it.  Called from
+/// the main loop.
+void service();
+
+/// Wait for the changes so far to be written
+void flush();
+
+/// Lifetime filament used by an extruder, in steps
+int64_t getFilament(uint8_t extruder);
+void addFilament(uint8_t extruder, int64_t steps);
+void setFilament(uint8_t extruder, int64_t steps);
+
+void getBuildTime(uint16_t *hours, uint8_t *minutes);
+void setBuildTime(uint16_t hours, uint8_t minutes);
+
+/// The host reads and writes the counters at their fixed cells; these put
+/// the journal's values in place of the cells' in data, and take them
+/// from data, for the bytes of offset to offset + length which overlap
+void hostRead(uint16_t offset, uint8_t *data, uint8_t length);
+void hostWrite(uint16_t offset, const uint8_t *data, uint8_t length);
+
+}
+
+#endif
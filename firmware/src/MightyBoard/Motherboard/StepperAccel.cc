@@ -31,22 +31,48 @@
 #include "StepperAccel.hh"
 
 #ifdef LOOKUP_TABLE_TIMER
-	#include "StepperAccelSpeedTable.hh"
+	// The SConscript generates the tables for the platform being built, the
+	// checked in ones cover every rate for builds made some other way
+	#ifdef SPEED_TABLE_GENERATED
+		#include "StepperAccelSpeedTableGen.hh"
+	#else
+		#include "StepperAccelSpeedTable.hh"
+	#endif
+
+	#if SPEED_TABLE_TIMER_FREQ != (F_CPU / 8)
+		#error "The speed tables were generated for another F_CPU"
+	#endif
+	#if SPEED_TABLE_MAX_RATE < TIMER_STEP_RATE_MAX
+		#error "The speed tables don't reach TIMER_STEP_RATE_MAX, define ADAPTIVE_MULTISTEP and USB_LOW_PRIORITY with defines= so the generator sees them"
+	#endif
+	#if (defined(OVERSAMPLED_DDA) && OVERSAMPLED_DDA > SPEED_TABLE_OVERSAMPLE_BITS) || \
+	    (defined(AMASS_DDA) && AMASS_MAX_LEVEL > SPEED_TABLE_OVERSAMPLE_BITS)
+		#error "The speed tables weren't checked for this much dda oversampling"
+	#endif
 #endif
 
 #include "Motherboard.hh"
 
 #include <avr/interrupt.h>
+#include <util/delay.h>
 #include <string.h>
 #include <math.h>
 #include "StepperAxis.hh"
 #include "Steppers.hh"
+#include "IsrProfile.hh"
+#include "FlightRecorder.hh"
 
 block_t		*current_block;				// A pointer to the block currently being traced
 bool            extruder_deprime_travel;                // When false, only deprime on pauses
 bool		extrude_when_negative[EXTRUDERS];	// True if negative values cause an extruder to extrude material
 int16_t		extruder_deprime_steps[EXTRUDERS];	// Positive number of steps to prime / deprime
 float		extruder_only_max_feedrate[EXTRUDERS];
+#ifdef UNDERRUN_STATS
+volatile uint8_t	st_drained;
+#endif
+#ifdef SD_DRY_RUN
+volatile bool		st_dry_running = false;
+#endif
 
 #ifdef JKN_ADVANCE
 	enum AdvanceState {
@@ -65,27 +91,95 @@ float		extruder_only_max_feedrate[EXTRUDERS];
     static uint8_t st_extruder_interrupt_rate[EXTRUDERS] = { EXTRUDERS_(0, 0)};
     static uint8_t extruder_interrupt_steps_per_call[EXTRUDERS]	= {EXTRUDERS_(0, 0)};
 	static uint8_t st_extruder_interrupt_rate_counter[EXTRUDERS];
+
+	// The direction last put out on each extruder's pin, 0 before the first step.
+	// It's only written again when the advance or a deprime reverses it
+	static int8_t e_direction[EXTRUDERS];
+
+	// The A3982 and A4982 need 200ns from a change of direction to the step's rising edge
+	#define EXTRUDER_DIR_SETUP_US	0.2
 #endif
 
 static unsigned char		out_bits;		// The next stepping-bits to be output
 volatile static uint32_t	step_events_completed;	// The number of step events executed in the current block
+#ifndef STEP_DUAL_EDGE
+static uint8_t			steps_pulsed;		// Axes whose step pins the last step event left high
+#endif
 
+#ifndef PRECOMPUTED_RAMPS
 static int32_t		acceleration_time, deceleration_time;
 static uint16_t		acc_step_rate, step_rate;
+#endif
 static char		step_loops, step_loops_nominal;
 static uint16_t		OCRnA_nominal;
 
+// The speed factor from the panel, 8.8, and what the intervals of current_block
+// are multiplied by to play it at that factor rather than the one it was
+// planned at; 256 when they're the same or the block isn't under the factor
+static volatile uint16_t	live_speed_factor = 256;
+static uint16_t			interval_scale = 256;
+
+#ifdef ADAPTIVE_MULTISTEP
+// log2 of the number of steps per interrupt that calc_timer() uses, adjusted at
+// the end of st_interrupt() from the time the interrupt took
+static uint8_t		multistep_shift = 0;
+static uint8_t		multistep_shift_nominal;	// multistep_shift when OCRnA_nominal was calculated
+#endif
+
+#ifdef PRECOMPUTED_RAMPS
+static block_ramp_t	*current_ramp;		// Precomputed timer values for current_block
+static uint8_t		ramp_index;		// The segment in current_ramp being stepped
+static uint32_t		ramp_next_step;		// The step event which starts the next segment
+#endif
+
+#ifdef FAST_PAUSE
+#define STOP_NONE		0
+#define STOP_REQUESTED		1	// Start decelerating at the next rate change
+#define STOP_DECELERATING	2
+#define STOP_STOPPED		3	// No blocks are picked up until st_resume()
+
+// The lowest rate the stop decelerates to, that of calculate_trapezoid_for_block()
+#define STOP_RATE_MIN		120
+
+static volatile uint8_t	stop_state = STOP_NONE;
+static volatile bool	stopped_in_block;	// The block at the tail was halted part way through
+static uint16_t		stop_rate;		// The rate the deceleration started from
+static uint16_t		stop_step_rate;		// and the one it's got down to
+static int32_t		stop_time;		// Timer ticks since it started
+#endif
+
 static bool		deprimed[EXTRUDERS];
 
 static bool		deprime_enabled;		//If true, depriming is On, if not, it's Off.  It's normally switched on.
 							//But is switched off when loading/unloading the extruder
 static uint8_t		last_active_toolhead = 0;
 
+// Bumped by the stepper interrupt each time it runs, and by anything else
+// which changes dda_position[] or last_active_toolhead, with interrupts off.
+// st_get_position() copies them with interrupts on and tries again if the
+// count has moved meanwhile, so that polling the position doesn't hold up
+// the steps.
+static volatile uint8_t	position_seq = 0;
+#define POSITION_SNAPSHOT_TRIES	4
+
+// A position and toolhead for the stepper interrupt to take up as the block in slot
+// mark_block finishes, left by st_mark_position()
+static bool		mark_pending = false;
+static uint8_t		mark_block;
+static uint8_t		mark_toolhead;
+static int32_t		mark_position[STEPPER_COUNT];
+
+#ifdef SD_DRY_RUN
+// Where the motors really are while a dry run plans moves they don't make
+static int32_t		dry_run_position[STEPPER_COUNT];
+static uint8_t		dry_run_toolhead;
+#endif
+
 #if  defined(DEBUG_TIMER)
 uint16_t debugTimer;
 #endif
 
-#ifdef OVERSAMPLED_DDA
+#ifdef DDA_OVERSAMPLE_BITS
 uint8_t oversampledCount = 0;
 #endif
 
@@ -197,41 +291,20 @@ struct lookup_table_entry {
 // Shift by 1 byte to the right
 #define SHIFT1(x) (uint8_t)((uint16_t)(x) >> 8)
 
-#if !defined(USB_LOW_PRIORITY)
-#define STEP_RATE_LOW   4864
-#define STEP_RATE_MED   9984
-#define STEP_RATE_HIGH 19968
-#else
-#define STEP_RATE_LOW   9984
-#define STEP_RATE_MED  19968
-#define STEP_RATE_HIGH 39936  // be careful of this being treated as a int16_t
+#if defined(AMASS_DDA) && !defined(AMASS_MAX_RATE)
+	// The highest interrupt rate AMASS_DDA oversamples up to, beyond this we'd be
+	// taking multiple steps per interrupt anyway
+	#define AMASS_MAX_RATE STEP_RATE_LOW
 #endif
 
 
-FORCE_INLINE uint16_t calc_timer(uint16_t step_rate) {
-	uint16_t timer;
-	uint8_t step_rate_high = SHIFT1(step_rate);
-
-	if (step_rate_high > SHIFT1(STEP_RATE_HIGH)) {
-		if (step_rate_high > SHIFT1(MAX_STEP_FREQUENCY))
-		     step_rate = ((uint16_t)MAX_STEP_FREQUENCY >> 3) & 0x1fff;
-		else
-		     step_rate = (step_rate >> 3) & 0x1fff;
-		step_loops = 8;
-	}
-	else if (step_rate_high > SHIFT1(STEP_RATE_MED)) {
-		step_rate = (step_rate >> 2) & 0x3fff;
-		step_loops = 4;
-	}
-	else if (step_rate_high > SHIFT1(STEP_RATE_LOW)) {
-		step_rate = (step_rate >> 1) & 0x7fff;
-		step_loops = 2;
-	} else {
-		if (step_rate < 32) step_rate = 32;
-		step_loops = 1;
-	}
+// Converts the step rate of the interrupt itself (i.e. already divided by the number of
+// steps taken per interrupt) to a timer value.  step_rate must be at least 32.
 
+FORCE_INLINE uint16_t rate_to_timer(uint16_t step_rate) {
 #ifdef LOOKUP_TABLE_TIMER
+	uint16_t timer;
+
 	step_rate -= 32; // Correct for minimal speed
 
 	if(step_rate >= (8*256)) { // higher step rate
@@ -262,72 +335,418 @@ FORCE_INLINE uint16_t calc_timer(uint16_t step_rate) {
 
 
 
+FORCE_INLINE uint16_t calc_timer_and_loops(uint16_t step_rate, uint8_t &loops) {
+	uint8_t step_rate_high = SHIFT1(step_rate);
+
+	if (step_rate_high > SHIFT1(STEP_RATE_HIGH)) {
+		if (step_rate_high > SHIFT1(MAX_STEP_FREQUENCY))
+		     step_rate = ((uint16_t)MAX_STEP_FREQUENCY >> 3) & 0x1fff;
+		else
+		     step_rate = (step_rate >> 3) & 0x1fff;
+		loops = 8;
+	}
+	else if (step_rate_high > SHIFT1(STEP_RATE_MED)) {
+		step_rate = (step_rate >> 2) & 0x3fff;
+		loops = 4;
+	}
+	else if (step_rate_high > SHIFT1(STEP_RATE_LOW)) {
+		step_rate = (step_rate >> 1) & 0x7fff;
+		loops = 2;
+	} else {
+		if (step_rate < 32) step_rate = 32;
+		loops = 1;
+	}
+
+	return rate_to_timer(step_rate);
+}
+
+
+
+#ifdef ADAPTIVE_MULTISTEP
+
+FORCE_INLINE uint16_t calc_timer(uint16_t step_rate) {
+	if ( step_rate > MAX_STEP_FREQUENCY )	step_rate = MAX_STEP_FREQUENCY;
+
+	// Slow moves keep stepping once per interrupt so they stay smooth, and regardless
+	// of the measured headroom, we never interrupt faster than STEP_RATE_MED
+	uint8_t shift = multistep_shift;
+	while (( shift ) && ( (step_rate >> shift) < ADAPTIVE_MULTISTEP_MIN_RATE ))	shift --;
+	while (( shift < 3 ) && ( (step_rate >> shift) > STEP_RATE_MED ))		shift ++;
+
+	step_loops = 1 << shift;
+	step_rate >>= shift;
+	if ( step_rate < 32 ) step_rate = 32;
+
+	return rate_to_timer(step_rate);
+}
+
+#else
+
+FORCE_INLINE uint16_t calc_timer(uint16_t step_rate) {
+	uint8_t loops;
+	uint16_t timer = calc_timer_and_loops(step_rate, loops);
+	step_loops = loops;
+	return timer;
+}
+
+#endif
+
+
+
+#ifdef S_CURVE_ACCELERATION
+
+// a * b >> 16
+FORCE_INLINE uint16_t mul_u16_h16(uint16_t a, uint16_t b) {
+	return (uint16_t)(((uint32_t)a * b) >> 16);
+}
+
+// How far the rate has got along an S-curve ramp, as a fraction of 0x10000, after time
+// ticks into it: 10t^3 - 15t^4 + 6t^5 for the fraction t of the ramp's time gone by.
+
+FORCE_INLINE uint16_t s_curve_fraction(uint32_t time, int8_t shift, uint16_t inverse) {
+	if ( shift >= 0 ) {
+		time >>= shift;
+	} else {
+		if ( time >= (0x10000UL >> -shift) )	return 0xFFFF;
+		time <<= -shift;
+	}
+	if ( time > 0xFFFF )	return 0xFFFF;
+
+	uint32_t t = ((uint32_t)(uint16_t)time * inverse) >> 15;
+	if ( t > 0xFFFF )	return 0xFFFF;
+
+	uint16_t t1 = (uint16_t)t;
+	uint16_t t2 = mul_u16_h16(t1, t1);
+	uint16_t t3 = mul_u16_h16(t2, t1);
+
+	// 6t^2 - 15t + 10, from 1 to 10, in 4.12 fixed point.  The partial sums
+	// may wrap but the result doesn't.
+	uint16_t poly = 40960U + (t2 >> 4) * 6U - (t1 >> 4) * 15U;
+
+	uint32_t b = ((uint32_t)t3 * poly) >> 12;
+	return ( b > 0xFFFF ) ? 0xFFFF : (uint16_t)b;
+}
+
+#endif
+
+
+
+#ifdef INPUT_SHAPING
+
+// The commanded positions of X and Y are sampled every SHAPER_SAMPLE_TICKS of the
+// stepper timer into shaper_history[].  Each shaped axis is then stepped towards the
+// sum of its impulses, gain[i] / 256 times where the axis was commanded to be delay[i]
+// samples ago.  The gains sum to 256, so the axis ends up where it was sent, a little
+// after the dda finishes with it.
+
+#define SHAPER_SAMPLE_SHIFT	10
+#define SHAPER_SAMPLE_TICKS	(1 << SHAPER_SAMPLE_SHIFT)	// 512us of the 2MHz timer
+#define SHAPER_HISTORY_MASK	(INPUT_SHAPER_HISTORY - 1)
+#define SHAPER_IDLE_TICKS	200				// 100us, while the steps are caught up
+
+struct shaper_axis {
+	uint8_t		impulses;		// 0 when the axis isn't shaped
+	uint8_t		delay[3];		// Samples, delay[0] is 0
+	uint16_t	gain[3];		// Of 256
+	int16_t		output;			// Steps taken, comparable with shaper_command[]
+};
+
+static struct shaper_axis	shaper[Y_AXIS + 1];
+static int16_t			shaper_history[Y_AXIS + 1][INPUT_SHAPER_HISTORY];
+static uint8_t			shaper_head;		// Newest sample in shaper_history
+static uint16_t			shaper_clock;		// Ticks since the newest sample
+static uint16_t			shaper_interval;	// Ticks since the last interrupt
+static uint8_t			shaper_longest;		// Longest delay of the shaped axes
+static uint8_t			shaper_settling;	// Samples until the history has caught up
+
+// Takes the samples due in the ticks since the last interrupt
+
+FORCE_INLINE void shaper_advance(uint16_t ticks) {
+	uint32_t clock = (uint32_t)shaper_clock + ticks;
+	uint8_t samples = 0;
+	while (( clock >= SHAPER_SAMPLE_TICKS ) && ( samples < INPUT_SHAPER_HISTORY )) {
+		clock -= SHAPER_SAMPLE_TICKS;
+		samples ++;
+
+		uint8_t last = shaper_head;
+		shaper_head = (shaper_head + 1) & SHAPER_HISTORY_MASK;
+		bool moved = false;
+		for ( uint8_t a = X_AXIS; a <= Y_AXIS; a ++ ) {
+			int16_t command = shaper_command[a];
+			if ( command != shaper_history[a][last] )	moved = true;
+			shaper_history[a][shaper_head] = command;
+		}
+		if ( moved )			shaper_settling = shaper_longest + 1;
+		else if ( shaper_settling )	shaper_settling --;
+	}
+	// After a long interval all of the history is the same
+	shaper_clock = (uint16_t)(clock & (SHAPER_SAMPLE_TICKS - 1));
+}
+
+// The commanded position delay samples ago, between the samples either side of it;
+// weight is how far the older sample is from the time wanted, of 256
+
+FORCE_INLINE int16_t shaper_delayed(uint8_t axis, uint8_t delay, uint16_t weight) {
+	if ( delay == 0 )	return shaper_command[axis];
+	int16_t newer = shaper_history[axis][(shaper_head - delay + 1) & SHAPER_HISTORY_MASK];
+	int16_t older = shaper_history[axis][(shaper_head - delay) & SHAPER_HISTORY_MASK];
+	return newer + (int16_t)(((int32_t)(int16_t)(older - newer) * weight) >> 8);
+}
+
+FORCE_INLINE bool shaper_pending() {
+	return shaper_settling ||
+		( shaper[X_AXIS].output != shaper_command[X_AXIS] ) ||
+		( shaper[Y_AXIS].output != shaper_command[Y_AXIS] );
+}
+
+// Steps each shaped axis once if it's half a step or more from where its impulses put it
+
+static void st_shaper_step() {
+	uint16_t weight = (SHAPER_SAMPLE_TICKS - shaper_clock) >> (SHAPER_SAMPLE_SHIFT - 8);
+
+	for ( uint8_t a = X_AXIS; a <= Y_AXIS; a ++ ) {
+		struct shaper_axis *s = &shaper[a];
+		if ( s->impulses == 0 )	continue;
+		if (( shaper_settling == 0 ) && ( s->output == shaper_command[a] ))	continue;
+
+		// Distance to go, in 256ths of a step
+		int32_t error = 0;
+		for ( uint8_t i = 0; i < s->impulses; i ++ )
+			error += (int32_t)(int16_t)(shaper_delayed(a, s->delay[i], weight) - s->output) * s->gain[i];
+
+		bool forward;
+		if ( error >= 128 )		forward = true;
+		else if ( error <= -128 )	forward = false;
+		else				continue;
+
+		stepperAxisSetDirection(a, forward);
+		if ( ! stepperAxisStepWithEndstopCheck(a, forward) )
+			dda_position[a] -= ( forward ) ? 1 : -1;
+		stepperAxisStep(a, false);
+		s->output += ( forward ) ? 1 : -1;
+
+		// Settling after a shaped block into one which isn't, the dda steps
+		// this axis too, and doesn't set its direction again
+		if ( ! stepperAxis[a].dda.shaped )
+			stepperAxis_dda_set_direction(a);
+	}
+}
+
+// Drops the steps still to come, so that the axes stop where they are
+
+static void shaper_flush() {
+	position_seq ++;
+	for ( uint8_t a = X_AXIS; a <= Y_AXIS; a ++ ) {
+		dda_position[a] -= (int16_t)(shaper_command[a] - shaper[a].output);
+		shaper_command[a] = shaper[a].output;
+		for ( uint8_t i = 0; i < INPUT_SHAPER_HISTORY; i ++ )
+			shaper_history[a][i] = shaper[a].output;
+	}
+	shaper_settling = 0;
+}
+
+void st_set_input_shaper(uint8_t axis, uint8_t type, float frequency, float damping) {
+	struct shaper_axis s;
+	s.impulses = 0;
+	s.delay[0] = 0;
+	s.gain[0] = 256;
+
+	if (( type != INPUT_SHAPER_OFF ) && ( frequency > 0.0 ) && ( damping >= 0.0 ) && ( damping < 1.0 )) {
+		// The impulses are half a damped period apart and cancel each other's ringing
+		float d = sqrt(1.0 - damping * damping);
+		float k = exp(-damping * M_PI / d);
+		float samples = 2000000.0 / (2.0 * frequency * d * SHAPER_SAMPLE_TICKS);
+		float g[3];
+		if ( type == INPUT_SHAPER_ZVD ) {
+			float sum = 1.0 + 2.0 * k + k * k;
+			g[1] = 2.0 * k / sum;
+			g[2] = k * k / sum;
+			s.impulses = 3;
+		} else {
+			g[1] = k / (1.0 + k);
+			s.impulses = 2;
+		}
+
+		// Shaping is left off if the history is too short for the delays
+		if (( samples * (s.impulses - 1) ) > (float)(INPUT_SHAPER_HISTORY - 1))
+			s.impulses = 0;
+		for ( uint8_t i = 1; i < s.impulses; i ++ ) {
+			s.delay[i] = (uint8_t)(samples * i + 0.5);
+			if ( s.delay[i] == 0 )	s.delay[i] = 1;
+			s.gain[i] = (uint16_t)(g[i] * 256.0 + 0.5);
+			s.gain[0] -= s.gain[i];
+		}
+	}
+
+	CRITICAL_SECTION_START;
+		s.output = shaper[axis].output;
+		shaper[axis] = s;
+		stepperAxis[axis].dda.shaped = false;
+		shaper_longest = 0;
+		for ( uint8_t a = X_AXIS; a <= Y_AXIS; a ++ )
+			if ( shaper[a].impulses && shaper[a].delay[shaper[a].impulses - 1] > shaper_longest )
+				shaper_longest = shaper[a].delay[shaper[a].impulses - 1];
+		shaper_flush();
+	CRITICAL_SECTION_END;
+}
+
+#endif
+
+
+
+#ifdef LIVE_Z_BABYSTEP
+
+// A change of the live Z offset is stepped out here straight away, rather than
+// waiting for the blocks already planned to run through.  st_babystep_z() moves
+// the planner's Z, and the starting positions of the blocks queued, by the same
+// steps, so the positions stay as they'd have been had the offset been in the
+// targets all along.  The steps go out while the block being stepped leaves Z
+// alone, no faster than Z's top speed.
+
+static volatile int16_t	babystep_pending;	// Z steps still to take, up when positive
+static uint16_t		babystep_ticks;		// Of the 2MHz timer, between them
+static uint16_t		babystep_clock;		// Ticks since the last
+static uint16_t		babystep_interval;	// Ticks since the last interrupt
+
+FORCE_INLINE void st_babystep() {
+	uint16_t clock = babystep_clock + babystep_interval;
+	babystep_clock = ( clock < babystep_clock ) ? 0xffff : clock;
+
+	if (( babystep_pending == 0 ) || ( babystep_clock < babystep_ticks ))	return;
+	if (( current_block != NULL ) && current_block->steps[Z_AXIS] )		return;
+
+	bool up = babystep_pending > 0;
+	stepperAxisSetDirection(Z_AXIS, up);
+	if ( stepperAxisStepWithEndstopCheck(Z_AXIS, up) )
+		dda_position[Z_AXIS] += ( up ) ? 1 : -1;
+	stepperAxisStep(Z_AXIS, false);
+	babystep_pending -= ( up ) ? 1 : -1;
+	babystep_clock = 0;
+
+	// The block doesn't step Z, but the next may expect its direction
+	stepperAxis_dda_set_direction(Z_AXIS);
+}
+
+void st_babystep_z(int16_t steps, uint16_t min_ticks)
+{
+	CRITICAL_SECTION_START;
+	plan_shift_z(steps);
+	if ( mark_pending )	mark_position[Z_AXIS] += steps;
+	babystep_pending += steps;
+	babystep_ticks = min_ticks;
+	CRITICAL_SECTION_END;
+}
+
+#endif
+
+
+
+// The shortest interval the speed factor may bring the timer down to, that of
+// the fastest interrupt rate calc_timer() ever asks for
+#define MIN_SCALED_INTERVAL	((uint16_t)(((uint32_t)F_CPU / 8) / TIMER_STEP_RATE_MAX))
+
+// A block planned at one speed factor plays at another by running through its
+// trapezoid in less or more time: the step rates are the planned ones, and so
+// are acceleration_time and deceleration_time, only the timer is scaled.  The
+// junctions between the blocks queued at the old factor keep matching, as all
+// of them are scaled alike; the speed jumps by the ratio of the factors where
+// the first block planned at the new one follows them.  The rates are at most
+// doubled, which keeps the accelerations within four times what the planner
+// allowed.
+FORCE_INLINE void update_interval_scale() {
+	uint16_t planned = current_block->speed_factor;
+
+	if (( planned == 0 ) || ( planned == live_speed_factor ))
+		interval_scale = 256;
+	else {
+		uint32_t scale = ((uint32_t)planned << 8) / live_speed_factor;
+		interval_scale = ( scale < 128 ) ? 128 : ( scale > 0xffff ) ? 0xffff : (uint16_t)scale;
+	}
+}
+
+// The timer interval for a planned one
+FORCE_INLINE uint16_t scaled_interval(uint16_t timer) {
+	if ( interval_scale == 256 )	return timer;
+
+	uint32_t scaled = ((uint32_t)timer * interval_scale) >> 8;
+	if ( scaled > 0xffff )			return 0xffff;
+	if ( scaled < MIN_SCALED_INTERVAL )	return MIN_SCALED_INTERVAL;
+	return (uint16_t)scaled;
+}
+
+#ifdef PRECOMPUTED_RAMPS
+
+uint16_t st_calc_timer(uint16_t step_rate, uint8_t *loops) {
+	return calc_timer_and_loops(step_rate, *loops);
+}
+
+
+
+// Switches the stepper timer to ramp segment "index" of the current block
+
+FORCE_INLINE void ramp_load_segment(uint8_t index) {
+	ramp_index = index;
+	step_loops = current_ramp->loops[index];
+	#ifdef DDA_OVERSAMPLE_BITS
+		STEPPER_OCRnA = scaled_interval(current_ramp->timer[index]) >> DDA_OVERSAMPLE_BITS;
+	#else
+		STEPPER_OCRnA = scaled_interval(current_ramp->timer[index]);
+	#endif
+}
+
+#endif
+
+
+
 // Sets up the next block from the buffer
 
 FORCE_INLINE void setup_next_block() {
 	//DEBUG_TIMER_START;
+#ifdef ISR_PROFILE
+	uint16_t profile_start = isr_profile_now();
+#endif
 
 	// Using this instead of memcpy saves 64 cycles
 	// starting_position is needed so that "definePosition" in Steppers.cc doesn't require a buffer drain before
 	// setting the position.  By including the starting_position in the block, we can make definePosition
 	// asynchronous
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-        dda_position[X_AXIS] = current_block->starting_position[X_AXIS] + current_block->starting_position[Y_AXIS];
-        dda_position[Y_AXIS] = current_block->starting_position[X_AXIS] - current_block->starting_position[Y_AXIS];
-	for ( uint8_t i = Z_AXIS; i < STEPPER_COUNT; i++ ) {
-		dda_position[i] = current_block->starting_position[i];
-	}
-#elif defined(CORE_XYZ)
-        dda_position[X_AXIS] = current_block->starting_position[Z_AXIS] + current_block->starting_position[Y_AXIS] + current_block->starting_position[X_AXIS];
-        dda_position[Y_AXIS] = current_block->starting_position[Z_AXIS] + current_block->starting_position[Y_AXIS] - current_block->starting_position[X_AXIS];
-        dda_position[Z_AXIS] = current_block->starting_position[Z_AXIS] - current_block->starting_position[Y_AXIS] - current_block->starting_position[X_AXIS];
+	block_cold_t *current_block_cold = &block_cold_buffer[block_buffer_tail];
+#if KINEMATICS_MIXED_MASK
+	Kinematics::toMotors(dda_position, current_block_cold->starting_position);
 	for ( uint8_t i = A_AXIS; i < STEPPER_COUNT; i++ ) {
-		dda_position[i] = current_block->starting_position[i];
+		dda_position[i] = current_block_cold->starting_position[i];
 	}
 #else
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ ) {
-		dda_position[i] = current_block->starting_position[i];
+		dda_position[i] = current_block_cold->starting_position[i];
 	}
 #endif
 
 	// Setup the next dda's and enabled axis
 	out_bits = current_block->direction_bits;
 
-#ifdef CORE_XY_STEPPER
-	// Clear the bits which indicate if the underlying X and Y axis are moving in the negative direction
-	// Shouldn't actually be necessary since the field was initialized to 0
-	// current_block->direction_bits &= ~( (1 << (X_AXIS + B_AXIS + 1)) | (1 << (Y_AXIS + B_AXIS + 1)) );
-
-	// Clear the direction bits for the Core-XY A and B axes
-	out_bits &= ~((1 << X_AXIS) | (1 << Y_AXIS));
+	update_interval_scale();
 
+#ifdef KINEMATICS_MIX_IN_STEPPER
+	// The block was planned in cartesian steps: mix them into those of the
+	// motors, and give the motors their directions.  The planner has already
+	// held all of the mixed motors if any of them moves
 	{
-	     int32_t asteps, bsteps, xsteps, ysteps;
-
-	     xsteps = current_block->steps[X_AXIS];
-	     ysteps = current_block->steps[Y_AXIS];
+	     int32_t cartesian[3], motors[3];
 
-	     // Determine the signs of X and Y
-	     if ( out_bits & (1 << X_AXIS) ) xsteps = -xsteps;
-	     if ( out_bits & (1 << Y_AXIS) ) ysteps = -ysteps;
+	     for ( uint8_t i = X_AXIS; i <= Z_AXIS; i++ )
+		  cartesian[i] = ( out_bits & (1 << i) ) ? - current_block->steps[i] : current_block->steps[i];
 
-	     asteps = xsteps + ysteps;
-	     bsteps = xsteps - ysteps;
+	     Kinematics::toMotors(motors, cartesian);
 
-	     // Now set the direction bits for the Core-XY A and B axes
-	     if ( asteps < 0 ) out_bits |= (1 << X_AXIS);
-	     if ( bsteps < 0 ) out_bits |= (1 << Y_AXIS);
-
-	     if (asteps > 0 && bsteps > 0) { out_bits |= 1 << (X_AXIS + B_AXIS + 1); }  // +X
-	     if (asteps > 0 && bsteps < 0) { out_bits |= 1 << (X_AXIS + B_AXIS + 1); }  // +Y
-
-	     // Ensure that both axes are enabled if either axes will be used
-	     if ( asteps != 0 || bsteps != 0 )
-		  // Need both steppers holding
-		  current_block->axesEnabled |= _BV(X_AXIS) | _BV(Y_AXIS);
-
-	     current_block->steps[X_AXIS] = labs(asteps);
-	     current_block->steps[Y_AXIS] = labs(bsteps);
+	     for ( uint8_t i = X_AXIS; i <= Z_AXIS; i++ ) {
+		  if ( ! ( KINEMATICS_MIXED_MASK & (1 << i) ) )
+		       continue;
+		  out_bits &= ~(1 << i);
+		  if ( motors[i] < 0 ) out_bits |= 1 << i;
+		  current_block->steps[i] = labs(motors[i]);
+	     }
+	     out_bits |= Kinematics::endstopDirections(motors) << (B_AXIS + 1);
 	}
 
 	{
@@ -359,12 +778,12 @@ FORCE_INLINE void setup_next_block() {
 					if ( extrude_when_negative[e] ) {
 						e_steps[e] -= extruder_deprime_steps[e];
 						#ifdef JKN_ADVANCE_LEAD_DE_PRIME
-							e_steps[e] -= current_block->advance_lead_prime;
+							e_steps[e] -= current_block_cold->advance_lead_prime;
 						#endif
 					} else {
 						e_steps[e] += extruder_deprime_steps[e];
 						#ifdef JKN_ADVANCE_LEAD_DE_PRIME
-							e_steps[e] += current_block->advance_lead_prime;
+							e_steps[e] += current_block_cold->advance_lead_prime;
 						#endif
 					}
 					deprimed[e] = false;
@@ -374,23 +793,52 @@ FORCE_INLINE void setup_next_block() {
 		}
 	#endif
 
+#ifdef AMASS_DDA
+	// Oversample the dda by as many bits as we can without the interrupt rate for the
+	// fastest part of the block (nominal_rate) exceeding AMASS_MAX_RATE.  Block rates
+	// above that aren't oversampled at all
+	amass_level = 0;
+	while (( amass_level < AMASS_MAX_LEVEL ) &&
+	       ( ((uint32_t)current_block->nominal_rate << (amass_level + 1)) <= AMASS_MAX_RATE ))
+		amass_level ++;
+	oversampledCount = 0;
+#endif
+
+#ifdef PRECOMPUTED_RAMPS
+	// The planner has done the timer calculations already
+	current_ramp = &block_ramp_buffer[block_buffer_tail];
+	OCRnA_nominal = current_ramp->nominal_timer;
+	step_loops_nominal = current_ramp->nominal_loops;
+
+	if ( current_block->use_accel ) {
+		ramp_next_step = current_ramp->accel_segment_steps;
+		ramp_load_segment(0);
+	} else {
+		step_loops = step_loops_nominal;
+		STEPPER_OCRnA = scaled_interval(OCRnA_nominal);
+	}
+#else
 	deceleration_time = 0;
 
 	OCRnA_nominal = calc_timer(current_block->nominal_rate);
 	step_loops_nominal = step_loops;
+	#ifdef ADAPTIVE_MULTISTEP
+		multistep_shift_nominal = multistep_shift;
+	#endif
 
 	if ( current_block->use_accel ) {
 		// step_rate to timer interval
 		acc_step_rate = current_block->initial_rate;
 		acceleration_time = calc_timer(acc_step_rate);
-		#ifdef OVERSAMPLED_DDA
-			STEPPER_OCRnA = acceleration_time >> OVERSAMPLED_DDA;
+		#ifdef DDA_OVERSAMPLE_BITS
+			STEPPER_OCRnA = scaled_interval(acceleration_time) >> DDA_OVERSAMPLE_BITS;
 		#else
-			STEPPER_OCRnA = acceleration_time;
+			STEPPER_OCRnA = scaled_interval(acceleration_time);
 		#endif
 	} else {
-		STEPPER_OCRnA = OCRnA_nominal;
+		STEPPER_OCRnA = scaled_interval(OCRnA_nominal);
 	}
+#endif
 
 	//if we have e_steps, re-enable the active extruders
 	uint8_t extruderOverriddenAxesEnabled = current_block->axesEnabled;
@@ -415,11 +863,28 @@ FORCE_INLINE void setup_next_block() {
 				(out_bits & (1 << B_AXIS)), current_block->steps[B_AXIS]);
 #endif
 
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-	stepperAxis_dda_reset_corexy(X_AXIS, out_bits & (1 << (X_AXIS + B_AXIS + 1)));
+	// The directions are set once for the block.  Even when this block's first
+	// step is taken in the same interrupt, the rest of the setup comes between,
+	// which is far longer than the drivers' direction setup time
+	stepperAxis_dda_set_direction(X_AXIS);
+	stepperAxis_dda_set_direction(Y_AXIS);
+	stepperAxis_dda_set_direction(Z_AXIS);
+	stepperAxis_dda_set_direction(A_AXIS);
 #if EXTRUDERS > 1
-	stepperAxis_dda_reset_corexy(Y_AXIS, out_bits & (1 << (Y_AXIS + B_AXIS + 1)));
+	stepperAxis_dda_set_direction(B_AXIS);
 #endif
+
+#ifdef INPUT_SHAPING
+	// Homing stops at the endstops as the dda reaches them
+	stepperAxis[X_AXIS].dda.shaped = shaper[X_AXIS].impulses && ! axis_homing[X_AXIS];
+	stepperAxis[Y_AXIS].dda.shaped = shaper[Y_AXIS].impulses && ! axis_homing[Y_AXIS];
+#endif
+
+#if KINEMATICS_MIXED_MASK
+	// The endstops of the mixed motors go by where the carriage heads
+	for ( uint8_t i = X_AXIS; i <= Z_AXIS; i++ )
+		if ( KINEMATICS_MIXED_MASK & (1 << i) )
+			stepperAxis_dda_reset_endstop(i, out_bits & (1 << (i + B_AXIS + 1)));
 #endif
 
 	#ifdef JKN_ADVANCE
@@ -434,33 +899,175 @@ FORCE_INLINE void setup_next_block() {
 		}
 	#endif
 
+#ifdef FLIGHT_RECORDER
+	flightrec::record(current_block);
+#endif
+
+#ifdef ISR_PROFILE
+	isr_profile_record(ISR_PROFILE_SETUP_NEXT_BLOCK, isr_profile_since(profile_start));
+#endif
+
 	//DEBUG_TIMER_FINISH;
 	//debug_onscreen1 = DEBUG_TIMER_TCTIMER_CYCLES;
 }
 
 
 
+// Done with the block at the tail: takes up the position marked for its end and
+// hands the actions read before the next block to the main loop
+
+FORCE_INLINE void finish_block() {
+	if ( mark_pending && mark_block == block_buffer_tail ) {
+		Kinematics::toMotors(dda_position, mark_position);
+		for ( uint8_t i = A_AXIS; i < STEPPER_COUNT; i++ )
+			dda_position[i] = mark_position[i];
+		last_active_toolhead = mark_toolhead;
+		mark_pending = false;
+	}
+	plan_action_ready = block_cold_buffer[block_buffer_tail].action_end;
+	current_block = NULL;
+	plan_discard_current_block();
+}
+
+
+
+#ifdef FAST_PAUSE
+
+// Decelerates current_block to a stop, at its acceleration, from the rate it was at when
+// st_request_stop() was called.  Unaccelerated blocks stop at once.
+
+FORCE_INLINE void stop_ramp() {
+	if ( stop_state == STOP_REQUESTED ) {
+		// The rate of the last interrupt: acc_step_rate holds at the end of the
+		// acceleration through to the start of the deceleration
+		stop_rate = ( deceleration_time ) ? step_rate : acc_step_rate;
+		stop_time = 0;
+		stop_state = STOP_DECELERATING;
+		#ifdef JKN_ADVANCE
+			advance_state = ADVANCE_STATE_PLATEAU;
+		#endif
+	}
+
+	uint16_t slowed = 0;
+	if ( current_block->use_accel )
+		MultiU24X24toH16(slowed, stop_time, current_block->acceleration_rate);
+	if (( ! current_block->use_accel ) || ( (uint32_t)slowed + STOP_RATE_MIN >= stop_rate )) {
+		stop_state = STOP_STOPPED;
+		STEPPER_OCRnA = 2000;
+		return;
+	}
+	stop_step_rate = stop_rate - slowed;
+
+	uint16_t timer = calc_timer(stop_step_rate);
+	#ifdef DDA_OVERSAMPLE_BITS
+		STEPPER_OCRnA = scaled_interval(timer) >> DDA_OVERSAMPLE_BITS;
+	#else
+		STEPPER_OCRnA = scaled_interval(timer);
+	#endif
+	stop_time += timer;
+}
+
+
+
+// Carries the deceleration on into the block after one which ended before the stop did.
+// final_rate is that of the block which ended.
+
+FORCE_INLINE void stop_next_block(uint16_t final_rate) {
+	// The blocks meet at the same speed, in steps of their own
+	uint32_t rate = ((uint32_t)stop_step_rate * current_block->initial_rate) / final_rate;
+
+	if (( ! current_block->use_accel ) || ( rate <= STOP_RATE_MIN )) {
+		// Stopped before it got going, it's left as it is
+		current_block = NULL;
+		stop_state = STOP_STOPPED;
+		STEPPER_OCRnA = 2000;
+		return;
+	}
+	if ( rate > current_block->nominal_rate )	rate = current_block->nominal_rate;
+
+	stop_rate = stop_step_rate = (uint16_t)rate;
+	stop_time = calc_timer(stop_rate);
+	#ifdef DDA_OVERSAMPLE_BITS
+		STEPPER_OCRnA = scaled_interval(stop_time) >> DDA_OVERSAMPLE_BITS;
+	#else
+		STEPPER_OCRnA = scaled_interval(stop_time);
+	#endif
+}
+
+#endif
+
+
+
+// Lowers the step pins raised by the last step event.  They're left high until
+// the next one, or the next interrupt, which gives them a pulse as wide as the
+// drivers need without waiting for it.  The input shaper and the extruder
+// interrupt pulse their pins themselves, so the dda's must be low before they do.
+// With STEP_DUAL_EDGE the pins are toggled instead, and there's nothing to lower.
+
+FORCE_INLINE void st_lower_steps() {
+#ifndef STEP_DUAL_EDGE
+	if ( steps_pulsed ) {
+		stepperAxisStepPorts(steps_pulsed, false);
+		steps_pulsed = 0;
+	}
+#endif
+}
+
+// Steps the dda for each axis, and raises the step pins of those which step together
+
+FORCE_INLINE void st_dda_step() {
+	uint8_t stepped = stepperAxis_dda_step(X_AXIS);
+	stepped |= stepperAxis_dda_step(Y_AXIS);
+	stepped |= stepperAxis_dda_step(Z_AXIS);
+	stepped |= stepperAxis_dda_step(A_AXIS);
+#if EXTRUDERS > 1
+	stepped |= stepperAxis_dda_step(B_AXIS);
+#endif
+	stepperAxisStepPorts(stepped, true);
+#ifndef STEP_DUAL_EDGE
+	steps_pulsed = stepped;
+#endif
+}
+
+
+
 // "The Stepper Driver Interrupt" - This timer interrupt is the workhorse.
 // It pops blocks from the block_buffer and executes them by pulsing the stepper pins appropriately.
 // Returns true if we deleted an item in the pipeline buffer
 
+#if defined(JKN_ADVANCE_UNIFIED_ISR) && !defined(JKN_ADVANCE)
+	#error "JKN_ADVANCE_UNIFIED_ISR requires JKN_ADVANCE"
+#endif
+
+#ifdef JKN_ADVANCE_UNIFIED_ISR
+FORCE_INLINE bool st_dda_interrupt() {
+#else
 bool st_interrupt() {
+#endif
 	//DEBUG_TIMER_START;
 	bool block_deleted = false;
 
-	#ifdef OVERSAMPLED_DDA
+	position_seq ++;
+	st_lower_steps();
+	stepperAxisLatchEndstops();
+
+	#ifdef INPUT_SHAPING
+		shaper_advance(shaper_interval);
+	#endif
+
+	#ifdef LIVE_Z_BABYSTEP
+		st_babystep();
+	#endif
+
+	#ifdef DDA_OVERSAMPLE_BITS
 		if ( current_block != NULL ) {
 			oversampledCount ++;
 
-			if ( oversampledCount < (1 << OVERSAMPLED_DDA) ) {
-				//Step the dda for each axis
-				stepperAxis_dda_step(X_AXIS);
-				stepperAxis_dda_step(Y_AXIS);
-				stepperAxis_dda_step(Z_AXIS);
-				stepperAxis_dda_step(A_AXIS);
-#if EXTRUDERS > 1
-				stepperAxis_dda_step(B_AXIS);
-#endif
+			if ( oversampledCount < (1 << DDA_OVERSAMPLE_BITS) ) {
+				#ifdef INPUT_SHAPING
+					st_shaper_step();
+				#endif
+				st_dda_step();
 				return block_deleted;
 			}
 		}
@@ -469,12 +1076,26 @@ bool st_interrupt() {
 	// If there is no current block, attempt to pop one from the buffer
 	if (current_block == NULL) {
 		// Anything in the buffer?
-		if (pipeline_ready)
+		if (pipeline_ready
+#ifdef FAST_PAUSE
+		    && ( stop_state == STOP_NONE )
+#endif
+#ifdef SD_DRY_RUN
+		    && ! st_dry_running
+#endif
+		   )
 			current_block = plan_get_current_block();
 
 		if (current_block != NULL) {
 			setup_next_block();
 		} else {
+#ifdef INPUT_SHAPING
+			// The shaped axes still have steps to come out
+			if ( shaper_pending() ) {
+				STEPPER_OCRnA = SHAPER_IDLE_TICKS;
+				st_shaper_step();
+			} else {
+#endif
 			STEPPER_OCRnA=2000; // 1kHz.
 
 			// Buffer is empty, because enabling/disabling axes doesn't require a block to be
@@ -489,6 +1110,9 @@ bool st_interrupt() {
 				)
 #endif
 				stepperAxisSetHardwareEnabledToMatch(axesEnabled);
+#ifdef INPUT_SHAPING
+			}
+#endif
 		}
 	}
 
@@ -519,6 +1143,8 @@ bool st_interrupt() {
 	if (current_block != NULL) {
 		// Take multiple steps per interrupt (For high speed moves)
 		for(int8_t i=0; i < step_loops; i++) {
+			st_lower_steps();
+
 			#ifdef JKN_ADVANCE
 				if ( current_block->use_accel ) {
 					for ( uint8_t e = 0; e < EXTRUDERS; e ++ ) {
@@ -533,15 +1159,13 @@ bool st_interrupt() {
 				}
 			#endif
 
-			//Step the dda for each axis
-			stepperAxis_dda_step(X_AXIS);
-			stepperAxis_dda_step(Y_AXIS);
-			stepperAxis_dda_step(Z_AXIS);
-			stepperAxis_dda_step(A_AXIS);
-#if EXTRUDERS > 1
-			stepperAxis_dda_step(B_AXIS);
-#endif
-			#ifdef OVERSAMPLED_DDA
+			#ifdef INPUT_SHAPING
+				st_shaper_step();
+			#endif
+
+			st_dda_step();
+
+			#ifdef DDA_OVERSAMPLE_BITS
 			oversampledCount = 0;
 			#endif
 
@@ -551,8 +1175,20 @@ bool st_interrupt() {
 		}
 
 		// Calculate new timer value
+#ifndef PRECOMPUTED_RAMPS
 		uint16_t timer;
+#endif
+#ifdef FAST_PAUSE
+		if ( stop_state != STOP_NONE )	stop_ramp();
+		else
+#endif
 		if (step_events_completed <= (uint32_t)current_block->accelerate_until) { // ACCELERATION PHASE
+#ifdef PRECOMPUTED_RAMPS
+			if (( step_events_completed >= ramp_next_step ) && ( ramp_index < (RAMP_SEGMENTS - 1) )) {
+				ramp_next_step += current_ramp->accel_segment_steps;
+				ramp_load_segment(ramp_index + 1);
+			}
+#else
 
 			// Note that we need to convert acceleration_time from units of
 			// 2 MHz to seconds.  That is done by dividing acceleration_time
@@ -562,21 +1198,29 @@ bool st_interrupt() {
 			// convenient to divide by 2^24 ( >> 24 ).  So, block->acceleration_rate
 			// has been prescaled by a factor of 8.388608.
 
+	#ifdef S_CURVE_ACCELERATION
+			acc_step_rate = current_block->initial_rate +
+				mul_u16_h16(current_block->accel_rate_change,
+					    s_curve_fraction(acceleration_time, current_block->accel_time_shift,
+							     current_block->accel_time_inverse));
+	#else
 			MultiU24X24toH16(acc_step_rate, acceleration_time, current_block->acceleration_rate);
 			acc_step_rate += current_block->initial_rate;
+	#endif
 
 			// upper limit
 			if (acc_step_rate > current_block->nominal_rate)	acc_step_rate = current_block->nominal_rate;
 
 			// step_rate to timer interval
 			timer = calc_timer(acc_step_rate);
-			#ifdef OVERSAMPLED_DDA
-				STEPPER_OCRnA = timer >> OVERSAMPLED_DDA;
+			#ifdef DDA_OVERSAMPLE_BITS
+				STEPPER_OCRnA = scaled_interval(timer) >> DDA_OVERSAMPLE_BITS;
 			#else
-				STEPPER_OCRnA = timer;
+				STEPPER_OCRnA = scaled_interval(timer);
 			#endif
 
 			acceleration_time += timer;
+#endif
 		}
 		else if (step_events_completed > (uint32_t)current_block->decelerate_after) {  // DECELERATION PHASE
 			#ifdef JKN_ADVANCE
@@ -590,6 +1234,16 @@ bool st_interrupt() {
 				advance_pressure_relax_accumulator += current_block->advance_pressure_relax;
 			#endif
 
+#ifdef PRECOMPUTED_RAMPS
+			if ( ramp_index < RAMP_SEGMENTS ) {
+				// First step of the deceleration
+				ramp_next_step = step_events_completed + current_ramp->decel_segment_steps;
+				ramp_load_segment(RAMP_SEGMENTS);
+			} else if (( step_events_completed >= ramp_next_step ) && ( ramp_index < (2 * RAMP_SEGMENTS - 1) )) {
+				ramp_next_step += current_ramp->decel_segment_steps;
+				ramp_load_segment(ramp_index + 1);
+			}
+#else
 			// Note that we need to convert deceleration_time from units of
 			// 2 MHz to seconds.  That is done by dividing deceleration_time
 			// by 2000000.  But, that will make it 0 when we use integer
@@ -598,7 +1252,17 @@ bool st_interrupt() {
 			// convenient to divide by 2^24 ( >> 24 ).  So, block->acceleration_rate
 			// has been prescaled by a factor of 8.388608.
 
+	#ifdef S_CURVE_ACCELERATION
+			// The S-curve runs from wherever the acceleration got to
+			if ( acc_step_rate > current_block->final_rate )
+				step_rate = mul_u16_h16(acc_step_rate - (uint16_t)current_block->final_rate,
+							s_curve_fraction(deceleration_time, current_block->decel_time_shift,
+									 current_block->decel_time_inverse));
+			else
+				step_rate = acc_step_rate + 1;
+	#else
 			MultiU24X24toH16(step_rate, deceleration_time, current_block->acceleration_rate);
+	#endif
 
 			if(step_rate > acc_step_rate) { // Check step_rate stays positive
 				step_rate = current_block->final_rate;
@@ -610,13 +1274,14 @@ bool st_interrupt() {
 
 			// step_rate to timer interval
 			timer = calc_timer(step_rate);
-			#ifdef OVERSAMPLED_DDA
-				STEPPER_OCRnA = timer >> OVERSAMPLED_DDA;
+			#ifdef DDA_OVERSAMPLE_BITS
+				STEPPER_OCRnA = scaled_interval(timer) >> DDA_OVERSAMPLE_BITS;
 			#else
-				STEPPER_OCRnA = timer;
+				STEPPER_OCRnA = scaled_interval(timer);
 			#endif
 
 			deceleration_time += timer;
+#endif
 		} else {	//NOMINAL PHASE
 			#ifdef JKN_ADVANCE
 				if ( advance_state == ADVANCE_STATE_ACCEL ) {
@@ -624,10 +1289,18 @@ bool st_interrupt() {
 				}
 			#endif
 
-			#ifdef OVERSAMPLED_DDA
-				STEPPER_OCRnA = OCRnA_nominal >> OVERSAMPLED_DDA;
+			#ifdef ADAPTIVE_MULTISTEP
+				if ( multistep_shift != multistep_shift_nominal ) {
+					OCRnA_nominal = calc_timer(current_block->nominal_rate);
+					step_loops_nominal = step_loops;
+					multistep_shift_nominal = multistep_shift;
+				}
+			#endif
+
+			#ifdef DDA_OVERSAMPLE_BITS
+				STEPPER_OCRnA = scaled_interval(OCRnA_nominal) >> DDA_OVERSAMPLE_BITS;
 			#else
-				STEPPER_OCRnA = OCRnA_nominal;
+				STEPPER_OCRnA = scaled_interval(OCRnA_nominal);
 			#endif
 
 			step_loops = step_loops_nominal;
@@ -637,22 +1310,60 @@ bool st_interrupt() {
 		if (step_events_completed >= current_block->step_event_count) {
 			#ifdef JKN_ADVANCE_LEAD_DE_PRIME
 				for ( uint8_t e = 0; e < EXTRUDERS; e ++ ) {
-					lastAdvanceDeprime[e] = current_block->advance_lead_deprime;
+					lastAdvanceDeprime[e] = block_cold_buffer[block_buffer_tail].advance_lead_deprime;
 				}
 			#endif
 
-			current_block = NULL;
-			plan_discard_current_block();
+#ifdef FAST_PAUSE
+			uint16_t final_rate = (uint16_t)current_block->final_rate;
+#endif
+			finish_block();
 			block_deleted = true;
 
-			// Preprocess the setup for the next block if have have one
+			// Preprocess the setup for the next block if have have one, unless stopping
+			// brought us to a halt
+#ifdef FAST_PAUSE
+			if ( stop_state != STOP_STOPPED )
+#endif
 			current_block = plan_get_current_block();
 			if (current_block != NULL) {
 				setup_next_block();
+#ifdef FAST_PAUSE
+				if ( stop_state == STOP_DECELERATING )	stop_next_block(final_rate);
+#endif
 			}
+#ifdef UNDERRUN_STATS
+			else st_drained++;
+#endif
 		}
+#ifdef FAST_PAUSE
+		else if ( stop_state == STOP_STOPPED ) {
+			// Halted part way, the block stays at the tail for plan_park()
+			current_block = NULL;
+			stopped_in_block = true;
+		}
+#endif
+
+		#ifdef ADAPTIVE_MULTISTEP
+			// The timer is reset on the compare match, so it holds the number of timer ticks
+			// since this interrupt became due.  Take more steps per interrupt if we used more than
+			// half of the interval to the next interrupt, and fewer if we used less than an eighth.
+			// The gap between the two keeps it from toggling as halving the steps per interrupt
+			// also halves the interval.
+			uint16_t elapsed = STEPPER_TCNTn;
+			uint16_t interval = STEPPER_OCRnA;
+			if (( elapsed > (interval >> 1) ) && ( multistep_shift < 3 ))		multistep_shift ++;
+			else if (( elapsed < (interval >> 3) ) && ( multistep_shift > 0 ))	multistep_shift --;
+		#endif
 	}
 
+	#ifdef INPUT_SHAPING
+		shaper_interval = STEPPER_OCRnA;
+	#endif
+	#ifdef LIVE_Z_BABYSTEP
+		babystep_interval = STEPPER_OCRnA;
+	#endif
+
 	//DEBUG_TIMER_FINISH;
 	//debug_onscreen2 = DEBUG_TIMER_TCTIMER_CYCLES;
 
@@ -680,16 +1391,14 @@ void st_extruder_interrupt()
 		     (i < extruder_interrupt_steps_per_call[0]); i ++ ) {
 
 		stepperAxisStep(A_AXIS, false);
-		if (e_steps[0] < 0) {
-			stepperAxisSetDirection(A_AXIS, false);
-			e_steps[0]++;
-			stepperAxisStep(A_AXIS, true);
-		}
-		else if (e_steps[0] > 0) {
-			stepperAxisSetDirection(A_AXIS, true);
-			e_steps[0]--;
-			stepperAxisStep(A_AXIS, true);
+		int8_t dir = ( e_steps[0] < 0 ) ? -1 : 1;
+		if ( dir != e_direction[0] ) {
+			stepperAxisSetDirection(A_AXIS, dir > 0);
+			e_direction[0] = dir;
+			_delay_us(EXTRUDER_DIR_SETUP_US);
 		}
+		e_steps[0] -= dir;
+		stepperAxisStep(A_AXIS, true);
 
 		st_extruder_interrupt_rate_counter[0] = 0;
 	}
@@ -701,16 +1410,14 @@ void st_extruder_interrupt()
 		     (i < extruder_interrupt_steps_per_call[1]); i ++ ) {
 
 		stepperAxisStep(B_AXIS, false);
-		if (e_steps[1] < 0) {
-			stepperAxisSetDirection(B_AXIS, false);
-			e_steps[1]++;
-			stepperAxisStep(B_AXIS, true);
-		}
-		else if (e_steps[1] > 0) {
-			stepperAxisSetDirection(B_AXIS, true);
-			e_steps[1]--;
-			stepperAxisStep(B_AXIS, true);
+		int8_t dir = ( e_steps[1] < 0 ) ? -1 : 1;
+		if ( dir != e_direction[1] ) {
+			stepperAxisSetDirection(B_AXIS, dir > 0);
+			e_direction[1] = dir;
+			_delay_us(EXTRUDER_DIR_SETUP_US);
 		}
+		e_steps[1] -= dir;
+		stepperAxisStep(B_AXIS, true);
 
 		st_extruder_interrupt_rate_counter[1] = 0;
 	}
@@ -718,17 +1425,65 @@ void st_extruder_interrupt()
 #endif
 }
 
+#ifdef JKN_ADVANCE_UNIFIED_ISR
+
+// The dda and st_extruder_interrupt() share the stepper interrupt.  Each has its own
+// deadline in stepper timer ticks, and the timer is set for whichever is due first.
+// When both are due, the dda goes first.
+
+#define ADVANCE_INTERVAL_TICKS	(2000000 / ADVANCE_INTERRUPT_FREQUENCY)	// 2MHz stepper timer
+#define UNIFIED_MIN_TICKS	32					// 16us
+
+static uint16_t	unified_interval;				// Timer interval ending at this interrupt
+static uint16_t	dda_ticks_remaining;				// Ticks until the dda is next due
+static uint16_t	advance_ticks_remaining = ADVANCE_INTERVAL_TICKS;	// Ticks until st_extruder_interrupt is next due
+
+bool st_interrupt() {
+	bool block_deleted = false;
+	uint16_t elapsed = unified_interval;
+
+	if ( dda_ticks_remaining <= elapsed ) {
+		block_deleted = st_dda_interrupt();
+		dda_ticks_remaining = STEPPER_OCRnA;	// The dda's next interval
+	} else	dda_ticks_remaining -= elapsed;
+
+	if ( advance_ticks_remaining <= elapsed ) {
+		st_extruder_interrupt();
+
+		// Keep to the advance interrupt frequency if we were late, unless we're
+		// so late that we've missed a whole interval, in which case it's dropped
+		uint16_t late = elapsed - advance_ticks_remaining;
+		advance_ticks_remaining = ( late < ADVANCE_INTERVAL_TICKS ) ? ADVANCE_INTERVAL_TICKS - late : ADVANCE_INTERVAL_TICKS;
+	} else	advance_ticks_remaining -= elapsed;
+
+	uint16_t next = ( dda_ticks_remaining < advance_ticks_remaining ) ? dda_ticks_remaining : advance_ticks_remaining;
+	if ( next < UNIFIED_MIN_TICKS )	next = UNIFIED_MIN_TICKS;
+	STEPPER_OCRnA = next;
+	unified_interval = next;
+
+	return block_deleted;
+}
+
+#endif
+
 #endif // JKN_ADVANCE
 
 
 
 void st_init()
 {
-	#ifdef OVERSAMPLED_DDA
+	#ifdef DDA_OVERSAMPLE_BITS
 		oversampledCount = 0;
 	#endif
 
 	last_active_toolhead = 0;
+	mark_pending = false;
+
+	#ifdef JKN_ADVANCE_UNIFIED_ISR
+		unified_interval = 0;
+		dda_ticks_remaining = 0;
+		advance_ticks_remaining = ADVANCE_INTERVAL_TICKS;
+	#endif
 
 	#ifdef JKN_ADVANCE
 		// Calculate the smallest number of st_extruder_interrupt's between extruder steps based on the
@@ -774,19 +1529,9 @@ void st_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 #endif
 {
 	CRITICAL_SECTION_START;
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-	dda_position[X_AXIS] = x + y;
-	dda_position[Y_AXIS] = x - y;
-	dda_position[Z_AXIS] = z;
-#elif defined(CORE_XYZ)
-	dda_position[X_AXIS] = z + y + x;
-	dda_position[Y_AXIS] = z + y - x;
-	dda_position[Z_AXIS] = z - y - x;
-#else
-	dda_position[X_AXIS] = x;
-	dda_position[Y_AXIS] = y;
-	dda_position[Z_AXIS] = z;
-#endif
+	int32_t cartesian[3] = { x, y, z };
+	position_seq ++;
+	Kinematics::toMotors(dda_position, cartesian);
 	dda_position[A_AXIS] = a;
 #if EXTRUDERS > 1
 	dda_position[B_AXIS] = b;
@@ -794,6 +1539,24 @@ void st_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 	CRITICAL_SECTION_END;
 }
 
+void st_mark_position(uint8_t block_index, const int32_t *position, uint8_t toolhead)
+{
+	CRITICAL_SECTION_START;
+	if ( blocks_queued() ) {
+		mark_block = block_index;
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			mark_position[i] = position[i];
+		mark_toolhead = toolhead;
+		mark_pending = true;
+	} else {
+		st_set_position(STEPPERS_(position[X_AXIS], position[Y_AXIS], position[Z_AXIS],
+					  position[A_AXIS], position[B_AXIS]));
+		last_active_toolhead = toolhead;
+		mark_pending = false;
+	}
+	CRITICAL_SECTION_END;
+}
+
 #if EXTRUDERS > 1
 void st_set_e_position(const int32_t &a, const int32_t &b)
 #else
@@ -801,6 +1564,7 @@ void st_set_e_position(const int32_t &a)
 #endif
 {
 	CRITICAL_SECTION_START;
+	position_seq ++;
 	dda_position[A_AXIS] = a;
 #if EXTRUDERS > 1
 	dda_position[B_AXIS] = b;
@@ -808,6 +1572,28 @@ void st_set_e_position(const int32_t &a)
 	CRITICAL_SECTION_END;
 }
 
+// Copies dda_position[] and the toolhead, both as of one moment
+static void st_snapshot_position(int32_t *motors, uint8_t *active_toolhead)
+{
+	for ( uint8_t tries = 0; ; tries ++ ) {
+		uint8_t seq = position_seq;
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			motors[i] = dda_position[i];
+		*active_toolhead = last_active_toolhead;
+		if ( seq == position_seq )	return;
+
+		// Fast steps could keep interrupting the copy, so in the end
+		// hold them off for it
+		if ( tries == POSITION_SNAPSHOT_TRIES - 1 )	break;
+	}
+
+	CRITICAL_SECTION_START;
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+		motors[i] = dda_position[i];
+	*active_toolhead = last_active_toolhead;
+	CRITICAL_SECTION_END;
+}
+
 #if EXTRUDERS > 1
 void st_get_position(int32_t *x, int32_t *y, int32_t *z,
 					 int32_t *a, int32_t *b, uint8_t *active_toolhead)
@@ -816,28 +1602,100 @@ void st_get_position(int32_t *x, int32_t *y, int32_t *z,
 					 int32_t *a, uint8_t *active_toolhead)
 #endif
 {
-	CRITICAL_SECTION_START;
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-	*x = (dda_position[X_AXIS] + dda_position[Y_AXIS]) / 2;
-	*y = (dda_position[X_AXIS] - dda_position[Y_AXIS]) / 2;
-	*z = dda_position[Z_AXIS];
-#elif defined(CORE_XYZ)
-	*x = (dda_position[X_AXIS] - dda_position[Y_AXIS]) / 2;
-	*y = (dda_position[Y_AXIS] - dda_position[Z_AXIS]) / 2;
-	*z = (dda_position[Z_AXIS] + dda_position[X_AXIS]) / 2;
-#else
-	*x = dda_position[X_AXIS];
-	*y = dda_position[Y_AXIS];
-	*z = dda_position[Z_AXIS];
-#endif
-	*a = dda_position[A_AXIS];
+	int32_t motors[STEPPER_COUNT];
+	int32_t cartesian[3];
+
+	st_snapshot_position(motors, active_toolhead);
+	Kinematics::toCartesian(cartesian, motors);
+	*x = cartesian[X_AXIS];
+	*y = cartesian[Y_AXIS];
+	*z = cartesian[Z_AXIS];
+	*a = motors[A_AXIS];
 #if EXTRUDERS > 1
-	*b = dda_position[B_AXIS];
+	*b = motors[B_AXIS];
 #endif
-	*active_toolhead = last_active_toolhead;
+}
+
+void st_set_speed_factor(uint16_t factor)
+{
+	CRITICAL_SECTION_START;
+	live_speed_factor = factor;
+	if ( current_block != NULL )	update_interval_scale();
+	CRITICAL_SECTION_END;
+}
+
+#ifdef FAST_PAUSE
+
+void st_request_stop()
+{
+	CRITICAL_SECTION_START;
+	if ( stop_state == STOP_NONE ) {
+		stopped_in_block = false;
+		stop_state = ( current_block != NULL ) ? STOP_REQUESTED : STOP_STOPPED;
+	}
+	CRITICAL_SECTION_END;
+}
+
+bool st_stopped(bool *in_block)
+{
+	*in_block = stopped_in_block;
+	return stop_state == STOP_STOPPED;
+}
+
+void st_resume()
+{
+	CRITICAL_SECTION_START;
+	stop_state = STOP_NONE;
+	stopped_in_block = false;
 	CRITICAL_SECTION_END;
 }
 
+#endif
+
+#ifdef SD_DRY_RUN
+
+void st_dry_run(bool on)
+{
+	DISABLE_STEPPER_DRIVER_INTERRUPT();
+
+	if ( on ) {
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			dry_run_position[i] = dda_position[i];
+		dry_run_toolhead = last_active_toolhead;
+	} else {
+		// None of the moves were made, so the motors are still where they started
+		while ( blocks_queued() )	plan_discard_current_block();
+		current_block = NULL;
+		mark_pending = false;
+
+		CRITICAL_SECTION_START;
+		position_seq ++;
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			dda_position[i] = dry_run_position[i];
+		last_active_toolhead = dry_run_toolhead;
+		CRITICAL_SECTION_END;
+	}
+	st_dry_running = on;
+
+	ENABLE_STEPPER_DRIVER_INTERRUPT();
+}
+
+bool st_dry_run_block(uint32_t *ms)
+{
+	if ( ! pipeline_ready )		return false;
+	block_t *block = plan_get_current_block();
+	if ( block == NULL )		return false;
+
+	*ms = plan_block_time_ms(block);
+	CRITICAL_SECTION_START;
+	position_seq ++;
+	finish_block();
+	CRITICAL_SECTION_END;
+	return true;
+}
+
+#endif
+
 void quickStop()
 {
 	DISABLE_STEPPER_DRIVER_INTERRUPT();
@@ -845,21 +1703,23 @@ void quickStop()
 		while(blocks_queued())	plan_discard_current_block();
 
 		current_block = NULL;
+		mark_pending = false;
+		plan_drop_actions();
+#ifdef FAST_PAUSE
+		stop_state = STOP_NONE;
+		stopped_in_block = false;
+#endif
 
 		CRITICAL_SECTION_START;
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-		planner_position[X_AXIS] = (dda_position[X_AXIS] + dda_position[Y_AXIS]) / 2;
-		planner_position[Y_AXIS] = (dda_position[X_AXIS] - dda_position[Y_AXIS]) / 2;
-		planner_position[Z_AXIS] = dda_position[Z_AXIS];
-#elif defined(CORE_XYZ)
-		planner_position[X_AXIS] = (dda_position[X_AXIS] - dda_position[Y_AXIS]) / 2;
-		planner_position[Y_AXIS] = (dda_position[Y_AXIS] - dda_position[Z_AXIS]) / 2;
-		planner_position[Z_AXIS] = (dda_position[Z_AXIS] + dda_position[X_AXIS]) / 2;
-#else
-		planner_position[X_AXIS] = dda_position[X_AXIS];
-		planner_position[Y_AXIS] = dda_position[Y_AXIS];
-		planner_position[Z_AXIS] = dda_position[Z_AXIS];
+#ifdef INPUT_SHAPING
+		shaper_flush();
+#endif
+#ifdef LIVE_Z_BABYSTEP
+		// The offset is still in the targets to come, so the next move takes
+		// up what wasn't stepped
+		babystep_pending = 0;
 #endif
+		Kinematics::toCartesian(planner_position, dda_position);
 		planner_position[A_AXIS] = dda_position[A_AXIS];
 #if EXTRUDERS > 1
 		planner_position[B_AXIS] = dda_position[B_AXIS];
@@ -31,8 +31,6 @@
 #include "Steppers.hh"
 #include "StepperAccelPlanner.hh"
 
-#define MAX_STEP_FREQUENCY 40000
-
 //Enables the debug timer.  The timer can detected upto 4ms before overflowing.
 //Example usage:
 //	DEBUG_TIMER_START;
@@ -67,6 +65,23 @@
 	#define LOOKUP_TABLE_TIMER
 #endif
 
+//If defined, the number of steps taken per stepper interrupt (1, 2, 4 or 8) is chosen from the
+//measured time the interrupt takes compared to the interval until the next interrupt, instead of
+//from the fixed STEP_RATE_LOW/MED/HIGH step rate thresholds.  Moves slower than
+//ADAPTIVE_MULTISTEP_MIN_RATE steps/s per interrupt are never multi-stepped.
+//#define ADAPTIVE_MULTISTEP
+
+#ifdef ADAPTIVE_MULTISTEP
+	#ifndef ADAPTIVE_MULTISTEP_MIN_RATE
+		#define ADAPTIVE_MULTISTEP_MIN_RATE 2432
+	#endif
+	#ifdef PRECOMPUTED_RAMPS
+		#error "ADAPTIVE_MULTISTEP can't be used with PRECOMPUTED_RAMPS, the ramps are computed ahead of time"
+	#endif
+#endif
+
+#include "StepperAccelRates.hh"
+
 #ifndef CRITICAL_SECTION_START
 	#define CRITICAL_SECTION_START  unsigned char _sreg = SREG; cli();
 	#define CRITICAL_SECTION_END    SREG = _sreg;
@@ -78,6 +93,10 @@ void st_init();
 // Returns true is there are no buffered steps to be executed
 bool st_empty();
 
+// Has the stepper interrupt take up the position, in cartesian steps, and the toolhead
+// as it finishes the block in slot block_index.  Straight away if no blocks are queued
+void st_mark_position(uint8_t block_index, const int32_t *position, uint8_t toolhead);
+
 #if EXTRUDERS > 1
 void st_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 					 const int32_t &a, const int32_t &b);
@@ -98,8 +117,65 @@ bool st_interrupt();
 void st_extruder_interrupt();
 
 void quickStop();
+
+// Sets the speed factor, 8.8, which the blocks planned under it are stepped at
+// from now on, including the one being stepped.  Those planned at another
+// factor are stepped at most twice as fast as planned
+void st_set_speed_factor(uint16_t factor);
+
+#ifdef FAST_PAUSE
+// Brings the steppers to a stop part way through the block being stepped, decelerating from
+// the rate it's at, or straight away when there isn't one.  No blocks are picked up from the
+// buffer after that until st_resume().
+void st_request_stop();
+
+// Returns true once the steppers have stopped; *in_block is set when the block at the tail
+// of the buffer was left part way through
+bool st_stopped(bool *in_block);
+
+void st_resume();
+#endif
+
+#ifdef SD_DRY_RUN
+// With on, blocks are left for st_dry_run_block() instead of being stepped, and the
+// position of the motors is put aside; with it off, the blocks are dropped and the
+// position taken up again
+void st_dry_run(bool on);
+
+// Takes the block at the tail as though it had been stepped, setting *ms to the time
+// its trapezoid takes.  False if there isn't one ready.
+bool st_dry_run_block(uint32_t *ms);
+#endif
+
+#ifdef INPUT_SHAPING
+#define INPUT_SHAPER_OFF	0
+#define INPUT_SHAPER_ZV		1
+#define INPUT_SHAPER_ZVD	2
+
+// Sets the input shaper of X or Y for a resonance at frequency Hz with the damping
+// ratio given.  Whatever steps of the axis are still to come out are dropped.
+void st_set_input_shaper(uint8_t axis, uint8_t type, float frequency, float damping);
+#endif
+
+#ifdef LIVE_Z_BABYSTEP
+// Moves Z by steps now, at least min_ticks of the stepper timer apart, along with the
+// planner's position and that of the blocks queued
+void st_babystep_z(int16_t steps, uint16_t min_ticks);
+#endif
+
+#ifdef PRECOMPUTED_RAMPS
+// Converts a step rate to a stepper timer value and multi-step count for the planner.
+// Unlike calc_timer(), this doesn't change the state of the stepper interrupt.
+uint16_t st_calc_timer(uint16_t step_rate, uint8_t *loops);
+#endif
   
 extern volatile bool		pipeline_ready;
+#ifdef UNDERRUN_STATS
+extern volatile uint8_t		st_drained;	// Counts blocks finished with none after them
+#endif
+#ifdef SD_DRY_RUN
+extern volatile bool		st_dry_running;	// Set by st_dry_run()
+#endif
 extern block_t	*current_block;  // A pointer to the block currently being traced
 extern bool     extruder_deprime_travel;
 extern int16_t	extruder_deprime_steps[EXTRUDERS];
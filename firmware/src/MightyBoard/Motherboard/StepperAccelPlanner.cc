@@ -68,6 +68,7 @@
 #include "Configuration.hh"
 #include "StepperAccel.hh"
 #include "StepperAccelPlanner.hh"
+#include "Xmem.hh"
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
@@ -97,14 +98,36 @@
 #endif
 
 volatile bool		pipeline_ready = true;
+#ifdef PINNED_KINEMATICS
+const uint32_t	max_acceleration_units_per_sq_second[STEPPER_COUNT] = PINNED_AXES(PINNED_MAX_ACCELERATION);
+#else
 uint32_t	max_acceleration_units_per_sq_second[STEPPER_COUNT];	// Use M201 to override by software
+#endif
 FPTYPE		smallest_max_speed_change;
 FPTYPE		max_speed_change[STEPPER_COUNT];			//The speed between junctions in the planner, reduces blobbing
+FPTYPE		junction_deviation = 0;					//mm, 0 to use max_speed_change for X, Y and Z too
 FPTYPE		minimumPlannerSpeed;
 uint8_t 	slowdown_limit;
+FPTYPE		extruder_max_extrusion_speed[EXTRUDERS];		//mm/s of filament when extruding on a printing move, 0 for no limit
+FPTYPE		planner_hint_speed = 0;					//mm/s, from HOST_CMD_PLANNER_HINT for the next block, 0 for none
+bool		planner_hint_nominal_length;
+
+// The ring of actions.  Those from plan_action_tail up to plan_action_ready may be taken,
+// those from there up to plan_action_head are waiting for their blocks
+static plan_action_t	plan_actions[PLAN_ACTIONS];
+static uint8_t		plan_action_head;
+static uint8_t		plan_action_tail;
+volatile uint8_t	plan_action_ready;
+
+// Fails to compile unless PLAN_ACTIONS is a power of two which the indices can count up to
+typedef char plan_actions_check[((PLAN_ACTIONS & (PLAN_ACTIONS - 1)) == 0 && PLAN_ACTIONS <= 128) ? 1 : -1];
 
 bool		disable_slowdown = true;
+#ifdef PINNED_KINEMATICS
+const uint32_t	axis_steps_per_sqr_second[STEPPER_COUNT] = PINNED_AXES(PINNED_STEPS_PER_SQR_SECOND);
+#else
 uint32_t	axis_steps_per_sqr_second[STEPPER_COUNT];
+#endif
 
 #ifdef JKN_ADVANCE
 FPTYPE	extruder_advance_k = 0, extruder_advance_k2 = 0;
@@ -113,16 +136,19 @@ FPTYPE	extruder_advance_k = 0, extruder_advance_k2 = 0;
 uint8_t         planner_axes;
 FPTYPE		delta_mm[STEPPER_COUNT];
 FPTYPE		planner_distance;
+uint16_t	planner_speed_factor;		// block_t.speed_factor for the next block
 uint32_t	planner_master_steps;
 uint8_t		planner_master_steps_index;
 int32_t		planner_steps[STEPPER_COUNT];
 FPTYPE		vmax_junction;
+#ifdef PINNED_KINEMATICS
+const uint32_t	axis_accel_step_cutoff[STEPPER_COUNT] = PINNED_AXES(PINNED_ACCEL_STEP_CUTOFF);
+#else
 uint32_t	axis_accel_step_cutoff[STEPPER_COUNT];
+#endif
 
-#ifdef CORE_XY
-int32_t         delta_ab[2];
-#elif CORE_XYZ
-int32_t         delta_ab[3];
+#ifdef KINEMATICS_MIX_IN_PLANNER
+int32_t         delta_ab[3];		// The move of the X, Y and Z motors
 #endif
 
 // minimum time in seconds that a movement needs to take if the buffer is emptied.
@@ -131,13 +157,64 @@ int32_t         delta_ab[3];
 // Comment out to disable
 FPTYPE		minimumSegmentTime;
 
+// Reciprocals of the settings plan_buffer_line() would otherwise divide by
+// for every block.  plan_init() works them out, as steppers::reset() loads
+// the settings.
+static FPTYPE	inverse_minimum_segment_time;
+static FPTYPE	inverse_slowdown_limit;
+
+// For each axis as the master, the other axes with a lower acceleration
+// limit.  Only those can hold a block's acceleration below the master's, so
+// plan_buffer_line() needn't check the rest.
+static uint8_t	accel_limiting_axes[STEPPER_COUNT];
+
+#ifdef TRAVEL_ACCELERATION
+// The same for moves which don't extrude, from the travel profile
+uint32_t	travel_steps_per_sqr_second[STEPPER_COUNT];
+uint32_t	travel_accel_step_cutoff[STEPPER_COUNT];
+FPTYPE		travel_junction_deviation = 0;
+static uint8_t	travel_limiting_axes[STEPPER_COUNT];
+#endif
+
+// How fast the blocks are coming in while the planner is short of them: the
+// time between them, averaged, in 100 microsecond units.  0 until it's been
+// measured, and always in the simulator, which has no clock to measure it
+// by.  The slowdown and the minimum segment time go by it, so that blocks
+// aren't slowed when more are on their way in time anyway.
+#define PLAN_ARRIVAL_MAX	30000		// 3 s, held below FPTYPE's limit
+static int32_t	plan_arrival_centa;
+#ifndef SIMULATOR
+static micros_t	plan_arrival_last;
+static bool	plan_arrival_hungry;		// The last block came in with the planner short of blocks
+#endif
+
 // The current position of the tool in absolute steps
 int32_t		planner_position[STEPPER_COUNT];			//rescaled from extern when axisStepsPerMM are changed by gcode
 int32_t		planner_target[STEPPER_COUNT];
+static uint8_t	planner_toolhead;					//The toolhead of the last block queued, or of plan_set_toolhead()
 
 static FPTYPE	prev_speed[STEPPER_COUNT];
 static FPTYPE   prev_final_speed = 0;
 
+// Axes for which prev_speed[] may be non-zero.  Axes outside of this mask and
+// planner_axes have zero speed in both blocks and are skipped by the jerk code.
+#define ALL_AXES_MASK	((1 << STEPPER_COUNT) - 1)
+static uint8_t	prev_speed_axes = 0;
+
+// Unit vector of the previous block's X, Y and Z motion, for the junction
+// deviation model, and that block's nominal speed.  prev_jd_speed is 0 when
+// there's no previous accelerated move to corner from.
+#define XYZ_AXES_MASK	((1 << X_AXIS) | (1 << Y_AXIS) | (1 << Z_AXIS))
+static FPTYPE	prev_unit[Z_AXIS + 1];
+static FPTYPE	prev_jd_speed = 0;
+
+// Loops over the axes in mask only.  The loop ends with the highest set bit, so
+// an XY move only visits X and Y and, as STEPPER_COUNT is a compile time
+// constant, single extruder builds never consider B.
+#define FOR_EACH_AXIS(i, mask) \
+	for ( uint8_t i = 0, _axis_mask = (mask) & ALL_AXES_MASK; _axis_mask; i ++, _axis_mask >>= 1 ) \
+		if ( _axis_mask & 1 )
+
 #ifdef SIMULATOR
 static block_t	*sblock = NULL;
 #endif
@@ -193,13 +270,53 @@ static int16_t isqrt1(int16_t value)
 	return result;
 }
 
+#elif defined(SIMULATOR)
+
+#define isqrt1(x) ((int32_t)sqrt((float)(x)))
+
 #endif
 
+// The float is taken apart rather than multiplied out: its 24 bit mantissa
+// is shifted into place by the exponent, less the 23 bits of it which are
+// fraction and plus the 16 of FPTYPE.
+FPTYPE plan_float_to_fp(float f) {
+#ifdef FIXED
+	union {
+		float		f;
+		uint32_t	u;
+	} bits;
+	bits.f = f;
+
+	int16_t exponent = (int16_t)((bits.u >> 23) & 0xff) - 127;
+	if ( exponent < -16 )	return 0;		// Smaller than FPTYPE resolves, or zero
+	if ( exponent >= 15 )					// 32768 or more, or not a number
+		return ( bits.u & 0x80000000UL ) ? (FPTYPE)-0x7fffffffL : (FPTYPE)0x7fffffffL;
+
+	uint32_t mantissa = (bits.u & 0x007fffffUL) | 0x00800000UL;
+	int8_t shift = (int8_t)(exponent - 7);
+	FPTYPE result = (FPTYPE)(( shift >= 0 ) ? (mantissa << shift) : (mantissa >> -shift));
+
+	return ( bits.u & 0x80000000UL ) ? -result : result;
+#else
+	return f;
+#endif
+}
+
 
-block_t			block_buffer[BLOCK_BUFFER_SIZE];	// A ring buffer for motion instfructions
+block_t			block_buffer[BLOCK_BUFFER_SIZE] XMEM_PLANNER_DATA;	// A ring buffer for motion instfructions
+block_cold_t		block_cold_buffer[BLOCK_BUFFER_SIZE] XMEM_PLANNER_DATA;	// Rarely used block fields, indexed as block_buffer
+#ifdef PRECOMPUTED_RAMPS
+block_ramp_t		block_ramp_buffer[BLOCK_BUFFER_SIZE] XMEM_PLANNER_DATA;	// Precomputed timer values, indexed as block_buffer
+#endif
 volatile unsigned char	block_buffer_head;			// Index of the next block to be pushed
 volatile unsigned char	block_buffer_tail;			// Index of the block to process now
 
+// Index of the oldest block whose entry speed may still change when new blocks are added.
+// Blocks from block_buffer_tail up to (but not including) this one are optimally planned and
+// are skipped by the planner passes.  Only the planner touches this, the stepper interrupt
+// doesn't, so it can be left behind block_buffer_tail and is clamped by planner_planned_index().
+static uint8_t		block_buffer_planned;
+
 
 // Returns the index of the next block in the ring buffer
 // NOTE: Removed modulo (%) operator, which uses an expensive divide and multiplication.
@@ -342,7 +459,7 @@ FORCE_INLINE int32_t intersection_distance(int32_t initial_rate_sq, int32_t fina
 FORCE_INLINE FPTYPE final_speed_step_rate(uint32_t acceleration, uint32_t initial_velocity, int32_t distance) {
      uint32_t v2 = initial_velocity * initial_velocity;
 
-#ifdef SIMULATOR
+#ifdef SIMULATOR_CHECKED
      uint64_t sum2 = (uint64_t)initial_velocity * (uint64_t)initial_velocity +
 	  2 * (uint64_t)acceleration * (uint64_t)distance;
      float fres = (sum2 > 0) ? sqrt((float)sum2) : 0.0;
@@ -358,12 +475,9 @@ FORCE_INLINE FPTYPE final_speed_step_rate(uint32_t acceleration, uint32_t initia
      }
      else	v2 += (acceleration * (uint32_t)distance) << 1;
      if (v2 <= 0x7fff)
-#ifndef SIMULATOR
+#ifndef SIMULATOR_CHECKED
 	  return ITOFP(isqrt1((uint16_t)v2));
 #else
-#ifndef isqrt1
-#define isqrt1(x) ((int32_t)sqrt((float)(x)))
-#endif
      result = ITOFP(isqrt1((uint16_t)v2));
 #endif
      else {
@@ -373,20 +487,20 @@ FORCE_INLINE FPTYPE final_speed_step_rate(uint32_t acceleration, uint32_t initia
 	       n++;
 	  }
 
-#ifndef SIMULATOR
-	  return ITOFP(isqrt1((int16_t)v2)) << n;
+#ifndef SIMULATOR_CHECKED
+	  return FPLSHIFT(ITOFP(isqrt1((int16_t)v2)), n);
 #else
-	  result = ITOFP(isqrt1((int16_t)v2)) << n;
+	  result = FPLSHIFT(ITOFP(isqrt1((int16_t)v2)), n);
 #endif
      }
 
-#ifdef SIMULATOR
+#ifdef SIMULATOR_CHECKED
      if ((fres != 0.0) && ((fabsf(fres - FPTOF(result))/fres) > 0.01)) {
 	  char buf[1024];
 	  snprintf(buf, sizeof(buf), "!!! final_speed_step_rate(%d, %d, %d): fixed result = %f; "
 		   "float result = %f !!!\n", acceleration, initial_velocity, distance,
 		   FPTOF(result), fres);
-	  if (sblock)	strlcat(sblock->message, buf, sizeof(sblock->message));
+	  if (sblock)	strlcat(plan_block_cold(sblock)->message, buf, sizeof(plan_block_cold(sblock)->message));
 	  else		printf("%s", buf);
      }
      return result;
@@ -397,6 +511,250 @@ FORCE_INLINE FPTYPE final_speed_step_rate(uint32_t acceleration, uint32_t initia
 
 
 
+#if defined(PRECOMPUTED_RAMPS) || defined(ESTIMATE_TIME) || defined(S_CURVE_ACCELERATION)
+
+// Integer square root of a 32 bit value, bit by bit
+
+static uint16_t isqrt32(uint32_t value) {
+	uint32_t result = 0;
+	uint32_t bit = (uint32_t)1 << 30;
+
+	while ( bit > value )	bit >>= 2;
+
+	while ( bit != 0 ) {
+		if ( value >= result + bit ) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint16_t)result;
+}
+
+#endif
+
+#ifdef ESTIMATE_TIME
+
+// Motion time of the blocks the stepper interrupt has finished with, in
+// milliseconds.  Those from block_buffer_timed up to block_buffer_tail are
+// yet to be added; their slots aren't reused until plan_buffer_line().
+static uint32_t		planner_run_ms;
+static uint8_t		block_buffer_timed;
+
+// The rate an accelerated block peaks at, and the steps it cruises there for
+static uint32_t planner_peak_rate(const block_t *block, int32_t *plateau_steps) {
+	*plateau_steps = block->decelerate_after - block->accelerate_until;
+	uint32_t peak_rate = block->nominal_rate;
+	if ( *plateau_steps <= 0 ) {
+		// Accelerates to where it has to start slowing down
+		uint32_t peak_sq = block->initial_rate * block->initial_rate +
+			(block->acceleration_st << 1) * (uint32_t)block->accelerate_until;
+		if ( peak_sq < (uint32_t)block->nominal_rate_sq )
+			peak_rate = isqrt32(peak_sq);
+		*plateau_steps = 0;
+	}
+	return peak_rate;
+}
+
+uint32_t plan_block_time_ms(const block_t *block) {
+	if ( block->nominal_rate == 0 )
+		return 0;
+	if ( !block->use_accel || block->acceleration_st == 0 )
+		return block->step_event_count * 1000 / block->nominal_rate;
+
+	int32_t plateau_steps;
+	uint32_t peak_rate = planner_peak_rate(block, &plateau_steps);
+
+	uint32_t ramps = 0;
+	if ( peak_rate > block->initial_rate )	ramps += peak_rate - block->initial_rate;
+	if ( peak_rate > block->final_rate )	ramps += peak_rate - block->final_rate;
+
+	return ramps * 1000 / block->acceleration_st +
+		(uint32_t)plateau_steps * 1000 / block->nominal_rate;
+}
+
+#ifdef PLANNER_STATS
+
+static planner_stats_t	planner_stats;
+
+// Adds a block to the stats, returning plan_block_time_ms() of it
+static uint32_t planner_count_stats(const block_t *block) {
+	planner_stats_t *s = &planner_stats;
+
+	s->blocks ++;
+	if ( block->entry_speed <= minimumPlannerSpeed )	s->full_stops ++;
+
+	int32_t speed = FPTOI(block->nominal_speed) / PLANNER_STATS_BUCKET_MM_S;
+	uint8_t bucket = ( speed < PLANNER_STATS_BUCKETS - 1 ) ? (uint8_t)speed : PLANNER_STATS_BUCKETS - 1;
+	if ( s->histogram[bucket] == 0xffff )
+		for ( uint8_t i = 0; i < PLANNER_STATS_BUCKETS; i ++ )
+			s->histogram[i] >>= 1;
+	s->histogram[bucket] ++;
+
+	if ( block->nominal_rate == 0 )
+		return 0;
+	if ( !block->use_accel || block->acceleration_st == 0 ) {
+		uint32_t ms = block->step_event_count * 1000 / block->nominal_rate;
+		s->reached_nominal ++;
+		s->cruise_ms += ms;
+		return ms;
+	}
+
+	int32_t plateau_steps;
+	uint32_t peak_rate = planner_peak_rate(block, &plateau_steps);
+	if ( plateau_steps > 0 )	s->reached_nominal ++;
+
+	// Split so that the two add up to plan_block_time_ms()'s ramps
+	uint32_t up = ( peak_rate > block->initial_rate ) ? peak_rate - block->initial_rate : 0;
+	uint32_t down = ( peak_rate > block->final_rate ) ? peak_rate - block->final_rate : 0;
+	uint32_t accel_ms = up * 1000 / block->acceleration_st;
+	uint32_t ramps_ms = (up + down) * 1000 / block->acceleration_st;
+	uint32_t cruise_ms = (uint32_t)plateau_steps * 1000 / block->nominal_rate;
+
+	s->accel_ms += accel_ms;
+	s->decel_ms += ramps_ms - accel_ms;
+	s->cruise_ms += cruise_ms;
+	return ramps_ms + cruise_ms;
+}
+
+#endif
+
+static void planner_count_run_time() {
+	uint8_t tail = block_buffer_tail;
+	while ( block_buffer_timed != tail ) {
+	#ifdef PLANNER_STATS
+		planner_run_ms += planner_count_stats(&block_buffer[block_buffer_timed]);
+	#else
+		planner_run_ms += plan_block_time_ms(&block_buffer[block_buffer_timed]);
+	#endif
+		block_buffer_timed = next_block_index(block_buffer_timed);
+	}
+}
+
+void plan_get_motion_time(uint32_t *run_ms, uint32_t *queued_ms) {
+	planner_count_run_time();
+	*run_ms = planner_run_ms;
+
+	uint32_t queued = 0;
+	for ( uint8_t i = block_buffer_timed; i != block_buffer_head; i = next_block_index(i) )
+		queued += plan_block_time_ms(&block_buffer[i]);
+	*queued_ms = queued;
+}
+
+void plan_reset_motion_time() {
+	planner_count_run_time();
+	planner_run_ms = 0;
+}
+
+#ifdef PLANNER_STATS
+
+void plan_stats_get(planner_stats_t *stats) {
+	planner_count_run_time();
+	*stats = planner_stats;
+}
+
+void plan_stats_reset() {
+	planner_count_run_time();
+	memset(&planner_stats, 0, sizeof(planner_stats));
+}
+
+#endif
+
+#endif
+
+#ifdef PRECOMPUTED_RAMPS
+
+// Fills in the timer values for the acceleration and deceleration ramps of a block.
+// From [6] above, rate^2 is linear in the distance travelled, rate(d)^2 = initial_rate^2 + 2ad.
+// Each segment uses the rate at its midpoint.  accelerate_steps and decelerate_after are as
+// calculated by calculate_trapezoid_for_block().
+
+static void planner_fill_ramp(block_ramp_t *ramp, const block_t *block, uint32_t initial_rate, uint32_t final_rate,
+			      int32_t accelerate_steps, int32_t decelerate_after) {
+	uint8_t loops;
+
+	ramp->nominal_timer = st_calc_timer((uint16_t)block->nominal_rate, &loops);
+	ramp->nominal_loops = loops;
+
+	if ( ! block->use_accel )	return;
+
+	uint32_t acceleration_doubled = block->acceleration_st << 1;
+	uint32_t nominal_rate_sq = (uint32_t)block->nominal_rate_sq;
+
+	// We accelerate from step 0 until (and including) step accelerate_steps as
+	// st_interrupt() tests "step_events_completed <= accelerate_until"
+	uint32_t segment_steps = ((uint32_t)accelerate_steps + RAMP_SEGMENTS) / RAMP_SEGMENTS;
+	if ( segment_steps > 0xffff )	segment_steps = 0xffff;
+	ramp->accel_segment_steps = (uint16_t)segment_steps;
+
+	uint32_t delta_sq = acceleration_doubled * segment_steps;
+	uint32_t rate_sq = initial_rate * initial_rate + (delta_sq >> 1);
+	for ( uint8_t i = 0; i < RAMP_SEGMENTS; i ++ ) {
+		if ( rate_sq > nominal_rate_sq )	rate_sq = nominal_rate_sq;
+		ramp->timer[i] = st_calc_timer(isqrt32(rate_sq), &loops);
+		ramp->loops[i] = loops;
+		rate_sq += delta_sq;
+	}
+
+	// The deceleration works back from final_rate at the end of the block
+	uint32_t decelerate_steps = block->step_event_count - (uint32_t)decelerate_after;
+	segment_steps = (decelerate_steps + RAMP_SEGMENTS - 1) / RAMP_SEGMENTS;
+	if ( segment_steps == 0 )	segment_steps = 1;
+	if ( segment_steps > 0xffff )	segment_steps = 0xffff;
+	ramp->decel_segment_steps = (uint16_t)segment_steps;
+
+	uint32_t final_rate_sq = final_rate * final_rate;
+	delta_sq = acceleration_doubled * segment_steps;
+	rate_sq = final_rate_sq + acceleration_doubled * decelerate_steps;
+	rate_sq = ( rate_sq > (delta_sq >> 1) ) ? rate_sq - (delta_sq >> 1) : 0;
+	for ( uint8_t i = RAMP_SEGMENTS; i < 2 * RAMP_SEGMENTS; i ++ ) {
+		if ( rate_sq > nominal_rate_sq )	rate_sq = nominal_rate_sq;
+		if ( rate_sq < final_rate_sq )		rate_sq = final_rate_sq;
+		ramp->timer[i] = st_calc_timer(isqrt32(rate_sq), &loops);
+		ramp->loops[i] = loops;
+		rate_sq = ( rate_sq > delta_sq ) ? rate_sq - delta_sq : 0;
+	}
+}
+
+#endif
+
+
+
+#ifdef S_CURVE_ACCELERATION
+
+// Works out the time a ramp which changes the step rate by rate_change takes at the
+// block's acceleration, normalized to between 0x8000 and 0xFFFF ticks by *shift, and the
+// inverse of that time which st_interrupt() multiplies the time into the ramp by.
+
+static void planner_s_curve_ramp(uint32_t rate_change, uint32_t acceleration, int8_t *shift, uint16_t *inverse) {
+	// Ticks of the 2 MHz timer, as 2000000 = 15625 << 7
+	uint32_t ticks = rate_change * 15625 / acceleration;
+	if ( ticks > 0x01FFFFFF )	ticks = 0x01FFFFFF;
+	ticks <<= 7;
+	if ( ticks == 0 )		ticks = 1;
+
+	int8_t s = 0;
+	while ( ticks > 0xFFFF ) {
+		ticks >>= 1;
+		s ++;
+	}
+	while ( ticks < 0x8000 ) {
+		ticks <<= 1;
+		s --;
+	}
+	*shift = s;
+
+	uint32_t inv = 0x80000000UL / ticks;
+	*inverse = ( inv > 0xFFFF ) ? 0xFFFF : (uint16_t)inv;
+}
+
+#endif
+
+
+
 // Calculates trapezoid parameters so that the entry- and exit-speed is compensated by the provided factors.
 
 void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE exit_factor) {
@@ -462,7 +820,10 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 		#ifdef SIMULATOR
 			sblock = block;
 		#endif
-		int16_t advance_lead_entry = 0, advance_lead_exit = 0, advance_lead_prime = 0, advance_lead_deprime = 0;
+		int16_t advance_lead_entry = 0, advance_lead_exit = 0;
+		#ifdef JKN_ADVANCE_LEAD_DE_PRIME
+			int16_t advance_lead_prime = 0, advance_lead_deprime = 0;
+		#endif
 		int32_t advance_pressure_relax = 0;
 
 		if ( block->use_advance_lead ) {
@@ -538,7 +899,9 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 
 				#ifndef SIMULATOR
 					if (advance_lead_entry < 0) advance_lead_entry = 0;
-					if (advance_lead_prime < 0) advance_lead_prime = 0;
+					#ifdef JKN_ADVANCE_LEAD_DE_PRIME
+						if (advance_lead_prime < 0) advance_lead_prime = 0;
+					#endif
 				#endif
 			}
 
@@ -578,7 +941,9 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 					if ( advance_pressure_relax < 0 ) advance_pressure_relax = 0;
 
 					if (advance_lead_exit    < 0) advance_lead_exit = 0;
-					if (advance_lead_deprime < 0) advance_lead_deprime = 0;
+					#ifdef JKN_ADVANCE_LEAD_DE_PRIME
+						if (advance_lead_deprime < 0) advance_lead_deprime = 0;
+					#endif
 				#endif
 			}
 
@@ -594,14 +959,42 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 						 advance_lead_entry, advance_lead_exit, advance_pressure_relax,initial_rate, block->nominal_rate,
 						 maximum_rate, final_rate, accelerate_steps, decelerate_after, block->step_event_count,
 						 plateau_steps, initial_rate_sq, block->nominal_rate_sq, final_rate_sq, acceleration_doubled);
-					strlcat(block->message, buf, sizeof(block->message));
+					strlcat(plan_block_cold(block)->message, buf, sizeof(plan_block_cold(block)->message));
 				}
 			#endif
 		}
 	#endif
 
+	#ifdef S_CURVE_ACCELERATION
+		// The rate the acceleration ends at, where the deceleration starts from
+		uint32_t peak_rate = block->nominal_rate;
+		if ( plateau_steps == 0 ) {
+			uint32_t peak_sq = (uint32_t)initial_rate_sq + (uint32_t)acceleration_doubled * (uint32_t)accelerate_steps;
+			if ( peak_sq < (uint32_t)block->nominal_rate_sq )	peak_rate = isqrt32(peak_sq);
+		}
+		if ( peak_rate < initial_rate )	peak_rate = initial_rate;
+		uint16_t accel_rate_change = (uint16_t)(peak_rate - initial_rate);
+		int8_t accel_time_shift = 0, decel_time_shift = 0;
+		uint16_t accel_time_inverse = 0, decel_time_inverse = 0;
+		if ( block->use_accel && acceleration > 0 ) {
+			planner_s_curve_ramp(accel_rate_change, (uint32_t)acceleration, &accel_time_shift, &accel_time_inverse);
+			planner_s_curve_ramp(( peak_rate > final_rate ) ? peak_rate - final_rate : 0, (uint32_t)acceleration,
+					     &decel_time_shift, &decel_time_inverse);
+		}
+	#endif
+
+	#ifdef PRECOMPUTED_RAMPS
+		// Done outside of the critical section, only the copy needs to be protected
+		block_ramp_t ramp;
+		planner_fill_ramp(&ramp, block, initial_rate, final_rate, accelerate_steps, decelerate_after);
+		block_ramp_t *block_ramp = &block_ramp_buffer[block - block_buffer];
+	#endif
+
 	CRITICAL_SECTION_START;  // Fill variables used by the stepper in a critical section
 		if(block->busy == false) { // Don't update variables if block is busy.
+			#ifdef PRECOMPUTED_RAMPS
+				*block_ramp = ramp;
+			#endif
 			if ( block->use_accel ) {
 				block->accelerate_until = accelerate_steps;
 				block->decelerate_after = decelerate_after;
@@ -609,11 +1002,22 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 			block->initial_rate = initial_rate;
 			block->final_rate = final_rate;
 
+			#ifdef S_CURVE_ACCELERATION
+				block->accel_rate_change  = accel_rate_change;
+				block->accel_time_shift   = accel_time_shift;
+				block->accel_time_inverse = accel_time_inverse;
+				block->decel_time_shift   = decel_time_shift;
+				block->decel_time_inverse = decel_time_inverse;
+			#endif
+
 			#ifdef JKN_ADVANCE
 				block->advance_lead_entry     = advance_lead_entry;
 				block->advance_lead_exit      = advance_lead_exit;
-				block->advance_lead_prime     = advance_lead_prime;
-				block->advance_lead_deprime   = advance_lead_deprime;
+				#ifdef JKN_ADVANCE_LEAD_DE_PRIME
+					block_cold_t *cold = plan_block_cold(block);
+					cold->advance_lead_prime   = advance_lead_prime;
+					cold->advance_lead_deprime = advance_lead_deprime;
+				#endif
 				block->advance_pressure_relax = advance_pressure_relax;
 			#endif
 		}
@@ -661,7 +1065,7 @@ void calculate_trapezoid_for_block(block_t *block, FPTYPE entry_factor, FPTYPE e
 FORCE_INLINE FPTYPE final_speed(FPTYPE acceleration, FPTYPE initial_velocity, FPTYPE distance) {
 	#ifdef FIXED
 		//  static int counts = 0;
-		#ifdef SIMULATOR
+		#ifdef SIMULATOR_CHECKED
 			float  ftv = FPTOF(initial_velocity);
 			float  fac = FPTOF(acceleration);
 			float   fd = FPTOF(distance);
@@ -733,7 +1137,7 @@ FORCE_INLINE FPTYPE final_speed(FPTYPE acceleration, FPTYPE initial_velocity, FP
 			else		result <<= (6 - n);
 		}
 
-		#ifndef SIMULATOR
+		#ifndef SIMULATOR_CHECKED
 			return result;
 
 			//#ifdef DEBUG_ONSCREEN
@@ -761,11 +1165,11 @@ FORCE_INLINE FPTYPE final_speed(FPTYPE acceleration, FPTYPE initial_velocity, FP
 					 FPTOF(result), fres,
 					 (100*fres/FPTOF(result))-100);
 
-				if (sblock)	strlcat(sblock->message, buf, sizeof(sblock->message));
+				if (sblock)	strlcat(plan_block_cold(sblock)->message, buf, sizeof(plan_block_cold(sblock)->message));
 				else		printf("%s", buf);
 			}
 			return result;
-		#endif // SIMULATOR
+		#endif // SIMULATOR_CHECKED
 	#else
 		// Just assume we're doing everything with floating point arithmetic
 		// and do not need to worry about overflows or underflows
@@ -813,16 +1217,11 @@ void planner_reverse_pass_kernel(block_t *current, block_t *next) {
 // planner_recalculate() needs to go over the current plan twice. Once in reverse and once forward. This
 // implements the reverse pass.
 
-void planner_reverse_pass() {
+void planner_reverse_pass(uint8_t planned) {
 	uint8_t block_index	= block_buffer_head;
 	block_t *block[2]	= { NULL, NULL};
 
-	//Make a local copy of block_buffer_tail, because the interrupt can alter it
-	CRITICAL_SECTION_START;
-  		unsigned char tail = block_buffer_tail;
-	CRITICAL_SECTION_END;
-
-	while(block_index != tail) {
+	while(block_index != planned) {
 		block_index = prev_block_index(block_index);
 		block[1]= block[0];
 		block[0] = &block_buffer[block_index];
@@ -872,14 +1271,33 @@ void planner_forward_pass_kernel(block_t *previous, block_t *current) {
 // planner_recalculate() needs to go over the current plan twice. Once in reverse and once forward. This
 // implements the forward pass.
 
-void planner_forward_pass() {
-	uint8_t block_index	= block_buffer_tail;
+// The forward pass also advances block_buffer_planned past blocks whose entry speed can no
+// longer change: a block cruising at its maximum entry speed can't be raised any further, and
+// a block whose entry speed is limited by accelerating from an already optimal block can't
+// either.  The next call will not revisit them.
+
+void planner_forward_pass(uint8_t planned, uint8_t tail) {
+	uint8_t block_index	= planned;
 	block_t *block[2]	= { NULL, NULL };
 
+	// The block before the first non optimal block is the starting point of the acceleration
+	if ( planned != tail )	block[1] = &block_buffer[prev_block_index(planned)];
+
 	while(block_index != block_buffer_head) {
 		block[0] = block[1];
 		block[1] = &block_buffer[block_index];
+
+		FPTYPE entry_speed = block[1]->entry_speed;
 		planner_forward_pass_kernel(block[0],block[1]);
+
+		if ((block[1]->max_entry_speed - block[1]->entry_speed) <= KCONSTANT_3) {
+			// Cruising at the maximum entry speed, everything up to here is optimal
+			block_buffer_planned = next_block_index(block_index);
+		} else if (( block_index == block_buffer_planned ) && VNEQ(entry_speed, block[1]->entry_speed)) {
+			// Acceleration limited by the previous (optimal) block
+			block_buffer_planned = next_block_index(block_index);
+		}
+
 		block_index = next_block_index(block_index);
 	}
 }
@@ -890,8 +1308,10 @@ void planner_forward_pass() {
 // entry_factor for each junction. Must be called by planner_recalculate() after
 // updating the blocks.
 
-void planner_recalculate_trapezoids() {
-	uint8_t block_index	= block_buffer_tail;
+void planner_recalculate_trapezoids(uint8_t planned, uint8_t tail) {
+	// The trapezoid of the block before the first non optimal block depends on that
+	// block's entry speed, so it's included.  Anything older than that can't change.
+	uint8_t block_index	= ( planned != tail ) ? prev_block_index(planned) : tail;
 	block_t *current;
 	block_t *next		= NULL;
 
@@ -941,15 +1361,302 @@ void planner_recalculate_trapezoids() {
 // the set limit. Finally it will:
 //
 //   3. Recalculate trapezoids for all blocks.
+//
+// Blocks before block_buffer_planned are already optimally planned and adding more blocks can't
+// change them, so all three stages start at block_buffer_planned instead of block_buffer_tail.
+// This keeps the cost per added block roughly constant instead of growing with BLOCK_BUFFER_SIZE.
 
 void planner_recalculate() {
-	planner_reverse_pass();
-	planner_forward_pass();
-	planner_recalculate_trapezoids();
+	//Make a local copy of block_buffer_tail, because the interrupt can alter it
+	CRITICAL_SECTION_START;
+		uint8_t tail = block_buffer_tail;
+	CRITICAL_SECTION_END;
+
+	// The stepper interrupt may have consumed blocks past block_buffer_planned
+	if ( ((block_buffer_planned - tail) & (BLOCK_BUFFER_SIZE - 1)) >
+	     ((block_buffer_head    - tail) & (BLOCK_BUFFER_SIZE - 1)) )
+		block_buffer_planned = tail;
+
+	uint8_t planned = block_buffer_planned;
+
+	planner_reverse_pass(planned);
+	planner_forward_pass(planned, tail);
+	planner_recalculate_trapezoids(planned, tail);
+}
+
+
+
+#ifdef FAST_PAUSE
+
+// The blocks plan_park() set aside, from tail up to head, and the planner state to go on from
+// where they end.  The slots from head round to tail are free for the moves made meanwhile.
+static struct {
+	bool	parked;
+	uint8_t	tail, head;
+	int32_t	position[STEPPER_COUNT];
+	FPTYPE	prev_speed[STEPPER_COUNT];
+	FPTYPE	prev_final_speed;
+	uint8_t	prev_speed_axes;
+	FPTYPE	prev_unit[Z_AXIS + 1];
+	FPTYPE	prev_jd_speed;
+} parked;
+
+
+
+// Trims the block the stepper interrupt was halted in to the steps it had still to make
+
+static void planner_trim_block(block_t *block) {
+	uint32_t total = block->step_event_count;
+	uint32_t left = 0;
+
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		int32_t steps = block->steps[i] - stepperAxis[i].dda.steps_completed;
+		if ( steps < 0 )	steps = 0;
+		block->steps[i] = steps;
+		if ( (uint32_t)steps > left ) {
+			left = steps;
+			block->dda_master_axis_index = i;
+		}
+	}
+	block->step_event_count = left;
+
+	// The same fraction of the distance is left, the feed rates and accelerations are
+	// unchanged.  The step counts are cut down to where FPTYPE holds them.
+	while ( total > 0x7FFF ) {
+		total >>= 1;
+		left >>= 1;
+	}
+	block->millimeters = FPMULT2(block->millimeters, FPDIV(ITOFP((int32_t)left), ITOFP((int32_t)total)));
+	block->nominal_length_flag = false;
+}
+
+
+
+bool plan_park(bool in_block) {
+	#ifdef ESTIMATE_TIME
+		planner_count_run_time();
+	#endif
+
+	if ( block_buffer_head == block_buffer_tail )	return false;
+
+	block_cold_t *cold = &block_cold_buffer[block_buffer_tail];
+	if ( in_block ) {
+		planner_trim_block(&block_buffer[block_buffer_tail]);
+
+		// It carries on from where the steppers are
+		uint8_t active_toolhead;
+		#if EXTRUDERS > 1
+			st_get_position(&cold->starting_position[X_AXIS], &cold->starting_position[Y_AXIS],
+					&cold->starting_position[Z_AXIS], &cold->starting_position[A_AXIS],
+					&cold->starting_position[B_AXIS], &active_toolhead);
+		#else
+			st_get_position(&cold->starting_position[X_AXIS], &cold->starting_position[Y_AXIS],
+					&cold->starting_position[Z_AXIS], &cold->starting_position[A_AXIS],
+					&active_toolhead);
+		#endif
+	}
+
+	parked.parked = true;
+	parked.tail = block_buffer_tail;
+	parked.head = block_buffer_head;
+	parked.prev_final_speed = prev_final_speed;
+	parked.prev_speed_axes = prev_speed_axes;
+	parked.prev_jd_speed = prev_jd_speed;
+	for ( uint8_t i = 0; i <= Z_AXIS; i ++ )
+		parked.prev_unit[i] = prev_unit[i];
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
+		parked.prev_speed[i] = prev_speed[i];
+
+	// The moves made while parked start from rest at the steppers' position
+	prev_final_speed = 0;
+	prev_speed_axes = 0;
+	prev_jd_speed = 0;
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
+		prev_speed[i] = 0;
+
+	CRITICAL_SECTION_START;
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		parked.position[i] = planner_position[i];
+		planner_position[i] = cold->starting_position[i];
+	}
+	block_buffer_tail = block_buffer_head;
+	CRITICAL_SECTION_END;
+
+	block_buffer_planned = block_buffer_head;
+	#ifdef ESTIMATE_TIME
+		block_buffer_timed = block_buffer_head;
+	#endif
+
+	return true;
+}
+
+
+
+// While blocks are parked, the moves made meanwhile go in the slots after them.  The buffer
+// starts over at parked.head each time it has emptied, and when it has come round to
+// parked.tail, waits for the stepper interrupt to empty it.
+
+static void planner_parked_make_room() {
+	if ( block_buffer_head == parked.tail )
+		while ( blocks_queued() ) ;
+
+	if ( blocks_queued() )	return;
+
+	CRITICAL_SECTION_START;
+	block_buffer_tail = parked.head;
+	block_buffer_head = parked.head;
+	CRITICAL_SECTION_END;
+
+	block_buffer_planned = parked.head;
+	#ifdef ESTIMATE_TIME
+		block_buffer_timed = parked.head;
+	#endif
+}
+
+
+
+void plan_unpark() {
+	if ( ! parked.parked )	return;
+
+	// Hold the stepper interrupt off the blocks until they're planned again
+	while ( blocks_queued() ) ;
+	st_request_stop();
+
+	#ifdef ESTIMATE_TIME
+		planner_count_run_time();
+		block_buffer_timed = parked.tail;
+	#endif
+
+	prev_final_speed = parked.prev_final_speed;
+	prev_speed_axes = parked.prev_speed_axes;
+	prev_jd_speed = parked.prev_jd_speed;
+	for ( uint8_t i = 0; i <= Z_AXIS; i ++ )
+		prev_unit[i] = parked.prev_unit[i];
+
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
+		prev_speed[i] = parked.prev_speed[i];
+
+	CRITICAL_SECTION_START;
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
+		planner_position[i] = parked.position[i];
+	block_buffer_tail = parked.tail;
+	block_buffer_head = parked.head;
+	CRITICAL_SECTION_END;
+	parked.parked = false;
+
+	// The first block starts from rest.  Each of those after it may then only enter as fast as
+	// the one before can accelerate to, which becomes its maximum so that later passes keep it.
+	// The blocks beyond the first one it doesn't hold back were optimal before.
+	block_t *previous = &block_buffer[parked.tail];
+	previous->busy = false;		// The stepper interrupt picks it up afresh
+	previous->entry_speed = min(minimumPlannerSpeed, previous->nominal_speed);
+	previous->max_entry_speed = previous->entry_speed;
+	previous->recalculate_flag = true;
+	previous->speed_changed = true;
+
+	uint8_t block_index = next_block_index(parked.tail);
+	block_buffer_planned = block_index;
+	while (( block_index != block_buffer_head ) && previous->use_accel ) {
+		block_t *current = &block_buffer[block_index];
+		if ( ! current->use_accel )	break;
+
+		FPTYPE entry_speed = final_speed(previous->acceleration, previous->entry_speed, previous->millimeters);
+		if ( entry_speed >= current->entry_speed )	break;
+
+		current->entry_speed = entry_speed;
+		current->max_entry_speed = entry_speed;
+		current->recalculate_flag = true;
+		current->speed_changed = true;
+
+		previous = current;
+		block_index = next_block_index(block_index);
+		block_buffer_planned = block_index;
+	}
+
+	planner_recalculate_trapezoids(parked.tail, parked.tail);
+
+	st_resume();
+}
+
+
+
+void plan_discard_parked() {
+	parked.parked = false;
+	plan_drop_actions();
+}
+
+#endif
+
+
+
+bool plan_queue_action(const plan_action_t *action) {
+	if ( plan_action_room() == 0 )	return false;
+
+	bool queued;
+	plan_actions[plan_action_head & (PLAN_ACTIONS - 1)] = *action;
+
+	// The last block mustn't finish between seeing that it's there and giving it the action
+	CRITICAL_SECTION_START;
+	queued = blocks_queued();
+	if ( queued ) {
+		plan_action_head++;
+		block_cold_buffer[prev_block_index(block_buffer_head)].action_end = plan_action_head;
+	}
+	CRITICAL_SECTION_END;
+
+	return queued;
+}
+
+
+
+uint8_t plan_action_room() {
+	return PLAN_ACTIONS - (uint8_t)(plan_action_head - plan_action_tail);
 }
 
 
 
+bool plan_take_action(plan_action_t *action) {
+	if ( plan_action_tail == plan_action_ready )	return false;
+
+	*action = plan_actions[plan_action_tail & (PLAN_ACTIONS - 1)];
+	plan_action_tail++;
+	return true;
+}
+
+
+
+bool plan_actions_pending() {
+	return plan_action_tail != plan_action_head;
+}
+
+
+
+void plan_drop_actions() {
+	CRITICAL_SECTION_START;
+	plan_action_tail = plan_action_head;
+	plan_action_ready = plan_action_head;
+	CRITICAL_SECTION_END;
+}
+
+
+
+void plan_set_accel_limits() {
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		accel_limiting_axes[i] = 0;
+		for ( uint8_t j = 0; j < STEPPER_COUNT; j ++ )
+			if ( axis_steps_per_sqr_second[j] < axis_steps_per_sqr_second[i] )
+				accel_limiting_axes[i] |= 1 << j;
+	}
+#ifdef TRAVEL_ACCELERATION
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		travel_limiting_axes[i] = 0;
+		for ( uint8_t j = 0; j < STEPPER_COUNT; j ++ )
+			if ( travel_steps_per_sqr_second[j] < travel_steps_per_sqr_second[i] )
+				travel_limiting_axes[i] |= 1 << j;
+	}
+#endif
+}
+
 void plan_init(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2, bool zhold) {
 #ifdef SIMULATOR
 		if ( (B_AXIS+1) != STEPPER_COUNT ) abort();
@@ -965,9 +1672,20 @@ void plan_init(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2, bool zhold) {
 
 	block_buffer_head = 0;
 	block_buffer_tail = 0;
+	block_buffer_planned = 0;
+	plan_drop_actions();
+	#ifdef ESTIMATE_TIME
+		block_buffer_timed = 0;
+		planner_run_ms = 0;
+	#endif
+	#ifdef FAST_PAUSE
+		parked.parked = false;
+	#endif
 
 	// clear planner_position & prev_speed info
 	prev_final_speed = 0;
+	prev_speed_axes = 0;
+	prev_jd_speed = 0;
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
 	{
 		prev_speed[i] = 0;
@@ -982,6 +1700,11 @@ void plan_init(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2, bool zhold) {
 	acceleration_zhold = zhold;
 	disable_slowdown = true;
 
+	plan_set_accel_limits();
+
+	inverse_minimum_segment_time = ( minimumSegmentTime > 0 ) ? FPDIV(KCONSTANT_1, minimumSegmentTime) : 0;
+	inverse_slowdown_limit = slowdown_limit ? FPDIV(KCONSTANT_1, ITOFP((int32_t)slowdown_limit)) : 0;
+
 	#ifdef DEBUG_BLOCK_BY_MOVE_INDEX
 		current_move_index = 0;
 	#endif
@@ -998,31 +1721,53 @@ void plan_init(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2, bool zhold) {
 
 void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t &extruder, bool use_accel, uint8_t active_toolhead)
 {
+	#ifdef ESTIMATE_TIME
+		// Before the head's slot, which may hold a finished block, is reused
+		planner_count_run_time();
+	#endif
+
+	#ifdef FAST_PAUSE
+		if ( parked.parked )	planner_parked_make_room();
+	#endif
+
+	// A hint is for this block alone, whether or not it's used
+	FPTYPE hint_speed = planner_hint_speed;
+	planner_hint_speed = 0;
+
 	// Calculate the buffer head after we push this byte
 	uint8_t next_buffer_head = next_block_index(block_buffer_head);
 
 	// Prepare to set up new block
 	block_t *block = &block_buffer[block_buffer_head];
+	block_cold_t *cold = &block_cold_buffer[block_buffer_head];
 
 	// Mark block as not busy (Not executed by the stepper interrupt)
 	block->busy = false;
 
 	// Note whether block is accelerated or not
 	block->use_accel = use_accel;
+	block->speed_factor = use_accel ? planner_speed_factor : 0;
 
 	// Note the active toolhead
 	block->active_toolhead = active_toolhead;
+	planner_toolhead = active_toolhead;
 
 	CRITICAL_SECTION_START;
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
-		block->starting_position[i] = planner_position[i];
+		cold->starting_position[i] = planner_position[i];
 	CRITICAL_SECTION_END;
+	#ifdef FAST_PAUSE
+		// The moves made while parked mustn't pass on the actions of those set aside
+		cold->action_end = parked.parked ? plan_action_ready : plan_action_head;
+	#else
+		cold->action_end = plan_action_head;
+	#endif
 
 	#ifdef SIMULATOR
 		// Track how many times this block is worked on by the planner
 		// Namely, how many times it is passed to calculate_trapezoid_for_block()
 		block->planned = 0;
-		block->message[0] = '\0';
+		cold->message[0] = '\0';
 		sblock = block;
 	#endif
 
@@ -1052,22 +1797,18 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	// Compute direction bits for this block
 	block->direction_bits = 0;
-#if !defined(CORE_XY) && !defined(CORE_XYZ)
+#ifndef KINEMATICS_MIX_IN_PLANNER
 	if (planner_target[X_AXIS] < planner_position[X_AXIS]) { block->direction_bits |= (1<<X_AXIS); }
 	if (planner_target[Y_AXIS] < planner_position[Y_AXIS]) { block->direction_bits |= (1<<Y_AXIS); }
-#elif defined(CORE_XYZ)
-	if (delta_ab[X_AXIS] < 0) { block->direction_bits |= (1<<X_AXIS); }
-	if (delta_ab[Y_AXIS] < 0) { block->direction_bits |= (1<<Y_AXIS); }
-	if (delta_ab[Z_AXIS] < 0) { block->direction_bits |= (1<<Z_AXIS); }
+	if (planner_target[Z_AXIS] < planner_position[Z_AXIS]) { block->direction_bits |= (1<<Z_AXIS); }
 #else
 	if (delta_ab[X_AXIS] < 0) { block->direction_bits |= (1<<X_AXIS); }
 	if (delta_ab[Y_AXIS] < 0) { block->direction_bits |= (1<<Y_AXIS); }
+	if (delta_ab[Z_AXIS] < 0) { block->direction_bits |= (1<<Z_AXIS); }
 
-	// The following two bits are used to aid in endstop control
-	if (delta_ab[X_AXIS] > 0 && delta_ab[Y_AXIS] > 0) { block->direction_bits |= (1 << (X_AXIS + B_AXIS + 1)); }  // +X
-	if (delta_ab[X_AXIS] > 0 && delta_ab[Y_AXIS] < 0) { block->direction_bits |= (1 << (Y_AXIS + B_AXIS + 1)); }  // +Y
+	// The bits above B_AXIS are used to aid in endstop control
+	block->direction_bits |= Kinematics::endstopDirections(delta_ab) << (B_AXIS + 1);
 #endif
-	if (planner_target[Z_AXIS] < planner_position[Z_AXIS]) { block->direction_bits |= (1<<Z_AXIS); }
 	if (planner_target[A_AXIS] < planner_position[A_AXIS]) { block->direction_bits |= (1<<A_AXIS); }
 #if EXTRUDERS > 1
 	if (planner_target[B_AXIS] < planner_position[B_AXIS]) { block->direction_bits |= (1<<B_AXIS); }
@@ -1088,35 +1829,20 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 	#ifndef SIMULATOR
 		//enable active axes
 
-        #if !defined(CORE_XY) && !defined(CORE_XYZ)
-	       if ( planner_axes & (1 << X_AXIS) ) stepperAxisSetEnabled(X_AXIS, true);
-	       if ( planner_axes & (1 << Y_AXIS) ) stepperAxisSetEnabled(Y_AXIS, true);
-        #elif defined(CORE_XYZ)
-	       // Need both steppers holding for Core XY
-	       if ( planner_axes & ((1 << X_AXIS) | (1 << Y_AXIS) | ( 1 << Z_AXIS)) )
-	       {
-		     stepperAxisSetEnabled(X_AXIS, true);
-		     stepperAxisSetEnabled(Y_AXIS, true);
-		     stepperAxisSetEnabled(Z_AXIS, true);
-		}
-	#else
-	       // Need both steppers holding for Core XY
-	       if ( planner_axes & ((1 << X_AXIS) | (1 << Y_AXIS)) )
-	       {
-		     stepperAxisSetEnabled(X_AXIS, true);
-		     stepperAxisSetEnabled(Y_AXIS, true);
-		}
-	#endif
-	       if ( planner_axes & (1 << Z_AXIS) ) stepperAxisSetEnabled(Z_AXIS, true);
-	       if ( planner_axes & (1 << A_AXIS) ) stepperAxisSetEnabled(A_AXIS, true);
-	       if ( planner_axes & (1 << B_AXIS) ) stepperAxisSetEnabled(B_AXIS, true);
+	       // Motors shared between axes all hold while any of them moves
+	       uint8_t hold_axes = kinematicsHoldAxes(planner_axes);
+	       if ( hold_axes & (1 << X_AXIS) ) stepperAxisSetEnabled(X_AXIS, true);
+	       if ( hold_axes & (1 << Y_AXIS) ) stepperAxisSetEnabled(Y_AXIS, true);
+	       if ( hold_axes & (1 << Z_AXIS) ) stepperAxisSetEnabled(Z_AXIS, true);
+	       if ( hold_axes & (1 << A_AXIS) ) stepperAxisSetEnabled(A_AXIS, true);
+	       if ( hold_axes & (1 << B_AXIS) ) stepperAxisSetEnabled(B_AXIS, true);
 
 		// Note the current enabled axes
 		block->axesEnabled = axesEnabled;
 
 		//Hold Z
 		if ( acceleration_zhold ) block->axesEnabled |= _BV(Z_AXIS);
-                else if ( 0 == (planner_axes & (1 << Z_AXIS)) )	block->axesEnabled &= ~(_BV(Z_AXIS));
+                else if ( 0 == (hold_axes & (1 << Z_AXIS)) )	block->axesEnabled &= ~(_BV(Z_AXIS));
 	#endif
 
 	uint8_t moves_queued = movesplanned();
@@ -1127,9 +1853,32 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	//If we have an empty buffer, then anything "previous" should be wiped
 	if ( moves_queued == 0 ) {
-		for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
+		FOR_EACH_AXIS(i, prev_speed_axes)
 			prev_speed[i] = 0;
+		prev_speed_axes = 0;
+		prev_jd_speed = 0;
+	}
+
+	#ifndef SIMULATOR
+	{
+		// Only the time to a block the planner was waiting for counts: with
+		// the buffer full it's the steppers setting the pace, and from empty
+		// it may have been a heat up
+		uint8_t wrap;
+		micros_t now = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+		if ( plan_arrival_hungry && moves_queued != 0 ) {
+			uint32_t interval = now - plan_arrival_last;
+			int32_t sample = ( interval > PLAN_ARRIVAL_MAX ) ? PLAN_ARRIVAL_MAX : (int32_t)interval;
+			if ( plan_arrival_centa == 0 )	plan_arrival_centa = sample;
+			else				plan_arrival_centa += (sample - plan_arrival_centa) / 4;
+		}
+		plan_arrival_last = now;
+		plan_arrival_hungry = slowdown_limit ? ( moves_queued < slowdown_limit ) :
+						       ( moves_queued < BLOCK_BUFFER_SIZE / 2 );
 	}
+	#endif
+	// In seconds
+	FPTYPE arrival_time = plan_arrival_centa ? FPDIV(ITOFP(plan_arrival_centa), ITOFP(10000)) : 0;
 
 	block->nominal_rate = dda_rate;
 
@@ -1145,26 +1894,47 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 			//according to how little we have left in the buffer
 
 			if ( (! disable_slowdown ) && moves_queued < slowdown_limit) {
-				FPTYPE slowdownScaling = FPDIV(ITOFP(moves_queued), ITOFP((int32_t)slowdown_limit));
-
-				if (feed_rate != 0) {
-					FPTYPE originalFeedRate = feed_rate;
-					//At least minimum planner speed, or 0.5s, or computed slowdown.
-					feed_rate = max(minimumPlannerSpeed, max(FPDIV(planner_distance, KCONSTANT_0_5), FPMULT2(feed_rate, slowdownScaling)));
-					slowdownScaling = FPDIV(feed_rate, originalFeedRate);
+				FPTYPE slowdownScaling = FPMULT2(ITOFP(moves_queued), inverse_slowdown_limit);
+
+				// With the rate the blocks come in known, this one need only
+				// be slowed to take as long as the wait for the next, and
+				// only as far as the buffer is short of slowdown_limit.  If
+				// it takes that long anyway, the buffer isn't emptying.
+				if ( arrival_time != 0 && feed_rate != 0 ) {
+					FPTYPE block_time = FPDIV(planner_distance, feed_rate);
+					FPTYPE keep = ( block_time < arrival_time ) ? FPDIV(block_time, arrival_time) : KCONSTANT_1;
+					slowdownScaling = KCONSTANT_1 - FPMULT2(KCONSTANT_1 - keep, KCONSTANT_1 - slowdownScaling);
+				}
 
-					block->nominal_rate = (uint32_t)FPTOI(FPMULT2(ITOFP((int32_t)block->nominal_rate),
-							slowdownScaling));
+				if ( slowdownScaling < KCONSTANT_1 ) {
+					if (feed_rate != 0) {
+						//At least minimum planner speed, or 0.5s, or computed slowdown.
+						//Only a floor over the computed slowdown changes the scaling.
+						FPTYPE slowest = max(minimumPlannerSpeed, planner_distance + planner_distance);
+						FPTYPE slowed = FPMULT2(feed_rate, slowdownScaling);
+						if ( slowed < slowest ) {
+							slowdownScaling = FPDIV(slowest, feed_rate);
+							slowed = slowest;
+						}
+						feed_rate = slowed;
+
+						block->nominal_rate = (uint32_t)FPTOI(FPMULT2(ITOFP((int32_t)block->nominal_rate),
+								slowdownScaling));
+					}
+					else
+						block->nominal_rate = (uint32_t)FPTOI(FPMULT2(ITOFP((int32_t)block->nominal_rate),
+								slowdownScaling));
 				}
-				else
-					block->nominal_rate = (uint32_t)FPTOI(FPMULT2(ITOFP((int32_t)block->nominal_rate),
-							slowdownScaling));
 			}
 		}
 		// END SLOWDOWN
 	#endif
 
+	// Left at zero without a feed rate, as the next block's junction reads
+	// them through prev_speed[]
 	FPTYPE current_speed[STEPPER_COUNT];
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+		current_speed[i] = 0;
 	FPTYPE inverse_millimeters = 0;
 
 	//If we have a feed_rate, we calculate some stuff early, because it's also needed for non-accelerated blocks
@@ -1178,25 +1948,40 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 		// Calculate speed in mm/second for each axis. No divide by zero due to previous checks.
 		inverse_second = FPMULT2(feed_rate, inverse_millimeters);
 
-		// Calculate speed in mm/sec for each axis
-		for(unsigned char i=0; i < STEPPER_COUNT; i++) {
+		// Calculate speed in mm/sec for each axis.  delta_mm[] is zero for the
+		// axes which aren't moving, so spare them the multiply
+		FOR_EACH_AXIS(i, planner_axes)
 			current_speed[i] = FPMULT2(delta_mm[i], inverse_second);
-		}
+
+		FPTYPE speed_factor = KCONSTANT_1;
 
 		// If the user has changed the print speed dynamically, then ensure that
 		//   the maximum feedrate limits are observed
 		if ( block->use_accel && steppers::alterSpeed ) {
-			FPTYPE speed_factor = KCONSTANT_1;
-			for (unsigned char i=0; i < STEPPER_COUNT; i++)
+			FOR_EACH_AXIS(i, planner_axes)
 				if ( FPABS(current_speed[i]) > stepperAxis[i].max_feedrate )
 					speed_factor = min(speed_factor, FPDIV(stepperAxis[i].max_feedrate, FPABS(current_speed[i])));
-			if ( speed_factor < KCONSTANT_1 ) {
-				for (unsigned char i=0; i < STEPPER_COUNT; i++)
-					current_speed[i] = FPMULT2(current_speed[i], speed_factor);
-				feed_rate = FPMULT2(feed_rate, speed_factor);
-				block->nominal_rate = (uint32_t)FPTOI(FPMULT2( ITOFP((int32_t)block->nominal_rate), speed_factor));
+		}
+
+		// Nor may a printing move extrude faster than the hot end can melt.
+		// Retracting along a travel isn't held to it.
+		if ( block->use_accel && ! extruder_only_move ) {
+			for ( uint8_t e = 0; e < EXTRUDERS; e++ ) {
+				FPTYPE limit = extruder_max_extrusion_speed[e];
+				bool negative = ( e == 0 ) ? ACCELERATION_EXTRUDE_WHEN_NEGATIVE_A : ACCELERATION_EXTRUDE_WHEN_NEGATIVE_B;
+				FPTYPE speed = current_speed[A_AXIS + e];
+				if ( negative ) speed = -speed;
+				if ( limit != 0 && speed > limit )
+					speed_factor = min(speed_factor, FPDIV(limit, speed));
 			}
 		}
+
+		if ( speed_factor < KCONSTANT_1 ) {
+			FOR_EACH_AXIS(i, planner_axes)
+				current_speed[i] = FPMULT2(current_speed[i], speed_factor);
+			feed_rate = FPMULT2(feed_rate, speed_factor);
+			block->nominal_rate = (uint32_t)FPTOI(FPMULT2( ITOFP((int32_t)block->nominal_rate), speed_factor));
+		}
 	}
 
 	//For code clarity purposes, we add to the buffer and drop out here for accelerated blocks
@@ -1212,7 +1997,7 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 		if ( feed_rate != 0 ) {
 			FPTYPE speed_factor = KCONSTANT_1; //factor <=1 do decrease speed
 
-			for(unsigned char i=0; i < STEPPER_COUNT; i++) {
+			FOR_EACH_AXIS(i, planner_axes) {
 				if(FPABS(current_speed[i]) > max_speed_change[i])
 					speed_factor = min(speed_factor, FPDIV(max_speed_change[i], FPABS(current_speed[i])));
 			}
@@ -1227,6 +2012,8 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 			if (speed_factor != KCONSTANT_1) {
 				for (uint8_t i = 0; i < STEPPER_COUNT; i++)
+					prev_speed[i] = 0;
+				FOR_EACH_AXIS(i, planner_axes)
 					prev_speed[i] = FPMULT2(current_speed[i], speed_factor);
 				docopy = false;
 			}
@@ -1243,6 +2030,11 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 				prev_speed[i] = current_speed[i];
 		}
 
+		// Without a feed rate, current_speed[] wasn't computed and we
+		// can't say which axes are still at rest
+		prev_speed_axes = ( feed_rate != 0 ) ? planner_axes : ALL_AXES_MASK;
+		prev_jd_speed = 0;
+
 		#ifdef SIMULATOR
 		        block->millimeters   = 0;
 			block->nominal_speed = feed_rate;
@@ -1269,11 +2061,17 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 	}
 
 	if ( ! extruder_only_move ) {
-		//If we have one item in the buffer, then control it's minimum time with minimumSegmentTime
-		if ((moves_queued < 1 ) && (minimumSegmentTime > 0) && ( block->millimeters > 0 ) &&
-		    ( feed_rate > 0 ) && (( FPDIV(block->millimeters, feed_rate) ) < minimumSegmentTime)) {
+		//If we have one item in the buffer, then control it's minimum time with minimumSegmentTime,
+		//or with the time to the next block if that's known to be less
+		FPTYPE segment_time = minimumSegmentTime;
+		if ( arrival_time != 0 && arrival_time < segment_time ) segment_time = arrival_time;
+		if ((moves_queued < 1 ) && (segment_time > 0) && ( block->millimeters > 0 ) &&
+		    ( feed_rate > 0 ) && ( block->millimeters < FPMULT2(feed_rate, segment_time) )) {
 			FPTYPE originalFeedRate  = feed_rate;
-			feed_rate = FPDIV(block->millimeters, minimumSegmentTime);
+			if ( segment_time == minimumSegmentTime )
+				feed_rate = FPMULT2(block->millimeters, inverse_minimum_segment_time);
+			else
+				feed_rate = FPDIV(block->millimeters, segment_time);
 			// block->nominal_rate <= 0x7fff (32,767 steps/s)
 			block->nominal_rate = (uint32_t)FPTOI(FPMULT2( ITOFP((int32_t)block->nominal_rate), FPDIV(feed_rate, originalFeedRate)));
 
@@ -1282,7 +2080,7 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 				snprintf(buf, sizeof(buf),
 					 "!!! Minimum segment time kicked in: old feed rate=%f; new feed rate=%f !!!\n",
 					 FPTOF(originalFeedRate), FPTOF(feed_rate));
-					 strlcat(block->message, buf, sizeof(block->message));
+					 strlcat(cold->message, buf, sizeof(cold->message));
 			#endif
 		}
 	}
@@ -1292,33 +2090,42 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	// Compute and limit the acceleration rate for the trapezoid generator.
 
-	// We're here limited to a max step event count of 0xffff
-	// For the Z-axis -- the highest res axis -- that amounts to 163.8 mm (65,535/400)
-	// Can increase by shifting right more
-
-	FPTYPE steps_per_mm;
-	if (block->step_event_count < 0x7fff)
-		steps_per_mm = FPMULT2(ITOFP((int32_t)block->step_event_count), inverse_millimeters);
-	else if (block->step_event_count < 0xffff)
-		steps_per_mm = FPMULT2(ITOFP((int32_t)block->step_event_count >> 1), inverse_millimeters << 1);
-	else if (block->step_event_count < 0x1ffff)
-		// Someone had a Z resolution of 630 steps/mm which made a 115.5 mm Z travel exceed 0xffff steps
-		steps_per_mm = FPMULT2(ITOFP((int32_t)block->step_event_count >> 2), inverse_millimeters << 2);
-	else
-		// Switch to floating point.  But if someone has this high of resolution for X | Y
-		// then they have bigger problems: not enough CPU cycles to run the stepper interrupt
-		// at the necessary frequency.
-		steps_per_mm = FTOFP(FPTOF(inverse_millimeters) * (float)block->step_event_count);
+	// In fixed point, step_event_count times inverse_millimeters is the integer
+	// product of the count with the bits of the FPTYPE.  That's exact whatever
+	// the count, so long moves need neither shifts nor float.
+	#ifdef FIXED
+		FPTYPE steps_per_mm = (FPTYPE)((int32_t)block->step_event_count * inverse_millimeters);
+	#else
+		FPTYPE steps_per_mm = inverse_millimeters * (float)block->step_event_count;
+	#endif
+
+	// A move which doesn't extrude takes the travel profile's limits
+	const uint32_t *accel_limit = axis_steps_per_sqr_second;
+	const uint32_t *accel_cutoff = axis_accel_step_cutoff;
+	const uint8_t *limiting_axes = accel_limiting_axes;
+	FPTYPE deviation = junction_deviation;
+#ifdef TRAVEL_ACCELERATION
+	if ( ! extruder_only_move && ( planner_axes & ~XYZ_AXES_MASK ) == 0 ) {
+		accel_limit = travel_steps_per_sqr_second;
+		accel_cutoff = travel_accel_step_cutoff;
+		limiting_axes = travel_limiting_axes;
+		if ( travel_junction_deviation != 0 )
+			deviation = travel_junction_deviation;
+	}
+#endif
 
 	// Limit acceleration per axis
 	// Start with the max axial acceleration for an axis
 	// with block->step_event_count since we're going to require
 	// acceleration_st <= max_acceleration[master-axis] anyway
-	block->acceleration_st = axis_steps_per_sqr_second[planner_master_steps_index]; // *
+	block->acceleration_st = accel_limit[planner_master_steps_index]; // *
 	// (uint32_t)FPTOI(steps_per_mm); // convert to: acceleration steps/sec^2
 
-	// Now skip this axis in our checks
-	uint8_t axes = planner_axes & ~(1 << planner_master_steps_index);
+	// Now skip this axis in our checks, and those which can't take the
+	// acceleration any lower.  The acceleration only ever comes down from
+	// the master's, and an axis with no fewer steps per sec^2 and no more
+	// steps than the master never holds it down.
+	uint8_t axes = planner_axes & limiting_axes[planner_master_steps_index];
 
 	//Assumptions made, due to the high value of acceleration_st / p_retract acceleration, dropped
 	//ceil and floating point multiply
@@ -1330,9 +2137,9 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
 	     if ( axes & (1 << i ) ) {
-		  if (block->step_event_count <= axis_accel_step_cutoff[i]) {
+		  if (block->step_event_count <= accel_cutoff[i]) {
 		       // We're below the cutoff: do the comparisons in 32 bits
-		       if ((block->acceleration_st * (uint32_t)block->steps[i]) > (axis_steps_per_sqr_second[i] * block->step_event_count))
+		       if ((block->acceleration_st * (uint32_t)block->steps[i]) > (accel_limit[i] * block->step_event_count))
 			    // We only need to reduce the acceleration to
 			    //
 			    //   axis_steps_per_sqr_second[i] * ( step_event_count / steps[i] )
@@ -1349,13 +2156,13 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 			    //
 			    // Note that Marlin does the same thing, although there's no code comments
 			    // in Marlin indicating if any thought was given to the matter or not.
-			    block->acceleration_st = axis_steps_per_sqr_second[i];
+			    block->acceleration_st = accel_limit[i];
 		  } else {
 		       // Above the cutoffs: do the comparisons in 64 bits
 		       if (((uint64_t)block->acceleration_st * (uint64_t)block->steps[i]) >
-			   ((uint64_t)axis_steps_per_sqr_second[i] * (uint64_t)block->step_event_count))
-			    // block->acceleration_st = (uint32_t)(((uint64_t)axis_steps_per_sqr_second[i] * (uint64_t)block->step_event_count) / (uint64_t)block->steps[i]);
-			    block->acceleration_st = axis_steps_per_sqr_second[i];
+			   ((uint64_t)accel_limit[i] * (uint64_t)block->step_event_count))
+			    // block->acceleration_st = (uint32_t)(((uint64_t)accel_limit[i] * (uint64_t)block->step_event_count) / (uint64_t)block->steps[i]);
+			    block->acceleration_st = accel_limit[i];
 		  }
 	     }
 	}
@@ -1368,26 +2175,26 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 	else if (block->acceleration_st <= 0x1FFFF)
 		// Acceleration limit to prevent overflow is 0x1FFFF / axis-steps-per-mm
 		// good up to about 327.67 mm/s^2 @ 400 steps/mm || 1,365.3 mm/s^2 @ 96 steps/mm
-		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>2), (steps_per_mm>>2));
+		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>2), FPRSHIFT(steps_per_mm, 2));
 	else if (block->acceleration_st <= 0x7FFFF)
 		// Acceleration limit to prevent overflow is 0x7FFFF / axis-steps-per-mm
 		// good up to 1311 mm/s^2 @ 400 steps/mm || 5,461 mm/s^2 @ 96 steps/mm
-		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>4), (steps_per_mm>>4));
+		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>4), FPRSHIFT(steps_per_mm, 4));
 	else
 		// Acceleration limit to prevent overflow is 0xFFFFF / axis-steps-per-mm
 		// good up to 2,621 mm/s^2 @ 400 steps/mm || 10,922 mm/s^2 @ 96 steps/mm
 		// STOP HERE SINCE JKN Advance K2 calculations limit accel to 0xFFFFF / axis-steps-per-mm
-		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>5), (steps_per_mm>>5));
+		block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>5), FPRSHIFT(steps_per_mm, 5));
 
 	#if 0
 		else if (block->acceleration_st <= 0x1FFFFF)
 			// Acceleration limit to prevent overflow is 0x1FFFFF / axis-steps-per-mm
 			// good up to 5,243 mm/s^2 @ 400 steps/mm || 21,845 mm/s^2 @ 96 steps/mm
-			block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>6), (steps_per_mm>>6));
+			block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>6), FPRSHIFT(steps_per_mm, 6));
 		else
 			// Acceleration limit to prevent overflow is 0x7FFFFF / axis-steps-permm
 			// good up to 20,972 mm/s^2 @ 400 steps/mm || 87,379 mm/s^2 @ 96 steps/mm
-			block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>8), (steps_per_mm>>8));
+			block->acceleration = FPDIV(ITOFP(((int32_t)block->acceleration_st)>>8), FPRSHIFT(steps_per_mm, 8));
 	#endif
 
 	// The value 8.388608 derives from the timer frequency used for
@@ -1413,15 +2220,68 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	FPTYPE scaling = KCONSTANT_1;
 	bool docopy = true;
+	FPTYPE unit[Z_AXIS + 1];
+	bool jd_move = deviation != 0 && !extruder_only_move && feed_rate != 0;
+	bool corner = false;
+	if ( jd_move ) {
+		for ( uint8_t i = 0; i <= Z_AXIS; i ++ )
+			unit[i] = FPMULT2(delta_mm[i], inverse_millimeters);
+		corner = prev_jd_speed != 0;
+	}
+
 	if ( moves_queued == 0 ) {
 	     vmax_junction = minimumPlannerSpeed;
 	     scaling = FPDIV(vmax_junction, block->nominal_speed);
 	} else if ( block->nominal_speed <= smallest_max_speed_change ) {
 	     vmax_junction = block->nominal_speed;
 	     // scaling remains KCONSTANT_1
+	} else if ( hint_speed != 0 ) {
+		// The host has done the sums below for this junction.  The axis
+		// speeds are scaled with its speed, for a block after this
+		// without a hint.
+		if ( hint_speed < block->nominal_speed ) {
+			scaling = FPDIV(hint_speed, block->nominal_speed);
+			vmax_junction = hint_speed;
+			for (uint8_t i = 0; i < STEPPER_COUNT; i++)
+				prev_speed[i] = 0;
+			FOR_EACH_AXIS(i, planner_axes)
+				prev_speed[i] = FPMULT2(current_speed[i], scaling);
+			docopy = false;
+		} else
+			vmax_junction = block->nominal_speed;
 	} else {
+		uint8_t jerk_axes = planner_axes | prev_speed_axes;
+
+		// Junction deviation: the fastest speed at which the corner can be
+		// taken on a circle which touches both moves and comes within
+		// junction_deviation of the corner, v^2 = a d sin(t/2) / (1 - sin(t/2))
+		// where t is the angle between the moves.  X, Y and Z are then left
+		// out of the max_speed_change limits, which still hold for the
+		// extruders.
+		if ( corner ) {
+			FPTYPE cos_dir = 0;
+			for ( uint8_t i = 0; i <= Z_AXIS; i ++ )
+				cos_dir += FPMULT2(unit[i], prev_unit[i]);
+
+			// sin(t/2) = sqrt((1 - cos(t))/2), and cos(t) = -cos_dir
+			FPTYPE sin_half = ( cos_dir > -KCONSTANT_1 ) ?
+				FPSQRT(FPMULT2(KCONSTANT_1 + cos_dir, KCONSTANT_0_5)) : 0;
+
+			// Within a few degrees of straight on, a move is taken at speed
+			if ( KCONSTANT_1 - sin_half > KCONSTANT_0_001 ) {
+				FPTYPE vmax = FPMULT2(FPSQRT(FPMULT2(block->acceleration, deviation)),
+						      FPSQRT(FPDIV(sin_half, KCONSTANT_1 - sin_half)));
+				if ( vmax < prev_jd_speed && vmax < block->nominal_speed )
+					scaling = FPDIV(vmax, block->nominal_speed);
+			}
+			if ( prev_jd_speed < FPMULT2(block->nominal_speed, scaling) )
+				scaling = FPDIV(prev_jd_speed, block->nominal_speed);
+			jerk_axes &= ~XYZ_AXES_MASK;
+		}
+
 		FPTYPE delta_v;
-		for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
+		// Axes at rest in this and the previous block have delta_v = 0
+		FOR_EACH_AXIS(i, jerk_axes) {
 			delta_v = FPABS(current_speed[i] - prev_speed[i]);
 			if ( delta_v > max_speed_change[i] ) {
 
@@ -1454,6 +2314,8 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 		if (scaling != KCONSTANT_1) {
 			vmax_junction = FPMULT2(block->nominal_speed, scaling);
 			for (uint8_t i = 0; i < STEPPER_COUNT; i++)
+				prev_speed[i] = 0;
+			FOR_EACH_AXIS(i, planner_axes)
 				prev_speed[i] = FPMULT2(current_speed[i], scaling);
 			docopy = false;
 		} else
@@ -1465,6 +2327,14 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 		for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
 			prev_speed[i] = current_speed[i];
 	}
+	prev_speed_axes = planner_axes;
+
+	if ( jd_move ) {
+		for ( uint8_t i = 0; i <= Z_AXIS; i ++ )
+			prev_unit[i] = unit[i];
+		prev_jd_speed = block->nominal_speed;
+	}
+	else prev_jd_speed = 0;
 
 	//END OF YET ANOTHER JERK
 
@@ -1479,7 +2349,9 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 
 	// It's the max. speed we can achieve if we accelerate the entire length of the block
 	//   starting with an initial speed of minimumPlannerSpeed
-	FPTYPE v_allowable = final_speed(block->acceleration,minimumPlannerSpeed,block->millimeters);
+	// A hinted block the host found too short to stop in needn't be tried
+	FPTYPE v_allowable = ( hint_speed != 0 && !planner_hint_nominal_length ) ? 0 :
+		final_speed(block->acceleration,minimumPlannerSpeed,block->millimeters);
 
 	// And this will typically produce a larger value
 	if (vmax_junction < minimumPlannerSpeed) {
@@ -1512,8 +2384,10 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 			block->use_advance_lead = false;
 			block->advance_lead_entry   = 0;
 			block->advance_lead_exit    = 0;
-			block->advance_lead_prime   = 0;
-			block->advance_lead_deprime = 0;
+			#ifdef JKN_ADVANCE_LEAD_DE_PRIME
+				cold->advance_lead_prime   = 0;
+				cold->advance_lead_deprime = 0;
+			#endif
 			block->advance_pressure_relax = 0;
 		} else {
 			block->use_advance_lead = true;
@@ -1560,6 +2434,26 @@ void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t
 }
 
 
+// Brings the stepper interrupt's position and toolhead into line with planner_position and
+// planner_toolhead as it finishes the last block queued, so that neither needs the buffer to
+// drain first.  The next block queued carries the position in its starting_position too, but
+// there may not be one for a while.  Must be called in a critical section
+
+static void planner_mark_position() {
+#ifndef SIMULATOR
+	st_mark_position(prev_block_index(block_buffer_head), planner_position, planner_toolhead);
+#else
+	//If the buffer is empty, we set the stepper position to match
+	if ( movesplanned() == 0 ) {
+		st_set_position(STEPPERS_(planner_position[X_AXIS],
+								  planner_position[Y_AXIS],
+								  planner_position[Z_AXIS],
+								  planner_position[A_AXIS],
+								  planner_position[B_AXIS]));
+	}
+#endif
+}
+
 #if EXTRUDERS > 1
 void plan_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 					   const int32_t &a, const int32_t &b)
@@ -1577,18 +2471,45 @@ void plan_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 	planner_position[B_AXIS] = b;
 #endif
 
-	//If the buffer is empty, we set the stepper position to match
-	if ( movesplanned() == 0 ) {
-		st_set_position(STEPPERS_(planner_position[X_AXIS], 
-								  planner_position[Y_AXIS],
-								  planner_position[Z_AXIS],
-								  planner_position[A_AXIS],
-								  planner_position[B_AXIS]));
-	}
+	planner_mark_position();
 
 	CRITICAL_SECTION_END;  // Fill variables used by the stepper in a critical section
 }
 
+#ifdef JKN_ADVANCE
+void plan_set_advance(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2)
+{
+	CRITICAL_SECTION_START;
+	extruder_advance_k  = extruderAdvanceK;
+	extruder_advance_k2 = extruderAdvanceK2;
+	CRITICAL_SECTION_END;
+}
+#endif
+
+void plan_set_toolhead(uint8_t active_toolhead)
+{
+	CRITICAL_SECTION_START;
+	planner_toolhead = active_toolhead;
+	planner_mark_position();
+	CRITICAL_SECTION_END;
+}
+
+#ifdef LIVE_Z_BABYSTEP
+void plan_shift_z(int32_t steps)
+{
+	for ( uint8_t i = block_buffer_tail; i != block_buffer_head; i = next_block_index(i) )
+		block_cold_buffer[i].starting_position[Z_AXIS] += steps;
+	#ifdef FAST_PAUSE
+		if ( parked.parked ) {
+			for ( uint8_t i = parked.tail; i != parked.head; i = next_block_index(i) )
+				block_cold_buffer[i].starting_position[Z_AXIS] += steps;
+			parked.position[Z_AXIS] += steps;
+		}
+	#endif
+	planner_position[Z_AXIS] += steps;
+}
+#endif
+
 #if EXTRUDERS > 1
 void plan_set_e_position(const int32_t &a, const int32_t &b)
 #else
@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include "avrfix.h"
 #include "Configuration.hh"
+#include "PinnedKinematics.hh"
 
 #ifdef SIMULATOR
 	#include "Simulator.hh"
@@ -45,6 +46,13 @@
 	#endif
 #endif
 
+#include "Kinematics.hh"
+
+// Live Z steps are for a Z which has a motor of its own
+#if defined(LIVE_Z_BABYSTEP) && ( ( KINEMATICS_MIXED_MASK & KINEMATICS_Z ) || defined(SIMULATOR) )
+	#undef LIVE_Z_BABYSTEP
+#endif
+
 #ifndef NOFIXED
 	#define FIXED
 #else
@@ -53,6 +61,14 @@
 	#endif
 #endif
 
+// Simulator builds check the fixed point arithmetic for overflow, and the
+// square roots against float, as they go.  SIMULATOR_UNCHECKED leaves the
+// checks out for just the arithmetic the AVR does, which is far faster
+// over big files and gives the same plan.
+#if defined(SIMULATOR) && !defined(SIMULATOR_UNCHECKED)
+	#define SIMULATOR_CHECKED
+#endif
+
 //Drop ceil/floor calculations.  Making this available as a #define so we can test timing later
 #define NO_CEIL
 
@@ -81,7 +97,7 @@
 	#define KCONSTANT_1000		65536000	//ftok(1000.0)
         #define KCONSTANT_1000000_LSR_16 1000000        //ftok(1000000.0) >> 16
 
-	#ifndef SIMULATOR
+	#ifndef SIMULATOR_CHECKED
 		//Type Conversions
 		#define FPTOI(x)		ktoli(x)	//FPTYPE  -> int32_t
 		#define FPTOI16(x)		ktoi(x)		//FPTYPE  -> int16_t
@@ -122,6 +138,9 @@
 		#define FPSCALE2(x)		fpscale2S((x),,__LINE__,__FILE__)
 	#endif
 
+	#define FPLSHIFT(x,n)		((x) << (n))	//FPTYPE times 2^n
+	#define FPRSHIFT(x,n)		((x) >> (n))	//FPTYPE over 2^n
+
 	#ifndef NO_CEIL
 		#define FPCEIL(x)	roundk(x + KCONSTANT_0_5, 3)
 	#endif
@@ -166,6 +185,8 @@
 	#define FPSQRT(x)		sqrt(x)
 	#define FPABS(x)		abs(x)
 	#define FPSCALE2(x)		((x) * 2.0)
+	#define FPLSHIFT(x,n)		ldexpf((x), (n))
+	#define FPRSHIFT(x,n)		ldexpf((x), -(n))
 
         #ifdef AUTO_LEVEL_TILT
                #define FATAN2(x,y)      atan2f(x,y)
@@ -201,8 +222,65 @@
 
 // The number of linear motions that can be in the plan at any give time.
 // THE BLOCK_BUFFER_SIZE NEEDS TO BE A POWER OF 2, i.g. 8,16,32 because shifts and ors are used to do the ringbuffering.
-// Values less than 16 would not be wise
-#define BLOCK_BUFFER_SIZE 16 // maximize block buffer
+// Values less than 16 would not be wise.  Platforms can override the default with PLATFORM_BLOCK_BUFFER_SIZE
+// in platforms.py.  The 2560 builds default to a deeper look-ahead as dense, short segment gcode otherwise
+// runs out of planned distance and gets planned down to minimumPlannerSpeed.  With the planner in
+// external SRAM (XMEM_PLANNER, see Xmem.hh), it looks as far ahead as the block indices can count.
+#ifdef PLATFORM_BLOCK_BUFFER_SIZE
+	#define BLOCK_BUFFER_SIZE PLATFORM_BLOCK_BUFFER_SIZE
+#elif defined(XMEM) && defined(XMEM_PLANNER)
+	#define BLOCK_BUFFER_SIZE 128
+#elif defined(__AVR_ATmega2560__) && !defined(SAVE_SPACE)
+	#define BLOCK_BUFFER_SIZE 32
+#else
+	#define BLOCK_BUFFER_SIZE 16 // maximize block buffer
+#endif
+
+#if ( BLOCK_BUFFER_SIZE & (BLOCK_BUFFER_SIZE - 1) ) != 0 || BLOCK_BUFFER_SIZE < 8 || BLOCK_BUFFER_SIZE > 128
+	#error "BLOCK_BUFFER_SIZE must be a power of 2 between 8 and 128"
+#endif
+
+// If defined, calculate_trapezoid_for_block() also converts the acceleration and deceleration
+// ramps of each block into RAMP_SEGMENTS precomputed stepper timer values each (see block_ramp_t).
+// st_interrupt() then only indexes into the table when a segment boundary is crossed instead of
+// running calc_timer() during acceleration and deceleration.  Costs about
+// (RAMP_SEGMENTS * 6 + 7) bytes of SRAM per block.  Not supported by the simulator.
+//#define PRECOMPUTED_RAMPS
+
+#if defined(PRECOMPUTED_RAMPS) && defined(SIMULATOR)
+	#undef PRECOMPUTED_RAMPS
+#endif
+
+#if defined(PRECOMPUTED_RAMPS) && !defined(RAMP_SEGMENTS)
+	#define RAMP_SEGMENTS 8
+#endif
+
+// If defined, st_interrupt() ramps the step rate along an S-curve rather than a straight
+// line: the rate follows the 6 point Bezier curve v0 + (v1 - v0)(10t^3 - 15t^4 + 6t^5) over
+// the time t the trapezoid's ramp takes, so the acceleration builds up and dies away smoothly
+// instead of changing in a step at each end of the ramp.  The ramps take the same time and
+// distance as the trapezoid's, so the planner is unchanged, but the acceleration peaks at 15/8
+// of the trapezoid's at the middle of a ramp.  Costs 8 bytes of SRAM per block, and the stepper
+// interrupt a few multiplies per ramp step.
+//#define S_CURVE_ACCELERATION
+
+#if defined(S_CURVE_ACCELERATION) && defined(PRECOMPUTED_RAMPS)
+	#error "S_CURVE_ACCELERATION can't be used with PRECOMPUTED_RAMPS, which precomputes straight ramps"
+#endif
+
+// If defined, a pause brings the steppers to a stop part way through the move they're making,
+// decelerating from its present rate, instead of stepping out everything that's buffered first.
+// The blocks left are parked with the planner's state while the pause moves are made, the one
+// cut short trimmed to what's left of it, and are put back to carry on from where it stopped on
+// resuming.  Costs about 70 bytes of SRAM.  Needs the straight ramps of st_interrupt() and the
+// motor steps in the blocks, so isn't available with PRECOMPUTED_RAMPS, S_CURVE_ACCELERATION or
+// CORE_XY_STEPPER, nor in the simulator.
+#define FAST_PAUSE
+
+#if defined(FAST_PAUSE) && ( defined(PRECOMPUTED_RAMPS) || defined(S_CURVE_ACCELERATION) || \
+			     defined(KINEMATICS_MIX_IN_STEPPER) || defined(SIMULATOR) )
+	#undef FAST_PAUSE
+#endif
 
 // When SAVE_SPACE is defined, the code doesn't take some optimizations which
 // which lead to additional program space usage.
@@ -214,7 +292,6 @@ typedef struct {
 	// Fields used by the bresenham algorithm for tracing the line
 	int32_t		steps[STEPPER_COUNT];			// Step count along each axis
 	uint32_t	step_event_count;			// The number of step events required to complete this block
-	int32_t		starting_position[STEPPER_COUNT];
 	int32_t		accelerate_until;			// The index of the step event on which to stop acceleration
 	int32_t		decelerate_after;			// The index of the step event on which to start decelerating
 	int32_t		acceleration_rate;			// The acceleration rate used for acceleration calculation
@@ -226,8 +303,6 @@ typedef struct {
 		int16_t	advance_lead_entry;
 		int16_t	advance_lead_exit;
 		int32_t	advance_pressure_relax;			//Decel phase only
-		int16_t	advance_lead_prime;
-		int16_t	advance_lead_deprime;
 	#endif
 
 	// Fields used by the motion planner to manage acceleration
@@ -247,31 +322,174 @@ typedef struct {
 	uint32_t	acceleration_st;			// acceleration steps/sec^2
 	char		use_accel;				// Use acceleration when true
 	char		speed_changed;				// Entry speed has changed
+	uint16_t	speed_factor;				// The speed factor the block was planned at, 8.8, 0 when it doesn't apply
 	volatile char	busy;
 
 	#ifdef SIMULATOR
 		FPTYPE	feed_rate;				// Original feed rate before being modified for nomimal_speed
 		int	planned;				// Count of the number of times the block was passed to caclulate_trapezoid_for_block()
-		char	message[1024];
 	#endif
 
 	#ifdef DEBUG_BLOCK_BY_MOVE_INDEX
 		uint32_t move_index;
 	#endif
 
+	#ifdef S_CURVE_ACCELERATION
+		// The time into a ramp, in 2 MHz ticks shifted right by *_time_shift (left
+		// if negative), times *_time_inverse >> 15 is how far through the ramp we are
+		// as a fraction of 0x10000; see planner_s_curve_ramp()
+		uint16_t	accel_rate_change;		// Rate at the end of the acceleration less initial_rate
+		uint16_t	accel_time_inverse;
+		uint16_t	decel_time_inverse;
+		int8_t		accel_time_shift;
+		int8_t		decel_time_shift;
+	#endif
+
 	uint8_t		dda_master_axis_index;
 	uint8_t		axesEnabled;
 } block_t;
 
+// Fields which are only touched when a block is created and when the stepper interrupt
+// first picks it up, or finishes it.  They're kept out of block_t in a parallel array (same index as
+// block_buffer) so that the planner passes walk a smaller struct and a deeper
+// BLOCK_BUFFER_SIZE fits in SRAM.
+typedef struct {
+	int32_t		starting_position[STEPPER_COUNT];
+	uint8_t		action_end;				// plan_action_head when the block was queued or last given an action
+	#if defined(JKN_ADVANCE) && defined(JKN_ADVANCE_LEAD_DE_PRIME)
+		int16_t	advance_lead_prime;
+		int16_t	advance_lead_deprime;
+	#endif
+	#ifdef SIMULATOR
+		char	message[1024];
+	#endif
+} block_cold_t;
+
+#ifdef PRECOMPUTED_RAMPS
+// Stepper timer values for a block, written by the planner at the same time as the trapezoid.
+// The acceleration ramp is split into RAMP_SEGMENTS segments of accel_segment_steps steps each,
+// which are followed by RAMP_SEGMENTS deceleration segments of decel_segment_steps steps each.
+// Timer values are as returned by calc_timer(), i.e. before OVERSAMPLED_DDA is applied.
+typedef struct {
+	uint16_t	accel_segment_steps;
+	uint16_t	decel_segment_steps;
+	uint16_t	nominal_timer;
+	uint8_t		nominal_loops;
+	uint16_t	timer[RAMP_SEGMENTS * 2];
+	uint8_t		loops[RAMP_SEGMENTS * 2];
+} block_ramp_t;
+#endif
+
 // Initialize the motion plan subsystem
 void plan_init(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2, bool zhold);
 
+// Called by plan_init(), and again whenever axis_steps_per_sqr_second[] is
+// changed after it
+void plan_set_accel_limits();
+
+#ifdef JKN_ADVANCE
+// Change the JKN advance K and K2 for the blocks planned from now on, the
+// ones already planned keep theirs
+void plan_set_advance(FPTYPE extruderAdvanceK, FPTYPE extruderAdvanceK2);
+#endif
+
 // Add a new linear movement to the buffer.
 void plan_buffer_line(FPTYPE feed_rate, const uint32_t &dda_rate, const uint8_t &extruder, bool use_accel, uint8_t active_toolhead);
 
+// FTOFP() without software float, for the floats which come with commands.
+// Truncates as FTOFP() does, and saturates at the limits of FPTYPE.
+FPTYPE plan_float_to_fp(float f);
+
 void planner_recalculate();
 
-// Set position. Used for G92 instructions.
+#ifdef FAST_PAUSE
+// With the steppers held by st_request_stop(), sets the blocks still buffered aside so that other
+// moves can be made, in_block when the stepper interrupt left the one at the tail part way, which
+// is trimmed to what's left of it.  planner_position becomes where the steppers stopped.  Returns
+// false, leaving the buffer as it is, when there were no blocks to set aside.
+bool plan_park(bool in_block);
+
+// Puts the parked blocks back once the moves made since have been stepped, the first of them
+// starting from rest, and planner_position back to where they end
+void plan_unpark();
+
+// Forgets about the parked blocks, which will never be stepped
+void plan_discard_parked();
+#endif
+
+// Commands other than moves which are to take effect in step with them: a fan, LED or heater
+// setting, or a pause, was read after the blocks already queued and so is taken up as they're
+// done.  The actions wait in a ring of PLAN_ACTIONS, a power of two, which needs no locking
+// against the stepper interrupt.  Only to be used from the main loop.
+#define PLAN_ACTIONS	8
+
+#define PLAN_ACTION_FAN			1	// arg[0]: the setting of the extra FET's fan
+#define PLAN_ACTION_TOOL_FAN		2	// arg[0]: tool, arg[1]: on
+#define PLAN_ACTION_TOOL_TEMP		3	// arg[0]: tool, arg[1..2]: the temperature, as sent
+#define PLAN_ACTION_PLATFORM_TEMP	4	// arg[1..2]: the temperature, as sent
+#define PLAN_ACTION_RGB_LED		5	// arg[0..2]: red, green and blue
+#define PLAN_ACTION_PAUSE		6	// Pause the build
+#define PLAN_ACTION_CHECKPOINT		7	// Keep the power loss checkpoint taken
+#define PLAN_ACTION_LAYER		8	// A layer starts; arg[0..2]: mm of the last, in hundredths
+
+typedef struct {
+	uint8_t		type;
+	uint8_t		arg[3];
+} plan_action_t;
+
+// Queues the action to be taken up once the stepper interrupt has finished the last block
+// queued.  Returns false, leaving the action with the caller, when no blocks are queued, or
+// when there's no room; see plan_action_room()
+bool plan_queue_action(const plan_action_t *action);
+
+// How many more actions can be queued
+uint8_t plan_action_room();
+
+// Copies out the next action whose blocks are done and returns true, false when there's none
+bool plan_take_action(plan_action_t *action);
+
+// Whether any actions are queued, whether or not their blocks are done
+bool plan_actions_pending();
+
+// Forgets the queued actions, along with the blocks they're waiting for
+void plan_drop_actions();
+
+extern volatile uint8_t	plan_action_ready;	// Written by the stepper interrupt as blocks finish
+
+#ifdef ESTIMATE_TIME
+// Motion time, from the blocks' trapezoids, of the blocks run since
+// plan_reset_motion_time() and of those still queued
+void plan_get_motion_time(uint32_t *run_ms, uint32_t *queued_ms);
+void plan_reset_motion_time();
+
+// Time a block's trapezoid takes, in milliseconds
+uint32_t plan_block_time_ms(const block_t *block);
+#endif
+
+#ifdef PLANNER_STATS
+// The nominal speeds of the blocks run are counted in PLANNER_STATS_BUCKETS
+// buckets of PLANNER_STATS_BUCKET_MM_S mm/s each, the last taking all faster
+#define PLANNER_STATS_BUCKETS		12
+#define PLANNER_STATS_BUCKET_MM_S	15
+
+// Counts of the blocks run since plan_stats_reset(), taken from their
+// trapezoids as the stepper interrupt finishes with them
+typedef struct {
+	uint32_t	blocks;
+	uint32_t	reached_nominal;			// Cruised at their nominal speed, the rest were triangles
+	uint32_t	full_stops;				// Started from rest
+	uint32_t	accel_ms;				// Time accelerating, cruising and decelerating
+	uint32_t	cruise_ms;
+	uint32_t	decel_ms;
+	uint16_t	histogram[PLANNER_STATS_BUCKETS];	// Halved when a bucket would overflow
+} planner_stats_t;
+
+void plan_stats_get(planner_stats_t *stats);
+void plan_stats_reset();
+#endif
+
+// Set position. Used for G92 instructions.  The stepper interrupt takes it up once it's
+// through the blocks already queued
 #if EXTRUDERS > 1
 void plan_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 					   const int32_t &a, const int32_t &b);
@@ -282,6 +500,16 @@ void plan_set_position(const int32_t &x, const int32_t &y, const int32_t &z,
 void plan_set_e_position(const int32_t &a);
 #endif
 
+#ifdef LIVE_Z_BABYSTEP
+// Moves the planner's Z, the starting positions of the blocks queued and those of any parked,
+// by steps, for st_babystep_z().  With interrupts off.
+void plan_shift_z(int32_t steps);
+#endif
+
+// Changes the toolhead the stepper position is reported with, once the stepper interrupt is
+// through the blocks already queued.  Those queued after carry their own
+void plan_set_toolhead(uint8_t active_toolhead);
+
 #ifndef SIMULATOR
 	#define SIMULATOR_RECORD(x...)
 #else
@@ -293,17 +521,22 @@ void plan_set_e_position(const int32_t &a);
 #endif
 
 extern uint32_t		minsegmenttime;
-extern uint32_t		max_acceleration_units_per_sq_second[STEPPER_COUNT];	// Use M201 to override by software
+extern PINNED_CONST uint32_t	max_acceleration_units_per_sq_second[STEPPER_COUNT];	// Use M201 to override by software
 extern FPTYPE		max_speed_change[STEPPER_COUNT];			//The speed between junctions in the planner, reduces blobbing
 extern FPTYPE		smallest_max_speed_change;
+extern FPTYPE		junction_deviation;
+extern FPTYPE		extruder_max_extrusion_speed[EXTRUDERS];
+extern FPTYPE		planner_hint_speed;
+extern bool		planner_hint_nominal_length;
 
 extern FPTYPE		minimumSegmentTime;
 extern bool 		disable_slowdown;
-extern uint32_t		axis_steps_per_sqr_second[STEPPER_COUNT];
+extern PINNED_CONST uint32_t	axis_steps_per_sqr_second[STEPPER_COUNT];
 extern bool		acceleration_zhold;
 extern uint8_t          planner_axes;
 extern FPTYPE		delta_mm[STEPPER_COUNT];
 extern FPTYPE		planner_distance;
+extern uint16_t		planner_speed_factor;
 extern FPTYPE		minimumPlannerSpeed;
 extern uint32_t		planner_master_steps;
 extern uint8_t		planner_master_steps_index;
@@ -311,15 +544,22 @@ extern int32_t		planner_steps[STEPPER_COUNT];
 extern uint8_t		slowdown_limit;
 extern int32_t		planner_position[STEPPER_COUNT];
 extern int32_t		planner_target[STEPPER_COUNT];
-extern uint32_t		axis_accel_step_cutoff[STEPPER_COUNT];
+extern PINNED_CONST uint32_t	axis_accel_step_cutoff[STEPPER_COUNT];
+#ifdef TRAVEL_ACCELERATION
+extern uint32_t		travel_steps_per_sqr_second[STEPPER_COUNT];
+extern uint32_t		travel_accel_step_cutoff[STEPPER_COUNT];
+extern FPTYPE		travel_junction_deviation;
+#endif
 extern block_t		block_buffer[BLOCK_BUFFER_SIZE];			// A ring buffer for motion instfructions
+extern block_cold_t	block_cold_buffer[BLOCK_BUFFER_SIZE];			// Rarely used block fields, indexed as block_buffer
+#ifdef PRECOMPUTED_RAMPS
+extern block_ramp_t	block_ramp_buffer[BLOCK_BUFFER_SIZE];			// Precomputed timer values, indexed as block_buffer
+#endif
 
 extern volatile unsigned char	block_buffer_head;				// Index of the next block to be pushed
 extern volatile unsigned char	block_buffer_tail;
 
-#if defined(CORE_XY)
-extern int32_t          delta_ab[2];
-#elif defined(CORE_XYZ)
+#ifdef KINEMATICS_MIX_IN_PLANNER
 extern int32_t          delta_ab[3];
 #endif
 
@@ -353,6 +593,13 @@ FORCE_INLINE block_t *plan_get_current_block()
 	return(block);
 }
 
+// Returns the rarely used fields for a block.  When the block index is at hand,
+// index block_cold_buffer directly instead as this costs a pointer division.
+FORCE_INLINE block_cold_t *plan_block_cold(const block_t *block)
+{
+	return &block_cold_buffer[block - block_buffer];
+}
+
 // Gets the current block. Returns NULL if buffer empty
 FORCE_INLINE bool blocks_queued()
 {
@@ -0,0 +1,31 @@
+#ifndef STEPPERACCELRATES_HH
+#define STEPPERACCELRATES_HH
+
+// The step rates the stepper interrupt is timed around.  This is plain C with
+// no avr-libc, as StepperAccelSpeedTableBuild.c is built for the host from it
+// to size and check the speed lookup tables.
+
+#define MAX_STEP_FREQUENCY 40000
+
+// Step rates beyond which 2, 4 and 8 steps are taken per interrupt
+#if !defined(USB_LOW_PRIORITY)
+#define STEP_RATE_LOW   4864
+#define STEP_RATE_MED   9984
+#define STEP_RATE_HIGH 19968
+#else
+#define STEP_RATE_LOW   9984
+#define STEP_RATE_MED  19968
+#define STEP_RATE_HIGH 39936  // be careful of this being treated as a int16_t
+#endif
+
+// The highest rate rate_to_timer() is asked for, once the step rate has been
+// divided by the steps taken per interrupt.  calc_timer_and_loops() compares
+// the high bytes of the rates only, so a rate anywhere in the 256 steps/s above
+// STEP_RATE_LOW is still taken one step at a time.
+#ifdef ADAPTIVE_MULTISTEP
+#define TIMER_STEP_RATE_MAX STEP_RATE_MED
+#else
+#define TIMER_STEP_RATE_MAX (STEP_RATE_LOW | 0xff)
+#endif
+
+#endif
@@ -1,49 +1,179 @@
+/*
+ * StepperAccelSpeedTableBuild.c - generates StepperAccelSpeedTable.hh
+ *
+ * rate_to_timer() in StepperAccel.cc turns a step rate into the stepper
+ * timer interval by interpolating between the entries of two tables, rather
+ * than by dividing.  This writes those tables to stdout for one set of build
+ * options: it's compiled for the host with the -D flags of the firmware,
+ * which give F_CPU, USB_LOW_PRIORITY, ADAPTIVE_MULTISTEP and the like.
+ *
+ * The fast table is only as long as the highest rate rate_to_timer() can be
+ * given (TIMER_STEP_RATE_MAX) needs, which saves most of its 1KB of flash.
+ *
+ * Every rate from 32 up to that rate is then run through the same integer
+ * interpolation as the firmware and compared with the division it replaces.
+ * The interval may be off by the tolerance, which the lowest rates need most
+ * of: the slow table is sparse for them.  Shifted right by each number of dda
+ * oversampling bits the build may use, it must stay non-zero and be out by no
+ * more than a count beyond that.  Exits non-zero, without writing the tables,
+ * when either isn't so.
+ *
+ * Usage: StepperAccelSpeedTableBuild [-r max_rate] [-b bits] [-t tolerance]
+ *
+ *   -r max_rate   Highest step rate to cover (default TIMER_STEP_RATE_MAX),
+ *                 65535 gives the full fast table
+ *   -b bits       Most oversampling bits to check the intervals for (default
+ *                 OVERSAMPLED_DDA or AMASS_MAX_LEVEL when defined, else 3)
+ *   -t tolerance  Largest error allowed, in percent of the interval
+ *                 (default 1.5)
+ */
+
 #include <stdio.h>
-#include <math.h>
 #include <stdlib.h>
-#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "StepperAccelRates.hh"
+
+#ifndef F_CPU
+#define F_CPU 16000000L
+#endif
 
-#define TIMER_FREQ 2000000
+// The stepper timer runs with a prescaler of 8
+#define TIMER_FREQ	((long)(F_CPU) / 8)
 
-main()
+#define MIN_RATE	32
+
+#if defined(OVERSAMPLED_DDA)
+#define DEFAULT_BITS	OVERSAMPLED_DDA
+#elif defined(AMASS_DDA) && defined(AMASS_MAX_LEVEL)
+#define DEFAULT_BITS	AMASS_MAX_LEVEL
+#else
+#define DEFAULT_BITS	3
+#endif
+
+static long fast[256][2], slow[256][2];
+
+static void build(long table[256][2], int entries, int spacing)
 {
-  int i,j;
-  int array[256][2];
-  printf("#ifndef SPEED_LOOKUPTABLE_H\n");
-  printf("#define SPEED_LOOKUPTABLE_H\n");
-  printf("\n");    
-  printf("#include <avr/pgmspace.h>\n");
-  printf("\n");    
-  printf("uint16_t speed_lookuptable_fast[256][2] PROGMEM = {\n");
-  for(i=0;i<256;i++){
-     array[i][0] = TIMER_FREQ / ((i*256)+32);
-  }
-  for(i=0;i<255;i++){
-     array[i][1] = array[i][0] - array[i+1][0];
-  }
-  array[255][1] = array[254][1];
-  for(i=0;i<32;i++) {
-    for(j=0;j<8;j++) {
-      printf("{ %d, %d}, ", array[i*8+j][0], array[i*8+j][1]);
-    } 
-    printf("\n");    
-  }
-  printf("};\n");    
-  printf("uint16_t speed_lookuptable_slow[256][2] PROGMEM = {\n");
-  for(i=0;i<256;i++){
-     array[i][0] = TIMER_FREQ / ((i*8)+32);
-  }
-  for(i=0;i<255;i++){
-     array[i][1] = array[i][0] - array[i+1][0];
-  }
-  array[255][1] = array[254][1];
-  for(i=0;i<32;i++) {
-    for(j=0;j<8;j++) {
-      printf("{ %d, %d}, ", array[i*8+j][0], array[i*8+j][1]);
-    } 
-    printf("\n");    
-  }
-  printf("};\n");    
-  printf("\n");
-  printf("#endif\n");
+     int i;
+
+     // The gain of the last entry comes from the rate just past the table, so
+     // interpolating up to the end of it still makes sense
+     for (i = 0; i < entries; i++)
+	  table[i][0] = TIMER_FREQ / (i * spacing + MIN_RATE);
+     for (i = 0; i < entries; i++)
+	  table[i][1] = table[i][0] - TIMER_FREQ / ((i + 1) * spacing + MIN_RATE);
+}
+
+// rate_to_timer(), in the integer arithmetic of the firmware
+static long interpolate(long step_rate)
+{
+     long *e;
+
+     step_rate -= MIN_RATE;
+     if (step_rate >= 8 * 256) {
+	  e = fast[step_rate >> 8];
+	  // MultiU16X8toH16() rounds the product to the nearest
+	  return(e[0] - (((step_rate & 0xff) * e[1] + 0x80) >> 8));
+     }
+     e = slow[step_rate >> 3];
+     return(e[0] - ((e[1] * (step_rate & 7)) >> 3));
+}
+
+static int check(long max_rate, int max_bits, double tolerance)
+{
+     long rate, timer, divided, worst_rate = 0;
+     int bits;
+     double err, worst = 0.0;
+
+     for (rate = MIN_RATE; rate <= max_rate; rate++) {
+	  timer = interpolate(rate);
+	  divided = TIMER_FREQ / rate;
+	  if (timer <= 0 || timer > 0xffffL) {
+	       fprintf(stderr, "The interval for %ld steps/s, %ld, doesn't fit the timer\n",
+		       rate, timer);
+	       return(-1);
+	  }
+
+	  err = fabs((double)(timer - divided)) * (double)rate / (double)TIMER_FREQ;
+	  if (err > worst) {
+	       worst = err;
+	       worst_rate = rate;
+	  }
+
+	  // The oversampled dda is given the interval shifted right, which may
+	  // round it a count further out
+	  for (bits = 1; bits <= max_bits; bits++) {
+	       if ((timer >> bits) == 0 ||
+		   labs((timer >> bits) - (divided >> bits)) > (labs(timer - divided) >> bits) + 1) {
+		    fprintf(stderr, "The interval for %ld steps/s with %d oversampling "
+			    "bits is %ld, not %ld\n", rate, bits, timer >> bits, divided >> bits);
+		    return(-1);
+	       }
+	  }
+     }
+
+     fprintf(stderr, "Speed tables for %ld steps/s at %ld Hz: worst error %.3f%% at %ld steps/s\n",
+	     max_rate, TIMER_FREQ, worst * 100.0, worst_rate);
+     if (worst * 100.0 > tolerance) {
+	  fprintf(stderr, "That's more than the %.3f%% allowed\n", tolerance);
+	  return(-1);
+     }
+     return(0);
+}
+
+static void print(const char *name, long table[256][2], int entries)
+{
+     int i;
+
+     printf("const uint16_t %s[%d][2] PROGMEM = {\n", name, entries);
+     for (i = 0; i < entries; i++)
+	  printf("{ %ld, %ld}%s", table[i][0], table[i][1],
+		 (i == entries - 1) ? "\n" : ((i & 7) == 7) ? ",\n" : ", ");
+     printf("};\n\n");
+}
+
+int main(int argc, char **argv)
+{
+     long max_rate = TIMER_STEP_RATE_MAX;
+     int c, fast_entries, max_bits = DEFAULT_BITS;
+     double tolerance = 1.5;
+
+     while ((c = getopt(argc, argv, "b:r:t:")) != -1) {
+	  switch (c) {
+	  case 'b' : max_bits  = atoi(optarg); break;
+	  case 'r' : max_rate  = atol(optarg); break;
+	  case 't' : tolerance = atof(optarg); break;
+	  default :
+	       fprintf(stderr, "Usage: %s [-r max_rate] [-b bits] [-t tolerance]\n", argv[0]);
+	       return(1);
+	  }
+     }
+
+     if (max_rate < MIN_RATE + 8 * 256 || max_rate > 0xffffL || max_bits < 0 || max_bits > 7) {
+	  fprintf(stderr, "A rate from %d to 65535 and up to 7 bits, please\n", MIN_RATE + 8 * 256);
+	  return(1);
+     }
+
+     fast_entries = (int)((max_rate - MIN_RATE) >> 8) + 1;
+     build(fast, fast_entries, 256);
+     build(slow, 256, 8);
+
+     if (check(max_rate, max_bits, tolerance))
+	  return(1);
+
+     printf("#ifndef STEPPERACCELSPEEDTABLE_HH\n");
+     printf("#define STEPPERACCELSPEEDTABLE_HH\n\n");
+     printf("// Generated by StepperAccelSpeedTableBuild.c -r %ld -b %d\n\n", max_rate, max_bits);
+     printf("#include <inttypes.h>\n");
+     printf("#include <avr/pgmspace.h>\n\n");
+     printf("#define SPEED_TABLE_TIMER_FREQ %ld\n", TIMER_FREQ);
+     printf("#define SPEED_TABLE_MAX_RATE %ld\n", max_rate);
+     printf("#define SPEED_TABLE_OVERSAMPLE_BITS %d\n\n", max_bits);
+     print("speed_lookuptable_fast", fast, fast_entries);
+     print("speed_lookuptable_slow", slow, 256);
+     printf("#endif\n");
+
+     return(0);
 }
@@ -87,15 +87,112 @@ struct StepperAxis stepperAxis[STEPPER_COUNT];
 volatile int32_t dda_position[STEPPER_COUNT];
 volatile bool    axis_homing[STEPPER_COUNT];
 volatile int16_t e_steps[EXTRUDERS];
+#ifdef INPUT_SHAPING
+volatile int16_t shaper_command[Y_AXIS + 1];
+#endif
 volatile uint8_t axesEnabled;			//Planner axis enabled
 volatile uint8_t axesHardwareEnabled;		//Hardware axis enabled
 
+#ifdef AMASS_DDA
+uint8_t amass_level = 0;			//Oversampling bits for the current block
+#endif
+
+#if defined(ENDSTOPS_LATCHED) && !defined(SIMULATOR)
+volatile uint8_t endstops_latched;
+uint8_t endstops_inverted;
+uint8_t endstops_enabled;
+
+void stepperAxisLatchEndstopsSetup() {
+	uint8_t inverted = 0, enabled = 0;
+
+	for ( uint8_t i = X_AXIS; i <= Z_AXIS; i ++ ) {
+		if ( stepperAxis[i].invert_endstop )
+			inverted |= ENDSTOP_MIN(i) | ENDSTOP_MAX(i);
+		if ( ! STEPPER_IOPORT_NULL(stepperAxisPorts[i].maximum) )
+			enabled |= ENDSTOP_MAX(i);
+		if ( ! STEPPER_IOPORT_NULL(stepperAxisPorts[i].minimum)
+#if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
+		     && ! stepperAxis[i].disabled_endstop
+#endif
+		   )
+			enabled |= ENDSTOP_MIN(i);
+	}
+
+	endstops_inverted = inverted;
+	endstops_enabled = enabled;
+}
+#endif
+
+#ifdef PINNED_KINEMATICS
+static const float pinned_steps_per_mm[STEPPER_COUNT] PROGMEM = PINNED_AXES(PINNED_STEPS_PER_MM);
+static const uint32_t pinned_max_feedrates[STEPPER_COUNT] PROGMEM = PINNED_AXES(PINNED_MAX_FEEDRATE);
+#endif
+
+/// Load an axis' steps per mm, max feedrate and length from the EEPROM, and
+/// the jog interval and step limits made from them.  With PINNED_KINEMATICS
+/// the steps per mm and max feedrate are the platform's.
+void stepperAxisLoadSettings(uint8_t axis) {
+#ifdef PINNED_KINEMATICS
+	stepperAxis[axis].steps_per_mm = pgm_read_float(&pinned_steps_per_mm[axis]);
+	stepperAxis[axis].max_feedrate = FTOFP((float)pgm_read_dword(&pinned_max_feedrates[axis]) / 60.0);
+#else
+	stepperAxis[axis].steps_per_mm = (float)eeprom::getEeprom32(eeprom_offsets::AXIS_STEPS_PER_MM + axis * sizeof(uint32_t),
+						   	         AXIS_DEFAULT(replicator_axis_steps_per_mm::axis_steps_per_mm, axis)) / 1000000.0;
+
+	stepperAxis[axis].max_feedrate = FTOFP((float)eeprom::getEeprom32(eeprom_offsets::AXIS_MAX_FEEDRATES + axis * sizeof(uint32_t),
+								       AXIS_DEFAULT(replicator_axis_max_feedrates::axis_max_feedrates, axis)) / 60.0);
+#endif
+
+	// max jogging speed for an axis is the min count of microseconds per step
+	// min us/step = (1000000 us/s) / [ (max mm/s) * (axis steps/mm) ]
+	int32_t f = (int32_t)(stepperAxis[axis].steps_per_mm * FPTOF(stepperAxis[axis].max_feedrate));
+	stepperAxis[axis].min_interval = f ? 1000000 / f : 500;
+
+	//Read the axis lengths in
+	int32_t length = (int32_t)((float)eeprom::getEeprom32(eeprom_offsets::AXIS_LENGTHS + axis * sizeof(uint32_t), AXIS_DEFAULT(replicator_axis_lengths::axis_lengths, axis)) *
+				    stepperAxis[axis].steps_per_mm);
+	int32_t *axisMin = &stepperAxis[axis].min_axis_steps_limit;
+	int32_t *axisMax = &stepperAxis[axis].max_axis_steps_limit;
+
+	switch(axis) {
+	case X_AXIS:
+	case Y_AXIS:
+		//Half the axis in either direction around the center point
+		*axisMax = length / 2;
+		*axisMin = - (*axisMax);
+		break;
+	case Z_AXIS:
+		// ***** WARNING *****
+		// The following assumes the Z home offset is close to zero.  Thus
+		// there's an implicit assumption that Z min homing is done.  If Z max
+		// homing is done instead, then #define Z_HOME_MAX
+#ifndef Z_HOME_MAX
+		//Z is special, as 0 as at the top, so min is 0, and max = length - Z Home Offset
+		*axisMax = length - (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + axis * sizeof(uint32_t), 0);
+#else
+		//We home to Z max and so axis min = 0 and axis max is Z Home Position
+		*axisMax = (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + axis * sizeof(uint32_t), 0);
+#endif
+		*axisMin = 0;
+		break;
+	case A_AXIS:
+	case B_AXIS:
+		*axisMax = length;
+		*axisMin = - length;
+		break;
+	}
+}
+
 /// Initialize a stepper axis
 void stepperAxisInit(bool hard_reset) {
 	uint8_t axes_invert = 0, endstops_invert = 0;
 	if ( hard_reset ) {
 		//Load the defaults
+#ifdef PINNED_KINEMATICS
+		axes_invert	= PLATFORM_AXIS_INVERT;
+#else
 		axes_invert	= eeprom::getEeprom8(eeprom_offsets::AXIS_INVERSION, 0);
+#endif
 		endstops_invert = eeprom::getEeprom8(eeprom_offsets::ENDSTOP_INVERSION, 0);
 #if defined(PSTOP_SUPPORT)
 		if ( !pstop_enabled ) {
@@ -130,50 +227,7 @@ void stepperAxisInit(bool hard_reset) {
 			stepperAxis[i].invert_endstop = !endstops_present || ((endstops_invert & (1<<i)) != 0);
 			stepperAxis[i].invert_axis = (axes_invert & (1<<i)) != 0;
 
-			stepperAxis[i].steps_per_mm = (float)eeprom::getEeprom32(eeprom_offsets::AXIS_STEPS_PER_MM + i * sizeof(uint32_t),
-								   	         replicator_axis_steps_per_mm::axis_steps_per_mm[i]) / 1000000.0;
-
-			stepperAxis[i].max_feedrate = FTOFP((float)eeprom::getEeprom32(eeprom_offsets::AXIS_MAX_FEEDRATES + i * sizeof(uint32_t),
-										       replicator_axis_max_feedrates::axis_max_feedrates[i]) / 60.0);
-
-			// max jogging speed for an axis is the min count of microseconds per step
-			// min us/step = (1000000 us/s) / [ (max mm/s) * (axis steps/mm) ]
-			int32_t f = (int32_t)(stepperAxis[i].steps_per_mm * FPTOF(stepperAxis[i].max_feedrate));
-			stepperAxis[i].min_interval = f ? 1000000 / f : 500;
-
-			//Read the axis lengths in
-			int32_t length = (int32_t)((float)eeprom::getEeprom32(eeprom_offsets::AXIS_LENGTHS + i * sizeof(uint32_t), replicator_axis_lengths::axis_lengths[i]) *
-						    stepperAxis[i].steps_per_mm);
-			int32_t *axisMin = &stepperAxis[i].min_axis_steps_limit;
-			int32_t *axisMax = &stepperAxis[i].max_axis_steps_limit;
-
-			switch(i) {
-			case X_AXIS:
-			case Y_AXIS:
-				//Half the axis in either direction around the center point
-				*axisMax = length / 2;
-				*axisMin = - (*axisMax);
-				break;
-			case Z_AXIS:
-				// ***** WARNING *****
-				// The following assumes the Z home offset is close to zero.  Thus
-				// there's an implicit assumption that Z min homing is done.  If Z max
-				// homing is done instead, then #define Z_HOME_MAX
-#ifndef Z_HOME_MAX
-				//Z is special, as 0 as at the top, so min is 0, and max = length - Z Home Offset
-				*axisMax = length - (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + i * sizeof(uint32_t), 0);
-#else
-				//We home to Z max and so axis min = 0 and axis max is Z Home Position
-				*axisMax = (int32_t)eeprom::getEeprom32(eeprom_offsets::AXIS_HOME_POSITIONS_STEPS + i * sizeof(uint32_t), 0);
-#endif
-				*axisMin = 0;
-				break;
-			case A_AXIS:
-			case B_AXIS:
-				*axisMax = length;
-				*axisMin = - length;
-				break;
-			}
+			stepperAxisLoadSettings(i);
 
 			//Setup the pins
 			STEPPER_IOPORT_SET_DIRECTION(stepperAxisPorts[i].dir, true);
@@ -205,6 +259,9 @@ void stepperAxisInit(bool hard_reset) {
 		//Setup the higher level stuff functionality / create the ddas
 		axis_homing[i]				= false;
 		stepperAxis[i].dda.eAxis		= (i >= A_AXIS) ? true : false;
+#ifdef INPUT_SHAPING
+		stepperAxis[i].dda.shaped		= false;
+#endif
 		stepperAxis[i].dda.counter		= 0;
 		stepperAxis[i].dda.direction		= 1;
 		stepperAxis[i].dda.stepperDir		= false;
@@ -234,6 +291,10 @@ void stepperAxisInit(bool hard_reset) {
 
 	for (uint8_t i = 0; i < EXTRUDERS; i ++ )
 		e_steps[i] = 0;
+
+#if defined(ENDSTOPS_LATCHED) && !defined(SIMULATOR)
+	stepperAxisLatchEndstopsSetup();
+#endif
 }
 
 /// Returns the steps per mm for the given axis
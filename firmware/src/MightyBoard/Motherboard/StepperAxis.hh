@@ -98,18 +98,45 @@ struct StepperIOPort {
 
 #define STEPPER_NULL	{ 0, 0, 0, 0 }
 
+// If defined, the steps of X and Y are put out through an input shaper, a ZV or ZVD
+// filter set by eeprom_offsets::INPUT_SHAPER which cancels the ringing of each axis at
+// its resonant frequency.  The dda counts the axis' steps into shaper_command[] and
+// st_shaper_step() in StepperAccel.cc steps the axis.  INPUT_SHAPER_HISTORY samples of
+// the commanded positions, one every 512us, are kept for the delayed impulses; the
+// default of 64 allows delays of up to 32ms.  Costs 4 bytes of SRAM per sample.
+//#define INPUT_SHAPING
+
+#if defined(INPUT_SHAPING) && defined(SIMULATOR)
+	#undef INPUT_SHAPING
+#endif
+
+#ifdef INPUT_SHAPING
+	#if KINEMATICS_MIXED_MASK
+		#error "INPUT_SHAPING doesn't support the Core XY kinematics, whose endstops depend on both motors"
+	#endif
+	#ifndef INPUT_SHAPER_HISTORY
+		#define INPUT_SHAPER_HISTORY 64
+	#endif
+	#if ( INPUT_SHAPER_HISTORY & (INPUT_SHAPER_HISTORY - 1) ) != 0 || INPUT_SHAPER_HISTORY > 128
+		#error "INPUT_SHAPER_HISTORY must be a power of 2 no more than 128"
+	#endif
+#endif
+
 struct dda {
         bool    master;         //True if this is the master steps axis
         int32_t master_steps;   //The number of steps for the master axis
         bool    eAxis;          //True if this is the e axis
         char    direction;      //Direction of the dda, 1 = forward, -1 = backwards
         bool    stepperDir;     //The direction the stepper gets sent in
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-        bool    positiveDir;    //For purposes of CoreXY homing, direction is positive (true)
+#if KINEMATICS_MIXED_MASK
+        bool    positiveDir;    //For the endstops of mixed motors, the carriage heads for max (true)
 #endif
 	bool	enabled;	//True if this dda is enabled, 0 if target is reached or
 				//this axis isn't moving. (Z and 1 extruder frequently don't move)
 				//This variable acts to speed up processing.
+#ifdef INPUT_SHAPING
+	bool	shaped;		//True if the steps go through the input shaper
+#endif
 
         int32_t counter;                //Used for the dda counter
         int32_t steps_completed;        //Number of steps completed
@@ -145,21 +172,53 @@ extern struct StepperAxis 	stepperAxis[STEPPER_COUNT];
 
 extern volatile int32_t dda_position[STEPPER_COUNT];
 extern volatile int16_t e_steps[EXTRUDERS];
+#ifdef INPUT_SHAPING
+extern volatile int16_t shaper_command[Y_AXIS + 1];	//Steps counted by the dda, wrapping
+#endif
 extern volatile bool    axis_homing[STEPPER_COUNT];
 extern volatile uint8_t axesEnabled;			//Planner axis enabled
 extern volatile uint8_t axesHardwareEnabled;		//Hardware axis enabled
 
+// With AMASS_DDA, the dda's are oversampled by a number of bits chosen for each block
+// from its step rate, rather than by the fixed OVERSAMPLED_DDA.  DDA_OVERSAMPLE_BITS is
+// the number of bits in use, and is left undefined when the dda isn't oversampled.
+#if defined(AMASS_DDA) && defined(OVERSAMPLED_DDA)
+	#error "AMASS_DDA and OVERSAMPLED_DDA can't both be defined"
+#endif
+
+#ifdef AMASS_DDA
+	#ifndef AMASS_MAX_LEVEL
+		#define AMASS_MAX_LEVEL 3
+	#endif
+	extern uint8_t amass_level;
+	#define DDA_OVERSAMPLE_BITS amass_level
+#elif defined(OVERSAMPLED_DDA)
+	#define DDA_OVERSAMPLE_BITS OVERSAMPLED_DDA
+#endif
+
 
 /// Set the direction of the next step
 FORCE_INLINE void stepperAxisSetDirection(uint8_t axis, bool forward) {
+#ifdef PINNED_KINEMATICS
+	STEPPER_IOPORT_WRITE(stepperAxisPorts[axis].dir, PINNED_AXIS_INVERTED(axis) ? (! forward) : forward);
+#else
 	STEPPER_IOPORT_WRITE(stepperAxisPorts[axis].dir, (stepperAxis[axis].invert_axis) ? (! forward) : forward);
+#endif
 }
 	
 /// Step
+///
+/// With STEP_DUAL_EDGE, for drivers which step on both edges, a step toggles
+/// the pin, by writing its bit to the PIN register, and lowering it is a no-op.
+/// Every caller raises and then lowers, so each step is still one edge.
 
 ///***** SHOULD THIS BE REALLY false, true
 FORCE_INLINE void stepperAxisStep(uint8_t axis, bool value) {
+#if defined(STEP_DUAL_EDGE) && !defined(SIMULATOR)
+	if ( value )	_SFR_MEM8(stepperAxisPorts[axis].step.iport) = _BV(stepperAxisPorts[axis].step.pin);
+#else
 	STEPPER_IOPORT_WRITE(stepperAxisPorts[axis].step, value);
+#endif
 }
 
 /// The A3982 steper driver chip has an inverted enable
@@ -204,20 +263,166 @@ FORCE_INLINE bool stepperAxisIsAtMinimum(uint8_t axis) {
 	? false : (STEPPER_IOPORT_READ(stepperAxisPorts[axis].minimum) ^ stepperAxis[axis].invert_endstop);
 }
 
-/// Makes a step, but checks if an endstop is triggered first, if it is, the
-/// step is abandoned and "true" is returned.
-FORCE_INLINE bool stepperAxisStepWithEndstopCheck(uint8_t axis, bool direction) {
+/// Latched endstops
+///
+/// With ENDSTOPS_LATCHED, stepperAxisLatchEndstops() reads all of the endstops
+/// from the stepper interrupt, once before its steps, into endstops_latched.
+/// As with the step pins, which endstops share a port is worked out at compile
+/// time, so each port is read once; all of the Mighty One's are on port L.
+/// The steps then test a bit of the mask, unless the axis is homing, when the
+/// endstop is read on every step as before.  P-Stop only ever takes its
+/// endstop out of stepperAxisPorts[], which stepperAxisLatchEndstopsSetup()
+/// sees, so the pins of the table below hold.
+#if defined(ENDSTOPS_LATCHED) && !defined(SIMULATOR)
+
+// Bits of endstops_latched, for X to Z
+#define ENDSTOP_MIN(axis)	_BV(axis)
+#define ENDSTOP_MAX(axis)	_BV((axis) + 3)
+#define ENDSTOPS		6
+
+extern volatile uint8_t endstops_latched;	// Triggered endstops
+extern uint8_t endstops_inverted;		// Endstops which are triggered when their pin is low
+extern uint8_t endstops_enabled;		// Endstops which are present and not disabled
+
+/// Sets endstops_inverted and endstops_enabled from the axes' settings
+extern void stepperAxisLatchEndstopsSetup();
+
+static const StepperIOPort stepperEndstopPorts[ENDSTOPS] = {
+	X_STEPPER_MIN,
+	Y_STEPPER_MIN,
+	Z_STEPPER_MIN,
+	X_STEPPER_MAX,
+	Y_STEPPER_MAX,
+	Z_STEPPER_MAX
+};
+
+#define ENDSTOP_SHARED(a, b)	( stepperEndstopPorts[a].iport == stepperEndstopPorts[b].iport )
+#define ENDSTOP_EARLIER(a, b)	(( (a) < (b) ) && ENDSTOP_SHARED(a, b))
+#define ENDSTOP_BIT(a, b, v)	(( ENDSTOP_SHARED(a, b) && ( (v) & _BV(stepperEndstopPorts[b].pin) )) ? _BV(b) : 0 )
+
+/// Reads the port of endstop e, and returns the bits of the endstops on it
+/// whose pins are high, unless an endstop before it is on the same port
+FORCE_INLINE uint8_t stepperAxisReadEndstopPort(uint8_t e) {
+	if ( ENDSTOP_EARLIER(0, e) || ENDSTOP_EARLIER(1, e) || ENDSTOP_EARLIER(2, e) ||
+	     ENDSTOP_EARLIER(3, e) || ENDSTOP_EARLIER(4, e) )
+		return 0;
+
+	uint8_t v = _SFR_MEM8(stepperEndstopPorts[e].iport);
+	return ENDSTOP_BIT(e, 0, v) | ENDSTOP_BIT(e, 1, v) | ENDSTOP_BIT(e, 2, v) |
+	       ENDSTOP_BIT(e, 3, v) | ENDSTOP_BIT(e, 4, v) | ENDSTOP_BIT(e, 5, v);
+}
+
+FORCE_INLINE void stepperAxisLatchEndstops() {
+	uint8_t high = stepperAxisReadEndstopPort(0) | stepperAxisReadEndstopPort(1) |
+		       stepperAxisReadEndstopPort(2) | stepperAxisReadEndstopPort(3) |
+		       stepperAxisReadEndstopPort(4) | stepperAxisReadEndstopPort(5);
+	endstops_latched = ( high ^ endstops_inverted ) & endstops_enabled;
+}
+
+#undef ENDSTOP_BIT
+#undef ENDSTOP_EARLIER
+#undef ENDSTOP_SHARED
+
+#else
+
+FORCE_INLINE void stepperAxisLatchEndstops() {}
+
+#endif
+
+/// Returns true if a step may be taken in direction, and false, ending any homing
+/// of the axis, if the endstop it's heading for is triggered
+FORCE_INLINE bool stepperAxisEndstopCheck(uint8_t axis, bool direction) {
+#if defined(ENDSTOPS_LATCHED) && !defined(SIMULATOR)
+	if ( ! axis_homing[axis] ) {
+		if ( axis > Z_AXIS )	return true;
+		return ! ( endstops_latched & ( (direction) ? ENDSTOP_MAX(axis) : ENDSTOP_MIN(axis) ) );
+	}
+#endif
 	if (( (direction)   && (! stepperAxisIsAtMaximum(axis))) ||
-	    ( (! direction) && (! stepperAxisIsAtMinimum(axis)))) {
-		stepperAxisStep(axis, true);
+	    ( (! direction) && (! stepperAxisIsAtMinimum(axis))))
 		return true;
-	}
-	else {
-		axis_homing[axis] = false;
-		return false;
-	}
+	axis_homing[axis] = false;
+	return false;
 }
 
+/// Makes a step, but checks if an endstop is triggered first, if it is, the
+/// step is abandoned and "false" is returned.
+FORCE_INLINE bool stepperAxisStepWithEndstopCheck(uint8_t axis, bool direction) {
+	if ( ! stepperAxisEndstopCheck(axis, direction) )	return false;
+	stepperAxisStep(axis, true);
+	return true;
+}
+
+/// Step pins of several axes at once
+///
+/// The dda's step pins are spread over a few ports (X and Y share F on the
+/// Mighty One, Y and Z L on the Mighty Two, and A and B A on both), and
+/// stepping each through stepperAxisStep() costs a read-modify-write of its
+/// port per axis.  stepperAxisStepPorts() instead writes each port once, with
+/// the pins of all the axes in the mask axes which are on it, so the pulses
+/// of a step event go out together.
+///
+/// stepperStepPorts[] is a copy of the step pins of stepperAxisPorts[] which
+/// the compiler can see, so that which axes share a port is worked out at
+/// compile time.  The step pins are never changed at run time.
+#ifndef SIMULATOR
+
+// B's step pin is in the table when there's one extruder too, so the
+// comparisons below don't need bounds checks; B is then never in axes
+static const StepperIOPort stepperStepPorts[B_AXIS + 1] = {
+	X_STEPPER_STEP,
+	Y_STEPPER_STEP,
+	Z_STEPPER_STEP,
+	A_STEPPER_STEP,
+	B_STEPPER_STEP
+};
+
+#define STEPPER_STEP_SHARED(a, b)	( stepperStepPorts[a].port == stepperStepPorts[b].port )
+#define STEPPER_STEP_EARLIER(a, b)	(( (a) < (b) ) && STEPPER_STEP_SHARED(a, b))
+#define STEPPER_STEP_BIT(a, b, axes)	(( STEPPER_STEP_SHARED(a, b) && ( (axes) & _BV(b) )) ? _BV(stepperStepPorts[b].pin) : 0 )
+
+/// Writes the port of axis for the axes in axes which step through it, unless
+/// an axis before it has the same port and has written it already.  axis is
+/// always a constant, so all but the write itself folds away.
+FORCE_INLINE void stepperAxisStepPort(uint8_t axis, uint8_t axes, bool value) {
+	if ( STEPPER_STEP_EARLIER(X_AXIS, axis) || STEPPER_STEP_EARLIER(Y_AXIS, axis) ||
+	     STEPPER_STEP_EARLIER(Z_AXIS, axis) || STEPPER_STEP_EARLIER(A_AXIS, axis) )
+		return;
+
+	uint8_t mask = STEPPER_STEP_BIT(axis, X_AXIS, axes) | STEPPER_STEP_BIT(axis, Y_AXIS, axes) |
+		       STEPPER_STEP_BIT(axis, Z_AXIS, axes) | STEPPER_STEP_BIT(axis, A_AXIS, axes) |
+		       STEPPER_STEP_BIT(axis, B_AXIS, axes);
+	if ( mask == 0 )	return;
+
+#ifdef STEP_DUAL_EDGE
+	// One write toggles all of the port's pins, with no read-modify-write
+	if ( value )	_SFR_MEM8(stepperStepPorts[axis].iport) = mask;
+#else
+	if ( value )	_SFR_MEM8(stepperStepPorts[axis].port) |=  mask;
+	else		_SFR_MEM8(stepperStepPorts[axis].port) &= ~mask;
+#endif
+}
+
+FORCE_INLINE void stepperAxisStepPorts(uint8_t axes, bool value) {
+	stepperAxisStepPort(X_AXIS, axes, value);
+	stepperAxisStepPort(Y_AXIS, axes, value);
+	stepperAxisStepPort(Z_AXIS, axes, value);
+	stepperAxisStepPort(A_AXIS, axes, value);
+#if EXTRUDERS > 1
+	stepperAxisStepPort(B_AXIS, axes, value);
+#endif
+}
+
+#undef STEPPER_STEP_BIT
+#undef STEPPER_STEP_EARLIER
+#undef STEPPER_STEP_SHARED
+
+#else
+
+FORCE_INLINE void stepperAxisStepPorts(uint8_t, bool) {}
+
+#endif
+
 FORCE_INLINE int32_t stepperAxis_minInterval(uint8_t axis) { return stepperAxis[axis].min_interval; }
 
 /// DDA
@@ -232,30 +437,30 @@ FORCE_INLINE void stepperAxis_dda_reset(uint8_t ind, bool master, int32_t master
 
 	DDA_IND.counter  = master_steps >> 1;
 
-#ifdef OVERSAMPLED_DDA
-        DDA_IND.counter  = - (DDA_IND.counter << OVERSAMPLED_DDA);
+#ifdef DDA_OVERSAMPLE_BITS
+        DDA_IND.counter  = - (DDA_IND.counter << DDA_OVERSAMPLE_BITS);
 #else
         DDA_IND.counter  = - DDA_IND.counter;
 #endif
 
         DDA_IND.master                = master;
-#ifdef OVERSAMPLED_DDA
-        DDA_IND.master_steps          = master_steps << OVERSAMPLED_DDA;
+#ifdef DDA_OVERSAMPLE_BITS
+        DDA_IND.master_steps          = master_steps << DDA_OVERSAMPLE_BITS;
 #else
         DDA_IND.master_steps          = master_steps;
 #endif
         DDA_IND.steps         = steps;
         DDA_IND.direction     = (direction) ? -1 : 1;
         DDA_IND.stepperDir    = (direction) ? false : true;
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
+#if KINEMATICS_MIXED_MASK
 		DDA_IND.positiveDir   = DDA_IND.stepperDir;
 #endif
 
         DDA_IND.steps_completed = 0;
 }
 
-#if defined(CORE_XY) || defined(CORE_XY_STEPPER)
-FORCE_INLINE void stepperAxis_dda_reset_corexy(uint8_t ind, bool direction)
+#if KINEMATICS_MIXED_MASK
+FORCE_INLINE void stepperAxis_dda_reset_endstop(uint8_t ind, bool direction)
 {
         // Inverted logic from stepperAxis_dda_reset
         DDA_IND.positiveDir = (direction) ? true : false;
@@ -264,8 +469,8 @@ FORCE_INLINE void stepperAxis_dda_reset_corexy(uint8_t ind, bool direction)
 
 FORCE_INLINE void stepperAxis_dda_shift_phase16(uint8_t ind, int16_t phase)
 {
-#ifdef OVERSAMPLED_DDA
-        DDA_IND.counter += phase << OVERSAMPLED_DDA;
+#ifdef DDA_OVERSAMPLE_BITS
+        DDA_IND.counter += phase << DDA_OVERSAMPLE_BITS;
 #else
         DDA_IND.counter += phase;
 #endif
@@ -273,16 +478,34 @@ FORCE_INLINE void stepperAxis_dda_shift_phase16(uint8_t ind, int16_t phase)
 
 FORCE_INLINE void stepperAxis_dda_shift_phase32(uint8_t ind, int32_t phase)
 {
-#ifdef OVERSAMPLED_DDA
-        DDA_IND.counter += phase << OVERSAMPLED_DDA;
+#ifdef DDA_OVERSAMPLE_BITS
+        DDA_IND.counter += phase << DDA_OVERSAMPLE_BITS;
 #else
         DDA_IND.counter += phase;
 #endif
 }
 
-FORCE_INLINE void stepperAxis_dda_step(uint8_t ind)
+/// Puts out the direction of axis ind for the block its dda has been reset
+/// for.  It holds for the whole block, so stepperAxis_dda_step() doesn't set it.
+/// With JKN_ADVANCE the extruders' directions are set by the extruder interrupt
+/// instead, as the advance reverses them part way through a block.
+FORCE_INLINE void stepperAxis_dda_set_direction(uint8_t ind)
 {
 	if ( ! DDA_IND.enabled )	return;
+#ifdef JKN_ADVANCE
+	if ( DDA_IND.eAxis )		return;
+#endif
+	stepperAxisSetDirection(ind, DDA_IND.stepperDir);
+}
+
+/// Steps the dda of axis ind, and returns _BV(ind) if its step pin is to be
+/// pulsed, which the caller does with stepperAxisStepPorts() for all the axes
+/// together.  The position is counted before the pulse goes out.
+FORCE_INLINE uint8_t stepperAxis_dda_step(uint8_t ind)
+{
+	uint8_t stepped = 0;
+
+	if ( ! DDA_IND.enabled )	return stepped;
 
 	DDA_IND.counter += DDA_IND.steps;
 	if (( DDA_IND.counter > 0 ) && ( DDA_IND.steps_completed < DDA_IND.steps ))
@@ -307,21 +530,36 @@ FORCE_INLINE void stepperAxis_dda_step(uint8_t ind)
 		else
 		{
 #endif
-			stepperAxisSetDirection(ind, DDA_IND.stepperDir );
-			if ( stepperAxisStepWithEndstopCheck(ind,
-#if !defined(CORE_XY) && !defined(CORE_XY_STEPPER)
-							     DDA_IND.stepperDir) )
+#ifdef INPUT_SHAPING
+		if (( ind <= Y_AXIS ) && ( DDA_IND.shaped )) {
+			// st_shaper_step() takes the step, and takes it back off
+			// dda_position if the endstop stops it
+			shaper_command[ind] += DDA_IND.direction;
+			dda_position[ind] += DDA_IND.direction;
+		}
+		else
+		{
+#endif
+			if ( stepperAxisEndstopCheck(ind,
+#if KINEMATICS_MIXED_MASK == 0
+						     DDA_IND.stepperDir) ) {
 #else
-							     DDA_IND.positiveDir) )
+						     DDA_IND.positiveDir) ) {
 #endif
 				dda_position[ind] += DDA_IND.direction;
-			stepperAxisStep(ind, false);
+				stepped = _BV(ind);
+			}
+#ifdef INPUT_SHAPING
+		}
+#endif
 #ifdef JKN_ADVANCE
 		}
 #endif
 
 		DDA_IND.steps_completed ++;
 	}
+
+	return stepped;
 }
 
 /// Clips an axis to the minimum step limit.  It returns target if it doesn't require clipping,
@@ -339,6 +577,7 @@ FORCE_INLINE int32_t stepperAxis_clip_to_max(uint8_t axis, int32_t target)
 }
 
 extern void stepperAxisInit(bool hard_reset);
+extern void stepperAxisLoadSettings(uint8_t axis);
 extern float stepperAxisStepsPerMM(uint8_t axis);
 extern float stepperAxisStepsToMM(int32_t steps, uint8_t axis);
 extern int32_t stepperAxisMMToSteps(float mm, uint8_t axis);
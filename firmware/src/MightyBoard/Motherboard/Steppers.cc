@@ -20,6 +20,7 @@
 #include "Compat.hh"
 #include "Model.hh"
 #include "MachineId.hh"
+#include <math.h>
 
 #ifndef SIMULATOR
 
@@ -65,6 +66,47 @@
 
 #if defined(AUTO_LEVEL)
 #include "SkewTilt.hh"
+#include "MeshLevel.hh"
+#endif
+
+#ifdef UNDERRUN_STATS
+#include <string.h>
+#include "Host.hh"
+#include "SDCard.hh"
+#endif
+
+#ifdef SD_DRY_RUN
+#include "DryRun.hh"
+#endif
+
+#ifdef FLIGHT_RECORDER
+#include "FlightRecorder.hh"
+#endif
+
+#ifdef LAYER_LOG
+#include "LayerLog.hh"
+#endif
+
+// The pots are only there to be set on the board itself
+#if defined(MOTOR_CURRENT_PROFILE) && ( defined(SIMULATOR) || !defined(DIGIPOT_SUPPORT) )
+#undef MOTOR_CURRENT_PROFILE
+#endif
+
+#ifdef MOTOR_CURRENT_PROFILE
+#include "Command.hh"
+#endif
+
+#if defined(MOTOR_CURRENT_PROFILE) || ( defined(FAST_PAUSE) && !defined(SIMULATOR) )
+#include "Timeout.hh"
+#endif
+
+// The simulator has nothing stepping the blocks out to make room for them
+#if defined(MOVE_QUEUE) && defined(SIMULATOR)
+#undef MOVE_QUEUE
+#endif
+
+#ifdef MOVE_QUEUE
+#include <avr/wdt.h>
 #endif
 
 #ifdef DEBUG_ONSCREEN
@@ -88,8 +130,12 @@ FPTYPE extrusionFactor = KCONSTANT_1;
 void initPots() {
      // set digipots to stored default values
      DigiPots::init();
-     for ( int i = 0; i < STEPPER_COUNT; i++ )
-	  DigiPots::resetPot(i);
+#ifdef MOTOR_CURRENT_PROFILE
+     // Which starts the current profile over too
+     resetAxisPots((1 << STEPPER_COUNT) - 1);
+#else
+     DigiPots::resetPots((1 << STEPPER_COUNT) - 1);
+#endif
 }
 
 #define INITPOTS  initPots()
@@ -103,6 +149,9 @@ void initPots() {
 #if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
 void disableZMinEnd(bool disable) {
 	stepperAxis[2].disabled_endstop = disable;
+#if defined(ENDSTOPS_LATCHED) && !defined(SIMULATOR)
+	stepperAxisLatchEndstopsSetup();
+#endif
 }
 #endif
 
@@ -111,8 +160,19 @@ int32_t z_Offset_Change = 0;
 volatile bool is_running;
 volatile bool is_homing;
 bool acceleration = true;
+
+// Two speed homing: an accelerated approach at homing_fast_feedrate, which
+// is a move of finite length, then a back-off of homing_backoff x 0.1 mm
+// before the homing move proper
+static volatile bool homing_approach;
+static uint8_t homing_fast_feedrate[Z_AXIS + 1];	// mm/s, 0 = none
+static uint8_t homing_backoff;
 uint8_t plannerMaxBufferSize;
+#ifdef PINNED_KINEMATICS
+const FPTYPE axis_steps_per_unit_inverse[STEPPER_COUNT] = PINNED_AXES(PINNED_STEPS_PER_UNIT_INVERSE);
+#else
 FPTYPE axis_steps_per_unit_inverse[STEPPER_COUNT];
+#endif
 
 // Some gcode is loaded with enable/disable extruder commands. E.g., before each travel-only move.
 // This seems okay for 1.75 mm filament extruders.  However, it is problematic for 3mm filament
@@ -122,6 +182,22 @@ FPTYPE axis_steps_per_unit_inverse[STEPPER_COUNT];
 // gcode / s3g command to disable the extruder stepper motors.
 bool extruder_hold[EXTRUDERS]; // True if the extruders should not be disabled during printing
 
+#ifdef JKN_ADVANCE
+// The advance profiles as reset() works them out from EEPROM, with the JKN
+// advance and deprime settings at the end, so that changing profile is a copy
+struct advance_profile_t {
+	FPTYPE	k, k2;
+	int16_t	deprime_steps[EXTRUDERS];
+	FPTYPE	max_extrusion_rate;	// mm/s, 0 for none
+};
+static advance_profile_t advance_profiles[PROFILES_QUANTITY + 1];
+static uint8_t advance_profile_index = PROFILES_QUANTITY;	// The one printed with
+#endif
+
+// The filament speeds, mm/s, at which the extruders put out the most the hot
+// ends can melt, 0 for no limit
+static FPTYPE extruder_flow_speed[EXTRUDERS];
+
 // Segments are accelerated when segmentAccelState is true; unaccelerated otherwise
 static bool segmentAccelState = true;
 
@@ -138,7 +214,125 @@ uint16_t debugTimer = 0;
 #endif
 
 
+#ifdef MOVE_QUEUE
+
+static void decodeTarget(const Point& target, uint8_t relative, int32_t *out);
+static void planTargetNew(int32_t dda_interval, int32_t us);
+static void planTargetNewExt(int32_t dda_rate, uint8_t relative, FPTYPE distance, int16_t feedrateMult64);
+
+// Moves decoded while the planner is full, waiting for it to have room.
+// Their targets are as decodeTarget() works them out, so a block freeing up
+// only has to be planned.
+#define QUEUED_NEW		0x01	// setTargetNew()'s, else setTargetNewExt()'s
+#define QUEUED_HINT_LENGTH	0x02	// planner_hint_nominal_length
+#define QUEUED_SPEED		0x80	// Under the speed factor, as relative's bit 7
+
+typedef struct {
+	int32_t	target[STEPPER_COUNT];
+	int32_t	rate;			// dda_rate, or setTargetNew()'s dda_interval
+	int32_t	us;			// setTargetNew()'s
+	FPTYPE	distance;
+	FPTYPE	hint_speed;		// planner_hint_speed
+	int16_t	feedrate_mult_64;
+	uint8_t	flags;			// QUEUED_ bits
+} queued_move_t;
+
+static queued_move_t queued_moves[MOVE_QUEUE_SIZE];
+static uint8_t queued_head = 0;		// Where the next one goes
+static uint8_t queued_count = 0;
+
+// Set from stopMidMove() until the parked moves are resumed or dropped.
+// The queued moves then wait behind them, and the moves made meanwhile
+// start from where the steppers stopped.
+static bool queue_held = false;
+
+#define QUEUED_INDEX(n)	((uint8_t)(n) & (MOVE_QUEUE_SIZE - 1))
+
+// Fails to compile unless MOVE_QUEUE_SIZE is a power of two
+typedef char move_queue_check[((MOVE_QUEUE_SIZE & (MOVE_QUEUE_SIZE - 1)) == 0 && MOVE_QUEUE_SIZE <= 64) ? 1 : -1];
+
+static const int32_t *tailPosition() {
+	if ( queued_count != 0 && !queue_held )
+		return queued_moves[QUEUED_INDEX(queued_head - 1)].target;
+	return planner_position;
+}
+
+// Plans the queued moves for as long as the planner has room.  A hint
+// given for a move still to come is kept for it.
+static void planQueuedMoves() {
+	if ( queued_count == 0 || queue_held ) return;
+
+	FPTYPE hint_speed = planner_hint_speed;
+	bool hint_length = planner_hint_nominal_length;
+	while ( queued_count != 0 && movesplanned() < (BLOCK_BUFFER_SIZE - 2) ) {
+		queued_move_t *m = &queued_moves[QUEUED_INDEX(queued_head - queued_count)];
+		for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
+			planner_target[i] = m->target[i];
+		planner_hint_speed = m->hint_speed;
+		planner_hint_nominal_length = ( m->flags & QUEUED_HINT_LENGTH ) != 0;
+		queued_count--;
+		if ( m->flags & QUEUED_NEW ) planTargetNew(m->rate, m->us);
+		else planTargetNewExt(m->rate, m->flags, m->distance, m->feedrate_mult_64);
+	}
+	planner_hint_speed = hint_speed;
+	planner_hint_nominal_length = hint_length;
+}
+
+// Decodes the move into the queue when the planner has no room for it, or
+// there are moves queued ahead of it.  False when it's to be planned now.
+static bool queueMove(const Point& target, int32_t rate, int32_t us, uint8_t relative,
+		      FPTYPE distance, int16_t feedrateMult64, uint8_t flags) {
+	if ( queue_held ) return false;
+	planQueuedMoves();
+	if ( queued_count == 0 && movesplanned() < (BLOCK_BUFFER_SIZE - 2) )
+		return false;
+
+	// The callers check moveQueueRoom(), so this is only for safety
+	while ( queued_count == MOVE_QUEUE_SIZE ) {
+		wdt_reset();
+		planQueuedMoves();
+	}
+
+	queued_move_t *m = &queued_moves[QUEUED_INDEX(queued_head)];
+	decodeTarget(target, relative, m->target);
+	m->rate = rate;
+	m->us = us;
+	m->distance = distance;
+	m->feedrate_mult_64 = feedrateMult64;
+	m->hint_speed = planner_hint_speed;
+	if ( planner_hint_nominal_length ) flags |= QUEUED_HINT_LENGTH;
+	m->flags = flags;
+	planner_hint_speed = 0;
+	queued_head = QUEUED_INDEX(queued_head + 1);
+	queued_count++;
+	return true;
+}
+
+bool moveQueueEmpty() {
+	return queued_count == 0;
+}
+
+bool moveQueueRoom(uint8_t moves) {
+	return !queue_held && queued_count + moves <= MOVE_QUEUE_SIZE;
+}
+
+static void dropQueuedMoves() {
+	queued_count = 0;
+	queue_held = false;
+}
+
+#else
+
+static const int32_t *tailPosition() {
+	return planner_position;
+}
+
+#endif
+
 bool isRunning() {
+#ifdef MOVE_QUEUE
+	if ( queued_count != 0 ) return true;
+#endif
 	return is_running || is_homing;
 }
 
@@ -380,6 +574,206 @@ void loadToleranceOffsets() {
 #endif // !defined(SIMULATOR)
 }
 
+//Macros to clean things up a bit
+#define NAC2(LOCATION) eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::LOCATION
+#define NAC2_2(LOCATION) eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::LOCATION
+#define AC2(LOCATION,INT16INDEX) NAC2(LOCATION) + sizeof(uint16_t) * INT16INDEX
+#define AC2_2(LOCATION,INT16INDEX) NAC2_2(LOCATION) + sizeof(uint16_t) * INT16INDEX
+
+// The settings below are loaded by reset(), and again by the apply...()
+// functions when they're changed while the machine runs.  Only the planner
+// reads them, as it plans each move in the main loop, so a change made from
+// the main loop takes effect from the next move planned.  The blocks already
+// planned run as they were, and nothing has to drain first.
+
+// Max accelerations in mm/s^2, and the steps/s^2 the planner uses
+static void loadAccelerationSettings() {
+	acceleration = ( eeprom::getEeprom8(NAC2(ACCELERATION_ACTIVE), 0) & 0x01 ) != 0;
+
+	// With PINNED_KINEMATICS the per axis limits are the platform's, built in
+#ifndef PINNED_KINEMATICS
+	// Set max acceleration in units/s^2 for print moves
+	// X,Y,Z,A,B maximum start speed for accelerated moves.
+	// A,B default values are good for skeinforge 40+, for older versions raise them a lot.
+	max_acceleration_units_per_sq_second[X_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,0), DEFAULT_MAX_ACCELERATION_AXIS_X);
+	max_acceleration_units_per_sq_second[Y_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,1), DEFAULT_MAX_ACCELERATION_AXIS_Y);
+	max_acceleration_units_per_sq_second[Z_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,2), DEFAULT_MAX_ACCELERATION_AXIS_Z);
+	max_acceleration_units_per_sq_second[A_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,3), DEFAULT_MAX_ACCELERATION_AXIS_A);
+#if EXTRUDERS > 1
+	max_acceleration_units_per_sq_second[B_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,4), DEFAULT_MAX_ACCELERATION_AXIS_B);
+#endif
+
+	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
+		// Limit the max accelerations so that the calculation of block->acceleration & JKN Advance K2
+		// can be performed without overflow issues
+		if (max_acceleration_units_per_sq_second[i] > (uint32_t)((float)0xFFFFF / stepperAxisStepsPerMM(i)))
+		     max_acceleration_units_per_sq_second[i] = (uint32_t)((float)0xFFFFF / stepperAxisStepsPerMM(i));
+		axis_steps_per_sqr_second[i] = (uint32_t)((float)max_acceleration_units_per_sq_second[i] * stepperAxisStepsPerMM(i));
+		axis_accel_step_cutoff[i] = (uint32_t)0xffffffff / axis_steps_per_sqr_second[i];
+	}
+#endif
+
+#ifdef TRAVEL_ACCELERATION
+	// Travel only moves X, Y and Z; the extruders keep their printing limits
+	uint32_t travel_percent = (uint32_t)eeprom::getEeprom16(eeprom_offsets::TRAVEL_PROFILE +
+								travel_profile_offsets::ACCELERATION, 0);
+	if ( travel_percent == 0 ) travel_percent = 100;
+	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
+		uint32_t accel = axis_steps_per_sqr_second[i];
+		if ( i <= Z_AXIS ) {
+			// The same overflow limit as for printing moves, 0xFFFFF steps/s^2
+			accel = (uint32_t)(((uint64_t)accel * travel_percent) / 100);
+			if ( accel > 0xFFFFF ) accel = 0xFFFFF;
+			if ( accel == 0 ) accel = 1;
+		}
+		travel_steps_per_sqr_second[i] = accel;
+		travel_accel_step_cutoff[i] = (uint32_t)0xffffffff / accel;
+	}
+#endif
+}
+
+// Max speed changes and junction deviations
+static void loadJerkSettings() {
+	//Maximum speed change
+	max_speed_change[X_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,0), DEFAULT_MAX_SPEED_CHANGE_X));
+	max_speed_change[Y_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,1), DEFAULT_MAX_SPEED_CHANGE_Y));
+	max_speed_change[Z_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,2), DEFAULT_MAX_SPEED_CHANGE_Z));
+	max_speed_change[A_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,3), DEFAULT_MAX_SPEED_CHANGE_A));
+#if EXTRUDERS > 1
+	max_speed_change[B_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,4), DEFAULT_MAX_SPEED_CHANGE_B));
+#endif
+
+#ifdef DEBUG_SLOW_MOTION
+	max_speed_change[X_AXIS]  = FTOFP((float)1);
+	max_speed_change[Y_AXIS]  = FTOFP((float)1);
+	max_speed_change[Z_AXIS]  = FTOFP((float)0.15);
+	max_speed_change[A_AXIS]  = FTOFP((float)1);
+#if EXTRUDERS > 1
+	max_speed_change[B_AXIS]  = FTOFP((float)1);
+#endif
+#endif
+
+#ifdef FIXED
+	smallest_max_speed_change = max_speed_change[Z_AXIS];
+	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
+		if ( max_speed_change[i] < smallest_max_speed_change )
+			smallest_max_speed_change = max_speed_change[i];
+	}
+#endif
+
+	junction_deviation = FTOFP((float)eeprom::getEeprom8(eeprom_offsets::JUNCTION_DEVIATION,
+							     DEFAULT_JUNCTION_DEVIATION) / 100.0);
+
+#ifdef TRAVEL_ACCELERATION
+	travel_junction_deviation = FTOFP((float)eeprom::getEeprom8(eeprom_offsets::TRAVEL_PROFILE +
+								    travel_profile_offsets::JUNCTION_DEVIATION, 0) / 100.0);
+#endif
+}
+
+// Deprime steps and the advance profiles
+static void loadAdvanceSettings() {
+	//Number of steps when priming or deprime the extruder
+	int16_t deprime_a = (int16_t)eeprom::getEeprom16(AC2_2(EXTRUDER_DEPRIME_STEPS,0), DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
+#if EXTRUDERS > 1
+	int16_t deprime_b = (int16_t)eeprom::getEeprom16(AC2_2(EXTRUDER_DEPRIME_STEPS,1), DEFAULT_EXTRUDER_DEPRIME_STEPS_B);
+#endif
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		extruder_deprime_steps[0] = deprime_a;
+#if EXTRUDERS > 1
+		extruder_deprime_steps[1] = deprime_b;
+#endif
+	}
+	extruder_deprime_travel      = 1 == (eeprom::getEeprom8(eeprom_offsets::EXTRUDER_DEPRIME_ON_TRAVEL,
+								DEFAULT_EXTRUDER_DEPRIME_ON_TRAVEL));
+
+#ifdef JKN_ADVANCE
+	for (uint8_t i = 0; i < PROFILES_QUANTITY; i++) {
+		uint16_t offset = eeprom_offsets::ADVANCE_PROFILES + i * ADVANCE_PROFILE_SIZE;
+		advance_profile_t *p = &advance_profiles[i];
+
+		p->k  = FTOFP((float)eeprom::getEeprom32(offset + advance_profile_offsets::JKN_ADVANCE_K,  DEFAULT_JKN_ADVANCE_K)  / 100000.0);
+		p->k2 = FTOFP((float)eeprom::getEeprom32(offset + advance_profile_offsets::JKN_ADVANCE_K2, DEFAULT_JKN_ADVANCE_K2) / 100000.0);
+		int16_t deprime = (int16_t)eeprom::getEeprom16(offset + advance_profile_offsets::DEPRIME_STEPS,
+							      DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
+		for (uint8_t e = 0; e < EXTRUDERS; e++)
+			p->deprime_steps[e] = deprime;
+		p->max_extrusion_rate = ITOFP((int32_t)eeprom::getEeprom16(offset + advance_profile_offsets::MAX_EXTRUSION_RATE, 0));
+	}
+
+	advance_profile_t *settings = &advance_profiles[PROFILES_QUANTITY];
+	settings->k  = FTOFP((float)eeprom::getEeprom32(NAC2_2(JKN_ADVANCE_K),  DEFAULT_JKN_ADVANCE_K)  / 100000.0);
+	settings->k2 = FTOFP((float)eeprom::getEeprom32(NAC2_2(JKN_ADVANCE_K2), DEFAULT_JKN_ADVANCE_K2) / 100000.0);
+	for (uint8_t e = 0; e < EXTRUDERS; e++)
+		settings->deprime_steps[e] = extruder_deprime_steps[e];
+	settings->max_extrusion_rate = 0;
+#endif
+}
+
+void applyAccelerationSettings() {
+	loadAccelerationSettings();
+	setSegmentAccelState(acceleration);
+	plan_set_accel_limits();
+}
+
+void applyJerkSettings() {
+	loadJerkSettings();
+}
+
+void applyAdvanceSettings() {
+	loadAdvanceSettings();
+#ifdef JKN_ADVANCE
+	setAdvanceProfile(advance_profile_index);
+#endif
+}
+
+void applyAxisSettings() {
+	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ ) {
+		stepperAxisLoadSettings(i);
+#ifndef PINNED_KINEMATICS
+		axis_steps_per_unit_inverse[i] = FTOFP(1.0 / stepperAxisStepsPerMM(i));
+#endif
+	}
+	// The accelerations are kept in steps
+	applyAccelerationSettings();
+}
+
+// True if the length bytes written at offset overlap the size bytes at start
+static bool settingWritten(uint16_t offset, uint16_t length, uint16_t start, uint16_t size) {
+	return offset < start + size && start < offset + length;
+}
+
+void applySettings(uint16_t offset, uint16_t length) {
+	if ( settingWritten(offset, length, eeprom_offsets::AXIS_STEPS_PER_MM, STEPPER_COUNT * sizeof(uint32_t)) ||
+	     settingWritten(offset, length, eeprom_offsets::AXIS_MAX_FEEDRATES, STEPPER_COUNT * sizeof(uint32_t)) ||
+	     settingWritten(offset, length, eeprom_offsets::AXIS_LENGTHS, STEPPER_COUNT * sizeof(uint32_t)) )
+		applyAxisSettings();
+	else if ( settingWritten(offset, length, NAC2(ACCELERATION_ACTIVE), 1) ||
+		  settingWritten(offset, length, AC2(MAX_ACCELERATION_AXIS,0), STEPPER_COUNT * sizeof(uint16_t))
+#ifdef TRAVEL_ACCELERATION
+		  || settingWritten(offset, length, eeprom_offsets::TRAVEL_PROFILE + travel_profile_offsets::ACCELERATION,
+				    sizeof(uint16_t))
+#endif
+		)
+		applyAccelerationSettings();
+
+	if ( settingWritten(offset, length, AC2(MAX_SPEED_CHANGE,0), STEPPER_COUNT * sizeof(uint16_t)) ||
+	     settingWritten(offset, length, eeprom_offsets::JUNCTION_DEVIATION, 1)
+#ifdef TRAVEL_ACCELERATION
+	     || settingWritten(offset, length, eeprom_offsets::TRAVEL_PROFILE + travel_profile_offsets::JUNCTION_DEVIATION, 1)
+#endif
+		)
+		applyJerkSettings();
+
+	// The JKN advance settings and deprime steps lead ACCELERATION2_SETTINGS
+	if ( settingWritten(offset, length, NAC2_2(JKN_ADVANCE_K), acceleration2_eeprom_offsets::SLOWDOWN_FLAG) ||
+	     settingWritten(offset, length, eeprom_offsets::EXTRUDER_DEPRIME_ON_TRAVEL, 1)
+#ifdef JKN_ADVANCE
+	     || settingWritten(offset, length, eeprom_offsets::ADVANCE_PROFILES, PROFILES_QUANTITY * ADVANCE_PROFILE_SIZE)
+#endif
+		)
+		applyAdvanceSettings();
+}
+
 void reset() {
 	stepperAxisInit(false);
 	INITPOTS;
@@ -398,10 +792,7 @@ void reset() {
 		eeprom::setDefaultsAcceleration();
 	}
 
-        //Get the acceleration settings
-	uint8_t accel = eeprom::getEeprom8(eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::ACCELERATION_ACTIVE, 0) & 0x01;
-        acceleration = accel & 0x01;
-
+	loadAccelerationSettings();
 	setSegmentAccelState(acceleration);
 	deprimeEnable(true);
 
@@ -412,35 +803,11 @@ void reset() {
 	//http://reprap.org/pipermail/reprap-dev/2011-May/003323.html
 	//http://www.brokentoaster.com/blog/?p=358
 
+#ifndef PINNED_KINEMATICS
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i ++ )
 		axis_steps_per_unit_inverse[i] = FTOFP(1.0 / stepperAxisStepsPerMM(i));
-
-	//Macros to clean things up a bit
-	#define NAC2(LOCATION) eeprom_offsets::ACCELERATION_SETTINGS + acceleration_eeprom_offsets::LOCATION
-	#define NAC2_2(LOCATION) eeprom_offsets::ACCELERATION2_SETTINGS + acceleration2_eeprom_offsets::LOCATION
-	#define AC2(LOCATION,INT16INDEX) NAC2(LOCATION) + sizeof(uint16_t) * INT16INDEX
-	#define AC2_2(LOCATION,INT16INDEX) NAC2_2(LOCATION) + sizeof(uint16_t) * INT16INDEX
-
-	// Set max acceleration in units/s^2 for print moves
-	// X,Y,Z,A,B maximum start speed for accelerated moves.
-	// A,B default values are good for skeinforge 40+, for older versions raise them a lot.
-	max_acceleration_units_per_sq_second[X_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,0), DEFAULT_MAX_ACCELERATION_AXIS_X);
-	max_acceleration_units_per_sq_second[Y_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,1), DEFAULT_MAX_ACCELERATION_AXIS_Y);
-	max_acceleration_units_per_sq_second[Z_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,2), DEFAULT_MAX_ACCELERATION_AXIS_Z);
-	max_acceleration_units_per_sq_second[A_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,3), DEFAULT_MAX_ACCELERATION_AXIS_A);
-#if EXTRUDERS > 1
-	max_acceleration_units_per_sq_second[B_AXIS] = (uint32_t)eeprom::getEeprom16(AC2(MAX_ACCELERATION_AXIS,4), DEFAULT_MAX_ACCELERATION_AXIS_B);
 #endif
 
-	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-		// Limit the max accelerations so that the calculation of block->acceleration & JKN Advance K2
-		// can be performed without overflow issues
-		if (max_acceleration_units_per_sq_second[i] > (uint32_t)((float)0xFFFFF / stepperAxisStepsPerMM(i)))
-		     max_acceleration_units_per_sq_second[i] = (uint32_t)((float)0xFFFFF / stepperAxisStepsPerMM(i));
-		axis_steps_per_sqr_second[i] = (uint32_t)((float)max_acceleration_units_per_sq_second[i] * stepperAxisStepsPerMM(i));
-		axis_accel_step_cutoff[i] = (uint32_t)0xffffffff / axis_steps_per_sqr_second[i];
-	}
-
 #ifdef OLD_ACCEL_LIMITS
 	//Set default acceleration for "Normal Moves (acceleration)" and "filament only moves (retraction)" in mm/sec^2
 
@@ -465,44 +832,24 @@ void reset() {
 #endif
 #endif
 
-	//Number of steps when priming or deprime the extruder
-	extruder_deprime_steps[0]    = (int16_t)eeprom::getEeprom16(AC2_2(EXTRUDER_DEPRIME_STEPS,0), DEFAULT_EXTRUDER_DEPRIME_STEPS_A);
-#if EXTRUDERS > 1
-	extruder_deprime_steps[1]    = (int16_t)eeprom::getEeprom16(AC2_2(EXTRUDER_DEPRIME_STEPS,1), DEFAULT_EXTRUDER_DEPRIME_STEPS_B);
-#endif
-	extruder_deprime_travel      = 1 == (eeprom::getEeprom8(eeprom_offsets::EXTRUDER_DEPRIME_ON_TRAVEL,
-								DEFAULT_EXTRUDER_DEPRIME_ON_TRAVEL));
-
-	//Maximum speed change
-	max_speed_change[X_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,0), DEFAULT_MAX_SPEED_CHANGE_X));
-	max_speed_change[Y_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,1), DEFAULT_MAX_SPEED_CHANGE_Y));
-	max_speed_change[Z_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,2), DEFAULT_MAX_SPEED_CHANGE_Z));
-	max_speed_change[A_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,3), DEFAULT_MAX_SPEED_CHANGE_A));
-#if EXTRUDERS > 1
-	max_speed_change[B_AXIS]  = FTOFP((float)eeprom::getEeprom16(AC2(MAX_SPEED_CHANGE,4), DEFAULT_MAX_SPEED_CHANGE_B));
-#endif
-
-#ifdef DEBUG_SLOW_MOTION
-	max_speed_change[X_AXIS]  = FTOFP((float)1);
-	max_speed_change[Y_AXIS]  = FTOFP((float)1);
-	max_speed_change[Z_AXIS]  = FTOFP((float)0.15);
-	max_speed_change[A_AXIS]  = FTOFP((float)1);
-#if EXTRUDERS > 1
-	max_speed_change[B_AXIS]  = FTOFP((float)1);
-#endif
-#endif
-
-#ifdef FIXED
-	smallest_max_speed_change = max_speed_change[Z_AXIS];
-	for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-		if ( max_speed_change[i] < smallest_max_speed_change )
-			smallest_max_speed_change = max_speed_change[i];
-	}
-#endif
+	loadJerkSettings();
+	loadAdvanceSettings();
 
 	FPTYPE advanceK         = FTOFP((float)eeprom::getEeprom32(NAC2_2(JKN_ADVANCE_K),  DEFAULT_JKN_ADVANCE_K)         / 100000.0);
 	FPTYPE advanceK2        = FTOFP((float)eeprom::getEeprom32(NAC2_2(JKN_ADVANCE_K2), DEFAULT_JKN_ADVANCE_K2)        / 100000.0);
 
+	// A flow in mm³/s over the area of the filament is its speed
+	for (uint8_t e = 0; e < EXTRUDERS; e++) {
+		uint16_t offset = eeprom_offsets::EXTRUSION_LIMITS + 4 * e;
+		float flow = (float)eeprom::getEeprom16(offset + extrusion_limit_offsets::MAX_VOLUMETRIC_FLOW,
+							DEFAULT_MAX_VOLUMETRIC_FLOW);
+		float diameter = (float)eeprom::getEeprom16(offset + extrusion_limit_offsets::FILAMENT_DIAMETER,
+							    DEFAULT_FILAMENT_DIAMETER) / 100.0;
+		extruder_flow_speed[e] = ( flow > 0.0 && diameter > 0.0 ) ?
+			FTOFP(flow / (M_PI * 0.25 * diameter * diameter)) : 0;
+		extruder_max_extrusion_speed[e] = extruder_flow_speed[e];
+	}
+
 	minimumSegmentTime = FTOFP((float)ACCELERATION_MIN_SEGMENT_TIME);
 
 	// Minimum planner junction speed. Sets the default minimum speed the planner plans for at the end
@@ -544,14 +891,27 @@ void reset() {
 	extruder_hold[1] = extruder_hold[0];
 #endif
 
+	// The fast homing speeds are no more than the axes can take
+	static const uint8_t fast_default[Z_AXIS + 1] = {
+		DEFAULT_HOMING_FAST_FEEDRATE_X,
+		DEFAULT_HOMING_FAST_FEEDRATE_Y,
+		DEFAULT_HOMING_FAST_FEEDRATE_Z };
+	for (uint8_t i = 0; i <= Z_AXIS; i++) {
+		float fast = (float)eeprom::getEeprom8(eeprom_offsets::HOMING_FAST_FEEDRATE + i,
+						       fast_default[i]);
+		if ( fast > FPTOF(stepperAxis[i].max_feedrate) )
+			fast = FPTOF(stepperAxis[i].max_feedrate);
+		homing_fast_feedrate[i] = (uint8_t)fast;
+	}
+	homing_backoff = eeprom::getEeprom8(eeprom_offsets::HOMING_BACKOFF, DEFAULT_HOMING_BACKOFF);
+
 #ifdef PLANNER_OFF
 	plannerMaxBufferSize = 1;
 #else
 	plannerMaxBufferSize = BLOCK_BUFFER_SIZE - 1;
 #endif
 
-	alterSpeed  = 0x00;
-	speedFactor = KCONSTANT_1;
+	setSpeedFactor(KCONSTANT_1);
 
 #if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL) && defined(AUTO_LEVEL)
 	command::max_zprobe_hits = (uint8_t)eeprom::getEeprom8(
@@ -571,12 +931,29 @@ void reset() {
 
 	plan_init(advanceK, advanceK2, hold_z);		//Initialize planner
 	st_init();					//Initialize stepper accel
+#ifdef JKN_ADVANCE
+	setAdvanceProfile(eeprom::getEeprom8(eeprom_offsets::ADVANCE_PROFILE_ACTIVE, ADVANCE_PROFILE_NONE));
+#endif
+
+#ifdef INPUT_SHAPING
+	uint8_t shaper_type = eeprom::getEeprom8(eeprom_offsets::INPUT_SHAPER + input_shaper_offsets::TYPE,
+						 DEFAULT_INPUT_SHAPER_TYPE);
+	for (uint8_t i = X_AXIS; i <= Y_AXIS; i++) {
+		uint16_t offset = eeprom_offsets::INPUT_SHAPER + 2 * i;
+		st_set_input_shaper(i, shaper_type,
+				    (float)eeprom::getEeprom8(offset + input_shaper_offsets::FREQUENCY,
+							      DEFAULT_INPUT_SHAPER_FREQUENCY),
+				    (float)eeprom::getEeprom8(offset + input_shaper_offsets::DAMPING,
+							      DEFAULT_INPUT_SHAPER_DAMPING) / 100.0);
+	}
+#endif
 }
 
 //public:
 void init() {
 	is_running = false;
 	is_homing = false;
+	homing_approach = false;
 
 	stepperAxisInit(true);
 	DEBUG_VALUE(DEBUG_STEPPERS | 0x02);
@@ -597,13 +974,90 @@ void abort() {
 
         is_running = false;
         is_homing = false;
+	homing_approach = false;
 
 	stepperAxisInit(false);
 
 	setSegmentAccelState(acceleration);
 	deprimeEnable(true);
+#ifdef MOVE_QUEUE
+	dropQueuedMoves();
+#endif
+}
+
+void abortDecelerated() {
+#if defined(FAST_PAUSE) && !defined(SIMULATOR)
+	// Ramp down from the rate being stepped at, so no steps are lost at
+	// speed.  Homing stops at the endstops as it always has.
+	if ( !is_homing && blocks_queued() ) {
+		Timeout stop_timeout;
+		bool in_block;
+
+		// Well inside the watchdog's, should a slow axis take its time
+		stop_timeout.start(1000000);
+		st_request_stop();
+		while ( !st_stopped(&in_block) && blocks_queued() && !stop_timeout.hasElapsedNow() ) ;
+	}
+#endif
+	abort();
+}
+
+#ifdef FAST_PAUSE
+
+// True from stopMidMove() until parkStoppedMoves() has parked the moves
+static bool stop_requested = false;
+
+void stopMidMove() {
+	stop_requested = true;
+#ifdef MOVE_QUEUE
+	queue_held = true;
+#endif
+	st_request_stop();
+}
+
+bool parkStoppedMoves() {
+	bool in_block;
+
+	// The buffer may have been emptied by an abort() since the stop was asked for
+	if ( !st_stopped(&in_block) && blocks_queued() )
+		return false;
+
+	plan_park(in_block);
+	st_resume();
+	stop_requested = false;
+	is_running = false;
+	return true;
+}
+
+void cancelStopMidMove() {
+	if ( !stop_requested )
+		return;
+
+	// It can't be undone part way through the block, so stop and carry on from there
+	while ( !parkStoppedMoves() ) ;
+	resumeParkedMoves();
+}
+
+void resumeParkedMoves() {
+	plan_unpark();
+#ifdef MOVE_QUEUE
+	queue_held = false;
+	planQueuedMoves();
+#endif
+
+	if ( movesplanned() >= plannerMaxBufferSize )	is_running = true;
+	else						is_running = false;
+}
+
+void discardParkedMoves() {
+	plan_discard_parked();
+#ifdef MOVE_QUEUE
+	dropQueuedMoves();
+#endif
 }
 
+#endif
+
 Point removeOffsets(const Point &position) {
     Point p = position;
     for ( uint8_t i = 0; i < STEPPER_COUNT; i++ )
@@ -640,11 +1094,12 @@ const Point getPlannerPosition() {
 	Point p;
 
 	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
-		p = Point(STEPPERS_(planner_position[X_AXIS],
-							planner_position[Y_AXIS],
-							planner_position[Z_AXIS],
-							planner_position[A_AXIS],
-							planner_position[B_AXIS]));
+		const int32_t *tail = tailPosition();
+		p = Point(STEPPERS_(tail[X_AXIS],
+				    tail[Y_AXIS],
+				    tail[Z_AXIS],
+				    tail[A_AXIS],
+				    tail[B_AXIS]));
 	}
 
 	// Subtract out the toolhead offset
@@ -654,6 +1109,9 @@ const Point getPlannerPosition() {
 #if defined(AUTO_LEVEL)
 	// This needs to be done after removing the toolhead offsets
 	if ( skew_active ) p[Z_AXIS] -= skew((int32_t *)&p.coordinates[0]);
+#if defined(AUTO_LEVEL_MESH)
+	else if ( mesh_active ) p[Z_AXIS] -= mesh((int32_t *)&p.coordinates[0]);
+#endif
 #endif
 
 	return p;
@@ -695,6 +1153,9 @@ const Point getStepperPosition(uint8_t *toolIndex) {
 	// been applied.  Thus we need to remove it.
 	// This needs to be done after removing the toolhead offsets
 	if ( skew_active ) position[Z_AXIS] -= skew(position);
+#if defined(AUTO_LEVEL_MESH)
+	else if ( mesh_active ) position[Z_AXIS] -= mesh(position);
+#endif
 #endif
 	Point p = Point(STEPPERS_(position[X_AXIS], position[Y_AXIS],
 							  position[Z_AXIS], position[A_AXIS],
@@ -713,33 +1174,54 @@ const Point getStepperPosition(uint8_t *toolIndex) {
 
 #endif
 
+#ifdef KINEMATICS_MIX_IN_PLANNER
+// The planner plans the motors' steps: the move of the X, Y and Z motors into
+// delta_ab[], where the planner also looks for the direction bits
+static void planMotorDeltas() {
+	int32_t delta[3];
+	for ( uint8_t i = X_AXIS; i <= Z_AXIS; i++ )
+		delta[i] = planner_target[i] - planner_position[i];
+	Kinematics::toMotors(delta_ab, delta);
+}
+#endif
+
+// The absolute target in steps of a move to target, into out: the relative
+// axes from where the last move ends, with the skew, the live Z offset and
+// the toolhead offsets put in
+static void decodeTarget(const Point& target, uint8_t relative, int32_t *out) {
+	const int32_t *from = tailPosition();
 
-void setTargetNew(const Point& target, int32_t dda_interval, int32_t us, uint8_t relative) {
 	// Convert relative coordinates into absolute coordinates
 	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ ) {
-	     planner_target[i] = target[i];
+	     out[i] = target[i];
 	     if ( (relative & (1 << i)) != 0 )
-		  planner_target[i] += planner_position[i];
+		  out[i] += from[i];
 	}
 
 #if defined(AUTO_LEVEL)
 	// Apply the skew before the toolhead offsets
 	// The skew transform is computed using coordinates which have had
 	// the offsets removed
-	if ( skew_active ) planner_target[Z_AXIS] += skew(planner_target);
+	if ( skew_active ) out[Z_AXIS] += skew(out);
+#if defined(AUTO_LEVEL_MESH)
+	else if ( mesh_active ) out[Z_AXIS] += mesh(out);
+#endif
 #endif
-	planner_target[Z_AXIS] -= z_Offset_Change;//live Z adjust during a print - the logic is inverted, as stated in the docs, even if that is unintuitive
+	out[Z_AXIS] -= z_Offset_Change;//live Z adjust during a print - the logic is inverted, as stated in the docs, even if that is unintuitive
 
 	// Add on the toolhead offsets
-	planner_target[X_AXIS] += (*tool_offsets)[X_AXIS];
-	planner_target[Y_AXIS] += (*tool_offsets)[Y_AXIS];
+	out[X_AXIS] += (*tool_offsets)[X_AXIS];
+	out[Y_AXIS] += (*tool_offsets)[Y_AXIS];
+}
 
+// Plans the move to planner_target of setTargetNew()
+static void planTargetNew(int32_t dda_interval, int32_t us) {
         //Calculate the maximum steps of any axis and store in planner_master_steps
         //Also calculate the step deltas (planner_steps[i]) at the same time.
 	int32_t max_delta = 0;
 	planner_master_steps_index = 0;
 	planner_axes = 0;
-#if !defined(CORE_XY) && !defined(CORE_XYZ)
+#ifndef KINEMATICS_MIX_IN_PLANNER
         for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
                 planner_steps[i] = labs(planner_target[i] - planner_position[i]);
 		if ( planner_steps[i] ) {
@@ -750,47 +1232,17 @@ void setTargetNew(const Point& target, int32_t dda_interval, int32_t us, uint8_t
 		     }
 		}
         }
-#elif defined(CORE_XYZ)
-	// If us != 0, force recalc since max_delta may change
-	//  Note that when jogging or homing, the passed value for
-	//  us is zero.  HOWEVER, for those motions, max_delta
-	//  doesn't change since one of X-steps or Y-steps is zero
-	if ( us ) dda_interval = 0;
-
-	int32_t delta_x = planner_target[X_AXIS] - planner_position[X_AXIS];
-	int32_t delta_y = planner_target[Y_AXIS] - planner_position[Y_AXIS];
-	int32_t delta_z = planner_target[Z_AXIS] - planner_position[Z_AXIS];
-
-	delta_ab[X_AXIS] = delta_z + delta_y + delta_x;
-	delta_ab[Y_AXIS] = delta_z + delta_y - delta_x;
-	delta_ab[Z_AXIS] = delta_z - delta_y - delta_x;
-
-        for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-	        if ( i <= Z_AXIS ) planner_steps[i] = labs(delta_ab[i]);
-	        else planner_steps[i] = labs(planner_target[i] - planner_position[i]);
-		if ( planner_steps[i] ) {
-		     planner_axes |= 1 << i;
-		     if ( planner_steps[i] > max_delta ) {
-			  planner_master_steps_index = i;
-			  max_delta = planner_steps[i];
-		     }
-		}
-        }
 #else
 	// If us != 0, force recalc since max_delta may change
 	//  Note that when jogging or homing, the passed value for
 	//  us is zero.  HOWEVER, for those motions, max_delta
-	//  doesn't change since one of X-steps or Y-steps is zero
+	//  doesn't change since only one of the mixed axes moves
 	if ( us ) dda_interval = 0;
 
-	int32_t delta_x = planner_target[X_AXIS] - planner_position[X_AXIS];
-	int32_t delta_y = planner_target[Y_AXIS] - planner_position[Y_AXIS];
-
-	delta_ab[X_AXIS] = delta_x + delta_y;
-	delta_ab[Y_AXIS] = delta_x - delta_y;
+	planMotorDeltas();
 
         for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-	        if ( i <= Y_AXIS ) planner_steps[i] = labs(delta_ab[i]);
+	        if ( i <= Z_AXIS ) planner_steps[i] = labs(delta_ab[i]);
 	        else planner_steps[i] = labs(planner_target[i] - planner_position[i]);
 		if ( planner_steps[i] ) {
 		     planner_axes |= 1 << i;
@@ -827,45 +1279,125 @@ void setTargetNew(const Point& target, int32_t dda_interval, int32_t us, uint8_t
 	else                                               is_running = false;
 }
 
+void setTargetNew(const Point& target, int32_t dda_interval, int32_t us, uint8_t relative) {
+#ifdef MOVE_QUEUE
+	if ( queueMove(target, dda_interval, us, relative, 0, 0, QUEUED_NEW) ) return;
+#endif
+	decodeTarget(target, relative, planner_target);
+	planTargetNew(dda_interval, us);
+}
 
-//Dda_rate is the number of dda steps per second for the master axis
 
-void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, float distance, int16_t feedrateMult64) {
-	// Convert relative coordinates into absolute coordinates
-	for ( uint8_t i = 0; i < STEPPER_COUNT; i++ ) {
-	     planner_target[i] = target[i];
-	     if ( (relative & (1 << i)) != 0 )
-		  planner_target[i] += planner_position[i];
+// steps * axis_steps_per_unit_inverse[axis], in mm.  In fixed point that's
+// an integer product of the steps with the FPTYPE, which fits whenever the
+// distance does, so long moves don't need the overflow checks of FPMULT2().
+static FPTYPE deltaStepsToMM(int32_t steps, uint8_t axis) {
+#ifdef FIXED
+	return (FPTYPE)(steps * (int32_t)axis_steps_per_unit_inverse[axis]);
+#else
+	return (float)steps * axis_steps_per_unit_inverse[axis];
+#endif
+}
+
+// The speed factor in the 8.8 the stepper interrupt works in
+static uint16_t liveSpeedFactor(FPTYPE factor) {
+#ifdef FIXED
+	return (uint16_t)((uint32_t)factor >> 8);
+#else
+	return (uint16_t)(factor * 256.0);
+#endif
+}
+
+void changeZOffset(int32_t change) {
+	z_Offset_Change += change;
+#ifdef MOVE_QUEUE
+	// As it would have been had they been decoded now
+	for ( uint8_t n = 0; n < queued_count; n++ )
+		queued_moves[QUEUED_INDEX(queued_head - 1 - n)].target[Z_AXIS] -= change;
+#endif
+#if defined(LIVE_Z_BABYSTEP) && !defined(SIMULATOR)
+	// The targets are lowered by the offset, so the platform is too
+	uint32_t ticks = 2 * (uint32_t)stepperAxis_minInterval(Z_AXIS);
+	while ( change ) {
+		int16_t steps = ( change > 1000 ) ? 1000 : ( change < -1000 ) ? -1000 : (int16_t)change;
+		st_babystep_z(-steps, ( ticks > 0xffff ) ? 0xffff : (uint16_t)ticks);
+		change -= steps;
 	}
+#endif
+}
 
-#if defined(AUTO_LEVEL)
-	// Apply the skew before the toolhead offsets
-	// The skew transform is computed using coordinates which have had
-	// the offsets removed
-	if ( skew_active ) planner_target[Z_AXIS] += skew(planner_target);
+void setSpeedFactor(FPTYPE factor) {
+	speedFactor = factor;
+	alterSpeed  = (factor == KCONSTANT_1) ? 0x00 : 0x80;
+	st_set_speed_factor(liveSpeedFactor(factor));
+}
+
+#ifdef JKN_ADVANCE
+void setAdvanceProfile(uint8_t index) {
+	if ( index > PROFILES_QUANTITY ) index = PROFILES_QUANTITY;
+	advance_profile_index = index;
+	const advance_profile_t *p = &advance_profiles[index];
+
+	plan_set_advance(p->k, p->k2);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for (uint8_t e = 0; e < EXTRUDERS; e++)
+			extruder_deprime_steps[e] = p->deprime_steps[e];
+	}
+
+	// The planner holds the printing moves to the lower of this and the
+	// hot end's flow as it plans each one
+	for (uint8_t e = 0; e < EXTRUDERS; e++) {
+		FPTYPE limit = extruder_flow_speed[e];
+		if ( p->max_extrusion_rate != 0 && ( limit == 0 || p->max_extrusion_rate < limit ) )
+			limit = p->max_extrusion_rate;
+		extruder_max_extrusion_speed[e] = limit;
+	}
+}
+#endif
+
+#if defined(FIXED) && defined(KINEMATICS_MIX_IN_PLANNER)
+// n / d, for an n too big for FPDIV().  That's n << 32 over the bits of d:
+// n is shifted up and d down until the 32 bit division has at least 15 bits
+// of quotient, which is then shifted by what's left of the 32.
+static FPTYPE longDivideFP(uint32_t n, FPTYPE d) {
+	uint32_t den = (uint32_t)d;
+	int8_t shift = 32;
+
+	if ( den == 0 || n == 0 )
+		return 0;
+	while ( ! (n & 0x80000000UL) ) {
+		n <<= 1;
+		shift--;
+	}
+	while ( den > 0xffff ) {
+		den >>= 1;
+		shift--;
+	}
+
+	uint32_t q = n / den;
+	if ( shift < 0 )
+		return (FPTYPE)(q >> -shift);
+	if ( q > (0x7fffffffUL >> shift) )
+		return (FPTYPE)0x7fffffffL;
+	return (FPTYPE)(q << shift);
+}
 #endif
-	planner_target[Z_AXIS] -= z_Offset_Change;//live Z adjust during a print - the logic is inverted, as stated in the docs, even if that is unintuitive
 
-	// Now add in the toolhead offsets
-	planner_target[X_AXIS] += (*tool_offsets)[X_AXIS];
-	planner_target[Y_AXIS] += (*tool_offsets)[Y_AXIS];
+//Dda_rate is the number of dda steps per second for the master axis
 
+// Plans the move to planner_target of setTargetNewExt(); only bit 7 of
+// relative is looked at
+static void planTargetNewExt(int32_t dda_rate, uint8_t relative, FPTYPE distance, int16_t feedrateMult64) {
         //Calculate the maximum steps of any axis and store in planner_master_steps
         //Also calculate the step deltas (planner_steps[i]) at the same time.
         int32_t max_delta = 0;
         planner_master_steps_index = 0;
 	planner_axes = 0;
-#if !defined(CORE_XY) && !defined(CORE_XYZ)
+#ifndef KINEMATICS_MIX_IN_PLANNER
         for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
                 planner_steps[i] = planner_target[i] - planner_position[i];
-		int32_t abs_planner_steps = labs(planner_steps[i]);
-		if ( abs_planner_steps <= 0x7fff )
-		     delta_mm[i] = FPMULT2(ITOFP(planner_steps[i]), axis_steps_per_unit_inverse[i]);
-		else
-		      // This typically only happens for LONG Z axis moves
-		      // As such it typically happens three times per print
-		     delta_mm[i] = FTOFP((float)planner_steps[i] * FPTOF(axis_steps_per_unit_inverse[i]));
-                planner_steps[i] = abs_planner_steps;
+		delta_mm[i] = deltaStepsToMM(planner_steps[i], i);
+                planner_steps[i] = labs(planner_steps[i]);
 
 		if ( planner_steps[i] ) {
 		     planner_axes |= 1 << i;
@@ -875,52 +1407,14 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 		     }
 		}
         }
-#elif defined(CORE_XYZ)
-	int32_t delta_x = planner_target[X_AXIS] - planner_position[X_AXIS];
-	int32_t delta_y = planner_target[Y_AXIS] - planner_position[Y_AXIS];
-	int32_t delta_z = planner_target[Z_AXIS] - planner_position[Z_AXIS];
-
-	delta_ab[X_AXIS] = delta_z + delta_y + delta_x;
-	delta_ab[Y_AXIS] = delta_z + delta_y - delta_x;
-	delta_ab[Z_AXIS] = delta_z - delta_y - delta_x;
-
-        for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-	        if ( i <= Z_AXIS ) planner_steps[i] = delta_ab[i];
-                else planner_steps[i] = planner_target[i] - planner_position[i];
-		int32_t abs_planner_steps = labs(planner_steps[i]);
-		if ( abs_planner_steps <= 0x7fff )
-		     delta_mm[i] = FPMULT2(ITOFP(planner_steps[i]), axis_steps_per_unit_inverse[i]);
-		else
-		      // This typically only happens for LONG Z axis moves
-		      // As such it typically happens three times per print
-		     delta_mm[i] = FTOFP((float)planner_steps[i] * FPTOF(axis_steps_per_unit_inverse[i]));
-                planner_steps[i] = abs_planner_steps;
-		if ( planner_steps[i] ) {
-		     planner_axes |= 1 << i;
-		     if ( planner_steps[i] > max_delta ) {
-			  planner_master_steps_index = i;
-			  max_delta = planner_steps[i];
-		     }
-		}
-	}
 #else
-	int32_t delta_x = planner_target[X_AXIS] - planner_position[X_AXIS];
-	int32_t delta_y = planner_target[Y_AXIS] - planner_position[Y_AXIS];
-
-	delta_ab[X_AXIS] = delta_x + delta_y;
-	delta_ab[Y_AXIS] = delta_x - delta_y;
+	planMotorDeltas();
 
         for (uint8_t i = 0; i < STEPPER_COUNT; i++) {
-	        if ( i <= Y_AXIS ) planner_steps[i] = delta_ab[i];
+	        if ( i <= Z_AXIS ) planner_steps[i] = delta_ab[i];
                 else planner_steps[i] = planner_target[i] - planner_position[i];
-		int32_t abs_planner_steps = labs(planner_steps[i]);
-		if ( abs_planner_steps <= 0x7fff )
-		     delta_mm[i] = FPMULT2(ITOFP(planner_steps[i]), axis_steps_per_unit_inverse[i]);
-		else
-		      // This typically only happens for LONG Z axis moves
-		      // As such it typically happens three times per print
-		     delta_mm[i] = FTOFP((float)planner_steps[i] * FPTOF(axis_steps_per_unit_inverse[i]));
-                planner_steps[i] = abs_planner_steps;
+		delta_mm[i] = deltaStepsToMM(planner_steps[i], i);
+                planner_steps[i] = labs(planner_steps[i]);
 		if ( planner_steps[i] ) {
 		     planner_axes |= 1 << i;
 		     if ( planner_steps[i] > max_delta ) {
@@ -937,7 +1431,7 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 
 	planner_master_steps = (uint32_t)max_delta;
 
-	if (( planner_master_steps == 0 ) || ( distance == 0.0 )) {
+	if (( planner_master_steps == 0 ) || ( distance == 0 )) {
 #ifdef DEBUG_BLOCK_BY_MOVE_INDEX
 		//To keep in sync with the simulator
 		current_move_index ++;
@@ -946,12 +1440,17 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 	}
 
 	//Handle distance
-	planner_distance = FTOFP(distance);
+	planner_distance = distance;
+
+#ifdef LAYER_LOG
+	// Ahead of the block, so a layer change goes in behind the blocks before it
+	if ( layerlog::isRunning() ) layerlog::planned(FPTOF(distance));
+#endif
 
 	//Handle feedrate
 	FPTYPE feedrate = 0;
 
-#if defined(CORE_XY) || defined(CORE_XYZ)
+#ifdef KINEMATICS_MIX_IN_PLANNER
 	feedrate = ITOFP((int32_t)feedrateMult64);
 
 	//Feed rate was multiplied by 64 before it was sent, undo
@@ -967,26 +1466,29 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 	//  expensive.
 
 #ifdef FIXED
-	if ( planner_master_steps < 0x7fff ) {
-	     FPTYPE tmp = FPDIV(ITOFP((int32_t)planner_master_steps), planner_distance);
-
-	     // 181 is a tad smaller than sqrt(0x7fff)
-	     if ( feedrate > KCONSTANT_181 || tmp > KCONSTANT_181 )
-		  dda_rate = (int32_t)((float)feedrateMult64 * FPTOF(tmp)) >> 6;
-	     else
-		  dda_rate = FPTOI(FPMULT2(feedrate, tmp));
-	}
-	else
-	     dda_rate = (int32_t)((float)feedrateMult64 * (float)planner_master_steps / distance) >> 6;
+	FPTYPE steps_per_mm = ( planner_master_steps < 0x7fff ) ?
+		FPDIV(ITOFP((int32_t)planner_master_steps), planner_distance) :
+		longDivideFP(planner_master_steps, planner_distance);
+
+	// feedrateMult64 * steps_per_mm >> 6, a product of up to 47 bits, taken
+	// from the integer and fraction parts of steps_per_mm separately
+	uint32_t f = (uint16_t)feedrateMult64;
+	uint32_t rate = ((f * ((uint32_t)steps_per_mm >> 16)) >> 6) +
+		((f * ((uint32_t)steps_per_mm & 0xffff)) >> 22);
+	dda_rate = ( rate > 0x7fff ) ? 0x7fff : (int32_t)rate;
 #else
 	dda_rate = (int32_t)((float)feedrateMult64 * (float)planner_master_steps / distance) >> 6;
-#endif
 	if ( dda_rate > 0x7fff ) dda_rate = 0x7fff;
 #endif
+#endif
+
+	// Moves the speed factor applies to carry it, so that the stepper
+	// interrupt can play them at whatever it is by the time they're stepped
+	planner_speed_factor = 0;
 
 	if ( acceleration ) {
 
-#if !defined(CORE_XY) || !defined(CORE_XYZ)
+#ifndef KINEMATICS_MIX_IN_PLANNER
 		feedrate = ITOFP((int32_t)feedrateMult64);
 
 		//Feed rate was multiplied by 64 before it was sent, undo
@@ -997,10 +1499,18 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 #endif
 #endif
 
-		if ( relative & 0x80 ) {
+		if ( relative & 0x80 )
+			planner_speed_factor = liveSpeedFactor(speedFactor);
+
+		if (( relative & 0x80 ) && ( alterSpeed )) {
 #ifdef FIXED
 			feedrate = FPMULT2(feedrate, speedFactor);
-			dda_rate = (int32_t)((float)dda_rate * FPTOF(speedFactor));
+
+			// The rate may not fit an FPTYPE, so it's scaled a 16 bit half
+			// at a time
+			uint32_t k = (uint32_t)speedFactor, r = (uint32_t)dda_rate;
+			dda_rate = (int32_t)(r * (k >> 16) + (r >> 16) * (k & 0xffff) +
+					     (((r & 0xffff) * (k & 0xffff)) >> 16));
 #else
 		        feedrate *= speedFactor;
 			dda_rate = (int32_t)((float)dda_rate * speedFactor);
@@ -1015,10 +1525,18 @@ void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, fl
 	else                                               is_running = false;
 }
 
+void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, FPTYPE distance, int16_t feedrateMult64) {
+#ifdef MOVE_QUEUE
+	if ( queueMove(target, dda_rate, 0, relative, distance, feedrateMult64, relative & QUEUED_SPEED) ) return;
+#endif
+	decodeTarget(target, relative, planner_target);
+	planTargetNewExt(dda_rate, relative, distance, feedrateMult64);
+}
+
 
 //Step positions for homing.  We shift by >> 1 so that we can add
 //tool_offsets without overflow
-#if !defined(CORE_XY) && !defined(CORE_XY_STEPPER) && !defined(CORE_XYZ)
+#if KINEMATICS_MIXED_MASK == 0
 #define POSITIVE_HOME_POSITION ((INT32_MAX - 1) >> 1)
 #define NEGATIVE_HOME_POSITION ((INT32_MIN + 1) >> 1)
 #else
@@ -1052,6 +1570,131 @@ void startHoming(const bool maximums, const uint8_t axes_enabled, uint32_t us_pe
         is_homing = true;
 }
 
+// Plans an accelerated move of steps[i] along each of the axes, taking as
+// long as the slowest of them needs at its fast homing speed, or with
+// travel, at its top speed
+static void planHomingMove(const uint8_t axes, const int32_t *steps, bool travel = false) {
+	Point target = getPlannerPosition();
+	float time = 0.0, distance = 0.0;
+	int32_t master_steps = 0;
+
+	for (uint8_t i = 0; i <= Z_AXIS; i++) {
+		if ( (axes & (1 << i)) == 0 )
+			continue;
+		target[i] += steps[i];
+		int32_t n = labs(steps[i]);
+		if ( n > master_steps )
+			master_steps = n;
+		float mm = stepperAxisStepsToMM(n, i);
+		float t = mm / ( travel ? FPTOF(stepperAxis[i].max_feedrate) :
+				 (float)homing_fast_feedrate[i] );
+		if ( t > time )
+			time = t;
+		distance += mm * mm;
+	}
+	if ( time == 0.0 )
+		return;
+
+	distance = sqrt(distance);
+	float feedrate = distance / time;
+	// feedrateMult64 is 16 bits
+	if ( feedrate > 511.0 )
+		feedrate = 511.0;
+
+	setTargetNewExt(target, (int32_t)((float)master_steps / time), 0, FTOFP(distance),
+			(int16_t)(feedrate * 64.0));
+}
+
+uint8_t startHomingFast(const bool maximums, const uint8_t axes_enabled, uint32_t us_per_step) {
+	if ( !acceleration )
+		return 0;
+
+	int32_t steps[Z_AXIS + 1];
+	uint8_t axes = 0;
+	for (uint8_t i = 0; i <= Z_AXIS; i++) {
+		if ( (axes_enabled & (1 << i)) == 0 || homing_fast_feedrate[i] == 0 )
+			continue;
+
+		// Not worth it unless the approach is the faster
+		uint32_t interval = us_per_step;
+		if ( interval < (uint32_t)stepperAxis_minInterval(i) )
+			interval = (uint32_t)stepperAxis_minInterval(i);
+		if ( (float)homing_fast_feedrate[i] * stepperAxisStepsPerMM(i) * (float)interval <= 1000000.0 )
+			continue;
+
+		// Far enough to reach the endstop from anywhere on the axis
+		int32_t span = labs(stepperAxis[i].max_axis_steps_limit - stepperAxis[i].min_axis_steps_limit);
+		if ( span == 0 )
+			continue;
+		span += span >> 2;
+		steps[i] = maximums ? span : -span;
+		axes |= 1 << i;
+	}
+	if ( axes == 0 )
+		return 0;
+
+	for (uint8_t i = 0; i < STEPPER_COUNT; i++)
+		axis_homing[i] = (axes & (1 << i)) != 0;
+
+	setSegmentAccelState(true);
+	homing_approach = true;
+	planHomingMove(axes, steps);
+	is_homing = true;
+
+	return axes;
+}
+
+void startHomingBackoff(const bool maximums, const uint8_t axes) {
+	int32_t steps[Z_AXIS + 1];
+	for (uint8_t i = 0; i <= Z_AXIS; i++) {
+		int32_t n = stepperAxisMMToSteps((float)homing_backoff * 0.1, i);
+		steps[i] = maximums ? -n : n;
+	}
+	planHomingMove(axes, steps);
+}
+
+
+void startProbeTravel(const int32_t x, const int32_t y) {
+	Point at = getPlannerPosition();
+	int32_t steps[Z_AXIS + 1] = { x - at[X_AXIS], y - at[Y_AXIS], 0 };
+	planHomingMove((1 << X_AXIS) | (1 << Y_AXIS), steps, true);
+}
+
+// A continuous jog is a run of short accelerated segments, JOG_LOOKAHEAD of
+// them kept queued.  The planner speeds up through the first and, once no
+// more are added, slows down by the end of the last; fewer queued than the
+// slowdown limit keeps the slowdown out of it.
+#ifndef JOG_SEGMENT_MS
+#define JOG_SEGMENT_MS	100
+#endif
+#ifndef JOG_LOOKAHEAD
+#define JOG_LOOKAHEAD	4
+#endif
+
+void continueJog(uint8_t axis, bool positive, uint32_t us_per_step) {
+	if ( us_per_step < (uint32_t)stepperAxis_minInterval(axis) )
+		us_per_step = (uint32_t)stepperAxis_minInterval(axis);
+
+	int32_t n = (int32_t)((JOG_SEGMENT_MS * 1000L) / us_per_step);
+	if ( n < 1 )
+		n = 1;
+	float mm = stepperAxisStepsToMM(n, axis);
+	float feedrate = mm * 1000000.0 / ((float)n * (float)us_per_step);
+	// feedrateMult64 is 16 bits
+	if ( feedrate > 511.0 )
+		feedrate = 511.0;
+
+	if ( !blocks_queued() ) {
+		setSegmentAccelState(true);
+		disable_slowdown = true;
+	}
+	while ( movesplanned() < JOG_LOOKAHEAD ) {
+		Point target = getPlannerPosition();
+		target[axis] += positive ? n : -n;
+		setTargetNewExt(target, (int32_t)(1000000L / us_per_step), 0, FTOFP(mm),
+				(int16_t)(feedrate * 64.0));
+	}
+}
 
 /// Enable/disable the given axis.
 void enableAxis(uint8_t index, bool enable) {
@@ -1078,8 +1721,113 @@ uint8_t allAxesEnabled(void) {
 
 #if !defined(SIMULATOR) && defined(DIGIPOT_SUPPORT)
 
+#ifdef MOTOR_CURRENT_PROFILE
+
+// X and Y's currents follow the moves: raised for the blocks which speed up
+// or slow down hard or fast, as set between them, and lowered once the
+// steppers have been still for a while.  The pots are only written when the
+// level changes, and a boost is held for a while so that a run of short
+// moves doesn't have them written for each one.
+
+#ifndef CURRENT_BOOST_ACCEL
+#define CURRENT_BOOST_ACCEL	1500	// mm/s^2, a ramp at this or more is boosted
+#endif
+#ifndef CURRENT_BOOST_SPEED
+#define CURRENT_BOOST_SPEED	150	// mm/s, as is one to or from this speed or more
+#endif
+#ifndef CURRENT_BOOST_PERCENT
+#define CURRENT_BOOST_PERCENT	125	// of the pots as set, up to the pots' limit
+#endif
+#ifndef CURRENT_IDLE_PERCENT
+#define CURRENT_IDLE_PERCENT	60
+#endif
+#ifndef CURRENT_IDLE_SECONDS
+#define CURRENT_IDLE_SECONDS	5
+#endif
+#define CURRENT_BOOST_HOLD_MS	1000
+#define CURRENT_LOOKAHEAD	3	// Blocks after the one running which are looked at
+
+#define CURRENT_AXES		(_BV(X_AXIS) | _BV(Y_AXIS))
+
+enum { CURRENT_RUN, CURRENT_BOOST, CURRENT_IDLE };
+
+static uint8_t currentLevel = CURRENT_RUN;
+static uint8_t runPots[STEPPER_COUNT];	// X and Y's pots as set, while they're at another level
+static Timeout boostHold;
+static Timeout idleDelay;
+
+static void setCurrentLevel(uint8_t level) {
+     if ( level == currentLevel ) return;
+
+     if ( currentLevel == CURRENT_RUN ) {
+	  runPots[X_AXIS] = DigiPots::getPotValue(X_AXIS);
+	  runPots[Y_AXIS] = DigiPots::getPotValue(Y_AXIS);
+     }
+
+     uint8_t vals[STEPPER_COUNT];
+     uint8_t percent = ( level == CURRENT_BOOST ) ? CURRENT_BOOST_PERCENT :
+	  ( level == CURRENT_IDLE ) ? CURRENT_IDLE_PERCENT : 100;
+     for ( uint8_t i = X_AXIS; i <= Y_AXIS; i++ ) {
+	  // DigiPots holds them to the pots' limit
+	  uint16_t v = (uint16_t)runPots[i] * percent / 100;
+	  vals[i] = ( v > 0xff ) ? 0xff : (uint8_t)v;
+     }
+     DigiPots::setPotValues(vals, CURRENT_AXES);
+     currentLevel = level;
+}
+
+static bool wantsBoost(const block_t *block) {
+     if ( ( block->steps[X_AXIS] | block->steps[Y_AXIS] ) == 0 || ! block->use_accel )
+	  return false;
+     // Cruising the whole way, there's no ramp to boost
+     if ( block->initial_rate >= block->nominal_rate && block->final_rate >= block->nominal_rate )
+	  return false;
+     return FPTOI(block->acceleration) >= CURRENT_BOOST_ACCEL ||
+	  FPTOI(block->nominal_speed) >= CURRENT_BOOST_SPEED;
+}
+
+/// Called from runSteppersSlice()
+static void runCurrentProfile() {
+     // Homing and pausing have their own currents
+     if ( is_homing || command::pauseState() != PAUSE_STATE_NONE ) {
+	  setCurrentLevel(CURRENT_RUN);
+	  idleDelay.start(CURRENT_IDLE_SECONDS * 1000000L);
+	  return;
+     }
+
+     if ( blocks_queued() ) {
+	  uint8_t index = block_buffer_tail;
+	  for ( uint8_t i = 0; i <= CURRENT_LOOKAHEAD && index != block_buffer_head; i++ ) {
+	       if ( wantsBoost(&block_buffer[index]) ) {
+		    boostHold.start(CURRENT_BOOST_HOLD_MS * 1000L);
+		    break;
+	       }
+	       index = (index + 1) & (BLOCK_BUFFER_SIZE - 1);
+	  }
+	  idleDelay.start(CURRENT_IDLE_SECONDS * 1000000L);
+     }
+
+     if ( boostHold.isActive() && ! boostHold.hasElapsed() )
+	  setCurrentLevel(CURRENT_BOOST);
+     else if ( idleDelay.hasElapsed() )
+	  setCurrentLevel(CURRENT_IDLE);
+     else
+	  setCurrentLevel(CURRENT_RUN);
+}
+
+// Setting the pots sets their level as they run, so the others go back to
+// theirs first
+#define CURRENT_RESTORE()	setCurrentLevel(CURRENT_RUN)
+
+#else
+
+#define CURRENT_RESTORE()
+
+#endif
+
 /// set digital potentiometer for stepper axis
 void setAxisPotValue(uint8_t index, uint8_t value) {
+     CURRENT_RESTORE();
      if (index < STEPPER_COUNT)
 	  DigiPots::setPotValue(index, value);
 }
@@ -1087,22 +1835,40 @@ void setAxisPotValue(uint8_t index, uint8_t value) {
 
 /// get the digital potentiometer for stepper axis
 uint8_t getAxisPotValue(uint8_t index) {
-     if (index < STEPPER_COUNT)
+     if (index < STEPPER_COUNT) {
+#ifdef MOTOR_CURRENT_PROFILE
+	  if ( currentLevel != CURRENT_RUN && ( CURRENT_AXES & _BV(index) ) )
+	       return runPots[index];
+#endif
 	  return DigiPots::getPotValue(index);
+     }
      return 0;
 }
 
 /// Reset the digital potentiometer for stepper axis to the stored eeprom value
 void resetAxisPot(uint8_t index) {
+     CURRENT_RESTORE();
      if (index < STEPPER_COUNT)
 	  DigiPots::resetPot(index);
 }
 
+void setAxisPotValues(const uint8_t *values, uint8_t axes) {
+     CURRENT_RESTORE();
+     DigiPots::setPotValues(values, axes & ((1 << STEPPER_COUNT) - 1));
+}
+
+void resetAxisPots(uint8_t axes) {
+     CURRENT_RESTORE();
+     DigiPots::resetPots(axes & ((1 << STEPPER_COUNT) - 1));
+}
+
 #else
 
 void setAxisPotValue(uint8_t index, uint8_t value) { return; }
 uint8_t getAxisPotValue(uint8_t index) { return 0; }
 void resetAxisPot(uint8_t index) { return; }
+void setAxisPotValues(const uint8_t *values, uint8_t axes) { return; }
+void resetAxisPots(uint8_t axes) { return; }
 
 #endif
 
@@ -1121,6 +1887,10 @@ void changeToolIndex(uint8_t tool) {
      tool_offsets = ( toolIndex == 1 ) ?
 		 &tolerance_offset_T1 : &tolerance_offset_T0;
 
+     // The stepper position is reported against the new offsets once the moves queued
+     // for the old toolhead are done, without waiting for them here
+     plan_set_toolhead(toolIndex);
+
 #if 0
      // Queue a move to effect the change
 
@@ -1197,8 +1967,72 @@ void runSteppersSlice() {
 #if defined(DEBUG_ONSCREEN) && defined(TIME_STEPPER_INTERRUPT)
         debug_onscreen2 = debugTimer;
 #endif
+
+#ifdef SD_DRY_RUN
+	if ( dryrun::isRunning() ) dryrun::runSlice();
+#endif
+
+#ifdef MOTOR_CURRENT_PROFILE
+	runCurrentProfile();
+#endif
+
+#ifdef MOVE_QUEUE
+	planQueuedMoves();
+#endif
+}
+
+#ifdef SD_DRY_RUN
+bool takeDryRunMove(uint32_t *ms) {
+	if ( ! st_dry_run_block(ms) ) return false;
+	is_running = false;
+	return true;
+}
+#endif
+
+#ifdef UNDERRUN_STATS
+static uint16_t underruns[UNDERRUN_CAUSES];
+static uint8_t drained_seen;
+
+void checkUnderrun(bool deliberate) {
+	// The interrupt counts every time the last block finishes; several
+	// between calls are one underrun
+	uint8_t drained = st_drained;
+	if ( drained == drained_seen ) return;
+	drained_seen = drained;
+
+	if ( deliberate || is_homing || command::isPaused() ||
+	     host::getBuildState() != host::BUILD_RUNNING )
+		return;
+
+	uint8_t cause;
+	if ( ! command::isEmpty() )
+		cause = UNDERRUN_COMMAND;
+	else if ( sdcard::isPlaying() ) {
+		// At the end of the file the moves are meant to run out
+		if ( ! sdcard::playbackHasNext() ) return;
+		cause = UNDERRUN_SD;
+	}
+	else if ( host::getHostState() == host::HOST_STATE_BUILDING )
+		cause = UNDERRUN_HOST;
+	else
+		return;
+
+	if ( underruns[cause] != 0xffff ) underruns[cause]++;
+#ifdef FLIGHT_RECORDER
+	flightrec::freeze(flightrec::FREEZE_UNDERRUN);
+#endif
 }
 
+uint16_t getUnderruns(uint8_t cause) {
+	return ( cause < UNDERRUN_CAUSES ) ? underruns[cause] : 0;
+}
+
+void resetUnderruns() {
+	memset(underruns, 0, sizeof(underruns));
+	drained_seen = st_drained;
+}
+#endif
+
 
 void doStepperInterrupt() {
 #if defined(DEBUG_ONSCREEN) && defined(TIME_STEPPER_INTERRUPT)
@@ -1217,6 +2051,12 @@ void doStepperInterrupt() {
 	//Homing blocks aren't automatically deleted by st_interrupt because they are set to
 	//positions of INT32_MAX/MIN.
 	if ( is_homing ) {
+		// The fast approach ends with its block, should the endstops
+		// not have stopped it first
+		if ( homing_approach && !blocks_queued() )
+			for (uint8_t i = 0; i <= Z_AXIS; i++)
+				axis_homing[i] = false;
+
 		is_homing = false;
 
 		//Are we still homing on one of the axis?
@@ -1230,6 +2070,7 @@ void doStepperInterrupt() {
 			//planner position to stepper position
 			quickStop();
 
+			homing_approach = false;
 			setSegmentAccelState(acceleration);
 		}
 	}
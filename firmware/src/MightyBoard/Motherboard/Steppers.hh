@@ -18,6 +18,14 @@
 #ifndef STEPPERS_HH_
 #define STEPPERS_HH_
 
+// Count the times the planner runs dry in mid build, which also freezes the
+// flight recorder and goes in the layer log.  Defined ahead of the includes,
+// as StepperAccel.hh needs it too.
+#if ( defined(BUILD_STATS) || defined(FLIGHT_RECORDER) || defined(LAYER_LOG) ) && \
+    !defined(SIMULATOR)
+#define UNDERRUN_STATS
+#endif
+
 #ifndef SIMULATOR
 #include "Configuration.hh"
 #include "Types.hh"
@@ -50,7 +58,7 @@ namespace steppers {
     extern uint8_t alterSpeed;
     extern uint8_t alterExtrusion;
     extern uint8_t toolIndex;
-    extern FPTYPE axis_steps_per_unit_inverse[STEPPER_COUNT];
+    extern PINNED_CONST FPTYPE axis_steps_per_unit_inverse[STEPPER_COUNT];
     extern FPTYPE speedFactor;
     extern FPTYPE extrusionFactor;
 
@@ -70,6 +78,11 @@ namespace steppers {
     /// the not-running state.
     void abort();
 
+    /// As abort(), but with FAST_PAUSE the motion is first decelerated to a
+    /// stop at the acceleration of the block being stepped.  The positions
+    /// are then taken up from where the motors came to rest.
+    void abortDecelerated();
+
     /// Reset the current system position to the given point
     /// \param[in] position New system position
 	void definePosition(const Point& position, bool home);
@@ -97,10 +110,85 @@ namespace steppers {
     /// \param[in] dda_rate dda steps per second for the master axis
     /// \param[in] relative Bitfield specifying whether each axis should
     ///                     interpret the new position as absolute or
-    ///                     relative.
-    /// \param[in] distance of the move in mm's
+    ///                     relative.  Bit 7 set puts the move under the
+    ///                     speed factor.
+    /// \param[in] distance of the move in mm's; plan_float_to_fp() converts
+    ///            the float of a command without software float
     /// \param[in] feedrate of the move in mm's per second multiplied by 64
-    void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, float distance, int16_t feedrateMult64);
+    void setTargetNewExt(const Point& target, int32_t dda_rate, uint8_t relative, FPTYPE distance, int16_t feedrateMult64);
+
+#ifdef MOVE_QUEUE
+#ifndef MOVE_QUEUE_SIZE
+#define MOVE_QUEUE_SIZE 4
+#endif
+    /// With MOVE_QUEUE, the two calls above decode the moves which the
+    /// planner has no room for into a queue of MOVE_QUEUE_SIZE.  Those are
+    /// planned from runSteppersSlice() as the blocks free up, and
+    /// getPlannerPosition() is where the last of them ends.
+    /// \return True when there are none waiting
+    bool moveQueueEmpty();
+
+    /// \param[in] moves The most the next command can make
+    /// \return True when there's room to decode them ahead of the planner
+    bool moveQueueRoom(uint8_t moves);
+#endif
+
+    /// Add change to the live Z offset, z_Offset_Change.  With
+    /// LIVE_Z_BABYSTEP the platform moves by it straight away, else from
+    /// the next move planned.
+    void changeZOffset(int32_t change);
+
+    /// Set the speed factor of the moves, from 0.1 to 5.  The moves already
+    /// planned take it up as they're stepped, the ones in progress at once.
+    void setSpeedFactor(FPTYPE factor);
+
+#ifdef JKN_ADVANCE
+    /// Print with the advance K, K2, deprime steps and max extrusion rate of
+    /// the advance profile index, or of the settings for one past the last.
+    /// Takes effect from the next move planned, without a drain.
+    void setAdvanceProfile(uint8_t index);
+#endif
+
+    /// Reload a group of settings from the EEPROM while the machine runs,
+    /// without the idle pipeline reset() needs.  Only the precomputed
+    /// constants the planner works from are updated, so the change takes
+    /// effect from the next move planned.
+    ///   applyAccelerationSettings() -- acceleration on/off, max accelerations
+    ///   applyJerkSettings()         -- max speed changes, junction deviations
+    ///   applyAdvanceSettings()      -- JKN advance, deprime, advance profiles
+    ///   applyAxisSettings()         -- steps/mm, max feedrates, axis lengths
+    ///                                  and the accelerations in steps
+    void applyAccelerationSettings();
+    void applyJerkSettings();
+    void applyAdvanceSettings();
+    void applyAxisSettings();
+
+    /// Apply whichever of the groups above the length bytes of EEPROM
+    /// just written at offset belong to
+    void applySettings(uint16_t offset, uint16_t length);
+
+#ifdef FAST_PAUSE
+    /// Start bringing the steppers to a stop part way through the move
+    /// they're making, for a pause
+    void stopMidMove();
+
+    /// Once the steppers have stopped, set the moves still to be made
+    /// aside so that others can be made meanwhile
+    /// \return True when they've stopped; the planner position is then
+    ///         where they did
+    bool parkStoppedMoves();
+
+    /// Carry on with the move being made when stopMidMove() was called, if
+    /// the moves weren't parked yet
+    void cancelStopMidMove();
+
+    /// Carry on with the moves parkStoppedMoves() set aside, once those
+    /// made since have finished
+    void resumeParkedMoves();
+
+    /// Drop the moves parkStoppedMoves() set aside
+    void discardParkedMoves();
+#endif
 
     /// Home one or more axes
     /// \param[in] maximums If true, home in the positive direction
@@ -111,6 +199,30 @@ namespace steppers {
                      const uint8_t axes_enabled,
 		     uint32_t us_per_step);
 
+    /// Start the fast approach of a two speed home: an accelerated move
+    /// towards the endstops at the HOMING_FAST_FEEDRATE speeds, of a little
+    /// more than the length of each axis.  It stops as startHoming() does.
+    /// \param[in] us_per_step Speed of the homing to follow; axes for which
+    ///                        the approach would be no faster are left out
+    /// \return The axes approached, 0 if none
+    uint8_t startHomingFast(const bool maximums,
+                            const uint8_t axes_enabled,
+                            uint32_t us_per_step);
+
+    /// Back the axes which made the fast approach off from the endstops
+    /// by HOMING_BACKOFF
+    void startHomingBackoff(const bool maximums, const uint8_t axes);
+
+    /// Travel to X and Y, in steps, with an accelerated move at the top
+    /// speeds of the axes, for HOST_CMD_PROBE_POINT
+    void startProbeTravel(const int32_t x, const int32_t y);
+
+    /// Jog the axis at us_per_step, held to its top speed, by topping
+    /// up a short queue of accelerated segments.  Called for as long as the
+    /// jog is held; the motion ramps down to a stop at the end of the queue
+    /// once the calls stop, or sooner with abortDecelerated().
+    void continueJog(uint8_t axis, bool positive, uint32_t us_per_step);
+
 
     /// Enable/disable the given axis.
     /// \param[in] index Index of the axis to enable or disable
@@ -139,6 +251,15 @@ namespace steppers {
     /// \param[in] index Index of the axis
     void resetAxisPot(uint8_t index);
 
+    /// Set the digital potentiometers of the axes in a mask together
+    /// \param[in] values desired value for the pot of each axis, by index
+    /// \param[in] axes bit mask of the axes to set
+    void setAxisPotValues(const uint8_t *values, uint8_t axes);
+
+    /// Reset the digital potentiometers of the axes in a mask to their
+    /// stored eeprom values
+    void resetAxisPots(uint8_t axes);
+
     /// Toggle segment acceleration on or off
     /// Note this is also off if acceleration variable is not set
     void setSegmentAccelState(bool state);
@@ -160,6 +281,38 @@ namespace steppers {
     /// Run the stepper slice
     void runSteppersSlice();
 
+#ifdef UNDERRUN_STATS
+    /// What the planner ran out of when it ran dry in mid build
+    enum UnderrunCause {
+	UNDERRUN_COMMAND = 0,	///< Moves were buffered, but not planned in time
+	UNDERRUN_SD,		///< The SD card didn't keep the command buffer filled
+	UNDERRUN_HOST,		///< The host didn't keep the command buffer filled
+	UNDERRUN_CAUSES
+    };
+
+    /// See whether the planner has run dry since the last call, and if so
+    /// count it against its cause.  Called by the command slice before it
+    /// refills anything.  The buffer running dry on purpose, for a command
+    /// which waits for the moves before it, isn't an underrun.
+    /// \param[in] deliberate True if the command slice is waiting for
+    ///            the steppers, or the next command isn't a move
+    void checkUnderrun(bool deliberate);
+
+    /// Number of underruns in this build with the given cause
+    uint16_t getUnderruns(uint8_t cause);
+
+    /// Clear the underrun counters, at the start of a build
+    void resetUnderruns();
+#endif
+
+#ifdef SD_DRY_RUN
+    /// Take the next planned move of a dry run without making it, as the
+    /// stepper interrupt would have once it was done.  False if there isn't
+    /// one ready.
+    /// \param[out] ms The time the move would have taken
+    bool takeDryRunMove(uint32_t *ms);
+#endif
+
     /// Handle the interrupt for the steppers (X/Y/Z/A/B axis)
     void doStepperInterrupt();
 
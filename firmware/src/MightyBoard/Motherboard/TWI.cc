@@ -18,11 +18,43 @@
 // Based on I2C master code by Peter Fleury <pfleury@gmx.ch>
 // http://jump.to/fleury
 #include "Compat.hh"
+#include <avr/interrupt.h>
 #include <util/twi.h>
+#include <util/atomic.h>
 #include "TWI.hh"
 
 static bool twi_init_complete = false;
 
+typedef char twi_queue_length_check[(TWI_QUEUE_LENGTH & (TWI_QUEUE_LENGTH - 1)) == 0 &&
+                                    TWI_QUEUE_LENGTH <= 128 ? 1 : -1];
+typedef char twi_queue_bytes_check[(TWI_QUEUE_BYTES & (TWI_QUEUE_BYTES - 1)) == 0 &&
+                                   TWI_QUEUE_BYTES <= 128 ? 1 : -1];
+
+typedef struct {
+  uint8_t address;
+  uint8_t length;
+  TWI_callback done;
+  uint8_t *read;  // where a read's bytes go, 0 for a write
+} twi_write_t;
+
+// The queue, and the bytes of its writes in order.  The heads are only
+// moved by TWI_queue_write() and the tails by the interrupt; they run on
+// through 255 and are masked to index.
+static twi_write_t twi_queue[TWI_QUEUE_LENGTH];
+static volatile uint8_t twi_queue_head = 0, twi_queue_tail = 0;
+static uint8_t twi_bytes[TWI_QUEUE_BYTES];
+static volatile uint8_t twi_bytes_head = 0, twi_bytes_tail = 0;
+
+// Bytes still to send of the write at the tail of the queue, or to
+// receive of the read, and where the next one of those goes
+static uint8_t twi_left;
+static uint8_t *twi_read;
+
+// Set while a blocking transfer has the bus; queued writes wait for it
+static volatile bool twi_held = false;
+
+#define TWCR_QUEUED ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+
 // Alias function for compatibility with original API.
 void TWI_init(bool force_reinit) {
   // If we've already done this, return.
@@ -45,11 +77,201 @@ void TWI_init(bool force_reinit) {
   twi_init_complete = true;
 }
 
+static void twi_step();
+
+bool TWI_busy() {
+  return twi_queue_head != twi_queue_tail;
+}
+
+// With interrupts off, the interrupt's work is done by whoever is waiting
+static void twi_poll() {
+  if (!(SREG & (1 << SREG_I)) && (TWCR & (1 << TWINT)) && TWI_busy())
+    twi_step();
+}
+
+void TWI_wait() {
+  while (TWI_busy())
+    twi_poll();
+  while (TWCR & (1 << TWSTO))
+    ;
+}
+
+// Start sending the write at the tail of the queue; a stop for the write
+// before it goes out first when stop is set
+static void twi_start(bool stop) {
+  twi_write_t *write = &twi_queue[twi_queue_tail & (TWI_QUEUE_LENGTH - 1)];
+  twi_left = write->length;
+  twi_read = write->read;
+  TWCR = TWCR_QUEUED | (1 << TWSTA) | (stop ? (1 << TWSTO) : 0);
+}
+
+// Start the queue, once a blocking transfer has finished its stop
+static void twi_kick() {
+  while (TWCR & (1 << TWSTO))
+    ;
+  twi_start(false);
+}
+
+// Take the bus for a blocking transfer, once the queue is empty
+static void twi_hold() {
+  for (;;) {
+    TWI_wait();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (!TWI_busy()) {
+        twi_held = true;
+        return;
+      }
+    }
+  }
+}
+
+// Give the bus back, and send what was queued meanwhile
+static void twi_release() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    twi_held = false;
+    if (TWI_busy())
+      twi_kick();
+  }
+}
+
+bool TWI_queue_room(uint8_t writes, uint8_t bytes) {
+  return (uint8_t)(TWI_QUEUE_LENGTH - (uint8_t)(twi_queue_head - twi_queue_tail)) >= writes &&
+         (uint8_t)(TWI_QUEUE_BYTES - (uint8_t)(twi_bytes_head - twi_bytes_tail)) >= bytes;
+}
+
+// Queue a write of data, or a read into read when that's set
+static bool twi_enqueue(uint8_t address, const uint8_t *data, uint8_t length,
+                        TWI_callback done, uint8_t *read) {
+  uint8_t bytes = read ? 0 : length;
+  if (bytes > TWI_QUEUE_BYTES)
+    return false;
+
+  for (;;) {
+    while (!TWI_queue_room(1, bytes))
+      twi_poll();
+
+    // Interrupts queue writes too, so the room is taken with them off
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (TWI_queue_room(1, bytes)) {
+        uint8_t head = twi_bytes_head;
+        for (uint8_t i = 0; i < bytes; i++)
+          twi_bytes[head++ & (TWI_QUEUE_BYTES - 1)] = data[i];
+        twi_bytes_head = head;
+
+        twi_write_t *write = &twi_queue[twi_queue_head & (TWI_QUEUE_LENGTH - 1)];
+        write->address = address;
+        write->length = length;
+        write->done = done;
+        write->read = read;
+
+        bool idle = !TWI_busy();
+        twi_queue_head++;
+        if (idle && !twi_held)
+          twi_kick();
+        return true;
+      }
+    }
+  }
+}
+
+bool TWI_queue_write(uint8_t address, const uint8_t *data, uint8_t length,
+                     TWI_callback done) {
+  return twi_enqueue(address, data, length, done, 0);
+}
+
+bool TWI_queue_read(uint8_t address, uint8_t *data, uint8_t length,
+                    TWI_callback done) {
+  if (length == 0)
+    return false;
+  return twi_enqueue(address, 0, length, done, data);
+}
+
+// Finish the write at the tail of the queue, and start the next one
+static void twi_finish(uint8_t err) {
+  twi_write_t *write = &twi_queue[twi_queue_tail & (TWI_QUEUE_LENGTH - 1)];
+  TWI_callback done = write->done;
+
+  // Skip what's left of a write after an error
+  if (!write->read)
+    twi_bytes_tail += twi_left;
+  twi_queue_tail++;
+
+  if (TWI_busy())
+    twi_start(true);
+  else
+    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+
+  if (done)
+    done(err);
+}
+
+static void twi_step() {
+  switch (TW_STATUS & 0xF8) {
+  case TW_START:
+  case TW_REP_START:
+    TWDR = twi_queue[twi_queue_tail & (TWI_QUEUE_LENGTH - 1)].address |
+           (twi_read ? TW_READ : TW_WRITE);
+    TWCR = TWCR_QUEUED;
+    break;
+
+  case TW_MT_SLA_ACK:
+  case TW_MT_DATA_ACK:
+    if (twi_left) {
+      uint8_t tail = twi_bytes_tail;
+      TWDR = twi_bytes[tail & (TWI_QUEUE_BYTES - 1)];
+      twi_bytes_tail = tail + 1;
+      twi_left--;
+      TWCR = TWCR_QUEUED;
+    } else {
+      twi_finish(0);
+    }
+    break;
+
+  case TW_MT_SLA_NACK:
+    twi_finish(2);
+    break;
+
+  case TW_MT_DATA_NACK:
+    twi_finish(3);
+    break;
+
+  // A read acks each byte but the last, which ends it
+  case TW_MR_DATA_ACK:
+    *twi_read++ = TWDR;
+    twi_left--;
+    // fall through
+  case TW_MR_SLA_ACK:
+    TWCR = TWCR_QUEUED | ((twi_left > 1) ? (1 << TWEA) : 0);
+    break;
+
+  case TW_MR_DATA_NACK:
+    *twi_read++ = TWDR;
+    twi_left = 0;
+    twi_finish(0);
+    break;
+
+  case TW_MR_SLA_NACK:
+    twi_finish(2);
+    break;
+
+  default:
+    // Lost arbitration or a bus error; the stop lets the bus go
+    twi_finish(1);
+    break;
+  }
+}
+
+ISR(TWI_vect) {
+  twi_step();
+}
+
 // TODO write proper error codes
 uint8_t TWI_write_data(uint8_t address, uint8_t *data, uint8_t length) {
   uint8_t twst;
   uint8_t err = 0;
 
+  twi_hold();
+
   // send START condition
   TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
 
@@ -59,8 +281,10 @@ uint8_t TWI_write_data(uint8_t address, uint8_t *data, uint8_t length) {
 
   // check value of TWI Status Register. Mask prescaler bits.
   twst = TW_STATUS & 0xF8;
-  if ((twst != TW_START) && (twst != TW_REP_START))
+  if ((twst != TW_START) && (twst != TW_REP_START)) {
+    twi_release();
     return 1;
+  }
 
   // send device address
   TWDR = address | TW_WRITE;
@@ -101,6 +325,7 @@ uint8_t TWI_write_data(uint8_t address, uint8_t *data, uint8_t length) {
   while (TWCR & (1 << TWSTO))
     ;
 
+  twi_release();
   return err;
 }
 // TODO write proper error codes
@@ -108,6 +333,8 @@ uint8_t TWI_write_byte(uint8_t address, uint8_t data) {
   uint8_t twst;
   uint8_t err = 0;
 
+  twi_hold();
+
   // send START condition
   TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
 
@@ -117,8 +344,10 @@ uint8_t TWI_write_byte(uint8_t address, uint8_t data) {
 
   // check value of TWI Status Register. Mask prescaler bits.
   twst = TW_STATUS & 0xF8;
-  if ((twst != TW_START) && (twst != TW_REP_START))
+  if ((twst != TW_START) && (twst != TW_REP_START)) {
+    twi_release();
     return 1;
+  }
 
   // send device address
   TWDR = address | TW_WRITE;
@@ -157,6 +386,7 @@ uint8_t TWI_write_byte(uint8_t address, uint8_t data) {
   while (TWCR & (1 << TWSTO))
     ;
 
+  twi_release();
   return err;
 }
 
@@ -167,6 +397,8 @@ uint8_t TWI_read_byte(uint8_t address, uint8_t *data, uint8_t length) {
   uint8_t twst;
   uint8_t err = 0;
 
+  twi_hold();
+
   // send START condition
   TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
 
@@ -176,8 +408,10 @@ uint8_t TWI_read_byte(uint8_t address, uint8_t *data, uint8_t length) {
 
   // check value of TWI Status Register. Mask prescaler bits.
   twst = TW_STATUS & 0xF8;
-  if ((twst != TW_START) && (twst != TW_REP_START))
+  if ((twst != TW_START) && (twst != TW_REP_START)) {
+    twi_release();
     return 1;
+  }
 
   // send device address
   TWDR = address | TW_READ;
@@ -214,5 +448,6 @@ uint8_t TWI_read_byte(uint8_t address, uint8_t *data, uint8_t length) {
 
   TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN); /* send stop condition */
 
+  twi_release();
   return err;
 }
@@ -18,12 +18,52 @@
 #ifndef TWI_HH
 #define TWI_HH
 
+#include <stdint.h>
+
 #define SCL_CLOCK  100000L
 
+// Writes waiting to go out through the TWI interrupt, and the bytes
+// they may hold between them; both powers of two, no more than 128
+#ifndef TWI_QUEUE_LENGTH
+#define TWI_QUEUE_LENGTH 8
+#endif
+
+#ifndef TWI_QUEUE_BYTES
+#define TWI_QUEUE_BYTES 64
+#endif
+
+// Called from the TWI interrupt when a queued write is done, with 0 or the
+// error TWI_write_data() would have returned
+typedef void (*TWI_callback)(uint8_t err);
+
 void TWI_init(bool force_reinit = false);
 
+// These wait for the queued writes to go out before starting, and then
+// for every byte of their own; writes queued meanwhile go out after them
 uint8_t TWI_write_data(uint8_t address, uint8_t * data, uint8_t length);
 uint8_t TWI_read_byte(uint8_t address, uint8_t * data, uint8_t length);
 uint8_t TWI_write_byte(uint8_t address, uint8_t data);
 
+// Copy a write into the queue and return; the TWI interrupt sends it, after
+// those queued before it.  Waits while the queue is full, sending the writes
+// itself if interrupts are off.  False if the write is longer than the queue.
+bool TWI_queue_write(uint8_t address, const uint8_t *data, uint8_t length,
+                     TWI_callback done = 0);
+
+// Queue a read of length bytes into data, which must stay there until it's
+// done; the same as a write otherwise, taking a place in the queue but none
+// of its bytes.  Done is called from the interrupt once data is filled in.
+bool TWI_queue_read(uint8_t address, uint8_t *data, uint8_t length,
+                    TWI_callback done = 0);
+
+// True if the queue has room for this many more writes of, between them,
+// this many bytes; for interrupts, which shouldn't wait on the queue
+bool TWI_queue_room(uint8_t writes, uint8_t bytes);
+
+// True while there are queued writes still going out
+bool TWI_busy();
+
+// Wait until the queued writes are out and the bus is free
+void TWI_wait();
+
 #endif
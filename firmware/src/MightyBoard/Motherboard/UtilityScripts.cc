@@ -24,6 +24,8 @@
 #include "EepromMap.hh"
 #include "Model.hh"
 #include "Menu_locales.hh"
+#include "Commands.hh"
+#include <string.h>
 
 #if defined(USE_ZMAX_HOME)
 const static uint16_t Lengths[3]  PROGMEM = { 147, /// Home Axes
@@ -48,15 +50,541 @@ const static uint16_t Lengths[3]  PROGMEM = { 98, /// Home Axes
 #if !defined(SINGLE_EXTRUDER) && defined(NOZZLE_CALIBRATION_SCRIPT)
 	#ifdef MODEL_REPLICATOR2
 		#if defined(USE_ZMAX_HOME)
-		const static uint8_t NozzleCalibrate[] PROGMEM = { 137,  8,  153,  0,  0,  0,  0,  110,  111,  122,  122,  108,  101,  67,  97,  108,  105,  98,  114,  97,  116,  105,  111,  110,  45,  82,  101,  112,  50,  45,  65,  0,  150,  0,  0,  134,  0,  132,  4,  136,  0,  0,  0,  20,  0,  132,  3,  105,  1,  0,  0,  20,  0,  144,  27,  139,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  136,  0,  3,  2,  110,  0,  135,  0,  100,  0,  255,  255,  136,  0,  3,  2,  220,  0,  136,  1,  3,  2,  220,  0,  131,  4,  188,  0,  0,  0,  20,  0,  140,  0,  0,  0,  0,  0,  0,  0,  0,  48,  248,  255,  255,  0,  0,  0,  0,  0,  0,  0,  0,  155,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  213,  20,  0,  0,  24,  0,  0,  160,  64,  85,  3,  131,  4,  184,  11,  0,  0,  20,  0,  144,  4,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  145,  0,  20,  145,  1,  20,  145,  2,  20,  145,  3,  20,  145,  4,  20,  135,  0,  100,  0,  255,  255,  134,  1,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  135,  1,  100,  0,  255,  255,  145,  0,  127,  145,  1,  127,  145,  2,  40,  145,  3,  127,  145,  4,  127,  134,  0,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  155,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  120,  30,  0,  0,  24,  154,  153,  69,  66,  224,  4,  155,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  208,  253,  255,  255,  0,  0,  0,  0,  116,  0,  0,  0,  24,  0,  0,  128,  64,  53,  0,  140,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  155,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  247,  13,  0,  0,  24,  34,  164,  42,  66,  0,  10,  155,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  70,  7,  0,  0,  24,  154,  153,  153,  62,  83,  3,  137,  136,  155,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  228,  255,  255,  255,  0,  0,  0,  0,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  141,  215,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  32,  66,  42,  3,  155,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  67,  14,  0,  0,  24,  142,  5,  37,  66,  0,  10,  155,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  191,  244,  255,  255,  165,  248,  255,  255,  104,  1,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  37,  11,  0,  0,  24,  74,  186,  212,  66,  0,  10,  155,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  186,  255,  255,  255,  0,  0,  0,  0,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  191,  244,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  32,  66,  42,  3,  155,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  67,  14,  0,  0,  24,  142,  5,  37,  66,  0,  10,  155,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  118,  248,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  45,  252,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  228,  255,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  155,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  155,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  155,  3,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  81,  7,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  8,  11,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  191,  14,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  118,  18,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  45,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  45,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  45,  22,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  227,  25,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  154,  29,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  70,  7,  0,  0,  24,  0,  0,  0,  63,  83,  3,  137,  8,  134,  1,  139,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  176,  205,  255,  255,  0,  0,  0,  0,  128,  0,  0,  0,  137,  24,  140,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  80,  50,  0,  0,  0,  0,  0,  0,  155,  127,  243,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  210,  12,  0,  0,  24,  37,  235,  14,  67,  0,  10,  155,  127,  243,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  70,  7,  0,  0,  24,  154,  153,  153,  62,  83,  3,  137,  144,  155,  127,  243,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  228,  255,  255,  255,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  127,  243,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  127,  243,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  127,  243,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  135,  254,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  215,  1,  0,  0,  157,  237,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  168,  14,  0,  0,  24,  119,  189,  220,  66,  0,  10,  155,  215,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  186,  255,  255,  255,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  215,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  215,  1,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  132,  5,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  132,  5,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  132,  5,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  49,  9,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  49,  9,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  49,  9,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  223,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  223,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  223,  12,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  140,  16,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  140,  16,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  140,  16,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  58,  20,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  58,  20,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  20,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  231,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  231,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  231,  23,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  148,  27,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  148,  27,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  148,  27,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  31,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  66,  31,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  66,  31,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  239,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  239,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  239,  34,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  157,  38,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  157,  38,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  157,  38,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  74,  42,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  74,  42,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  74,  42,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  247,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  247,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  247,  45,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  137,  16,  155,  247,  45,  0,  0,  165,  248,  255,  255,  48,  242,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  202,  19,  0,  0,  24,  10,  215,  26,  67,  42,  3,  137,  31,  136,  0,  3,  2,  0,  0,  136,  1,  3,  2,  0,  0,  136,  0,  3,  2,  0,  0,  150,  100,  0,  154,  0,  137,  31 };
+		const static uint8_t NozzleCalibrate[] PROGMEM = {
+			63,137,8,153,0,0,0,0,110,111,122,122,108,101,67,97,
+			108,105,98,114,97,116,105,111,110,45,82,101,112,50,45,65,
+			0,150,0,0,134,0,132,4,136,0,0,0,20,0,132,3,
+			105,1,0,0,20,0,144,27,139,0,0,0,0,0,0,0,
+			0,63,0,0,0,0,0,0,0,0,0,0,0,0,128,0,
+			0,0,136,0,3,2,110,0,135,0,100,0,255,255,136,0,
+			3,2,220,0,136,1,3,2,220,0,131,4,188,0,0,0,
+			20,0,140,0,0,0,0,0,0,0,0,48,248,255,255,0,
+			0,0,4,0,0,0,0,0,224,213,20,0,0,24,0,0,
+			160,64,85,3,63,131,4,184,11,0,0,20,0,144,4,139,
+			94,215,255,255,202,228,255,255,32,78,0,0,0,0,0,0,
+			0,0,0,0,128,0,0,0,145,0,20,145,1,20,145,2,
+			20,145,3,20,145,4,20,135,0,100,0,255,255,134,1,139,
+			94,215,255,255,202,63,228,255,255,32,78,0,0,0,0,0,
+			0,0,0,0,0,128,0,0,0,135,1,100,0,255,255,145,
+			0,127,145,1,127,145,2,40,145,3,127,145,4,127,134,0,
+			139,94,215,255,255,202,228,255,255,32,78,0,0,0,0,0,
+			0,0,0,0,0,128,2,0,0,0,231,94,215,202,228,240,
+			0,120,30,0,0,24,154,153,69,66,224,4,232,208,253,116,
+			0,0,0,24,0,0,128,64,53,0,20,140,94,215,255,255,
+			202,228,255,255,240,0,0,0,0,0,0,0,0,0,0,0,
+			239,228,14,237,4,120,0,48,2,247,13,0,0,24,34,164,
+			42,66,0,10,232,214,255,70,7,0,0,24,154,153,153,62,
+			83,3,1,137,136,236,216,254,14,0,119,30,0,0,24,164,
+			112,61,63,224,4,232,242,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,75,241,36,254,168,4,0,0,24,0,0,32,
+			66,42,3,235,181,14,183,3,76,2,67,14,0,0,24,142,
+			5,37,66,0,10,232,144,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,248,244,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,235,8,11,183,3,76,2,240,13,0,0,24,128,
+			60,253,65,0,10,232,144,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,248,244,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,235,8,11,183,3,76,2,240,13,0,0,24,128,
+			60,253,65,0,10,232,144,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,248,244,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,235,8,11,182,3,76,2,240,13,0,0,24,128,
+			60,253,65,0,10,232,144,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,248,244,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,235,8,11,183,3,76,2,240,13,0,0,24,128,
+			60,253,65,0,10,232,144,255,149,14,0,0,24,154,153,153,
+			62,170,6,233,248,244,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,235,8,11,183,3,76,2,240,13,0,0,24,128,
+			60,253,65,0,10,64,240,232,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,235,8,11,183,3,76,2,240,13,0,0,
+			24,128,60,253,65,0,10,232,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,239,133,25,92,226,40,1,76,2,37,11,
+			0,0,24,74,186,212,66,0,10,236,216,254,116,255,119,30,
+			0,0,24,164,112,61,63,224,4,232,28,0,149,14,0,0,
+			24,154,153,153,62,170,6,234,182,14,36,254,168,4,0,0,
+			24,0,0,32,66,42,3,235,183,3,74,241,76,2,67,14,
+			0,0,24,142,5,37,66,0,10,232,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,234,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,235,183,3,248,244,76,2,240,13,
+			0,0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,234,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,235,183,3,248,244,76,2,240,13,
+			0,0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,234,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,235,183,3,248,244,76,2,240,13,
+			0,0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,234,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,235,182,3,248,244,76,2,240,13,
+			0,0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,234,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,235,183,3,248,244,76,2,240,13,
+			0,0,24,128,60,253,65,0,10,64,240,232,144,255,149,14,
+			0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,4,
+			0,0,24,0,0,240,65,42,3,235,183,3,248,244,76,2,
+			240,13,0,0,24,128,60,253,65,0,10,232,144,255,149,14,
+			0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,4,
+			0,0,24,0,0,240,65,42,3,232,76,2,70,7,0,0,
+			24,0,0,0,63,83,3,51,137,8,134,1,139,81,33,0,
+			0,173,3,0,0,64,0,0,0,176,205,255,255,0,0,0,
+			0,128,0,0,0,137,24,140,81,33,0,0,173,3,0,0,
+			64,0,0,0,80,50,0,0,0,0,0,0,239,46,210,67,
+			230,40,1,186,255,210,12,0,0,24,37,235,14,67,0,10,
+			240,214,255,70,7,0,0,24,154,153,153,62,83,3,1,137,
+			144,244,216,254,14,0,119,30,0,0,24,164,112,61,63,224,
+			4,240,242,255,149,14,0,0,24,154,153,153,62,170,6,241,
+			8,11,36,254,168,4,0,0,24,0,0,240,65,42,3,243,
+			248,244,173,3,76,2,244,13,0,0,24,114,251,252,65,0,
+			10,240,144,255,149,14,0,0,24,154,153,153,62,170,6,241,
+			8,11,36,254,168,4,0,0,24,0,0,240,65,42,3,243,
+			248,244,173,3,76,2,244,13,0,0,24,114,251,252,65,0,
+			10,240,144,255,149,14,0,0,24,154,153,153,62,170,6,241,
+			8,11,36,254,168,4,0,0,24,0,0,240,65,42,3,243,
+			248,244,174,3,76,2,244,13,0,0,24,114,251,252,65,0,
+			10,240,144,255,149,14,0,0,24,154,153,153,62,170,6,241,
+			8,11,36,254,168,4,0,0,24,0,0,240,65,42,3,243,
+			248,244,173,3,76,2,244,13,0,0,24,114,251,252,65,0,
+			10,240,144,255,149,14,0,0,24,154,153,153,62,170,6,241,
+			8,11,36,254,168,4,0,0,24,0,0,240,65,42,3,243,
+			248,244,174,3,76,2,244,13,0,0,24,114,251,252,65,0,
+			10,240,144,255,149,14,0,0,24,154,153,153,62,170,6,64,
+			240,241,8,11,36,254,168,4,0,0,24,0,0,240,65,42,
+			3,243,248,244,173,3,76,2,244,13,0,0,24,114,251,252,
+			65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,170,
+			6,64,48,241,8,11,36,254,168,4,0,0,24,0,0,240,
+			65,42,3,247,80,3,141,215,40,1,76,2,168,14,0,0,
+			24,119,189,220,66,0,10,244,216,254,116,255,119,30,0,0,
+			24,164,112,61,63,224,4,240,28,0,149,14,0,0,24,154,
+			153,153,62,170,6,242,8,11,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,243,173,3,248,244,76,2,244,13,0,0,
+			24,114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,242,8,11,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,243,173,3,248,244,76,2,244,13,0,0,
+			24,114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,242,8,11,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,243,174,3,248,244,76,2,244,13,0,0,
+			24,114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,242,8,11,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,243,173,3,248,244,76,2,244,13,0,0,
+			24,114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,242,8,11,36,254,168,4,0,0,24,0,
+			0,240,65,42,3,243,174,3,248,244,76,2,244,13,0,0,
+			24,114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,
+			153,153,62,170,6,64,240,242,8,11,36,254,168,4,0,0,
+			24,0,0,240,65,42,3,243,173,3,248,244,76,2,244,13,
+			0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,0,
+			24,154,153,153,62,170,6,64,48,242,8,11,36,254,168,4,
+			0,0,24,0,0,240,65,42,3,60,137,16,155,247,45,0,
+			0,165,248,255,255,48,242,0,0,0,0,0,0,0,0,0,
+			0,202,19,0,0,24,10,215,26,67,42,3,137,31,136,0,
+			3,2,0,0,136,1,3,2,0,0,136,0,3,2,0,0,
+			150,100,0,154,0,137,31};
 		#else
-		const static uint8_t NozzleCalibrate[] PROGMEM = { 137,  8,  153,  0,  0,  0,  0,  82,  101,  112,  71,  32,  66,  117,  105,  108,  100,  0,  150,  0,  255,  134,  0,  136,  0,  31,  2,  110,  0,  136,  1,  31,  2,  110,  0,  134,  0,  136,  0,  3,  2,  220,  0,  134,  1,  136,  1,  3,  2,  220,  0,  132,  3,  105,  1,  0,  0,  20,  0,  131,  4,  136,  0,  0,  0,  20,  0,  140,  0,  0,  0,  0,  0,  0,  0,  0,  48,  248,  255,  255,  0,  0,  0,  0,  0,  0,  0,  0,  142,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  87,  41,  4,  0,  24,  131,  4,  220,  5,  0,  0,  20,  0,  144,  31,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  145,  0,  20,  145,  1,  20,  145,  2,  20,  145,  3,  20,  145,  4,  20,  134,  0,  134,  0,  135,  0,  100,  0,  255,  255,  141,  0,  100,  0,  255,  255,  134,  1,  134,  1,  135,  1,  100,  0,  255,  255,  141,  0,  100,  0,  255,  255,  145,  0,  127,  145,  1,  127,  145,  2,  40,  145,  3,  127,  145,  4,  127,  134,  0,  142,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  213,  167,  38,  0,  24,  136,  0,  10,  1,  3,  136,  0,  4,  1,  255,  142,  93,  215,  255,  255,  201,  228,  255,  255,  240,  0,  0,  0,  166,  254,  255,  255,  0,  0,  0,  0,  0,  62,  73,  0,  24,  140,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  134,  0,  142,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  11,  70,  16,  0,  24,  142,  67,  230,  255,  255,  184,  233,  255,  255,  104,  1,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  28,  88,  0,  0,  24,  137,  136,  142,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  239,  255,  255,  255,  0,  0,  0,  0,  26,  143,  0,  0,  24,  142,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  141,  215,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  134,  47,  48,  0,  24,  142,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  188,  15,  0,  24,  142,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  67,  230,  255,  255,  36,  241,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  219,  244,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  67,  230,  255,  255,  147,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  59,  219,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  109,  7,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  67,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  37,  11,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  220,  14,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  67,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  192,  244,  255,  255,  165,  248,  255,  255,  104,  1,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  24,  147,  40,  0,  24,  142,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  213,  255,  255,  255,  0,  0,  0,  0,  211,  122,  0,  0,  24,  142,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  192,  244,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  134,  47,  48,  0,  24,  142,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  188,  15,  0,  24,  142,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  118,  248,  255,  255,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  45,  252,  255,  255,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  227,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  228,  255,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  155,  3,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  154,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  155,  3,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  82,  7,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  81,  7,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  9,  11,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  191,  14,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  117,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  118,  18,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  45,  22,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  44,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  45,  22,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  228,  25,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  227,  25,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  155,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  154,  29,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  81,  33,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  146,  0,  0,  24,  137,  8,  134,  1,  137,  24,  140,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  22,  31,  0,  0,  0,  0,  0,  0,  142,  127,  243,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  227,  132,  54,  0,  24,  142,  128,  243,  255,  255,  239,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  28,  88,  0,  0,  24,  137,  144,  142,  127,  243,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  239,  255,  255,  255,  26,  143,  0,  0,  24,  142,  127,  243,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  136,  254,  255,  255,  239,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  136,  254,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  75,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  135,  254,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  128,  243,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  128,  243,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  128,  243,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  82,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  128,  243,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  128,  243,  255,  255,  174,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  128,  243,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  135,  254,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  128,  243,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  135,  254,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  128,  243,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  135,  254,  255,  255,  181,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  128,  243,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  135,  254,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  127,  243,  255,  255,  17,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  127,  243,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  136,  254,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  215,  1,  0,  0,  157,  237,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  83,  26,  42,  0,  24,  142,  214,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  212,  255,  255,  255,  211,  122,  0,  0,  24,  142,  215,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  215,  1,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  132,  5,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  132,  5,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  132,  5,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  49,  9,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  50,  9,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  49,  9,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  223,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  223,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  223,  12,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  140,  16,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  141,  16,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  140,  16,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  58,  20,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  57,  20,  0,  0,  158,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  58,  20,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  231,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  231,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  231,  23,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  149,  27,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  148,  27,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  149,  27,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  66,  31,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  65,  31,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  66,  31,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  240,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  239,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  239,  34,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  157,  38,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  156,  38,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  157,  38,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  74,  42,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  74,  42,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  74,  42,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  248,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  247,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  248,  45,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  137,  16,  142,  247,  45,  0,  0,  166,  248,  255,  255,  48,  242,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  160,  41,  121,  0,  24,  136,  1,  10,  1,  2,  136,  1,  4,  1,  255,  137,  31,  134,  0,  136,  0,  3,  2,  0,  0,  134,  1,  136,  1,  3,  2,  0,  0,  134,  0,  136,  0,  31,  2,  0,  0,  136,  1,  31,  2,  0,  0,  137,  31 };
+		const static uint8_t NozzleCalibrate[] PROGMEM = {
+			63,137,8,153,0,0,0,0,82,101,112,71,32,66,117,105,
+			108,100,0,150,0,255,134,0,136,0,31,2,110,0,136,1,
+			31,2,110,0,134,0,136,0,3,2,220,0,134,1,136,1,
+			3,2,220,0,132,3,105,1,0,0,20,0,131,4,136,0,
+			0,23,0,20,0,140,0,0,0,0,0,0,0,0,48,248,
+			255,255,0,0,0,0,0,0,0,0,160,87,41,4,0,24,
+			63,131,4,220,5,0,0,20,0,144,31,139,94,215,255,255,
+			202,228,255,255,32,78,0,0,0,0,0,0,0,0,0,0,
+			128,0,0,0,145,0,20,145,1,20,145,2,20,145,3,20,
+			145,4,20,134,0,134,0,135,0,100,0,255,255,141,0,100,
+			0,34,255,255,134,1,134,1,135,1,100,0,255,255,141,0,
+			100,0,255,255,145,0,127,145,1,127,145,2,40,145,3,127,
+			145,4,127,134,0,167,94,215,202,228,240,0,213,167,38,0,
+			24,9,136,0,10,1,3,136,0,4,1,255,171,255,255,255,
+			255,166,254,0,62,73,0,24,22,140,94,215,255,255,202,228,
+			255,255,240,0,0,0,0,0,0,0,0,0,0,0,134,0,
+			175,229,14,238,4,120,0,90,1,11,70,16,0,24,171,1,
+			0,1,0,230,255,28,88,0,0,24,1,137,136,175,255,255,
+			255,255,216,254,9,0,26,143,0,0,24,168,247,255,242,43,
+			0,0,24,169,75,241,218,254,134,47,48,0,24,171,181,14,
+			183,3,107,1,217,188,15,0,24,168,187,255,241,43,0,0,
+			24,169,248,244,218,254,165,35,36,0,24,171,8,11,183,3,
+			107,1,67,19,12,0,24,171,1,0,255,255,187,255,241,43,
+			0,0,24,171,247,244,1,0,218,254,165,35,36,0,24,171,
+			8,11,183,3,108,1,67,19,12,0,24,170,255,255,186,255,
+			242,43,0,0,24,171,248,244,1,0,218,254,165,35,36,0,
+			24,171,8,11,182,3,107,1,67,19,12,0,24,171,1,0,
+			1,0,187,255,242,43,0,0,24,171,247,244,255,255,218,254,
+			165,35,36,0,24,171,8,11,183,3,107,1,67,19,12,0,
+			24,168,187,255,242,43,0,0,24,169,248,244,218,254,165,35,
+			36,0,24,171,8,11,183,3,107,1,67,19,12,0,24,168,
+			187,255,242,43,0,0,24,169,249,244,218,254,165,35,36,0,
+			24,171,7,11,183,3,108,1,67,19,12,0,24,168,186,255,
+			242,43,0,0,24,169,248,244,218,254,165,35,36,0,24,171,
+			8,11,183,3,107,1,67,19,12,0,24,170,255,255,187,255,
+			242,43,0,0,24,171,248,244,1,0,218,254,165,35,36,0,
+			24,171,9,11,182,3,107,1,67,19,12,0,24,171,255,255,
+			1,0,187,255,241,43,0,0,24,171,248,244,255,255,218,254,
+			165,35,36,0,24,171,8,11,183,3,107,1,67,19,12,0,
+			24,170,1,0,187,255,241,43,0,0,24,171,248,244,255,255,
+			218,254,165,35,36,0,24,171,9,11,183,3,108,1,67,19,
+			12,0,24,169,255,255,186,255,241,43,0,0,24,169,248,244,
+			218,254,165,35,36,0,24,171,8,11,183,3,107,1,67,19,
+			12,0,24,168,187,255,241,43,0,0,24,169,248,244,218,254,
+			165,35,36,0,24,175,134,25,92,226,40,1,107,1,24,147,
+			40,0,24,173,255,255,216,254,170,255,211,122,0,0,24,168,
+			17,0,241,43,0,0,24,171,1,0,182,14,218,254,134,47,
+			48,0,24,171,182,3,74,241,107,1,217,188,15,0,24,168,
+			187,255,241,43,0,0,24,170,9,11,218,254,165,35,36,0,
+			24,171,183,3,247,244,107,1,67,19,12,0,24,168,187,255,
+			241,43,0,0,24,170,9,11,218,254,165,35,36,0,24,171,
+			183,3,247,244,108,1,67,19,12,0,24,169,255,255,186,255,
+			241,43,0,0,24,171,1,0,8,11,218,254,165,35,36,0,
+			24,171,183,3,249,244,107,1,67,19,12,0,24,171,255,255,
+			255,255,187,255,241,43,0,0,24,171,1,0,8,11,218,254,
+			165,35,36,0,24,171,182,3,248,244,107,1,67,19,12,0,
+			24,171,1,0,1,0,187,255,241,43,0,0,24,171,255,255,
+			7,11,218,254,165,35,36,0,24,171,183,3,248,244,107,1,
+			67,19,12,0,24,168,187,255,241,43,0,0,24,171,1,0,
+			9,11,218,254,165,35,36,0,24,171,182,3,247,244,108,1,
+			67,19,12,0,24,168,186,255,241,43,0,0,24,170,9,11,
+			218,254,165,35,36,0,24,171,182,3,247,244,107,1,67,19,
+			12,0,24,169,1,0,187,255,241,43,0,0,24,170,8,11,
+			218,254,165,35,36,0,24,171,183,3,249,244,107,1,67,19,
+			12,0,24,171,255,255,255,255,187,255,241,43,0,0,24,171,
+			1,0,8,11,218,254,165,35,36,0,24,171,182,3,248,244,
+			107,1,67,19,12,0,24,171,1,0,1,0,187,255,241,43,
+			0,0,24,171,255,255,7,11,218,254,165,35,36,0,24,171,
+			183,3,248,244,108,1,67,19,12,0,24,169,1,0,186,255,
+			241,43,0,0,24,171,255,255,9,11,218,254,165,35,36,0,
+			24,171,183,3,247,244,107,1,67,19,12,0,24,168,187,255,
+			241,43,0,0,24,170,9,11,218,254,165,35,36,0,24,170,
+			255,255,107,1,217,146,0,0,24,26,137,8,134,1,137,24,
+			140,81,33,0,0,173,3,0,0,64,0,0,0,22,31,0,
+			0,0,0,0,0,175,46,210,67,230,40,1,213,255,227,132,
+			54,0,24,179,1,0,255,255,229,255,28,88,0,0,24,1,
+			137,144,183,255,255,1,0,216,254,10,0,26,143,0,0,24,
+			176,246,255,242,43,0,0,24,179,9,11,255,255,212,254,165,
+			35,36,0,24,179,247,244,174,3,115,1,41,16,12,0,24,
+			176,185,255,241,43,0,0,24,177,9,11,212,254,165,35,36,
+			0,24,179,247,244,174,3,115,1,41,16,12,0,24,178,255,
+			255,185,255,241,43,0,0,24,177,8,11,212,254,165,35,36,
+			0,24,179,249,244,174,3,115,1,41,16,12,0,24,177,255,
+			255,186,255,242,43,0,0,24,177,8,11,210,254,165,35,36,
+			0,24,179,249,244,173,3,117,1,41,16,12,0,24,177,255,
+			255,184,255,242,43,0,0,24,177,8,11,212,254,165,35,36,
+			0,24,179,249,244,174,3,115,1,41,16,12,0,24,177,255,
+			255,185,255,242,43,0,0,24,179,8,11,255,255,212,254,165,
+			35,36,0,24,179,249,244,174,3,115,1,41,16,12,0,24,
+			177,255,255,185,255,242,43,0,0,24,177,8,11,212,254,165,
+			35,36,0,24,179,249,244,174,3,115,1,41,16,12,0,24,
+			179,255,255,255,255,186,255,242,43,0,0,24,177,8,11,210,
+			254,165,35,36,0,24,179,248,244,174,3,117,1,41,16,12,
+			0,24,177,1,0,184,255,242,43,0,0,24,177,7,11,212,
+			254,165,35,36,0,24,179,248,244,173,3,115,1,41,16,12,
+			0,24,177,1,0,185,255,241,43,0,0,24,177,7,11,212,
+			254,165,35,36,0,24,179,248,244,174,3,115,1,41,16,12,
+			0,24,177,1,0,185,255,241,43,0,0,24,179,7,11,255,
+			255,212,254,165,35,36,0,24,179,248,244,174,3,115,1,41,
+			16,12,0,24,177,1,0,186,255,241,43,0,0,24,177,7,
+			11,210,254,165,35,36,0,24,179,248,244,174,3,117,1,41,
+			16,12,0,24,178,255,255,184,255,241,43,0,0,24,177,9,
+			11,212,254,165,35,36,0,24,183,79,3,141,215,40,1,115,
+			1,83,26,42,0,24,181,255,255,216,254,168,255,211,122,0,
+			0,24,177,1,0,17,0,241,43,0,0,24,178,9,11,212,
+			254,165,35,36,0,24,179,173,3,247,244,115,1,41,16,12,
+			0,24,176,185,255,241,43,0,0,24,178,8,11,212,254,165,
+			35,36,0,24,179,173,3,248,244,115,1,41,16,12,0,24,
+			177,1,0,185,255,241,43,0,0,24,179,255,255,8,11,212,
+			254,165,35,36,0,24,179,174,3,248,244,115,1,41,16,12,
+			0,24,176,186,255,241,43,0,0,24,178,8,11,210,254,165,
+			35,36,0,24,179,173,3,248,244,117,1,41,16,12,0,24,
+			177,1,0,184,255,241,43,0,0,24,179,255,255,8,11,212,
+			254,165,35,36,0,24,179,174,3,248,244,115,1,41,16,12,
+			0,24,179,255,255,1,0,185,255,241,43,0,0,24,179,1,
+			0,7,11,212,254,165,35,36,0,24,179,173,3,248,244,115,
+			1,41,16,12,0,24,176,185,255,241,43,0,0,24,178,8,
+			11,212,254,165,35,36,0,24,179,174,3,248,244,115,1,41,
+			16,12,0,24,177,255,255,186,255,241,43,0,0,24,179,1,
+			0,8,11,210,254,165,35,36,0,24,179,173,3,248,244,117,
+			1,41,16,12,0,24,177,255,255,184,255,241,43,0,0,24,
+			179,1,0,8,11,212,254,165,35,36,0,24,179,174,3,248,
+			244,115,1,41,16,12,0,24,177,255,255,185,255,241,43,0,
+			0,24,178,9,11,212,254,165,35,36,0,24,179,174,3,247,
+			244,115,1,41,16,12,0,24,177,255,255,185,255,241,43,0,
+			0,24,179,1,0,8,11,212,254,165,35,36,0,24,179,173,
+			3,248,244,115,1,41,16,12,0,24,176,186,255,241,43,0,
+			0,24,178,8,11,210,254,165,35,36,0,24,179,174,3,248,
+			244,117,1,41,16,12,0,24,177,255,255,184,255,241,43,0,
+			0,24,179,1,0,8,11,212,254,165,35,36,0,24,63,137,
+			16,142,247,45,0,0,166,248,255,255,48,242,0,0,0,0,
+			0,0,0,0,0,0,160,41,121,0,24,136,1,10,1,2,
+			136,1,4,1,255,137,31,134,0,136,0,3,2,0,0,134,
+			1,136,1,3,2,0,0,134,0,136,0,31,2,0,0,7,
+			136,1,31,2,0,0,137,31};
 		#endif
 	#else
 		#if defined(USE_ZMAX_HOME)
-		const static uint8_t NozzleCalibrate[] PROGMEM = { 137,  8,  153,  0,  0,  0,  0,  110,  111,  122,  122,  108,  101,  67,  97,  108,  105,  98,  114,  97,  116,  105,  111,  110,  45,  82,  101,  112,  49,  95,  65,  0,  150,  0,  0,  134,  0,  132,  4,  136,  0,  0,  0,  20,  0,  132,  3,  105,  1,  0,  0,  20,  0,  144,  27,  139,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  136,  0,  3,  2,  110,  0,  135,  0,  100,  0,  255,  255,  136,  0,  3,  2,  220,  0,  136,  1,  3,  2,  220,  0,  131,  4,  188,  0,  0,  0,  20,  0,  140,  0,  0,  0,  0,  0,  0,  0,  0,  48,  248,  255,  255,  0,  0,  0,  0,  0,  0,  0,  0,  133,  32,  78,  0,  0,  155,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  213,  20,  0,  0,  24,  0,  0,  160,  64,  85,  3,  131,  4,  184,  11,  0,  0,  20,  0,  144,  4,  139,  0,  0,  0,  0,  0,  0,  0,  0,  160,  15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  155,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  192,  24,  0,  0,  24,  252,  223,  10,  67,  192,  13,  145,  0,  20,  145,  1,  20,  145,  2,  20,  145,  3,  20,  145,  4,  20,  135,  0,  100,  0,  255,  255,  134,  1,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  135,  1,  100,  0,  255,  255,  145,  0,  127,  145,  1,  127,  145,  2,  40,  145,  3,  127,  145,  4,  127,  134,  0,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  155,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  120,  30,  0,  0,  24,  154,  153,  69,  66,  224,  4,  155,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  208,  253,  255,  255,  0,  0,  0,  0,  116,  0,  0,  0,  24,  0,  0,  128,  64,  53,  0,  140,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  155,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  247,  13,  0,  0,  24,  34,  164,  42,  66,  0,  10,  155,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  70,  7,  0,  0,  24,  154,  153,  153,  62,  83,  3,  137,  136,  155,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  228,  255,  255,  255,  0,  0,  0,  0,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  141,  215,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  32,  66,  42,  3,  155,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  67,  14,  0,  0,  24,  142,  5,  37,  66,  0,  10,  155,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  66,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  58,  219,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  191,  244,  255,  255,  165,  248,  255,  255,  104,  1,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  37,  11,  0,  0,  24,  74,  186,  212,  66,  0,  10,  155,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  186,  255,  255,  255,  0,  0,  0,  0,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  191,  244,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  32,  66,  42,  3,  155,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  67,  14,  0,  0,  24,  142,  5,  37,  66,  0,  10,  155,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  118,  248,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  45,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  45,  252,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  228,  255,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  155,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  155,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  155,  3,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  81,  7,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  8,  11,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  191,  14,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  118,  18,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  45,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  45,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  45,  22,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  227,  25,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  154,  29,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  240,  13,  0,  0,  24,  128,  60,  253,  65,  0,  10,  155,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  214,  255,  255,  255,  0,  0,  0,  0,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  250,  253,  255,  255,  0,  0,  0,  0,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  70,  0,  0,  0,  0,  0,  0,  0,  70,  7,  0,  0,  24,  0,  0,  0,  63,  83,  3,  137,  8,  134,  1,  139,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  176,  205,  255,  255,  0,  0,  0,  0,  128,  0,  0,  0,  137,  24,  140,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  80,  50,  0,  0,  0,  0,  0,  0,  155,  195,  242,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  223,  12,  0,  0,  24,  94,  170,  16,  67,  0,  10,  155,  195,  242,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  70,  7,  0,  0,  24,  154,  153,  153,  62,  83,  3,  137,  144,  155,  195,  242,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  228,  255,  255,  255,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  195,  242,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  195,  242,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  195,  242,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  203,  253,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  26,  1,  0,  0,  157,  237,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  168,  14,  0,  0,  24,  119,  189,  220,  66,  0,  10,  155,  26,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  186,  255,  255,  255,  119,  30,  0,  0,  24,  164,  112,  61,  63,  224,  4,  155,  26,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  26,  1,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  200,  4,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  200,  4,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  200,  4,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  117,  8,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  117,  8,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  117,  8,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  35,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  35,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  35,  12,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  208,  15,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  208,  15,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  208,  15,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  125,  19,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  125,  19,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  125,  19,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  43,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  43,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  43,  23,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  216,  26,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  216,  26,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  216,  26,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  134,  30,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  134,  30,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  134,  30,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  51,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  51,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  51,  34,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  224,  37,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  224,  37,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  224,  37,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  142,  41,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  142,  41,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  142,  41,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  155,  59,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  70,  0,  0,  0,  244,  13,  0,  0,  24,  114,  251,  252,  65,  0,  10,  155,  59,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  214,  255,  255,  255,  149,  14,  0,  0,  24,  154,  153,  153,  62,  170,  6,  155,  59,  45,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  250,  253,  255,  255,  168,  4,  0,  0,  24,  0,  0,  240,  65,  42,  3,  137,  16,  155,  59,  45,  0,  0,  165,  248,  255,  255,  48,  242,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  202,  19,  0,  0,  24,  10,  215,  26,  67,  42,  3,  137,  31,  136,  0,  3,  2,  0,  0,  136,  1,  3,  2,  0,  0,  136,  0,  3,  2,  0,  0,  150,  100,  0,  154,  0,  137,  31 };
+		const static uint8_t NozzleCalibrate[] PROGMEM = {
+			63,137,8,153,0,0,0,0,110,111,122,122,108,101,67,97,
+			108,105,98,114,97,116,105,111,110,45,82,101,112,49,95,65,
+			0,150,0,0,134,0,132,4,136,0,0,0,20,0,132,3,
+			105,1,0,0,20,0,144,27,139,0,0,0,0,0,0,0,
+			0,63,0,0,0,0,0,0,0,0,0,0,0,0,128,0,
+			0,0,136,0,3,2,110,0,135,0,100,0,255,255,136,0,
+			3,2,220,0,136,1,3,2,220,0,131,4,188,0,0,0,
+			20,0,140,0,0,0,0,0,0,0,0,48,248,255,255,0,
+			0,0,9,0,0,0,0,0,133,32,78,0,0,224,213,20,
+			0,0,24,0,0,160,64,85,3,34,131,4,184,11,0,0,
+			20,0,144,4,139,0,0,0,0,0,0,0,0,160,15,0,
+			0,0,0,0,0,0,0,0,0,128,0,0,0,231,94,215,
+			202,228,32,78,192,24,0,0,24,252,223,10,67,192,13,63,
+			145,0,20,145,1,20,145,2,20,145,3,20,145,4,20,135,
+			0,100,0,255,255,134,1,139,94,215,255,255,202,228,255,255,
+			32,78,0,0,0,0,0,0,0,0,0,0,128,0,0,0,
+			135,1,100,0,255,255,145,0,127,145,1,127,145,2,40,145,
+			31,3,127,145,4,127,134,0,139,94,215,255,255,202,228,255,
+			255,32,78,0,0,0,0,0,0,0,0,0,0,128,0,0,
+			0,228,208,178,120,30,0,0,24,154,153,69,66,224,4,232,
+			208,253,116,0,0,0,24,0,0,128,64,53,0,20,140,94,
+			215,255,255,202,228,255,255,240,0,0,0,0,0,0,0,0,
+			0,0,0,239,228,14,237,4,120,0,48,2,247,13,0,0,
+			24,34,164,42,66,0,10,232,214,255,70,7,0,0,24,154,
+			153,153,62,83,3,1,137,136,236,216,254,14,0,119,30,0,
+			0,24,164,112,61,63,224,4,232,242,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,75,241,36,254,168,4,0,0,24,
+			0,0,32,66,42,3,235,181,14,183,3,76,2,67,14,0,
+			0,24,142,5,37,66,0,10,232,144,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,235,8,11,183,3,76,2,240,13,0,
+			0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,235,8,11,183,3,76,2,240,13,0,
+			0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,235,8,11,182,3,76,2,240,13,0,
+			0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,235,8,11,183,3,76,2,240,13,0,
+			0,24,128,60,253,65,0,10,232,144,255,149,14,0,0,24,
+			154,153,153,62,170,6,233,248,244,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,235,8,11,183,3,76,2,240,13,0,
+			0,24,128,60,253,65,0,10,64,240,232,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,233,248,244,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,235,8,11,183,3,76,2,240,
+			13,0,0,24,128,60,253,65,0,10,232,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,233,248,244,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,239,133,25,92,226,40,1,76,
+			2,37,11,0,0,24,74,186,212,66,0,10,236,216,254,116,
+			255,119,30,0,0,24,164,112,61,63,224,4,232,28,0,149,
+			14,0,0,24,154,153,153,62,170,6,234,182,14,36,254,168,
+			4,0,0,24,0,0,32,66,42,3,235,183,3,74,241,76,
+			2,67,14,0,0,24,142,5,37,66,0,10,232,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,235,183,3,248,244,76,
+			2,240,13,0,0,24,128,60,253,65,0,10,232,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,235,183,3,248,244,76,
+			2,240,13,0,0,24,128,60,253,65,0,10,232,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,235,183,3,248,244,76,
+			2,240,13,0,0,24,128,60,253,65,0,10,232,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,235,182,3,248,244,76,
+			2,240,13,0,0,24,128,60,253,65,0,10,232,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,234,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,235,183,3,248,244,76,
+			2,240,13,0,0,24,128,60,253,65,0,10,64,240,232,144,
+			255,149,14,0,0,24,154,153,153,62,170,6,234,8,11,36,
+			254,168,4,0,0,24,0,0,240,65,42,3,235,183,3,248,
+			244,76,2,240,13,0,0,24,128,60,253,65,0,10,232,144,
+			255,149,14,0,0,24,154,153,153,62,170,6,234,8,11,36,
+			254,168,4,0,0,24,0,0,240,65,42,3,232,76,2,70,
+			7,0,0,24,0,0,0,63,83,3,51,137,8,134,1,139,
+			81,33,0,0,173,3,0,0,64,0,0,0,176,205,255,255,
+			0,0,0,0,128,0,0,0,137,24,140,81,33,0,0,173,
+			3,0,0,64,0,0,0,80,50,0,0,0,0,0,0,239,
+			114,209,67,230,40,1,186,255,223,12,0,0,24,94,170,16,
+			67,0,10,240,214,255,70,7,0,0,24,154,153,153,62,83,
+			3,1,137,144,244,216,254,14,0,119,30,0,0,24,164,112,
+			61,63,224,4,240,242,255,149,14,0,0,24,154,153,153,62,
+			170,6,241,8,11,36,254,168,4,0,0,24,0,0,240,65,
+			42,3,243,248,244,173,3,76,2,244,13,0,0,24,114,251,
+			252,65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,
+			170,6,241,8,11,36,254,168,4,0,0,24,0,0,240,65,
+			42,3,243,248,244,173,3,76,2,244,13,0,0,24,114,251,
+			252,65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,
+			170,6,241,8,11,36,254,168,4,0,0,24,0,0,240,65,
+			42,3,243,248,244,174,3,76,2,244,13,0,0,24,114,251,
+			252,65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,
+			170,6,241,8,11,36,254,168,4,0,0,24,0,0,240,65,
+			42,3,243,248,244,173,3,76,2,244,13,0,0,24,114,251,
+			252,65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,
+			170,6,241,8,11,36,254,168,4,0,0,24,0,0,240,65,
+			42,3,243,248,244,174,3,76,2,244,13,0,0,24,114,251,
+			252,65,0,10,240,144,255,149,14,0,0,24,154,153,153,62,
+			170,6,64,240,241,8,11,36,254,168,4,0,0,24,0,0,
+			240,65,42,3,243,248,244,173,3,76,2,244,13,0,0,24,
+			114,251,252,65,0,10,240,144,255,149,14,0,0,24,154,153,
+			153,62,170,6,64,48,241,8,11,36,254,168,4,0,0,24,
+			0,0,240,65,42,3,247,79,3,141,215,40,1,76,2,168,
+			14,0,0,24,119,189,220,66,0,10,244,216,254,116,255,119,
+			30,0,0,24,164,112,61,63,224,4,240,28,0,149,14,0,
+			0,24,154,153,153,62,170,6,242,8,11,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,243,174,3,248,244,76,2,244,
+			13,0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,242,8,11,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,243,173,3,248,244,76,2,244,
+			13,0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,242,8,11,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,243,174,3,248,244,76,2,244,
+			13,0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,242,8,11,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,243,173,3,248,244,76,2,244,
+			13,0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,242,8,11,36,254,168,4,0,
+			0,24,0,0,240,65,42,3,243,173,3,248,244,76,2,244,
+			13,0,0,24,114,251,252,65,0,10,240,144,255,149,14,0,
+			0,24,154,153,153,62,170,6,64,240,242,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,243,174,3,248,244,76,
+			2,244,13,0,0,24,114,251,252,65,0,10,240,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,242,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,243,173,3,248,244,76,
+			2,244,13,0,0,24,114,251,252,65,0,10,240,144,255,149,
+			14,0,0,24,154,153,153,62,170,6,242,8,11,36,254,168,
+			4,0,0,24,0,0,240,65,42,3,60,137,16,155,59,45,
+			0,0,165,248,255,255,48,242,0,0,0,0,0,0,0,0,
+			0,0,202,19,0,0,24,10,215,26,67,42,3,137,31,136,
+			0,3,2,0,0,136,1,3,2,0,0,136,0,3,2,0,
+			0,150,100,0,154,0,137,31};
 		#else
-		const static uint8_t NozzleCalibrate[] PROGMEM = { 137,  16,  153,  0,  0,  0,  0,  82,  101,  112,  71,  32,  66,  117,  105,  108,  100,  0,  150,  0,  255,  134,  0,  136,  0,  31,  2,  110,  0,  136,  1,  31,  2,  110,  0,  134,  0,  136,  0,  3,  2,  220,  0,  134,  1,  136,  1,  3,  2,  220,  0,  132,  3,  105,  1,  0,  0,  20,  0,  131,  4,  136,  0,  0,  0,  20,  0,  140,  0,  0,  0,  0,  0,  0,  0,  0,  48,  248,  255,  255,  0,  0,  0,  0,  0,  0,  0,  0,  142,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  87,  41,  4,  0,  24,  131,  4,  220,  5,  0,  0,  20,  0,  144,  31,  139,  94,  215,  255,  255,  202,  228,  255,  255,  32,  78,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  128,  0,  0,  0,  145,  0,  20,  145,  1,  20,  145,  2,  20,  145,  3,  20,  145,  4,  20,  134,  0,  134,  0,  135,  0,  100,  0,  255,  255,  141,  0,  100,  0,  255,  255,  134,  1,  134,  1,  135,  1,  100,  0,  255,  255,  141,  0,  100,  0,  255,  255,  145,  0,  127,  145,  1,  127,  145,  2,  40,  145,  3,  127,  145,  4,  127,  134,  0,  142,  93,  215,  255,  255,  201,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  213,  167,  38,  0,  24,  136,  0,  10,  1,  3,  136,  0,  4,  1,  255,  142,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  166,  254,  255,  255,  0,  0,  0,  0,  0,  62,  73,  0,  24,  140,  94,  215,  255,  255,  202,  228,  255,  255,  240,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  134,  0,  142,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  11,  70,  16,  0,  24,  142,  66,  230,  255,  255,  183,  233,  255,  255,  104,  1,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  28,  88,  0,  0,  24,  137,  136,  142,  66,  230,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  239,  255,  255,  255,  0,  0,  0,  0,  26,  143,  0,  0,  24,  142,  67,  230,  255,  255,  184,  233,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  140,  215,  255,  255,  183,  233,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  134,  47,  48,  0,  24,  142,  66,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  188,  15,  0,  24,  142,  67,  230,  255,  255,  110,  237,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  109,  237,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  37,  241,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  219,  244,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  67,  230,  255,  255,  220,  244,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  219,  244,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  147,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  146,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  147,  248,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  67,  230,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  73,  252,  255,  255,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  59,  219,  255,  255,  183,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  109,  7,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  110,  7,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  242,  43,  0,  0,  24,  142,  58,  219,  255,  255,  109,  7,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  37,  11,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  36,  11,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  37,  11,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  67,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  219,  14,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  66,  230,  255,  255,  147,  18,  0,  0,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  146,  18,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  67,  230,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  66,  230,  255,  255,  72,  22,  0,  0,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  58,  219,  255,  255,  73,  22,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  191,  244,  255,  255,  165,  248,  255,  255,  104,  1,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  24,  147,  40,  0,  24,  142,  192,  244,  255,  255,  166,  248,  255,  255,  64,  0,  0,  0,  213,  255,  255,  255,  0,  0,  0,  0,  211,  122,  0,  0,  24,  142,  191,  244,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  191,  244,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  134,  47,  48,  0,  24,  142,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  188,  15,  0,  24,  142,  118,  248,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  119,  248,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  45,  252,  255,  255,  166,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  44,  252,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  45,  252,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  228,  255,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  228,  255,  255,  255,  166,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  228,  255,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  154,  3,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  155,  3,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  154,  3,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  82,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  81,  7,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  82,  7,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  8,  11,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  8,  11,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  191,  14,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  191,  14,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  118,  18,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  118,  18,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  118,  18,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  44,  22,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  45,  22,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  44,  22,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  228,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  227,  25,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  228,  25,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  44,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  154,  29,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  154,  29,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  82,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  67,  19,  12,  0,  24,  142,  81,  33,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  230,  255,  255,  255,  0,  0,  0,  0,  241,  43,  0,  0,  24,  142,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  192,  254,  255,  255,  0,  0,  0,  0,  165,  35,  36,  0,  24,  142,  81,  33,  0,  0,  174,  3,  0,  0,  64,  0,  0,  0,  43,  0,  0,  0,  0,  0,  0,  0,  217,  146,  0,  0,  24,  137,  8,  134,  1,  137,  24,  140,  81,  33,  0,  0,  173,  3,  0,  0,  64,  0,  0,  0,  22,  31,  0,  0,  0,  0,  0,  0,  142,  195,  242,  255,  255,  239,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  125,  47,  55,  0,  24,  142,  195,  242,  255,  255,  240,  233,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  28,  88,  0,  0,  24,  137,  144,  142,  195,  242,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  239,  255,  255,  255,  26,  143,  0,  0,  24,  142,  195,  242,  255,  255,  239,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  240,  233,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  75,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  74,  241,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  248,  244,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  82,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  83,  252,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  0,  0,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  174,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  203,  253,  255,  255,  173,  3,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  242,  43,  0,  0,  24,  142,  204,  253,  255,  255,  91,  7,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  8,  11,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  181,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  182,  14,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  99,  18,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  195,  242,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  195,  242,  255,  255,  17,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  203,  253,  255,  255,  16,  22,  0,  0,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  26,  1,  0,  0,  157,  237,  255,  255,  104,  1,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  83,  26,  42,  0,  24,  142,  27,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  212,  255,  255,  255,  211,  122,  0,  0,  24,  142,  26,  1,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  27,  1,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  199,  4,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  200,  4,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  200,  4,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  117,  8,  0,  0,  158,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  118,  8,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  117,  8,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  34,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  35,  12,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  35,  12,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  208,  15,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  208,  15,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  208,  15,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  125,  19,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  125,  19,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  126,  19,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  43,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  42,  23,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  43,  23,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  216,  26,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  217,  26,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  216,  26,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  133,  30,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  134,  30,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  134,  30,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  51,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  51,  34,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  51,  34,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  224,  37,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  224,  37,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  230,  255,  255,  255,  241,  43,  0,  0,  24,  142,  225,  37,  0,  0,  166,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  184,  254,  255,  255,  165,  35,  36,  0,  24,  142,  142,  41,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  45,  0,  0,  0,  41,  16,  12,  0,  24,  142,  141,  41,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  142,  41,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  142,  59,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  44,  0,  0,  0,  41,  16,  12,  0,  24,  142,  59,  45,  0,  0,  157,  237,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  229,  255,  255,  255,  241,  43,  0,  0,  24,  142,  60,  45,  0,  0,  165,  248,  255,  255,  64,  0,  0,  0,  0,  0,  0,  0,  185,  254,  255,  255,  165,  35,  36,  0,  24,  137,  16,  142,  59,  45,  0,  0,  165,  248,  255,  255,  48,  242,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  160,  41,  121,  0,  24,  136,  1,  10,  1,  2,  136,  1,  4,  1,  255,  137,  31,  134,  0,  136,  0,  3,  2,  0,  0,  134,  1,  136,  1,  3,  2,  0,  0,  134,  0,  136,  0,  31,  2,  0,  0,  136,  1,  31,  2,  0,  0,  137,  31 };
+		const static uint8_t NozzleCalibrate[] PROGMEM = {
+			63,137,16,153,0,0,0,0,82,101,112,71,32,66,117,105,
+			108,100,0,150,0,255,134,0,136,0,31,2,110,0,136,1,
+			31,2,110,0,134,0,136,0,3,2,220,0,134,1,136,1,
+			3,2,220,0,132,3,105,1,0,0,20,0,131,4,136,0,
+			0,23,0,20,0,140,0,0,0,0,0,0,0,0,48,248,
+			255,255,0,0,0,0,0,0,0,0,160,87,41,4,0,24,
+			63,131,4,220,5,0,0,20,0,144,31,139,94,215,255,255,
+			202,228,255,255,32,78,0,0,0,0,0,0,0,0,0,0,
+			128,0,0,0,145,0,20,145,1,20,145,2,20,145,3,20,
+			145,4,20,134,0,134,0,135,0,100,0,255,255,141,0,100,
+			0,34,255,255,134,1,134,1,135,1,100,0,255,255,141,0,
+			100,0,255,255,145,0,127,145,1,127,145,2,40,145,3,127,
+			145,4,127,134,0,167,93,215,201,228,240,0,213,167,38,0,
+			24,9,136,0,10,1,3,136,0,4,1,255,171,1,0,1,
+			0,166,254,0,62,73,0,24,22,140,94,215,255,255,202,228,
+			255,255,240,0,0,0,0,0,0,0,0,0,0,0,134,0,
+			175,228,14,237,4,120,0,90,1,11,70,16,0,24,168,230,
+			255,28,88,0,0,24,1,137,136,172,216,254,9,0,26,143,
+			0,0,24,171,1,0,1,0,247,255,242,43,0,0,24,171,
+			73,241,255,255,218,254,134,47,48,0,24,171,182,14,183,3,
+			107,1,217,188,15,0,24,169,1,0,187,255,241,43,0,0,
+			24,171,247,244,255,255,218,254,165,35,36,0,24,171,8,11,
+			184,3,107,1,67,19,12,0,24,168,187,255,241,43,0,0,
+			24,169,248,244,218,254,165,35,36,0,24,171,8,11,182,3,
+			108,1,67,19,12,0,24,171,1,0,1,0,186,255,242,43,
+			0,0,24,171,247,244,255,255,218,254,165,35,36,0,24,171,
+			8,11,184,3,107,1,67,19,12,0,24,170,255,255,187,255,
+			242,43,0,0,24,171,248,244,1,0,218,254,165,35,36,0,
+			24,171,8,11,182,3,107,1,67,19,12,0,24,169,1,0,
+			187,255,242,43,0,0,24,169,247,244,218,254,165,35,36,0,
+			24,171,8,11,183,3,107,1,67,19,12,0,24,168,187,255,
+			242,43,0,0,24,169,248,244,218,254,165,35,36,0,24,171,
+			8,11,183,3,108,1,67,19,12,0,24,168,186,255,242,43,
+			0,0,24,169,249,244,218,254,165,35,36,0,24,171,7,11,
+			182,3,107,1,67,19,12,0,24,170,1,0,187,255,242,43,
+			0,0,24,171,248,244,255,255,218,254,165,35,36,0,24,171,
+			8,11,184,3,107,1,67,19,12,0,24,170,255,255,187,255,
+			241,43,0,0,24,171,248,244,1,0,218,254,165,35,36,0,
+			24,171,9,11,182,3,107,1,67,19,12,0,24,169,255,255,
+			187,255,241,43,0,0,24,169,248,244,218,254,165,35,36,0,
+			24,171,8,11,184,3,108,1,67,19,12,0,24,170,255,255,
+			186,255,241,43,0,0,24,169,248,244,218,254,165,35,36,0,
+			24,171,9,11,183,3,107,1,67,19,12,0,24,171,255,255,
+			255,255,187,255,241,43,0,0,24,171,248,244,1,0,218,254,
+			165,35,36,0,24,175,133,25,92,226,40,1,107,1,24,147,
+			40,0,24,175,1,0,1,0,216,254,170,255,211,122,0,0,
+			24,171,255,255,255,255,17,0,241,43,0,0,24,170,182,14,
+			218,254,134,47,48,0,24,171,183,3,74,241,107,1,217,188,
+			15,0,24,168,187,255,241,43,0,0,24,171,1,0,8,11,
+			218,254,165,35,36,0,24,171,182,3,249,244,107,1,67,19,
+			12,0,24,171,255,255,255,255,187,255,241,43,0,0,24,171,
+			1,0,8,11,218,254,165,35,36,0,24,171,183,3,248,244,
+			108,1,67,19,12,0,24,170,1,0,186,255,241,43,0,0,
+			24,170,7,11,218,254,165,35,36,0,24,171,182,3,248,244,
+			107,1,67,19,12,0,24,171,1,0,1,0,187,255,241,43,
+			0,0,24,171,255,255,7,11,218,254,165,35,36,0,24,171,
+			184,3,248,244,107,1,67,19,12,0,24,169,255,255,187,255,
+			241,43,0,0,24,171,1,0,9,11,218,254,165,35,36,0,
+			24,171,182,3,247,244,107,1,67,19,12,0,24,168,187,255,
+			241,43,0,0,24,170,9,11,218,254,165,35,36,0,24,171,
+			183,3,247,244,108,1,67,19,12,0,24,168,186,255,241,43,
+			0,0,24,170,8,11,218,254,165,35,36,0,24,171,183,3,
+			249,244,107,1,67,19,12,0,24,170,255,255,187,255,241,43,
+			0,0,24,170,8,11,218,254,165,35,36,0,24,171,182,3,
+			248,244,107,1,67,19,12,0,24,171,1,0,1,0,187,255,
+			241,43,0,0,24,171,255,255,7,11,218,254,165,35,36,0,
+			24,171,184,3,248,244,107,1,67,19,12,0,24,169,255,255,
+			187,255,241,43,0,0,24,171,1,0,9,11,218,254,165,35,
+			36,0,24,171,182,3,247,244,108,1,67,19,12,0,24,168,
+			186,255,241,43,0,0,24,170,9,11,218,254,165,35,36,0,
+			24,171,184,3,247,244,107,1,67,19,12,0,24,169,255,255,
+			187,255,241,43,0,0,24,170,8,11,218,254,165,35,36,0,
+			24,170,1,0,107,1,217,146,0,0,24,26,137,8,134,1,
+			137,24,140,81,33,0,0,173,3,0,0,64,0,0,0,22,
+			31,0,0,0,0,0,0,175,114,209,65,230,40,1,213,255,
+			125,47,55,0,24,178,1,0,229,255,28,88,0,0,24,1,
+			137,144,180,216,254,10,0,26,143,0,0,24,178,255,255,246,
+			255,242,43,0,0,24,179,8,11,1,0,212,254,165,35,36,
+			0,24,179,248,244,173,3,115,1,41,16,12,0,24,176,185,
+			255,241,43,0,0,24,177,8,11,212,254,165,35,36,0,24,
+			179,248,244,173,3,115,1,41,16,12,0,24,178,1,0,186,
+			255,241,43,0,0,24,179,8,11,255,255,210,254,165,35,36,
+			0,24,179,248,244,174,3,117,1,41,16,12,0,24,176,184,
+			255,242,43,0,0,24,177,8,11,212,254,165,35,36,0,24,
+			179,248,244,173,3,115,1,41,16,12,0,24,176,185,255,242,
+			43,0,0,24,177,8,11,212,254,165,35,36,0,24,179,248,
+			244,174,3,115,1,41,16,12,0,24,178,255,255,185,255,242,
+			43,0,0,24,179,8,11,1,0,212,254,165,35,36,0,24,
+			179,248,244,173,3,115,1,41,16,12,0,24,176,186,255,242,
+			43,0,0,24,177,8,11,210,254,165,35,36,0,24,179,248,
+			244,173,3,117,1,41,16,12,0,24,178,1,0,184,255,242,
+			43,0,0,24,179,8,11,255,255,212,254,165,35,36,0,24,
+			179,248,244,174,3,115,1,41,16,12,0,24,176,185,255,242,
+			43,0,0,24,177,9,11,212,254,165,35,36,0,24,179,247,
+			244,173,3,115,1,41,16,12,0,24,176,185,255,241,43,0,
+			0,24,177,8,11,212,254,165,35,36,0,24,179,248,244,174,
+			3,115,1,41,16,12,0,24,178,255,255,186,255,241,43,0,
+			0,24,179,8,11,1,0,210,254,165,35,36,0,24,179,248,
+			244,173,3,117,1,41,16,12,0,24,176,184,255,241,43,0,
+			0,24,177,8,11,212,254,165,35,36,0,24,179,248,244,173,
+			3,115,1,41,16,12,0,24,178,1,0,185,255,241,43,0,
+			0,24,179,8,11,255,255,212,254,165,35,36,0,24,183,79,
+			3,141,215,40,1,115,1,83,26,42,0,24,181,1,0,216,
+			254,168,255,211,122,0,0,24,177,255,255,17,0,241,43,0,
+			0,24,179,1,0,8,11,212,254,165,35,36,0,24,179,172,
+			3,248,244,115,1,41,16,12,0,24,177,1,0,185,255,241,
+			43,0,0,24,178,8,11,212,254,165,35,36,0,24,179,173,
+			3,249,244,115,1,41,16,12,0,24,179,1,0,255,255,186,
+			255,241,43,0,0,24,179,255,255,8,11,210,254,165,35,36,
+			0,24,179,173,3,248,244,117,1,41,16,12,0,24,177,1,
+			0,184,255,241,43,0,0,24,178,8,11,212,254,165,35,36,
+			0,24,179,173,3,248,244,115,1,41,16,12,0,24,176,185,
+			255,241,43,0,0,24,64,30,179,1,0,8,11,212,254,165,
+			35,36,0,24,179,173,3,248,244,115,1,41,16,12,0,24,
+			177,255,255,186,255,241,43,0,0,24,179,1,0,9,11,210,
+			254,165,35,36,0,24,179,173,3,247,244,117,1,41,16,12,
+			0,24,177,1,0,184,255,241,43,0,0,24,179,255,255,8,
+			11,212,254,165,35,36,0,24,179,173,3,248,244,115,1,41,
+			16,12,0,24,177,1,0,185,255,241,43,0,0,24,178,8,
+			11,212,254,165,35,36,0,24,179,173,3,248,244,115,1,41,
+			16,12,0,24,176,185,255,241,43,0,0,24,178,8,11,212,
+			254,165,35,36,0,24,179,173,3,248,244,115,1,41,16,12,
+			0,24,176,186,255,241,43,0,0,24,179,1,0,9,11,210,
+			254,165,35,36,0,24,179,173,3,247,244,117,1,41,16,12,
+			0,24,177,255,255,184,255,241,43,0,0,24,179,1,0,8,
+			11,212,254,165,35,36,0,24,179,173,3,248,244,115,1,41,
+			16,12,0,24,176,185,255,241,43,0,0,24,179,1,0,8,
+			11,212,254,165,35,36,0,24,63,137,16,142,59,45,0,0,
+			165,248,255,255,48,242,0,0,0,0,0,0,0,0,0,0,
+			160,41,121,0,24,136,1,10,1,2,136,1,4,1,255,137,
+			31,134,0,136,0,3,2,0,0,134,1,136,1,3,2,0,
+			0,134,0,136,0,31,2,0,0,7,136,1,31,2,0,0,
+			137,31};
 		#endif
 	#endif
 #endif // !defined(SINGLE_EXTRUDER) && defined(NOZZLE_CALIBRATION_SCRIPT)
@@ -64,11 +592,28 @@ const static uint16_t Lengths[3]  PROGMEM = { 98, /// Home Axes
 LEVEL_PLATE
 
 namespace utility {
-	 
+
+// The scripts are packed with firmware/packUtilityScript.py, whose docstring
+// has the format, and unpacked into the command buffer as they are played
+#define PACKED_REPEAT		0x40
+#define PACKED_MOVE		0x80
+#define PACKED_MOVE_EXT		0x40
+#define PACKED_MOVE_REST	0x20
+#define PACKED_AXES		5
+
+#define MOVE_LENGTH		26	// HOST_CMD_QUEUE_POINT_NEW
+#define MOVE_EXT_LENGTH		32	// HOST_CMD_QUEUE_POINT_NEW_EXT
+#define MOVE_REST_OFFSET	(1 + 4 * PACKED_AXES)
+
 volatile bool is_playing;
-int build_index = 0;
-int build_length = 0;
-const uint8_t * buildFile;
+static const uint8_t *script;		// next byte of the packed script
+static uint16_t script_left;		// bytes left to play, once unpacked
+static uint8_t literal_left;		// of the literal run being played
+static uint8_t repeat_left;		// plays left of the repeat being played
+static uint8_t move_index, move_length;	// of the move being played
+
+// The last move, which the next packs its positions and the rest against
+static uint8_t move[MOVE_EXT_LENGTH];
 	  
 /// returns true if script is running
 bool isPlaying() {
@@ -76,42 +621,110 @@ bool isPlaying() {
 }
 
 void reset() {
-	build_index = 0;
-	build_length = 0;
+	script_left = 0;
 	is_playing = false;
 }
  
 /// returns true if more bytes are available in the script
 bool playbackHasNext() {
-	return (build_index < build_length);
+	return script_left != 0;
+}
+
+// Unpack a move op into move[]
+static void unpackMove(uint8_t op) {
+	int32_t *positions = (int32_t *)(move + 1);
+
+	move[0] = ( op & PACKED_MOVE_EXT ) ? HOST_CMD_QUEUE_POINT_NEW_EXT : HOST_CMD_QUEUE_POINT_NEW;
+	move_length = ( op & PACKED_MOVE_EXT ) ? MOVE_EXT_LENGTH : MOVE_LENGTH;
+	for ( uint8_t i = 0; i < PACKED_AXES; i++ ) {
+		if ( op & (1 << i) ) {
+			positions[i] += (int16_t)pgm_read_word(script);
+			script += 2;
+		}
+	}
+	if ( op & PACKED_MOVE_REST ) {
+		memcpy_P(move + MOVE_REST_OFFSET, script, move_length - MOVE_REST_OFFSET);
+		script += move_length - MOVE_REST_OFFSET;
+	}
+	move_index = 0;
 }
  
-/// gets next byte in script
-uint8_t playbackNext() {
-	uint8_t byte;
+// Read the next op of the script, which isn't a repeat
+static void nextOp() {
+	for (;;) {
+		uint8_t op = pgm_read_byte(script++);
+		if ( op < PACKED_REPEAT ) {
+			literal_left = op + 1;
+			return;
+		}
+		if ( op >= PACKED_MOVE ) {
+			unpackMove(op);
+			return;
+		}
+		// The first time the op is reached the bytes before it have
+		// played once
+		uint8_t length = pgm_read_byte(script++);
+		if ( repeat_left == 0 )
+			repeat_left = (op & (PACKED_REPEAT - 1)) + 1;
+		else
+			repeat_left--;
+		if ( repeat_left )
+			script -= length + 2;
+	}
+}
+
+/// copies up to count bytes of the script to dst
+uint16_t playbackRead(uint8_t *dst, uint16_t count) {
+	if ( count > script_left )
+		count = script_left;
+	script_left -= count;
 
-	if ( build_index < build_length ) { 
-		byte = pgm_read_byte(buildFile + build_index++);
-		return byte;
+	uint16_t left = count;
+	while ( left ) {
+		uint8_t n;
+		if ( move_index < move_length ) {
+			n = move_length - move_index;
+			if ( n > left )
+				n = (uint8_t)left;
+			memcpy(dst, move + move_index, n);
+			move_index += n;
+		}
+		else if ( literal_left ) {
+			n = literal_left;
+			if ( n > left )
+				n = (uint8_t)left;
+			memcpy_P(dst, script, n);
+			script += n;
+			literal_left -= n;
+		}
+		else {
+			nextOp();
+			continue;
+		}
+		dst += n;
+		left -= n;
 	}
-	else 
-		return 0;
+	return count;
+}
+ 
+/// gets next byte in script
+uint8_t playbackNext() {
+	uint8_t byte = 0;
+	playbackRead(&byte, 1);
+	return byte;
 }
  
 /// begin buffer playback
 bool startPlayback(uint8_t build) {
-	is_playing = true;
-	build_index = 0;
-
 	// get build file
 	switch (build) {
 	case HOME_AXES:  // we just used the first 98 bytes
 	case LEVEL_PLATE_STARTUP:
-		buildFile = LevelPlate;
+		script = LevelPlate;
 		break;
-#if !defined(SINGLE_EXTRUDER) && defined(NOZZLE_CALIBRATE_SCRIPT)
+#if !defined(SINGLE_EXTRUDER) && defined(NOZZLE_CALIBRATION_SCRIPT)
 	case TOOLHEAD_CALIBRATE:
-		buildFile = NozzleCalibrate;
+		script = NozzleCalibrate;
 		break;
 #endif
 	default:
@@ -119,7 +732,12 @@ bool startPlayback(uint8_t build) {
 	}
 	
 	// get build length
-	build_length = pgm_read_word(Lengths + build);
+	script_left = pgm_read_word(Lengths + build);
+	literal_left = 0;
+	repeat_left = 0;
+	move_index = move_length = 0;
+	memset(move, 0, sizeof(move));
+	is_playing = true;
 
 	return true;
 }
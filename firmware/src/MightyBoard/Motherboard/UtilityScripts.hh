@@ -36,6 +36,10 @@ namespace utility {
  
  /// gets next byte in script
  uint8_t playbackNext();
+
+ /// copies up to count of the next bytes in the script to dst, a run
+ /// at a time, and returns how many it copied, 0 at the end
+ uint16_t playbackRead(uint8_t *dst, uint16_t count);
  
  /// begin buffer playback
  bool startPlayback(uint8_t build);
@@ -0,0 +1,31 @@
+/*
+ *  Enables the external memory interface for XMEM builds; see Xmem.hh
+ */
+
+#include "Xmem.hh"
+
+#if defined(XMEM) && !defined(SIMULATOR)
+
+#include <avr/io.h>
+
+// Where the linker put the xmem section
+extern uint8_t __start_xmem[];
+extern uint8_t __stop_xmem[];
+
+// Runs in .init3, after the stack pointer is set up and before .data is
+// copied, .bss cleared and the constructors run, so the buffers are there
+// and zeroed for them as .bss would be.  Being naked, it falls through to
+// the next init section rather than returning.
+void xmem_init(void) __attribute__((naked, used, section(".init3")));
+
+void xmem_init(void) {
+	// One sector over the whole external range, with its wait states
+	// set by SRW11:SRW10, and all of port C given to the address bus
+	XMCRA = _BV(SRE) | ((XMEM_WAIT_STATES) << SRW10);
+	XMCRB = 0;
+
+	for ( uint8_t *p = __start_xmem; p < __stop_xmem; p ++ )
+		*p = 0;
+}
+
+#endif
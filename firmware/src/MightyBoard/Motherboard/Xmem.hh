@@ -0,0 +1,73 @@
+#ifndef __XMEM_HH__
+#define __XMEM_HH__
+
+#include "Configuration.hh"
+
+// External SRAM on the ATmega1280/2560 external memory interface.  With
+// XMEM, the buffers picked by the platform's 'xmem' list in platforms.py are
+// placed in the xmem section, which the link puts at 0x2200, just past the
+// internal SRAM.  Up to 0xFFFF, that's 56.5 KB.  The interface is enabled and
+// the section cleared in .init3, before the C runtime touches any of it.
+//
+// The interface takes over ports A and C and pins G0-G2, so this is only for
+// boards which have an SRAM there instead of the stock MightyBoard's steppers.
+//
+//   XMEM_PLANNER          -- block_buffer[] and its side arrays
+//   XMEM_COMMANDS         -- the command buffer
+//   XMEM_SD               -- the SD read buffer, or sd_raw's block cache
+//   XMEM_FLIGHT_RECORDER  -- the flight recorder's ring
+//
+// Each moves the default size of its buffer up to one which only fits in
+// external SRAM; the PLATFORM_ settings still override them.  An external
+// access takes a cycle more than an internal one, and XMEM_WAIT_STATES (0 to
+// 3, default 0) more again, for SRAMs slower than 55 ns.
+
+#if defined(XMEM) && !defined(SIMULATOR)
+
+#if !defined(__AVR_ATmega1280__) && !defined(__AVR_ATmega2560__)
+#error "XMEM needs the external memory interface of an ATmega1280 or 2560"
+#endif
+
+#ifndef XMEM_WAIT_STATES
+#define XMEM_WAIT_STATES 0
+#endif
+
+#if XMEM_WAIT_STATES < 0 || XMEM_WAIT_STATES > 3
+#error "XMEM_WAIT_STATES must be from 0 to 3"
+#endif
+
+#define XMEM_DATA __attribute__((section("xmem")))
+
+#else
+
+#define XMEM_DATA
+
+#endif
+
+// The attribute for each buffer, empty for one left in internal SRAM
+
+#if defined(XMEM) && defined(XMEM_PLANNER)
+#define XMEM_PLANNER_DATA XMEM_DATA
+#else
+#define XMEM_PLANNER_DATA
+#endif
+
+#if defined(XMEM) && defined(XMEM_COMMANDS)
+#define XMEM_COMMANDS_DATA XMEM_DATA
+#else
+#define XMEM_COMMANDS_DATA
+#endif
+
+#if defined(XMEM) && defined(XMEM_SD)
+#define XMEM_SD_DATA XMEM_DATA
+#else
+#define XMEM_SD_DATA
+#endif
+
+#if defined(XMEM) && defined(XMEM_FLIGHT_RECORDER)
+#define XMEM_FLIGHT_RECORDER_DATA XMEM_DATA
+#else
+#define XMEM_FLIGHT_RECORDER_DATA
+#endif
+
+#endif
@@ -307,6 +307,60 @@ _iAccum divkS(_iAccum x, _iAccum y) {
 }
 
 
+/**
+ * Restoring division which only develops as many quotient bits as the
+ * result needs: the divisor is first aligned with the dividend, then one
+ * bit is generated per shift-subtract step, plus a rounding bit.  For
+ * operands of similar size that is around 18 steps, against the 32 of
+ * the libgcc division used by divkD() and divkS(), and all 16 fractional
+ * bits are exact.  Overflows saturate.
+ */
+_iAccum divkF(_iAccum x, _iAccum y) {
+  uint32_t ux, uy, rem, q;
+  uint8_t n, neg, carry;
+
+  if(y == 0)
+     return (x < 0 ? AVRFIX_ACCUM_MIN : AVRFIX_ACCUM_MAX);
+  if(x == 0)
+     return 0;
+
+  neg = (x < 0) != (y < 0);
+  ux = (uint32_t)absk(x);
+  uy = (uint32_t)absk(y);
+
+  /* Quotient bits from 2^0 down to 2^-17, the last one for rounding,
+     and one more for each place the divisor is shifted up */
+  n = AVRFIX_ACCUM_FBIT + 2;
+  while(uy < ux && (uy & 0x80000000UL) == 0) {
+    uy = LSHIFT_static(uy, 1);
+    n++;
+  }
+
+  rem = ux;
+  q = 0;
+  carry = 0;
+  for(;;) {
+    q = LSHIFT_static(q, 1);
+    /* With a carry out of rem the true remainder exceeds uy,
+       and the unsigned subtraction wraps to the right value */
+    if(carry || rem >= uy) {
+      rem -= uy;
+      q |= 1;
+    }
+    if(--n == 0)
+      break;
+    if(q & 0x80000000UL)
+      return (neg ? AVRFIX_ACCUM_MIN : AVRFIX_ACCUM_MAX);
+    carry = (rem & 0x80000000UL) != 0;
+    rem = LSHIFT_static(rem, 1);
+  }
+  q = RSHIFT_static(q, 1) + (q & 1);
+  if(q > (uint32_t)AVRFIX_ACCUM_MAX)
+     return (neg ? AVRFIX_ACCUM_MIN : AVRFIX_ACCUM_MAX);
+  return (neg ? -(_iAccum)q : (_iAccum)q);
+}
+
+
 _lAccum ldivlkD(_lAccum x, _lAccum y) {
   if ( y == 0 )
     return ACCUM_INFINITY;
@@ -988,6 +1042,53 @@ _iAccum sqrtk_uncorrected(_iAccum a, int8_t pow2, uint8_t cordic_steps)
 }
 
 
+/**
+ * Digit by digit square root, developing the root of a * 2^16 one bit
+ * per step from two bits of the radicand, with shifts and subtractions
+ * only.  Leading zero bits of a are skipped without a step.  The result
+ * is rounded to the nearest 1/65536, where sqrtkD() needs 17 CORDIC
+ * steps with variable shifts and a gain correction multiply.
+ */
+_iAccum sqrtkF(_iAccum a)
+{
+  uint32_t x, rem, root, test;
+  uint8_t steps;
+
+  if(a <= 0)
+    return 0;
+
+  /* 16 bit pairs from a, then 8 pairs of zeros for the fraction */
+  x = (uint32_t)a;
+  steps = 24;
+  while((x & 0xFF000000UL) == 0) {
+    x = LSHIFT_static(x, 8);
+    steps -= 4;
+  }
+  while((x & 0xC0000000UL) == 0) {
+    x = LSHIFT_static(x, 2);
+    steps--;
+  }
+
+  rem = 0;
+  root = 0;
+  do {
+    rem = LSHIFT_static(rem, 2) | RSHIFT_static(x, 30);
+    x = LSHIFT_static(x, 2);
+    root = LSHIFT_static(root, 1);
+    test = LSHIFT_static(root, 1) | 1;
+    if(rem >= test) {
+      rem -= test;
+      root |= 1;
+    }
+  } while(--steps);
+
+  /* The true root is at least root + 1/2 when rem > root */
+  if(rem > root)
+    root++;
+  return (_iAccum)root;
+}
+
+
 /**
  * The cordic method works only within [1, 9]
  * for other values the following identity is used:
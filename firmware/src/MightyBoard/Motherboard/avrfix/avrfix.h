@@ -179,19 +179,31 @@ extern _sAccum sdivskS(_sAccum, _sAccum);
 extern _iAccum divkS(_iAccum, _iAccum);
 extern _lAccum ldivlkS(_lAccum, _lAccum);
 
+/* Faster, exactly rounded and saturating division.  divk() uses it
+   unless AVRFIX_ORIGINAL_DIVSQRT is defined */
+extern _iAccum divkF(_iAccum, _iAccum);
+
 #if FX_ACCUM_OVERFLOW == DEFAULT
   #define smulsk(a,b) smulskD((a),(b))
   #define mulk(a,b) mulkD((a),(b))
   #define lmullk(a,b) lmullkD((a), (b))
   #define sdivsk(a,b) sdivskD((a), (b))
+  #ifdef AVRFIX_ORIGINAL_DIVSQRT
   #define divk(a,b) divkD((a), (b))
+  #else
+  #define divk(a,b) divkF((a), (b))
+  #endif
   #define ldivlk(a,b) ldivlkD((a), (b))
 #elif FX_ACCUM_OVERFLOW == SAT
   #define smulsk(a,b) smulskS((a),(b))
   #define mulk(a,b) mulkS((a),(b))
   #define lmullk(a,b) lmullkS((a), (b))
   #define sdivsk(a,b) sdivskS((a), (b))
+  #ifdef AVRFIX_ORIGINAL_DIVSQRT
   #define divk(a,b) divkS((a), (b))
+  #else
+  #define divk(a,b) divkF((a), (b))
+  #endif
   #define ldivlk(a,b) ldivlkS((a), (b))
 #endif
 
@@ -280,17 +292,28 @@ extern uint8_t countlsk(_iAccum f);
 
 extern _iAccum sqrtk_uncorrected(_iAccum,int8_t,uint8_t);
 
+/* Digit by digit square root, rounded to nearest.  sqrtk() uses it
+   unless AVRFIX_ORIGINAL_DIVSQRT is defined */
+extern _iAccum sqrtkF(_iAccum);
+
 #define sqrtkD(a)   mulkD(sqrtk_uncorrected(a, -8, 17), CORDICH_GAIN/256)
 #define lsqrtlkD(a) lmullkD(sqrtk_uncorrected(a, 0, 24), CORDICH_GAIN)
 
 #define sqrtkS(a)   mulkS(sqrtk_uncorrected(a, -8, 17), CORDICH_GAIN/256)
 #define lsqrtlkS(a) lmullkS(sqrtk_uncorrected(a, 0, 24), CORDICH_GAIN)
 
+#if defined(AVRFIX_ORIGINAL_DIVSQRT)
+  #if FX_ACCUM_OVERFLOW == DEFAULT
+    #define sqrtk(a) sqrtkD(a)
+  #else
+    #define sqrtk(a) sqrtkS(a)
+  #endif
+#else
+  #define sqrtk(a) sqrtkF(a)
+#endif
 #if FX_ACCUM_OVERFLOW == DEFAULT
-  #define sqrtk(a) sqrtkD(a)
   #define lsqrtlk(a) lsqrtlkD(a)
 #else
-  #define sqrtk(a) sqrtkS(a)
   #define lsqrtlk(a) lsqrtlkS(a)
 #endif
 
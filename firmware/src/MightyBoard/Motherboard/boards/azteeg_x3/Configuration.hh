@@ -198,6 +198,13 @@
 #define VIKI_ENC_PIN_B		PINH
 #define VIKI_ENC_MASK_B		0b00010000
 
+// ViKi expander interrupt (INTA), if wired to a spare input, so that the
+// buttons are only read when they change; e.g. for PE6
+//#define VIKI_INT_PORT		PORTE
+//#define VIKI_INT_DDR		DDRE
+//#define VIKI_INT_PIN		PINE
+//#define VIKI_INT_MASK		0b01000000
+
 #define DIGIPOT_SUPPORT		1
 
 #define X_POT_PIN		0 // P0W on MCP4451 00 (A1=0 A0=0)
@@ -334,19 +341,19 @@
 #endif
 
 /// POWER Pins for extruders, fans and heated build platform
-#define EXA_PWR			Pin(PortB,4)	// OC2A
+#define EXA_PWR			FAST_PIN(B,4)	// OC2A
 #define EXA_PWR_OCRn		OCR2A
 #define EXA_PWR_TCCRn		TCCR2A
 #define EXA_PWR_TCCRn_on	0b10000000
 #define EXA_PWR_TCCRn_off	0b00111111
 
-#define EXB_PWR			Pin(PortH,6)	// OC2B
+#define EXB_PWR			FAST_PIN(H,6)	// OC2B
 #define EXB_PWR_OCRn		OCR2B
 #define EXB_PWR_TCCRn		TCCR2A
 #define EXB_PWR_TCCRn_on	0b00100000
 #define EXB_PWR_TCCRn_off	0b11001111
 
-#define HBP_HEAT		Pin(PortH,5)	// OC4C
+#define HBP_HEAT		FAST_PIN(H,5)	// OC4C
 
 // Extruder heat sink fans
 // We use the extra two extruder/fan outputs on the expansion board for these.
@@ -357,7 +364,7 @@
 
 // Print cooling fan
 #define ACTIVE_COOLING_FAN
-#define EX_FAN			Pin(PortG,5)	// OC0B / D4
+#define EX_FAN			FAST_PIN(G,5)	// OC0B / D4
 #define EXTRA_FET		EX_FAN
 
 // Rep 1: wait 0.5 seconds, then handle Extruder 1
@@ -450,6 +457,10 @@
 //Don't make it too large, as it will kill performance and can overflow int32_t
 //#define OVERSAMPLED_DDA 2
 
+//Alternatively, AMASS_DDA oversamples slow blocks only, by up to AMASS_MAX_LEVEL bits
+//(default 3), keeping the interrupt rate below AMASS_MAX_RATE.  It's selected in
+//platforms.py and can't be combined with OVERSAMPLED_DDA
+
 #else
 
 #define DEBUG_VALUE(x)
@@ -458,6 +469,17 @@
 
 #define JKN_ADVANCE
 
+//When defined, the advance extruder steps are taken from the stepper interrupt, on
+//the same timeline as the dda, instead of from their own 10KHz timer interrupt.
+//This saves the overhead of the second interrupt and the two no longer preempt
+//each other.
+//#define JKN_ADVANCE_UNIFIED_ISR
+
+//When defined, the endstops are read once per stepper interrupt, with one read of each
+//port, into a mask which the steps test, instead of by each axis on each of its steps.
+//Homing still reads them on every step
+//#define ENDSTOPS_LATCHED
+
 //Minimum time in seconds that a movement needs to take if the planning pipeline command buffer is
 //emptied. Increase this number if you see blobs while printing high speed & high detail. It will
 //slowdown on the detailed stuff.
@@ -470,7 +492,7 @@
 #define ACCELERATION_MIN_PLANNER_SPEED 2
 
 //Slowdown limit specifies what to do when the pipeline command buffer starts to empty.
-//The pipeline command buffer is 16 commands in length, and Slowdown Limit can be set
+//The pipeline command buffer is BLOCK_BUFFER_SIZE commands in length, and Slowdown Limit can be set
 //between 0 - 8 (half the buffer size).
 //
 //When Commands Left <= Slowdown Limit, the feed rate is progressively slowed down as the buffer
@@ -479,6 +501,10 @@
 //By slowing down the feed rate, you reduce the possibility of running out of commands, and creating
 //a blob due to the stopped movement.
 //
+//Once the time between the commands coming in has been measured, a move is only slowed as far as it
+//needs to be to last until the next is due, so moves which come in fast enough run at full speed.
+//The minimum segment time above is cut to that time too.
+//
 //Possible values are:
 //
 //0 - Disabled - Never Slowdown
@@ -487,6 +513,26 @@
 //3,4,5,6,7,8 - The higher the number, the earlier the start of the slowdown
 #define ACCELERATION_SLOWDOWN_LIMIT (BLOCK_BUFFER_SIZE/2)
 
+//When defined, moves from the host which are in a line and little more than a few steps long, as a
+//fine STL export makes of its curves, are merged with those following them in the command buffer
+//into one planner block, up to SEGMENT_MERGE_STEPS steps of X or Y (32 by default).  Their filament
+//adds up.  Moves are only merged when they turn by no more than SEGMENT_MERGE_DEVIATION steps, at
+//the same height and extruding at much the same rate, and when X, Y and Z are absolute and A and B
+//relative, as HOST_CMD_QUEUE_POINT_DELTA has them.  That leaves more of the planner's buffer to look
+//ahead with.
+//#define SEGMENT_MERGE
+
+//When defined, moves which don't extrude take their acceleration and junction deviation from
+//the TRAVEL_PROFILE EEPROM setting rather than from the printing limits.  A travel move can't
+//ooze or smear a line, so it can take its corners and speed up harder than a printing move.
+//#define TRAVEL_ACCELERATION
+
+//When defined, the moves are decoded on ahead of the planner while it's full, into a queue of
+//MOVE_QUEUE_SIZE (4) moves with their offsets, skew and extrusion factors already applied.  A
+//block freeing up is then filled from the queue in the next pass of the main loop, rather than
+//waiting on the command to be decoded.  Costs 39 bytes of RAM a move.
+//#define MOVE_QUEUE
+
 //ACCELERATION_EXTRUDER_WHEN_NEGATIVE specifies the direction of extruder.
 //If negative steps cause an extruder to extrude material, then set this to true.
 //If positive steps cause an extruder to extrude material, then set this to false.
@@ -583,24 +629,274 @@
 //When defined, acceleration stats are displayed on the LCD screen
 //#define ACCEL_STATS
 
+// When defined, the planner keeps statistics of the blocks run, for tuning
+// the acceleration and jerk: a histogram of their nominal speeds, how many
+// cruised at them rather than turning back in a triangle, how many started
+// from rest, and the time spent accelerating, cruising and decelerating.
+// Read with the HOST_CMD_GET_PLANNER_STATS query.  Costs about 50 bytes of RAM
+//#define PLANNER_STATS
+
+// When defined, the last FLIGHT_RECORDER_RECORDS blocks the steppers ran
+// (16 by default, 12 bytes of RAM each) are kept with their rates and timing,
+// and frozen when the planner runs dry in mid build, an error is shown or
+// the build is paused, to be read back with HOST_CMD_FLIGHT_RECORDER.
+//#define FLIGHT_RECORDER
+
+//When defined, the execution times of the stepper, advance, ADC and host
+//UART receive interrupts are recorded, and can be viewed from the Utilities
+//menu or read with the HOST_CMD_GET_ISR_PROFILE query
+//#define ISR_PROFILE
+
+//When defined, HOST_CMD_PC_PROFILE can have a timer interrupt sample
+//where the code is running once a millisecond, into PC_PROFILE_BUCKETS
+//buckets of flash (128 by default, 2 bytes of RAM each), for pcprof.py
+//to map to the functions of the ELF
+//#define PC_PROFILE
+
+//When defined (with STACK_PAINT), SRAM use is measured: the deepest the stack
+//has been, the static SRAM of the larger buffers and the headroom left over
+//time.  It can be viewed from the Utilities menu or read with the
+//HOST_CMD_GET_MEMORY_PROFILE query
+//#define MEMORY_PROFILE
+
+//When defined, the HOST_CMD_SD_BENCHMARK query reports how fast a file can be
+//read from the SD card
+//#define SD_BENCHMARK
+
+// When defined, the SD card menu keeps the names of the files on the lines
+// shown, reading a screenful at a time rather than a line at a time, and
+// not at all to scroll the selected name.  Costs about 140 bytes of RAM
+//#define SD_NAME_CACHE
+
+//When defined, SD card playback is instrumented to tell card stalls apart
+//from planner stalls.  The counters are shown on the print statistics
+//screen (DOWN to page) and can be read with HOST_CMD_GET_SD_PLAYBACK_STATS
+//#define SD_PLAYBACK_STATS
+
+//When defined, an SD card build's commands are decoded where they lie in the
+//SD read buffer rather than being copied through the command buffer.  Only a
+//command which runs over the end of a block of the card, or carries a
+//string, is copied.  The look ahead of SEGMENT_MERGE and TOOLCHANGE_PREHEAT
+//then stops at the end of the block being played.
+//#define SD_DIRECT_DECODE
+
+//When defined, the time each slice of the main loop takes is recorded,
+//with a histogram of the loop period.  Slices and passes which take longer
+//than SLICE_BUDGET_MS (default 5) are counted as over budget.  The loop
+//times rotate through the monitor screen and can be read with
+//HOST_CMD_GET_SLICE_STATS
+//#define SLICE_STATS
+
 // Disabled SD card folder support owing to a broken SD card detect switch
 //#define BROKEN_SD
 
 // Build with nozzle calibration S3G script and help screen to run it
 //#define NOZZLE_CALIBRATION_SCRIPT
 
-// Single extruder builds have space for SDHC & FAT-32 support
-#if defined(SINGLE_EXTRUDER) || !defined(NOZZLE_CALIBRATION_SCRIPT) || defined(__AVR_ATmega2560__)
+// Single extruder builds have space for SDHC & FAT-32 support.  A platform
+// can also choose for itself with SD_RAW_SDHC=0 or SD_RAW_SDHC=1
+#if !defined(SD_RAW_SDHC) && (defined(SINGLE_EXTRUDER) || !defined(NOZZLE_CALIBRATION_SCRIPT) || defined(__AVR_ATmega2560__))
 #define SD_RAW_SDHC 1
 #endif
 
+// Packet CRCs are looked up in a 256 byte table in flash, rather than worked
+// out bit by bit, for less time in the UART interrupts.  On by default where
+// there's flash to spare; set PACKET_CRC_TABLE=0 or 1 to choose
+#if !defined(PACKET_CRC_TABLE) && defined(__AVR_ATmega2560__)
+#define PACKET_CRC_TABLE 1
+#endif
+
+//The host may ask for status frames to be pushed to it with
+//HOST_CMD_SET_TELEMETRY, rather than polling.  On where there's flash to
+//spare; set HOST_TELEMETRY=0 or 1 to choose
+#if !defined(HOST_TELEMETRY) && defined(__AVR_ATmega2560__)
+#define HOST_TELEMETRY 1
+#endif
+
+//When defined, the host may ask with HOST_CMD_SET_LARGE_PACKETS for
+//packets of up to HOST_LARGE_PACKET_PAYLOAD (128) bytes, so that it can
+//send several moves in one packet with one reply.  The UART's input
+//packets grow to that size, 96 bytes more of RAM each
+//#define HOST_LARGE_PACKETS
+
+//When defined, HOST_CMD_EEPROM_IMAGE takes a whole EEPROM image, run
+//length encoded or not, and queues only the bytes which differ for the
+//EEPROM interrupt, then returns one CRC to verify it by; for
+//make-eeprom.py --port
+//#define EEPROM_IMAGE
+
+//When defined, the heater PID loops are worked out in fixed point rather
+//than in software float.  The outputs agree with the float PID to within
+//a count or two
+//#define PID_FIXED_POINT
+
+//When set, thermistor readings are converted with the dense tables in
+//TemperatureDenseTables.h, a table read and a shift, instead of a binary
+//search and a divide.  They cost about 2K of flash for each table slot,
+//and the PROGMEM tables must all stay in the first 64K of flash
+//#define TEMP_DENSE_TABLES 1
+
+//When defined, the ADC samples the extruder and platform inputs continuously
+//and averages 16 samples of each in its ISR, and the temperatures are all
+//converted together from one pass of averages every half second, rather
+//than from 8 samples taken one channel after another
+//#define ADC_SEQUENCER
+
+//When defined, with ADC_SEQUENCER, tool 0 has a sensor on each extruder
+//input and its temperature is theirs together: their average while they
+//agree to within TEMP_FUSION_SPREAD (15C), else the hotter of the two.  Set
+//the tool count to 1
+//#define TEMP_DUAL_FUSION
+
+#ifdef ADC_SEQUENCER
+#undef SAMPLE_INTERVAL_MICROS_THERMOCOUPLE
+#define SAMPLE_INTERVAL_MICROS_THERMOCOUPLE 500000L
+// Room for both pins of each extruder, as the menu can swap them, and
+// the analog buttons
+#ifndef ADC_SEQ_CHANNELS
+#ifdef HAS_ANALOG_BUTTONS
+#define ADC_SEQ_CHANNELS 6
+#else
+#define ADC_SEQ_CHANNELS 5
+#endif
+#endif
+#endif
+
+//When defined, the heaters add a feed-forward term to the PID, the output
+//a first order model of each heater says holds the target, and use the
+//model to decide when to stop heating at full output.  The models are
+//identified with HOST_CMD_HEATER_TUNE and kept in EEPROM; heaters
+//without one run the PID alone
+//#define HEATER_FEED_FORWARD
+
+//When defined, with HEATER_FEED_FORWARD, the heaters' models are also
+//used to watch for a runaway: every ten seconds the rise the model
+//expects for the output is compared with the rise measured, and a
+//heater that keeps falling well short of it, or heats well past it,
+//is shut down.  This takes the place of the fixed heating up progress
+//check for heaters with a model
+//#define HEATER_RUNAWAY_MODEL
+
+//When defined, the heaters' PIDs can be tuned by relay feedback, from
+//HOST_CMD_PID_AUTOTUNE or the utilities menu, and the gains found are
+//saved to EEPROM
+//#define PID_AUTOTUNE
+
+//When defined, the extruders and the platform heat at the same time,
+//sharing out this many watts between them, instead of the extruders
+//waiting for the platform.  The heaters' powers are HEATER_WATTS_EXTRUDER
+//and HEATER_WATTS_PLATFORM (Motherboard.hh); the budget is the supply's
+//rating less what the motors and electronics draw
+//#define HEATER_POWER_BUDGET 200
+#if defined(HEATER_POWER_BUDGET) && !defined(HEATERS_ON_STEROIDS)
+#define HEATERS_ON_STEROIDS
+#endif
+
+//When defined, the command buffer is searched ahead of the next tool change
+//for a temperature raise for the standby extruder, which is started early
+//enough for the extruder to be hot when the change comes: by the rate it
+//heated at last time, and with this many seconds to spare.  A wait for a
+//tool already at temperature then goes straight through, without waiting
+//for the moves to finish.  Needs two extruders
+//#define TOOLCHANGE_PREHEAT 5
+#if defined(TOOLCHANGE_PREHEAT) && !defined(ESTIMATE_TIME)
+#define ESTIMATE_TIME 1
+#endif
+
+//When defined, the heaters log their readings and outputs to a ring of
+//HEATER_LOG_SAMPLES samples (8 bytes each) in RAM, started and read back
+//with HOST_CMD_HEATER_LOG
+//#define HEATER_LOG
+
+//When defined, runHostSlice() logs the time of each host packet and the
+//reply to it to a ring of HOST_LOG_RECORDS records (8 bytes each) in RAM,
+//started and read back with HOST_CMD_HOST_LOG; see simulator/hostreplay.cc
+//#define HOST_LOG
+
+//When defined, a NAME.QUE text file on the SD card can be built as a queue of
+//builds, each started once the last has finished, with an optional cool down
+//and eject build between them; see PrintQueue.hh for the format
+//#define PRINT_QUEUE
+
+// When defined, the platform is watched as it cools after a build, and
+// HOST_CMD_BOARD_STATUS tells the host once it has settled at the release
+// temperature set in the EEPROM, and when the bot is ready for the next
+// build.  A print queue can wait for it with a "cool" line of its own.
+//#define PLATFORM_COOLDOWN
+
+//When defined, SD card builds are checkpointed to the EEPROM every
+//POWER_LOSS_RESUME_S seconds (60 by default), and a build cut short by a
+//power loss can be carried on from the main menu's "Resume Build".  X and Y
+//are homed again, but Z isn't, so the platform must not have moved since
+//#define POWER_LOSS_RESUME
+
 // When defined, the ability to write an SD card file over S3G is supported
 //#define S3G_CAPTURE_2_SD
 
+// When defined along with S3G_CAPTURE_2_SD, a file can be played back while
+// it is still being captured, so a build can start as soon as its upload
+// does.  Playback waits at the end of what has been captured so far.  Costs
+// a second FAT file handle, about 60 bytes of RAM
+//#define SD_PLAY_WHILE_CAPTURE
+
+// When defined, the file of an SD card build is read through alongside it,
+// while it waits for its heaters and a little at a time after, for its
+// layers, height, filament and time, shown on a page of the print
+// statistics.  With ESTIMATE_TIME, the time left is then told from how long
+// the moves still to come take rather than from the bytes left.  What's
+// found is kept in a NAME.INF file next to NAME.X3G for the next time it's
+// built.  Costs another FAT file handle, about 60 bytes of RAM
+//#define SD_PRESCAN
+
+// When defined along with SD_PRESCAN, the pre-scan also takes a CRC of the
+// whole file.  A file captured from the host has the CRC of what was written
+// kept in its .INF file, and a build whose file reads back differently, or
+// fails to read, is cancelled as soon as the scan gets there rather than
+// when the build does.  A file read back whole once isn't checked again.
+//#define SD_FILE_CRC
+
+// When defined, an SD card build writes a line for each layer to NAME.LOG
+// next to NAME.X3G: the layer's time, its moves' average speed, the planner
+// underruns during it, the fewest blocks planned and the furthest a heater
+// was from its target.  The lines are queued and written while the planner
+// has blocks to spare.  Costs another FAT file handle and a 128 byte queue,
+// about 200 bytes of RAM
+//#define LAYER_LOG
+
+// When defined, an SD card file can be dry run
+// from the host with HOST_CMD_DRY_RUN: it's read and planned as fast as it
+// can be, with nothing moved, heated or waited for, to check it runs on this
+// firmware and to see how far ahead of the steppers its moves are planned.
+//#define SD_DRY_RUN
+
+// When defined, the settings menu has a Fast Cancel option.  With it on, a
+// cancelled build slows to a stop within the move it's in, throws away the
+// moves and commands buffered after it, turns the heaters off and plans the
+// retract and the move clear of the build at once.  The build is over as soon
+// as they're planned; the bot resets once they've run.
+//#define FAST_CANCEL
+
+// When defined, the settings may let the moves which don't extrude go on
+// while the build waits for its heaters.  A wait for a tool or the platform
+// then holds back only the first move which moves an extruder, so homing,
+// probing and travel to the purge position happen as the nozzle heats.  A
+// file can also ask for this itself, between the begin and join of a
+// HOST_CMD_CONCURRENT, whatever the settings.
+//#define HEAT_WAIT_MOVES
+
 // When defined, VREF for the Z axis may be set above 40
 //#define DIGI_POT_HIGH_Z_VREF
 
-#if defined(BUILD_STATS) && !defined(ESTIMATE_TIME)
+// When defined, X and Y's motor currents follow the moves: raised by
+// CURRENT_BOOST_PERCENT around blocks which accelerate at CURRENT_BOOST_ACCEL
+// mm/s^2 or more or ramp to CURRENT_BOOST_SPEED mm/s or more, back to the
+// pots' settings for the rest of the moves, and lowered to
+// CURRENT_IDLE_PERCENT once the steppers have been still for
+// CURRENT_IDLE_SECONDS.  See Steppers.cc for the defaults.  The boost is held
+// to the pots' limit, so it only helps where they're set below it.
+//#define MOTOR_CURRENT_PROFILE
+
+#if ( defined(BUILD_STATS) || defined(SD_DRY_RUN) || defined(PLANNER_STATS) ) && !defined(ESTIMATE_TIME)
 #define ESTIMATE_TIME 1
 #endif
 
@@ -89,7 +89,7 @@ void DigiPots::init() {
 
      // Load our default VREF settings
      cli();
-     eeprom_read_block(defaultPotValues,
+     eeprom::readBlock(defaultPotValues,
 		       (void *)eeprom_offsets::DIGI_POT_SETTINGS,
 		       sizeof(uint8_t) * STEPPER_COUNT);
      sei();
@@ -128,13 +128,24 @@ void DigiPots::setPotValue(uint8_t axis, const uint8_t val) {
 
      packet[0] = 0x40;
      packet[1] = 0xFF;
-     TWI_write_data(addr, packet, 2);
+     TWI_queue_write(addr, packet, 2);
 
      packet[0] = 0xA0;
      packet[1] = 0xFF;
-     TWI_write_data(addr, packet, 2);
+     TWI_queue_write(addr, packet, 2);
 
      packet[0] = registers[axis];
      packet[1] = val;
-     TWI_write_data(addr, packet, 2);
+     TWI_queue_write(addr, packet, 2);
+}
+
+// The pots are on the hardware bus, and their writes are queued
+void DigiPots::setPotValues(const uint8_t *vals, uint8_t mask) {
+     for (uint8_t axis = 0; axis < STEPPER_COUNT; axis++)
+	  if ( mask & (1 << axis) )
+	       setPotValue(axis, vals[axis]);
+}
+
+void DigiPots::resetPots(uint8_t mask) {
+     setPotValues(defaultPotValues, mask);
 }
@@ -36,6 +36,7 @@
 
 #include "Compat.hh"
 #include "RGB_LED.hh"
+#include "RGB_Effects.hh"
 #include "Configuration.hh"
 #include "EepromMap.hh"
 #include "Eeprom.hh"
@@ -200,9 +201,7 @@ void setCustomColor(uint8_t red, uint8_t green, uint8_t blue) {
 }
 
 
-void setColor(uint8_t r, uint8_t g, uint8_t b) {
-	 if (!LEDEnabled) return;
-
+static void applyColor(uint8_t r, uint8_t g, uint8_t b) {
      pwm_r_top_value = r >> RGB_RES;
      pwm_g_top_value = g >> RGB_RES;
      pwm_b_top_value = b >> RGB_RES;
@@ -268,6 +267,28 @@ void setColor(uint8_t r, uint8_t g, uint8_t b) {
 
 #undef SOLID_ON_OFF
 }
+
+void setColor(uint8_t r, uint8_t g, uint8_t b) {
+	 if (!LEDEnabled) return;
+
+     RGB_Effects::colorSet(r, g, b);
+     applyColor(r, g, b);
+}
+
+void prepareEffect(const uint8_t * /*from*/, const uint8_t * /*to*/) {
+}
+
+// Once the PWM is running a step only changes its duty cycles
+bool pushColor(uint8_t r, uint8_t g, uint8_t b) {
+     if ( TIMSK1 & (1 << OCIE1A) ) {
+	  pwm_r_top_value = r >> RGB_RES;
+	  pwm_g_top_value = g >> RGB_RES;
+	  pwm_b_top_value = b >> RGB_RES;
+     }
+     else
+	  applyColor(r, g, b);
+     return true;
+}
 }
 
 #endif
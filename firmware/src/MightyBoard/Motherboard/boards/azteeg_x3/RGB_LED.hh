@@ -29,5 +29,10 @@ namespace RGB_LED {
  void setColor(uint8_t red, uint8_t green, uint8_t blue);
  void setDefaultColor(uint8_t c = 0xff);
  void setCustomColor(uint8_t red, uint8_t green, uint8_t blue);
+
+ // For RGB_Effects: set the driver up to show the colours between from
+ // and to, and show one of them from an interrupt; false if it couldn't
+ void prepareEffect(const uint8_t *from, const uint8_t *to);
+ bool pushColor(uint8_t red, uint8_t green, uint8_t blue);
 }
 #endif
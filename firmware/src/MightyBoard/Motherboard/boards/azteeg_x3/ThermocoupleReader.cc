@@ -34,6 +34,11 @@
 #include "EepromMap.hh"
 #include "Eeprom.hh"
 #include <avr/eeprom.h>
+#include <math.h>
+
+#if defined(ADC_SEQUENCER) && ADC_SEQ_CHANNELS < TEMP_NSENSORS + 2
+#error "ADC_SEQ_CHANNELS must leave room for both pins of each extruder"
+#endif
 
 /*
  * Thermocouple Reader Constructor
@@ -44,7 +49,6 @@
  * @param [in] pinH -- HBP ADC pin number (0 - 15)
  */
 ThermocoupleReader::ThermocoupleReader() :
-     error_code(TemperatureSensor::SS_OK),
      last(THERM_CHANNEL_TWO),
      pindex(THERM_CHANNEL_HBP)
 {
@@ -116,8 +120,10 @@ void ThermocoupleReader::reset() {
      cnt   = 0;
      accum = 0;
 
-     for (uint8_t i = 0; i < TEMP_NSENSORS; i++)
+     for (uint8_t i = 0; i < TEMP_NSENSORS; i++) {
 	  temp[i] = 0.0;
+	  error_code[i] = TemperatureSensor::SS_OK;
+     }
 }
 
 void ThermocoupleReader::init() {
@@ -126,9 +132,18 @@ void ThermocoupleReader::init() {
      for (uint8_t i = 0; i < TEMP_NSENSORS; i++)
 		 initAnalogPin(pin[i]);
 
+#ifdef ADC_SEQUENCER
+     // The sequencer averages each pin in turn from now on.  A pin it
+     // already has keeps its channel, and there's room for the other pin
+     // of each extruder should the menu change the sensor type.
+     for (uint8_t i = 0; i < TEMP_NSENSORS; i++)
+	  seq[i] = addAnalogChannel(pin[i]);
+     fresh = 0;
+#else
      // Initiate the first ADC sample
      finished = false;
      startAnalogRead(pin[pindex], &raw, &finished);
+#endif
 }
 
 /*
@@ -142,9 +157,108 @@ TemperatureSensor::SensorState ThermocoupleReader::GetChannelTemperature(uint8_t
 									 volatile float &read_temperature)
 {
      read_temperature = temp[channel];
-     return error_code;
+     return error_code[channel];
 }
 
+/*
+ * Convert a channel's sum of TEMP_OVERSAMPLE ADC samples to its
+ * temperature and error code
+ */
+void ThermocoupleReader::convert(uint8_t channel, int16_t sum) {
+
+     // Sensor type: thermocouple (1) or thermistor (0)
+
+     if ( sensor_types & (1 << channel) ) {
+
+	  // Thermocouple ADC
+	  // We can handle this faster than using a table
+	  if ( !(ADC_THERMOCOUPLE_DISCONNECTED(sum)) ) {
+		  temp[channel] = (float)((int32_t)sum * 1000L)/(float)(1024 * TEMP_OVERSAMPLE);
+		  error_code[channel] = (temp[channel] < MAX_TEMP) ?
+			  TemperatureSensor::SS_OK : TemperatureSensor::SS_BAD_READ;
+	  }
+	  else {
+		  // Value appears suspect; signal an error indicating that the
+		  // sensor is disconnected
+		  temp[channel] = MAX_TEMP;
+		  error_code[channel] = TemperatureSensor::SS_ERROR_UNPLUGGED;
+	  }
+     }
+     else {
+
+	  // Thermistor ADC
+	  if ( !(ADC_THERMISTOR_DISCONNECTED(sum)) ) {
+		  temp[channel] = TemperatureTable::TempReadtoCelsius(
+			  sum, table_indices[channel],
+			  MAX_TEMP);
+		  error_code[channel] = (temp[channel] < MAX_TEMP) ?
+			  TemperatureSensor::SS_OK : TemperatureSensor::SS_BAD_READ;
+	  }
+	  else {
+		  // Value appears suspect; signal an error indicating that the
+		  // sensor is disconnected
+		  error_code[channel] = TemperatureSensor::SS_ERROR_UNPLUGGED;
+		  temp[channel] = MAX_TEMP;
+	  }
+     }
+}
+
+#ifdef TEMP_DUAL_FUSION
+
+/*
+ * Tool 0 has a sensor on each extruder input.  Their average is tool 0's
+ * temperature while they agree; when they don't, the cooler one is taken to
+ * be the one that's wrong, a sensor come loose from the block, so that the
+ * heater can't overheat on it.  Either one failing fails tool 0.  Tool 1's
+ * reading is the second sensor's alone.
+ */
+void ThermocoupleReader::fuse() {
+     if ( error_code[THERM_CHANNEL_ONE] != TemperatureSensor::SS_OK )
+	  return;
+     if ( error_code[THERM_CHANNEL_TWO] != TemperatureSensor::SS_OK ) {
+	  error_code[THERM_CHANNEL_ONE] = error_code[THERM_CHANNEL_TWO];
+	  return;
+     }
+     float other = temp[THERM_CHANNEL_TWO];
+     if ( fabs(temp[THERM_CHANNEL_ONE] - other) <= TEMP_FUSION_SPREAD )
+	  temp[THERM_CHANNEL_ONE] = (temp[THERM_CHANNEL_ONE] + other) * 0.5;
+     else if ( other > temp[THERM_CHANNEL_ONE] )
+	  temp[THERM_CHANNEL_ONE] = other;
+}
+
+#endif
+
+#ifdef ADC_SEQUENCER
+
+/*
+ * Take the sequencer's newest average of each channel, and once every
+ * channel has a new one convert them all in the one pass.  This function
+ * is called by the motherboard slice at regular intervals.
+ */
+uint8_t ThermocoupleReader::update() {
+     for (uint8_t i = 0; i < TEMP_NSENSORS; i++) {
+	  int16_t value;
+	  if ( getAnalogChannel(seq[i], &value) ) {
+	       raws[i] = value;
+	       fresh |= 1 << i;
+	  }
+     }
+     if ( fresh != (1 << TEMP_NSENSORS) - 1 )
+	  return THERM_NOT_READY;
+     fresh = 0;
+
+     for (uint8_t i = 0; i < TEMP_NSENSORS; i++)
+	  convert(i, raws[i] * TEMP_OVERSAMPLE);
+#ifdef TEMP_DUAL_FUSION
+     fuse();
+#endif
+
+     last = THERM_CHANNEL_ALL;
+     return THERM_READY;
+}
+
+#else
+
 /*
  * Get a new read from the ADC.
  * This function is called by the motherboard slice at regular intervals
@@ -168,7 +282,7 @@ uint8_t ThermocoupleReader::update() {
      // Process prior ADC sample
      if ( !valid ) {
 	  // ADC not completed yet
-	  error_code = TemperatureSensor::SS_ADC_BUSY;
+	  error_code[pindex] = TemperatureSensor::SS_ADC_BUSY;
 	  if ( ++attempts < 10 ) return THERM_ADC_BUSY;
 
 	  // Stubborn channel; move on to the next one
@@ -186,41 +300,7 @@ uint8_t ThermocoupleReader::update() {
 
      if ( ++cnt >= TEMP_OVERSAMPLE ) {
 
-	  // Sensor type: thermocouple (1) or thermistor (0)
-
-	  if ( sensor_types & (1 << pindex) ) {
-
-	       // Thermocouple ADC
-	       // We can handle this faster than using a table
-	       if ( !(ADC_THERMOCOUPLE_DISCONNECTED(accum)) ) {
-			   temp[pindex] = (float)((int32_t)accum * 1000L)/(float)(1024 * TEMP_OVERSAMPLE);
-			   error_code = (temp[pindex] < MAX_TEMP) ?
-				   TemperatureSensor::SS_OK : TemperatureSensor::SS_BAD_READ;
-	       }
-	       else {
-			   // Value appears suspect; signal an error indicating that the
-			   // sensor is disconnected
-			   temp[pindex] = MAX_TEMP;
-			   error_code = TemperatureSensor::SS_ERROR_UNPLUGGED;
-	       }
-	  }
-	  else {
-
-	       // Thermistor ADC
-	       if ( !(ADC_THERMISTOR_DISCONNECTED(accum)) ) {
-			   temp[pindex] = TemperatureTable::TempReadtoCelsius(
-				   accum, table_indices[pindex],
-				   MAX_TEMP);
-			   error_code = (temp[pindex] < MAX_TEMP) ?
-				   TemperatureSensor::SS_OK : TemperatureSensor::SS_BAD_READ;
-	       }
-	       else {
-			   // Value appears suspect; signal an error indicating that the
-			   // sensor is disconnected
-			   error_code = TemperatureSensor::SS_ERROR_UNPLUGGED;
-			   temp[pindex] = MAX_TEMP;
-	       }
-	  }
+	  convert(pindex, accum);
 
 	  // Okay to process this temp sensor in the higher level code
 	  retval = THERM_READY;    
@@ -240,3 +320,5 @@ retry:
 
      return retval;
 }
+
+#endif
@@ -29,13 +29,25 @@
 #define THERM_CHANNEL_ONE	0
 #define THERM_CHANNEL_TWO	1
 #define THERM_CHANNEL_HBP	2
+// From getLastUpdated() once every channel has been read in one pass of
+// the ADC sequencer
+#define THERM_CHANNEL_ALL	3
+
+#if defined(TEMP_DUAL_FUSION) && !defined(ADC_SEQUENCER)
+#error "TEMP_DUAL_FUSION needs ADC_SEQUENCER"
+#endif
+
+// Two readings of tool 0 further apart than this, in C, don't agree
+#ifndef TEMP_FUSION_SPREAD
+#define TEMP_FUSION_SPREAD	15
+#endif
 
 class ThermocoupleReader {
 
 public:
 
 private:
-     TemperatureSensor::SensorState error_code;
+     TemperatureSensor::SensorState error_code[TEMP_NSENSORS];
 
      volatile bool    finished;
      volatile int16_t raw;
@@ -43,7 +55,16 @@ private:
      uint8_t          cnt, last, pindex, pin[TEMP_NSENSORS], sensor_types;
 	 uint8_t          table_indices[TEMP_NSENSORS];
      float            temp[TEMP_NSENSORS];
+#ifdef ADC_SEQUENCER
+     uint8_t          seq[TEMP_NSENSORS];	///< Sequencer channels
+     uint8_t          fresh;			///< A bit for each channel with a new average in raws
+     int16_t          raws[TEMP_NSENSORS];
+#endif
      void reset();
+     void convert(uint8_t channel, int16_t sum);
+#ifdef TEMP_DUAL_FUSION
+     void fuse();
+#endif
 
 public:
      ThermocoupleReader();
@@ -19,6 +19,7 @@
 
 #include "Compat.hh"
 #include "RGB_LED.hh"
+#include "RGB_Effects.hh"
 #include "TWI.hh"
 #include <util/delay.h>
 #include "Configuration.hh"
@@ -55,7 +56,7 @@ static void toggleLEDNoPWM(bool enable, uint8_t LEDs)
 	  // clear past select data and turn LEDs full off
 	  data[1] = (LEDSelect & ~LEDs) | (LED_OFF & LEDs);
 
-     TWI_write_data(LEDAddress, data, 2); //uint8_t error
+     TWI_queue_write(LEDAddress, data, 2);
 
      LEDSelect = data[1];
 }
@@ -86,10 +87,8 @@ static void setBrightness(uint8_t Channel, uint8_t level, uint8_t LEDs) {
 	  return;
      }
 
-     TWI_write_data(LEDAddress, data1, 2); //uint8_t error
-     _delay_us(1);
-     TWI_write_data(LEDAddress, data2, 2); //uint8_t error
-     _delay_us(1);
+     TWI_queue_write(LEDAddress, data1, 2);
+     TWI_queue_write(LEDAddress, data2, 2);
 
      LEDSelect = data1[1];
 
@@ -122,16 +121,16 @@ static void setBlinkRate(uint8_t Channel, uint8_t LEDs, uint8_t rate)
      else
 	  return;
 
-     TWI_write_data(LEDAddress, data1, 2); //uint8_t error
-     _delay_us(1);
-     TWI_write_data(LEDAddress, data2, 2); //uint8_t error
-     _delay_us(1);
+     TWI_queue_write(LEDAddress, data1, 2);
+     TWI_queue_write(LEDAddress, data2, 2);
 
      LEDSelect = data1[1];
 }
 
 void clear() {
 
+     RGB_Effects::colorSet(0, 0, 0);
+
      // clear LEDs
      setBrightness(3, 0, LED_RED | LED_GREEN | LED_BLUE);
 }
@@ -219,6 +218,8 @@ void setColor(uint8_t red, uint8_t green, uint8_t blue, bool clearOld) {
      if ( !LEDEnabled )
 	  return;
 
+     RGB_Effects::colorSet(red, green, blue);
+
      if ( clearOld )
 	  clear();
 
@@ -305,6 +306,73 @@ void setColor(uint8_t red, uint8_t green, uint8_t blue, bool clearOld) {
      }
 }
 
+// Two duty cycles for three colours: the colours lit at either end of the
+// effect are given channels as setColor() would, and each step only
+// changes the channels' duty cycles
+static uint8_t effectLeds[2];
+
+void prepareEffect(const uint8_t *from, const uint8_t *to) {
+     static const uint8_t bits[3] = { LED_RED, LED_GREEN, LED_BLUE };
+     uint8_t peak[3], lit[3], count = 0;
+
+     for (uint8_t c = 0; c < 3; c++) {
+	  peak[c] = from[c] > to[c] ? from[c] : to[c];
+	  if ( peak[c] )
+	       lit[count++] = c;
+     }
+
+     uint8_t leds0 = 0, leds1 = 0;
+     effectLeds[0] = effectLeds[1] = 0;
+     if ( count == 3 ) {
+	  // The two nearest share channel 2, the other has channel 1
+	  uint8_t alone = 1;
+	  int16_t dRG = abs((int16_t)peak[0] - peak[1]);
+	  int16_t dRB = abs((int16_t)peak[0] - peak[2]);
+	  int16_t dGB = abs((int16_t)peak[1] - peak[2]);
+	  if ( dGB < dRG && dGB < dRB )
+	       alone = 0;
+	  else if ( dRG < dRB )
+	       alone = 2;
+	  effectLeds[0] = alone;
+	  effectLeds[1] = alone ? 0 : 1;
+	  leds0 = bits[alone];
+	  leds1 = (LED_RED | LED_GREEN | LED_BLUE) & ~bits[alone];
+     }
+     else {
+	  if ( count > 0 ) {
+	       effectLeds[0] = lit[0];
+	       leds0 = bits[lit[0]];
+	  }
+	  if ( count > 1 ) {
+	       effectLeds[1] = lit[1];
+	       leds1 = bits[lit[1]];
+	  }
+     }
+
+     // No blinking, and the LEDs not lit off
+     uint8_t data[2] = {LED_REG_PSC0, 0};
+     TWI_queue_write(LEDAddress, data, 2);
+     data[0] = LED_REG_PSC1;
+     TWI_queue_write(LEDAddress, data, 2);
+     data[0] = LED_REG_SELECT;
+     data[1] = (LED_BLINK_PWM0 & leds0) | (LED_BLINK_PWM1 & leds1);
+     TWI_queue_write(LEDAddress, data, 2);
+     LEDSelect = data[1];
+}
+
+bool pushColor(uint8_t red, uint8_t green, uint8_t blue) {
+     if ( !TWI_queue_room(2, 4) )
+	  return false;
+
+     uint8_t color[3] = { red, green, blue };
+     uint8_t data[2] = {LED_REG_PWM0, color[effectLeds[0]]};
+     TWI_queue_write(LEDAddress, data, 2);
+     data[0] = LED_REG_PWM1;
+     data[1] = color[effectLeds[1]];
+     TWI_queue_write(LEDAddress, data, 2);
+     return true;
+}
+
 }
 
 #endif
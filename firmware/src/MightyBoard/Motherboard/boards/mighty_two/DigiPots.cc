@@ -77,7 +77,6 @@
 
 static uint8_t potValues[STEPPER_COUNT];
 static uint8_t defaultPotValues[STEPPER_COUNT];
-static Pin potPins[STEPPER_COUNT];
 
 void DigiPots::init() {
      static bool initialized = false;
@@ -88,16 +87,8 @@ void DigiPots::init() {
      // Initialize I2C bit-banger
      SoftI2cManager::getI2cManager().init();
 
-     potPins[X_AXIS] = X_POT_PIN;
-     potPins[Y_AXIS] = Y_POT_PIN;
-     potPins[Z_AXIS] = Z_POT_PIN;
-     potPins[A_AXIS] = A_POT_PIN;
-#if EXTRUDERS > 1
-     potPins[B_AXIS] = B_POT_PIN;
-#endif
-
      cli();
-     eeprom_read_block(defaultPotValues,
+     eeprom::readBlock(defaultPotValues,
 		       (void *)eeprom_offsets::DIGI_POT_SETTINGS,
 		       sizeof(uint8_t) * STEPPER_COUNT);
      sei();
@@ -115,31 +106,40 @@ void DigiPots::resetPot(uint8_t axis) {
      setPotValue(axis, defaultPotValues[axis]);
 }
 
-void DigiPots::setPotValue(uint8_t axis, const uint8_t val) {
-     // Higher level code validates axis
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
-     SoftI2cManager i2cPots = SoftI2cManager::getI2cManager();
-#pragma GCC diagnostic pop
-
-     potValues[axis] = val > DIGI_POT_MAX_XYAB ? DIGI_POT_MAX_XYAB : val;
+// Write potValues[] to the pots of the axes in mask, in one transaction
+// for all of them
+static void writePots(uint8_t mask) {
+     SoftI2cManager &i2cPots = SoftI2cManager::getI2cManager();
 
 #if defined(DIGI_POT_WRITE_VERIFICATION)
-     uint8_t i = 0, actualDigiPotValue;
-     do {
+     uint8_t actualDigiPotValues[STEPPER_COUNT];
+     for (uint8_t i = 0; mask && i < DIGI_POT_WRITE_VERIFICATION_RETRIES; i++) {
 #endif
-	  i2cPots.start(0b01011110 | I2C_WRITE, potPins[axis]);
-	  i2cPots.write(potValues[axis], potPins[axis]);
-	  i2cPots.stop();
+	  i2cPots.writeAll(0b01011110 | I2C_WRITE, potValues, mask);
 
 #if defined(DIGI_POT_WRITE_VERIFICATION)
-	  i2cPots.start(0b01011111 | I2C_WRITE, potPins[axis]);
-	  actualDigiPotValue = i2cPots.read(true, potPins[axis]);
-	  i2cPots.stop();
-	  i++;
+	  // Only those which didn't take are written again
+	  i2cPots.readAll(0b01011111 | I2C_WRITE, actualDigiPotValues, mask);
+	  for (uint8_t axis = 0; axis < STEPPER_COUNT; axis++)
+	       if ( actualDigiPotValues[axis] == potValues[axis] )
+		    mask &= ~(1 << axis);
      }
-     while (( i < DIGI_POT_WRITE_VERIFICATION_RETRIES ) &&
-	    ( actualDigiPotValue != potValues[axis] ));
 #endif
 }
 
+void DigiPots::setPotValue(uint8_t axis, const uint8_t val) {
+     // Higher level code validates axis
+     potValues[axis] = val > DIGI_POT_MAX_XYAB ? DIGI_POT_MAX_XYAB : val;
+     writePots(1 << axis);
+}
+
+void DigiPots::setPotValues(const uint8_t *vals, uint8_t mask) {
+     for (uint8_t axis = 0; axis < STEPPER_COUNT; axis++)
+	  if ( mask & (1 << axis) )
+	       potValues[axis] = vals[axis] > DIGI_POT_MAX_XYAB ? DIGI_POT_MAX_XYAB : vals[axis];
+     writePots(mask);
+}
+
+void DigiPots::resetPots(uint8_t mask) {
+     setPotValues(defaultPotValues, mask);
+}
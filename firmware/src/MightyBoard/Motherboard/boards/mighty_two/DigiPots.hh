@@ -26,6 +26,12 @@ namespace DigiPots {
      /// set i2c pot to specified value (0-127 valid)
      void setPotValue(uint8_t axis, const uint8_t val);
 
+     /// set the pot of each axis i in mask to vals[i], all in one go
+     void setPotValues(const uint8_t *vals, uint8_t mask);
+
+     /// set the pots of the axes in mask to their default values
+     void resetPots(uint8_t mask);
+
      /// returns the last pot value set
      uint8_t getPotValue(uint8_t axis);
 };
@@ -19,6 +19,7 @@
 
 #include "Compat.hh"
 #include "RGB_LED.hh"
+#include "RGB_Effects.hh"
 #include "TWI.hh"
 #include <util/delay.h>
 #include "Configuration.hh"
@@ -127,48 +128,34 @@ static void setLEDBlink(uint8_t rate) {
      if ( rate > 0 ) {
 	  // turn group blink on
 	  uint8_t data[2] = {LED_REG_MODE2, LED_OUT_INVERTED | LED_OUT_DRIVE | LED_GROUP_BLINK};
-	  TWI_write_data(LEDAddress, data, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data, 2);
 
 	  uint8_t data2[2] = {LED_REG_LEDOUT, LED_GROUP & ( LED_RED | LED_GREEN | LED_BLUE)};
-	  TWI_write_data(LEDAddress, data2, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data2, 2);
 
 	  // set group blink rate
 	  uint8_t data1[2] = {LED_REG_GRPPWM, 128};
-	  TWI_write_data(LEDAddress, data1, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data1, 2);
 
 	  //set dimming frequency to zero
 	  uint8_t data3[2] = {LED_REG_GRPFREQ, rate};
-	  TWI_write_data(LEDAddress, data3, 2);
+	  TWI_queue_write(LEDAddress, data3, 2);
      }
      else {
 	  // turn group blink off
 	  uint8_t data[2] = {LED_REG_MODE2, LED_OUT_INVERTED | LED_OUT_DRIVE };
-	  TWI_write_data(LEDAddress, data, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data, 2);
 
 	  uint8_t data2[2] = {LED_REG_LEDOUT, LED_INDIVIDUAL & ( LED_RED | LED_GREEN | LED_BLUE)};
-	  TWI_write_data(LEDAddress, data2, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data2, 2);
 
 	  // set blink rate to zero
 	  uint8_t data1[2] = {LED_REG_GRPPWM, rate};
-	  TWI_write_data(LEDAddress, data1, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data1, 2);
 
 	  //set dimming frequency to zero
 	  uint8_t data3[2] = {LED_REG_GRPFREQ, rate};
-	  TWI_write_data(LEDAddress, data3, 2);
-
-	  _delay_us(50);
+	  TWI_queue_write(LEDAddress, data3, 2);
 
 	  setDefaultColor();
      }
@@ -182,24 +169,34 @@ void setCustomColor(uint8_t red, uint8_t green, uint8_t blue) {
 }
 
 
-void setColor(uint8_t red, uint8_t green, uint8_t blue) {
-	 if ( !LEDEnabled ) return;
-
-     // set red
+// The three duty cycles go out through the TWI queue
+static void writeColor(uint8_t red, uint8_t green, uint8_t blue) {
      uint8_t data[2] = {LED_REG_PWM_RED, red};
-     TWI_write_data(LEDAddress, data, 2);
-
-     _delay_us(50);
+     TWI_queue_write(LEDAddress, data, 2);
 
-     // set green
      uint8_t data1[2] = {LED_REG_PWM_GREEN, green};
-     TWI_write_data(LEDAddress, data1, 2);
-
-     _delay_us(50);
+     TWI_queue_write(LEDAddress, data1, 2);
 
-     // set blue
      uint8_t data2[2] = {LED_REG_PWM_BLUE, blue};
-     TWI_write_data(LEDAddress, data2, 2);
+     TWI_queue_write(LEDAddress, data2, 2);
+}
+
+void setColor(uint8_t red, uint8_t green, uint8_t blue) {
+	 if ( !LEDEnabled ) return;
+
+     RGB_Effects::colorSet(red, green, blue);
+     writeColor(red, green, blue);
+}
+
+// Each colour has its own duty cycle, so there's nothing to set up
+void prepareEffect(const uint8_t * /*from*/, const uint8_t * /*to*/) {
+}
+
+bool pushColor(uint8_t red, uint8_t green, uint8_t blue) {
+     if ( !TWI_queue_room(3, 6) )
+	  return false;
+     writeColor(red, green, blue);
+     return true;
 }
 }
 
@@ -74,48 +74,59 @@ void ThermocoupleReader::init() {
 }
 
 /*
- * Send initial config value to the ADS1118
+ * Shift a byte out to the ADS1118, least significant bit first as the
+ * config values are kept, while shifting its byte in most significant first
  *
  */
-void ThermocoupleReader::initConfig()
+uint8_t ThermocoupleReader::transferByte(uint8_t out)
 {
-     sck_pin.setValue(false);
-
-     config_state = THERM_CHANNEL_ONE;
-     read_state = THERM_CHANNEL_ONE;
-     temp_check_counter = TEMP_CHECK_COUNT;
-
-     uint16_t config = channel_one_config;
+     uint8_t in = 0;
 
-     uint16_t config_reg = 0;
+     for (uint8_t i = 0; i < 8; i++) {
 
-     // send the config register
-     for (int i = 0; i < 16; i++) {
-
-	  // shift out config register data
-	  do_pin.setValue((config & 0b01) != 0);
-	  config >>= 1;
+	  do_pin.setValue((out & 0b01) != 0);
+	  out >>= 1;
 
 	  sck_pin.setValue(true);
-	  // we don't care about the slave data here
+	  in = in << 1;
+	  if ( di_pin.getValue() ) { in = in | 0x01; }
+
 	  sck_pin.setValue(false);
      }
+     return in;
+}
 
-     // read back the config reg
-     for (int i = 0; i < 16; i++) {
+/*
+ * End a read, whether finished or held up too long.  Raising chip select
+ * resets the ADS1118's serial interface, and it keeps the conversion
+ *
+ */
+void ThermocoupleReader::resetInterface()
+{
+     cs_pin.setValue(true);
+     sck_pin.setValue(false);
+     cs_pin.setValue(false);
+     spi_bytes = 0;
+}
 
-	  // shift out dummy data
-	  do_pin.setValue(false);
+/*
+ * Send initial config value to the ADS1118
+ *
+ */
+void ThermocoupleReader::initConfig()
+{
+     sck_pin.setValue(false);
 
-	  sck_pin.setValue(true);
-	  config_reg = config_reg << 1;
-	  if ( di_pin.getValue() ) { config_reg = config_reg | 0x01; }
+     config_state = THERM_CHANNEL_ONE;
+     read_state = THERM_CHANNEL_ONE;
+     temp_check_counter = TEMP_CHECK_COUNT;
+     spi_bytes = 0;
 
-	  sck_pin.setValue(false);
-     }
+     // send the config register; we don't care about the slave data here
+     transferByte(channel_one_config & 0xff);
+     transferByte(channel_one_config >> 8);
 
-     /// we could check here to make sure the config data has been read correctly
-     sck_pin.setValue(false);
+     resetInterface();
 }
 
 
@@ -149,67 +160,53 @@ static float ColdReadToCelsius(int16_t adc)
  */
 uint8_t ThermocoupleReader::update() {
 
-     sck_pin.setValue(false);
-
-     // check that data ready flag is low
-     // if it is high, return false so the calling function knows to try again
-     if ( di_pin.getValue() )
-	  return THERM_ADC_BUSY;
+     if ( spi_bytes == 0 ) {
+	  sck_pin.setValue(false);
 
-     uint16_t config = 0;
+	  // check that data ready flag is low
+	  // if it is high, return false so the calling function knows to try again
+	  if ( di_pin.getValue() )
+	       return THERM_ADC_BUSY;
 
-     // the config register determines the output for the next read
-     switch ( config_state ) {
-     case THERM_CHANNEL_ONE :
-	  config = channel_one_config;
-	  break;
-     case THERM_CHANNEL_TWO :
-	  config = channel_two_config;
-	  break;
-     case THERM_COLD_JUNCTION :
-	  config = cold_temp_config;
-	  break;
-     default :
-	  break;
+	  // the config register determines the output for the next read
+	  switch ( config_state ) {
+	  case THERM_CHANNEL_ONE :
+	       spi_config = channel_one_config;
+	       break;
+	  case THERM_CHANNEL_TWO :
+	       spi_config = channel_two_config;
+	       break;
+	  case THERM_COLD_JUNCTION :
+	       spi_config = cold_temp_config;
+	       break;
+	  default :
+	       spi_config = 0;
+	       break;
+	  }
+	  spi_raw = 0;
+     }
+     else if ( spi_gap.hasElapsed() ) {
+	  resetInterface();
+	  return THERM_ADC_BUSY;
      }
-
-     uint16_t config_reg = 0;
-     uint16_t raw = 0;
 
      /// the ADS1118 uses bidirection SPI communication
-     /// the sensor returns 4 bytes of data per read.  the first two bytes are the
-     /// ADC bits.  the second two bytes are the config register bits
-     /// the mightyboard (master) sends the desired configuration register in the first
-     /// two bytes and sends dummy data for the second two bytes
+     /// the sensor returns the two bytes of the ADC bits while the mightyboard
+     /// (master) sends the configuration register for the next conversion
 
-     // read the temperature register
-     for (int i = 0; i < 16; i++) {
+     // one byte per call; THERM_ADC_BUSY brings the caller back for the next
+     spi_raw = (spi_raw << 8) | transferByte(spi_config & 0xff);
+     spi_config >>= 8;
 
-	  // shift out config register data
-	  do_pin.setValue((config & 0b01) != 0);
-	  config >>= 1;
-
-	  sck_pin.setValue(true);
-	  raw = raw << 1;
-	  if ( di_pin.getValue() ) {raw = raw | 0x01; }
-
-	  sck_pin.setValue(false);
+     if ( ++spi_bytes < THERM_SPI_BYTES ) {
+	  spi_gap.start(THERM_SPI_GAP_MICROS);
+	  return THERM_ADC_BUSY;
      }
 
-     // read back the config reg
-     for (int i = 0; i < 16; i++) {
-
-	  // shift out dummy data
-	  do_pin.setValue(false);
-
-	  sck_pin.setValue(true);
-	  config_reg = config_reg << 1;
-	  if ( di_pin.getValue() ) { config_reg = config_reg | 0x01; }
-
-	  sck_pin.setValue(false);
-     }
+     // end the 16 bit cycle; the conversion carries on with the new config
+     resetInterface();
 
-     sck_pin.setValue(false);
+     uint16_t raw = spi_raw;
 
      float temp;
      /// store read to the temperature variable
@@ -245,6 +242,7 @@ uint8_t ThermocoupleReader::update() {
 
      /// track last update temperature, so that this value can be queried.
      last_temp_updated = read_state;
+     uint8_t ret = ( read_state == THERM_COLD_JUNCTION ) ? THERM_ADC_BUSY : THERM_READY;
      /// the temperature read next cycle is determined by the config bytes we just sent
      read_state = config_state;
 
@@ -277,6 +275,8 @@ uint8_t ThermocoupleReader::update() {
 	  break;
      }
 
-     // return true when temperature update is successful
-     return THERM_READY;
+     // return true when temperature update is successful.  A cold junction
+     // read has nothing for the heaters, so the caller is sent straight back
+     // for channel one's conversion rather than waiting out its interval.
+     return ret;
 }
@@ -24,6 +24,7 @@
 
 #include "Pin.hh"
 #include "TemperatureSensor.hh"
+#include "Timeout.hh"
 
 #define THERM_READY		0
 #define THERM_NOT_READY		1
@@ -58,7 +59,9 @@
 #define	SAMPLE_FREQ_32   0x0040
 #define SAMPLE_FREQ_16   0x0020
 
-/// single sample vs continous conversion
+/// single sample vs continous conversion.  The reader leaves it clear: the
+/// ADS1118 converts continuously, and each read's config bits pick the
+/// channel of the conversion after it, so there's nothing to start or wait on
 #define SINGLE_MODE		0x0100
 
 /// ADC mode (thermocouples) vs temperature sensor (on-board cold_junction temp sensor)
@@ -74,6 +77,15 @@
 /// because we don't expect it to change much
 #define TEMP_CHECK_COUNT 120
 
+/// A read is shifted a byte per call of update(), so that it doesn't hold
+/// up the main loop.  It's a 16 bit cycle, the conversion shifted in as the
+/// next config goes out, and chip select is raised after it to end the
+/// cycle rather than clocking the config back in.  The ADS1118 resets its
+/// serial interface if SCLK is held low for 28 ms, so when the gap between
+/// two bytes gets near that the read is started again.
+#define THERM_SPI_BYTES		2
+#define THERM_SPI_GAP_MICROS	(20L * 1000L)
+
 #define THERM_CHANNEL_ONE	0
 #define THERM_CHANNEL_TWO	1
 #define THERM_CHANNEL_HBP	2
@@ -81,6 +93,8 @@
 
 /// The thermocouple module provides a bitbanging driver that can read the
 /// temperature from the ADS1118 sensor, and also report on any error conditions.
+/// The sensor's pins aren't on the SPI or USART pins, so there's no hardware
+/// to shift the bits out.
 /// \ingroup SoftwareLibraries
 class ThermocoupleReader {
 
@@ -106,6 +120,14 @@ private:
 
      uint8_t last_temp_updated;
 
+     uint8_t spi_bytes;			///< Bytes of the present read shifted so far
+     uint16_t spi_config;		///< Config bits still to shift out
+     uint16_t spi_raw;			///< Conversion bits shifted in
+     Timeout spi_gap;			///< Runs from one byte to the next
+
+     uint8_t transferByte(uint8_t out);
+     void resetInterface();
+
 public:
      /// Create a new thermocouple instance, and attach it to the given pins.
      /// \param [in] do_p Data Out: MOSI (output).
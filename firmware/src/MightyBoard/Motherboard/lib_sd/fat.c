@@ -17,6 +17,9 @@
 #include "fat.h"
 #include "fat_config.h"
 #include "sd-reader_config.h"
+#if FAT_PEEK_SUPPORT
+#include "sd_raw.h"
+#endif
 
 #include <string.h>
 
@@ -206,8 +209,26 @@ static struct fat_file_struct fat_file_handles[FAT_FILE_COUNT];
 static struct fat_dir_struct fat_dir_handles[FAT_DIR_COUNT];
 #endif
 
+#if FAT_CLUSTER_CACHE_RUNS
+/* runs of consecutive clusters of one file's cluster chain */
+struct fat_cluster_cache_struct
+{
+    const struct fat_file_struct* fd;
+    uint8_t run_count;
+    /* set when the last run ends the chain */
+    uint8_t complete;
+    cluster_t run_first[FAT_CLUSTER_CACHE_RUNS];
+    cluster_t run_length[FAT_CLUSTER_CACHE_RUNS];
+};
+
+static struct fat_cluster_cache_struct fat_cluster_cache;
+
+static void fat_fill_cluster_cache(const struct fat_file_struct* fd, cluster_t cluster_num);
+#endif
+
 static uint8_t fat_read_header(struct fat_fs_struct* fs);
 static cluster_t fat_get_next_cluster(const struct fat_fs_struct* fs, cluster_t cluster_num);
+static cluster_t fat_get_next_file_cluster(const struct fat_file_struct* fd, cluster_t cluster_num);
 static offset_t fat_cluster_offset(const struct fat_fs_struct* fs, cluster_t cluster_num);
 static uint8_t fat_dir_entry_read_callback(uint8_t* buffer, offset_t offset, void* p);
 #if FAT_LFN_SUPPORT
@@ -980,6 +1001,138 @@ uint8_t fat_get_dir_entry_of_path(struct fat_fs_struct* fs, const char* path, st
     return 0;
 }
 
+#if FAT_CLUSTER_CACHE_RUNS
+/**
+ * \ingroup fat_file
+ * Caches the cluster chain of a file, from cluster_num on.
+ *
+ * Stops when the chain ends or the cache is full.  Any cache for another
+ * file is dropped.
+ */
+void fat_fill_cluster_cache(const struct fat_file_struct* fd, cluster_t cluster_num)
+{
+    struct fat_cluster_cache_struct* cache = &fat_cluster_cache;
+    uint8_t run = 0;
+
+    cache->fd = fd;
+    cache->complete = 0;
+    cache->run_first[0] = cluster_num;
+    cache->run_length[0] = 1;
+
+    sd_errno = 0;
+    while((cluster_num = fat_get_next_cluster(fd->fs, cluster_num)))
+    {
+        if(cluster_num == cache->run_first[run] + cache->run_length[run])
+        {
+            ++cache->run_length[run];
+            continue;
+        }
+        if(++run >= FAT_CLUSTER_CACHE_RUNS)
+            break;
+        cache->run_first[run] = cluster_num;
+        cache->run_length[run] = 1;
+    }
+
+    /* the chain ended, rather than a read failed or the cache filled up */
+    if(!cluster_num && !sd_errno)
+        cache->complete = 1;
+    cache->run_count = (run < FAT_CLUSTER_CACHE_RUNS) ? run + 1 : FAT_CLUSTER_CACHE_RUNS;
+}
+
+/**
+ * \ingroup fat_file
+ * Caches the cluster chain of an open file.
+ *
+ * Reading through the file then takes the clusters from the cache rather
+ * than from the FAT as long as the chain is made of no more than
+ * FAT_CLUSTER_CACHE_RUNS runs of consecutive clusters, and otherwise
+ * caches the next part of the chain once the cached part is used up.
+ * Only one file is cached at a time; writing to or resizing the file
+ * drops its cache.
+ *
+ * \param[in] fd The file handle of the file to cache.
+ * \returns 0 on failure, 1 on success.
+ */
+uint8_t fat_cache_file_clusters(struct fat_file_struct* fd)
+{
+    if(!fd || !fd->dir_entry.cluster)
+        return 0;
+
+    fat_fill_cluster_cache(fd, fd->dir_entry.cluster);
+    return 1;
+}
+#endif
+
+#if DOXYGEN || FAT_FILE_COUNT > 1
+/**
+ * \ingroup fat_file
+ * Brings a file handle up to date with another handle of the same file
+ * which is being written to, so that what has been written since the
+ * file was opened can be read.
+ *
+ * Only the first cluster and the size are taken; the reader finds the
+ * clusters added since in the FAT.  Don't cache the reader's cluster
+ * chain with fat_cache_file_clusters() while the file grows.
+ *
+ * \param[in] fd The file handle of the file being read.
+ * \param[in] writer The file handle of the file being written.
+ * \returns 0 if the handles aren't of the same file, 1 otherwise.
+ */
+uint8_t fat_follow_file(struct fat_file_struct* fd, const struct fat_file_struct* writer)
+{
+    if(!fd || !writer || fd->dir_entry.entry_offset != writer->dir_entry.entry_offset)
+        return 0;
+
+    fd->dir_entry.cluster = writer->dir_entry.cluster;
+    fd->dir_entry.file_size = writer->dir_entry.file_size;
+    return 1;
+}
+#endif
+
+/**
+ * \ingroup fat_file
+ * Finds the cluster following cluster_num in a file's cluster chain.
+ *
+ * Uses the cluster chain cache when it holds the file, and the FAT
+ * otherwise.
+ *
+ * \returns The wanted cluster number, or 0 at the end of the chain or on error.
+ */
+cluster_t fat_get_next_file_cluster(const struct fat_file_struct* fd, cluster_t cluster_num)
+{
+#if FAT_CLUSTER_CACHE_RUNS
+    struct fat_cluster_cache_struct* cache = &fat_cluster_cache;
+    if(cache->fd == fd)
+    {
+        for(uint8_t run = 0; run < cache->run_count; ++run)
+        {
+            cluster_t index = (cluster_t) (cluster_num - cache->run_first[run]);
+            if(index >= cache->run_length[run])
+                continue;
+
+            if(index + 1 < cache->run_length[run])
+                return cluster_num + 1;
+            if(run + 1 < cache->run_count)
+                return cache->run_first[run + 1];
+            if(cache->complete)
+            {
+                /* as fat_get_next_cluster() does at the end of the chain */
+                fat_errno = FAT_ERR_BAD;
+                return 0;
+            }
+
+            /* past the cached part of the chain, so cache the next part */
+            cluster_num = fat_get_next_cluster(fd->fs, cluster_num);
+            if(cluster_num)
+                fat_fill_cluster_cache(fd, cluster_num);
+            return cluster_num;
+        }
+    }
+#endif
+
+    return fat_get_next_cluster(fd->fs, cluster_num);
+}
+
 /**
  * \ingroup fat_file
  * Opens a file on a FAT filesystem.
@@ -1041,6 +1194,11 @@ void fat_close_file(struct fat_file_struct* fd)
             fat_write_dir_entry(fd->fs, &fd->dir_entry);
 #endif
 
+#if FAT_CLUSTER_CACHE_RUNS
+        if(fat_cluster_cache.fd == fd)
+            fat_cluster_cache.fd = 0;
+#endif
+
 #if USE_DYNAMIC_MEMORY
         free(fd);
 #else
@@ -1105,7 +1263,7 @@ intptr_t fat_read_file(struct fat_file_struct* fd, uint8_t* buffer, uintptr_t bu
             while(pos >= cluster_size)
             {
                 pos -= cluster_size;
-                cluster_num = fat_get_next_cluster(fd->fs, cluster_num);
+                cluster_num = fat_get_next_file_cluster(fd, cluster_num);
                 if(!cluster_num)
                     // fd_errno handled by fat_get_next_cluster()
                     return -1;
@@ -1144,7 +1302,7 @@ intptr_t fat_read_file(struct fat_file_struct* fd, uint8_t* buffer, uintptr_t bu
         if(first_cluster_offset + copy_length >= cluster_size)
         {
             /* we are on a cluster boundary, so get the next cluster */
-            if((cluster_num = fat_get_next_cluster(fd->fs, cluster_num)))
+            if((cluster_num = fat_get_next_file_cluster(fd, cluster_num)))
             {
                 first_cluster_offset = 0;
             }
@@ -1162,6 +1320,93 @@ intptr_t fat_read_file(struct fat_file_struct* fd, uint8_t* buffer, uintptr_t bu
     return buffer_len;
 }
 
+#if DOXYGEN || FAT_PEEK_SUPPORT
+/**
+ * \ingroup fat_file
+ * Returns the data at the current file location without copying it.
+ *
+ * Loads the block holding the current file location into the sd_raw block
+ * cache and points \c data at the file location within it.  The file
+ * location is not changed; call fat_skip_file() to move past the data.
+ *
+ * \note The data is only valid until the next read or write of the card.
+ *
+ * \param[in] fd The file handle of the file from which to read.
+ * \param[out] data Set to the data at the current file location.
+ * \returns The number of bytes available up to the end of the block or of the file, 0 on end of file, or -1 on failure.
+ * \see fat_skip_file, fat_read_file
+ */
+intptr_t fat_peek_file(struct fat_file_struct* fd, const uint8_t** data)
+{
+    /* check arguments */
+    if(!fd || !data)
+    {
+        fat_errno = FAT_ERR_EINVAL;
+        return -1;
+    }
+    fat_errno = 0;
+    sd_errno = 0;
+
+    if(fd->pos >= fd->dir_entry.file_size)
+        return 0;
+
+    uint16_t cluster_size = fd->fs->header.cluster_size;
+    cluster_t cluster_num = fd->pos_cluster;
+
+    /* find the cluster holding the file location */
+    if(!cluster_num)
+    {
+        cluster_num = fd->dir_entry.cluster;
+        for(offset_t pos = fd->pos; cluster_num && pos >= cluster_size; pos -= cluster_size)
+            cluster_num = fat_get_next_file_cluster(fd, cluster_num);
+        if(!cluster_num)
+        {
+            if(!fat_errno)
+                fat_errno = FAT_ERR_BAD;
+            return -1;
+        }
+        fd->pos_cluster = cluster_num;
+    }
+
+    offset_t offset = fat_cluster_offset(fd->fs, cluster_num) + (uint16_t) (fd->pos & (cluster_size - 1));
+    uint16_t block_offset = (uint16_t) (offset & 0x01ff);
+    const uint8_t* block = sd_raw_read_block(offset - block_offset);
+    if(!block)
+    {
+        fat_errno = sd_errno ? sd_errno : FAT_ERR_BAD;
+        return -1;
+    }
+
+    uint16_t length = 512 - block_offset;
+    if(fd->pos + length > fd->dir_entry.file_size)
+        length = (uint16_t) (fd->dir_entry.file_size - fd->pos);
+
+    *data = block + block_offset;
+    return length;
+}
+
+/**
+ * \ingroup fat_file
+ * Moves the file location past data returned by fat_peek_file().
+ *
+ * \param[in] fd The file handle of the file being read.
+ * \param[in] count The number of bytes to skip, at most the count last returned by fat_peek_file().
+ * \see fat_peek_file
+ */
+void fat_skip_file(struct fat_file_struct* fd, uintptr_t count)
+{
+    if(!fd || !count)
+        return;
+
+    fd->pos += count;
+
+    /* on a cluster boundary, move on to the next cluster; at the end of
+     * the chain pos_cluster becomes 0 and fat_peek_file() will search */
+    if(!(fd->pos & (fd->fs->header.cluster_size - 1)) && fd->pos_cluster)
+        fd->pos_cluster = fat_get_next_file_cluster(fd, fd->pos_cluster);
+}
+#endif
+
 #if DOXYGEN || FAT_WRITE_SUPPORT
 /**
  * \ingroup fat_file
@@ -1184,6 +1429,12 @@ intptr_t fat_write_file(struct fat_file_struct* fd, const uint8_t* buffer, uintp
         return -1;
     }
 
+#if FAT_CLUSTER_CACHE_RUNS
+    /* the cluster chain may change */
+    if(fat_cluster_cache.fd == fd)
+        fat_cluster_cache.fd = 0;
+#endif
+
     uint16_t cluster_size = fd->fs->header.cluster_size;
     cluster_t cluster_num = fd->pos_cluster;
     uintptr_t buffer_left = buffer_len;
@@ -1408,6 +1659,12 @@ uint8_t fat_resize_file(struct fat_file_struct* fd, uint32_t size)
     if(!fd)
         return 0;
 
+#if FAT_CLUSTER_CACHE_RUNS
+    /* the cluster chain may change */
+    if(fat_cluster_cache.fd == fd)
+        fat_cluster_cache.fd = 0;
+#endif
+
     cluster_t cluster_num = fd->dir_entry.cluster;
     uint16_t cluster_size = fd->fs->header.cluster_size;
     uint32_t size_new = size;
@@ -1675,6 +1932,45 @@ uint8_t fat_reset_dir(struct fat_dir_struct* dd)
     return 1;
 }
 
+/**
+ * \ingroup fat_dir
+ * Gets the position of a directory handle.
+ *
+ * The next fat_read_dir() after a fat_seek_dir() to this position
+ * returns the entry which the next fat_read_dir() would return now.
+ *
+ * \param[in] dd The directory handle.
+ * \param[out] pos Buffer into which to write the position.
+ * \see fat_seek_dir
+ */
+void fat_tell_dir(const struct fat_dir_struct* dd, struct fat_dir_pos_struct* pos)
+{
+    pos->cluster = dd->entry_cluster;
+    pos->offset = dd->entry_offset;
+}
+
+/**
+ * \ingroup fat_dir
+ * Moves a directory handle to a position got from fat_tell_dir().
+ *
+ * The position must have been got from a handle of the same directory,
+ * and the directory must not have been changed since.
+ *
+ * \param[in] dd The directory handle.
+ * \param[in] pos The position to move to.
+ * \returns 0 on failure, 1 on success.
+ * \see fat_tell_dir
+ */
+uint8_t fat_seek_dir(struct fat_dir_struct* dd, const struct fat_dir_pos_struct* pos)
+{
+    if(!dd)
+        return 0;
+
+    dd->entry_cluster = pos->cluster;
+    dd->entry_offset = pos->offset;
+    return 1;
+}
+
 /**
  * \ingroup fat_fs
  * Callback function for reading a directory entry.
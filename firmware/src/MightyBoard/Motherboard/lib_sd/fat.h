@@ -80,6 +80,18 @@ struct fat_fs_struct;
 struct fat_file_struct;
 struct fat_dir_struct;
 
+/**
+ * \ingroup fat_dir
+ * A position within a directory listing, for returning to later.
+ */
+struct fat_dir_pos_struct
+{
+    /** The cluster of the next entry to read. */
+    cluster_t cluster;
+    /** The offset of the next entry within that cluster. */
+    uint16_t offset;
+};
+
 /**
  * \ingroup fat_file
  * Describes a directory entry.
@@ -110,6 +122,16 @@ void fat_close(struct fat_fs_struct* fs);
 struct fat_file_struct* fat_open_file(struct fat_fs_struct* fs, const struct fat_dir_entry_struct* dir_entry);
 void fat_close_file(struct fat_file_struct* fd);
 intptr_t fat_read_file(struct fat_file_struct* fd, uint8_t* buffer, uintptr_t buffer_len);
+#if FAT_CLUSTER_CACHE_RUNS
+uint8_t fat_cache_file_clusters(struct fat_file_struct* fd);
+#endif
+#if FAT_FILE_COUNT > 1
+uint8_t fat_follow_file(struct fat_file_struct* fd, const struct fat_file_struct* writer);
+#endif
+#if FAT_PEEK_SUPPORT
+intptr_t fat_peek_file(struct fat_file_struct* fd, const uint8_t** data);
+void fat_skip_file(struct fat_file_struct* fd, uintptr_t count);
+#endif
 intptr_t fat_write_file(struct fat_file_struct* fd, const uint8_t* buffer, uintptr_t buffer_len);
 uint8_t fat_seek_file(struct fat_file_struct* fd, int32_t* offset, uint8_t whence);
 uint8_t fat_resize_file(struct fat_file_struct* fd, uint32_t size);
@@ -118,6 +140,8 @@ struct fat_dir_struct* fat_open_dir(struct fat_fs_struct* fs, const struct fat_d
 void fat_close_dir(struct fat_dir_struct* dd);
 uint8_t fat_read_dir(struct fat_dir_struct* dd, struct fat_dir_entry_struct* dir_entry);
 uint8_t fat_reset_dir(struct fat_dir_struct* dd);
+void fat_tell_dir(const struct fat_dir_struct* dd, struct fat_dir_pos_struct* pos);
+uint8_t fat_seek_dir(struct fat_dir_struct* dd, const struct fat_dir_pos_struct* pos);
 
 uint8_t fat_create_file(struct fat_dir_struct* parent, const char* file, struct fat_dir_entry_struct* dir_entry);
 uint8_t fat_delete_file(struct fat_fs_struct* fs, struct fat_dir_entry_struct* dir_entry);
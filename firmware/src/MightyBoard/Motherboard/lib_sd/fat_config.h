@@ -38,6 +38,14 @@ extern "C"
  */
 #define FAT_WRITE_SUPPORT SD_RAW_WRITE_SUPPORT
 
+/**
+ * \ingroup fat_config
+ * Controls support for reading files in place, from the sd_raw block cache.
+ *
+ * Needs the block cache, so it is only available when SD_RAW_SAVE_RAM is 0.
+ */
+#define FAT_PEEK_SUPPORT (!SD_RAW_SAVE_RAM)
+
 /**
  * \ingroup fat_config
  * Controls FAT long filename (LFN) support.
@@ -112,8 +120,18 @@ void get_datetime(uint16_t* year, uint8_t* month, uint8_t* day, uint8_t* hour, u
 /**
  * \ingroup fat_config
  * Maximum number of file handles.
+ *
+ * A second handle lets a file be played back while it is still being
+ * captured, and another lets the pre-scan read the file played back, each
+ * at the cost of another handle's RAM.
  */
+#if defined(SD_PLAY_WHILE_CAPTURE) && defined(SD_PRESCAN)
+#define FAT_FILE_COUNT 3
+#elif defined(SD_PLAY_WHILE_CAPTURE) || defined(SD_PRESCAN)
+#define FAT_FILE_COUNT 2
+#else
 #define FAT_FILE_COUNT 1
+#endif
 
 /**
  * \ingroup fat_config
@@ -121,6 +139,17 @@ void get_datetime(uint16_t* year, uint8_t* month, uint8_t* day, uint8_t* hour, u
  */
 #define FAT_DIR_COUNT 2
 
+/**
+ * \ingroup fat_config
+ * Number of runs of consecutive clusters held by the cluster chain cache.
+ *
+ * fat_cache_file_clusters() fills the cache for one open file, so that
+ * reading through it needn't look up the cluster chain in the FAT at every
+ * cluster boundary.  Each extra run costs two cluster numbers of RAM.
+ * Set to 0 to disable the cache.
+ */
+#define FAT_CLUSTER_CACHE_RUNS 8
+
 /**
  * @}
  */
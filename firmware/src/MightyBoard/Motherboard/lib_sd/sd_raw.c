@@ -14,6 +14,7 @@
 #include <util/delay.h>
 #include "Configuration.hh"
 #include "Pin.hh"
+#include "Xmem.hh"
 
 #if !SD_RAW_SAVE_RAM
 #include "sd_crc.h"
@@ -21,6 +22,9 @@ static bool sd_use_crc = false;
 #endif
 
 uint8_t sd_errno;
+#if !SD_RAW_SAVE_RAM
+uint16_t sd_raw_crc_retries;
+#endif
 
 /**
  * \addtogroup sd_raw MMC/SD/SDHC card raw access
@@ -156,7 +160,7 @@ uint8_t sd_errno;
 
 #if !SD_RAW_SAVE_RAM
 /* static data buffer for acceleration */
-static uint8_t raw_block[512];
+static uint8_t raw_block[512] XMEM_SD_DATA;
 /* offset where the data within raw_block lies on the card */
 static offset_t raw_block_address;
 #if SD_RAW_WRITE_BUFFERING
@@ -168,10 +172,22 @@ static uint8_t raw_block_written;
 /* card type state */
 static uint8_t sd_raw_card_type;
 
+#if SD_RAW_STREAM_SUPPORT
+/* card address of the next block of the multiple block read in progress, or -1 if there is none */
+static offset_t stream_address = (offset_t) -1;
+/* set with sd_raw_stream() */
+static uint8_t stream_enabled;
+#endif
+
 /* private helper functions */
 static void sd_raw_send_byte(uint8_t b);
 static uint8_t sd_raw_rec_byte();
+static void sd_raw_rec_block(uint8_t* buffer);
+static void sd_raw_send_frame(uint8_t command, uint32_t arg);
 static uint8_t sd_raw_send_command(uint8_t command, uint32_t arg);
+#if SD_RAW_STREAM_SUPPORT
+static void sd_raw_stream_stop();
+#endif
 
 /**
  * \ingroup sd_raw
@@ -201,8 +217,14 @@ static void spi_init(uint8_t spi_rate)
      SPSR = (spi_rate & 1) || (spi_rate == 6) ? 0 : (1 << SPI2X);
 }
 
+// Every command other than the next block of a multiple block read
+// starts here, so this is where a read in progress is ended
 static void SELECT_CARD(void)
 {
+#if SD_RAW_STREAM_SUPPORT
+     if(stream_address != (offset_t) -1)
+          sd_raw_stream_stop();
+#endif
      spi_init(spi_rate);
      select_card();
 }
@@ -220,6 +242,11 @@ uint8_t sd_raw_init(bool use_crc, uint8_t speed)
 
     sd_errno = 0;
 
+#if SD_RAW_STREAM_SUPPORT
+    /* the card is being reset, which abandons any read in progress */
+    stream_address = (offset_t) -1;
+#endif
+
     /* enable inputs for reading card status */
     configure_pin_available();
     configure_pin_locked();
@@ -395,8 +422,13 @@ uint8_t sd_raw_init(bool use_crc, uint8_t speed)
     // But owing to the lousy SD card bus, that doesn't work well
     // Then with the introduction of the revH MightyBoard, they dropped
     // down to f_OSC / 16.
-    spi_rate = 3;
-    spi_init(3);
+    spi_rate = SD_RAW_SPI_RATE;
+#if !SD_RAW_SAVE_RAM
+    // With CRCs checked, a bad read at a faster clock is caught and retried
+    if ( sd_use_crc && SD_RAW_CRC_SPI_RATE < SD_RAW_SPI_RATE )
+        spi_rate = SD_RAW_CRC_SPI_RATE;
+#endif
+    spi_init(spi_rate);
 #endif
 
 #if !SD_RAW_SAVE_RAM
@@ -406,7 +438,19 @@ uint8_t sd_raw_init(bool use_crc, uint8_t speed)
     raw_block_written = 1;
 #endif
     if(!sd_raw_read(0, raw_block, sizeof(raw_block)))
-        return 0;
+    {
+#if !SD_POOR_DESIGN
+        if(spi_rate >= SD_RAW_SPI_RATE)
+            return 0;
+
+        /* the faster clock doesn't work with this card, so fall back */
+        spi_rate = SD_RAW_SPI_RATE;
+        spi_init(spi_rate);
+        sd_errno = 0;
+        if(!sd_raw_read(0, raw_block, sizeof(raw_block)))
+#endif
+            return 0;
+    }
 #endif
 
     // sd_errno set by sd_raw_read
@@ -490,15 +534,13 @@ uint8_t sd_raw_rec_byte()
 
 /**
  * \ingroup sd_raw
- * Send a command to the memory card which responses with a R1 response (and possibly others).
+ * Sends a command to the memory card, without waiting for its response.
  *
  * \param[in] command The command to send.
  * \param[in] arg The argument for command.
- * \returns The command answer.
  */
-uint8_t sd_raw_send_command(uint8_t command, uint32_t arg)
+void sd_raw_send_frame(uint8_t command, uint32_t arg)
 {
-    uint8_t response;
     uint8_t *args = reinterpret_cast<uint8_t *>(&arg);
 
     /* wait some clock cycles: make sure the SPI bus is clear */
@@ -533,6 +575,47 @@ uint8_t sd_raw_send_command(uint8_t command, uint32_t arg)
 #if !SD_RAW_SAVE_RAM
     }
 #endif
+}
+
+/**
+ * \ingroup sd_raw
+ * Receives a 512 byte data block from the memory card.
+ *
+ * Each transfer is started as soon as the previous byte has been read, so
+ * that storing the byte and looping overlap with the SPI shifting in the
+ * next one.
+ *
+ * \param[out] buffer The buffer into which to write the block.
+ */
+void sd_raw_rec_block(uint8_t* buffer)
+{
+    uint8_t* last = buffer + 511;
+
+    SPDR = 0xff;
+    while(buffer != last)
+    {
+        loop_until_bit_is_set(SPSR, SPIF);
+        uint8_t b = SPDR;
+        SPDR = 0xff;
+        *buffer++ = b;
+    }
+    loop_until_bit_is_set(SPSR, SPIF);
+    *buffer = SPDR;
+}
+
+/**
+ * \ingroup sd_raw
+ * Send a command to the memory card which responses with a R1 response (and possibly others).
+ *
+ * \param[in] command The command to send.
+ * \param[in] arg The argument for command.
+ * \returns The command answer.
+ */
+uint8_t sd_raw_send_command(uint8_t command, uint32_t arg)
+{
+    uint8_t response;
+
+    sd_raw_send_frame(command, arg);
 
     /* receive response */
     for(uint8_t i = 0; i < 10; ++i)
@@ -623,9 +706,7 @@ uint8_t sd_raw_read(offset_t offset, uint8_t* buffer, uintptr_t length)
             sd_raw_rec_byte();
 #else
             /* read byte block */
-            uint8_t* cache = raw_block;
-            for(uint16_t i = 0; i < 512; ++i)
-                *cache++ = sd_raw_rec_byte();
+            sd_raw_rec_block(raw_block);
             raw_block_address = block_address;
 
             /* read crc16 */
@@ -635,6 +716,7 @@ uint8_t sd_raw_read(offset_t offset, uint8_t* buffer, uintptr_t length)
                 if ( crc != sd_crc16(raw_block, (uint16_t)512) ) {
                     unselect_card();
                     if ( ++attempts < 5 ) {
+                        ++sd_raw_crc_retries;
                         sd_raw_rec_byte(); // pause a little
                         goto read_block;
                     }
@@ -675,6 +757,165 @@ uint8_t sd_raw_read(offset_t offset, uint8_t* buffer, uintptr_t length)
     return 1;
 }
 
+#if SD_RAW_STREAM_SUPPORT
+/**
+ * \ingroup sd_raw
+ * Ends the multiple block read in progress.
+ */
+void sd_raw_stream_stop()
+{
+    stream_address = (offset_t) -1;
+
+    spi_init(spi_rate);
+    select_card();
+
+    /* the R1b response follows a stuff byte, and is then busy until the card is ready */
+    sd_raw_send_frame(CMD_STOP_TRANSMISSION, 0);
+    sd_raw_rec_byte();
+    for(uint8_t i = 0; i < 10 && sd_raw_rec_byte() == 0xff; ++i)
+        ;
+    for(uint16_t i = 0; i < 0x7fff && sd_raw_rec_byte() != 0xff; ++i)
+        ;
+
+    unselect_card();
+    sd_raw_rec_byte();
+}
+
+/**
+ * \ingroup sd_raw
+ * Reads a block into the block cache as part of a multiple block read.
+ *
+ * The read carries on from the previous block if that was the one before
+ * \c block_address, and otherwise a new one is started.
+ *
+ * \returns 0 on failure, 1 on success.
+ */
+static uint8_t sd_raw_stream_block(offset_t block_address)
+{
+    uint8_t attempts = 0;
+
+#if SD_RAW_WRITE_BUFFERING
+    if(!sd_raw_sync())
+        return 0;
+#endif
+
+read_block:
+    if(block_address == stream_address)
+    {
+        spi_init(spi_rate);
+        select_card();
+    }
+    else
+    {
+        /* ends the read in progress, if there is one */
+        SELECT_CARD();
+
+#if SD_RAW_SDHC
+        if(sd_raw_send_command(CMD_READ_MULTIPLE_BLOCK, (sd_raw_card_type & (1 << SD_RAW_SPEC_SDHC) ? block_address / 512 : block_address)))
+#else
+        if(sd_raw_send_command(CMD_READ_MULTIPLE_BLOCK, block_address))
+#endif
+        {
+            unselect_card();
+            sd_errno = SDR_ERR_BADRESPONSE;
+            return 0;
+        }
+        stream_address = block_address;
+    }
+
+    /* wait for data block (start byte 0xfe) */
+    if(!sd_start_block())
+    {
+        unselect_card();
+        sd_raw_stream_stop();
+        sd_errno = SDR_ERR_COMMS;
+        return 0;
+    }
+
+    sd_raw_rec_block(raw_block);
+    raw_block_address = block_address;
+
+    if ( sd_use_crc ) {
+        uint16_t crc = sd_raw_rec_byte() << 8;
+        crc |= sd_raw_rec_byte();
+        if ( crc != sd_crc16(raw_block, (uint16_t)512) ) {
+            unselect_card();
+            sd_raw_stream_stop();
+            raw_block_address = (offset_t) -1;
+            if ( ++attempts < 5 ) {
+                ++sd_raw_crc_retries;
+                goto read_block;
+            }
+            sd_errno = SDR_ERR_CRC;
+            return 0;
+        }
+    }
+    else
+    {
+        /* ignore crc bytes */
+        sd_raw_rec_byte();
+        sd_raw_rec_byte();
+    }
+
+    /* the card carries on with the next block once it is selected again */
+    stream_address += 512;
+    unselect_card();
+    sd_raw_rec_byte();
+
+    return 1;
+}
+
+/**
+ * \ingroup sd_raw
+ * Enables or disables streaming by sd_raw_read_block().
+ *
+ * While enabled, reads of consecutive blocks through sd_raw_read_block()
+ * are served by a single multiple block read, which saves a command and
+ * the card's access latency for each block.  Any other access to the card
+ * ends the multiple block read, so it's meant for reading a file from
+ * start to end.
+ *
+ * \param[in] enable 1 to enable streaming, 0 to end it.
+ */
+void sd_raw_stream(uint8_t enable)
+{
+    stream_enabled = enable;
+    if(!enable && stream_address != (offset_t) -1)
+        sd_raw_stream_stop();
+}
+#endif
+
+#if !SD_RAW_SAVE_RAM
+/**
+ * \ingroup sd_raw
+ * Reads a whole block into the block cache, unless it is already cached.
+ *
+ * This lets sequential readers use the data where it lies rather than
+ * copying it out in small pieces.
+ *
+ * \note The data is only valid until the next read or write of the card.
+ *
+ * \param[in] block_address Offset of the block, a multiple of 512.
+ * \returns A pointer to the cached block, or 0 on failure.
+ * \see sd_raw_read
+ */
+const uint8_t* sd_raw_read_block(offset_t block_address)
+{
+    if(block_address == raw_block_address)
+        return raw_block;
+
+#if SD_RAW_STREAM_SUPPORT
+    if(stream_enabled)
+        return sd_raw_stream_block(block_address) ? raw_block : 0;
+#endif
+
+    if(!sd_raw_read(block_address, raw_block, sizeof(raw_block)))
+        return 0;
+
+    return raw_block;
+}
+#endif
+
 /**
  * \ingroup sd_raw
  * Continuously reads units of \c interval bytes and calls a callback function.
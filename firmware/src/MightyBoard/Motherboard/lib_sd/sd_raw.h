@@ -125,11 +125,22 @@ struct sd_raw_info
 typedef uint8_t (*sd_raw_read_interval_handler_t)(uint8_t* buffer, offset_t offset, void* p);
 typedef uintptr_t (*sd_raw_write_interval_handler_t)(uint8_t* buffer, offset_t offset, void* p);
 
+#if !SD_RAW_SAVE_RAM
+/* Number of block reads repeated after a CRC error, free running */
+extern uint16_t sd_raw_crc_retries;
+#endif
+
 uint8_t sd_raw_init(bool use_crc, uint8_t speed);
 uint8_t sd_raw_available();
 uint8_t sd_raw_locked();
 
 uint8_t sd_raw_read(offset_t offset, uint8_t* buffer, uintptr_t length);
+#if !SD_RAW_SAVE_RAM
+const uint8_t* sd_raw_read_block(offset_t block_address);
+#endif
+#if SD_RAW_STREAM_SUPPORT
+void sd_raw_stream(uint8_t enable);
+#endif
 uint8_t sd_raw_read_interval(offset_t offset, uint8_t* buffer, uintptr_t interval, uintptr_t length, sd_raw_read_interval_handler_t callback, void* p);
 uint8_t sd_raw_write(offset_t offset, const uint8_t* buffer, uintptr_t length);
 uint8_t sd_raw_write_interval(offset_t offset, uint8_t* buffer, uintptr_t length, sd_raw_write_interval_handler_t callback, void* p);
@@ -26,6 +26,19 @@
 
 #define SD_POOR_DESIGN 0
 
+// SPI clock used once the card is initialized, as F_CPU / 2^(1 + rate).  The
+// default of 3 (1 MHz) is what the MightyBoard revH and later run at.  When
+// the card's CRCs are checked (the SD_USE_CRC EEPROM setting), every block
+// read is verified, so SD_RAW_CRC_SPI_RATE is tried first and SD_RAW_SPI_RATE
+// is only fallen back to should the first read fail.
+#ifndef SD_RAW_SPI_RATE
+#define SD_RAW_SPI_RATE 3
+#endif
+
+#ifndef SD_RAW_CRC_SPI_RATE
+#define SD_RAW_CRC_SPI_RATE 0
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -71,6 +84,17 @@ extern "C"
  */
 #define SD_RAW_SAVE_RAM 1
 
+/**
+ * \ingroup sd_raw_config
+ * Controls support for streaming sequential reads.
+ *
+ * Set to 1 to let sd_raw_read_block() keep a multiple block read
+ * (CMD18) going while consecutive blocks are asked for, once enabled
+ * with sd_raw_stream().  Needs the block cache, so SD_RAW_SAVE_RAM
+ * must be 0.
+ */
+#define SD_RAW_STREAM_SUPPORT 1
+
 /**
  * \ingroup sd_raw_config
  * Controls support for SDHC cards.
@@ -162,6 +186,10 @@ extern "C"
 #undef SD_RAW_WRITE_BUFFERING
 #define SD_RAW_WRITE_BUFFERING 0
 #endif
+#if SD_RAW_SAVE_RAM
+#undef SD_RAW_STREAM_SUPPORT
+#define SD_RAW_STREAM_SUPPORT 0
+#endif
 
 #ifdef __cplusplus
 }
@@ -35,7 +35,14 @@ static uint8_t previousButton; ///< state of the button pins from the previous s
 
 void AnalogButtonArray::init() {
 	adcValid = false;
+	active = false;
 	initAnalogPin(ANALOG_BUTTONS_PIN);
+#ifdef ADC_SEQUENCER
+	// One read at a time, between the heaters' channels, if it's full
+	adcChannel = addAnalogChannel(ANALOG_BUTTONS_PIN);
+	if (adcChannel != ADC_SEQ_NONE)
+		setAnalogChannelRate(adcChannel, ANALOG_BUTTONS_IDLE_TURNS);
+#endif
 }
 
 // This function takes an ADC value and returns which button was pressed.
@@ -61,28 +68,48 @@ void AnalogButtonArray::scanButtons() {
 	int16_t buttonValue;
 	bool valid;
 
-	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-		valid = adcValid;
-		buttonValue = adcValue;
+#ifdef ADC_SEQUENCER
+	if (adcChannel != ADC_SEQ_NONE)
+		valid = getAnalogChannel(adcChannel, &buttonValue);
+	else
+#endif
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			valid = adcValid;
+			buttonValue = adcValue;
+
+			// Invalidate the result now that we have read it
+			if (adcValid)
+				adcValid = false;
+		}
 
-		// Invalidate the result now that we have read it
-		if (adcValid)
-			adcValid = false;
+		// initiate next read when it's due; if the ADC is busy, wait for
+		// next time.
+		if ((!readTimeout.isActive() || readTimeout.hasElapsed()) &&
+		    startAnalogRead(ANALOG_BUTTONS_PIN, &adcValue, &adcValid))
+			readTimeout.start(active ? ANALOG_BUTTONS_ACTIVE_MICROS :
+					  ANALOG_BUTTONS_IDLE_MICROS);
 	}
-	
-	// initiate next read, if the ADC is busy, return and wait for next time.
-	if (!startAnalogRead(ANALOG_BUTTONS_PIN, &adcValue, &adcValid)) return;
-	
+
 	// We we don't have a valid reading return and wait for next time.
 	if (!valid) return;
 
+	// Take the ADC value and determine if we have a button press
+	uint8_t currentButton = buttonFromADC(buttonValue);
+
+	// Read at full rate while a button is down
+	if (active != (currentButton != NO_BUTTON)) {
+		active = !active;
+#ifdef ADC_SEQUENCER
+		if (adcChannel != ADC_SEQ_NONE)
+			setAnalogChannelRate(adcChannel, active ? 1 : ANALOG_BUTTONS_IDLE_TURNS);
+#endif
+	}
+
     // Don't bother scanning if we already have a button
     if (buttonPressWaiting || (buttonTimeout.isActive() && !buttonTimeout.hasElapsed()))
     return;
 	
-	// Take the ADC value and determine if we have a button press
-	uint8_t currentButton = buttonFromADC(buttonValue);
-	
 	// See if the button we have now is different from the last button
 	if (currentButton == previousButton) {
 		buttonCount++;
@@ -23,6 +23,7 @@
 #ifndef ANALOGBUTTONARRAY_HH
 #define ANALOGBUTTONARRAY_HH
 
+#include "Configuration.hh"
 #include "ButtonArray.hh"
 #include <util/atomic.h>
 #include "Types.hh"
@@ -31,6 +32,22 @@
 #define DEBOUNCE_COUNT 2
 #define NO_BUTTON 255
 
+// The ladder is read slowly while no button is down, leaving the ADC to the
+// heaters, and at full rate from the first sign of a press until it's let
+// go: on every ANALOG_BUTTONS_IDLE_TURNS turns of the ADC sequencer, or
+// without it, one read every ANALOG_BUTTONS_IDLE_MICROS
+#ifndef ANALOG_BUTTONS_IDLE_TURNS
+#define ANALOG_BUTTONS_IDLE_TURNS 8
+#endif
+
+#ifndef ANALOG_BUTTONS_IDLE_MICROS
+#define ANALOG_BUTTONS_IDLE_MICROS 20000L
+#endif
+
+#ifndef ANALOG_BUTTONS_ACTIVE_MICROS
+#define ANALOG_BUTTONS_ACTIVE_MICROS 2000L
+#endif
+
 // See shared/ButtonArray.h for descriptions of the functions of this class.
 class AnalogButtonArray : public ButtonArray {
 private:
@@ -38,6 +55,11 @@ private:
   int16_t adcValue;
   uint8_t previousButton;
   uint8_t buttonCount;
+  bool active;          ///< a button was down at the last read
+  Timeout readTimeout;  ///< until the next one off read
+#ifdef ADC_SEQUENCER
+  uint8_t adcChannel;   ///< sequencer channel for the ladder, or ADC_SEQ_NONE
+#endif
 
   uint8_t buttonFromADC(int16_t adc_value);
 
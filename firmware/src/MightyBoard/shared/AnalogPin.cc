@@ -20,14 +20,23 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <util/atomic.h>
+#include "IsrProfile.hh"
 
 
 volatile int16_t* adc_destination; //< Address to write the sampled data to
 
 volatile bool* adc_finished; //< Flag to set once the data is sampled
 
+#ifdef ADC_SEQUENCER
+static volatile bool adc_running = false; //< A conversion is in progress
+#endif
+
 #if defined (__AVR_ATmega168__) || defined (__AVR_ATmega328__)
 
+#ifdef ADC_SEQUENCER
+#error ADC_SEQUENCER is only written for the ATmega1280 and 2560
+#endif
+
 // We are using the AVcc as our reference.  There's a 100nF cap
 // to ground on the AREF pin.
 const uint8_t ANALOG_REF = 0x01;
@@ -95,27 +104,167 @@ void initAnalogPin(uint8_t pin) {
 	  DDRF  &= ~(_BV(pin));
 	  PORTF &= ~(_BV(pin));
 	  DIDR0 |= _BV(pin);
-
-	  // clear ADC Channel bit selecting upper 8 ADCs
-	  ADCSRB &= ~(_BV(MUX5));
      }
      else {
-	  pin   &= 7;
-	  DDRK  &= ~(_BV(pin));
-	  PORTK &= ~(_BV(pin));
-	  DIDR2 |= _BV(pin);
+	  DDRK  &= ~(_BV(pin & 7));
+	  PORTK &= ~(_BV(pin & 7));
+	  DIDR2 |= _BV(pin & 7);
+     }
+
+#ifdef ADC_SEQUENCER
+     // Once it's running the sequencer selects the channel for each
+     // conversion, and the read-modify-write of ADCSRA could clear its
+     // interrupt and stall it
+     if ( adc_running ) return;
+#endif
 
-	  // set ADC Channel bit selecting upper 8 ADCs
+     // clear or set ADC Channel bit selecting upper 8 ADCs
+     if (pin < 8)
+	  ADCSRB &= ~(_BV(MUX5));
+     else
 	  ADCSRB |= _BV(MUX5);
-     }
 
      // select ADC Channel and connect AREF to AVCC
-     ADMUX = _BV(REFS0) | pin;
+     ADMUX = _BV(REFS0) | (pin & 7);
 
      // enable ADC conversions, interrupt on completion
      ADCSRA |= _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0) | _BV(ADEN) | _BV(ADIE);
 }
 
+#ifdef ADC_SEQUENCER
+
+// The ADC runs continuously, one conversion started from the ISR as the
+// last finishes.  It takes 2^ADC_SEQ_SHIFT samples in a row from each
+// channel in turn, after one to let the input settle once the channel has
+// been switched.  One off reads from startAnalogRead() go in between
+// channels.  A channel with a rate of n is only sampled on every nth time
+// its turn comes round, the rest being passed over.
+
+#define SEQ_ONE_OFF	0xff	// seq_current while a one off read is running
+
+static uint8_t seq_pins[ADC_SEQ_CHANNELS];
+static uint8_t seq_count = 0;
+static volatile int16_t seq_value[ADC_SEQ_CHANNELS];
+static volatile uint8_t seq_ready = 0;	// a bit for each channel with a new average
+static uint8_t seq_every[ADC_SEQ_CHANNELS];	// its rate
+static uint8_t seq_skip[ADC_SEQ_CHANNELS];	// turns to pass over before it's sampled
+
+// Only touched by the ISR once the ADC is running
+static uint8_t seq_current;		// channel being sampled, or SEQ_ONE_OFF
+static uint8_t seq_next = 0;		// next channel to sample
+static uint8_t seq_samples;		// samples taken, counting the one thrown away
+static uint16_t seq_sum;
+
+static volatile uint8_t one_off_pin;
+static volatile bool one_off_pending = false;
+
+// Fails to compile if the sum of the samples could overflow, or there are
+// more channels than seq_ready has bits
+typedef char seq_shift_check[(ADC_SEQ_SHIFT <= 6) ? 1 : -1];
+typedef char seq_channels_check[(ADC_SEQ_CHANNELS <= 8) ? 1 : -1];
+
+static void startConversion(uint8_t pin) {
+     // Select high or low bank of ADC inputs
+     ADCSRB = ( pin > 7 ) ? _BV(MUX5) : 0;
+
+     // select ADC Channel and connect AREF to AVCC
+     ADMUX = _BV(REFS0) | ( pin & 0x07 );
+
+     // start the conversion.
+     ADCSRA |= _BV(ADSC);
+}
+
+// Start the next conversion, a one off read if one is waiting, else the
+// next channel.  Called with interrupts off
+static void startNext() {
+     if ( one_off_pending ) {
+	  one_off_pending = false;
+	  seq_current = SEQ_ONE_OFF;
+	  startConversion(one_off_pin);
+     }
+     else if ( seq_count ) {
+	  // Some channel is due within the slowest rate's turns
+	  for (;;) {
+	       seq_current = seq_next;
+	       seq_next = ( seq_next + 1 < seq_count ) ? seq_next + 1 : 0;
+	       if ( seq_skip[seq_current] == 0 ) break;
+	       seq_skip[seq_current]--;
+	  }
+	  seq_skip[seq_current] = seq_every[seq_current] - 1;
+	  seq_samples = 0;
+	  seq_sum = 0;
+	  startConversion(seq_pins[seq_current]);
+     }
+     else {
+	  adc_running = false;
+	  return;
+     }
+     adc_running = true;
+}
+
+uint8_t addAnalogChannel(uint8_t pin) {
+     // Sensors are initialized again on every reset, so a pin which is
+     // already sampled keeps its channel
+     for ( uint8_t i = 0; i < seq_count; i ++ )
+	  if ( seq_pins[i] == pin ) return i;
+
+     uint8_t channel = ADC_SEQ_NONE;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  if ( seq_count < ADC_SEQ_CHANNELS ) {
+	       channel = seq_count++;
+	       seq_pins[channel] = pin;
+	       seq_every[channel] = 1;
+	       seq_skip[channel] = 0;
+	       seq_ready &= ~_BV(channel);
+	       if ( ! adc_running ) startNext();
+	  }
+     }
+     return channel;
+}
+
+void setAnalogChannelRate(uint8_t channel, uint8_t every) {
+     if ( every == 0 ) every = 1;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  seq_every[channel] = every;
+	  // A faster rate needn't wait out the turns of the slower one
+	  if ( seq_skip[channel] >= every ) seq_skip[channel] = every - 1;
+     }
+}
+
+bool getAnalogChannel(uint8_t channel, int16_t *value) {
+     bool ready;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  ready = ( seq_ready & _BV(channel) ) != 0;
+	  *value = seq_value[channel];
+	  seq_ready &= ~_BV(channel);
+     }
+     return ready;
+}
+
+bool startAnalogRead(uint8_t pin,
+		     volatile int16_t* destination,
+		     volatile bool* finished) {
+     bool started = false;
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  // We should not start a new read while an existing one is waiting
+	  // or in progress
+	  if ( ! one_off_pending && ! ( adc_running && seq_current == SEQ_ONE_OFF ) ) {
+	       adc_destination = destination;
+	       adc_finished = finished;
+	       *adc_finished = false;
+	       one_off_pin = pin;
+	       one_off_pending = true;
+	       if ( ! adc_running ) startNext();
+	       started = true;
+	  }
+     }
+
+     // An interrupt will signal conversion completion.
+     return started;
+}
+
+#else
+
 bool startAnalogRead(uint8_t pin,
 		     volatile int16_t* destination,
 		     volatile bool* finished) {
@@ -146,10 +295,17 @@ bool startAnalogRead(uint8_t pin,
      return true;
 }
 
+#endif
+
 ISR(ADC_vect)
 {
      uint8_t low_byte, high_byte;
 
+#ifdef ISR_PROFILE
+     uint8_t isr_temp = ISR_PROFILE_TEMP;
+     uint16_t isr_start = STEPPER_TCNTn;
+#endif
+
      // we have to read ADCL first; doing so locks both ADCL
      // and ADCH until ADCH is read.  reading ADCL second would
      // cause the results of each conversion to be discarded,
@@ -158,9 +314,35 @@ ISR(ADC_vect)
      low_byte  = ADCL;
      high_byte = ADCH;
 
+#ifdef ADC_SEQUENCER
+     int16_t value = (high_byte << 8) | low_byte;
+
+     if ( seq_current == SEQ_ONE_OFF ) {
+	  *adc_destination = value;
+	  *adc_finished = true;
+	  startNext();
+     }
+     else {
+	  // The first sample after switching channels is thrown away
+	  if ( seq_samples ) seq_sum += value;
+	  if ( ++seq_samples > (1 << ADC_SEQ_SHIFT) ) {
+	       seq_value[seq_current] = seq_sum >> ADC_SEQ_SHIFT;
+	       seq_ready |= _BV(seq_current);
+	       startNext();
+	  }
+	  else
+	       ADCSRA |= _BV(ADSC);
+     }
+#else
      // combine the two bytes
      *adc_destination = (high_byte << 8) | low_byte;
      *adc_finished = true;
+#endif
+
+#ifdef ISR_PROFILE
+     isr_profile_record(ISR_PROFILE_ADC, isr_profile_since(isr_start));
+     ISR_PROFILE_TEMP = isr_temp;
+#endif
 }
 
 #endif
@@ -19,6 +19,7 @@
 #define ANALOG_PIN_HH_
 
 #include "Compat.hh"
+#include "Configuration.hh"
 #include <stdint.h>
 
 /// Porting notes:
@@ -38,4 +39,41 @@ void initAnalogPin(uint8_t pin);
 ///              completed, and the output is stored in destination.
 bool startAnalogRead(uint8_t pin, volatile int16_t* destination, volatile bool* finished);
 
+#ifdef ADC_SEQUENCER
+
+/// Channels the sequencer can sample
+#ifndef ADC_SEQ_CHANNELS
+#define ADC_SEQ_CHANNELS 4
+#endif
+
+/// Each channel's average is of 2^ADC_SEQ_SHIFT samples
+#ifndef ADC_SEQ_SHIFT
+#define ADC_SEQ_SHIFT 4
+#endif
+
+#define ADC_SEQ_NONE 0xff
+
+/// Add a pin to those the ADC samples continuously, in turn, and averages
+/// in the ISR.  The pin must first be placed into analog input mode by a
+/// call to #initAnalogPin().  Reads with #startAnalogRead() still work,
+/// going in between the channels.
+/// \param [in] pin Analog input number (processor-specific)
+/// \return Channel to read the pin's averages from, or ADC_SEQ_NONE if
+///          all ADC_SEQ_CHANNELS are in use
+uint8_t addAnalogChannel(uint8_t pin);
+
+/// Sample a channel only on every nth turn of the sequencer, to leave the
+/// ADC to the others; channels start at 1, every turn.
+/// \param [in] channel Channel returned by #addAnalogChannel()
+/// \param [in] every Turns per sample, from 1 to 255
+void setAnalogChannelRate(uint8_t channel, uint8_t every);
+
+/// Get the latest average for a channel of the sequencer.
+/// \param [in] channel Channel returned by #addAnalogChannel()
+/// \param [out] value The average, in ADC counts
+/// \return True if this is a new average since the last call
+bool getAnalogChannel(uint8_t channel, int16_t *value);
+
+#endif
+
 #endif /* ANALOG_PIN_HH_ */
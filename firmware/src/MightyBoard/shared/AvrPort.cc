@@ -21,19 +21,19 @@
 #if defined(__AVR_ATmega644P__) || \
 defined(__AVR_ATmega1280__) || \
 	defined(__AVR_ATmega2560__)
-extern const AvrPort PortA = { 0x20 };
+extern const AvrPort PortA = { AVR_PORT_BASE_A };
 #endif // __AVR_ATmega644P__
-extern const AvrPort PortB = { 0x23 };
-extern const AvrPort PortC = { 0x26 };
-extern const AvrPort PortD = { 0x29 };
+extern const AvrPort PortB = { AVR_PORT_BASE_B };
+extern const AvrPort PortC = { AVR_PORT_BASE_C };
+extern const AvrPort PortD = { AVR_PORT_BASE_D };
 #if defined (__AVR_ATmega1280__) || defined (__AVR_ATmega2560__)
-extern const AvrPort PortE = { 0x2C };
-extern const AvrPort PortF = { 0x2F };
-extern const AvrPort PortG = { 0x32 };
-extern const AvrPort PortH = { 0x100 };
-extern const AvrPort PortJ = { 0x103 };
-extern const AvrPort PortK = { 0x106 };
-extern const AvrPort PortL = { 0x109 };
+extern const AvrPort PortE = { AVR_PORT_BASE_E };
+extern const AvrPort PortF = { AVR_PORT_BASE_F };
+extern const AvrPort PortG = { AVR_PORT_BASE_G };
+extern const AvrPort PortH = { AVR_PORT_BASE_H };
+extern const AvrPort PortJ = { AVR_PORT_BASE_J };
+extern const AvrPort PortK = { AVR_PORT_BASE_K };
+extern const AvrPort PortL = { AVR_PORT_BASE_L };
 #endif //__AVR_ATmega1280__
 
 extern const AvrPort NullPort = { NULL_PORT };
@@ -59,6 +59,24 @@ typedef uint16_t port_base_t;
 #endif
 
 
+// The base addresses, of PINx, of the ports, for the AvrPorts below and for
+// FastPin, which needs them as constants
+#if defined(__AVR_ATmega644P__) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+#define AVR_PORT_BASE_A	0x20
+#endif
+#define AVR_PORT_BASE_B	0x23
+#define AVR_PORT_BASE_C	0x26
+#define AVR_PORT_BASE_D	0x29
+#if defined (__AVR_ATmega1280__) || defined (__AVR_ATmega2560__)
+#define AVR_PORT_BASE_E	0x2C
+#define AVR_PORT_BASE_F	0x2F
+#define AVR_PORT_BASE_G	0x32
+#define AVR_PORT_BASE_H	0x100
+#define AVR_PORT_BASE_J	0x103
+#define AVR_PORT_BASE_K	0x106
+#define AVR_PORT_BASE_L	0x109
+#endif
+
 #define PINx _SFR_MEM8(port_base+0)
 #define DDRx _SFR_MEM8(port_base+1)
 #define PORTx _SFR_MEM8(port_base+2)
@@ -20,6 +20,7 @@
 #define SHARED_CIRCULAR_BUFFER_HH_
 
 #include <stdint.h>
+#include <string.h>
 
 typedef uint16_t BufSizeType;
 
@@ -119,6 +120,187 @@ typedef CircularBufferTempl<uint8_t> CircularBuffer;
 typedef CircularBufferTempl<uint16_t> CircularBuffer16;
 typedef CircularBufferTempl<uint32_t> CircularBuffer32;
 
+/// A circular buffer with a compile time, power of two size.  Indices wrap
+/// with a mask rather than the division which "% size" costs on the AVR.
+///
+/// head is only written by push() and tail only by pop(); both run freely
+/// and the length is their difference.  So one producer and one consumer,
+/// either of which may be an interrupt, can share the buffer without
+/// disabling interrupts, provided that each can read the other's index in
+/// one go.  On the AVR that means an 8 bit IndexType, and so a SIZE of at
+/// most 128.  Buffers with 16 bit indices must be used from one context
+/// only, or have interrupts disabled around accesses as for
+/// CircularBufferTempl.  reset() must not race with either side.
+template<typename T, BufSizeType SIZE, typename IndexType = BufSizeType>
+class CircularBufferPow2Templ {
+public:
+	typedef T BufDataType;
+private:
+	// Fails to compile unless SIZE is a power of two which IndexType can count up to
+	typedef char size_check[((SIZE & (SIZE - 1)) == 0 &&
+				 SIZE <= (BufSizeType)((IndexType)~0 >> 1) + 1) ? 1 : -1];
+	static const IndexType MASK = SIZE - 1;
+
+	volatile IndexType head; /// Index of the next push, before masking
+	volatile IndexType tail; /// Index of the next pop, before masking
+	BufDataType data[SIZE]; /// Buffer data
+	volatile bool overflow; /// Overflow indicator
+	volatile bool underflow; /// Underflow indicator
+
+	// Keeps the compiler from moving data accesses past the index updates
+	static inline void barrier() {
+		__asm__ __volatile__ ("" ::: "memory");
+	}
+public:
+	CircularBufferPow2Templ() :
+		head(0), tail(0), overflow(false), underflow(false) {
+	}
+
+	/// Reset the buffer to its empty state.  All data in
+	/// the buffer will be (effectively) lost.
+	inline void reset() {
+		head = 0;
+		tail = 0;
+		overflow = false;
+		underflow = false;
+	}
+	/// Append a byte to the tail of the buffer
+	inline void push(BufDataType b) {
+		IndexType h = head;
+		if ((IndexType)(h - tail) < SIZE) {
+			data[h & MASK] = b;
+			barrier();
+			head = h + 1;
+		} else {
+			overflow = true;
+		}
+	}
+	/// Append sz entries from src to the tail of the buffer, with at
+	/// most two memcpy()s.  If there isn't room for all of them, nothing
+	/// is appended and the overflow flag is set.
+	inline bool pushFrom(const BufDataType *src, BufSizeType sz) {
+		IndexType h = head;
+		if (SIZE - (IndexType)(h - tail) < sz) {
+			overflow = true;
+			return false;
+		}
+		BufSizeType first = h & MASK;
+		BufSizeType chunk = SIZE - first;
+		if (chunk > sz)
+			chunk = sz;
+		memcpy((BufDataType *)&data[first], src, chunk * sizeof(BufDataType));
+		if (sz > chunk)
+			memcpy((BufDataType *)data, src + chunk, (sz - chunk) * sizeof(BufDataType));
+		barrier();
+		head = h + (IndexType)sz;
+		return true;
+	}
+
+	/// Point *p at the free entries at the tail of the buffer which lie
+	/// contiguously in memory, up to the end of the buffer data, and
+	/// return how many there are.  Fill some and append them with
+	/// pushed(sz), so a producer can write straight into the buffer.
+	inline BufSizeType pushContiguous(BufDataType **p) {
+		BufSizeType first = head & MASK;
+		BufSizeType room = getRemainingCapacity();
+		*p = (BufDataType *)&data[first];
+		return ( room > SIZE - first ) ? SIZE - first : room;
+	}
+
+	/// Append the sz entries written through pushContiguous()
+	inline void pushed(BufSizeType sz) {
+		barrier();
+		head = head + (IndexType)sz;
+	}
+	/// Pop a byte off the head of the buffer
+	inline BufDataType pop() {
+		IndexType t = tail;
+		if (head == t) {
+			underflow = true;
+			return BufDataType();
+		}
+		BufDataType popped_byte = data[t & MASK];
+		barrier();
+		tail = t + 1;
+		return popped_byte;
+	}
+
+	/// Pop a number of bytes off the head of the buffer.  If there
+	/// are not enough bytes to complete the pop, pop what we can and
+	/// set the underflow flag.
+	inline void pop(BufSizeType sz) {
+		IndexType len = getLength();
+		if (len < sz) {
+			underflow = true;
+			sz = len;
+		}
+		tail = tail + (IndexType)sz;
+	}
+
+	/// Copy sz entries, starting offset entries from the head of the
+	/// buffer, to dst.  At most two memcpy()s, as the data may wrap
+	/// around the end of the buffer.  Returns false, copying nothing,
+	/// if the buffer holds fewer than offset + sz entries.
+	inline bool peek(BufDataType *dst, BufSizeType sz, BufSizeType offset = 0) const {
+		if (getLength() < offset + sz)
+			return false;
+		BufSizeType first = (IndexType)(tail + offset) & MASK;
+		BufSizeType chunk = SIZE - first;
+		if (chunk > sz)
+			chunk = sz;
+		memcpy(dst, (const BufDataType *)&data[first], chunk * sizeof(BufDataType));
+		if (sz > chunk)
+			memcpy(dst + chunk, (const BufDataType *)data, (sz - chunk) * sizeof(BufDataType));
+		return true;
+	}
+
+	/// Point *p at the entries at the head of the buffer which lie
+	/// contiguously in memory, up to the end of the buffer data, and
+	/// return how many there are.  Consume them with pop(sz).
+	inline BufSizeType peekContiguous(const BufDataType **p) const {
+		BufSizeType first = tail & MASK;
+		BufSizeType len = getLength();
+		*p = (const BufDataType *)&data[first];
+		return ( len > SIZE - first ) ? SIZE - first : len;
+	}
+
+	/// As peek(), but also pops the copied entries
+	inline bool popInto(BufDataType *dst, BufSizeType sz) {
+		if (!peek(dst, sz))
+			return false;
+		barrier();
+		tail = tail + (IndexType)sz;
+		return true;
+	}
+
+	/// Get the length of the buffer
+	inline BufSizeType getLength() const {
+		return (IndexType)(head - tail);
+	}
+
+	/// Get the remaining capacity of this buffer
+	inline BufSizeType getRemainingCapacity() const {
+		return SIZE - getLength();
+	}
+
+	/// Check if the buffer is empty
+	inline bool isEmpty() const {
+		return head == tail;
+	}
+	/// Read the buffer directly
+	inline BufDataType& operator[](BufSizeType index) {
+		return data[(IndexType)(tail + index) & MASK];
+	}
+	/// Check the overflow flag
+	inline bool hasOverflow() const {
+		return overflow;
+	}
+	/// Check the underflow flag
+	inline bool hasUnderflow() const {
+		return underflow;
+	}
+};
+
 #define DEFINE_BUFFER(name,dtype,size) \
 dtype name##_data[size]; \
 CircularBufferTempl<dtype> name(size,name##_data);
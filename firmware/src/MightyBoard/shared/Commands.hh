@@ -77,9 +77,212 @@
 
 #define HOST_CMD_GET_POSITION_EXT  21
 #define HOST_CMD_EXTENDED_STOP     22
+// In PLATFORM_COOLDOWN builds, the board status is followed by a byte of the
+// platform cool down monitor's bits: 0x01 once the platform has cooled to its
+// release temperature with its heater off, and 0x02 when as well the bot is
+// idle and ready for the next build
 #define HOST_CMD_BOARD_STATUS	   23
+// The reply ends with three uint16 counts of the times the planner ran dry
+// in mid build: with commands buffered but not yet planned, waiting on the
+// SD card and waiting on the host (BUILD_STATS builds, else zeros)
 #define HOST_CMD_GET_BUILD_STATS   24
 #define HOST_CMD_ADVANCED_VERSION  27
+// Retrieve the interrupt execution time statistics (ISR_PROFILE builds)
+#define HOST_CMD_GET_ISR_PROFILE   28
+// Measure how fast a file can be read from the SD card (SD_BENCHMARK builds)
+#define HOST_CMD_SD_BENCHMARK      29
+// SD card playback counters (SD_PLAYBACK_STATS builds)
+#define HOST_CMD_GET_SD_PLAYBACK_STATS 30
+// Switch the host link to a faster baud rate.  The payload is the rate as a
+// uint32; 115200, 250000 and 500000 are supported, anything else gets
+// RC_CMD_UNSUPPORTED.  The RC_OK reply is sent at the old rate, and the new
+// one takes effect once it has gone, so the host switches after reading the
+// reply.  Away from 115200, the bot drops back to it when no packet has
+// arrived for HOST_BAUD_LINK_TIMEOUT_MS, and the host should do likewise
+// when replies stop; so a host idling at the faster rate should keep
+// polling.
+#define HOST_CMD_SET_BAUD_RATE     31
+// Number the packets from the host so that it can send several without
+// waiting for each reply.  With byte 1 non-zero, every following packet
+// starts with a sequence number, counting up from 0 and wrapping at 255,
+// and every reply starts with the number of the last packet accepted in
+// order, so the acks are cumulative.  A packet out of order is dropped with
+// RC_OUT_OF_SEQUENCE, one hit by a CRC, length or timeout error is dropped
+// as usual, and one turned away with RC_BUFFER_OVERFLOW isn't accepted
+// either; the host resends from the packet after the ack.  A repeat of an
+// accepted packet is only acked, so a query whose reply was lost should be
+// sent again under a new number.  The reply to this query is RC_OK and the
+// number of packets the host may have in flight.  The mode ends with byte 1
+// zero, on a host reset, or when a faster baud rate falls back.
+#define HOST_CMD_SET_PACKET_WINDOW 32
+// Main loop timing (SLICE_STATS builds).  Byte 1 is the slice, or 0xff for
+// whole passes of the loop; if bit 0 of byte 2 is set the statistics are
+// reset after they've been read.  The reply is RC_OK, the number of slices,
+// the slice which last went over budget (0xff for none), the average and
+// longest run in microseconds as uint32s, and the runs, passes put off and
+// runs over budget as uint16s.  For whole passes, the histogram of loop
+// periods follows as SLICE_HISTOGRAM_BUCKETS uint16s.
+#define HOST_CMD_GET_SLICE_STATS   33
+// Have the bot push a status frame every so many milliseconds, given as a
+// uint16 in bytes 1-2, so the host needn't poll for it; 0 stops them, and
+// periods under HOST_TELEMETRY_MIN_MS are lengthened to it.  The reply is
+// RC_OK and the period in effect as a uint16.  Frames go out between
+// replies, never in place of one, and are led like a reply (by the ack in
+// windowed mode) but with RC_TELEMETRY for the response code.  After that:
+// a uint8 frame count, the X, Y and Z positions in steps as int32s, the
+// current temperatures of tools 0 and 1 and the platform as int16s, their
+// heater outputs (0-255) as uint8s, the number of moves planned, the build
+// percentage (101 when not building) and the board status bits.  The frames
+// stop on a host reset, or when a faster baud rate falls back.  Only in
+// builds with HOST_TELEMETRY, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_SET_TELEMETRY     34
+// Several HOST_CMD_TOOL_QUERY queries in one packet.  The payload is a list
+// of tool index and SLAVE_CMD_ query pairs, and the reply is RC_OK, the
+// number of queries answered, then their answers one after another as
+// HOST_CMD_TOOL_QUERY would give them, less the RC_OK of each.  Answering
+// stops at a query which isn't supported, or once the reply might not have
+// room for the next answer, so the host should look at the count.
+#define HOST_CMD_TOOL_MULTI_QUERY  35
+// Tune a heater (byte 1: 0 and 1 for the tools, 2 for the platform).  Byte 2
+// is the action: 0 only reports, 1 starts a model tune which heats at full
+// output up to the uint16 temperature in bytes 3-4 and fits the model to
+// the response, 2 stops a tune.  The reply is RC_OK, the tune state
+// (0 idle, 1 running, 2 done, 3 failed) and the heater's model from
+// HEATER_MODEL_SETTINGS: gain, time constant, dead time and ambient as
+// uint16s; the state isn't 1 after a start if the tune couldn't start.
+// Only in builds with HEATER_FEED_FORWARD, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_HEATER_TUNE       36
+// Autotune a heater's PID by relay feedback (byte 1: 0 and 1 for the tools,
+// 2 for the platform).  Byte 2 is the action: 0 only reports, 1 starts a
+// tune about the uint16 temperature in bytes 3-4, running the number of
+// relay cycles in byte 5 if there is one (AUTOTUNE_CYCLES if not), 2 stops
+// a tune.  The reply is RC_OK, the tune state (as HOST_CMD_HEATER_TUNE),
+// the cycles run so far and the heater's P, I and D gains from EEPROM as
+// uint16s in 1/256ths; a finished tune has saved the gains it found.  Only
+// in builds with PID_AUTOTUNE, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_PID_AUTOTUNE      37
+// The heater log.  Byte 1 is the action: 0 reads samples from the sequence
+// number in bytes 2-3 on, 1 clears the log and starts logging the heaters in
+// the bit mask in byte 2 (bit 0 tool 0, bit 1 tool 1, bit 2 the platform)
+// at most every uint16 tenths of a second in bytes 3-4, 2 stops logging.
+// The reply is RC_OK, 1 if logging, the uint16 sequence numbers of the next
+// sample to be logged and of the oldest held, then for a read the number of
+// samples which follow (up to HEATER_LOG_PER_PACKET) and the samples, from
+// the one asked for or the oldest held if that's gone.  A sample is the
+// uint16 time in tenths of a second since the start, the int16 setpoint in
+// degrees C, the int16 reading in 1/16 degrees C, the heater and its output
+// (0-255).  Only in builds with HEATER_LOG, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_HEATER_LOG        38
+// The host packet log.  Byte 1 is the action: 0 reads records from the
+// sequence number in bytes 2-3 on, 1 clears the log and starts logging, 2
+// stops logging.  The reply is RC_OK, 1 if logging, the uint16 sequence
+// numbers of the next record to be logged and of the oldest held, then for
+// a read the number of records which follow (up to HOST_LOG_PER_PACKET) and
+// the records, from the one asked for or the oldest held if that's gone.  A
+// record is the uint32 time in hundreds of microseconds at which the packet
+// was answered, its command byte (0xff if it failed to arrive whole), the
+// response code and the uint16 space then left in the command buffer.  Only
+// in builds with HOST_LOG, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_HOST_LOG          39
+// SRAM use, in bytes.  The reply is RC_OK, the size of the SRAM, the static
+// SRAM (.data and .bss), the heap, the deepest the stack has been, the
+// headroom it has never touched and what's free below the stack pointer as
+// uint16s; then the number of subsystems and the static SRAM of each as
+// uint16s (the planner's blocks, the command buffer, the LCD and the host
+// UART's packets); then the number of headroom samples, taken every
+// MEMORY_PROFILE_SAMPLE_S seconds, and the samples as uint16s, oldest
+// first.  If bit 0 of byte 1 is set the free SRAM is painted again after
+// it's been read, so the stack's depth is measured afresh, and the samples
+// are cleared.  Only in builds with MEMORY_PROFILE, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_GET_MEMORY_PROFILE 40
+// Dry run of an SD card file: it's read and planned as for a build, but
+// nothing is moved, heated or waited for.  Byte 1 is the action: 1 starts
+// a dry run of the file named in bytes 2 on, 0 reads the report of the
+// current or last one.  The reply to a start is RC_OK and the SdErrorCode.
+// The reply to a read is RC_OK, the state (0 none, 1 running, 2 done), the
+// error (0 none, 1 a command with no handler, 2 an SD card error, 3
+// cancelled) and its detail (the command or the SdErrorCode); then as
+// uint32s the offset in the file it got to, the planner blocks, their time
+// in ms and, as an int32, the least time in ms of motion which would have
+// been queued ahead of a move (negative if the steppers would have stalled);
+// then as a uint16 the moves which would have stalled, and as a uint32 how
+// long the run took in ms.  Only in builds with SD_DRY_RUN, else
+// RC_CMD_UNSUPPORTED.
+#define HOST_CMD_DRY_RUN           41
+// Credit flow control, so the host can stream commands without asking for
+// the buffer size.  With byte 1 non-zero, every following reply carries
+// the uint16 free space in the command buffer once the packet has been
+// handled, just ahead of the response code (after the sequence number in
+// windowed mode), and so does every telemetry frame.  The host may send
+// that many bytes of commands, less those in packets it has sent since the
+// one replied to.  The reply to this query is RC_OK and the uint16 free
+// space and size of the command buffer.  The mode ends with byte 1 zero, on
+// a host reset, or when a faster baud rate falls back.  Fewer heater and
+// host log records then fit in a reply.
+#define HOST_CMD_SET_CREDIT_MODE   42
+// Statistics of the planner blocks run.  With bit 0 of byte 1 clear, the reply
+// is RC_OK then uint32 counts of the blocks, those which cruised at their
+// nominal speed and those which started from rest, then the uint32 ms spent
+// accelerating, cruising and decelerating.  With bit 0 set, it's RC_OK, the
+// uint8 width in mm/s of the buckets, then the uint16 counts of the 12
+// buckets of nominal speeds, the last of which takes all faster.  The counts
+// are halved together when one would overflow.  With bit 7 set, the
+// statistics start over once read.  Only in builds with PLANNER_STATS, else
+// RC_CMD_UNSUPPORTED.
+#define HOST_CMD_GET_PLANNER_STATS 43
+// The flight recorder, a ring of the last blocks the steppers ran which is
+// frozen when the planner runs dry in mid build, an error is shown or the
+// build is paused.  Byte 1 is the action: 0 reads the records from the
+// uint16 sequence number in bytes 2 and 3 on, 1 clears the ring and records
+// again, 2 freezes it.  The reply is RC_OK, the cause it was frozen for (0
+// still recording, 1 the planner ran dry, 2 an error, 3 a pause, 4 the
+// host), the uint16 hundreds of microseconds from the last record to the
+// freeze, and the uint16 sequence numbers of the next record and of the
+// oldest held.  Replies to a read go on with the count of records which fit
+// and the records: uint16 hundreds of microseconds since the block before
+// was set up, step events, initial, nominal and final step rates, and the
+// acceleration in 16 steps a second squared, each 0xffff when it's more;
+// then the blocks planned, this one included, and the flags (bit 0 accelerated, bit 1 reaches the nominal rate, bits 2 to 4 the
+// master axis).  A record overwritten as it's read comes back as zeros.
+// Only in builds with FLIGHT_RECORDER, else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_FLIGHT_RECORDER   44
+// The sampling profiler.  Byte 1 is the action: 0 reads the counts from the
+// bucket in byte 2 on, 1 clears them and samples into buckets of 2^n bytes
+// of flash, n a uint8 in byte 6, from the uint32 byte address in bytes 2-5,
+// and 2 stops sampling.  The reply is RC_OK, 1 if it's sampling, the uint32
+// base and uint8 shift of the window, the uint8 number of buckets and the
+// uint16 count of samples outside the window.  Replies to a read go on with
+// the count of buckets which fit and their uint16 counts.  The counts are
+// halved together when one would overflow.  Only in builds with PC_PROFILE,
+// else RC_CMD_UNSUPPORTED.
+#define HOST_CMD_PC_PROFILE        45
+// Large packets, so that one packet can carry several action commands one
+// after another.  With byte 1 non-zero, the packets from the host may carry
+// up to HOST_LARGE_PACKET_PAYLOAD bytes (128 unless the build says
+// otherwise); with it zero, and to begin with, no more than 32.  The action
+// commands in a packet are all queued, or none of them with
+// RC_BUFFER_OVERFLOW, and get the one reply.  Replies stay within 32 bytes.
+// The reply to this query is RC_OK and the uint8 longest payload now
+// accepted.  The mode ends with byte 1 zero, on a host reset, or when a
+// faster baud rate falls back.  Only in builds with HOST_LARGE_PACKETS, else
+// RC_CMD_UNSUPPORTED.
+#define HOST_CMD_SET_LARGE_PACKETS 46
+// Writes a whole EEPROM image.  Byte 1 is the action: 0 begins one, with
+// the reply RC_OK, the uint16 size of the EEPROM and the uint16 start and
+// end of the region the image leaves alone, the journal of the lifetime
+// counters.  1 writes the chunk which follows the uint16 offset in bytes
+// 2-3, and 2 the same run length encoded: a byte c under 0x80 is followed by
+// c + 1 bytes as they are, and one of 0x80 or more by a byte to repeat
+// (c & 0x7f) + 3 times.  Only the bytes which differ are queued, as long as
+// there's room, and the reply is RC_OK, the uint16 offset the chunk was
+// taken up to, from which the host goes on, and the uint16 bytes changed
+// since the image began.  3 waits for the writes and reloads the settings;
+// its reply is RC_OK, the uint16 CRC-16 (0xA001 reflected, from 0xffff, as
+// avr-libc's _crc16_update) of the uint16 length in bytes 4-5 from the
+// offset in bytes 2-3, less the region left alone, and the bytes changed.
+// RC_BOT_BUILDING during a build.  Only in builds with EEPROM_IMAGE, else
+// RC_CMD_UNSUPPORTED.
+#define HOST_CMD_EEPROM_IMAGE      47
 
 // These are our bufferable commands from the host
 
@@ -116,7 +319,77 @@
 #define HOST_CMD_SET_ACCELERATION_TOGGLE	156
 #define HOST_CMD_STREAM_VERSION		157
 #define HOST_CMD_PAUSE_AT_ZPOS		158
-
+// A shorter HOST_CMD_QUEUE_POINT_NEW_EXT for streaming: a uint8 mask of the
+// axes which move (bit 0 X to bit 4 B), an int16 step delta for each of them
+// in that order, then a uint16 dda_rate, the float distance and the int16
+// feedrate_mult_64.  8 bytes plus 2 per axis; a move which doesn't fit these
+// fields has to be sent as HOST_CMD_QUEUE_POINT_NEW_EXT.
+#define HOST_CMD_QUEUE_POINT_DELTA	159
+// Mesh leveling, for AUTO_LEVEL_MESH builds: a uint8 action and a uint8
+// point index.  Action 0 records the Z of the current position, less the
+// probe offsets in X and Y, as point index of the grid (row by row, from
+// index 0); 1 levels with the mesh in EEPROM, and cancels the build if it
+// is incomplete or too far out; 2 stops leveling with it.
+#define HOST_CMD_MESH_LEVEL		160
+// An arc in the XY plane, queued as chords: int32 X, Y and Z of the end
+// and A and B steps to extrude, relative, then the int32 X and Y of the
+// centre relative to the start, all in steps; a uint8 of flags, bit 0 set
+// for counter-clockwise (G3); and the int16 feedrate_mult_64.  Z moves
+// evenly along the arc.  The same start and end is a whole circle.
+#define HOST_CMD_QUEUE_ARC		161
+// Planner hint for the move which follows it: a uint16 max entry speed in
+// mm/s multiplied by 64, worked out by the host, and a uint8 of flags, bit
+// 0 set if the move can stop from its nominal speed within its length.
+// The firmware takes the speed as the move's junction speed, capped at its
+// nominal speed, in place of working it out, and still brakes to a stop at
+// the end of what it has buffered.
+#define HOST_CMD_PLANNER_HINT		162
+#define PLANNER_HINT_NOMINAL_LENGTH	0x01
+// Firmware retraction, for G10 and G11: a uint8 of flags, bit 0 set to
+// unretract, the uint16 length in steps of the active extruder and the
+// int16 feed rate in mm/s multiplied by 64, 0 for A's max speed change from
+// EEPROM.  A retract is queued with the travel move after it, over as much
+// of the start of the travel as it takes at its rate; an unretract right
+// after the travel goes over the end of it.  Otherwise each is a move of
+// the extruder on its own.  A retract does nothing while retracted, and an
+// unretract nothing unless retracted.
+#define HOST_CMD_FIRMWARE_RETRACT	163
+#define FIRMWARE_RETRACT_UNRETRACT	0x01
+// Print with an advance profile from EEPROM (ADVANCE_PROFILES): a uint8
+// profile index, or 0xFF for the JKN advance and deprime settings.  The
+// moves queued after it take up the profile's K, K2, deprime steps and max
+// extrusion rate; those before keep theirs, so it needn't wait for them.
+// Builds without JKN_ADVANCE ignore it.
+#define HOST_CMD_SET_ADVANCE_PROFILE	164
+// Probe a leveling point, for AUTO_LEVEL builds: a uint8 point, the int32 X
+// and Y of the nozzle in steps, a uint32 feedrate in us per step and a
+// uint16 timeout in seconds for each touch, as HOST_CMD_FIND_AXES_MINIMUM
+// has them, a uint16 tolerance in steps and a uint8 most touches.  Travels
+// to X and Y with an accelerated move, then homes Z, fast then at the
+// feedrate, and backs off and touches again at the feedrate until the
+// touches lie within the tolerance of one another or there have been the
+// most of them.  Their mean is recorded as M131 or HOST_CMD_MESH_LEVEL
+// action 0 would record the Z there: as point 0 - 2 of the skew or, with
+// PROBE_POINT_MESH set, as that point of the mesh.  Z is left backed off by
+// HOMING_BACKOFF from the last touch, clear for the travel to the next.
+#define HOST_CMD_PROBE_POINT		165
+#define PROBE_POINT_MESH		0x80
+// Start up with the heaters coming up alongside the homing and probing, for
+// HEAT_WAIT_MOVES builds: a uint8 action.  CONCURRENT_BEGIN begins a phase
+// in which HOST_CMD_WAIT_FOR_TOOL and HOST_CMD_WAIT_FOR_PLATFORM don't stop
+// the build, whatever HEAT_WAIT_MOVES_ENABLE is set to; the commands after
+// them go on while the heaters come up.  CONCURRENT_JOIN ends the phase and
+// waits for the heaters waited on in it, with the timeout the last of the
+// waits gave.  The first move which extrudes joins if nothing has before.
+// Other builds wait at each wait as they come to it.
+#define HOST_CMD_CONCURRENT		166
+#define CONCURRENT_BEGIN		0
+#define CONCURRENT_JOIN			1
+
+// Echo, for timing the host link: the reply is RC_OK, the uint32 time on
+// the bot in hundreds of microseconds (it wraps at 2^32) and the bytes
+// after byte 0, up to MAX_PACKET_PAYLOAD - 5 of them (one fewer with the
+// packet window on).  simulator/echobench.cc times the link with it.
 #define HOST_CMD_DEBUG_ECHO        0x70
 
 
@@ -3,10 +3,13 @@
 #include "Eeprom.hh"
 #include "EepromMap.hh"
 #include "StepperAxis.hh"
+#include "StatsJournal.hh"
 
 #include "Version.hh"
 #include <avr/eeprom.h>
+#include <avr/interrupt.h>
 #include <avr/wdt.h>
+#include <util/atomic.h>
 
 #ifdef EEPROM_MENU_ENABLE
 #include "SDCard.hh"
@@ -14,6 +17,45 @@
 
 namespace eeprom {
 
+Settings settings;
+
+void loadSettings() {
+     for (uint8_t i = 0; i < 2; i++)
+	  settings.preheat_temp[i] = (int16_t)getEeprom16(eeprom_offsets::PREHEAT_SETTINGS +
+						   i * sizeof(int16_t), DEFAULT_PREHEAT_TEMP);
+     settings.preheat_temp[2] = (int16_t)getEeprom16(eeprom_offsets::PREHEAT_SETTINGS +
+					      preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP, 100);
+     settings.retract_feedrate_a = getEeprom16(eeprom_offsets::ACCELERATION2_SETTINGS +
+					acceleration_eeprom_offsets::MAX_SPEED_CHANGE +
+					sizeof(uint16_t) * A_AXIS, DEFAULT_MAX_ACCELERATION_AXIS_A);
+     settings.tool_count = getEeprom8(eeprom_offsets::TOOL_COUNT, 1);
+     settings.hbp_present = getEeprom8(eeprom_offsets::HBP_PRESENT, 1);
+     settings.override_gcode_temp = getEeprom8(eeprom_offsets::OVERRIDE_GCODE_TEMP, DEFAULT_OVERRIDE_GCODE_TEMP);
+     settings.heat_during_pause = getEeprom8(eeprom_offsets::HEAT_DURING_PAUSE, DEFAULT_HEAT_DURING_PAUSE);
+     settings.ditto_print = getEeprom8(eeprom_offsets::DITTO_PRINT_ENABLED, 0);
+     settings.clear_for_estop = getEeprom8(eeprom_offsets::CLEAR_FOR_ESTOP, 0);
+     settings.cooling_fan_duty = getEeprom8(eeprom_offsets::COOLING_FAN_DUTY_CYCLE, COOLING_FAN_DUTY_CYCLE_DEFAULT);
+#ifdef FAST_CANCEL
+     settings.fast_cancel = getEeprom8(eeprom_offsets::FAST_CANCEL_ENABLE, 0);
+#endif
+#ifdef HEAT_WAIT_MOVES
+     settings.heat_wait_moves = getEeprom8(eeprom_offsets::HEAT_WAIT_MOVES_ENABLE, 0);
+#endif
+#ifdef PLATFORM_COOLDOWN
+     settings.release_temp = getEeprom8(eeprom_offsets::PLATFORM_RELEASE_TEMP, DEFAULT_PLATFORM_RELEASE_TEMP);
+#endif
+#ifdef HAS_RGB_LED
+     settings.led_color = getEeprom8(eeprom_offsets::LED_STRIP_SETTINGS + blink_eeprom_offsets::BASIC_COLOR_OFFSET,
+			      LED_DEFAULT_COLOR);
+     settings.heat_lights =
+	  ( LED_DEFAULT_OFF != getEeprom8( // LEDs enabled
+	       eeprom_offsets::LED_STRIP_SETTINGS, LED_DEFAULT_OFF) ) &&
+	  ( LED_DEFAULT_OFF != getEeprom8( // Heat progress enabled
+	       eeprom_offsets::LED_STRIP_SETTINGS + blink_eeprom_offsets::LED_HEAT_OFFSET,
+	       LED_DEFAULT_HEAT_COLOR) );
+#endif
+}
+
 /**
  * if the EEPROM is initalized and matches firmware version, exit
  * if the EEPROM is not initalized, write defaults, and set a new version
@@ -21,9 +63,14 @@ namespace eeprom {
  */
 void init() {
      uint8_t prom_version[2];
-     eeprom_read_block(prom_version,(const uint8_t *)eeprom_offsets::VERSION_LOW, 2);
-     if ((prom_version[1]*100 + prom_version[0]) == firmware_version)
+
+     journal::load();
+
+     readBlock(prom_version,(const uint8_t *)eeprom_offsets::VERSION_LOW, 2);
+     if ((prom_version[1]*100 + prom_version[0]) == firmware_version) {
+	  loadSettings();
 	  return;
+     }
 
      // Delay a bit to prevent a reset from avrdude from
      // hitting us while updating the eeprom
@@ -38,7 +85,9 @@ void init() {
      //Update eeprom version # to match current firmware version
      prom_version[0] = firmware_version % 100;
      prom_version[1] = firmware_version / 100;
-     eeprom_write_block(prom_version,(uint8_t*)eeprom_offsets::VERSION_LOW,2);
+     writeBlock(prom_version,(uint8_t*)eeprom_offsets::VERSION_LOW,2);
+
+     loadSettings();
 }
 
 #if defined(ERASE_EEPROM_ON_EVERY_BOOT) || defined(EEPROM_MENU_ENABLE)
@@ -57,8 +106,9 @@ void init() {
 
 //Complete erase of eeprom to 0xFF
 void erase() {
+        journal::flush();
         for (uint16_t i = 0; i < EEPROM_SIZE; i ++ ) {
-                eeprom_write_byte((uint8_t*)i, 0xFF);
+                writeByte((uint8_t*)i, 0xFF);
 		wdt_reset();
 	}
 }
@@ -71,13 +121,15 @@ void erase() {
 bool saveToSDFile(const char *filename) {
 	uint8_t v;
 
+	journal::flush();
+
 	//Open the file for writing
 	if ( sdcard::startCapture((char *)filename) != sdcard::SD_SUCCESS )	return false;
 
 	//Write the eeprom contents to the file
 	bool ret = true;
         for (uint16_t i = 0; i < EEPROM_SIZE; i ++ ) {
-                v = eeprom_read_byte((uint8_t*)i);
+                v = readByte((uint8_t*)i);
 		if ( !sdcard::writeByte(v) ) {
 		    ret = false;
 		    break;
@@ -96,10 +148,12 @@ bool restoreFromSDFile(const char *filename) {
 
 	if ( sdcard::startPlayback((char *)filename) != sdcard::SD_SUCCESS )	return false;
 
+	journal::flush();
+
         for (uint16_t i = 0; i < EEPROM_SIZE; i ++ ) {
 		if ( sdcard::playbackHasNext() ) {
 			v = sdcard::playbackNext();
-                	eeprom_write_byte((uint8_t*)i, v);
+                	writeByte((uint8_t*)i, v);
 			wdt_reset();
 		}
 		else break;
@@ -107,25 +161,27 @@ bool restoreFromSDFile(const char *filename) {
 
     	sdcard::finishPlayback();
 
+	journal::load();
+	loadSettings();
 	return true;
 }
 
 #endif
 
 uint8_t getEeprom8(const uint16_t location, const uint8_t default_value) {
-        uint8_t data = eeprom_read_byte((uint8_t*)location);
+        uint8_t data = readByte((uint8_t*)location);
         if (data == 0xff) data = default_value;
         return data;
 }
 
 uint16_t getEeprom16(const uint16_t location, const uint16_t default_value) {
-        uint16_t data = eeprom_read_word((uint16_t*)location);
+        uint16_t data = readWord((uint16_t*)location);
         if (data == 0xffff) data = default_value;
         return data;
 }
 
 uint32_t getEeprom32(const uint16_t location, const uint32_t default_value) {
-        uint32_t data = eeprom_read_dword((uint32_t*)location);
+        uint32_t data = readDword((uint32_t*)location);
         if (data == 0xffffffff) return default_value;
         return data;
 }
@@ -142,7 +198,7 @@ float getEepromFixed32(const uint16_t location, const float default_value) {
 /// Fetch a fixed 16 value from eeprom
 float getEepromFixed16(const uint16_t location, const float default_value) {
         uint8_t data[2];
-        eeprom_read_block(data,(uint8_t*)location,2);
+        readBlock(data,(uint8_t*)location,2);
         if (data[0] == 0xff && data[1] == 0xff) return default_value;
         return ((float)data[0]) + ((float)data[1])/256.0;
 }
@@ -154,7 +210,7 @@ void setEepromFixed16(const uint16_t location, const float new_value)
     uint8_t data[2];
     data[0] = (uint8_t)new_value;
     data[1] = (int)((new_value - data[0])*256.0);
-    eeprom_write_block(data,(uint8_t*)location,2);
+    writeBlock(data,(uint8_t*)location,2);
 }
 
 
@@ -162,7 +218,7 @@ void setEepromFixed16(const uint16_t location, const float new_value)
 int64_t getEepromInt64(const uint16_t location, const int64_t default_value) {
         int64_t *ret;
         uint8_t data[8];
-        eeprom_read_block(data,(const uint8_t*)location,8);
+        readBlock(data,(const uint8_t*)location,8);
         if (data[0] == 0xff && data[1] == 0xff && data[2] == 0xff && data[3] == 0xff &&
             data[4] == 0xff && data[5] == 0xff && data[6] == 0xff && data[7] == 0xff)
                  return default_value;
@@ -175,7 +231,125 @@ int64_t getEepromInt64(const uint16_t location, const int64_t default_value) {
 void setEepromInt64(const uint16_t location, const int64_t value) {
         void *data;
         data = (void *)&value;
-        eeprom_write_block(data,(void*)location,8);
+        writeBlock(data,(void*)location,8);
+}
+
+typedef char eeprom_queue_check[(EEPROM_QUEUE_LENGTH <= 128 &&
+				 !(EEPROM_QUEUE_LENGTH & (EEPROM_QUEUE_LENGTH - 1))) ? 1 : -1];
+
+#define QUEUE_MASK (EEPROM_QUEUE_LENGTH - 1)
+
+static struct {
+     uint16_t addr;
+     uint8_t data;
+} queue[EEPROM_QUEUE_LENGTH];
+
+// The interrupt takes from the tail, the main loop adds at the head
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+// Start writing the next queued byte which differs from the EEPROM's, or
+// stop the interrupt once there is none.  Called with interrupts off and
+// no write under way.
+static void step() {
+     while ( queue_tail != queue_head ) {
+	  uint8_t t = queue_tail;
+	  uint16_t addr = queue[t].addr;
+	  uint8_t data = queue[t].data;
+	  queue_tail = (t + 1) & QUEUE_MASK;
+
+	  EEAR = addr;
+	  EECR |= _BV(EERE);
+	  if ( EEDR != data ) {
+	       EEDR = data;
+	       EECR |= _BV(EEMPE);
+	       EECR |= _BV(EEPE);
+	       return;
+	  }
+     }
+     EECR &= ~_BV(EERIE);
+}
+
+ISR(EE_READY_vect) {
+     step();
+}
+
+// With interrupts off nothing takes bytes off the queue, so do it here
+static void poll() {
+     if ( !(SREG & _BV(SREG_I)) && !(EECR & _BV(EEPE)) )
+	  step();
+}
+
+void writeBlock(const void *src, void *dst, size_t n) {
+     const uint8_t *s = (const uint8_t *)src;
+     uint16_t addr = (uint16_t)dst;
+
+     while ( n ) {
+	  bool queued = false;
+	  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	       uint8_t h = queue_head;
+	       if ( ((h + 1) & QUEUE_MASK) != queue_tail ) {
+		    queue[h].addr = addr;
+		    queue[h].data = *s;
+		    queue_head = (h + 1) & QUEUE_MASK;
+		    EECR |= _BV(EERIE);
+		    queued = true;
+	       }
+	  }
+	  if ( queued ) {
+	       s++;
+	       addr++;
+	       n--;
+	  }
+	  else
+	       poll();
+     }
+}
+
+bool writeRoom(uint8_t n) {
+     return ((queue_tail - queue_head - 1) & QUEUE_MASK) >= n;
+}
+
+void readBlock(void *dst, const void *src, size_t n) {
+     uint8_t *d = (uint8_t *)dst;
+     uint16_t addr = (uint16_t)src;
+
+     // Hold the interrupt off, and let the write under way finish; the
+     // queue then stays as it is, and the registers are ours
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  EECR &= ~_BV(EERIE);
+     }
+     while ( EECR & _BV(EEPE) )
+	  ;
+
+     while ( n-- ) {
+	  // The last byte queued for an address is what it will hold
+	  bool queued = false;
+	  uint8_t v = 0;
+	  for (uint8_t i = queue_tail; i != queue_head; i = (i + 1) & QUEUE_MASK) {
+	       if ( queue[i].addr == addr ) {
+		    v = queue[i].data;
+		    queued = true;
+	       }
+	  }
+	  if ( !queued ) {
+	       EEAR = addr;
+	       EECR |= _BV(EERE);
+	       v = EEDR;
+	  }
+	  *d++ = v;
+	  addr++;
+     }
+
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  if ( queue_head != queue_tail )
+	       EECR |= _BV(EERIE);
+     }
+}
+
+void flushWrites() {
+     while ( queue_head != queue_tail || (EECR & _BV(EEPE)) )
+	  poll();
 }
 
 } // namespace eeprom
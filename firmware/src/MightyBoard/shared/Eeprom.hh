@@ -2,14 +2,52 @@
 #define EEPROM_HH
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifndef SIMULATOR
 #include <avr/pgmspace.h>
 #include "Configuration.hh"
 #endif
 
+// Bytes waiting to be written to the EEPROM; a power of two, no more than 128
+#ifndef EEPROM_QUEUE_LENGTH
+#define EEPROM_QUEUE_LENGTH 32
+#endif
+
 namespace eeprom {
 
+/// Settings which are read while running, kept in RAM so that reading one
+/// is a load.  loadSettings() copies them from the EEPROM at boot, and
+/// whatever writes one of them calls it again afterwards.
+typedef struct {
+	int16_t preheat_temp[3];	///< right, left and platform, in C
+	uint16_t retract_feedrate_a;	///< A's max speed change, in mm/s
+	uint8_t tool_count;
+	uint8_t hbp_present;
+	uint8_t override_gcode_temp;
+	uint8_t heat_during_pause;
+	uint8_t ditto_print;
+	uint8_t clear_for_estop;
+	uint8_t cooling_fan_duty;	///< percent
+#ifdef FAST_CANCEL
+	uint8_t fast_cancel;
+#endif
+#ifdef HEAT_WAIT_MOVES
+	uint8_t heat_wait_moves;
+#endif
+#ifdef PLATFORM_COOLDOWN
+	uint8_t release_temp;		///< C
+#endif
+#ifdef HAS_RGB_LED
+	uint8_t led_color;
+	bool heat_lights;
+#endif
+} Settings;
+
+extern Settings settings;
+
+void loadSettings();
+
 void init();
 
 #if defined(ERASE_EEPROM_ON_EVERY_BOOT) || defined(EEPROM_MENU_ENABLE)
@@ -30,6 +68,28 @@ void setEepromFixed16(const uint16_t location, const float new_value);
 int64_t getEepromInt64(const uint16_t location, const int64_t default_value);
 void setEepromInt64(const uint16_t location, const int64_t value);
 
+/// Writes to the EEPROM are queued and written from the EE_READY interrupt,
+/// so they return once their bytes are queued, or as soon as there is room
+/// for them.  Reads see the queued bytes.  These take the place of
+/// avr-libc's eeprom_read_* and eeprom_write_*, which would race the
+/// interrupt for the EEPROM's registers.
+void writeBlock(const void *src, void *dst, size_t n);
+void readBlock(void *dst, const void *src, size_t n);
+
+inline void writeByte(uint8_t *dst, uint8_t value) { writeBlock(&value, dst, 1); }
+inline void writeWord(uint16_t *dst, uint16_t value) { writeBlock(&value, dst, 2); }
+inline void writeDword(uint32_t *dst, uint32_t value) { writeBlock(&value, dst, 4); }
+
+inline uint8_t readByte(const uint8_t *src) { uint8_t v; readBlock(&v, src, 1); return v; }
+inline uint16_t readWord(const uint16_t *src) { uint16_t v; readBlock(&v, src, 2); return v; }
+inline uint32_t readDword(const uint32_t *src) { uint32_t v; readBlock(&v, src, 4); return v; }
+
+/// True if n bytes can be queued without waiting
+bool writeRoom(uint8_t n);
+
+/// Wait for the queued writes to be written
+void flushWrites();
+
 }
 
 #endif // EEPROM_HH
@@ -51,6 +51,10 @@ ExtruderBoard::ExtruderBoard(uint8_t slave_id_in, Pin HeaterPin_In, Pin FanPin_I
 void ExtruderBoard::disable(bool state) {
      is_disabled = state;
      extruder_heater.disable(state);
+#if !defined(USE_THERMOCOUPLE_DUAL)
+     // Don't leave chip select low on the shared pins
+     if ( state ) extruder_thermocouple.init();
+#endif
 }
 
 void ExtruderBoard::reset() {
@@ -68,7 +72,8 @@ void ExtruderBoard::reset() {
 void ExtruderBoard::runExtruderSlice() {
      if ( is_disabled )
 	  return;
-     extruder_heater.manage_temperature();
+     if ( !extruder_heater.isDisabled() )
+	  extruder_heater.manage_reading(extruder_thermocouple.update());
      coolingFan.manageCoolingFan();
 }
 
@@ -78,6 +78,11 @@ public:
      void setFan(uint8_t on);
 
      Heater& getExtruderHeater() { return extruder_heater; }
+
+#if !defined(USE_THERMOCOUPLE_DUAL)
+     /// True while this extruder's thermocouple is part way through a read
+     bool isSensorBusy() { return extruder_thermocouple.isBusy(); }
+#endif
 };
 
 #endif // MIGHTYBOARD_EXTRUDER_HH
@@ -23,6 +23,11 @@
 #include "Eeprom.hh"
 #include "EepromMap.hh"
 #include "Motherboard.hh"
+#include "HeaterLog.hh"
+#ifdef HEATER_FEED_FORWARD
+#include <avr/eeprom.h>
+#include <math.h>
+#endif
 
 /// Offset to compensate for range clipping and bleed-off
 #define HEATER_OFFSET_ADJUSTMENT 0
@@ -52,6 +57,17 @@ const int16_t HEAT_FAIL_CHECK_THRESHOLD = 30;
 /// to get to this temperature, the heater has already been checked.
 const int16_t HEAT_CHECKED_THRESHOLD = 50;
 
+#ifdef HEATER_RUNAWAY_MODEL
+/// Seconds over which the measured rise is compared with the model's
+const uint8_t RUNAWAY_WINDOW_SECONDS = 10;
+
+/// Degrees, plus half the rise expected, the measured rise may be off by
+const float RUNAWAY_MARGIN = 5.0;
+
+/// Windows in a row off the model before shutting off the heater
+const uint8_t RUNAWAY_WINDOWS = 3;
+#endif
+
 #if !defined(CLONE_R1)
 
 /// timeout for heating all the way up
@@ -67,9 +83,46 @@ const int16_t HEAT_CHECKED_THRESHOLD = 50;
 
 #endif
 
+/// Tell the interface this heater's temperatures have changed; the screen
+/// events for the heaters are in calibration_eeprom_offset order
+static void notifyInterface(uint8_t heater) {
+     Motherboard::getBoard().getInterfaceBoard().notify(1 << heater);
+}
+
 /// threshold above starting temperature we check for heating progres
 const int16_t HEAT_PROGRESS_THRESHOLD = 10;
 
+#ifdef HEATER_FEED_FORWARD
+
+/// A model tune needs to heat the heater by at least this much
+const int16_t TUNE_MIN_RISE = 40;
+
+/// The dead time runs until the temperature has risen by this much
+const int16_t TUNE_DEAD_RISE = 2;
+
+/// Give up on a model tune after this many tenths of a second
+const uint16_t TUNE_MAX_TENTHS = 9000;
+
+#endif
+
+#ifdef PID_AUTOTUNE
+
+/// The relay stays put for at least this many tenths of a second after
+/// switching, so that noise about the target doesn't switch it straight back
+const uint16_t AUTOTUNE_MIN_HALF = 50;
+
+/// An autotune fails if the heater gets this far over the target
+const int16_t AUTOTUNE_OVERSHOOT = 20;
+
+/// Give up on an autotune after this many tenths of a second
+const uint16_t AUTOTUNE_MAX_TENTHS = 36000;
+
+/// Limits on the relay's bias, so both levels keep some swing
+const uint8_t AUTOTUNE_BIAS_MIN = 20;
+const uint8_t AUTOTUNE_BIAS_MAX = 235;
+
+#endif
+
 #if defined(HAS_VIKI_INTERFACE) || defined(HAS_VIKI2_INTERFACE)
 
 #define VIKI_LED(x) viki_led(x)
@@ -107,6 +160,12 @@ void Heater::reset() {
      current_temperature = 0;
      startTemp = 0;
      paused_set_temperature = 0;
+#ifdef TOOLCHANGE_PREHEAT
+     heat_rate = HEAT_RATE_DEFAULT;
+#endif
+#ifdef HEATER_POWER_BUDGET
+     power_share = 255;
+#endif
 
      // Deviation from MBI: at this point, MBI's reset() just repeats
      // the exact same sequence of statements as are found in abort().
@@ -126,6 +185,9 @@ void Heater::abort() {
      newTargetReached = false;
      is_paused = false;
      is_disabled = false;
+#ifdef TOOLCHANGE_PREHEAT
+     rate_start_temp = 0;
+#endif
 
      float p = eeprom::getEepromFixed16(eeprom_base+pid_eeprom_offsets::P_TERM_OFFSET,DEFAULT_P);
      float i = eeprom::getEepromFixed16(eeprom_base+pid_eeprom_offsets::I_TERM_OFFSET,DEFAULT_I);
@@ -140,7 +202,19 @@ void Heater::abort() {
      pid.setDGain(d);
      pid.setTarget(0);
      VIKI_LED(false);
-     next_pid_timeout.start(UPDATE_INTERVAL_MICROS);
+
+     pid_period = 10000L * eeprom::getEeprom8(eeprom_offsets::HEATER_PERIODS + heater_period_offsets::PID +
+					      ((calibration_eeprom_offset == 2) ? heater_period_offsets::PLATFORM : 0), 0);
+     next_pid_timeout = Timeout();
+
+#ifdef HEATER_FEED_FORWARD
+     tune_state = HEATER_TUNE_IDLE;
+     loadModel();
+#endif
+
+#ifdef PID_AUTOTUNE
+     autotune_state = HEATER_TUNE_IDLE;
+#endif
 
      // Deviation from MBI
      // Seems like a bad idea: what happens when there's a value already there which isn't 0x00 nor 0xff??
@@ -173,6 +247,8 @@ void Heater::set_target_temperature(int16_t target_temp)
      else if ( target_temp < 0 )
 	  target_temp = 0;
 
+     notifyInterface(calibration_eeprom_offset);
+
      // Presently, MBI's code is broken when a new temp is set for
      // a paused heater.  In MBI's fw, the paused heater's temp is
      // changed to the new temp and thus the heater does not act
@@ -243,6 +319,18 @@ void Heater::set_target_temperature(int16_t target_temp)
 	       heatProgressTimer = Timeout();
 	  }
      }
+
+#ifdef TOOLCHANGE_PREHEAT
+     // Time the heat up if it's long enough to measure the rate over
+     if ( target_temp >= current_temperature + HEAT_RATE_MIN_RISE ) {
+	  uint8_t wrap;
+	  rate_start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	  rate_start_temp = current_temperature;
+     }
+     else
+	  rate_start_temp = 0;
+#endif
+
      pid.setTarget(target_temp);
 }
 
@@ -285,6 +373,15 @@ bool Heater::has_reached_target_temperature()
      return newTargetReached;
 }
 
+#ifdef TOOLCHANGE_PREHEAT
+uint16_t Heater::secondsToHeat(int16_t target) {
+     int16_t rise = target - current_temperature;
+     if ( rise <= TARGET_HYSTERESIS )
+	  return 0;
+     return (uint16_t)(((uint32_t)rise * 10 + heat_rate - 1) / heat_rate);
+}
+#endif
+
 bool Heater::isHeating(){
      return (pid.getTarget() > 0) && !has_reached_target_temperature() && !fail_state;
 }
@@ -299,12 +396,9 @@ int16_t Heater::getDelta(){
      return (int16_t)((target > temp) ? target - temp : temp - target);
 }
 
-void Heater::manage_temperature() {
-
-     if ( is_disabled )
-	  return;
+void Heater::manage_reading(TemperatureSensor::SensorState state) {
 
-     switch (sensor.update()) {
+     switch (state) {
      case TemperatureSensor::SS_ADC_BUSY:
      case TemperatureSensor::SS_ADC_WAITING:
 	  // We're waiting for the ADC, so don't update the temperature yet.
@@ -331,12 +425,19 @@ void Heater::manage_temperature() {
 	       fail_mode = HEATER_FAIL_NOT_PLUGGED_IN;
 	       fail();
 	  }
-	  current_temperature = BAD_TEMPERATURE + 1;
+	  if ( current_temperature != BAD_TEMPERATURE + 1 ) {
+	       current_temperature = BAD_TEMPERATURE + 1;
+	       notifyInterface(calibration_eeprom_offset);
+	  }
 	  return;
      }
 
      float fp_current_temp = sensor.getTemperature(); // + calibration_offset;
-     current_temperature = (int)(0.5 + fp_current_temp);
+     int16_t temp = (int)(0.5 + fp_current_temp);
+     if ( temp != current_temperature ) {
+	  current_temperature = temp;
+	  notifyInterface(calibration_eeprom_offset);
+     }
 
      if (!is_paused){
 	  uint8_t old_value_count = value_fail_count;
@@ -350,6 +451,15 @@ void Heater::manage_temperature() {
 		    return;
 	       }
 	  }
+#ifdef HEATER_RUNAWAY_MODEL
+	  // with a model, the heater is held to the rise it predicts rather
+	  // than to a fixed rise in a fixed time
+	  if ( modelValid() ) {
+	       if ( checkModel(fp_current_temp) )
+		    return;
+	  }
+	  else
+#endif
 	  // check that the heater is heating up after target is set
 	  if(!progressChecked){
 	       if(heatProgressTimer.hasElapsed()){
@@ -382,15 +492,64 @@ void Heater::manage_temperature() {
 	  if(value_fail_count == old_value_count)
 	       value_fail_count = 0;
      }
+
+#ifdef HEATER_LOG
+     heaterlog::record(calibration_eeprom_offset, pid.getTarget(), fp_current_temp, output);
+#endif
+
      if (fail_state) {
 	  return;
      }
 
-     next_pid_timeout.start(UPDATE_INTERVAL_MICROS);
+#ifdef TOOLCHANGE_PREHEAT
+     if ( rate_start_temp && current_temperature >= pid.getTarget() - TARGET_HYSTERESIS ) {
+	  uint8_t wrap;
+	  micros_t tenths = (Motherboard::getBoard().getCurrentCentaMicros(&wrap) - rate_start) / 1000;
+	  if ( tenths > 0 ) {
+	       uint32_t rate = (uint32_t)(current_temperature - rate_start_temp) * 100 / tenths;
+	       heat_rate = ( rate > 255 ) ? 255 : ( rate < 1 ) ? 1 : (uint8_t)rate;
+	  }
+	  rate_start_temp = 0;
+     }
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+     if ( tune_state == HEATER_TUNE_RUNNING ) {
+	  runModelTune();
+	  return;
+     }
+#endif
+
+#ifdef PID_AUTOTUNE
+     if ( autotune_state == HEATER_TUNE_RUNNING ) {
+	  runAutotune(fp_current_temp);
+	  return;
+     }
+#endif
+
+     // The readings are checked on every one, but the PID waits out its
+     // period, if it has one
+     if ( pid_period ) {
+	  if ( next_pid_timeout.isActive() && !next_pid_timeout.hasElapsed() )
+	       return;
+	  next_pid_timeout.start(pid_period);
+     }
 
      int delta = pid.getTarget() - current_temperature;
 
-     if ( bypassing_PID && (delta < PID_BYPASS_DELTA) ) {
+     bool leave_bypass = delta < PID_BYPASS_DELTA;
+#ifdef HEATER_FEED_FORWARD
+     if ( modelValid() ) {
+	  // Stay at full output until the heat already on its way, the dead
+	  // time's worth at the present rate of rise, will carry the heater
+	  // up to the target
+	  float rate = ((float)model.ambient + model.gain - fp_current_temp) / model.tau;
+	  leave_bypass = delta < TARGET_HYSTERESIS ||
+	       fp_current_temp + rate * model.dead * 0.1 >= pid.getTarget();
+     }
+#endif
+
+     if ( bypassing_PID && leave_bypass ) {
 	  bypassing_PID = false;
 	  pid.reset_state();
      }
@@ -404,6 +563,11 @@ void Heater::manage_temperature() {
 	  int mv = 0;
 	  if ( pid.getTarget() != 0 ) {
 	       mv = pid.calculate(fp_current_temp);
+#ifdef HEATER_FEED_FORWARD
+	       // The output the model says holds the target, so that the PID
+	       // only has to make up for the model's error
+	       mv += feedForward();
+#endif
 	       // offset value to compensate for heat bleed-off.
 	       // There are probably more elegant ways to do this,
 	       // but this works pretty well.
@@ -439,6 +603,9 @@ void Heater::Pause(bool on){
 	  // clear heatup timers
 	  heatingUpTimer = Timeout();
 	  heatProgressTimer = Timeout();
+#ifdef HEATER_RUNAWAY_MODEL
+	  runaway_readings = 0;
+#endif
 	  // clear reached target temperature
 	  newTargetReached = false;
 	  is_paused = true; // do after get_set_temperature()
@@ -449,15 +616,413 @@ void Heater::Pause(bool on){
      }
 }
 
+#ifdef HEATER_POWER_BUDGET
+
+void Heater::set_output(uint8_t value)
+{
+     bool changed = value != output;
+     output = value;
+     // Share the budget out again before the element draws any more
+     if ( changed )
+	  Motherboard::getBoard().sharePower();
+     applyOutput();
+}
+
+void Heater::setPowerShare(uint8_t share)
+{
+     if ( share == power_share )
+	  return;
+     power_share = share;
+     applyOutput();
+}
+
+void Heater::applyOutput()
+{
+     element.setHeatingElement(( power_share == 255 ) ? output :
+	  (uint8_t)(((uint16_t)output * (power_share + 1)) >> 8));
+}
+
+#else
+
 void Heater::set_output(uint8_t value)
 {
+     output = value;
      element.setHeatingElement(value);
 }
 
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+
+void Heater::loadModel() {
+     eeprom::readBlock(&model, (const void *)(eeprom_offsets::HEATER_MODEL_SETTINGS +
+	  calibration_eeprom_offset * sizeof(HeaterModel)), sizeof(HeaterModel));
+     ff_target = -1;
+#ifdef HEATER_RUNAWAY_MODEL
+     runaway_readings = 0;
+     runaway_windows = 0;
+#endif
+}
+
+uint8_t Heater::feedForward() {
+     if ( !modelValid() )
+	  return 0;
+     int16_t target = pid.getTarget();
+     if ( target != ff_target ) {
+	  int32_t out = 255L * (target - model.ambient) / model.gain;
+	  ff_output = ( out < 0 ) ? 0 : ( out > 255 ) ? 255 : (uint8_t)out;
+	  ff_target = target;
+     }
+     return ff_output;
+}
+
+#ifdef HEATER_RUNAWAY_MODEL
+
+// Called with each good reading while the heater has a model.  Over each
+// window the model gives the rise from the temperature at its start, for
+// the mean output over it, and the rise measured has to stay near that.
+// A heater falling short while it's driven is taken not to be heating,
+// a loose sensor or a dead element, and one rising past it a runaway, an
+// element that heats when it isn't driven.  Returns true if it failed.
+bool Heater::checkModel(float temp) {
+     uint8_t wrap;
+     micros_t now = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+     if ( runaway_readings == 0 ) {
+	  runaway_start = now;
+	  runaway_temp = temp;
+	  runaway_output = 0;
+	  runaway_last = output;
+	  runaway_readings = 1;
+	  return false;
+     }
+
+     // The output was set at the reading before and has held since
+     runaway_output += output;
+     runaway_readings++;
+     micros_t elapsed = now - runaway_start;
+     if ( elapsed < RUNAWAY_WINDOW_SECONDS * 10000UL )
+	  return false;
+
+     float dt = elapsed * 0.0001;
+     uint8_t mean = runaway_output / (runaway_readings - 1);
+     // For the dead time at the start of the window, the heater answers to
+     // the output of the window before
+     float dead = model.dead * 0.1;
+     if ( dead > dt )
+	  dead = dt;
+     float u = (runaway_last * dead + mean * (dt - dead)) / dt;
+     float expected = ((float)model.ambient + model.gain * u / 255.0 - runaway_temp) *
+	  (1.0 - exp(-dt / model.tau));
+     float error = temp - runaway_temp - expected;
+     float allowed = RUNAWAY_MARGIN + fabs(expected) * 0.5;
+
+     runaway_start = now;
+     runaway_temp = temp;
+     runaway_output = 0;
+     runaway_last = mean;
+     runaway_readings = 1;
+
+     HeaterFailMode mode;
+     if ( error > allowed )
+	  mode = HEATER_FAIL_RUNAWAY;
+     // Falling faster than the model cools, as under a fan, is no fault
+     else if ( expected > 0.0 && error < -allowed )
+	  mode = HEATER_FAIL_NOT_HEATING;
+     else {
+	  runaway_windows = 0;
+	  return false;
+     }
+     if ( ++runaway_windows < RUNAWAY_WINDOWS )
+	  return false;
+     fail_mode = mode;
+     fail();
+     return true;
+}
+
+#endif
+
+bool Heater::startModelTune(int16_t limit) {
+     int16_t maxtemp = (calibration_eeprom_offset == 2) ? MAX_HBP_TEMP : MAX_VALID_TEMP;
+     if ( limit > maxtemp )
+	  limit = maxtemp;
+     if ( fail_state || is_disabled || is_paused || current_temperature >= BAD_TEMPERATURE ||
+	  limit < current_temperature + TUNE_MIN_RISE )
+	  return false;
+#ifdef PID_AUTOTUNE
+     if ( autotune_state == HEATER_TUNE_RUNNING )
+	  return false;
+#endif
+
+     // The target keeps the heating up checks running during the tune
+     set_target_temperature(limit);
+     tune_limit = limit;
+     tune_ambient = current_temperature;
+     tune_dead = 0;
+     tune_half = 0;
+     uint8_t wrap;
+     tune_start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+     tune_state = HEATER_TUNE_RUNNING;
+     return true;
+}
+
+void Heater::abortTune() {
+     if ( tune_state != HEATER_TUNE_RUNNING )
+	  return;
+     tune_state = HEATER_TUNE_IDLE;
+     set_target_temperature(0);
+     set_output(0);
+}
+
+// Called in place of the PID while a model tune runs
+void Heater::runModelTune() {
+     // Someone else has taken the heater over
+     if ( is_paused || pid.getTarget() != tune_limit ) {
+	  tune_state = HEATER_TUNE_FAILED;
+	  return;
+     }
+
+     uint8_t wrap;
+     micros_t ticks = Motherboard::getBoard().getCurrentCentaMicros(&wrap) - tune_start;
+     uint16_t tenths = (uint16_t)(ticks / 1000);
+     int16_t rise = current_temperature - tune_ambient;
+
+     if ( !tune_dead && rise >= TUNE_DEAD_RISE )
+	  tune_dead = tenths;
+     if ( !tune_half && rise >= (tune_limit - tune_ambient) / 2 ) {
+	  tune_half = tenths;
+	  tune_half_temp = current_temperature;
+     }
+
+     if ( current_temperature >= tune_limit )
+	  finishModelTune(tenths);
+     else if ( tenths > TUNE_MAX_TENTHS ) {
+	  tune_state = HEATER_TUNE_FAILED;
+	  set_target_temperature(0);
+	  set_output(0);
+     }
+     else
+	  set_output(255);
+}
+
+// Fit the model to the times the heater took to rise half way and all the
+// way to the limit, after the dead time.  With x = exp(-t1 / tau) and
+// n = t2 / t1, the rises are r1 = K(1 - x) and r2 = K(1 - x^n), so r2 / r1 =
+// (1 - x^n) / (1 - x), which grows with x and is solved for it by bisection.
+void Heater::finishModelTune(uint16_t tenths) {
+     set_target_temperature(0);
+     set_output(0);
+     tune_state = HEATER_TUNE_FAILED;
+
+     float t1 = (tune_half - tune_dead) * 0.1;
+     float t2 = (tenths - tune_dead) * 0.1;
+     float r1 = tune_half_temp - tune_ambient;
+     float r2 = current_temperature - tune_ambient;
+     if ( !tune_dead || tune_half <= tune_dead || t2 <= t1 || r1 <= 0 )
+	  return;
+     float n = t2 / t1;
+     float q = r2 / r1;
+     // A straight line or worse, no curve to fit
+     if ( q <= 1.0 || q >= n )
+	  return;
+
+     float lo = 0.0, hi = 1.0, x = 0.5;
+     for ( uint8_t i = 0; i < 24; i++ ) {
+	  x = (lo + hi) * 0.5;
+	  if ( (1.0 - exp(n * log(x))) / (1.0 - x) < q ) lo = x;
+	  else hi = x;
+     }
+
+     float tau = -t1 / log(x);
+     float gain = r1 / (1.0 - x);
+     if ( tau < 1.0 || tau > 60000.0 || gain < 1.0 || gain > 60000.0 )
+	  return;
+
+     HeaterModel m;
+     m.gain = (uint16_t)(gain + 0.5);
+     m.tau = (uint16_t)(tau + 0.5);
+     m.dead = tune_dead;
+     m.ambient = tune_ambient;
+     eeprom::writeBlock(&m, (void *)(eeprom_offsets::HEATER_MODEL_SETTINGS +
+	  calibration_eeprom_offset * sizeof(HeaterModel)), sizeof(HeaterModel));
+     loadModel();
+     tune_state = HEATER_TUNE_DONE;
+}
+
+#endif
+
+#ifdef PID_AUTOTUNE
+
+float Heater::getPIDGain(uint16_t offset) {
+     return eeprom::getEepromFixed16(eeprom_base + offset, 0);
+}
+
+bool Heater::startAutotune(int16_t target, uint8_t cycles) {
+     int16_t maxtemp = (calibration_eeprom_offset == 2) ? MAX_HBP_TEMP : MAX_VALID_TEMP;
+     if ( fail_state || is_disabled || is_paused || current_temperature >= BAD_TEMPERATURE ||
+	  target > maxtemp - AUTOTUNE_OVERSHOOT || target <= current_temperature ||
+	  cycles < AUTOTUNE_MIN_CYCLES )
+	  return false;
+#ifdef HEATER_FEED_FORWARD
+     if ( tune_state == HEATER_TUNE_RUNNING )
+	  return false;
+#endif
+
+     // The target keeps the heating up checks running during the tune
+     set_target_temperature(target);
+     autotune_target = target;
+     autotune_cycles = cycles;
+     autotune_done = 0;
+     autotune_high = true;
+     autotune_bias = autotune_swing = 127;
+     autotune_max = autotune_min = current_temperature;
+     autotune_switched = 0;
+     autotune_on = 0;
+     autotune_samples = 0;
+     autotune_ku = autotune_tu = 0.0;
+     autotune_count = 0;
+     uint8_t wrap;
+     autotune_start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+     autotune_state = HEATER_TUNE_RUNNING;
+     return true;
+}
+
+void Heater::stopAutotune(uint8_t state) {
+     autotune_state = state;
+     set_target_temperature(0);
+     set_output(0);
+}
+
+void Heater::abortAutotune() {
+     if ( autotune_state == HEATER_TUNE_RUNNING )
+	  stopAutotune(HEATER_TUNE_IDLE);
+}
+
+// Called in place of the PID while an autotune runs.  The relay goes low
+// when the temperature rises through the target and high when it falls
+// back through it.  After each cycle the bias moves to even out the time
+// spent high and low, as heat lost at the target needs more than half
+// power to make up.
+void Heater::runAutotune(float temp) {
+     // Someone else has taken the heater over
+     if ( is_paused || pid.getTarget() != autotune_target ) {
+	  autotune_state = HEATER_TUNE_FAILED;
+	  return;
+     }
+
+     uint8_t wrap;
+     micros_t ticks = Motherboard::getBoard().getCurrentCentaMicros(&wrap) - autotune_start;
+     uint16_t tenths = (uint16_t)(ticks / 1000);
+     uint16_t half = tenths - autotune_switched;
+
+     autotune_samples++;
+     if ( temp > autotune_max ) autotune_max = temp;
+     if ( temp < autotune_min ) autotune_min = temp;
+
+     if ( temp > autotune_target + AUTOTUNE_OVERSHOOT || tenths > AUTOTUNE_MAX_TENTHS ) {
+	  stopAutotune(HEATER_TUNE_FAILED);
+	  return;
+     }
+
+     if ( autotune_high ) {
+	  if ( temp > autotune_target && half > AUTOTUNE_MIN_HALF ) {
+	       autotune_high = false;
+	       autotune_on = half;
+	       autotune_switched = tenths;
+	       autotune_max = temp;
+	  }
+     }
+     else if ( temp < autotune_target && half > AUTOTUNE_MIN_HALF ) {
+	  // A cycle ends.  The first is the heat up from cold and the second
+	  // runs with the first's guess at the bias, so neither is measured.
+	  if ( autotune_done >= 2 && autotune_max > autotune_min ) {
+	       // Ziegler-Nichols: a relay of amplitude d drives an oscillation of
+	       // amplitude a, from which the ultimate gain is 4d / (pi a)
+	       autotune_ku += (4.0 * autotune_swing) / (3.14159 * 0.5 * (autotune_max - autotune_min));
+	       autotune_tu += (autotune_on + half) * 0.1;
+	       autotune_count++;
+	  }
+	  if ( autotune_done >= 1 ) {
+	       int16_t bias = autotune_bias +
+		    (int16_t)(((int32_t)autotune_swing * ((int16_t)autotune_on - (int16_t)half)) /
+			      (autotune_on + half));
+	       if ( bias < AUTOTUNE_BIAS_MIN ) bias = AUTOTUNE_BIAS_MIN;
+	       else if ( bias > AUTOTUNE_BIAS_MAX ) bias = AUTOTUNE_BIAS_MAX;
+	       autotune_bias = (uint8_t)bias;
+	       autotune_swing = ( bias > 127 ) ? 255 - bias : bias;
+	  }
+	  autotune_high = true;
+	  autotune_switched = tenths;
+	  autotune_min = temp;
+	  if ( ++autotune_done >= autotune_cycles ) {
+	       finishAutotune(tenths);
+	       return;
+	  }
+     }
+
+     set_output(autotune_high ? autotune_bias + autotune_swing : autotune_bias - autotune_swing);
+}
+
+// Gains within the ranges the EEPROM map gives for them
+static float autotuneGain(float gain, float limit) {
+     return ( gain < 0.0 ) ? 0.0 : ( gain > limit ) ? limit : gain;
+}
+
+void Heater::finishAutotune(uint16_t tenths) {
+     stopAutotune(HEATER_TUNE_FAILED);
+     if ( !autotune_count || !autotune_samples )
+	  return;
+
+     // The classic Ziegler-Nichols PID
+     float ku = autotune_ku / autotune_count;
+     float tu = autotune_tu / autotune_count;
+     float kp = 0.6 * ku;
+     float ki = 2.0 * kp / tu;
+     float kd = kp * tu * 0.125;
+
+     // The PID works in readings rather than seconds, sums the error each
+     // reading, takes the change in the error over DELTA_SAMPLES readings
+     // and doubles its output.  The readings come as often as the sensor is
+     // sampled, which differs between boards, so the interval is measured.
+     float dt = tenths * 0.1 / autotune_samples;
+     // With a PID period, the PID runs on the first reading after it's up
+     float runs = ceil(pid_period * 1e-6 / dt);
+     if ( runs > 1 )
+	  dt *= runs;
+     float p = autotuneGain(kp * 0.5, 100.0);
+     float i = autotuneGain(ki * dt * 0.5, 1.0);
+     float d = autotuneGain(kd / (2.0 * DELTA_SAMPLES * dt), 100.0);
+
+     // With the accumulated error clamped, the I term can only get so big.
+     // The relay's bias has settled on the output which holds the target,
+     // and the I term has to be able to get there by itself, or the heater
+     // settles short of the target.
+     float i_min = autotune_bias / (2.0 * ERR_ACC_MAX);
+     if ( i < i_min )
+	  i = autotuneGain(i_min, 1.0);
+
+     eeprom::setEepromFixed16(eeprom_base + pid_eeprom_offsets::P_TERM_OFFSET, p);
+     eeprom::setEepromFixed16(eeprom_base + pid_eeprom_offsets::I_TERM_OFFSET, i);
+     eeprom::setEepromFixed16(eeprom_base + pid_eeprom_offsets::D_TERM_OFFSET, d);
+     pid.setPGain(p);
+     pid.setIGain(i);
+     pid.setDGain(d);
+     autotune_state = HEATER_TUNE_DONE;
+}
+
+#endif
+
 // mark as failed and report to motherboard for user messaging
 void Heater::fail()
 {
      fail_state = true;
+#ifdef HEATER_FEED_FORWARD
+     if ( tune_state == HEATER_TUNE_RUNNING )
+	  tune_state = HEATER_TUNE_FAILED;
+#endif
+#ifdef PID_AUTOTUNE
+     if ( autotune_state == HEATER_TUNE_RUNNING )
+	  autotune_state = HEATER_TUNE_FAILED;
+#endif
      set_target_temperature(0);
      set_output(0);
      Motherboard::getBoard().heaterFail(fail_mode, calibration_eeprom_offset);
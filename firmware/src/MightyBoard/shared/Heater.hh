@@ -42,13 +42,55 @@ const uint16_t Heater_Max_Temp[2] = {350,150};
 #define DEFAULT_I 0.325
 #define DEFAULT_D 36.0
 
+#ifdef TOOLCHANGE_PREHEAT
+/// Heat ups of HEAT_RATE_MIN_RISE degrees or more are timed, and the rate
+/// they rose at is what secondsToHeat() goes by.  Until one has been timed
+/// the heater is taken to rise at HEAT_RATE_DEFAULT tenths of a degree a
+/// second
+#define HEAT_RATE_MIN_RISE 20
+#define HEAT_RATE_DEFAULT 15
+#endif
+
+#ifdef PID_AUTOTUNE
+/// Relay cycles an autotune runs unless told otherwise, and the fewest it
+/// can run: the first two cycles aren't measured
+#define AUTOTUNE_CYCLES 5
+#define AUTOTUNE_MIN_CYCLES 3
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+/// First order plus dead time model of a heater, identified by
+/// Heater::startModelTune() and kept in EEPROM at HEATER_MODEL_SETTINGS.
+/// 0xffff for the gain means the heater hasn't been identified.
+typedef struct {
+	uint16_t gain;		///< Rise over ambient at full output, degrees C
+	uint16_t tau;		///< Time constant, seconds
+	uint16_t dead;		///< Dead time, tenths of a second
+	int16_t ambient;	///< Temperature the model was identified from, degrees C
+} HeaterModel;
+#endif
+
+#if defined(HEATER_RUNAWAY_MODEL) && !defined(HEATER_FEED_FORWARD)
+#error "HEATER_RUNAWAY_MODEL needs HEATER_FEED_FORWARD"
+#endif
+
+#if defined(HEATER_FEED_FORWARD) || defined(PID_AUTOTUNE)
+enum HeaterTuneState {
+	HEATER_TUNE_IDLE = 0,
+	HEATER_TUNE_RUNNING = 1,
+	HEATER_TUNE_DONE = 2,
+	HEATER_TUNE_FAILED = 3
+};
+#endif
+
 enum HeaterFailMode{
 	HEATER_FAIL_NONE = 0,
 	HEATER_FAIL_NOT_PLUGGED_IN = 0x02,
 	HEATER_FAIL_SOFTWARE_CUTOFF = 0x04,
 	HEATER_FAIL_NOT_HEATING = 0x08,
 	HEATER_FAIL_DROPPING_TEMP = 0x10,
-	HEATER_FAIL_BAD_READS = 0x20
+	HEATER_FAIL_BAD_READS = 0x20,
+	HEATER_FAIL_RUNAWAY = 0x40	///< Heating well past what the model expects for the output
 };
 
 
@@ -66,6 +108,7 @@ class Heater
     HeatingElement& element;            ///< Heating element used to produce an output
     Timeout next_pid_timeout;           ///< Timeout timer for PID loop (should be slower
                                         ///< or the same speed as sensor timeout)
+    micros_t pid_period;                ///< From HEATER_PERIODS, 0 to run the PID on every reading
     volatile int16_t current_temperature;       ///< Last known temperature reading
     int16_t startTemp;		///< start temperature when new target is set.  used to assess heating up progress
     int16_t paused_set_temperature;		///< we record the set temperature when a heater is "paused"
@@ -75,6 +118,12 @@ class Heater
 
     PID pid;                            ///< PID controller instance
     bool bypassing_PID;                 ///< True if the heater is in full on
+    uint8_t output;                     ///< Last value given to the heating element
+#ifdef HEATER_POWER_BUDGET
+    uint8_t power_share;                ///< The element gets output * (power_share + 1) / 256
+
+    void applyOutput();
+#endif
 
     bool fail_state;                    ///< True if the heater has detected a hardware
                                         ///< failure and is shut down.
@@ -97,10 +146,65 @@ class Heater
     uint8_t calibration_eeprom_offset; //axis offset in HEATER_CALIBRATE
     //int8_t  calibration_offset;   // temperature offset for this heater in degrees C
 
-    /// This is the interval between PID calculations.  It doesn't make sense for
-    /// this to be fast (<1 sec) because of the long system delay between heater
-    /// and sensor.
-    const static micros_t UPDATE_INTERVAL_MICROS = 500L * 1000L;
+#ifdef TOOLCHANGE_PREHEAT
+    uint8_t heat_rate;                  ///< Tenths of a degree a second, of the last timed heat up
+    int16_t rate_start_temp;            ///< Temperature the heat up being timed started at, 0 for none
+    micros_t rate_start;                ///< getCurrentCentaMicros() when it started
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+    HeaterModel model;                  ///< Model from EEPROM
+    int16_t ff_target;                  ///< Target ff_output was worked out for
+    uint8_t ff_output;                  ///< Output which holds ff_target, by the model
+
+    uint8_t tune_state;                 ///< HeaterTuneState
+    int16_t tune_limit;                 ///< The tune heats at full output up to this
+    int16_t tune_ambient;               ///< Temperature the tune started from
+    uint16_t tune_dead;                 ///< Tenths of a second until the first rise
+    uint16_t tune_half;                 ///< Tenths of a second until half way
+    int16_t tune_half_temp;             ///< Temperature at tune_half
+    micros_t tune_start;                ///< getCurrentCentaMicros() at the start
+
+    void loadModel();
+    bool modelValid() { return model.gain != 0xffff && model.gain != 0 && model.tau != 0; }
+    uint8_t feedForward();
+    void runModelTune();
+    void finishModelTune(uint16_t tenths);
+#endif
+
+#ifdef HEATER_RUNAWAY_MODEL
+    uint16_t runaway_readings;          ///< Readings in the present window, 0 before it starts
+    micros_t runaway_start;             ///< getCurrentCentaMicros() at the start of the window
+    float runaway_temp;                 ///< Temperature at the start of the window
+    uint32_t runaway_output;            ///< Sum of the output over the window's readings
+    uint8_t runaway_last;               ///< Mean output over the window before
+    uint8_t runaway_windows;            ///< Windows in a row the heater has been off the model
+
+    bool checkModel(float temp);
+#endif
+
+#ifdef PID_AUTOTUNE
+    uint8_t autotune_state;             ///< HeaterTuneState
+    uint8_t autotune_cycles;            ///< Relay cycles to run
+    uint8_t autotune_done;              ///< Relay cycles run so far
+    bool autotune_high;                 ///< The relay is at bias + swing
+    uint8_t autotune_bias;              ///< The relay switches between bias +/- swing
+    uint8_t autotune_swing;
+    int16_t autotune_target;            ///< Temperature the relay switches about
+    float autotune_max;                 ///< Highest temperature since switching low
+    float autotune_min;                 ///< Lowest temperature since switching high
+    uint16_t autotune_switched;         ///< Tenths of a second at the last switch
+    uint16_t autotune_on;               ///< Tenths of a second spent high last cycle
+    uint16_t autotune_samples;          ///< Readings during the tune
+    float autotune_ku;                  ///< Sums of the ultimate gain and period
+    float autotune_tu;                  ///< of the cycles measured
+    uint8_t autotune_count;             ///< Cycles in autotune_ku and autotune_tu
+    micros_t autotune_start;            ///< getCurrentCentaMicros() at the start
+
+    void runAutotune(float temp);
+    void finishAutotune(uint16_t tenths);
+    void stopAutotune(uint8_t state);
+#endif
 
     /// Put the heater into a failure state, ensuring that the heating element is
     /// disabled.
@@ -141,12 +245,29 @@ class Heater
     bool has_failed() { return fail_state; }
 
     /// Run the heater management loop. This must be called periodically
-    void manage_temperature();
+    void manage_temperature() { if ( !is_disabled ) manage_reading(sensor.update()); }
+
+    /// Run the heater management loop on a reading the owner of the sensor
+    /// has just taken from it, with the state update() returned.  The
+    /// sensor's class is known where it's a member, so its update() is
+    /// called directly rather than through the TemperatureSensor interface.
+    /// A disabled heater's sensor isn't to be read.
+    void manage_reading(TemperatureSensor::SensorState state);
 
     /// Change the setpoint temperature
     /// \param value New setpoint temperature, in degrees Celcius.
     void set_output(uint8_t value);
 
+    /// Get the last value given to the heating element, 0-255
+    uint8_t get_output() { return output; }
+
+#ifdef HEATER_POWER_BUDGET
+    /// Scale the heating element's output to fit the power budget.  The
+    /// output asked for, which get_output() returns, is left as it is.
+    /// \param[in] share The element gets (share + 1) / 256 of the output
+    void setPowerShare(uint8_t share);
+#endif
+
     /// Reset the heater to a to board-on state
     void reset();
 
@@ -190,6 +311,56 @@ class Heater
 
     bool isDisabled(){return is_disabled;}
 
+#ifdef TOOLCHANGE_PREHEAT
+    /// Estimate how long heating from the present temperature up to target
+    /// takes, at the rate of the last timed heat up
+    /// \param[in] target Temperature to heat to, in degrees Celcius
+    /// \return seconds, 0 if the heater is there already
+    uint16_t secondsToHeat(int16_t target);
+#endif
+
+#ifdef HEATER_FEED_FORWARD
+    /// Identify the heater's model: heat at full output from the present
+    /// temperature up to limit, then work the model out from the response
+    /// and save it to EEPROM.  The heater is left off when it's done.
+    /// \param[in] limit Temperature to stop at, in degrees Celcius
+    /// \return false if the heater can't be tuned now
+    bool startModelTune(int16_t limit);
+
+    /// Stop a tune, turning the heater off
+    void abortTune();
+
+    /// \return a HeaterTuneState
+    uint8_t getTuneState() { return tune_state; }
+
+    const HeaterModel& getModel() { return model; }
+#endif
+
+#ifdef PID_AUTOTUNE
+    /// Tune the PID by relay feedback: switch the output between two levels
+    /// about target for a number of cycles, and work the gains out from the
+    /// period and height of the oscillation.  The gains are saved to EEPROM
+    /// and used from then on; the heater is left off when it's done.
+    /// \param[in] target Temperature to oscillate about, in degrees Celcius
+    /// \param[in] cycles Number of cycles to run, at least #AUTOTUNE_MIN_CYCLES
+    /// \return false if the heater can't be tuned now
+    bool startAutotune(int16_t target, uint8_t cycles);
+
+    /// Stop an autotune, turning the heater off
+    void abortAutotune();
+
+    /// \return a HeaterTuneState
+    uint8_t getAutotuneState() { return autotune_state; }
+
+    /// \return the number of relay cycles run so far
+    uint8_t getAutotuneCycles() { return autotune_done; }
+
+    /// Get a PID gain as it is stored in EEPROM
+    /// \param[in] offset One of the pid_eeprom_offsets
+    /// \return the gain, or 0 if none is stored
+    float getPIDGain(uint16_t offset);
+#endif
+
 #if defined(HAS_VIKI_INTERFACE)
      void viki_led(bool state);
 #endif
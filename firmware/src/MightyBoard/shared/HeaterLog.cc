@@ -0,0 +1,91 @@
+/*
+ *  Ring of heater samples for tuning off line, read back over the host
+ *  interface.
+ */
+
+#include "Compat.hh"
+#include "HeaterLog.hh"
+
+#ifdef HEATER_LOG
+
+#include "Motherboard.hh"
+#include <string.h>
+
+namespace heaterlog {
+
+// A sample's slot is its sequence number modulo the size, which only stays
+// put across a wrap of the sequence numbers for a power of two
+#if (HEATER_LOG_SAMPLES & (HEATER_LOG_SAMPLES - 1)) != 0 || HEATER_LOG_SAMPLES > 0x8000
+#error HEATER_LOG_SAMPLES must be a power of two, no more than 32768
+#endif
+
+static HeaterSample samples[HEATER_LOG_SAMPLES];
+
+static uint16_t next = 0;		///< Sequence number of the next sample
+static uint16_t held = 0;		///< Samples held, up to HEATER_LOG_SAMPLES
+static uint8_t logging = 0;		///< Bit mask of the heaters being logged
+static uint16_t log_interval;		///< Tenths of a second between samples
+static micros_t log_start;
+static uint16_t last_sample[HEATER_LOG_HEATERS];
+static uint8_t sampled;			///< Heaters with a sample at last_sample
+
+static uint16_t now() {
+	uint8_t wrap;
+	return (uint16_t)((Motherboard::getBoard().getCurrentCentaMicros(&wrap) - log_start) / 1000L);
+}
+
+void start(uint8_t heaters, uint16_t interval) {
+	uint8_t wrap;
+	log_start = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+	log_interval = interval;
+	next = 0;
+	held = 0;
+	sampled = 0;
+	logging = heaters & ((1 << HEATER_LOG_HEATERS) - 1);
+}
+
+void stop() {
+	logging = 0;
+}
+
+bool isRunning() {
+	return logging != 0;
+}
+
+void record(uint8_t heater, int16_t setpoint, float reading, uint8_t output) {
+	if ( heater >= HEATER_LOG_HEATERS || !(logging & (1 << heater)) ) return;
+
+	uint16_t time = now();
+	uint8_t bit = 1 << heater;
+	if ( (sampled & bit) && (uint16_t)(time - last_sample[heater]) < log_interval ) return;
+	last_sample[heater] = time;
+	sampled |= bit;
+
+	HeaterSample *s = &samples[next % HEATER_LOG_SAMPLES];
+	s->time = time;
+	s->setpoint = setpoint;
+	s->reading = (int16_t)(reading * 16.0);
+	s->heater = heater;
+	s->output = output;
+
+	next ++;
+	if ( held < HEATER_LOG_SAMPLES ) held ++;
+}
+
+uint16_t getNext() {
+	return next;
+}
+
+uint16_t getOldest() {
+	return next - held;
+}
+
+bool getSample(uint16_t seq, HeaterSample *sample) {
+	if ( (uint16_t)(next - 1 - seq) >= held ) return false;
+	memcpy(sample, &samples[seq % HEATER_LOG_SAMPLES], sizeof(HeaterSample));
+	return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef __HEATER_LOG_HH__
+#define __HEATER_LOG_HH__
+
+#include <stdint.h>
+#include "Configuration.hh"
+
+// A ring of heater samples, taken by the heaters themselves as they read
+// their sensors, so a warm-up can be captured without the host polling and
+// read back afterwards with HOST_CMD_HEATER_LOG.  Once it's full the oldest
+// samples are overwritten.
+
+#ifdef HEATER_LOG
+
+// 8 bytes each; a power of two
+#ifndef HEATER_LOG_SAMPLES
+#define HEATER_LOG_SAMPLES	128
+#endif
+
+// Heaters, as the host commands number them: 0 and 1 the tools, 2 the platform
+#define HEATER_LOG_HEATERS	3
+
+namespace heaterlog {
+
+typedef struct {
+	uint16_t time;		///< Tenths of a second since the log started
+	int16_t setpoint;	///< Degrees C
+	int16_t reading;	///< Sixteenths of a degree C
+	uint8_t heater;
+	uint8_t output;		///< Output in effect when the reading was taken, 0-255
+} HeaterSample;
+
+/// Clear the log and start logging the heaters in the bit mask heaters
+/// (bit 0 tool 0, bit 1 tool 1, bit 2 the platform), a sample of each at
+/// most every interval tenths of a second; 0 logs every reading
+void start(uint8_t heaters, uint16_t interval);
+
+/// Stop logging, keeping the samples
+void stop();
+
+bool isRunning();
+
+/// Called by the heaters with each reading
+void record(uint8_t heater, int16_t setpoint, float reading, uint8_t output);
+
+/// Sequence number of the next sample to be logged; it counts from 0 at the
+/// start and wraps
+uint16_t getNext();
+
+/// Sequence number of the oldest sample held
+uint16_t getOldest();
+
+/// Copy sample seq, returns false if it isn't held
+bool getSample(uint16_t seq, HeaterSample *sample);
+
+}
+
+#endif
+
+#endif
@@ -76,6 +76,10 @@ micros_t getUpdateRate() {
         return board->getUpdateRate();
 }
 
+uint8_t getUpdateEvents() {
+        return board->getUpdateEvents();
+}
+
 void doUpdate() {
         board->doUpdate();
 }
@@ -69,6 +69,10 @@ void doUpdate();
 /// much impact.
 micros_t getUpdateRate();
 
+/// The SCREEN_EVENT_ bits the current screen's update() is for, or 0 when
+/// it is a refresh or redraw.  See Screen::getUpdateEvents().
+uint8_t getUpdateEvents();
+
 /// Set Interface board LEDS
 void setLEDs(bool on);
 
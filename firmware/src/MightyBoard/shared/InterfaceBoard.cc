@@ -6,6 +6,9 @@
 #include "Timeout.hh"
 #include "Command.hh"
 #include "Motherboard.hh"
+#include "StepperAccelPlanner.hh"
+#include "Eeprom.hh"
+#include "EepromMap.hh"
 
 #if defined HAS_INTERFACE_BOARD
 
@@ -19,7 +22,11 @@ InterfaceBoard::InterfaceBoard(ButtonArray& buttons_in,
 	                       Screen* buildFinishedScreen_in) :
         lcd(lcd_in),
         buttons(buttons_in),
-	waitingMask(0)
+	waitingMask(0),
+	pendingEvents(0),
+	updateEvents(0),
+	throttled(false),
+	scanPasses(0)
 {
         buildScreen = buildScreen_in;
         mainScreen = mainScreen_in;
@@ -43,6 +50,8 @@ void InterfaceBoard::init() {
     screen_locked = false;
     buttonRepetitions = 0;
     lockoutButtonRepetitionsClear = false;
+    printPriority = 0 != eeprom::getEeprom8(eeprom_offsets::UI_PRINT_PRIORITY,
+					    DEFAULT_UI_PRINT_PRIORITY);
 
 #if defined(INTERFACE_LED_PORT) && defined(INTERFACE_DDR) && defined(INTERFACE_LED)
     INTERFACE_DDR |= INTERFACE_LED;
@@ -93,7 +102,22 @@ void InterfaceBoard::setCoolingFanIndicator(bool on) {
 }
 #endif
 
+// Slow down while the planner is short of moves and there are commands
+// which could refill it, and stay slowed down until it's well filled again
+void InterfaceBoard::updateThrottle() {
+     if ( ! printPriority || command::isEmpty() || command::isPaused() )
+	  throttled = false;
+     else if ( throttled )
+	  throttled = movesplanned() < UI_RESUME_MOVES;
+     else
+	  throttled = movesplanned() < UI_THROTTLE_MOVES;
+}
+
 void InterfaceBoard::doInterrupt() {
+     updateThrottle();
+     if ( throttled && ++scanPasses < UI_THROTTLE_SCAN_PASSES )
+	  return;
+     scanPasses = 0;
      buttons.scanButtons();
 }
 
@@ -104,7 +128,8 @@ bool InterfaceBoard::isButtonPressed(ButtonArray::ButtonName button) {
 }
 
 micros_t InterfaceBoard::getUpdateRate() {
-	return screenStack[screenIndex]->getUpdateRate();
+	micros_t rate = screenStack[screenIndex]->getUpdateRate();
+	return throttled ? rate << UI_THROTTLE_SHIFT : rate;
 }
 
 /// push Error Message Screen
@@ -181,9 +206,11 @@ void InterfaceBoard::doUpdate() {
 	}
 
     bool forceRedraw = false;
+    bool buttonPressed = false;
     static ButtonArray::ButtonName button;
     if(!screen_locked){
         if (buttons.getButton(button)) {
+	    buttonPressed = true;
 	    if((((1<<button) & waitingMask) != 0) &&
                       (!(screenStack[screenIndex]->optionsMask & IS_CANCEL_SCREEN_MASK))){
                  waitingMask = 0;
@@ -221,8 +248,23 @@ void InterfaceBoard::doUpdate() {
 	    lockoutButtonRepetitionsClear = false;
         }
 
-        // update build data
-        screenStack[screenIndex]->update(lcd, forceRedraw);
+        // update build data, for a screen which is updated on events only
+        // when one it shows was raised or it's due a refresh
+        Screen *screen = screenStack[screenIndex];
+        uint8_t events = screen->getUpdateEvents();
+        bool refresh = refreshTimeout.hasElapsed() || ! refreshTimeout.isActive();
+        if ( events == 0 || forceRedraw || buttonPressed || refresh ||
+             (pendingEvents & events) ) {
+             // Only an update for events alone draws just what they changed
+             if ( refresh || forceRedraw || buttonPressed ) {
+                  events = 0;
+                  refreshTimeout.start(SCREEN_REFRESH_MS * 1000L);
+             }
+             updateEvents = pendingEvents & events;
+             pendingEvents = 0;
+             screen->update(lcd, forceRedraw);
+             updateEvents = 0;
+        }
     }
 }
 
@@ -33,6 +33,31 @@
 /// Maximum number of screens that can be active at once.
 #define SCREEN_STACK_DEPTH      7
 
+/// Longest a screen which is updated on events goes without an update
+#ifndef SCREEN_REFRESH_MS
+#define SCREEN_REFRESH_MS       500
+#endif
+
+/// Print priority: the interface slows down when the planner has fewer
+/// moves than UI_THROTTLE_MOVES and commands are waiting, and speeds up
+/// again once it has UI_RESUME_MOVES
+#ifndef UI_THROTTLE_MOVES
+#define UI_THROTTLE_MOVES       (BLOCK_BUFFER_SIZE >> 1)
+#endif
+#ifndef UI_RESUME_MOVES
+#define UI_RESUME_MOVES         ((BLOCK_BUFFER_SIZE * 3) >> 2)
+#endif
+
+/// While slowed down, screens are updated at 1 << UI_THROTTLE_SHIFT times
+/// their period and the buttons are scanned every UI_THROTTLE_SCAN_PASSES
+/// passes of the main loop
+#ifndef UI_THROTTLE_SHIFT
+#define UI_THROTTLE_SHIFT       2
+#endif
+#ifndef UI_THROTTLE_SCAN_PASSES
+#define UI_THROTTLE_SCAN_PASSES 4
+#endif
+
 
 /// The InterfaceBoard module provides support for the MakerBot Industries
 /// Gen4 Interface Board. It could very likely be adopted to support other
@@ -73,6 +98,16 @@ private:
 
 	bool lockoutButtonRepetitionsClear; /// Used to lockout the clearing of buttonRepetitions
 
+	uint8_t pendingEvents;		/// SCREEN_EVENT_ bits raised since the screen was last updated
+	uint8_t updateEvents;		/// Those the screen is being updated for
+	Timeout refreshTimeout;		/// Runs until a screen updated on events is due a refresh
+
+	bool printPriority;		/// Print priority is turned on
+	bool throttled;			/// The interface is slowed down for the planner
+	uint8_t scanPasses;		/// Passes since the buttons were last scanned
+
+	void updateThrottle();
+
 public:
         /// Construct an interface board.
         /// \param[in] button array to read from
@@ -116,8 +151,17 @@ public:
 
 	micros_t getUpdateRate();
 
+	/// Turn print priority on or off
+	void setPrintPriority(bool on) { printPriority = on; }
+
 	void doUpdate();
 
+	/// Note a change which screens may show, SCREEN_EVENT_ bits
+	void notify(uint8_t events) { pendingEvents |= events; }
+
+	/// The events the current update() is for, or 0 if it's a refresh
+	uint8_t getUpdateEvents() { return updateEvents; }
+
 	void showMonitorMode();
 
 	/// Tell the interface board that the system is waiting for a button push
@@ -36,6 +36,9 @@
 #include <math.h>
 #include <util/delay.h>
 #include "TWI.hh"
+#ifdef LOCALE_PACKED
+#include "locale.hh"
+#endif
 
 // When the display powers up, it is configured as follows:
 //
@@ -56,8 +59,10 @@
 // can't assume that its in that state when a sketch starts (and the
 // LiquidCrystal constructor is called).
 
-// Nothing to construct
-LiquidCrystalSerial::LiquidCrystalSerial() {}
+// row_offsets in flush() covers four rows, and _dirty a bit per column
+typedef char lcd_shadow_size_check[(LCD_SCREEN_HEIGHT <= 4 && LCD_SCREEN_WIDTH <= 32) ? 1 : -1];
+
+LiquidCrystalSerial::LiquidCrystalSerial() : _lcd_address(0xff) {}
 
 // Initialization of a standard HD44780 display
 void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
@@ -111,16 +116,19 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 
   display();
 
-  // clear it off
-  clear();
+  // clear it off, and the copy of it with it
+  command(LCD_CLEARDISPLAY);
+  _delay_us(2000);
+  memset(_shadow, ' ', sizeof(_shadow));
+  memset(_dirty, 0, sizeof(_dirty));
 
   // Initialize to default text direction (for romance languages)
   _displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
   // set the entry mode
   command(LCD_ENTRYMODESET | _displaymode);
 
-  // program special characters
-  uint8_t down[8] = { 0x00,   // 0000000
+  // program special characters, from flash
+  static const uint8_t down[8] PROGMEM = { 0x00,   // 0000000
                       0x00,   // 0000000
                       0x00,   // 0000000
                       0x00,   // 0000000
@@ -129,7 +137,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
                       0x08,   // 0001000
                       0x00 }; // 0000000
 
-  uint8_t folder_in[8] = { 0x08, // 01000
+  static const uint8_t folder_in[8] PROGMEM = { 0x08, // 01000
                            0x0C, // 01100
                            0x0E, // 01110
                            0x0F, // 01111
@@ -139,7 +147,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
                            0x00  // 00000
   };
 
-  uint8_t folder_out[8] = { 0x04, // 00100
+  static const uint8_t folder_out[8] PROGMEM = { 0x04, // 00100
                             0x0C, // 01100
                             0x1F, // 11111
                             0x0D, // 01101
@@ -153,7 +161,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
     //Custom extruder / platform heating and arrow
     //characters (Courtesy of Erwin Ried)
 
-    uint8_t extruder_normal[8] = {
+    static const uint8_t extruder_normal[8] PROGMEM = {
 	    0x11,	//10001
 	    0x1F,	//11111
 	    0x0A,	//01010
@@ -163,7 +171,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 	    0x04,	//00100
 	    0x00};	//00000
 
-    uint8_t extruder_heating[8] = {
+    static const uint8_t extruder_heating[8] PROGMEM = {
 	    0x11,	//10001
 	    0x1F,	//11111
 	    0x0E,	//01110
@@ -173,7 +181,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 	    0x04,	//00100
 	    0x00};	//00000
 
-    uint8_t platform_normal[8] = {
+    static const uint8_t platform_normal[8] PROGMEM = {
 	    0x12,	//10010
 	    0x09,	//01001
 	    0x12,	//10010
@@ -183,7 +191,7 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 	    0x11,	//10001
 	    0x00};	//00000
 
-    uint8_t platform_heating[8] = {
+    static const uint8_t platform_heating[8] PROGMEM = {
 	    0x12,	//10010
 	    0x09,	//01001
 	    0x12,	//10010
@@ -205,9 +213,18 @@ void LiquidCrystalSerial::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 }
 
 /********** high level commands, for the user! */
+// Blanks the copy of the screen; flush() then only has to blank the cells
+// which weren't already, and doesn't wait out LCD_CLEARDISPLAY
 void LiquidCrystalSerial::clear() {
-  command(LCD_CLEARDISPLAY); // clear display, set cursor position to zero
-  _delay_us(2000);           // this command takes a long time!
+  for (uint8_t row = 0; row < LCD_SCREEN_HEIGHT; row++) {
+    for (uint8_t col = 0; col < LCD_SCREEN_WIDTH; col++) {
+      if (_shadow[row][col] != ' ') {
+        _shadow[row][col] = ' ';
+        _dirty[row] |= 1UL << col;
+      }
+    }
+  }
+  setCursor(0, 0);
 }
 
 void LiquidCrystalSerial::home() {
@@ -228,14 +245,14 @@ void LiquidCrystalSerial::clearHomeCursor() {
   setCursor(0, 0);
 }
 
+// Only moves the cursor in the copy of the screen; flush() addresses the
+// display itself
 void LiquidCrystalSerial::setCursor(uint8_t col, uint8_t row) {
-  int row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
-  if (row > _numlines) {
+  if (row >= _numlines) {
     row = _numlines - 1; // we count rows starting w/0
   }
 
   _xcursor = col; _ycursor = row;
-  command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
 }
 
 // If col or row = -1, then the current position is retained
@@ -308,8 +325,8 @@ void LiquidCrystalSerial::noAutoscroll(void) {
 }
 
 // Allows us to fill the first 8 CGRAM locations
-// with custom characters
-void LiquidCrystalSerial::createChar(uint8_t location, uint8_t charmap[]) {
+// with custom characters, whose maps are in flash
+void LiquidCrystalSerial::createChar(uint8_t location, const uint8_t charmap[]) {
   location &= 0x7; // we only have 8 locations 0-7
   uint8_t cmd = LCD_SETCGRAMADDR | (location << 3);
 
@@ -317,24 +334,74 @@ void LiquidCrystalSerial::createChar(uint8_t location, uint8_t charmap[]) {
   for(uint8_t j = 2; j; j--)
   {
     command(cmd);
-    uint8_t *map = charmap;
+    const uint8_t *map = charmap;
     for (int i = 8; i; i--) {
-      write(*map++);
+      // Straight to CGRAM, past the copy of the screen
+      send(pgm_read_byte(map++), true);
     }
   }
 }
 
 /*********** mid level commands, for sending data/cmds */
 
-void LiquidCrystalSerial::command(uint8_t value) { send(value, false); }
+void LiquidCrystalSerial::command(uint8_t value) {
+  send(value, false);
+  _lcd_address = 0xff;
+}
 
-inline void LiquidCrystalSerial::write(uint8_t value) {
-  send(value, true);
+void LiquidCrystalSerial::write(uint8_t value) {
+  if (_ycursor < LCD_SCREEN_HEIGHT && _xcursor < LCD_SCREEN_WIDTH &&
+      _shadow[_ycursor][_xcursor] != value) {
+    _shadow[_ycursor][_xcursor] = value;
+    _dirty[_ycursor] |= 1UL << _xcursor;
+  }
   _xcursor++;
   if (_xcursor >= _numCols)
     setCursor(0, _ycursor + 1);
 }
 
+bool LiquidCrystalSerial::flush(uint8_t bytes) {
+  static const uint8_t row_offsets[] PROGMEM = { 0x00, 0x40, 0x14, 0x54 };
+
+  for (uint8_t row = 0; row < LCD_SCREEN_HEIGHT; row++) {
+    uint32_t bit = 1;
+    for (uint8_t col = 0; _dirty[row]; col++, bit <<= 1) {
+      if (!(_dirty[row] & bit))
+        continue;
+
+      // A run of changed cells takes one address command; the display
+      // moves along by itself as they're written
+      uint8_t addr = col + pgm_read_byte(&row_offsets[row]);
+      if (addr != _lcd_address) {
+        if (!bytes--)
+          return false;
+        command(LCD_SETDDRAMADDR | addr);
+        _lcd_address = addr;
+      }
+      if (!bytes)
+        return false;
+
+      // As much of the run as there's budget for goes in one send
+      uint8_t count = 1;
+      while (count < bytes && col + count < LCD_SCREEN_WIDTH &&
+             (_dirty[row] & (bit << count)))
+        count++;
+      sendData(&_shadow[row][col], count);
+      _dirty[row] &= ~(((1UL << count) - 1) << col);
+      bytes -= count;
+      _lcd_address = addr + count;
+      col += count - 1;
+      bit <<= count - 1;
+    }
+  }
+  return true;
+}
+
+void LiquidCrystalSerial::sendData(const uint8_t *data, uint8_t count) {
+  while (count--)
+    send(*data++, true);
+}
+
 void LiquidCrystalSerial::writeInt(uint16_t value, uint8_t digits) {
 
     if(digits > 5)
@@ -347,97 +414,74 @@ void LiquidCrystalSerial::moveWriteInt(uint8_t col, uint8_t row, uint16_t value,
      writeInt(value, digits);
 }
 
+// Digits are taken off by subtracting powers of ten, the AVR has no divide
+const static uint32_t powers_of_ten[] PROGMEM = {
+     1L, 10L, 100L, 1000L, 10000L, 100000L,
+     1000000L, 10000000L, 100000000L, 1000000000L
+};
+
+// The digit of value for 10^power, which is taken off value; value must
+// have no higher digits
+static char takeDigit(uint32_t &value, uint8_t power) {
+     uint32_t p = pgm_read_dword(&powers_of_ten[power]);
+     char c = '0';
+     while ( value >= p ) {
+	  value -= p;
+	  c++;
+     }
+     return c;
+}
+
 void LiquidCrystalSerial::writeInt32(uint32_t value, uint8_t digits) {
 
-     uint32_t currentDigit = 1;
-     uint32_t nextDigit;
      bool nonzero_seen = false;
 
      if ( digits > 9 )
 	  digits = 9;
 
-     for (uint8_t i = digits; i; i--)
-	  currentDigit *= 10;
+     // Drop the digits which don't fit
+     for (uint8_t i = 10; i > digits; )
+	  takeDigit(value, --i);
 
      for (uint8_t i = digits; i; i--) {
-	  nextDigit = currentDigit / 10;
-	  char c;
-	  int8_t d = (value % currentDigit) / nextDigit;
-	  if ( nonzero_seen || d != 0 || i == 1) {
-	       c = d + '0';
+	  char c = takeDigit(value, i - 1);
+	  if ( nonzero_seen || c != '0' || i == 1 )
 	       nonzero_seen = true;
-	  }
 	  else
 	       c = ' ';
 	  write(c);
-	  currentDigit = nextDigit;
      }
 }
 
-//From: http://www.arduino.cc/playground/Code/PrintFloats
-//tim [at] growdown [dot] com   Ammended to write a float to lcd
 //If rightJusityToCol = 0, the number is left justified, i.e. printed from the
 //current cursor position.  If it's non-zero, it's right justified to end at rightJustifyToCol column.
 
 #define MAX_FLOAT_STR_LEN 20
 
-void LiquidCrystalSerial::writeFloat(float value, uint8_t decimalPlaces, uint8_t rightJustifyToCol) {
-        // this is used to cast digits
-        int digit;
-        float tens = 0.1;
-        int tenscount = 0;
-        int i;
-        float tempfloat = value;
+void LiquidCrystalSerial::writeFixed(int32_t value, uint8_t decimalPlaces, uint8_t rightJustifyToCol) {
 	uint8_t p = 0;
 	char str[MAX_FLOAT_STR_LEN + 1];
+	uint32_t magnitude;
 
-        // make sure we round properly. this could use pow from <math.h>, but doesn't seem worth the import
-        // if this rounding step isn't here, the value  54.321 prints as 54.3209
-
-        // calculate rounding term d:   0.5/pow(10,decimalPlaces)
-        float d = 0.5;
-        if (value < 0) d *= -1.0;
-
-        // divide by ten for each decimal place
-        for (i = decimalPlaces; i; i--) d/= 10.0;
-
-        // this small addition, combined with truncation will round our values properly
-        tempfloat +=  d;
-
-        // first get value tens to be the large power of ten less than value
-        // tenscount isn't necessary but it would be useful if you wanted to know after this how many chars the number will take
-
-        tempfloat = fabsf(tempfloat);
-        while ((tens * 10.0) <= tempfloat) {
-                tens *= 10.0;
-                tenscount += 1;
-        }
-
-        // write out the negative if needed
-        if (value < 0) str[p++] = '-';
-
-        if (tenscount == 0) str[p++] = '0';
-
-        for (i = tenscount; i; i--) {
-                digit = (int) (tempfloat/tens);
-                str[p++] = digit + '0';
-                tempfloat = tempfloat - ((float)digit * tens);
-                tens /= 10.0;
-        }
-
-        // if no decimalPlaces after decimal, stop now and return
-        if (decimalPlaces > 0) {
-		// otherwise, write the point and continue on
-		str[p++] = '.';
-
-		// now write out each decimal place by shifting digits one by one into the ones place and writing the truncated value
-		for (i = decimalPlaces; i; i--) {
-			tempfloat *= 10.0;
-			digit = (int) tempfloat;
-			str[p++] = digit+'0';
-			// once written, subtract off that digit
-			tempfloat = tempfloat - (float) digit;
-		}
+	if ( decimalPlaces > 9 )
+		decimalPlaces = 9;
+
+	if ( value < 0 ) {
+		str[p++] = '-';
+		magnitude = -(uint32_t)value;
+	}
+	else
+		magnitude = (uint32_t)value;
+
+	// At least one digit before the point
+	uint8_t digits = decimalPlaces + 1;
+	while ( digits < 10 && magnitude >= pgm_read_dword(&powers_of_ten[digits]) )
+		digits++;
+
+	for (uint8_t i = digits; i; ) {
+		str[p++] = takeDigit(magnitude, --i);
+		if ( i == decimalPlaces && i )
+			str[p++] = '.';
 	}
 
 	str[p] = '\0';
@@ -448,6 +492,19 @@ void LiquidCrystalSerial::writeFloat(float value, uint8_t decimalPlaces, uint8_t
 	writeString(str);
 }
 
+void LiquidCrystalSerial::writeFloat(float value, uint8_t decimalPlaces, uint8_t rightJustifyToCol) {
+	// Scaled and rounded once, then written as fixed point
+	float scaled = value;
+	for (uint8_t i = decimalPlaces; i; i--)
+		scaled *= 10.0;
+	scaled += (scaled < 0) ? -0.5 : 0.5;
+	if ( scaled > 2147483647.0 )
+		scaled = 2147483647.0;
+	else if ( scaled < -2147483647.0 )
+		scaled = -2147483647.0;
+	writeFixed((int32_t)scaled, decimalPlaces, rightJustifyToCol);
+}
+
 char* LiquidCrystalSerial::writeLine(char* message) {
 	char* letter = message;
 	while (*letter != 0 && *letter != '\n') {
@@ -467,12 +524,43 @@ void LiquidCrystalSerial::writeString(char message[]) {
 	}
 }
 
+#ifdef LOCALE_PACKED
+
+char LocaleReader::next() {
+	uint8_t c;
+	if ( word ) {
+		c = pgm_read_byte(word++);
+		if ( c & 0x80 ) word = 0;
+		return (char)(c & 0x7f);
+	}
+	c = pgm_read_byte(msg++);
+	if ( c == LOCALE_LITERAL )
+		return (char)pgm_read_byte(msg++);
+	if ( c >= LOCALE_WORD_FIRST ) {
+		// Words aren't empty, nor packed themselves
+		word = LOCALE_WORDS + pgm_read_word(&LOCALE_WORD_OFFSETS[c - LOCALE_WORD_FIRST]);
+		return next();
+	}
+	return (char)c;
+}
+
+void LiquidCrystalSerial::writeFromPgmspace(const prog_uchar message[]) {
+	LocaleReader reader(message);
+	char letter;
+	while ((letter = reader.next()))
+		write(letter);
+}
+
+#else
+
 void LiquidCrystalSerial::writeFromPgmspace(const prog_uchar message[]) {
 	char letter;
 	while ((letter = pgm_read_byte(message++)))
 		write(letter);
 }
 
+#endif
+
 void LiquidCrystalSerial::moveWriteFromPgmspace(uint8_t col, uint8_t row,
 						const prog_uchar message[]) {
 	setCursor(col, row);
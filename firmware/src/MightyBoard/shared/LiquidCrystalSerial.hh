@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 #include <avr/pgmspace.h>
+#include "Configuration.hh"
 #include "Pin.hh"
 
 // commands
@@ -92,6 +93,12 @@
 #define LCD_CUSTOM_CHAR_UP 0x5e     // ^
 #define LCD_CUSTOM_CHAR_RIGHT 0x7e // right pointing arrow (0x7f is left pointing)
 
+// Bytes sent to the display on each pass of the main loop, each of them
+// taking some tens of microseconds to shift out
+#ifndef LCD_FLUSH_BYTES
+#define LCD_FLUSH_BYTES 4
+#endif
+
 // TODO:  make variable names for rs, rw, e places in the output vector
 
 class LiquidCrystalSerial {
@@ -121,7 +128,7 @@ public:
   void autoscroll();
   void noAutoscroll();
 
-  void createChar(uint8_t, uint8_t[]);
+  void createChar(uint8_t, const uint8_t[]);	// map in flash
   void setCursor(uint8_t, uint8_t);
   void setRow(uint8_t);
   void setCursorExt(int8_t col, int8_t row);
@@ -134,6 +141,9 @@ public:
   void writeInt32(uint32_t value, uint8_t digits);
   void writeFloat(float value, uint8_t decimalPlaces,
                   uint8_t rightJustifyToCol);
+  /** Write value / 10^decimalPlaces as writeFloat() would, without floats */
+  void writeFixed(int32_t value, uint8_t decimalPlaces,
+                  uint8_t rightJustifyToCol);
 
   void writeString(char message[]);
 
@@ -148,9 +158,23 @@ public:
 
   void command(uint8_t);
 
+  /* The write and cursor methods, and clear(), only change a copy of the
+   * screen held in RAM.  This sends up to bytes of the cells of it which
+   * have changed to the display, so a screen which redraws all of itself
+   * costs no more than the characters which differ, and the main loop can
+   * send them a few at a time.  Returns true once there are none left. */
+  bool flush(uint8_t bytes);
+
+  /* Send all of the changed cells, for a screen which is held up */
+  void flush() { while (!flush(0xff)) ; }
+
 protected:
   /* Sends 8-bits to the HD44780 in two 4-bit transmissions. */  
   virtual void send(uint8_t, bool) = 0;
+
+  /* Sends a run of characters, which the display writes to consecutive
+   * cells.  Bus expanders override this to send them in one transfer. */
+  virtual void sendData(const uint8_t *data, uint8_t count);
   
   /* Sets the state of the shift register or bus expander directly
    *
@@ -178,6 +202,15 @@ protected:
   uint8_t _ycursor;
 
   uint8_t _numlines,_numCols;
+
+  // What the display will show once flushed, and a bit per column of each
+  // row for the cells which have changed since the last flush
+  uint8_t _shadow[LCD_SCREEN_HEIGHT][LCD_SCREEN_WIDTH];
+  uint32_t _dirty[LCD_SCREEN_HEIGHT];
+
+  // The DDRAM address the display writes the next character to, or 0xff
+  // after a command which may have moved it
+  uint8_t _lcd_address;
   
 };
 
@@ -77,12 +77,46 @@ bool LiquidCrystalSerial_I2C::setBacklight(bool value) {
 
 // write either command or data, with automatic 4/8-bit selection
 void LiquidCrystalSerial_I2C::send(uint8_t value, bool dataMode) {
-  write4bits((value >> 4), dataMode);
-  write4bits((value & 0x0F), dataMode);
+  uint8_t burst[4];
+  expand(burst, value, dataMode);
+  TWI_write_data(LCD_I2C_DEVICE_ADDRESS << 1, burst, sizeof(burst));
+}
+
+// The expander takes each byte of a transfer as the next state of its
+// pins, so the enable pulses for a run of characters go in one transfer.
+// They're queued; commands, which the display needs time after, aren't.
+void LiquidCrystalSerial_I2C::sendData(const uint8_t *data, uint8_t count) {
+  uint8_t burst[4 * LCD_I2C_BURST_CHARS];
+  while (count) {
+    uint8_t n = (count > LCD_I2C_BURST_CHARS) ? LCD_I2C_BURST_CHARS : count;
+    uint8_t *out = burst;
+    for (uint8_t i = n; i; i--)
+      out = expand(out, *data++, true);
+    TWI_queue_write(LCD_I2C_DEVICE_ADDRESS << 1, burst, out - burst);
+    count -= n;
+  }
+}
+
+// The four pin states which clock value in, a nibble at a time with the
+// enable pin high and then low
+uint8_t *LiquidCrystalSerial_I2C::expand(uint8_t *out, uint8_t value, bool dataMode) {
+  uint8_t bits = nibbleBits(value >> 4, dataMode);
+  *out++ = bits | (1 << LCD_EN_PIN);
+  *out++ = bits;
+  bits = nibbleBits(value & 0x0F, dataMode);
+  *out++ = bits | (1 << LCD_EN_PIN);
+  *out++ = bits;
+  return out;
 }
 
 // write4bits
 void LiquidCrystalSerial_I2C::write4bits(uint8_t value, bool dataMode) {
+  pulseEnable(nibbleBits(value, dataMode));
+}
+
+// The pin states for the 4 least-significant bits of value, with the
+// enable pin low
+uint8_t LiquidCrystalSerial_I2C::nibbleBits(uint8_t value, bool dataMode) {
   uint8_t bits = 0;
 
   // Map in the data bits
@@ -107,12 +141,14 @@ void LiquidCrystalSerial_I2C::write4bits(uint8_t value, bool dataMode) {
     bits |= (1 << LCD_BACKLIGHT_PIN);
 #endif
 
-  pulseEnable(bits);
+  return bits;
 }
 
 void LiquidCrystalSerial_I2C::pulseEnable(uint8_t data) {
-  TWI_write_byte(LCD_I2C_DEVICE_ADDRESS << 1, data | (1 << LCD_EN_PIN));
-  TWI_write_byte(LCD_I2C_DEVICE_ADDRESS << 1, data & ~(1 << LCD_EN_PIN));
+  uint8_t burst[2];
+  burst[0] = data | (1 << LCD_EN_PIN);
+  burst[1] = data & ~(1 << LCD_EN_PIN);
+  TWI_write_data(LCD_I2C_DEVICE_ADDRESS << 1, burst, sizeof(burst));
 }
 
 void LiquidCrystalSerial_I2C::writeSerial(uint8_t value) {
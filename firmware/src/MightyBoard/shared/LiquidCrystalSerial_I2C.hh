@@ -51,6 +51,11 @@
 #define LCD_D6_PIN 6
 #define LCD_D7_PIN 7
 
+// Characters sent to the expander in one transfer, four bytes each
+#ifndef LCD_I2C_BURST_CHARS
+#define LCD_I2C_BURST_CHARS 8
+#endif
+
 class LiquidCrystalSerial_I2C : public LiquidCrystalSerial {
 
 public:
@@ -65,10 +70,14 @@ public:
 
 private:
   void send(uint8_t, bool);
+  void sendData(const uint8_t *data, uint8_t count);
   void writeSerial(uint8_t);
   void write4bits(uint8_t value, bool dataMode);
   void pulseEnable(uint8_t value);
 
+  uint8_t nibbleBits(uint8_t value, bool dataMode);
+  uint8_t *expand(uint8_t *out, uint8_t value, bool dataMode);
+
   bool has_i2c_lcd;
   bool backlight_state;
 };
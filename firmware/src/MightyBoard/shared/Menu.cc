@@ -16,10 +16,14 @@
 #include <util/delay.h>
 #include <stdlib.h>
 #include "SDCard.hh"
+#include "PrintQueue.hh"
+#include "Checkpoint.hh"
+#include "PreScan.hh"
 #include <string.h>
 #include "Version.hh"
 #include "EepromMap.hh"
 #include "Eeprom.hh"
+#include "StatsJournal.hh"
 #include <avr/eeprom.h>
 #ifdef HAS_RGB_LED
 #include "RGB_LED.hh"
@@ -42,6 +46,18 @@
 #include "MachineId.hh"
 #endif
 
+#if defined(ISR_PROFILE)
+#include "IsrProfile.hh"
+#endif
+
+#if defined(MEMORY_PROFILE)
+#include "MemoryProfile.hh"
+#endif
+
+#if defined(SLICE_STATS)
+#include "Scheduler.hh"
+#endif
+
 //#define HOST_PACKET_TIMEOUT_MS 20
 //#define HOST_PACKET_TIMEOUT_MICROS (1000L*HOST_PACKET_TIMEOUT_MS)
 
@@ -57,7 +73,6 @@ static bool hasHBP = true;
 static bool jog_paused;
 
 #define DUMP_FILE "eeprom_dump.bin"
-static const char dumpFilename[] = DUMP_FILE;
 
 enum sucessState{
 	SUCCESS,
@@ -70,23 +85,12 @@ uint8_t filamentSuccess;
 uint32_t homePosition[PROFILES_HOME_POSITIONS_STORED];
 
 ActiveBuildMenu               activeBuildMenu;
-BotStatsScreen                botStatsScreen;
-BuildStatsScreen              buildStatsScreen;
 CancelBuildMenu               cancelBuildMenu;
-ChangeSpeedScreen             changeSpeedScreen;
-ChangeExtrusionScreen         changeExtrusionScreen;
-ChangeTempScreen              changeTempScreen;
-ChangePlatformTempScreen      changePlatformTempScreen;
 FilamentMenu                  filamentMenu;
-FilamentOdometerScreen        filamentOdometerScreen;
 FilamentScreen                filamentScreen;
 HeaterPreheatMenu             heaterPreheatMenu;
-HomeOffsetsModeScreen         homeOffsetsModeScreen;
-JogModeScreen                 jogModeScreen;
 MonitorModeScreen             monitorModeScreen;
-PauseAtZPosScreen             pauseAtZPosScreen;
 PreheatSettingsMenu           preheatSettingsMenu;
-ProfileChangeNameModeScreen   profileChangeNameModeScreen;
 ProfileDisplaySettingsMenu    profileDisplaySettingsMenu;
 ProfileSubMenu                profileSubMenu;
 ProfilesMenu                  profilesMenu;
@@ -96,24 +100,12 @@ SettingsMenu                  settingsMenu;
 SplashScreen                  splashScreen;
 UtilitiesMenu                 utilityMenu;
 
-#if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
-ThermistorScreen              thermistorScreen;
-#endif
-
 #if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
-CoolingFanPwmScreen           coolingFanPwmScreen;
 #define MONITOR_MODE_HBP_OFFSET -8
 #else
 #define MONITOR_MODE_HBP_OFFSET +0
 #endif
 
-#if defined(AUTO_LEVEL)
-MaxZDiffScreen                alevelZDiffScreen;
-#if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL)
-MaxZProbeHitsScreen           maxZProbeHitsScreen;
-#endif
-#endif
-
 #ifndef SINGLE_EXTRUDER
 #ifdef NOZZLE_CALIBRATION_SCREEN
 NozzleCalibrationScreen       nozzleCalibrationScreen;
@@ -127,6 +119,62 @@ EepromMenu                    eepromMenu;
 
 /// Static instances of our menus
 
+// The screens below are each pushed from a menu and push none of their own
+// but the cancel menu, so no two of them are ever on the stack at once.
+// Rather than each having a static instance, they share the one piece of
+// storage, and each is constructed there by overlayScreen() as it's pushed.
+// Their state is all set up by reset(), as it was for the static ones.
+union ScreenOverlay {
+	char botStats[sizeof(BotStatsScreen)];
+	char buildStats[sizeof(BuildStatsScreen)];
+	char changeExtrusion[sizeof(ChangeExtrusionScreen)];
+	char changePlatformTemp[sizeof(ChangePlatformTempScreen)];
+	char changeSpeed[sizeof(ChangeSpeedScreen)];
+	char changeTemp[sizeof(ChangeTempScreen)];
+	char filamentOdometer[sizeof(FilamentOdometerScreen)];
+	char homeOffsetsMode[sizeof(HomeOffsetsModeScreen)];
+	char jogMode[sizeof(JogModeScreen)];
+	char pauseAtZPos[sizeof(PauseAtZPosScreen)];
+	char profileChangeNameMode[sizeof(ProfileChangeNameModeScreen)];
+#ifdef ISR_PROFILE
+	char isrProfile[sizeof(IsrProfileScreen)];
+#endif
+#ifdef MEMORY_PROFILE
+	char memoryProfile[sizeof(MemoryProfileScreen)];
+#endif
+#ifdef PID_AUTOTUNE
+	char autotune[sizeof(AutotuneScreen)];
+#endif
+#if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
+	char thermistor[sizeof(ThermistorScreen)];
+#endif
+#if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
+	char coolingFanPwm[sizeof(CoolingFanPwmScreen)];
+#endif
+#if defined(AUTO_LEVEL)
+	char maxZDiff[sizeof(MaxZDiffScreen)];
+#if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL)
+	char maxZProbeHits[sizeof(MaxZProbeHitsScreen)];
+#endif
+#endif
+	void *align;
+};
+
+static ScreenOverlay screenOverlay;
+
+// Placement new, which avr-libc has no <new> for
+inline void *operator new(size_t, void *p) { return p; }
+
+template <class T> static T *overlayScreen() {
+	return new (&screenOverlay) T();
+}
+
+static Screen *homeOffsetsModeScreen(uint8_t do_home_offsets) {
+	HomeOffsetsModeScreen *screen = overlayScreen<HomeOffsetsModeScreen>();
+	screen->do_home_offsets = do_home_offsets;
+	return screen;
+}
+
 //Macros to expand SVN revision macro into a str
 #define STR_EXPAND(x) #x        //Surround the supplied macro by double quotes
 #define STR(x) STR_EXPAND(x)
@@ -217,14 +265,14 @@ static void formatTime(char *buf, uint32_t val)
 	const uint8_t radixcount = 5;
 	const uint8_t houridx = 2;
 	const uint8_t minuteidx = 4;
-	uint32_t radixes[radixcount] = {360000, 36000, 3600, 600, 60};
+	const static PROGMEM uint32_t radixes[radixcount] = {360000, 36000, 3600, 600, 60};
 	if (val >= 3600000)
 		val %= 3600000;
 
 	for (radidx = 0; radidx < radixcount; radidx++) {
 		char digit = '0';
 		uint8_t bit = 8;
-		uint32_t radshift = radixes[radidx] << 3;
+		uint32_t radshift = pgm_read_dword(&radixes[radidx]) << 3;
 		for (; bit > 0; bit >>= 1, radshift >>= 1) {
 			if (val > radshift) {
 				val -= radshift;
@@ -317,7 +365,7 @@ void SplashScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 			lcd.moveWriteFromPgmspace(0, 1, CLEAR_MSG);
 			lcd.setRow(1);
                		lcd.writeFromPgmspace(SPLASH_SRAM_MSG);
-                	lcd.writeFloat((float)StackCount(), 0, LCD_SCREEN_WIDTH);
+                	lcd.writeFixed(StackCount(), 0, LCD_SCREEN_WIDTH);
 		}
 		else
 			lcd.moveWriteFromPgmspace(0, 1, SPLASH2_MSG);
@@ -417,7 +465,7 @@ void HeaterPreheatMenu::drawItem(uint8_t index, LiquidCrystalSerial& lcd) {
 
 void HeaterPreheatMenu::storeHeatByte() {
 	uint8_t heatByte = (_rightActive*(1<<HEAT_MASK_RIGHT)) + (_leftActive*(1<<HEAT_MASK_LEFT)) + (_platformActive*(1<<HEAT_MASK_PLATFORM));
-	eeprom_write_byte((uint8_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_ON_OFF_OFFSET), heatByte);
+	eeprom::writeByte((uint8_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_ON_OFF_OFFSET), heatByte);
 }
 
 void HeaterPreheatMenu::handleSelect(uint8_t index) {
@@ -516,6 +564,7 @@ void NozzleCalibrationScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw)
 			break;
 		}
 		lcd.writeFromPgmspace(msg);
+		lcd.flush();
 		_delay_us(500000);
 		Motherboard::interfaceBlinkOn();
 	}
@@ -615,7 +664,7 @@ void SelectAlignmentMenu::handleSelect(uint8_t index) {
 	//   the second time around.
 	int32_t offset = offsets[index] + stepperAxisMMToSteps((float)(counter[index] - 7) * 0.1f, index);
 	cli();
-	eeprom_write_block((uint8_t *)&offset,
+	eeprom::writeBlock((uint8_t *)&offset,
 			   (uint8_t *)eeprom_offsets::TOOLHEAD_OFFSET_SETTINGS + index * sizeof(int32_t),
 			   sizeof(int32_t));
 	sei();
@@ -773,6 +822,7 @@ void FilamentScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 			/// alert user to press M to stop extusion / reversal
 		case FILAMENT_STOP:
 			lcd.writeFromPgmspace(STOP_EXIT_MSG);
+			lcd.flush();
 			Motherboard::interfaceBlinkOn();
 			_delay_us(1000000);
 			break;
@@ -928,7 +978,7 @@ bool MessageScreen::screenWaiting(void){
 	return (timeout.isActive() || incomplete);
 }
 
-void MessageScreen::addMessage(CircularBuffer& buf) {
+void MessageScreen::addMessage(CommandBuffer& buf) {
 	char c = buf.pop();
 	while (c != '\0' && buf.getLength() > 0) {
 		if ( cursor < MSG_SCR_BUF_SIZE ) message[cursor++] = c;
@@ -944,7 +994,14 @@ void MessageScreen::addMessage(CircularBuffer& buf) {
 
 void MessageScreen::addMessage(const prog_uchar msg[]) {
 
+#ifdef LOCALE_PACKED
+	LocaleReader reader(msg);
+	char c;
+	while ( (c = reader.next()) && cursor < MSG_SCR_BUF_SIZE - 1 )
+		message[cursor++] = c;
+#else
 	cursor += strlcpy_P(message + cursor, (const prog_char *)msg, MSG_SCR_BUF_SIZE - cursor);
+#endif
 
 	// ensure that message is always null-terminated
 	if (cursor < MSG_SCR_BUF_SIZE - 1)
@@ -1039,8 +1096,10 @@ void JogModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 	    (!interface::isButtonPressed(ButtonArray::UP)))
 	{
 		jogging = false;
-		steppers::abort();
+		steppers::abortDecelerated();
 	}
+	else if ( jogging && jogDistance == DISTANCE_CONT )
+		steppers::continueJog(jogAxis, jogPositive, jogInterval);
 
 	if (forceRedraw || distanceChanged || modeChanged) {
 
@@ -1081,7 +1140,7 @@ void JogModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 }
 
 void JogModeScreen::jog(ButtonArray::ButtonName direction) {
-	steppers::abort();
+	steppers::abortDecelerated();
 	uint8_t dummy;
 	Point position = steppers::getStepperPosition(&dummy);
 
@@ -1095,12 +1154,7 @@ void JogModeScreen::jog(ButtonArray::ButtonName direction) {
 	case DISTANCE_LONG:
 		steps = 3000;
 		break;
-	case DISTANCE_CONT:	//Continuous movement, no clunks
-#if !defined(CORE_XY) && !defined(CORE_XY_STEPPER) && !defined(CORE_XYZ)
-		steps = (INT32_MAX - 1) >> 2;
-#else
-		steps = (INT32_MAX - 1) >> 4;
-#endif
+	case DISTANCE_CONT:	//Continuous movement, kept queued by update() while held
 		break;
 	}
 
@@ -1155,11 +1209,19 @@ void JogModeScreen::jog(ButtonArray::ButtonName direction) {
 		}
 	}
 
-	position[index] += steps;
 	int32_t interval = stepperAxis_minInterval(index);
 	if (interval < 500) interval = 500;
-	if (direction == ButtonArray::UP || direction == ButtonArray::DOWN)
-	{
+	if (direction != ButtonArray::UP && direction != ButtonArray::DOWN)
+		return;
+
+	if ( jogDistance == DISTANCE_CONT ) {
+		jogAxis = index;
+		jogPositive = steps > 0;
+		jogInterval = interval;
+		steppers::continueJog(jogAxis, jogPositive, jogInterval);
+	}
+	else {
+		position[index] += steps;
 		steppers::setTargetNew(position, interval, 0, 0);
 	}
 }
@@ -1219,16 +1281,20 @@ void printLastBuildTime(const prog_uchar *msg, uint8_t row, LiquidCrystalSerial&
 void writeFilamentUsed(LiquidCrystalSerial& lcd, float filamentUsed) {
 	uint8_t precision;
 
-	filamentUsed /= 1000.0; //convert to meters
-	if      ( filamentUsed < 0.1 )  {
-		filamentUsed *= 1000.0;        //Back to mm's
-		precision = 1;
+	// In tenths of a mm, which is also 4 places of meters
+	int32_t used = (int32_t)(filamentUsed * 10.0 + 0.5);
+	if      ( used < 1000L )    precision = 1;	// mm's
+	else if ( used < 100000L )  precision = 4;
+	else if ( used < 1000000L ) {
+		used = (used + 5) / 10;
+		precision = 3;
+	}
+	else {
+		used = (used + 50) / 100;
+		precision = 2;
 	}
-	else if ( filamentUsed < 10.0 )  precision = 4;
-	else if ( filamentUsed < 100.0 ) precision = 3;
-	else                             precision = 2;
 
-	lcd.writeFloat(filamentUsed, precision, LCD_SCREEN_WIDTH - ((precision == 1) ? 2 : 1));
+	lcd.writeFixed(used, precision, LCD_SCREEN_WIDTH - ((precision == 1) ? 2 : 1));
 	lcd.writeFromPgmspace((precision == 1) ? MILLIMETERS_MSG : METERS_MSG);
 }
 
@@ -1239,8 +1305,8 @@ void filamentOdometers(bool odo, uint8_t yOffset, LiquidCrystalSerial &lcd) {
 	lcd.moveWriteFromPgmspace(0, yOffset, odo ? FILAMENT_LIFETIME1_MSG : FILAMENT_LIFETIME2_MSG);
 
 	float filamentUsedA, filamentUsedB;
-	filamentUsedA = stepperAxisStepsToMM(eeprom::getEepromInt64(eeprom_offsets::FILAMENT_LIFETIME, 0),                  A_AXIS);
-	filamentUsedB = stepperAxisStepsToMM(eeprom::getEepromInt64(eeprom_offsets::FILAMENT_LIFETIME + sizeof(int64_t),0), B_AXIS);
+	filamentUsedA = stepperAxisStepsToMM(journal::getFilament(0), A_AXIS);
+	filamentUsedB = stepperAxisStepsToMM(journal::getFilament(1), B_AXIS);
 	writeFilamentUsed(lcd, filamentUsedA + filamentUsedB);
 
 	// Get trip filament used for A & B axis and sum them into filamentUsed
@@ -1264,8 +1330,8 @@ void FilamentOdometerScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw)
 void FilamentOdometerScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	switch (button) {
 	case ButtonArray::CENTER:
-		eeprom::setEepromInt64(eeprom_offsets::FILAMENT_TRIP, eeprom::getEepromInt64(eeprom_offsets::FILAMENT_LIFETIME, 0));
-		eeprom::setEepromInt64(eeprom_offsets::FILAMENT_TRIP + sizeof(int64_t), eeprom::getEepromInt64(eeprom_offsets::FILAMENT_LIFETIME + sizeof(int64_t), 0));
+		eeprom::setEepromInt64(eeprom_offsets::FILAMENT_TRIP, journal::getFilament(0));
+		eeprom::setEepromInt64(eeprom_offsets::FILAMENT_TRIP + sizeof(int64_t), journal::getFilament(1));
 		needsRedraw = true;
 		break;
         case ButtonArray::LEFT:
@@ -1290,89 +1356,19 @@ void MonitorModeScreen::reset() {
 #endif
 }
 
-void MonitorModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
+void MonitorModeScreen::drawPhase(LiquidCrystalSerial& lcd, uint8_t phase) {
 #ifdef ACCEL_STATS
 	const static PROGMEM prog_uchar mon_speed[] = "Acc:                ";
 #endif
-	Motherboard& board = Motherboard::getBoard();
-
-	if ( !heating ) {
-		if  (board.getExtruderBoard(0).getExtruderHeater().isHeating() ||
-		     board.getExtruderBoard(1).getExtruderHeater().isHeating() ||
-		     board.getPlatformHeater().isHeating() ) {
-			heating = true;
-			lastHeatIndex = 0;
-			lcd.setRow(0);
-			lcd.writeFromPgmspace(HEATING_SPACES_MSG);
-		}
-	}
-
-	if (forceRedraw) {
-
-		lcd.clearHomeCursor();
-		if ( heating ) {
-			lcd.writeFromPgmspace(HEATING_MSG);
-			lastHeatIndex = 0;
-		}
-		else {
-			buildInfo(lcd);
-		}
-
-		uint8_t row;
-		if ( hasHBP ) {
-			lcd.moveWriteFromPgmspace(0, 3, PLATFORM_TEMP_MSG);
-			row = 2;
-		}
-		else row = 3;
-#if defined(COOLING_FAN_PWM)
-		lcd.moveWriteFromPgmspace(13, 3, PWM_FAN_MSG);
+#ifdef SLICE_STATS
+	const static PROGMEM prog_uchar mon_loop[] = "Loop:               ";
 #endif
-		if ( singleTool )
-			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER_TEMP_MSG);
-		else {
-			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER2_TEMP_MSG);
-			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER1_TEMP_MSG);
-		}
-		while (row >= 1)
-			lcd.moveWriteFromPgmspace(0, row--, CLEAR_MSG);
-	}
-
-	OutPacket responsePacket;
+	Motherboard& board = Motherboard::getBoard();
 	uint16_t data;
 	host::HostState state;
-	int16_t currentDelta = 0;
-	int16_t setTemp = 0;
-
-	/// show heating progress
-	if ( heating ) {
-		if (board.getExtruderBoard(0).getExtruderHeater().isHeating()  && !board.getExtruderBoard(0).getExtruderHeater().isPaused()){
-			currentDelta += board.getExtruderBoard(0).getExtruderHeater().getDelta();
-			setTemp += (int16_t)(board.getExtruderBoard(0).getExtruderHeater().get_set_temperature());
-		}
-		if ( board.getExtruderBoard(1).getExtruderHeater().isHeating() && !board.getExtruderBoard(1).getExtruderHeater().isPaused() ) {
-			currentDelta += board.getExtruderBoard(1).getExtruderHeater().getDelta();
-			setTemp += (int16_t)(board.getExtruderBoard(1).getExtruderHeater().get_set_temperature());
-		}
-		if ( board.getPlatformHeater().isHeating() ) {
-			currentDelta += board.getPlatformHeater().getDelta()*2;
-			setTemp += (int16_t)(board.getPlatformHeater().get_set_temperature())*2;
-		}
-
-		if ( currentDelta == 0 ) {
-			heating = false;
-			//redraw build name
-			lcd.moveWriteFromPgmspace(0, 0, CLEAR_MSG);
-			lcd.setRow(0);
-			buildInfo(lcd);
-		}
-		else {
-			progressBar(lcd, currentDelta, setTemp);
-		}
-	}
-
 
 	// Redraw tool info
-	switch (updatePhase) {
+	switch (phase) {
 
 	// Dual extruder Tool 0 current temp
 	case 0:
@@ -1573,6 +1569,29 @@ void MonitorModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 			lcd.write(' ');
 			break;
 #endif // ACCEL_STATS
+
+#ifdef SLICE_STATS
+		// Average/longest pass of the main loop in ms, and the
+		// slice which last went over budget
+		case BUILD_TIME_PHASE_SLICE_STATS:
+		{
+			scheduler::SliceStats loop;
+			scheduler::getSliceStats(SLICE_LOOP, &loop);
+			lcd.moveWriteFromPgmspace(0, 1, mon_loop);
+			lcd.setCursor(5, 1);
+			// The ticks are tenths of a ms
+			lcd.writeFixed(( loop.runs ) ? loop.total / loop.runs : 0, 1, LCD_SCREEN_WIDTH);
+			lcd.write('/');
+			lcd.writeFixed(loop.max, 1, LCD_SCREEN_WIDTH);
+			uint8_t slow = scheduler::getSlowSlice();
+			if ( slow != SLICE_NONE ) {
+				lcd.write(' ');
+				lcd.write('!');
+				lcd.write('0' + slow);
+			}
+			break;
+		}
+#endif // SLICE_STATS
 		}
 
         	if ( ! okButtonHeld ) {
@@ -1586,6 +1605,106 @@ void MonitorModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 		break;
 #endif // BUILD_STATS
 	}
+}
+
+void MonitorModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	Motherboard& board = Motherboard::getBoard();
+
+	if ( !heating ) {
+		if  (board.getExtruderBoard(0).getExtruderHeater().isHeating() ||
+		     board.getExtruderBoard(1).getExtruderHeater().isHeating() ||
+		     board.getPlatformHeater().isHeating() ) {
+			heating = true;
+			lastHeatIndex = 0;
+			lcd.setRow(0);
+			lcd.writeFromPgmspace(HEATING_SPACES_MSG);
+		}
+	}
+
+	if (forceRedraw) {
+
+		lcd.clearHomeCursor();
+		if ( heating ) {
+			lcd.writeFromPgmspace(HEATING_MSG);
+			lastHeatIndex = 0;
+		}
+		else {
+			buildInfo(lcd);
+		}
+
+		uint8_t row;
+		if ( hasHBP ) {
+			lcd.moveWriteFromPgmspace(0, 3, PLATFORM_TEMP_MSG);
+			row = 2;
+		}
+		else row = 3;
+#if defined(COOLING_FAN_PWM)
+		lcd.moveWriteFromPgmspace(13, 3, PWM_FAN_MSG);
+#endif
+		if ( singleTool )
+			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER_TEMP_MSG);
+		else {
+			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER2_TEMP_MSG);
+			lcd.moveWriteFromPgmspace(0, row--, EXTRUDER1_TEMP_MSG);
+		}
+		while (row >= 1)
+			lcd.moveWriteFromPgmspace(0, row--, CLEAR_MSG);
+	}
+
+	int16_t currentDelta = 0;
+	int16_t setTemp = 0;
+
+	/// show heating progress
+	if ( heating ) {
+		if (board.getExtruderBoard(0).getExtruderHeater().isHeating()  && !board.getExtruderBoard(0).getExtruderHeater().isPaused()){
+			currentDelta += board.getExtruderBoard(0).getExtruderHeater().getDelta();
+			setTemp += (int16_t)(board.getExtruderBoard(0).getExtruderHeater().get_set_temperature());
+		}
+		if ( board.getExtruderBoard(1).getExtruderHeater().isHeating() && !board.getExtruderBoard(1).getExtruderHeater().isPaused() ) {
+			currentDelta += board.getExtruderBoard(1).getExtruderHeater().getDelta();
+			setTemp += (int16_t)(board.getExtruderBoard(1).getExtruderHeater().get_set_temperature());
+		}
+		if ( board.getPlatformHeater().isHeating() ) {
+			currentDelta += board.getPlatformHeater().getDelta()*2;
+			setTemp += (int16_t)(board.getPlatformHeater().get_set_temperature())*2;
+		}
+
+		if ( currentDelta == 0 ) {
+			heating = false;
+			//redraw build name
+			lcd.moveWriteFromPgmspace(0, 0, CLEAR_MSG);
+			lcd.setRow(0);
+			buildInfo(lcd);
+		}
+		else {
+			progressBar(lcd, currentDelta, setTemp);
+		}
+	}
+
+
+	// Draw what an event changed now, rather than when the rotation
+	// comes round to it
+	uint8_t events = interface::getUpdateEvents();
+	if ( events ) {
+		if ( events & SCREEN_EVENT_TOOL0 ) {
+			drawPhase(lcd, singleTool ? 2 : 0);
+			drawPhase(lcd, singleTool ? 3 : 1);
+		}
+		if ( (events & SCREEN_EVENT_TOOL1) && !singleTool ) {
+			drawPhase(lcd, 2);
+			drawPhase(lcd, 3);
+		}
+		if ( events & SCREEN_EVENT_PLATFORM ) {
+			drawPhase(lcd, 4);
+			drawPhase(lcd, 5);
+		}
+		if ( events & SCREEN_EVENT_BUILD )
+			drawPhase(lcd, 6);
+		return;
+	}
+
+	drawPhase(lcd, updatePhase);
+
 #if defined(COOLING_FAN_PWM)
 	#ifdef BUILD_STATS
 		if (++updatePhase > 8)
@@ -1602,15 +1721,18 @@ void MonitorModeScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 		updatePhase = 0;
 
 #ifdef DEBUG_ONSCREEN
+	const static PROGMEM prog_uchar dos1_msg[] = "DOS1: ";
+	const static PROGMEM prog_uchar dos2_msg[] = "DOS2: ";
+
 	lcd.setRow(0);
-	lcd.writeString((char *)"DOS1: ");
+	lcd.writeFromPgmspace(dos1_msg);
 	lcd.writeFloat(debug_onscreen1, 3, LCD_SCREEN_WIDTH);
-	lcd.writeString((char *)" ");
+	lcd.write(' ');
 
 	lcd.setRow(1);
-	lcd.writeString((char *)"DOS2: ");
+	lcd.writeFromPgmspace(dos2_msg);
 	lcd.writeFloat(debug_onscreen2, 3, LCD_SCREEN_WIDTH);
-	lcd.writeString((char *)" ");
+	lcd.write(' ');
 #endif
 }
 
@@ -1918,21 +2040,22 @@ void PreheatSettingsMenu::handleSelect(uint8_t index) {
 		break;
 	case 1:
 		// store right tool setting
-		eeprom_write_word((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP), counterRight);
+		eeprom::writeWord((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP), counterRight);
 		break;
 	case 2:
 		if ( !singleTool )
 			// store left tool setting
-			eeprom_write_word((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP), counterLeft);
+			eeprom::writeWord((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP), counterLeft);
 		else if ( hasHBP )
-			eeprom_write_word((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), counterPlatform);
+			eeprom::writeWord((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), counterPlatform);
 		break;
 	case 3:
 		if ( !singleTool && hasHBP )
 			// store platform setting
-			eeprom_write_word((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), counterPlatform);
+			eeprom::writeWord((uint16_t*)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), counterPlatform);
 		break;
 	}
+	eeprom::loadSettings();
 }
 
 
@@ -1984,15 +2107,15 @@ void writeProfileToEeprom(uint8_t pIndex, uint8_t *pName, uint32_t *homeOffsets,
 	cli();
 
 	//Write profile name
-	if ( pName )    eeprom_write_block(pName,(uint8_t*)(offset + profile_offsets::PROFILE_NAME), PROFILE_NAME_SIZE);
+	if ( pName )    eeprom::writeBlock(pName,(uint8_t*)(offset + profile_offsets::PROFILE_NAME), PROFILE_NAME_SIZE);
 
 	//Write home axis
-	eeprom_write_block((void *)homeOffsets,(void *)(offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
+	eeprom::writeBlock((void *)homeOffsets,(void *)(offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
 
 	//Write temps
-	eeprom_write_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP), rightTemp);
-	eeprom_write_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP), leftTemp);
-	eeprom_write_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP), hbpTemp);
+	eeprom::writeWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP), rightTemp);
+	eeprom::writeWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP), leftTemp);
+	eeprom::writeWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP), hbpTemp);
 
 	sei();
 }
@@ -2004,15 +2127,15 @@ void readProfileFromEeprom(uint8_t pIndex, uint8_t *pName, uint32_t *homeOffsets
 	cli();
 
 	//Read profile name
-	if ( pName )    eeprom_read_block(pName,(uint8_t*)offset, PROFILE_NAME_SIZE);
+	if ( pName )    eeprom::readBlock(pName,(uint8_t*)offset, PROFILE_NAME_SIZE);
 
 	//Read home axis
-	eeprom_read_block((void *)homeOffsets,(void *)(offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
+	eeprom::readBlock((void *)homeOffsets,(void *)(offset + profile_offsets::PROFILE_HOME_POSITIONS_STEPS), PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
 
 	//Read temps
-	*rightTemp      = eeprom_read_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP));
-	*leftTemp       = eeprom_read_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP));
-	*hbpTemp        = eeprom_read_word((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP));
+	*rightTemp      = eeprom::readWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_RIGHT_TEMP));
+	*leftTemp       = eeprom::readWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_LEFT_TEMP));
+	*hbpTemp        = eeprom::readWord((uint16_t*)(offset + profile_offsets::PROFILE_PREHEAT_PLATFORM_TEMP));
 
 	sei();
 }
@@ -2022,7 +2145,7 @@ void getProfileName(uint8_t pIndex, uint8_t *buf) {
 	uint16_t offset = eeprom_offsets::PROFILES_BASE + (uint16_t)(pIndex * PROFILE_SIZE);
 
 	cli();
-	eeprom_read_block(buf,(void *)offset,PROFILE_NAME_SIZE);
+	eeprom::readBlock(buf,(void *)offset,PROFILE_NAME_SIZE);
 	sei();
 
 	//Fill out the name with white space
@@ -2043,7 +2166,7 @@ ProfilesMenu::ProfilesMenu() :
 
 	//Setup defaults if required
 	//Initialize a flag to tell us profiles have been initialized
-	if ( eeprom_read_byte((uint8_t*)eeprom_offsets::PROFILES_INIT) != PROFILES_INITIALIZED )
+	if ( eeprom::readByte((uint8_t*)eeprom_offsets::PROFILES_INIT) != PROFILES_INITIALIZED )
 		eeprom::setDefaultsProfiles(eeprom_offsets::PROFILES_BASE);
 }
 
@@ -2107,11 +2230,16 @@ void ProfileSubMenu::handleSelect(uint8_t index) {
 
 		//Write out the home offsets
 		cli();
-		eeprom_write_block(homePosition, (void*)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, sizeof(uint32_t) * PROFILES_HOME_POSITIONS_STORED);
-		eeprom_write_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP),    rightTemp);
-		eeprom_write_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP),     leftTemp);
-		eeprom_write_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), hbpTemp);
+		eeprom::writeBlock(homePosition, (void*)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, sizeof(uint32_t) * PROFILES_HOME_POSITIONS_STORED);
+		eeprom::writeWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP),    rightTemp);
+		eeprom::writeWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP),     leftTemp);
+		eeprom::writeWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP), hbpTemp);
+		eeprom::writeByte((uint8_t *)eeprom_offsets::ADVANCE_PROFILE_ACTIVE, profileIndex);
 		sei();
+		eeprom::loadSettings();
+#ifdef JKN_ADVANCE
+		steppers::setAdvanceProfile(profileIndex);
+#endif
 
 		interface::popScreen();
 		interface::popScreen();
@@ -2121,22 +2249,39 @@ void ProfileSubMenu::handleSelect(uint8_t index) {
 		profileDisplaySettingsMenu.profileIndex = profileIndex;
 		interface::pushScreen(&profileDisplaySettingsMenu);
 		break;
-	case 2:
+	case 2: {
 		//Change Profile Name
-		profileChangeNameModeScreen.profileIndex = profileIndex;
-		interface::pushScreen(&profileChangeNameModeScreen);
+		ProfileChangeNameModeScreen *screen = overlayScreen<ProfileChangeNameModeScreen>();
+		screen->profileIndex = profileIndex;
+		interface::pushScreen(screen);
 		break;
+	}
 	case 3: //Save To Profile
 		//Get the home axis positions
 		cli();
-		eeprom_read_block((void *)homePosition,(void *)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
-		rightTemp = eeprom_read_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP));
-		leftTemp  = eeprom_read_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP));
-		hbpTemp   = eeprom_read_word((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP));
+		eeprom::readBlock((void *)homePosition,(void *)eeprom_offsets::AXIS_HOME_POSITIONS_STEPS, PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
+		rightTemp = eeprom::readWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP));
+		leftTemp  = eeprom::readWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_LEFT_TEMP));
+		hbpTemp   = eeprom::readWord((uint16_t *)(eeprom_offsets::PREHEAT_SETTINGS + preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP));
 		sei();
 
 		writeProfileToEeprom(profileIndex, NULL, homePosition, hbpTemp, rightTemp, leftTemp);
 
+		//And the JKN advance and deprime settings to its advance profile
+		{
+			uint16_t offset = eeprom_offsets::ADVANCE_PROFILES + (uint16_t)(profileIndex * ADVANCE_PROFILE_SIZE);
+			uint16_t accel2 = eeprom_offsets::ACCELERATION2_SETTINGS;
+
+			cli();
+			eeprom::writeDword((uint32_t *)(offset + advance_profile_offsets::JKN_ADVANCE_K),
+					   eeprom::readDword((uint32_t *)(accel2 + acceleration2_eeprom_offsets::JKN_ADVANCE_K)));
+			eeprom::writeDword((uint32_t *)(offset + advance_profile_offsets::JKN_ADVANCE_K2),
+					   eeprom::readDword((uint32_t *)(accel2 + acceleration2_eeprom_offsets::JKN_ADVANCE_K2)));
+			eeprom::writeWord((uint16_t *)(offset + advance_profile_offsets::DEPRIME_STEPS),
+					  eeprom::readWord((uint16_t *)(accel2 + acceleration2_eeprom_offsets::EXTRUDER_DEPRIME_STEPS)));
+			sei();
+		}
+
 		interface::popScreen();
 		interface::popScreen();
 		break;
@@ -2178,7 +2323,7 @@ void ProfileChangeNameModeScreen::notifyButtonPressed(ButtonArray::ButtonName bu
 		offset = eeprom_offsets::PROFILES_BASE + (uint16_t)(profileIndex * PROFILE_SIZE);
 
 		cli();
-		eeprom_write_block(profileName,(uint8_t*)offset, PROFILE_NAME_SIZE);
+		eeprom::writeBlock(profileName,(uint8_t*)offset, PROFILE_NAME_SIZE);
 		sei();
 
 		interface::popScreen();
@@ -2231,15 +2376,15 @@ void ProfileDisplaySettingsMenu::drawItem(uint8_t index, LiquidCrystalSerial& lc
 		break;
 	case 5:
 		lcd.writeFromPgmspace(PROFILE_RIGHT_MSG);
-		lcd.writeFloat((float)rightTemp, 0, LCD_SCREEN_WIDTH);
+		lcd.writeFixed(rightTemp, 0, LCD_SCREEN_WIDTH);
 		break;
 	case 6:
 		lcd.writeFromPgmspace(PROFILE_LEFT_MSG);
-		lcd.writeFloat((float)leftTemp, 0, LCD_SCREEN_WIDTH);
+		lcd.writeFixed(leftTemp, 0, LCD_SCREEN_WIDTH);
 		break;
 	case 7:
 		lcd.writeFromPgmspace(PROFILE_PLATFORM_MSG);
-		lcd.writeFloat((float)hbpTemp, 0, LCD_SCREEN_WIDTH);
+		lcd.writeFixed(hbpTemp, 0, LCD_SCREEN_WIDTH);
 		break;
 	}
 }
@@ -2284,6 +2429,10 @@ void EepromMenu::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
 		const static PROGMEM prog_uchar eeprom_dumpfnf[]     = DUMP_FILE " file" "not found";
 		const static PROGMEM prog_uchar eeprom_badrestore[]  = "Read failed; EEPROM " "may be corrupt";
 
+		// The SD card calls want the name in SRAM, but only in here
+		char dumpFilename[sizeof(DUMP_FILE)];
+		strcpy_P(dumpFilename, PSTR(DUMP_FILE));
+
 		switch ( itemSelected ) {
 		case 0:	//Dump
 			if ( ! sdcard::fileExists(dumpFilename) ) {
@@ -2434,7 +2583,7 @@ void HomeOffsetsModeScreen::reset() {
 	  msg = XYZTOOLHEAD_MSG;
      }
      cli();
-     eeprom_read_block(homePosition, (void *)offset,
+     eeprom::readBlock(homePosition, (void *)offset,
 		       PROFILES_HOME_POSITIONS_STORED * sizeof(uint32_t));
      sei();
 
@@ -2504,13 +2653,13 @@ void HomeOffsetsModeScreen::notifyButtonPressed(ButtonArray::ButtonName button)
 		{
 			int32_t saved_z=0;
 			cli();
-			eeprom_read_block(&saved_z, (void *)(offset + Z_AXIS * sizeof(int32_t)), sizeof(int32_t));
+			eeprom::readBlock(&saved_z, (void *)(offset + Z_AXIS * sizeof(int32_t)), sizeof(int32_t));
 			sei();
 			saved_z = saved_z - homePosition[currentIndex];
 			if(saved_z != 0)
 			{
 				homePosition[currentIndex] += saved_z;
-				steppers::z_Offset_Change += saved_z;
+				steppers::changeZOffset(saved_z);
 			}
 		}
 		interface::popScreen();
@@ -2518,7 +2667,7 @@ void HomeOffsetsModeScreen::notifyButtonPressed(ButtonArray::ButtonName button)
 	case ButtonArray::CENTER:
 		if ( valueChanged ) {
 		     cli();
-		     eeprom_write_block(
+		     eeprom::writeBlock(
 			  (void *)&homePosition[currentIndex],
 			  (void*)(offset + sizeof(uint32_t) * currentIndex),
 			  sizeof(uint32_t));
@@ -2538,7 +2687,7 @@ void HomeOffsetsModeScreen::notifyButtonPressed(ButtonArray::ButtonName button)
 		homePosition[currentIndex] += incr;
 		valueChanged = true;
 		if(do_home_offsets == 4) // live z change during a print
-			steppers::z_Offset_Change += incr;
+			steppers::changeZOffset(incr);
 		break;
 	case ButtonArray::RIGHT:
 		// RESET
@@ -2729,7 +2878,7 @@ void MaxZDiffScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	{
 	     int32_t max_zdelta = stepperAxisMMToSteps(fmax_zdelta, Z_AXIS);
 	     cli();
-	     eeprom_write_block(&max_zdelta, (uint8_t *)eeprom_offsets::ALEVEL_MAX_ZDELTA,
+	     eeprom::writeBlock(&max_zdelta, (uint8_t *)eeprom_offsets::ALEVEL_MAX_ZDELTA,
 				sizeof(int32_t));
 	     sei();
 	}
@@ -2807,7 +2956,7 @@ void MaxZProbeHitsScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	       // value has changed
 	       command::max_zprobe_hits = new_value;
 	       cli();
-	       eeprom_write_block((void *)&command::max_zprobe_hits,
+	       eeprom::writeBlock((void *)&command::max_zprobe_hits,
 				  (uint8_t *)eeprom_offsets::ALEVEL_MAX_ZPROBE_HITS,
 				  sizeof(uint8_t));
 	       sei();
@@ -2886,7 +3035,6 @@ void ChangeExtrusionScreen::notifyButtonPressed(ButtonArray::ButtonName button)
 
 void ChangeSpeedScreen::reset() {
 	speedFactor = steppers::speedFactor;
-	alterSpeed = steppers::alterSpeed;
 }
 
 void ChangeSpeedScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
@@ -2908,8 +3056,7 @@ void ChangeSpeedScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	switch (button) {
 	case ButtonArray::LEFT:
 		// Treat as a cancel
-		steppers::alterSpeed  = alterSpeed;
-		steppers::speedFactor = speedFactor;
+		steppers::setSpeedFactor(speedFactor);
 		// FALL THROUGH
 	case ButtonArray::CENTER:
 		interface::popScreen();
@@ -2930,8 +3077,8 @@ void ChangeSpeedScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	if ( sf > KCONSTANT_5 ) sf = KCONSTANT_5;
 	else if ( sf < KCONSTANT_0_1 ) sf = KCONSTANT_0_1;
 
-	steppers::alterSpeed  = (sf == KCONSTANT_1) ? 0x00 : 0x80;
-	steppers::speedFactor = sf;
+	// The moves already planned take it up too, the one being stepped at once
+	steppers::setSpeedFactor(sf);
 }
 
 void ChangeTempScreen::reset() {
@@ -3100,8 +3247,9 @@ void CoolingFanPwmScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 
 	switch (button) {
 	case ButtonArray::CENTER:
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::COOLING_FAN_DUTY_CYCLE,
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::COOLING_FAN_DUTY_CYCLE,
 			       fan_pwm);
+	     eeprom::loadSettings();
 	// FALL THROUGH
 	case ButtonArray::LEFT:
 		interface::popScreen();
@@ -3286,7 +3434,7 @@ void ActiveBuildMenu::handleSelect(uint8_t index) {
 	if ( is_paused && !is_heating ) {
 		if ( index == lind ) {
 		        jog_paused = true;
-			interface::pushScreen(&jogModeScreen);
+			interface::pushScreen(overlayScreen<JogModeScreen>());
 			return;
 		}
 		lind++;
@@ -3319,33 +3467,33 @@ void ActiveBuildMenu::handleSelect(uint8_t index) {
 
 	if ( !is_paused ) {
 		if ( index == lind ) {
-			interface::pushScreen(&pauseAtZPosScreen);
+			interface::pushScreen(overlayScreen<PauseAtZPosScreen>());
 			return;
 		}
 		lind++;
 	}
 
 	if ( index == lind ) {
-		interface::pushScreen(&changeExtrusionScreen);
+		interface::pushScreen(overlayScreen<ChangeExtrusionScreen>());
 		return;
 	}
 
 	lind++;
 	if ( index == lind ) {
-		interface::pushScreen(&changeSpeedScreen);
+		interface::pushScreen(overlayScreen<ChangeSpeedScreen>());
 		return;
 	}
 	lind++;
 
 	if ( index == lind ) {
-		interface::pushScreen(&changeTempScreen);
+		interface::pushScreen(overlayScreen<ChangeTempScreen>());
 		return;
 	}
 	lind++;
 
 	if (eeprom::hasHBP()) {
 		if ( index == lind ) {
-			interface::pushScreen(&changePlatformTempScreen);
+			interface::pushScreen(overlayScreen<ChangePlatformTempScreen>());
 			return;
 		}
 		lind++;
@@ -3395,7 +3543,7 @@ void ActiveBuildMenu::handleSelect(uint8_t index) {
 #endif
 
 	if ( index == lind ) {
-		interface::pushScreen(&buildStatsScreen);
+		interface::pushScreen(overlayScreen<BuildStatsScreen>());
 		return;
 	}
 	lind++;
@@ -3409,50 +3557,152 @@ void ActiveBuildMenu::handleSelect(uint8_t index) {
 		}
 		lind++;
 		if ( index == lind ) {
-		homeOffsetsModeScreen.do_home_offsets = 4;
-		interface::pushScreen(&homeOffsetsModeScreen);
+		interface::pushScreen(homeOffsetsModeScreen(4));
 		}
 		lind++;
 	}
 }
 
-void BuildStatsScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw){
+#if defined(SD_PLAYBACK_STATS)
 
-	if (forceRedraw) {
+// The second page of the print statistics: SD card chunk look ups, KB played
+// back, the longest look up in us, and the CRC retries and number of times
+// the command buffer ran dry
+
+void BuildStatsScreen::updateSdStats(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	const static PROGMEM prog_uchar sd_labels[] = "SD reads  KBytes    Max us    CRC       Empty ";
+	sdcard::PlaybackStats stats;
+
+	if ( forceRedraw ) {
 		lcd.clearHomeCursor();
-		lcd.writeFromPgmspace(BUILD_TIME_MSG);
-#if defined(ESTIMATE_TIME)
-		lcd.moveWriteFromPgmspace(0, 1, MON_TIME_LEFT_MSG);
-#endif
-		lcd.moveWriteFromPgmspace(0, 2, FILAMENT_MSG);
-#if !defined(AUTO_LEVEL)
-		lcd.moveWriteFromPgmspace(0, 3, Z_POSITION_MSG);
-#endif
+		for ( uint8_t i = 0; i < 3; i ++ ) {
+			lcd.setCursor(0, i);
+			for ( uint8_t c = 0; c < 10; c ++ )
+				lcd.write(pgm_read_byte(&sd_labels[i * 10 + c]));
+		}
+		lcd.setCursor(0, 3);
+		for ( uint8_t c = 30; c < 46; c ++ )
+			lcd.write(pgm_read_byte(&sd_labels[c]));
 	}
 
-	Point position;
+	sdcard::getPlaybackStats(&stats);
+	lcd.setCursor(11, 0);
+	lcd.writeInt32(stats.fetches, 9);
+	lcd.setCursor(11, 1);
+	lcd.writeInt32(stats.bytes >> 10, 9);
+	lcd.setCursor(11, 2);
+	lcd.writeInt32(stats.max_micros, 9);
+	lcd.moveWriteInt(4, 3, stats.crc_retries, 5);
+	lcd.moveWriteInt(16, 3, stats.starved, 4);
+}
 
-	switch (update_count) {
+#endif
 
-	// Elapsed time
-	case 0:
-		uint16_t build_hours;
-		uint8_t build_minutes;
-		host::getPrintTime(build_hours, build_minutes);
+#if defined(SD_PRESCAN)
 
-		lcd.moveWriteInt(12, 0, build_hours, 4);
-		lcd.moveWriteInt(17, 0, build_minutes, 2);
+// What the pre-scan found in the file: its layers, the height of the top
+// one, the filament and the time of the moves at their own feed rates,
+// with the values left blank until the scan has reached the end
 
-		break;
+void BuildStatsScreen::updateScanStats(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	const static PROGMEM prog_uchar scan_labels[] = "Layers    Height    Filament  Time      ";
+	const prescan::Results *r = prescan::results();
 
-	// Time left estimate
-	case 1:
-#if defined(ESTIMATE_TIME)
-	        writeTimeLeft(lcd, 1);
-		break;
-#else
-		// Fall thru to case 2
-#endif
+	if ( forceRedraw ) {
+		lcd.clearHomeCursor();
+		for ( uint8_t i = 0; i < 4; i ++ ) {
+			lcd.setCursor(0, i);
+			for ( uint8_t c = 0; c < 10; c ++ )
+				lcd.write(pgm_read_byte(&scan_labels[i * 10 + c]));
+		}
+	}
+	if ( !r )
+		return;
+
+	lcd.moveWriteInt(15, 0, r->layers, 5);
+	lcd.setCursor(10, 1);
+	lcd.writeFloat(stepperAxisStepsToMM(r->z_max, Z_AXIS), 2, LCD_SCREEN_WIDTH - 2);
+	lcd.writeFromPgmspace(MILLIMETERS_MSG);
+	lcd.setCursor(10, 2);
+	writeFilamentUsed(lcd, stepperAxisStepsToMM(r->filament[0], A_AXIS) +
+			  stepperAxisStepsToMM(r->filament[1], B_AXIS));
+
+	uint32_t minutes = r->millis[PRESCAN_PROFILE - 1] / 60000L;
+	lcd.moveWriteInt(12, 3, (uint16_t)(minutes / 60), 4);
+	lcd.write(':');
+	lcd.writeInt((uint16_t)(minutes % 60), 2);
+}
+
+#endif
+
+// The pages of the print statistics, cycled through with up and down
+enum {
+	BUILD_STATS_PAGE_MAIN,
+#if defined(SD_PLAYBACK_STATS)
+	BUILD_STATS_PAGE_SD,
+#endif
+#if defined(SD_PRESCAN)
+	BUILD_STATS_PAGE_SCAN,
+#endif
+	BUILD_STATS_PAGES
+};
+
+void BuildStatsScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw){
+
+#if defined(SD_PLAYBACK_STATS) || defined(SD_PRESCAN)
+	if ( needsRedraw ) {
+		forceRedraw = true;
+		needsRedraw = false;
+	}
+#endif
+#if defined(SD_PLAYBACK_STATS)
+	if ( page == BUILD_STATS_PAGE_SD ) {
+		updateSdStats(lcd, forceRedraw);
+		return;
+	}
+#endif
+#if defined(SD_PRESCAN)
+	if ( page == BUILD_STATS_PAGE_SCAN ) {
+		updateScanStats(lcd, forceRedraw);
+		return;
+	}
+#endif
+
+	if (forceRedraw) {
+		lcd.clearHomeCursor();
+		lcd.writeFromPgmspace(BUILD_TIME_MSG);
+#if defined(ESTIMATE_TIME)
+		lcd.moveWriteFromPgmspace(0, 1, MON_TIME_LEFT_MSG);
+#endif
+		lcd.moveWriteFromPgmspace(0, 2, FILAMENT_MSG);
+#if !defined(AUTO_LEVEL)
+		lcd.moveWriteFromPgmspace(0, 3, Z_POSITION_MSG);
+#endif
+	}
+
+	Point position;
+
+	switch (update_count) {
+
+	// Elapsed time
+	case 0:
+		uint16_t build_hours;
+		uint8_t build_minutes;
+		host::getPrintTime(build_hours, build_minutes);
+
+		lcd.moveWriteInt(12, 0, build_hours, 4);
+		lcd.moveWriteInt(17, 0, build_minutes, 2);
+
+		break;
+
+	// Time left estimate
+	case 1:
+#if defined(ESTIMATE_TIME)
+	        writeTimeLeft(lcd, 1);
+		break;
+#else
+		// Fall thru to case 2
+#endif
 
 	// Filament used
 	case 2:
@@ -3509,6 +3759,10 @@ void BuildStatsScreen::reset() {
 #if defined(AUTO_LEVEL)
 	flip_flop = 0;
 #endif
+#if defined(SD_PLAYBACK_STATS) || defined(SD_PRESCAN)
+	page = BUILD_STATS_PAGE_MAIN;
+	needsRedraw = false;
+#endif
 }
 
 void BuildStatsScreen::notifyButtonPressed(ButtonArray::ButtonName button){
@@ -3518,6 +3772,19 @@ void BuildStatsScreen::notifyButtonPressed(ButtonArray::ButtonName button){
 	case ButtonArray::LEFT:
 		interface::popScreen();
 		break;
+#if defined(SD_PLAYBACK_STATS) || defined(SD_PRESCAN)
+	case ButtonArray::UP:
+		page = page ? page - 1 : BUILD_STATS_PAGES - 1;
+		update_count = 0;
+		needsRedraw = true;
+		break;
+	case ButtonArray::DOWN:
+		if ( ++page >= BUILD_STATS_PAGES )
+			page = BUILD_STATS_PAGE_MAIN;
+		update_count = 0;
+		needsRedraw = true;
+		break;
+#endif
 	default:
 		break;
 	}
@@ -3591,6 +3858,10 @@ MainMenu::MainMenu() :
 void MainMenu::resetState() {
 	itemIndex = 1;
 	firstItemIndex = 1;
+#ifdef POWER_LOSS_RESUME
+	// Offered only after a build was cut short
+	itemCount = checkpoint::available() ? 5 : 4;
+#endif
 }
 
 void MainMenu::drawItem(uint8_t index, LiquidCrystalSerial& lcd) {
@@ -3616,6 +3887,11 @@ void MainMenu::drawItem(uint8_t index, LiquidCrystalSerial& lcd) {
 	case 3:
 		msg = UTILITIES_MSG;
 		break;
+#ifdef POWER_LOSS_RESUME
+	case 4:
+		msg = RESUME_BUILD_MSG;
+		break;
+#endif
 	}
 	lcd.writeFromPgmspace(msg);
 }
@@ -3634,6 +3910,13 @@ void MainMenu::handleSelect(uint8_t index) {
 		// home axes script
 		interface::pushScreen(&utilityMenu);
 		return;
+#ifdef POWER_LOSS_RESUME
+	case 4:
+		if ( checkpoint::resume() == sdcard::SD_SUCCESS )
+			return;
+		MenuBadness((sdcard::sdAvailable == sdcard::SD_ERR_CRC) ? CARDCRC_MSG : CARDOPENERR_MSG);
+		return;
+#endif
 	}
 }
 
@@ -3649,6 +3932,15 @@ UtilitiesMenu::UtilitiesMenu() :
 #if defined(EEPROM_MENU_ENABLE)
 	     + 1
 #endif
+#if defined(ISR_PROFILE)
+	     + 1
+#endif
+#if defined(MEMORY_PROFILE)
+	     + 1
+#endif
+#if defined(PID_AUTOTUNE)
+	     + 1
+#endif
 #if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
 		 + 1
 #endif
@@ -3678,6 +3970,15 @@ void UtilitiesMenu::resetState() {
 #if defined(EEPROM_MENU_ENABLE)
 	     1 +
 #endif
+#if defined(ISR_PROFILE)
+	     1 +
+#endif
+#if defined(MEMORY_PROFILE)
+	     1 +
+#endif
+#if defined(PID_AUTOTUNE)
+	     1 +
+#endif
 #if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
 		 1 +
 #endif
@@ -3790,6 +4091,21 @@ void UtilitiesMenu::drawItem(uint8_t index, LiquidCrystalSerial& lcd) {
 	lind++;
 #endif
 
+#if defined(ISR_PROFILE)
+	if ( index == lind ) msg = ISR_PROFILE_MSG;
+	lind++;
+#endif
+
+#if defined(MEMORY_PROFILE)
+	if ( index == lind ) msg = MEMORY_PROFILE_MSG;
+	lind++;
+#endif
+
+#if defined(PID_AUTOTUNE)
+	if ( index == lind ) msg = AUTOTUNE_MSG;
+	lind++;
+#endif
+
 	// ------ next screen ------
 
 	if ( index == lind ) msg = VERSION_MSG;
@@ -3846,13 +4162,13 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 
 	if ( index == lind ) {
 		// bot stats
-		interface::pushScreen(&botStatsScreen);
+		interface::pushScreen(overlayScreen<BotStatsScreen>());
 	}
 	lind++;
 
 	if ( index == lind ) {
 		// Filament Odometer
-		interface::pushScreen(&filamentOdometerScreen);
+		interface::pushScreen(overlayScreen<FilamentOdometerScreen>());
 	}
 	lind++;
 
@@ -3864,8 +4180,7 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 
 	if ( index == lind ) {
 	     // Home Offsets
-	     homeOffsetsModeScreen.do_home_offsets = 1;
-	     interface::pushScreen(&homeOffsetsModeScreen);
+	     interface::pushScreen(homeOffsetsModeScreen(1));
 	}
 	lind++;
 
@@ -3873,8 +4188,7 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 	if ( !singleTool ) {
 	     if ( index == lind ) {
 		  // Toolhead Offsets
-		  homeOffsetsModeScreen.do_home_offsets = 0;
-		  interface::pushScreen(&homeOffsetsModeScreen);
+		  interface::pushScreen(homeOffsetsModeScreen(0));
 	     }
 	     lind++;
 	}
@@ -3882,7 +4196,7 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 
 #if BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
 	if ( index == lind ) {
-		interface::pushScreen(&thermistorScreen);
+		interface::pushScreen(overlayScreen<ThermistorScreen>());
 	}
 	lind++;
 #endif
@@ -3890,7 +4204,7 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 	if ( index == lind ) {
 		// Jog axes
 		jog_paused = false;
-		interface::pushScreen(&jogModeScreen);
+		interface::pushScreen(overlayScreen<JogModeScreen>());
 	}
 	lind++;
 
@@ -3904,26 +4218,24 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 #if defined(AUTO_LEVEL)
 	if ( index == lind ) {
 	     // Leveling compensation values for P1, P2 and P3
-	     homeOffsetsModeScreen.do_home_offsets = 2;
-	     interface::pushScreen(&homeOffsetsModeScreen);
+	     interface::pushScreen(homeOffsetsModeScreen(2));
 	}
 	lind++;
 
 	if ( index == lind ) {
-	     interface::pushScreen(&alevelZDiffScreen);
+	     interface::pushScreen(overlayScreen<MaxZDiffScreen>());
 	}
 	lind++;
 
 	if ( index == lind ) {
 	     // Probe offsets for X and Y
-	     homeOffsetsModeScreen.do_home_offsets = 3;
-	     interface::pushScreen(&homeOffsetsModeScreen);
+	     interface::pushScreen(homeOffsetsModeScreen(3));
 	}
 	lind++;
 
 #if defined(PSTOP_SUPPORT) && defined(PSTOP_ZMIN_LEVEL)
 	if ( index == lind ) {
-	     interface::pushScreen(&maxZProbeHitsScreen);
+	     interface::pushScreen(overlayScreen<MaxZProbeHitsScreen>());
 	}
 	lind++;
 #endif
@@ -3945,7 +4257,7 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 
 #if defined(COOLING_FAN_PWM) || defined(COOLING_FAN_PWM_ON_DISPLAY)
 	if ( index == lind ) {
-	     interface::pushScreen(&coolingFanPwmScreen);
+	     interface::pushScreen(overlayScreen<CoolingFanPwmScreen>());
 	}
 	lind++;
 #endif
@@ -3962,6 +4274,27 @@ void UtilitiesMenu::handleSelect(uint8_t index) {
 	lind++;
 #endif
 
+#if defined(ISR_PROFILE)
+	if ( index == lind ) {
+	     interface::pushScreen(overlayScreen<IsrProfileScreen>());
+	}
+	lind++;
+#endif
+
+#if defined(MEMORY_PROFILE)
+	if ( index == lind ) {
+	     interface::pushScreen(overlayScreen<MemoryProfileScreen>());
+	}
+	lind++;
+#endif
+
+#if defined(PID_AUTOTUNE)
+	if ( index == lind ) {
+	     interface::pushScreen(overlayScreen<AutotuneScreen>());
+	}
+	lind++;
+#endif
+
 	if ( index == lind ) {
 	     splashScreen.hold_on = true;
 	     interface::pushScreen(&splashScreen);
@@ -4009,15 +4342,308 @@ void BotStatsScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
 	  interface::popScreen();
 }
 
+#ifdef ISR_PROFILE
+
+// Interrupt execution times, paged with UP/DOWN:
+//   0: min/avg/max time in us
+//   1: % of calls in each histogram bucket (<16us, <64us, <256us, >=256us)
+//   2: number of calls recorded, and stepper interrupt overruns
+// then the same again for the interrupts which didn't fit on the screen.
+// CENTER resets the statistics
+
+#define ISR_PROFILE_PAGES 3
+#define ISR_PROFILE_GROUPS ((ISR_PROFILE_SOURCES + LCD_SCREEN_HEIGHT - 1) / LCD_SCREEN_HEIGHT)
+
+void IsrProfileScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	const static PROGMEM prog_uchar isr_names[] = "StpExtBlkADCURx";
+	const static PROGMEM prog_uchar isr_overruns[] = " Ovr ";
+	isr_profile_t profile;
+
+	if ( forceRedraw || needsRedraw ) {
+		lcd.clearHomeCursor();
+		needsRedraw = false;
+	}
+
+	uint8_t first = (page / ISR_PROFILE_PAGES) * LCD_SCREEN_HEIGHT;
+	for ( uint8_t row = 0; row < LCD_SCREEN_HEIGHT; row ++ ) {
+		uint8_t i = first + row;
+		if ( ! isr_profile_get(i, &profile) ) break;
+
+		lcd.setCursor(0, row);
+		for ( uint8_t c = 0; c < 3; c ++ )
+			lcd.write(pgm_read_byte(&isr_names[i * 3 + c]));
+
+		switch ( page % ISR_PROFILE_PAGES ) {
+		case 0:
+			// Ticks are 0.5us
+			lcd.write(' ');
+			lcd.writeInt(( profile.count ) ? profile.min_ticks >> 1 : 0, 5);
+			lcd.write(' ');
+			lcd.writeInt(( profile.count ) ? (uint16_t)((profile.total_ticks / profile.count) >> 1) : 0, 5);
+			lcd.write(' ');
+			lcd.writeInt(profile.max_ticks >> 1, 5);
+			break;
+		case 1:
+			for ( uint8_t b = 0; b < ISR_PROFILE_BUCKETS; b ++ ) {
+				lcd.write(' ');
+				lcd.writeInt(( profile.count ) ? (uint16_t)(((uint32_t)profile.histogram[b] * 100) / profile.count) : 0, 3);
+			}
+			break;
+		default:
+			lcd.write(' ');
+			lcd.writeInt(profile.count, 5);
+			if ( i == ISR_PROFILE_ST_INTERRUPT ) {
+				lcd.writeFromPgmspace(isr_overruns);
+				lcd.writeInt(isr_profile_overruns, 5);
+			}
+			break;
+		}
+	}
+}
+
+void IsrProfileScreen::reset() {
+	page = 0;
+	needsRedraw = false;
+}
+
+void IsrProfileScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
+	switch (button) {
+	case ButtonArray::CENTER:
+		isr_profile_reset();
+		break;
+	case ButtonArray::UP:
+		page = ( page == 0 ) ? ISR_PROFILE_PAGES * ISR_PROFILE_GROUPS - 1 : page - 1;
+		needsRedraw = true;
+		break;
+	case ButtonArray::DOWN:
+		if ( ++page >= ISR_PROFILE_PAGES * ISR_PROFILE_GROUPS ) page = 0;
+		needsRedraw = true;
+		break;
+	case ButtonArray::LEFT:
+		interface::popScreen();
+		break;
+	default:
+		break;
+	}
+}
+
+#endif
+
+#ifdef MEMORY_PROFILE
+
+// SRAM use in bytes, paged with UP/DOWN:
+//   0: static SRAM, the deepest the stack has been, the headroom it has
+//      never touched and what's free below it now
+//   1: the static SRAM of the planner, command buffer, LCD and host packets
+//   2: the headroom sampled every MEMORY_PROFILE_SAMPLE_S seconds, oldest
+//      first
+// CENTER paints the free SRAM again and clears the samples
+
+#define MEMORY_PROFILE_PAGES 3
+#define MEMORY_PROFILE_NAME_LEN 9
+
+void MemoryProfileScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	const static PROGMEM prog_uchar totals_names[] = "Static   Stack    Headroom Free now ";
+	const static PROGMEM prog_uchar subsystem_names[] = "Planner  Commands LCD      Packets  ";
+
+	if ( forceRedraw || needsRedraw ) {
+		lcd.clearHomeCursor();
+		needsRedraw = false;
+	}
+
+	if ( page == 2 ) {
+		uint16_t samples[MEMORY_PROFILE_HISTORY];
+		uint8_t count = memory_profile_history(samples);
+		for ( uint8_t i = 0; i < count; i ++ ) {
+			lcd.setCursor((i & 1) * (LCD_SCREEN_WIDTH / 2), i >> 1);
+			lcd.writeInt(samples[i], 5);
+		}
+		return;
+	}
+
+	memory_profile_t profile;
+	if ( page == 0 )
+		memory_profile_get(&profile);
+
+	const prog_uchar *names = ( page == 0 ) ? totals_names : subsystem_names;
+	for ( uint8_t row = 0; row < LCD_SCREEN_HEIGHT; row ++ ) {
+		uint16_t value;
+		if ( page == 0 ) {
+			switch ( row ) {
+			case 0:  value = profile.static_bytes; break;
+			case 1:  value = profile.stack; break;
+			case 2:  value = profile.headroom; break;
+			default: value = profile.free_now; break;
+			}
+		}
+		else
+			value = memory_profile_subsystem(row);
+
+		lcd.setCursor(0, row);
+		for ( uint8_t c = 0; c < MEMORY_PROFILE_NAME_LEN; c ++ )
+			lcd.write(pgm_read_byte(&names[row * MEMORY_PROFILE_NAME_LEN + c]));
+		lcd.writeInt(value, 5);
+	}
+}
+
+void MemoryProfileScreen::reset() {
+	page = 0;
+	needsRedraw = false;
+}
+
+void MemoryProfileScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
+	switch (button) {
+	case ButtonArray::CENTER:
+		memory_profile_reset();
+		needsRedraw = true;
+		break;
+	case ButtonArray::UP:
+		page = ( page == 0 ) ? MEMORY_PROFILE_PAGES - 1 : page - 1;
+		needsRedraw = true;
+		break;
+	case ButtonArray::DOWN:
+		if ( ++page >= MEMORY_PROFILE_PAGES ) page = 0;
+		needsRedraw = true;
+		break;
+	case ButtonArray::LEFT:
+		interface::popScreen();
+		break;
+	default:
+		break;
+	}
+}
+
+#endif
+
+#ifdef PID_AUTOTUNE
+
+// Relay autotune of one heater.  RIGHT picks the heater and UP/DOWN the
+// temperature to tune about, CENTER starts and stops the tune.  The tune
+// carries on if the screen is left.
+
+static Heater& autotuneHeater(uint8_t heater) {
+	Motherboard& board = Motherboard::getBoard();
+	return ( heater == 2 ) ? board.getPlatformHeater() :
+		board.getExtruderBoard(heater).getExtruderHeater();
+}
+
+// Start from the heater's preheat temperature
+void AutotuneScreen::setTarget() {
+	uint16_t offset = ( heater == 0 ) ? preheat_eeprom_offsets::PREHEAT_RIGHT_TEMP :
+		( heater == 1 ) ? preheat_eeprom_offsets::PREHEAT_LEFT_TEMP :
+		preheat_eeprom_offsets::PREHEAT_PLATFORM_TEMP;
+	target = eeprom::getEeprom16(eeprom_offsets::PREHEAT_SETTINGS + offset,
+				     ( heater == 2 ) ? 100 : DEFAULT_PREHEAT_TEMP);
+	if ( target == 0 ) target = 100;
+}
+
+void AutotuneScreen::update(LiquidCrystalSerial& lcd, bool forceRedraw) {
+	Heater& h = autotuneHeater(heater);
+	uint8_t state = h.getAutotuneState();
+
+	// Messages and gains differ in length, so start again when they change
+	if ( forceRedraw || needsRedraw || state != lastState ) {
+		lcd.clearHomeCursor();
+		lcd.writeFromPgmspace(AUTOTUNE_MSG);
+		needsRedraw = false;
+		lastState = state;
+	}
+
+	lcd.setRow(1);
+	if ( heater == 2 ) lcd.writeFromPgmspace(PLATFORM_MSG);
+	else {
+		lcd.writeFromPgmspace(TOOL_MSG);
+		lcd.write(' ');
+		lcd.write('0' + heater);
+	}
+	lcd.moveWriteInt(15, 1, target, 3);
+	lcd.write('C');
+
+	lcd.setRow(2);
+	switch ( state ) {
+	case HEATER_TUNE_RUNNING:
+		lcd.writeFromPgmspace(AUTOTUNE_RUNNING_MSG);
+		lcd.writeInt(h.getAutotuneCycles(), 2);
+		lcd.write(' ');
+		lcd.writeInt(h.get_current_temperature(), 3);
+		lcd.write('C');
+		break;
+	case HEATER_TUNE_DONE:
+		lcd.writeFromPgmspace(AUTOTUNE_DONE_MSG);
+		break;
+	case HEATER_TUNE_FAILED:
+		lcd.writeFromPgmspace(AUTOTUNE_FAILED_MSG);
+		break;
+	default:
+		lcd.writeFromPgmspace(AUTOTUNE_IDLE_MSG);
+		break;
+	}
+
+	// The gains in use
+	lcd.setRow(3);
+	lcd.write('P');
+	lcd.writeFloat(h.getPIDGain(pid_eeprom_offsets::P_TERM_OFFSET), 2, 7);
+	lcd.setCursor(8, 3);
+	lcd.write('I');
+	lcd.writeFloat(h.getPIDGain(pid_eeprom_offsets::I_TERM_OFFSET), 2, 14);
+	lcd.setCursor(15, 3);
+	lcd.write('D');
+	lcd.writeFloat(h.getPIDGain(pid_eeprom_offsets::D_TERM_OFFSET), 0, 20);
+}
+
+void AutotuneScreen::reset() {
+	heater = 0;
+	needsRedraw = false;
+	lastState = HEATER_TUNE_IDLE;
+	setTarget();
+}
+
+void AutotuneScreen::notifyButtonPressed(ButtonArray::ButtonName button) {
+	Heater& h = autotuneHeater(heater);
+	bool running = h.getAutotuneState() == HEATER_TUNE_RUNNING;
+
+	switch (button) {
+	case ButtonArray::CENTER:
+		if ( running ) h.abortAutotune();
+		else h.startAutotune(target, AUTOTUNE_CYCLES);
+		break;
+	case ButtonArray::RIGHT:
+		if ( running ) break;
+		do {
+			if ( ++heater > 2 ) heater = 0;
+		} while ( (heater == 1 && eeprom::isSingleTool()) ||
+			  (heater == 2 && !eeprom::hasHBP()) );
+		setTarget();
+		needsRedraw = true;
+		break;
+	case ButtonArray::UP:
+		if ( !running ) target += 5;
+		break;
+	case ButtonArray::DOWN:
+		if ( !running && target > 5 ) target -= 5;
+		break;
+	case ButtonArray::LEFT:
+		interface::popScreen();
+		break;
+	default:
+		break;
+	}
+}
+
+#endif
+
 SettingsMenu::SettingsMenu() :
 	CounterMenu(_BV((uint8_t)ButtonArray::UP) | _BV((uint8_t)ButtonArray::DOWN),
-				(uint8_t)7
+				(uint8_t)8
 #if EXTRUDERS > 1
 				+ 1
 #endif
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
 				+ 1
 #endif
+#ifdef FAST_CANCEL
+				+ 1
+#endif
 #ifdef PSTOP_SUPPORT
 				+ 2
 #endif
@@ -4065,6 +4691,11 @@ void SettingsMenu::resetState() {
 	extruderHoldOn = 0 != eeprom::getEeprom8(eeprom_offsets::EXTRUDER_HOLD,
 						 DEFAULT_EXTRUDER_HOLD);
 	useCRC = 1 == eeprom::getEeprom8(eeprom_offsets::SD_USE_CRC, DEFAULT_SD_USE_CRC);
+	printPriorityOn = 0 != eeprom::getEeprom8(eeprom_offsets::UI_PRINT_PRIORITY,
+						  DEFAULT_UI_PRINT_PRIORITY);
+#ifdef FAST_CANCEL
+	fastCancelOn = 0 != eeprom::getEeprom8(eeprom_offsets::FAST_CANCEL_ENABLE, 0);
+#endif
 #ifdef PSTOP_SUPPORT
 	pstopEnabled  = pstop_enabled == 1;
 	pstopInverted = pstop_value == 1;
@@ -4160,6 +4791,20 @@ void SettingsMenu::drawItem(uint8_t index, LiquidCrystalSerial& lcd) {
 	}
 	lind++;
 
+	if ( index == lind ) {
+	     msg = PRINT_PRIORITY_MSG;
+	     test = printPriorityOn;
+	}
+	lind++;
+
+#ifdef FAST_CANCEL
+	if ( index == lind ) {
+	     msg = FAST_CANCEL_MSG;
+	     test = fastCancelOn;
+	}
+	lind++;
+#endif
+
 #ifdef PSTOP_SUPPORT
 	if ( index == lind ) {
 	     msg = PSTOP_ENABLE_MSG;
@@ -4288,6 +4933,18 @@ void SettingsMenu::handleCounterUpdate(uint8_t index, int8_t up) {
 	}
 	lind++;
 
+	if ( index == lind ) {
+	     printPriorityOn = !printPriorityOn;
+	}
+	lind++;
+
+#ifdef FAST_CANCEL
+	if ( index == lind ) {
+	     fastCancelOn = !fastCancelOn;
+	}
+	lind++;
+#endif
+
 #ifdef PSTOP_SUPPORT
 	if ( index == lind ) {
 	     pstopEnabled = !pstopEnabled;
@@ -4338,12 +4995,11 @@ void SettingsMenu::handleSelect(uint8_t index) {
 
 #define SETTINGS_LINEUPDATE 0x01
 #define SETTINGS_COMMANDRST 0x02
-#define SETTINGS_STEPPERRST 0x04
 
 #if defined(DITTO_PRINT) && EXTRUDERS > 1
 	if ( index == lind ) {
 	     if ( !singleExtruder ) {
-		  eeprom_write_byte((uint8_t*)eeprom_offsets::DITTO_PRINT_ENABLED,
+		  eeprom::writeByte((uint8_t*)eeprom_offsets::DITTO_PRINT_ENABLED,
 				    dittoPrintOn ? 1 : 0);
 		  flags = SETTINGS_COMMANDRST | SETTINGS_LINEUPDATE;
 	     }
@@ -4352,21 +5008,21 @@ void SettingsMenu::handleSelect(uint8_t index) {
 #endif
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t *)eeprom_offsets::OVERRIDE_GCODE_TEMP,
+	     eeprom::writeByte((uint8_t *)eeprom_offsets::OVERRIDE_GCODE_TEMP,
 			       overrideGcodeTempOn ? 1 : 0);
 	     flags = SETTINGS_LINEUPDATE;
 	}
 	lind++;
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::HEAT_DURING_PAUSE,
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::HEAT_DURING_PAUSE,
 			       pauseHeatOn ? 1 : 0);
 	     flags = SETTINGS_LINEUPDATE;
 	}
 	lind++;
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::BUZZ_SETTINGS,
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::BUZZ_SETTINGS,
 			       soundOn ? 1 : 0);
 	     Piezo::reset();
 	     flags = SETTINGS_LINEUPDATE;
@@ -4374,10 +5030,11 @@ void SettingsMenu::handleSelect(uint8_t index) {
 	lind++;
 
 	if ( index == lind ) {
-		eeprom_write_byte((uint8_t*)eeprom_offsets::ACCELERATION_SETTINGS +
+		eeprom::writeByte((uint8_t*)eeprom_offsets::ACCELERATION_SETTINGS +
 				  acceleration_eeprom_offsets::ACCELERATION_ACTIVE,
 				  accelerationOn ? 1 : 0);
-		flags = SETTINGS_LINEUPDATE | SETTINGS_STEPPERRST;
+		steppers::applyAccelerationSettings();
+		flags = SETTINGS_LINEUPDATE;
 	}
 	lind++;
 
@@ -4392,7 +5049,7 @@ void SettingsMenu::handleSelect(uint8_t index) {
 #endif
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::HBP_PRESENT, hasHBP ? 1 : 0);
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::HBP_PRESENT, hasHBP ? 1 : 0);
 	     if ( !hasHBP )
 		  Motherboard::getBoard().getPlatformHeater().set_target_temperature(0);
 	     flags = SETTINGS_COMMANDRST | SETTINGS_LINEUPDATE;
@@ -4400,14 +5057,14 @@ void SettingsMenu::handleSelect(uint8_t index) {
 	lind++;
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::EXTRUDER_HOLD,
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::EXTRUDER_HOLD,
 			       extruderHoldOn ? 1 : 0);
 	     flags = SETTINGS_COMMANDRST | SETTINGS_LINEUPDATE;
 	}
 	lind++;
 
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::SD_USE_CRC,
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::SD_USE_CRC,
 			       useCRC ? 1 : 0);
 #ifndef BROKEN_SD
 	     sdcard::mustReinit = true;
@@ -4416,10 +5073,27 @@ void SettingsMenu::handleSelect(uint8_t index) {
 	}
 	lind++;
 
+	if ( index == lind ) {
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::UI_PRINT_PRIORITY,
+			       printPriorityOn ? 1 : 0);
+	     Motherboard::getBoard().getInterfaceBoard().setPrintPriority(printPriorityOn);
+	     flags = SETTINGS_LINEUPDATE;
+	}
+	lind++;
+
+#ifdef FAST_CANCEL
+	if ( index == lind ) {
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::FAST_CANCEL_ENABLE,
+			       fastCancelOn ? 1 : 0);
+	     flags = SETTINGS_LINEUPDATE;
+	}
+	lind++;
+#endif
+
 #ifdef PSTOP_SUPPORT
 	if ( index == lind ) {
 	     pstop_enabled = pstopEnabled ? 1 : 0;
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::PSTOP_ENABLE, (uint8_t)pstop_enabled);
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::PSTOP_ENABLE, (uint8_t)pstop_enabled);
 	     steppers::init();
 	     flags = SETTINGS_LINEUPDATE;
 	}
@@ -4427,7 +5101,7 @@ void SettingsMenu::handleSelect(uint8_t index) {
 
 	if ( index == lind ) {
 	     pstop_value = pstopInverted ? 1 : 0;
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::PSTOP_INVERTED, (uint8_t)pstop_value);
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::PSTOP_INVERTED, (uint8_t)pstop_value);
 	     flags = SETTINGS_LINEUPDATE;
 	}
 	lind++;
@@ -4436,7 +5110,7 @@ void SettingsMenu::handleSelect(uint8_t index) {
 #ifdef MACHINE_ID_MENU
 	if ( index == lind ) {
 	     uint16_t val = type2MachineId(bottype);
-	     eeprom_write_word((uint16_t*)(eeprom_offsets::VID_PID_INFO + 2), val);
+	     eeprom::writeWord((uint16_t*)(eeprom_offsets::VID_PID_INFO + 2), val);
 	     flags = SETTINGS_LINEUPDATE;
 	}
 	lind++;
@@ -4444,7 +5118,7 @@ void SettingsMenu::handleSelect(uint8_t index) {
 
 #ifdef ALTERNATE_UART
 	if ( index == lind ) {
-	     eeprom_write_byte((uint8_t*)eeprom_offsets::ENABLE_ALTERNATE_UART, altUART ? 1 : 0);
+	     eeprom::writeByte((uint8_t*)eeprom_offsets::ENABLE_ALTERNATE_UART, altUART ? 1 : 0);
 	     UART::getHostUART().setHardwareUART(altUART ? 1 : 0);
 	     flags = SETTINGS_LINEUPDATE;
 	}
@@ -4459,8 +5133,8 @@ void SettingsMenu::handleSelect(uint8_t index) {
 	lind++;
 #endif
 
+	eeprom::loadSettings();
 	if ( flags & SETTINGS_COMMANDRST ) command::reset();
-	else if ( flags & SETTINGS_STEPPERRST ) steppers::reset();
 	lineUpdate = flags & SETTINGS_LINEUPDATE ? 1 : 0;
 }
 
@@ -4474,14 +5148,60 @@ bool isSXGFile(char *filename, uint8_t len) {
 	     (filename[len-3] == 'S') || (filename[len-3] == 'X')) &&
 	    (filename[len-2] == '3') &&
 	    ((filename[len-1] == 'g') || (filename[len-1] == 'G'))) return true;
+#ifdef PRINT_QUEUE
+	if (printqueue::isQueueFile(filename)) return true;
+#endif
 	return false;
 }
 
 // Count the number of files on the SD card
 static uint8_t fileCount;
 
+// Where in the directory every (1 << dirIndexShift)'th counted file is, so
+// that getFilename() can start near the file rather than reading the whole
+// directory up to it for every line drawn.  Built by countFiles(); when it
+// fills, every other position is dropped and the spacing doubled.
+#define DIR_INDEX_SIZE 16
+static sdcard::DirPosition dirIndex[DIR_INDEX_SIZE];
+static uint8_t dirIndexCount;
+static uint8_t dirIndexShift;
+
+static void indexFile(const sdcard::DirPosition *pos) {
+	if ( dirIndexCount >= DIR_INDEX_SIZE ) {
+		for ( uint8_t i = 1; i < DIR_INDEX_SIZE / 2; i++ )
+			dirIndex[i] = dirIndex[i << 1];
+		dirIndexCount = DIR_INDEX_SIZE / 2;
+		dirIndexShift++;
+		// The file being counted is at a multiple of the new spacing too
+	}
+	dirIndex[dirIndexCount++] = *pos;
+}
+
+#ifdef SD_NAME_CACHE
+
+// The names of the files on a screenful of lines, from window_first on,
+// read in one pass through the directory when a line not held is drawn.
+// The one under the cursor is redrawn every update to scroll it, and is
+// then taken from here rather than from the card.  Names are no longer
+// than the FAT library's long_name.
+#define DIR_WINDOW	LCD_SCREEN_HEIGHT
+#define DIR_NAME_SIZE	32
+
+static char windowName[DIR_WINDOW][DIR_NAME_SIZE];
+static uint8_t windowDirs;	// Bit i set if line i is a folder
+static uint8_t windowFirst;
+static uint8_t windowCount;	// 0 when nothing is held
+static sdcard::DirPosition windowPos;	// Of the first, to tell it's still good
+
+#endif
+
 uint8_t countFiles() {
 	fileCount = 0;
+	dirIndexCount = 0;
+	dirIndexShift = 0;
+#ifdef SD_NAME_CACHE
+	windowCount = 0;
+#endif
 
 	// First, reset the directory index
 	if ( sdcard::directoryReset() != sdcard::SD_SUCCESS )
@@ -4493,55 +5213,125 @@ uint8_t countFiles() {
 
 	// Count the files
 	do {
-		bool isdir;
+		bool isdir, counted;
+		sdcard::DirPosition pos;
+		sdcard::directoryTell(&pos);
 		sdcard::directoryNextEntry(fnbuf,sizeof(fnbuf),&flen,&isdir);
 		if ( fnbuf[0] == 0 )
 			return fileCount;
 		// Count .. and anyfile which doesn't begin with .
-		if ( isdir ) {
-			if ( fnbuf[0] != '.' || ( fnbuf[1] == '.' && fnbuf[2] == 0 ) ) fileCount++;
+		if ( isdir )
+			counted = fnbuf[0] != '.' || ( fnbuf[1] == '.' && fnbuf[2] == 0 );
+		else
+			counted = isSXGFile(fnbuf, flen);
+		if ( counted ) {
+			if ( ( fileCount & ((1 << dirIndexShift) - 1) ) == 0 )
+				indexFile(&pos);
+			fileCount++;
 		}
-		else if ( isSXGFile(fnbuf, flen) ) fileCount++;
 	} while (true);
 
 	// Never reached
 	return fileCount;
 }
 
+// Reads on to the next file counted, false at the end of the directory
+static bool nextFile(char buffer[], uint8_t buffer_size, uint8_t *buflen, bool *isdir) {
+	do {
+		sdcard::directoryNextEntry(buffer, buffer_size, buflen, isdir);
+		if ( buffer[0] == 0 )
+			// No more files
+			return false;
+		if ( *isdir ) {
+			if ( buffer[0] != '.' || ( buffer[1] == '.' && buffer[2] == 0 ) )
+				return true;
+		}
+		else if ( isSXGFile(buffer, *buflen) )
+			return true;
+	} while (true);
+}
+
+// Sets the directory scan going from the file index, using buffer to read
+// through the ones before it
+static bool seekFile(uint8_t index, char buffer[], uint8_t buffer_size) {
+	// Start from the nearest indexed file before this one, or failing
+	// that, from the start of the directory list
+	uint8_t slot = index >> dirIndexShift;
+	if ( slot < dirIndexCount && sdcard::directorySeek(&dirIndex[slot]) == sdcard::SD_SUCCESS )
+		index -= slot << dirIndexShift;
+	else if ( sdcard::directoryReset() != sdcard::SD_SUCCESS )
+		return false;
+
+	uint8_t len;
+	bool isdir;
+	for (uint8_t i = 0; i < index; i++)
+		if ( !nextFile(buffer, buffer_size, &len, &isdir) )
+			return false;
+	return true;
+}
+
+#ifdef SD_NAME_CACHE
+
+// Reads the names of the window of lines which index is in
+static void fillWindow(uint8_t index) {
+	uint8_t first = index - index % DIR_WINDOW;
+	uint8_t len;
+	bool isdir;
+
+	windowCount = 0;
+	windowDirs = 0;
+	if ( !seekFile(first, windowName[0], DIR_NAME_SIZE) )
+		return;
+	sdcard::directoryTell(&windowPos);
+	windowFirst = first;
+	for (uint8_t i = 0; i < DIR_WINDOW; i++) {
+		if ( !nextFile(windowName[i], DIR_NAME_SIZE, &len, &isdir) )
+			break;
+		if ( isdir )
+			windowDirs |= 1 << i;
+		windowCount++;
+	}
+}
+
+#endif
+
 bool getFilename(uint8_t index, char buffer[], uint8_t buffer_size, uint8_t *buflen, bool *isdir) {
 
 	*buflen = 0;
 	*isdir = false;
 
-	// First, reset the directory list
-	if ( sdcard::directoryReset() != sdcard::SD_SUCCESS )
-		return false;
-
-	uint8_t my_buflen = 0; // set to zero in case the for loop never runs
-	bool my_isdir;
-
 #ifdef REVERSE_SD_FILES
 	// present files in reverse order in hopes this will show newer files first
 	// HOWEVER, with wrap around on the LCD menu, this isn't too useful
 	index = (fileCount - 1) - index;
 #endif
-	for (uint8_t i = 0; i < index+1; i++) {
-		do {
-			sdcard::directoryNextEntry(buffer, buffer_size, &my_buflen, &my_isdir);
-			if ( buffer[0] == 0 )
-				// No more files
-				return false;
-			if ( my_isdir ) {
-				if ( buffer[0] != '.' || ( buffer[1] == '.' && buffer[2] == 0 ) )
-					break;
-			}
-			else if ( isSXGFile(buffer, my_buflen) )
-				break;
-		} while (true);
-	}
+
+#ifdef SD_NAME_CACHE
+	if ( windowCount == 0 || index < windowFirst || index >= windowFirst + windowCount ||
+	     !sdcard::directoryValid(&windowPos) ) {
+		fillWindow(index);
+		if ( windowCount == 0 || index >= windowFirst + windowCount )
+			return false;
+	}
+
+	uint8_t line = index - windowFirst;
+	uint8_t len;
+	for (len = 0; len < buffer_size - 1 && windowName[line][len] != 0; len++)
+		buffer[len] = windowName[line][len];
+	buffer[len] = 0;
+	*isdir  = ( windowDirs & (1 << line) ) != 0;
+	*buflen = len;
+#else
+	uint8_t my_buflen = 0; // set to zero in case the loop never runs
+	bool my_isdir = false;
+
+	if ( !seekFile(index, buffer, buffer_size) ||
+	     !nextFile(buffer, buffer_size, &my_buflen, &my_isdir) )
+		return false;
 
 	*isdir  = my_isdir;
 	*buflen = my_buflen;
+#endif
 
 	return true;
 }
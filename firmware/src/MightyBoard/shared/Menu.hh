@@ -9,7 +9,7 @@
 #include "ButtonArray.hh"
 #include "LiquidCrystalSerial.hh"
 #include "Configuration.hh"
-#include "CircularBuffer.hh"
+#include "Command.hh"
 #include "Timeout.hh"
 #include "Host.hh"
 #include "UtilityScripts.hh"
@@ -51,6 +51,13 @@ enum AlignmentState {
 
 #endif
 
+/// Changes a screen can ask to be redrawn for; see Screen::getUpdateEvents().
+/// The low three are for the heater of that calibration_eeprom_offset.
+#define SCREEN_EVENT_TOOL0	0x01	///< Tool 0's shown or set temperature
+#define SCREEN_EVENT_TOOL1	0x02	///< Tool 1's shown or set temperature
+#define SCREEN_EVENT_PLATFORM	0x04	///< The platform's shown or set temperature
+#define SCREEN_EVENT_BUILD	0x08	///< The build percentage
+
 /// The screen class defines a standard interface for anything that should
 /// be displayed on the LCD.
 class Screen {
@@ -68,6 +75,12 @@ public:
 
 	virtual micros_t getUpdateRate() = 0;
 
+	/// The SCREEN_EVENT_ bits this screen shows.  A screen which returns
+	/// any is only updated for them, for buttons and redraws, and at least
+	/// every SCREEN_REFRESH_MS; getUpdateRate() is then how soon it sees
+	/// them.  Screens which return 0 are updated at getUpdateRate().
+	virtual uint8_t getUpdateEvents() { return 0; }
+
         /// Update the screen display,
         /// \param[in] lcd LCD to write to
         /// \param[in] forceRedraw if true, redraw the entire screen. If false,
@@ -210,6 +223,16 @@ private:
 #if defined(AUTO_LEVEL)
         uint8_t flip_flop;
 #endif
+#if defined(SD_PLAYBACK_STATS) || defined(SD_PRESCAN)
+	uint8_t page;
+	bool needsRedraw;
+#endif
+#if defined(SD_PLAYBACK_STATS)
+	void updateSdStats(LiquidCrystalSerial& lcd, bool forceRedraw);
+#endif
+#if defined(SD_PRESCAN)
+	void updateScanStats(LiquidCrystalSerial& lcd, bool forceRedraw);
+#endif
 
 public:
 	micros_t getUpdateRate() {return 500L * 1000L;}
@@ -353,7 +376,6 @@ public:
 class ChangeSpeedScreen: public Screen {
 
 private:
-	uint8_t alterSpeed;
 	FPTYPE  speedFactor;
 
 public:
@@ -478,7 +500,7 @@ public:
 
 	void setXY(uint8_t xpos, uint8_t ypos) { x = xpos; y = ypos; }
 
-	void addMessage(CircularBuffer& buf);
+	void addMessage(CommandBuffer& buf);
 	void addMessage(const prog_uchar msg[]);
 	void clearMessage();
 	void setTimeout(uint8_t seconds);//, bool pop);
@@ -515,6 +537,9 @@ private:
 	uint8_t    digiPotOnEntry[3];
 	bool       distanceChanged, modeChanged;
 	bool       jogging;
+	uint8_t    jogAxis;		///< Of the continuous jog held
+	bool       jogPositive;
+	int32_t    jogInterval;		///< Its microseconds a step
 	//we just ignore endstops in manual mode, if those defines are true
 #if defined(AUTO_LEVEL) && defined(AUTO_LEVEL_IGNORE_ZMIN_ONBUILD)
 	bool oldZvalIgnore;
@@ -807,6 +832,9 @@ private:
 		BUILD_TIME_PHASE_ZPOS,
 #ifdef ACCEL_STATS
 		BUILD_TIME_PHASE_ACCEL_STATS,
+#endif
+#ifdef SLICE_STATS
+		BUILD_TIME_PHASE_SLICE_STATS,
 #endif
 		BUILD_TIME_PHASE_LAST	//Not counted, just an end marker
 	};
@@ -815,8 +843,16 @@ private:
         uint32_t lastElapsedSeconds;
 #endif
 
+	/// Draw one of the items updatePhase rotates through
+	void drawPhase(LiquidCrystalSerial& lcd, uint8_t phase);
+
 public:
-	micros_t getUpdateRate() {return 500L * 1000L;}
+	micros_t getUpdateRate() {return 100L * 1000L;}
+
+	uint8_t getUpdateEvents() {
+		return SCREEN_EVENT_TOOL0 | SCREEN_EVENT_TOOL1 |
+			SCREEN_EVENT_PLATFORM | SCREEN_EVENT_BUILD;
+	}
 
 	void update(LiquidCrystalSerial& lcd, bool forceRedraw);
 
@@ -874,6 +910,10 @@ private:
 	bool extruderHoldOn;
 	bool toolOffsetSystemOld;
 	bool useCRC;
+	bool printPriorityOn;
+#ifdef FAST_CANCEL
+	bool fastCancelOn;
+#endif
 #ifdef PSTOP_SUPPORT
 	bool pstopEnabled;
 	bool pstopInverted;
@@ -920,6 +960,70 @@ private:
 
 #endif
 
+#ifdef ISR_PROFILE
+
+class IsrProfileScreen: public Screen {
+
+private:
+	uint8_t page;
+	bool needsRedraw;
+
+public:
+	micros_t getUpdateRate() {return 500L * 1000L;}
+
+	void update(LiquidCrystalSerial& lcd, bool forceRedraw);
+
+	void reset();
+
+	void notifyButtonPressed(ButtonArray::ButtonName button);
+};
+
+#endif
+
+#ifdef MEMORY_PROFILE
+
+class MemoryProfileScreen: public Screen {
+
+private:
+	uint8_t page;
+	bool needsRedraw;
+
+public:
+	micros_t getUpdateRate() {return 500L * 1000L;}
+
+	void update(LiquidCrystalSerial& lcd, bool forceRedraw);
+
+	void reset();
+
+	void notifyButtonPressed(ButtonArray::ButtonName button);
+};
+
+#endif
+
+#ifdef PID_AUTOTUNE
+
+class AutotuneScreen: public Screen {
+
+private:
+	uint8_t heater;		// 0 and 1 for the tools, 2 for the platform
+	int16_t target;
+	uint8_t lastState;
+	bool needsRedraw;
+
+	void setTarget();
+
+public:
+	micros_t getUpdateRate() {return 500L * 1000L;}
+
+	void update(LiquidCrystalSerial& lcd, bool forceRedraw);
+
+	void reset();
+
+	void notifyButtonPressed(ButtonArray::ButtonName button);
+};
+
+#endif
+
 class BotStatsScreen: public Screen {
 
 public:
@@ -26,12 +26,14 @@
 #include <stdlib.h>
 #include "PID.hh"
 
-#define ERR_ACC_MAX 256
 #define ERR_ACC_MIN -ERR_ACC_MAX
 
 // scale the output term to account for our fixed-point bounds
 #define OUTPUT_SCALE 2
 
+// The history index wraps with a mask
+typedef char delta_samples_check[((DELTA_SAMPLES & (DELTA_SAMPLES - 1)) == 0) ? 1 : -1];
+
 PID::PID() {
     reset();
 }
@@ -70,6 +72,53 @@ void PID::reset_state() {
 // which will give us a delta impulse for that one calculation round and then
 // the D term will immediately disappear.  By averaging the last N deltas, we
 // allow changes to be registered rather than get subsumed in the sampling noise.
+#if defined(PID_FIXED_POINT)
+
+#define PID_ONE ((int16_t)1 << PID_TEMP_BITS)
+
+static int16_t saturate16(int32_t v) {
+	if (v > 32767) return 32767;
+	if (v < -32768) return -32768;
+	return (int16_t)v;
+}
+
+// The same loop in PID_TEMP_BITS fixed point.  The products of the
+// (saturated) 16 bit terms and 8.8 gains can't overflow an int32_t, and each
+// is shifted down a little before the sum so that that can't either.  The
+// only float left is turning pv into fixed point.
+int PID::calculate(const float pv) {
+	int16_t e = saturate16((int32_t)sp * PID_ONE - (int32_t)(pv * PID_ONE));
+
+	int32_t acc = (int32_t)error_acc + e;
+	if (acc > (int32_t)ERR_ACC_MAX * PID_ONE)
+		acc = (int32_t)ERR_ACC_MAX * PID_ONE;
+	else if (acc < (int32_t)ERR_ACC_MIN * PID_ONE)
+		acc = (int32_t)ERR_ACC_MIN * PID_ONE;
+	error_acc = (int16_t)acc;
+
+	int16_t delta = saturate16((int32_t)e - prev_error);
+	delta_summation -= delta_history[delta_idx];
+	delta_history[delta_idx] = delta;
+	delta_summation += delta;
+	delta_idx = (delta_idx+1) & (DELTA_SAMPLES-1);
+
+	prev_error = e;
+
+	int32_t p_term = (int32_t)e * p_gain;
+	int32_t i_term = (int32_t)error_acc * i_gain;
+	int32_t d_term = (int32_t)saturate16(delta_summation) * d_gain;
+
+#if !defined(SUPPORT_GET_PID_STATE)
+	int last_output;
+#endif
+	last_output = (int)(((p_term >> 4) + (i_term >> 4) + (d_term >> 4)) >>
+			    (PID_TEMP_BITS + PID_GAIN_BITS - 4)) * OUTPUT_SCALE;
+
+	return last_output;
+}
+
+#else
+
 int PID::calculate(const float pv) {
 	float e = sp - pv;
 	error_acc += e;
@@ -88,7 +137,7 @@ int PID::calculate(const float pv) {
 	delta_summation -= delta_history[delta_idx];
 	delta_history[delta_idx] = delta;
 	delta_summation += (float)delta;
-	delta_idx = (delta_idx+1) % DELTA_SAMPLES;
+	delta_idx = (delta_idx+1) & (DELTA_SAMPLES-1);
 	// Use the delta over the whole window
 	float d_term = delta_summation * d_gain;
 
@@ -102,6 +151,8 @@ int PID::calculate(const float pv) {
 	return last_output;
 }
 
+#endif // PID_FIXED_POINT
+
 void PID::setTarget(const int target) {
     if (abs(sp - target) > 10)
 	reset_state();
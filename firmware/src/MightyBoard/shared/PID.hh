@@ -25,25 +25,54 @@
 #define PID_HH_
 
 #include <stdint.h>
+#include "Configuration.hh"
 
 /// Number of delta samples to
 #define DELTA_SAMPLES 4 // PID::reset_state() assumes 4.
 
+/// The accumulated error is clamped to +/- this, in degrees C times readings
+#define ERR_ACC_MAX 256
+
+#if defined(PID_FIXED_POINT)
+/// With PID_FIXED_POINT, temperatures and errors carry this many fractional
+/// bits, which leaves an int16_t room for +/-512C
+#define PID_TEMP_BITS 6
+/// and the gains this many, as the 8.8 numbers the EEPROM holds them in
+#define PID_GAIN_BITS 8
+typedef int16_t pid_value_t;
+typedef uint16_t pid_gain_t;
+#else
+typedef float pid_value_t;
+typedef float pid_gain_t;
+#endif
+
 /// The PID controller module implements a simple PID controller.
 /// \ingroup SoftwareLibraries
 class PID {
 private:
-    float p_gain; ///< proportional gain
-    float i_gain; ///< integral gain
-    float d_gain; ///< derivative gain
+    pid_gain_t p_gain; ///< proportional gain
+    pid_gain_t i_gain; ///< integral gain
+    pid_gain_t d_gain; ///< derivative gain
 
     /// Data for approximating d (smoothing to handle discrete nature of sampling).
     /// See PID.cc for a description of why we do this.
-    float delta_history[DELTA_SAMPLES];
+    pid_value_t delta_history[DELTA_SAMPLES];
+#if defined(PID_FIXED_POINT)
+    int32_t delta_summation;    ///< Sum of delta_history
+#else
     float delta_summation;      ///< ?
+#endif
     uint8_t delta_idx;          ///< Current index in the delta history buffer
-    float prev_error;             ///< Previous input for calculating next delta
-    float error_acc;              ///< Accumulated error, for calculating integral
+    pid_value_t prev_error;       ///< Previous input for calculating next delta
+    pid_value_t error_acc;        ///< Accumulated error, for calculating integral
+
+#if defined(PID_FIXED_POINT)
+    static pid_gain_t toGain(const float gain) {
+	return (pid_gain_t)(gain * (1 << PID_GAIN_BITS) + 0.5);
+    }
+#else
+    static pid_gain_t toGain(const float gain) { return gain; }
+#endif
 
     int sp;                     ///< Process set point
 
@@ -57,15 +86,15 @@ public:
 
     /// Set the P term of the PID controller
     /// \param[in] p_gain_in New proportional gain term
-    void setPGain(const float p_gain_in) { p_gain = p_gain_in; }
+    void setPGain(const float p_gain_in) { p_gain = toGain(p_gain_in); }
 
     /// Set the I term of the PID controller
     /// \param[in] i_gain_in New integration gain term
-    void setIGain(const float i_gain_in) { i_gain = i_gain_in; }
+    void setIGain(const float i_gain_in) { i_gain = toGain(i_gain_in); }
 
     /// Set the D term of the PID controller
     /// \param[in] d_gain_in New derivative gain term
-    void setDGain(const float d_gain_in) { d_gain = d_gain_in; }
+    void setDGain(const float d_gain_in) { d_gain = toGain(d_gain_in); }
 
     /// Set the setpoint of the PID controller
     /// \param[in] target New PID controller target
@@ -89,7 +118,11 @@ public:
 #if defined(SUPPORT_GET_PID_STATE)
     /// Get the current value of the error term
     /// \return Error term
+#if defined(PID_FIXED_POINT)
+    int getErrorTerm() { return error_acc >> PID_TEMP_BITS; }
+#else
     int getErrorTerm() { return (int)error_acc; }
+#endif
 
     /// Get the last process output value
     /// \return Last process output value
@@ -97,8 +130,12 @@ public:
 
     /// Get the current value of the delta term
     /// \return Delta term
+#if defined(PID_FIXED_POINT)
+    int getDeltaTerm() { return (int)(delta_summation >> PID_TEMP_BITS); }
+#else
     int getDeltaTerm() { return (int)delta_summation; }
 #endif
+#endif
 
 };
 
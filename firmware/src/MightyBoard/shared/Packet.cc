@@ -16,24 +16,68 @@
  */
 
 #include "Compat.hh"
+#include "Configuration.hh"
 #include "Packet.hh"
+#ifdef SIMULATOR
+#include "Simulator.hh"
+#else
 #include <util/crc16.h>
+#endif
+
+#if PACKET_CRC_TABLE
+#include <avr/pgmspace.h>
+
+// _crc_ibutton_update(0, i) for each byte i.  The update only depends on
+// crc ^ data, so one look up takes in a byte, rather than the eight shifts
+// of the bitwise version.
+const static uint8_t crc_table[256] PROGMEM = {
+	0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41,
+	0x9d, 0xc3, 0x21, 0x7f, 0xfc, 0xa2, 0x40, 0x1e, 0x5f, 0x01, 0xe3, 0xbd, 0x3e, 0x60, 0x82, 0xdc,
+	0x23, 0x7d, 0x9f, 0xc1, 0x42, 0x1c, 0xfe, 0xa0, 0xe1, 0xbf, 0x5d, 0x03, 0x80, 0xde, 0x3c, 0x62,
+	0xbe, 0xe0, 0x02, 0x5c, 0xdf, 0x81, 0x63, 0x3d, 0x7c, 0x22, 0xc0, 0x9e, 0x1d, 0x43, 0xa1, 0xff,
+	0x46, 0x18, 0xfa, 0xa4, 0x27, 0x79, 0x9b, 0xc5, 0x84, 0xda, 0x38, 0x66, 0xe5, 0xbb, 0x59, 0x07,
+	0xdb, 0x85, 0x67, 0x39, 0xba, 0xe4, 0x06, 0x58, 0x19, 0x47, 0xa5, 0xfb, 0x78, 0x26, 0xc4, 0x9a,
+	0x65, 0x3b, 0xd9, 0x87, 0x04, 0x5a, 0xb8, 0xe6, 0xa7, 0xf9, 0x1b, 0x45, 0xc6, 0x98, 0x7a, 0x24,
+	0xf8, 0xa6, 0x44, 0x1a, 0x99, 0xc7, 0x25, 0x7b, 0x3a, 0x64, 0x86, 0xd8, 0x5b, 0x05, 0xe7, 0xb9,
+	0x8c, 0xd2, 0x30, 0x6e, 0xed, 0xb3, 0x51, 0x0f, 0x4e, 0x10, 0xf2, 0xac, 0x2f, 0x71, 0x93, 0xcd,
+	0x11, 0x4f, 0xad, 0xf3, 0x70, 0x2e, 0xcc, 0x92, 0xd3, 0x8d, 0x6f, 0x31, 0xb2, 0xec, 0x0e, 0x50,
+	0xaf, 0xf1, 0x13, 0x4d, 0xce, 0x90, 0x72, 0x2c, 0x6d, 0x33, 0xd1, 0x8f, 0x0c, 0x52, 0xb0, 0xee,
+	0x32, 0x6c, 0x8e, 0xd0, 0x53, 0x0d, 0xef, 0xb1, 0xf0, 0xae, 0x4c, 0x12, 0x91, 0xcf, 0x2d, 0x73,
+	0xca, 0x94, 0x76, 0x28, 0xab, 0xf5, 0x17, 0x49, 0x08, 0x56, 0xb4, 0xea, 0x69, 0x37, 0xd5, 0x8b,
+	0x57, 0x09, 0xeb, 0xb5, 0x36, 0x68, 0x8a, 0xd4, 0x95, 0xcb, 0x29, 0x77, 0xf4, 0xaa, 0x48, 0x16,
+	0xe9, 0xb7, 0x55, 0x0b, 0x88, 0xd6, 0x34, 0x6a, 0x2b, 0x75, 0x97, 0xc9, 0x4a, 0x14, 0xf6, 0xa8,
+	0x74, 0x2a, 0xc8, 0x96, 0x15, 0x4b, 0xa9, 0xf7, 0xb6, 0xe8, 0x0a, 0x54, 0xd7, 0x89, 0x6b, 0x35
+};
+
+static inline uint8_t crcUpdate(uint8_t crc, uint8_t data) {
+	return pgm_read_byte(&crc_table[crc ^ data]);
+}
+#else
+static inline uint8_t crcUpdate(uint8_t crc, uint8_t data) {
+	return _crc_ibutton_update(crc, data);
+}
+#endif
 
 /// Append a byte and update the CRC
-void Packet::appendByte(uint8_t data) {
-	if (length < MAX_PACKET_PAYLOAD) {
-		crc = _crc_ibutton_update(crc, data);
-		payload[length] = data;
-		length++;
+template <uint8_t CAPACITY>
+void Packet<CAPACITY>::appendByte(uint8_t data) {
+	// One read and write of each volatile member, as this runs in the
+	// receive interrupt
+	uint8_t len = length;
+	if (len < CAPACITY) {
+		crc = crcUpdate(crc, data);
+		payload[len] = data;
+		length = len + 1;
 	}
 	else error(PacketError::APPEND_BUFFER_OVERFLOW);
 }
 /// Reset this packet to an empty state
-void Packet::reset() {
+template <uint8_t CAPACITY>
+void Packet<CAPACITY>::reset() {
 	crc = 0;
 	length = 0;
 #ifdef PARANOID
-	for (uint8_t i = 0; i < MAX_PACKET_PAYLOAD; i++) {
+	for (uint8_t i = 0; i < CAPACITY; i++) {
 		payload[i] = 0;
 	}
 #endif // PARANOID
@@ -41,7 +85,41 @@ void Packet::reset() {
 	state = PS_START;
 }
 
+// Reads an 8-bit byte from the specified index of the payload
+template <uint8_t CAPACITY>
+uint8_t Packet<CAPACITY>::read8(uint8_t index) const {
+	return payload[index];
+}
+template <uint8_t CAPACITY>
+uint16_t Packet<CAPACITY>::read16(uint8_t index) const {
+	return payload[index] | (payload[index + 1] << 8);
+}
+template <uint8_t CAPACITY>
+uint32_t Packet<CAPACITY>::read32(uint8_t index) const {
+	union {
+		// AVR is little-endian
+		int32_t a;
+		struct {
+			uint8_t data[4];
+		} b;
+	} shared;
+	shared.b.data[0] = payload[index];
+	shared.b.data[1] = payload[index+1];
+	shared.b.data[2] = payload[index+2];
+	shared.b.data[3] = payload[index+3];
+
+	return shared.a;
+}
+
+template class Packet<MAX_PACKET_PAYLOAD>;
+#if MAX_IN_PACKET_PAYLOAD != MAX_PACKET_PAYLOAD
+template class Packet<MAX_IN_PACKET_PAYLOAD>;
+#endif
+
 InPacket::InPacket() {
+#ifdef HOST_LARGE_PACKETS
+	limit = MAX_PACKET_PAYLOAD;
+#endif
 	reset();
 }
 
@@ -52,25 +130,31 @@ void InPacket::reset() {
 
 //process a byte for our packet.
 void InPacket::processByte(uint8_t b) {
-	if (state == PS_START) {
+	// state is volatile, so test a copy rather than reloading it for each branch
+	uint8_t s = state;
+	if (s == PS_START) {
 		if (b == START_BYTE) {
 			state = PS_LEN;
 		} else {
 			error(PacketError::NOISE_BYTE);
 		}
-	} else if (state == PS_LEN) {
+	} else if (s == PS_LEN) {
+#ifdef HOST_LARGE_PACKETS
+		if (b <= limit) {
+#else
 		if (b <= MAX_PACKET_PAYLOAD) {
+#endif
 			expected_length = b;
-			state = (expected_length == 0) ? PS_CRC : PS_PAYLOAD;
+			state = (b == 0) ? PS_CRC : PS_PAYLOAD;
 		} else {
 			error(PacketError::EXCEEDED_MAX_LENGTH);
 		}
-	} else if (state == PS_PAYLOAD) {
+	} else if (s == PS_PAYLOAD) {
 		appendByte(b);
 		if (length >= expected_length) {
 			state = PS_CRC;
 		}
-	} else if (state == PS_CRC) {
+	} else if (s == PS_CRC) {
 		if (crc == b) {
 			state = PS_LAST;
 		} else {
@@ -80,27 +164,14 @@ void InPacket::processByte(uint8_t b) {
 	}
 }
 
-// Reads an 8-bit byte from the specified index of the payload
-uint8_t Packet::read8(uint8_t index) const {
-	return payload[index];
-}
-uint16_t Packet::read16(uint8_t index) const {
-	return payload[index] | (payload[index + 1] << 8);
-}
-uint32_t Packet::read32(uint8_t index) const {
-	union {
-		// AVR is little-endian
-		int32_t a;
-		struct {
-			uint8_t data[4];
-		} b;
-	} shared;
-	shared.b.data[0] = payload[index];
-	shared.b.data[1] = payload[index+1];
-	shared.b.data[2] = payload[index+2];
-	shared.b.data[3] = payload[index+3];
-
-	return shared.a;
+uint8_t InPacket::popFront() {
+	if (length == 0) return 0;
+	uint8_t first = payload[0];
+	length--;
+	for (uint8_t i = 0; i < length; i++) {
+		payload[i] = payload[i + 1];
+	}
+	return first;
 }
 
 OutPacket::OutPacket() {
@@ -152,3 +223,14 @@ void OutPacket::append32(uint32_t value) {
 	appendByte((value>>16)&0xff);
 	appendByte((value>>24)&0xff);
 }
+void OutPacket::write16(uint8_t index, uint16_t value) {
+	uint8_t len = length;
+	if (index + 2 > len) return;
+	payload[index] = value&0xff;
+	payload[index+1] = (value>>8)&0xff;
+	// The CRC runs from the start of the payload
+	uint8_t c = 0;
+	for (uint8_t i = 0; i < len; i++)
+		c = crcUpdate(c, payload[i]);
+	crc = c;
+}
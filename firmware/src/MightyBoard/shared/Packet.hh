@@ -19,10 +19,26 @@
 #define SHARED_PACKET_HH_
 
 #include <stdint.h>
+#include "Configuration.hh"
 
 #define START_BYTE 0xD5
 #define MAX_PACKET_PAYLOAD 32
 
+// Packets from the host may carry up to this once it has asked for large
+// packets with HOST_CMD_SET_LARGE_PACKETS.  Replies, and packets before
+// then, stay within MAX_PACKET_PAYLOAD.
+#ifdef HOST_LARGE_PACKETS
+#ifndef HOST_LARGE_PACKET_PAYLOAD
+#define HOST_LARGE_PACKET_PAYLOAD 128
+#endif
+#if HOST_LARGE_PACKET_PAYLOAD <= MAX_PACKET_PAYLOAD || HOST_LARGE_PACKET_PAYLOAD > 255
+#error HOST_LARGE_PACKET_PAYLOAD must be more than MAX_PACKET_PAYLOAD and no more than 255
+#endif
+#define MAX_IN_PACKET_PAYLOAD HOST_LARGE_PACKET_PAYLOAD
+#else
+#define MAX_IN_PACKET_PAYLOAD MAX_PACKET_PAYLOAD
+#endif
+
 #define SLAVE_ID_BROADCAST 127
 
 namespace PacketError {
@@ -54,7 +70,9 @@ typedef enum {
         RC_CANCEL_BUILD		= 0x89, 
         RC_BOT_BUILDING		= 0x8A,  // this response is returned if the bot is building from SD card and the host attempts to send action commands
         RC_BOT_OVERHEAT		= 0x8B,	// if the bot overheats, it will not respond to commands
-        RC_PACKET_TIMEOUT	= 0x8C
+        RC_PACKET_TIMEOUT	= 0x8C,
+        RC_OUT_OF_SEQUENCE	= 0x8D,	// windowed mode: the packet wasn't the next one expected, and was dropped
+        RC_TELEMETRY		= 0x8E	// not a reply: leads the status frames turned on by HOST_CMD_SET_TELEMETRY
 } ResponseCode;
 
 /// Convenience function to accept old response codes
@@ -77,11 +95,14 @@ inline bool rcCompare(uint8_t data, ResponseCode code) {
 #define PS_LAST               4
 #define PS_LAST_INCORRECT_CRC 5
 
+/// A packet with room for CAPACITY bytes of payload.  Only the host's input
+/// packets are ever larger than MAX_PACKET_PAYLOAD.
+template <uint8_t CAPACITY>
 class Packet {
 protected:
     volatile uint8_t length; /// The current length of the payload (data[0] if raw packets)
     volatile uint8_t crc; /// The CRC of the current contents of the payload (data[-1] of raw packets)
-    volatile uint8_t payload[MAX_PACKET_PAYLOAD]; /// Data payload (starts at data[2] of raw packet)
+    volatile uint8_t payload[CAPACITY]; /// Data payload (starts at data[2] of raw packet)
 	volatile uint8_t error_code; // Have any errors cropped up during processing?
 	volatile uint8_t state;
 
@@ -115,12 +136,21 @@ public:
 };
 
 /// Input Packet.
-class InPacket: public Packet {
+class InPacket: public Packet<MAX_IN_PACKET_PAYLOAD> {
 private:
 	volatile uint8_t expected_length;
+#ifdef HOST_LARGE_PACKETS
+	uint8_t limit;		///< Longest payload accepted, kept over resets
+#endif
 public:
 	InPacket();
 
+#ifdef HOST_LARGE_PACKETS
+	/// Accept payloads of up to limit bytes, no more than
+	/// MAX_IN_PACKET_PAYLOAD, from the next packet on
+	void setLimit(uint8_t limit_in) { limit = limit_in; }
+#endif
+
 	/// Reset the entire packet reception.
 	void reset();
 
@@ -137,6 +167,11 @@ public:
 		return state != PS_START;
 	}
 
+	/// Remove the first byte of a received payload and return it, moving
+	/// the rest down.  For framing carried inside the payload, such as
+	/// the sequence numbers of the windowed host protocol.
+	uint8_t popFront();
+
 	/// Indicate that this packet has timed out.  This means:
 	/// * setting the PACKET_TIMEOUT error on the packet
 	/// * the packet gets reset
@@ -146,7 +181,7 @@ public:
 };
 
 /// Output Packet.
-class OutPacket: public Packet {
+class OutPacket: public Packet<MAX_PACKET_PAYLOAD> {
 private:
 	volatile uint8_t send_payload_index;
 public:
@@ -172,6 +207,10 @@ public:
 	void append8(uint8_t value);
 	void append16(uint16_t value);
 	void append32(uint32_t value);
+
+	// Overwrite two bytes already appended, such as a field of a header
+	// only known once the rest has been
+	void write16(uint8_t idx, uint16_t value);
 };
 
 #endif // SHARED_PACKET_HH_
@@ -44,4 +44,47 @@ public:
 
 static const Pin NullPin(NullPort, 0);
 
+/// A pin fixed at compile time, for the pins which are switched often.  As
+/// the port and the pin are constants, each access compiles to an sbi, cbi
+/// or sbis for ports A to G, and to a load and store for the others, with
+/// none of Pin's loads of its port and mask.  FAST_PIN(L,4) makes one for
+/// the pin macros of Configuration.hh; where a Pin is wanted, as for a pin
+/// handed to a constructor, it converts to one.
+template <port_base_t PORT_BASE, uint8_t PIN_INDEX>
+class FastPin {
+public:
+	static inline bool isNull() { return false; }
+
+	static inline void setDirection(bool out) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			if (out)	_SFR_MEM8(PORT_BASE + 1) |=  (uint8_t)_BV(PIN_INDEX);
+			else		_SFR_MEM8(PORT_BASE + 1) &= (uint8_t)~_BV(PIN_INDEX);
+		}
+	}
+
+	static inline bool getValue() {
+		return ( _SFR_MEM8(PORT_BASE) & (uint8_t)_BV(PIN_INDEX) ) != 0;
+	}
+
+	static inline void setValue(bool on) {
+		if (on)	setValueOn();
+		else	setValueOff();
+	}
+
+	static inline void setValueOn() {
+		_SFR_MEM8(PORT_BASE + 2) |= (uint8_t)_BV(PIN_INDEX);
+	}
+
+	static inline void setValueOff() {
+		_SFR_MEM8(PORT_BASE + 2) &= (uint8_t)~_BV(PIN_INDEX);
+	}
+
+	operator Pin() const {
+		AvrPort port = { PORT_BASE };
+		return Pin(port, PIN_INDEX);
+	}
+};
+
+#define FAST_PIN(PLETTER, PNUMBER)	FastPin<AVR_PORT_BASE_ ## PLETTER, PNUMBER>()
+
 #endif // PIN_HH
@@ -26,21 +26,20 @@
 #include <util/delay.h>
 #include "TWI.hh"
 
+// Only boards with the stock display define its pins
+#if defined(LCD_STROBE)
+
 //*** These functions are for and LCD using a shift register, the stock makerbot
-// hardware.
-StandardLiquidCrystalSerial::StandardLiquidCrystalSerial(Pin strobe, Pin data,
-                                                         Pin CLK) {
-  init(strobe, data, CLK);
+// hardware.  It's always on the board's LCD_ pins, which are FastPins, so the
+// bits are shifted out without loading a port and mask for each.
+StandardLiquidCrystalSerial::StandardLiquidCrystalSerial() {
+  init();
 }
 
-void StandardLiquidCrystalSerial::init(Pin strobe, Pin data, Pin clk) {
-  _strobe_pin = strobe;
-  _data_pin = data;
-  _clk_pin = clk;
-
-  _strobe_pin.setDirection(true);
-  _data_pin.setDirection(true);
-  _clk_pin.setDirection(true);
+void StandardLiquidCrystalSerial::init() {
+  LCD_STROBE.setDirection(true);
+  LCD_DATA.setDirection(true);
+  LCD_CLK.setDirection(true);
 
   _displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
 
@@ -88,15 +87,17 @@ void StandardLiquidCrystalSerial::pulseEnable(uint8_t value) {
 void StandardLiquidCrystalSerial::writeSerial(uint8_t value) {
 
   for (int8_t i = 7; i >= 0; i--) {
-    _clk_pin.setValue(false);
+    LCD_CLK.setValueOff();
     bool data = (value >> i) & 0x01 ? true : false;
-    _data_pin.setValue(data);
+    LCD_DATA.setValue(data);
 
-    _clk_pin.setValue(true);
+    LCD_CLK.setValueOn();
     _delay_us(1);
   }
 
-  _strobe_pin.setValue(true);
+  LCD_STROBE.setValueOn();
   _delay_us(1);
-  _strobe_pin.setValue(false);
+  LCD_STROBE.setValueOff();
 }
+
+#endif // LCD_STROBE
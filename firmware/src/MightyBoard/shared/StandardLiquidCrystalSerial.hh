@@ -30,8 +30,8 @@
 class StandardLiquidCrystalSerial : public LiquidCrystalSerial {
 
 public:
-  StandardLiquidCrystalSerial(Pin strobe, Pin data, Pin CLK);
-  void init(Pin strobe, Pin data, Pin CLK);
+  StandardLiquidCrystalSerial();
+  void init();
   void begin(uint8_t cols, uint8_t rows, uint8_t charsize = LCD_5x8DOTS);
 
 private:
@@ -39,10 +39,6 @@ private:
   void writeSerial(uint8_t);
   void write4bits(uint8_t value, bool dataMode);
   void pulseEnable(uint8_t value);
-
-  Pin _strobe_pin; // LOW: command.  HIGH: character.
-  Pin _data_pin;   // LOW: write to LCD.  HIGH: read from LCD.
-  Pin _clk_pin;    // activated by a HIGH pulse.
 };
 
 #endif // STANDARD_LIQUID_CRYSTAL_HH
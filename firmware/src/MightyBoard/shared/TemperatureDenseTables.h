@@ -0,0 +1,1256 @@
+// Dense thermistor tables, indexed by (reading - first) >> TEMP_DENSE_STEP_BITS
+// Made with createDenseTemperatureLookup.py from the tables in TemperatureTable.cc
+// and ThermistorTables.h; regenerate it when they change
+// Errors are against the sparse tables, for readings of 0 to 300C (150C for
+// the MightyBoard platform tables)
+//
+// No include guard: TemperatureTable.cc includes this once for the MightyBoards,
+// and ThermistorTables.h once for each Azteeg table slot, with MY_INDEX and
+// MY_TABLE set.  The dense table for MY_TABLE is named MY_TABLE_dense.
+
+#define TEMP_DENSE_FRAC_BITS 4
+
+#define TEMP_DENSE_CAT(t) t ## _dense
+#define TEMP_DENSE_NAME(t) TEMP_DENSE_CAT(t)
+
+#if BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_E
+
+#define TEMP_DENSE_STEP_BITS 3
+
+// 129 entries, worst error 0.44C at reading 955
+static const int16_t table_hbp_thermistor_dense[] PROGMEM = {
+     1, 1023,
+     13456, 12041, 10626,  9210,  7795,  6380,  4965,  4038,  3927,  3816,
+      3705,  3594,  3483,  3372,  3299,  3238,  3178,  3118,  3057,  2997,
+      2939,  2895,  2852,  2808,  2765,  2721,  2678,  2640,  2609,  2578,
+      2546,  2515,  2483,  2452,  2425,  2398,  2372,  2345,  2318,  2292,
+      2266,  2242,  2218,  2194,  2169,  2145,  2121,  2100,  2081,  2061,
+      2042,  2023,  2003,  1984,  1965,  1945,  1926,  1907,  1887,  1868,
+      1849,  1829,  1810,  1791,  1771,  1752,  1733,  1715,  1698,  1682,
+      1665,  1648,  1631,  1614,  1594,  1575,  1556,  1536,  1517,  1498,
+      1480,  1463,  1446,  1429,  1412,  1395,  1378,  1359,  1340,  1320,
+      1301,  1282,  1262,  1243,  1224,  1205,  1185,  1166,  1147,  1127,
+      1106,  1085,  1063,  1041,  1019,   998,   976,   949,   923,   896,
+       870,   843,   817,   786,   747,   708,   670,   631,   592,   554,
+       488,   413,   338,   263,   188,   114,    45,    19,    -6
+};
+
+#elif BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_G
+
+#define TEMP_DENSE_STEP_BITS 3
+
+// 129 entries, worst error 0.56C at reading 955
+static const int16_t table_hbp_thermistor_dense[] PROGMEM = {
+     1, 1023,
+     14656, 13084, 11512,  9939,  8367,  6795,  5223,  4196,  4077,  3959,
+      3841,  3722,  3604,  3486,  3407,  3342,  3277,  3211,  3146,  3081,
+      3019,  2975,  2932,  2888,  2845,  2801,  2758,  2719,  2685,  2651,
+      2618,  2584,  2550,  2516,  2466,  2412,  2359,  2306,  2253,  2200,
+      2155,  2136,  2117,  2097,  2078,  2059,  2039,  2020,  2001,  1981,
+      1962,  1943,  1923,  1904,  1887,  1870,  1853,  1836,  1819,  1803,
+      1785,  1765,  1746,  1727,  1707,  1688,  1669,  1653,  1639,  1624,
+      1610,  1595,  1581,  1566,  1549,  1532,  1515,  1498,  1481,  1464,
+      1448,  1431,  1414,  1397,  1380,  1363,  1346,  1329,  1312,  1295,
+      1278,  1262,  1245,  1227,  1205,  1183,  1161,  1140,  1118,  1096,
+      1073,  1049,  1025,  1000,   976,   952,   928,   904,   880,   856,
+       831,   807,   783,   755,   722,   688,   654,   620,   586,   552,
+       486,   409,   331,   254,   177,   100,    30,    13,    -4
+};
+
+#elif BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
+
+#define TEMP_DENSE_STEP_BITS 3
+
+#if MY_INDEX == 1
+// 986 entries, worst error 0.08C at reading 2443
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     184, 8064,
+      4800,  4760,  4720,  4680,  4640,  4560,  4533,  4507,  4480,  4440,
+      4400,  4360,  4320,  4293,  4267,  4240,  4213,  4187,  4160,  4133,
+      4107,  4080,  4060,  4040,  4020,  4000,  3980,  3960,  3940,  3920,
+      3900,  3880,  3860,  3840,  3824,  3808,  3792,  3776,  3760,  3744,
+      3728,  3712,  3696,  3680,  3664,  3648,  3632,  3616,  3600,  3589,
+      3577,  3566,  3554,  3543,  3531,  3520,  3507,  3493,  3480,  3467,
+      3453,  3440,  3430,  3420,  3410,  3400,  3390,  3380,  3370,  3360,
+      3350,  3340,  3330,  3320,  3310,  3300,  3290,  3280,  3271,  3262,
+      3253,  3244,  3236,  3227,  3218,  3209,  3200,  3193,  3185,  3178,
+      3171,  3164,  3156,  3149,  3142,  3135,  3127,  3120,  3113,  3105,
+      3098,  3091,  3084,  3076,  3069,  3062,  3055,  3047,  3040,  3033,
+      3027,  3020,  3013,  3007,  3000,  2993,  2987,  2980,  2973,  2967,
+      2960,  2954,  2948,  2942,  2935,  2929,  2923,  2917,  2911,  2905,
+      2898,  2892,  2886,  2880,  2875,  2869,  2864,  2859,  2853,  2848,
+      2843,  2837,  2832,  2827,  2821,  2816,  2811,  2805,  2800,  2795,
+      2790,  2785,  2780,  2775,  2770,  2765,  2760,  2755,  2750,  2745,
+      2740,  2735,  2730,  2725,  2720,  2716,  2711,  2707,  2702,  2698,
+      2693,  2689,  2684,  2680,  2676,  2671,  2667,  2662,  2658,  2653,
+      2649,  2644,  2640,  2636,  2632,  2627,  2623,  2619,  2615,  2611,
+      2606,  2602,  2598,  2594,  2589,  2585,  2581,  2577,  2573,  2568,
+      2564,  2560,  2556,  2552,  2549,  2545,  2541,  2537,  2533,  2530,
+      2526,  2522,  2518,  2514,  2510,  2507,  2503,  2499,  2495,  2491,
+      2488,  2484,  2480,  2477,  2473,  2470,  2466,  2463,  2459,  2456,
+      2452,  2449,  2445,  2442,  2438,  2435,  2431,  2428,  2424,  2421,
+      2417,  2414,  2410,  2407,  2403,  2400,  2397,  2394,  2390,  2387,
+      2384,  2381,  2378,  2374,  2371,  2368,  2365,  2362,  2358,  2355,
+      2352,  2349,  2346,  2342,  2339,  2336,  2333,  2330,  2326,  2323,
+      2320,  2317,  2314,  2311,  2308,  2305,  2302,  2299,  2296,  2293,
+      2290,  2287,  2284,  2281,  2279,  2276,  2273,  2270,  2267,  2264,
+      2261,  2258,  2255,  2252,  2249,  2246,  2243,  2240,  2237,  2234,
+      2231,  2229,  2226,  2223,  2220,  2217,  2214,  2211,  2209,  2206,
+      2203,  2200,  2197,  2194,  2191,  2189,  2186,  2183,  2180,  2177,
+      2174,  2171,  2169,  2166,  2163,  2160,  2157,  2155,  2152,  2150,
+      2147,  2145,  2142,  2139,  2137,  2134,  2132,  2129,  2126,  2124,
+      2121,  2119,  2116,  2114,  2111,  2108,  2106,  2103,  2101,  2098,
+      2095,  2093,  2090,  2088,  2085,  2083,  2080,  2078,  2075,  2072,
+      2070,  2068,  2065,  2062,  2060,  2058,  2055,  2052,  2050,  2048,
+      2045,  2042,  2040,  2038,  2035,  2032,  2030,  2028,  2025,  2022,
+      2020,  2018,  2015,  2012,  2010,  2008,  2005,  2002,  2000,  1998,
+      1995,  1993,  1991,  1988,  1986,  1984,  1981,  1979,  1976,  1974,
+      1972,  1969,  1967,  1965,  1962,  1960,  1958,  1955,  1953,  1951,
+      1948,  1946,  1944,  1941,  1939,  1936,  1934,  1932,  1929,  1927,
+      1925,  1922,  1920,  1918,  1915,  1913,  1911,  1909,  1906,  1904,
+      1902,  1899,  1897,  1895,  1893,  1890,  1888,  1886,  1883,  1881,
+      1879,  1877,  1874,  1872,  1870,  1867,  1865,  1863,  1861,  1858,
+      1856,  1854,  1851,  1849,  1847,  1845,  1842,  1840,  1838,  1836,
+      1833,  1831,  1829,  1827,  1824,  1822,  1820,  1818,  1816,  1813,
+      1811,  1809,  1807,  1804,  1802,  1800,  1798,  1796,  1793,  1791,
+      1789,  1787,  1784,  1782,  1780,  1778,  1776,  1773,  1771,  1769,
+      1767,  1764,  1762,  1760,  1758,  1756,  1754,  1751,  1749,  1747,
+      1745,  1743,  1741,  1738,  1736,  1734,  1732,  1730,  1728,  1725,
+      1723,  1721,  1719,  1717,  1715,  1712,  1710,  1708,  1706,  1704,
+      1702,  1699,  1697,  1695,  1693,  1691,  1689,  1686,  1684,  1682,
+      1680,  1678,  1676,  1674,  1672,  1669,  1667,  1665,  1663,  1661,
+      1659,  1657,  1655,  1653,  1651,  1648,  1646,  1644,  1642,  1640,
+      1638,  1636,  1634,  1632,  1629,  1627,  1625,  1623,  1621,  1619,
+      1617,  1615,  1613,  1611,  1608,  1606,  1604,  1602,  1600,  1598,
+      1596,  1594,  1591,  1589,  1587,  1585,  1583,  1581,  1578,  1576,
+      1574,  1572,  1570,  1568,  1565,  1563,  1561,  1559,  1557,  1555,
+      1552,  1550,  1548,  1546,  1544,  1542,  1539,  1537,  1535,  1533,
+      1531,  1529,  1526,  1524,  1522,  1520,  1518,  1516,  1514,  1511,
+      1509,  1507,  1505,  1503,  1501,  1498,  1496,  1494,  1492,  1490,
+      1488,  1485,  1483,  1481,  1479,  1477,  1475,  1472,  1470,  1468,
+      1466,  1464,  1462,  1459,  1457,  1455,  1453,  1451,  1449,  1446,
+      1444,  1442,  1440,  1438,  1436,  1434,  1431,  1429,  1427,  1425,
+      1423,  1421,  1418,  1416,  1414,  1412,  1410,  1408,  1405,  1403,
+      1401,  1399,  1397,  1395,  1392,  1390,  1388,  1386,  1384,  1382,
+      1379,  1377,  1375,  1373,  1371,  1369,  1366,  1364,  1362,  1360,
+      1358,  1355,  1353,  1351,  1349,  1346,  1344,  1342,  1339,  1337,
+      1335,  1333,  1330,  1328,  1326,  1323,  1321,  1319,  1317,  1314,
+      1312,  1310,  1307,  1305,  1303,  1301,  1298,  1296,  1294,  1291,
+      1289,  1287,  1285,  1282,  1280,  1278,  1275,  1273,  1270,  1268,
+      1265,  1263,  1261,  1258,  1256,  1253,  1251,  1248,  1246,  1244,
+      1241,  1239,  1236,  1234,  1232,  1229,  1227,  1224,  1222,  1219,
+      1217,  1215,  1212,  1210,  1207,  1205,  1202,  1200,  1197,  1195,
+      1192,  1190,  1187,  1185,  1182,  1179,  1177,  1174,  1172,  1169,
+      1166,  1164,  1161,  1159,  1156,  1154,  1151,  1148,  1146,  1143,
+      1141,  1138,  1135,  1133,  1130,  1128,  1125,  1123,  1120,  1117,
+      1114,  1112,  1109,  1106,  1103,  1101,  1098,  1095,  1092,  1090,
+      1087,  1084,  1081,  1079,  1076,  1073,  1070,  1068,  1065,  1062,
+      1059,  1057,  1054,  1051,  1048,  1046,  1043,  1040,  1037,  1034,
+      1031,  1028,  1025,  1022,  1019,  1016,  1013,  1010,  1007,  1004,
+      1001,   999,   996,   993,   990,   987,   984,   981,   978,   975,
+       972,   969,   966,   963,   960,   957,   953,   950,   947,   943,
+       940,   937,   933,   930,   927,   923,   920,   917,   913,   910,
+       907,   903,   900,   897,   893,   890,   887,   883,   880,   876,
+       873,   869,   865,   862,   858,   855,   851,   847,   844,   840,
+       836,   833,   829,   825,   822,   818,   815,   811,   807,   804,
+       800,   796,   792,   787,   783,   779,   775,   771,   766,   762,
+       758,   754,   749,   745,   741,   737,   733,   728,   724,   720,
+       715,   711,   706,   701,   696,   692,   687,   682,   678,   673,
+       668,   664,   659,   654,   649,   645,   640,   635,   629,   624,
+       619,   613,   608,   603,   597,   592,   587,   581,   576,   571,
+       565,   560,   553,   547,   540,   533,   527,   520,   513,   507,
+       500,   493,   487,   480,   473,   465,   458,   451,   444,   436,
+       429,   422,   415,   407,   400,   390,   380,   370,   360,   350,
+       340,   330,   320,   310,   300,   290,   280,   270,   260,   250,
+       240,   227,   213,   200,   187,   173,   160,   144,   128,   112,
+        96,    80,    60,    40,    20,     0
+};
+#endif
+
+#if MY_INDEX == 2
+// 1016 entries, worst error 0.08C at reading 785
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8128,
+     13568, 13266, 12963, 12661, 12359, 12056, 11754, 11452, 11149, 10847,
+     10545, 10242,  9940,  9638,  9335,  9033,  8730,  8428,  8126,  7823,
+      7521,  7219,  6916,  6614,  6312,  6009,  5707,  5405,  5102,  4800,
+      4760,  4720,  4680,  4640,  4608,  4576,  4544,  4512,  4480,  4457,
+      4434,  4411,  4389,  4366,  4343,  4320,  4297,  4274,  4251,  4229,
+      4206,  4183,  4160,  4144,  4128,  4112,  4096,  4080,  4064,  4048,
+      4032,  4016,  4000,  3985,  3971,  3956,  3942,  3927,  3913,  3898,
+      3884,  3869,  3855,  3840,  3828,  3815,  3803,  3791,  3778,  3766,
+      3754,  3742,  3729,  3717,  3705,  3692,  3680,  3671,  3661,  3652,
+      3642,  3633,  3624,  3614,  3605,  3595,  3586,  3576,  3567,  3558,
+      3548,  3539,  3529,  3520,  3512,  3504,  3496,  3488,  3480,  3472,
+      3464,  3456,  3448,  3440,  3432,  3424,  3416,  3408,  3400,  3392,
+      3384,  3376,  3368,  3360,  3353,  3347,  3340,  3333,  3327,  3320,
+      3313,  3307,  3300,  3293,  3287,  3280,  3273,  3267,  3260,  3253,
+      3247,  3240,  3233,  3227,  3220,  3213,  3207,  3200,  3194,  3189,
+      3183,  3177,  3171,  3166,  3160,  3154,  3149,  3143,  3137,  3131,
+      3126,  3120,  3114,  3109,  3103,  3097,  3091,  3086,  3080,  3074,
+      3069,  3063,  3057,  3051,  3046,  3040,  3035,  3031,  3026,  3022,
+      3017,  3013,  3008,  3003,  2999,  2994,  2990,  2985,  2981,  2976,
+      2971,  2967,  2962,  2958,  2953,  2949,  2944,  2939,  2935,  2930,
+      2926,  2921,  2917,  2912,  2907,  2903,  2898,  2894,  2889,  2885,
+      2880,  2876,  2872,  2868,  2864,  2860,  2857,  2853,  2849,  2845,
+      2841,  2837,  2833,  2829,  2825,  2821,  2818,  2814,  2810,  2806,
+      2802,  2798,  2794,  2790,  2786,  2782,  2779,  2775,  2771,  2767,
+      2763,  2759,  2755,  2751,  2747,  2743,  2740,  2736,  2732,  2728,
+      2724,  2720,  2717,  2713,  2710,  2707,  2704,  2700,  2697,  2694,
+      2691,  2687,  2684,  2681,  2678,  2674,  2671,  2668,  2664,  2661,
+      2658,  2655,  2651,  2648,  2645,  2642,  2638,  2635,  2632,  2629,
+      2625,  2622,  2619,  2616,  2612,  2609,  2606,  2602,  2599,  2596,
+      2593,  2589,  2586,  2583,  2580,  2576,  2573,  2570,  2567,  2563,
+      2560,  2557,  2554,  2551,  2549,  2546,  2543,  2540,  2537,  2534,
+      2531,  2529,  2526,  2523,  2520,  2517,  2514,  2511,  2509,  2506,
+      2503,  2500,  2497,  2494,  2491,  2489,  2486,  2483,  2480,  2477,
+      2474,  2471,  2469,  2466,  2463,  2460,  2457,  2454,  2451,  2449,
+      2446,  2443,  2440,  2437,  2434,  2431,  2429,  2426,  2423,  2420,
+      2417,  2414,  2411,  2409,  2406,  2403,  2400,  2397,  2395,  2392,
+      2390,  2387,  2385,  2382,  2380,  2377,  2375,  2372,  2370,  2367,
+      2364,  2362,  2359,  2357,  2354,  2352,  2349,  2347,  2344,  2342,
+      2339,  2337,  2334,  2331,  2329,  2326,  2324,  2321,  2319,  2316,
+      2314,  2311,  2309,  2306,  2303,  2301,  2298,  2296,  2293,  2291,
+      2288,  2286,  2283,  2281,  2278,  2276,  2273,  2270,  2268,  2265,
+      2263,  2260,  2258,  2255,  2253,  2250,  2248,  2245,  2243,  2240,
+      2238,  2235,  2233,  2231,  2228,  2226,  2224,  2221,  2219,  2217,
+      2214,  2212,  2210,  2208,  2205,  2203,  2201,  2198,  2196,  2194,
+      2191,  2189,  2187,  2184,  2182,  2180,  2177,  2175,  2173,  2170,
+      2168,  2166,  2163,  2161,  2159,  2157,  2154,  2152,  2150,  2147,
+      2145,  2143,  2140,  2138,  2136,  2133,  2131,  2129,  2126,  2124,
+      2122,  2119,  2117,  2115,  2112,  2110,  2108,  2106,  2103,  2101,
+      2099,  2096,  2094,  2092,  2089,  2087,  2085,  2082,  2080,  2078,
+      2076,  2073,  2071,  2069,  2067,  2065,  2062,  2060,  2058,  2056,
+      2054,  2052,  2049,  2047,  2045,  2043,  2041,  2038,  2036,  2034,
+      2032,  2030,  2027,  2025,  2023,  2021,  2019,  2016,  2014,  2012,
+      2010,  2008,  2005,  2003,  2001,  1999,  1997,  1995,  1992,  1990,
+      1988,  1986,  1984,  1981,  1979,  1977,  1975,  1973,  1970,  1968,
+      1966,  1964,  1962,  1959,  1957,  1955,  1953,  1951,  1948,  1946,
+      1944,  1942,  1940,  1938,  1935,  1933,  1931,  1929,  1927,  1924,
+      1922,  1920,  1918,  1916,  1914,  1911,  1909,  1907,  1905,  1903,
+      1901,  1898,  1896,  1894,  1892,  1890,  1888,  1885,  1883,  1881,
+      1879,  1877,  1875,  1872,  1870,  1868,  1866,  1864,  1862,  1859,
+      1857,  1855,  1853,  1851,  1849,  1846,  1844,  1842,  1840,  1838,
+      1836,  1834,  1831,  1829,  1827,  1825,  1823,  1821,  1818,  1816,
+      1814,  1812,  1810,  1808,  1805,  1803,  1801,  1799,  1797,  1795,
+      1792,  1790,  1788,  1786,  1784,  1782,  1779,  1777,  1775,  1773,
+      1771,  1769,  1766,  1764,  1762,  1760,  1758,  1756,  1753,  1751,
+      1749,  1747,  1744,  1742,  1740,  1738,  1736,  1733,  1731,  1729,
+      1727,  1724,  1722,  1720,  1718,  1716,  1713,  1711,  1709,  1707,
+      1704,  1702,  1700,  1698,  1696,  1693,  1691,  1689,  1687,  1684,
+      1682,  1680,  1678,  1676,  1673,  1671,  1669,  1667,  1664,  1662,
+      1660,  1658,  1656,  1653,  1651,  1649,  1647,  1644,  1642,  1640,
+      1638,  1636,  1633,  1631,  1629,  1627,  1624,  1622,  1620,  1618,
+      1616,  1613,  1611,  1609,  1607,  1604,  1602,  1600,  1598,  1595,
+      1593,  1590,  1588,  1586,  1583,  1581,  1579,  1576,  1574,  1571,
+      1569,  1567,  1564,  1562,  1559,  1557,  1555,  1552,  1550,  1547,
+      1545,  1543,  1540,  1538,  1536,  1533,  1531,  1528,  1526,  1524,
+      1521,  1519,  1516,  1514,  1512,  1509,  1507,  1504,  1502,  1500,
+      1497,  1495,  1493,  1490,  1488,  1485,  1483,  1481,  1478,  1476,
+      1473,  1471,  1469,  1466,  1464,  1461,  1459,  1457,  1454,  1452,
+      1450,  1447,  1445,  1442,  1440,  1437,  1435,  1432,  1429,  1427,
+      1424,  1421,  1419,  1416,  1413,  1411,  1408,  1405,  1403,  1400,
+      1397,  1395,  1392,  1389,  1387,  1384,  1381,  1379,  1376,  1373,
+      1371,  1368,  1365,  1363,  1360,  1357,  1355,  1352,  1349,  1347,
+      1344,  1341,  1339,  1336,  1333,  1331,  1328,  1325,  1323,  1320,
+      1317,  1315,  1312,  1309,  1307,  1304,  1301,  1299,  1296,  1293,
+      1291,  1288,  1285,  1283,  1280,  1277,  1273,  1270,  1267,  1264,
+      1260,  1257,  1254,  1251,  1247,  1244,  1241,  1238,  1234,  1231,
+      1228,  1224,  1221,  1218,  1215,  1211,  1208,  1205,  1202,  1198,
+      1195,  1192,  1189,  1185,  1182,  1179,  1176,  1172,  1169,  1166,
+      1162,  1159,  1156,  1153,  1149,  1146,  1143,  1140,  1136,  1133,
+      1130,  1127,  1123,  1120,  1116,  1112,  1108,  1104,  1100,  1096,
+      1092,  1088,  1084,  1080,  1076,  1072,  1068,  1064,  1060,  1056,
+      1052,  1048,  1044,  1040,  1036,  1032,  1028,  1024,  1020,  1016,
+      1012,  1008,  1004,  1000,   996,   992,   988,   984,   980,   976,
+       972,   968,   964,   960,   955,   950,   945,   939,   934,   929,
+       924,   919,   914,   908,   903,   898,   893,   888,   883,   877,
+       872,   867,   862,   857,   852,   846,   841,   836,   831,   826,
+       821,   815,   810,   805,   800,   793,   785,   778,   771,   764,
+       756,   749,   742,   735,   727,   720,   713,   705,   698,   691,
+       684,   676,   669,   662,   655,   647,   640,   630,   620,   610,
+       600,   590,   580,   570,   560,   550,   540,   530,   520,   510,
+       500,   490,   480,   465,   451,   436,   422,   407,   393,   378,
+       364,   349,   335,   320,   300,   280,   260,   240,   220,   200,
+       180,   160,   120,    80,    40,     0
+};
+#endif
+
+#if MY_INDEX == 3
+// 1018 entries, worst error 0.08C at reading 2211
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8144,
+     13824, 13373, 12922, 12470, 12019, 11568, 11117, 10666, 10214,  9763,
+      9312,  8861,  8410,  7958,  7507,  7056,  6605,  6154,  5702,  5251,
+      4800,  4760,  4720,  4680,  4640,  4600,  4560,  4520,  4480,  4440,
+      4400,  4360,  4320,  4293,  4267,  4240,  4213,  4187,  4160,  4137,
+      4114,  4091,  4069,  4046,  4023,  4000,  3980,  3960,  3940,  3920,
+      3900,  3880,  3860,  3840,  3824,  3808,  3792,  3776,  3760,  3744,
+      3728,  3712,  3696,  3680,  3665,  3651,  3636,  3622,  3607,  3593,
+      3578,  3564,  3549,  3535,  3520,  3509,  3499,  3488,  3477,  3467,
+      3456,  3445,  3435,  3424,  3413,  3403,  3392,  3381,  3371,  3360,
+      3351,  3341,  3332,  3322,  3313,  3304,  3294,  3285,  3275,  3266,
+      3256,  3247,  3238,  3228,  3219,  3209,  3200,  3192,  3185,  3177,
+      3170,  3162,  3154,  3147,  3139,  3131,  3124,  3116,  3109,  3101,
+      3093,  3086,  3078,  3070,  3063,  3055,  3048,  3040,  3034,  3028,
+      3022,  3015,  3009,  3003,  2997,  2991,  2985,  2978,  2972,  2966,
+      2960,  2954,  2948,  2942,  2935,  2929,  2923,  2917,  2911,  2905,
+      2898,  2892,  2886,  2880,  2875,  2869,  2864,  2859,  2853,  2848,
+      2843,  2837,  2832,  2827,  2821,  2816,  2811,  2805,  2800,  2795,
+      2789,  2784,  2779,  2773,  2768,  2763,  2757,  2752,  2747,  2741,
+      2736,  2731,  2725,  2720,  2716,  2711,  2707,  2703,  2698,  2694,
+      2690,  2685,  2681,  2677,  2672,  2668,  2664,  2659,  2655,  2651,
+      2646,  2642,  2638,  2634,  2629,  2625,  2621,  2616,  2612,  2608,
+      2603,  2599,  2595,  2590,  2586,  2582,  2577,  2573,  2569,  2564,
+      2560,  2556,  2553,  2549,  2545,  2542,  2538,  2535,  2531,  2527,
+      2524,  2520,  2516,  2513,  2509,  2505,  2502,  2498,  2495,  2491,
+      2487,  2484,  2480,  2476,  2473,  2469,  2465,  2462,  2458,  2455,
+      2451,  2447,  2444,  2440,  2436,  2433,  2429,  2425,  2422,  2418,
+      2415,  2411,  2407,  2404,  2400,  2397,  2394,  2391,  2387,  2384,
+      2381,  2378,  2375,  2372,  2369,  2365,  2362,  2359,  2356,  2353,
+      2350,  2347,  2344,  2340,  2337,  2334,  2331,  2328,  2325,  2322,
+      2318,  2315,  2312,  2309,  2306,  2303,  2300,  2296,  2293,  2290,
+      2287,  2284,  2281,  2278,  2275,  2271,  2268,  2265,  2262,  2259,
+      2256,  2253,  2249,  2246,  2243,  2240,  2237,  2235,  2232,  2229,
+      2226,  2224,  2221,  2218,  2216,  2213,  2210,  2207,  2205,  2202,
+      2199,  2197,  2194,  2191,  2188,  2186,  2183,  2180,  2178,  2175,
+      2172,  2169,  2167,  2164,  2161,  2159,  2156,  2153,  2151,  2148,
+      2145,  2142,  2140,  2137,  2134,  2132,  2129,  2126,  2123,  2121,
+      2118,  2115,  2113,  2110,  2107,  2104,  2102,  2099,  2096,  2094,
+      2091,  2088,  2085,  2083,  2080,  2078,  2075,  2073,  2070,  2068,
+      2065,  2063,  2061,  2058,  2056,  2053,  2051,  2048,  2046,  2044,
+      2041,  2039,  2036,  2034,  2032,  2029,  2027,  2024,  2022,  2019,
+      2017,  2015,  2012,  2010,  2007,  2005,  2002,  2000,  1998,  1995,
+      1993,  1990,  1988,  1985,  1983,  1981,  1978,  1976,  1973,  1971,
+      1968,  1966,  1964,  1961,  1959,  1956,  1954,  1952,  1949,  1947,
+      1944,  1942,  1939,  1937,  1935,  1932,  1930,  1927,  1925,  1922,
+      1920,  1918,  1916,  1913,  1911,  1909,  1907,  1904,  1902,  1900,
+      1898,  1896,  1893,  1891,  1889,  1887,  1884,  1882,  1880,  1878,
+      1876,  1873,  1871,  1869,  1867,  1864,  1862,  1860,  1858,  1856,
+      1853,  1851,  1849,  1847,  1844,  1842,  1840,  1838,  1836,  1833,
+      1831,  1829,  1827,  1824,  1822,  1820,  1818,  1816,  1813,  1811,
+      1809,  1807,  1804,  1802,  1800,  1798,  1796,  1793,  1791,  1789,
+      1787,  1784,  1782,  1780,  1778,  1776,  1773,  1771,  1769,  1767,
+      1764,  1762,  1760,  1758,  1756,  1754,  1751,  1749,  1747,  1745,
+      1743,  1741,  1739,  1737,  1734,  1732,  1730,  1728,  1726,  1724,
+      1722,  1719,  1717,  1715,  1713,  1711,  1709,  1707,  1705,  1702,
+      1700,  1698,  1696,  1694,  1692,  1690,  1687,  1685,  1683,  1681,
+      1679,  1677,  1675,  1673,  1670,  1668,  1666,  1664,  1662,  1660,
+      1658,  1655,  1653,  1651,  1649,  1647,  1645,  1643,  1641,  1638,
+      1636,  1634,  1632,  1630,  1628,  1626,  1623,  1621,  1619,  1617,
+      1615,  1613,  1611,  1609,  1606,  1604,  1602,  1600,  1598,  1596,
+      1593,  1591,  1589,  1587,  1585,  1582,  1580,  1578,  1576,  1574,
+      1572,  1569,  1567,  1565,  1563,  1561,  1558,  1556,  1554,  1552,
+      1550,  1547,  1545,  1543,  1541,  1539,  1536,  1534,  1532,  1530,
+      1528,  1525,  1523,  1521,  1519,  1517,  1515,  1512,  1510,  1508,
+      1506,  1504,  1501,  1499,  1497,  1495,  1493,  1490,  1488,  1486,
+      1484,  1482,  1479,  1477,  1475,  1473,  1471,  1468,  1466,  1464,
+      1462,  1460,  1458,  1455,  1453,  1451,  1449,  1447,  1444,  1442,
+      1440,  1438,  1436,  1433,  1431,  1429,  1427,  1425,  1422,  1420,
+      1418,  1416,  1414,  1412,  1409,  1407,  1405,  1403,  1401,  1398,
+      1396,  1394,  1392,  1390,  1387,  1385,  1383,  1381,  1379,  1376,
+      1374,  1372,  1370,  1368,  1365,  1363,  1361,  1359,  1357,  1355,
+      1352,  1350,  1348,  1346,  1344,  1341,  1339,  1337,  1335,  1333,
+      1330,  1328,  1326,  1324,  1322,  1319,  1317,  1315,  1313,  1311,
+      1308,  1306,  1304,  1302,  1300,  1298,  1295,  1293,  1291,  1289,
+      1287,  1284,  1282,  1280,  1277,  1275,  1272,  1270,  1267,  1264,
+      1262,  1259,  1256,  1254,  1251,  1249,  1246,  1243,  1241,  1238,
+      1235,  1233,  1230,  1228,  1225,  1222,  1220,  1217,  1214,  1212,
+      1209,  1207,  1204,  1201,  1199,  1196,  1193,  1191,  1188,  1186,
+      1183,  1180,  1178,  1175,  1172,  1170,  1167,  1165,  1162,  1159,
+      1157,  1154,  1151,  1149,  1146,  1144,  1141,  1138,  1136,  1133,
+      1130,  1128,  1125,  1123,  1120,  1117,  1115,  1112,  1110,  1107,
+      1104,  1102,  1099,  1096,  1094,  1091,  1089,  1086,  1083,  1081,
+      1078,  1075,  1073,  1070,  1068,  1065,  1062,  1060,  1057,  1054,
+      1052,  1049,  1047,  1044,  1041,  1039,  1036,  1033,  1031,  1028,
+      1026,  1023,  1020,  1018,  1015,  1012,  1010,  1007,  1005,  1002,
+       999,   997,   994,   991,   989,   986,   984,   981,   978,   976,
+       973,   970,   968,   965,   963,   960,   956,   952,   948,   944,
+       940,   937,   933,   929,   925,   921,   917,   913,   909,   905,
+       901,   898,   894,   890,   886,   882,   878,   874,   870,   866,
+       862,   859,   855,   851,   847,   843,   839,   835,   831,   827,
+       823,   820,   816,   812,   808,   804,   800,   796,   792,   788,
+       784,   780,   777,   773,   769,   765,   761,   757,   753,   749,
+       745,   741,   738,   734,   730,   726,   722,   718,   714,   710,
+       706,   702,   699,   695,   691,   687,   683,   679,   675,   671,
+       667,   663,   660,   656,   652,   648,   644,   640,   633,   627,
+       620,   613,   607,   600,   593,   587,   580,   573,   567,   560,
+       553,   547,   540,   533,   527,   520,   513,   507,   500,   493,
+       487,   480,   473,   467,   460,   453,   447,   440,   433,   427,
+       420,   413,   407,   400,   393,   387,   380,   373,   367,   360,
+       353,   347,   340,   333,   327,   320,   305,   291,   276,   262,
+       247,   233,   218,   204,   189,   175,   160,   145,   131,   116,
+       102,    87,    73,    58,    44,    29,    15,     0,   -32,   -64,
+       -96,  -128,  -160,  -192,  -224,  -256,  -288,  -320
+};
+#endif
+
+#if MY_INDEX == 4
+// 1008 entries, worst error 0.08C at reading 505
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8064,
+      6880,  6792,  6703,  6615,  6526,  6438,  6349,  6261,  6172,  6084,
+      5995,  5907,  5819,  5730,  5642,  5553,  5465,  5376,  5288,  5199,
+      5111,  5022,  4934,  4846,  4757,  4669,  4580,  4492,  4403,  4315,
+      4226,  4138,  4050,  3961,  3873,  3784,  3696,  3607,  3519,  3430,
+      3342,  3253,  3165,  3077,  2988,  2900,  2811,  2723,  2634,  2546,
+      2457,  2369,  2280,  2192,  2183,  2174,  2165,  2156,  2147,  2138,
+      2129,  2120,  2110,  2101,  2092,  2083,  2074,  2065,  2056,  2047,
+      2038,  2029,  2020,  2011,  2002,  1993,  1984,  1975,  1966,  1957,
+      1947,  1938,  1929,  1920,  1911,  1902,  1893,  1884,  1875,  1866,
+      1857,  1848,  1839,  1830,  1821,  1812,  1803,  1794,  1784,  1775,
+      1766,  1757,  1748,  1739,  1730,  1721,  1712,  1707,  1702,  1698,
+      1693,  1688,  1683,  1678,  1673,  1669,  1664,  1659,  1654,  1649,
+      1644,  1640,  1635,  1630,  1625,  1620,  1615,  1611,  1606,  1601,
+      1596,  1591,  1586,  1582,  1577,  1572,  1567,  1562,  1557,  1553,
+      1548,  1543,  1538,  1533,  1528,  1524,  1519,  1514,  1509,  1504,
+      1499,  1495,  1490,  1485,  1480,  1475,  1470,  1466,  1461,  1456,
+      1453,  1449,  1446,  1443,  1439,  1436,  1433,  1429,  1426,  1423,
+      1419,  1416,  1413,  1410,  1406,  1403,  1400,  1396,  1393,  1390,
+      1386,  1383,  1380,  1376,  1373,  1370,  1366,  1363,  1360,  1356,
+      1353,  1350,  1346,  1343,  1340,  1336,  1333,  1330,  1326,  1323,
+      1320,  1317,  1313,  1310,  1307,  1303,  1300,  1297,  1293,  1290,
+      1287,  1283,  1280,  1277,  1275,  1272,  1269,  1266,  1264,  1261,
+      1258,  1256,  1253,  1250,  1247,  1245,  1242,  1239,  1237,  1234,
+      1231,  1228,  1226,  1223,  1220,  1218,  1215,  1212,  1209,  1207,
+      1204,  1201,  1198,  1196,  1193,  1190,  1188,  1185,  1182,  1179,
+      1177,  1174,  1171,  1169,  1166,  1163,  1160,  1158,  1155,  1152,
+      1150,  1147,  1144,  1141,  1139,  1136,  1134,  1132,  1130,  1128,
+      1125,  1123,  1121,  1119,  1117,  1115,  1113,  1111,  1109,  1106,
+      1104,  1102,  1100,  1098,  1096,  1094,  1092,  1090,  1087,  1085,
+      1083,  1081,  1079,  1077,  1075,  1073,  1070,  1068,  1066,  1064,
+      1062,  1060,  1058,  1056,  1054,  1051,  1049,  1047,  1045,  1043,
+      1041,  1039,  1037,  1035,  1032,  1030,  1028,  1026,  1024,  1022,
+      1020,  1018,  1016,  1013,  1011,  1009,  1007,  1005,  1003,  1001,
+       999,   997,   994,   992,   990,   988,   986,   984,   982,   980,
+       978,   975,   973,   971,   969,   967,   965,   963,   961,   958,
+       956,   954,   952,   950,   948,   946,   944,   942,   939,   937,
+       935,   933,   931,   929,   927,   925,   923,   920,   918,   916,
+       914,   912,   910,   908,   907,   905,   903,   901,   899,   898,
+       896,   894,   892,   890,   888,   887,   885,   883,   881,   879,
+       878,   876,   874,   872,   870,   869,   867,   865,   863,   861,
+       859,   858,   856,   854,   852,   850,   849,   847,   845,   843,
+       841,   840,   838,   836,   834,   832,   830,   829,   827,   825,
+       823,   821,   820,   818,   816,   814,   813,   811,   810,   808,
+       807,   805,   804,   802,   801,   799,   798,   796,   795,   793,
+       792,   790,   789,   787,   786,   784,   783,   781,   780,   778,
+       777,   775,   774,   772,   771,   769,   768,   766,   765,   763,
+       762,   760,   759,   757,   756,   754,   753,   751,   750,   748,
+       747,   745,   744,   742,   741,   739,   738,   736,   734,   733,
+       731,   730,   728,   727,   725,   724,   722,   721,   719,   718,
+       716,   715,   713,   712,   710,   709,   707,   706,   704,   703,
+       701,   700,   698,   697,   695,   694,   692,   691,   689,   688,
+       686,   685,   683,   682,   680,   679,   677,   676,   674,   673,
+       671,   670,   668,   667,   665,   664,   662,   661,   659,   658,
+       656,   654,   652,   651,   649,   647,   645,   643,   642,   640,
+       638,   636,   634,   632,   631,   629,   627,   625,   623,   622,
+       620,   618,   616,   614,   613,   611,   609,   607,   605,   603,
+       602,   600,   598,   596,   594,   593,   591,   589,   587,   585,
+       584,   582,   580,   578,   576,   574,   573,   571,   569,   567,
+       565,   564,   562,   560,   558,   557,   555,   554,   552,   551,
+       549,   548,   546,   545,   543,   542,   540,   539,   537,   536,
+       534,   533,   531,   530,   528,   527,   525,   524,   522,   521,
+       519,   518,   516,   515,   513,   512,   510,   509,   507,   506,
+       504,   503,   501,   500,   498,   497,   495,   494,   492,   491,
+       489,   488,   486,   485,   483,   482,   480,   478,   477,   475,
+       474,   472,   471,   469,   468,   466,   465,   463,   462,   460,
+       459,   457,   456,   454,   453,   451,   450,   448,   447,   445,
+       444,   442,   441,   439,   438,   436,   435,   433,   432,   430,
+       429,   427,   426,   424,   423,   421,   420,   418,   417,   415,
+       414,   412,   411,   409,   408,   406,   405,   403,   402,   400,
+       398,   397,   395,   394,   392,   391,   389,   388,   386,   385,
+       383,   382,   380,   379,   377,   376,   374,   373,   371,   370,
+       368,   367,   365,   364,   362,   361,   359,   358,   356,   355,
+       353,   352,   350,   349,   347,   346,   344,   343,   341,   340,
+       338,   337,   335,   334,   332,   331,   329,   328,   326,   325,
+       323,   322,   320,   318,   316,   315,   313,   311,   309,   307,
+       306,   304,   302,   300,   298,   296,   295,   293,   291,   289,
+       287,   286,   284,   282,   280,   278,   277,   275,   273,   271,
+       269,   267,   266,   264,   262,   260,   258,   257,   255,   253,
+       251,   249,   248,   246,   244,   242,   240,   238,   237,   235,
+       233,   231,   229,   228,   226,   224,   222,   220,   218,   216,
+       213,   211,   209,   207,   205,   203,   201,   199,   197,   194,
+       192,   190,   188,   186,   184,   182,   180,   178,   175,   173,
+       171,   169,   167,   165,   163,   161,   158,   156,   154,   152,
+       150,   148,   146,   144,   142,   139,   137,   135,   133,   131,
+       129,   127,   125,   123,   120,   118,   116,   114,   112,   110,
+       108,   106,   104,   101,    99,    97,    95,    93,    91,    89,
+        87,    85,    82,    80,    78,    76,    74,    72,    70,    68,
+        66,    63,    61,    59,    57,    55,    53,    51,    49,    46,
+        44,    42,    40,    38,    36,    34,    32,    30,    27,    25,
+        23,    21,    19,    17,    15,    13,    11,     8,     6,     4,
+         2,     0,    -3,    -7,   -10,   -13,   -17,   -20,   -23,   -27,
+       -30,   -33,   -37,   -40,   -43,   -46,   -50,   -53,   -56,   -60,
+       -63,   -66,   -70,   -73,   -76,   -80,   -83,   -86,   -90,   -93,
+       -96,  -100,  -103,  -106,  -110,  -113,  -116,  -120,  -123,  -126,
+      -130,  -133,  -136,  -139,  -143,  -146,  -149,  -153,  -156,  -159,
+      -163,  -166,  -169,  -173,  -176,  -183,  -190,  -198,  -205,  -212,
+      -219,  -227,  -234,  -241,  -248,  -256,  -263,  -270,  -277,  -285,
+      -292,  -299,  -306,  -314,  -321,  -328,  -335,  -343,  -350,  -357,
+      -364,  -372,  -379,  -386,  -393,  -401,  -408,  -415,  -422,  -430,
+      -437,  -444,  -451,  -459,  -466,  -473,  -480,  -488,  -495,  -502,
+      -509,  -517,  -524,  -531,  -538,  -546,  -553,  -560
+};
+#endif
+
+#if MY_INDEX == 5
+// 1010 entries, worst error 0.08C at reading 6859
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8080,
+     11408, 10995, 10582, 10169,  9756,  9343,  8930,  8517,  8104,  7691,
+      7278,  6865,  6452,  6039,  5626,  5213,  4800,  4747,  4693,  4640,
+      4587,  4533,  4480,  4440,  4400,  4360,  4320,  4280,  4240,  4200,
+      4160,  4133,  4107,  4080,  4053,  4027,  4000,  3973,  3947,  3920,
+      3893,  3867,  3840,  3820,  3800,  3780,  3760,  3740,  3720,  3700,
+      3680,  3664,  3648,  3632,  3616,  3600,  3584,  3568,  3552,  3536,
+      3520,  3507,  3493,  3480,  3467,  3453,  3440,  3427,  3413,  3400,
+      3387,  3373,  3360,  3349,  3337,  3326,  3314,  3303,  3291,  3280,
+      3269,  3257,  3246,  3234,  3223,  3211,  3200,  3192,  3183,  3175,
+      3166,  3158,  3149,  3141,  3133,  3124,  3116,  3107,  3099,  3091,
+      3082,  3074,  3065,  3057,  3048,  3040,  3033,  3025,  3018,  3011,
+      3004,  2996,  2989,  2982,  2975,  2967,  2960,  2953,  2945,  2938,
+      2931,  2924,  2916,  2909,  2902,  2895,  2887,  2880,  2874,  2868,
+      2862,  2856,  2850,  2844,  2839,  2833,  2827,  2821,  2815,  2809,
+      2803,  2797,  2791,  2785,  2779,  2773,  2767,  2761,  2756,  2750,
+      2744,  2738,  2732,  2726,  2720,  2715,  2711,  2706,  2701,  2696,
+      2692,  2687,  2682,  2678,  2673,  2668,  2664,  2659,  2654,  2649,
+      2645,  2640,  2635,  2631,  2626,  2621,  2616,  2612,  2607,  2602,
+      2598,  2593,  2588,  2584,  2579,  2574,  2569,  2565,  2560,  2556,
+      2552,  2548,  2544,  2540,  2537,  2533,  2529,  2525,  2521,  2517,
+      2513,  2509,  2505,  2501,  2498,  2494,  2490,  2486,  2482,  2478,
+      2474,  2470,  2466,  2462,  2459,  2455,  2451,  2447,  2443,  2439,
+      2435,  2431,  2427,  2423,  2420,  2416,  2412,  2408,  2404,  2400,
+      2397,  2393,  2390,  2387,  2383,  2380,  2377,  2373,  2370,  2367,
+      2363,  2360,  2357,  2353,  2350,  2347,  2343,  2340,  2337,  2333,
+      2330,  2327,  2323,  2320,  2317,  2313,  2310,  2307,  2303,  2300,
+      2297,  2293,  2290,  2287,  2283,  2280,  2277,  2273,  2270,  2267,
+      2263,  2260,  2257,  2253,  2250,  2247,  2243,  2240,  2237,  2234,
+      2232,  2229,  2226,  2223,  2221,  2218,  2215,  2212,  2210,  2207,
+      2204,  2201,  2199,  2196,  2193,  2190,  2188,  2185,  2182,  2179,
+      2177,  2174,  2171,  2168,  2166,  2163,  2160,  2157,  2154,  2152,
+      2149,  2146,  2143,  2141,  2138,  2135,  2132,  2130,  2127,  2124,
+      2121,  2119,  2116,  2113,  2110,  2108,  2105,  2102,  2099,  2097,
+      2094,  2091,  2088,  2086,  2083,  2080,  2078,  2075,  2073,  2070,
+      2068,  2065,  2063,  2061,  2058,  2056,  2053,  2051,  2048,  2046,
+      2044,  2041,  2039,  2036,  2034,  2032,  2029,  2027,  2024,  2022,
+      2019,  2017,  2015,  2012,  2010,  2007,  2005,  2002,  2000,  1998,
+      1995,  1993,  1990,  1988,  1985,  1983,  1981,  1978,  1976,  1973,
+      1971,  1968,  1966,  1964,  1961,  1959,  1956,  1954,  1952,  1949,
+      1947,  1944,  1942,  1939,  1937,  1935,  1932,  1930,  1927,  1925,
+      1922,  1920,  1918,  1916,  1914,  1911,  1909,  1907,  1905,  1903,
+      1901,  1898,  1896,  1894,  1892,  1890,  1888,  1885,  1883,  1881,
+      1879,  1877,  1875,  1872,  1870,  1868,  1866,  1864,  1862,  1859,
+      1857,  1855,  1853,  1851,  1849,  1846,  1844,  1842,  1840,  1838,
+      1836,  1834,  1831,  1829,  1827,  1825,  1823,  1821,  1818,  1816,
+      1814,  1812,  1810,  1808,  1805,  1803,  1801,  1799,  1797,  1795,
+      1792,  1790,  1788,  1786,  1784,  1782,  1779,  1777,  1775,  1773,
+      1771,  1769,  1766,  1764,  1762,  1760,  1758,  1756,  1754,  1752,
+      1750,  1748,  1746,  1744,  1742,  1739,  1737,  1735,  1733,  1731,
+      1729,  1727,  1725,  1723,  1721,  1719,  1717,  1715,  1713,  1711,
+      1709,  1707,  1705,  1703,  1701,  1698,  1696,  1694,  1692,  1690,
+      1688,  1686,  1684,  1682,  1680,  1678,  1676,  1674,  1672,  1670,
+      1668,  1666,  1664,  1662,  1659,  1657,  1655,  1653,  1651,  1649,
+      1647,  1645,  1643,  1641,  1639,  1637,  1635,  1633,  1631,  1629,
+      1627,  1625,  1623,  1621,  1618,  1616,  1614,  1612,  1610,  1608,
+      1606,  1604,  1602,  1600,  1598,  1596,  1594,  1592,  1590,  1588,
+      1586,  1584,  1582,  1580,  1578,  1576,  1574,  1572,  1570,  1568,
+      1566,  1564,  1562,  1560,  1559,  1557,  1555,  1553,  1551,  1549,
+      1547,  1545,  1543,  1541,  1539,  1537,  1535,  1533,  1531,  1529,
+      1527,  1525,  1523,  1521,  1519,  1517,  1515,  1513,  1511,  1509,
+      1507,  1505,  1503,  1501,  1499,  1497,  1495,  1493,  1491,  1489,
+      1487,  1485,  1483,  1481,  1480,  1478,  1476,  1474,  1472,  1470,
+      1468,  1466,  1464,  1462,  1460,  1458,  1456,  1454,  1452,  1450,
+      1448,  1446,  1444,  1442,  1440,  1438,  1436,  1434,  1432,  1430,
+      1428,  1426,  1424,  1422,  1419,  1417,  1415,  1413,  1411,  1409,
+      1407,  1405,  1403,  1401,  1399,  1397,  1395,  1393,  1391,  1389,
+      1387,  1385,  1383,  1381,  1378,  1376,  1374,  1372,  1370,  1368,
+      1366,  1364,  1362,  1360,  1358,  1356,  1354,  1352,  1350,  1348,
+      1346,  1344,  1342,  1339,  1337,  1335,  1333,  1331,  1329,  1327,
+      1325,  1323,  1321,  1319,  1317,  1315,  1313,  1311,  1309,  1307,
+      1305,  1303,  1301,  1298,  1296,  1294,  1292,  1290,  1288,  1286,
+      1284,  1282,  1280,  1278,  1275,  1273,  1271,  1269,  1266,  1264,
+      1262,  1260,  1257,  1255,  1253,  1251,  1248,  1246,  1244,  1242,
+      1239,  1237,  1235,  1233,  1230,  1228,  1226,  1224,  1221,  1219,
+      1217,  1215,  1212,  1210,  1208,  1206,  1203,  1201,  1199,  1197,
+      1194,  1192,  1190,  1188,  1185,  1183,  1181,  1179,  1176,  1174,
+      1172,  1170,  1167,  1165,  1163,  1161,  1158,  1156,  1154,  1152,
+      1149,  1147,  1145,  1143,  1140,  1138,  1136,  1134,  1131,  1129,
+      1127,  1125,  1122,  1120,  1117,  1115,  1112,  1110,  1107,  1105,
+      1102,  1099,  1097,  1094,  1092,  1089,  1086,  1084,  1081,  1079,
+      1076,  1074,  1071,  1068,  1066,  1063,  1061,  1058,  1055,  1053,
+      1050,  1048,  1045,  1043,  1040,  1037,  1035,  1032,  1030,  1027,
+      1025,  1022,  1019,  1017,  1014,  1012,  1009,  1006,  1004,  1001,
+       999,   996,   994,   991,   988,   986,   983,   981,   978,   975,
+       973,   970,   968,   965,   963,   960,   957,   954,   951,   947,
+       944,   941,   938,   935,   932,   929,   925,   922,   919,   916,
+       913,   910,   907,   904,   900,   897,   894,   891,   888,   885,
+       882,   878,   875,   872,   869,   866,   863,   860,   856,   853,
+       850,   847,   844,   841,   838,   835,   831,   828,   825,   822,
+       819,   816,   813,   809,   806,   803,   800,   796,   792,   788,
+       784,   780,   776,   772,   768,   764,   760,   756,   752,   748,
+       744,   740,   736,   732,   728,   724,   720,   716,   712,   708,
+       704,   700,   696,   692,   688,   684,   680,   676,   672,   668,
+       664,   660,   656,   652,   648,   644,   640,   634,   629,   623,
+       618,   612,   607,   601,   596,   590,   585,   579,   574,   568,
+       563,   557,   552,   546,   541,   535,   530,   524,   519,   513,
+       508,   502,   497,   491,   486,   480,   472,   464,   456,   448,
+       440,   432,   424,   416,   408,   400,   392,   384,   376,   368,
+       360,   352,   344,   336,   328,   320,   309,   297,   286,   274,
+       263,   251,   240,   229,   217,   206,   194,   183,   171,   160,
+       144,   128,   112,    96,    80,    64,    48,    32,    16,     0
+};
+#endif
+
+#if MY_INDEX == 6
+// 1023 entries, worst error 4.38C at reading 7311
+// The sparse table steps from 45C to 40C at reading 7312
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8184,
+      5600,  5541,  5481,  5422,  5363,  5304,  5244,  5185,  5126,  5067,
+      5007,  4948,  4889,  4830,  4770,  4711,  4652,  4593,  4533,  4474,
+      4415,  4356,  4296,  4237,  4178,  4119,  4059,  4000,  3973,  3947,
+      3920,  3900,  3880,  3860,  3840,  3820,  3800,  3780,  3760,  3733,
+      3707,  3680,  3640,  3600,  3584,  3568,  3552,  3536,  3520,  3500,
+      3480,  3460,  3440,  3431,  3422,  3413,  3404,  3396,  3387,  3378,
+      3369,  3360,  3351,  3342,  3333,  3324,  3316,  3307,  3298,  3289,
+      3280,  3269,  3257,  3246,  3234,  3223,  3211,  3200,  3190,  3180,
+      3170,  3160,  3150,  3140,  3130,  3120,  3110,  3100,  3090,  3080,
+      3070,  3060,  3050,  3040,  3030,  3020,  3010,  3000,  2990,  2980,
+      2970,  2960,  2943,  2926,  2909,  2891,  2874,  2857,  2840,  2823,
+      2806,  2789,  2771,  2754,  2737,  2720,  2714,  2708,  2702,  2696,
+      2690,  2684,  2679,  2673,  2667,  2661,  2655,  2649,  2643,  2637,
+      2631,  2625,  2619,  2613,  2607,  2601,  2596,  2590,  2584,  2578,
+      2572,  2566,  2560,  2556,  2552,  2548,  2544,  2540,  2536,  2532,
+      2528,  2524,  2520,  2516,  2512,  2508,  2504,  2500,  2496,  2492,
+      2488,  2484,  2480,  2476,  2472,  2468,  2464,  2460,  2456,  2452,
+      2448,  2444,  2440,  2436,  2432,  2428,  2424,  2420,  2416,  2412,
+      2408,  2404,  2400,  2396,  2392,  2388,  2384,  2380,  2376,  2372,
+      2368,  2364,  2360,  2356,  2352,  2348,  2344,  2340,  2336,  2332,
+      2328,  2324,  2320,  2316,  2312,  2308,  2304,  2300,  2296,  2292,
+      2288,  2284,  2280,  2276,  2272,  2268,  2264,  2260,  2256,  2252,
+      2248,  2244,  2240,  2237,  2233,  2230,  2226,  2223,  2220,  2216,
+      2213,  2209,  2206,  2203,  2199,  2196,  2192,  2189,  2186,  2182,
+      2179,  2175,  2172,  2169,  2165,  2162,  2158,  2155,  2151,  2148,
+      2145,  2141,  2138,  2134,  2131,  2128,  2124,  2121,  2117,  2114,
+      2111,  2107,  2104,  2100,  2097,  2094,  2090,  2087,  2083,  2080,
+      2077,  2073,  2070,  2067,  2063,  2060,  2057,  2053,  2050,  2047,
+      2043,  2040,  2037,  2033,  2030,  2027,  2023,  2020,  2017,  2013,
+      2010,  2007,  2003,  2000,  1997,  1993,  1990,  1987,  1983,  1980,
+      1977,  1973,  1970,  1967,  1963,  1960,  1957,  1953,  1950,  1947,
+      1943,  1940,  1937,  1933,  1930,  1927,  1923,  1920,  1918,  1915,
+      1913,  1910,  1908,  1905,  1903,  1900,  1898,  1895,  1893,  1890,
+      1888,  1886,  1883,  1881,  1878,  1876,  1873,  1871,  1868,  1866,
+      1863,  1861,  1858,  1856,  1854,  1851,  1849,  1846,  1844,  1841,
+      1839,  1836,  1834,  1831,  1829,  1826,  1824,  1822,  1819,  1817,
+      1814,  1812,  1809,  1807,  1804,  1802,  1799,  1797,  1794,  1792,
+      1790,  1787,  1785,  1782,  1780,  1777,  1775,  1772,  1770,  1767,
+      1765,  1762,  1760,  1757,  1755,  1752,  1749,  1747,  1744,  1741,
+      1739,  1736,  1733,  1731,  1728,  1725,  1723,  1720,  1717,  1715,
+      1712,  1709,  1707,  1704,  1701,  1699,  1696,  1693,  1691,  1688,
+      1685,  1683,  1680,  1677,  1674,  1671,  1668,  1665,  1662,  1658,
+      1655,  1652,  1649,  1646,  1643,  1640,  1637,  1634,  1631,  1628,
+      1625,  1622,  1618,  1615,  1612,  1609,  1606,  1603,  1600,  1598,
+      1596,  1595,  1593,  1591,  1589,  1588,  1586,  1584,  1582,  1580,
+      1579,  1577,  1575,  1573,  1572,  1570,  1568,  1566,  1564,  1563,
+      1561,  1559,  1557,  1556,  1554,  1552,  1550,  1548,  1547,  1545,
+      1543,  1541,  1540,  1538,  1536,  1534,  1532,  1531,  1529,  1527,
+      1525,  1524,  1522,  1520,  1517,  1514,  1512,  1509,  1506,  1503,
+      1501,  1498,  1495,  1492,  1490,  1487,  1484,  1481,  1479,  1476,
+      1473,  1470,  1468,  1465,  1462,  1459,  1457,  1454,  1451,  1448,
+      1446,  1443,  1440,  1438,  1437,  1435,  1433,  1431,  1430,  1428,
+      1426,  1425,  1423,  1421,  1420,  1418,  1416,  1414,  1413,  1411,
+      1409,  1408,  1406,  1404,  1403,  1401,  1399,  1397,  1396,  1394,
+      1392,  1391,  1389,  1387,  1386,  1384,  1382,  1380,  1379,  1377,
+      1375,  1374,  1372,  1370,  1369,  1367,  1365,  1363,  1362,  1360,
+      1358,  1357,  1355,  1353,  1351,  1350,  1348,  1346,  1345,  1343,
+      1341,  1340,  1338,  1336,  1334,  1333,  1331,  1329,  1328,  1326,
+      1324,  1323,  1321,  1319,  1317,  1316,  1314,  1312,  1311,  1309,
+      1307,  1306,  1304,  1302,  1300,  1299,  1297,  1295,  1294,  1292,
+      1290,  1289,  1287,  1285,  1283,  1282,  1280,  1277,  1274,  1272,
+      1269,  1266,  1263,  1260,  1258,  1255,  1252,  1249,  1246,  1244,
+      1241,  1238,  1235,  1232,  1229,  1227,  1224,  1221,  1218,  1215,
+      1213,  1210,  1207,  1204,  1201,  1199,  1196,  1193,  1190,  1187,
+      1185,  1182,  1179,  1176,  1173,  1171,  1168,  1165,  1162,  1159,
+      1156,  1154,  1151,  1148,  1145,  1142,  1140,  1137,  1134,  1131,
+      1128,  1126,  1123,  1120,  1119,  1117,  1116,  1115,  1113,  1112,
+      1110,  1109,  1108,  1106,  1105,  1104,  1102,  1101,  1099,  1098,
+      1097,  1095,  1094,  1093,  1091,  1090,  1089,  1087,  1086,  1084,
+      1083,  1082,  1080,  1079,  1078,  1076,  1075,  1074,  1072,  1071,
+      1069,  1068,  1067,  1065,  1064,  1063,  1061,  1060,  1058,  1057,
+      1056,  1054,  1053,  1052,  1050,  1049,  1048,  1046,  1045,  1043,
+      1042,  1041,  1039,  1038,  1037,  1035,  1034,  1032,  1031,  1030,
+      1028,  1027,  1026,  1024,  1023,  1022,  1020,  1019,  1017,  1016,
+      1015,  1013,  1012,  1011,  1009,  1008,  1006,  1005,  1004,  1002,
+      1001,  1000,   998,   997,   996,   994,   993,   991,   990,   989,
+       987,   986,   985,   983,   982,   981,   979,   978,   976,   975,
+       974,   972,   971,   970,   968,   967,   965,   964,   963,   961,
+       960,   957,   954,   952,   949,   946,   943,   941,   938,   935,
+       932,   930,   927,   924,   921,   919,   916,   913,   910,   908,
+       905,   902,   899,   897,   894,   891,   888,   886,   883,   880,
+       878,   876,   874,   872,   870,   868,   866,   864,   862,   859,
+       857,   855,   853,   851,   849,   847,   845,   843,   841,   839,
+       837,   835,   833,   831,   829,   827,   825,   823,   821,   818,
+       816,   814,   812,   810,   808,   806,   804,   802,   800,   799,
+       798,   796,   795,   794,   793,   791,   790,   789,   788,   786,
+       785,   784,   783,   782,   780,   779,   778,   777,   775,   774,
+       773,   772,   770,   769,   768,   767,   766,   764,   763,   762,
+       761,   759,   758,   757,   756,   754,   753,   752,   751,   750,
+       748,   747,   746,   745,   743,   742,   741,   740,   738,   737,
+       736,   735,   734,   732,   731,   730,   729,   727,   726,   725,
+       724,   722,   721,   640,   636,   632,   629,   625,   621,   617,
+       613,   610,   606,   602,   598,   594,   590,   587,   583,   579,
+       575,   571,   568,   564,   560,   556,   552,   547,   543,   539,
+       535,   531,   526,   522,   518,   514,   509,   505,   501,   497,
+       493,   488,   484,   480,   475,   470,   465,   460,   455,   450,
+       445,   440,   435,   430,   425,   420,   415,   410,   405,   400,
+       394,   388,   382,   376,   370,   364,   358,   352,   342,   332,
+       322,   311,   301,   291,   281,   271,   261,   251,   241,   230,
+       220,   210,   200,   190,   180,   170,   159,   149,   139,   129,
+       119,   109,    99,    89,    78,    68,    58,    48,    45,    42,
+        38,    35,    32,    29,    26,    22,    19,    16,    13,    10,
+         6,     3,     0
+};
+#endif
+
+#if MY_INDEX == 7
+// 1023 entries, worst error 0.08C at reading 8161
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8184,
+     15056, 14541, 14027, 13512, 12997, 12483, 11968, 11453, 10939, 10424,
+      9909,  9395,  8880,  8365,  7851,  7336,  6821,  6307,  5792,  5736,
+      5680,  5624,  5568,  5512,  5456,  5400,  5344,  5288,  5232,  5176,
+      5120,  5064,  5008,  4952,  4896,  4840,  4784,  4755,  4725,  4696,
+      4667,  4637,  4608,  4579,  4549,  4520,  4491,  4461,  4432,  4403,
+      4373,  4344,  4315,  4285,  4256,  4237,  4219,  4200,  4181,  4163,
+      4144,  4125,  4107,  4088,  4069,  4051,  4032,  4013,  3995,  3976,
+      3957,  3939,  3920,  3906,  3892,  3877,  3863,  3849,  3835,  3820,
+      3806,  3792,  3778,  3764,  3749,  3735,  3721,  3707,  3692,  3678,
+      3664,  3652,  3641,  3629,  3618,  3606,  3595,  3583,  3572,  3560,
+      3548,  3537,  3525,  3514,  3502,  3491,  3479,  3468,  3456,  3447,
+      3438,  3429,  3420,  3412,  3403,  3394,  3385,  3376,  3367,  3358,
+      3349,  3340,  3332,  3323,  3314,  3305,  3296,  3288,  3280,  3272,
+      3264,  3256,  3248,  3240,  3232,  3224,  3216,  3208,  3200,  3192,
+      3184,  3176,  3168,  3160,  3152,  3146,  3140,  3133,  3127,  3121,
+      3115,  3108,  3102,  3096,  3090,  3084,  3077,  3071,  3065,  3059,
+      3052,  3046,  3040,  3034,  3028,  3021,  3015,  3009,  3003,  2996,
+      2990,  2984,  2978,  2972,  2965,  2959,  2953,  2947,  2940,  2934,
+      2928,  2923,  2917,  2912,  2907,  2901,  2896,  2891,  2885,  2880,
+      2875,  2869,  2864,  2859,  2853,  2848,  2843,  2837,  2832,  2827,
+      2821,  2816,  2811,  2805,  2800,  2795,  2789,  2784,  2779,  2773,
+      2768,  2763,  2757,  2752,  2747,  2741,  2736,  2732,  2727,  2723,
+      2718,  2714,  2709,  2705,  2700,  2696,  2692,  2687,  2683,  2678,
+      2674,  2669,  2665,  2660,  2656,  2652,  2649,  2645,  2642,  2638,
+      2635,  2631,  2628,  2624,  2620,  2617,  2613,  2610,  2606,  2603,
+      2599,  2596,  2592,  2588,  2583,  2579,  2574,  2570,  2565,  2561,
+      2556,  2552,  2548,  2543,  2539,  2534,  2530,  2525,  2521,  2516,
+      2512,  2508,  2505,  2501,  2498,  2494,  2491,  2487,  2484,  2480,
+      2476,  2473,  2469,  2466,  2462,  2459,  2455,  2452,  2448,  2444,
+      2441,  2437,  2434,  2430,  2427,  2423,  2420,  2416,  2412,  2409,
+      2405,  2402,  2398,  2395,  2391,  2388,  2384,  2381,  2379,  2376,
+      2373,  2371,  2368,  2365,  2363,  2360,  2357,  2355,  2352,  2349,
+      2347,  2344,  2341,  2339,  2336,  2332,  2329,  2325,  2322,  2318,
+      2315,  2311,  2308,  2304,  2300,  2297,  2293,  2290,  2286,  2283,
+      2279,  2276,  2272,  2269,  2267,  2264,  2261,  2259,  2256,  2253,
+      2251,  2248,  2245,  2243,  2240,  2237,  2235,  2232,  2229,  2227,
+      2224,  2220,  2217,  2213,  2210,  2206,  2203,  2199,  2196,  2192,
+      2188,  2185,  2181,  2178,  2174,  2171,  2167,  2164,  2160,  2157,
+      2155,  2152,  2149,  2147,  2144,  2141,  2139,  2136,  2133,  2131,
+      2128,  2125,  2123,  2120,  2117,  2115,  2112,  2109,  2107,  2104,
+      2101,  2099,  2096,  2093,  2091,  2088,  2085,  2083,  2080,  2077,
+      2075,  2072,  2069,  2067,  2064,  2061,  2059,  2056,  2053,  2051,
+      2048,  2045,  2043,  2040,  2037,  2035,  2032,  2029,  2027,  2024,
+      2021,  2019,  2016,  2013,  2011,  2008,  2005,  2003,  2000,  1997,
+      1995,  1992,  1989,  1987,  1984,  1981,  1979,  1976,  1973,  1971,
+      1968,  1966,  1964,  1963,  1961,  1959,  1957,  1956,  1954,  1952,
+      1950,  1948,  1947,  1945,  1943,  1941,  1940,  1938,  1936,  1933,
+      1931,  1928,  1925,  1923,  1920,  1917,  1915,  1912,  1909,  1907,
+      1904,  1901,  1899,  1896,  1893,  1891,  1888,  1885,  1883,  1880,
+      1877,  1875,  1872,  1869,  1867,  1864,  1861,  1859,  1856,  1853,
+      1851,  1848,  1845,  1843,  1840,  1837,  1835,  1832,  1829,  1827,
+      1824,  1821,  1819,  1816,  1813,  1811,  1808,  1805,  1803,  1800,
+      1797,  1795,  1792,  1790,  1788,  1787,  1785,  1783,  1781,  1780,
+      1778,  1776,  1774,  1772,  1771,  1769,  1767,  1765,  1764,  1762,
+      1760,  1757,  1755,  1752,  1749,  1747,  1744,  1741,  1739,  1736,
+      1733,  1731,  1728,  1725,  1723,  1720,  1717,  1715,  1712,  1710,
+      1708,  1707,  1705,  1703,  1701,  1700,  1698,  1696,  1694,  1692,
+      1691,  1689,  1687,  1685,  1684,  1682,  1680,  1677,  1675,  1672,
+      1669,  1667,  1664,  1661,  1659,  1656,  1653,  1651,  1648,  1645,
+      1643,  1640,  1637,  1635,  1632,  1629,  1627,  1624,  1621,  1619,
+      1616,  1613,  1611,  1608,  1605,  1603,  1600,  1597,  1595,  1592,
+      1589,  1587,  1584,  1582,  1580,  1579,  1577,  1575,  1573,  1572,
+      1570,  1568,  1566,  1564,  1563,  1561,  1559,  1557,  1556,  1554,
+      1552,  1549,  1547,  1544,  1541,  1539,  1536,  1533,  1531,  1528,
+      1525,  1523,  1520,  1517,  1515,  1512,  1509,  1507,  1504,  1502,
+      1500,  1499,  1497,  1495,  1493,  1492,  1490,  1488,  1486,  1484,
+      1483,  1481,  1479,  1477,  1476,  1474,  1472,  1469,  1467,  1464,
+      1461,  1459,  1456,  1453,  1451,  1448,  1445,  1443,  1440,  1437,
+      1435,  1432,  1429,  1427,  1424,  1421,  1419,  1416,  1413,  1411,
+      1408,  1405,  1403,  1400,  1397,  1395,  1392,  1389,  1387,  1384,
+      1381,  1379,  1376,  1374,  1372,  1371,  1369,  1367,  1365,  1364,
+      1362,  1360,  1358,  1356,  1355,  1353,  1351,  1349,  1348,  1346,
+      1344,  1341,  1339,  1336,  1333,  1331,  1328,  1325,  1323,  1320,
+      1317,  1315,  1312,  1309,  1307,  1304,  1301,  1299,  1296,  1293,
+      1291,  1288,  1285,  1283,  1280,  1277,  1275,  1272,  1269,  1267,
+      1264,  1261,  1259,  1256,  1253,  1251,  1248,  1245,  1243,  1240,
+      1237,  1235,  1232,  1229,  1227,  1224,  1221,  1219,  1216,  1213,
+      1211,  1208,  1205,  1203,  1200,  1197,  1195,  1192,  1189,  1187,
+      1184,  1181,  1179,  1176,  1173,  1171,  1168,  1165,  1163,  1160,
+      1157,  1155,  1152,  1149,  1147,  1144,  1141,  1139,  1136,  1133,
+      1131,  1128,  1125,  1123,  1120,  1117,  1115,  1112,  1109,  1107,
+      1104,  1101,  1099,  1096,  1093,  1091,  1088,  1085,  1083,  1080,
+      1077,  1075,  1072,  1069,  1067,  1064,  1061,  1059,  1056,  1052,
+      1049,  1045,  1042,  1038,  1035,  1031,  1028,  1024,  1020,  1017,
+      1013,  1010,  1006,  1003,   999,   996,   992,   989,   987,   984,
+       981,   979,   976,   973,   971,   968,   965,   963,   960,   957,
+       955,   952,   949,   947,   944,   940,   937,   933,   930,   926,
+       923,   919,   916,   912,   908,   905,   901,   898,   894,   891,
+       887,   884,   880,   876,   873,   869,   866,   862,   859,   855,
+       852,   848,   844,   841,   837,   834,   830,   827,   823,   820,
+       816,   812,   807,   803,   798,   794,   789,   785,   780,   776,
+       772,   767,   763,   758,   754,   749,   745,   740,   736,   732,
+       727,   723,   718,   714,   709,   705,   700,   696,   692,   687,
+       683,   678,   674,   669,   665,   660,   656,   651,   645,   640,
+       635,   629,   624,   619,   613,   608,   603,   597,   592,   587,
+       581,   576,   571,   565,   560,   553,   546,   539,   532,   524,
+       517,   510,   503,   496,   489,   482,   475,   468,   460,   453,
+       446,   439,   432,   423,   414,   405,   396,   388,   379,   370,
+       361,   352,   343,   334,   325,   316,   308,   299,   290,   281,
+       272,   258,   244,   229,   215,   201,   187,   172,   158,   144,
+       130,   116,   101,    87,    73,    59,    44,    30,    16,    15,
+        14,    13,    11,    10,     9,     8,     7,     6,     5,     3,
+         2,     1,     0
+};
+#endif
+
+#if MY_INDEX == 71
+// 976 entries, worst error 0.08C at reading 2491
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     280, 8080,
+      4800,  4770,  4740,  4710,  4680,  4650,  4620,  4590,  4560,  4530,
+      4500,  4470,  4440,  4410,  4380,  4350,  4320,  4293,  4267,  4240,
+      4220,  4200,  4180,  4160,  4128,  4112,  4096,  4080,  4064,  4032,
+      4016,  4000,  3984,  3968,  3952,  3936,  3920,  3904,  3888,  3872,
+      3856,  3840,  3824,  3808,  3792,  3776,  3760,  3744,  3736,  3728,
+      3712,  3696,  3680,  3672,  3664,  3648,  3632,  3616,  3608,  3600,
+      3584,  3576,  3568,  3552,  3536,  3528,  3520,  3504,  3496,  3488,
+      3480,  3472,  3456,  3448,  3440,  3424,  3416,  3408,  3400,  3392,
+      3376,  3368,  3360,  3352,  3344,  3336,  3328,  3320,  3312,  3304,
+      3296,  3280,  3272,  3264,  3256,  3248,  3240,  3232,  3224,  3216,
+      3208,  3200,  3195,  3189,  3184,  3176,  3168,  3160,  3152,  3144,
+      3136,  3128,  3120,  3115,  3109,  3104,  3096,  3088,  3080,  3072,
+      3067,  3061,  3056,  3048,  3040,  3035,  3029,  3024,  3016,  3008,
+      3003,  2997,  2992,  2987,  2981,  2976,  2968,  2960,  2955,  2949,
+      2944,  2939,  2933,  2928,  2923,  2917,  2912,  2907,  2901,  2896,
+      2891,  2885,  2880,  2875,  2869,  2864,  2859,  2853,  2848,  2843,
+      2837,  2832,  2827,  2821,  2816,  2811,  2805,  2800,  2795,  2789,
+      2784,  2779,  2773,  2768,  2764,  2760,  2756,  2752,  2747,  2741,
+      2736,  2732,  2728,  2724,  2720,  2716,  2711,  2707,  2702,  2698,
+      2693,  2689,  2684,  2680,  2676,  2671,  2667,  2662,  2658,  2653,
+      2649,  2644,  2640,  2636,  2632,  2627,  2623,  2619,  2615,  2611,
+      2606,  2602,  2598,  2594,  2589,  2585,  2581,  2577,  2573,  2568,
+      2564,  2560,  2556,  2553,  2549,  2545,  2542,  2538,  2535,  2531,
+      2527,  2524,  2520,  2516,  2513,  2509,  2505,  2502,  2498,  2495,
+      2491,  2487,  2484,  2480,  2476,  2473,  2469,  2465,  2462,  2458,
+      2455,  2451,  2447,  2444,  2440,  2436,  2433,  2429,  2425,  2422,
+      2418,  2415,  2411,  2407,  2404,  2400,  2397,  2394,  2391,  2387,
+      2384,  2381,  2378,  2375,  2372,  2369,  2365,  2362,  2359,  2356,
+      2353,  2350,  2347,  2344,  2340,  2337,  2334,  2331,  2328,  2325,
+      2322,  2318,  2315,  2312,  2309,  2306,  2303,  2300,  2296,  2293,
+      2290,  2287,  2284,  2281,  2278,  2275,  2271,  2268,  2265,  2262,
+      2259,  2256,  2253,  2249,  2246,  2243,  2240,  2237,  2235,  2232,
+      2229,  2227,  2224,  2221,  2218,  2216,  2213,  2210,  2208,  2205,
+      2202,  2200,  2197,  2194,  2192,  2189,  2186,  2184,  2181,  2178,
+      2175,  2173,  2170,  2167,  2165,  2162,  2159,  2157,  2154,  2151,
+      2149,  2146,  2143,  2141,  2138,  2135,  2132,  2130,  2127,  2124,
+      2122,  2119,  2116,  2114,  2111,  2108,  2106,  2103,  2100,  2097,
+      2095,  2092,  2089,  2087,  2084,  2081,  2079,  2076,  2073,  2071,
+      2068,  2065,  2063,  2060,  2057,  2054,  2052,  2049,  2046,  2044,
+      2041,  2038,  2036,  2033,  2030,  2028,  2025,  2022,  2019,  2017,
+      2014,  2011,  2009,  2006,  2003,  2001,  1998,  1995,  1993,  1990,
+      1987,  1985,  1982,  1979,  1976,  1974,  1971,  1968,  1966,  1963,
+      1960,  1958,  1955,  1952,  1950,  1947,  1944,  1942,  1939,  1936,
+      1933,  1931,  1928,  1925,  1923,  1920,  1918,  1915,  1913,  1911,
+      1908,  1906,  1904,  1901,  1899,  1896,  1894,  1892,  1889,  1887,
+      1885,  1882,  1880,  1878,  1875,  1873,  1871,  1868,  1866,  1864,
+      1861,  1859,  1856,  1854,  1852,  1849,  1847,  1845,  1842,  1840,
+      1838,  1835,  1833,  1831,  1828,  1826,  1824,  1821,  1819,  1816,
+      1814,  1812,  1809,  1807,  1805,  1802,  1800,  1798,  1795,  1793,
+      1791,  1788,  1786,  1784,  1781,  1779,  1776,  1774,  1772,  1769,
+      1767,  1765,  1762,  1760,  1758,  1755,  1753,  1751,  1749,  1746,
+      1744,  1742,  1739,  1737,  1735,  1733,  1730,  1728,  1726,  1723,
+      1721,  1719,  1717,  1714,  1712,  1710,  1707,  1705,  1703,  1701,
+      1698,  1696,  1694,  1691,  1689,  1687,  1685,  1682,  1680,  1678,
+      1675,  1673,  1671,  1669,  1666,  1664,  1662,  1659,  1657,  1655,
+      1653,  1650,  1648,  1646,  1643,  1641,  1639,  1637,  1634,  1632,
+      1630,  1627,  1625,  1623,  1621,  1618,  1616,  1614,  1611,  1609,
+      1607,  1605,  1602,  1600,  1598,  1595,  1593,  1591,  1589,  1586,
+      1584,  1582,  1579,  1577,  1575,  1573,  1570,  1568,  1566,  1563,
+      1561,  1559,  1557,  1554,  1552,  1550,  1547,  1545,  1543,  1541,
+      1538,  1536,  1534,  1531,  1529,  1527,  1525,  1522,  1520,  1518,
+      1515,  1513,  1511,  1509,  1506,  1504,  1502,  1499,  1497,  1495,
+      1493,  1490,  1488,  1486,  1483,  1481,  1479,  1477,  1474,  1472,
+      1470,  1467,  1465,  1463,  1461,  1458,  1456,  1454,  1451,  1449,
+      1447,  1445,  1442,  1440,  1438,  1435,  1433,  1431,  1428,  1426,
+      1424,  1421,  1419,  1416,  1414,  1412,  1409,  1407,  1405,  1402,
+      1400,  1398,  1395,  1393,  1391,  1388,  1386,  1384,  1381,  1379,
+      1376,  1374,  1372,  1369,  1367,  1365,  1362,  1360,  1358,  1355,
+      1353,  1350,  1348,  1345,  1343,  1341,  1338,  1336,  1333,  1331,
+      1328,  1326,  1324,  1321,  1319,  1316,  1314,  1312,  1309,  1307,
+      1304,  1302,  1299,  1297,  1295,  1292,  1290,  1287,  1285,  1282,
+      1280,  1278,  1275,  1273,  1270,  1268,  1265,  1263,  1260,  1258,
+      1255,  1253,  1250,  1248,  1245,  1243,  1240,  1237,  1235,  1232,
+      1229,  1227,  1224,  1221,  1219,  1216,  1214,  1211,  1209,  1206,
+      1204,  1201,  1199,  1196,  1194,  1191,  1189,  1186,  1184,  1181,
+      1179,  1176,  1173,  1171,  1168,  1165,  1163,  1160,  1157,  1155,
+      1152,  1149,  1146,  1143,  1140,  1137,  1135,  1132,  1129,  1126,
+      1123,  1120,  1117,  1115,  1112,  1109,  1107,  1104,  1101,  1099,
+      1096,  1093,  1091,  1088,  1085,  1082,  1079,  1076,  1073,  1071,
+      1068,  1065,  1062,  1059,  1056,  1053,  1050,  1047,  1044,  1041,
+      1039,  1036,  1033,  1030,  1027,  1024,  1021,  1018,  1014,  1011,
+      1008,  1005,  1002,   998,   995,   992,   989,   986,   982,   979,
+       976,   973,   970,   966,   963,   960,   957,   954,   950,   947,
+       944,   941,   938,   934,   931,   928,   924,   921,   917,   914,
+       910,   907,   903,   900,   896,   892,   889,   885,   882,   878,
+       875,   871,   868,   864,   860,   857,   853,   850,   846,   843,
+       839,   836,   832,   828,   824,   820,   816,   812,   808,   804,
+       800,   796,   792,   787,   783,   779,   775,   771,   766,   762,
+       758,   754,   749,   745,   741,   737,   733,   728,   724,   720,
+       715,   710,   705,   700,   695,   690,   685,   680,   675,   670,
+       665,   660,   655,   650,   645,   640,   635,   629,   624,   619,
+       613,   608,   603,   597,   592,   587,   581,   576,   571,   565,
+       560,   553,   547,   540,   533,   527,   520,   513,   507,   500,
+       493,   487,   480,   475,   469,   464,   456,   448,   440,   432,
+       424,   416,   408,   400,   392,   384,   376,   368,   360,   352,
+       336,   328,   320,   310,   300,   290,   280,   270,   260,   250,
+       240,   227,   213,   200,   187,   173,   160,   144,   128,   112,
+        96,    80,    60,    40,    20,     0
+};
+#endif
+
+#if MY_INDEX == 8
+// 1008 entries, worst error 0.08C at reading 1207
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8064,
+     11264, 11117, 10969, 10822, 10675, 10527, 10380, 10233, 10085,  9938,
+      9791,  9643,  9496,  9349,  9202,  9054,  8907,  8760,  8612,  8465,
+      8318,  8170,  8023,  7876,  7728,  7581,  7434,  7286,  7139,  6992,
+      6844,  6697,  6550,  6402,  6255,  6108,  5960,  5813,  5666,  5518,
+      5371,  5224,  5077,  4929,  4782,  4635,  4487,  4340,  4193,  4045,
+      3898,  3751,  3603,  3456,  3444,  3431,  3419,  3406,  3394,  3382,
+      3369,  3357,  3345,  3332,  3320,  3307,  3295,  3283,  3270,  3258,
+      3246,  3233,  3221,  3208,  3196,  3184,  3171,  3159,  3147,  3134,
+      3122,  3109,  3097,  3085,  3072,  3060,  3048,  3035,  3023,  3010,
+      2998,  2986,  2973,  2961,  2949,  2936,  2924,  2911,  2899,  2887,
+      2874,  2862,  2850,  2837,  2825,  2812,  2800,  2793,  2786,  2779,
+      2772,  2765,  2758,  2751,  2744,  2738,  2731,  2724,  2717,  2710,
+      2703,  2696,  2689,  2682,  2675,  2668,  2661,  2654,  2647,  2640,
+      2633,  2626,  2619,  2613,  2606,  2599,  2592,  2585,  2578,  2571,
+      2564,  2557,  2550,  2543,  2536,  2529,  2522,  2515,  2508,  2501,
+      2494,  2488,  2481,  2474,  2467,  2460,  2453,  2446,  2439,  2432,
+      2427,  2423,  2418,  2414,  2409,  2405,  2400,  2396,  2391,  2387,
+      2382,  2378,  2373,  2369,  2364,  2360,  2355,  2350,  2346,  2341,
+      2337,  2332,  2328,  2323,  2319,  2314,  2310,  2305,  2301,  2296,
+      2292,  2287,  2283,  2278,  2274,  2269,  2264,  2260,  2255,  2251,
+      2246,  2242,  2237,  2233,  2228,  2224,  2219,  2215,  2210,  2206,
+      2201,  2197,  2192,  2188,  2185,  2181,  2178,  2174,  2170,  2167,
+      2163,  2159,  2156,  2152,  2149,  2145,  2141,  2138,  2134,  2130,
+      2127,  2123,  2120,  2116,  2112,  2109,  2105,  2101,  2098,  2094,
+      2091,  2087,  2083,  2080,  2076,  2072,  2069,  2065,  2062,  2058,
+      2054,  2051,  2047,  2043,  2040,  2036,  2033,  2029,  2025,  2022,
+      2018,  2014,  2011,  2007,  2004,  2000,  1997,  1994,  1991,  1988,
+      1985,  1982,  1979,  1976,  1973,  1970,  1967,  1964,  1961,  1958,
+      1955,  1952,  1949,  1946,  1943,  1940,  1937,  1934,  1931,  1928,
+      1925,  1922,  1918,  1915,  1912,  1909,  1906,  1903,  1900,  1897,
+      1894,  1891,  1888,  1885,  1882,  1879,  1876,  1873,  1870,  1867,
+      1864,  1861,  1858,  1855,  1852,  1849,  1846,  1843,  1840,  1837,
+      1835,  1832,  1829,  1826,  1824,  1821,  1818,  1816,  1813,  1810,
+      1807,  1805,  1802,  1799,  1797,  1794,  1791,  1788,  1786,  1783,
+      1780,  1778,  1775,  1772,  1769,  1767,  1764,  1761,  1758,  1756,
+      1753,  1750,  1748,  1745,  1742,  1739,  1737,  1734,  1731,  1729,
+      1726,  1723,  1720,  1718,  1715,  1712,  1710,  1707,  1704,  1701,
+      1699,  1696,  1694,  1692,  1690,  1688,  1685,  1683,  1681,  1679,
+      1677,  1675,  1673,  1671,  1669,  1666,  1664,  1662,  1660,  1658,
+      1656,  1654,  1652,  1650,  1647,  1645,  1643,  1641,  1639,  1637,
+      1635,  1633,  1630,  1628,  1626,  1624,  1622,  1620,  1618,  1616,
+      1614,  1611,  1609,  1607,  1605,  1603,  1601,  1599,  1597,  1595,
+      1592,  1590,  1588,  1586,  1584,  1582,  1579,  1577,  1574,  1572,
+      1570,  1567,  1565,  1562,  1560,  1557,  1555,  1553,  1550,  1548,
+      1545,  1543,  1541,  1538,  1536,  1533,  1531,  1528,  1526,  1524,
+      1521,  1519,  1516,  1514,  1512,  1509,  1507,  1504,  1502,  1499,
+      1497,  1495,  1492,  1490,  1487,  1485,  1483,  1480,  1478,  1475,
+      1473,  1470,  1468,  1466,  1463,  1461,  1458,  1456,  1454,  1452,
+      1451,  1449,  1447,  1445,  1443,  1442,  1440,  1438,  1436,  1434,
+      1432,  1431,  1429,  1427,  1425,  1423,  1422,  1420,  1418,  1416,
+      1414,  1413,  1411,  1409,  1407,  1405,  1403,  1402,  1400,  1398,
+      1396,  1394,  1393,  1391,  1389,  1387,  1385,  1384,  1382,  1380,
+      1378,  1376,  1374,  1373,  1371,  1369,  1367,  1365,  1364,  1362,
+      1360,  1358,  1356,  1354,  1352,  1349,  1347,  1345,  1343,  1341,
+      1339,  1337,  1335,  1333,  1330,  1328,  1326,  1324,  1322,  1320,
+      1318,  1316,  1314,  1311,  1309,  1307,  1305,  1303,  1301,  1299,
+      1297,  1294,  1292,  1290,  1288,  1286,  1284,  1282,  1280,  1278,
+      1275,  1273,  1271,  1269,  1267,  1265,  1263,  1261,  1259,  1256,
+      1254,  1252,  1250,  1248,  1246,  1244,  1242,  1240,  1237,  1235,
+      1233,  1231,  1229,  1227,  1225,  1223,  1221,  1218,  1216,  1214,
+      1212,  1210,  1208,  1206,  1204,  1202,  1199,  1197,  1195,  1193,
+      1191,  1189,  1187,  1185,  1182,  1180,  1178,  1176,  1174,  1172,
+      1170,  1168,  1166,  1163,  1161,  1159,  1157,  1155,  1153,  1151,
+      1149,  1147,  1144,  1142,  1140,  1138,  1136,  1134,  1132,  1131,
+      1129,  1127,  1125,  1123,  1122,  1120,  1118,  1116,  1114,  1112,
+      1111,  1109,  1107,  1105,  1103,  1102,  1100,  1098,  1096,  1094,
+      1093,  1091,  1089,  1087,  1085,  1083,  1082,  1080,  1078,  1076,
+      1074,  1073,  1071,  1069,  1067,  1065,  1064,  1062,  1060,  1058,
+      1056,  1054,  1053,  1051,  1049,  1047,  1045,  1044,  1042,  1040,
+      1038,  1036,  1034,  1032,  1029,  1027,  1025,  1023,  1021,  1019,
+      1017,  1015,  1013,  1010,  1008,  1006,  1004,  1002,  1000,   998,
+       996,   994,   991,   989,   987,   985,   983,   981,   979,   977,
+       974,   972,   970,   968,   966,   964,   962,   960,   958,   955,
+       953,   951,   949,   947,   945,   943,   941,   939,   936,   934,
+       932,   930,   928,   926,   923,   921,   918,   916,   914,   911,
+       909,   906,   904,   901,   899,   897,   894,   892,   889,   887,
+       885,   882,   880,   877,   875,   872,   870,   868,   865,   863,
+       860,   858,   856,   853,   851,   848,   846,   843,   841,   839,
+       836,   834,   831,   829,   827,   824,   822,   819,   817,   814,
+       812,   810,   807,   805,   802,   800,   798,   795,   793,   790,
+       788,   786,   783,   781,   778,   776,   773,   771,   769,   766,
+       764,   761,   759,   757,   754,   752,   749,   747,   744,   742,
+       740,   737,   735,   732,   730,   728,   725,   723,   720,   718,
+       715,   713,   711,   708,   706,   703,   701,   699,   696,   694,
+       691,   689,   686,   684,   682,   679,   677,   674,   672,   669,
+       665,   662,   659,   655,   652,   649,   645,   642,   639,   635,
+       632,   629,   626,   622,   619,   616,   612,   609,   606,   602,
+       599,   596,   592,   589,   586,   582,   579,   576,   572,   569,
+       566,   562,   559,   556,   552,   549,   546,   542,   539,   536,
+       533,   529,   526,   523,   519,   516,   513,   509,   506,   503,
+       499,   496,   492,   488,   483,   479,   475,   471,   466,   462,
+       458,   454,   450,   445,   441,   437,   433,   428,   424,   420,
+       416,   411,   407,   403,   399,   395,   390,   386,   382,   378,
+       373,   369,   365,   361,   357,   352,   348,   344,   340,   335,
+       331,   327,   323,   318,   314,   310,   306,   302,   297,   293,
+       289,   285,   280,   276,   272,   267,   262,   257,   251,   246,
+       241,   236,   231,   226,   221,   216,   210,   205,   200,   195,
+       190,   185,   180,   174,   169,   164,   159,   154,   149,   144,
+       139,   133,   128,   123,   118,   113,   108,   103,    98,    92,
+        87,    82,    77,    72,    67,    62,    56,    51,    46,    41,
+        36,    31,    26,    21,    15,    10,     5,     0
+};
+#endif
+
+#if MY_INDEX == 9
+// 1016 entries, worst error 0.08C at reading 7591
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8128,
+     14976, 14685, 14395, 14104, 13813, 13522, 13232, 12941, 12650, 12359,
+     12069, 11778, 11487, 11196, 10906, 10615, 10324, 10033,  9743,  9452,
+      9161,  8870,  8580,  8289,  7998,  7707,  7417,  7126,  6835,  6544,
+      6254,  5963,  5672,  5381,  5091,  4800,  4775,  4751,  4726,  4701,
+      4677,  4652,  4627,  4603,  4578,  4553,  4528,  4504,  4479,  4454,
+      4430,  4405,  4380,  4356,  4331,  4306,  4282,  4257,  4232,  4208,
+      4183,  4158,  4133,  4109,  4084,  4059,  4035,  4010,  3985,  3961,
+      3936,  3923,  3910,  3898,  3885,  3872,  3859,  3846,  3834,  3821,
+      3808,  3795,  3782,  3770,  3757,  3744,  3731,  3718,  3706,  3693,
+      3680,  3667,  3654,  3642,  3629,  3616,  3603,  3590,  3578,  3565,
+      3552,  3539,  3526,  3514,  3501,  3488,  3479,  3471,  3462,  3453,
+      3445,  3436,  3427,  3419,  3410,  3401,  3392,  3384,  3375,  3366,
+      3358,  3349,  3340,  3332,  3323,  3314,  3306,  3297,  3288,  3280,
+      3271,  3262,  3253,  3245,  3236,  3227,  3219,  3210,  3201,  3193,
+      3184,  3178,  3171,  3165,  3158,  3152,  3146,  3139,  3133,  3126,
+      3120,  3114,  3107,  3101,  3094,  3088,  3082,  3075,  3069,  3062,
+      3056,  3050,  3043,  3037,  3030,  3024,  3018,  3011,  3005,  2998,
+      2992,  2986,  2979,  2973,  2966,  2960,  2955,  2949,  2944,  2938,
+      2933,  2927,  2922,  2916,  2911,  2905,  2900,  2894,  2889,  2883,
+      2878,  2872,  2867,  2861,  2856,  2850,  2845,  2839,  2834,  2828,
+      2823,  2817,  2812,  2806,  2801,  2795,  2790,  2784,  2779,  2773,
+      2768,  2763,  2759,  2754,  2750,  2745,  2741,  2736,  2731,  2727,
+      2722,  2718,  2713,  2709,  2704,  2699,  2695,  2690,  2686,  2681,
+      2677,  2672,  2667,  2663,  2658,  2654,  2649,  2645,  2640,  2635,
+      2631,  2626,  2622,  2617,  2613,  2608,  2604,  2601,  2597,  2593,
+      2590,  2586,  2582,  2579,  2575,  2571,  2568,  2564,  2560,  2557,
+      2553,  2549,  2546,  2542,  2539,  2535,  2531,  2528,  2524,  2520,
+      2517,  2513,  2509,  2506,  2502,  2498,  2495,  2491,  2487,  2484,
+      2480,  2476,  2473,  2469,  2465,  2462,  2458,  2454,  2451,  2447,
+      2443,  2440,  2436,  2432,  2429,  2425,  2421,  2418,  2414,  2411,
+      2407,  2403,  2400,  2396,  2392,  2389,  2385,  2381,  2378,  2374,
+      2370,  2367,  2363,  2359,  2356,  2352,  2349,  2346,  2342,  2339,
+      2336,  2333,  2330,  2326,  2323,  2320,  2317,  2314,  2310,  2307,
+      2304,  2301,  2298,  2294,  2291,  2288,  2285,  2282,  2278,  2275,
+      2272,  2269,  2266,  2262,  2259,  2256,  2253,  2250,  2246,  2243,
+      2240,  2237,  2235,  2232,  2229,  2226,  2224,  2221,  2218,  2215,
+      2213,  2210,  2207,  2204,  2202,  2199,  2196,  2193,  2191,  2188,
+      2185,  2182,  2180,  2177,  2174,  2171,  2169,  2166,  2163,  2160,
+      2158,  2155,  2152,  2149,  2147,  2144,  2141,  2139,  2136,  2133,
+      2130,  2128,  2125,  2122,  2119,  2117,  2114,  2111,  2108,  2106,
+      2103,  2100,  2097,  2095,  2092,  2089,  2086,  2084,  2081,  2078,
+      2075,  2073,  2070,  2067,  2064,  2062,  2059,  2056,  2053,  2051,
+      2048,  2045,  2043,  2040,  2037,  2034,  2032,  2029,  2026,  2023,
+      2021,  2018,  2015,  2012,  2010,  2007,  2004,  2001,  1999,  1996,
+      1993,  1990,  1988,  1985,  1982,  1979,  1977,  1974,  1971,  1968,
+      1966,  1963,  1960,  1957,  1955,  1952,  1950,  1947,  1945,  1943,
+      1941,  1938,  1936,  1934,  1931,  1929,  1927,  1925,  1922,  1920,
+      1918,  1915,  1913,  1911,  1909,  1906,  1904,  1902,  1899,  1897,
+      1895,  1893,  1890,  1888,  1886,  1883,  1881,  1879,  1877,  1874,
+      1872,  1870,  1867,  1865,  1863,  1861,  1858,  1856,  1854,  1851,
+      1849,  1847,  1845,  1842,  1840,  1838,  1835,  1833,  1831,  1829,
+      1826,  1824,  1822,  1819,  1817,  1815,  1813,  1810,  1808,  1806,
+      1803,  1801,  1799,  1797,  1794,  1792,  1790,  1787,  1785,  1783,
+      1781,  1778,  1776,  1774,  1771,  1769,  1767,  1765,  1762,  1760,
+      1758,  1755,  1753,  1751,  1749,  1746,  1744,  1742,  1739,  1737,
+      1735,  1733,  1730,  1728,  1726,  1723,  1721,  1719,  1717,  1714,
+      1712,  1710,  1707,  1705,  1703,  1701,  1698,  1696,  1694,  1691,
+      1689,  1687,  1685,  1682,  1680,  1678,  1675,  1673,  1671,  1669,
+      1666,  1664,  1662,  1659,  1657,  1655,  1653,  1650,  1648,  1646,
+      1643,  1641,  1639,  1637,  1634,  1632,  1630,  1627,  1625,  1623,
+      1621,  1618,  1616,  1614,  1611,  1609,  1607,  1605,  1602,  1600,
+      1598,  1595,  1593,  1591,  1589,  1586,  1584,  1582,  1579,  1577,
+      1575,  1573,  1570,  1568,  1566,  1563,  1561,  1559,  1557,  1554,
+      1552,  1550,  1547,  1545,  1543,  1541,  1538,  1536,  1534,  1531,
+      1529,  1527,  1525,  1522,  1520,  1518,  1515,  1513,  1511,  1509,
+      1506,  1504,  1502,  1499,  1497,  1495,  1493,  1490,  1488,  1486,
+      1483,  1481,  1479,  1477,  1474,  1472,  1470,  1467,  1465,  1463,
+      1461,  1458,  1456,  1454,  1451,  1449,  1447,  1445,  1442,  1440,
+      1438,  1435,  1433,  1431,  1429,  1426,  1424,  1422,  1419,  1417,
+      1415,  1413,  1410,  1408,  1406,  1403,  1401,  1399,  1397,  1394,
+      1392,  1389,  1387,  1384,  1381,  1378,  1376,  1373,  1370,  1367,
+      1365,  1362,  1359,  1356,  1354,  1351,  1348,  1345,  1343,  1340,
+      1337,  1334,  1332,  1329,  1326,  1323,  1321,  1318,  1315,  1312,
+      1310,  1307,  1304,  1301,  1299,  1296,  1294,  1291,  1289,  1287,
+      1285,  1282,  1280,  1278,  1275,  1273,  1271,  1269,  1266,  1264,
+      1262,  1259,  1257,  1255,  1253,  1250,  1248,  1246,  1243,  1241,
+      1239,  1237,  1234,  1232,  1230,  1227,  1225,  1223,  1221,  1218,
+      1216,  1213,  1211,  1208,  1205,  1202,  1200,  1197,  1194,  1191,
+      1189,  1186,  1183,  1180,  1178,  1175,  1172,  1169,  1167,  1164,
+      1161,  1158,  1156,  1153,  1150,  1147,  1145,  1142,  1139,  1136,
+      1134,  1131,  1128,  1125,  1123,  1120,  1117,  1114,  1110,  1107,
+      1104,  1101,  1098,  1094,  1091,  1088,  1085,  1082,  1078,  1075,
+      1072,  1069,  1066,  1062,  1059,  1056,  1053,  1050,  1046,  1043,
+      1040,  1037,  1034,  1030,  1027,  1024,  1021,  1018,  1014,  1011,
+      1008,  1005,  1002,   998,   995,   992,   989,   986,   982,   979,
+       976,   973,   970,   966,   963,   960,   957,   954,   950,   947,
+       944,   941,   938,   934,   931,   928,   925,   922,   918,   915,
+       912,   909,   906,   902,   899,   896,   892,   889,   885,   881,
+       878,   874,   870,   867,   863,   859,   856,   852,   848,   845,
+       841,   837,   834,   830,   827,   823,   819,   816,   812,   808,
+       805,   801,   797,   794,   790,   786,   783,   779,   775,   772,
+       768,   763,   759,   754,   750,   745,   741,   736,   731,   727,
+       722,   718,   713,   709,   704,   699,   695,   690,   686,   681,
+       677,   672,   667,   663,   658,   654,   649,   645,   640,   635,
+       631,   626,   622,   617,   613,   608,   601,   594,   587,   581,
+       574,   567,   560,   553,   546,   539,   533,   526,   519,   512,
+       505,   498,   491,   485,   478,   471,   464,   457,   450,   443,
+       437,   430,   423,   416,   409,   402,   395,   389,   382,   375,
+       368,   356,   344,   332,   320,   308,   296,   284,   272,   260,
+       248,   236,   224,   212,   200,   188,   176,   164,   152,   140,
+       128,   116,   104,    92,    80,    73,    65,    58,    51,    44,
+        36,    29,    22,    15,     7,     0
+};
+#endif
+
+#if MY_INDEX == 10
+// 1016 entries, worst error 0.08C at reading 1557
+static const int16_t TEMP_DENSE_NAME(MY_TABLE)[] PROGMEM = {
+     8, 8128,
+     14864, 14576, 14288, 14000, 13712, 13424, 13136, 12848, 12560, 12272,
+     11984, 11696, 11408, 11120, 10832, 10544, 10256,  9968,  9680,  9392,
+      9104,  8816,  8528,  8240,  7952,  7664,  7376,  7088,  6800,  6512,
+      6224,  5936,  5648,  5360,  5072,  4784,  4760,  4736,  4711,  4687,
+      4663,  4639,  4614,  4590,  4566,  4542,  4517,  4493,  4469,  4445,
+      4421,  4396,  4372,  4348,  4324,  4299,  4275,  4251,  4227,  4203,
+      4178,  4154,  4130,  4106,  4081,  4057,  4033,  4009,  3984,  3960,
+      3936,  3923,  3909,  3896,  3883,  3870,  3856,  3843,  3830,  3817,
+      3803,  3790,  3777,  3764,  3750,  3737,  3724,  3711,  3697,  3684,
+      3671,  3658,  3644,  3631,  3618,  3605,  3591,  3578,  3565,  3552,
+      3538,  3525,  3512,  3499,  3485,  3472,  3463,  3455,  3446,  3437,
+      3429,  3420,  3411,  3403,  3394,  3385,  3376,  3368,  3359,  3350,
+      3342,  3333,  3324,  3316,  3307,  3298,  3290,  3281,  3272,  3264,
+      3255,  3246,  3237,  3229,  3220,  3211,  3203,  3194,  3185,  3177,
+      3168,  3162,  3155,  3149,  3142,  3136,  3130,  3123,  3117,  3110,
+      3104,  3098,  3091,  3085,  3078,  3072,  3066,  3059,  3053,  3046,
+      3040,  3034,  3027,  3021,  3014,  3008,  3002,  2995,  2989,  2982,
+      2976,  2970,  2963,  2957,  2950,  2944,  2939,  2934,  2929,  2924,
+      2919,  2914,  2909,  2904,  2899,  2894,  2889,  2884,  2879,  2874,
+      2869,  2864,  2859,  2853,  2848,  2843,  2838,  2833,  2828,  2823,
+      2818,  2813,  2808,  2803,  2798,  2793,  2788,  2783,  2778,  2773,
+      2768,  2763,  2759,  2754,  2750,  2745,  2741,  2736,  2731,  2727,
+      2722,  2718,  2713,  2709,  2704,  2699,  2695,  2690,  2686,  2681,
+      2677,  2672,  2667,  2663,  2658,  2654,  2649,  2645,  2640,  2635,
+      2631,  2626,  2622,  2617,  2613,  2608,  2604,  2600,  2596,  2592,
+      2587,  2583,  2579,  2575,  2571,  2567,  2563,  2559,  2555,  2550,
+      2546,  2542,  2538,  2534,  2530,  2526,  2522,  2517,  2513,  2509,
+      2505,  2501,  2497,  2493,  2489,  2485,  2480,  2476,  2472,  2468,
+      2464,  2461,  2458,  2454,  2451,  2448,  2445,  2442,  2438,  2435,
+      2432,  2429,  2426,  2422,  2419,  2416,  2413,  2410,  2406,  2403,
+      2400,  2397,  2394,  2390,  2387,  2384,  2381,  2378,  2374,  2371,
+      2368,  2365,  2362,  2358,  2355,  2352,  2349,  2346,  2342,  2339,
+      2336,  2333,  2330,  2326,  2323,  2320,  2317,  2314,  2310,  2307,
+      2304,  2301,  2298,  2294,  2291,  2288,  2285,  2282,  2278,  2275,
+      2272,  2269,  2266,  2262,  2259,  2256,  2253,  2250,  2246,  2243,
+      2240,  2237,  2235,  2232,  2229,  2226,  2224,  2221,  2218,  2215,
+      2213,  2210,  2207,  2204,  2202,  2199,  2196,  2193,  2191,  2188,
+      2185,  2182,  2180,  2177,  2174,  2171,  2169,  2166,  2163,  2160,
+      2158,  2155,  2152,  2149,  2147,  2144,  2141,  2139,  2136,  2133,
+      2130,  2128,  2125,  2122,  2119,  2117,  2114,  2111,  2108,  2106,
+      2103,  2100,  2097,  2095,  2092,  2089,  2086,  2084,  2081,  2078,
+      2075,  2073,  2070,  2067,  2064,  2062,  2059,  2056,  2053,  2051,
+      2048,  2045,  2043,  2040,  2037,  2034,  2032,  2029,  2026,  2023,
+      2021,  2018,  2015,  2012,  2010,  2007,  2004,  2001,  1999,  1996,
+      1993,  1990,  1988,  1985,  1982,  1979,  1977,  1974,  1971,  1968,
+      1966,  1963,  1960,  1957,  1955,  1952,  1950,  1947,  1945,  1943,
+      1941,  1938,  1936,  1934,  1931,  1929,  1927,  1925,  1922,  1920,
+      1918,  1915,  1913,  1911,  1909,  1906,  1904,  1902,  1899,  1897,
+      1895,  1893,  1890,  1888,  1886,  1883,  1881,  1879,  1877,  1874,
+      1872,  1870,  1867,  1865,  1863,  1861,  1858,  1856,  1854,  1851,
+      1849,  1847,  1845,  1842,  1840,  1838,  1835,  1833,  1831,  1829,
+      1826,  1824,  1822,  1819,  1817,  1815,  1813,  1810,  1808,  1806,
+      1803,  1801,  1799,  1797,  1794,  1792,  1790,  1787,  1785,  1783,
+      1781,  1778,  1776,  1774,  1771,  1769,  1767,  1765,  1762,  1760,
+      1758,  1755,  1753,  1751,  1749,  1746,  1744,  1742,  1739,  1737,
+      1735,  1733,  1730,  1728,  1726,  1723,  1721,  1719,  1717,  1714,
+      1712,  1710,  1707,  1705,  1703,  1701,  1698,  1696,  1694,  1691,
+      1689,  1687,  1685,  1682,  1680,  1678,  1675,  1673,  1671,  1669,
+      1666,  1664,  1662,  1659,  1657,  1655,  1653,  1650,  1648,  1646,
+      1643,  1641,  1639,  1637,  1634,  1632,  1630,  1627,  1625,  1623,
+      1621,  1618,  1616,  1614,  1611,  1609,  1607,  1605,  1602,  1600,
+      1598,  1595,  1593,  1591,  1589,  1586,  1584,  1582,  1579,  1577,
+      1575,  1573,  1570,  1568,  1566,  1563,  1561,  1559,  1557,  1554,
+      1552,  1549,  1547,  1544,  1541,  1538,  1536,  1533,  1530,  1527,
+      1525,  1522,  1519,  1516,  1514,  1511,  1508,  1505,  1503,  1500,
+      1497,  1494,  1492,  1489,  1486,  1483,  1481,  1478,  1475,  1472,
+      1470,  1467,  1464,  1461,  1459,  1456,  1454,  1451,  1449,  1447,
+      1445,  1442,  1440,  1438,  1435,  1433,  1431,  1429,  1426,  1424,
+      1422,  1419,  1417,  1415,  1413,  1410,  1408,  1406,  1403,  1401,
+      1399,  1397,  1394,  1392,  1390,  1387,  1385,  1383,  1381,  1378,
+      1376,  1374,  1371,  1369,  1367,  1365,  1362,  1360,  1358,  1355,
+      1353,  1351,  1349,  1346,  1344,  1342,  1339,  1337,  1335,  1333,
+      1330,  1328,  1326,  1323,  1321,  1319,  1317,  1314,  1312,  1310,
+      1307,  1305,  1303,  1301,  1298,  1296,  1294,  1291,  1289,  1287,
+      1285,  1282,  1280,  1278,  1275,  1273,  1271,  1269,  1266,  1264,
+      1262,  1259,  1257,  1255,  1253,  1250,  1248,  1246,  1243,  1241,
+      1239,  1237,  1234,  1232,  1230,  1227,  1225,  1223,  1221,  1218,
+      1216,  1213,  1211,  1208,  1205,  1202,  1200,  1197,  1194,  1191,
+      1189,  1186,  1183,  1180,  1178,  1175,  1172,  1169,  1167,  1164,
+      1161,  1158,  1156,  1153,  1150,  1147,  1145,  1142,  1139,  1136,
+      1134,  1131,  1128,  1125,  1123,  1120,  1117,  1114,  1110,  1107,
+      1104,  1101,  1098,  1094,  1091,  1088,  1085,  1082,  1078,  1075,
+      1072,  1069,  1066,  1062,  1059,  1056,  1053,  1050,  1046,  1043,
+      1040,  1037,  1034,  1030,  1027,  1024,  1021,  1018,  1014,  1011,
+      1008,  1005,  1002,   998,   995,   992,   989,   986,   982,   979,
+       976,   973,   970,   966,   963,   960,   957,   954,   950,   947,
+       944,   941,   938,   934,   931,   928,   925,   922,   918,   915,
+       912,   909,   906,   902,   899,   896,   892,   889,   885,   881,
+       878,   874,   870,   867,   863,   859,   856,   852,   848,   845,
+       841,   837,   834,   830,   827,   823,   819,   816,   812,   808,
+       805,   801,   797,   794,   790,   786,   783,   779,   775,   772,
+       768,   763,   759,   754,   750,   745,   741,   736,   731,   727,
+       722,   718,   713,   709,   704,   699,   695,   690,   686,   681,
+       677,   672,   667,   663,   658,   654,   649,   645,   640,   635,
+       631,   626,   622,   617,   613,   608,   601,   594,   587,   581,
+       574,   567,   560,   553,   546,   539,   533,   526,   519,   512,
+       505,   498,   491,   485,   478,   471,   464,   457,   450,   443,
+       437,   430,   423,   416,   409,   402,   395,   389,   382,   375,
+       368,   356,   344,   332,   320,   308,   296,   284,   272,   260,
+       248,   236,   224,   212,   200,   188,   176,   164,   152,   140,
+       128,   116,   104,    92,    80,    73,    65,    58,    51,    44,
+        36,    29,    22,    15,     7,     0
+};
+#endif
+
+#endif
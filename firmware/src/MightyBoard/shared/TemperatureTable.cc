@@ -301,7 +301,12 @@ const static Entry table_hbp_thermistor[] PROGMEM = {
 
 #endif
 
-static uint8_t num_temps[] = {
+// The Azteeg's dense tables come in with ThermistorTables.h
+#if TEMP_DENSE_TABLES && BOARD_TYPE != BOARD_TYPE_AZTEEG_X3
+#include "TemperatureDenseTables.h"
+#endif
+
+const static uint8_t num_temps[] PROGMEM = {
 #if BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_G
      THERMOCOUPLE_K_NUM_TEMPS - 1,
 #endif
@@ -378,6 +383,38 @@ inline void getEntry(Entry *rv, uint8_t entryIdx)
 #endif
 }
 
+#if TEMP_DENSE_TABLES
+/// get the dense table made by createDenseTemperatureLookup.py
+///
+/// @param[in] table_id  which table to read (valid values defined by therm_table struct)
+/// @return  dense table, or 0 for the thermocouple, which is still searched
+inline const int16_t *getDenseTable(uint8_t table_id)
+{
+#if BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_G
+	if ( table_id == TABLE_THERMOCOUPLE_K )
+		return 0;
+	return table_hbp_thermistor_dense;
+#elif BOARD_TYPE == BOARD_TYPE_AZTEEG_X3
+	if ( table_id == TABLE_EXT_THERMISTOR )
+		return table_ext_thermistor_dense;
+	else if ( table_id == TABLE_HBP_THERMISTOR )
+		return table_hbp_thermistor_dense;
+	else if ( table_id == TABLE_3_THERMISTOR )
+		return table_3_thermistor_dense;
+	else if ( table_id == TABLE_4_THERMISTOR )
+		return table_4_thermistor_dense;
+	else if ( table_id == TABLE_5_THERMISTOR )
+		return table_5_thermistor_dense;
+	else if ( table_id == TABLE_6_THERMISTOR )
+		return table_6_thermistor_dense;
+	else
+		return table_7_thermistor_dense;
+#else
+	return table_hbp_thermistor_dense;
+#endif
+}
+#endif
+
 /// Translate a temperature reading into degrees Celcius, using the provided lookup table.
 /// @param[in] reading Thermistor/Thermocouple voltage reading, in ADC counts
 /// @param[in] table_idx therm_tables index of the temperature lookup table
@@ -385,13 +422,33 @@ inline void getEntry(Entry *rv, uint8_t entryIdx)
 /// @return Temperature reading, in degrees Celcius
 float TempReadtoCelsius(int16_t reading, uint8_t table_idx,
 						float max_allowed_value) {
+#if TEMP_DENSE_TABLES
+     // The dense tables start with the first and last readings they cover,
+     // then have an entry every 2^TEMP_DENSE_STEP_BITS counts.  One read
+     // and a shift to interpolate, rather than a search and a divide
+     const int16_t *dense = getDenseTable(table_idx);
+     if ( dense ) {
+	  int16_t first = (int16_t)pgm_read_word(&dense[0]);
+	  if ( reading < first || reading > (int16_t)pgm_read_word(&dense[1]) ) {
+	       // out of scale; safety mode
+	       return max_allowed_value;
+	  }
+	  uint16_t offset = (uint16_t)(reading - first);
+	  const int16_t *d = &dense[2 + (offset >> TEMP_DENSE_STEP_BITS)];
+	  int16_t t = (int16_t)pgm_read_word(d);
+	  uint8_t frac = offset & ((1 << TEMP_DENSE_STEP_BITS) - 1);
+	  if ( frac )
+	       t += ((int16_t)pgm_read_word(d + 1) - t) * frac >> TEMP_DENSE_STEP_BITS;
+	  return (float)t * (1.0 / (1 << TEMP_DENSE_FRAC_BITS));
+     }
+#endif
      uint8_t bottom = 0;
 #if BOARD_TYPE == BOARD_TYPE_MIGHTYBOARD_G
 	 // Tables include thermocouple table which has index 0
-     uint8_t numtemps = num_temps[table_idx];
+     uint8_t numtemps = pgm_read_byte(&num_temps[table_idx]);
 #else
 	 // Tables do not include a thermocouple table; subtract 1 from indices
-     uint8_t numtemps = num_temps[table_idx-1];
+     uint8_t numtemps = pgm_read_byte(&num_temps[table_idx-1]);
 #endif
      uint8_t top = numtemps;
      uint8_t mid = (bottom + top) >> 1;
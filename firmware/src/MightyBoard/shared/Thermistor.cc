@@ -33,12 +33,24 @@ Thermistor::Thermistor(uint8_t analog_pin_in, uint8_t table_index_in) :
 void Thermistor::init() {
      current_temp = 0;
      initAnalogPin(analog_pin);
+#ifdef ADC_SEQUENCER
+     // Falls back to one reading at a time if the sequencer is full
+     adc_channel = addAnalogChannel(analog_pin);
+#endif
 }
 
 Thermistor::SensorState Thermistor::update() {
 	int16_t temp;
 	bool valid;
 
+#ifdef ADC_SEQUENCER
+	if ( adc_channel != ADC_SEQ_NONE ) {
+		// An average of the samples taken since the last update
+		if ( ! getAnalogChannel(adc_channel, &temp) ) return SS_ADC_WAITING;
+		return convert(temp);
+	}
+#endif
+
 	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
 		valid = raw_valid;
 		temp = raw_value;
@@ -55,6 +67,10 @@ Thermistor::SensorState Thermistor::update() {
 	// If we haven't gotten data yet, return.
 	if (!valid) return SS_ADC_WAITING;
 
+	return convert(temp);
+}
+
+Thermistor::SensorState Thermistor::convert(int16_t temp) {
 	// TODO: The raw_value appears to be 0 the first time this loop is run,
 	//       which causes this failsafe to trigger unnecessarily. Disabling
 	//       for now, since it doesn't work for ABP/HBP thermistors.
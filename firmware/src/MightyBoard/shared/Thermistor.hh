@@ -18,6 +18,7 @@
 #ifndef THERMISTOR_HH_
 #define THERMISTOR_HH_
 
+#include "Configuration.hh"
 #include "TemperatureSensor.hh"
 
 /// The thermistor module provides a driver to read the value of a thermistor connected
@@ -31,6 +32,12 @@ private:
         // TODO: This should come from the ADC!
         const static int ADC_RANGE = 1024;  ///< Maximum ADC value
         const uint8_t table_index;          ///< EEPROM offset where the thermistor conversion table is located.
+#ifdef ADC_SEQUENCER
+        uint8_t adc_channel;                ///< sequencer channel averaging the pin, or ADC_SEQ_NONE
+#endif
+
+        /// Set current_temp from an ADC reading
+        SensorState convert(int16_t reading);
 
 public:
         /// Create a new thermistor, attacheced to the given analog input pin, and using
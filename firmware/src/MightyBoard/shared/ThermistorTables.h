@@ -722,6 +722,11 @@ const static PROGMEM prog_uchar MY_NAME[] = "11. QWG-104-3950";
 
 #endif
 
+// The dense table for this slot, named MY_TABLE_dense
+#if TEMP_DENSE_TABLES
+#include "TemperatureDenseTables.h"
+#endif
+
 #endif // BOARD_TYPE_AZTEEG_X3
 
 #endif // THERMISTOR_TABLES_H_
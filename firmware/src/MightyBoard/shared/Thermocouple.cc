@@ -38,7 +38,9 @@ inline void nop() {
 Thermocouple::Thermocouple(const Pin& cs,const Pin& sck,const Pin& so) :
         cs_pin(cs),
         sck_pin(sck),
-        so_pin(so)
+        so_pin(so),
+        raw(0),
+        bytes(0)
 {
 }
 
@@ -48,82 +50,64 @@ void Thermocouple::init() {
 	so_pin.setDirection(false);
 	cs_pin.setValue(true);   // Clock select is active low
 	current_temp = 0;
+	raw = 0;
+	bytes = 0;
 }
 
-#ifndef MAX31855
-
-Thermocouple::SensorState Thermocouple::update() {
-	cs_pin.setValue(false);
+// Clock a byte in, most significant bit first.  The clock goes low before
+// each bit is read and is left high, so a read can stop between bytes.
+uint8_t Thermocouple::readByte() {
+	uint8_t in = 0;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline"
-	nop();
-#pragma GCC diagnostic pop
-
-	uint16_t raw  = 0;
-	for (int8_t i = 15; i >= 0; i--)
-	{
+	for (uint8_t i = 0; i < 8; i++) {
 		sck_pin.setValue(false);
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
 		nop();
-#pragma GCC diagnostic ignored "-Winline"
-
+		in <<= 1;
 		if ( so_pin.getValue() )
-			raw |= (1 << i);
-
+			in |= 1;
 		sck_pin.setValue(true);
+		nop();
+	}
+#pragma GCC diagnostic pop
+	return in;
+}
+
+// A read is taken a byte per call, so as not to hold up the main loop for
+// the whole of it; SS_ADC_BUSY brings the heater back for the next byte
+Thermocouple::SensorState Thermocouple::update() {
+	if ( bytes == 0 ) {
+#ifdef MAX31855
+		// TODO: Check timing against datasheet.
+		sck_pin.setValue(false);
+#endif
+		cs_pin.setValue(false);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winline"
 		nop();
-#pragma GCC diagnostic ignored "-Winline"
+#pragma GCC diagnostic pop
+		raw = 0;
 	}
 
+	raw = (raw << 8) | readByte();
+	if ( ++bytes < THERMOCOUPLE_BYTES )
+		return SS_ADC_BUSY;
+
+	bytes = 0;
 	cs_pin.setValue(true);
 
+#ifndef MAX31855
+
 	if ( raw & 0x04 ) {
 		// Set the temperature to 1024 as an error condition
 		current_temp = BAD_TEMPERATURE + 1;
 		return SS_ERROR_UNPLUGGED;
 	}
 
-	current_temp = (raw >> 3) * 0.25;
-
-	return SS_OK;
-}
+	current_temp = ((uint16_t)raw >> 3) * 0.25;
 
 #else
 
-Thermocouple::SensorState Thermocouple::update() {
-
-	// TODO: Check timing against datasheet.
-#pragma GCC diagnostic push
-	sck_pin.setValue(false);
-#pragma GCC diagnostic ignored "-Winline"
-	nop();
-	cs_pin.setValue(false);
-#pragma GCC diagnostic ignored "-Winline"
-	nop();
-#pragma GCC diagnostic pop
-
-	uint32_t raw = 0;
-	for (uint8_t i = 0; i < 32; i++) {
-		sck_pin.setValue(false);
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
-		nop();
-#pragma GCC diagnostic pop
-		raw <<= 1;
-		if ( so_pin.getValue() ) 
-			raw |= 1;
-		sck_pin.setValue(true);
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winline"
-		nop();
-#pragma GCC diagnostic pop
-	}
-
-	cs_pin.setValue(true);
-
 	// Evaluate the results
 
 	if ( raw & 0x07 ) {
@@ -133,18 +117,18 @@ Thermocouple::SensorState Thermocouple::update() {
 	}
 
 	// Ignore the chip's internal temperature and status/error bits
-	raw >>= 18;
+	uint16_t bits = (uint16_t)(raw >> 18);
 
 	// Use the bottom 13 bits
-	int16_t temp = (int16_t)(raw & 0x3fff);
+	int16_t temp = (int16_t)(bits & 0x3fff);
 
 	// Sign bit
-	if ( raw & 0x2000 ) 
+	if ( bits & 0x2000 ) 
 		temp |= 0xc000;
 
 	current_temp = temp * 0.25;
 
+#endif
+
 	return SS_OK;
 }
-
-#endif
@@ -21,6 +21,13 @@
 #include "TemperatureSensor.hh"
 #include "Pin.hh"
 
+/// The MAX6675 sends 16 bits, the MAX31855 32
+#ifdef MAX31855
+#define THERMOCOUPLE_BYTES 4
+#else
+#define THERMOCOUPLE_BYTES 2
+#endif
+
 /// The thermocouple module provides a bitbanging driver that can read the
 /// temperature from (chip name) sensor, and also report on any error conditions.
 /// \ingroup SoftwareLibraries
@@ -29,6 +36,10 @@ private:
         Pin cs_pin;  ///< Chip select pin (output)
         Pin sck_pin; ///< Clock pin (output)
         Pin so_pin;  ///< Data pin (input)
+        uint32_t raw;  ///< Bits of the present read
+        uint8_t bytes; ///< Bytes of the present read taken so far
+
+        uint8_t readByte();
 public:
         /// Create a new thermocouple instance, and attach it to the given pins.
         /// \param [in] cs Chip Select (output).
@@ -39,5 +50,10 @@ public:
 	void init();
 
 	SensorState update();
+
+	/// True while a read is part way through, with chip select held low.
+	/// Thermocouples share the clock and data pins, so another mustn't
+	/// start a read until this one is done.
+	bool isBusy() const { return bytes != 0; }
 };
 #endif // THERMOCOUPLE_HH_
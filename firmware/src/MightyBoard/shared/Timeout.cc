@@ -19,6 +19,7 @@
 #include "Timeout.hh"
 #include "Configuration.hh"
 #include "Motherboard.hh"
+#include <util/atomic.h>
 
 // MBI used a technique which handled wrap around of the clock timer
 // but required a minimum of two uint32_t values per Timeout object.
@@ -65,6 +66,26 @@
 // extends us out a further factor of 255 to 3.47 years!
 // 
 
+// The clock as latchClock() took it.  The stepper and interface interrupts
+// poll timeouts too, so it's set with them held off.
+static bool clock_latched = false;
+static micros_t latched_micros;
+static uint8_t latched_wrap;
+
+void Timeout::latchClock() {
+     uint8_t wrap;
+     micros_t now = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	  latched_micros = now;
+	  latched_wrap = wrap;
+	  clock_latched = true;
+     }
+}
+
+void Timeout::unlatchClock() {
+     clock_latched = false;
+}
+
 Timeout::Timeout() : flags(0) { }
 
 void Timeout::start(micros_t duration_micros_in) {
@@ -72,12 +93,24 @@ void Timeout::start(micros_t duration_micros_in) {
      end_time_micros = (duration_micros_in / 100) + Motherboard::getBoard().getCurrentCentaMicros(&my_wrap);
 }
 
-bool Timeout::hasElapsed() {
-     if ( flags == TIMEOUT_FLAGS_ACTIVE ) {
-	  uint8_t wrap;
-	  if ( ( end_time_micros <= Motherboard::getBoard().getCurrentCentaMicros(&wrap) ) ||
-	       ( my_wrap < wrap ) )
-	       flags = TIMEOUT_FLAGS_ELAPSED;
-     }
+bool Timeout::elapsedAt(micros_t now, uint8_t wrap) {
+     if ( ( end_time_micros <= now ) || ( my_wrap < wrap ) )
+	  flags = TIMEOUT_FLAGS_ELAPSED;
      return 0 != (flags & TIMEOUT_FLAGS_ELAPSED);
 }
+
+bool Timeout::hasElapsed() {
+     if ( flags != TIMEOUT_FLAGS_ACTIVE )
+	  return 0 != (flags & TIMEOUT_FLAGS_ELAPSED);
+     if ( clock_latched )
+	  return elapsedAt(latched_micros, latched_wrap);
+     return hasElapsedNow();
+}
+
+bool Timeout::hasElapsedNow() {
+     if ( flags != TIMEOUT_FLAGS_ACTIVE )
+	  return 0 != (flags & TIMEOUT_FLAGS_ELAPSED);
+     uint8_t wrap;
+     micros_t now = Motherboard::getBoard().getCurrentCentaMicros(&wrap);
+     return elapsedAt(now, wrap);
+}
@@ -30,6 +30,12 @@
 ///
 /// Timeouts must be checked before the maximum timeout length to remain valid
 /// After a timeout has elapsed, it can not go back to a valid state without being explicitly reset.
+///
+/// The main loop polls a few dozen timeouts on each pass, so it takes the clock once at the
+/// start of the pass with latchClock(), and hasElapsed() compares against that instead of reading
+/// the clock itself.  A timeout may then be seen to elapse up to a pass late, but never early;
+/// start() always reads the clock.  A wait which polls a timeout in a loop of its own, within a
+/// pass, uses hasElapsedNow().
 
 #define TIMEOUT_FLAGS_ACTIVE  0x01
 #define TIMEOUT_FLAGS_ELAPSED 0x02
@@ -41,6 +47,8 @@ private:
         uint8_t my_wrap;
 	micros_t end_time_micros;
 
+	bool elapsedAt(micros_t now, uint8_t wrap);
+
 public:
         /// Instantiate a new timeout object.
 	Timeout();
@@ -55,6 +63,14 @@ public:
         /// \return True if the timeout has elapsed.
 	bool hasElapsed();
 
+        /// As hasElapsed(), but against the clock as it is now
+	bool hasElapsedNow();
+
+        /// Take the clock for the hasElapsed() calls until unlatchClock()
+	static void latchClock();
+
+	static void unlatchClock();
+
         ///
         /// \return True if the timeout is still running.
         bool isActive() const { return 0 != ( flags & TIMEOUT_FLAGS_ACTIVE ); }
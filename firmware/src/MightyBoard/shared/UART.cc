@@ -20,9 +20,11 @@
 #include "EepromMap.hh"
 #include "Eeprom.hh"
 #include "Pin.hh"
+#include "IsrProfile.hh"
 #include <stdint.h>
 #include <avr/sfr_defs.h>
 #include <avr/interrupt.h>
+#include <util/atomic.h>
 #include <avr/io.h>
 #include <util/delay.h>
 #include <avr/io.h>
@@ -92,11 +94,17 @@ volatile uint8_t loopback_bytes = 0;
 // Alternate UART uses 115200 on both UARTS
 #define UBRR1_VALUE 16 // 115200 baud
 #else
-// SLAVE_UART uses 38400 for the RS485 bus
-#define UBRR1_VALUE 51 // 38400 baud
+// SLAVE_UART runs the RS485 bus at SLAVE_UART_BAUD
+#ifndef SLAVE_UART_BAUD
+#define SLAVE_UART_BAUD 38400L
+#endif
+#define UBRR1_VALUE UBRR_2X(SLAVE_UART_BAUD)
 #endif
 #define UCSRA_VALUE(uart_) _BV(U2X##uart_)
 
+// UBRR for a baud rate in double-speed mode, rounded to the nearest
+#define UBRR_2X(baud_) ((F_CPU / 8 + (baud_) / 2) / (baud_) - 1)
+
 // Adapted from ancient arduino/wiring rabbit hole
 #define INIT_SERIAL(uart_)                                                     \
   {                                                                            \
@@ -176,7 +184,8 @@ inline void speak() { TX_Enable.setValue(true); }
 #endif
 
 UART::UART(uint8_t index, communication_mode mode)
-    : index_(index), mode_(mode), enabled_(false) {
+    : index_(index), mode_(mode), enabled_(false), in_receiving_(0),
+      in_handling_(0) {
   init_serial();
 #ifdef ALTERNATE_UART
   // Value in EEPROM is the UART index: 0 for UART0 (USB), 1 for UART1
@@ -211,6 +220,83 @@ void UART::setHardwareUART(uint8_t index) {
 }
 #endif
 
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+
+// Only rates which F_CPU / 8 divides closely.  1 Mbaud would also divide
+// exactly, but leaves too little time to take each byte before the next
+// overruns the receiver while the stepper interrupt runs.
+bool UART::supportsBaudRate(uint32_t baud) {
+  return baud == 115200 || baud == 250000 || baud == 500000;
+}
+
+void UART::setBaudRate(uint32_t baud) {
+  uint16_t ubrr = UBRR_2X(baud);
+
+  // The last byte of a reply may still be in the data register and another
+  // in the shifter; two bytes at 115200 take 174us
+  _delay_us(200);
+  if (index_ == 0) {
+    UBRR0H = ubrr >> 8;
+    UBRR0L = ubrr & 0xff;
+  }
+#if HAS_SLAVE_UART || defined(ALTERNATE_UART)
+  else {
+    UBRR1H = ubrr >> 8;
+    UBRR1L = ubrr & 0xff;
+  }
+#endif
+}
+
+#endif
+
+// The receiving packet moves on when it's done, unless the next one is still
+// waiting to be handled; bytes then go to it as they would with no ring.
+void UART::processByte(uint8_t b) {
+  InPacket &packet = in_[in_receiving_];
+
+  packet.processByte(b);
+  if (inPacketDone(packet)) {
+    uint8_t next = (in_receiving_ + 1) & (UART_IN_PACKETS - 1);
+    if (next != in_handling_)
+      in_receiving_ = next;
+  }
+}
+
+void UART::nextInPacket() {
+  ATOMIC_BLOCK(ATOMIC_FORCEON) {
+    in_[in_handling_].reset();
+    if (in_handling_ != in_receiving_)
+      in_handling_ = (in_handling_ + 1) & (UART_IN_PACKETS - 1);
+
+    // Let a packet which finished with the ring full move on to the
+    // slot just freed
+    uint8_t next = (in_receiving_ + 1) & (UART_IN_PACKETS - 1);
+    if (next != in_handling_ && inPacketDone(in_[in_receiving_]))
+      in_receiving_ = next;
+  }
+}
+
+void UART::resetInPackets() {
+  ATOMIC_BLOCK(ATOMIC_FORCEON) {
+    for (uint8_t i = 0; i < UART_IN_PACKETS; i++)
+      in_[i].reset();
+    in_receiving_ = 0;
+    in_handling_ = 0;
+  }
+}
+
+#ifdef HOST_LARGE_PACKETS
+
+// Each packet's length byte is checked against the limit as it arrives
+void UART::setInPacketLimit(uint8_t limit) {
+  ATOMIC_BLOCK(ATOMIC_FORCEON) {
+    for (uint8_t i = 0; i < UART_IN_PACKETS; i++)
+      in_[i].setLimit(limit);
+  }
+}
+
+#endif
+
 // Subsequent bytes will be triggered by the tx complete interrupt.
 void UART::beginSend() {
   if (!enabled_) {
@@ -280,7 +366,7 @@ ISR(USART_RX_vect) {
   if (loopback_bytes > 0) {
     loopback_bytes--;
   } else {
-    UART::getHostUART().in.processByte(byte_in);
+    UART::getHostUART().processByte(byte_in);
   }
 }
 
@@ -296,8 +382,23 @@ ISR(USART_TX_vect) {
 #elif defined(__AVR_ATmega644P__) || defined(__AVR_ATmega1280__) ||            \
     defined(__AVR_ATmega2560__)
 
+#ifdef ISR_PROFILE
+// The receive interrupt can run inside the stepper interrupt, so it has to
+// keep the timer's TEMP register for it, as the ADC interrupt does
+#define HOST_RX_ISR(udr_)                                                      \
+  {                                                                            \
+    uint8_t isr_temp = ISR_PROFILE_TEMP;                                       \
+    uint16_t isr_start = STEPPER_TCNTn;                                        \
+    UART::getHostUART().processByte(udr_);                                     \
+    isr_profile_record(ISR_PROFILE_UART_RX, isr_profile_since(isr_start));     \
+    ISR_PROFILE_TEMP = isr_temp;                                               \
+  }
+#else
+#define HOST_RX_ISR(udr_) UART::getHostUART().processByte(udr_)
+#endif
+
 // Send and receive interrupts
-ISR(USART0_RX_vect) { UART::getHostUART().in.processByte(UDR0); }
+ISR(USART0_RX_vect) { HOST_RX_ISR(UDR0); }
 
 ISR(USART0_TX_vect) {
   if (UART::getHostUART().out.isSending()) {
@@ -306,7 +407,7 @@ ISR(USART0_TX_vect) {
 }
 
 #ifdef ALTERNATE_UART
-ISR(USART1_RX_vect) { UART::getHostUART().in.processByte(UDR1); }
+ISR(USART1_RX_vect) { HOST_RX_ISR(UDR1); }
 
 ISR(USART1_TX_vect) {
   if (UART::getHostUART().out.isSending()) {
@@ -323,7 +424,7 @@ ISR(USART1_RX_vect) {
   if (loopback_bytes > 0) {
     loopback_bytes--;
   } else {
-    UART::getSlaveUART().in.processByte(byte_in);
+    UART::getSlaveUART().processByte(byte_in);
   }
 }
 
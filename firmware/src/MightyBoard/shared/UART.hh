@@ -22,6 +22,14 @@
 #include "Configuration.hh"
 #include <stdint.h>
 
+// How many packets each UART can hold, so that the next can arrive while
+// the last is still being handled.  Must be a power of 2.
+#ifdef PLATFORM_UART_IN_PACKETS
+#define UART_IN_PACKETS PLATFORM_UART_IN_PACKETS
+#else
+#define UART_IN_PACKETS 2
+#endif
+
 // TODO: Move to UART class
 /// Communication mode selection
 enum communication_mode {
@@ -92,10 +100,41 @@ private:
   const communication_mode mode_; ///< Communication mode we are speaking
   volatile bool enabled_;         ///< True if the hardware is currently enabled
 
+  // Fails to compile unless UART_IN_PACKETS is a power of two
+  typedef char in_packets_check[((UART_IN_PACKETS & (UART_IN_PACKETS - 1)) == 0) ? 1 : -1];
+
+  InPacket in_[UART_IN_PACKETS];  ///< Ring of input packets
+  volatile uint8_t in_receiving_; ///< Index of the packet being received
+  volatile uint8_t in_handling_;  ///< Index of the packet to handle next
+
+  static bool inPacketDone(const InPacket &packet) {
+    return packet.isFinished() != 0 || packet.hasError();
+  }
+
 public:
-  InPacket in;   ///< Input packet
   OutPacket out; ///< Output packet
 
+  /// Get the oldest packet which hasn't been handled: a complete one, or
+  /// the one still being received if there are none.
+  InPacket &getInPacket() { return in_[in_handling_]; }
+
+  /// Reset the packet from getInPacket() once it's been handled, and move
+  /// on to the next one.
+  void nextInPacket();
+
+  /// Reset all the input packets, dropping any not yet handled.
+  void resetInPackets();
+
+#ifdef HOST_LARGE_PACKETS
+  /// Accept payloads of up to limit bytes in the packets from now on.
+  void setInPacketLimit(uint8_t limit);
+#endif
+
+  /// Add a received byte to the packet being received.  Called by the
+  /// receive interrupt.
+  /// \param[in] b Byte received
+  void processByte(uint8_t b);
+
   /// Begin sending the data located in the #out packet.
   void beginSend();
 
@@ -103,6 +142,15 @@ public:
   /// \param[in] true to enable the serial port, false to disable it.
   void enable(bool enabled);
 
+  /// Check whether setBaudRate() can run at baud
+  /// \param[in] baud Baud rate in bits per second
+  static bool supportsBaudRate(uint32_t baud);
+
+  /// Change the baud rate.  Waits for the byte being sent to go first.
+  /// \param[in] baud Baud rate in bits per second, one which
+  /// supportsBaudRate() accepts
+  void setBaudRate(uint32_t baud);
+
 #ifdef ALTERNATE_UART
   /// Set the UART to use
   /// \param[in] index of the UART periperhal to use 0 or 1
@@ -35,6 +35,15 @@ static uint8_t previousButtons; ///< state of the button pins from the previous
 
 #define A_BUTTONS_MASK 0x1F
 
+// The buttons are read through the TWI queue, a read at a time, rather
+// than waiting on the bus from the main loop.  With VIKI_INT_PIN wired to
+// the expander's INTA, which it pulls low on a change of the buttons, a
+// read is only queued then; otherwise one is kept going.
+static uint8_t buttonRegister;
+static volatile bool buttonReadBusy = false;
+static volatile bool buttonReadDone = false;
+static bool buttonReadWanted = true;
+
 // Encoder support
 #if defined(VIKI_ENC_PIN_A) && defined(VIKI_ENC_PIN_B)
 static int8_t encClicks, encDir, encTurning;
@@ -95,9 +104,21 @@ void VikiInterface::init() {
   // We only support 4-bit mode
   _displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
 
+#if defined(VIKI_INT_PIN)
+  VIKI_INT_DDR  &= ~(VIKI_INT_MASK); // Set pin as input
+  VIKI_INT_PORT |=   VIKI_INT_MASK;  // Enable pullup
+#endif
+
   // Configure the port extender inputs and outputs
   uint8_t packet[3];
 
+  // Writes stay on the one register, so the LCD's enable pulses can be
+  // sent to port B in one transfer.  Both INT pins follow either port.
+  packet[0] = MCP23017_IOCONA;
+  packet[1] = MCP23017_IOCON_SEQOP | MCP23017_IOCON_MIRROR;
+  if (TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2))
+    return;
+
   // I/O direction for the extender port A
   packet[0] = MCP23017_IODIRA;
   packet[1] = A_BUTTONS_MASK;
@@ -110,6 +131,12 @@ void VikiInterface::init() {
   if (TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2))
     return;
 
+  // Interrupt on any change of the buttons, until port A is read
+  packet[0] = MCP23017_GPINTENA;
+  packet[1] = A_BUTTONS_MASK;
+  if (TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2))
+    return;
+
   // I/O direction for the extender port B
   packet[0] = MCP23017_IODIRB;
   packet[1] = 0x00;
@@ -118,10 +145,7 @@ void VikiInterface::init() {
 
   // Set the LED states (default states are all OFF)
   //   expander_bits[] set in our object initializer
-  packet[0] = MCP23017_GPIOA;
-  packet[1] = expander_bits[0];
-  packet[2] = expander_bits[1];
-  if (TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 3))
+  if (writePortAB())
     return;
 
   has_i2c_lcd = true;
@@ -130,11 +154,15 @@ void VikiInterface::init() {
 
 /*........... Viki Specific Stuff */
 bool VikiInterface::writePortAB() {
-  uint8_t packet[3];
+  // One port at a time, as the register address doesn't move on
+  uint8_t packet[2];
   packet[0] = MCP23017_GPIOA;
   packet[1] = expander_bits[0];
-  packet[2] = expander_bits[1];
-  return TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 3);
+  if (TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2))
+    return true;
+  packet[0] = MCP23017_GPIOB;
+  packet[1] = expander_bits[1];
+  return TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2);
 }
 
 void VikiInterface::setToolIndicator(uint8_t toolID, bool state) {
@@ -172,12 +200,47 @@ void VikiInterface::setBuzzer(bool state) {
 
 // write either command or data, with automatic 4/8-bit selection
 void VikiInterface::send(uint8_t value, bool dataMode) {
-  write4bits((value >> 4), dataMode);
-  write4bits((value & 0x0F), dataMode);
+  uint8_t packet[5];
+  packet[0] = MCP23017_GPIOB;
+  expand(packet + 1, value, dataMode);
+  TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, sizeof(packet));
+}
+
+// Port B takes each byte of a transfer in turn, so the enable pulses for a
+// run of characters go in one queued transfer
+void VikiInterface::sendData(const uint8_t *data, uint8_t count) {
+  uint8_t packet[1 + 4 * VIKI_BURST_CHARS];
+  packet[0] = MCP23017_GPIOB;
+  while (count) {
+    uint8_t n = (count > VIKI_BURST_CHARS) ? VIKI_BURST_CHARS : count;
+    uint8_t *out = packet + 1;
+    for (uint8_t i = n; i; i--)
+      out = expand(out, *data++, true);
+    TWI_queue_write(VIKI_I2C_DEVICE_ADDRESS << 1, packet, out - packet);
+    count -= n;
+  }
+}
+
+// The four port B states which clock value in, a nibble at a time with
+// the enable pin high and then low
+uint8_t *VikiInterface::expand(uint8_t *out, uint8_t value, bool dataMode) {
+  uint8_t bits = nibbleBits(value >> 4, dataMode);
+  *out++ = bits | (1 << (B_LCD_EN_PIN));
+  *out++ = bits;
+  bits = nibbleBits(value & 0x0F, dataMode);
+  *out++ = bits | (1 << (B_LCD_EN_PIN));
+  *out++ = bits;
+  return out;
 }
 
 // write4bits
 void VikiInterface::write4bits(uint8_t value, bool dataMode) {
+  pulseEnable(nibbleBits(value, dataMode));
+}
+
+// The port B state for the 4 least-significant bits of value, with the
+// enable pin low
+uint8_t VikiInterface::nibbleBits(uint8_t value, bool dataMode) {
 
   // Send 4-bits to the B-register, since all of the LCD pins exist on
   // the expander's PORTB.  Get BIT0 from our expander_bits[] state because
@@ -197,20 +260,17 @@ void VikiInterface::write4bits(uint8_t value, bool dataMode) {
   // Is it a command or data (register select)
   if (dataMode) bits |= (1 << B_LCD_RS_PIN);
 
-  pulseEnable(bits);
+  return bits;
 }
 
 void VikiInterface::pulseEnable(uint8_t data) {
-  uint8_t packet[2];
+  uint8_t packet[3];
 
-  // Write once with the LCD's enable pin held HIGH
+  // Once with the LCD's enable pin held HIGH, and again with it LOW
   packet[0] = MCP23017_GPIOB;
   packet[1] = data | (1 << (B_LCD_EN_PIN));
-  TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2);
-
-  // Write again with the LCD's enable pin pulled LOW
-  packet[1] &= ~(1 << (B_LCD_EN_PIN));
-  TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 2);
+  packet[2] = data & ~(1 << (B_LCD_EN_PIN));
+  TWI_write_data(VIKI_I2C_DEVICE_ADDRESS << 1, packet, 3);
 }
 
 void VikiInterface::writeSerial(uint8_t value) {
@@ -237,6 +297,29 @@ bool VikiInterface::getButtonRegister(uint8_t* buttons) {
   return false;
 }
 
+// From the TWI interrupt
+static void buttonsRead(uint8_t err) {
+  buttonReadBusy = false;
+  if (err)
+    buttonReadWanted = true;
+  else
+    buttonReadDone = true;
+}
+
+// Queue a read of port A, if there's room for it and the write of its
+// register address to go in together
+static void queueButtonRead() {
+  static const uint8_t reg = MCP23017_GPIOA;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (TWI_queue_room(2, 1)) {
+      buttonReadBusy = true;
+      buttonReadWanted = false;
+      TWI_queue_write(VIKI_I2C_DEVICE_ADDRESS << 1, &reg, 1);
+      TWI_queue_read(VIKI_I2C_DEVICE_ADDRESS << 1, &buttonRegister, 1, buttonsRead);
+    }
+  }
+}
+
 void VikiInterface::scanButtons() {
   if (buttonPressWaiting ||
       (buttonTimeout.isActive() && !buttonTimeout.hasElapsed()))
@@ -271,8 +354,24 @@ void VikiInterface::scanButtons() {
   }
 #endif
 
-  // Get the buttons, return if there is an error.
-  if (getButtonRegister(&newButtons)) return;
+  // Get the buttons from the last read, if there's a new one, and start
+  // the next read
+  if (!has_i2c_lcd || buttonReadBusy) return;
+  bool fresh = buttonReadDone;
+  buttonReadDone = false;
+  newButtons = fresh ? (buttonRegister & A_BUTTONS_MASK) : previousButtons;
+#if defined(VIKI_INT_PIN)
+  if (!(VIKI_INT_PIN & VIKI_INT_MASK)) buttonReadWanted = true;
+#else
+  buttonReadWanted = true;
+#endif
+  if (buttonReadWanted) queueButtonRead();
+#if defined(VIKI_ENC_PIN_A) && defined(VIKI_ENC_PIN_B)
+  if (!fresh && encClicks == 0) return;
+#else
+  if (!fresh) return;
+#endif
+  uint8_t buttons = newButtons;
 
   buttonTimeout.clear();
 
@@ -312,7 +411,9 @@ void VikiInterface::scanButtons() {
   }
 
 exitScanButtons:
-  previousButtons = newButtons;
+  // The buttons as read, without those the encoder stood in for, as with
+  // reads only on a change there may be no later one to see them let go
+  previousButtons = buttons;
 
 }
 
@@ -81,6 +81,16 @@
 #define MCP23017_GPIOB 0x13
 #define MCP23017_OLATB 0x15
 
+// IOCON: keep the register address, so that consecutive bytes all go to it
+#define MCP23017_IOCON_SEQOP 0x20
+// IOCON: INTA and INTB both go with a change on either port
+#define MCP23017_IOCON_MIRROR 0x40
+
+// Characters sent to the expander in one transfer, four bytes each
+#ifndef VIKI_BURST_CHARS
+#define VIKI_BURST_CHARS 8
+#endif
+
 // Button Mask
 #define LEFT_BUTTON_MASK (1<<4)
 #define UP_BUTTON_MASK (1<<3)
@@ -114,10 +124,14 @@ public:
 private:
   // LCD low-level private 
   void send(uint8_t, bool);
+  void sendData(const uint8_t *data, uint8_t count);
   void writeSerial(uint8_t);
   void write4bits(uint8_t value, bool dataMode);
   void pulseEnable(uint8_t value);
 
+  uint8_t nibbleBits(uint8_t value, bool dataMode);
+  uint8_t *expand(uint8_t *out, uint8_t value, bool dataMode);
+
   bool writePortAB();
   bool getButtonRegister(uint8_t* buttons);
   bool has_i2c_lcd;
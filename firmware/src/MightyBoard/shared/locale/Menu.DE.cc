@@ -163,6 +163,10 @@ const PROGMEM prog_uchar OLD_MSG[]                 = "ALT";
 const PROGMEM prog_uchar NEW_MSG[]                 = "NEU";
 //#endif
 const PROGMEM prog_uchar SD_USE_CRC_MSG[]          = "Check SD reads";
+const PROGMEM prog_uchar PRINT_PRIORITY_MSG[]      = "Druck Vorrang";
+#ifdef FAST_CANCEL
+const PROGMEM prog_uchar FAST_CANCEL_MSG[]         = "Schnell Abbruch";
+#endif
 #if defined(PSTOP_SUPPORT)
 #if defined(ZYYX_3D_PRINTER)
 const PROGMEM prog_uchar PSTOP_ENABLE_MSG[]        = "Filament Sensor";
@@ -234,6 +238,10 @@ const PROGMEM prog_uchar HEATER_FAIL_NOT_PLUGGED_IN_MSG[]     = "Temperature rea
 const PROGMEM prog_uchar HEATER_FAIL_READ_MSG[]               = "Temperature reads   "
                                                                 "out of range.       "
                                                                 "Check wiring.";
+#ifdef HEATER_RUNAWAY_MODEL
+const PROGMEM prog_uchar HEATER_FAIL_RUNAWAY_MSG[]            = "Heating uncontrolled"
+                                                                "Check heater.";
+#endif
 
 const PROGMEM prog_uchar BUILD_TIME_MSG[]    = "Druck Zeit:     h  m";
 
@@ -289,6 +297,30 @@ const PROGMEM prog_uchar TOTAL_TIME_MSG[]                = "Lifetime:      h 00m
 const PROGMEM prog_uchar LAST_TIME_MSG[]                 = "Last Print:    h 00m";
 const PROGMEM prog_uchar BUILD_TIME2_MSG[]               =  "Print Time:   h 00m"; // This string is 19 chars WIDE!
 
+#if defined(ISR_PROFILE)
+const PROGMEM prog_uchar ISR_PROFILE_MSG[]	= "Interrupt Zeiten";
+#endif
+
+#if defined(MEMORY_PROFILE)
+const PROGMEM prog_uchar MEMORY_PROFILE_MSG[]	= "Speichernutzung";
+#endif
+
+#if defined(POWER_LOSS_RESUME)
+const PROGMEM prog_uchar RESUME_BUILD_MSG[]	= "Druck fortsetzen";
+#endif
+
+#if defined(SD_FILE_CRC)
+const PROGMEM prog_uchar FILE_CHECKSUM_MSG[]	= "Druckdatei defekt.  " "Pruefsumme passt    " "nicht zur Aufnahme.";
+#endif
+
+#if defined(PID_AUTOTUNE)
+const PROGMEM prog_uchar AUTOTUNE_MSG[]		= "PID Autotune";
+const PROGMEM prog_uchar AUTOTUNE_IDLE_MSG[]	= "Center startet Tune";
+const PROGMEM prog_uchar AUTOTUNE_RUNNING_MSG[]	= "Zyklus ";
+const PROGMEM prog_uchar AUTOTUNE_DONE_MSG[]	= "Werte gespeichert";
+const PROGMEM prog_uchar AUTOTUNE_FAILED_MSG[]	= "Tune fehlgeschlagen";
+#endif
+
 #if defined(EEPROM_MENU_ENABLE)
 const PROGMEM prog_uchar EEPROM_MSG[]           = "Eeprom";
 const PROGMEM prog_uchar EEPROM_DUMP_MSG[]      = "Eeprom -> SD";
@@ -137,6 +137,10 @@ const PROGMEM prog_uchar OVERRIDE_GCODE_TEMP_MSG[] = "Override GcTemp";
 const PROGMEM prog_uchar PAUSE_HEAT_MSG[]	   = "Pause with Heat";
 const PROGMEM prog_uchar EXTRUDER_HOLD_MSG[]       = "Extruder Hold";
 const PROGMEM prog_uchar SD_USE_CRC_MSG[]          = "Check SD Reads";
+const PROGMEM prog_uchar PRINT_PRIORITY_MSG[]      = "Print Priority";
+#ifdef FAST_CANCEL
+const PROGMEM prog_uchar FAST_CANCEL_MSG[]         = "Fast Cancel";
+#endif
 #if defined(PSTOP_SUPPORT)
 #if defined(ZYYX_3D_PRINTER)
 const PROGMEM prog_uchar PSTOP_ENABLE_MSG[]        = "Filament Sensor";
@@ -197,6 +201,9 @@ const PROGMEM prog_uchar HEATER_FAIL_NOT_HEATING_MSG[]     = "Not heating proper
 const PROGMEM prog_uchar HEATER_FAIL_DROPPING_TEMP_MSG[]   = "Temperature dropping" "Check wiring.";
 const PROGMEM prog_uchar HEATER_FAIL_NOT_PLUGGED_IN_MSG[]  = "Temperature reads   " "are failing.        " "Check wiring.";
 const PROGMEM prog_uchar HEATER_FAIL_READ_MSG[]            = "Temperature reads   " "out of range.       " "Check wiring.";
+#ifdef HEATER_RUNAWAY_MODEL
+const PROGMEM prog_uchar HEATER_FAIL_RUNAWAY_MSG[]         = "Heating uncontrolled" "Check heater.";
+#endif
 
 const PROGMEM prog_uchar BUILD_TIME_MSG[]	= "Print Time:     h  m";
 
@@ -252,6 +259,30 @@ const PROGMEM prog_uchar TOTAL_TIME_MSG[]                = "Lifetime:      h 00m
 const PROGMEM prog_uchar LAST_TIME_MSG[]                 = "Last Print:    h 00m";
 const PROGMEM prog_uchar BUILD_TIME2_MSG[]               =  "Print Time:   h 00m"; // This string is 19 chars WIDE!
 
+#if defined(ISR_PROFILE)
+const PROGMEM prog_uchar ISR_PROFILE_MSG[]	= "Interrupt Timing";
+#endif
+
+#if defined(MEMORY_PROFILE)
+const PROGMEM prog_uchar MEMORY_PROFILE_MSG[]	= "Memory Usage";
+#endif
+
+#if defined(POWER_LOSS_RESUME)
+const PROGMEM prog_uchar RESUME_BUILD_MSG[]	= "Resume Build";
+#endif
+
+#if defined(SD_FILE_CRC)
+const PROGMEM prog_uchar FILE_CHECKSUM_MSG[]	= "Build file damaged. " "Its checksum doesn't" "match the one taken " "when it was written.";
+#endif
+
+#if defined(PID_AUTOTUNE)
+const PROGMEM prog_uchar AUTOTUNE_MSG[]		= "PID Autotune";
+const PROGMEM prog_uchar AUTOTUNE_IDLE_MSG[]	= "Center starts tune";
+const PROGMEM prog_uchar AUTOTUNE_RUNNING_MSG[]	= "Cycle ";
+const PROGMEM prog_uchar AUTOTUNE_DONE_MSG[]	= "Gains saved";
+const PROGMEM prog_uchar AUTOTUNE_FAILED_MSG[]	= "Tune failed";
+#endif
+
 #if defined(EEPROM_MENU_ENABLE)
 const PROGMEM prog_uchar EEPROM_MSG[]		= "Eeprom";
 const PROGMEM prog_uchar EEPROM_DUMP_MSG[]	= "Eeprom -> SD";
@@ -121,6 +121,10 @@ const PROGMEM prog_uchar OVERRIDE_GCODE_TEMP_MSG[] = "Surcharger GcTemp";
 const PROGMEM prog_uchar PAUSE_HEAT_MSG[]	        = "Pause avec chauffe";
 const PROGMEM prog_uchar EXTRUDER_HOLD_MSG[]       = "Extruder Hold";
 const PROGMEM prog_uchar SD_USE_CRC_MSG[]          = "Check SD reads";
+const PROGMEM prog_uchar PRINT_PRIORITY_MSG[]      = "Priorite impr.";
+#ifdef FAST_CANCEL
+const PROGMEM prog_uchar FAST_CANCEL_MSG[]         = "Annul. rapide";
+#endif
 #if defined(PSTOP_SUPPORT)
 #if defined(ZYYX_3D_PRINTER)
 const PROGMEM prog_uchar PSTOP_ENABLE_MSG[]        = "Capteur filament";
@@ -188,6 +192,9 @@ const PROGMEM prog_uchar HEATER_FAIL_NOT_PLUGGED_IN_MSG[]  = "Temperature reads
 //const PROGMEM prog_uchar HEATER_FAIL_DROPPING_TEMP_MSG[]   = "Echec du chauffage !" "La temperature des  " "tetes chute !       " "Verif. connectiques ";
 //const PROGMEM prog_uchar HEATER_FAIL_NOT_PLUGGED_IN_MSG[]  = "Erreur de chauffe ! " "Echec du releve de  " "temperature!        " "Verif. connectiques ";
 const PROGMEM prog_uchar HEATER_FAIL_READ_MSG[]            = "Temperature reads   " "out of range.       " "Check wiring.";
+#ifdef HEATER_RUNAWAY_MODEL
+const PROGMEM prog_uchar HEATER_FAIL_RUNAWAY_MSG[]         = "Heating uncontrolled" "Check heater.";
+#endif
 
 const PROGMEM prog_uchar BUILD_TIME_MSG[]	= "Print Time:     h  m";
 
@@ -243,6 +250,30 @@ const PROGMEM prog_uchar TOTAL_TIME_MSG[]                = "Lifetime:      h 00m
 const PROGMEM prog_uchar LAST_TIME_MSG[]                 = "Last Print:    h 00m";
 const PROGMEM prog_uchar BUILD_TIME2_MSG[]               =  "Print Time:   h 00m"; // This string is 19 chars WIDE!
 
+#if defined(ISR_PROFILE)
+const PROGMEM prog_uchar ISR_PROFILE_MSG[]	= "Temps Interruptions";
+#endif
+
+#if defined(MEMORY_PROFILE)
+const PROGMEM prog_uchar MEMORY_PROFILE_MSG[]	= "Utilisation SRAM";
+#endif
+
+#if defined(POWER_LOSS_RESUME)
+const PROGMEM prog_uchar RESUME_BUILD_MSG[]	= "Reprise impression";
+#endif
+
+#if defined(SD_FILE_CRC)
+const PROGMEM prog_uchar FILE_CHECKSUM_MSG[]	= "Fichier endommage.  " "Somme de controle   " "differente de celle " "de l'enregistrement.";
+#endif
+
+#if defined(PID_AUTOTUNE)
+const PROGMEM prog_uchar AUTOTUNE_MSG[]		= "Autotune PID";
+const PROGMEM prog_uchar AUTOTUNE_IDLE_MSG[]	= "Centre: lancer";
+const PROGMEM prog_uchar AUTOTUNE_RUNNING_MSG[]	= "Cycle ";
+const PROGMEM prog_uchar AUTOTUNE_DONE_MSG[]	= "Gains sauves";
+const PROGMEM prog_uchar AUTOTUNE_FAILED_MSG[]	= "Echec du reglage";
+#endif
+
 #if defined(EEPROM_MENU_ENABLE)
 const PROGMEM prog_uchar EEPROM_MSG[]		= "Eeprom";
 const PROGMEM prog_uchar EEPROM_DUMP_MSG[]	= "Eeprom -> SD";
@@ -147,6 +147,10 @@ extern const unsigned char OVERRIDE_GCODE_TEMP_MSG[];
 extern const unsigned char PAUSE_HEAT_MSG[];
 extern const unsigned char EXTRUDER_HOLD_MSG[];
 extern const unsigned char SD_USE_CRC_MSG[];
+extern const unsigned char PRINT_PRIORITY_MSG[];
+#ifdef FAST_CANCEL
+extern const unsigned char FAST_CANCEL_MSG[];
+#endif
 #ifdef PSTOP_SUPPORT
 extern const unsigned char PSTOP_ENABLE_MSG[];
 extern const unsigned char PSTOP_INVERTED_MSG[];
@@ -201,6 +205,9 @@ extern const unsigned char HEATER_FAIL_NOT_HEATING_MSG[];
 extern const unsigned char HEATER_FAIL_DROPPING_TEMP_MSG[];
 extern const unsigned char HEATER_FAIL_NOT_PLUGGED_IN_MSG[];
 extern const unsigned char HEATER_FAIL_READ_MSG[];
+#ifdef HEATER_RUNAWAY_MODEL
+extern const unsigned char HEATER_FAIL_RUNAWAY_MSG[];
+#endif
 //
 extern const unsigned char BUILD_TIME_MSG[];
 extern const unsigned char Z_POSITION_MSG[];
@@ -253,6 +260,30 @@ extern const unsigned char TOTAL_TIME_MSG[];
 extern const unsigned char LAST_TIME_MSG[];
 extern const unsigned char BUILD_TIME2_MSG[];
 
+#ifdef ISR_PROFILE
+extern const unsigned char ISR_PROFILE_MSG[];
+#endif
+
+#ifdef MEMORY_PROFILE
+extern const unsigned char MEMORY_PROFILE_MSG[];
+#endif
+
+#ifdef POWER_LOSS_RESUME
+extern const unsigned char RESUME_BUILD_MSG[];
+#endif
+
+#ifdef SD_FILE_CRC
+extern const unsigned char FILE_CHECKSUM_MSG[];
+#endif
+
+#ifdef PID_AUTOTUNE
+extern const unsigned char AUTOTUNE_MSG[];
+extern const unsigned char AUTOTUNE_IDLE_MSG[];
+extern const unsigned char AUTOTUNE_RUNNING_MSG[];
+extern const unsigned char AUTOTUNE_DONE_MSG[];
+extern const unsigned char AUTOTUNE_FAILED_MSG[];
+#endif
+
 #ifdef EEPROM_MENU_ENABLE
 extern const unsigned char EEPROM_MSG[];
 extern const unsigned char EEPROM_DUMP_MSG[];
@@ -320,4 +351,30 @@ extern const unsigned char CHOOSE_HBP_THERM_MSG[];
 extern const unsigned char CHOOSE_THERM_MSG[];
 #endif
 
+#ifdef LOCALE_PACKED
+
+// Messages packed by packLocaleStrings.py: a byte from LOCALE_WORD_FIRST up
+// stands for a word of LOCALE_WORDS, the last character of which has its
+// top bit set, and LOCALE_LITERAL for the byte which follows it
+#define LOCALE_WORD_FIRST 0x80
+#define LOCALE_LITERAL    0xFF
+
+extern const unsigned char LOCALE_WORDS[];
+extern const uint16_t LOCALE_WORD_OFFSETS[];
+
+/// Unpacks a message a character at a time
+class LocaleReader {
+public:
+	LocaleReader(const unsigned char *msg_in) : msg(msg_in), word(0) {}
+
+	/// The next character of the message, 0 at its end
+	char next();
+
+private:
+	const unsigned char *msg;
+	const unsigned char *word;
+};
+
+#endif
+
 #endif // __LOCALE_HH_INCLUDED__
@@ -102,12 +102,85 @@ platforms = {
 #                                       ff_creatorx-2560 show that there seems no benefit to go
 #                                       above the default, but if you're cramming many features in
 #                                       an exotic printer type, maybe it needs to be lowered.
+#                                       The buffer is only used if the SD library is built with
+#                                       SD_RAW_SAVE_RAM; otherwise files are played back in place
+#                                       from its 512 byte block cache, and this only sets how much
+#                                       room the command buffer needs before it's refilled.
 #                                       (default: 32)
 #
+#      PLATFORM_SD_CAPTURE_BUFFER    -- Size in bytes of the queue of data captured from the host
+#                                       with S3G_CAPTURE_2_SD, waiting to be written to the card.
+#                                       Must be a power of 2.
+#                                       (default: 256)
+#
+#      PLATFORM_UART_IN_PACKETS      -- Number of packets from the host which can be held at once,
+#                                       so that one can arrive while the last is handled. Must be
+#                                       a power of 2; each costs about 40 bytes of SRAM. (default: 2)
+#
+#      PLATFORM_COMMAND_BUFFER_SIZE  -- Size in bytes of the buffer of commands waiting to be run.
+#                                       Must be a power of 2. A larger buffer rides out dense runs
+#                                       of short segments when printing from SD; 1024 fits on an
+#                                       atmega2560 with the default features. (default: 512)
+#
+#      PLATFORM_BLOCK_BUFFER_SIZE    -- Number of moves the planner looks ahead. Must be a power of 2.
+#                                       Each extra block costs roughly 110 bytes of SRAM, so check
+#                                       the free SRAM in the Version menu after raising it.
+#                                       (default: 32 on atmega2560, 16 otherwise)
+#
+#      PRECOMPUTED_RAMPS             -- The planner precomputes the stepper timer values for the
+#                                       acceleration and deceleration of each block, which takes
+#                                       that work out of the stepper interrupt. Use RAMP_SEGMENTS to
+#                                       set the number of timer values per ramp (default: 8). Costs
+#                                       (RAMP_SEGMENTS * 6 + 7) bytes of SRAM per planner block.
+#
+#      ADAPTIVE_MULTISTEP            -- The stepper interrupt picks how many steps to take per
+#                                       interrupt (1, 2, 4 or 8) from the time it has left over,
+#                                       instead of from fixed step rate thresholds. Moves below
+#                                       ADAPTIVE_MULTISTEP_MIN_RATE steps/s (default: 2432) always
+#                                       take one step per interrupt. Can't be used with
+#                                       PRECOMPUTED_RAMPS.
+#
+#      S_CURVE_ACCELERATION          -- Ramps the step rate along an S-curve instead of a straight
+#                                       line, so the acceleration rises and falls smoothly rather
+#                                       than jumping at the start and end of each ramp. The ramps
+#                                       take as long as before, but the acceleration peaks at 15/8 of
+#                                       the setting mid ramp. Costs 8 bytes of SRAM per planner block.
+#                                       Can't be used with PRECOMPUTED_RAMPS.
+#
+#      INPUT_SHAPING                 -- Puts the steps of X and Y out through a ZV or ZVD input
+#                                       shaper, which cancels the ringing of each axis at the
+#                                       frequency and damping set in the INPUT_SHAPER eeprom
+#                                       settings. INPUT_SHAPER_HISTORY (default: 64) samples of the
+#                                       X and Y positions, 512us apart, are kept for the delays,
+#                                       at 4 bytes of SRAM each. Not for Core XY machines.
+#
+#      AMASS_DDA                     -- Oversamples the dda of slow blocks to smooth out the steps of
+#                                       the slower axes, instead of the fixed OVERSAMPLED_DDA. The
+#                                       oversampling is chosen for each block so the interrupt rate
+#                                       stays below AMASS_MAX_RATE (default: 4864, or 9984 with
+#                                       USB_LOW_PRIORITY), up to AMASS_MAX_LEVEL bits (default: 3).
+#
+#      STEP_DUAL_EDGE                -- For stepper drivers which step on both edges of the step
+#                                       pulse, such as TMC drivers with dedge set. A step toggles
+#                                       the step pin, with one write per port, instead of raising
+#                                       it and then lowering it. Not for the stock A4982 drivers,
+#                                       which would then only step on every other step.
+#
+#      LIVE_Z_BABYSTEP               -- A change of the live Z offset from the LCD during a build
+#                                       steps Z at once, between the blocks which move it, instead
+#                                       of waiting for the moves already planned to be made. Not
+#                                       for machines whose Z motor is mixed with another axis.
+#
 #      AUTO_LEVEL_IGNORE_ZMIN_ONBUILD-- Ignores the z-min switch when building. This will avoid
 #                                       uncorrect behaviour of z-switch that will stop the platform
 #                                       from being lifted when using auto-leveling.
 #
+#      AUTO_LEVEL_MESH               -- With AUTO_LEVEL, levels with a grid of MESH_POINTS_X by
+#                                       MESH_POINTS_Y probed Z heights (default: 4 by 4) instead of
+#                                       the three point plane. Moves are split where they cross the
+#                                       grid. Points are recorded and leveling enabled with the
+#                                       HOST_CMD_MESH_LEVEL command.
+#
 #      COOLING_FAN_PWM               -- Cooling fan Pulse Width modulation, will allow to control
 #                                       the cooling fan with a scale from 0 to 255, and not only 1 or 0.
 #
@@ -124,8 +197,40 @@ platforms = {
 #                                       the platform too, if uncertain or if you haven't modified the
 #                                       printer DON'T USE THIS ONE.
 #
+#   xmem       -- Buffers to place in an SRAM on the external memory interface,
+#                 from 'planner', 'commands', 'sd' and 'flight_recorder'.  Each
+#                 then defaults to a size which only fits there: 128 planner
+#                 blocks, 8192 bytes of commands, a 512 byte SD read buffer and
+#                 128 flight recorder records.  The interface takes over ports
+#                 A and C, so this is only for boards built with such an SRAM;
+#                 see MightyBoard/Motherboard/Xmem.hh.
+#
 #   squeeze    -- Source files to compile --mcall-prologues so as to save
 #                 code space.
+#   speed      -- Source files to compile -O2 rather than -Os, for the code
+#                 whose time counts: the stepper interrupt, the planner and
+#                 the host packets.  They cost more flash, which the
+#                 squeezed files can win back.  A file in both is squeezed.
+#
+#   kinematics -- Steps per mm, axis inversion, max feedrates and max
+#                 accelerations built in as constants, for a fleet of
+#                 machines which are all alike.  The planner's tables are then
+#                 constants and the EEPROM's settings for these are ignored.
+#                 A dictionary of
+#
+#                   'steps_per_mm'      : [ X, Y, Z, A, B ] in steps/mm
+#                   'invert'            : bitmask for axis inversion (0b---BAZYX)
+#                   'max_feedrates'     : [ X, Y, Z, A, B ] in mm/minute
+#                   'max_accelerations' : [ X, Y, Z, A, B ] in mm/s^2
+#
+#                 which also sets PLATFORM_AXIS_STEPS_PER_MM, PLATFORM_AXIS_INVERT
+#                 and PLATFORM_MAX_FEEDRATES; see
+#                 MightyBoard/Motherboard/PinnedKinematics.hh.  For instance
+#
+#                   'kinematics' : { 'steps_per_mm' : [ 88.573186, 88.573186, 400, 96.275202, 96.275202 ],
+#                                    'invert' : 0b10111,
+#                                    'max_feedrates' : [ 18000, 18000, 1170, 1600, 1600 ],
+#                                    'max_accelerations' : [ 1000, 1000, 150, 2000, 2000 ] }
 
     'mighty_one-hyper-zmax' :
         { 'mcu' : 'atmega1280',
@@ -249,6 +354,21 @@ platforms = {
                         'EEPROM_MENU_ENABLE', 'RGB_LED_MENU' ]
         },
 
+    'mighty_one-2560-fast' :
+        { 'mcu' : 'atmega2560',
+          'programmer' : 'stk500v2',
+          'board_directory' : 'mighty_one',
+          'defines' : [ 'BUILD_STATS', 'ALTERNATE_UART', 'AUTO_LEVEL', 'AUTO_LEVEL_IGNORE_ZMIN_ONBUILD',
+                        'PSTOP_ZMIN_LEVEL', 'HAS_RGB_LED', 'COOLING_FAN_PWM',
+                        'PLATFORM_SPLASH1_MSG=\\\"SF-Replicator1\\\"',
+                        'PLATFORM_THE_REPLICATOR_STR=\\\"Replicator 1\\\"',
+                        'EEPROM_MENU_ENABLE', 'RGB_LED_MENU' ],
+          'speed' : [ 'StepperAccel.cc', 'StepperAccelPlanner.cc', 'StepperAxis.cc',
+                      'Steppers.cc', 'Packet.cc', 'UART.cc', 'avrfix.c' ],
+          'squeeze' : [ 'Menu.cc', 'InterfaceBoard.cc', 'LiquidCrystalSerial.cc',
+                        'UtilityScripts.cc', 'EepromMap.cc' ]
+        },
+
     'CTC_BizerMod-2560-zmax' :
         { 'mcu' : 'atmega2560',
           'programmer' : 'stk500v2',